@@ -0,0 +1,52 @@
+# CoreMark-style CRC kernel: the bitwise CRC-16/ARC (reflected polynomial
+# 0xA001) of a 256-byte buffer, computed PASSES times. Tail-heavy on short
+# data-dependent branches and shifts.
+
+.equ PASSES, 16
+.equ BYTES, 256
+
+.data
+buffer: .zero 256
+
+.text
+main:
+    # Fill the buffer with a byte pattern
+    la s0, buffer
+    li t0, 0
+fill:
+    slli t1, t0, 3
+    xor t1, t1, t0
+    add t2, s0, t0
+    sb t1, 0(t2)
+    addi t0, t0, 1
+    li t3, BYTES
+    blt t0, t3, fill
+
+    li s1, 0xA001       # polynomial
+    li s2, 0            # crc
+    li s3, PASSES
+pass:
+    li t0, 0
+byte:
+    add t2, s0, t0
+    lbu t1, 0(t2)
+    xor s2, s2, t1
+    li t4, 8
+bit:
+    andi t5, s2, 1
+    srli s2, s2, 1
+    beqz t5, nopoly
+    xor s2, s2, s1
+nopoly:
+    addi t4, t4, -1
+    bnez t4, bit
+    addi t0, t0, 1
+    li t3, BYTES
+    blt t0, t3, byte
+    addi s3, s3, -1
+    bnez s3, pass
+
+    # Exit with the low byte of the crc
+    andi a0, s2, 0xff
+    li a7, 93
+    ecall
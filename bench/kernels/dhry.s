@@ -0,0 +1,79 @@
+# Dhrystone-style kernel: string copies and comparisons, procedure calls and
+# record assignments, repeated ITERATIONS times. Dominated by byte accesses,
+# calls and returns.
+
+.equ ITERATIONS, 1000
+
+.data
+str1: .string "DHRYSTONE PROGRAM, 1'ST STRING"
+str2: .string "DHRYSTONE PROGRAM, 2'ND STRING"
+copy: .zero 32
+rec1: .zero 32
+rec2: .zero 32
+
+.text
+main:
+    li s0, ITERATIONS
+    li s1, 0            # count of equal comparisons
+loop:
+    # strcpy(copy, str1)
+    la a0, copy
+    la a1, str1
+    jal strcpy
+    # strcmp(copy, str2)
+    la a0, copy
+    la a1, str2
+    jal strcmp
+    bnez a0, differ
+    addi s1, s1, 1
+differ:
+    # Assign record rec2 = rec1, field by field, and update a field
+    la a0, rec2
+    la a1, rec1
+    jal reccopy
+    lw t0, 8(a0)
+    addi t0, t0, 5
+    sw t0, 8(a1)
+    addi s0, s0, -1
+    bnez s0, loop
+
+    mv a0, s1
+    li a7, 93
+    ecall
+
+# Copies the null-terminated string at a1 to a0.
+strcpy:
+    mv t0, a0
+strcpy_loop:
+    lbu t1, 0(a1)
+    sb t1, 0(t0)
+    addi a1, a1, 1
+    addi t0, t0, 1
+    bnez t1, strcpy_loop
+    ret
+
+# Returns the difference of the first differing bytes of the strings at a0
+# and a1, or 0 if they are equal.
+strcmp:
+    lbu t0, 0(a0)
+    lbu t1, 0(a1)
+    bne t0, t1, strcmp_done
+    addi a0, a0, 1
+    addi a1, a1, 1
+    bnez t0, strcmp
+strcmp_done:
+    sub a0, t0, t1
+    ret
+
+# Copies the 8 words of the record at a1 to a0.
+reccopy:
+    li t0, 0
+    li t2, 32
+reccopy_loop:
+    add t1, a1, t0
+    lw t3, 0(t1)
+    add t1, a0, t0
+    sw t3, 0(t1)
+    addi t0, t0, 4
+    blt t0, t2, reccopy_loop
+    ret
@@ -0,0 +1,74 @@
+# CoreMark-style matrix kernel: C = A * B for 16x16 integer matrices, computed
+# PASSES times. Dominated by loads, multiplications and loop overhead.
+
+.equ PASSES, 4
+.equ N, 16
+
+.data
+matA: .zero 1024
+matB: .zero 1024
+matC: .zero 1024
+
+.text
+main:
+    # A[i] = i, B[i] = 3 * i + 1
+    la s0, matA
+    la s1, matB
+    la s2, matC
+    li t0, 0
+    li t1, 256
+init:
+    slli t2, t0, 2
+    add t3, s0, t2
+    sw t0, 0(t3)
+    add t3, s1, t2
+    slli t4, t0, 1
+    add t4, t4, t0
+    addi t4, t4, 1
+    sw t4, 0(t3)
+    addi t0, t0, 1
+    blt t0, t1, init
+
+    li s4, PASSES
+    li s5, N
+pass:
+    li t0, 0            # i
+row:
+    li t1, 0            # j
+col:
+    li t2, 0            # k
+    li t6, 0            # sum
+dot:
+    # sum += A[i][k] * B[k][j]
+    mul t3, t0, s5
+    add t3, t3, t2
+    slli t3, t3, 2
+    add t3, s0, t3
+    lw a0, 0(t3)
+    mul t4, t2, s5
+    add t4, t4, t1
+    slli t4, t4, 2
+    add t4, s1, t4
+    lw a1, 0(t4)
+    mul a2, a0, a1
+    add t6, t6, a2
+    addi t2, t2, 1
+    blt t2, s5, dot
+    # C[i][j] = sum
+    mul t3, t0, s5
+    add t3, t3, t1
+    slli t3, t3, 2
+    add t3, s2, t3
+    sw t6, 0(t3)
+    addi t1, t1, 1
+    blt t1, s5, col
+    addi t0, t0, 1
+    blt t0, s5, row
+    addi s4, s4, -1
+    bnez s4, pass
+
+    # Exit with the low byte of C[15][15]
+    lw a0, 1020(s2)
+    andi a0, a0, 0xff
+    li a7, 93
+    ecall
@@ -0,0 +1,233 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QTextStream>
+
+#include <iostream>
+
+#include "cli/clirunner.h"
+#include "processorregistry.h"
+#include "version/version.h"
+
+#if !defined(RISCV32_TEST_DIR) || !defined(RISCV64_TEST_DIR) ||                \
+    !defined(BENCH_KERNEL_DIR) || !defined(EXAMPLES_ASM_DIR)
+static_assert(false, "Benchmark workload directories must be defined");
+#endif
+
+/** Ripes simulator benchmark
+ *
+ * Runs a fixed set of workloads on each processor model, in a set of simulator
+ * configurations, and reports the simulated cycles per second of each
+ * combination as JSON. Workloads are run through the CLI (see
+ * CLIRunner::runArguments), such that the measured path is that of CLI runs.
+ *
+ * The report is versioned by its "format" and "version" keys; results are
+ * listed in a stable order (processor, configuration, workload), such that
+ * reports of different releases may be compared.
+ */
+
+using namespace Ripes;
+
+namespace {
+
+constexpr int c_reportVersion = 1;
+
+// Tests of the RISC-V test suite which are not run (see tst_riscv).
+const QStringList c_excludedTests = {"f", "ldst", "move", "recoding",
+                                     "memory"};
+
+struct Workload {
+  QString name;
+  // Assembly sources run in sequence; the workload is measured over all of
+  // them.
+  QStringList sources;
+};
+
+struct Config {
+  QString name;
+  QStringList arguments;
+};
+
+const std::vector<Config> c_configs = {
+    {"base", {}},
+    {"cache",
+     {"--l1i", "lines=64,ways=2,blocks=4", "--l1d",
+      "lines=64,ways=2,blocks=4"}},
+    {"pipeline", {"--pipeline", "--stages", "--cpistack", "--imix"}},
+};
+
+std::vector<Workload> workloads(bool rv64) {
+  std::vector<Workload> workloads;
+  Workload tests{"riscv-tests", {}};
+  const QDir testDir(rv64 ? RISCV64_TEST_DIR : RISCV32_TEST_DIR);
+  for (const auto &test : testDir.entryList({"*.s"}, QDir::Files, QDir::Name)) {
+    if (std::none_of(
+            c_excludedTests.begin(), c_excludedTests.end(),
+            [&](const QString &excluded) { return test.startsWith(excluded); }))
+      tests.sources << testDir.filePath(test);
+  }
+  workloads.push_back(tests);
+
+  const QDir kernelDir(BENCH_KERNEL_DIR);
+  for (const auto &kernel : {"crc16", "matmul", "dhry"})
+    workloads.push_back(
+        {kernel, {kernelDir.filePath(QString(kernel) + ".s")}});
+
+  const QDir examplesDir(EXAMPLES_ASM_DIR);
+  for (const auto &example : {"complexMul", "factorial"})
+    workloads.push_back({QString("examples/") + example,
+                         {examplesDir.filePath(QString(example) + ".s")}});
+  return workloads;
+}
+
+// Runs @p workload on @p proc in @p config, returning its result.
+QJsonObject runWorkload(const Workload &workload, ProcessorID proc,
+                        const QStringList &extensions, const Config &config,
+                        long long maxCycles) {
+  QJsonObject result;
+  result["workload"] = workload.name;
+  result["proc"] = enumToString<ProcessorID>(proc);
+  result["config"] = config.name;
+
+  long long cycles = 0;
+  long long instructions = 0;
+  double wallSeconds = 0;
+  QString status = "ok";
+  for (const auto &source : workload.sources) {
+    QStringList args = {"--src",      source,
+                        "-t",         "asm",
+                        "--proc",     enumToString<ProcessorID>(proc),
+                        "--max-cycles", QString::number(maxCycles),
+                        "--cycles",   "--iret",
+                        "--simperf"};
+    if (!extensions.isEmpty())
+      args << "--isaexts" << extensions.join(",");
+    args << config.arguments;
+    const QJsonObject run = CLIRunner::runArguments(args);
+    if (run.value("status") != "ok") {
+      status = run.value("status").toString();
+      result["error"] = source + ": " + run.value("error").toString();
+      break;
+    }
+    const QJsonObject report = run.value("report").toObject();
+    cycles += report.value("cycles").toVariant().toLongLong();
+    instructions += report.value("# instructions retired").toVariant().toLongLong();
+    wallSeconds += report.value("simulator performance")
+                       .toObject()
+                       .value("wall time (s)")
+                       .toDouble();
+  }
+
+  result["status"] = status;
+  result["cycles"] = cycles;
+  result["instructions"] = instructions;
+  result["wall time (s)"] = wallSeconds;
+  result["cycles per second"] = wallSeconds == 0 ? 0.0 : cycles / wallSeconds;
+  result["instructions per second"] =
+      wallSeconds == 0 ? 0.0 : instructions / wallSeconds;
+  return result;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  QCoreApplication app(argc, argv);
+  QCoreApplication::setApplicationName("Ripes");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "Ripes simulator benchmark. Reports the simulated cycles per second of "
+      "each workload on each processor model and configuration as JSON.");
+  parser.addHelpOption();
+  parser.addOption(QCommandLineOption(
+      "output", "Report output file. If not set, report is printed to stdout.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "proc", "Only benchmark the processor models matching the given regular "
+              "expression.",
+      "regex"));
+  parser.addOption(QCommandLineOption(
+      "workload", "Only run the workloads matching the given regular "
+                  "expression.",
+      "regex"));
+  parser.addOption(QCommandLineOption(
+      "config", "Only run the configurations matching the given regular "
+                "expression. Configurations: [base, cache, pipeline].",
+      "regex"));
+  parser.addOption(QCommandLineOption(
+      "max-cycles", "Maximum cycles simulated per source.", "cycles",
+      "20000000"));
+  parser.process(app);
+
+  const auto filter = [&](const QString &option) {
+    return QRegularExpression(parser.isSet(option) ? parser.value(option)
+                                                   : QString());
+  };
+  const QRegularExpression procFilter = filter("proc");
+  const QRegularExpression workloadFilter = filter("workload");
+  const QRegularExpression configFilter = filter("config");
+  for (const auto *re : {&procFilter, &workloadFilter, &configFilter}) {
+    if (!re->isValid()) {
+      std::cerr << "ERROR: Invalid regular expression '"
+                << re->pattern().toStdString() << "'" << std::endl;
+      return 1;
+    }
+  }
+  bool ok;
+  const long long maxCycles = parser.value("max-cycles").toLongLong(&ok);
+  if (!ok || maxCycles <= 0) {
+    std::cerr << "ERROR: Invalid cycle limit (--max-cycles)" << std::endl;
+    return 1;
+  }
+
+  QJsonArray results;
+  int failures = 0;
+  for (const auto &it : ProcessorRegistry::getAvailableProcessors()) {
+    const ProcessorID proc = it.first;
+    if (!procFilter.match(enumToString<ProcessorID>(proc)).hasMatch())
+      continue;
+    const auto isaInfo = it.second->isaInfo();
+    const bool rv64 = isaInfo.isa->bits() == 64;
+    for (const auto &config : c_configs) {
+      if (!configFilter.match(config.name).hasMatch())
+        continue;
+      for (const auto &workload : workloads(rv64)) {
+        if (!workloadFilter.match(workload.name).hasMatch())
+          continue;
+        std::cerr << "Running " << workload.name.toStdString() << " on "
+                  << enumToString<ProcessorID>(proc).toStdString() << " ("
+                  << config.name.toStdString() << ")" << std::endl;
+        const QJsonObject result =
+            runWorkload(workload, proc, isaInfo.defaultExtensions, config,
+                        maxCycles);
+        if (result.value("status") != "ok")
+          failures++;
+        results.append(result);
+      }
+    }
+  }
+
+  QJsonObject report;
+  report["format"] = "ripes-bench";
+  report["version"] = c_reportVersion;
+  report["ripes"] = getRipesVersion();
+  report["results"] = results;
+
+  QTextStream stream(stdout, QIODevice::WriteOnly);
+  QFile outputFile(parser.value("output"));
+  if (parser.isSet("output")) {
+    if (!outputFile.open(QIODevice::Truncate | QIODevice::Text |
+                         QIODevice::WriteOnly)) {
+      std::cerr << "ERROR: Failed to open output file" << std::endl;
+      return 1;
+    }
+    stream.setDevice(&outputFile);
+  }
+  stream << QJsonDocument(report).toJson(QJsonDocument::Indented);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,350 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <QtEndian>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+
+#include "VSRTL/core/vsrtl_constant.h"
+#include "VSRTL/core/vsrtl_design.h"
+#include "VSRTL/core/vsrtl_register.h"
+
+#include "assembler/rv32i_assembler.h"
+#include "cachesim/cachesim.h"
+#include "isa/rv32isainfo.h"
+#include "processorhandler.h"
+#include "processors/RISC-V/rv_alu.h"
+#include "processors/RISC-V/rv_decode.h"
+#include "processors/pagedaddressspace.h"
+#include "version/version.h"
+
+/** Ripes microbenchmarks
+ *
+ * Times the primitives on the hot paths of the simulator and the assembler in
+ * isolation, and reports the time per operation of each as JSON. Where
+ * ripes_bench measures whole simulations, these pinpoint which primitive a
+ * change in simulation speed stems from.
+ *
+ * Each benchmark is first calibrated to the number of iterations which takes
+ * at least the minimum sample time, and then sampled a number of times; the
+ * median and minimum time per operation of the samples are reported.
+ */
+
+using namespace Ripes;
+
+namespace {
+
+constexpr int c_reportVersion = 1;
+
+struct Benchmark {
+  QString name;
+  // What a single operation of the benchmark is.
+  QString op;
+  // Executes @p iterations iterations of the benchmark, returning a value
+  // derived from the results such that they are not optimized away.
+  std::function<uint64_t(uint64_t iterations)> run;
+  // Operations executed per iteration.
+  uint64_t opsPerIteration = 1;
+};
+
+// Sink for the results of the benchmarks.
+volatile uint64_t g_sink = 0;
+
+double sampleSeconds(const Benchmark &benchmark, uint64_t iterations) {
+  const auto start = std::chrono::steady_clock::now();
+  g_sink = g_sink + benchmark.run(iterations);
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+QJsonObject measure(const Benchmark &benchmark, double minSampleSeconds,
+                    int samples) {
+  uint64_t iterations = 1;
+  while (sampleSeconds(benchmark, iterations) < minSampleSeconds)
+    iterations *= 2;
+
+  std::vector<double> nsPerOp;
+  const double ops =
+      static_cast<double>(iterations * benchmark.opsPerIteration);
+  for (int i = 0; i < samples; ++i)
+    nsPerOp.push_back(sampleSeconds(benchmark, iterations) * 1e9 / ops);
+  std::sort(nsPerOp.begin(), nsPerOp.end());
+
+  QJsonObject result;
+  result["name"] = benchmark.name;
+  result["op"] = benchmark.op;
+  result["ops per sample"] = ops;
+  result["samples"] = samples;
+  result["ns/op"] = nsPerOp.at(nsPerOp.size() / 2);
+  result["min ns/op"] = nsPerOp.front();
+  return result;
+}
+
+/// Generates an RV32IM program of (roughly) @p lines source lines, exercising
+/// labels, branches, loads and stores, pseudo-instructions and data
+/// directives.
+QStringList syntheticSource(int lines) {
+  QStringList source = {".data"};
+  for (int i = 0; i < 64; ++i)
+    source << QString("d%1: .word %2").arg(i).arg(i * 7919);
+  source << ".text";
+  for (int i = 0; source.size() < lines; ++i) {
+    const QString label = QString("L%1").arg(i);
+    source << label + ":";
+    source << QString("addi a0, a0, %1").arg(i % 4096 - 2048);
+    source << QString("lw t0, %1(sp)").arg(4 * (i % 64));
+    source << QString("mul a1, a0, t0");
+    source << QString("sw a1, %1(sp)").arg(4 * ((i + 1) % 64));
+    source << QString("li a2, %1").arg(i * 12345);
+    source << QString("la a3, d%1").arg(i % 64);
+    source << QString("slli a4, a2, %1").arg(i % 32);
+    source << QString("bne a0, a4, %1").arg(label);
+    source << QString("jal ra, %1").arg(label);
+  }
+  return source;
+}
+
+/// Returns the instruction words of the text section of @p source.
+std::vector<uint32_t> textWords(const Assembler::RV32I_Assembler &assembler,
+                                const QStringList &source) {
+  const auto result = assembler.assemble(source);
+  std::vector<uint32_t> words;
+  const auto *text = result.program.getSection(".text");
+  if (text == nullptr)
+    return words;
+  for (int i = 0; i + 4 <= text->data.size(); i += 4)
+    words.push_back(qFromLittleEndian<quint32>(text->data.constData() + i));
+  return words;
+}
+
+/// A design clocking an accumulator through an ALU, ie. acc <= acc op c. A
+/// VSRTL component is only evaluated when its design is clocked, so the ALU
+/// benchmarks include the cost of clocking the design; the register benchmark
+/// measures that cost alone.
+class ALUDesign : public vsrtl::core::Design {
+public:
+  ALUDesign(int op) : Design("ALU benchmark") {
+    acc->out >> alu->op1;
+    3 >> alu->op2;
+    op >> alu->ctrl;
+    alu->res >> acc->in;
+    verifyAndInitialize();
+  }
+  SUBCOMPONENT(alu, vsrtl::core::ALU<32>);
+  SUBCOMPONENT(acc, vsrtl::core::Register<32>);
+};
+
+class RegisterDesign : public vsrtl::core::Design {
+public:
+  RegisterDesign() : Design("Register benchmark") {
+    reg->out >> reg->in;
+    verifyAndInitialize();
+  }
+  SUBCOMPONENT(reg, vsrtl::core::Register<32>);
+};
+
+std::vector<Benchmark> benchmarks() {
+  std::vector<Benchmark> benchmarks;
+
+  // Inputs shared by the benchmarks. These are constructed once and outlive
+  // the benchmarks.
+  static const auto isa =
+      std::make_shared<ISAInfo<ISA::RV32I>>(QStringList{"M"});
+  static Assembler::RV32I_Assembler assembler(isa.get());
+  static const QStringList source = syntheticSource(20000);
+  static const std::vector<uint32_t> words = textWords(assembler, source);
+  if (words.empty()) {
+    std::cerr << "ERROR: Failed to assemble the synthetic program"
+              << std::endl;
+    return benchmarks;
+  }
+  const auto word = [](uint64_t i) { return words[i % words.size()]; };
+
+  benchmarks.push_back(
+      {"decode", "instruction word", [=](uint64_t iterations) {
+         uint64_t sum = 0;
+         for (uint64_t i = 0; i < iterations; ++i)
+           sum += vsrtl::core::Decode<32>::decodeOpcode(word(i), isa.get());
+         return sum;
+       }});
+  benchmarks.push_back(
+      {"instrparser I-type", "instruction word", [=](uint64_t iterations) {
+         uint64_t sum = 0;
+         for (uint64_t i = 0; i < iterations; ++i) {
+           const auto fields = RVInstrParser::decodeI32Instr(word(i));
+           sum += fields[1] + fields[3] + fields[4];
+         }
+         return sum;
+       }});
+  benchmarks.push_back(
+      {"instrparser B-type", "instruction word", [=](uint64_t iterations) {
+         uint64_t sum = 0;
+         for (uint64_t i = 0; i < iterations; ++i) {
+           const auto fields = RVInstrParser::decodeB32Instr(word(i));
+           sum += fields[1] + fields[2] + fields[6] + fields[7];
+         }
+         return sum;
+       }});
+  benchmarks.push_back(
+      {"matcher", "instruction word", [=](uint64_t iterations) {
+         const auto &matcher = assembler.getMatcher();
+         uint64_t matched = 0;
+         for (uint64_t i = 0; i < iterations; ++i)
+           matched += !matcher.matchInstruction(word(i)).isError();
+         return matched;
+       }});
+
+  benchmarks.push_back(
+      {"design register", "cycle", [](uint64_t iterations) {
+         RegisterDesign design;
+         for (uint64_t i = 0; i < iterations; ++i)
+           design.clock();
+         return design.reg->out.uValue();
+       }});
+  for (const auto &op : std::vector<std::pair<QString, int>>{
+           {"add", ALUOp::ADD}, {"mul", ALUOp::MUL}, {"div", ALUOp::DIV}}) {
+    const int aluOp = op.second;
+    benchmarks.push_back({"alu " + op.first, "cycle", [=](uint64_t iterations) {
+                            ALUDesign design(aluOp);
+                            for (uint64_t i = 0; i < iterations; ++i)
+                              design.clock();
+                            return design.alu->res.uValue();
+                          }});
+  }
+
+  // Memory accesses sweep a 64 KiB region, word by word.
+  constexpr AInt memoryBytes = 1 << 16;
+  benchmarks.push_back(
+      {"memory read", "word access", [=](uint64_t iterations) {
+         PagedAddressSpaceMM memory;
+         uint64_t sum = 0;
+         for (uint64_t i = 0; i < iterations; ++i)
+           sum += memory.readMem((i * 4) % memoryBytes, 4);
+         return sum;
+       }});
+  benchmarks.push_back(
+      {"memory write", "word access", [=](uint64_t iterations) {
+         PagedAddressSpaceMM memory;
+         for (uint64_t i = 0; i < iterations; ++i)
+           memory.writeMem((i * 4) % memoryBytes, i, 4);
+         return memory.readMem(0, 4);
+       }});
+
+  // Cache accesses follow a pseudo-random walk through 32 KiB, such that the
+  // 4 KiB cache both hits and misses.
+  benchmarks.push_back({"cache access", "access", [](uint64_t iterations) {
+                          CacheSim cache(nullptr);
+                          cache.setBlocks(2);
+                          cache.setLines(6);
+                          cache.setWays(2);
+                          uint32_t state = 0x12345678;
+                          uint64_t cycles = 0;
+                          for (uint64_t i = 0; i < iterations; ++i) {
+                            state ^= state << 13;
+                            state ^= state >> 17;
+                            state ^= state << 5;
+                            cycles += cache.access(state & 0x7fff,
+                                                   (state >> 16) & 1
+                                                       ? MemoryAccess::Write
+                                                       : MemoryAccess::Read);
+                          }
+                          return cycles + cache.getHits();
+                        }});
+
+  benchmarks.push_back({"assembler", "source line",
+                        [=](uint64_t iterations) {
+                          uint64_t errors = 0;
+                          for (uint64_t i = 0; i < iterations; ++i)
+                            errors += assembler.assemble(source).errors.size();
+                          return errors;
+                        },
+                        static_cast<uint64_t>(source.size())});
+  return benchmarks;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  QCoreApplication app(argc, argv);
+  QCoreApplication::setApplicationName("Ripes");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "Ripes microbenchmarks. Reports the time per operation of the hot path "
+      "primitives of the simulator and the assembler as JSON.");
+  parser.addHelpOption();
+  parser.addOption(QCommandLineOption(
+      "output", "Report output file. If not set, report is printed to stdout.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "benchmark", "Only run the benchmarks matching the given regular "
+                   "expression.",
+      "regex"));
+  parser.addOption(QCommandLineOption(
+      "min-time", "Minimum duration of each sample, in milliseconds.", "ms",
+      "100"));
+  parser.addOption(QCommandLineOption(
+      "samples", "Number of samples of each benchmark.", "samples", "5"));
+  parser.process(app);
+
+  const QRegularExpression filter(
+      parser.isSet("benchmark") ? parser.value("benchmark") : QString());
+  if (!filter.isValid()) {
+    std::cerr << "ERROR: Invalid regular expression '"
+              << filter.pattern().toStdString() << "'" << std::endl;
+    return 1;
+  }
+  bool ok;
+  const double minTimeMs = parser.value("min-time").toDouble(&ok);
+  if (!ok || minTimeMs <= 0) {
+    std::cerr << "ERROR: Invalid sample time (--min-time)" << std::endl;
+    return 1;
+  }
+  const int samples = parser.value("samples").toInt(&ok);
+  if (!ok || samples <= 0) {
+    std::cerr << "ERROR: Invalid sample count (--samples)" << std::endl;
+    return 1;
+  }
+
+  // The cache simulator binds to the processor handler upon construction.
+  ProcessorHandler::get();
+
+  QJsonArray results;
+  const auto all = benchmarks();
+  if (all.empty())
+    return 1;
+  for (const auto &benchmark : all) {
+    if (!filter.match(benchmark.name).hasMatch())
+      continue;
+    std::cerr << "Running " << benchmark.name.toStdString() << std::endl;
+    results.append(measure(benchmark, minTimeMs / 1000, samples));
+  }
+
+  QJsonObject report;
+  report["format"] = "ripes-microbench";
+  report["version"] = c_reportVersion;
+  report["ripes"] = getRipesVersion();
+  report["results"] = results;
+
+  QTextStream stream(stdout, QIODevice::WriteOnly);
+  QFile outputFile(parser.value("output"));
+  if (parser.isSet("output")) {
+    if (!outputFile.open(QIODevice::Truncate | QIODevice::Text |
+                         QIODevice::WriteOnly)) {
+      std::cerr << "ERROR: Failed to open output file" << std::endl;
+      return 1;
+    }
+    stream.setDevice(&outputFile);
+  }
+  stream << QJsonDocument(report).toJson(QJsonDocument::Indented);
+  return 0;
+}
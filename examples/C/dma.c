@@ -0,0 +1,50 @@
+#include "ripes_system.h"
+
+/* DMA
+ * This program fills an image in memory, and moves it onto an LED matrix
+ * peripheral, alternating between a copy loop on the processor and a transfer
+ * by the DMA controller. Compare the cycles spent by each.
+ *
+ * To run this program, make sure that you have instantiated one of each of the
+ * following peripherals in the I/O tab:
+ * - "LED Matrix"
+ * - "DMA"
+ */
+
+#define W LED_MATRIX_0_WIDTH
+#define H LED_MATRIX_0_HEIGHT
+unsigned *led_base = LED_MATRIX_0_BASE;
+unsigned image[W * H];
+
+volatile unsigned *dma_src = DMA_0_SRC;
+volatile unsigned *dma_dst = DMA_0_DST;
+volatile unsigned *dma_len = DMA_0_LEN;
+volatile unsigned *dma_ctrl = DMA_0_CTRL;
+volatile unsigned *dma_status = DMA_0_STATUS;
+
+void cpu_copy() {
+    for (int i = 0; i < W * H; i++)
+        *(led_base + i) = image[i];
+}
+
+void dma_copy() {
+    *dma_src = (unsigned)image;
+    *dma_dst = (unsigned)led_base;
+    *dma_len = sizeof(image);
+    *dma_ctrl = DMA_0_CTRL_START;
+    while (*dma_status & DMA_0_STATUS_BUSY)
+        ;
+}
+
+void main() {
+    unsigned v = 0;
+    while (1) {
+        for (int i = 0; i < W * H; i++)
+            image[i] = (v + i) & 0xFFFFFF;
+        if (v & 1)
+            dma_copy();
+        else
+            cpu_copy();
+        v++;
+    }
+}
@@ -0,0 +1,31 @@
+#include "ripes_system.h"
+
+/* Framebuffer
+ * This program draws a moving gradient onto a framebuffer peripheral, and
+ * presents each frame by writing to the VSYNC register.
+ *
+ * To run this program, make sure that you have instantiated a "Framebuffer"
+ * peripheral in the "I/O" tab. Set its "VSync" parameter to 1 for the display
+ * to only be refreshed once a frame has been drawn.
+ */
+
+#define W FRAMEBUFFER_0_WIDTH
+#define H FRAMEBUFFER_0_HEIGHT
+unsigned *pixels = FRAMEBUFFER_0_PIXELS;
+volatile unsigned *vsync = FRAMEBUFFER_0_VSYNC;
+
+void main() {
+    unsigned t = 0;
+    while (1) {
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                unsigned r = (x + t) & 0xFF;
+                unsigned g = (y + t) & 0xFF;
+                unsigned b = (x ^ y) & 0xFF;
+                pixels[y * W + x] = r << 16 | g << 8 | b;
+            }
+        }
+        *vsync = 1;
+        t++;
+    }
+}
@@ -0,0 +1,41 @@
+# Timer
+# This program counts the ticks of a periodic machine timer interrupt, waiting
+# for each tick with wfi rather than by polling. The simulator skips the idle
+# cycles of a wfi at once, such that the waits cost no simulation time.
+#
+# To run this program, make sure that you have instantiated a "Timer"
+# peripheral in the "I/O" tab, and selected a single-cycle ISS processor.
+
+.equ PERIOD, 1000
+.equ TICKS, 10
+
+main:
+        la      t0, handler
+        csrw    mtvec, t0
+        li      s0, TIMER_0_MTIMECMP
+        li      s1, PERIOD
+        sw      zero, 4(s0)             # MTIMECMPH
+        sw      s1, 0(s0)               # first tick at cycle PERIOD
+        li      t0, 0x80                # mie.MTIE
+        csrs    mie, t0
+        csrsi   mstatus, 0x8            # mstatus.MIE
+
+        mv      s2, zero                # ticks
+        li      s3, TICKS
+wait:
+        wfi
+        blt     s2, s3, wait
+
+        mv      a0, s2
+        li      a7, 1                   # print the number of ticks
+        ecall
+        li      a7, 10                  # exit
+        ecall
+
+# Acknowledges a tick by advancing MTIMECMP by a period.
+handler:
+        lw      t0, 0(s0)
+        add     t0, t0, s1
+        sw      t0, 0(s0)
+        addi    s2, s2, 1
+        mret
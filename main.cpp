@@ -4,10 +4,13 @@
 #include <QMessageBox>
 #include <QResource>
 #include <QTimer>
+#include <cstring>
 #include <iostream>
+#include <memory>
 
 #include "src/cli/clioptions.h"
 #include "src/cli/clirunner.h"
+#include "src/hosttrace.h"
 #include "src/mainwindow.h"
 
 using namespace std;
@@ -55,7 +58,25 @@ CommandLineParseResult parseCommandLine(QCommandLineParser &parser,
   }
 }
 
+// Returns true if the arguments select CLI mode. This is determined before
+// the application is constructed, such that CLI mode does not initialize the
+// widget stack (nor require a display).
+bool isCLIModeRequested(int argc, char **argv) {
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--mode=cli") == 0)
+      return true;
+    if (std::strcmp(argv[i], "--mode") == 0 && i + 1 < argc &&
+        std::strcmp(argv[i + 1], "cli") == 0)
+      return true;
+  }
+  return false;
+}
+
 int guiMode(QApplication &app) {
+  // Icons, fonts and processor layouts are only needed for drawing the GUI.
+  Q_INIT_RESOURCE(icons);
+  Q_INIT_RESOURCE(fonts);
+  Q_INIT_RESOURCE(layouts);
   Ripes::MainWindow m;
 
   // The following sequence of events manages to successfully start the
@@ -76,33 +97,54 @@ int CLIMode(QCommandLineParser &parser, Ripes::CLIModeOptions &options) {
     parser.showHelp();
     return 0;
   }
+  if (options.workerPort != 0)
+    return Ripes::CLIRunner::runWorker(options);
+  if (options.server)
+    return Ripes::CLIRunner::runServer(options);
+  if (options.sweep)
+    return Ripes::CLIRunner::runSweep(options);
+  if (!options.batchManifest.isEmpty())
+    return Ripes::CLIRunner::runBatch(options);
   return Ripes::CLIRunner(options).run();
 }
 
 int main(int argc, char **argv) {
-  Q_INIT_RESOURCE(icons);
   Q_INIT_RESOURCE(examples);
-  Q_INIT_RESOURCE(layouts);
-  Q_INIT_RESOURCE(fonts);
 
-  QApplication app(argc, argv);
+  // CLI mode runs headless, on a QCoreApplication.
+  std::unique_ptr<QCoreApplication> app;
+  if (isCLIModeRequested(argc, argv))
+    app = std::make_unique<QCoreApplication>(argc, argv);
+  else
+    app = std::make_unique<QApplication>(argc, argv);
   QCoreApplication::setApplicationName("Ripes");
 
   QCommandLineParser parser;
   Ripes::CLIModeOptions options;
   initParser(parser, options);
   QString err;
-  switch (parseCommandLine(parser, err)) {
-  case CommandLineError:
+  const CommandLineParseResult parseResult = parseCommandLine(parser, err);
+  if (parseResult == CommandLineError) {
     std::cerr << "ERROR: " << err.toStdString() << std::endl;
     parser.showHelp();
     return 0;
-  case CommandLineHelpRequested:
+  } else if (parseResult == CommandLineHelpRequested) {
     parser.showHelp();
     return 0;
-  case CommandLineGUI:
-    return guiMode(app);
-  case CommandLineCLI:
-    return CLIMode(parser, options);
   }
+
+  if (parser.isSet("host-trace")) {
+    err = Ripes::HostTrace::start(parser.value("host-trace"));
+    if (!err.isEmpty()) {
+      std::cerr << err.toStdString() << std::endl;
+      return 1;
+    }
+  }
+  // Any mode other than CLI mode constructed a QApplication.
+  const int result =
+      parseResult == CommandLineGUI
+          ? guiMode(*static_cast<QApplication *>(app.get()))
+          : CLIMode(parser, options);
+  Ripes::HostTrace::stop();
+  return result;
 }
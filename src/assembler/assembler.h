@@ -1,6 +1,8 @@
 #pragma once
 
+#include <QHash>
 #include <QRegularExpression>
+#include <QSet>
 
 #include "instruction.h"
 #include "isa/isainfo.h"
@@ -10,13 +12,17 @@
 #include "relocation.h"
 #include "ripes_types.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <numeric>
+#include <optional>
 #include <set>
+#include <thread>
 #include <variant>
 
 #include "STLExtras.h"
 #include "assemblerbase.h"
+#include "hosttrace.h"
 
 namespace Ripes {
 namespace Assembler {
@@ -25,13 +31,14 @@ namespace Assembler {
  * A macro for running an assembler pass with error handling
  */
 #define runPass(resName, resType, passFunction, ...)                           \
-  auto passFunction##_res = passFunction(__VA_ARGS__);                         \
+  auto passFunction##_res = HostTrace::traced(                                 \
+      #passFunction, "assembler", [&] { return passFunction(__VA_ARGS__); });  \
   if (auto *errors = std::get_if<Errors>(&passFunction##_res)) {               \
     result.errors.insert(result.errors.end(), errors->begin(), errors->end()); \
     assert(result.errors.size() != 0);                                         \
     return result;                                                             \
   }                                                                            \
-  auto resName = std::get<resType>(passFunction##_res);
+  auto resName = std::get<resType>(std::move(passFunction##_res));
 
 /**
  * A macro for running an assembler operation which may throw an error or return
@@ -56,6 +63,33 @@ namespace Assembler {
     continue;                                                                  \
   }
 
+/**
+ * Invokes @p f(begin, end) for contiguous chunks of the range [0, n), in
+ * parallel across the hardware threads of the host when @p n is large enough
+ * to amortize starting them. Chunks must be independent, and results must be
+ * written by index such that they do not depend on the order of execution.
+ */
+template <typename F>
+void forEachChunk(size_t n, const F &f) {
+  // Minimum number of items in a chunk.
+  constexpr size_t c_minChunk = 4096;
+  const size_t threads = std::min<size_t>(
+      std::max(1u, std::thread::hardware_concurrency()), n / c_minChunk);
+  if (threads <= 1) {
+    f(0, n);
+    return;
+  }
+  std::vector<std::thread> workers;
+  for (size_t t = 1; t < threads; ++t) {
+    const size_t begin = (t * n) / threads;
+    const size_t end = ((t + 1) * n) / threads;
+    workers.emplace_back([&f, begin, end] { f(begin, end); });
+  }
+  f(0, n / threads);
+  for (auto &worker : workers)
+    worker.join();
+}
+
 // Macro for defining type aliases for register/instruction width specific types
 // of the assembler types
 #define AssemblerTypes(_Reg_T)                                                 \
@@ -91,6 +125,7 @@ public:
   AssembleResult
   assemble(const QStringList &programLines, const SymbolMap *symbols = nullptr,
            const QString &sourceHash = QString()) const override {
+    HostTrace::Scope traceScope("assemble", "assembler");
     AssembleResult result;
 
     /// by default, emit to .text until otherwise specified
@@ -104,7 +139,18 @@ public:
     runPass(tokenizedLines, SourceProgram, pass0, programLines);
 
     /// Pseudo instruction expansion
-    runPass(expandedLines, SourceProgram, pass1, tokenizedLines);
+    runPass(expandedLines, SourceProgram, pass1, std::move(tokenizedLines));
+
+    const SymbolMap inputSymbols = symbols ? *symbols : SymbolMap();
+    if (m_incremental && m_previous &&
+        sameSourceProgram(expandedLines, m_previous->expandedLines) &&
+        sameSymbols(inputSymbols, m_previous->inputSymbols)) {
+      // Translation and linkage would yield the previous program.
+      m_symbolMap = m_previous->symbolMap;
+      result.program = m_previous->program;
+      result.program.sourceHash = sourceHash;
+      return result;
+    }
 
     /** Assemble. During assembly, we generate:
      * - linkageMap: Recording offsets of instructions which require linkage
@@ -117,12 +163,181 @@ public:
     runPass(unused, NoPassResult, pass3, program, needsLinkage);
     Q_UNUSED(unused);
 
+    program.entryPoint = m_sectionBasePointers.at(".text");
+    if (m_incremental)
+      m_previous = PreviousAssembly{expandedLines, inputSymbols, m_symbolMap,
+                                    program};
+
     result.program = program;
     result.program.sourceHash = sourceHash;
-    result.program.entryPoint = m_sectionBasePointers.at(".text");
     return result;
   }
 
+  AssembleResult
+  assembleFiles(const std::vector<SourceFile> &files,
+                const SymbolMap *symbols = nullptr) const override {
+    HostTrace::Scope traceScope("assembleFiles", "assembler");
+    AssembleResult result;
+    const SymbolMap inputSymbols = symbols ? *symbols : SymbolMap();
+    const auto bases = m_sectionBasePointers;
+
+    // Lay out the objects in the order of the files, (re)assembling those
+    // which changed or cannot be moved to their place in the program.
+    std::vector<const Object *> objects;
+    std::vector<std::map<Section, AInt>> placements;
+    std::vector<unsigned> lineOffsets;
+    std::map<Section, AInt> ends = bases;
+    unsigned lineOffset = 0;
+    QByteArray source;
+    for (const auto &file : files) {
+      std::map<Section, AInt> placement;
+      for (const auto &[section, end] : ends) {
+        const AInt base = bases.at(section);
+        placement[section] = base + alignTo(end - base, c_objectAlignment);
+      }
+      const QString hash = Program::calculateHash(file.text.toUtf8());
+      const QStringList lines = file.text.split(QRegExp("[\r\n]"));
+      source += file.text.toUtf8() + "\n";
+
+      auto it = m_objects.find(file.name);
+      if (it != m_objects.end() && it->second.sourceHash == hash &&
+          sameSymbols(it->second.inputSymbols, inputSymbols) &&
+          (!it->second.placementDependent || it->second.bases == placement)) {
+        m_objectsReused++;
+      } else {
+        Object object;
+        m_trackPlacement = true;
+        const auto objectResult =
+            assembleObject(lines, inputSymbols, placement, object);
+        m_trackPlacement = false;
+        m_objectsAssembled++;
+        if (!objectResult.errors.empty()) {
+          m_objects.erase(file.name);
+          for (const auto &error : objectResult.errors)
+            result.errors.push_back(fileError(file, lineOffset, error));
+          lineOffset += lines.size();
+          continue;
+        }
+        object.sourceHash = hash;
+        object.inputSymbols = inputSymbols;
+        object.lines = lines.size();
+        it = m_objects.insert_or_assign(file.name, std::move(object)).first;
+      }
+      const Object &object = it->second;
+      for (auto &[section, end] : ends)
+        end = placement.at(section) +
+              object.program.sections.at(section).data.size();
+      objects.push_back(&object);
+      placements.push_back(std::move(placement));
+      lineOffsets.push_back(lineOffset);
+      lineOffset += object.lines;
+    }
+    m_sectionBasePointers = bases;
+    // Objects of files which are no longer part of the program are dropped.
+    for (auto it = m_objects.begin(); it != m_objects.end();) {
+      const bool used =
+          std::any_of(files.begin(), files.end(), [&](const SourceFile &file) {
+            return file.name == it->first;
+          });
+      it = used ? std::next(it) : m_objects.erase(it);
+    }
+    if (!result.errors.empty())
+      return result;
+
+    // Create the sections of the program, and merge the symbols of the files.
+    Program program;
+    for (const auto &[name, base] : bases) {
+      ProgramSection section;
+      section.name = name;
+      section.address = base;
+      section.data = QByteArray(ends.at(name) - base, '\0');
+      program.sections[name] = section;
+    }
+    m_symbolMap = inputSymbols;
+    std::map<QString, size_t> definedBy;
+    std::vector<SymbolMap> relativeSymbols(objects.size());
+    for (size_t i = 0; i < objects.size(); ++i) {
+      const Object &object = *objects.at(i);
+      const auto &placement = placements.at(i);
+      for (const auto &[name, section] : object.program.sections) {
+        const AInt offset = placement.at(name) - bases.at(name);
+        program.sections.at(name).data.replace(offset, section.data.size(),
+                                               section.data);
+      }
+      for (const auto &[symbol, value] : object.symbols.abs) {
+        const VIntS relocated = symbol.is(Symbol::Type::Address)
+                                    ? relocate(object, placement, value)
+                                    : value;
+        if (!m_symbolMap.abs.emplace(symbol, relocated).second) {
+          const auto other = definedBy.find(symbol.v);
+          result.errors.push_back(
+              Error(Location::unknown(),
+                    files.at(i).name + ": Multiple definitions of symbol '" +
+                        symbol.v + "'" +
+                        (other != definedBy.end()
+                             ? " (also defined in " +
+                                   files.at(other->second).name + ")"
+                             : QString())));
+          continue;
+        }
+        definedBy[symbol.v] = i;
+      }
+      for (const auto &[symbol, definitions] : object.symbols.rel)
+        for (const auto &[line, value] : definitions)
+          relativeSymbols.at(i).rel[symbol][line] =
+              relocate(object, placement, value);
+
+      const VInt textOffset =
+          placement.at(".text") - object.bases.at(".text");
+      for (const auto &[offset, lines] : object.program.sourceMapping)
+        for (const auto line : lines)
+          program.sourceMapping[offset + textOffset].insert(
+              line + lineOffsets.at(i));
+    }
+    if (!result.errors.empty())
+      return result;
+
+    // Link the requests of each object against the symbols of all files and
+    // its own relative symbols.
+    const AbsoluteSymbolMap allSymbols = m_symbolMap.abs;
+    for (size_t i = 0; i < objects.size(); ++i) {
+      const Object &object = *objects.at(i);
+      LinkRequests needsLinkage = object.needsLinkage;
+      for (auto &request : needsLinkage)
+        request.offset += placements.at(i).at(request.section) -
+                          object.bases.at(request.section);
+      m_symbolMap.abs = allSymbols;
+      m_symbolMap.rel = relativeSymbols.at(i).rel;
+      auto linked = pass3(program, needsLinkage);
+      if (auto *errors = std::get_if<Errors>(&linked))
+        for (const auto &error : *errors)
+          result.errors.push_back(
+              fileError(files.at(i), lineOffsets.at(i), error));
+    }
+    m_symbolMap.abs = allSymbols;
+    m_symbolMap.rel.clear();
+    if (!result.errors.empty())
+      return result;
+
+    // As in pass2, the greatest name of several symbols at an address is kept.
+    for (const auto &iter : m_symbolMap.abs) {
+      if (iter.first.is(Symbol::Type::Address)) {
+        auto it = program.symbols.emplace(iter.second, iter.first).first;
+        if (it->second < iter.first)
+          it->second = iter.first;
+      }
+    }
+    program.entryPoint = bases.at(".text");
+    program.sourceHash = Program::calculateHash(source);
+    result.program = std::move(program);
+    return result;
+  }
+
+  QString configurationKey() const override {
+    return m_isa->name() + ":" + m_isa->enabledExtensions().join(",") + ":" +
+           AssemblerBase::configurationKey();
+  }
+
   DisassembleResult disassemble(const Program &program,
                                 const AInt baseAddress = 0) const override {
     VInt progByteIter = 0;
@@ -151,6 +366,13 @@ public:
     return res;
   }
 
+  unsigned instructionSize(const VInt word) const override {
+    auto match = m_matcher->matchInstruction(word);
+    if (match.isError())
+      return 0;
+    return std::get<const _Instruction *>(match)->size();
+  }
+
   OpDisassembleResult disassemble(const VInt word,
                                   const ReverseSymbolMap &symbols,
                                   const AInt baseAddress = 0) const override {
@@ -233,15 +455,142 @@ protected:
 
   using LinkRequests = std::vector<LinkRequest>;
 
+  /// Number of source lines which pass0 lexes at a time.
+  static constexpr int c_lexBlockLines = 1 << 16;
+
+  static bool sameSourceProgram(const SourceProgram &a,
+                                const SourceProgram &b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                      [](const TokenizedSrcLine &l, const TokenizedSrcLine &r) {
+                        if (l.sourceLine() != r.sourceLine() ||
+                            l.directive != r.directive ||
+                            l.symbols != r.symbols || l.tokens != r.tokens)
+                          return false;
+                        for (int i = 0; i < l.tokens.size(); ++i)
+                          if (l.tokens[i].relocation() !=
+                              r.tokens[i].relocation())
+                            return false;
+                        return true;
+                      });
+  }
+
+  static bool sameSymbols(const SymbolMap &a, const SymbolMap &b) {
+    return a.abs == b.abs && a.rel == b.rel;
+  }
+
+  /// The object of a source file of a multi-file program (see assembleFiles):
+  /// the file assembled at the section base addresses of bases, before
+  /// linkage.
+  struct Object {
+    QString sourceHash;
+    SymbolMap inputSymbols;
+    std::map<Section, AInt> bases;
+    // Set if the object cannot be moved from its bases.
+    bool placementDependent = false;
+    unsigned lines = 0;
+    // The sections and source mapping of the file.
+    Program program;
+    // The symbols defined by the file.
+    SymbolMap symbols;
+    LinkRequests needsLinkage;
+  };
+
+  static AInt alignTo(AInt value, AInt alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+  }
+
+  /// Assembles @p programLines into @p object at the section base addresses
+  /// of @p bases, without linkage. Placement dependence is recorded while
+  /// m_trackPlacement is set.
+  AssembleResult assembleObject(const QStringList &programLines,
+                                const SymbolMap &inputSymbols,
+                                const std::map<Section, AInt> &bases,
+                                Object &object) const {
+    AssembleResult result;
+    m_sectionBasePointers = bases;
+    setCurrentSegment(Location::unknown(), ".text");
+    m_symbolMap = inputSymbols;
+    m_placementDependent = false;
+
+    runPass(tokenizedLines, SourceProgram, pass0, programLines);
+    runPass(expandedLines, SourceProgram, pass1, std::move(tokenizedLines));
+    LinkRequests needsLinkage;
+    runPass(program, Program, pass2, expandedLines, needsLinkage);
+
+    object.bases = bases;
+    object.placementDependent = m_placementDependent;
+    object.program = std::move(program);
+    object.needsLinkage = std::move(needsLinkage);
+    for (const auto &iter : m_symbolMap.abs)
+      if (inputSymbols.abs.count(iter.first) == 0)
+        object.symbols.abs.insert(iter);
+    object.symbols.rel = m_symbolMap.rel;
+    return result;
+  }
+
+  /// Returns the address @p value of a label of @p object, moved with the
+  /// section which contains it to @p placement.
+  static VIntS relocate(const Object &object,
+                        const std::map<Section, AInt> &placement,
+                        VIntS value) {
+    // Labels lie within (or at the end of) the section with the greatest base
+    // address not above them.
+    const Section *containing = nullptr;
+    for (const auto &[section, base] : object.bases) {
+      const AInt end =
+          base + object.program.sections.at(section).data.size();
+      if (base <= static_cast<AInt>(value) && static_cast<AInt>(value) <= end &&
+          (!containing || base > object.bases.at(*containing)))
+        containing = &section;
+    }
+    if (!containing)
+      return value;
+    return value - object.bases.at(*containing) + placement.at(*containing);
+  }
+
+  /// Returns @p error of @p file, at its line in the concatenation of the
+  /// files starting at @p lineOffset.
+  static Error fileError(const SourceFile &file, unsigned lineOffset,
+                         const Error &error) {
+    const Location location =
+        error.isKnownSourceLine()
+            ? Location(error.sourceLine() + lineOffset)
+            : Location::unknown();
+    return Error(location, file.name + ": " + error.errorMessage());
+  }
+
+  /**
+   * @brief lexLine
+   * Tokenizes @p line, strips its comment and splits the symbols which it
+   * defines from the remaining tokens. Independent of any other line.
+   */
+  Result<SymbolLinePair> lexLine(unsigned index, const QString &line) const {
+    const Location location(index);
+    auto tokens = tokenize(location, line);
+    if (tokens.isError())
+      return tokens.error();
+    auto remainingTokens = splitCommentFromLine(tokens.value());
+    if (remainingTokens.isError())
+      return remainingTokens.error();
+    return splitSymbolsFromLine(location, remainingTokens.value());
+  }
+
   /**
    * @brief pass0
-   * Line tokenization and source line recording
+   * Line tokenization and source line recording. Lines are lexed in parallel
+   * (see lexLine); the remainder of the pass, which depends on preceding
+   * lines, is serial, such that errors are reported in source order.
+   * The program is processed in blocks of c_lexBlockLines lines, such that
+   * only the lexed lines of a single block are held besides the tokenized
+   * program. Within a chunk of a block, equal tokens are interned to share the
+   * data of a single string.
    */
   std::variant<Errors, SourceProgram> pass0(const QStringList &program) const {
     Errors errors;
     SourceProgram tokenizedLines;
     tokenizedLines.reserve(program.size());
     Symbols symbols;
+    QHash<QString, SymbolLinePair> lexCache;
 
     /** @brief carry
      * A symbol should refer to the next following assembler line; whether an
@@ -252,81 +601,139 @@ protected:
      * line).
      */
     Symbols carry;
-    for (auto line : llvm::enumerate(program)) {
-      if (line.value().isEmpty())
-        continue;
-      TokenizedSrcLine tsl(line.index());
-      runOperation(tokens, tokenize, tsl, line.value());
-
-      runOperation(remainingTokens, splitCommentFromLine, tokens);
-
-      // Symbols precede directives
-      runOperation(symbolsAndRest, splitSymbolsFromLine, tsl, remainingTokens);
-
-      tsl.symbols = symbolsAndRest.first;
-
-      bool uniqueSymbols = true;
-      for (const auto &s : symbolsAndRest.first) {
-        if (!s.isLegal())
-          errors.push_back(Error(tsl, "Illegal symbol '" + s.v + "'"));
-
-        if (!s.isLocal() && symbols.count(s) != 0) {
-          errors.push_back(
-              Error(tsl, "Multiple definitions of symbol '" + s.v + "'"));
-          uniqueSymbols = false;
-          break;
+    std::vector<std::optional<Result<SymbolLinePair>>> lexedLines;
+    for (int block = 0; block < program.size(); block += c_lexBlockLines) {
+      const int blockEnd =
+          std::min<int>(program.size(), block + c_lexBlockLines);
+      lexedLines.assign(blockEnd - block, std::nullopt);
+      forEachChunk(blockEnd - block, [&](size_t begin, size_t end) {
+        QSet<QString> interned;
+        for (size_t i = begin; i < end; ++i) {
+          const QString &line = program.at(block + i);
+          if (line.isEmpty())
+            continue;
+          // Lexing is independent of the line index, unless it fails.
+          auto cached = m_lexCache.constFind(line);
+          if (cached != m_lexCache.constEnd()) {
+            lexedLines[i] = Result<SymbolLinePair>(cached.value());
+            continue;
+          }
+          lexedLines[i] = lexLine(block + i, line);
+          if (lexedLines[i]->isError())
+            continue;
+          for (auto &token : lexedLines[i]->value().second) {
+            auto it = interned.constFind(token);
+            if (it != interned.constEnd())
+              static_cast<QString &>(token) = *it;
+            else
+              interned.insert(token);
+          }
+        }
+      });
+      if (m_incremental) {
+        for (int i = block; i < blockEnd; ++i) {
+          auto &lexedLine = lexedLines[i - block];
+          if (lexedLine && lexedLine->isResult())
+            lexCache.insert(program.at(i), lexedLine->value());
         }
       }
-      if (!uniqueSymbols) {
-        continue;
-      }
-      symbols.insert(symbolsAndRest.first.begin(), symbolsAndRest.first.end());
-
-      runOperation(directiveAndRest, splitDirectivesFromLine, tsl,
-                   symbolsAndRest.second);
-      tsl.directive = directiveAndRest.first;
 
-      // Parse (and remove) relocation hints from the tokens.
-      runOperation(finalTokens, splitRelocationsFromLine,
-                   directiveAndRest.second);
-
-      tsl.tokens = finalTokens;
-      if (tsl.tokens.empty() && tsl.directive.isEmpty()) {
-        if (!tsl.symbols.empty()) {
-          carry.insert(tsl.symbols.begin(), tsl.symbols.end());
+      for (int index = block; index < blockEnd; ++index) {
+        auto &lexedLineOpt = lexedLines[index - block];
+        if (!lexedLineOpt)
+          continue;
+        TokenizedSrcLine tsl(index);
+        // Symbols precede directives
+        auto &lexedLine = *lexedLineOpt;
+        if (lexedLine.isError()) {
+          errors.push_back(lexedLine.error());
+          continue;
+        }
+        auto &symbolsAndRest = lexedLine.value();
+
+        bool uniqueSymbols = true;
+        for (const auto &s : symbolsAndRest.first) {
+          if (!s.isLegal())
+            errors.push_back(Error(tsl, "Illegal symbol '" + s.v + "'"));
+
+          if (!s.isLocal() && symbols.count(s) != 0) {
+            errors.push_back(
+                Error(tsl, "Multiple definitions of symbol '" + s.v + "'"));
+            uniqueSymbols = false;
+            break;
+          }
+        }
+        if (!uniqueSymbols) {
+          continue;
+        }
+        symbols.insert(symbolsAndRest.first.begin(),
+                       symbolsAndRest.first.end());
+        tsl.symbols = std::move(symbolsAndRest.first);
+
+        runOperation(directiveAndRest, splitDirectivesFromLine, tsl,
+                     symbolsAndRest.second);
+        tsl.directive = directiveAndRest.first;
+
+        // Parse (and remove) relocation hints from the tokens.
+        runOperation(finalTokens, splitRelocationsFromLine,
+                     directiveAndRest.second);
+
+        tsl.tokens = finalTokens;
+        const bool isBlank = tsl.tokens.empty() && tsl.directive.isEmpty();
+        if (isBlank) {
+          if (!tsl.symbols.empty()) {
+            carry.insert(tsl.symbols.begin(), tsl.symbols.end());
+          }
+        } else {
+          tsl.symbols.insert(carry.begin(), carry.end());
+          carry.clear();
         }
-      } else {
-        tsl.symbols.insert(carry.begin(), carry.end());
-        carry.clear();
-        tokenizedLines.push_back(tsl);
-      }
 
-      if (!tsl.directive.isEmpty() && m_earlyDirectives.count(tsl.directive)) {
-        bool wasDirective; // unused
-        runOperation(directiveBytes, assembleDirective,
-                     DirectiveArg{tsl, nullptr}, wasDirective, false);
+        if (!tsl.directive.isEmpty() &&
+            m_earlyDirectives.count(tsl.directive)) {
+          bool wasDirective; // unused
+          runOperation(directiveBytes, assembleDirective,
+                       DirectiveArg{tsl, nullptr}, wasDirective, false);
+        }
+        if (!isBlank)
+          tokenizedLines.push_back(std::move(tsl));
       }
     }
+    if (m_incremental) {
+      // Retain the lines of this assembly only, such that the cache is bounded
+      // by the size of the program.
+      m_lexCache = std::move(lexCache);
+    }
 
     if (!errors.empty()) {
       return {errors};
     } else {
-      return {tokenizedLines};
+      return {std::move(tokenizedLines)};
     }
   }
 
   /**
    * @brief pass1
-   * Pseudo-op expansion. If @return errors is empty, pass succeeded.
+   * Pseudo-op expansion. If @return errors is empty, pass succeeded. Lines are
+   * expanded in parallel, and collected in source order. @p tokenizedLines is
+   * consumed, such that lines which are not pseudo-ops are moved rather than
+   * copied.
    */
   std::variant<Errors, SourceProgram>
-  pass1(const SourceProgram &tokenizedLines) const {
+  pass1(SourceProgram tokenizedLines) const {
     Errors errors;
     SourceProgram expandedLines;
     expandedLines.reserve(tokenizedLines.size());
 
+    std::vector<std::optional<Result<std::vector<LineTokens>>>> expansions(
+        tokenizedLines.size());
+    forEachChunk(tokenizedLines.size(), [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i)
+        expansions[i] = expandPseudoOp(tokenizedLines[i]);
+    });
+
     for (auto tokenizedLine : llvm::enumerate(tokenizedLines)) {
-      auto expandedOps = expandPseudoOp(tokenizedLine.value());
+      auto &expandedOps = *expansions[tokenizedLine.index()];
       if (expandedOps.isResult()) {
         /** @note: Original source line is kept for all resulting lines after
          * pseudo-op expantion. Labels and directives are only kept for the
@@ -345,14 +752,14 @@ protected:
       } else {
         // This was not a pseudoinstruction; just add line to the set of
         // expanded lines
-        expandedLines.push_back(tokenizedLine.value());
+        expandedLines.push_back(std::move(tokenizedLine.value()));
       }
     }
 
     if (errors.size() != 0) {
       return {errors};
     } else {
-      return {expandedLines};
+      return {std::move(expandedLines)};
     }
   }
 
@@ -446,7 +853,11 @@ protected:
     /// @todo: also consider relative symbols here.
     for (const auto &iter : m_symbolMap.abs) {
       if (iter.first.is(Symbol::Type::Address)) {
-        program.symbols[iter.second] = iter.first;
+        // Of several symbols at the same address, the greatest name is kept,
+        // independent of the order of the symbol map.
+        auto it = program.symbols.emplace(iter.second, iter.first).first;
+        if (it->second < iter.first)
+          it->second = iter.first;
       }
     }
 
@@ -664,6 +1075,20 @@ protected:
   std::unique_ptr<_Matcher> m_matcher;
 
   const ISAInfoBase *m_isa;
+
+  /// State retained between assemblies when assembling incrementally (see
+  /// AssemblerBase::setIncremental): the lexed lines of the previous program,
+  /// keyed by their source text, and the previous assembly.
+  struct PreviousAssembly {
+    SourceProgram expandedLines;
+    SymbolMap inputSymbols;
+    SymbolMap symbolMap;
+    Program program;
+  };
+  mutable QHash<QString, SymbolLinePair> m_lexCache;
+  mutable std::optional<PreviousAssembly> m_previous;
+  /// The objects of the files of multi-file programs, by file name.
+  mutable std::map<QString, Object> m_objects;
 };
 
 } // namespace Assembler
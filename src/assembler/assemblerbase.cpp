@@ -36,18 +36,51 @@ AssembleResult AssemblerBase::assembleRaw(const QString &program,
                   Program::calculateHash(program.toUtf8()));
 }
 
+QString AssemblerBase::configurationKey() const {
+  QStringList segments;
+  for (const auto &[section, base] : m_sectionBasePointers)
+    segments << section + "=" + QString::number(base, 16);
+  return segments.join(",");
+}
+
 /// Resolves an expression through either the built-in symbol map, or through
 /// the expression evaluator.
 ExprEvalRes AssemblerBase::evalExpr(const Location &location,
                                     const QString &expr) const {
-  auto relativeMap = m_symbolMap.copyRelativeTo(location.sourceLine());
-
-  auto symbolValue = relativeMap.find(expr);
-  if (symbolValue != relativeMap.end()) {
-    return symbolValue->second;
+  const unsigned line = location.sourceLine();
+  if (m_trackPlacement && !m_placementDependent)
+    m_placementDependent = referencesAddress(expr);
+  if (auto symbolValue = m_symbolMap.lookup(expr, line)) {
+    return *symbolValue;
   } else {
-    return evaluate(location, expr, &relativeMap);
+    return evaluate(location, expr, m_symbolMap, line);
+  }
+}
+
+bool AssemblerBase::referencesAddress(const QString &expr) const {
+  static const QRegularExpression s_operandSplitter(R"([^\w.$]+)");
+  static const QRegularExpression s_relativeLabel(R"(^\d+[bf]$)");
+  for (const auto &operand :
+       expr.split(s_operandSplitter, Qt::SkipEmptyParts)) {
+    if (operand.front().isDigit()) {
+      // Numeric literals, or references to relative (numeric) labels.
+      if (s_relativeLabel.match(operand).hasMatch())
+        return true;
+      continue;
+    }
+    auto symbol = m_symbolMap.abs.find(Symbol(operand));
+    if (symbol != m_symbolMap.abs.end() &&
+        symbol->first.is(Symbol::Type::Address))
+      return true;
   }
+  return false;
+}
+
+void AssemblerBase::noteAlignment(int boundary) const {
+  // Objects are moved by multiples of c_objectAlignment, which preserves the
+  // padding of alignments dividing it.
+  if (m_trackPlacement && c_objectAlignment % boundary != 0)
+    m_placementDependent = true;
 }
 
 void AssemblerBase::setDirectives(const DirectiveVec &directives) {
@@ -21,6 +21,13 @@ struct OpDisassembleResult {
   std::optional<Error> err;
 };
 
+/// A source file of a program assembled from several files (see
+/// AssemblerBase::assembleFiles).
+struct SourceFile {
+  QString name;
+  QString text;
+};
+
 ///  Base class for a Ripes assembler.
 class AssemblerBase {
 public:
@@ -43,6 +50,53 @@ public:
   AssembleResult assembleRaw(const QString &program,
                              const SymbolMap *symbols = nullptr) const;
 
+  /**
+   * @brief assembleFiles
+   * Assembles a program from several source files. Each file is assembled
+   * separately into an object, and the objects are linked: the sections of
+   * each file follow those of the preceding file, aligned to
+   * c_objectAlignment bytes, and the symbols of each file are visible to the
+   * link requests of all files. The program starts at the text section of the
+   * first file.
+   *
+   * The object of each file is retained by the assembler, keyed by the name of
+   * the file. A file which is unchanged since it was last assembled is only
+   * relocated to its place in the program, unless its object depends on its
+   * placement (an address evaluated by a directive, ie. `.word label`, or an
+   * alignment of more than c_objectAlignment bytes), in which case it is
+   * reassembled when moved.
+   *
+   * Source lines (of errors and of the source mapping) are those of the
+   * concatenation of the files, and errors are prefixed with the name of their
+   * file.
+   */
+  virtual AssembleResult
+  assembleFiles(const std::vector<SourceFile> &files,
+                const SymbolMap *symbols = nullptr) const = 0;
+  /// The number of objects assembled, and reused without reassembly, by
+  /// assembleFiles.
+  unsigned long long objectsAssembled() const { return m_objectsAssembled; }
+  unsigned long long objectsReused() const { return m_objectsReused; }
+  /// Alignment, in bytes, of the sections of each object of a multi-file
+  /// program.
+  static constexpr unsigned c_objectAlignment = 16;
+
+  /// Records an alignment of @p boundary bytes applied by a directive to the
+  /// program being assembled (see assembleFiles).
+  void noteAlignment(int boundary) const;
+
+  /// Enables incremental assembly, for repeatedly assembling a program while it
+  /// is being edited. Lines which are unchanged since the previous assembly are
+  /// not tokenized again, and if the program is unchanged after pseudo-op
+  /// expansion (an edit of comments or whitespace), the program of the
+  /// previous assembly is reused without translation and linkage.
+  void setIncremental(bool incremental) { m_incremental = incremental; }
+
+  /// Returns a key identifying the configuration of this assembler, which
+  /// together with the source program and predefined symbols determines the
+  /// result of assembling.
+  virtual QString configurationKey() const;
+
   /// Disassembles an input program relative to the provided base address.
   virtual DisassembleResult disassemble(const Program &program,
                                         const AInt baseAddress = 0) const = 0;
@@ -53,6 +107,10 @@ public:
                                           const ReverseSymbolMap &symbols,
                                           const AInt baseAddress = 0) const = 0;
 
+  /// Returns the size, in bytes, of the instruction encoded by @p word, or 0 if
+  /// @p word does not decode. Cheaper than disassembling @p word.
+  virtual unsigned instructionSize(const VInt word) const = 0;
+
   /// Returns the set of opcodes (as strings) which are supported by this
   /// assembler.
   virtual std::set<QString> getOpcodes() const = 0;
@@ -60,6 +118,9 @@ public:
   /// Resolves an expression through either the built-in symbol map, or through
   /// the expression evaluator.
   ExprEvalRes evalExpr(const Location &location, const QString &expr) const;
+  /// Returns true if @p expr references a label, whose value depends on the
+  /// placement of the program.
+  bool referencesAddress(const QString &expr) const;
 
   /// Set the supported directives for this assembler.
   void setDirectives(const DirectiveVec &directives);
@@ -106,7 +167,9 @@ protected:
    * @brief m_sectionBasePointers maintains the base position for the segments
    * annoted by the Segment enum class.
    */
-  std::map<Section, AInt> m_sectionBasePointers;
+  /// Marked mutable such that the objects of multi-file programs are assembled
+  /// at their place in the program (see assembleFiles).
+  mutable std::map<Section, AInt> m_sectionBasePointers;
   /**
    * @brief m_currentSegment maintains the current segment where the assembler
    * emits information. Marked mutable to allow for switching currently selected
@@ -121,6 +184,15 @@ protected:
   DirectiveVec m_directives;
   DirectiveMap m_directivesMap;
   EarlyDirectives m_earlyDirectives;
+
+  bool m_incremental = false;
+
+  /// Set while assembling an object (see assembleFiles), for which directives
+  /// record whether the object depends on its placement.
+  mutable bool m_trackPlacement = false;
+  mutable bool m_placementDependent = false;
+  mutable unsigned long long m_objectsAssembled = 0;
+  mutable unsigned long long m_objectsReused = 0;
 };
 
 } // namespace Assembler
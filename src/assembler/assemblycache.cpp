@@ -0,0 +1,164 @@
+#include "assemblycache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+
+#include <algorithm>
+
+namespace Ripes {
+namespace Assembler {
+
+namespace {
+// Identifies (the version of) the format of programs cached on disk.
+constexpr quint32 c_diskMagic = 0x52504143; // "RPAC"
+constexpr quint32 c_diskVersion = 1;
+
+// Bound on the total size of the sections of the programs cached in memory.
+constexpr int c_maxCostKiB = 64 * 1024;
+
+QString cacheKey(const AssemblerBase &assembler, const QString &program,
+                 const SymbolMap *symbols) {
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  const auto addField = [&](const QByteArray &field) {
+    hash.addData(field);
+    hash.addData("\0", 1);
+  };
+  addField(program.toUtf8());
+  addField(assembler.configurationKey().toUtf8());
+  if (symbols) {
+    // Symbol maps are unordered; hash them in order.
+    const std::map<Symbol, VIntS> abs(symbols->abs.begin(), symbols->abs.end());
+    const std::map<SymbolMap::RelativeSymbol,
+                   std::map<SymbolMap::SourceLine, VIntS>>
+        rel(symbols->rel.begin(), symbols->rel.end());
+    for (const auto &[symbol, value] : abs)
+      addField(symbol.v.toUtf8() + ":" + QByteArray::number(symbol.type) +
+               "=" + QByteArray::number(static_cast<qlonglong>(value)));
+    for (const auto &[symbol, lines] : rel)
+      for (const auto &[line, value] : lines)
+        addField(QByteArray::number(symbol) + "@" + QByteArray::number(line) +
+                 "=" + QByteArray::number(static_cast<qlonglong>(value)));
+  }
+  return hash.result().toHex();
+}
+
+int programCost(const Program &program) {
+  qint64 bytes = 0;
+  for (const auto &it : program.sections)
+    bytes += it.second.data.size();
+  return static_cast<int>(std::max<qint64>(1, bytes / 1024));
+}
+} // namespace
+
+AssemblyCache::AssemblyCache() { m_programs.setMaxCost(c_maxCostKiB); }
+
+AssembleResult AssemblyCache::assemble(const AssemblerBase &assembler,
+                                       const QString &program,
+                                       const SymbolMap *symbols) {
+  const QString key = cacheKey(assembler, program, symbols);
+  AssembleResult result;
+  if (const Program *cached = m_programs.object(key)) {
+    m_hits++;
+    result.program = *cached;
+    return result;
+  }
+  if (auto stored = loadFromDisk(key)) {
+    m_hits++;
+    result.program = *stored;
+    m_programs.insert(key, new Program(*stored), programCost(*stored));
+    return result;
+  }
+
+  m_misses++;
+  result = assembler.assembleRaw(program, symbols);
+  if (result.errors.empty()) {
+    m_programs.insert(key, new Program(result.program),
+                      programCost(result.program));
+    storeToDisk(key, result.program);
+  }
+  return result;
+}
+
+std::optional<Program> AssemblyCache::loadFromDisk(const QString &key) const {
+  if (m_diskCacheDir.isEmpty())
+    return {};
+  QFile file(QDir(m_diskCacheDir).filePath(key + ".program"));
+  if (!file.open(QIODevice::ReadOnly))
+    return {};
+
+  QDataStream in(&file);
+  quint32 magic, version;
+  in >> magic >> version;
+  if (magic != c_diskMagic || version != c_diskVersion)
+    return {};
+
+  Program program;
+  quint64 entryPoint;
+  quint32 nSections, nSymbols, nMappings;
+  in >> entryPoint >> program.sourceHash >> nSections;
+  program.entryPoint = entryPoint;
+  for (quint32 i = 0; i < nSections && in.status() == QDataStream::Ok; ++i) {
+    ProgramSection section;
+    quint64 address;
+    in >> section.name >> address >> section.data;
+    section.address = address;
+    program.sections[section.name] = section;
+  }
+  in >> nSymbols;
+  for (quint32 i = 0; i < nSymbols && in.status() == QDataStream::Ok; ++i) {
+    quint64 address;
+    Symbol symbol;
+    quint32 type;
+    in >> address >> symbol.v >> type;
+    symbol.type = type;
+    program.symbols[address] = symbol;
+  }
+  in >> nMappings;
+  for (quint32 i = 0; i < nMappings && in.status() == QDataStream::Ok; ++i) {
+    quint64 address;
+    QList<quint32> lines;
+    in >> address >> lines;
+    program.sourceMapping[address] =
+        std::set<unsigned>(lines.begin(), lines.end());
+  }
+  if (in.status() != QDataStream::Ok)
+    return {};
+  return program;
+}
+
+void AssemblyCache::storeToDisk(const QString &key,
+                                const Program &program) const {
+  if (m_diskCacheDir.isEmpty() || !QDir().mkpath(m_diskCacheDir))
+    return;
+  // Written through a QSaveFile, such that concurrent Ripes processes never
+  // read a partially written program.
+  QSaveFile file(QDir(m_diskCacheDir).filePath(key + ".program"));
+  if (!file.open(QIODevice::WriteOnly))
+    return;
+
+  QDataStream out(&file);
+  out << c_diskMagic << c_diskVersion;
+  out << static_cast<quint64>(program.entryPoint) << program.sourceHash
+      << static_cast<quint32>(program.sections.size());
+  for (const auto &it : program.sections)
+    out << it.second.name << static_cast<quint64>(it.second.address)
+        << it.second.data;
+  out << static_cast<quint32>(program.symbols.size());
+  for (const auto &it : program.symbols)
+    out << static_cast<quint64>(it.first) << it.second.v
+        << static_cast<quint32>(it.second.type);
+  out << static_cast<quint32>(program.sourceMapping.size());
+  for (const auto &it : program.sourceMapping) {
+    QList<quint32> lines;
+    for (const auto line : it.second)
+      lines << line;
+    out << static_cast<quint64>(it.first) << lines;
+  }
+  file.commit();
+}
+
+} // namespace Assembler
+} // namespace Ripes
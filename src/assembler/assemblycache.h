@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QCache>
+#include <QString>
+
+#include "assemblerbase.h"
+
+namespace Ripes {
+namespace Assembler {
+
+/**
+ * @brief The AssemblyCache class
+ * A content-addressed cache of assembled programs. Programs are keyed on a
+ * hash of their source, the configuration of the assembler which assembled
+ * them (ISA, extensions and segment base addresses; see
+ * AssemblerBase::configurationKey) and the predefined symbols, such that
+ * reassembling an unchanged source returns the earlier result.
+ *
+ * Programs are cached in memory, bounded by the size of their sections, and
+ * optionally in a directory on disk, where they are shared between Ripes
+ * processes. Only programs which assembled without errors are cached.
+ */
+class AssemblyCache {
+public:
+  static AssemblyCache &get() {
+    static AssemblyCache cache;
+    return cache;
+  }
+
+  /// Assembles @p program using @p assembler and the predefined @p symbols,
+  /// or returns the cached result of an earlier, identical assembly.
+  AssembleResult assemble(const AssemblerBase &assembler,
+                          const QString &program,
+                          const SymbolMap *symbols = nullptr);
+
+  /// Sets the directory in which programs are cached on disk. An empty path
+  /// disables the disk cache.
+  void setDiskCacheDirectory(const QString &path) { m_diskCacheDir = path; }
+
+  void clear() { m_programs.clear(); }
+  unsigned long long hits() const { return m_hits; }
+  unsigned long long misses() const { return m_misses; }
+
+private:
+  AssemblyCache();
+
+  std::optional<Program> loadFromDisk(const QString &key) const;
+  void storeToDisk(const QString &key, const Program &program) const;
+
+  // Cached programs; the cost of each is the size of its sections in KiB.
+  QCache<QString, Program> m_programs;
+  QString m_diskCacheDir;
+  unsigned long long m_hits = 0;
+  unsigned long long m_misses = 0;
+};
+
+} // namespace Assembler
+} // namespace Ripes
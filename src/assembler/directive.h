@@ -4,6 +4,8 @@
 #include <QString>
 #include <functional>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
 #include <variant>
 
 #include "assembler_defines.h"
@@ -55,8 +57,8 @@ private:
 };
 
 using DirectivePtr = std::shared_ptr<Directive>;
-using DirectiveMap = std::map<QString, DirectivePtr>;
+using DirectiveMap = std::unordered_map<QString, DirectivePtr, QStringHash>;
 using DirectiveVec = std::vector<DirectivePtr>;
-using EarlyDirectives = std::set<QString>;
+using EarlyDirectives = std::unordered_set<QString, QStringHash>;
 } // namespace Assembler
 } // namespace Ripes
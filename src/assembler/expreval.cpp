@@ -1,7 +1,12 @@
 #include "expreval.h"
 
+#include <QHash>
+
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <vector>
 
 #include "assembler_defines.h"
 #include "binutils.h"
@@ -230,90 +235,232 @@ ExprRes parseLeft(const Location &loc, const QString &s, int &pos, int &depth) {
   }
 }
 
-VIntS evaluate(const std::shared_ptr<Expr> &expr,
-               const AbsoluteSymbolMap *variables) {
+/**
+ * @brief The ExprOp struct
+ * An operation of a compiled expression. Expressions are compiled into
+ * postfix order: operands are pushed onto a stack, and operators replace the
+ * topmost two operands with their result.
+ */
+struct ExprOp {
+  enum Kind { Const, Symbol, Add, Sub, Mul, Div, Mod, And, Or, SignExtend };
+  Kind kind;
+  VIntS value = 0;
+  QString symbol;
+  // Index of the symbol within CompiledExpr::symbols().
+  unsigned slot = 0;
+};
+
+template <typename BinOp>
+bool compileBinOp(const std::shared_ptr<Expr> &expr, ExprOp::Kind kind,
+                  ExprCode &code);
+
+void compile(const std::shared_ptr<Expr> &expr, ExprCode &code) {
   // There is a bug in GCC for variant visitors on incomplete variant types
   // (recursive), So instead we'll macro our way towards something that looks
   // like a pattern match for the variant type.
-  IfExpr(Add, v) {
-    return evaluate(v->lhs, variables) + evaluate(v->rhs, variables);
-  }
-  FiExpr;
-  IfExpr(Div, v) {
-    return evaluate(v->lhs, variables) / evaluate(v->rhs, variables);
-  }
-  FiExpr;
-  IfExpr(Mul, v) {
-    return evaluate(v->lhs, variables) * evaluate(v->rhs, variables);
-  }
-  FiExpr;
-  IfExpr(Sub, v) {
-    return evaluate(v->lhs, variables) - evaluate(v->rhs, variables);
-  }
-  FiExpr;
-  IfExpr(Mod, v) {
-    return evaluate(v->lhs, variables) % evaluate(v->rhs, variables);
-  }
-  FiExpr;
-  IfExpr(And, v) {
-    return evaluate(v->lhs, variables) & evaluate(v->rhs, variables);
-  }
-  FiExpr;
-  IfExpr(Or, v) {
-    return evaluate(v->lhs, variables) | evaluate(v->rhs, variables);
-  }
-  FiExpr;
-  IfExpr(SignExtend, v) {
-    return vsrtl::signextend(evaluate(v->lhs, variables),
-                             evaluate(v->rhs, variables));
-  }
-  FiExpr;
+  if (compileBinOp<Add>(expr, ExprOp::Add, code) ||
+      compileBinOp<Div>(expr, ExprOp::Div, code) ||
+      compileBinOp<Mul>(expr, ExprOp::Mul, code) ||
+      compileBinOp<Sub>(expr, ExprOp::Sub, code) ||
+      compileBinOp<Mod>(expr, ExprOp::Mod, code) ||
+      compileBinOp<And>(expr, ExprOp::And, code) ||
+      compileBinOp<Or>(expr, ExprOp::Or, code) ||
+      compileBinOp<SignExtend>(expr, ExprOp::SignExtend, code))
+    return;
   IfExpr(Nothing, v) {
     Q_UNUSED(v);
-    return 0;
+    code.push_back({ExprOp::Const, 0, QString()});
+    return;
   }
   FiExpr;
   IfExpr(Literal, v) {
+    // Immediates are resolved upon compilation, symbols upon evaluation.
     bool ok = false;
     auto value = getImmediate(v->v, ok);
-    if (!ok) {
-      if (variables != nullptr) {
-        auto it = variables->find(v->v);
-        if (it != variables->end()) {
-          value = it->second;
-          ok = true;
-        }
+    if (ok)
+      code.push_back({ExprOp::Const, value, QString()});
+    else
+      code.push_back({ExprOp::Symbol, 0, v->v});
+    return;
+  }
+  FiExpr;
+
+  Q_UNREACHABLE();
+}
+
+template <typename BinOp>
+bool compileBinOp(const std::shared_ptr<Expr> &expr, ExprOp::Kind kind,
+                  ExprCode &code) {
+  IfExpr(BinOp, v) {
+    compile(v->lhs, code);
+    compile(v->rhs, code);
+    code.push_back({kind, 0, QString()});
+    return true;
+  }
+  FiExpr;
+  return false;
+}
+
+/// Evaluates @p code, resolving the symbol operations through @p lookup, which
+/// returns an std::optional<VIntS>. Division by zero and overflowing division
+/// yield the results of RISC-V division.
+template <typename Lookup>
+ExprEvalRes evaluate(const Location &loc, const ExprCode &code,
+                     const Lookup &lookup) {
+  std::vector<VIntS> stack;
+  stack.reserve(code.size());
+  for (const auto &op : code) {
+    if (op.kind == ExprOp::Const) {
+      stack.push_back(op.value);
+      continue;
+    }
+    if (op.kind == ExprOp::Symbol) {
+      if (const std::optional<VIntS> value = lookup(op)) {
+        stack.push_back(*value);
+        continue;
       }
+      return {Error(loc, QString("Unknown symbol '%1'").arg(op.symbol))};
     }
 
-    if (!ok) {
-      throw std::runtime_error(
-          QString("Unknown symbol '%1'").arg(v->v).toStdString());
+    const VIntS rhs = stack.back();
+    stack.pop_back();
+    VIntS &lhs = stack.back();
+    switch (op.kind) {
+    case ExprOp::Add:
+      lhs = lhs + rhs;
+      break;
+    case ExprOp::Sub:
+      lhs = lhs - rhs;
+      break;
+    case ExprOp::Mul:
+      lhs = lhs * rhs;
+      break;
+    case ExprOp::Div:
+      if (rhs == 0)
+        lhs = -1;
+      else if (rhs != -1 || lhs != std::numeric_limits<VIntS>::min())
+        lhs = lhs / rhs;
+      break;
+    case ExprOp::Mod:
+      if (rhs == -1)
+        lhs = 0;
+      else if (rhs != 0)
+        lhs = lhs % rhs;
+      break;
+    case ExprOp::And:
+      lhs = lhs & rhs;
+      break;
+    case ExprOp::Or:
+      lhs = lhs | rhs;
+      break;
+    case ExprOp::SignExtend:
+      lhs = vsrtl::signextend(lhs, rhs);
+      break;
+    default:
+      Q_UNREACHABLE();
     }
+  }
+  assert(stack.size() == 1);
+  return {stack.back()};
+}
+
+// Bound on the number of compiled expressions cached by each thread.
+constexpr int c_maxCachedExprs = 4096;
 
-    return value;
+/// Parses and compiles @p s, which holds no whitespace.
+Result<ExprCode> compileExpr(const Location &loc, const QString &s) {
+  int pos = 0;
+  int depth = 0;
+  auto exprTree = parseLeft(loc, s, pos, depth);
+  if (auto *err = std::get_if<Error>(&exprTree)) {
+    return *err;
   }
-  FiExpr;
+  ExprCode code;
+  compile(std::get<std::shared_ptr<Expr>>(exprTree), code);
+  return code;
+}
 
-  Q_UNREACHABLE();
+/// Returns the compiled expression @p s. The expression remains valid until the
+/// next expression is compiled.
+Result<const ExprCode *> compile(const Location &loc, const QString &s) {
+  QString sNoWhitespace = s;
+  sNoWhitespace.replace(" ", "");
+
+  // Expressions are compiled once, and cached by their text, such that
+  // repeated evaluations only bind the values of symbols. Only expressions
+  // which parse are cached, so parse errors are reported at each location.
+  thread_local QHash<QString, ExprCode> compiled;
+  auto it = compiled.constFind(sNoWhitespace);
+  if (it != compiled.constEnd())
+    return &it.value();
+
+  auto code = compileExpr(loc, sNoWhitespace);
+  if (code.isError())
+    return code.error();
+  if (compiled.size() >= c_maxCachedExprs)
+    compiled.clear();
+  return &compiled.insert(sNoWhitespace, code.value()).value();
+}
+
+template <typename Lookup>
+ExprEvalRes compileAndEvaluate(const Location &loc, const QString &s,
+                               const Lookup &lookup) {
+  auto code = compile(loc, s);
+  if (code.isError())
+    return code.error();
+  return evaluate(loc, *code.value(), lookup);
 }
 
 ExprEvalRes evaluate(const Location &loc, const QString &s,
                      const AbsoluteSymbolMap *variables) {
+  return compileAndEvaluate(
+      loc, s, [variables](const ExprOp &op) -> std::optional<VIntS> {
+        if (variables != nullptr) {
+          auto it = variables->find(op.symbol);
+          if (it != variables->end())
+            return it->second;
+        }
+        return {};
+      });
+}
+
+ExprEvalRes evaluate(const Location &loc, const QString &s,
+                     const SymbolMap &symbols, unsigned line) {
+  return compileAndEvaluate(loc, s, [&](const ExprOp &op) {
+    return symbols.lookup(op.symbol, line);
+  });
+}
+
+Result<CompiledExpr> CompiledExpr::compile(const Location &loc,
+                                           const QString &s) {
   QString sNoWhitespace = s;
   sNoWhitespace.replace(" ", "");
-  int pos = 0;
-  int depth = 0;
-  auto exprTree = parseLeft(loc, sNoWhitespace, pos, depth);
-  if (auto *err = std::get_if<Error>(&exprTree)) {
-    return *err;
-  }
-  const auto exprTreeRes = std::get<std::shared_ptr<Expr>>(exprTree);
-  try {
-    return {evaluate(exprTreeRes, variables)};
-  } catch (const std::runtime_error &e) {
-    return {Error(loc, e.what())};
+  auto code = compileExpr(loc, sNoWhitespace);
+  if (code.isError())
+    return code.error();
+
+  CompiledExpr expr;
+  auto ops = std::make_shared<ExprCode>(code.value());
+  for (auto &op : *ops) {
+    if (op.kind != ExprOp::Symbol)
+      continue;
+    auto &symbols = expr.m_symbols;
+    auto it = std::find(symbols.begin(), symbols.end(), op.symbol);
+    op.slot = it - symbols.begin();
+    if (it == symbols.end())
+      symbols.push_back(op.symbol);
   }
+  expr.m_code = std::move(ops);
+  return expr;
+}
+
+ExprEvalVT CompiledExpr::evaluate(const ExprEvalVT *values) const {
+  auto res = Assembler::evaluate(
+      Location::unknown(), *m_code,
+      [values](const ExprOp &op) -> std::optional<VIntS> {
+        return values[op.slot];
+      });
+  return std::get<ExprEvalVT>(res);
 }
 
 bool couldBeExpression(const QString &s) {
@@ -4,7 +4,9 @@
 #include "assemblererror.h"
 #include "symbolmap.h"
 #include <QRegularExpression>
+#include <memory>
 #include <variant>
+#include <vector>
 
 namespace Ripes {
 namespace Assembler {
@@ -22,10 +24,43 @@ using ExprEvalRes = Result<ExprEvalVT>;
  * implemented - to ensure precedence, parentheses must be implemented. The
  * functionality is mainly intended to be used by the assembler to expand
  * complex pseudoinstructions and as such not by the user.
+ * Expressions are compiled upon their first evaluation, and the compiled
+ * expression is cached by its text; later evaluations only bind the values of
+ * the symbols in @p variables.
  */
 ExprEvalRes evaluate(const Location &, const QString &,
                      const AbsoluteSymbolMap *variables = nullptr);
 
+/// Evaluates an expression as above, with the symbols of @p symbols relative to
+/// @p line (see SymbolMap::lookup).
+ExprEvalRes evaluate(const Location &, const QString &,
+                     const SymbolMap &symbols, unsigned line);
+
+struct ExprOp;
+using ExprCode = std::vector<ExprOp>;
+
+/**
+ * @brief The CompiledExpr class
+ * An expression compiled once, for repeated evaluation outside of the
+ * assembler (ie. for breakpoint conditions). The symbols of the expression are
+ * bound to slots upon compilation, such that evaluations index the values of
+ * the symbols rather than looking them up.
+ */
+class CompiledExpr {
+public:
+  static Result<CompiledExpr> compile(const Location &, const QString &);
+
+  /// The symbols of the expression, in the order of their values in
+  /// evaluate().
+  const std::vector<QString> &symbols() const { return m_symbols; }
+  /// Evaluates the expression, with the i'th symbol bound to @p values[i].
+  ExprEvalVT evaluate(const ExprEvalVT *values) const;
+
+private:
+  std::shared_ptr<const ExprCode> m_code;
+  std::vector<QString> m_symbols;
+};
+
 /**
  * @brief couldBeExpression
  * @returns true if we have probably cause that the string is an expression and
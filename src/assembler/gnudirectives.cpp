@@ -1,6 +1,9 @@
 #include "gnudirectives.h"
 #include "assembler.h"
 
+#include <cstring>
+#include <type_traits>
+
 namespace Ripes {
 namespace Assembler {
 
@@ -35,6 +38,8 @@ DirectiveVec gnuDirectives() {
   add_directive(directives, twoByteDirective());
   add_directive(directives, fourByteDirective());
   add_directive(directives, longDirective());
+  add_directive(directives, floatDirective());
+  add_directive(directives, doubleFloatDirective());
   add_directive(directives, equDirective());
   add_directive(directives, alignDirective());
 
@@ -93,6 +98,33 @@ Result<QByteArray> dataFunctor(const AssemblerBase *assembler,
   }
 }
 
+/// Assembles each argument as an IEEE 754 floating-point value of type F, in
+/// little-endian byte order.
+template <typename F>
+Result<QByteArray> floatFunctor(const AssemblerBase *,
+                                const DirectiveArg &arg) {
+  if (arg.line.tokens.length() < 1) {
+    return {Error(arg.line, "Invalid number of arguments (expected >1)")};
+  }
+  QByteArray bytes;
+  for (const auto &token : arg.line.tokens) {
+    bool ok;
+    const double value = token.toDouble(&ok);
+    if (!ok) {
+      return {Error(arg.line,
+                    QString("'%1' is not a floating-point value").arg(token))};
+    }
+    const F v = static_cast<F>(value);
+    std::conditional_t<sizeof(F) == 4, uint32_t, uint64_t> bits;
+    std::memcpy(&bits, &v, sizeof(F));
+    for (size_t i = 0; i < sizeof(F); ++i) {
+      bytes.append(bits & 0xff);
+      bits >>= 8;
+    }
+  }
+  return {bytes};
+}
+
 Result<QByteArray> stringFunctor(const AssemblerBase *,
                                  const DirectiveArg &arg) {
   if (arg.line.tokens.length() != 1) {
@@ -122,6 +154,14 @@ Directive fourByteDirective() { return Directive(".4byte", &dataFunctor<4>); }
 
 Directive longDirective() { return Directive(".long", &dataFunctor<4>); }
 
+Directive floatDirective() {
+  return Directive(".float", &floatFunctor<float>);
+}
+
+Directive doubleFloatDirective() {
+  return Directive(".double", &floatFunctor<double>);
+}
+
 Directive stringDirective() { return Directive(".string", &stringFunctor); }
 
 /**
@@ -227,6 +267,7 @@ Directive alignDirective() {
     if (boundary == 0) {
       return {QByteArray()};
     }
+    assembler->noteAlignment(boundary);
     int byteOffset =
         (arg.section->address + arg.section->data.size()) % boundary;
     int bytesToSkip = byteOffset != 0 ? boundary - byteOffset : 0;
@@ -26,6 +26,8 @@ Directive byteDirective();
 Directive twoByteDirective();
 Directive fourByteDirective();
 Directive longDirective();
+Directive floatDirective();
+Directive doubleFloatDirective();
 Directive alignDirective();
 
 Directive dummyDirective(const QString &name);
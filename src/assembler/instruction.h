@@ -8,6 +8,7 @@
 #include <map>
 #include <memory>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include "STLExtras.h"
@@ -501,7 +502,9 @@ private:
 };
 
 template <typename Reg_T>
-using InstrMap = std::map<QString, std::shared_ptr<Instruction<Reg_T>>>;
+using InstrMap =
+    std::unordered_map<QString, std::shared_ptr<Instruction<Reg_T>>,
+                       QStringHash>;
 
 template <typename Reg_T>
 using InstrVec = std::vector<std::shared_ptr<Instruction<Reg_T>>>;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <numeric>
@@ -23,6 +24,7 @@ class Matcher {
     std::vector<MatchNode> children;
     std::shared_ptr<Instruction<Reg_T>> instruction;
     void matchOnExtraMatchConds() { m_matchOnExtraMatchConds = true; }
+    bool matchesOnExtraMatchConds() const { return m_matchOnExtraMatchConds; }
 
     bool matches(const Instr_T &instr) const {
       return m_matchOnExtraMatchConds ? instruction->matchesWithExtras(instr)
@@ -66,13 +68,57 @@ class Matcher {
     }
   };
 
+  /// A leaf of the match tree, flattened into the conjunction of the OpParts
+  /// along its path: an instruction word reaches the leaf if
+  /// (word & mask) == value.
+  struct DecodeLeaf {
+    Instr_T mask = 0;
+    Instr_T value = 0;
+    const Instruction<Reg_T> *instruction = nullptr;
+  };
+
+  /// A contiguous range of instruction bits which indexes the decode table,
+  /// placed at bit @p offset of the table index.
+  struct KeySegment {
+    unsigned start;
+    unsigned width;
+    unsigned offset;
+  };
+
+  /// The maximum number of instruction bits indexing the decode table.
+  static constexpr unsigned c_maxKeyBits = 12;
+
 public:
   Matcher(const std::vector<std::shared_ptr<Instruction<Reg_T>>> &instructions)
-      : m_matchRoot(buildMatchTree(instructions, 1)) {}
+      : m_matchRoot(buildMatchTree(instructions, 1)) {
+    buildDecodeTable();
+  }
   void print() const { m_matchRoot.print(); }
 
+  /**
+   * @brief matchInstruction
+   * Decodes @p instruction through the decode table: the key bits of the word
+   * index a slot, which lists the leaves of the match tree that agree with the
+   * slot on the key bits, in the order in which the match tree would visit
+   * them. The first leaf whose remaining bits and extra match conditions
+   * match is the instruction which the match tree would have yielded.
+   */
   Result<const Instruction<Reg_T> *>
   matchInstruction(const Instr_T &instruction) const {
+    const unsigned key = decodeKey(instruction);
+    for (unsigned i = m_slotBegin[key]; i < m_slotBegin[key + 1]; ++i) {
+      const DecodeLeaf &leaf = m_leaves[m_slotLeaves[i]];
+      if ((instruction & leaf.mask) == leaf.value &&
+          leaf.instruction->matchesWithExtras(instruction))
+        return leaf.instruction;
+    }
+    return Error(0, "Unknown instruction");
+  }
+
+  /// Decodes @p instruction by walking the match tree. This is the reference
+  /// which the decode table is built from.
+  Result<const Instruction<Reg_T> *>
+  matchInstructionByTree(const Instr_T &instruction) const {
     auto match = matchInstructionRec(instruction, m_matchRoot, true);
     if (match == nullptr) {
       return Error(0, "Unknown instruction");
@@ -81,6 +127,102 @@ public:
   }
 
 private:
+  unsigned decodeKey(Instr_T instruction) const {
+    unsigned key = 0;
+    for (const auto &segment : m_keySegments)
+      key |= static_cast<unsigned>((instruction >> segment.start) &
+                                   vsrtl::generateBitmask(segment.width))
+             << segment.offset;
+    return key;
+  }
+
+  /// Flattens the leaves of the match tree in visiting order, appending the
+  /// OpParts which are matched along the path to each leaf to @p path.
+  void flattenMatchTree(const MatchNode &node, std::vector<OpPart> &path,
+                        bool isRoot) {
+    const bool matchesOnOpPart = !isRoot && !node.matchesOnExtraMatchConds();
+    if (matchesOnOpPart)
+      path.push_back(node.matcher);
+    if (node.children.empty()) {
+      DecodeLeaf leaf;
+      leaf.instruction = node.instruction.get();
+      bool reachable = true;
+      for (const auto &opPart : path) {
+        const Instr_T mask = opPart.range.mask << opPart.range.start;
+        const Instr_T value = opPart.range.apply(opPart.value);
+        // Conflicting OpParts along the path render the leaf unreachable.
+        reachable &= ((leaf.value ^ value) & leaf.mask & mask) == 0;
+        leaf.mask |= mask;
+        leaf.value |= value;
+      }
+      if (reachable)
+        m_leaves.push_back(leaf);
+    } else {
+      for (const auto &child : node.children)
+        flattenMatchTree(child, path, false);
+    }
+    if (matchesOnOpPart)
+      path.pop_back();
+  }
+
+  /**
+   * @brief buildDecodeTable
+   * The table is indexed by the bits of the first two OpParts of each
+   * instruction (for RISC-V, the opcode and funct3 fields), limited to
+   * c_maxKeyBits bits such that the table stays small. Bits which do not index
+   * the table (for RISC-V, funct7 and the like) are matched within a slot.
+   */
+  void buildDecodeTable() {
+    std::vector<OpPart> path;
+    flattenMatchTree(m_matchRoot, path, true);
+
+    // Gather the bit ranges of the leading OpParts, and merge overlapping or
+    // adjacent ranges into segments.
+    std::vector<std::pair<unsigned, unsigned>> ranges;
+    for (const auto &leaf : m_leaves) {
+      const auto &opParts = leaf.instruction->getOpcode().opParts;
+      for (unsigned i = 0; i < std::min<size_t>(2, opParts.size()); ++i)
+        ranges.push_back({opParts[i].range.start, opParts[i].range.stop});
+    }
+    std::sort(ranges.begin(), ranges.end());
+    std::vector<std::pair<unsigned, unsigned>> merged;
+    for (const auto &range : ranges) {
+      if (!merged.empty() && range.first <= merged.back().second + 1)
+        merged.back().second = std::max(merged.back().second, range.second);
+      else
+        merged.push_back(range);
+    }
+    unsigned keyBits = 0;
+    Instr_T keyMask = 0;
+    for (const auto &range : merged) {
+      const unsigned width = range.second - range.first + 1;
+      if (keyBits + width > c_maxKeyBits)
+        continue;
+      m_keySegments.push_back({range.first, width, keyBits});
+      keyMask |= vsrtl::generateBitmask(width) << range.first;
+      keyBits += width;
+    }
+
+    // A leaf is a candidate of a slot if it agrees with the slot on the key
+    // bits. Leaves are added in visiting order.
+    const unsigned nSlots = 1u << keyBits;
+    m_slotBegin.reserve(nSlots + 1);
+    for (unsigned key = 0; key < nSlots; ++key) {
+      m_slotBegin.push_back(m_slotLeaves.size());
+      Instr_T pattern = 0;
+      for (const auto &segment : m_keySegments)
+        pattern |= static_cast<Instr_T>((key >> segment.offset) &
+                                        vsrtl::generateBitmask(segment.width))
+                   << segment.start;
+      for (unsigned i = 0; i < m_leaves.size(); ++i) {
+        const DecodeLeaf &leaf = m_leaves[i];
+        if (((pattern ^ leaf.value) & leaf.mask & keyMask) == 0)
+          m_slotLeaves.push_back(i);
+      }
+    }
+    m_slotBegin.push_back(m_slotLeaves.size());
+  }
+
   const Instruction<Reg_T> *matchInstructionRec(const Instr_T &instruction,
                                                 const MatchNode &node,
                                                 bool isRoot) const {
@@ -170,6 +312,13 @@ private:
   }
 
   MatchNode m_matchRoot;
+
+  std::vector<DecodeLeaf> m_leaves;
+  std::vector<KeySegment> m_keySegments;
+  // The candidate leaves of slot k are
+  // m_slotLeaves[m_slotBegin[k] .. m_slotBegin[k + 1]).
+  std::vector<unsigned> m_slotBegin;
+  std::vector<unsigned> m_slotLeaves;
 };
 
 } // namespace Assembler
@@ -1,7 +1,13 @@
 #include "objdump.h"
 
 #include "../processorhandler.h"
+#include "assembler.h"
+
 #include <QDataStream>
+#include <QFile>
+
+#include <climits>
+#include <mutex>
 
 namespace Ripes {
 namespace Assembler {
@@ -149,5 +155,88 @@ QString binobjdump(const std::shared_ptr<const Program> &program,
       addrOffsetMap);
 }
 
+QString writeObjdump(const std::shared_ptr<const Program> &program,
+                     const QString &path) {
+  QFile file(path);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    return "Error: Could not open objdump file " + path;
+  const auto *textSection = program->getSection(TEXT_SECTION_NAME);
+  if (!textSection)
+    return QString();
+
+  const auto assembler = ProcessorHandler::getAssembler();
+  const unsigned regBytes = ProcessorHandler::currentISA()->bytes();
+  const unsigned instrBytes = ProcessorHandler::currentISA()->instrBytes();
+  const QByteArray &data = textSection->data;
+  const AInt base = textSection->address;
+  const QString indent = "    ";
+
+  // Reads the instruction word at @p offset of the text section, which may be
+  // truncated by the end of the section.
+  const auto readWord = [&](AInt offset) {
+    VInt word = 0;
+    for (unsigned i = 0; i < instrBytes && offset + i < AInt(data.size()); ++i)
+      word |= static_cast<VInt>(static_cast<uint8_t>(data[offset + i]))
+              << (CHAR_BIT * i);
+    return word;
+  };
+
+  // Lay out the instructions, which only requires their sizes. Words which do
+  // not decode are skipped by the default instruction size of the ISA.
+  std::vector<AInt> offsets;
+  for (AInt offset = 0; offset < AInt(data.size());) {
+    offsets.push_back(offset);
+    const unsigned size = assembler->instructionSize(readWord(offset));
+    offset += size != 0 ? size : instrBytes;
+  }
+
+  const auto format = [&](AInt offset, QString &out) {
+    const AInt addr = base + offset;
+    auto symbol = program->symbols.find(addr);
+    if (symbol != program->symbols.end())
+      out += "\n" +
+             QString::number(addr, 16).rightJustified(regBytes * 2, '0') +
+             " <" + symbol->second.v + ">:\n";
+    out += indent + QString::number(addr, 16) + ":" + indent + indent;
+
+    const VInt word = readWord(offset);
+    const auto disres = assembler->disassemble(word, program->symbols, addr);
+    const unsigned bytes = disres.err ? 0 : disres.bytesDisassembled;
+    for (unsigned i = bytes; i-- > 0;)
+      out += QString::number((word >> (CHAR_BIT * i)) & 0xFF, 16)
+                 .rightJustified(2, '0');
+    out += indent + indent;
+    // Pad if < default instruction width to align disassembled instruction
+    // with default instruction width column
+    for (int dBytes = instrBytes - bytes; dBytes > 0;
+         dBytes -= indent.size() / 2)
+      out += indent;
+    out += disres.repr + "\n";
+  };
+
+  // Instructions are disassembled in blocks, each of which is written to the
+  // file before the next is disassembled.
+  constexpr size_t c_blockInstructions = 1 << 16;
+  for (size_t block = 0; block < offsets.size();
+       block += c_blockInstructions) {
+    const size_t blockEnd =
+        std::min(offsets.size(), block + c_blockInstructions);
+    std::mutex chunksMutex;
+    std::map<size_t, QByteArray> chunks;
+    forEachChunk(blockEnd - block, [&](size_t begin, size_t end) {
+      QString out;
+      for (size_t i = block + begin; i < block + end; ++i)
+        format(offsets[i], out);
+      const QByteArray chunk = out.toUtf8();
+      std::lock_guard<std::mutex> lock(chunksMutex);
+      chunks[begin] = chunk;
+    });
+    for (const auto &chunk : chunks)
+      if (file.write(chunk.second) != chunk.second.size())
+        return "Error: Could not write objdump file " + path;
+  }
+  return QString();
+}
+
 } // namespace Assembler
 } // namespace Ripes
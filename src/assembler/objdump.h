@@ -28,5 +28,13 @@ QString objdump(const std::shared_ptr<const Program> &program,
 QString binobjdump(const std::shared_ptr<const Program> &program,
                    AddrOffsetMap &addrOffsetMap);
 
+/// Writes the objdump listing of the text section of @p program to @p path.
+/// The section is disassembled in parallel, in chunks which are streamed to the
+/// file in order, such that the listing of a large program is never held in
+/// memory as a whole. Returns an error message on failure, or an empty string
+/// on success.
+QString writeObjdump(const std::shared_ptr<const Program> &program,
+                     const QString &path);
+
 } // namespace Assembler
 } // namespace Ripes
@@ -1,6 +1,10 @@
 #include "program.h"
 
 #include "processorhandler.h"
+#include "symbolindex.h"
+
+#include <algorithm>
+#include <climits>
 
 namespace Ripes {
 
@@ -17,48 +21,59 @@ const ProgramSection *Program::getSection(const QString &name) const {
 }
 
 void DisassembledProgram::clear() {
-  addressToDisresMap.clear();
-  indexToAddressMap.clear();
-  addressToIndexMap.clear();
+  m_addresses.clear();
+  m_indices.clear();
+  m_disassembled.clear();
+  m_disassembler = nullptr;
 }
 
-bool DisassembledProgram::empty() const { return addressToDisresMap.empty(); }
+bool DisassembledProgram::empty() const { return m_addresses.empty(); }
 
 std::optional<VInt> DisassembledProgram::indexToAddress(unsigned idx) const {
-  auto it = indexToAddressMap.find(idx);
-  if (it != indexToAddressMap.end())
-    return it->second;
+  if (idx < m_addresses.size())
+    return m_addresses[idx];
   return std::nullopt;
 }
 
 std::optional<unsigned> DisassembledProgram::addressToIndex(VInt addr) const {
-  auto it = addressToIndexMap.find(addr);
-  if (it != addressToIndexMap.end())
-    return it->second;
-  return std::nullopt;
+  if (addr < m_start || (addr - m_start) % m_alignment != 0)
+    return std::nullopt;
+  const VInt slot = (addr - m_start) / m_alignment;
+  if (slot >= m_indices.size() || m_indices[slot] < 0)
+    return std::nullopt;
+  return m_indices[slot];
 }
 
-void DisassembledProgram::set(unsigned int idx, VInt address,
-                              const QString &disres) {
-  assert(indexToAddressMap.count(idx) == 0);
-  assert(addressToDisresMap.count(address) == 0);
-  indexToAddressMap[idx] = address;
-  addressToIndexMap[address] = idx;
-  addressToDisresMap[address] = disres;
+void DisassembledProgram::set(VInt start, unsigned alignment,
+                              std::vector<VInt> addresses,
+                              const Disassembler &disassembler) {
+  m_start = start;
+  m_alignment = alignment;
+  m_addresses = std::move(addresses);
+  m_indices.assign(
+      m_addresses.empty() ? 0 : (m_addresses.back() - start) / alignment + 1,
+      -1);
+  for (unsigned i = 0; i < m_addresses.size(); ++i) {
+    assert((m_addresses[i] - start) % alignment == 0);
+    m_indices[(m_addresses[i] - start) / alignment] = i;
+  }
+  m_disassembled.assign(m_addresses.size(), std::nullopt);
+  m_disassembler = disassembler;
 }
 
 std::optional<QString> DisassembledProgram::getFromAddr(VInt address) const {
-  auto it = addressToDisresMap.find(address);
-  if (it != addressToDisresMap.end())
-    return {it->second};
+  if (auto idx = addressToIndex(address))
+    return getFromIdx(*idx);
   return {};
 }
 
 std::optional<QString> DisassembledProgram::getFromIdx(unsigned idx) const {
-  auto it = indexToAddressMap.find(idx);
-  if (it != indexToAddressMap.end())
-    return getFromAddr(it->second);
-  return {};
+  if (idx >= m_addresses.size())
+    return {};
+  auto &disassembled = m_disassembled[idx];
+  if (!disassembled)
+    disassembled = m_disassembler(m_addresses[idx]);
+  return disassembled;
 }
 
 const DisassembledProgram &Program::getDisassembled() const {
@@ -68,36 +83,66 @@ const DisassembledProgram &Program::getDisassembled() const {
     return disassembled;
   }
   if (disassembled.empty()) {
-    auto &assembler = ProcessorHandler::getAssembler();
-    auto &memory = ProcessorHandler::getMemory();
-    auto &symbols = ProcessorHandler::getProgram()->symbols;
-
-    // Initialize caching
-    const unsigned instrBytes = ProcessorHandler::currentISA()->instrBytes();
+    const auto assembler = ProcessorHandler::getAssembler();
+    const auto *isa = ProcessorHandler::currentISA();
+    const unsigned instrBytes = isa->instrBytes();
+    const unsigned alignment = std::max(1u, isa->instrByteAlignment());
     const VInt textSectionBaseAddr = textSection->address;
-    unsigned line = 0;
-    for (AInt addr = 0;
-         addr < static_cast<AInt>(ProcessorHandler::getCurrentProgramSize());) {
-      const VInt disassembleAddr = addr + textSectionBaseAddr;
-      auto disRes =
-          assembler->disassemble(memory.readMem(disassembleAddr, instrBytes),
-                                 symbols, disassembleAddr);
-      // todo(mortbopet): shouldn't we do something about the possibility of the
-      // disassembling returning an error?
-      const VInt realAddr = textSectionBaseAddr + addr;
-      disassembled.set(line, realAddr, disRes.repr);
-      if (disRes.err.has_value()) {
-        // Error during disassembled; we'll just have to increment the address
-        // counter by the default instruction size of the ISA.
-        addr += instrBytes;
-      } else
-        addr += disRes.bytesDisassembled;
-      ++line;
+    const QByteArray data = textSection->data;
+
+    // Reads the instruction word at @p offset of the text section, which may
+    // be truncated by the end of the section.
+    const auto readWord = [data, instrBytes](AInt offset) {
+      VInt word = 0;
+      for (unsigned i = 0; i < instrBytes && offset + i < AInt(data.size());
+           ++i)
+        word |= static_cast<VInt>(static_cast<uint8_t>(data[offset + i]))
+                << (CHAR_BIT * i);
+      return word;
+    };
+
+    // Lay out the instructions, which only requires their sizes, unless the
+    // layout is known.
+    std::vector<VInt> addresses = instructionLayout;
+    if (addresses.empty()) {
+      for (AInt addr = 0; addr < static_cast<AInt>(data.size());) {
+        addresses.push_back(textSectionBaseAddr + addr);
+        // Words which do not decode are skipped by the default instruction
+        // size of the ISA.
+        const unsigned size = assembler->instructionSize(readWord(addr));
+        addr += size != 0 ? size : instrBytes;
+      }
     }
+
+    const auto programSymbols =
+        std::make_shared<const ReverseSymbolMap>(symbols);
+    disassembled.set(textSectionBaseAddr, alignment, std::move(addresses),
+                     [=](VInt address) {
+                       return assembler
+                           ->disassemble(
+                               readWord(address - textSectionBaseAddr),
+                               *programSymbols, address)
+                           .repr;
+                     });
   }
   return disassembled;
 }
 
+void Program::buildSymbolIndex() const {
+  if (symbolIndex.valid())
+    return;
+  // The index is built from a copy of the symbols (of which the names are
+  // implicitly shared), such that the program may be destroyed while building.
+  symbolIndex = std::async(std::launch::async, [symbols = symbols] {
+                  return std::make_shared<const SymbolIndex>(symbols);
+                }).share();
+}
+
+const SymbolIndex &Program::getSymbolIndex() const {
+  buildSymbolIndex();
+  return *symbolIndex.get();
+}
+
 QString Program::calculateHash(const QByteArray &data) {
   return QCryptographicHash::hash(data, QCryptographicHash::Sha1);
 }
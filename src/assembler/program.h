@@ -1,10 +1,14 @@
 #pragma once
 
 #include <QByteArray>
+#include <QFile>
 #include <QHash>
 #include <QMap>
 #include <QMetaType>
 #include <QString>
+#include <functional>
+#include <future>
+#include <memory>
 #include <optional>
 #include <set>
 #include <vector>
@@ -23,7 +27,9 @@ enum SourceType {
   /** Executable files not compiled from within ripes */
   ExternalELF,
   /** Executable files compiled within ripes */
-  InternalELF
+  InternalELF,
+  /** Session files, holding a program and optionally a checkpoint */
+  Session
 };
 
 #define TEXT_SECTION_NAME ".text"
@@ -61,11 +67,23 @@ public:
 
   operator const QString &() const { return v; }
 
+  struct Hash {
+    size_t operator()(const Symbol &s) const { return qHash(s.v); }
+  };
+
   QString v;
   unsigned type = 0;
 };
 
+/// Hashes QString keys of std::unordered_map, for which not all supported Qt
+/// versions specialize std::hash.
+struct QStringHash {
+  size_t operator()(const QString &s) const { return qHash(s); }
+};
+
 using ReverseSymbolMap = std::map<AInt, Symbol>;
+class SymbolIndex;
+class SourceLineTable;
 
 struct LoadFileParams {
   QString filepath;
@@ -80,11 +98,24 @@ struct ProgramSection {
   QByteArray data;
 };
 
+/**
+ * @brief The DisassembledProgram class
+ * The instructions of a text section, and their disassembly. The layout of the
+ * instructions is determined up front, which only requires decoding the size
+ * of each instruction; instructions are disassembled lazily upon first access,
+ * and cached. Addresses index dense vectors, in units of the instruction
+ * alignment of the ISA.
+ */
 class DisassembledProgram {
 public:
-  /// Associates the given address and index with the disassembled instruction
-  /// string
-  void set(unsigned idx, VInt address, const QString &disres);
+  using Disassembler = std::function<QString(VInt address)>;
+
+  /// Sets the program to the instructions at @p addresses, in ascending order,
+  /// of a text section starting at @p start. Instruction addresses are
+  /// multiples of @p alignment bytes from @p start. Instructions are
+  /// disassembled through @p disassembler.
+  void set(VInt start, unsigned alignment, std::vector<VInt> addresses,
+           const Disassembler &disassembler);
 
   /// Returns the disassembled instruction for the given index.
   std::optional<QString> getFromIdx(unsigned idx) const;
@@ -101,16 +132,21 @@ public:
   /// Returns true if no disassembled program has been set.
   bool empty() const;
 
-  unsigned numInstructions() const { return indexToAddressMap.size(); }
+  unsigned numInstructions() const { return m_addresses.size(); }
+  /// The address of each instruction, in ascending order.
+  const std::vector<VInt> &addresses() const { return m_addresses; }
 
 private:
-  /// An ordered map of [instruction address : disassembled instruction]
-  std::map<VInt, QString> addressToDisresMap;
-
-  /// Ordered maps of the index of a given disassembled instruction to its
-  /// address.
-  std::map<unsigned, VInt> indexToAddressMap;
-  std::map<VInt, unsigned> addressToIndexMap;
+  VInt m_start = 0;
+  unsigned m_alignment = 1;
+  /// The address of each instruction, by index.
+  std::vector<VInt> m_addresses;
+  /// The index of the instruction at each aligned address, or -1 if no
+  /// instruction starts at the address.
+  std::vector<int> m_indices;
+  /// The disassembled instructions, by index, once disassembled.
+  mutable std::vector<std::optional<QString>> m_disassembled;
+  Disassembler m_disassembler;
 };
 
 /**
@@ -129,10 +165,18 @@ public:
   std::map<QString, ProgramSection> sections;
   ReverseSymbolMap symbols;
   SourceMapping sourceMapping;
+  // The source lines of the instructions of the program, as given by its debug
+  // information, if any.
+  std::shared_ptr<const SourceLineTable> sourceLines;
 
   // Hash of the source code which this program resulted from. Expected to be a
   // SHA-1 hash (fastest).
   QString sourceHash;
+
+  // Memory mapped file which this program was loaded from, if any. Section
+  // data may refer directly to the mapped file contents, so the mapping is kept
+  // alive for the lifetime of the program.
+  std::shared_ptr<QFile> mappedFile;
   // Returns true if data is equal to the sourceHash of this program.
   bool isSameSource(const QByteArray &data) const;
 
@@ -140,17 +184,33 @@ public:
   /// nullptr if no section was found with the given name.
   const ProgramSection *getSection(const QString &name) const;
 
-  /// Returns the disassembled version of this program. The result is an ordered
-  /// map of [instruction address : disassembled instruction]
+  /// Returns the disassembled version of this program, disassembling its
+  /// instructions upon access.
   const DisassembledProgram &getDisassembled() const;
   const SourceMapping &getSourceMapping() const;
 
+  /// Sets the addresses of the instructions of the text section, as given by
+  /// getDisassembled().addresses() of an identical program, such that the
+  /// instructions need not be decoded to be laid out upon disassembly.
+  void setInstructionLayout(std::vector<VInt> addresses) {
+    instructionLayout = std::move(addresses);
+  }
+
+  /// Starts building the search index of the symbols of this program on a
+  /// separate thread. The symbols shall not be modified hereafter.
+  void buildSymbolIndex() const;
+  /// Returns the search index of the symbols of this program, waiting for it
+  /// to be built if building is in progress, or building it if not started.
+  const SymbolIndex &getSymbolIndex() const;
+
   /// Calculates a hash used for source identification.
   static QString calculateHash(const QByteArray &data);
 
 private:
   /// A caching of the disassembled version of this program.
   mutable DisassembledProgram disassembled;
+  std::vector<VInt> instructionLayout;
+  mutable std::shared_future<std::shared_ptr<const SymbolIndex>> symbolIndex;
 };
 
 } // namespace Ripes
@@ -69,7 +69,8 @@ using PseudoInstrVec = std::vector<std::shared_ptr<PseudoInstruction<Reg_T>>>;
 
 template <typename Reg_T>
 using PseudoInstrMap =
-    std::map<QString, std::shared_ptr<PseudoInstruction<Reg_T>>>;
+    std::unordered_map<QString, std::shared_ptr<PseudoInstruction<Reg_T>>,
+                       QStringHash>;
 
 } // namespace Assembler
 } // namespace Ripes
@@ -4,6 +4,7 @@
 #include <QString>
 #include <functional>
 #include <memory>
+#include <unordered_map>
 #include <variant>
 
 #include "assembler_defines.h"
@@ -41,7 +42,9 @@ private:
 };
 
 template <typename Reg_T>
-using RelocationsMap = std::map<QString, std::shared_ptr<Relocation<Reg_T>>>;
+using RelocationsMap =
+    std::unordered_map<QString, std::shared_ptr<Relocation<Reg_T>>,
+                       QStringHash>;
 
 template <typename Reg_T>
 using RelocationsVec = std::vector<std::shared_ptr<Relocation<Reg_T>>>;
@@ -6,9 +6,13 @@
 #include <QByteArray>
 #include <algorithm>
 
+#include "rv_a_ext.h"
 #include "rv_c_ext.h"
+#include "rv_d_ext.h"
+#include "rv_f_ext.h"
 #include "rv_i_ext.h"
 #include "rv_m_ext.h"
+#include "rv_v_ext.h"
 
 namespace Ripes {
 namespace Assembler {
@@ -51,9 +55,21 @@ RV32I_Assembler::initInstructions(const ISAInfo<ISA::RV32I> *isa) const {
     case 'M':
       RV_M<Reg_T>::enable(isa, instructions, pseudoInstructions);
       break;
+    case 'A':
+      RV_A<Reg_T>::enable(isa, instructions, pseudoInstructions);
+      break;
+    case 'F':
+      RV_F<Reg_T>::enable(isa, instructions, pseudoInstructions);
+      break;
+    case 'D':
+      RV_D<Reg_T>::enable(isa, instructions, pseudoInstructions);
+      break;
     case 'C':
       RV_C<Reg_T>::enable(isa, instructions, pseudoInstructions);
       break;
+    case 'V':
+      RV_V<Reg_T>::enable(isa, instructions, pseudoInstructions);
+      break;
     default:
       assert(false && "Unhandled ISA extension");
     }
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QObject>
+#include <functional>
+
+#include "assembler.h"
+#include "rvassembler_common.h"
+
+namespace Ripes {
+namespace Assembler {
+
+// Atomic memory operations and store-conditionals: "amoadd.w rd, rs2, (rs1)".
+// The aq and rl bits are given by the suffix of the instruction name.
+#define AMOType(name, funct3, funct5, aqrl)                                    \
+  std::shared_ptr<_Instruction>(new _Instruction(                              \
+      _Opcode(name, {OpPart(RVISA::Opcode::AMO, 0, 6),                         \
+                     OpPart(funct3, 12, 14), OpPart(aqrl, 25, 26),             \
+                     OpPart(funct5, 27, 31)}),                                 \
+      {std::make_shared<_Reg>(isa, 1, 7, 11, "rd"),                            \
+       std::make_shared<_Reg>(isa, 2, 20, 24, "rs2"),                          \
+       std::make_shared<_Reg>(isa, 3, 15, 19, "rs1")}))
+
+// Load-reserved: "lr.w rd, (rs1)", with rs2 = x0.
+#define LRType(name, funct3, aqrl)                                             \
+  std::shared_ptr<_Instruction>(new _Instruction(                              \
+      _Opcode(name, {OpPart(RVISA::Opcode::AMO, 0, 6),                         \
+                     OpPart(funct3, 12, 14), OpPart(0b00000, 20, 24),          \
+                     OpPart(aqrl, 25, 26), OpPart(0b00010, 27, 31)}),          \
+      {std::make_shared<_Reg>(isa, 1, 7, 11, "rd"),                            \
+       std::make_shared<_Reg>(isa, 2, 15, 19, "rs1")}))
+
+/**
+ * Extension enabler.
+ * Calling an extension enabler will register the appropriate assemblers and
+ * pseudo-op expander functors with the assembler. The extension enablers are
+ * templated to allow for sharing implementations between 32- and 64-bit
+ * variants.
+ */
+template <typename Reg__T>
+struct RV_A {
+  AssemblerTypes(Reg__T);
+  static void enable(const ISAInfoBase *isa, _InstrVec &instructions,
+                     _PseudoInstrVec & /*pseudoInstructions*/) {
+    // Pseudo-op functors
+
+    // Assembler functors
+    addWidth(isa, instructions, "w", 0b010);
+    if (isa->isaID() == ISA::RV64I)
+      addWidth(isa, instructions, "d", 0b011);
+  }
+
+private:
+  /// Adds the instructions operating on words of the given @p width suffix,
+  /// in each of their aq/rl orderings.
+  static void addWidth(const ISAInfoBase *isa, _InstrVec &instructions,
+                       const QString &width, unsigned funct3) {
+    const std::vector<std::pair<QString, unsigned>> amos = {
+        {"sc", 0b00011},      {"amoswap", 0b00001}, {"amoadd", 0b00000},
+        {"amoxor", 0b00100},  {"amoand", 0b01100},  {"amoor", 0b01000},
+        {"amomin", 0b10000},  {"amomax", 0b10100},  {"amominu", 0b11000},
+        {"amomaxu", 0b11100}};
+    const std::vector<std::pair<QString, unsigned>> orderings = {
+        {"", 0b00}, {".aq", 0b10}, {".rl", 0b01}, {".aqrl", 0b11}};
+
+    for (const auto &ordering : orderings) {
+      const QString suffix = "." + width + ordering.first;
+      instructions.push_back(
+          LRType(Token("lr" + suffix), funct3, ordering.second));
+      for (const auto &amo : amos) {
+        instructions.push_back(AMOType(Token(amo.first + suffix), funct3,
+                                       amo.second, ordering.second));
+      }
+    }
+  }
+};
+
+} // namespace Assembler
+} // namespace Ripes
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QObject>
+#include <functional>
+
+#include "assembler.h"
+#include "rv_f_ext.h"
+#include "rvassembler_common.h"
+
+namespace Ripes {
+namespace Assembler {
+
+/**
+ * Extension enabler.
+ * Calling an extension enabler will register the appropriate assemblers and
+ * pseudo-op expander functors with the assembler. The extension enablers are
+ * templated to allow for sharing implementations between 32- and 64-bit
+ * variants.
+ */
+template <typename Reg__T>
+struct RV_D {
+  AssemblerTypes(Reg__T);
+  static void enable(const ISAInfoBase *isa, _InstrVec &instructions,
+                     _PseudoInstrVec &pseudoInstructions) {
+    // Pseudo-op functors
+
+    // Assembler functors
+    // The moves between the register files are RV64 only, since the integer
+    // registers of RV32 cannot hold a double.
+    RV_FP<Reg__T>::addFormat(
+        isa, instructions, pseudoInstructions,
+        {"d", 0b01, "fld", "fsd", 0b011, "d", isa->isaID() == ISA::RV64I});
+
+    // Conversions between the single- and double-precision formats, of the
+    // format given by fmt from the format given by rs2.
+    const std::vector<std::tuple<QString, unsigned, unsigned>> conversions = {
+        {"fcvt.s.d", 0b00, 0b00001}, {"fcvt.d.s", 0b01, 0b00000}};
+    for (const auto &[name, fmt, rs2] : conversions) {
+      RV_FP<Reg__T>::addInstruction(
+          instructions, pseudoInstructions, name,
+          {OpPart(RVISA::Opcode::OP_FP, 0, 6), OpPart(rs2, 20, 24),
+           OpPart(fmt, 25, 26), OpPart(0b01000, 27, 31)},
+          {std::make_shared<FPReg<Reg__T>>(isa, 1, 7, 11, "rd"),
+           std::make_shared<FPReg<Reg__T>>(isa, 2, 15, 19, "rs1"),
+           std::make_shared<RVRoundingMode<Reg__T>>(3)});
+    }
+  }
+};
+
+} // namespace Assembler
+} // namespace Ripes
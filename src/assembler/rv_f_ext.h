@@ -0,0 +1,319 @@
+#pragma once
+
+#include <QObject>
+#include <array>
+#include <functional>
+
+#include "assembler.h"
+#include "instruction.h"
+#include "rvassembler_common.h"
+
+namespace Ripes {
+namespace Assembler {
+
+/// Register specialization for the floating-point registers of the F and D
+/// extensions, given as f0-f31 or by their ABI names (ie. fa0).
+template <typename Reg_T>
+struct FPReg : public Reg<Reg_T> {
+  using Reg<Reg_T>::Reg;
+  std::optional<Error> apply(const TokenizedSrcLine &line, Instr_T &instruction,
+                             FieldLinkRequest<Reg_T> &) const override {
+    bool success;
+    const QString &regToken = line.tokens[this->tokenIndex];
+    const unsigned reg = this->m_isa->fpRegNumber(regToken, success);
+    if (!success)
+      return Error(line, "Unknown floating-point register '" + regToken + "'");
+    instruction |= this->m_range.apply(reg);
+    return std::nullopt;
+  }
+
+  std::optional<Error> decode(const Instr_T instruction,
+                              const Reg_T /*address*/, const ReverseSymbolMap &,
+                              LineTokens &line) const override {
+    const unsigned regNumber = this->m_range.decode(instruction);
+    const Token registerName = this->m_isa->fpRegName(regNumber);
+    if (registerName.isEmpty()) {
+      return Error(0, "Unknown floating-point register number '" +
+                          QString::number(regNumber) + "'");
+    }
+    line.push_back(registerName);
+    return std::nullopt;
+  }
+};
+
+/// The rounding mode operand (the rm field, bits 12-14) of floating-point
+/// instructions, given by name. dyn selects the rounding mode of frm.
+template <typename Reg_T>
+struct RVRoundingMode : public Field<Reg_T> {
+  RVRoundingMode(unsigned tokenIndex) : Field<Reg_T>(tokenIndex) {}
+
+  std::optional<Error> apply(const TokenizedSrcLine &line, Instr_T &instruction,
+                             FieldLinkRequest<Reg_T> &) const override {
+    const QString &token = line.tokens[this->tokenIndex];
+    for (unsigned rm = 0; rm < s_names.size(); ++rm) {
+      if (!token.isEmpty() && token == s_names[rm]) {
+        instruction |= m_range.apply(rm);
+        return std::nullopt;
+      }
+    }
+    return Error(line, "Unknown rounding mode '" + token +
+                           "', expected rne, rtz, rdn, rup, rmm or dyn");
+  }
+
+  std::optional<Error> decode(const Instr_T instruction, const Reg_T,
+                              const ReverseSymbolMap &,
+                              LineTokens &line) const override {
+    const QString name = s_names.at(m_range.decode(instruction));
+    if (name.isEmpty())
+      return Error(0, "Reserved rounding mode");
+    line.push_back(name);
+    return std::nullopt;
+  }
+
+  std::vector<BitRange> bitRanges() const override { return {m_range}; }
+
+  const BitRange m_range = BitRange(12, 14);
+  // Indexed by the encoding of the rounding mode; 101 and 110 are reserved.
+  static inline const std::array<const char *, 8> s_names = {
+      "rne", "rtz", "rdn", "rup", "rmm", "", "", "dyn"};
+};
+
+/**
+ * @brief The RV_FP struct
+ * The instructions shared by the F and D extensions, for the floating-point
+ * format @p fmt (S = 00, D = 01) named by the suffix of the instructions.
+ * Instructions taking a rounding mode are accompanied by a pseudo-instruction
+ * of the same name without the rounding mode, which rounds with the dynamic
+ * rounding mode (frm).
+ */
+template <typename Reg__T>
+struct RV_FP {
+  AssemblerTypes(Reg__T);
+  using _Fields = std::vector<std::shared_ptr<Field<Reg__T>>>;
+
+  struct Format {
+    // Instruction name suffix of the format, ie. "s"
+    QString suffix;
+    unsigned fmt;
+    // Names of the load and store, and their width (funct3)
+    QString load;
+    QString store;
+    unsigned width;
+    // Integer name suffix of the moves between register files, ie. "w"
+    QString moveSuffix;
+    bool hasMoves;
+  };
+
+  static void addFormat(const ISAInfoBase *isa, _InstrVec &instructions,
+                        _PseudoInstrVec &pseudoInstructions,
+                        const Format &format) {
+    const bool isRV64 = isa->isaID() == ISA::RV64I;
+    const QString s = "." + format.suffix;
+    auto fpr = [&](unsigned token, unsigned start, unsigned stop,
+                   const QString &name) {
+      return std::make_shared<FPReg<Reg__T>>(isa, token, start, stop, name);
+    };
+    auto gpr = [&](unsigned token, unsigned start, unsigned stop,
+                   const QString &name) {
+      return std::make_shared<_Reg>(isa, token, start, stop, name);
+    };
+    auto rm = [](unsigned token) {
+      return std::make_shared<RVRoundingMode<Reg__T>>(token);
+    };
+    // Adds an OP-FP instruction, and the rounding pseudo-instruction of
+    // instructions with a rounding mode.
+    auto add = [&](const QString &name, unsigned funct5,
+                   std::vector<OpPart> opParts, const _Fields &fields) {
+      opParts.push_back(OpPart(RVISA::Opcode::OP_FP, 0, 6));
+      opParts.push_back(OpPart(format.fmt, 25, 26));
+      opParts.push_back(OpPart(funct5, 27, 31));
+      addInstruction(instructions, pseudoInstructions, name, opParts, fields);
+    };
+
+    // Loads and stores: "flw rd, imm(rs1)" and "fsw rs2, imm(rs1)"
+    addInstruction(
+        instructions, pseudoInstructions, format.load,
+        {OpPart(RVISA::Opcode::LOAD_FP, 0, 6), OpPart(format.width, 12, 14)},
+        {fpr(1, 7, 11, "rd"), gpr(3, 15, 19, "rs1"),
+         std::make_shared<_Imm>(2, 12, _Imm::Repr::Signed,
+                                std::vector{ImmPart(0, 20, 31)})});
+    addInstruction(
+        instructions, pseudoInstructions, format.store,
+        {OpPart(RVISA::Opcode::STORE_FP, 0, 6), OpPart(format.width, 12, 14)},
+        {gpr(3, 15, 19, "rs1"),
+         std::make_shared<_Imm>(
+             2, 12, _Imm::Repr::Signed,
+             std::vector{ImmPart(5, 25, 31), ImmPart(0, 7, 11)}),
+         fpr(1, 20, 24, "rs2")});
+
+    // Fused multiply-adds (R4-Type)
+    const std::vector<std::pair<QString, unsigned>> fmas = {
+        {"fmadd", RVISA::Opcode::MADD},
+        {"fmsub", RVISA::Opcode::MSUB},
+        {"fnmsub", RVISA::Opcode::NMSUB},
+        {"fnmadd", RVISA::Opcode::NMADD}};
+    for (const auto &[name, opcode] : fmas) {
+      addInstruction(instructions, pseudoInstructions, name + s,
+                     {OpPart(opcode, 0, 6), OpPart(format.fmt, 25, 26)},
+                     {fpr(1, 7, 11, "rd"), fpr(2, 15, 19, "rs1"),
+                      fpr(3, 20, 24, "rs2"), fpr(4, 27, 31, "rs3"), rm(5)});
+    }
+
+    // Arithmetic
+    const std::vector<std::pair<QString, unsigned>> arith = {
+        {"fadd", 0b00000},
+        {"fsub", 0b00001},
+        {"fmul", 0b00010},
+        {"fdiv", 0b00011}};
+    for (const auto &[name, funct5] : arith) {
+      add(name + s, funct5, {},
+          {fpr(1, 7, 11, "rd"), fpr(2, 15, 19, "rs1"), fpr(3, 20, 24, "rs2"),
+           rm(4)});
+    }
+    add("fsqrt" + s, 0b01011, {OpPart(0, 20, 24)},
+        {fpr(1, 7, 11, "rd"), fpr(2, 15, 19, "rs1"), rm(3)});
+
+    // Sign injection, min/max and comparisons, selected by funct3
+    const std::vector<std::tuple<QString, unsigned, unsigned>> noRounding = {
+        {"fsgnj", 0b00100, 0b000}, {"fsgnjn", 0b00100, 0b001},
+        {"fsgnjx", 0b00100, 0b010}, {"fmin", 0b00101, 0b000},
+        {"fmax", 0b00101, 0b001}};
+    for (const auto &[name, funct5, funct3] : noRounding) {
+      add(name + s, funct5, {OpPart(funct3, 12, 14)},
+          {fpr(1, 7, 11, "rd"), fpr(2, 15, 19, "rs1"), fpr(3, 20, 24, "rs2")});
+    }
+    const std::vector<std::pair<QString, unsigned>> compares = {
+        {"feq", 0b010}, {"flt", 0b001}, {"fle", 0b000}};
+    for (const auto &[name, funct3] : compares) {
+      add(name + s, 0b10100, {OpPart(funct3, 12, 14)},
+          {gpr(1, 7, 11, "rd"), fpr(2, 15, 19, "rs1"), fpr(3, 20, 24, "rs2")});
+    }
+    add("fclass" + s, 0b11100, {OpPart(0b001, 12, 14), OpPart(0, 20, 24)},
+        {gpr(1, 7, 11, "rd"), fpr(2, 15, 19, "rs1")});
+
+    // Conversions to and from integers, of the integer type selected by rs2.
+    // The 64-bit integer conversions are RV64 only.
+    const std::vector<std::pair<QString, unsigned>> intTypes = {
+        {"w", 0b00000}, {"wu", 0b00001}, {"l", 0b00010}, {"lu", 0b00011}};
+    for (const auto &[type, rs2] : intTypes) {
+      if (rs2 >= 0b00010 && !isRV64)
+        continue;
+      add("fcvt." + type + s, 0b11000, {OpPart(rs2, 20, 24)},
+          {gpr(1, 7, 11, "rd"), fpr(2, 15, 19, "rs1"), rm(3)});
+      add("fcvt" + s + "." + type, 0b11010, {OpPart(rs2, 20, 24)},
+          {fpr(1, 7, 11, "rd"), gpr(2, 15, 19, "rs1"), rm(3)});
+    }
+
+    // Moves of the raw bits between the register files
+    if (format.hasMoves) {
+      const QString x = "fmv.x." + format.moveSuffix;
+      const QString f = "fmv." + format.moveSuffix + ".x";
+      add(x, 0b11100, {OpPart(0b000, 12, 14), OpPart(0, 20, 24)},
+          {gpr(1, 7, 11, "rd"), fpr(2, 15, 19, "rs1")});
+      add(f, 0b11110, {OpPart(0b000, 12, 14), OpPart(0, 20, 24)},
+          {fpr(1, 7, 11, "rd"), gpr(2, 15, 19, "rs1")});
+    }
+
+    // Pseudo-op functors; moves, negation and absolute value are sign
+    // injections.
+    const std::vector<std::pair<QString, QString>> signOps = {
+        {"fmv", "fsgnj"}, {"fneg", "fsgnjn"}, {"fabs", "fsgnjx"}};
+    for (const auto &[pseudo, op] : signOps) {
+      const QString opName = op + s;
+      pseudoInstructions.push_back(std::shared_ptr<_PseudoInstruction>(
+          new _PseudoInstruction(
+              Token(pseudo + s), {RegTok, RegTok},
+              [opName](const _PseudoInstruction &,
+                       const TokenizedSrcLine &line, const SymbolMap &) {
+                return LineTokensVec{LineTokens()
+                                     << Token(opName) << line.tokens.at(1)
+                                     << line.tokens.at(2) << line.tokens.at(2)};
+              })));
+    }
+  }
+
+  /// Adds an instruction of the given opcode parts and fields. If the last
+  /// field is a rounding mode, a pseudo-instruction of the same name, without
+  /// the rounding mode operand, is added as well.
+  static void addInstruction(_InstrVec &instructions,
+                             _PseudoInstrVec &pseudoInstructions,
+                             const QString &name,
+                             const std::vector<OpPart> &opParts,
+                             const _Fields &fields) {
+    instructions.push_back(std::shared_ptr<_Instruction>(
+        new _Instruction(_Opcode(Token(name), opParts), fields)));
+    if (!std::dynamic_pointer_cast<RVRoundingMode<Reg__T>>(fields.back()))
+      return;
+    const _Fields operands(fields.size() - 1, RegTok);
+    pseudoInstructions.push_back(
+        std::shared_ptr<_PseudoInstruction>(new _PseudoInstruction(
+            Token(name), operands,
+            _PseudoExpandFunc(line) {
+              LineTokens tokens = line.tokens;
+              tokens << Token("dyn");
+              return LineTokensVec{tokens};
+            })));
+  }
+};
+
+/**
+ * Extension enabler.
+ * Calling an extension enabler will register the appropriate assemblers and
+ * pseudo-op expander functors with the assembler. The extension enablers are
+ * templated to allow for sharing implementations between 32- and 64-bit
+ * variants.
+ */
+template <typename Reg__T>
+struct RV_F {
+  AssemblerTypes(Reg__T);
+  static void enable(const ISAInfoBase *isa, _InstrVec &instructions,
+                     _PseudoInstrVec &pseudoInstructions) {
+    // Pseudo-op functors
+
+    // Accesses of the floating-point CSRs
+    const std::vector<std::pair<QString, QString>> csrs = {
+        {"csr", "fcsr"}, {"rm", "frm"}, {"flags", "fflags"}};
+    for (const auto &[suffix, csr] : csrs) {
+      pseudoInstructions.push_back(std::shared_ptr<_PseudoInstruction>(
+          new _PseudoInstruction(
+              Token("fr" + suffix), {RegTok},
+              [csr = csr](const _PseudoInstruction &,
+                        const TokenizedSrcLine &line, const SymbolMap &) {
+                return LineTokensVec{LineTokens()
+                                     << Token("csrrs") << line.tokens.at(1)
+                                     << Token(csr) << Token("x0")};
+              })));
+      pseudoInstructions.push_back(std::shared_ptr<_PseudoInstruction>(
+          new _PseudoInstruction(
+              Token("fs" + suffix), {RegTok, RegTok},
+              [csr = csr](const _PseudoInstruction &,
+                        const TokenizedSrcLine &line, const SymbolMap &) {
+                return LineTokensVec{LineTokens()
+                                     << Token("csrrw") << line.tokens.at(1)
+                                     << Token(csr) << line.tokens.at(2)};
+              })));
+    }
+
+    // The names of the moves prior to version 2.2 of the F extension
+    const std::vector<std::pair<QString, QString>> moveAliases = {
+        {"fmv.x.s", "fmv.x.w"}, {"fmv.s.x", "fmv.w.x"}};
+    for (const auto &[alias, name] : moveAliases) {
+      pseudoInstructions.push_back(std::shared_ptr<_PseudoInstruction>(
+          new _PseudoInstruction(
+              Token(alias), {RegTok, RegTok},
+              [name = name](const _PseudoInstruction &,
+                            const TokenizedSrcLine &line, const SymbolMap &) {
+                return LineTokensVec{LineTokens() << Token(name)
+                                                  << line.tokens.at(1)
+                                                  << line.tokens.at(2)};
+              })));
+    }
+
+    // Assembler functors
+    RV_FP<Reg__T>::addFormat(isa, instructions, pseudoInstructions,
+                             {"s", 0b00, "flw", "fsw", 0b010, "w", true});
+  }
+};
+
+} // namespace Assembler
+} // namespace Ripes
@@ -80,6 +80,33 @@ struct RV_I {
             return LineTokensVec{LineTokens() << Token("jal") << Token("x1") << line.tokens.at(1)};
         })));
 
+    pseudoInstructions.push_back(std::shared_ptr<_PseudoInstruction>(new _PseudoInstruction(
+        Token("csrr"), {RegTok, ImmTok}, _PseudoExpandFunc(line) {
+            return LineTokensVec{LineTokens() << Token("csrrs") << line.tokens.at(1) << line.tokens.at(2) << Token("x0")};
+        })));
+
+    // CSR writes, sets and clears, discarding the previous value of the CSR
+    const std::pair<const char *, const char *> csrWrites[] = {{"csrw", "csrrw"}, {"csrs", "csrrs"}, {"csrc", "csrrc"},
+                                                               {"csrwi", "csrrwi"}, {"csrsi", "csrrsi"}, {"csrci", "csrrci"}};
+    for (const auto &csrWrite : csrWrites) {
+        const QString op = csrWrite.second;
+        pseudoInstructions.push_back(std::shared_ptr<_PseudoInstruction>(new _PseudoInstruction(
+            Token(csrWrite.first), {ImmTok, op.endsWith('i') ? std::shared_ptr<Field<Reg__T>>(ImmTok) : RegTok}, [op](const _PseudoInstruction&, const TokenizedSrcLine& line, const SymbolMap&) {
+                return LineTokensVec{LineTokens() << Token(op) << Token("x0") << line.tokens.at(1) << line.tokens.at(2)};
+            })));
+    }
+
+    // Counter CSR reads (Zicntr)
+    const std::pair<const char *, const char *> counters[] = {{"rdcycle", "0xc00"}, {"rdtime", "0xc01"}, {"rdinstret", "0xc02"},
+                                                              {"rdcycleh", "0xc80"}, {"rdtimeh", "0xc81"}, {"rdinstreth", "0xc82"}};
+    for (const auto &counter : counters) {
+        const QString csr = counter.second;
+        pseudoInstructions.push_back(std::shared_ptr<_PseudoInstruction>(new _PseudoInstruction(
+            Token(counter.first), {RegTok}, [csr](const _PseudoInstruction&, const TokenizedSrcLine& line, const SymbolMap&) {
+                return LineTokensVec{LineTokens() << Token("csrrs") << line.tokens.at(1) << Token(csr) << Token("x0")};
+            })));
+    }
+
     pseudoInstructions.push_back(std::shared_ptr<_PseudoInstruction>(
         new _PseudoInstruction(Token(Token("nop")), {}, [](const _PseudoInstruction&, const TokenizedSrcLine& , const SymbolMap&) {
             return LineTokensVec{LineTokens() << Token("addi") << Token("x0") << Token("x0") << Token("0")};
@@ -183,12 +210,11 @@ struct RV_I {
           int64_t immediate = getImmediateSext32(line.tokens.at(2), canConvert);
 
           if (!canConvert) {
-            auto absSymbols = symbols.copyRelativeTo(line.sourceLine());
             // Check if the immediate has been made available in the symbol set
             // at this point...
-            auto it = absSymbols.find(line.tokens.at(2));
-            if (it != absSymbols.end()) {
-              immediate = it->second;
+            if (auto value =
+                    symbols.lookup(line.tokens.at(2), line.sourceLine())) {
+              immediate = *value;
             } else {
               if (unsignedFitErr) {
                 return Result<std::vector<LineTokens>>{
@@ -265,6 +291,37 @@ struct RV_I {
                 {OpPart(RVISA::Opcode::ECALL, 0, 6), OpPart(0, 7, 31)}),
         {})));
 
+    instructions.push_back(std::shared_ptr<_Instruction>(new _Instruction(
+        _Opcode(Token("mret"), {OpPart(RVISA::Opcode::ECALL, 0, 6),
+                                OpPart(0, 7, 19), OpPart(0x302, 20, 31)}),
+        {})));
+
+    instructions.push_back(std::shared_ptr<_Instruction>(new _Instruction(
+        _Opcode(Token("wfi"), {OpPart(RVISA::Opcode::ECALL, 0, 6),
+                               OpPart(0, 7, 19), OpPart(0x105, 20, 31)}),
+        {})));
+
+    // Zicsr; the register (rs1) and immediate (uimm) variants.
+    const std::pair<const char *, unsigned> csrOps[] = {
+        {"csrrw", 0b001}, {"csrrs", 0b010}, {"csrrc", 0b011}};
+    for (const auto &[name, funct3] : csrOps)
+      instructions.push_back(std::shared_ptr<_Instruction>(new _Instruction(
+          _Opcode(Token(name),
+                  {OpPart(RVISA::Opcode::ECALL, 0, 6), OpPart(funct3, 12, 14)}),
+          {std::make_shared<_Reg>(isa, 1, 7, 11, "rd"),
+           std::make_shared<CSRImm<Reg__T>>(2),
+           std::make_shared<_Reg>(isa, 3, 15, 19, "rs1")})));
+    const std::pair<const char *, unsigned> csrImmOps[] = {
+        {"csrrwi", 0b101}, {"csrrsi", 0b110}, {"csrrci", 0b111}};
+    for (const auto &[name, funct3] : csrImmOps)
+      instructions.push_back(std::shared_ptr<_Instruction>(new _Instruction(
+          _Opcode(Token(name),
+                  {OpPart(RVISA::Opcode::ECALL, 0, 6), OpPart(funct3, 12, 14)}),
+          {std::make_shared<_Reg>(isa, 1, 7, 11, "rd"),
+           std::make_shared<CSRImm<Reg__T>>(2),
+           std::make_shared<_Imm>(3, 5, _Imm::Repr::Unsigned,
+                                  std::vector{ImmPart(0, 15, 19)})})));
+
     instructions.push_back(UType(Token("lui"), RVISA::Opcode::LUI));
 
     instructions.push_back(std::shared_ptr<_Instruction>(new _Instruction(
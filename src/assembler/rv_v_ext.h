@@ -0,0 +1,270 @@
+#pragma once
+
+#include <QObject>
+#include <array>
+#include <functional>
+
+#include "assembler.h"
+#include "instruction.h"
+#include "rvassembler_common.h"
+
+namespace Ripes {
+namespace Assembler {
+
+/// Register specialization for the vector registers of the V extension, given
+/// as v0-v31.
+template <typename Reg_T>
+struct VReg : public Reg<Reg_T> {
+  using Reg<Reg_T>::Reg;
+  std::optional<Error> apply(const TokenizedSrcLine &line, Instr_T &instruction,
+                             FieldLinkRequest<Reg_T> &) const override {
+    const QString &regToken = line.tokens[this->tokenIndex];
+    bool success = regToken.startsWith('v');
+    const unsigned reg = success ? regToken.mid(1).toUInt(&success) : 0;
+    if (!success || reg >= 32)
+      return Error(line, "Unknown vector register '" + regToken + "'");
+    instruction |= this->m_range.apply(reg);
+    return std::nullopt;
+  }
+
+  std::optional<Error> decode(const Instr_T instruction,
+                              const Reg_T /*address*/, const ReverseSymbolMap &,
+                              LineTokens &line) const override {
+    line.push_back(
+        Token("v" + QString::number(this->m_range.decode(instruction))));
+    return std::nullopt;
+  }
+};
+
+/// A field of the vtype operand of vsetvli and vsetivli (ie. e32 or m1), given
+/// by name. The names are indexed by the encoding of the field; empty names
+/// are reserved encodings.
+template <typename Reg_T>
+struct VTypeField : public Field<Reg_T> {
+  VTypeField(unsigned tokenIndex, const BitRange &range,
+             const std::vector<QString> &names, const QString &what)
+      : Field<Reg_T>(tokenIndex), m_range(range), m_names(names),
+        m_what(what) {}
+
+  std::optional<Error> apply(const TokenizedSrcLine &line, Instr_T &instruction,
+                             FieldLinkRequest<Reg_T> &) const override {
+    const QString &token = line.tokens[this->tokenIndex];
+    for (unsigned v = 0; v < m_names.size(); ++v) {
+      if (!token.isEmpty() && token == m_names[v]) {
+        instruction |= m_range.apply(v);
+        return std::nullopt;
+      }
+    }
+    QStringList names;
+    for (const auto &name : m_names) {
+      if (!name.isEmpty())
+        names << name;
+    }
+    return Error(line, "Unknown " + m_what + " '" + token + "', expected " +
+                           names.join(", "));
+  }
+
+  std::optional<Error> decode(const Instr_T instruction, const Reg_T,
+                              const ReverseSymbolMap &,
+                              LineTokens &line) const override {
+    const unsigned v = m_range.decode(instruction);
+    if (v >= m_names.size() || m_names[v].isEmpty())
+      return Error(0, "Reserved " + m_what);
+    line.push_back(m_names[v]);
+    return std::nullopt;
+  }
+
+  std::vector<BitRange> bitRanges() const override { return {m_range}; }
+
+  const BitRange m_range;
+  const std::vector<QString> m_names;
+  const QString m_what;
+};
+
+/**
+ * Extension enabler.
+ * Calling an extension enabler will register the appropriate assemblers and
+ * pseudo-op expander functors with the assembler. The extension enablers are
+ * templated to allow for sharing implementations between 32- and 64-bit
+ * variants.
+ *
+ * The implemented subset of the V extension is unmasked; the vm bit (25) of
+ * the instructions is always set, and the v0.t operand is not accepted.
+ */
+template <typename Reg__T>
+struct RV_V {
+  AssemblerTypes(Reg__T);
+  using _Fields = std::vector<std::shared_ptr<Field<Reg__T>>>;
+
+  static void enable(const ISAInfoBase *isa, _InstrVec &instructions,
+                     _PseudoInstrVec &pseudoInstructions) {
+    auto vr = [&](unsigned token, unsigned start, unsigned stop,
+                  const QString &name) {
+      return std::make_shared<VReg<Reg__T>>(isa, token, start, stop, name);
+    };
+    auto gpr = [&](unsigned token, unsigned start, unsigned stop,
+                   const QString &name) {
+      return std::make_shared<_Reg>(isa, token, start, stop, name);
+    };
+    auto add = [&](const QString &name, const std::vector<OpPart> &opParts,
+                   const _Fields &fields) {
+      instructions.push_back(std::shared_ptr<_Instruction>(
+          new _Instruction(_Opcode(Token(name), opParts), fields)));
+    };
+
+    // Pseudo-op functors; vsetvli and vsetivli without the tail and mask
+    // policies are undisturbed.
+    for (const char *name : {"vsetvli", "vsetivli"}) {
+      pseudoInstructions.push_back(
+          std::shared_ptr<_PseudoInstruction>(new _PseudoInstruction(
+              Token(name), {RegTok, RegTok, RegTok, RegTok},
+              _PseudoExpandFunc(line) {
+                LineTokens tokens = line.tokens;
+                tokens << Token("tu") << Token("mu");
+                return LineTokensVec{tokens};
+              })));
+    }
+
+    // Assembler functors
+
+    // Configuration: "vsetvli rd, rs1, e32, m1, ta, ma",
+    // "vsetivli rd, uimm, e32, m1, ta, ma" and "vsetvl rd, rs1, rs2"
+    auto vtype = [](unsigned token) {
+      return _Fields{
+          std::make_shared<VTypeField<Reg__T>>(
+              token, BitRange(23, 25),
+              std::vector<QString>{"e8", "e16", "e32", "e64"}, "element width"),
+          std::make_shared<VTypeField<Reg__T>>(
+              token + 1, BitRange(20, 22),
+              std::vector<QString>{"m1", "m2", "m4", "m8", "", "mf8", "mf4",
+                                   "mf2"},
+              "register group multiplier"),
+          std::make_shared<VTypeField<Reg__T>>(
+              token + 2, BitRange(26, 26), std::vector<QString>{"tu", "ta"},
+              "tail policy"),
+          std::make_shared<VTypeField<Reg__T>>(
+              token + 3, BitRange(27, 27), std::vector<QString>{"mu", "ma"},
+              "mask policy")};
+    };
+    const std::vector<OpPart> config = {OpPart(RVISA::Opcode::OP_V, 0, 6),
+                                        OpPart(0b111, 12, 14)};
+    _Fields vsetvli = {gpr(1, 7, 11, "rd"), gpr(2, 15, 19, "rs1")};
+    for (const auto &field : vtype(3))
+      vsetvli.push_back(field);
+    auto opParts = config;
+    opParts.push_back(OpPart(0, 28, 31));
+    add("vsetvli", opParts, vsetvli);
+
+    _Fields vsetivli = {
+        gpr(1, 7, 11, "rd"),
+        std::make_shared<_Imm>(2, 5, _Imm::Repr::Unsigned,
+                               std::vector{ImmPart(0, 15, 19)})};
+    for (const auto &field : vtype(3))
+      vsetivli.push_back(field);
+    opParts = config;
+    opParts.push_back(OpPart(0, 28, 29));
+    opParts.push_back(OpPart(0b11, 30, 31));
+    add("vsetivli", opParts, vsetivli);
+
+    opParts = config;
+    opParts.push_back(OpPart(0b1000000, 25, 31));
+    add("vsetvl", opParts,
+        {gpr(1, 7, 11, "rd"), gpr(2, 15, 19, "rs1"), gpr(3, 20, 24, "rs2")});
+
+    // Unit-stride loads and stores: "vle32.v vd, (rs1)" and
+    // "vse32.v vs3, (rs1)", of the width given by funct3.
+    const std::vector<std::pair<QString, unsigned>> widths = {
+        {"8", 0b000}, {"16", 0b101}, {"32", 0b110}, {"64", 0b111}};
+    for (const auto &[eew, width] : widths) {
+      for (const bool isLoad : {true, false}) {
+        add((isLoad ? "vle" : "vse") + eew + ".v",
+            {OpPart(isLoad ? RVISA::Opcode::LOAD_FP : RVISA::Opcode::STORE_FP,
+                    0, 6),
+             OpPart(width, 12, 14), OpPart(0, 20, 24), OpPart(1, 25, 25),
+             OpPart(0, 26, 31)},
+            {vr(1, 7, 11, isLoad ? "vd" : "vs3"), gpr(2, 15, 19, "rs1")});
+      }
+    }
+
+    // Arithmetic: "vadd.vv vd, vs2, vs1", "vadd.vx vd, vs2, rs1" and
+    // "vadd.vi vd, vs2, simm5", of the forms given by funct3.
+    enum Forms { VV = 1, VX = 2, VI = 4 };
+    auto op = [&](const QString &name, unsigned funct3, unsigned funct6,
+                  const _Fields &fields) {
+      add(name,
+          {OpPart(RVISA::Opcode::OP_V, 0, 6), OpPart(funct3, 12, 14),
+           OpPart(1, 25, 25), OpPart(funct6, 26, 31)},
+          fields);
+    };
+    auto forms = [&](const QString &name, unsigned funct6, unsigned forms,
+                     bool isMul = false) {
+      if (forms & VV) {
+        op(name + ".vv", isMul ? 0b010 : 0b000, funct6,
+           {vr(1, 7, 11, "vd"), vr(2, 20, 24, "vs2"), vr(3, 15, 19, "vs1")});
+      }
+      if (forms & VX) {
+        op(name + ".vx", isMul ? 0b110 : 0b100, funct6,
+           {vr(1, 7, 11, "vd"), vr(2, 20, 24, "vs2"), gpr(3, 15, 19, "rs1")});
+      }
+      if (forms & VI) {
+        // The shift amounts of the shifts are unsigned.
+        const bool isShift = funct6 >= 0b100101;
+        op(name + ".vi", 0b011, funct6,
+           {vr(1, 7, 11, "vd"), vr(2, 20, 24, "vs2"),
+            std::make_shared<_Imm>(3, 5,
+                                   isShift ? _Imm::Repr::Unsigned
+                                           : _Imm::Repr::Signed,
+                                   std::vector{ImmPart(0, 15, 19)})});
+      }
+    };
+    const std::vector<std::tuple<QString, unsigned, unsigned>> integerOps = {
+        {"vadd", 0b000000, VV | VX | VI}, {"vsub", 0b000010, VV | VX},
+        {"vrsub", 0b000011, VX | VI},     {"vminu", 0b000100, VV | VX},
+        {"vmin", 0b000101, VV | VX},      {"vmaxu", 0b000110, VV | VX},
+        {"vmax", 0b000111, VV | VX},      {"vand", 0b001001, VV | VX | VI},
+        {"vor", 0b001010, VV | VX | VI},  {"vxor", 0b001011, VV | VX | VI},
+        {"vsll", 0b100101, VV | VX | VI}, {"vsrl", 0b101000, VV | VX | VI},
+        {"vsra", 0b101001, VV | VX | VI}};
+    for (const auto &[name, funct6, f] : integerOps)
+      forms(name, funct6, f);
+    forms("vmul", 0b100101, VV | VX, true);
+
+    // Moves to vector registers: "vmv.v.v vd, vs1", "vmv.v.x vd, rs1" and
+    // "vmv.v.i vd, simm5", with vs2 = v0
+    const std::vector<std::tuple<QString, unsigned, _Fields>> moves = {
+        {"vmv.v.v", 0b000, {vr(1, 7, 11, "vd"), vr(2, 15, 19, "vs1")}},
+        {"vmv.v.x", 0b100, {vr(1, 7, 11, "vd"), gpr(2, 15, 19, "rs1")}},
+        {"vmv.v.i", 0b011,
+         {vr(1, 7, 11, "vd"),
+          std::make_shared<_Imm>(2, 5, _Imm::Repr::Signed,
+                                 std::vector{ImmPart(0, 15, 19)})}}};
+    for (const auto &[name, funct3, fields] : moves) {
+      add(name,
+          {OpPart(RVISA::Opcode::OP_V, 0, 6), OpPart(funct3, 12, 14),
+           OpPart(0, 20, 24), OpPart(1, 25, 25), OpPart(0b010111, 26, 31)},
+          fields);
+    }
+
+    // Reductions: "vredsum.vs vd, vs2, vs1"
+    const std::array<const char *, 8> reductions = {
+        "vredsum", "vredand",  "vredor",  "vredxor",
+        "vredminu", "vredmin", "vredmaxu", "vredmax"};
+    for (unsigned funct6 = 0; funct6 < reductions.size(); ++funct6) {
+      op(QString(reductions[funct6]) + ".vs", 0b010, funct6,
+         {vr(1, 7, 11, "vd"), vr(2, 20, 24, "vs2"), vr(3, 15, 19, "vs1")});
+    }
+
+    // Moves of element 0: "vmv.x.s rd, vs2" and "vmv.s.x vd, rs1"
+    add("vmv.x.s",
+        {OpPart(RVISA::Opcode::OP_V, 0, 6), OpPart(0b010, 12, 14),
+         OpPart(0, 15, 19), OpPart(1, 25, 25), OpPart(0b010000, 26, 31)},
+        {gpr(1, 7, 11, "rd"), vr(2, 20, 24, "vs2")});
+    add("vmv.s.x",
+        {OpPart(RVISA::Opcode::OP_V, 0, 6), OpPart(0b110, 12, 14),
+         OpPart(0, 20, 24), OpPart(1, 25, 25), OpPart(0b010000, 26, 31)},
+        {vr(1, 7, 11, "vd"), gpr(2, 15, 19, "rs1")});
+  }
+};
+
+} // namespace Assembler
+} // namespace Ripes
@@ -154,5 +154,44 @@ namespace Assembler {
         return Result<std::vector<LineTokens>>(v);                             \
       }))
 
+/**
+ * @brief The CSRImm struct
+ * The 12-bit CSR number operand of the Zicsr instructions. CSRs may be given
+ * by name (ie. mtvec, see RVISA::csrNumber) or by number, and known CSRs are
+ * disassembled by name.
+ */
+template <typename Reg_T>
+struct CSRImm : public Imm<Reg_T> {
+  CSRImm(unsigned tokenIndex)
+      : Imm<Reg_T>(tokenIndex, 12, Imm<Reg_T>::Repr::Hex,
+                   std::vector{ImmPart(0, 20, 31)}) {}
+
+  std::optional<Error>
+  apply(const TokenizedSrcLine &line, Instr_T &instruction,
+        FieldLinkRequest<Reg_T> &linksWithSymbol) const override {
+    bool known;
+    const unsigned csr =
+        RVISA::csrNumber(line.tokens[this->tokenIndex], known);
+    if (!known)
+      return Imm<Reg_T>::apply(line, instruction, linksWithSymbol);
+    for (const auto &part : this->parts)
+      part.apply(csr, instruction);
+    return std::nullopt;
+  }
+
+  std::optional<Error> decode(const Instr_T instruction, const Reg_T address,
+                              const ReverseSymbolMap &symbolMap,
+                              LineTokens &line) const override {
+    Instr_T csr = 0;
+    for (const auto &part : this->parts)
+      part.decode(csr, instruction);
+    const QString name = RVISA::csrName(csr);
+    if (name.isEmpty())
+      return Imm<Reg_T>::decode(instruction, address, symbolMap, line);
+    line.push_back(name);
+    return std::nullopt;
+  }
+};
+
 } // namespace Assembler
 } // namespace Ripes
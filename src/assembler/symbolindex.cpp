@@ -0,0 +1,95 @@
+#include "symbolindex.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+SymbolIndex::SymbolIndex(const ReverseSymbolMap &symbols) {
+  std::vector<std::pair<QString, Entry>> sorted;
+  sorted.reserve(symbols.size());
+  for (const auto &symbol : symbols)
+    sorted.push_back({symbol.second.v.toCaseFolded(),
+                      Entry{symbol.first, symbol.second.v}});
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [](const auto &lhs, const auto &rhs) {
+                     return lhs.first < rhs.first;
+                   });
+
+  m_entries.reserve(sorted.size());
+  m_folded.reserve(sorted.size());
+  std::vector<Trigram> trigrams;
+  for (auto &symbol : sorted) {
+    const unsigned idx = m_entries.size();
+    const QString &folded = symbol.first;
+    trigrams.clear();
+    for (int i = 0; i + 2 < folded.size(); ++i)
+      trigrams.push_back(trigram(folded, i));
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()),
+                   trigrams.end());
+    for (const Trigram t : trigrams)
+      m_trigrams[t].push_back(idx);
+
+    m_folded.push_back(std::move(symbol.first));
+    m_entries.push_back(std::move(symbol.second));
+  }
+
+  m_byAddress.resize(m_entries.size());
+  for (unsigned i = 0; i < m_byAddress.size(); ++i)
+    m_byAddress[i] = i;
+  std::stable_sort(m_byAddress.begin(), m_byAddress.end(),
+                   [this](unsigned lhs, unsigned rhs) {
+                     return m_entries[lhs].address < m_entries[rhs].address;
+                   });
+}
+
+std::vector<unsigned> SymbolIndex::find(const QString &query,
+                                        size_t limit) const {
+  const QString folded = query.toCaseFolded();
+  if (folded.isEmpty()) {
+    return std::vector<unsigned>(
+        m_byAddress.begin(),
+        m_byAddress.begin() + std::min(limit, m_byAddress.size()));
+  }
+
+  std::vector<unsigned> matches;
+  // Prefix matches form a contiguous range of the sorted names.
+  auto it = std::lower_bound(m_folded.begin(), m_folded.end(), folded);
+  for (; it != m_folded.end() && it->startsWith(folded); ++it) {
+    if (matches.size() >= limit)
+      return matches;
+    matches.push_back(it - m_folded.begin());
+  }
+
+  const auto addContaining = [&](unsigned idx) {
+    const QString &name = m_folded[idx];
+    if (!name.startsWith(folded) && name.contains(folded))
+      matches.push_back(idx);
+    return matches.size() < limit;
+  };
+
+  if (folded.size() < 3) {
+    // Too short for a trigram; the query is compared against all names.
+    for (unsigned idx = 0; idx < m_folded.size(); ++idx)
+      if (!addContaining(idx))
+        break;
+    return matches;
+  }
+
+  // Any name containing the query contains all of its trigrams; the entries
+  // containing the rarest of those are the candidates.
+  const std::vector<unsigned> *candidates = nullptr;
+  for (int i = 0; i + 2 < folded.size(); ++i) {
+    auto postings = m_trigrams.find(trigram(folded, i));
+    if (postings == m_trigrams.end())
+      return matches;
+    if (!candidates || postings->second.size() < candidates->size())
+      candidates = &postings->second;
+  }
+  for (const unsigned idx : *candidates)
+    if (!addContaining(idx))
+      break;
+  return matches;
+}
+
+} // namespace Ripes
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QString>
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "program.h"
+
+namespace Ripes {
+
+/**
+ * @brief The SymbolIndex class
+ * A case-insensitive search index over the symbol table of a program, such that
+ * symbols may be filtered on each keystroke, even for programs linking
+ * thousands of library symbols.
+ *
+ * Entries are sorted by their case folded name, such that the entries with
+ * names starting with a query form a contiguous range, found by binary search.
+ * Names containing a query of at least three characters are found through the
+ * trigrams of the names: only the entries sharing the rarest trigram of the
+ * query are compared against it.
+ */
+class SymbolIndex {
+public:
+  struct Entry {
+    AInt address;
+    QString name;
+  };
+
+  SymbolIndex() = default;
+  explicit SymbolIndex(const ReverseSymbolMap &symbols);
+
+  /// Returns the indices of the entries with names containing @p query,
+  /// ignoring case. Names starting with @p query are ordered first; otherwise,
+  /// entries are ordered by name. An empty query matches all entries, ordered
+  /// by address. At most @p limit indices are returned.
+  std::vector<unsigned>
+  find(const QString &query,
+       size_t limit = std::numeric_limits<size_t>::max()) const;
+
+  const Entry &entry(unsigned idx) const { return m_entries.at(idx); }
+  unsigned size() const { return m_entries.size(); }
+
+private:
+  using Trigram = uint64_t;
+  static Trigram trigram(const QString &str, int pos) {
+    return (static_cast<Trigram>(str[pos].unicode()) << 32) |
+           (static_cast<Trigram>(str[pos + 1].unicode()) << 16) |
+           str[pos + 2].unicode();
+  }
+
+  /// Entries, sorted by folded name.
+  std::vector<Entry> m_entries;
+  /// The case folded name of each entry.
+  std::vector<QString> m_folded;
+  /// Entry indices, sorted by address.
+  std::vector<unsigned> m_byAddress;
+  /// The entries containing each trigram, in ascending order.
+  std::unordered_map<Trigram, std::vector<unsigned>> m_trigrams;
+};
+
+} // namespace Ripes
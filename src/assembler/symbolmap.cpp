@@ -46,5 +46,33 @@ AbsoluteSymbolMap SymbolMap::copyRelativeTo(unsigned line,
   return res;
 }
 
+std::optional<VIntS> SymbolMap::lookup(const QString &name, unsigned line,
+                                       const QString &beforeSuffix,
+                                       const QString &afterSuffix) const {
+  // Relative symbols take precedence over absolute symbols of the same name.
+  for (const QString *suffix : {&beforeSuffix, &afterSuffix}) {
+    if (!name.endsWith(*suffix))
+      continue;
+    const QString id = name.chopped(suffix->size());
+    bool ok;
+    const int relSymbol = id.toInt(&ok);
+    if (!ok || QString::number(relSymbol) != id)
+      continue;
+    auto relSymbols = rel.find(relSymbol);
+    if (relSymbols == rel.end())
+      continue;
+    auto ub = relSymbols->second.upper_bound(line);
+    if (suffix == &afterSuffix && ub != relSymbols->second.end())
+      return ub->second;
+    if (suffix == &beforeSuffix && ub != relSymbols->second.begin())
+      return std::prev(ub)->second;
+  }
+
+  auto it = abs.find(name);
+  if (it != abs.end())
+    return it->second;
+  return {};
+}
+
 } // namespace Assembler
 } // namespace Ripes
@@ -2,16 +2,19 @@
 
 #include "assembler_defines.h"
 #include <optional>
+#include <unordered_map>
 
 namespace Ripes {
 namespace Assembler {
 
-using AbsoluteSymbolMap = std::map<Symbol, VIntS>;
+using AbsoluteSymbolMap = std::unordered_map<Symbol, VIntS, Symbol::Hash>;
 struct SymbolMap {
   AbsoluteSymbolMap abs;
   using RelativeSymbol = int;
   using SourceLine = unsigned;
-  std::map<RelativeSymbol, std::map<SourceLine, VIntS>> rel;
+  // The definitions of each relative symbol, ordered by source line such that
+  // the nearest definition before or after a line may be found.
+  std::unordered_map<RelativeSymbol, std::map<SourceLine, VIntS>> rel;
 
   void clear() {
     abs.clear();
@@ -51,6 +54,12 @@ struct SymbolMap {
   AbsoluteSymbolMap copyRelativeTo(unsigned line,
                                    const QString &beforeSuffix = "b",
                                    const QString &afterSuffix = "f") const;
+
+  /// Returns the value of @p name in the copy of this symbol map relative to
+  /// @p line (see copyRelativeTo), without copying the symbol map.
+  std::optional<VIntS> lookup(const QString &name, unsigned line,
+                              const QString &beforeSuffix = "b",
+                              const QString &afterSuffix = "f") const;
 };
 
 } // namespace Assembler
@@ -0,0 +1,305 @@
+#include "breakpointcondition.h"
+
+#include <QRegularExpression>
+#include <algorithm>
+
+namespace Ripes {
+
+namespace {
+/// Returns the index of the first occurrence of @p token in @p s which is not
+/// enclosed in parentheses or brackets, or -1.
+int findTopLevel(const QString &s, const QString &token) {
+  int depth = 0;
+  for (int i = 0; i < s.size(); ++i) {
+    const QChar ch = s.at(i);
+    if (ch == '(' || ch == '[')
+      depth++;
+    else if (ch == ')' || ch == ']')
+      depth--;
+    else if (depth == 0 && s.mid(i, token.size()) == token)
+      return i;
+  }
+  return -1;
+}
+
+/// Splits @p s at the occurrences of @p token outside of parentheses and
+/// brackets.
+QStringList splitTopLevel(QString s, const QString &token) {
+  QStringList parts;
+  for (int i = findTopLevel(s, token); i != -1; i = findTopLevel(s, token)) {
+    parts.push_back(s.left(i));
+    s = s.mid(i + token.size());
+  }
+  parts.push_back(s);
+  return parts;
+}
+
+/// Returns the index of the parenthesis closing that at @p open, or -1.
+int closingParen(const QString &s, int open) {
+  int depth = 0;
+  for (int i = open; i < s.size(); ++i) {
+    if (s.at(i) == '(')
+      depth++;
+    else if (s.at(i) == ')' && --depth == 0)
+      return i;
+  }
+  return -1;
+}
+
+VIntS signExtend(VInt value, unsigned bits) {
+  if (bits >= sizeof(VInt) * CHAR_BIT)
+    return static_cast<VIntS>(value);
+  const unsigned shift = sizeof(VInt) * CHAR_BIT - bits;
+  return static_cast<VIntS>(value << shift) >> shift;
+}
+} // namespace
+
+struct BreakpointCondition::Compiler {
+  const ISAInfoBase &isa;
+  const Program *program;
+  std::vector<Value> memValues;
+
+  QString condition(const QString &s, Node &node) {
+    const QStringList terms = splitTopLevel(s, "||");
+    if (terms.size() == 1)
+      return conjunction(s, node);
+    node.kind = Node::Or;
+    node.children.resize(terms.size());
+    for (int i = 0; i < terms.size(); ++i) {
+      if (QString err = conjunction(terms[i], node.children[i]); !err.isEmpty())
+        return err;
+    }
+    return QString();
+  }
+
+  QString conjunction(const QString &s, Node &node) {
+    const QStringList terms = splitTopLevel(s, "&&");
+    if (terms.size() == 1)
+      return comparison(s, node);
+    node.kind = Node::And;
+    node.children.resize(terms.size());
+    for (int i = 0; i < terms.size(); ++i) {
+      if (QString err = comparison(terms[i], node.children[i]); !err.isEmpty())
+        return err;
+    }
+    return QString();
+  }
+
+  QString comparison(const QString &s, Node &node) {
+    // A parenthesized condition, as opposed to a parenthesized value.
+    if (s.startsWith('(') && closingParen(s, 0) == s.size() - 1) {
+      const QString inner = s.mid(1, s.size() - 2);
+      if (findComparison(inner).first != -1 ||
+          findTopLevel(inner, "&&") != -1 || findTopLevel(inner, "||") != -1)
+        return condition(inner, node);
+    }
+
+    node.kind = Node::Compare;
+    const auto [pos, op] = findComparison(s);
+    if (pos == -1)
+      return value(s, node.lhs);
+    node.op = op;
+    const int opSize = op == Node::Lt || op == Node::Gt ? 1 : 2;
+    if (QString err = value(s.left(pos), node.lhs); !err.isEmpty())
+      return err;
+    return value(s.mid(pos + opSize), node.rhs);
+  }
+
+  /// Returns the position and operator of the first top-level comparison of
+  /// @p s, if any.
+  static std::pair<int, Node::Op> findComparison(const QString &s) {
+    int depth = 0;
+    for (int i = 0; i < s.size(); ++i) {
+      const QChar ch = s.at(i);
+      const QChar next = i + 1 < s.size() ? s.at(i + 1) : QChar();
+      if (ch == '(' || ch == '[')
+        depth++;
+      else if (ch == ')' || ch == ']')
+        depth--;
+      else if (depth != 0)
+        continue;
+      else if (ch == '=' && next == '=')
+        return {i, Node::Eq};
+      else if (ch == '!' && next == '=')
+        return {i, Node::Ne};
+      else if (ch == '<')
+        return {i, next == '=' ? Node::Le : Node::Lt};
+      else if (ch == '>')
+        return {i, next == '=' ? Node::Ge : Node::Gt};
+    }
+    return {-1, Node::NonZero};
+  }
+
+  QString value(QString s, Value &value) {
+    // Words of memory are compiled as values of their own, and bound to
+    // symbols of the enclosing expression.
+    for (int i = s.indexOf("mem["); i != -1; i = s.indexOf("mem[", i + 1)) {
+      if (i > 0 && (s.at(i - 1).isLetterOrNumber() || s.at(i - 1) == '_'))
+        continue;
+      int depth = 0;
+      int end = i + 3;
+      for (; end < s.size(); ++end) {
+        if (s.at(end) == '[')
+          depth++;
+        else if (s.at(end) == ']' && --depth == 0)
+          break;
+      }
+      if (end == s.size())
+        return "Unmatched bracket in '" + s + "'";
+      Value address;
+      if (QString err = this->value(s.mid(i + 4, end - i - 4), address);
+          !err.isEmpty())
+        return err;
+      memValues.push_back(std::move(address));
+      s.replace(i, end - i + 1, "$mem" + QString::number(memValues.size() - 1));
+    }
+
+    if (s.isEmpty())
+      return "Missing operand";
+    if (s.contains('=') || s.contains('!'))
+      return "Invalid operator in '" + s + "'";
+    auto expr = Assembler::CompiledExpr::compile(Assembler::Location::unknown(),
+                                                 s);
+    if (expr.isError())
+      return expr.error().errorMessage();
+    value.expr = expr.value();
+
+    for (const auto &symbol : value.expr.symbols()) {
+      Binding binding;
+      bool isRegister = false;
+      if (symbol.startsWith("$mem")) {
+        binding.kind = Binding::Memory;
+        binding.index = symbol.mid(4).toUInt();
+      } else if (symbol == "pc") {
+        binding.kind = Binding::Pc;
+      } else if (binding.index = isa.regNumber(symbol, isRegister);
+                 isRegister) {
+        binding.kind = Binding::Register;
+      } else if (!programSymbol(symbol, binding.value)) {
+        return "Unknown symbol '" + symbol + "'";
+      }
+      value.bindings.push_back(binding);
+    }
+    value.symbolValues.resize(value.bindings.size());
+    return QString();
+  }
+
+  bool programSymbol(const QString &name, VIntS &value) const {
+    if (!program)
+      return false;
+    for (const auto &symbol : program->symbols) {
+      if (symbol.second.v == name) {
+        value = static_cast<VIntS>(symbol.first);
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+QString BreakpointCondition::compile(const QString &condition,
+                                     const ISAInfoBase &isa,
+                                     const Program *program) {
+  QString s = condition;
+  s.remove(QRegularExpression("\\s"));
+  std::unique_ptr<Node> root;
+  Compiler compiler{isa, program, {}};
+  if (!s.isEmpty()) {
+    root = std::make_unique<Node>();
+    if (QString err = compiler.condition(s, *root); !err.isEmpty())
+      return "Invalid condition '" + condition + "': " + err;
+  }
+  m_text = condition.trimmed();
+  m_root = std::move(root);
+  m_memValues = std::move(compiler.memValues);
+  m_bits = isa.bits();
+  return QString();
+}
+
+bool BreakpointCondition::triggers(RipesProcessor &proc, StageIndex stage) {
+  const long long cycle = proc.getCycleCount();
+  if (cycle == m_lastCycle)
+    return m_lastResult;
+  const bool stalled =
+      cycle == m_lastCycle + 1 &&
+      (proc.isStalled() ||
+       proc.stageInfo(stage).state == StageInfo::State::Stalled);
+  m_lastCycle = cycle;
+  if (stalled)
+    return m_lastResult;
+
+  if (m_root && !holds(*m_root, proc, proc.getPcForStage(stage))) {
+    m_lastResult = false;
+    return false;
+  }
+  m_hits++;
+  m_lastResult = m_hits >= m_hitCount;
+  return m_lastResult;
+}
+
+bool BreakpointCondition::holds(const Node &node, RipesProcessor &proc,
+                                AInt pc) const {
+  switch (node.kind) {
+  case Node::Or:
+    return std::any_of(
+        node.children.begin(), node.children.end(),
+        [&](const Node &child) { return holds(child, proc, pc); });
+  case Node::And:
+    return std::all_of(
+        node.children.begin(), node.children.end(),
+        [&](const Node &child) { return holds(child, proc, pc); });
+  case Node::Compare:
+    break;
+  }
+
+  const VIntS lhs = evaluate(node.lhs, proc, pc);
+  if (node.op == Node::NonZero)
+    return lhs != 0;
+  const VIntS rhs = evaluate(node.rhs, proc, pc);
+  switch (node.op) {
+  case Node::Eq:
+    return lhs == rhs;
+  case Node::Ne:
+    return lhs != rhs;
+  case Node::Lt:
+    return lhs < rhs;
+  case Node::Le:
+    return lhs <= rhs;
+  case Node::Gt:
+    return lhs > rhs;
+  case Node::Ge:
+    return lhs >= rhs;
+  case Node::NonZero:
+    break;
+  }
+  Q_UNREACHABLE();
+}
+
+VIntS BreakpointCondition::evaluate(const Value &value, RipesProcessor &proc,
+                                    AInt pc) const {
+  for (size_t i = 0; i < value.bindings.size(); ++i) {
+    const Binding &binding = value.bindings[i];
+    VIntS &v = value.symbolValues[i];
+    switch (binding.kind) {
+    case Binding::Constant:
+      v = binding.value;
+      break;
+    case Binding::Register:
+      v = signExtend(proc.getRegister(RegisterFileType::GPR, binding.index),
+                     m_bits);
+      break;
+    case Binding::Pc:
+      v = static_cast<VIntS>(pc);
+      break;
+    case Binding::Memory: {
+      const AInt address = static_cast<AInt>(
+          evaluate(m_memValues[binding.index], proc, pc));
+      v = signExtend(proc.getMemory().readMemConst(address, 4), 32);
+      break;
+    }
+    }
+  }
+  return value.expr.evaluate(value.symbolValues.data());
+}
+
+} // namespace Ripes
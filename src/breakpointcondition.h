@@ -0,0 +1,108 @@
+#pragma once
+
+#include <QString>
+#include <memory>
+#include <vector>
+
+#include "assembler/expreval.h"
+#include "assembler/program.h"
+#include "isa/isainfo.h"
+#include "processors/interface/ripesprocessor.h"
+
+namespace Ripes {
+
+/**
+ * @brief The BreakpointCondition class
+ * The condition and hit count of a breakpoint. The breakpoint triggers when
+ * its PC enters a breakpoint-triggering stage with the condition holding, from
+ * the hit count'th time that this happens. Conditions are compiled once, and
+ * only evaluated when the PC matches.
+ *
+ * A condition is a boolean combination of comparisons of values:
+ *
+ *   condition  := and ('||' and)*
+ *   and        := comparison ('&&' comparison)*
+ *   comparison := value [('==' | '!=' | '<' | '<=' | '>' | '>=') value]
+ *               | '(' condition ')'
+ *
+ * Values are assembler expressions (see Assembler::evaluate) over the
+ * registers of the ISA (by name or alias), 'pc', the symbols of the program
+ * and the words of memory 'mem[<value>]'. Values are signed, and registers and
+ * words are sign-extended; a value without comparison holds if non-zero.
+ * Conditions are evaluated on the register state of the processor at the time
+ * that the breakpoint triggers.
+ */
+class BreakpointCondition {
+public:
+  /**
+   * @brief compile
+   * Compiles @p condition against the registers of @p isa and the symbols of
+   * @p program, if any. An empty condition always holds. Returns an error
+   * message on failure, in which case the condition is unchanged.
+   */
+  QString compile(const QString &condition, const ISAInfoBase &isa,
+                  const Program *program);
+
+  /// Sets the number of times which the breakpoint must be hit before
+  /// triggering; 0 and 1 trigger upon the first hit.
+  void setHitCount(unsigned hitCount) { m_hitCount = hitCount; }
+
+  const QString &text() const { return m_text; }
+  unsigned hitCount() const { return m_hitCount; }
+  /// The number of times the breakpoint was hit since the last reset.
+  unsigned hits() const { return m_hits; }
+  void resetHits() {
+    m_hits = 0;
+    m_lastCycle = -1;
+  }
+
+  /**
+   * @brief triggers
+   * Returns true if the breakpoint triggers, given that its PC is within
+   * @p stage of @p proc. A breakpoint is hit once per entry into the stage;
+   * repeated calls within a cycle, and cycles in which the stage is stalled,
+   * are not counted as hits.
+   */
+  bool triggers(RipesProcessor &proc, StageIndex stage);
+
+private:
+  struct Binding {
+    enum Kind { Constant, Register, Pc, Memory };
+    Kind kind = Constant;
+    // The register index, or the index of the memory value.
+    unsigned index = 0;
+    VIntS value = 0;
+  };
+  struct Value {
+    Assembler::CompiledExpr expr;
+    std::vector<Binding> bindings;
+    // The values bound to the symbols of the expression upon evaluation.
+    mutable std::vector<VIntS> symbolValues;
+  };
+  struct Node {
+    enum Kind { Or, And, Compare };
+    enum Op { NonZero, Eq, Ne, Lt, Le, Gt, Ge };
+    Kind kind = Compare;
+    std::vector<Node> children;
+    Op op = NonZero;
+    Value lhs, rhs;
+  };
+
+  struct Compiler;
+  bool holds(const Node &node, RipesProcessor &proc, AInt pc) const;
+  VIntS evaluate(const Value &value, RipesProcessor &proc, AInt pc) const;
+
+  QString m_text;
+  // Null for an empty condition.
+  std::unique_ptr<Node> m_root;
+  std::vector<Value> m_memValues;
+  unsigned m_bits = 32;
+  unsigned m_hitCount = 0;
+
+  unsigned m_hits = 0;
+  // The cycle of the most recent call to triggers(), and its result.
+  long long m_lastCycle = -1;
+  bool m_lastResult = false;
+};
+
+} // namespace Ripes
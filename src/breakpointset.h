@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <set>
+#include <unordered_set>
+#include <vector>
+
+#include "ripes_types.h"
+
+namespace Ripes {
+
+/**
+ * @brief The BreakpointSet class
+ * The set of breakpoint addresses, optimized for the per-cycle lookups of a
+ * run. Breakpoints within the range set by setRange() (ie. the text section of
+ * the program) are held in a bitmap of its halfwords, the alignment of
+ * instructions; other breakpoints are held in a hash set. The ordered set of
+ * addresses is kept for enumeration.
+ */
+class BreakpointSet {
+public:
+  /// Sets the range [start; end[ covered by the bitmap.
+  void setRange(AInt start, AInt end) {
+    m_start = start;
+    m_bits.assign(end > start ? ((end - start) / 2 + 63) / 64 : 0, 0);
+    m_end = m_start + m_bits.size() * 64 * 2;
+    m_sparse.clear();
+    for (const AInt address : m_addresses)
+      mark(address, true);
+  }
+
+  void insert(AInt address) {
+    if (m_addresses.insert(address).second)
+      mark(address, true);
+  }
+  void erase(AInt address) {
+    if (m_addresses.erase(address))
+      mark(address, false);
+  }
+  void clear() {
+    m_addresses.clear();
+    m_sparse.clear();
+    std::fill(m_bits.begin(), m_bits.end(), 0);
+  }
+
+  bool empty() const { return m_addresses.empty(); }
+  bool contains(AInt address) const {
+    if (address >= m_start && address < m_end && (address & 1) == 0) {
+      const AInt bit = (address - m_start) / 2;
+      return (m_bits[bit / 64] >> (bit % 64)) & 1;
+    }
+    return !m_sparse.empty() && m_sparse.count(address);
+  }
+
+  /// The breakpoint addresses, in ascending order.
+  const std::set<AInt> &addresses() const { return m_addresses; }
+
+private:
+  void mark(AInt address, bool set) {
+    if (address >= m_start && address < m_end && (address & 1) == 0) {
+      const AInt bit = (address - m_start) / 2;
+      const uint64_t mask = uint64_t(1) << (bit % 64);
+      if (set)
+        m_bits[bit / 64] |= mask;
+      else
+        m_bits[bit / 64] &= ~mask;
+    } else if (set) {
+      m_sparse.insert(address);
+    } else {
+      m_sparse.erase(address);
+    }
+  }
+
+  std::set<AInt> m_addresses;
+  AInt m_start = 0;
+  AInt m_end = 0;
+  std::vector<uint64_t> m_bits;
+  std::unordered_set<AInt> m_sparse;
+};
+
+} // namespace Ripes
@@ -20,9 +20,10 @@ CacheConfigWidget::CacheConfigWidget(QWidget *parent)
 
   // Gather a list of all items in this widget which will trigger a modification
   // to the current configuration
-  m_configItems = {
-      m_ui->presets,           m_ui->ways,   m_ui->lines, m_ui->blocks,
-      m_ui->replacementPolicy, m_ui->wrMiss, m_ui->wrHit};
+  m_configItems = {m_ui->presets,           m_ui->ways,
+                   m_ui->lines,             m_ui->blocks,
+                   m_ui->replacementPolicy, m_ui->prefetchPolicy,
+                   m_ui->wrMiss,            m_ui->wrHit};
 }
 
 void CacheConfigWidget::setCache(const std::shared_ptr<CacheSim> &cache) {
@@ -31,10 +32,20 @@ void CacheConfigWidget::setCache(const std::shared_ptr<CacheSim> &cache) {
   setupEnumCombobox(m_ui->replacementPolicy, s_cacheReplPolicyStrings);
   setupEnumCombobox(m_ui->wrHit, s_cacheWritePolicyStrings);
   setupEnumCombobox(m_ui->wrMiss, s_cacheWriteAllocateStrings);
+  setupEnumCombobox(m_ui->prefetchPolicy, s_cachePrefetchPolicyStrings);
 
   m_ui->ways->setValue(m_cache->getWaysBits());
   m_ui->lines->setValue(m_cache->getLineBits());
   m_ui->blocks->setValue(m_cache->getBlockBits());
+  m_ui->hitLatency->setValue(m_cache->getLatency());
+  m_ui->missLatency->setValue(m_cache->getMissLatency());
+
+  // Latencies only affect the timing of subsequent accesses, and do not require
+  // the cache to be reset.
+  connect(m_ui->hitLatency, QOverload<int>::of(&QSpinBox::valueChanged),
+          cache.get(), [=](int cycles) { m_cache->setLatency(cycles); });
+  connect(m_ui->missLatency, QOverload<int>::of(&QSpinBox::valueChanged),
+          cache.get(), [=](int cycles) { m_cache->setMissLatency(cycles); });
 
   connect(m_ui->ways, QOverload<int>::of(&QSpinBox::valueChanged),
           m_cache.get(), &CacheSim::setWays);
@@ -49,6 +60,12 @@ void CacheConfigWidget::setCache(const std::shared_ptr<CacheSim> &cache) {
             m_cache->setReplacementPolicy(qvariant_cast<ReplPolicy>(
                 m_ui->replacementPolicy->itemData(index)));
           });
+  connect(m_ui->prefetchPolicy,
+          QOverload<int>::of(&QComboBox::currentIndexChanged), cache.get(),
+          [=](int index) {
+            m_cache->setPrefetchPolicy(qvariant_cast<PrefetchPolicy>(
+                m_ui->prefetchPolicy->itemData(index)));
+          });
   connect(m_ui->wrHit, QOverload<int>::of(&QComboBox::currentIndexChanged),
           cache.get(), [=](int index) {
             m_cache->setWritePolicy(
@@ -159,6 +176,7 @@ void CacheConfigWidget::handleConfigurationChanged() {
   setEnumIndex(m_ui->wrHit, m_cache->getWritePolicy());
   setEnumIndex(m_ui->wrMiss, m_cache->getWriteAllocPolicy());
   setEnumIndex(m_ui->replacementPolicy, m_cache->getReplacementPolicy());
+  setEnumIndex(m_ui->prefetchPolicy, m_cache->getPrefetchPolicy());
 
   if (!m_justSetPreset) {
     m_ui->presets->setCurrentIndex(-1);
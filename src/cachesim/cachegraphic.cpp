@@ -5,9 +5,11 @@
 #include <QGraphicsScene>
 #include <QGraphicsSimpleTextItem>
 #include <QPen>
+#include <QTimer>
 
 #include "processorhandler.h"
 #include "radix.h"
+#include "ripessettings.h"
 
 namespace {
 
@@ -75,6 +77,22 @@ private:
   QGraphicsPolygonItem *m_arrow = nullptr;
 };
 
+/**
+ * @brief The DetailLayer class
+ * An empty item grouping all items which are only drawn when the cache is
+ * viewed in detail. Hiding the layer hides all of its children.
+ */
+class DetailLayer : public QGraphicsItem {
+public:
+  DetailLayer(QGraphicsItem *parent) : QGraphicsItem(parent) {
+    setFlag(QGraphicsItem::ItemHasNoContents);
+  }
+
+  QRectF boundingRect() const override { return childrenBoundingRect(); }
+  void paint(QPainter *, const QStyleOptionGraphicsItem *,
+             QWidget * = nullptr) override {}
+};
+
 CacheGraphic::CacheGraphic(CacheSim &cache)
     : QGraphicsObject(nullptr), m_cache(cache), m_fm(m_font) {
   // Connect to CacheSim::dataChanged using QueuedConnection, to ensure allow
@@ -86,18 +104,13 @@ CacheGraphic::CacheGraphic(CacheSim &cache)
           &CacheGraphic::wayInvalidated);
   connect(&cache, &CacheSim::cacheInvalidated, this,
           &CacheGraphic::cacheInvalidated);
+  connect(&cache, &CacheSim::transactionsBatched, this,
+          &CacheGraphic::transactionsBatched);
 
   cacheInvalidated();
 }
 
 void CacheGraphic::updateLineReplFields(unsigned lineIdx) {
-  auto *cacheLine = m_cache.getLine(lineIdx);
-
-  if (cacheLine == nullptr) {
-    // Nothing to do
-    return;
-  }
-
   if (m_cacheTextItems.at(0).at(0).lru == nullptr) {
     // The current cache configuration does not have any replacement field
     return;
@@ -106,7 +119,7 @@ void CacheGraphic::updateLineReplFields(unsigned lineIdx) {
   for (const auto &way : m_cacheTextItems[lineIdx]) {
     // If LRU was just initialized, the actual (software) LRU value may be very
     // large. Mask to the number of actual LRU bits.
-    unsigned lruVal = cacheLine->at(way.first).lru;
+    unsigned lruVal = m_cache.getWay(lineIdx, way.first).lru;
     lruVal &= vsrtl::generateBitmask(m_cache.getWaysBits());
     const QString lruText = QString::number(lruVal);
     way.second.lru->setText(lruText);
@@ -136,11 +149,7 @@ void CacheGraphic::updateWay(unsigned lineIdx, unsigned wayIdx) {
   }
   CacheWay &way = wayIt->second;
 
-  CacheSim::CacheWay simWay = CacheSim::CacheWay();
-
-  if (auto *cacheLine = m_cache.getLine(lineIdx)) {
-    simWay = cacheLine->at(wayIdx);
-  };
+  const CacheSim::CacheWay simWay = m_cache.getWay(lineIdx, wayIdx);
 
   const unsigned bytes = ProcessorHandler::currentISA()->bytes();
   // ======================== Update block text fields ======================
@@ -173,6 +182,9 @@ void CacheGraphic::updateWay(unsigned lineIdx, unsigned wayIdx) {
       if (simWay.dirtyBlocks.count(i)) {
         tooltip += "\n> Dirty";
       }
+      if (simWay.prefetched) {
+        tooltip += "\n> Prefetched";
+      }
       blockTextItem->setToolTip(tooltip);
       // Store the address within the userrole of the block text. Doing this, we
       // are able to easily retrieve the address for the block if the block is
@@ -239,8 +251,8 @@ void CacheGraphic::updateWay(unsigned lineIdx, unsigned wayIdx) {
     const auto bottomRight =
         QPointF((blockIdx + 1) * m_blockWidth + m_widthBeforeBlocks,
                 lineIdx * m_lineHeight + (wayIdx + 1) * m_setHeight);
-    way.dirtyBlocks[blockIdx] =
-        std::make_unique<QGraphicsRectItem>(QRectF(topLeft, bottomRight), this);
+    way.dirtyBlocks[blockIdx] = std::make_unique<QGraphicsRectItem>(
+        QRectF(topLeft, bottomRight), m_detailLayer);
 
     const auto &dirtyRectItem = way.dirtyBlocks[blockIdx];
     dirtyRectItem->setZValue(-1);
@@ -253,7 +265,7 @@ QGraphicsSimpleTextItem *
 CacheGraphic::tryCreateGraphicsTextItem(QGraphicsSimpleTextItem **item, qreal x,
                                         qreal y) {
   if (*item == nullptr) {
-    *item = new QGraphicsSimpleTextItem(this);
+    *item = new QGraphicsSimpleTextItem(m_detailLayer);
     (*item)->setFont(m_font);
     (*item)->setPos(x, y);
   }
@@ -263,7 +275,7 @@ CacheGraphic::tryCreateGraphicsTextItem(QGraphicsSimpleTextItem **item, qreal x,
 std::unique_ptr<QGraphicsSimpleTextItem>
 CacheGraphic::createGraphicsTextItemSP(qreal x, qreal y) {
   std::unique_ptr<QGraphicsSimpleTextItem> ptr =
-      std::make_unique<QGraphicsSimpleTextItem>(this);
+      std::make_unique<QGraphicsSimpleTextItem>(m_detailLayer);
   ptr->setFont(m_font);
   ptr->setPos(x, y);
   return ptr;
@@ -306,7 +318,8 @@ void CacheGraphic::drawIndexingItems() {
   };
 
   // Draw address box
-  const QString addressText = QString("-").repeated(32);
+  const unsigned addressBits = ProcessorHandler::currentISA()->bits();
+  const QString addressText = QString("-").repeated(addressBits);
   m_addressTextItem = drawText(addressText, 0, 0 - m_setHeight * 3.5);
   auto addressTextRect = m_addressTextItem->boundingRect();
   addressTextRect.moveTo(m_addressTextItem->pos());
@@ -323,7 +336,7 @@ void CacheGraphic::drawIndexingItems() {
   smallerFont.setPointSize(m_font.pointSize() * 0.8);
   drawText(botBits, nextBitsPos.x(), nextBitsPos.y() - m_setHeight,
            &smallerFont);
-  const QString topBits = "31";
+  const QString topBits = QString::number(addressBits - 1);
   drawText(topBits,
            m_addressTextItem->pos().x() - smallerFontMetric.width(topBits),
            m_addressTextItem->pos().y() - m_setHeight, &smallerFont);
@@ -397,6 +410,12 @@ void CacheGraphic::cacheInvalidated() {
   for (const auto &item : childItems()) {
     delete item;
   }
+  m_dirtyWays.clear();
+  m_dirtyLines.clear();
+  m_transactionPending = false;
+  m_pendingPrefetches.clear();
+  m_detailLayer = new DetailLayer(this);
+  m_detailLayer->setVisible(m_detailed);
 
   // Determine cell dimensions
   m_setHeight = m_fm.height();
@@ -479,7 +498,7 @@ void CacheGraphic::cacheInvalidated() {
       for (int j = 1; j < m_cache.getWays(); j++) {
         verticalAdvance += m_setHeight;
         auto *setLine = new QGraphicsLineItem(0, verticalAdvance, m_cacheWidth,
-                                              verticalAdvance, this);
+                                              verticalAdvance, m_detailLayer);
         auto pen = setLine->pen();
         pen.setStyle(Qt::DashLine);
         setLine->setPen(pen);
@@ -493,7 +512,7 @@ void CacheGraphic::cacheInvalidated() {
 
     const qreal y = i * m_lineHeight + m_lineHeight / 2 - m_setHeight / 2;
     const qreal x = -m_fm.width(text) * 1.2;
-    drawText(text, x, y);
+    drawText(text, x, y, nullptr, m_detailLayer);
   }
 
   // Draw index column text
@@ -511,13 +530,12 @@ void CacheGraphic::cacheInvalidated() {
 
   // Update all entries in the cache
   for (int lineIdx = 0; lineIdx < m_cache.getLines(); lineIdx++) {
-    if (const auto *line = m_cache.getLine(lineIdx)) {
-      for (const auto &way : *line) {
-        updateWay(lineIdx, way.first);
-      }
-      updateLineReplFields(lineIdx);
+    for (int wayIdx = 0; wayIdx < m_cache.getWays(); wayIdx++) {
+      m_dirtyWays.emplace(lineIdx, wayIdx);
     }
+    m_dirtyLines.insert(lineIdx);
   }
+  refresh();
 
   if (auto *_scene = scene()) {
     // Invalidate the scene rect to resize it to the current dimensions of the
@@ -541,7 +559,8 @@ void CacheGraphic::updateAddressing(
 
       const CacheWay &way = wayIt->second;
       m_addressTextItem->setText(
-          QString::number(transaction.address, 2).rightJustified(32, '0'));
+          QString::number(transaction.address, 2)
+              .rightJustified(ProcessorHandler::currentISA()->bits(), '0'));
 
       if (way.tag) {
         QPolygonF lineIndexingPoly;
@@ -577,37 +596,115 @@ void CacheGraphic::updateAddressing(
       }
 
     } else {
-      m_addressTextItem->setText(QString("-").repeated(32));
+      m_addressTextItem->setText(
+          QString("-").repeated(ProcessorHandler::currentISA()->bits()));
     }
   }
 }
 
 void CacheGraphic::wayInvalidated(unsigned lineIdx, unsigned wayIdx) {
-  updateWay(lineIdx, wayIdx);
-  updateLineReplFields(lineIdx);
+  m_dirtyWays.emplace(lineIdx, wayIdx);
+  m_dirtyLines.insert(lineIdx);
+  scheduleRefresh();
 }
 
 void CacheGraphic::dataChanged(CacheSim::CacheTransaction transaction) {
   if (transaction.type != MemoryAccess::None) {
-    wayInvalidated(transaction.index.line, transaction.index.way);
-    updateAddressing(true, transaction);
-    updateHighlighting(true, transaction);
+    m_dirtyWays.emplace(transaction.index.line, transaction.index.way);
+    m_dirtyLines.insert(transaction.index.line);
+  }
+  if (transaction.isPrefetch) {
+    // Prefetches are highlighted alongside the access which triggered them.
+    m_pendingPrefetches.push_back(transaction);
   } else {
-    updateHighlighting(false, transaction);
-    updateAddressing(false, transaction);
+    // Only the most recent transaction is highlighted.
+    m_pendingTransaction = transaction;
+    m_transactionPending = true;
+    m_pendingPrefetches.clear();
+  }
+  scheduleRefresh();
+}
+
+void CacheGraphic::transactionsBatched(
+    const std::vector<CacheSim::CacheTransaction> &transactions) {
+  for (const auto &transaction : transactions) {
+    if (transaction.type != MemoryAccess::None) {
+      m_dirtyWays.emplace(transaction.index.line, transaction.index.way);
+      m_dirtyLines.insert(transaction.index.line);
+    }
+    if (transaction.isPrefetch) {
+      m_pendingPrefetches.push_back(transaction);
+    } else {
+      m_pendingTransaction = transaction;
+      m_transactionPending = true;
+      m_pendingPrefetches.clear();
+    }
+  }
+  // Batches are already delivered at the UI update rate.
+  refresh();
+}
+
+void CacheGraphic::scheduleRefresh() {
+  if (m_refreshScheduled) {
+    return;
+  }
+  m_refreshScheduled = true;
+  const int interval = 1000 / RipesSettings::cached<SettingId::UIUpdatePS>();
+  QTimer::singleShot(interval, this, &CacheGraphic::refresh);
+}
+
+void CacheGraphic::refresh() {
+  m_refreshScheduled = false;
+  // The cache simulator is owned by the simulator thread while running; the
+  // contents of the cache are only updated once running has finished.
+  if (m_detailed && !ProcessorHandler::isRunning()) {
+    for (const auto &way : m_dirtyWays) {
+      updateWay(way.first, way.second);
+    }
+    for (const unsigned lineIdx : m_dirtyLines) {
+      updateLineReplFields(lineIdx);
+    }
+    m_dirtyWays.clear();
+    m_dirtyLines.clear();
+  }
+
+  if (m_transactionPending) {
+    const bool active = m_pendingTransaction.type != MemoryAccess::None;
+    updateAddressing(active, m_pendingTransaction);
+    updateHighlighting(active, m_pendingTransaction);
+    m_transactionPending = false;
+  }
+  for (const auto &prefetch : m_pendingPrefetches) {
+    highlightPrefetch(prefetch);
+  }
+  m_pendingPrefetches.clear();
+}
+
+void CacheGraphic::setLevelOfDetail(qreal lod) {
+  const bool detailed = lod >= s_detailedLOD;
+  if (detailed == m_detailed) {
+    return;
+  }
+  m_detailed = detailed;
+  m_detailLayer->setVisible(detailed);
+  if (detailed) {
+    // Apply all updates deferred while the graphic was not viewed in detail
+    refresh();
   }
 }
 
 QGraphicsSimpleTextItem *CacheGraphic::drawText(const QString &text,
                                                 const QPointF &pos,
-                                                const QFont *otherFont) {
-  return drawText(text, pos.x(), pos.y(), otherFont);
+                                                const QFont *otherFont,
+                                                QGraphicsItem *parent) {
+  return drawText(text, pos.x(), pos.y(), otherFont, parent);
 }
 
 QGraphicsSimpleTextItem *CacheGraphic::drawText(const QString &text, qreal x,
-                                                qreal y,
-                                                const QFont *otherFont) {
-  auto *textItem = new QGraphicsSimpleTextItem(text, this);
+                                                qreal y, const QFont *otherFont,
+                                                QGraphicsItem *parent) {
+  auto *textItem =
+      new QGraphicsSimpleTextItem(text, parent ? parent : this);
   if (otherFont) {
     textItem->setFont(*otherFont);
   } else {
@@ -671,6 +768,23 @@ void CacheGraphic::updateHighlighting(
   }
 }
 
+void CacheGraphic::highlightPrefetch(
+    const CacheSim::CacheTransaction &transaction) {
+  const QPointF topLeft =
+      QPointF(m_widthBeforeTag, transaction.index.line * m_lineHeight +
+                                    transaction.index.way * m_setHeight);
+  const QPointF bottomRight =
+      QPointF(m_cacheWidth, transaction.index.line * m_lineHeight +
+                                (transaction.index.way + 1) * m_setHeight);
+  m_highlightingItems.emplace_back(std::make_unique<QGraphicsRectItem>(
+      QRectF(topLeft, bottomRight), this));
+  auto *prefetchRectItem = m_highlightingItems.rbegin()->get();
+  prefetchRectItem->setZValue(-1);
+  prefetchRectItem->setOpacity(0.3);
+  prefetchRectItem->setBrush(Qt::blue);
+  prefetchRectItem->setToolTip("Prefetched");
+}
+
 void CacheGraphic::initializeControlBits() {
   for (int lineIdx = 0; lineIdx < m_cache.getLines(); lineIdx++) {
     auto &line = m_cacheTextItems[lineIdx];
@@ -680,12 +794,12 @@ void CacheGraphic::initializeControlBits() {
 
       // Create valid field
       x = m_bitWidth / 2 - m_fm.width("0") / 2;
-      line[setIdx].valid = drawText("0", x, y);
+      line[setIdx].valid = drawText("0", x, y, nullptr, m_detailLayer);
 
       if (m_cache.getWritePolicy() == WritePolicy::WriteBack) {
         // Create dirty bit field
         x = m_widthBeforeDirty + m_bitWidth / 2 - m_fm.width("0") / 2;
-        line[setIdx].dirty = drawText("0", x, y);
+        line[setIdx].dirty = drawText("0", x, y, nullptr, m_detailLayer);
       }
 
       if (m_cache.getReplacementPolicy() == ReplPolicy::LRU &&
@@ -693,7 +807,7 @@ void CacheGraphic::initializeControlBits() {
         // Create LRU field
         const QString lruText = QString::number(m_cache.getWays() - 1);
         x = m_widthBeforeLRU + m_lruWidth / 2 - m_fm.width(lruText) / 2;
-        line[setIdx].lru = drawText(lruText, x, y);
+        line[setIdx].lru = drawText(lruText, x, y, nullptr, m_detailLayer);
       }
     }
   }
@@ -7,9 +7,11 @@
 #include <QGraphicsItem>
 #include <QObject>
 #include <memory>
+#include <set>
 
 namespace Ripes {
 class FancyPolyLine;
+class DetailLayer;
 
 class CacheGraphic : public QGraphicsObject {
 public:
@@ -21,15 +23,34 @@ public:
              QWidget * = nullptr) override {}
   bool indexingVisible() const { return m_indexingVisible; }
 
+  /**
+   * @brief setLevelOfDetail
+   * Informs the graphic of the scale at which it is viewed. Below
+   * s_detailedLOD, the contents of the cache would be unreadable, and only the
+   * cache grid and access highlighting is drawn. Updates to the contents of the
+   * cache are deferred until the graphic is again viewed in detail.
+   */
+  void setLevelOfDetail(qreal lod);
+
 public slots:
   /**
    * @brief dataChanged
    * The cache simulator indicates that some entries in the cache has changed.
    * CacheGraphic will, using @p transaction, lazily initialize and update all
-   * required values to reflect the new state of the cache.
+   * required values to reflect the new state of the cache. Updates are
+   * coalesced and applied at the next UI refresh.
    */
   void dataChanged(CacheSim::CacheTransaction transaction);
 
+  /**
+   * @brief transactionsBatched
+   * The cache simulator has delivered a batch of transactions performed while
+   * the processor is running. The most recent transaction is highlighted. The
+   * affected ways are updated once running has finished.
+   */
+  void transactionsBatched(
+      const std::vector<CacheSim::CacheTransaction> &transactions);
+
   /**
    * @brief wayInvalidated
    * The cache simulator has signalled that all graphics in the given cache way
@@ -76,15 +97,34 @@ private:
   void initializeControlBits();
   void updateHighlighting(bool active,
                           const CacheSim::CacheTransaction &transaction);
+  /// Highlights the way filled by the prefetch @p transaction.
+  void highlightPrefetch(const CacheSim::CacheTransaction &transaction);
+  /// Draws @p text as a child of @p parent, or of this graphic if no parent is
+  /// given.
   QGraphicsSimpleTextItem *drawText(const QString &text, const QPointF &pos,
-                                    const QFont *otherFont = nullptr);
+                                    const QFont *otherFont = nullptr,
+                                    QGraphicsItem *parent = nullptr);
   QGraphicsSimpleTextItem *drawText(const QString &text, qreal x, qreal y,
-                                    const QFont *otherFont = nullptr);
+                                    const QFont *otherFont = nullptr,
+                                    QGraphicsItem *parent = nullptr);
   QGraphicsSimpleTextItem *
   tryCreateGraphicsTextItem(QGraphicsSimpleTextItem **item, qreal x, qreal y);
   std::unique_ptr<QGraphicsSimpleTextItem> createGraphicsTextItemSP(qreal x,
                                                                     qreal y);
 
+  /**
+   * @brief scheduleRefresh
+   * Schedules a call to refresh() at the next UI refresh, if not already
+   * scheduled.
+   */
+  void scheduleRefresh();
+  /**
+   * @brief refresh
+   * Updates all ways and lines which have changed since the last refresh, as
+   * well as the highlighting of the most recent transaction.
+   */
+  void refresh();
+
   // Graphical update functions
   void updateLineReplFields(unsigned lineIdx);
   void updateWay(unsigned lineIdx, unsigned wayIdx);
@@ -102,6 +142,21 @@ private:
 
   bool m_indexingVisible = true;
 
+  // Pending updates, coalesced until the next refresh.
+  std::set<std::pair<unsigned, unsigned>> m_dirtyWays;
+  std::set<unsigned> m_dirtyLines;
+  CacheSim::CacheTransaction m_pendingTransaction;
+  bool m_transactionPending = false;
+  // Prefetch fills triggered by the most recent transaction.
+  std::vector<CacheSim::CacheTransaction> m_pendingPrefetches;
+  bool m_refreshScheduled = false;
+
+  // Parent of all per-way items of the cache, which are hidden when the
+  // graphic is not viewed in detail.
+  DetailLayer *m_detailLayer = nullptr;
+  bool m_detailed = true;
+  static constexpr qreal s_detailedLOD = 0.35;
+
   // Drawing dimensions
   qreal m_setHeight = 0;
   qreal m_lineHeight = 0;
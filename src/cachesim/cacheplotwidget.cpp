@@ -3,9 +3,11 @@
 
 #include <QCheckBox>
 #include <QClipboard>
+#include <QDialog>
 #include <QFileDialog>
 #include <QPushButton>
 #include <QToolBar>
+#include <QVBoxLayout>
 #include <QtCharts/QAreaSeries>
 #include <QtCharts/QChartView>
 #include <QtCharts/QLineSeries>
@@ -17,6 +19,7 @@
 #include "enumcombobox.h"
 #include "processorhandler.h"
 #include "ripessettings.h"
+#include "stackdistanceprofiler.h"
 
 #include "limits.h"
 
@@ -26,6 +29,12 @@ static QPointF stepPoint(const QPointF &p1, const QPointF &p2) {
   return QPointF(p2.x(), p1.y());
 }
 
+// Number of points, excluding step points, which a plotted series is
+// decimated to.
+static int plotPointTarget() {
+  return RipesSettings::cached<SettingId::CacheMaxPoints>();
+}
+
 CachePlotWidget::CachePlotWidget(QWidget *parent)
     : QWidget(parent), m_ui(new Ui::CachePlotWidget) {
   m_ui->setupUi(this);
@@ -69,13 +78,14 @@ CachePlotWidget::CachePlotWidget(QWidget *parent)
 
   connect(m_ui->maxCyclesButton, &QPushButton::clicked, this, [=] {
     QMessageBox::information(
-        this, "Maximum plot cycles reached",
-        "The maximum number of plot cycles was reached. Beyond this point, "
-        "cache statistics is no longer plotted "
-        "for performance reasons.\nIf you wish to increase the # of cycles "
-        "plotted, please change the setting:\n   "
-        " "
-        "\"Edit->Settings->Environment->Max. cache plot cycles\"");
+        this, "Maximum plot samples reached",
+        "The maximum number of cache statistics samples was reached. Cache "
+        "statistics are now plotted at a resolution of " +
+            QString::number(m_cache->getAccessHistoryResolution()) +
+            " cycles, for performance reasons.\nIf you wish to increase "
+            "the resolution, please change the setting:\n   "
+            " "
+            "\"Edit->Settings->Environment->Max. cache plot samples\"");
   });
 }
 
@@ -103,15 +113,10 @@ void CachePlotWidget::setCache(const std::shared_ptr<CacheSim> &cache) {
   });
   m_ui->size->setText(QString::number(m_cache->getCacheSize().bits));
 
-  const auto plotUpdateFunc = [=]() {
-    updateRatioPlot();
-    updateAllowedRange(RangeChangeSource::Cycles);
-    updatePlotAxes();
-  };
   connect(ProcessorHandler::get(), &ProcessorHandler::processorClockedNonRun,
-          this, plotUpdateFunc);
+          this, &CachePlotWidget::updatePlot);
   connect(ProcessorHandler::get(), &ProcessorHandler::runFinished, this,
-          plotUpdateFunc);
+          &CachePlotWidget::updatePlot);
   connect(m_cache.get(), &CacheSim::cacheInvalidated, this,
           [=] { resetRatioPlot(); });
 
@@ -231,6 +236,76 @@ void CachePlotWidget::setupPlotActions() {
   m_ui->savePlot->setDefaultAction(m_savePlotAction);
   connect(m_savePlotAction, &QAction::triggered, this,
           &CachePlotWidget::savePlot);
+
+  m_missRateCurvesAction = new QAction("Show miss-rate curves", this);
+  m_missRateCurvesAction->setIcon(QIcon(":/icons/analytics.svg"));
+  m_ui->missRateCurves->setDefaultAction(m_missRateCurvesAction);
+  connect(m_missRateCurvesAction, &QAction::triggered, this,
+          &CachePlotWidget::showMissRateCurves);
+}
+
+void CachePlotWidget::showMissRateCurves() {
+  const StackDistanceProfiler *profiler = m_cache->getStackDistanceProfiler();
+  if (!profiler) {
+    // Profiling is enabled on demand, given its overhead. The processor is
+    // reset, such that the profile covers the entire execution.
+    m_cache->setStackDistanceProfiling(true);
+    RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+    QMessageBox::information(
+        this, "Miss-rate curves",
+        "Stack distance profiling of this cache has been enabled, and the "
+        "processor has been reset.\nExecute the program, and press this "
+        "button again to show the miss rate of all LRU cache sizes and "
+        "associativities, with the block size of the current configuration.");
+    return;
+  }
+  if (profiler->accesses() == 0) {
+    QMessageBox::information(this, "Miss-rate curves",
+                             "No cache accesses have been profiled yet.");
+    return;
+  }
+
+  const auto missRate = [&](unsigned long long misses) {
+    return 100.0 * misses / profiler->accesses();
+  };
+  auto *chart = new QChart();
+  const unsigned maxBits =
+      std::max(profiler->maxCapacityBits() + 1,
+               StackDistanceProfiler::s_maxSetBits +
+                   StackDistanceProfiler::s_maxWayBits);
+  for (unsigned w = 0; w <= StackDistanceProfiler::s_maxWayBits; ++w) {
+    auto *series = new QLineSeries(chart);
+    series->setName(w == 0 ? "Direct mapped"
+                           : QString::number(1 << w) + "-way");
+    for (unsigned s = 0; s <= StackDistanceProfiler::s_maxSetBits; ++s)
+      series->append(s + w, missRate(profiler->misses(s, w)));
+    chart->addSeries(series);
+  }
+  auto *faSeries = new QLineSeries(chart);
+  faSeries->setName("Fully associative");
+  for (unsigned bits = 0; bits <= maxBits; ++bits)
+    faSeries->append(bits, missRate(profiler->fullyAssociativeMisses(bits)));
+  chart->addSeries(faSeries);
+
+  chart->createDefaultAxes();
+  auto *axisX = qobject_cast<QValueAxis *>(chart->axes(Qt::Horizontal).first());
+  auto *axisY = qobject_cast<QValueAxis *>(chart->axes(Qt::Vertical).first());
+  axisX->setTitleText("log2(cache size in blocks of " +
+                      QString::number(1 << profiler->blockBits()) +
+                      " bytes)");
+  axisX->setLabelFormat("%d");
+  axisY->setTitleText("Miss rate (%)");
+  axisY->setRange(0, 100);
+  chart->setTitle(QString::number(profiler->accesses()) + " accesses");
+
+  QDialog dialog(this);
+  dialog.setWindowTitle("Miss-rate curves");
+  auto *layout = new QVBoxLayout(&dialog);
+  auto *view = new QChartView(chart, &dialog);
+  view->setRenderHint(QPainter::Antialiasing);
+  view->setMinimumSize(640, 480);
+  layout->addWidget(view);
+  dialog.exec();
 }
 
 void CachePlotWidget::savePlot() {
@@ -299,58 +374,41 @@ void CachePlotWidget::variablesChanged() {
 std::map<CachePlotWidget::Variable, QList<QPoint>>
 CachePlotWidget::gatherData(unsigned fromCycle) const {
   std::map<Variable, QList<QPoint>> cacheData;
-  const auto &trace = m_cache->getAccessTrace();
+  const auto &history = m_cache->getAccessHistory();
 
   for (int i = 0; i < N_TraceVars; ++i) {
-    cacheData[static_cast<Variable>(i)].reserve(trace.size());
+    cacheData[static_cast<Variable>(i)].reserve(history.size());
   }
 
-  // Gather data up until the end of the trace or the maximum plotted cycles
-  const unsigned maxCycles =
-      RipesSettings::value(RIPES_SETTING_CACHE_MAXCYCLES).toInt();
-  if (fromCycle > maxCycles) {
-    return {};
-  }
-
-  for (auto it = trace.upper_bound(fromCycle);
-       it != trace.lower_bound(maxCycles); it++) {
-    const auto &entry = it->second;
-    Q_ASSERT(it->first <= maxCycles);
-    cacheData[Variable::Writes].append(QPoint(it->first, entry.writes));
-    cacheData[Variable::Reads].append(QPoint(it->first, entry.reads));
-    cacheData[Variable::Hits].append(QPoint(it->first, entry.hits));
-    cacheData[Variable::Misses].append(QPoint(it->first, entry.misses));
-    cacheData[Variable::Writebacks].append(QPoint(it->first, entry.writebacks));
-    cacheData[Variable::Accesses].append(
-        QPoint(it->first, entry.hits + entry.misses));
+  auto it = std::upper_bound(
+      history.begin(), history.end(), fromCycle,
+      [](unsigned cycle, const auto &sample) { return cycle < sample.cycle; });
+  for (; it != history.end(); it++) {
+    const auto &entry = it->stats;
+    cacheData[Variable::Writes].append(QPoint(it->cycle, entry.writes));
+    cacheData[Variable::Reads].append(QPoint(it->cycle, entry.reads));
+    cacheData[Variable::Hits].append(QPoint(it->cycle, entry.hits));
+    cacheData[Variable::Misses].append(QPoint(it->cycle, entry.misses));
+    cacheData[Variable::Writebacks].append(QPoint(it->cycle, entry.writebacks));
+    cacheData[Variable::Accesses].append(QPoint(it->cycle, entry.accesses()));
   }
 
   return cacheData;
 }
 
-void resample(QLineSeries *series, unsigned target, double &step) {
+void CachePlotWidget::plotPoints(QLineSeries *series,
+                                 const PlotDecimator &points, bool steps) {
+  const QVector<QPointF> decimated = points.decimate(plotPointTarget());
   QVector<QPointF> newPoints;
-  const auto &oldPoints = series->pointsVector();
-  step = (oldPoints.last().x() / static_cast<double>(target)) *
-         2; // *2 to account for steps
-  newPoints.reserve(target);
-  for (int i = 0; i < oldPoints.size(); i += step) {
-    newPoints << oldPoints.at(i);
-  }
-
-#if !defined(QT_NO_DEBUG)
-  // sanity check
-  QPointF plast = QPointF(0, 0);
-  bool first = true;
-  for (const auto &p : qAsConst(newPoints)) {
-    if (!first) {
-      Q_ASSERT(p.x() - plast.x() < step * 1.1);
-      first = false;
+  newPoints.reserve(decimated.size() * (steps ? 2 : 1));
+  QPointF lastPoint = QPointF(-1, 0);
+  for (const auto &p : decimated) {
+    if (steps) {
+      newPoints << stepPoint(lastPoint, p);
     }
-    plast = p;
+    newPoints << p;
+    lastPoint = p;
   }
-#endif
-
   series->replace(newPoints);
 }
 
@@ -386,7 +444,30 @@ void CachePlotWidget::updatePlotAxes() {
                   m_ui->rangeSlider->maximumPosition());
 }
 
+void CachePlotWidget::updatePlot() {
+  if (!isVisible()) {
+    m_plotStale = true;
+    return;
+  }
+  m_plotStale = false;
+  updateRatioPlot();
+  updateAllowedRange(RangeChangeSource::Cycles);
+  updatePlotAxes();
+}
+
+void CachePlotWidget::showEvent(QShowEvent *event) {
+  QWidget::showEvent(event);
+  if (m_plotStale)
+    updatePlot();
+}
+
 void CachePlotWidget::updateRatioPlot() {
+  if (m_cache->getAccessHistoryResolution() != m_plottedResolution) {
+    // The cache has merged its history samples; regather the plot at the new
+    // resolution.
+    resetRatioPlot();
+  }
+
   const auto newCacheData = gatherData(m_lastCyclePlotted);
   const int nNewPoints = newCacheData.at(Accesses).size();
   if (nNewPoints == 0) {
@@ -411,12 +492,8 @@ void CachePlotWidget::updateRatioPlot() {
 
   QList<QPointF> newPoints;
   QList<QPointF> newWindowPoints;
-  QPointF lastPoint;
-  if (m_series->pointsVector().size() > 0) {
-    lastPoint = m_series->pointsVector().constLast();
-  } else {
-    lastPoint = QPointF(-1, 0);
-  }
+  QPointF lastPoint =
+      m_ratioPoints.empty() ? QPointF(-1, 0) : m_ratioPoints.last();
   for (int i = 0; i < nNewPoints; ++i) {
     // Cummulative plot. For the unary variable, "Accesses" is just used to
     // index into the cache data for accessing the x variable.
@@ -432,21 +509,13 @@ void CachePlotWidget::updateRatioPlot() {
       ratio = static_cast<double>(p1.y()) / p2.y();
       ratio *= 100.0;
     }
-    bool skipPoint = false;
     const QPointF newPoint = QPointF(p1.x(), ratio);
-    if (lastPoint.x() >= 0) {
-      if (newPoint.x() - lastPoint.x() < m_xStep) {
-        // Skip point; irrelevant at the current sampling level
-        skipPoint = true;
-      }
-    }
-    if (!skipPoint) {
-      newPoints << stepPoint(lastPoint, newPoint);
-      newPoints << newPoint;
-      m_maxY = ratio > m_maxY ? ratio : m_maxY;
-      m_minY = ratio < m_minY ? ratio : m_minY;
-      lastPoint = newPoint;
-    }
+    m_ratioPoints.append(newPoint);
+    newPoints << stepPoint(lastPoint, newPoint);
+    newPoints << newPoint;
+    m_maxY = ratio > m_maxY ? ratio : m_maxY;
+    m_minY = ratio < m_minY ? ratio : m_minY;
+    lastPoint = newPoint;
 
     // Moving average plot
     if (m_ui->windowed->isChecked()) {
@@ -473,45 +542,44 @@ void CachePlotWidget::updateRatioPlot() {
       const double wAvg =
           std::accumulate(m_mavgData.begin(), m_mavgData.end(), 0.0) /
           m_mavgData.size();
-      newWindowPoints << QPointF(p1.x(), wAvg);
+      const QPointF windowPoint = QPointF(p1.x(), wAvg);
+      m_mavgPoints.append(windowPoint);
+      newWindowPoints << windowPoint;
       m_lastDiffData.first = p1;
       m_lastDiffData.second = p2;
     }
   }
 
-  if (newPoints.size() == 0 && newWindowPoints.size() == 0) {
-    return;
-  }
-
-  plotMover(m_series, false);
-  m_series->append(newPoints);
-  if (m_ui->windowed->isChecked()) {
-    plotMover(m_mavgSeries, false);
-    m_mavgSeries->append(newWindowPoints);
-  }
-
-  // Determine whether to resample;
-  // *2 the allowed points to account for the addition of step points.
-  // *2 to account for the fact that the setting specifies the minimum # of
-  // points, and we resample at a 2x ratio
-  const int maxPoints =
-      RipesSettings::value(RIPES_SETTING_CACHE_MAXPOINTS).toInt() * 2 * 2;
-  if (m_series->pointsVector().size() >= maxPoints) {
-    resample(m_series, maxPoints / 2, m_xStep);
-  }
+  // New points are appended to the plotted series until a series holds
+  // s_resamplingRatio times the allowed number of points, after which it is
+  // replaced by a decimation of all points gathered so far. This bounds both
+  // the size of the series and the amortized cost of each update.
+  const auto updateSeries = [&](QLineSeries *series,
+                                const PlotDecimator &points,
+                                const QList<QPointF> &seriesPoints,
+                                bool steps) {
+    const int maxPoints =
+        plotPointTarget() * s_resamplingRatio * (steps ? 2 : 1);
+    if (series->count() + seriesPoints.size() > maxPoints) {
+      plotPoints(series, points, steps);
+    } else {
+      plotMover(series, false);
+      series->append(seriesPoints);
+      plotMover(series, true);
+    }
+  };
 
-  plotMover(m_series, true);
+  updateSeries(m_series, m_ratioPoints, newPoints, true);
   if (m_ui->windowed->isChecked()) {
-    plotMover(m_mavgSeries, true);
+    updateSeries(m_mavgSeries, m_mavgPoints, newWindowPoints, false);
   }
 
   updatePlotWarningButton();
 }
 
 void CachePlotWidget::updatePlotWarningButton() {
-  m_ui->maxCyclesButton->setVisible(
-      m_lastCyclePlotted >=
-      RipesSettings::value(RIPES_SETTING_CACHE_MAXCYCLES).toInt());
+  m_ui->maxCyclesButton->setVisible(m_cache->getAccessHistoryResolution() >
+                                    1);
 }
 
 void CachePlotWidget::resetRatioPlot() {
@@ -519,8 +587,10 @@ void CachePlotWidget::resetRatioPlot() {
   m_minY = DBL_MAX;
   m_series->clear();
   m_mavgSeries->clear();
+  m_ratioPoints.clear();
+  m_mavgPoints.clear();
+  m_plottedResolution = m_cache->getAccessHistoryResolution();
   m_lastCyclePlotted = 0;
-  m_xStep = 1;
   m_lastDiffValid = false;
 
   if (m_ui->windowed->isChecked()) {
@@ -6,6 +6,7 @@
 
 #include "cachesim.h"
 #include "float.h"
+#include "plotdecimator.h"
 #include <queue>
 
 QT_FORWARD_DECLARE_CLASS(QToolBar);
@@ -60,6 +61,9 @@ public:
   void setCache(const std::shared_ptr<CacheSim> &cache);
   ~CachePlotWidget();
 
+protected:
+  void showEvent(QShowEvent *event) override;
+
 public slots:
 
 private slots:
@@ -78,17 +82,22 @@ private:
   void showSizeBreakdown();
   void copyPlotDataToClipboard() const;
   void savePlot();
+  void showMissRateCurves();
+  /// Updates the plot to the current cycle. The plot is not updated while the
+  /// widget is hidden, but once it is shown.
+  void updatePlot();
   void updateRatioPlot();
   void updatePlotAxes();
   void updateAllowedRange(const RangeChangeSource src);
   void updatePlotWarningButton();
 
   /**
-   * @brief resampleToScreen
-   * Resamples @param series to only contain as many points as would be visible
-   * on the associated plot view
+   * @brief plotPoints
+   * Replaces the points of @param series with a decimation of @param points to
+   * the number of points allowed by the cache plot settings.
    */
-  void resampleToScreen(QLineSeries *series);
+  void plotPoints(QLineSeries *series, const PlotDecimator &points,
+                  bool steps);
 
   void resetRatioPlot();
   QChart *m_plot = nullptr;
@@ -96,9 +105,19 @@ private:
   double m_maxY = -DBL_MAX;
   double m_minY = DBL_MAX;
   int64_t m_lastCyclePlotted = 0;
-  double m_xStep = 1.0;
+  // Whether cycles were executed while the widget was hidden.
+  bool m_plotStale = false;
   static constexpr int s_resamplingRatio = 2;
 
+  // All ratio and moving average points plotted since the last reset. The
+  // plotted series hold a decimation of these, onto which new points are
+  // appended until the series must be decimated again.
+  PlotDecimator m_ratioPoints;
+  PlotDecimator m_mavgPoints;
+  // Access history resolution when the points were gathered. The history is
+  // regathered when the cache coarsens its history.
+  unsigned m_plottedResolution = 1;
+
   QLineSeries *m_mavgSeries = nullptr;
   // N last computations of the change in ratio value
   FixedQueue<double> m_mavgData;
@@ -114,6 +133,7 @@ private:
 
   QAction *m_copyDataAction = nullptr;
   QAction *m_savePlotAction = nullptr;
+  QAction *m_missRateCurvesAction = nullptr;
   QAction *m_totalMarkerAction = nullptr;
   QAction *m_mavgMarkerAction = nullptr;
 
@@ -1,10 +1,14 @@
 #include "cachesim.h"
 #include "binutils.h"
 
+#include "prefetcher.h"
 #include "processorhandler.h"
+#include "ripessettings.h"
+#include "stackdistanceprofiler.h"
 
 #include <QApplication>
 #include <QThread>
+#include <algorithm>
 #include <random>
 #include <utility>
 
@@ -22,10 +26,38 @@ void CacheInterface::reverse() {
   }
 }
 
+void CacheInterface::warm(AInt address, MemoryAccess::Type type) {
+  if (m_nextLevelCache)
+    m_nextLevelCache->warm(address, type);
+}
+
+void CacheInterface::warmEviction(AInt address) {
+  if (m_nextLevelCache)
+    m_nextLevelCache->warmEviction(address);
+}
+
 CacheSim::CacheSim(QObject *parent) : CacheInterface(parent) {
   m_byteOffset = log2Ceil(ProcessorHandler::currentISA()->bytes());
   m_wordBits = ProcessorHandler::currentISA()->bits();
+  m_historyCapacity =
+      RipesSettings::value(RIPES_SETTING_CACHE_MAXCYCLES).toInt();
+  m_runDrainTimer.setInterval(
+      1000.0 / RipesSettings::value(RIPES_SETTING_UIUPDATEPS).toInt());
+  connect(RipesSettings::getObserver(RIPES_SETTING_UIUPDATEPS),
+          &SettingObserver::modified, this, [=] {
+            m_runDrainTimer.setInterval(
+                1000.0 /
+                RipesSettings::value(RIPES_SETTING_UIUPDATEPS).toInt());
+          });
+  connect(&m_runDrainTimer, &QTimer::timeout, this,
+          &CacheSim::drainRunTransactions);
+  connect(ProcessorHandler::get(), &ProcessorHandler::runStarted, this, [=] {
+    m_runTransactions.clear();
+    m_runDrainTimer.start();
+  });
   connect(ProcessorHandler::get(), &ProcessorHandler::runFinished, this, [=] {
+    m_runDrainTimer.stop();
+    m_runTransactions.clear();
     // Given that we are not updating the graphical state of the cache simulator
     // whilst the processor is running, once running is finished, the entirety
     // of the cache view should be reloaded in the graphical view.
@@ -36,41 +68,118 @@ CacheSim::CacheSim(QObject *parent) : CacheInterface(parent) {
   updateConfiguration();
 }
 
-void CacheSim::updateCacheLineReplFields(CacheLine &line, unsigned wayIdx) {
-  if (getReplacementPolicy() == ReplPolicy::LRU) {
+void CacheSim::updateCacheLineReplFields(unsigned lineIdx, unsigned wayIdx,
+                                         bool fill) {
+  switch (getReplacementPolicy()) {
+  case ReplPolicy::Random:
+    break;
+  case ReplPolicy::LRU: {
+    const unsigned base = wayIndex(lineIdx, 0);
     // Find previous LRU value for the updated index
-    const unsigned preLRU = line[wayIdx].lru;
+    const unsigned preLRU = m_lrus[base + wayIdx];
 
     // All indicies which are curently more recent than preLRU shall be
     // incremented
-    for (auto &set : line) {
-      if (set.second.valid && set.second.lru < preLRU) {
-        set.second.lru++;
+    for (int i = 0; i < getWays(); ++i) {
+      if (m_valid[base + i] && m_lrus[base + i] < preLRU) {
+        m_lrus[base + i]++;
       }
     }
 
     // Upgrade @p lruIdx to the most recently used
-    line[wayIdx].lru = 0;
+    m_lrus[base + wayIdx] = 0;
+    break;
+  }
+  case ReplPolicy::PLRU: {
+    // Point each node on the path from the root to the accessed way towards
+    // the opposite subtree.
+    unsigned node = 1;
+    for (int level = getWaysBits() - 1; level >= 0; --level) {
+      const unsigned dir = (wayIdx >> level) & 1;
+      setReplField(lineIdx, node - 1, 1, !dir);
+      node = 2 * node + dir;
+    }
+    break;
+  }
+  case ReplPolicy::FIFO: {
+    if (fill && getWays() > 1)
+      setReplField(lineIdx, 0, getWaysBits(), (wayIdx + 1) % getWays());
+    break;
+  }
+  case ReplPolicy::SRRIP: {
+    if (!fill) {
+      // Hits predict a near-immediate re-reference.
+      setReplField(lineIdx, wayIdx * s_rrpvBits, s_rrpvBits, 0);
+      break;
+    }
+    // The eviction way holds the largest RRPV of the line. Age all ways such
+    // that the eviction way would have been predicted as distant, as if
+    // searching for a way with the maximum RRPV. Invalid ways are always
+    // distant, so filling these does not age the line.
+    const unsigned age =
+        s_rrpvMax - replField(lineIdx, wayIdx * s_rrpvBits, s_rrpvBits);
+    if (age != 0) {
+      for (int i = 0; i < getWays(); ++i) {
+        const unsigned rrpv = replField(lineIdx, i * s_rrpvBits, s_rrpvBits);
+        setReplField(lineIdx, i * s_rrpvBits, s_rrpvBits,
+                     std::min(rrpv + age, s_rrpvMax));
+      }
+    }
+    // Newly loaded blocks are predicted as long re-reference intervals.
+    setReplField(lineIdx, wayIdx * s_rrpvBits, s_rrpvBits, s_rrpvMax - 1);
+    break;
+  }
   }
 }
 
-void CacheSim::revertCacheLineReplFields(CacheLine &line,
-                                         const CacheWay &oldWay,
-                                         unsigned wayIdx) {
+void CacheSim::revertCacheLineReplFields(const CacheTrace &trace) {
+  const unsigned lineIdx = trace.transaction.index.line;
+  if (trace.savedReplState)
+    restoreReplState(lineIdx);
+
   if (getReplacementPolicy() == ReplPolicy::LRU) {
+    const unsigned oldLru = trace.oldLru;
+    const unsigned wayIdx = trace.transaction.index.way;
+    const unsigned base = wayIndex(lineIdx, 0);
     // All indicies which are curently less than or equal to the old LRU shall
     // be decremented
-    for (auto &set : line) {
-      if (set.second.valid && set.second.lru <= oldWay.lru) {
-        set.second.lru--;
+    for (int i = 0; i < getWays(); ++i) {
+      if (m_valid[base + i] && m_lrus[base + i] <= oldLru) {
+        m_lrus[base + i]--;
       }
     }
 
     // Revert the oldWay LRU
-    line[wayIdx].lru = oldWay.lru;
+    m_lrus[base + wayIdx] = oldLru;
+  }
+}
+
+unsigned CacheSim::replStateBits() const {
+  switch (m_replPolicy) {
+  case ReplPolicy::PLRU:
+    return getWays() - 1;
+  case ReplPolicy::FIFO:
+    return getWaysBits();
+  case ReplPolicy::SRRIP:
+    return getWays() * s_rrpvBits;
+  default:
+    return 0;
   }
 }
 
+void CacheSim::saveReplState(unsigned lineIdx) {
+  const auto begin = m_replState.begin() + lineIdx * m_replWords;
+  for (unsigned i = m_replWords; i > 0; --i)
+    m_replStack.push_front(*(begin + i - 1));
+}
+
+void CacheSim::restoreReplState(unsigned lineIdx) {
+  Q_ASSERT(m_replStack.size() >= m_replWords);
+  std::copy(m_replStack.begin(), m_replStack.begin() + m_replWords,
+            m_replState.begin() + lineIdx * m_replWords);
+  m_replStack.erase(m_replStack.begin(), m_replStack.begin() + m_replWords);
+}
+
 CacheSim::CacheSize CacheSim::getCacheSize() const {
   CacheSize size;
 
@@ -93,6 +202,12 @@ CacheSim::CacheSize CacheSim::getCacheSize() const {
     componentBits = getWaysBits() * entries;
     size.components.push_back("LRU bits: " + QString::number(componentBits));
     size.bits += componentBits;
+  } else if (m_replPolicy != ReplPolicy::Random) {
+    // Per-line replacement state
+    componentBits = replStateBits() * getLines();
+    size.components.push_back(s_cacheReplPolicyStrings.at(m_replPolicy) +
+                              " bits: " + QString::number(componentBits));
+    size.bits += componentBits;
   }
 
   // Tag bits
@@ -105,122 +220,235 @@ CacheSim::CacheSize CacheSim::getCacheSize() const {
   size.components.push_back("Data bits: " + QString::number(componentBits));
   size.bits += componentBits;
 
+  if (m_victimEntries != 0) {
+    // Valid and dirty bits, a tag of the full line address, and data of each
+    // line of the victim cache.
+    componentBits = m_victimEntries *
+                    (2 + m_wordBits - m_byteOffset - getBlockBits() +
+                     m_wordBits * getBlocks());
+    size.components.push_back("Victim cache bits: " +
+                              QString::number(componentBits));
+    size.bits += componentBits;
+  }
+
   return size;
 }
 
-std::pair<unsigned, CacheSim::CacheWay *>
-CacheSim::locateEvictionWay(const CacheTransaction &transaction) {
-  auto &cacheLine = m_cacheLines[transaction.index.line];
-
-  std::pair<unsigned, CacheSim::CacheWay *> ew;
-  ew.first = s_invalidIndex;
-  ew.second = nullptr;
+unsigned
+CacheSim::locateEvictionWay(const CacheTransaction &transaction) const {
+  const unsigned base = wayIndex(transaction.index.line, 0);
+  unsigned wayIdx = s_invalidIndex;
 
   // Locate a new way based on replacement policy.
   if (m_replPolicy == ReplPolicy::Random) {
     // Select a random way
-    ew.first = std::rand() % getWays();
-    ew.second = &cacheLine[ew.first];
-  } else if (m_replPolicy == ReplPolicy::LRU) {
+    wayIdx = std::rand() % getWays();
+  } else {
     if (getWays() == 1) {
-      // Nothing to do if we are in LRU and only have 1 set.
-      ew.first = 0;
-      ew.second = &cacheLine[ew.first];
+      // Nothing to do if we only have 1 set.
+      wayIdx = 0;
     } else {
-      // Lazily initialize all ways in the cacheline before starting to iterate.
-      for (int i = 0; i < getWays(); ++i)
-        cacheLine[i];
-
       // If there is an invalid cache line, select that.
-      auto it =
-          std::find_if(cacheLine.begin(), cacheLine.end(),
-                       [=](const auto &way) { return !way.second.valid; });
-      if (it != cacheLine.end()) {
-        ew.first = it->first;
-        ew.second = &it->second;
-      }
-      if (ew.second == nullptr) {
-        // Else, Find LRU way.
-        for (auto &way : cacheLine) {
-          if (static_cast<long>(way.second.lru) == getWays() - 1) {
-            ew.first = way.first;
-            ew.second = &way.second;
-            break;
-          }
+      for (int i = 0; i < getWays(); ++i) {
+        if (!m_valid[base + i]) {
+          wayIdx = i;
+          break;
         }
       }
+      if (wayIdx == s_invalidIndex)
+        wayIdx = locateReplacementWay(transaction.index.line);
     }
   }
 
-  Q_ASSERT(ew.first != s_invalidIndex && "Unable to locate way for eviction");
-  Q_ASSERT(ew.second != nullptr && "Unable to locate way for eviction");
-  return ew;
+  Q_ASSERT(wayIdx != s_invalidIndex && "Unable to locate way for eviction");
+  return wayIdx;
 }
 
-CacheSim::CacheWay CacheSim::evictAndUpdate(CacheTransaction &transaction) {
-  const auto [wayIdx, wayPtr] = locateEvictionWay(transaction);
+unsigned CacheSim::locateReplacementWay(unsigned lineIdx) const {
+  switch (m_replPolicy) {
+  case ReplPolicy::LRU: {
+    const unsigned base = wayIndex(lineIdx, 0);
+    for (int i = 0; i < getWays(); ++i) {
+      if (static_cast<long>(m_lrus[base + i]) == getWays() - 1)
+        return i;
+    }
+    break;
+  }
+  case ReplPolicy::PLRU: {
+    // Follow the tree towards the pseudo least recently used way.
+    unsigned node = 1;
+    unsigned wayIdx = 0;
+    for (int level = 0; level < getWaysBits(); ++level) {
+      const unsigned dir = replField(lineIdx, node - 1, 1);
+      wayIdx = (wayIdx << 1) | dir;
+      node = 2 * node + dir;
+    }
+    return wayIdx;
+  }
+  case ReplPolicy::FIFO:
+    return replField(lineIdx, 0, getWaysBits());
+  case ReplPolicy::SRRIP: {
+    // Select the first way with the largest RRPV.
+    unsigned wayIdx = 0;
+    unsigned maxRrpv = 0;
+    for (int i = 0; i < getWays(); ++i) {
+      const unsigned rrpv = replField(lineIdx, i * s_rrpvBits, s_rrpvBits);
+      if (rrpv > maxRrpv) {
+        maxRrpv = rrpv;
+        wayIdx = i;
+        if (rrpv == s_rrpvMax)
+          break;
+      }
+    }
+    return wayIdx;
+  }
+  case ReplPolicy::Random:
+    break;
+  }
+  return s_invalidIndex;
+}
 
-  CacheWay eviction;
+void CacheSim::evictAndUpdate(CacheTransaction &transaction,
+                              WayState *eviction) {
+  const unsigned wayIdx = locateEvictionWay(transaction);
+  const unsigned idx = wayIndex(transaction.index.line, wayIdx);
 
-  if (!wayPtr->valid) {
+  if (!m_valid[idx]) {
     // Record that this was an invalid->valid transition
     transaction.transToValid = true;
   } else {
     // Store the old way info in our eviction trace, in case of rollbacks
-    eviction = *wayPtr;
+    if (eviction)
+      *eviction = saveWay(idx);
 
-    if (eviction.dirty) {
+    if (m_dirty[idx]) {
       // The eviction will result in a writeback
       transaction.isWriteback = true;
+      transaction.writebackAddress =
+          buildAddress(m_tags[idx], transaction.index.line, 0);
+    } else {
+      transaction.isEviction = true;
+      transaction.evictionAddress =
+          buildAddress(m_tags[idx], transaction.index.line, 0);
     }
   }
 
   // Invalidate the target way
-  *wayPtr = CacheWay();
+  invalidateWay(idx);
 
   // Set required values in way, reflecting the newly loaded address
-  wayPtr->valid = true;
-  wayPtr->dirty = false;
-  wayPtr->tag = getTag(transaction.address);
+  m_valid[idx] = true;
+  m_dirty[idx] = false;
+  m_tags[idx] = getTag(transaction.address);
   transaction.tagChanged = true;
   transaction.index.way = wayIdx;
+}
+
+void CacheSim::resizeStorage() {
+  const size_t ways = static_cast<size_t>(getLines()) * getWays();
+  m_dirtyBlockWords = (getBlocks() + 63) / 64;
+  m_tags.assign(ways, -1);
+  // LRU algorithm relies on invalid cache ways to have an initial high value.
+  m_lrus.assign(ways, -1);
+  m_valid.assign(ways, false);
+  m_dirty.assign(ways, false);
+  m_dirtyBlocks.assign(ways * m_dirtyBlockWords, 0);
+  m_prefetched.assign(ways, false);
+  m_prefetchReady.assign(ways, 0);
+  m_replWords = (replStateBits() + 63) / 64;
+  // Invalid ways are predicted as distant re-references by SRRIP.
+  m_replState.assign(static_cast<size_t>(getLines()) * m_replWords,
+                     m_replPolicy == ReplPolicy::SRRIP ? ~uint64_t(0) : 0);
+  m_replStack.clear();
+  m_victims.clear();
+  m_victimStack.clear();
+}
+
+void CacheSim::removeWay(unsigned lineIdx, unsigned idx) {
+  if (m_replPolicy == ReplPolicy::LRU) {
+    // Ways less recently used than the removed way move up in the LRU order.
+    const unsigned base = wayIndex(lineIdx, 0);
+    for (int i = 0; i < getWays(); ++i) {
+      if (m_valid[base + i] && m_lrus[base + i] > m_lrus[idx])
+        m_lrus[base + i]--;
+    }
+  } else if (m_replPolicy == ReplPolicy::SRRIP) {
+    // Invalid ways are predicted as distant re-references.
+    const unsigned wayIdx = idx - wayIndex(lineIdx, 0);
+    setReplField(lineIdx, wayIdx * s_rrpvBits, s_rrpvBits, s_rrpvMax);
+  }
+  invalidateWay(idx);
+}
 
-  return eviction;
+void CacheSim::invalidateWay(unsigned idx) {
+  m_tags[idx] = -1;
+  m_lrus[idx] = -1;
+  m_valid[idx] = false;
+  m_dirty[idx] = false;
+  m_prefetched[idx] = false;
+  uint64_t *dirtyBlocks = dirtyBlocksOf(idx);
+  std::fill(dirtyBlocks, dirtyBlocks + m_dirtyBlockWords, 0);
 }
 
-unsigned CacheSim::getHits() const {
-  if (m_accessTrace.size() == 0) {
+CacheSim::WayState CacheSim::saveWay(unsigned idx) const {
+  const uint64_t *dirtyBlocks = dirtyBlocksOf(idx);
+  return WayState{m_tags[idx],
+                  m_lrus[idx],
+                  m_valid[idx] != 0,
+                  m_dirty[idx] != 0,
+                  std::vector<uint64_t>(dirtyBlocks,
+                                        dirtyBlocks + m_dirtyBlockWords),
+                  m_prefetched[idx] != 0,
+                  m_prefetchReady[idx]};
+}
+
+void CacheSim::restoreWay(unsigned idx, const WayState &state) {
+  m_tags[idx] = state.tag;
+  m_lrus[idx] = state.lru;
+  m_valid[idx] = state.valid;
+  m_dirty[idx] = state.dirty;
+  std::copy(state.dirtyBlocks.begin(), state.dirtyBlocks.end(),
+            dirtyBlocksOf(idx));
+  m_prefetched[idx] = state.prefetched;
+  m_prefetchReady[idx] = state.prefetchReady;
+}
+
+unsigned CacheSim::getHits() const { return m_accessStats.hits; }
+
+unsigned CacheSim::getMisses() const { return m_accessStats.misses; }
+
+unsigned CacheSim::getWritebacks() const { return m_accessStats.writebacks; }
+
+double CacheSim::getPrefetchAccuracy() const {
+  if (m_accessStats.prefetches == 0) {
     return 0;
-  } else {
-    auto &trace = m_accessTrace.rbegin()->second;
-    return trace.hits;
   }
+  return static_cast<double>(m_accessStats.prefetchHits) /
+         m_accessStats.prefetches;
 }
 
-unsigned CacheSim::getMisses() const {
-  if (m_accessTrace.size() == 0) {
+double CacheSim::getPrefetchCoverage() const {
+  const int wouldBeMisses = m_accessStats.prefetchHits + m_accessStats.misses;
+  if (wouldBeMisses == 0) {
     return 0;
-  } else {
-    auto &trace = m_accessTrace.rbegin()->second;
-    return trace.misses;
   }
+  return static_cast<double>(m_accessStats.prefetchHits) / wouldBeMisses;
 }
 
-unsigned CacheSim::getWritebacks() const {
-  if (m_accessTrace.size() == 0) {
+double CacheSim::getPrefetchTimeliness() const {
+  if (m_accessStats.prefetchHits == 0) {
     return 0;
-  } else {
-    auto &trace = m_accessTrace.rbegin()->second;
-    return trace.writebacks;
   }
+  return static_cast<double>(m_accessStats.prefetchHits -
+                             m_accessStats.latePrefetches) /
+         m_accessStats.prefetchHits;
 }
 
 double CacheSim::getHitRate() const {
-  if (m_accessTrace.size() == 0) {
+  if (m_accessStats.accesses() == 0) {
     return 0;
   } else {
-    auto &trace = m_accessTrace.rbegin()->second;
-    return static_cast<double>(trace.hits) / (trace.hits + trace.misses);
+    return static_cast<double>(m_accessStats.hits) / m_accessStats.accesses();
   }
 }
 
@@ -229,88 +457,248 @@ void CacheSim::analyzeCacheAccess(CacheTransaction &transaction) const {
   transaction.index.block = getBlockIdx(transaction.address);
 
   transaction.isHit = false;
-  if (m_cacheLines.count(transaction.index.line) != 0) {
-    for (const auto &way : m_cacheLines.at(transaction.index.line)) {
-      if ((way.second.tag == getTag(transaction.address)) && way.second.valid) {
-        transaction.index.way = way.first;
-        transaction.isHit = true;
-        break;
-      }
+  const VInt tag = getTag(transaction.address);
+  const unsigned base = wayIndex(transaction.index.line, 0);
+  for (int i = 0; i < getWays(); ++i) {
+    if (m_tags[base + i] == tag && m_valid[base + i]) {
+      transaction.index.way = i;
+      transaction.isHit = true;
+      break;
     }
   }
 }
 
-void CacheSim::pushAccessTrace(const CacheTransaction &transaction) {
-  // Access traces are pushed in sorted order into the access trace map; indexed
-  // by a key corresponding to the cycle of the acces.
-  const unsigned currentCycle =
-      ProcessorHandler::getProcessor()->getCycleCount();
-
-  const CacheAccessTrace &mostRecentTrace =
-      m_accessTrace.size() == 0 ? CacheAccessTrace()
-                                : m_accessTrace.rbegin()->second;
-
-  m_accessTrace[currentCycle] = CacheAccessTrace(mostRecentTrace, transaction);
+void CacheSim::pushAccessTrace(const CacheTransaction &transaction,
+                               const AccessContext &context) {
+  if (context.warm)
+    return;
+  m_accessStats.add(transaction, 1);
+  recordAccessHistory(context.cycle);
 
-  if (!ProcessorHandler::isRunning()) {
+  if (context.notify) {
     emit hitrateChanged();
   }
 }
 
-void CacheSim::popAccessTrace() {
-  Q_ASSERT(m_accessTrace.size() > 0);
-  // The access trace should have an entry
-  m_accessTrace.erase(m_accessTrace.rbegin()->first);
+void CacheSim::popAccessTrace(const CacheTrace &trace) {
+  m_accessStats.add(trace.transaction, -1);
+
+  // Discard the history recorded at or after the undone cycle, and record the
+  // statistics as of the end of the preceding cycle.
+  while (!m_accessHistory.empty() &&
+         m_accessHistory.back().cycle >= trace.cycle) {
+    m_accessHistory.pop_back();
+  }
+  const int recordedAccesses = m_accessHistory.empty()
+                                   ? 0
+                                   : m_accessHistory.back().stats.accesses();
+  if (trace.cycle > 0 && recordedAccesses != m_accessStats.accesses())
+    recordAccessHistory(trace.cycle - 1);
+
   emit hitrateChanged();
 }
 
-void CacheSim::access(AInt address, MemoryAccess::Type type) {
+void CacheSim::recordAccessHistory(unsigned cycle) {
+  const auto bucket = [&](unsigned c) { return c >> m_historyShift; };
+  if (!m_accessHistory.empty() &&
+      bucket(m_accessHistory.back().cycle) == bucket(cycle)) {
+    m_accessHistory.back() = {cycle, m_accessStats};
+    return;
+  }
+
+  m_accessHistory.push_back({cycle, m_accessStats});
+  // A history of less than two samples cannot be merged.
+  while (m_accessHistory.size() > std::max<size_t>(m_historyCapacity, 2)) {
+    // Double the bucket size, keeping the most recent sample of each bucket.
+    m_historyShift++;
+    size_t n = 0;
+    for (const auto &sample : m_accessHistory) {
+      if (n > 0 && bucket(m_accessHistory[n - 1].cycle) == bucket(sample.cycle))
+        m_accessHistory[n - 1] = sample;
+      else
+        m_accessHistory[n++] = sample;
+    }
+    m_accessHistory.resize(n);
+  }
+}
+
+CacheSim::AccessContext CacheSim::processorContext() {
+  AccessContext context;
+  context.cycle = ProcessorHandler::getProcessor()->getCycleCount();
+  // Undo traces are only recorded if the processor may be reversed.
+  context.recordUndo = ProcessorHandler::isReversible();
+  context.notify = !ProcessorHandler::isRunning();
+  context.batch = !context.notify;
+  context.forward = true;
+  return context;
+}
+
+CacheSim::AccessContext CacheSim::warmContext() {
+  AccessContext context;
+  // Warmed prefetch fills complete before detailed simulation starts.
+  context.cycle = 0;
+  context.recordUndo = false;
+  context.notify = false;
+  context.batch = false;
+  context.forward = true;
+  context.warm = true;
+  return context;
+}
+
+unsigned CacheSim::forwardAccess(AInt address, MemoryAccess::Type type,
+                                 const AccessContext &context) {
+  if (!context.warm)
+    return m_nextLevelCache->access(address, type);
+  m_nextLevelCache->warm(address, type);
+  return 0;
+}
+
+void CacheSim::forwardEviction(AInt address, const AccessContext &context) {
+  if (context.warm)
+    m_nextLevelCache->warmEviction(address);
+  else
+    m_nextLevelCache->evict(address);
+}
+
+unsigned CacheSim::access(AInt address, MemoryAccess::Type type) {
+  const unsigned latency = performAccess(address, type, processorContext());
+  m_latencyCycles += latency;
+  return latency;
+}
+
+void CacheSim::evict(AInt address) {
+  if (m_inclusionPolicy != InclusionPolicy::Exclusive)
+    return;
+  AccessContext context = processorContext();
+  context.insertion = true;
+  performAccess(address, MemoryAccess::Read, context);
+}
+
+void CacheSim::warm(AInt address, MemoryAccess::Type type) {
+  performAccess(address, type, warmContext());
+}
+
+void CacheSim::warmEviction(AInt address) {
+  if (m_inclusionPolicy != InclusionPolicy::Exclusive)
+    return;
+  AccessContext context = warmContext();
+  context.insertion = true;
+  performAccess(address, MemoryAccess::Read, context);
+}
+
+void CacheSim::replayAccess(AInt address, MemoryAccess::Type type,
+                            unsigned cycle, CacheTransaction *transaction) {
+  performAccess(address, type,
+                AccessContext{cycle, false, false, false, false, transaction});
+}
+
+bool CacheSim::contains(AInt address) const {
+  CacheTransaction transaction;
+  transaction.address = address & ~0b11;
+  analyzeCacheAccess(transaction);
+  return transaction.isHit;
+}
+
+bool CacheSim::invalidate(AInt address) {
+  CacheTransaction transaction;
+  transaction.address = address & ~0b11;
+  analyzeCacheAccess(transaction);
+  if (!transaction.isHit)
+    return false;
+  const unsigned idx = wayIndex(transaction.index.line, transaction.index.way);
+  const bool dirty = m_dirty[idx];
+  removeWay(transaction.index.line, idx);
+  return dirty;
+}
+
+unsigned CacheSim::performAccess(AInt address, MemoryAccess::Type type,
+                                 const AccessContext &context) {
   address = address & ~0b11; // Disregard unaligned accesses
+  const bool recordUndo = context.recordUndo;
+  const bool exclusive = m_inclusionPolicy == InclusionPolicy::Exclusive;
   CacheTrace trace;
-  CacheWay oldWay;
   CacheTransaction transaction;
   transaction.address = address;
   transaction.type = type;
+  // Exclusive caches are only written by the writebacks of the previous level
+  // caches, which are inserted as the lines they evict.
+  transaction.isInsertion =
+      context.insertion || (exclusive && type == MemoryAccess::Write);
+  if (m_profiler && !transaction.isInsertion && !context.warm)
+    m_profiler->access(address);
 
   analyzeCacheAccess(transaction);
 
+  // Exclusive caches do not allocate the lines read by the previous level
+  // caches.
+  const bool allocate =
+      transaction.isInsertion ||
+      (type == MemoryAccess::Read
+           ? !exclusive
+           : getWriteAllocPolicy() == WriteAllocPolicy::WriteAllocate);
   if (!transaction.isHit) {
-    if (type == MemoryAccess::Read ||
-        (type == MemoryAccess::Write &&
-         getWriteAllocPolicy() == WriteAllocPolicy::WriteAllocate)) {
-      oldWay = evictAndUpdate(transaction);
+    if (allocate) {
+      WayState eviction;
+      const bool saveEviction = recordUndo || m_victimEntries != 0;
+      evictAndUpdate(transaction, saveEviction ? &eviction : nullptr);
+      if (m_victimEntries != 0)
+        swapInVictim(transaction, trace, context);
+      if (!transaction.transToValid) {
+        retireEvictedLine(transaction, saveEviction ? &eviction : nullptr,
+                          trace, context);
+        if (recordUndo) {
+          // Only evictions of valid ways need to record the full way state.
+          trace.oldLru = eviction.lru;
+          trace.evicted = true;
+          m_evictionStack.push_front(std::move(eviction));
+        }
+      }
     }
   } else {
-    oldWay = m_cacheLines[transaction.index.line][transaction.index.way];
+    const unsigned idx =
+        wayIndex(transaction.index.line, transaction.index.way);
+    trace.oldLru = m_lrus[idx];
+    trace.oldDirty = m_dirty[idx];
+    if (m_prefetched[idx]) {
+      // First demand access to a prefetched block.
+      transaction.prefetchHit = true;
+      transaction.latePrefetch = context.cycle < m_prefetchReady[idx];
+      m_prefetched[idx] = false;
+    }
   }
 
   // === Update dirty and LRU bits ===
 
-  // Initially, we need a check for the case of "write + miss + noWriteAlloc".
-  // In this case, we should not update replacement/dirty fields. In all other
-  // cases, this is a valid action.
-  const bool writeMissNoAlloc =
-      !transaction.isHit && type == MemoryAccess::Write &&
-      getWriteAllocPolicy() == WriteAllocPolicy::NoWriteAllocate;
-
-  if (!writeMissNoAlloc) {
-    // Lazily ensure that the located way has been initialized
-    m_cacheLines[transaction.index.line][transaction.index.way];
+  // Initially, we need a check for the case of a miss which is not allocated,
+  // ie. "write + miss + noWriteAlloc". In this case, we should not update
+  // replacement/dirty fields. In all other cases, this is a valid action.
+  const bool bypass = !transaction.isHit && !allocate;
 
+  if (!bypass) {
     if (type == MemoryAccess::Write &&
         getWritePolicy() == WritePolicy::WriteBack) {
-      CacheWay &way =
-          m_cacheLines[transaction.index.line][transaction.index.way];
-      way.dirty = true;
-      way.dirtyBlocks.insert(transaction.index.block);
+      const unsigned idx =
+          wayIndex(transaction.index.line, transaction.index.way);
+      m_dirty[idx] = true;
+      uint64_t &word = dirtyBlocksOf(idx)[transaction.index.block / 64];
+      const uint64_t bit = uint64_t(1) << (transaction.index.block % 64);
+      if (!(word & bit)) {
+        word |= bit;
+        trace.dirtiedBlock = transaction.index.block;
+      }
     }
 
-    updateCacheLineReplFields(m_cacheLines[transaction.index.line],
-                              transaction.index.way);
-  } else {
+    if (recordUndo && m_replWords != 0) {
+      saveReplState(transaction.index.line);
+      trace.savedReplState = true;
+    }
+    updateCacheLineReplFields(transaction.index.line, transaction.index.way,
+                              !transaction.isHit);
+  } else if (type == MemoryAccess::Write) {
     // In case of a write miss with no write allocate, the value is always
     // written through to memory (a writeback)
     transaction.isWriteback = true;
+    transaction.writebackAddress = address;
   }
 
   // If our WritePolicy is WriteThrough and this access is a write, the
@@ -318,39 +706,295 @@ void CacheSim::access(AInt address, MemoryAccess::Type type) {
   if (type == MemoryAccess::Write &&
       getWritePolicy() == WritePolicy::WriteThrough) {
     transaction.isWriteback = true;
+    transaction.writebackAddress = address;
   }
 
   // ===========================
 
   // At this point, no further changes shall be made to the transaction.
   // We record the transaction as well as a possible eviction
-  trace.oldWay = oldWay;
   trace.transaction = transaction;
-  pushTrace(trace);
-  pushAccessTrace(transaction);
+  trace.cycle = context.cycle;
+  if (recordUndo)
+    pushTrace(trace);
+  pushAccessTrace(transaction, context);
 
   // === Some sanity checking ===
-  // It should never be possible that a read returns an invalid way index
-  if (type == MemoryAccess::Read) {
+  // It should never be possible that an allocating access returns an invalid
+  // way index
+  if (!bypass) {
     transaction.index.assertValid();
   }
 
-  // It should never be possible that a write returns an invalid way index if we
-  // write-allocate
-  if (type == MemoryAccess::Write &&
-      getWriteAllocPolicy() == WriteAllocPolicy::WriteAllocate) {
-    transaction.index.assertValid();
+  // ===========================
+  // Exclusive caches hand out the lines read by the previous level caches.
+  const bool handOut = exclusive && transaction.isHit &&
+                       type == MemoryAccess::Read && !transaction.isInsertion;
+  const bool handOutDirty =
+      handOut && invalidateTraced(transaction.index.line,
+                                  transaction.index.way, context, true);
+
+  // Propagate the traffic caused by this access to the next level cache; a
+  // writeback of the evicted (or written through) data, followed by a fill of
+  // the accessed block. Writebacks are assumed to be buffered, and as such only
+  // fills contribute to the latency of the access.
+  unsigned latency = m_latency;
+  const bool fill = !transaction.isHit && !transaction.victimHit &&
+                    !transaction.isInsertion &&
+                    (allocate || type == MemoryAccess::Read);
+  if (transaction.victimHit)
+    latency += s_victimLatency;
+  if (m_nextLevelCache && context.forward) {
+    if (transaction.isWriteback)
+      forwardAccess(transaction.writebackAddress, MemoryAccess::Write, context);
+    if (transaction.isEviction)
+      forwardEviction(transaction.evictionAddress, context);
+    if (handOutDirty)
+      forwardAccess(address, MemoryAccess::Write, context);
+    if (fill)
+      latency += forwardAccess(address, MemoryAccess::Read, context);
+  } else if (fill) {
+    latency += m_missLatency;
   }
 
-  // ===========================
-  if (writeMissNoAlloc) {
-    // There are no graphical changes to perform since nothing is pulled into
-    // the cache upon a missed write without write allocation
-    return;
+  // There are no graphical changes to perform for a miss which is not
+  // allocated, since nothing is pulled into the cache.
+  if (!bypass) {
+    notifyTransaction(transaction, context);
   }
+  if (m_prefetcher && !transaction.isInsertion) {
+    issuePrefetches(address, transaction.isHit, context);
+  }
+  if (context.result)
+    *context.result = transaction;
+  return latency;
+}
 
-  if (!ProcessorHandler::isRunning()) {
+void CacheSim::notifyTransaction(const CacheTransaction &transaction,
+                                 const AccessContext &context) {
+  if (context.notify) {
     emit dataChanged(transaction);
+  } else if (context.batch) {
+    m_runTransactions.push(transaction);
+  }
+}
+
+void CacheSim::issuePrefetches(AInt address, bool hit,
+                               const AccessContext &context) {
+  m_prefetchRequests.clear();
+  m_prefetcher->observe(address, hit, m_prefetchRequests);
+  for (const AInt prefetchAddress : m_prefetchRequests) {
+    performPrefetch(prefetchAddress, context);
+  }
+}
+
+void CacheSim::performPrefetch(AInt address, const AccessContext &context) {
+  CacheTransaction transaction;
+  transaction.address = address;
+  transaction.type = MemoryAccess::Read;
+  transaction.isPrefetch = true;
+  analyzeCacheAccess(transaction);
+  const AInt lineAddress =
+      buildAddress(getTag(address), transaction.index.line, 0);
+  if (transaction.isHit ||
+      std::any_of(m_victims.begin(), m_victims.end(),
+                  [&](const VictimLine &line) {
+                    return line.address == lineAddress;
+                  })) {
+    // The block is already present in the cache
+    return;
+  }
+
+  // A prefetch fill is traced as an access of its own, such that it is undone
+  // alongside the demand access which triggered it.
+  CacheTrace trace;
+  WayState eviction;
+  const bool saveEviction = context.recordUndo || m_victimEntries != 0;
+  evictAndUpdate(transaction, saveEviction ? &eviction : nullptr);
+  if (!transaction.transToValid) {
+    retireEvictedLine(transaction, saveEviction ? &eviction : nullptr, trace,
+                      context);
+    if (context.recordUndo) {
+      trace.oldLru = eviction.lru;
+      trace.evicted = true;
+      m_evictionStack.push_front(std::move(eviction));
+    }
+  }
+  if (context.recordUndo && m_replWords != 0) {
+    saveReplState(transaction.index.line);
+    trace.savedReplState = true;
+  }
+  updateCacheLineReplFields(transaction.index.line, transaction.index.way,
+                            true);
+
+  unsigned latency = m_latency;
+  if (m_nextLevelCache && context.forward) {
+    if (transaction.isWriteback)
+      forwardAccess(transaction.writebackAddress, MemoryAccess::Write, context);
+    if (transaction.isEviction)
+      forwardEviction(transaction.evictionAddress, context);
+    latency += forwardAccess(address, MemoryAccess::Read, context);
+  } else {
+    latency += m_missLatency;
+  }
+  const unsigned idx = wayIndex(transaction.index.line, transaction.index.way);
+  m_prefetched[idx] = true;
+  m_prefetchReady[idx] = context.cycle + latency;
+
+  trace.transaction = transaction;
+  trace.cycle = context.cycle;
+  if (context.recordUndo)
+    pushTrace(trace);
+  pushAccessTrace(transaction, context);
+  notifyTransaction(transaction, context);
+}
+
+void CacheSim::swapInVictim(CacheTransaction &transaction, CacheTrace &trace,
+                            const AccessContext &context) {
+  const AInt lineAddress =
+      buildAddress(getTag(transaction.address), transaction.index.line, 0);
+  const auto it = std::find_if(
+      m_victims.begin(), m_victims.end(),
+      [&](const VictimLine &line) { return line.address == lineAddress; });
+  if (it == m_victims.end())
+    return;
+
+  saveVictimState(trace, context);
+  transaction.victimHit = true;
+  const unsigned idx = wayIndex(transaction.index.line, transaction.index.way);
+  m_dirty[idx] = it->dirty;
+  std::copy(it->dirtyBlocks.begin(), it->dirtyBlocks.end(),
+            dirtyBlocksOf(idx));
+  m_victims.erase(it);
+}
+
+void CacheSim::retireEvictedLine(CacheTransaction &transaction,
+                                 const WayState *evicted, CacheTrace &trace,
+                                 const AccessContext &context) {
+  if (m_victimEntries != 0) {
+    Q_ASSERT(evicted && "Victim caches require the evicted way state");
+    saveVictimState(trace, context);
+    m_victims.insert(m_victims.begin(),
+                     VictimLine{buildAddress(evicted->tag,
+                                             transaction.index.line, 0),
+                                evicted->dirty, evicted->dirtyBlocks});
+    // The evicted line only leaves the cache once evicted from the victim
+    // cache.
+    transaction.isWriteback = false;
+    transaction.isEviction = false;
+    if (m_victims.size() <= m_victimEntries)
+      return;
+    const VictimLine &line = m_victims.back();
+    if (line.dirty) {
+      transaction.isWriteback = true;
+      transaction.writebackAddress = line.address;
+    } else {
+      transaction.isEviction = true;
+      transaction.evictionAddress = line.address;
+    }
+    m_victims.pop_back();
+  }
+
+  if (m_inclusionPolicy != InclusionPolicy::Inclusive)
+    return;
+  const AInt lineBytes = AInt(1) << (m_byteOffset + getBlockBits());
+  if (transaction.isWriteback) {
+    invalidatePrevious(transaction.writebackAddress, lineBytes, context);
+  } else if (transaction.isEviction &&
+             invalidatePrevious(transaction.evictionAddress, lineBytes,
+                                context)) {
+    // The line was modified in a previous level cache.
+    transaction.isEviction = false;
+    transaction.isWriteback = true;
+    transaction.writebackAddress = transaction.evictionAddress;
+  }
+}
+
+void CacheSim::saveVictimState(CacheTrace &trace,
+                               const AccessContext &context) {
+  if (context.recordUndo && !trace.savedVictimState) {
+    m_victimStack.push_front(m_victims);
+    trace.savedVictimState = true;
+  }
+}
+
+bool CacheSim::invalidatePrevious(AInt address, AInt bytes,
+                                  const AccessContext &context) {
+  bool dirty = false;
+  for (CacheSim *cache : m_previousLevelCaches)
+    dirty |= cache->invalidateRange(address, bytes, context);
+  return dirty;
+}
+
+bool CacheSim::invalidateRange(AInt address, AInt bytes,
+                               const AccessContext &context) {
+  const AInt lineBytes = AInt(1) << (m_byteOffset + getBlockBits());
+  bool dirty = false;
+  for (AInt lineAddress = address & ~(lineBytes - 1);
+       lineAddress < address + bytes; lineAddress += lineBytes) {
+    CacheTransaction transaction;
+    transaction.address = lineAddress;
+    analyzeCacheAccess(transaction);
+    if (transaction.isHit) {
+      dirty |= invalidateTraced(transaction.index.line, transaction.index.way,
+                                context, false);
+      continue;
+    }
+
+    const auto it = std::find_if(
+        m_victims.begin(), m_victims.end(),
+        [&](const VictimLine &line) { return line.address == lineAddress; });
+    if (it == m_victims.end())
+      continue;
+    // Invalidations of victim cache lines are traced without a way.
+    CacheTrace trace;
+    trace.transaction.address = lineAddress;
+    trace.transaction.isInvalidation = true;
+    trace.cycle = context.cycle;
+    saveVictimState(trace, context);
+    dirty |= it->dirty;
+    m_victims.erase(it);
+    if (context.recordUndo)
+      pushTrace(trace);
+    pushAccessTrace(trace.transaction, context);
+  }
+  if (m_inclusionPolicy == InclusionPolicy::Inclusive)
+    dirty |= invalidatePrevious(address, bytes, context);
+  return dirty;
+}
+
+bool CacheSim::invalidateTraced(unsigned lineIdx, unsigned wayIdx,
+                                const AccessContext &context, bool writeback) {
+  const unsigned idx = wayIndex(lineIdx, wayIdx);
+  const bool dirty = m_dirty[idx];
+  CacheTrace trace;
+  trace.transaction.address = buildAddress(m_tags[idx], lineIdx, 0);
+  trace.transaction.index = {lineIdx, wayIdx, 0};
+  trace.transaction.isInvalidation = true;
+  trace.transaction.isWriteback = writeback && dirty;
+  trace.transaction.writebackAddress = trace.transaction.address;
+  trace.cycle = context.cycle;
+  if (context.recordUndo) {
+    trace.evicted = true;
+    m_evictionStack.push_front(saveWay(idx));
+    if (m_replWords != 0) {
+      saveReplState(lineIdx);
+      trace.savedReplState = true;
+    }
+    pushTrace(trace);
+  }
+  removeWay(lineIdx, idx);
+  pushAccessTrace(trace.transaction, context);
+  if (context.notify)
+    emit wayInvalidated(lineIdx, wayIdx);
+  return dirty;
+}
+
+void CacheSim::drainRunTransactions() {
+  std::vector<CacheTransaction> transactions;
+  m_runTransactions.drain(transactions);
+  if (!transactions.empty()) {
+    emit transactionsBatched(transactions);
   }
 }
 
@@ -359,39 +1003,78 @@ void CacheSim::undo() {
     return;
 
   const auto trace = popTrace();
-  popAccessTrace();
+  popAccessTrace(trace);
 
-  const auto &oldWay = trace.oldWay;
   const unsigned &lineIdx = trace.transaction.index.line;
   const unsigned &wayIdx = trace.transaction.index.way;
-  auto &line = m_cacheLines.at(lineIdx);
-  auto &way = line.at(wayIdx);
-
-  // Case 1: A cache way was transitioned to valid. In this case, we simply
-  // invalidate the cache way
-  if (trace.transaction.transToValid) {
-    // Invalidate the way
-    Q_ASSERT(m_cacheLines.at(lineIdx).count(wayIdx) != 0);
-    way = CacheWay();
-  }
-  // Case 2: A miss occured on a valid entry. In this case, we have to restore
-  // the old way, which was evicted
-  // - Restore the old entry which was evicted
-  else if (!trace.transaction.isHit) {
-    way = oldWay;
-  }
-  // Case 3: Else, it was a cache hit; Revert replacement fields and dirty
-  // blocks
-  way.dirtyBlocks = oldWay.dirtyBlocks;
-  revertCacheLineReplFields(line, oldWay, wayIdx);
-
-  // Notify that changes to the way has been performed
-  emit wayInvalidated(lineIdx, wayIdx);
+
+  // A write miss without write allocation, and the invalidation of a victim
+  // cache line, did not modify the ways of the cache.
+  if (wayIdx != s_invalidIndex) {
+    const unsigned idx = wayIndex(lineIdx, wayIdx);
+
+    // Case 0: A cache way was invalidated outside of an access. Restore the way
+    // and its position in the LRU order
+    if (trace.transaction.isInvalidation) {
+      Q_ASSERT(m_evictionStack.size() > 0);
+      const WayState &way = m_evictionStack.front();
+      if (m_replPolicy == ReplPolicy::LRU) {
+        const unsigned base = wayIndex(lineIdx, 0);
+        for (int i = 0; i < getWays(); ++i) {
+          if (m_valid[base + i] && m_lrus[base + i] >= way.lru)
+            m_lrus[base + i]++;
+        }
+      }
+      restoreWay(idx, way);
+      m_evictionStack.pop_front();
+      if (trace.savedReplState)
+        restoreReplState(lineIdx);
+    }
+    // Case 1: A cache way was transitioned to valid. In this case, we simply
+    // invalidate the cache way
+    else if (trace.transaction.transToValid) {
+      invalidateWay(idx);
+    }
+    // Case 2: A miss occured on a valid entry. In this case, we have to
+    // restore the old way, which was evicted
+    else if (trace.evicted) {
+      Q_ASSERT(m_evictionStack.size() > 0);
+      restoreWay(idx, m_evictionStack.front());
+      m_evictionStack.pop_front();
+    }
+    // Case 3: Else, it was a cache hit; Revert dirty state
+    else {
+      if (trace.dirtiedBlock != s_invalidIndex) {
+        dirtyBlocksOf(idx)[trace.dirtiedBlock / 64] &=
+            ~(uint64_t(1) << (trace.dirtiedBlock % 64));
+      }
+      m_dirty[idx] = trace.oldDirty;
+      if (trace.transaction.prefetchHit) {
+        m_prefetched[idx] = true;
+      }
+    }
+    // In all other cases, revert the replacement fields
+    if (!trace.transaction.isInvalidation)
+      revertCacheLineReplFields(trace);
+
+    // Notify that changes to the way has been performed
+    emit wayInvalidated(lineIdx, wayIdx);
+  }
+  if (trace.savedVictimState) {
+    Q_ASSERT(m_victimStack.size() > 0);
+    m_victims = std::move(m_victimStack.front());
+    m_victimStack.pop_front();
+  }
 
   // Finally, re-emit the transaction which occurred in the previous cache
   // access to update the cache highlighting state
-  if (m_traceStack.size() > 0) {
-    emit dataChanged(m_traceStack.begin()->transaction);
+  const auto previous = std::find_if(
+      m_traceStack.begin(), m_traceStack.end(),
+      [](const CacheTrace &t) {
+        return !t.transaction.isPrefetch && !t.transaction.isInvalidation;
+      });
+  if (previous != m_traceStack.end()) {
+    emit dataChanged(previous->transaction);
   } else {
     emit dataChanged(CacheTransaction());
   }
@@ -407,16 +1090,23 @@ CacheSim::CacheTrace CacheSim::popTrace() {
 void CacheSim::pushTrace(const CacheTrace &eviction) {
   m_traceStack.push_front(eviction);
   if (m_traceStack.size() > vsrtl::core::ClockedComponent::reverseStackSize()) {
+    if (m_traceStack.back().evicted)
+      m_evictionStack.pop_back();
+    if (m_traceStack.back().savedReplState)
+      m_replStack.erase(m_replStack.end() - m_replWords, m_replStack.end());
+    if (m_traceStack.back().savedVictimState)
+      m_victimStack.pop_back();
     m_traceStack.pop_back();
   }
 }
 
-AInt CacheSim::buildAddress(unsigned tag, unsigned lineIdx,
+AInt CacheSim::buildAddress(VInt tag, unsigned lineIdx,
                             unsigned blockIdx) const {
   AInt address = 0;
-  address |= tag << (m_byteOffset + getBlockBits() + getLineBits());
-  address |= lineIdx << (m_byteOffset + getBlockBits());
-  address |= blockIdx << (m_byteOffset);
+  address |= static_cast<AInt>(tag)
+             << (m_byteOffset + getBlockBits() + getLineBits());
+  address |= static_cast<AInt>(lineIdx) << (m_byteOffset + getBlockBits());
+  address |= static_cast<AInt>(blockIdx) << (m_byteOffset);
   return address;
 }
 
@@ -426,7 +1116,7 @@ unsigned CacheSim::getLineIdx(const AInt address) const {
   return maskedAddress;
 }
 
-unsigned CacheSim::getTag(const AInt address) const {
+VInt CacheSim::getTag(const AInt address) const {
   AInt maskedAddress = address & m_tagMask;
   maskedAddress >>= m_byteOffset + getBlockBits() + getLineBits();
   return maskedAddress;
@@ -438,40 +1128,63 @@ unsigned CacheSim::getBlockIdx(const AInt address) const {
   return maskedAddress;
 }
 
-const CacheSim::CacheLine *CacheSim::getLine(unsigned idx) const {
-  if (m_cacheLines.count(idx)) {
-    return &m_cacheLines.at(idx);
-  } else {
-    return nullptr;
+CacheSim::CacheWay CacheSim::getWay(unsigned lineIdx, unsigned wayIdx) const {
+  const unsigned idx = wayIndex(lineIdx, wayIdx);
+  CacheWay way;
+  way.tag = m_tags[idx];
+  way.valid = m_valid[idx];
+  way.dirty = m_dirty[idx];
+  way.lru = m_lrus[idx];
+  way.prefetched = m_prefetched[idx];
+  const uint64_t *dirtyBlocks = dirtyBlocksOf(idx);
+  for (int block = 0; block < getBlocks(); ++block) {
+    if (dirtyBlocks[block / 64] & (uint64_t(1) << (block % 64)))
+      way.dirtyBlocks.insert(block);
   }
+  return way;
+}
+
+CacheSim::CacheLine CacheSim::getLine(unsigned idx) const {
+  CacheLine line;
+  for (int i = 0; i < getWays(); ++i)
+    line[i] = getWay(idx, i);
+  return line;
 }
 
 void CacheSim::reverse() {
-  if (m_accessTrace.size() == 0) {
+  if (m_traceStack.size() == 0) {
     // Nothing to reverse
     return;
   }
 
   const unsigned cycleToUndo =
       ProcessorHandler::getProcessor()->getCycleCount() + 1;
-  if (m_accessTrace.rbegin()->first != cycleToUndo) {
+  if (m_traceStack.front().cycle != cycleToUndo) {
     // No cache access in this cycle
     return;
   }
 
-  // It is now safe to undo the cycle at the top of our access stack(s).
-  undo();
+  // It is now safe to undo the cycle at the top of our access stack(s). A
+  // shared next level cache may have been accessed multiple times within the
+  // cycle.
+  while (m_traceStack.size() > 0 && m_traceStack.front().cycle == cycleToUndo)
+    undo();
 
   CacheInterface::reverse();
 }
 
 void CacheSim::recalculateMasks() {
+  // Masks are computed in the address type, such that tags of 64-bit ISAs are
+  // not truncated.
   unsigned bitOffset = m_byteOffset;
-  m_blockMask = vsrtl::generateBitmask(getBlockBits()) << bitOffset;
+  m_blockMask = static_cast<AInt>(vsrtl::generateBitmask(getBlockBits()))
+                << bitOffset;
   bitOffset += getBlockBits();
-  m_lineMask = vsrtl::generateBitmask(getLineBits()) << bitOffset;
+  m_lineMask = static_cast<AInt>(vsrtl::generateBitmask(getLineBits()))
+               << bitOffset;
   bitOffset += getLineBits();
-  m_tagMask = vsrtl::generateBitmask(m_wordBits - bitOffset) << bitOffset;
+  m_tagMask = static_cast<AInt>(vsrtl::generateBitmask(m_wordBits - bitOffset))
+              << bitOffset;
 }
 
 void CacheSim::reset() {
@@ -482,9 +1195,21 @@ void CacheSim::reset() {
 
   m_isResetting = true;
 
-  m_cacheLines.clear();
-  m_accessTrace.clear();
+  resizeStorage();
+  if (m_profiler)
+    m_profiler->reset();
+  if (m_prefetcher)
+    m_prefetcher->reset();
+  m_accessStats = CacheAccessTrace();
+  m_latencyCycles = 0;
+  m_accessHistory.clear();
+  m_historyShift = 0;
+  m_historyCapacity =
+      RipesSettings::value(RIPES_SETTING_CACHE_MAXCYCLES).toInt();
   m_traceStack.clear();
+  m_evictionStack.clear();
+  m_victims.clear();
+  m_victimStack.clear();
 
   m_wordBits = ProcessorHandler::currentISA()->bits();
   m_byteOffset = log2Ceil(ProcessorHandler::currentISA()->bytes());
@@ -499,11 +1224,26 @@ void CacheSim::reset() {
 
 void CacheSim::updateConfiguration() {
   // Recalculate masks
+  m_wordBits = ProcessorHandler::currentISA()->bits();
   m_byteOffset = log2Ceil(ProcessorHandler::currentISA()->bytes());
   recalculateMasks();
+  resizeStorage();
+  if (m_profiler)
+    setStackDistanceProfiling(true);
+  m_prefetcher =
+      Prefetcher::create(m_prefetchPolicy, m_byteOffset + getBlockBits());
   emit configurationChanged();
 }
 
+void CacheSim::setStackDistanceProfiling(bool enabled) {
+  if (enabled) {
+    m_profiler = std::make_shared<StackDistanceProfiler>(m_byteOffset +
+                                                         getBlockBits());
+  } else {
+    m_profiler.reset();
+  }
+}
+
 void CacheSim::setBlocks(unsigned blocks) {
   m_blocks = blocks;
   updateConfiguration();
@@ -534,6 +1274,27 @@ void CacheSim::setReplacementPolicy(ReplPolicy policy) {
   updateConfiguration();
 }
 
+void CacheSim::setPrefetchPolicy(PrefetchPolicy policy) {
+  m_prefetchPolicy = policy;
+  updateConfiguration();
+}
+
+void CacheSim::setVictimCacheEntries(unsigned entries) {
+  m_victimEntries = entries;
+  updateConfiguration();
+}
+
+CachePreset CacheSim::getPreset() const {
+  CachePreset preset;
+  preset.blocks = m_blocks;
+  preset.lines = m_lines;
+  preset.ways = m_ways;
+  preset.wrPolicy = m_wrPolicy;
+  preset.wrAllocPolicy = m_wrAllocPolicy;
+  preset.replPolicy = m_replPolicy;
+  return preset;
+}
+
 void CacheSim::setPreset(const CachePreset &preset) {
   m_blocks = preset.blocks;
   m_ways = preset.ways;
@@ -6,17 +6,23 @@
 
 #include <QDataStream>
 #include <QObject>
+#include <QTimer>
 
 #include "../external/VSRTL/core/vsrtl_register.h"
 #include "processors/RISC-V/rv_memory.h"
 #include "processors/interface/ripesprocessor.h"
+#include "spscring.h"
 
 namespace Ripes {
 class CacheSim;
+class StackDistanceProfiler;
+class Prefetcher;
 
 enum WriteAllocPolicy { WriteAllocate, NoWriteAllocate };
 enum WritePolicy { WriteThrough, WriteBack };
-enum ReplPolicy { Random, LRU };
+enum ReplPolicy { Random, LRU, PLRU, FIFO, SRRIP };
+enum class PrefetchPolicy { Disabled, NextLine, Stride, Stream };
+enum class InclusionPolicy { NINE, Inclusive, Exclusive };
 
 struct CachePreset {
   QString name;
@@ -64,10 +70,28 @@ public:
   /**
    * @brief access
    * A function called by the logical "child" of this cache, indicating that it
-   * desires to access this cache
+   * desires to access this cache. Returns the number of cycles required to
+   * serve the access.
    */
-  virtual void access(AInt address, MemoryAccess::Type type) = 0;
-  void setNextLevelCache(const std::shared_ptr<CacheSim> &cache) {
+  virtual unsigned access(AInt address, MemoryAccess::Type type) = 0;
+  /**
+   * @brief evict
+   * Called by the logical child of this cache when it evicts the clean line
+   * of @p address. Dirty lines are instead written back through access().
+   */
+  virtual void evict(AInt address) { Q_UNUSED(address); }
+  /**
+   * @brief warm
+   * Updates the state of the cache for an access by the logical child of this
+   * cache, ie. while fast-forwarding functionally, such that the cache is warm
+   * once detailed simulation starts. No statistics or undo state are recorded,
+   * and no signals are emitted. Caches without state to warm pass the access on
+   * to their next level cache.
+   */
+  virtual void warm(AInt address, MemoryAccess::Type type);
+  /// Warms the eviction of the clean line of @p address; see evict().
+  virtual void warmEviction(AInt address);
+  void setNextLevelCache(const std::shared_ptr<CacheInterface> &cache) {
     m_nextLevelCache = cache;
   }
 
@@ -84,7 +108,7 @@ protected:
    * @brief m_nextLevelCache
    * Pointer to the next level (logical parent) cache.
    */
-  std::shared_ptr<CacheSim> m_nextLevelCache;
+  std::shared_ptr<CacheInterface> m_nextLevelCache;
 };
 
 class CacheSim : public CacheInterface {
@@ -97,11 +121,18 @@ public:
     std::vector<QString> components;
   };
 
+  /**
+   * @brief The CacheWay struct
+   * View of the state of a single cache way. The cache state itself is stored
+   * in a packed representation; see m_tags.
+   */
   struct CacheWay {
     VInt tag = -1;
     std::set<unsigned> dirtyBlocks;
     bool dirty = false;
     bool valid = false;
+    // True if the way was filled by a prefetch, and has not yet been accessed.
+    bool prefetched = false;
 
     // LRU algorithm relies on invalid cache ways to have an initial high value.
     // -1 ensures maximum value for all way sizes.
@@ -136,6 +167,23 @@ public:
         false; // True if the cacheline just transitioned from invalid to valid
     bool tagChanged =
         false; // True if transToValid or the previous entry was evicted
+    AInt writebackAddress = 0; // Address written to the next level, if
+                               // isWriteback
+    bool isPrefetch = false; // True if the transaction is a prefetch fill
+    bool prefetchHit = false; // True if a demand access hit a prefetched block
+                              // which had not yet been accessed
+    bool latePrefetch = false; // True if prefetchHit, and the prefetch fill had
+                               // not yet completed at the time of the access
+    bool victimHit = false; // True if a miss was served by the victim cache
+    bool isEviction = false; // True if a valid clean line left the cache; dirty
+                             // lines are written back instead
+    AInt evictionAddress = 0; // Address of the evicted line, if isEviction
+    bool isInvalidation = false; // True if the transaction invalidated a line
+                                 // outside of an access, ie. on behalf of an
+                                 // inclusive or exclusive next level cache
+    bool isInsertion = false; // True if the transaction inserted a line
+                              // evicted by a previous level cache into an
+                              // exclusive cache
   };
 
   struct CacheAccessTrace {
@@ -144,65 +192,239 @@ public:
     int reads = 0;
     int writes = 0;
     int writebacks = 0;
+    // Prefetch fills, and demand accesses served by (late) prefetched blocks.
+    int prefetches = 0;
+    int prefetchHits = 0;
+    int latePrefetches = 0;
+    // Misses served by the victim cache.
+    int victimHits = 0;
+    // Lines invalidated on behalf of the next level cache, and lines inserted
+    // upon their eviction from a previous level cache.
+    int invalidations = 0;
+    int insertions = 0;
     CacheAccessTrace() {}
     CacheAccessTrace(const CacheTransaction &transaction)
         : CacheAccessTrace(CacheAccessTrace(), transaction) {}
     CacheAccessTrace(const CacheAccessTrace &pre,
-                     const CacheTransaction &transaction) {
-      reads = pre.reads + (transaction.type == MemoryAccess::Read ? 1 : 0);
-      writes = pre.writes + (transaction.type == MemoryAccess::Write ? 1 : 0);
-      writebacks = pre.writebacks + (transaction.isWriteback ? 1 : 0);
-      hits = pre.hits + (transaction.isHit ? 1 : 0);
-      misses = pre.misses + (transaction.isHit ? 0 : 1);
+                     const CacheTransaction &transaction)
+        : CacheAccessTrace(pre) {
+      add(transaction, 1);
+    }
+    /// Adds @p n counts of @p transaction to the statistics. A negative @p n
+    /// removes counts, ie. when undoing a transaction.
+    void add(const CacheTransaction &transaction, int n) {
+      writebacks += transaction.isWriteback ? n : 0;
+      if (transaction.isInvalidation) {
+        invalidations += n;
+        return;
+      }
+      if (transaction.isInsertion) {
+        // Insertions are not demand accesses.
+        insertions += n;
+        return;
+      }
+      if (transaction.isPrefetch) {
+        // Prefetch fills are not demand accesses.
+        prefetches += n;
+        return;
+      }
+      prefetchHits += transaction.prefetchHit ? n : 0;
+      latePrefetches += transaction.latePrefetch ? n : 0;
+      victimHits += transaction.victimHit ? n : 0;
+      reads += transaction.type == MemoryAccess::Read ? n : 0;
+      writes += transaction.type == MemoryAccess::Write ? n : 0;
+      hits += transaction.isHit ? n : 0;
+      misses += transaction.isHit ? 0 : n;
     }
+    int accesses() const { return hits + misses; }
+  };
+
+  /**
+   * @brief The AccessSample struct
+   * Cumulative access statistics as of the end of @p cycle.
+   */
+  struct AccessSample {
+    unsigned cycle;
+    CacheAccessTrace stats;
   };
 
   using CacheLine = std::map<unsigned, CacheWay>;
 
+  // Additional cycles of the misses served by the victim cache, for swapping
+  // the line into the cache.
+  static constexpr unsigned s_victimLatency = 1;
+
   CacheSim(QObject *parent);
   void setWritePolicy(WritePolicy policy);
   void setWriteAllocatePolicy(WriteAllocPolicy policy);
   void setReplacementPolicy(ReplPolicy policy);
+  /**
+   * @brief setPrefetchPolicy
+   * Selects the prefetcher in front of this cache. Prefetch fills are undone
+   * alongside the access which triggered them, whereas the training state of
+   * the prefetcher is not reverted.
+   */
+  void setPrefetchPolicy(PrefetchPolicy policy);
+  /**
+   * @brief setVictimCacheEntries
+   * Attaches a fully-associative victim cache of @p entries lines with LRU
+   * replacement, holding the lines evicted from this cache; 0 entries detaches
+   * it. A miss to a line of the victim cache swaps the line back into the
+   * cache in place of a fill from the next level cache, at s_victimLatency
+   * additional cycles, and is counted as a miss and a victim hit. Lines are
+   * written back once dirty and evicted from the victim cache. Accesses which
+   * do not allocate bypass the victim cache.
+   */
+  void setVictimCacheEntries(unsigned entries);
+  unsigned getVictimCacheEntries() const { return m_victimEntries; }
+  /**
+   * @brief setInclusionPolicy
+   * Selects whether this cache holds the lines of the previous level caches
+   * (see addPreviousLevelCache). Non-inclusive non-exclusive (NINE) caches
+   * neither enforce nor prevent holding them. Inclusive caches invalidate
+   * the lines they evict in the previous level caches, writing back the line
+   * if a previous level cache held it dirty. Exclusive caches only allocate
+   * the lines evicted and written back by the previous level caches, and hand
+   * out the lines which they read, invalidating their own copy, which is
+   * written back if dirty.
+   */
+  void setInclusionPolicy(InclusionPolicy policy) {
+    m_inclusionPolicy = policy;
+  }
+  InclusionPolicy getInclusionPolicy() const { return m_inclusionPolicy; }
+  /// Registers @p cache, whose next level cache is this cache, as a previous
+  /// level cache for the inclusion policy. The cache must outlive this cache.
+  void addPreviousLevelCache(CacheSim *cache) {
+    m_previousLevelCaches.push_back(cache);
+  }
 
-  void access(AInt address, MemoryAccess::Type type) override;
+  unsigned access(AInt address, MemoryAccess::Type type) override;
+  /// Inserts the clean line of @p address, evicted by a previous level cache,
+  /// if this cache is exclusive.
+  void evict(AInt address) override;
+  void warm(AInt address, MemoryAccess::Type type) override;
+  void warmEviction(AInt address) override;
+  /**
+   * @brief replayAccess
+   * Performs an access which is not associated with the current processor, ie.
+   * an access of a recorded trace performed in @p cycle. No undo state is
+   * recorded, no signals are emitted, and next level caches are not accessed.
+   * As such, caches may replay accesses concurrently on separate threads. If
+   * provided, the transaction of the access is stored in @p transaction.
+   */
+  void replayAccess(AInt address, MemoryAccess::Type type, unsigned cycle,
+                    CacheTransaction *transaction = nullptr);
+  /// Returns true if the block of @p address is present in the cache.
+  bool contains(AInt address) const;
+  /**
+   * @brief invalidate
+   * Invalidates the way holding the block of @p address, if present, as when
+   * snooped by a coherence protocol. No undo state is recorded, and the
+   * access statistics are unaffected. Returns true if the way was dirty.
+   */
+  bool invalidate(AInt address);
   void undo();
   void reset() override;
 
+  /**
+   * @brief setLatency
+   * Sets the number of cycles required to access this cache. The latency of a
+   * miss additionally includes the latency of the next level cache or, for the
+   * last level cache, the miss latency. Latencies stall the processor if
+   * timing is enabled for the L1CacheShim feeding the hierarchy, and are used
+   * for estimating the memory stall cycles of a cache hierarchy.
+   */
+  void setLatency(unsigned cycles) { m_latency = cycles; }
+  unsigned getLatency() const { return m_latency; }
+  /// Sets the number of cycles required for serving a miss from memory, when
+  /// no next level cache is attached.
+  void setMissLatency(unsigned cycles) { m_missLatency = cycles; }
+  unsigned getMissLatency() const { return m_missLatency; }
+  /// Returns the total latency of the accesses of the processor (see access())
+  /// since the last reset. Undoing accesses does not revert their latency.
+  unsigned long long getLatencyCycles() const { return m_latencyCycles; }
+
+  /**
+   * @brief setStackDistanceProfiling
+   * Enables or disables stack distance profiling of the accesses to this cache,
+   * at the block size of the current configuration. The profile is cleared
+   * upon reset and configuration changes. Reversing the processor does not
+   * revert profiled accesses.
+   */
+  void setStackDistanceProfiling(bool enabled);
+  /// Returns the stack distance profile, or nullptr if profiling is disabled.
+  const StackDistanceProfiler *getStackDistanceProfiler() const {
+    return m_profiler.get();
+  }
+
+  /// Returns the current configuration as an (unnamed) preset.
+  CachePreset getPreset() const;
+
   WriteAllocPolicy getWriteAllocPolicy() const { return m_wrAllocPolicy; }
   ReplPolicy getReplacementPolicy() const { return m_replPolicy; }
   WritePolicy getWritePolicy() const { return m_wrPolicy; }
+  PrefetchPolicy getPrefetchPolicy() const { return m_prefetchPolicy; }
 
-  const std::map<unsigned, CacheAccessTrace> &getAccessTrace() const {
-    return m_accessTrace;
+  /**
+   * @brief getAccessHistory
+   * Returns the history of the cache access statistics, sorted by cycle. The
+   * history holds at most one sample per getAccessHistoryResolution() cycles.
+   */
+  const std::vector<AccessSample> &getAccessHistory() const {
+    return m_accessHistory;
   }
+  /// Number of cycles covered by each sample of the access history.
+  unsigned getAccessHistoryResolution() const { return 1u << m_historyShift; }
 
   double getHitRate() const;
+  /// Returns the access statistics since the last reset.
+  const CacheAccessTrace &getAccessStats() const { return m_accessStats; }
   unsigned getHits() const;
   unsigned getMisses() const;
   unsigned getWritebacks() const;
+  unsigned getPrefetches() const { return m_accessStats.prefetches; }
+  unsigned getVictimHits() const { return m_accessStats.victimHits; }
+  /// Lines invalidated on behalf of an inclusive next level cache, or handed
+  /// out by an exclusive cache.
+  unsigned getInvalidations() const { return m_accessStats.invalidations; }
+  /// Lines inserted into an exclusive cache upon their eviction from a
+  /// previous level cache.
+  unsigned getInsertions() const { return m_accessStats.insertions; }
+  /// Fraction of prefetch fills which were accessed before being evicted.
+  double getPrefetchAccuracy() const;
+  /// Fraction of the would-be misses which were served by prefetched blocks.
+  double getPrefetchCoverage() const;
+  /// Fraction of the accessed prefetched blocks which had completed their fill
+  /// at the time of the access.
+  double getPrefetchTimeliness() const;
   CacheSize getCacheSize() const;
 
-  AInt buildAddress(unsigned tag, unsigned lineIdx, unsigned blockIdx) const;
+  AInt buildAddress(VInt tag, unsigned lineIdx, unsigned blockIdx) const;
 
   int getBlockBits() const { return m_blocks; }
   int getWaysBits() const { return m_ways; }
   int getLineBits() const { return m_lines; }
+  /// Returns the number of address bits stored in each tag, which depends on
+  /// the address width of the current ISA.
   int getTagBits() const {
-    return 32 - 2 /*byte offset*/ - getBlockBits() - getLineBits();
+    return m_wordBits - m_byteOffset - getBlockBits() - getLineBits();
   }
 
   int getBlocks() const { return static_cast<int>(std::pow(2, m_blocks)); }
   int getWays() const { return static_cast<int>(std::pow(2, m_ways)); }
   int getLines() const { return static_cast<int>(std::pow(2, m_lines)); }
-  unsigned getBlockMask() const { return m_blockMask; }
-  unsigned getTagMask() const { return m_tagMask; }
-  unsigned getLineMask() const { return m_lineMask; }
+  AInt getBlockMask() const { return m_blockMask; }
+  AInt getTagMask() const { return m_tagMask; }
+  AInt getLineMask() const { return m_lineMask; }
 
   unsigned getLineIdx(const AInt address) const;
   unsigned getBlockIdx(const AInt address) const;
-  unsigned getTag(const AInt address) const;
+  VInt getTag(const AInt address) const;
 
-  const CacheLine *getLine(unsigned idx) const;
+  /// Returns a view of cache line @p idx.
+  CacheLine getLine(unsigned idx) const;
+  /// Returns a view of way @p wayIdx of cache line @p lineIdx.
+  CacheWay getWay(unsigned lineIdx, unsigned wayIdx) const;
 
 public slots:
   void setBlocks(unsigned blocks);
@@ -222,6 +444,16 @@ signals:
   void dataChanged(CacheSim::CacheTransaction transaction);
   void hitrateChanged();
 
+  /**
+   * @brief transactionsBatched
+   * Emitted while the processor is running, at the UI update rate, with the
+   * transactions performed since the previous batch. Transactions may be
+   * dropped if the graphical view cannot keep up with the simulator. The state
+   * of the cache must not be inspected until running has finished.
+   */
+  void transactionsBatched(
+      const std::vector<CacheSim::CacheTransaction> &transactions);
+
   // Signals that the entire cache line @p
   /**
    * @brief wayInvalidated
@@ -238,17 +470,136 @@ signals:
   void cacheInvalidated();
 
 private:
+  /**
+   * @brief The CacheTrace struct
+   * Delta record of the changes which a single cache access made to the
+   * accessed way. Only evictions of valid ways require the full prior way
+   * state, which is stored separately in m_evictionStack.
+   */
   struct CacheTrace {
     CacheTransaction transaction;
-    CacheWay oldWay;
+    // Replacement field of the accessed way prior to the access.
+    unsigned oldLru = -1;
+    // Block which was newly marked dirty by this access, if any.
+    unsigned dirtiedBlock = s_invalidIndex;
+    // Dirty flag of the accessed way prior to the access.
+    bool oldDirty = false;
+    // True if a valid way was evicted by this access.
+    bool evicted = false;
+    // Cycle in which the access was performed.
+    unsigned cycle = 0;
+    // True if the replacement state of the accessed line prior to the access
+    // was pushed onto m_replStack.
+    bool savedReplState = false;
+    // True if the victim cache prior to the access was pushed onto
+    // m_victimStack.
+    bool savedVictimState = false;
+  };
+
+  /**
+   * @brief The WayState struct
+   * Full state of a single way, as recorded when a valid way is evicted.
+   */
+  struct WayState {
+    VInt tag;
+    unsigned lru;
+    bool valid;
+    bool dirty;
+    std::vector<uint64_t> dirtyBlocks;
+    bool prefetched;
+    unsigned prefetchReady;
   };
 
-  std::pair<unsigned, CacheSim::CacheWay *>
-  locateEvictionWay(const CacheTransaction &transaction);
-  CacheWay evictAndUpdate(CacheTransaction &transaction);
+  unsigned locateEvictionWay(const CacheTransaction &transaction) const;
+  /// Returns the way of the valid line @p lineIdx to be replaced according to
+  /// the replacement policy.
+  unsigned locateReplacementWay(unsigned lineIdx) const;
+  /// Evicts a way for @p transaction and loads the accessed address into it.
+  /// If provided, the prior state of an evicted valid way is stored in
+  /// @p eviction.
+  void evictAndUpdate(CacheTransaction &transaction, WayState *eviction);
   void analyzeCacheAccess(CacheTransaction &transaction) const;
-  void pushAccessTrace(const CacheTransaction &transaction);
-  void popAccessTrace();
+  /**
+   * @brief The AccessContext struct
+   * Describes the context in which an access is performed.
+   */
+  struct AccessContext {
+    unsigned cycle;
+    // Record undo state for reversing the access.
+    bool recordUndo;
+    // Emit signals for updating the graphical view of the cache.
+    bool notify;
+    // Queue the transaction for batched delivery to the graphical view.
+    bool batch;
+    // Propagate misses and writebacks to the next level cache.
+    bool forward;
+    // If set, receives the transaction of the access.
+    CacheTransaction *result = nullptr;
+    // Insert the accessed line, evicted by a previous level cache, without
+    // filling it from the next level cache.
+    bool insertion = false;
+    // Update the cache state only; the access statistics, history and stack
+    // distance profile are not recorded, and next level caches are warmed
+    // rather than accessed.
+    bool warm = false;
+  };
+  /// Returns the context of the accesses of the current processor.
+  static AccessContext processorContext();
+  /// Returns the context of accesses warming the cache (see warm()).
+  static AccessContext warmContext();
+  /// Accesses, or warms, the next level cache per @p context. Returns the
+  /// latency of the access.
+  unsigned forwardAccess(AInt address, MemoryAccess::Type type,
+                         const AccessContext &context);
+  void forwardEviction(AInt address, const AccessContext &context);
+  /// Returns the latency of the access.
+  unsigned performAccess(AInt address, MemoryAccess::Type type,
+                         const AccessContext &context);
+  /// Trains the prefetcher on a demand access to @p address, and fills the
+  /// requested blocks which are not present in the cache.
+  void issuePrefetches(AInt address, bool hit, const AccessContext &context);
+  void performPrefetch(AInt address, const AccessContext &context);
+  /// Swaps the line accessed by @p transaction, which was just allocated, in
+  /// from the victim cache, if present.
+  void swapInVictim(CacheTransaction &transaction, CacheTrace &trace,
+                    const AccessContext &context);
+  /**
+   * @brief retireEvictedLine
+   * Called when @p transaction evicts a valid way, of prior state @p evicted
+   * (required with a victim cache). The line is moved into the victim cache,
+   * and the line leaving the cache, if any, is recorded as the writeback or
+   * eviction of @p transaction, after invalidating it in the previous level
+   * caches of an inclusive cache.
+   */
+  void retireEvictedLine(CacheTransaction &transaction, const WayState *evicted,
+                         CacheTrace &trace, const AccessContext &context);
+  void saveVictimState(CacheTrace &trace, const AccessContext &context);
+  /// Invalidates the @p bytes from @p address in the previous level caches.
+  /// Returns true if any of the invalidated lines were dirty.
+  bool invalidatePrevious(AInt address, AInt bytes,
+                          const AccessContext &context);
+  /// Invalidates the lines overlapping the @p bytes from @p address, in this
+  /// cache, its victim cache, and the previous level caches if inclusive.
+  /// Returns true if any of the invalidated lines were dirty.
+  bool invalidateRange(AInt address, AInt bytes, const AccessContext &context);
+  /**
+   * @brief invalidateTraced
+   * Invalidates way @p wayIdx of line @p lineIdx outside of an access,
+   * recording an invalidation transaction per @p context, which is a writeback
+   * if @p writeback and the way was dirty. Returns true if the way was dirty.
+   */
+  bool invalidateTraced(unsigned lineIdx, unsigned wayIdx,
+                        const AccessContext &context, bool writeback);
+  /// Invalidates way @p idx, retaining the LRU order of the remaining ways of
+  /// line @p lineIdx.
+  void removeWay(unsigned lineIdx, unsigned idx);
+  /// Emits or queues @p transaction for the graphical view, per @p context.
+  void notifyTransaction(const CacheTransaction &transaction,
+                         const AccessContext &context);
+  void pushAccessTrace(const CacheTransaction &transaction,
+                       const AccessContext &context);
+  void popAccessTrace(const CacheTrace &trace);
+  void recordAccessHistory(unsigned cycle);
 
   /**
    * @brief updateConfiguration
@@ -269,10 +620,19 @@ private:
   WritePolicy m_wrPolicy = WritePolicy::WriteBack;
   WriteAllocPolicy m_wrAllocPolicy = WriteAllocPolicy::WriteAllocate;
 
-  unsigned m_blockMask = -1;
-  unsigned m_lineMask = -1;
-  unsigned m_tagMask = -1;
-
+  AInt m_blockMask = -1;
+  AInt m_lineMask = -1;
+  AInt m_tagMask = -1;
+
+  unsigned m_latency = 1;
+  unsigned m_missLatency = 10;
+  unsigned long long m_latencyCycles = 0;
+  std::shared_ptr<StackDistanceProfiler> m_profiler;
+  PrefetchPolicy m_prefetchPolicy = PrefetchPolicy::Disabled;
+  std::shared_ptr<Prefetcher> m_prefetcher;
+  InclusionPolicy m_inclusionPolicy = InclusionPolicy::NINE;
+  std::vector<CacheSim *> m_previousLevelCaches;
+  std::vector<AInt> m_prefetchRequests;
   int m_blocks = 2;           // Some power of 2
   int m_lines = 5;            // Some power of 2
   int m_ways = 0;             // Some power of 2
@@ -280,27 +640,116 @@ private:
   unsigned m_wordBits = -1;
 
   /**
-   * @brief m_cacheLines
-   * The datastructure for storing our cache hierachy, as per the current cache
-   * configuration.
+   * @brief m_tags
+   * Packed cache state. The state of a way is stored in parallel arrays, with
+   * way @p w of line @p l at index wayIndex(l, w). The dirty blocks of each way
+   * are stored as a bitmask of m_dirtyBlockWords words.
+   */
+  std::vector<VInt> m_tags;
+  std::vector<unsigned> m_lrus;
+  std::vector<uint8_t> m_valid;
+  std::vector<uint8_t> m_dirty;
+  std::vector<uint64_t> m_dirtyBlocks;
+  unsigned m_dirtyBlockWords = 0;
+  // Whether each way holds an unaccessed prefetched block, and the cycle in
+  // which its prefetch fill completes.
+  std::vector<uint8_t> m_prefetched;
+  std::vector<unsigned> m_prefetchReady;
+
+  /**
+   * @brief m_replState
+   * Packed per-line replacement state of the PLRU, FIFO and SRRIP policies,
+   * m_replWords words per line. No field straddles a word boundary.
+   * - PLRU: a binary tree of getWays() - 1 bits in heap order, where each bit
+   *   points towards the pseudo least recently used half of its subtree.
+   * - FIFO: a getWaysBits() wide pointer to the oldest way.
+   * - SRRIP: a 2-bit re-reference prediction value (RRPV) per way.
+   */
+  std::vector<uint64_t> m_replState;
+  unsigned m_replWords = 0;
+  /// Replacement state of the lines accessed by the accesses in m_traceStack
+  /// which have savedReplState set, m_replWords words each, most recent first.
+  std::deque<uint64_t> m_replStack;
+
+  /**
+   * @brief m_victims
+   * Lines of the victim cache, most recently inserted first. Prior contents
+   * of the victim cache for the accesses in m_traceStack which have
+   * savedVictimState set are stored in m_victimStack, most recent first.
    */
-  std::map<unsigned, CacheLine> m_cacheLines;
+  struct VictimLine {
+    AInt address;
+    bool dirty;
+    std::vector<uint64_t> dirtyBlocks;
+  };
+  unsigned m_victimEntries = 0;
+  std::vector<VictimLine> m_victims;
+  std::deque<std::vector<VictimLine>> m_victimStack;
+
+  static constexpr unsigned s_rrpvBits = 2;
+  static constexpr unsigned s_rrpvMax = (1 << s_rrpvBits) - 1;
+  unsigned replStateBits() const;
+  unsigned replField(unsigned lineIdx, unsigned offset, unsigned width) const {
+    const uint64_t word = m_replState[lineIdx * m_replWords + offset / 64];
+    return (word >> (offset % 64)) & ((uint64_t(1) << width) - 1);
+  }
+  void setReplField(unsigned lineIdx, unsigned offset, unsigned width,
+                    unsigned value) {
+    uint64_t &word = m_replState[lineIdx * m_replWords + offset / 64];
+    const uint64_t mask = ((uint64_t(1) << width) - 1) << (offset % 64);
+    word = (word & ~mask) | ((static_cast<uint64_t>(value) << (offset % 64)) &
+                             mask);
+  }
+  void saveReplState(unsigned lineIdx);
+  void restoreReplState(unsigned lineIdx);
+
+  unsigned wayIndex(unsigned lineIdx, unsigned wayIdx) const {
+    return lineIdx * getWays() + wayIdx;
+  }
+  uint64_t *dirtyBlocksOf(unsigned idx) {
+    return &m_dirtyBlocks[idx * m_dirtyBlockWords];
+  }
+  const uint64_t *dirtyBlocksOf(unsigned idx) const {
+    return &m_dirtyBlocks[idx * m_dirtyBlockWords];
+  }
+  /// (Re)allocates the packed cache state for the current configuration, with
+  /// all ways invalid.
+  void resizeStorage();
+  void invalidateWay(unsigned idx);
+  WayState saveWay(unsigned idx) const;
+  void restoreWay(unsigned idx, const WayState &state);
 
-  void updateCacheLineReplFields(CacheLine &line, unsigned wayIdx);
+  /**
+   * @brief updateCacheLineReplFields
+   * Updates a cacheline's replacement fields upon an access to @p wayIdx.
+   * @p fill is true if the accessed block was just loaded into the way.
+   */
+  void updateCacheLineReplFields(unsigned lineIdx, unsigned wayIdx, bool fill);
   /**
    * @brief revertCacheLineReplFields
    * Called whenever undoing a transaction to the cache. Reverts a cacheline's
    * replacement fields according to the configured replacement policy.
    */
-  void revertCacheLineReplFields(CacheLine &line, const CacheWay &oldWay,
-                                 unsigned wayIdx);
+  void revertCacheLineReplFields(const CacheTrace &trace);
 
   /**
-   * @brief m_accessTrace
-   * The access trace stack contains cache access statistics for each simulation
-   * cycle. Contrary to the TraceStack (m_traceStack).
+   * @brief m_accessStats
+   * Exact cache access statistics of all accesses performed since reset.
    */
-  std::map<unsigned, CacheAccessTrace> m_accessTrace;
+  CacheAccessTrace m_accessStats;
+
+  /**
+   * @brief m_accessHistory
+   * Multi-resolution history of m_accessStats, for plotting. Each sample covers
+   * a bucket of 2^m_historyShift cycles, and holds the statistics as of the
+   * last access within the bucket. Once the history exceeds m_historyCapacity
+   * samples, the bucket size is doubled and adjacent samples are merged. As
+   * such, the history covers the entire execution in bounded memory, at a
+   * resolution which decreases with the length of the execution.
+   */
+  std::vector<AccessSample> m_accessHistory;
+  unsigned m_historyShift = 0;
+  size_t m_historyCapacity = 0;
 
   /**
    * @brief m_traceStack
@@ -311,6 +760,13 @@ private:
    */
   std::deque<CacheTrace> m_traceStack;
 
+  /**
+   * @brief m_evictionStack
+   * Prior state of each valid way which was evicted by an access in
+   * m_traceStack, most recent first.
+   */
+  std::deque<WayState> m_evictionStack;
+
   /**
    * @brief m_isResetting
    * The cacheSim can be reset by either internally modyfing cache configuration
@@ -322,12 +778,36 @@ private:
    */
   bool m_isResetting = false;
 
+  /**
+   * @brief m_runTransactions
+   * While running, transactions are queued by the simulator thread in
+   * m_runTransactions instead of being signalled, and delivered in batches
+   * through transactionsBatched when m_runDrainTimer times out.
+   */
+  static constexpr size_t s_runTransactionCapacity = 1 << 12;
+  SPSCRing<CacheTransaction> m_runTransactions{s_runTransactionCapacity};
+  QTimer m_runDrainTimer;
+  void drainRunTransactions();
+
   CacheTrace popTrace();
   void pushTrace(const CacheTrace &trace);
 };
 
 const static std::map<ReplPolicy, QString> s_cacheReplPolicyStrings{
-    {ReplPolicy::Random, "Random"}, {ReplPolicy::LRU, "LRU"}};
+    {ReplPolicy::Random, "Random"},
+    {ReplPolicy::LRU, "LRU"},
+    {ReplPolicy::PLRU, "Tree-PLRU"},
+    {ReplPolicy::FIFO, "FIFO"},
+    {ReplPolicy::SRRIP, "SRRIP"}};
+const static std::map<PrefetchPolicy, QString> s_cachePrefetchPolicyStrings{
+    {PrefetchPolicy::Disabled, "None"},
+    {PrefetchPolicy::NextLine, "Next-line"},
+    {PrefetchPolicy::Stride, "Stride"},
+    {PrefetchPolicy::Stream, "Stream"}};
+const static std::map<InclusionPolicy, QString> s_cacheInclusionPolicyStrings{
+    {InclusionPolicy::NINE, "NINE"},
+    {InclusionPolicy::Inclusive, "Inclusive"},
+    {InclusionPolicy::Exclusive, "Exclusive"}};
 const static std::map<WriteAllocPolicy, QString> s_cacheWriteAllocateStrings{
     {WriteAllocPolicy::WriteAllocate, "Write allocate"},
     {WriteAllocPolicy::NoWriteAllocate, "No write allocate"}};
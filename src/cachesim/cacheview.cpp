@@ -4,6 +4,8 @@
 #include <QWheelEvent>
 #include <qmath.h>
 
+#include "cachegraphic.h"
+
 namespace Ripes {
 
 CacheView::CacheView(QWidget *parent) : QGraphicsView(parent) {
@@ -36,6 +38,22 @@ void CacheView::mousePressEvent(QMouseEvent *event) {
 void CacheView::fitScene() {
   scene()->setSceneRect(scene()->itemsBoundingRect());
   fitInView(scene()->sceneRect(), Qt::KeepAspectRatio);
+  updateLevelOfDetail();
+}
+
+void CacheView::updateLevelOfDetail() {
+  if (!scene()) {
+    return;
+  }
+  const qreal lod = transform().m11();
+  for (auto *item : scene()->items()) {
+    if (item->parentItem()) {
+      continue;
+    }
+    if (auto *cacheGraphic = dynamic_cast<CacheGraphic *>(item)) {
+      cacheGraphic->setLevelOfDetail(lod);
+    }
+  }
 }
 
 void CacheView::wheelEvent(QWheelEvent *e) {
@@ -67,6 +85,7 @@ void CacheView::setupMatrix() {
   matrix.scale(scale, scale);
 
   setTransform(matrix);
+  updateLevelOfDetail();
 }
 
 } // namespace Ripes
@@ -25,6 +25,9 @@ private slots:
   void zoomOut(int level = 1);
 
 private:
+  /// Propagates the current scale of the view to all cache graphics.
+  void updateLevelOfDetail();
+
   qreal m_zoom;
 };
 
@@ -0,0 +1,68 @@
+#include "dramsim.h"
+#include "binutils.h"
+
+namespace Ripes {
+
+static constexpr AInt s_closedRow = static_cast<AInt>(-1);
+
+DRAMSim::DRAMSim(const Config &config, QObject *parent)
+    : CacheInterface(parent), m_config(config),
+      m_rowShift(log2Ceil(config.rowBytes)) {
+  closeRows();
+}
+
+unsigned DRAMSim::access(AInt address, MemoryAccess::Type type) {
+  // Rows are interleaved across banks, such that sequential accesses beyond a
+  // row proceed in the next bank.
+  const AInt rowIndex = address >> m_rowShift;
+  AInt &openRow = m_openRows[rowIndex & (m_config.banks - 1)];
+  const AInt row = rowIndex / m_config.banks;
+
+  unsigned latency = m_config.tCAS + m_config.tBurst;
+  if (openRow == row) {
+    m_stats.rowHits++;
+  } else if (openRow == s_closedRow) {
+    m_stats.rowMisses++;
+    latency += m_config.tRCD;
+  } else {
+    m_stats.rowConflicts++;
+    latency += m_config.tRP + m_config.tRCD;
+  }
+  openRow = row;
+
+  m_stats.latencyCycles += latency;
+  if (type == MemoryAccess::Write) {
+    m_stats.writes++;
+  } else {
+    m_stats.reads++;
+    m_stats.readLatencyCycles += latency;
+  }
+  return latency;
+}
+
+void DRAMSim::closeRows() { m_openRows.assign(m_config.banks, s_closedRow); }
+
+void DRAMSim::reset() {
+  closeRows();
+  m_stats = Stats();
+  CacheInterface::reset();
+}
+
+void DRAMSim::reverse() {
+  closeRows();
+  CacheInterface::reverse();
+}
+
+double DRAMSim::rowHitRate() const {
+  return m_stats.accesses() == 0
+             ? 0.0
+             : static_cast<double>(m_stats.rowHits) / m_stats.accesses();
+}
+
+double DRAMSim::averageLatency() const {
+  return m_stats.accesses() == 0
+             ? 0.0
+             : static_cast<double>(m_stats.latencyCycles) / m_stats.accesses();
+}
+
+} // namespace Ripes
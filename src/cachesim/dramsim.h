@@ -0,0 +1,77 @@
+#pragma once
+
+#include "cachesim.h"
+
+#include <vector>
+
+namespace Ripes {
+
+/**
+ * @brief The DRAMSim class
+ * A timing model of main memory, attached below the last level caches of a
+ * cache hierarchy. Memory is divided into banks of rows of rowBytes bytes,
+ * with consecutive rows interleaved across the banks. Each bank has a row
+ * buffer holding its open row, which is kept open after an access (open-page
+ * policy). An access to the open row of its bank is a row hit, taking tCAS
+ * cycles. An access to a bank without an open row activates the row, taking
+ * tRCD + tCAS cycles, whereas an access to another row than the open one
+ * (a row conflict) first precharges the bank, taking tRP + tRCD + tCAS
+ * cycles. Each access additionally takes tBurst cycles to transfer its data.
+ *
+ * Accesses are served in order, and do not overlap; bank-level parallelism and
+ * refresh are not modelled.
+ */
+class DRAMSim : public CacheInterface {
+  Q_OBJECT
+public:
+  struct Config {
+    // Number of banks; a power of two.
+    unsigned banks = 8;
+    // Size of a row in bytes; a power of two.
+    unsigned rowBytes = 2048;
+    // Timings in processor cycles.
+    unsigned tRCD = 14;
+    unsigned tCAS = 14;
+    unsigned tRP = 14;
+    unsigned tBurst = 4;
+  };
+
+  struct Stats {
+    unsigned long long reads = 0;
+    unsigned long long writes = 0;
+    unsigned long long rowHits = 0;
+    // Accesses to banks without an open row.
+    unsigned long long rowMisses = 0;
+    unsigned long long rowConflicts = 0;
+    // Latency in cycles of all accesses, and of reads.
+    unsigned long long latencyCycles = 0;
+    unsigned long long readLatencyCycles = 0;
+
+    unsigned long long accesses() const { return reads + writes; }
+  };
+
+  DRAMSim(const Config &config, QObject *parent);
+
+  unsigned access(AInt address, MemoryAccess::Type type) override;
+  void reset() override;
+  /// Reversal closes all rows; the statistics are kept.
+  void reverse() override;
+
+  const Config &config() const { return m_config; }
+  const Stats &stats() const { return m_stats; }
+  /// Fraction of accesses which hit the open row of their bank.
+  double rowHitRate() const;
+  /// Average latency of an access, in cycles.
+  double averageLatency() const;
+
+private:
+  void closeRows();
+
+  const Config m_config;
+  Stats m_stats;
+  unsigned m_rowShift = 0;
+  // The open row of each bank, or -1 if the bank is precharged.
+  std::vector<AInt> m_openRows;
+};
+
+} // namespace Ripes
@@ -0,0 +1,80 @@
+#include "fetchbuffer.h"
+
+namespace Ripes {
+
+// The widest instruction, such that a fetch at most this far past the latest
+// fetch continues a sequential run.
+static constexpr AInt s_maxInstrBytes = 4;
+
+FetchBuffer::FetchBuffer(const Config &config, QObject *parent)
+    : CacheInterface(parent), m_config(config) {}
+
+unsigned FetchBuffer::access(AInt address, MemoryAccess::Type type) {
+  if (type != MemoryAccess::Read) {
+    m_stats.cacheAccesses++;
+    return m_nextLevelCache->access(address, type);
+  }
+  m_stats.fetches++;
+
+  // Track runs of sequential fetches. Refetching the latest address (ie. after
+  // a flush) continues the run.
+  const bool sequential = m_fetched && address >= m_lastFetch &&
+                          address <= m_lastFetch + s_maxInstrBytes;
+  const bool backward = m_fetched && address < m_lastFetch;
+  if (m_loopValid && (address < m_loopStart || address > m_loopEnd))
+    m_loopValid = false;
+  if (!m_loopValid && backward && m_config.loopBytes > 0 &&
+      address >= m_runStart &&
+      m_lastFetch + s_maxInstrBytes - address <= m_config.loopBytes) {
+    m_loopValid = true;
+    m_loopStart = address;
+    m_loopEnd = m_lastFetch;
+    m_stats.loops++;
+  }
+  if (!sequential && !m_loopValid)
+    m_runStart = address;
+  m_fetched = true;
+  m_lastFetch = address;
+
+  if (m_loopValid) {
+    m_stats.loopBufferHits++;
+    return 1;
+  }
+  const AInt block = address & ~static_cast<AInt>(m_config.blockBytes - 1);
+  if (m_blockValid && block == m_block) {
+    m_stats.fetchBufferHits++;
+    return 1;
+  }
+  m_blockValid = true;
+  m_block = block;
+  m_stats.cacheAccesses++;
+  const unsigned latency = m_nextLevelCache->access(block, type);
+  if (latency > 1)
+    m_stats.bubbleCycles += latency - 1;
+  return latency;
+}
+
+void FetchBuffer::clear() {
+  m_blockValid = false;
+  m_fetched = false;
+  m_loopValid = false;
+}
+
+void FetchBuffer::reset() {
+  clear();
+  m_stats = Stats();
+  CacheInterface::reset();
+}
+
+void FetchBuffer::reverse() {
+  clear();
+  CacheInterface::reverse();
+}
+
+double FetchBuffer::loopBufferHitRate() const {
+  return m_stats.fetches == 0 ? 0.0
+                              : static_cast<double>(m_stats.loopBufferHits) /
+                                    m_stats.fetches;
+}
+
+} // namespace Ripes
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "cachesim.h"
+
+namespace Ripes {
+
+/**
+ * @brief The FetchBuffer class
+ * A fetch buffer with a loop buffer, in front of the instruction side of the
+ * cache hierarchy. Instructions are fetched from the next level in aligned
+ * blocks of blockBytes bytes, such that sequential fetches within the block
+ * last fetched are served by the fetch buffer.
+ *
+ * The loop buffer captures loops of at most loopBytes bytes: a backward
+ * transfer of control to an address which was fetched sequentially since the
+ * last non-sequential fetch (ie. the loop body was just fetched in full) locks
+ * the body, from the target to the latest fetch, into the loop buffer. Fetches
+ * within the body are then served by the loop buffer until a fetch leaves it.
+ * Fetches served by either buffer take a single cycle and do not access the
+ * cache hierarchy.
+ *
+ * Fetch bubbles are the cycles, in excess of the first, of fetches served by
+ * the cache hierarchy; with cache timing enabled, these stall the processor.
+ */
+class FetchBuffer : public CacheInterface {
+  Q_OBJECT
+public:
+  struct Config {
+    // Bytes fetched from the next level at a time; a power of two.
+    unsigned blockBytes = 16;
+    // Capacity of the loop buffer in bytes, or 0 for no loop buffer.
+    unsigned loopBytes = 64;
+  };
+
+  struct Stats {
+    unsigned long long fetches = 0;
+    unsigned long long fetchBufferHits = 0;
+    unsigned long long loopBufferHits = 0;
+    // Fetches (and other accesses) forwarded to the next level.
+    unsigned long long cacheAccesses = 0;
+    unsigned long long bubbleCycles = 0;
+    // Loops captured by the loop buffer.
+    unsigned long long loops = 0;
+  };
+
+  FetchBuffer(const Config &config, QObject *parent);
+
+  unsigned access(AInt address, MemoryAccess::Type type) override;
+  void reset() override;
+  /// Reversal empties the buffers, such that subsequent fetches refill them
+  /// from the next level; the statistics are kept.
+  void reverse() override;
+
+  const Config &config() const { return m_config; }
+  const Stats &stats() const { return m_stats; }
+  /// Fraction of fetches served by the loop buffer.
+  double loopBufferHitRate() const;
+
+private:
+  void clear();
+
+  const Config m_config;
+  Stats m_stats;
+
+  bool m_blockValid = false;
+  AInt m_block = 0;
+  // The latest fetch, and the start of the run of sequential fetches ending
+  // with it.
+  bool m_fetched = false;
+  AInt m_lastFetch = 0;
+  AInt m_runStart = 0;
+  // The loop body held by the loop buffer, [m_loopStart; m_loopEnd].
+  bool m_loopValid = false;
+  AInt m_loopStart = 0;
+  AInt m_loopEnd = 0;
+};
+
+} // namespace Ripes
@@ -17,14 +17,17 @@ L1CacheShim::L1CacheShim(CacheType type, QObject *parent)
           &L1CacheShim::processorWasClocked, Qt::DirectConnection);
   connect(ProcessorHandler::get(), &ProcessorHandler::processorReversed, this,
           &L1CacheShim::processorReversed);
+  connect(ProcessorHandler::get(), &ProcessorHandler::fastForwardClocked, this,
+          &L1CacheShim::fastForwardWasClocked, Qt::DirectConnection);
 
   processorReset();
 }
 
-void L1CacheShim::access(AInt, MemoryAccess::Type) {
+unsigned L1CacheShim::access(AInt, MemoryAccess::Type) {
   // Should never occur; the shim determines accesses based on investigating the
   // associated memory.
   Q_ASSERT(false);
+  return 0;
 }
 
 void L1CacheShim::processorReset() {
@@ -45,6 +48,12 @@ void L1CacheShim::processorReversed() {
 }
 
 void L1CacheShim::processorWasClocked() {
+  // The memory accesses of a stall cycle were performed in the cycle which
+  // initiated the stall.
+  if (ProcessorHandler::getProcessor()->isStalled())
+    return;
+
+  unsigned latency = 0;
   if (m_type == CacheType::DataCache) {
     const auto dataAccess = ProcessorHandler::getProcessor()->dataMemAccess();
 
@@ -52,10 +61,12 @@ void L1CacheShim::processorWasClocked() {
     // if so, the access type.
     switch (dataAccess.type) {
     case MemoryAccess::Write:
-      m_nextLevelCache->access(dataAccess.address, MemoryAccess::Write);
+      latency =
+          m_nextLevelCache->access(dataAccess.address, MemoryAccess::Write);
       break;
     case MemoryAccess::Read:
-      m_nextLevelCache->access(dataAccess.address, MemoryAccess::Read);
+      latency =
+          m_nextLevelCache->access(dataAccess.address, MemoryAccess::Read);
       break;
     case MemoryAccess::None:
     default:
@@ -64,9 +75,24 @@ void L1CacheShim::processorWasClocked() {
   } else {
     const auto instrAccess = ProcessorHandler::getProcessor()->instrMemAccess();
     if (instrAccess.type == MemoryAccess::Read) {
-      m_nextLevelCache->access(instrAccess.address, MemoryAccess::Read);
+      latency =
+          m_nextLevelCache->access(instrAccess.address, MemoryAccess::Read);
     }
   }
+
+  // The processor models assume single-cycle memories.
+  if (m_timingEnabled && latency > 1)
+    ProcessorHandler::getProcessorNonConst()->stallForMemory(latency - 1);
+}
+
+void L1CacheShim::fastForwardWasClocked() {
+  if (!m_nextLevelCache)
+    return;
+  const auto *proc = ProcessorHandler::getProcessor();
+  const auto access = m_type == CacheType::DataCache ? proc->dataMemAccess()
+                                                     : proc->instrMemAccess();
+  if (access.type != MemoryAccess::None)
+    m_nextLevelCache->warm(access.address, access.type);
 }
 
 } // namespace Ripes
@@ -19,14 +19,24 @@ class L1CacheShim : public CacheInterface {
 public:
   enum class CacheType { DataCache, InstrCache };
   L1CacheShim(CacheType type, QObject *parent);
-  void access(AInt address, MemoryAccess::Type type) override;
+  unsigned access(AInt address, MemoryAccess::Type type) override;
 
   void setType(CacheType type);
 
+  /**
+   * @brief setTimingEnabled
+   * If enabled, the processor is stalled for the latency of each access to the
+   * cache hierarchy, in excess of a single cycle.
+   */
+  void setTimingEnabled(bool enabled) { m_timingEnabled = enabled; }
+
 private:
   void processorReset();
   void processorWasClocked();
   void processorReversed();
+  /// Warms the cache hierarchy with the accesses of the instruction which was
+  /// just fast-forwarded.
+  void fastForwardWasClocked();
 
   /**
    * @brief m_memory
@@ -35,6 +45,7 @@ private:
    * the given type of the memory.
    */
   CacheType m_type;
+  bool m_timingEnabled = false;
 };
 
 } // namespace Ripes
@@ -0,0 +1,108 @@
+#include "memoryaccesstrace.h"
+
+#include "processorhandler.h"
+
+#include <QDataStream>
+#include <QFile>
+
+namespace Ripes {
+
+static constexpr quint32 s_traceMagic = 0x524d4154; // "RMAT"
+static constexpr quint32 s_traceVersion = 1;
+
+// Flags byte layout.
+static constexpr uint8_t s_streamBit = 1 << 0;
+static constexpr uint8_t s_writeBit = 1 << 1;
+
+static uint64_t zigzagEncode(int64_t v) {
+  return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+static int64_t zigzagDecode(uint64_t v) {
+  return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+void MemoryAccessTrace::writeVarint(uint64_t value) {
+  while (value >= 0x80) {
+    m_data.push_back(static_cast<uint8_t>(value) | 0x80);
+    value >>= 7;
+  }
+  m_data.push_back(static_cast<uint8_t>(value));
+}
+
+void MemoryAccessTrace::append(const Entry &entry) {
+  const unsigned streamIdx = static_cast<unsigned>(entry.stream);
+  uint8_t flags = streamIdx ? s_streamBit : 0;
+  if (entry.type == MemoryAccess::Write)
+    flags |= s_writeBit;
+  m_data.push_back(flags);
+  writeVarint(entry.cycle - m_cycle);
+  writeVarint(zigzagEncode(static_cast<int64_t>(
+      entry.address - m_lastAddress[streamIdx])));
+  m_cycle = entry.cycle;
+  m_lastAddress[streamIdx] = entry.address;
+  m_entries++;
+}
+
+void MemoryAccessTrace::clear() {
+  m_data.clear();
+  m_entries = 0;
+  m_cycle = 0;
+  m_lastAddress[0] = m_lastAddress[1] = 0;
+}
+
+uint64_t MemoryAccessTrace::Reader::readVarint() {
+  uint64_t value = 0;
+  for (unsigned shift = 0; m_pos < m_trace.m_data.size(); shift += 7) {
+    const uint8_t byte = m_trace.m_data[m_pos++];
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80))
+      break;
+  }
+  return value;
+}
+
+bool MemoryAccessTrace::Reader::next(Entry &entry) {
+  if (m_pos >= m_trace.m_data.size())
+    return false;
+  const uint8_t flags = m_trace.m_data[m_pos++];
+  const unsigned streamIdx = flags & s_streamBit ? 1 : 0;
+  m_cycle += readVarint();
+  m_lastAddress[streamIdx] += zigzagDecode(readVarint());
+
+  entry.cycle = m_cycle;
+  entry.address = m_lastAddress[streamIdx];
+  entry.stream = static_cast<Stream>(streamIdx);
+  entry.type = flags & s_writeBit ? MemoryAccess::Write : MemoryAccess::Read;
+  return true;
+}
+
+QString MemoryAccessTrace::save(const QString &path) const {
+  QFile file(path);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    return "Error: Could not open trace file " + path;
+  QDataStream stream(&file);
+  const QByteArray data = QByteArray::fromRawData(
+      reinterpret_cast<const char *>(m_data.data()),
+      static_cast<int>(m_data.size()));
+  stream << s_traceMagic << s_traceVersion << static_cast<quint64>(m_entries)
+         << data;
+  return QString();
+}
+
+unsigned AccessTraceRecorder::access(AInt address, MemoryAccess::Type type) {
+  MemoryAccessTrace::Entry entry;
+  entry.cycle = ProcessorHandler::getProcessor()->getCycleCount();
+  entry.address = address;
+  entry.stream = m_stream;
+  entry.type = type;
+  m_trace->append(entry);
+  return 0;
+}
+
+void AccessTraceRecorder::reset() {
+  m_trace->clear();
+  CacheInterface::reset();
+}
+
+} // namespace Ripes
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QString>
+
+#include <memory>
+#include <vector>
+
+#include "cachesim.h"
+
+namespace Ripes {
+
+/**
+ * @brief The MemoryAccessTrace class
+ * A compact, append-only recording of the instruction and data memory access
+ * streams of a processor. Each access is encoded as a flags byte followed by
+ * the LEB128 encoded cycle delta and zigzag encoded address delta, relative to
+ * the previous access of the same stream. Sequential instruction fetches and
+ * strided data accesses thus typically require 3 bytes per access.
+ */
+class MemoryAccessTrace {
+public:
+  enum class Stream : uint8_t { Instr = 0, Data = 1 };
+
+  struct Entry {
+    unsigned cycle = 0;
+    AInt address = 0;
+    Stream stream = Stream::Data;
+    MemoryAccess::Type type = MemoryAccess::Read;
+  };
+
+  /**
+   * @brief The Reader class
+   * Sequentially decodes the entries of a trace.
+   */
+  class Reader {
+  public:
+    explicit Reader(const MemoryAccessTrace &trace) : m_trace(trace) {}
+    /// Decodes the next entry into @p entry. Returns false at the end of the
+    /// trace.
+    bool next(Entry &entry);
+
+  private:
+    uint64_t readVarint();
+
+    const MemoryAccessTrace &m_trace;
+    size_t m_pos = 0;
+    unsigned m_cycle = 0;
+    AInt m_lastAddress[2] = {0, 0};
+  };
+
+  void append(const Entry &entry);
+  void clear();
+
+  size_t size() const { return m_entries; }
+  size_t bytes() const { return m_data.size(); }
+
+  /// Writes the trace to the file at @p path. The file holds a magic number
+  /// ("RMAT"), the format version, the number of entries and the encoded
+  /// entries, as serialized by QDataStream. Returns an error message on
+  /// failure, or an empty string on success.
+  QString save(const QString &path) const;
+
+private:
+  void writeVarint(uint64_t value);
+
+  std::vector<uint8_t> m_data;
+  size_t m_entries = 0;
+  unsigned m_cycle = 0;
+  AInt m_lastAddress[2] = {0, 0};
+};
+
+/**
+ * @brief The AccessTraceRecorder class
+ * A cache interface which records all accesses of a given stream into a
+ * MemoryAccessTrace, ie. when attached to an L1CacheShim. The trace is cleared
+ * when the cache hierarchy is reset. Reversing is not supported; reversed
+ * accesses remain in the trace.
+ */
+class AccessTraceRecorder : public CacheInterface {
+  Q_OBJECT
+public:
+  AccessTraceRecorder(std::shared_ptr<MemoryAccessTrace> trace,
+                      MemoryAccessTrace::Stream stream, QObject *parent)
+      : CacheInterface(parent), m_trace(trace), m_stream(stream) {}
+
+  unsigned access(AInt address, MemoryAccess::Type type) override;
+  void reset() override;
+
+private:
+  std::shared_ptr<MemoryAccessTrace> m_trace;
+  MemoryAccessTrace::Stream m_stream;
+};
+
+} // namespace Ripes
@@ -0,0 +1,109 @@
+#include "plotdecimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Ripes {
+
+PlotDecimator::Bucket PlotDecimator::leaf(int idx, const QPointF &point) {
+  return {idx, idx, 1, point.x(), point.y()};
+}
+
+PlotDecimator::Bucket PlotDecimator::merge(const Bucket &lhs,
+                                           const Bucket &rhs) const {
+  Bucket merged;
+  merged.minIdx = m_points[rhs.minIdx].y() < m_points[lhs.minIdx].y()
+                      ? rhs.minIdx
+                      : lhs.minIdx;
+  merged.maxIdx = m_points[rhs.maxIdx].y() > m_points[lhs.maxIdx].y()
+                      ? rhs.maxIdx
+                      : lhs.maxIdx;
+  merged.count = lhs.count + rhs.count;
+  merged.sumX = lhs.sumX + rhs.sumX;
+  merged.sumY = lhs.sumY + rhs.sumY;
+  return merged;
+}
+
+void PlotDecimator::append(const QPointF &point) {
+  Q_ASSERT((m_points.empty() || point.x() >= m_points.back().x()) &&
+           "Points must be appended in order");
+  const int idx = size();
+  m_points.push_back(point);
+
+  // Complete the bucket of each level which this point is the last point of.
+  Bucket current = leaf(idx, point);
+  unsigned level = 0;
+  for (int i = idx; i & 1; i >>= 1, ++level) {
+    current = merge(bucket(level, i - 1), current);
+    if (m_levels.size() <= level)
+      m_levels.emplace_back();
+    m_levels[level].push_back(current);
+  }
+}
+
+void PlotDecimator::clear() {
+  m_points.clear();
+  m_levels.clear();
+}
+
+PlotDecimator::Bucket PlotDecimator::bucket(unsigned level, int i) const {
+  if (level == 0)
+    return leaf(i, m_points[i]);
+  const auto &complete = m_levels[level - 1];
+  if (i < static_cast<int>(complete.size()))
+    return complete[i];
+
+  // Partial bucket at the end of the series.
+  Bucket partial = bucket(level - 1, 2 * i);
+  if (((2 * i + 1) << (level - 1)) < size())
+    partial = merge(partial, bucket(level - 1, 2 * i + 1));
+  return partial;
+}
+
+QVector<QPointF> PlotDecimator::decimate(int target) const {
+  const int n = size();
+  if (n <= target)
+    return QVector<QPointF>(m_points.begin(), m_points.end());
+
+  // Select the finest pyramid level for which the buckets, plus the first and
+  // last points, fit within the target.
+  const int maxBuckets = std::max(target, 3) - 2;
+  unsigned level = 0;
+  while (((n - 1) >> level) + 1 > maxBuckets)
+    level++;
+  const int nBuckets = ((n - 1) >> level) + 1;
+
+  const auto area = [](const QPointF &a, const QPointF &b, const QPointF &c) {
+    return std::abs((a.x() - c.x()) * (b.y() - a.y()) -
+                    (a.x() - b.x()) * (c.y() - a.y()));
+  };
+
+  QVector<QPointF> points;
+  points.reserve(nBuckets + 2);
+  points << m_points.front();
+  int prevIdx = 0;
+  Bucket current = bucket(level, 0);
+  for (int b = 0; b < nBuckets; ++b) {
+    QPointF nextAvg = m_points.back();
+    Bucket next = current;
+    if (b + 1 < nBuckets) {
+      next = bucket(level, b + 1);
+      nextAvg = QPointF(next.sumX / next.count, next.sumY / next.count);
+    }
+
+    const QPointF &prev = m_points[prevIdx];
+    const int idx = area(prev, m_points[current.maxIdx], nextAvg) >
+                            area(prev, m_points[current.minIdx], nextAvg)
+                        ? current.maxIdx
+                        : current.minIdx;
+    if (idx > prevIdx && idx < n - 1) {
+      points << m_points[idx];
+      prevIdx = idx;
+    }
+    current = next;
+  }
+  points << m_points.back();
+  return points;
+}
+
+} // namespace Ripes
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QPointF>
+#include <QVector>
+
+#include <vector>
+
+namespace Ripes {
+
+/**
+ * @brief The PlotDecimator class
+ * An append-only series of points, sorted by x, which may be decimated to a
+ * bounded number of points for plotting. Points are summarized in a min/max
+ * pyramid, where level k holds, for each aligned bucket of 2^k points, the
+ * indices of its minimum and maximum points as well as the sum of its points.
+ * Appending a point is amortized O(1).
+ *
+ * Decimation follows the largest-triangle-three-buckets (LTTB) algorithm; the
+ * series is split into buckets of a pyramid level, and each bucket is
+ * represented by the point forming the largest triangle with the previously
+ * selected point and the average of the following bucket. Candidates are
+ * limited to the minimum and maximum of each bucket, such that decimation is
+ * O(target) regardless of the length of the series, and local extremes are
+ * preserved.
+ */
+class PlotDecimator {
+public:
+  void append(const QPointF &point);
+  void clear();
+
+  int size() const { return static_cast<int>(m_points.size()); }
+  bool empty() const { return m_points.empty(); }
+  const QPointF &at(int i) const { return m_points.at(i); }
+  const QPointF &last() const { return m_points.back(); }
+
+  /// Returns at most @p target points (and at least 3) representing the
+  /// series. The first and last points of the series are always retained.
+  QVector<QPointF> decimate(int target) const;
+
+private:
+  struct Bucket {
+    int minIdx;
+    int maxIdx;
+    int count;
+    double sumX;
+    double sumY;
+  };
+
+  static Bucket leaf(int idx, const QPointF &point);
+  Bucket merge(const Bucket &lhs, const Bucket &rhs) const;
+  /// Returns the bucket holding points [2^level * i, 2^level * (i + 1)), which
+  /// may be partial if it is the last bucket of the level.
+  Bucket bucket(unsigned level, int i) const;
+
+  std::vector<QPointF> m_points;
+  // m_levels[k] holds the complete buckets of 2^(k+1) points.
+  std::vector<std::vector<Bucket>> m_levels;
+};
+
+} // namespace Ripes
@@ -0,0 +1,123 @@
+#include "prefetcher.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace Ripes {
+
+std::unique_ptr<Prefetcher> Prefetcher::create(PrefetchPolicy policy,
+                                               unsigned blockBits) {
+  switch (policy) {
+  case PrefetchPolicy::Disabled:
+    return nullptr;
+  case PrefetchPolicy::NextLine:
+    return std::make_unique<NextLinePrefetcher>(blockBits);
+  case PrefetchPolicy::Stride:
+    return std::make_unique<StridePrefetcher>(blockBits);
+  case PrefetchPolicy::Stream:
+    return std::make_unique<StreamPrefetcher>(blockBits);
+  }
+  Q_UNREACHABLE();
+}
+
+void NextLinePrefetcher::observe(AInt address, bool,
+                                 std::vector<AInt> &prefetches) {
+  const AInt block = blockOf(address);
+  if (block == m_lastBlock)
+    return;
+  m_lastBlock = block;
+  prefetches.push_back(addressOf(block + 1));
+}
+
+void StridePrefetcher::reset() { m_table.fill(Entry()); }
+
+void StridePrefetcher::observe(AInt address, bool,
+                               std::vector<AInt> &prefetches) {
+  const AInt region = address >> s_regionBits;
+  Entry &entry = m_table[region % s_entries];
+  if (entry.region != region) {
+    entry = Entry();
+    entry.region = region;
+    entry.lastAddress = address;
+    return;
+  }
+
+  const AIntS stride = static_cast<AIntS>(address - entry.lastAddress);
+  entry.lastAddress = address;
+  if (stride == 0)
+    return;
+  if (stride == entry.stride) {
+    entry.confidence = std::min(entry.confidence + 1, 3u);
+  } else {
+    // Keep a confident stride through a single irregular access.
+    if (entry.confidence > 0)
+      entry.confidence--;
+    if (entry.confidence == 0)
+      entry.stride = stride;
+    return;
+  }
+
+  if (entry.confidence < 2)
+    return;
+  AInt lastBlock = blockOf(address);
+  for (unsigned i = 1; i <= s_degree; ++i) {
+    const AInt target = address + static_cast<AInt>(stride) * i;
+    if (blockOf(target) == lastBlock)
+      continue;
+    lastBlock = blockOf(target);
+    prefetches.push_back(addressOf(lastBlock));
+  }
+}
+
+void StreamPrefetcher::reset() {
+  m_streams.fill(Stream());
+  m_time = 0;
+}
+
+void StreamPrefetcher::observe(AInt address, bool,
+                               std::vector<AInt> &prefetches) {
+  const AInt block = blockOf(address);
+  m_time++;
+
+  Stream *match = nullptr;
+  for (auto &stream : m_streams) {
+    if (!stream.valid)
+      continue;
+    if (block == stream.lastBlock)
+      return;
+    const AIntS delta = static_cast<AIntS>(block - stream.lastBlock);
+    const AIntS ahead = stream.direction == 0 ? std::abs(delta)
+                                              : delta * stream.direction;
+    if (ahead > 0 && ahead <= static_cast<AIntS>(s_window)) {
+      match = &stream;
+      if (stream.direction == 0)
+        stream.direction = delta > 0 ? 1 : -1;
+      break;
+    }
+  }
+
+  if (!match) {
+    // Allocate a new stream in place of the least recently used stream.
+    Stream *victim = &m_streams[0];
+    for (auto &stream : m_streams) {
+      if (!stream.valid || stream.lastUse < victim->lastUse) {
+        victim = &stream;
+        if (!stream.valid)
+          break;
+      }
+    }
+    *victim = Stream();
+    victim->valid = true;
+    victim->lastBlock = block;
+    victim->lastUse = m_time;
+    return;
+  }
+
+  match->lastBlock = block;
+  match->lastUse = m_time;
+  for (unsigned i = 1; i <= s_degree; ++i)
+    prefetches.push_back(
+        addressOf(block + static_cast<AInt>(match->direction * AIntS(i))));
+}
+
+} // namespace Ripes
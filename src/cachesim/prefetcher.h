@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "cachesim.h"
+
+namespace Ripes {
+
+/**
+ * @brief The Prefetcher class
+ * A hardware prefetcher model in front of a cache. The prefetcher observes the
+ * demand accesses to the cache, and requests blocks to be prefetched into the
+ * cache. Accesses carry no program counter, so all prefetchers are trained on
+ * the address stream alone.
+ */
+class Prefetcher {
+public:
+  /// Prefetches at a granularity of 2^@p blockBits bytes.
+  explicit Prefetcher(unsigned blockBits) : m_blockBits(blockBits) {}
+  virtual ~Prefetcher() {}
+
+  /// Observes a demand access to @p address, which hit in the cache if @p hit.
+  /// Appends the addresses of the blocks to prefetch to @p prefetches.
+  virtual void observe(AInt address, bool hit,
+                       std::vector<AInt> &prefetches) = 0;
+  virtual void reset() = 0;
+
+  /// Returns a prefetcher implementing @p policy, or nullptr if prefetching is
+  /// disabled.
+  static std::unique_ptr<Prefetcher> create(PrefetchPolicy policy,
+                                            unsigned blockBits);
+
+protected:
+  AInt blockOf(AInt address) const { return address >> m_blockBits; }
+  AInt addressOf(AInt block) const { return block << m_blockBits; }
+
+  unsigned m_blockBits;
+};
+
+/**
+ * @brief The NextLinePrefetcher class
+ * Prefetches the next sequential block whenever a new block is accessed.
+ */
+class NextLinePrefetcher : public Prefetcher {
+public:
+  using Prefetcher::Prefetcher;
+  void observe(AInt address, bool hit, std::vector<AInt> &prefetches) override;
+  void reset() override { m_lastBlock = -1; }
+
+private:
+  AInt m_lastBlock = -1;
+};
+
+/**
+ * @brief The StridePrefetcher class
+ * A reference prediction table (RPT) stride prefetcher. In lieu of a program
+ * counter, the table is indexed by the 2^s_regionBits byte memory region of
+ * the access. Each entry holds the last address and stride seen within its
+ * region, and a saturating confidence counter. Once the stride of a region has
+ * repeated, the next s_degree strides are prefetched.
+ */
+class StridePrefetcher : public Prefetcher {
+public:
+  static constexpr unsigned s_entries = 16;
+  static constexpr unsigned s_regionBits = 12;
+  static constexpr unsigned s_degree = 2;
+
+  using Prefetcher::Prefetcher;
+  void observe(AInt address, bool hit, std::vector<AInt> &prefetches) override;
+  void reset() override;
+
+private:
+  struct Entry {
+    AInt region = -1;
+    AInt lastAddress = 0;
+    AIntS stride = 0;
+    unsigned confidence = 0;
+  };
+  std::array<Entry, s_entries> m_table;
+};
+
+/**
+ * @brief The StreamPrefetcher class
+ * Tracks up to s_streams sequential streams of block accesses, in either
+ * direction. An access within s_window blocks ahead of a stream advances the
+ * stream and, once its direction is established, prefetches the following
+ * s_degree blocks of the stream. Accesses matching no stream allocate a new
+ * stream, replacing the least recently advanced stream.
+ */
+class StreamPrefetcher : public Prefetcher {
+public:
+  static constexpr unsigned s_streams = 4;
+  static constexpr unsigned s_window = 4;
+  static constexpr unsigned s_degree = 4;
+
+  using Prefetcher::Prefetcher;
+  void observe(AInt address, bool hit, std::vector<AInt> &prefetches) override;
+  void reset() override;
+
+private:
+  struct Stream {
+    AInt lastBlock = -1;
+    int direction = 0;
+    unsigned lastUse = 0;
+    bool valid = false;
+  };
+  std::array<Stream, s_streams> m_streams;
+  unsigned m_time = 0;
+};
+
+} // namespace Ripes
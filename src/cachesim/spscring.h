@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+namespace Ripes {
+
+/**
+ * @brief The SPSCRing class
+ * A bounded, lock-free ring buffer for passing values from a single producer
+ * thread to a single consumer thread. The capacity is rounded up to a power of
+ * two. Values pushed while the ring is full are dropped.
+ */
+template <typename T>
+class SPSCRing {
+public:
+  explicit SPSCRing(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity)
+      size <<= 1;
+    m_buffer.resize(size);
+    m_mask = size - 1;
+  }
+
+  /// Producer side. Returns false if the ring was full and @p value was
+  /// dropped.
+  bool push(const T &value) {
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) > m_mask)
+      return false;
+    m_buffer[head & m_mask] = value;
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Consumer side. Appends all available values to @p values.
+  void drain(std::vector<T> &values) {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    const size_t head = m_head.load(std::memory_order_acquire);
+    for (; tail != head; ++tail)
+      values.push_back(m_buffer[tail & m_mask]);
+    m_tail.store(tail, std::memory_order_release);
+  }
+
+  /// Discards all values. Must only be called while neither side is active.
+  void clear() {
+    m_head.store(0);
+    m_tail.store(0);
+  }
+
+private:
+  std::vector<T> m_buffer;
+  size_t m_mask = 0;
+  std::atomic<size_t> m_head{0};
+  std::atomic<size_t> m_tail{0};
+};
+
+} // namespace Ripes
@@ -0,0 +1,141 @@
+#include "stackdistanceprofiler.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+static constexpr unsigned s_maxWays = 1 << StackDistanceProfiler::s_maxWayBits;
+
+void ReuseDistanceTracker::reset() {
+  m_lastAccess.clear();
+  m_tree.clear();
+  m_time = 0;
+}
+
+long long ReuseDistanceTracker::prefixSum(size_t t) const {
+  long long sum = 0;
+  for (size_t i = t + 1; i > 0; i -= i & (~i + 1))
+    sum += m_tree[i];
+  return sum;
+}
+
+void ReuseDistanceTracker::update(size_t t, int delta) {
+  for (size_t i = t + 1; i < m_tree.size(); i += i & (~i + 1))
+    m_tree[i] += delta;
+}
+
+void ReuseDistanceTracker::compact() {
+  std::vector<std::pair<size_t, AInt>> byTime;
+  byTime.reserve(m_lastAccess.size());
+  for (const auto &it : m_lastAccess)
+    byTime.push_back({it.second, it.first});
+  std::sort(byTime.begin(), byTime.end());
+
+  const size_t capacity = std::max<size_t>(1024, 2 * byTime.size());
+  m_tree.assign(capacity + 1, 0);
+  for (size_t t = 0; t < byTime.size(); ++t) {
+    m_lastAccess[byTime[t].second] = t;
+    update(t, 1);
+  }
+  m_time = byTime.size();
+}
+
+long long ReuseDistanceTracker::access(AInt block) {
+  // The number of blocks whose most recent access lies between the previous
+  // and current access to this block.
+  if (m_time + 1 >= m_tree.size())
+    compact();
+  long long distance = s_cold;
+  auto it = m_lastAccess.find(block);
+  if (it != m_lastAccess.end()) {
+    const size_t prev = it->second;
+    distance = prefixSum(m_time - 1) - prefixSum(prev);
+    update(prev, -1);
+    it->second = m_time;
+  } else {
+    m_lastAccess[block] = m_time;
+  }
+  update(m_time, 1);
+  m_time++;
+  return distance;
+}
+
+StackDistanceProfiler::StackDistanceProfiler(unsigned blockBits)
+    : m_blockBits(blockBits) {
+  reset();
+}
+
+void StackDistanceProfiler::reset() {
+  m_accesses = 0;
+  m_reuse.reset();
+  m_distances.fill(0);
+  m_compulsoryMisses = 0;
+  for (unsigned s = 0; s <= s_maxSetBits; ++s) {
+    auto &sets = m_sets.at(s);
+    sets.blocks.assign((1 << s) * s_maxWays, 0);
+    sets.sizes.assign(1 << s, 0);
+    sets.depths.fill(0);
+  }
+}
+
+void StackDistanceProfiler::access(AInt address) {
+  const AInt block = address >> m_blockBits;
+  m_accesses++;
+
+  // Fully associative stack distance.
+  const long long distance = m_reuse.access(block);
+  if (distance == ReuseDistanceTracker::s_cold)
+    m_compulsoryMisses++;
+  else
+    m_distances[ReuseDistanceTracker::bucket(distance)]++;
+
+  // Set associative stack distances.
+  for (unsigned s = 0; s <= s_maxSetBits; ++s) {
+    auto &sets = m_sets[s];
+    const unsigned set = block & ((AInt(1) << s) - 1);
+    AInt *stack = &sets.blocks[set * s_maxWays];
+    unsigned &size = sets.sizes[set];
+
+    unsigned depth = 0;
+    while (depth < size && stack[depth] != block)
+      depth++;
+    if (depth < size) {
+      sets.depths[depth]++;
+    } else {
+      sets.depths[s_maxWays]++;
+      size = std::min(size + 1, s_maxWays);
+      depth = size - 1;
+    }
+    // Move the block to the top of the stack.
+    std::copy_backward(stack, stack + depth, stack + depth + 1);
+    stack[0] = block;
+  }
+}
+
+unsigned long long
+StackDistanceProfiler::fullyAssociativeMisses(unsigned capacityBits) const {
+  unsigned long long hits = 0;
+  for (unsigned b = 0; b <= capacityBits && b < m_distances.size(); ++b)
+    hits += m_distances[b];
+  return m_accesses - hits;
+}
+
+unsigned StackDistanceProfiler::maxCapacityBits() const {
+  unsigned bits = 0;
+  for (unsigned b = 0; b < m_distances.size(); ++b)
+    if (m_distances[b] != 0)
+      bits = b;
+  return bits;
+}
+
+unsigned long long StackDistanceProfiler::misses(unsigned setBits,
+                                                 unsigned wayBits) const {
+  Q_ASSERT(setBits <= s_maxSetBits && wayBits <= s_maxWayBits);
+  const auto &depths = m_sets.at(setBits).depths;
+  unsigned long long hits = 0;
+  for (unsigned d = 0; d < (1u << wayBits); ++d)
+    hits += depths[d];
+  return m_accesses - hits;
+}
+
+} // namespace Ripes
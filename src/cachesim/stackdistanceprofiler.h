@@ -0,0 +1,144 @@
+#pragma once
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+#include "cachesim.h"
+
+namespace Ripes {
+
+/**
+ * @brief The ReuseDistanceTracker class
+ * Computes the reuse distance of each access of a stream of blocks: the number
+ * of distinct blocks accessed since the previous access to the same block.
+ * Distances are computed exactly, in O(log n) per access, using a Fenwick tree
+ * over the most recent access time of each block.
+ */
+class ReuseDistanceTracker {
+public:
+  /// The distance of the first access to a block.
+  static constexpr long long s_cold = -1;
+  /// The number of buckets of a histogram of distances (see bucket()).
+  static constexpr unsigned s_buckets = 66;
+
+  ReuseDistanceTracker() { reset(); }
+
+  /// Records an access to @p block. Returns its reuse distance, or s_cold if
+  /// the block was not accessed before.
+  long long access(AInt block);
+  void reset();
+
+  /// Returns the histogram bucket of distance @p distance; bucket 0 holds
+  /// d = 0, bucket b > 0 holds 2^(b-1) <= d < 2^b.
+  static unsigned bucket(unsigned long long distance) {
+    unsigned bucket = 0;
+    for (; distance != 0; distance >>= 1)
+      bucket++;
+    return bucket;
+  }
+
+private:
+  /// Returns the number of live timestamps in [0, t].
+  long long prefixSum(size_t t) const;
+  void update(size_t t, int delta);
+  /// Renumbers the access timestamps, such that they are dense.
+  void compact();
+
+  // m_lastAccess maps each block to the time of its most recent access.
+  // m_tree is a Fenwick tree marking the times which are the most recent
+  // access of some block.
+  std::unordered_map<AInt, size_t> m_lastAccess;
+  std::vector<int> m_tree;
+  size_t m_time = 0;
+};
+
+/**
+ * @brief The StackDistanceProfiler class
+ * Single-pass Mattson stack distance profiling of an access stream. For each
+ * access, the stack distance is the number of distinct blocks accessed since
+ * the previous access to the same block. An LRU cache of N blocks hits exactly
+ * those accesses with a stack distance less than N, which allows for deriving
+ * the miss rate of all cache sizes from a single pass.
+ *
+ * Fully associative distances are computed exactly (see
+ * ReuseDistanceTracker). Set associative distances are computed for up to
+ * 2^s_maxSetBits sets and 2^s_maxWayBits ways, by maintaining an LRU stack for
+ * each set of each set count.
+ */
+class StackDistanceProfiler {
+public:
+  static constexpr unsigned s_maxSetBits = 10;
+  static constexpr unsigned s_maxWayBits = 4;
+
+  /// Profiles accesses at a granularity of 2^@p blockBits bytes.
+  explicit StackDistanceProfiler(unsigned blockBits);
+
+  void access(AInt address);
+  void reset();
+
+  unsigned blockBits() const { return m_blockBits; }
+  unsigned long long accesses() const { return m_accesses; }
+
+  /// Returns the misses of a fully associative LRU cache of 2^@p capacityBits
+  /// blocks.
+  unsigned long long fullyAssociativeMisses(unsigned capacityBits) const;
+  /// Returns the smallest capacity (in log2 blocks) for which a fully
+  /// associative cache incurs only compulsory misses.
+  unsigned maxCapacityBits() const;
+
+  /// Returns the misses of an LRU cache of 2^@p setBits sets with 2^@p wayBits
+  /// ways.
+  unsigned long long misses(unsigned setBits, unsigned wayBits) const;
+
+private:
+  unsigned m_blockBits;
+  unsigned long long m_accesses = 0;
+
+  // Fully associative profiling.
+  ReuseDistanceTracker m_reuse;
+  // Histogram of stack distances (see ReuseDistanceTracker::bucket()).
+  std::array<unsigned long long, ReuseDistanceTracker::s_buckets>
+      m_distances{};
+  unsigned long long m_compulsoryMisses = 0;
+
+  // Set associative profiling, per set count.
+  struct SetStacks {
+    // MRU-ordered blocks of each set, 2^s_maxWayBits entries per set.
+    std::vector<AInt> blocks;
+    std::vector<unsigned> sizes;
+    // Hits per stack depth; the final entry counts accesses which were not
+    // found within the stack.
+    std::array<unsigned long long, (1 << s_maxWayBits) + 1> depths{};
+  };
+  std::array<SetStacks, s_maxSetBits + 1> m_sets;
+};
+
+/**
+ * @brief The StackDistanceRecorder class
+ * A cache interface which feeds all accesses into a StackDistanceProfiler, ie.
+ * when attached to an L1CacheShim. The profile is cleared when the cache
+ * hierarchy is reset.
+ */
+class StackDistanceRecorder : public CacheInterface {
+  Q_OBJECT
+public:
+  StackDistanceRecorder(unsigned blockBits, QObject *parent)
+      : CacheInterface(parent), m_profiler(blockBits) {}
+
+  unsigned access(AInt address, MemoryAccess::Type) override {
+    m_profiler.access(address);
+    return 0;
+  }
+  void reset() override {
+    m_profiler.reset();
+    CacheInterface::reset();
+  }
+
+  const StackDistanceProfiler &profiler() const { return m_profiler; }
+
+private:
+  StackDistanceProfiler m_profiler;
+};
+
+} // namespace Ripes
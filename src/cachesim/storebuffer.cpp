@@ -0,0 +1,132 @@
+#include "storebuffer.h"
+
+#include "processorhandler.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+StoreBuffer::StoreBuffer(const Config &config, QObject *parent)
+    : CacheInterface(parent), m_config(config),
+      m_wordMask(ProcessorHandler::currentISA()->bytes() - 1) {}
+
+unsigned StoreBuffer::access(AInt address, MemoryAccess::Type type) {
+  const long long now = ProcessorHandler::getProcessor()->getCycleCount();
+  advance(now);
+  const AInt word = address & ~m_wordMask;
+  const bool buffered =
+      std::find(m_entries.begin(), m_entries.end(), word) != m_entries.end();
+
+  if (type == MemoryAccess::Read) {
+    m_stats.loads++;
+    if (buffered) {
+      m_stats.forwards++;
+      return 1;
+    }
+    // The load is served once any store being written completes.
+    const long long wait = std::max(m_portFree - now, 0LL);
+    m_stats.loadWaitCycles += wait;
+    const unsigned latency = m_nextLevelCache->access(address, type);
+    m_portFree = now + wait + latency;
+    return static_cast<unsigned>(wait) + latency;
+  }
+
+  m_stats.stores++;
+  if (buffered) {
+    m_stats.merges++;
+    return 1;
+  }
+  // Wait for an entry to be freed.
+  long long cycle = now;
+  while (occupancy(cycle) >= m_config.entries) {
+    cycle = std::max(cycle, m_draining ? m_drainDone : m_portFree);
+    advance(cycle);
+  }
+  m_entries.push_back(word);
+  m_stats.maxOccupancy = std::max(m_stats.maxOccupancy, occupancy(cycle));
+  advance(cycle);
+
+  const long long stall = cycle - now;
+  m_stats.fullStallCycles += stall;
+  return 1 + static_cast<unsigned>(stall);
+}
+
+void StoreBuffer::advance(long long now) {
+  if (!m_synced) {
+    m_synced = true;
+    m_accounted = now;
+    m_portFree = now;
+  }
+
+  while (true) {
+    if (m_draining) {
+      if (m_drainDone > now)
+        break;
+      accountUntil(m_drainDone);
+      m_draining = false;
+    }
+    if (m_entries.empty())
+      break;
+    if (m_config.drain == DrainPolicy::Lazy &&
+        m_entries.size() < m_config.entries)
+      break;
+    const long long start = std::max(m_portFree, m_accounted);
+    if (start > now)
+      break;
+    accountUntil(start);
+    drainOldest(start);
+  }
+  accountUntil(now);
+}
+
+void StoreBuffer::drainOldest(long long start) {
+  const AInt word = m_entries.front();
+  m_entries.pop_front();
+  m_stats.drains++;
+  const unsigned latency = m_nextLevelCache->access(word, MemoryAccess::Write);
+  m_draining = true;
+  m_drainDone = m_portFree = start + latency;
+}
+
+unsigned StoreBuffer::occupancy(long long cycle) const {
+  return m_entries.size() + (m_draining && cycle < m_drainDone ? 1 : 0);
+}
+
+void StoreBuffer::accountUntil(long long cycle) {
+  if (cycle <= m_accounted)
+    return;
+  m_stats.occupancyCycles += occupancy(m_accounted) * (cycle - m_accounted);
+  m_stats.cycles += cycle - m_accounted;
+  m_accounted = cycle;
+}
+
+void StoreBuffer::clear() {
+  m_entries.clear();
+  m_draining = false;
+  m_synced = false;
+}
+
+void StoreBuffer::reset() {
+  clear();
+  m_stats = Stats();
+  CacheInterface::reset();
+}
+
+void StoreBuffer::reverse() {
+  clear();
+  CacheInterface::reverse();
+}
+
+double StoreBuffer::averageOccupancy() const {
+  return m_stats.cycles == 0 ? 0.0
+                             : static_cast<double>(m_stats.occupancyCycles) /
+                                   m_stats.cycles;
+}
+
+double StoreBuffer::forwardRate() const {
+  return m_stats.loads == 0
+             ? 0.0
+             : static_cast<double>(m_stats.forwards) / m_stats.loads;
+}
+
+} // namespace Ripes
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "cachesim.h"
+
+#include <deque>
+
+namespace Ripes {
+
+/**
+ * @brief The StoreBuffer class
+ * A store buffer between the memory stage of the processor and the data side
+ * of the cache hierarchy. Stores enter the buffer in a single cycle, and are
+ * written to the next level in order, one at a time, as the data cache port
+ * allows. A store stalls the processor only if the buffer is full, until the
+ * oldest store has been written. A store to a word already held by the buffer
+ * is merged into its entry.
+ *
+ * Loads of a word held by the buffer are forwarded from it in a single cycle.
+ * Other loads access the next level, after any store being written completes;
+ * loads take priority over the stores waiting in the buffer.
+ *
+ * The drain policy determines when stores are written: eagerly, whenever the
+ * port is free, or lazily, only once the buffer is full. Forwarding and
+ * merging are tracked at the granularity of the ISA word. Stores left in the
+ * buffer at the end of a run are not written.
+ */
+class StoreBuffer : public CacheInterface {
+  Q_OBJECT
+public:
+  enum class DrainPolicy { Eager, Lazy };
+
+  struct Config {
+    // Number of stores held by the buffer.
+    unsigned entries = 4;
+    DrainPolicy drain = DrainPolicy::Eager;
+  };
+
+  struct Stats {
+    unsigned long long stores = 0;
+    unsigned long long loads = 0;
+    // Loads served by the buffer.
+    unsigned long long forwards = 0;
+    // Stores merged into an entry of the buffer.
+    unsigned long long merges = 0;
+    // Stores written to the next level.
+    unsigned long long drains = 0;
+    // Cycles stores waited on a full buffer, and loads on a store being
+    // written.
+    unsigned long long fullStallCycles = 0;
+    unsigned long long loadWaitCycles = 0;
+    // Occupancy of the buffer, summed over the cycles up until the latest
+    // access.
+    unsigned long long occupancyCycles = 0;
+    unsigned long long cycles = 0;
+    unsigned maxOccupancy = 0;
+  };
+
+  StoreBuffer(const Config &config, QObject *parent);
+
+  unsigned access(AInt address, MemoryAccess::Type type) override;
+  void reset() override;
+  /// Reversal empties the buffer, without writing its stores; the statistics
+  /// are kept.
+  void reverse() override;
+
+  const Config &config() const { return m_config; }
+  const Stats &stats() const { return m_stats; }
+  /// Average number of stores held by the buffer per cycle.
+  double averageOccupancy() const;
+  /// Fraction of loads served by the buffer.
+  double forwardRate() const;
+
+private:
+  void clear();
+  /// Advances the buffer to cycle @p now, writing the stores due by then.
+  void advance(long long now);
+  /// Writes the oldest store in the buffer, starting at cycle @p start.
+  void drainOldest(long long start);
+  /// Number of stores held by the buffer at cycle @p cycle, including any
+  /// store being written.
+  unsigned occupancy(long long cycle) const;
+  void accountUntil(long long cycle);
+
+  const Config m_config;
+  Stats m_stats;
+  AInt m_wordMask = 0;
+
+  // Words held by the buffer, oldest first.
+  std::deque<AInt> m_entries;
+  // Whether a store is being written, completing at m_drainDone, and the cycle
+  // at which the data cache port is free (after any load being served).
+  bool m_draining = false;
+  long long m_drainDone = 0;
+  long long m_portFree = 0;
+  // Cycle up until which the occupancy has been accounted, once the buffer has
+  // observed the cycle count of the processor.
+  bool m_synced = false;
+  long long m_accounted = 0;
+};
+
+} // namespace Ripes
@@ -0,0 +1,126 @@
+#include "tlbsim.h"
+
+#include "processorhandler.h"
+
+#include <cstdlib>
+
+namespace Ripes {
+
+// Page tables, and base pages, span 4 KiB in both Sv32 and Sv39.
+static constexpr unsigned s_pageOffsetBits = 12;
+
+TLBSim::TLBSim(const Config &config, QObject *parent)
+    : CacheInterface(parent), m_config(config) {
+  if (ProcessorHandler::currentISA()->bits() == 32) {
+    m_levels = 2;
+    m_vpnBits = 10;
+    m_pteBytes = 4;
+  } else {
+    m_levels = 3;
+    m_vpnBits = 9;
+    m_pteBytes = 8;
+  }
+  m_pageShift = s_pageOffsetBits + m_config.pageLevel * m_vpnBits;
+  m_sets = m_config.entries / m_config.ways;
+  m_tags.resize(m_config.entries);
+  m_stamps.resize(m_config.entries);
+  flush();
+}
+
+QString TLBSim::scheme() const { return m_levels == 2 ? "Sv32" : "Sv39"; }
+
+unsigned TLBSim::access(AInt address, MemoryAccess::Type type) {
+  const AInt vpn = address >> m_pageShift;
+  const unsigned base = (vpn % m_sets) * m_config.ways;
+  m_time++;
+
+  unsigned latency = 0;
+  unsigned way = m_config.ways;
+  for (unsigned i = 0; i < m_config.ways; ++i) {
+    if (m_valid[base + i] && m_tags[base + i] == vpn) {
+      way = i;
+      break;
+    }
+  }
+
+  if (way != m_config.ways) {
+    m_stats.hits++;
+    if (m_config.repl == ReplPolicy::LRU)
+      m_stamps[base + way] = m_time;
+  } else {
+    m_stats.misses++;
+    latency += walk(vpn);
+
+    // Fill an invalid entry, or evict as per the replacement policy.
+    for (unsigned i = 0; i < m_config.ways && way == m_config.ways; ++i)
+      if (!m_valid[base + i])
+        way = i;
+    if (way == m_config.ways) {
+      if (m_config.repl == ReplPolicy::Random) {
+        way = std::rand() % m_config.ways;
+      } else {
+        way = 0;
+        for (unsigned i = 1; i < m_config.ways; ++i)
+          if (m_stamps[base + i] < m_stamps[base + way])
+            way = i;
+      }
+    }
+    m_valid[base + way] = true;
+    m_tags[base + way] = vpn;
+    m_stamps[base + way] = m_time;
+  }
+
+  return latency + m_nextLevelCache->access(address, type);
+}
+
+unsigned TLBSim::walk(AInt vpn) {
+  const AInt indexMask = (AInt(1) << m_vpnBits) - 1;
+  // The virtual page number in units of base pages, within the virtual
+  // address space of the scheme.
+  const AInt basePage = (vpn << (m_config.pageLevel * m_vpnBits)) &
+                        ((AInt(1) << (m_levels * m_vpnBits)) - 1);
+
+  unsigned latency = 0;
+  // Tables preceding those of the current level.
+  AInt tables = 0;
+  for (int level = m_levels - 1; level >= static_cast<int>(m_config.pageLevel);
+       --level) {
+    const unsigned prefixBits = (m_levels - 1 - level) * m_vpnBits;
+    const AInt table = tables + (basePage >> ((level + 1) * m_vpnBits));
+    const AInt index = (basePage >> (level * m_vpnBits)) & indexMask;
+    const AInt pte = m_config.rootTable + (table << s_pageOffsetBits) +
+                     index * m_pteBytes;
+    tables += AInt(1) << prefixBits;
+
+    const unsigned pteLatency =
+        m_walkCache ? m_walkCache->access(pte, MemoryAccess::Read)
+                    : m_walkLatency;
+    m_stats.walkAccesses++;
+    latency += pteLatency;
+  }
+  m_stats.walkCycles += latency;
+  return latency;
+}
+
+void TLBSim::flush() {
+  m_valid.assign(m_config.entries, false);
+  m_time = 0;
+}
+
+void TLBSim::reset() {
+  flush();
+  m_stats = Stats();
+  CacheInterface::reset();
+}
+
+void TLBSim::reverse() {
+  flush();
+  CacheInterface::reverse();
+}
+
+double TLBSim::hitRate() const {
+  const auto accesses = m_stats.hits + m_stats.misses;
+  return accesses == 0 ? 0.0 : static_cast<double>(m_stats.hits) / accesses;
+}
+
+} // namespace Ripes
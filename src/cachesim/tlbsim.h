@@ -0,0 +1,102 @@
+#pragma once
+
+#include "cachesim.h"
+
+#include <vector>
+
+namespace Ripes {
+
+/**
+ * @brief The TLBSim class
+ * A TLB reach estimator in front of a side of the cache hierarchy. The
+ * processor models implement neither supervisor mode nor satp, so no address
+ * translation takes place: accesses keep their address, and the TLB estimates
+ * the cost that translating them would have under an identity mapping of
+ * memory through RISC-V page tables (Sv32 for RV32, and Sv39 for RV64).
+ *
+ * All memory is mapped by pages of a single size, which may be a superpage
+ * (ie. megapages or gigapages). The page tables are laid out from the root
+ * table onwards, with the tables of each level following those of the level
+ * above it, ordered by the virtual page number prefix which they map. A TLB
+ * miss walks the page tables from the root table to the leaf entry, reading
+ * one page table entry per level through the walk cache (ie. the data side
+ * of the cache hierarchy); superpages skip the lower levels. A TLB hit takes
+ * no additional cycles, whereas a miss takes the latency of its walk. The
+ * page tables are not stored in memory; only their accesses are simulated.
+ */
+class TLBSim : public CacheInterface {
+  Q_OBJECT
+public:
+  struct Config {
+    unsigned entries = 32;
+    unsigned ways = 4;
+    ReplPolicy repl = ReplPolicy::LRU;
+    // Level of the leaf page table entries: 0 for 4 KiB pages, 1 for
+    // megapages (4 MiB in Sv32, 2 MiB in Sv39) and 2 for Sv39 gigapages.
+    unsigned pageLevel = 0;
+    // Physical address of the root page table.
+    AInt rootTable = 0xC0000000;
+  };
+
+  struct Stats {
+    unsigned long long hits = 0;
+    unsigned long long misses = 0;
+    // Page table entries read by page walks, and the cycles spent reading
+    // them.
+    unsigned long long walkAccesses = 0;
+    unsigned long long walkCycles = 0;
+  };
+
+  TLBSim(const Config &config, QObject *parent);
+
+  unsigned access(AInt address, MemoryAccess::Type type) override;
+  void reset() override;
+  /// Reversal flushes the TLB; the statistics are kept.
+  void reverse() override;
+
+  /**
+   * @brief setWalkCache
+   * Sets the cache hierarchy level serving the page table entry reads of page
+   * walks. Without a walk cache, each read takes @p latency cycles.
+   */
+  void setWalkCache(const std::shared_ptr<CacheInterface> &cache,
+                    unsigned latency) {
+    m_walkCache = cache;
+    m_walkLatency = latency;
+  }
+
+  const Config &config() const { return m_config; }
+  const Stats &stats() const { return m_stats; }
+  /// Name of the estimated translation scheme, ie. "Sv39".
+  QString scheme() const;
+  /// Bytes of memory mapped by a page.
+  AInt pageBytes() const { return AInt(1) << m_pageShift; }
+  /// Fraction of accesses which hit in the TLB.
+  double hitRate() const;
+
+private:
+  void flush();
+  /// Walks the page tables for virtual page number @p vpn of the leaf level.
+  /// Returns the latency of the walk.
+  unsigned walk(AInt vpn);
+
+  const Config m_config;
+  Stats m_stats;
+  std::shared_ptr<CacheInterface> m_walkCache;
+  unsigned m_walkLatency = 0;
+
+  // Page table geometry of the translation scheme.
+  unsigned m_levels = 0;
+  unsigned m_vpnBits = 0;
+  unsigned m_pteBytes = 0;
+  unsigned m_pageShift = 0;
+
+  unsigned m_sets = 0;
+  std::vector<AInt> m_tags;
+  std::vector<bool> m_valid;
+  // Last use (LRU) or fill (FIFO) of each entry.
+  std::vector<unsigned long long> m_stamps;
+  unsigned long long m_time = 0;
+};
+
+} // namespace Ripes
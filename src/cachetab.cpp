@@ -47,6 +47,14 @@ void CacheTab::tabVisibilityChanged(bool visible) {
   }
 }
 
+std::vector<CachePreset> CacheTab::l1Configurations() const {
+  return m_ui->cacheTabWidget->l1Configurations();
+}
+
+void CacheTab::setL1Configurations(const std::vector<CachePreset> &presets) {
+  m_ui->cacheTabWidget->setL1Configurations(presets);
+}
+
 CacheTab::~CacheTab() { delete m_ui; }
 
 } // namespace Ripes
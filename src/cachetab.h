@@ -3,8 +3,11 @@
 #include "ripestab.h"
 #include <QWidget>
 
+#include "cachesim/cachesim.h"
 #include "ripes_types.h"
 
+#include <vector>
+
 namespace Ripes {
 
 namespace Ui {
@@ -20,6 +23,11 @@ public:
 
   void tabVisibilityChanged(bool visible) override;
 
+  /// Returns the configurations of the L1 data and instruction caches, in that
+  /// order.
+  std::vector<CachePreset> l1Configurations() const;
+  void setL1Configurations(const std::vector<CachePreset> &presets);
+
 signals:
   void focusAddressChanged(Ripes::AInt address);
 
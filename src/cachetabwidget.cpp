@@ -5,6 +5,7 @@
 #include "memoryviewerwidget.h"
 #include "ripessettings.h"
 
+#include <QLabel>
 #include <QTabBar>
 #include <QWheelEvent>
 
@@ -28,6 +29,20 @@ void CacheTabWidget::flipTabs() {
   m_ui->tabWidget->setCurrentIndex(0);
 }
 
+std::vector<CachePreset> CacheTabWidget::l1Configurations() const {
+  return {m_ui->dataCacheWidget->getCacheSim()->getPreset(),
+          m_ui->instructionCacheWidget->getCacheSim()->getPreset()};
+}
+
+void CacheTabWidget::setL1Configurations(
+    const std::vector<CachePreset> &presets) {
+  if (presets.size() > DataCache)
+    m_ui->dataCacheWidget->getCacheSim()->setPreset(presets.at(DataCache));
+  if (presets.size() > InstrCache)
+    m_ui->instructionCacheWidget->getCacheSim()->setPreset(
+        presets.at(InstrCache));
+}
+
 CacheTabWidget::CacheTabWidget(QWidget *parent)
     : QWidget(parent), m_ui(new Ui::CacheTabWidget) {
   m_ui->setupUi(this);
@@ -40,6 +55,19 @@ CacheTabWidget::CacheTabWidget(QWidget *parent)
   m_l1dShim->setNextLevelCache(m_ui->dataCacheWidget->getCacheSim());
   m_l1iShim->setNextLevelCache(m_ui->instructionCacheWidget->getCacheSim());
 
+  const auto setTiming = [=](bool enabled) {
+    m_l1dShim->setTimingEnabled(enabled);
+    m_l1iShim->setTimingEnabled(enabled);
+  };
+  setTiming(RipesSettings::value(RIPES_SETTING_CACHE_TIMING).toBool());
+  connect(RipesSettings::getObserver(RIPES_SETTING_CACHE_TIMING),
+          &SettingObserver::modified, this, [=](const QVariant &enabled) {
+            setTiming(enabled.toBool());
+            // Cycle counts are only consistent if timing is enabled from the
+            // start of execution.
+            RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+          });
+
 #ifdef N_CACHES_ENABLED
   m_addTabIdx = m_ui->tabWidget->addTab(new QLabel("Placeholder"),
                                         QIcon((":/icons/plus.svg")), QString());
@@ -91,6 +119,18 @@ void CacheTabWidget::handleTabCloseRequest(int index) {
   }
   m_nextCacheLevel--;
   m_ui->tabWidget->setTabText(m_addTabIdx, QString());
+
+  // Detach the removed cache level from the hierarchy
+  Q_ASSERT(!m_sharedLevels.empty());
+  m_sharedLevels.back()->deleteLater();
+  m_sharedLevels.pop_back();
+  if (m_sharedLevels.empty()) {
+    m_ui->dataCacheWidget->setNextLevelCache(nullptr);
+    m_ui->instructionCacheWidget->setNextLevelCache(nullptr);
+  } else {
+    m_sharedLevels.back()->setNextLevelCache(nullptr);
+  }
+  RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
 }
 
 void CacheTabWidget::handleTabIndexChanged(int index) {
@@ -101,6 +141,18 @@ void CacheTabWidget::handleTabIndexChanged(int index) {
                                QString("L%1 Cache").arg(m_nextCacheLevel));
     m_nextCacheLevel++;
 
+    // The new cache is the last level cache; misses and writebacks of the
+    // level above it are forwarded to it. The L2 cache is shared between the
+    // L1 instruction and data caches.
+    if (m_sharedLevels.empty()) {
+      m_ui->dataCacheWidget->setNextLevelCache(cw->getCacheSim());
+      m_ui->instructionCacheWidget->setNextLevelCache(cw->getCacheSim());
+    } else {
+      m_sharedLevels.back()->setNextLevelCache(cw->getCacheSim());
+    }
+    m_sharedLevels.push_back(cw);
+    RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+
     // The new cache is the deleteable cache, the one below it is thus no longer
     // deleteable
     m_ui->tabWidget->tabBar()
@@ -114,6 +166,10 @@ void CacheTabWidget::handleTabIndexChanged(int index) {
   }
 
   // Locate cacheWidget for the current index
+  if (auto *cw = dynamic_cast<CacheWidget *>(m_ui->tabWidget->widget(index))) {
+    emit cacheFocusChanged(cw);
+    return;
+  }
   for (const auto &ch : m_ui->tabWidget->widget(index)->children()) {
     auto *cw = dynamic_cast<CacheWidget *>(ch);
     if (cw) {
@@ -3,7 +3,7 @@
 
 #include "cachesim/l1cacheshim.h"
 
-// #define N_CACHES_ENABLED
+#define N_CACHES_ENABLED
 
 namespace Ripes {
 class CacheWidget;
@@ -26,6 +26,13 @@ public:
    */
   void flipTabs();
 
+  /// Returns the configurations of the L1 data and instruction caches, in that
+  /// order.
+  std::vector<CachePreset> l1Configurations() const;
+  /// Configures the L1 data and instruction caches by @p presets, as returned
+  /// by l1Configurations().
+  void setL1Configurations(const std::vector<CachePreset> &presets);
+
 signals:
   void focusAddressChanged(unsigned address);
   void cacheFocusChanged(Ripes::CacheWidget *cacheInFocus);
@@ -44,6 +51,10 @@ private:
 
   std::unique_ptr<L1CacheShim> m_l1dShim;
   std::unique_ptr<L1CacheShim> m_l1iShim;
+
+  // Cache levels below the L1 caches, shared between the instruction and data
+  // caches, ordered by level.
+  std::vector<CacheWidget *> m_sharedLevels;
 };
 
 } // namespace Ripes
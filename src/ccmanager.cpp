@@ -6,10 +6,14 @@
 #include "ripessettings.h"
 #include "utilities/systemutils.h"
 
+#include <QCryptographicHash>
+#include <QDateTime>
 #include <QProcess>
 #include <QProgressDialog>
 #include <QTextDocument>
 
+#include <algorithm>
+
 namespace Ripes {
 
 const static std::vector<QString> s_validAutodetectedCCs = {
@@ -17,6 +21,9 @@ const static std::vector<QString> s_validAutodetectedCCs = {
     "riscv64-unknown-elf-c++"};
 const static QString s_testprogram = "int main() { return 0; }";
 
+// Bound on the total size of the compiled files cached in memory.
+constexpr int s_maxCompiledCostKiB = 16 * 1024;
+
 QString indentString(const QString &string, int indent) {
   auto subStrings = string.split("\n");
   auto indentedStrings = QStringList();
@@ -43,6 +50,8 @@ QString CCManager::CompileError::toString(const CompileCommand &cc) const {
 }
 
 CCManager::CCManager() {
+  m_compiled.setMaxCost(s_maxCompiledCostKiB);
+
   if (RipesSettings::value(RIPES_SETTING_CCPATH) == "") {
     // No previous compiler path has been set. Try to autodetect a valid
     // compiler within the current path
@@ -81,8 +90,7 @@ bool CCManager::trySetCC(const QString &CC) {
   return res.success;
 }
 
-CCManager::CCRes CCManager::compileRaw(const QString &rawsource,
-                                       QString outname, bool showProgressdiag) {
+QStringList CCManager::writeSource(const QString &rawsource) {
   // Write program to temporary file with a .c extension
   if (!(m_tmpSrcFile && (QFile::exists(m_tmpSrcFile->fileName())))) {
     const auto tempFileTemplate =
@@ -109,8 +117,12 @@ CCManager::CCRes CCManager::compileRaw(const QString &rawsource,
   if (!peripheralSymbolsHeader.isEmpty()) {
     sourceFiles << peripheralSymbolsHeader;
   }
+  return sourceFiles;
+}
 
-  return compile(sourceFiles, outname, showProgressdiag);
+CCManager::CCRes CCManager::compileRaw(const QString &rawsource,
+                                       QString outname, bool showProgressdiag) {
+  return compile(writeSource(rawsource), outname, showProgressdiag);
 }
 
 CCManager::CCRes CCManager::compile(const QTextDocument *source,
@@ -183,6 +195,141 @@ CCManager::CCRes CCManager::compile(const QStringList &files, QString outname,
   return res;
 }
 
+void CCManager::compileAsync(const QTextDocument *source, CompileCallback done,
+                             QString outname, bool showProgressdiag) {
+  compileAsync(writeSource(source->toPlainText()), done, outname,
+               showProgressdiag);
+}
+
+void CCManager::compileAsync(const QStringList &files, CompileCallback done,
+                             QString outname, bool showProgressdiag) {
+  abort();
+
+  CCRes res;
+  if (outname.isEmpty()) {
+    // Cleaning the result of an aborted compilation must not remove the output
+    // of a later compilation, so each compilation has an output file of its
+    // own.
+    QTemporaryFile outFile(QDir::tempPath() + QDir::separator() +
+                           QCoreApplication::applicationName() + ".XXXXXX.out");
+    outFile.setAutoRemove(false);
+    if (outFile.open())
+      outname = outFile.fileName();
+  }
+  QFile::remove(outname);
+
+  res.inFiles = files;
+  res.outFile = outname;
+  res.cc = createCompileCommand(files, outname);
+
+  const QString key = compileKey(res.cc, files, outname);
+  const QByteArray *elf = key.isEmpty() ? nullptr : m_compiled.object(key);
+  if (elf) {
+    QFile outFile(outname);
+    if (outFile.open(QIODevice::WriteOnly) &&
+        outFile.write(*elf) == elf->size()) {
+      outFile.close();
+      res.success = true;
+      done(res);
+      return;
+    }
+  }
+
+  auto *process = new QProcess(this);
+  auto aborted = std::make_shared<bool>(false);
+  m_asyncProcess = process;
+  m_asyncAborted = aborted;
+
+  QPointer<QProgressDialog> progressDiag;
+  if (showProgressdiag) {
+    // The dialog is modeless, such that the UI remains live while compiling.
+    progressDiag =
+        new QProgressDialog("Executing compiler...", "Abort", 0, 0, nullptr);
+    progressDiag->setAttribute(Qt::WA_DeleteOnClose);
+    connect(progressDiag, &QProgressDialog::canceled, process, [=] {
+      if (m_asyncProcess == process)
+        abort();
+    });
+    progressDiag->show();
+  }
+
+  const auto finished = [=] {
+    if (m_asyncProcess == process)
+      m_asyncProcess = nullptr;
+    if (progressDiag)
+      progressDiag->close();
+    process->deleteLater();
+
+    CCRes result = res;
+    result.aborted = *aborted;
+    if (!result.aborted) {
+      auto elfInfo = LoadDialog::validateELFFile(QFile(result.outFile));
+      result.success = elfInfo.valid;
+      result.errorOutput.errMsg = elfInfo.errorMessage;
+    }
+    result.errorOutput._stdout = QString(process->readAllStandardOutput());
+    result.errorOutput._stderr = QString(process->readAllStandardError());
+
+    if (result.success && !key.isEmpty()) {
+      QFile outFile(result.outFile);
+      if (outFile.open(QIODevice::ReadOnly)) {
+        auto *elf = new QByteArray(outFile.readAll());
+        m_compiled.insert(key, elf, std::max<int>(1, elf->size() / 1024));
+      }
+    }
+    done(result);
+  };
+  connect(process,
+          QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+          finished);
+  connect(process, &QProcess::errorOccurred, this,
+          [=](QProcess::ProcessError error) {
+            // A process which failed to start never finishes.
+            if (error == QProcess::FailedToStart)
+              finished();
+          });
+  process->setWorkingDirectory(res.cc.bin.absolutePath());
+  process->setProgram(res.cc.bin.absoluteFilePath());
+  process->setArguments(res.cc.args);
+  process->start();
+}
+
+void CCManager::abort() {
+  if (!m_asyncProcess)
+    return;
+  *m_asyncAborted = true;
+  m_asyncProcess->kill();
+  m_asyncProcess = nullptr;
+}
+
+QString CCManager::compileKey(const CompileCommand &cc,
+                              const QStringList &files,
+                              const QString &outname) const {
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  const auto addField = [&](const QByteArray &field) {
+    hash.addData(field);
+    hash.addData("\0", 1);
+  };
+  // An updated compiler may compile differently.
+  addField(cc.bin.absoluteFilePath().toUtf8());
+  addField(cc.bin.lastModified().toString(Qt::ISODateWithMs).toUtf8());
+  // The input files are keyed on their contents, and the output file is
+  // irrelevant.
+  for (const QString &arg : cc.args) {
+    if (arg == outname) {
+      addField("${output}");
+    } else if (files.contains(arg)) {
+      QFile file(arg);
+      if (!file.open(QIODevice::ReadOnly))
+        return QString();
+      addField(file.readAll());
+    } else {
+      addField(arg.toUtf8());
+    }
+  }
+  return hash.result().toHex();
+}
+
 QString CCManager::getError() { return get().m_process.readAllStandardError(); }
 
 static QStringList sanitizedArguments(const QString &args) {
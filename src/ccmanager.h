@@ -1,13 +1,17 @@
 #pragma once
 
+#include <QByteArray>
+#include <QCache>
 #include <QDir>
 #include <QFile>
 #include <QObject>
+#include <QPointer>
 #include <QProcess>
 #include <QString>
 
 QT_FORWARD_DECLARE_CLASS(QTextDocument)
 
+#include <functional>
 #include <memory>
 
 namespace Ripes {
@@ -42,7 +46,7 @@ public:
     bool success = false;
     bool aborted = false;
 
-    void clean() { QFile::remove(outFile); }
+    void clean() const { QFile::remove(outFile); }
   };
 
   static CCManager &get() {
@@ -69,6 +73,32 @@ public:
   CCRes compileRaw(const QString &rawsource, QString outname = QString(),
                    bool showProgressdiag = true);
 
+  using CompileCallback = std::function<void(const CCRes &res)>;
+
+  /**
+   * @brief compileAsync
+   * Starts compiling @p files, as compile() does, and returns immediately. @p
+   * done is executed in the GUI thread with the result once the compilation
+   * has finished. A compilation which is still running is aborted. If no @p
+   * outname has been provided, the output file is a temporary file unique to
+   * the compilation.
+   *
+   * Compiled files are cached, keyed on the contents of @p files, the
+   * compiler and the compile command (ie. the ISA and the CC and LD
+   * arguments). Recompiling an unchanged set of files returns the earlier
+   * result without executing the compiler. Headers included by @p files are
+   * not part of the key.
+   */
+  void compileAsync(const QStringList &files, CompileCallback done,
+                    QString outname = QString(), bool showProgressdiag = true);
+  void compileAsync(const QTextDocument *source, CompileCallback done,
+                    QString outname = QString(), bool showProgressdiag = true);
+
+  /// Aborts the running asynchronous compilation, if any. Its callback is
+  /// executed with an aborted result.
+  void abort();
+  bool isCompiling() const { return !m_asyncProcess.isNull(); }
+
   CompileCommand createCompileCommand(const QStringList &files,
                                       const QString &outname) const;
 
@@ -103,12 +133,36 @@ private:
    */
   CCRes verifyCC(const QString &CC);
 
+  /**
+   * @brief writeSource
+   * Writes @p rawsource to a temporary source file. @returns the files to
+   * compile for the source, ie. the source file and the header of the
+   * peripheral symbols, if available.
+   */
+  QStringList writeSource(const QString &rawsource);
+
+  /**
+   * @brief compileKey
+   * @returns the key of the compilation of @p files to @p outname through @p
+   * cc in the cache of compiled files, or an empty string if an input file
+   * could not be read.
+   */
+  QString compileKey(const CompileCommand &cc, const QStringList &files,
+                     const QString &outname) const;
+
   CCManager();
   QString m_currentCC;
   QProcess m_process;
   bool m_errored = false;
   bool m_aborted = false;
   std::unique_ptr<QFile> m_tmpSrcFile;
+
+  // The running asynchronous compilation, and whether it has been aborted.
+  QPointer<QProcess> m_asyncProcess;
+  std::shared_ptr<bool> m_asyncAborted;
+
+  // Compiled files; the cost of each is its size in KiB.
+  QCache<QString, QByteArray> m_compiled;
 };
 
 } // namespace Ripes
@@ -0,0 +1,64 @@
+#include "asyncfilewriter.h"
+
+namespace Ripes {
+
+QString AsyncFileWriter::open(const QString &path) {
+  close();
+  m_file.setFileName(path);
+  if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    return "Error: Could not open file " + path;
+  m_buffer.clear();
+  m_buffer.reserve(c_bufferSize + 256);
+  m_bytes = 0;
+  m_quit = false;
+  m_writeFailed = false;
+  m_thread = std::thread([this] { work(); });
+  return QString();
+}
+
+QString AsyncFileWriter::close() {
+  if (!isOpen())
+    return QString();
+  flush();
+  {
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_quit = true;
+  }
+  m_changed.notify_all();
+  m_thread.join();
+  m_file.close();
+  if (m_writeFailed)
+    return "Error: Could not write file " + m_file.fileName();
+  return QString();
+}
+
+void AsyncFileWriter::flush() {
+  if (m_buffer.isEmpty())
+    return;
+  {
+    std::unique_lock<std::mutex> lock(m_lock);
+    m_changed.wait(lock, [this] { return m_pending.size() < c_maxPending; });
+    m_pending.push_back(std::move(m_buffer));
+  }
+  m_changed.notify_all();
+  m_buffer = QByteArray();
+  m_buffer.reserve(c_bufferSize + 256);
+}
+
+void AsyncFileWriter::work() {
+  std::unique_lock<std::mutex> lock(m_lock);
+  while (true) {
+    m_changed.wait(lock, [this] { return m_quit || !m_pending.empty(); });
+    if (m_pending.empty())
+      return;
+    const QByteArray buffer = std::move(m_pending.front());
+    m_pending.pop_front();
+    lock.unlock();
+    m_changed.notify_all();
+    if (m_file.write(buffer) != buffer.size())
+      m_writeFailed = true;
+    lock.lock();
+  }
+}
+
+} // namespace Ripes
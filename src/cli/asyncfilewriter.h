@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace Ripes {
+
+/**
+ * @brief The AsyncFileWriter class
+ * Writes a stream of bytes to a file on a dedicated thread. Written bytes are
+ * buffered, and full buffers are handed to the writing thread, such that the
+ * simulation thread does not wait on the file system. At most c_maxPending
+ * buffers are queued; writing blocks once the file system falls further
+ * behind, bounding the memory held.
+ */
+class AsyncFileWriter {
+public:
+  static constexpr int c_bufferSize = 1 << 16;
+  static constexpr size_t c_maxPending = 8;
+
+  ~AsyncFileWriter() { close(); }
+
+  /// Opens the file at @p path. Returns an error message on failure, or an
+  /// empty string on success.
+  QString open(const QString &path);
+  /// Writes out all buffered bytes and closes the file. Returns an error
+  /// message if writing failed, or an empty string on success.
+  QString close();
+
+  bool isOpen() const { return m_thread.joinable(); }
+  QString fileName() const { return m_file.fileName(); }
+  /// The number of bytes written, including those still buffered.
+  unsigned long long bytes() const { return m_bytes; }
+
+  void write(const char *data, int size) {
+    m_buffer.append(data, size);
+    m_bytes += size;
+    if (m_buffer.size() >= c_bufferSize)
+      flush();
+  }
+  void write(const QByteArray &data) { write(data.constData(), data.size()); }
+
+private:
+  void flush();
+  void work();
+
+  QFile m_file;
+  QByteArray m_buffer;
+  unsigned long long m_bytes = 0;
+
+  std::mutex m_lock;
+  std::condition_variable m_changed;
+  std::deque<QByteArray> m_pending;
+  bool m_quit = false;
+  bool m_writeFailed = false;
+  std::thread m_thread;
+};
+
+} // namespace Ripes
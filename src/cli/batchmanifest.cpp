@@ -0,0 +1,120 @@
+#include "batchmanifest.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace Ripes {
+
+namespace {
+// Options which apply to the batch, server or sweep session as a whole, and
+// not to its runs, in addition to the swept options (--sweep-<option>).
+const QStringList c_batchOptions = {"batch", "server", "jobs", "output",
+                                    "mode", "console-out", "console-flush",
+                                    "console-buffer", "stdin", "host-trace",
+                                    "sweep", "shared-frontend", "nodes",
+                                    "node-retries", "worker"};
+
+QString valueToArgument(const QJsonValue &value) {
+  if (value.isDouble())
+    return value.toVariant().toString();
+  if (value.isArray()) {
+    QStringList items;
+    for (const auto &item : value.toArray())
+      items << valueToArgument(item);
+    return items.join(",");
+  }
+  if (value.isObject()) {
+    const QJsonObject object = value.toObject();
+    QStringList items;
+    for (auto it = object.begin(); it != object.end(); ++it)
+      items << it.key() + "=" + valueToArgument(it.value());
+    return items.join(",");
+  }
+  return value.toString();
+}
+} // namespace
+
+bool isSessionOption(const QString &option) {
+  return c_batchOptions.contains(option) || option.startsWith("sweep-");
+}
+
+QString parseBatchRun(const QJsonObject &run, BatchRun &batchRun) {
+  for (auto it = run.begin(); it != run.end(); ++it) {
+    const QString &key = it.key();
+    const QJsonValue &value = it.value();
+    if (isSessionOption(key))
+      return "Option '" + key + "' cannot be set per run";
+    if (key == "name") {
+      batchRun.name = value.toString();
+    } else if (key == "args") {
+      if (!value.isArray())
+        return "Expected a list of command-line arguments for 'args'";
+      for (const auto &argument : value.toArray()) {
+        const QString arg = argument.toString();
+        const QString option = arg.section('=', 0, 0);
+        if (option.startsWith("--") && isSessionOption(option.mid(2)))
+          return "Option '" + option.mid(2) + "' cannot be set per run";
+        batchRun.arguments << arg;
+      }
+    } else if (key == "telemetry") {
+      if (!value.isArray())
+        return "Expected a list of telemetry options for 'telemetry'";
+      for (const auto &telemetry : value.toArray())
+        batchRun.arguments << "--" + telemetry.toString();
+    } else if (value.isBool()) {
+      if (value.toBool())
+        batchRun.arguments << "--" + key;
+    } else if (value.isNull() || value.isUndefined()) {
+      return "Invalid value for option '" + key + "'";
+    } else {
+      batchRun.arguments << "--" + key << valueToArgument(value);
+    }
+  }
+  return QString();
+}
+
+QString loadBatchManifest(const QString &path, std::vector<BatchRun> &runs) {
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly))
+    return "Could not open batch manifest " + path;
+
+  QJsonParseError parseError;
+  const QJsonDocument doc =
+      QJsonDocument::fromJson(file.readAll(), &parseError);
+  if (doc.isNull())
+    return path + ": " + parseError.errorString() + " at offset " +
+           QString::number(parseError.offset);
+
+  QJsonArray runArray;
+  QJsonObject defaults;
+  if (doc.isArray()) {
+    runArray = doc.array();
+  } else {
+    const QJsonObject manifest = doc.object();
+    if (!manifest.value("runs").isArray())
+      return path + ": Expected a 'runs' array";
+    runArray = manifest.value("runs").toArray();
+    defaults = manifest.value("defaults").toObject();
+  }
+
+  for (int i = 0; i < runArray.size(); ++i) {
+    const QString location = path + ": run " + QString::number(i) + ": ";
+    if (!runArray.at(i).isObject())
+      return location + "Expected an object";
+    QJsonObject run = defaults;
+    const QJsonObject overrides = runArray.at(i).toObject();
+    for (auto it = overrides.begin(); it != overrides.end(); ++it)
+      run.insert(it.key(), it.value());
+
+    BatchRun batchRun;
+    QString err = parseBatchRun(run, batchRun);
+    if (!err.isEmpty())
+      return location + err;
+    runs.push_back(batchRun);
+  }
+  return QString();
+}
+
+} // namespace Ripes
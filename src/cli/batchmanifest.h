@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+
+#include <vector>
+
+namespace Ripes {
+
+/**
+ * @brief The BatchRun struct
+ * A single run of a batch manifest, given as the command-line arguments which
+ * would configure the run as a separate Ripes invocation.
+ */
+struct BatchRun {
+  // Optional name of the run, echoed in its result.
+  QString name;
+  QStringList arguments;
+};
+
+/// Returns true if @p option (without leading dashes) applies to a batch,
+/// server or sweep session as a whole, and cannot be set per run.
+bool isSessionOption(const QString &option);
+
+/**
+ * @brief parseBatchRun
+ * Converts the options of a single run, given as in a batch manifest (see
+ * loadBatchManifest), to the arguments of @p batchRun. Returns an error message
+ * on failure, or an empty string on success.
+ */
+QString parseBatchRun(const QJsonObject &run, BatchRun &batchRun);
+
+/**
+ * @brief loadBatchManifest
+ * Reads the runs of the batch manifest at @p path. The manifest is a JSON
+ * object with a "runs" array, and optionally a "defaults" object, or a bare
+ * array of runs. Each run is an object whose keys are command-line options
+ * (without leading dashes) and whose values are their arguments; the keys of
+ * "defaults" apply to every run which does not set them. Boolean values toggle
+ * flags, arrays are joined by commas, "reginit" may be an object of register
+ * indices to values, "telemetry" is a list of telemetry options to enable, and
+ * "args" is a list of command-line arguments which are passed verbatim.
+ * Returns an error message on failure, or an empty string on success.
+ */
+QString loadBatchManifest(const QString &path, std::vector<BatchRun> &runs);
+
+} // namespace Ripes
@@ -0,0 +1,90 @@
+#include "branchprofiler.h"
+
+#include "processorhandler.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+BranchProfiler::BranchProfiler() {
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorClocked, this,
+          [this] { processorClocked(); }, Qt::DirectConnection);
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          [this] { reset(); });
+  reset();
+}
+
+void BranchProfiler::reset() {
+  m_instrBytes = ProcessorHandler::currentISA()->instrBytes();
+  m_textStart = 0;
+  size_t instructions = 0;
+  if (auto program = ProcessorHandler::getProgram()) {
+    if (auto *text = program->getSection(TEXT_SECTION_NAME)) {
+      m_textStart = text->address;
+      instructions = text->data.size() / m_instrBytes;
+    }
+  }
+  m_entries.assign(instructions, Entry());
+  m_width = std::max<unsigned>(
+      ProcessorHandler::getProcessor()->structure().size(), 1);
+}
+
+void BranchProfiler::processorClocked() {
+  const auto *proc = ProcessorHandler::getProcessor();
+  const auto outcome = proc->branchOutcome();
+  if (!outcome.valid)
+    return;
+
+  const AInt idx = (outcome.pc - m_textStart) / m_instrBytes;
+  if (outcome.pc < m_textStart || idx >= m_entries.size())
+    return;
+  Entry &entry = m_entries[idx];
+  entry.isJump = outcome.isJump;
+  entry.executions++;
+  if (!outcome.taken)
+    return;
+  entry.taken++;
+  const auto stall = proc->stallCause();
+  if (stall.cause == RipesProcessor::StallCause::ControlHazard)
+    entry.flushCycles += (stall.lostSlots + m_width - 1) / m_width;
+}
+
+std::vector<BranchProfiler::Entry> BranchProfiler::worst(unsigned n) const {
+  std::vector<Entry> entries;
+  for (size_t i = 0; i < m_entries.size(); ++i) {
+    if (m_entries[i].executions == 0)
+      continue;
+    entries.push_back(m_entries[i]);
+    entries.back().address = m_textStart + i * m_instrBytes;
+  }
+  const auto worse = [](const Entry &lhs, const Entry &rhs) {
+    if (lhs.flushCycles != rhs.flushCycles)
+      return lhs.flushCycles > rhs.flushCycles;
+    if (lhs.executions != rhs.executions)
+      return lhs.executions > rhs.executions;
+    return lhs.address < rhs.address;
+  };
+  if (entries.size() > n) {
+    std::partial_sort(entries.begin(), entries.begin() + n, entries.end(),
+                      worse);
+    entries.resize(n);
+  } else {
+    std::sort(entries.begin(), entries.end(), worse);
+  }
+  return entries;
+}
+
+BranchProfiler::Entry BranchProfiler::total(bool jumps) const {
+  Entry sum;
+  sum.isJump = jumps;
+  for (const auto &entry : m_entries) {
+    if (entry.executions == 0 || entry.isJump != jumps)
+      continue;
+    sum.executions += entry.executions;
+    sum.taken += entry.taken;
+    sum.flushCycles += entry.flushCycles;
+  }
+  return sum;
+}
+
+} // namespace Ripes
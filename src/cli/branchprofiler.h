@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QObject>
+
+#include <vector>
+
+#include "processors/interface/ripesprocessor.h"
+
+namespace Ripes {
+
+/**
+ * @brief The BranchProfiler class
+ * Counts, for each branch and jump of the text section of the current
+ * program, the number of times it was resolved, the number of times it was
+ * taken and the number of cycles lost to the pipeline flushes it caused, as
+ * reported by RipesProcessor::branchOutcome() and
+ * RipesProcessor::stallCause(). Counters are stored in flat arrays indexed by
+ * instruction. The profile is cleared when the processor is reset.
+ */
+class BranchProfiler : public QObject {
+public:
+  struct Entry {
+    AInt address = 0;
+    bool isJump = false;
+    unsigned long long executions = 0;
+    unsigned long long taken = 0;
+    unsigned long long flushCycles = 0;
+  };
+
+  BranchProfiler();
+
+  /// Returns the @p n branches and jumps with the most flush cycles, in
+  /// descending order.
+  std::vector<Entry> worst(unsigned n) const;
+
+  /// Returns the sum of all branches (@p jumps = false) or jumps (@p jumps =
+  /// true). The address of the returned entry is unused.
+  Entry total(bool jumps) const;
+
+private:
+  void reset();
+  void processorClocked();
+
+  AInt m_textStart = 0;
+  unsigned m_instrBytes = 4;
+  unsigned m_width = 1;
+  std::vector<Entry> m_entries;
+};
+
+} // namespace Ripes
@@ -0,0 +1,647 @@
+#include "cachehierarchy.h"
+#include "binutils.h"
+#include "processorhandler.h"
+#include "ripessettings.h"
+
+// Declares the CachePreset metatype.
+#include "cachesim/cacheconfigwidget.h"
+
+#include <algorithm>
+#include <array>
+#include <map>
+
+namespace Ripes {
+
+// Parses a power-of-two count into its base-2 logarithm.
+static bool parsePowerOf2(const QString &value, int &bits) {
+  bool ok;
+  const unsigned v = value.toUInt(&ok);
+  if (!ok || !isPowerOf2(v))
+    return false;
+  bits = log2Ceil(v);
+  return true;
+}
+
+QString parseCacheLevelConfig(const QString &spec, CacheLevelConfig &config) {
+  for (const auto &entry : spec.split(",")) {
+    if (entry.trimmed().isEmpty())
+      continue;
+    const QStringList parts = entry.split("=");
+    if (parts.size() != 2)
+      return "Invalid cache parameter '" + entry + "'";
+    const QString key = parts.at(0).trimmed();
+    const QString value = parts.at(1).trimmed();
+
+    bool ok = true;
+    if (key == "preset") {
+      const auto presets = RipesSettings::value(RIPES_SETTING_CACHE_PRESETS)
+                               .value<QList<CachePreset>>();
+      const auto it = std::find_if(
+          presets.begin(), presets.end(), [&](const CachePreset &preset) {
+            return preset.name.compare(value, Qt::CaseInsensitive) == 0;
+          });
+      if (it == presets.end()) {
+        QStringList names;
+        for (const auto &preset : presets)
+          names << "'" + preset.name + "'";
+        return "Unknown cache preset '" + value +
+               "'. Available presets: " + names.join(", ");
+      }
+      config.preset = *it;
+    } else if (key == "lines") {
+      ok = parsePowerOf2(value, config.preset.lines);
+    } else if (key == "ways") {
+      ok = parsePowerOf2(value, config.preset.ways);
+    } else if (key == "blocks") {
+      ok = parsePowerOf2(value, config.preset.blocks);
+    } else if (key == "latency") {
+      config.latency = value.toUInt(&ok);
+    } else if (key == "victim") {
+      config.victim = value.toUInt(&ok);
+    } else if (key == "wp") {
+      ok = value == "wb" || value == "wt";
+      config.preset.wrPolicy =
+          value == "wt" ? WritePolicy::WriteThrough : WritePolicy::WriteBack;
+    } else if (key == "wa") {
+      ok = value == "alloc" || value == "noalloc";
+      config.preset.wrAllocPolicy = value == "noalloc"
+                                        ? WriteAllocPolicy::NoWriteAllocate
+                                        : WriteAllocPolicy::WriteAllocate;
+    } else if (key == "repl") {
+      const std::map<QString, ReplPolicy> policies = {
+          {"random", ReplPolicy::Random},
+          {"lru", ReplPolicy::LRU},
+          {"plru", ReplPolicy::PLRU},
+          {"fifo", ReplPolicy::FIFO},
+          {"srrip", ReplPolicy::SRRIP}};
+      const auto it = policies.find(value);
+      ok = it != policies.end();
+      if (ok)
+        config.preset.replPolicy = it->second;
+    } else if (key == "prefetch") {
+      const std::map<QString, PrefetchPolicy> policies = {
+          {"none", PrefetchPolicy::Disabled},
+          {"nextline", PrefetchPolicy::NextLine},
+          {"stride", PrefetchPolicy::Stride},
+          {"stream", PrefetchPolicy::Stream}};
+      const auto it = policies.find(value);
+      ok = it != policies.end();
+      if (ok)
+        config.prefetch = it->second;
+    } else {
+      return "Unknown cache parameter '" + key + "'";
+    }
+
+    if (!ok)
+      return "Invalid value '" + value + "' for cache parameter '" + key + "'";
+  }
+  return QString();
+}
+
+QString parseFetchBufferConfig(const QString &spec,
+                               FetchBuffer::Config &config) {
+  for (const auto &entry : spec.split(",")) {
+    if (entry.trimmed().isEmpty())
+      continue;
+    const QStringList parts = entry.split("=");
+    if (parts.size() != 2)
+      return "Invalid fetch buffer parameter '" + entry + "'";
+    const QString key = parts.at(0).trimmed();
+    const QString value = parts.at(1).trimmed();
+
+    bool ok = true;
+    if (key == "block") {
+      config.blockBytes = value.toUInt(&ok);
+      ok &= isPowerOf2(config.blockBytes) && config.blockBytes >= 4 &&
+            config.blockBytes <= 64;
+    } else if (key == "loop") {
+      config.loopBytes = value.toUInt(&ok);
+    } else {
+      return "Unknown fetch buffer parameter '" + key + "'";
+    }
+
+    if (!ok) {
+      return "Invalid value '" + value + "' for fetch buffer parameter '" +
+             key + "'";
+    }
+  }
+  return QString();
+}
+
+QString parseStoreBufferConfig(const QString &spec,
+                               StoreBuffer::Config &config) {
+  for (const auto &entry : spec.split(",")) {
+    if (entry.trimmed().isEmpty())
+      continue;
+    const QStringList parts = entry.split("=");
+    if (parts.size() != 2)
+      return "Invalid store buffer parameter '" + entry + "'";
+    const QString key = parts.at(0).trimmed();
+    const QString value = parts.at(1).trimmed();
+
+    bool ok = true;
+    if (key == "entries") {
+      config.entries = value.toUInt(&ok);
+      ok &= config.entries > 0;
+    } else if (key == "drain") {
+      if (value == "eager")
+        config.drain = StoreBuffer::DrainPolicy::Eager;
+      else if (value == "lazy")
+        config.drain = StoreBuffer::DrainPolicy::Lazy;
+      else
+        ok = false;
+    } else {
+      return "Unknown store buffer parameter '" + key + "'";
+    }
+
+    if (!ok) {
+      return "Invalid value '" + value + "' for store buffer parameter '" +
+             key + "'";
+    }
+  }
+  return QString();
+}
+
+QString parseTLBConfig(const QString &spec, TLBSim::Config &config,
+                       unsigned xlen) {
+  for (const auto &entry : spec.split(",")) {
+    if (entry.trimmed().isEmpty())
+      continue;
+    const QStringList parts = entry.split("=");
+    if (parts.size() != 2)
+      return "Invalid TLB parameter '" + entry + "'";
+    const QString key = parts.at(0).trimmed();
+    const QString value = parts.at(1).trimmed();
+
+    bool ok = true;
+    if (key == "entries") {
+      config.entries = value.toUInt(&ok);
+    } else if (key == "ways") {
+      config.ways = value.toUInt(&ok);
+    } else if (key == "repl") {
+      const std::map<QString, ReplPolicy> policies = {
+          {"random", ReplPolicy::Random},
+          {"lru", ReplPolicy::LRU},
+          {"fifo", ReplPolicy::FIFO}};
+      const auto it = policies.find(value);
+      ok = it != policies.end();
+      if (ok)
+        config.repl = it->second;
+    } else if (key == "page") {
+      const std::map<QString, unsigned> levels =
+          xlen == 32 ? std::map<QString, unsigned>{{"4k", 0}, {"4m", 1}}
+                     : std::map<QString, unsigned>{
+                           {"4k", 0}, {"2m", 1}, {"1g", 2}};
+      const auto it = levels.find(value.toLower());
+      ok = it != levels.end();
+      if (ok)
+        config.pageLevel = it->second;
+    } else if (key == "root") {
+      config.rootTable = value.toULongLong(&ok, 0);
+      ok &= (config.rootTable & 0xFFF) == 0;
+      if (xlen == 32)
+        ok &= config.rootTable <= 0xFFFFFFFF;
+    } else {
+      return "Unknown TLB parameter '" + key + "'";
+    }
+
+    if (!ok)
+      return "Invalid value '" + value + "' for TLB parameter '" + key + "'";
+  }
+  if (config.ways == 0 || config.entries < config.ways ||
+      config.entries % config.ways != 0)
+    return "The number of TLB entries must be a nonzero multiple of the "
+           "number of ways";
+  return QString();
+}
+
+QString parseDRAMConfig(const QString &spec, DRAMSim::Config &config) {
+  for (const auto &entry : spec.split(",")) {
+    if (entry.trimmed().isEmpty())
+      continue;
+    const QStringList parts = entry.split("=");
+    if (parts.size() != 2)
+      return "Invalid DRAM parameter '" + entry + "'";
+    const QString key = parts.at(0).trimmed();
+    const QString value = parts.at(1).trimmed();
+
+    bool ok = true;
+    if (key == "banks") {
+      config.banks = value.toUInt(&ok);
+      ok &= isPowerOf2(config.banks);
+    } else if (key == "row") {
+      config.rowBytes = value.toUInt(&ok);
+      ok &= isPowerOf2(config.rowBytes);
+    } else if (key == "trcd") {
+      config.tRCD = value.toUInt(&ok);
+    } else if (key == "tcas") {
+      config.tCAS = value.toUInt(&ok);
+    } else if (key == "trp") {
+      config.tRP = value.toUInt(&ok);
+    } else if (key == "burst") {
+      config.tBurst = value.toUInt(&ok);
+    } else {
+      return "Unknown DRAM parameter '" + key + "'";
+    }
+
+    if (!ok)
+      return "Invalid value '" + value + "' for DRAM parameter '" + key + "'";
+  }
+  return QString();
+}
+
+std::shared_ptr<CacheSim>
+CacheHierarchy::createLevel(const QString &name,
+                            const CacheLevelConfig &config) {
+  auto cache = std::make_shared<CacheSim>(nullptr);
+  cache->setPreset(config.preset);
+  cache->setLatency(config.latency);
+  cache->setPrefetchPolicy(config.prefetch);
+  cache->setVictimCacheEntries(config.victim);
+  m_levels.push_back({name, cache});
+  return cache;
+}
+
+void CacheHierarchy::build(const CacheHierarchyConfig &config) {
+  m_levels.clear();
+  m_lastLevels.clear();
+  m_l1iShim.reset();
+  m_l1dShim.reset();
+  m_fetchBuffer.reset();
+  m_storeBuffer.reset();
+  m_itlb.reset();
+  m_dtlb.reset();
+  m_dram.reset();
+  m_memLatency = config.memLatency;
+  m_timing = config.timing;
+  m_inclusion = InclusionPolicy::NINE;
+
+  // The misses of the L1I, L1D, L2 and L3 caches are readable by programs
+  // through the hpmcounter4..7 CSRs.
+  constexpr unsigned firstMissCounter = 4;
+  auto &hpmCounters = ProcessorHandler::getProcessorNonConst()->hpmCounters;
+  for (unsigned i = 0; i < 4; ++i)
+    hpmCounters[firstMissCounter + i] = nullptr;
+  if (!config.enabled())
+    return;
+
+  // Levels are created top-down, such that the report lists L1 caches first.
+  std::shared_ptr<CacheSim> l1i, l1d, l2, l3;
+  if (config.l1i)
+    l1i = createLevel("L1I", *config.l1i);
+  if (config.l1d)
+    l1d = createLevel("L1D", *config.l1d);
+  if (config.l2)
+    l2 = createLevel("L2", *config.l2);
+  if (config.l3)
+    l3 = createLevel("L3", *config.l3);
+  const std::array<std::shared_ptr<CacheSim>, 4> missCounted = {
+      {l1i, l1d, l2, l3}};
+  for (unsigned i = 0; i < missCounted.size(); ++i) {
+    if (const auto cache = missCounted[i])
+      hpmCounters[firstMissCounter + i] = [cache] {
+        return static_cast<uint64_t>(cache->getMisses());
+      };
+  }
+
+  // Link the shared levels, and the L1 caches to the first shared level.
+  if (l2 && l3)
+    l2->setNextLevelCache(l3);
+  const auto shared = l2 ? l2 : l3;
+  for (const auto &l1 : {l1i, l1d})
+    if (l1 && shared)
+      l1->setNextLevelCache(shared);
+
+  // Inclusion is enforced between the L1 caches and the first shared level,
+  // and between the shared levels.
+  m_inclusion = shared ? config.inclusion : InclusionPolicy::NINE;
+  if (m_inclusion != InclusionPolicy::NINE) {
+    shared->setInclusionPolicy(m_inclusion);
+    for (const auto &l1 : {l1i, l1d})
+      if (l1)
+        shared->addPreviousLevelCache(l1.get());
+    if (l2 && l3) {
+      l3->setInclusionPolicy(m_inclusion);
+      l3->addPreviousLevelCache(l2.get());
+    }
+  }
+
+  if (shared) {
+    m_lastLevels.push_back(l3 ? l3 : l2);
+  } else {
+    for (const auto &l1 : {l1i, l1d})
+      if (l1)
+        m_lastLevels.push_back(l1);
+  }
+  if (config.dram)
+    m_dram = std::make_shared<DRAMSim>(*config.dram, nullptr);
+  for (const auto &cache : m_lastLevels) {
+    if (m_dram)
+      cache->setNextLevelCache(m_dram);
+    else
+      cache->setMissLatency(m_memLatency);
+  }
+
+  // Page walks read the page tables through the data side of the hierarchy.
+  const auto createTLB = [&]() {
+    auto tlb = std::make_shared<TLBSim>(*config.tlb, nullptr);
+    if (const auto walkCache = l1d ? l1d : shared)
+      tlb->setWalkCache(walkCache, 0);
+    else
+      tlb->setWalkCache(m_dram, m_memLatency);
+    return tlb;
+  };
+
+  // Without an L1 cache, the processor accesses the shared levels directly.
+  if (const auto top = l1i ? l1i : shared) {
+    m_l1iShim = std::make_unique<L1CacheShim>(
+        L1CacheShim::CacheType::InstrCache, nullptr);
+    std::shared_ptr<CacheInterface> next = top;
+    if (config.fetchBuffer) {
+      m_fetchBuffer =
+          std::make_shared<FetchBuffer>(*config.fetchBuffer, nullptr);
+      m_fetchBuffer->setNextLevelCache(next);
+      next = m_fetchBuffer;
+    }
+    if (config.tlb) {
+      m_itlb = createTLB();
+      m_itlb->setNextLevelCache(next);
+      next = m_itlb;
+    }
+    m_l1iShim->setNextLevelCache(next);
+    m_l1iShim->setTimingEnabled(m_timing);
+  }
+  if (const auto top = l1d ? l1d : shared) {
+    m_l1dShim = std::make_unique<L1CacheShim>(
+        L1CacheShim::CacheType::DataCache, nullptr);
+    std::shared_ptr<CacheInterface> next = top;
+    if (config.storeBuffer) {
+      m_storeBuffer =
+          std::make_shared<StoreBuffer>(*config.storeBuffer, nullptr);
+      m_storeBuffer->setNextLevelCache(next);
+      next = m_storeBuffer;
+    }
+    if (config.tlb) {
+      m_dtlb = createTLB();
+      m_dtlb->setNextLevelCache(next);
+      next = m_dtlb;
+    }
+    m_l1dShim->setNextLevelCache(next);
+    m_l1dShim->setTimingEnabled(m_timing);
+  }
+}
+
+long long CacheHierarchy::estimatedStallCycles() const {
+  long long cycles = 0;
+  for (const auto &level : m_levels) {
+    cycles += static_cast<long long>(level.cache->getHits() +
+                                     level.cache->getMisses()) *
+                  level.cache->getLatency() +
+              static_cast<long long>(level.cache->getVictimHits()) *
+                  CacheSim::s_victimLatency;
+  }
+  if (m_dram)
+    return cycles + static_cast<long long>(m_dram->stats().readLatencyCycles);
+  // Memory traffic is approximated by the misses which were not served by a
+  // victim cache, and the writebacks of the last level caches.
+  for (const auto &cache : m_lastLevels) {
+    cycles += static_cast<long long>(cache->getMisses() -
+                                     cache->getVictimHits() +
+                                     cache->getWritebacks()) *
+              m_memLatency;
+  }
+  return cycles;
+}
+
+// Returns @p value per cycle of @p cycles.
+static double perCycle(double value, long long cycles) {
+  return cycles == 0 ? 0.0 : value / cycles;
+}
+
+namespace {
+/// Bytes transferred between a cache and the level below it.
+struct Traffic {
+  double readBytes = 0;
+  double writtenBytes = 0;
+  double bytes() const { return readBytes + writtenBytes; }
+};
+} // namespace
+
+// Returns the traffic to the level below of the accesses of @p stats to
+// @p cache: the fills of whole lines (including prefetch fills, but not the
+// misses served by the victim cache), and the writebacks of whole lines, or of
+// words if written through.
+static Traffic traffic(const CacheSim &cache,
+                       const CacheSim::CacheAccessTrace &stats,
+                       unsigned wordBytes) {
+  const unsigned lineBytes = (1u << cache.getBlockBits()) * wordBytes;
+  const unsigned writeBytes =
+      cache.getWritePolicy() == WritePolicy::WriteThrough ? wordBytes
+                                                          : lineBytes;
+  Traffic t;
+  t.readBytes =
+      static_cast<double>(stats.misses - stats.victimHits + stats.prefetches) *
+      lineBytes;
+  t.writtenBytes = static_cast<double>(stats.writebacks) * writeBytes;
+  return t;
+}
+
+// Returns the peak traffic of @p caches to the level below, in bytes per cycle
+// of the sampling interval, which is stored in @p interval. The traffic is
+// sampled from the access history of the caches, at the coarsest resolution
+// of their histories.
+static double
+peakBandwidth(const std::vector<std::shared_ptr<CacheSim>> &caches,
+              unsigned wordBytes, unsigned &interval) {
+  interval = 1;
+  for (const auto &cache : caches)
+    interval = std::max(interval, cache->getAccessHistoryResolution());
+  // The accesses in between two samples of a history were performed in the
+  // sampling interval of the latter sample.
+  std::map<unsigned, double> intervalBytes;
+  for (const auto &cache : caches) {
+    double prevBytes = 0;
+    for (const auto &sample : cache->getAccessHistory()) {
+      const double bytes = traffic(*cache, sample.stats, wordBytes).bytes();
+      intervalBytes[sample.cycle / interval] += bytes - prevBytes;
+      prevBytes = bytes;
+    }
+  }
+  double peak = 0;
+  for (const auto &it : intervalBytes)
+    peak = std::max(peak, it.second);
+  return peak / interval;
+}
+
+QVariantMap CacheHierarchy::report(long long cycles) const {
+  const unsigned wordBytes = ProcessorHandler::currentISA()->bytes();
+  QVariantMap levels;
+  for (const auto &level : m_levels) {
+    const auto &cache = level.cache;
+    QVariantMap stats;
+    stats["hits"] = cache->getHits();
+    stats["misses"] = cache->getMisses();
+    stats["writebacks"] = cache->getWritebacks();
+    stats["hit rate"] = cache->getHitRate();
+    stats["latency"] = cache->getLatency();
+    const unsigned accesses = cache->getHits() + cache->getMisses();
+    stats["average latency"] =
+        accesses == 0 ? 0.0
+                      : static_cast<double>(cache->getLatencyCycles()) /
+                            accesses;
+    const Traffic t = traffic(*cache, cache->getAccessStats(), wordBytes);
+    stats["bytes read"] = t.readBytes;
+    stats["bytes written"] = t.writtenBytes;
+    stats["bandwidth (bytes/cycle)"] = perCycle(t.bytes(), cycles);
+    unsigned interval;
+    stats["peak bandwidth (bytes/cycle)"] =
+        peakBandwidth({cache}, wordBytes, interval);
+    stats["bandwidth interval (cycles)"] = interval;
+    const auto size = cache->getCacheSize();
+    stats["size (bits)"] = size.bits;
+    QStringList sizeComponents;
+    for (const auto &component : size.components)
+      sizeComponents << component;
+    stats["size breakdown"] = sizeComponents;
+    if (cache->getPrefetchPolicy() != PrefetchPolicy::Disabled) {
+      QVariantMap prefetch;
+      prefetch["prefetcher"] =
+          s_cachePrefetchPolicyStrings.at(cache->getPrefetchPolicy());
+      prefetch["fills"] = cache->getPrefetches();
+      prefetch["accuracy"] = cache->getPrefetchAccuracy();
+      prefetch["coverage"] = cache->getPrefetchCoverage();
+      prefetch["timeliness"] = cache->getPrefetchTimeliness();
+      stats["prefetch"] = prefetch;
+    }
+    if (cache->getVictimCacheEntries() != 0) {
+      QVariantMap victim;
+      victim["lines"] = cache->getVictimCacheEntries();
+      victim["hits"] = cache->getVictimHits();
+      // Fraction of the misses of the cache which were served by the victim
+      // cache.
+      victim["hit rate"] =
+          cache->getMisses() == 0
+              ? 0.0
+              : static_cast<double>(cache->getVictimHits()) /
+                    cache->getMisses();
+      stats["victim cache"] = victim;
+    }
+    if (m_inclusion != InclusionPolicy::NINE) {
+      if (cache->getInclusionPolicy() != InclusionPolicy::NINE)
+        stats["inclusion"] =
+            s_cacheInclusionPolicyStrings.at(cache->getInclusionPolicy());
+      stats["invalidations"] = cache->getInvalidations();
+      if (cache->getInclusionPolicy() == InclusionPolicy::Exclusive)
+        stats["insertions"] = cache->getInsertions();
+    }
+    levels[level.name] = stats;
+  }
+  return levels;
+}
+
+QVariantMap CacheHierarchy::memoryReport(long long cycles) const {
+  const unsigned wordBytes = ProcessorHandler::currentISA()->bytes();
+  Traffic total;
+  for (const auto &cache : m_lastLevels) {
+    const Traffic t = traffic(*cache, cache->getAccessStats(), wordBytes);
+    total.readBytes += t.readBytes;
+    total.writtenBytes += t.writtenBytes;
+  }
+  QVariantMap stats;
+  stats["bytes read"] = total.readBytes;
+  stats["bytes written"] = total.writtenBytes;
+  stats["bandwidth (bytes/cycle)"] = perCycle(total.bytes(), cycles);
+  unsigned interval;
+  stats["peak bandwidth (bytes/cycle)"] =
+      peakBandwidth(m_lastLevels, wordBytes, interval);
+  stats["bandwidth interval (cycles)"] = interval;
+  return stats;
+}
+
+QVariantMap CacheHierarchy::dramReport(long long cycles) const {
+  QVariantMap stats;
+  if (m_dram) {
+    const auto &dram = m_dram->stats();
+    stats["banks"] = m_dram->config().banks;
+    stats["row (bytes)"] = m_dram->config().rowBytes;
+    stats["reads"] = dram.reads;
+    stats["writes"] = dram.writes;
+    stats["row hits"] = dram.rowHits;
+    stats["row misses"] = dram.rowMisses;
+    stats["row conflicts"] = dram.rowConflicts;
+    stats["row buffer hit rate"] = m_dram->rowHitRate();
+    stats["average latency"] = m_dram->averageLatency();
+    stats["bandwidth (bytes/cycle)"] =
+        memoryReport(cycles).value("bandwidth (bytes/cycle)");
+  }
+  return stats;
+}
+
+QVariantMap CacheHierarchy::fetchBufferReport() const {
+  QVariantMap stats;
+  if (m_fetchBuffer) {
+    const auto &fb = m_fetchBuffer->stats();
+    stats["block (bytes)"] = m_fetchBuffer->config().blockBytes;
+    stats["loop buffer (bytes)"] = m_fetchBuffer->config().loopBytes;
+    stats["fetches"] = fb.fetches;
+    stats["fetch buffer hits"] = fb.fetchBufferHits;
+    stats["loop buffer hits"] = fb.loopBufferHits;
+    stats["loop buffer hit rate"] = m_fetchBuffer->loopBufferHitRate();
+    stats["loops captured"] = fb.loops;
+    stats["cache accesses"] = fb.cacheAccesses;
+    stats["fetch bubble cycles"] = fb.bubbleCycles;
+  }
+  return stats;
+}
+
+QVariantMap CacheHierarchy::tlbReport() const {
+  QVariantMap tlbs;
+  for (const auto &[name, tlb] : {std::make_pair("ITLB", m_itlb),
+                                  std::make_pair("DTLB", m_dtlb)}) {
+    if (!tlb)
+      continue;
+    const auto &ts = tlb->stats();
+    QVariantMap stats;
+    stats["scheme"] = tlb->scheme();
+    stats["entries"] = tlb->config().entries;
+    stats["ways"] = tlb->config().ways;
+    stats["page (bytes)"] = QVariant::fromValue(tlb->pageBytes());
+    stats["reach (bytes)"] =
+        QVariant::fromValue(tlb->pageBytes() * tlb->config().entries);
+    stats["hits"] = ts.hits;
+    stats["misses"] = ts.misses;
+    stats["hit rate"] = tlb->hitRate();
+    stats["walk accesses"] = ts.walkAccesses;
+    stats["walk cycles"] = ts.walkCycles;
+    stats["average walk latency"] =
+        ts.misses == 0 ? 0.0
+                       : static_cast<double>(ts.walkCycles) / ts.misses;
+    tlbs[name] = stats;
+  }
+  return tlbs;
+}
+
+QVariantMap CacheHierarchy::storeBufferReport() const {
+  QVariantMap stats;
+  if (m_storeBuffer) {
+    const auto &sb = m_storeBuffer->stats();
+    stats["entries"] = m_storeBuffer->config().entries;
+    stats["drain"] =
+        m_storeBuffer->config().drain == StoreBuffer::DrainPolicy::Eager
+            ? "eager"
+            : "lazy";
+    stats["stores"] = sb.stores;
+    stats["merged stores"] = sb.merges;
+    stats["drained stores"] = sb.drains;
+    stats["loads"] = sb.loads;
+    stats["forwarded loads"] = sb.forwards;
+    stats["forward rate"] = m_storeBuffer->forwardRate();
+    stats["average occupancy"] = m_storeBuffer->averageOccupancy();
+    stats["max occupancy"] = sb.maxOccupancy;
+    stats["full stall cycles"] = sb.fullStallCycles;
+    stats["load wait cycles"] = sb.loadWaitCycles;
+  }
+  return stats;
+}
+
+} // namespace Ripes
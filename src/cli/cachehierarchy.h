@@ -0,0 +1,193 @@
+#pragma once
+
+#include <QString>
+#include <QVariantMap>
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "cachesim/cachesim.h"
+#include "cachesim/dramsim.h"
+#include "cachesim/fetchbuffer.h"
+#include "cachesim/l1cacheshim.h"
+#include "cachesim/storebuffer.h"
+#include "cachesim/tlbsim.h"
+
+namespace Ripes {
+
+/**
+ * @brief The CacheLevelConfig struct
+ * Configuration of a single level of the simulated cache hierarchy.
+ */
+struct CacheLevelConfig {
+  CachePreset preset = {"", 2, 5, 0, WritePolicy::WriteBack,
+                        WriteAllocPolicy::WriteAllocate, ReplPolicy::LRU};
+  // Access latency in cycles.
+  unsigned latency = 1;
+  PrefetchPolicy prefetch = PrefetchPolicy::Disabled;
+  // Lines of the victim cache, or 0 if none.
+  unsigned victim = 0;
+};
+
+/**
+ * @brief parseCacheLevelConfig
+ * Parses a cache level specification of the form
+ *   preset=<name>,lines=<n>,ways=<n>,blocks=<n>,latency=<n>,wp=<wb|wt>,
+ *   wa=<alloc|noalloc>,repl=<lru|plru|fifo|srrip|random>,
+ *   prefetch=<none|nextline|stride|stream>,victim=<lines>
+ * into @p config. All keys are optional; unspecified keys retain their value in
+ * @p config. A preset names one of the cache presets of the settings, and is
+ * overridden by any subsequent keys. lines, ways and blocks (words per line)
+ * must be powers of two.
+ * Returns an error message on failure, or an empty string on success.
+ */
+QString parseCacheLevelConfig(const QString &spec, CacheLevelConfig &config);
+
+/**
+ * @brief parseFetchBufferConfig
+ * Parses a fetch buffer specification of the form block=<bytes>,loop=<bytes>
+ * into @p config. Both keys are optional. The block size must be a power of
+ * two within [4, 64], and a loop buffer of 0 bytes disables it.
+ * Returns an error message on failure, or an empty string on success.
+ */
+QString parseFetchBufferConfig(const QString &spec,
+                               FetchBuffer::Config &config);
+
+/**
+ * @brief parseStoreBufferConfig
+ * Parses a store buffer specification of the form
+ * entries=<n>,drain=<eager|lazy> into @p config. Both keys are optional, and
+ * the buffer must hold at least one entry.
+ * Returns an error message on failure, or an empty string on success.
+ */
+QString parseStoreBufferConfig(const QString &spec,
+                               StoreBuffer::Config &config);
+
+/**
+ * @brief parseTLBConfig
+ * Parses a TLB specification of the form
+ *   entries=<n>,ways=<n>,repl=<lru|fifo|random>,page=<size>,root=<address>
+ * into @p config, for a processor of @p xlen bits. All keys are optional. The
+ * number of entries must be a multiple of the number of ways. Pages are 4k or
+ * 4m for Sv32 (RV32), and 4k, 2m or 1g for Sv39 (RV64). The root page table
+ * address must be page aligned.
+ * Returns an error message on failure, or an empty string on success.
+ */
+QString parseTLBConfig(const QString &spec, TLBSim::Config &config,
+                       unsigned xlen);
+
+/**
+ * @brief parseDRAMConfig
+ * Parses a main memory specification of the form
+ *   banks=<n>,row=<bytes>,trcd=<cycles>,tcas=<cycles>,trp=<cycles>,
+ *   burst=<cycles>
+ * into @p config. All keys are optional. banks and row must be powers of two.
+ * Returns an error message on failure, or an empty string on success.
+ */
+QString parseDRAMConfig(const QString &spec, DRAMSim::Config &config);
+
+/**
+ * @brief The CacheHierarchyConfig struct
+ * Configuration of the cache hierarchy simulated alongside the processor. The
+ * L1 caches are split into instruction and data caches, whereas the L2 and L3
+ * caches are unified, and shared between the L1 caches.
+ */
+struct CacheHierarchyConfig {
+  std::optional<CacheLevelConfig> l1i;
+  std::optional<CacheLevelConfig> l1d;
+  std::optional<CacheLevelConfig> l2;
+  std::optional<CacheLevelConfig> l3;
+  // Fetch buffer in front of the instruction side of the hierarchy.
+  std::optional<FetchBuffer::Config> fetchBuffer;
+  // Store buffer in front of the data side of the hierarchy.
+  std::optional<StoreBuffer::Config> storeBuffer;
+  // TLBs estimating the translation cost of each side of the hierarchy.
+  std::optional<TLBSim::Config> tlb;
+  // Latency in cycles of accesses which miss in the last level cache.
+  unsigned memLatency = 100;
+  // DRAM timing model serving the misses of the last level caches, in place
+  // of the fixed memLatency.
+  std::optional<DRAMSim::Config> dram;
+  // Stall the processor for the latency of each access.
+  bool timing = false;
+  // Inclusion of the lines of the L1 caches in the L2 cache, and of the L2
+  // cache in the L3 cache.
+  InclusionPolicy inclusion = InclusionPolicy::NINE;
+
+  bool enabled() const { return l1i || l1d || l2 || l3; }
+};
+
+/**
+ * @brief The CacheHierarchy class
+ * A hierarchy of cache simulators, fed by the memory accesses of the current
+ * processor. The hierarchy is reset alongside the processor.
+ */
+class CacheHierarchy {
+public:
+  struct Level {
+    QString name;
+    std::shared_ptr<CacheSim> cache;
+  };
+
+  /// Constructs the cache hierarchy described by @p config. Must be called
+  /// once the processor has been selected.
+  void build(const CacheHierarchyConfig &config);
+
+  const std::vector<Level> &levels() const { return m_levels; }
+  bool timingEnabled() const { return m_timing; }
+
+  /**
+   * @brief estimatedStallCycles
+   * Estimates the number of cycles spent in the memory hierarchy, as the sum of
+   * the accesses to each cache level times its latency, plus the traffic out of
+   * the last level caches times the memory latency. With a DRAM model, the
+   * latency of the reads of memory is used in place of the latter.
+   */
+  long long estimatedStallCycles() const;
+
+  /// Returns the statistics of each cache level, keyed by level name. Each
+  /// level reports the average latency of its accesses, the bytes read from
+  /// and written to the level below it, and the bandwidth to the level below
+  /// it, in bytes per cycle of @p cycles, on average and at its peak.
+  QVariantMap report(long long cycles) const;
+  /// Returns the traffic of the last level caches to memory over @p cycles,
+  /// as reported per level by report().
+  QVariantMap memoryReport(long long cycles) const;
+
+  bool hasDRAM() const { return static_cast<bool>(m_dram); }
+  /// Returns the statistics of the DRAM model, over @p cycles.
+  QVariantMap dramReport(long long cycles) const;
+
+  bool hasFetchBuffer() const { return static_cast<bool>(m_fetchBuffer); }
+  /// Returns the statistics of the fetch buffer.
+  QVariantMap fetchBufferReport() const;
+
+  bool hasTLB() const { return m_itlb || m_dtlb; }
+  /// Returns the statistics of the instruction and data TLBs.
+  QVariantMap tlbReport() const;
+
+  bool hasStoreBuffer() const { return static_cast<bool>(m_storeBuffer); }
+  /// Returns the statistics of the store buffer.
+  QVariantMap storeBufferReport() const;
+
+private:
+  std::shared_ptr<CacheSim> createLevel(const QString &name,
+                                        const CacheLevelConfig &config);
+
+  std::vector<Level> m_levels;
+  // Caches which forward their misses to memory.
+  std::vector<std::shared_ptr<CacheSim>> m_lastLevels;
+  unsigned m_memLatency = 0;
+  bool m_timing = false;
+  InclusionPolicy m_inclusion = InclusionPolicy::NINE;
+  std::shared_ptr<FetchBuffer> m_fetchBuffer;
+  std::shared_ptr<StoreBuffer> m_storeBuffer;
+  std::shared_ptr<TLBSim> m_itlb;
+  std::shared_ptr<TLBSim> m_dtlb;
+  std::shared_ptr<DRAMSim> m_dram;
+  std::unique_ptr<L1CacheShim> m_l1iShim;
+  std::unique_ptr<L1CacheShim> m_l1dShim;
+};
+
+} // namespace Ripes
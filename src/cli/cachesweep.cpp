@@ -0,0 +1,98 @@
+#include "cachesweep.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QtConcurrent/QtConcurrent>
+
+namespace Ripes {
+
+QString loadCacheSweepConfigs(const QString &path,
+                              std::vector<CacheSweepConfig> &configs) {
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    return "Could not open cache sweep file " + path;
+
+  QTextStream in(&file);
+  for (int lineNumber = 1; !in.atEnd(); ++lineNumber) {
+    const QString line = in.readLine().trimmed();
+    if (line.isEmpty() || line.startsWith("#"))
+      continue;
+
+    const QString location = path + ":" + QString::number(lineNumber) + ": ";
+    const QString stream = line.section(' ', 0, 0);
+    CacheSweepConfig config;
+    if (stream == "i")
+      config.stream = MemoryAccessTrace::Stream::Instr;
+    else if (stream == "d")
+      config.stream = MemoryAccessTrace::Stream::Data;
+    else
+      return location + "Invalid access stream '" + stream +
+             "' (expected i or d)";
+
+    config.spec = line.section(' ', 1).trimmed();
+    QString err = parseCacheLevelConfig(config.spec, config.config);
+    if (!err.isEmpty())
+      return location + err;
+    configs.push_back(config);
+  }
+  return QString();
+}
+
+void CacheSweep::record() {
+  const auto recorder = [&](L1CacheShim::CacheType type,
+                            MemoryAccessTrace::Stream stream) {
+    auto shim = std::make_unique<L1CacheShim>(type, nullptr);
+    shim->setNextLevelCache(
+        std::make_shared<AccessTraceRecorder>(m_trace, stream, nullptr));
+    return shim;
+  };
+  m_instrShim = recorder(L1CacheShim::CacheType::InstrCache,
+                         MemoryAccessTrace::Stream::Instr);
+  m_dataShim = recorder(L1CacheShim::CacheType::DataCache,
+                        MemoryAccessTrace::Stream::Data);
+}
+
+void CacheSweep::run(const std::vector<CacheSweepConfig> &configs,
+                     CacheSweepResult &result) const {
+  result = CacheSweepResult();
+  result.traceEntries = m_trace->size();
+  result.traceBytes = m_trace->bytes();
+
+  // Caches are constructed on this thread, given that CacheSim binds to the
+  // processor handler upon construction. Replaying is thread safe.
+  std::vector<std::shared_ptr<CacheSim>> caches;
+  std::vector<size_t> jobs;
+  for (size_t i = 0; i < configs.size(); ++i) {
+    auto cache = std::make_shared<CacheSim>(nullptr);
+    cache->setPreset(configs.at(i).config.preset);
+    cache->setPrefetchPolicy(configs.at(i).config.prefetch);
+    cache->setVictimCacheEntries(configs.at(i).config.victim);
+    caches.push_back(cache);
+    jobs.push_back(i);
+  }
+
+  const MemoryAccessTrace &trace = *m_trace;
+  QtConcurrent::blockingMap(jobs, [&](size_t i) {
+    CacheSim &cache = *caches.at(i);
+    const auto stream = configs.at(i).stream;
+    MemoryAccessTrace::Reader reader(trace);
+    MemoryAccessTrace::Entry entry;
+    while (reader.next(entry)) {
+      if (entry.stream == stream)
+        cache.replayAccess(entry.address, entry.type, entry.cycle);
+    }
+  });
+
+  for (size_t i = 0; i < configs.size(); ++i) {
+    CacheSweepResult::Entry entry;
+    entry.config = configs.at(i);
+    entry.hits = caches.at(i)->getHits();
+    entry.misses = caches.at(i)->getMisses();
+    entry.writebacks = caches.at(i)->getWritebacks();
+    entry.victimHits = caches.at(i)->getVictimHits();
+    entry.sizeBits = caches.at(i)->getCacheSize().bits;
+    result.entries.push_back(entry);
+  }
+}
+
+} // namespace Ripes
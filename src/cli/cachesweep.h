@@ -0,0 +1,76 @@
+#pragma once
+
+#include <QString>
+
+#include <memory>
+#include <vector>
+
+#include "cachehierarchy.h"
+#include "cachesim/l1cacheshim.h"
+#include "cachesim/memoryaccesstrace.h"
+
+namespace Ripes {
+
+/**
+ * @brief The CacheSweepConfig struct
+ * A single cache configuration of a design-space sweep, and the access stream
+ * which it is evaluated against.
+ */
+struct CacheSweepConfig {
+  MemoryAccessTrace::Stream stream;
+  // The specification from which the configuration was parsed.
+  QString spec;
+  CacheLevelConfig config;
+};
+
+/**
+ * @brief loadCacheSweepConfigs
+ * Reads a list of sweep configurations from the file at @p path. Each line of
+ * the file holds a stream (i or d) followed by a cache specification, as
+ * accepted by parseCacheLevelConfig. Empty lines and lines starting with # are
+ * ignored. Returns an error message on failure, or an empty string on success.
+ */
+QString loadCacheSweepConfigs(const QString &path,
+                              std::vector<CacheSweepConfig> &configs);
+
+struct CacheSweepResult {
+  struct Entry {
+    CacheSweepConfig config;
+    unsigned hits = 0;
+    unsigned misses = 0;
+    unsigned writebacks = 0;
+    unsigned victimHits = 0;
+    unsigned sizeBits = 0;
+  };
+  std::vector<Entry> entries;
+  size_t traceEntries = 0;
+  size_t traceBytes = 0;
+};
+
+/**
+ * @brief The CacheSweep class
+ * Trace-driven cache design-space exploration. The L1 instruction and data
+ * access streams of the processor are recorded once, after which the trace is
+ * replayed against any number of cache configurations, in parallel.
+ */
+class CacheSweep {
+public:
+  /// Starts recording the access streams of the current processor. The trace
+  /// is cleared whenever the processor is reset.
+  void record();
+
+  const MemoryAccessTrace &trace() const { return *m_trace; }
+
+  /// Replays the recorded trace against each of @p configs, distributed across
+  /// the global thread pool.
+  void run(const std::vector<CacheSweepConfig> &configs,
+           CacheSweepResult &result) const;
+
+private:
+  std::shared_ptr<MemoryAccessTrace> m_trace =
+      std::make_shared<MemoryAccessTrace>();
+  std::unique_ptr<L1CacheShim> m_instrShim;
+  std::unique_ptr<L1CacheShim> m_dataShim;
+};
+
+} // namespace Ripes
@@ -0,0 +1,224 @@
+#include "callgraphprofiler.h"
+
+#include "processorhandler.h"
+
+#include <QFile>
+
+#include <algorithm>
+#include <array>
+
+namespace Ripes {
+
+namespace {
+// The return address register, which calls link to and returns jump through.
+constexpr unsigned c_ra = 1;
+
+// gmon.out record tags.
+constexpr char c_gmonTagHistogram = 0;
+constexpr char c_gmonTagArc = 1;
+} // namespace
+
+CallGraphProfiler::CallGraphProfiler() {
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorClocked, this,
+          [this] { processorClocked(); }, Qt::DirectConnection);
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          [this] { reset(); });
+  reset();
+}
+
+void CallGraphProfiler::reset() {
+  m_text = DecodedText::decode();
+  m_functions.clear();
+  m_functions.push_back({"<unknown>"});
+  m_functionOf.assign(m_text.instrs.size(), 0);
+  if (auto program = ProcessorHandler::getProgram()) {
+    const AInt end = m_text.address(m_text.instrs.size());
+    for (const auto &it : program->symbols) {
+      if (it.first < m_text.start || it.first >= end || it.second.isLocal())
+        continue;
+      // Of several symbols at the same address, the first names the function.
+      if (m_functions.size() > 1 && m_functions.back().address == it.first)
+        continue;
+      Function function;
+      function.name = it.second.v;
+      function.address = it.first;
+      m_functions.push_back(function);
+    }
+    // Symbols are ordered by address.
+    unsigned function = 0;
+    for (size_t i = 0; i < m_functionOf.size(); ++i) {
+      while (function + 1 < m_functions.size() &&
+             m_functions[function + 1].address <= m_text.address(i))
+        function++;
+      m_functionOf[i] = function;
+    }
+  }
+  m_arcs.clear();
+  m_instrCycles.assign(m_text.instrs.size(), 0);
+  m_callSites.clear();
+
+  m_stack.clear();
+  m_depths.assign(m_functions.size(), 0);
+  m_callPending = false;
+
+  const auto *proc = ProcessorHandler::getProcessor();
+  m_finalStages.clear();
+  for (const auto &lane : proc->structure())
+    m_finalStages.push_back({lane.first, lane.second - 1});
+  m_lastRetired = proc->getInstructionsRetired();
+  m_totalCycles = 0;
+  m_pendingCycles = 0;
+}
+
+void CallGraphProfiler::processorClocked() {
+  const auto *proc = ProcessorHandler::getProcessor();
+  m_totalCycles++;
+  m_pendingCycles++;
+
+  const unsigned long long retired = proc->getInstructionsRetired();
+  unsigned long long newlyRetired = retired - m_lastRetired;
+  m_lastRetired = retired;
+
+  for (const auto &stage : m_finalStages) {
+    if (newlyRetired == 0)
+      break;
+    const StageInfo info = proc->stageInfo(stage);
+    if (!info.stage_valid || info.state != StageInfo::State::None)
+      continue;
+    newlyRetired--;
+    retire(info.pc);
+  }
+}
+
+void CallGraphProfiler::retire(AInt pc) {
+  const long idx = m_text.index(pc);
+  const unsigned function = functionOf(idx);
+  m_functions[function].selfCycles += m_pendingCycles;
+  if (idx >= 0)
+    m_instrCycles[idx] += m_pendingCycles;
+  m_pendingCycles = 0;
+
+  if (m_stack.empty()) {
+    // The first retired instruction enters the root function.
+    m_stack.push_back({function, 0});
+    m_depths[function]++;
+  } else if (m_callPending) {
+    // The first instruction retired after a call is the entry of the callee.
+    const unsigned caller = m_stack.back().function;
+    m_functions[function].calls++;
+    m_arcs[{caller, function}].calls++;
+    m_callSites[{m_callSite, pc}]++;
+    m_stack.push_back({function, m_callCycle});
+    m_depths[function]++;
+  }
+  m_callPending = false;
+  if (idx < 0)
+    return;
+
+  const DecodedText::Instr &instr = m_text.instrs[idx];
+  const bool isJump =
+      instr.opcode == RVInstr::JAL || instr.opcode == RVInstr::JALR;
+  if (isJump && instr.rd == c_ra) {
+    m_callPending = true;
+    m_callSite = pc;
+    m_callCycle = m_totalCycles;
+  } else if (instr.opcode == RVInstr::JALR && instr.rd == 0 &&
+             instr.rs1 == c_ra && m_stack.size() > 1) {
+    const Frame frame = m_stack.back();
+    m_stack.pop_back();
+    if (--m_depths[frame.function] == 0) {
+      const unsigned long long cycles = m_totalCycles - frame.entryCycle;
+      m_functions[frame.function].inclusiveCycles += cycles;
+      m_arcs[{m_stack.back().function, frame.function}].cycles += cycles;
+    }
+  }
+}
+
+void CallGraphProfiler::snapshot(std::vector<Function> &functions,
+                                 ArcMap &arcs) const {
+  functions = m_functions;
+  arcs = m_arcs;
+  std::vector<unsigned> depths = m_depths;
+  for (size_t i = m_stack.size(); i-- > 0;) {
+    const Frame &frame = m_stack[i];
+    if (--depths[frame.function] != 0)
+      continue;
+    const unsigned long long cycles = m_totalCycles - frame.entryCycle;
+    functions[frame.function].inclusiveCycles += cycles;
+    if (i > 0)
+      arcs[{m_stack[i - 1].function, frame.function}].cycles += cycles;
+  }
+}
+
+std::vector<CallGraphProfiler::Function> CallGraphProfiler::functions() const {
+  std::vector<Function> functions;
+  ArcMap arcs;
+  snapshot(functions, arcs);
+  return functions;
+}
+
+CallGraphProfiler::ArcMap CallGraphProfiler::arcs() const {
+  std::vector<Function> functions;
+  ArcMap arcs;
+  snapshot(functions, arcs);
+  return arcs;
+}
+
+QString CallGraphProfiler::writeGmon(const QString &path) const {
+  QFile file(path);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    return "Error: Could not open call graph file " + path;
+
+  // gmon.out is written in the byte order of the target, and addresses in the
+  // width of the target.
+  const unsigned addressBytes = ProcessorHandler::currentISA()->bytes();
+  QByteArray out;
+  const auto put = [&](uint64_t value, unsigned bytes) {
+    for (unsigned i = 0; i < bytes; ++i)
+      out.append(static_cast<char>((value >> (8 * i)) & 0xFF));
+  };
+
+  // Header: magic, version and padding.
+  out.append("gmon", 4);
+  put(1, 4);
+  put(0, 12);
+
+  // Histogram, with a bin per instruction granule. Bins are 16-bit counts, so
+  // cycles are scaled down by powers of 1000 until the largest bin fits.
+  static const std::array<const char *, 5> units = {
+      "cycles", "kcycles", "Mcycles", "Gcycles", "Tcycles"};
+  const unsigned long long maxCycles =
+      m_instrCycles.empty()
+          ? 0
+          : *std::max_element(m_instrCycles.begin(), m_instrCycles.end());
+  unsigned unit = 0;
+  unsigned long long scale = 1;
+  while (maxCycles / scale > 0xFFFF && unit + 1 < units.size()) {
+    scale *= 1000;
+    unit++;
+  }
+  out.append(c_gmonTagHistogram);
+  put(m_text.start, addressBytes);
+  put(m_text.address(m_text.instrs.size()), addressBytes);
+  put(m_instrCycles.size(), 4);
+  // One sample per unit, such that gprof reports time in units.
+  put(1, 4);
+  out.append(QByteArray(units[unit]).leftJustified(15, '\0', true));
+  out.append('c');
+  for (const auto cycles : m_instrCycles)
+    put(std::min<unsigned long long>((cycles + scale / 2) / scale, 0xFFFF), 2);
+
+  // Call arcs, from each call site to each callee entry address.
+  for (const auto &it : m_callSites) {
+    out.append(c_gmonTagArc);
+    put(it.first.first, addressBytes);
+    put(it.first.second, addressBytes);
+    put(std::min<unsigned long long>(it.second, 0x7FFFFFFF), 4);
+  }
+
+  if (file.write(out) != out.size())
+    return "Error: Could not write call graph file " + path;
+  return QString();
+}
+
+} // namespace Ripes
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+
+#include <map>
+#include <vector>
+
+#include "textdecoder.h"
+
+namespace Ripes {
+
+/**
+ * @brief The CallGraphProfiler class
+ * Profiles the functions of the current program during simulation, and the
+ * calls between them. Functions are delimited by the (non-local) symbols of
+ * the text section; instructions preceding the first symbol, or outside of the
+ * text section, belong to the <unknown> function.
+ *
+ * Calls and returns are detected upon retirement, following the calling
+ * convention: a call is a JAL or JALR linking to ra, and a return is a JALR to
+ * ra which does not link. Calls push a frame onto a shadow call stack, and
+ * returns pop it. Exclusive (self) cycles are charged upon retirement, as by
+ * HotSpotProfiler. The inclusive cycles of a call span from the retirement of
+ * the call to the retirement of its return; recursive calls are only counted
+ * once, by their outermost frame.
+ */
+class CallGraphProfiler : public QObject {
+public:
+  struct Function {
+    QString name;
+    AInt address = 0;
+    unsigned long long calls = 0;
+    unsigned long long selfCycles = 0;
+    unsigned long long inclusiveCycles = 0;
+  };
+  struct Arc {
+    unsigned long long calls = 0;
+    // Inclusive cycles of the callee, when called from the caller.
+    unsigned long long cycles = 0;
+  };
+  // Arcs are keyed by the (caller, callee) function indices.
+  using ArcMap = std::map<std::pair<unsigned, unsigned>, Arc>;
+
+  CallGraphProfiler();
+
+  /// Returns the profile of each function, including the cycles of the frames
+  /// which have not yet returned. Index 0 is the <unknown> function.
+  std::vector<Function> functions() const;
+  /// Returns the call graph, including the frames which have not yet
+  /// returned.
+  ArcMap arcs() const;
+  unsigned long long totalCycles() const { return m_totalCycles; }
+
+  /// Writes the profile to @p path in the gmon.out format read by gprof: a
+  /// histogram of the cycles of each instruction of the text section, and the
+  /// call arcs from each call site. Returns an error message on failure, or an
+  /// empty string on success.
+  QString writeGmon(const QString &path) const;
+
+private:
+  struct Frame {
+    unsigned function;
+    unsigned long long entryCycle;
+  };
+
+  void reset();
+  void processorClocked();
+  void retire(AInt pc);
+  unsigned functionOf(long idx) const {
+    return idx < 0 ? 0 : m_functionOf[idx];
+  }
+  /// Copies the profile into @p functions and @p arcs, accounting the
+  /// inclusive cycles of the frames which have not yet returned.
+  void snapshot(std::vector<Function> &functions, ArcMap &arcs) const;
+
+  DecodedText m_text;
+  std::vector<unsigned> m_functionOf;
+  std::vector<Function> m_functions;
+  ArcMap m_arcs;
+
+  // Cycles of each instruction of the text section, and the number of calls
+  // from each call site to each callee entry address.
+  std::vector<unsigned long long> m_instrCycles;
+  std::map<std::pair<AInt, AInt>, unsigned long long> m_callSites;
+
+  std::vector<Frame> m_stack;
+  // The number of frames of each function on the call stack.
+  std::vector<unsigned> m_depths;
+  bool m_callPending = false;
+  AInt m_callSite = 0;
+  unsigned long long m_callCycle = 0;
+
+  // The final stage of each lane, which instructions retire from.
+  std::vector<StageIndex> m_finalStages;
+  unsigned long long m_lastRetired = 0;
+  unsigned long long m_totalCycles = 0;
+  unsigned long long m_pendingCycles = 0;
+};
+
+} // namespace Ripes
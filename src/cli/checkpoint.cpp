@@ -0,0 +1,161 @@
+#include "checkpoint.h"
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+#include "syscall/systemio.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QStringList>
+
+namespace Ripes {
+
+static constexpr quint32 s_checkpointMagic = 0x52435054; // "RCPT"
+static constexpr quint32 s_checkpointVersion = 3;
+
+QByteArray checkpointData() {
+  const auto *isa = ProcessorHandler::currentISA();
+
+  QByteArray payload;
+  QDataStream out(&payload, QIODevice::WriteOnly);
+  out << static_cast<qint32>(ProcessorHandler::getID()) << isa->name();
+  const ArchitecturalState state =
+      ProcessorHandler::captureArchitecturalState();
+  out << static_cast<quint64>(state.pc)
+      << static_cast<quint64>(state.programBreak);
+
+  // Register files
+  out << static_cast<quint32>(state.registers.size());
+  for (const auto &rf : state.registers) {
+    out << static_cast<qint32>(rf.first)
+        << static_cast<quint32>(rf.second.size());
+    for (const auto &value : rf.second)
+      out << static_cast<quint64>(value);
+  }
+
+  // CSRs
+  out << static_cast<quint32>(state.csrs.size());
+  for (const auto &csr : state.csrs)
+    out << static_cast<quint32>(csr.first) << static_cast<quint64>(csr.second);
+
+  // Memory regions
+  out << static_cast<quint32>(state.memory.size());
+  for (const auto &region : state.memory)
+    out << static_cast<quint64>(region.first) << region.second;
+
+  // Files opened by the program, which are not restored.
+  const auto files = SystemIO::openFiles();
+  out << static_cast<quint32>(files.size());
+  for (const auto &file : files)
+    out << static_cast<qint32>(file.first) << file.second;
+
+  QByteArray data;
+  QDataStream dataStream(&data, QIODevice::WriteOnly);
+  dataStream << s_checkpointMagic << s_checkpointVersion << qCompress(payload);
+  return data;
+}
+
+QString saveCheckpoint(const QString &filepath) {
+  QFile file(filepath);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    return "Error: Could not open checkpoint file " + filepath;
+  file.write(checkpointData());
+  return QString();
+}
+
+QString loadCheckpoint(const QString &filepath) {
+  QFile file(filepath);
+  if (!file.open(QIODevice::ReadOnly))
+    return "Error: Could not open checkpoint file " + filepath;
+  return applyCheckpointData(file.readAll(), filepath);
+}
+
+QString applyCheckpointData(const QByteArray &data, const QString &name) {
+  QDataStream dataStream(data);
+  quint32 magic, version;
+  QByteArray compressed;
+  dataStream >> magic >> version >> compressed;
+  if (magic != s_checkpointMagic)
+    return "Error: " + name + " is not a Ripes checkpoint";
+  if (version != s_checkpointVersion)
+    return "Error: Unsupported checkpoint version " + QString::number(version);
+
+  const QByteArray payload = qUncompress(compressed);
+  QDataStream in(payload);
+  qint32 procID;
+  QString isaName;
+  quint64 pc, programBreak;
+  in >> procID >> isaName >> pc >> programBreak;
+
+  // Architectural state carries over between processor models implementing
+  // the same ISA.
+  if (isaName != ProcessorHandler::currentISA()->name()) {
+    return "Error: Checkpoint was taken using processor '" +
+           enumToString<ProcessorID>(static_cast<ProcessorID>(procID)) +
+           "' (" + isaName + "), but the current processor is '" +
+           enumToString<ProcessorID>(ProcessorHandler::getID()) + "' (" +
+           ProcessorHandler::currentISA()->name() + ")";
+  }
+
+  ArchitecturalState state;
+  state.pc = pc;
+  state.programBreak = programBreak;
+
+  quint32 nRegFiles;
+  in >> nRegFiles;
+  for (quint32 rf = 0; rf < nRegFiles; ++rf) {
+    qint32 rfid;
+    quint32 nRegs;
+    in >> rfid >> nRegs;
+    auto &regs = state.registers[static_cast<RegisterFileType>(rfid)];
+    for (quint32 i = 0; i < nRegs; ++i) {
+      quint64 value;
+      in >> value;
+      regs.push_back(value);
+    }
+  }
+
+  quint32 nCSRs;
+  in >> nCSRs;
+  for (quint32 i = 0; i < nCSRs; ++i) {
+    quint32 csr;
+    quint64 value;
+    in >> csr >> value;
+    state.csrs[csr] = value;
+  }
+
+  quint32 nRegions;
+  in >> nRegions;
+  for (quint32 r = 0; r < nRegions; ++r) {
+    quint64 address;
+    QByteArray data;
+    in >> address >> data;
+    state.memory[address] = data;
+  }
+
+  quint32 nFiles;
+  in >> nFiles;
+  QStringList files;
+  for (quint32 i = 0; i < nFiles; ++i) {
+    qint32 fd;
+    QString fileName;
+    in >> fd >> fileName;
+    files << fileName + " (fd " + QString::number(fd) + ")";
+  }
+
+  if (in.status() != QDataStream::Ok)
+    return "Error: Checkpoint " + name + " is corrupt";
+
+  // The program would resume with file descriptors which are no longer open.
+  if (!files.isEmpty()) {
+    return "Error: Checkpoint " + name +
+           " was taken while the program had files open, which cannot be "
+           "restored: " +
+           files.join(", ");
+  }
+
+  ProcessorHandler::applyArchitecturalState(state);
+  return QString();
+}
+
+} // namespace Ripes
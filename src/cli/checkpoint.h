@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QString>
+
+namespace Ripes {
+
+/**
+ * Checkpoints store the architectural state of the currently loaded processor
+ * model in a compact (compressed) binary file, allowing a simulation to be
+ * resumed without re-executing the instructions leading up to the checkpoint.
+ *
+ * A checkpoint contains:
+ * - The PC of the oldest in-flight instruction. For pipelined models,
+ *   younger in-flight instructions are re-executed when resuming.
+ * - The contents of all register files of the processor.
+ * - The CSRs holding architectural state, ie. fcsr and the machine-mode trap
+ *   CSRs (see RipesProcessor::getCSRState).
+ * - The memory contents of each section of the loaded program, the heap up to
+ *   the program break, as well as the stack, ranging from the current stack
+ *   pointer up to its initial value.
+ * - The program break.
+ *
+ * Microarchitectural state (pipeline registers, caches) is not checkpointed;
+ * the processor resumes with an empty pipeline and cold caches. A checkpoint
+ * may thus be restored on any processor model implementing the same ISA.
+ * Neither are peripheral registers nor the vector state of the V extension.
+ * The files opened by the program cannot be restored either; checkpoints
+ * taken while the program has files open are rejected when restored. Cycle
+ * and instruction counts are specific to the processor model, and restart
+ * from zero when resuming.
+ */
+
+/// Returns a checkpoint of the current processor state, in the format of
+/// checkpoint files.
+QByteArray checkpointData();
+
+/// Restores processor state from the checkpoint @p data, as returned by
+/// checkpointData(). @p name identifies the checkpoint in error messages.
+/// Returns an error message on failure, or an empty string on success.
+QString applyCheckpointData(const QByteArray &data, const QString &name);
+
+/// Writes a checkpoint of the current processor state to @p filepath.
+/// Returns an error message on failure, or an empty string on success.
+QString saveCheckpoint(const QString &filepath);
+
+/// Restores processor state from the checkpoint at @p filepath. The program
+/// which the checkpoint was taken from must already be loaded. Returns an
+/// error message on failure, or an empty string on success.
+QString loadCheckpoint(const QString &filepath);
+
+} // namespace Ripes
@@ -7,16 +7,107 @@
 
 namespace Ripes {
 
+namespace {
+// Options which may be swept by a parameter sweep (--sweep-<option>).
+const QStringList c_sweepOptions = {"proc", "isaexts", "l1i",
+                                    "l1d",  "l2",      "l3"};
+// Options which do not affect the result of a run, or whose files are keyed
+// on by their content, and are thus not part of the result cache key (see
+// CLIModeOptions::resultOptions).
+const QStringList c_resultNeutralOptions = {"src", "output", "v",
+                                            "mode", "jobs", "result-cache",
+                                            "asm-cache", "console-out",
+                                            "console-flush", "console-buffer",
+                                            "stdin", "checkpoint-in"};
+
+// Returns true if processor @p id replays instruction traces. The features of
+// a model are only known once it is constructed.
+bool replaysTraces(ProcessorID id) {
+  return ProcessorRegistry::constructProcessor(id, {})->features() &
+         RipesProcessor::hasTraceReplay;
+}
+} // namespace
+
 void addCLIOptions(QCommandLineParser &parser, Ripes::CLIModeOptions &options) {
-  parser.addOption(QCommandLineOption("src", "Path to source file.", "path"));
   parser.addOption(QCommandLineOption(
-      "t", "Source file type. Options: [c, asm, bin]", "type", "asm"));
+      "src",
+      "Path to source file. May be specified multiple times, in which case "
+      "each source is simulated separately and reported on individually.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "batch",
+      "Executes each run of the given JSON manifest within this process, "
+      "writing the JSON report of each run as a line of the output. Runs "
+      "specify their own source, processor and options.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "server",
+      "Serves requests read from stdin, each a line of JSON holding the "
+      "options of a run as in a batch manifest (--batch), and writes the "
+      "result of each to stdout as a line of JSON. Processor models are kept "
+      "across requests."));
+  parser.addOption(QCommandLineOption(
+      "sweep",
+      "Runs each source on the cartesian product of the values of the swept "
+      "options (--sweep-<option>), writing the report of each configuration "
+      "as a row of the output. The remaining options apply to every "
+      "configuration. Configurations are distributed across --jobs worker "
+      "processes."));
+  for (const auto &option : c_sweepOptions)
+    parser.addOption(QCommandLineOption(
+        "sweep-" + option,
+        "Value of --" + option +
+            " to sweep (see --sweep). May be specified multiple times.",
+        "value"));
+  parser.addOption(QCommandLineOption(
+      "shared-frontend",
+      "Executes each source of a sweep (--sweep) once, on the functional "
+      "processor of the XLEN of the swept processors, and replays its "
+      "committed instructions (see --replay-trace) on each configuration "
+      "while it executes, in place of executing the program for each "
+      "configuration. Requires superscalar or out-of-order timing models; "
+      "other processors are rejected."));
+  parser.addOption(QCommandLineOption(
+      "sweep-format",
+      "Format of the rows of a parameter sweep. Options: [json, csv]. 'json' "
+      "writes a line of JSON per configuration, and 'csv' a table with a "
+      "column per swept option and per (flattened) report value.",
+      "format", "json"));
+  parser.addOption(QCommandLineOption(
+      "jobs",
+      "Number of worker processes to distribute sources (or sweep "
+      "configurations) across when multiple sources are specified.",
+      "N", "1"));
+  parser.addOption(QCommandLineOption(
+      "nodes",
+      "Distributes the runs of a batch (--batch) or the configurations of a "
+      "sweep (--sweep) across the given worker nodes (--worker), in place of "
+      "--jobs. Sources are referred to by path, which must resolve on every "
+      "node.",
+      "host:port,..."));
+  parser.addOption(QCommandLineOption(
+      "node-retries",
+      "Number of times a run lost to a failing worker node (--nodes) is "
+      "retried on another node before it is reported as failed.",
+      "N", "2"));
+  parser.addOption(QCommandLineOption(
+      "worker",
+      "Serves runs distributed by a coordinator (--nodes) on the given TCP "
+      "port, executing up to --jobs runs at a time. The remaining options "
+      "apply to every run. Runs are not authenticated; only expose the port "
+      "to trusted networks.",
+      "port"));
+  parser.addOption(QCommandLineOption(
+      "t",
+      "Source file type. Options: [c, asm, bin, elf, session]. Sessions "
+      "(saved by the GUI) are resumed from their checkpoint, if any; their "
+      "processor and cache configuration is not applied.",
+      "type", "asm"));
 
   // Processor models. Generate information from processor registry.
   QStringList processorOptions;
-  for (int i = 0; i < ProcessorID::NUM_PROCESSORS; i++)
-    processorOptions.push_back(
-        enumToString<ProcessorID>(static_cast<ProcessorID>(i)));
+  for (const auto &desc : ProcessorRegistry::getAvailableProcessors())
+    processorOptions.push_back(enumToString<ProcessorID>(desc.first));
   QString desc =
       "Processor model. Options: [" + processorOptions.join(", ") + "]";
   parser.addOption(QCommandLineOption("proc", desc, "name"));
@@ -30,27 +121,556 @@ void addCLIOptions(QCommandLineParser &parser, Ripes::CLIModeOptions &options) {
       "value may be specified in signed, hex, or boolean notation. Format:\n"
       "<register idx>=<value>,<register idx>=<value>",
       "[rid:v]"));
+  parser.addOption(QCommandLineOption(
+      "console-out",
+      "Writes the console output of the simulated program to the given file "
+      "rather than to stdout.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "console-flush",
+      "Policy by which the console output of the simulated program is "
+      "flushed. Options: [newline, size, exit]. 'newline' flushes on each "
+      "newline, 'size' when --console-buffer bytes are buffered and 'exit' "
+      "once the program ends.",
+      "policy", "newline"));
+  parser.addOption(QCommandLineOption(
+      "console-buffer",
+      "Size in bytes of the console output buffer (see --console-flush).",
+      "bytes", "65536"));
+  parser.addOption(QCommandLineOption(
+      "stdin",
+      "Streams the given file into the standard input of the simulated "
+      "program, rather than the standard input of Ripes.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "io",
+      "Maps a headless peripheral into the address space of the processor, "
+      "exporting the same symbols as in the IO tab. May be specified multiple "
+      "times. Options: [ledmatrix[:<width>x<height>], switches[:<count>], "
+      "dpad, dma[:<bytes per cycle>], timer].",
+      "peripheral"));
+  parser.addOption(QCommandLineOption(
+      "io-script",
+      "Replays the input events of the given file into the peripherals (--io). "
+      "Each line holds '<cycle> <peripheral> <value...>', ie. "
+      "'1000 SWITCHES_0 0b101' or '1000 D_PAD_0 UP 1'.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "io-log",
+      "Logs each write which changes the color of an LED of the peripherals "
+      "(--io) to the given file, as '<cycle> <peripheral> <led> <color>'.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "io-header",
+      "Writes the C header of the symbols of the peripherals (--io), "
+      "ripes_system.h, to the given file.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "link",
+      "Assembly file linked into the program of each assembly source (-t "
+      "asm), following the source, ie. a library or driver shared between "
+      "sources. May be specified multiple times. Each file is assembled "
+      "separately, such that within a process (ie. --batch and --server) "
+      "unchanged files are not reassembled.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "asm-cache",
+      "Caches assembled programs in the given directory, keyed on the source, "
+      "ISA, extensions and segment addresses, such that unchanged sources are "
+      "not reassembled by later invocations.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "result-cache",
+      "Caches the report of each run in the given directory, keyed on the "
+      "source, processor, ISA extensions, register initialization, cache "
+      "configuration, telemetry and other simulation options, such that later "
+      "identical runs return the stored report without simulating.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "virtual-time",
+      "Derives the time seen by programs (Time_msec syscall) from the cycle "
+      "count at the given simulated clock frequency, rather than from the "
+      "wall clock of the host.",
+      "Hz"));
+  parser.addOption(QCommandLineOption(
+      "syscall-abi",
+      "System call ABI of the program. Options: [rars, newlib]. newlib "
+      "provides the Linux syscalls issued by programs built with a newlib "
+      "toolchain.",
+      "abi", "rars"));
+  parser.addOption(QCommandLineOption(
+      "branch-predictor",
+      "Branch predictor of processors implementing branch prediction. "
+      "Options: [nottaken, btfn, bimodal, gshare].",
+      "scheme", "nottaken"));
+  parser.addOption(QCommandLineOption(
+      "mul-latency",
+      "Latency in cycles of M-extension multiplications, within [1, 64].",
+      "cycles", "1"));
+  parser.addOption(QCommandLineOption(
+      "div-latency",
+      "Latency in cycles of M-extension divisions and remainders, within "
+      "[1, 64].",
+      "cycles", "1"));
+  parser.addOption(QCommandLineOption(
+      "hart-quantum",
+      "Cycles which the harts of multi-hart processors execute in between "
+      "synchronizing. Quanta larger than 1 execute the harts concurrently on "
+      "host threads.",
+      "cycles", "1"));
+  parser.addOption(QCommandLineOption(
+      "vlen",
+      "Width in bits of the vector registers of the V extension; a power of "
+      "two within [64, 4096].",
+      "bits", "128"));
+  parser.addOption(QCommandLineOption(
+      "nonserializing-ecalls",
+      "Handle the ecalls of output-only syscalls (print) without draining the "
+      "outstanding register writes of the pipelined processors first."));
   parser.addOption(QCommandLineOption(
       "timeout",
       "Simulation timeout in milliseconds. If simulation does not finish "
       "within the specified time, it will be aborted.",
       "ms", "0"));
+  parser.addOption(QCommandLineOption(
+      "max-cycles",
+      "Stops simulation once the processor model has executed the given "
+      "number of cycles. Unlike --timeout, the point at which simulation "
+      "stops does not depend on the load of the host.",
+      "cycles", "0"));
+  parser.addOption(QCommandLineOption(
+      "max-instrs",
+      "Stops simulation once the processor model has retired the given number "
+      "of instructions.",
+      "instrs", "0"));
+  parser.addOption(QCommandLineOption(
+      "checkpoint-in",
+      "Checkpoint file to restore processor state from after the program has "
+      "been loaded. Pipelines and caches start out empty, and checkpoints "
+      "taken while the program had files open are rejected.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "checkpoint-out",
+      "Checkpoint file to write the processor state to once simulation ends "
+      "(finished or timed out).",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "fork",
+      "Forks the simulation once it ends (finished, timed out or stopped at a "
+      "run limit) into a child which resumes from its state with the given "
+      "options (ie. \"--proc RV32_OOO --l1d lines=64\"), in addition to "
+      "those of this run. May be specified multiple times; the children run "
+      "in parallel, and their reports are included in the report of this "
+      "run.",
+      "options"));
+  parser.addOption(QCommandLineOption(
+      "fast-forward",
+      "Number of instructions to execute on a functional instruction set "
+      "simulator before transferring architectural state to the selected "
+      "processor model. Reported telemetry only covers the detailed part of "
+      "the simulation.",
+      "instrs", "0"));
+  parser.addOption(QCommandLineOption(
+      "warm-caches",
+      "Warms the cache hierarchy with the memory accesses of the instructions "
+      "executed while fast-forwarding (--fast-forward), such that the caches "
+      "are not cold once detailed simulation starts. Warming only updates the "
+      "cache state; the reported statistics cover the detailed part of the "
+      "simulation."));
+  parser.addOption(QCommandLineOption(
+      "no-translation",
+      "Executes the functional ISS (RV32_ISS, RV64_ISS and fast-forwarding) "
+      "instruction by instruction, rather than as translated basic blocks."));
+  parser.addOption(QCommandLineOption(
+      "simpoint-interval",
+      "Enables sampled simulation. The program is profiled functionally in "
+      "intervals of the given number of instructions, and only a "
+      "representative subset of intervals is simulated on the selected "
+      "processor model. CPI/IPC telemetry is extrapolated from these.",
+      "instrs", "0"));
+  parser.addOption(QCommandLineOption(
+      "simpoints",
+      "Maximum number of simulation points for sampled simulation.", "N",
+      "10"));
+  parser.addOption(QCommandLineOption(
+      "steady-state",
+      "Accelerates simulation of loops which reach a steady state: once the "
+      "pipeline states of each cycle repeat over the given number of "
+      "consecutive periods, retiring the same instructions, execution "
+      "continues functionally for as long as it follows the period, "
+      "extrapolating cycles from it. Detailed simulation resumes with an "
+      "empty pipeline at the first diverging instruction. Cycle, "
+      "instruction, CPI and IPC telemetry include the extrapolated part.",
+      "periods", "0"));
+  parser.addOption(QCommandLineOption(
+      "steady-state-period",
+      "Longest period, in cycles, detected by --steady-state.", "cycles",
+      "1024"));
+  parser.addOption(QCommandLineOption(
+      "cosim",
+      "Co-simulates the selected processor model in lockstep with the given "
+      "reference processor model (ie. RV32_ISS), comparing register state "
+      "after each change. Simulation stops at the first divergence.",
+      "name"));
+  parser.addOption(QCommandLineOption(
+      "gdb",
+      "Serves a GDB remote serial protocol session on the given local TCP "
+      "port (ie. target remote :1234) in place of running the program.",
+      "port"));
+  const QString cacheSpec =
+      " Format: preset=<name>,lines=<n>,ways=<n>,blocks=<n>,latency=<cycles>,"
+      "wp=<wb|wt>,wa=<alloc|noalloc>,repl=<lru|plru|fifo|srrip|random>,"
+      "prefetch=<none|nextline|stride|stream>,victim=<lines>. All parameters "
+      "are optional; parameters following a preset override it. victim "
+      "attaches a fully-associative victim cache of the given number of "
+      "lines.";
+  parser.addOption(QCommandLineOption(
+      "l1i", "Simulates an L1 instruction cache." + cacheSpec, "config"));
+  parser.addOption(QCommandLineOption(
+      "l1d", "Simulates an L1 data cache." + cacheSpec, "config"));
+  parser.addOption(QCommandLineOption(
+      "l2",
+      "Simulates a unified L2 cache, shared between the L1 caches." + cacheSpec,
+      "config"));
+  parser.addOption(QCommandLineOption(
+      "l3", "Simulates a unified L3 cache below the L2 cache." + cacheSpec,
+      "config"));
+  parser.addOption(QCommandLineOption(
+      "cache-inclusion",
+      "Inclusion of the lines of the L1 caches in the L2 cache, and of the L2 "
+      "cache in the L3 cache. Options: "
+      "nine (non-inclusive non-exclusive), inclusive (evictions invalidate the "
+      "lines in the caches above), exclusive (lines are moved up upon hits, "
+      "and only the lines evicted from the caches above are allocated).",
+      "policy", "nine"));
+  parser.addOption(QCommandLineOption(
+      "coherence-protocol",
+      "Protocol keeping the per-hart L1 data caches of the coherence "
+      "simulation (--coherence) coherent. Options: msi, mesi.",
+      "protocol", "mesi"));
+  parser.addOption(QCommandLineOption(
+      "coherence-l1",
+      "Configuration of each per-hart L1 data cache of the coherence "
+      "simulation (--coherence), which are always write-back and "
+      "write-allocate." +
+          cacheSpec,
+      "config"));
+  parser.addOption(QCommandLineOption(
+      "coherence-l2",
+      "Configuration of the shared L2 cache of the coherence simulation "
+      "(--coherence). Defaults to a 256-line, 4-way cache." +
+          cacheSpec,
+      "config"));
+  parser.addOption(QCommandLineOption(
+      "coherence-top",
+      "Number of cache lines to report in the coherence simulation "
+      "(--coherence).",
+      "N", "10"));
+  parser.addOption(QCommandLineOption(
+      "mem-latency",
+      "Latency in cycles of accesses which miss in the last level cache. Used "
+      "for estimating memory stall cycles.",
+      "cycles", "100"));
+  parser.addOption(QCommandLineOption(
+      "cache-timing",
+      "Stalls the processor for the latency of each access to the cache "
+      "hierarchy, such that cycle counts include memory stalls. Accesses "
+      "which miss in the last level cache take --mem-latency additional "
+      "cycles, or the latency of the DRAM model (--dram)."));
+  parser.addOption(QCommandLineOption(
+      "tlb",
+      "Estimates the TLB reach and page walk cost of the accesses to the "
+      "cache hierarchy, with instruction and data TLBs over an identity "
+      "mapping through Sv32 or Sv39 page tables, for RV32 and RV64 "
+      "respectively. Addresses are not translated. TLB misses walk the page "
+      "tables through the data side of the hierarchy. Format: "
+      "entries=<n>,ways=<n>,repl=<lru|fifo|random>,page=<4k|4m|2m|1g>,"
+      "root=<address>, defaulting to 32 entries, 4 ways, LRU replacement, "
+      "4 KiB pages and a root page table at 0xc0000000.",
+      "config"));
+  parser.addOption(QCommandLineOption(
+      "store-buffer",
+      "Simulates a store buffer in front of the data side of the cache "
+      "hierarchy, such that stores only stall the processor once the buffer "
+      "is full, and loads of buffered stores are forwarded from it. Format: "
+      "entries=<n>,drain=<eager|lazy>, defaulting to 4 entries drained "
+      "eagerly; lazy buffers drain only once full.",
+      "config"));
+  parser.addOption(QCommandLineOption(
+      "dram",
+      "Simulates main memory below the last level cache as banks of rows with "
+      "row buffers, in place of the fixed --mem-latency. Format: "
+      "banks=<n>,row=<bytes>,trcd=<cycles>,tcas=<cycles>,trp=<cycles>,"
+      "burst=<cycles>, defaulting to 8 banks of 2048-byte rows, "
+      "tRCD=tCAS=tRP=14 and a 4-cycle burst.",
+      "config"));
+  parser.addOption(QCommandLineOption(
+      "fetch-buffer",
+      "Simulates a fetch buffer with a loop buffer in front of the "
+      "instruction side of the cache hierarchy, serving sequential fetches "
+      "within the last fetched block and the fetches of small loops without "
+      "accessing the caches. Format: block=<bytes>,loop=<bytes>, defaulting "
+      "to a 16-byte block and a 64-byte loop buffer; loop=0 disables the loop "
+      "buffer.",
+      "config"));
+  parser.addOption(QCommandLineOption(
+      "cache-sweep",
+      "Records the L1 instruction and data access streams during simulation, "
+      "and replays them against each cache configuration listed in the given "
+      "file. Each line of the file holds a stream (i or d) followed by a "
+      "cache configuration (see --l1i).",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "cache-trace-out",
+      "Writes the L1 instruction and data access streams recorded during "
+      "simulation to the given file.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "pipeline-trace",
+      "Streams the stage occupancy of each simulated cycle to the given file "
+      "(see --pipeline-trace-format).",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "vcd",
+      "Streams the values of the selected signals of the processor model "
+      "(see --vcd-signals) after each cycle to the given Value Change Dump "
+      "file.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "mem-trace",
+      "Streams every instruction and data memory access (cycle, PC, address, "
+      "size and type) to the given binary file.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "mem-trace-compress",
+      "Compresses the memory access trace (--mem-trace) in zlib blocks."));
+  parser.addOption(QCommandLineOption(
+      "shm-trace",
+      "Publishes the events of --shm-trace-events into a ring buffer in the "
+      "POSIX shared memory object of the given name, for external tools to "
+      "consume live (see docs/cli.md).",
+      "name"));
+  parser.addOption(QCommandLineOption(
+      "shm-trace-events",
+      "Events published to the shared memory trace (--shm-trace), comma "
+      "separated. Options: [retire, mem, stage].",
+      "events", "retire,mem"));
+  parser.addOption(QCommandLineOption(
+      "shm-trace-records",
+      "Number of records held by the ring buffer of the shared memory trace "
+      "(--shm-trace); a power of two. Each record is 32 bytes.",
+      "N", "1048576"));
+  parser.addOption(QCommandLineOption(
+      "shm-trace-drop",
+      "Drops records which do not fit the ring buffer of the shared memory "
+      "trace (--shm-trace), rather than waiting for the consumer."));
+  parser.addOption(QCommandLineOption(
+      "commit-log",
+      "Streams a line per committed instruction (PC, instruction, register "
+      "and memory writes) to the given file, in the format of Spike's "
+      "--log-commits.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "commit-log-annotate",
+      "Annotates each line of the commit log (--commit-log) with the cycle of "
+      "the commit and the disassembled instruction."));
+  parser.addOption(QCommandLineOption(
+      "replay-trace",
+      "Replays the committed instructions of the given commit log (see "
+      "--commit-log) on a superscalar or out-of-order timing model, in place "
+      "of executing the program, to evaluate the timing of a recorded "
+      "execution. Other processors are rejected.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "replay-follow",
+      "Follows the commit log of --replay-trace while it is being written, "
+      "until its end marker, such that a trace is replayed as it is "
+      "recorded."));
+  parser.addOption(QCommandLineOption(
+      "syscall-log",
+      "Streams a line per system call (cycle, name, arguments, return value, "
+      "bytes transferred and host time) to the given file. Implies "
+      "--syscalls.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "callgraph-out",
+      "Writes the function profile and call graph to the given file in the "
+      "gmon.out format of gprof. Implies --callgraph.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "plugin",
+      "Loads an observer plugin from the given shared library, which observes "
+      "the execution of each source file (see docs/cli.md). May be "
+      "repeated.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "watch",
+      "Stops simulation once a data access of the processor model reads or "
+      "writes the given address range. Format: <address>[:<bytes>][:r|w|rw], "
+      "watching writes of a single byte by default. May be repeated.",
+      "range"));
+  parser.addOption(QCommandLineOption(
+      "objdump",
+      "Writes an objdump-style disassembly listing of the text section of the "
+      "program to the given file.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "dump-memory",
+      "Dumps the given range of memory once simulation ends (see "
+      "--dump-memory-out). Format: <address>:<bytes>. May be repeated.",
+      "range"));
+  parser.addOption(QCommandLineOption(
+      "dump-memory-out", "File to write the memory dump (--dump-memory) to.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "dump-memory-format",
+      "Format of the memory dump (--dump-memory). Options: [raw, hex, binary, "
+      "unsigned, signed]. Formatted dumps hold a line per 16 bytes, of the "
+      "address followed by the values in the given radix.",
+      "format", "hex"));
+  parser.addOption(QCommandLineOption(
+      "dump-memory-width",
+      "Width in bytes of the values of formatted memory dumps "
+      "(--dump-memory-format). Options: [1, 2, 4, 8].",
+      "bytes", "4"));
+  parser.addOption(QCommandLineOption(
+      "pipeline-trace-format",
+      "Format of the pipeline trace (--pipeline-trace). Options: [kanata, "
+      "binary]. Kanata traces may be viewed in the Konata pipeline viewer.",
+      "format", "kanata"));
+  parser.addOption(QCommandLineOption(
+      "vcd-signals",
+      "Comma-separated wildcard patterns of the signals dumped by --vcd, "
+      "matched against the output ports of the processor model, ie. "
+      "\"idex_reg.*\".",
+      "patterns", c_vcdDefaultSignals));
+  parser.addOption(QCommandLineOption(
+      "stackdist-block",
+      "Block size in bytes of the stack distance profile (--stackdist).",
+      "bytes", "16"));
+  parser.addOption(QCommandLineOption(
+      "profile-top",
+      "Number of instructions to report in the hot spot profile (--profile).",
+      "N", "10"));
+  parser.addOption(QCommandLineOption(
+      "source-lines-top",
+      "Number of source lines to report in the source line profile "
+      "(--source-lines).",
+      "N", "10"));
+  parser.addOption(QCommandLineOption(
+      "sample-interval",
+      "Interval in cycles at which the time series (--timeseries) is "
+      "sampled. Implies --timeseries.",
+      "N", "10000"));
+  parser.addOption(QCommandLineOption(
+      "branches-top",
+      "Number of branches to report in the branch profile (--branches).", "N",
+      "10"));
+  parser.addOption(QCommandLineOption(
+      "hazards-top",
+      "Number of basic blocks to report in the static hazard analysis "
+      "(--hazards).",
+      "N", "10"));
+  parser.addOption(QCommandLineOption(
+      "ilp-windows",
+      "Comma-separated instruction window sizes of the ILP limit study "
+      "(--ilp), in addition to an unbounded window.",
+      "sizes", "16,64,256"));
+  parser.addOption(QCommandLineOption(
+      "footprint-page",
+      "Page size in bytes of the memory footprint profile (--footprint).",
+      "bytes", "4096"));
+  parser.addOption(QCommandLineOption(
+      "footprint-interval",
+      "Interval in cycles at which the working set of the memory footprint "
+      "profile (--footprint) is sampled.",
+      "N", "10000"));
+  parser.addOption(QCommandLineOption(
+      "footprint-top",
+      "Number of pages to report in the memory footprint profile "
+      "(--footprint).",
+      "N", "10"));
+  parser.addOption(QCommandLineOption(
+      "reuse-block",
+      "Cache line size in bytes of the reuse distance profile (--reuse).",
+      "bytes", "64"));
+  parser.addOption(QCommandLineOption(
+      "reuse-capacity",
+      "Cache size in bytes for which the reuse distance profile (--reuse) "
+      "ranks loads and stores by their misses.",
+      "bytes", "32768"));
+  parser.addOption(QCommandLineOption(
+      "reuse-top",
+      "Number of loads and stores to report in the reuse distance profile "
+      "(--reuse).",
+      "N", "10"));
+  parser.addOption(QCommandLineOption(
+      "host-trace",
+      "Writes a Chrome trace event file (viewable in Perfetto) of the "
+      "host-side phases of the simulator: assembling, loading, processor "
+      "construction, running, system calls and view refreshes. Also applies "
+      "in GUI mode.",
+      "path"));
   parser.addOption(QCommandLineOption("v", "Verbose output"));
   parser.addOption(QCommandLineOption(
       "output", "Report output file. If not set, report is printed to stdout.",
       "path"));
   parser.addOption(QCommandLineOption("json", "JSON-formatted report."));
+  parser.addOption(QCommandLineOption(
+      "report-format",
+      "Format of the report. Options: [text, json, jsonl, cbor]. 'json' is "
+      "equivalent to --json. 'jsonl' and 'cbor' stream the report of each "
+      "telemetry as it is collected, as JSON Lines or as a CBOR sequence.",
+      "format", "text"));
 
   parser.addOption(QCommandLineOption("all", "Enable all report options."));
 
   // telemetry reporting
-  options.telemetry.push_back(std::make_shared<CyclesTelemetry>());
-  options.telemetry.push_back(std::make_shared<InstrsRetiredTelemetry>());
-  options.telemetry.push_back(std::make_shared<CPITelemetry>());
-  options.telemetry.push_back(std::make_shared<IPCTelemetry>());
+  options.simPointResult = std::make_shared<SimPointResult>();
+  options.steadyStateResult = std::make_shared<SteadyStateResult>();
+  options.telemetry.push_back(
+      std::make_shared<CyclesTelemetry>(options.steadyStateResult));
+  options.telemetry.push_back(
+      std::make_shared<InstrsRetiredTelemetry>(options.steadyStateResult));
+  options.telemetry.push_back(std::make_shared<CPITelemetry>(
+      options.simPointResult, options.steadyStateResult));
+  options.telemetry.push_back(std::make_shared<IPCTelemetry>(
+      options.simPointResult, options.steadyStateResult));
   options.telemetry.push_back(std::make_shared<PipelineTelemetry>());
+  options.telemetry.push_back(std::make_shared<StageTelemetry>());
+  options.telemetry.push_back(std::make_shared<CPIStackTelemetry>());
   options.telemetry.push_back(std::make_shared<RegisterTelemetry>());
+  options.telemetry.push_back(
+      std::make_shared<SimPointTelemetry>(options.simPointResult));
+  options.telemetry.push_back(
+      std::make_shared<SteadyStateTelemetry>(options.steadyStateResult));
+  options.telemetry.push_back(std::make_shared<ProfileTelemetry>(&parser));
+  options.telemetry.push_back(std::make_shared<BranchTelemetry>(&parser));
+  options.telemetry.push_back(std::make_shared<HazardTelemetry>(&parser));
+  options.telemetry.push_back(std::make_shared<InstructionMixTelemetry>());
+  options.telemetry.push_back(std::make_shared<IlpTelemetry>(&parser));
+  options.telemetry.push_back(std::make_shared<CallGraphTelemetry>());
   options.telemetry.push_back(std::make_shared<RunInfoTelemetry>(&parser));
+  options.telemetry.push_back(std::make_shared<SimPerfTelemetry>());
+  options.telemetry.push_back(std::make_shared<SyscallTelemetry>());
+  options.telemetry.push_back(std::make_shared<AtomicTelemetry>());
+  options.telemetry.push_back(std::make_shared<ComponentProfileTelemetry>());
+  options.cacheHierarchy = std::make_shared<CacheHierarchy>();
+  options.telemetry.push_back(
+      std::make_shared<CacheTelemetry>(options.cacheHierarchy));
+  options.telemetry.push_back(std::make_shared<CoherenceTelemetry>(&parser));
+  options.telemetry.push_back(std::make_shared<TimeSeriesTelemetry>(
+      &parser, options.cacheHierarchy));
+  options.telemetry.push_back(std::make_shared<SourceLineTelemetry>(
+      &parser, options.cacheHierarchy));
+  options.cacheSweepResult = std::make_shared<CacheSweepResult>();
+  options.telemetry.push_back(
+      std::make_shared<CacheSweepTelemetry>(options.cacheSweepResult));
+  options.telemetry.push_back(
+      std::make_shared<StackDistanceTelemetry>(&parser));
+  options.telemetry.push_back(std::make_shared<FootprintTelemetry>(&parser));
+  options.telemetry.push_back(std::make_shared<MemoryTelemetry>());
+  options.telemetry.push_back(std::make_shared<ReuseTelemetry>(&parser));
 
   for (auto &telemetry : options.telemetry) {
     QString desc = "Report " + telemetry->description();
@@ -63,11 +683,278 @@ bool parseCLIOptions(QCommandLineParser &parser, QString &errorMessage,
                      CLIModeOptions &options) {
   options.verbose = parser.isSet("v");
 
+  options.consoleOut = parser.value("console-out");
+  const QString consoleFlush = parser.value("console-flush");
+  if (consoleFlush == "newline") {
+    options.consoleFlush = ConsoleOutput::FlushPolicy::Newline;
+  } else if (consoleFlush == "size") {
+    options.consoleFlush = ConsoleOutput::FlushPolicy::Size;
+  } else if (consoleFlush == "exit") {
+    options.consoleFlush = ConsoleOutput::FlushPolicy::Exit;
+  } else {
+    errorMessage = "Invalid console flush policy '" + consoleFlush +
+                   "' (--console-flush).";
+    return false;
+  }
+  bool consoleBufferOk;
+  options.consoleBuffer =
+      parser.value("console-buffer").toInt(&consoleBufferOk);
+  if (!consoleBufferOk || options.consoleBuffer <= 0) {
+    errorMessage = "Invalid console buffer size '" +
+                   parser.value("console-buffer") + "' (--console-buffer).";
+    return false;
+  }
+  options.stdinFile = parser.value("stdin");
+  for (const auto &spec : parser.values("io")) {
+    IODeviceSpec device;
+    errorMessage = parseIODeviceSpec(spec, device);
+    if (!errorMessage.isEmpty())
+      return false;
+    options.ioDevices.push_back(device);
+  }
+  options.ioScript = parser.value("io-script");
+  options.ioLog = parser.value("io-log");
+  options.ioHeader = parser.value("io-header");
+  if (options.ioDevices.empty() &&
+      !(options.ioScript.isEmpty() && options.ioLog.isEmpty())) {
+    errorMessage = "An IO script or log (--io-script/--io-log) requires "
+                   "peripherals (--io).";
+    return false;
+  }
+  options.asmCacheDir = parser.value("asm-cache");
+  options.resultCacheDir = parser.value("result-cache");
+
+  const QString syscallABI = parser.value("syscall-abi");
+  if (syscallABI == "rars") {
+    options.syscallABI = SyscallABI::RARS;
+  } else if (syscallABI == "newlib") {
+    options.syscallABI = SyscallABI::Newlib;
+  } else {
+    errorMessage = "Invalid system call ABI '" + syscallABI +
+                   "' (--syscall-abi). Options: [rars, newlib].";
+    return false;
+  }
+
+  const QString branchPredictor = parser.value("branch-predictor");
+  const int scheme = BranchPredictor::schemeNames().indexOf(branchPredictor);
+  if (scheme < 0) {
+    errorMessage = "Invalid branch predictor '" + branchPredictor +
+                   "' (--branch-predictor). Options: [" +
+                   BranchPredictor::schemeNames().join(", ") + "].";
+    return false;
+  }
+  options.branchPredictor = static_cast<BranchPredictor::Scheme>(scheme);
+
+  for (const auto &[option, latency] :
+       {std::make_pair("mul-latency", &options.mextTiming.mulLatency),
+        std::make_pair("div-latency", &options.mextTiming.divLatency)}) {
+    bool ok;
+    *latency = parser.value(option).toUInt(&ok);
+    if (!ok || *latency < 1 ||
+        *latency > RipesProcessor::MExtTiming::s_maxLatency) {
+      errorMessage = "Invalid latency '" + parser.value(option) + "' (--" +
+                     option + "). Must be within [1, 64].";
+      return false;
+    }
+  }
+
+  bool hartQuantumOk;
+  options.hartQuantum = parser.value("hart-quantum").toUInt(&hartQuantumOk);
+  if (!hartQuantumOk || options.hartQuantum == 0) {
+    errorMessage = "Invalid hart quantum '" + parser.value("hart-quantum") +
+                   "' (--hart-quantum).";
+    return false;
+  }
+
+  options.nonSerializingEcalls = parser.isSet("nonserializing-ecalls");
+
+  bool vlenOk;
+  options.vlen = parser.value("vlen").toUInt(&vlenOk);
+  if (!vlenOk || options.vlen < RipesProcessor::s_minVLEN ||
+      options.vlen > RipesProcessor::s_maxVLEN ||
+      (options.vlen & (options.vlen - 1)) != 0) {
+    errorMessage = "Invalid VLEN '" + parser.value("vlen") +
+                   "' (--vlen). Must be a power of two within [64, 4096].";
+    return false;
+  }
+
+  if (parser.isSet("virtual-time")) {
+    bool ok;
+    options.virtualClockHz = parser.value("virtual-time").toULongLong(&ok);
+    if (!ok || options.virtualClockHz == 0) {
+      errorMessage = "Invalid clock frequency specified (--virtual-time).";
+      return false;
+    }
+  }
+
+  if (parser.isSet("jobs")) {
+    bool ok;
+    options.jobs = parser.value("jobs").toInt(&ok);
+    if (!ok || options.jobs < 1) {
+      errorMessage = "Invalid number of jobs specified (--jobs).";
+      return false;
+    }
+  }
+
+  if (parser.isSet("nodes")) {
+    const QString err = parseWorkerNodes(parser.value("nodes"), options.nodes);
+    if (!err.isEmpty()) {
+      errorMessage = err + " (--nodes).";
+      return false;
+    }
+    if (!parser.isSet("batch") && !parser.isSet("sweep")) {
+      errorMessage = "Worker nodes (--nodes) can only be used by batch "
+                     "(--batch) or sweep (--sweep) mode.";
+      return false;
+    }
+    bool ok;
+    options.nodeRetries = parser.value("node-retries").toUInt(&ok);
+    if (!ok) {
+      errorMessage = "Invalid number of retries specified (--node-retries).";
+      return false;
+    }
+  }
+
+  // The runs served by a worker are parsed by its server mode processes.
+  if (parser.isSet("worker")) {
+    bool ok;
+    const unsigned port = parser.value("worker").toUInt(&ok);
+    if (!ok || port == 0 || port > 0xFFFF) {
+      errorMessage =
+          "Invalid worker port '" + parser.value("worker") + "' (--worker).";
+      return false;
+    }
+    if (parser.isSet("src") || parser.isSet("batch") ||
+        parser.isSet("server") || parser.isSet("sweep") ||
+        parser.isSet("nodes")) {
+      errorMessage = "Worker mode (--worker) cannot be combined with source "
+                     "files (--src), batch (--batch), server (--server), sweep "
+                     "(--sweep) or worker nodes (--nodes).";
+      return false;
+    }
+    options.workerPort = port;
+    return true;
+  }
+
+  // The configurations of a sweep are parsed by the runner, as runs of a
+  // batch.
+  if (parser.isSet("sweep")) {
+    if (parser.isSet("batch") || parser.isSet("server")) {
+      errorMessage = "A parameter sweep (--sweep) cannot be combined with "
+                     "batch (--batch) or server (--server) mode.";
+      return false;
+    }
+    if (!parser.isSet("src")) {
+      errorMessage = "No source file specified (--src)";
+      return false;
+    }
+    options.sources = parser.values("src");
+    options.src = options.sources.front();
+    for (const auto &option : c_sweepOptions) {
+      QStringList values = parser.values("sweep-" + option);
+      // Processor names do not contain commas, and may be listed together.
+      if (option == "proc")
+        values = values.join(",").split(",", Qt::SkipEmptyParts);
+      if (!values.empty())
+        options.sweepValues.push_back({option, values});
+    }
+    if (options.sweepValues.empty()) {
+      errorMessage = "No options to sweep specified (--sweep-<option>).";
+      return false;
+    }
+    const QString format = parser.value("sweep-format");
+    if (format != "json" && format != "csv") {
+      errorMessage =
+          "Invalid sweep format '" + format + "' (--sweep-format).";
+      return false;
+    }
+    options.sweepCSV = format == "csv";
+    if (parser.isSet("shared-frontend")) {
+      if (parser.isSet("nodes")) {
+        errorMessage = "A shared front-end (--shared-frontend) cannot be "
+                       "combined with worker nodes (--nodes).";
+        return false;
+      }
+      if (!parser.values("sweep-isaexts").empty()) {
+        errorMessage = "A shared front-end (--shared-frontend) executes the "
+                       "ISA extensions of --isaexts, which cannot be swept.";
+        return false;
+      }
+      // The trace is recorded by the functional processor of the XLEN of the
+      // configurations.
+      QStringList procs = {parser.value("proc")};
+      for (const auto &sweep : options.sweepValues)
+        if (sweep.first == "proc")
+          procs = sweep.second;
+      unsigned xlen = 0;
+      for (const auto &procName : qAsConst(procs)) {
+        bool ok;
+        const int procID = QMetaEnum::fromType<ProcessorID>().keyToValue(
+            procName.toStdString().c_str(), &ok);
+        if (!ok || !ProcessorRegistry::hasProcessor(
+                       static_cast<ProcessorID>(procID))) {
+          errorMessage =
+              "Invalid processor model specified '" + procName + "'.";
+          return false;
+        }
+        if (!replaysTraces(static_cast<ProcessorID>(procID))) {
+          errorMessage = "The processor '" + procName +
+                         "' cannot replay traces (--shared-frontend); select "
+                         "superscalar or out-of-order timing models.";
+          return false;
+        }
+        const unsigned bits =
+            ProcessorRegistry::getDescription(static_cast<ProcessorID>(procID))
+                .isaInfo()
+                .isa->bits();
+        if (xlen != 0 && bits != xlen) {
+          errorMessage = "The processors of a shared front-end "
+                         "(--shared-frontend) must have the same XLEN.";
+          return false;
+        }
+        xlen = bits;
+      }
+      options.sharedFrontend = true;
+      options.sharedFrontendProc =
+          xlen == 64 ? ProcessorID::RV64_ISS : ProcessorID::RV32_ISS;
+    }
+    options.sweep = true;
+    options.outputFile = parser.value("output");
+    return true;
+  }
+
+  // Batch and server runs are configured by the manifest or requests, and
+  // parsed by the runner.
+  if (parser.isSet("batch") && parser.isSet("server")) {
+    errorMessage = "A batch manifest (--batch) cannot be combined with server "
+                   "mode (--server).";
+    return false;
+  }
+  if (parser.isSet("batch") || parser.isSet("server")) {
+    if (parser.isSet("src")) {
+      errorMessage = "Source files (--src) cannot be specified in batch "
+                     "(--batch) or server (--server) mode.";
+      return false;
+    }
+    options.batchManifest = parser.value("batch");
+    options.server = parser.isSet("server");
+    options.outputFile = parser.value("output");
+    return true;
+  }
+
   if (!parser.isSet("src")) {
     errorMessage = "No source file specified (--src)";
     return false;
   }
-  options.src = parser.value("src");
+  options.sources = parser.values("src");
+  options.src = options.sources.front();
+
+  if (options.jobs > 1 && options.sources.size() > 1 &&
+      !options.consoleOut.isEmpty()) {
+    errorMessage = "Console output (--console-out) cannot be written by "
+                   "multiple workers (--jobs).";
+    return false;
+  }
 
   if (!parser.isSet("t")) {
     errorMessage = "No source type specified (--t)";
@@ -82,11 +969,20 @@ bool parseCLIOptions(QCommandLineParser &parser, QString &errorMessage,
     options.srcType = SourceType::FlatBinary;
   } else if (parser.value("t") == "elf") {
     options.srcType = SourceType::ExternalELF;
+  } else if (parser.value("t") == "session") {
+    options.srcType = SourceType::Session;
   } else {
     errorMessage = "Invalid source type (--t)";
     return false;
   }
 
+  options.linkFiles = parser.values("link");
+  if (!options.linkFiles.isEmpty() &&
+      options.srcType != SourceType::Assembly) {
+    errorMessage = "Linked files (--link) require assembly sources (-t asm).";
+    return false;
+  }
+
   if (!parser.isSet("proc")) {
     errorMessage = "No processor specified (-proc).";
     return false;
@@ -94,7 +990,8 @@ bool parseCLIOptions(QCommandLineParser &parser, QString &errorMessage,
   bool ok;
   int procID = QMetaEnum::fromType<ProcessorID>().keyToValue(
       parser.value("proc").toStdString().c_str(), &ok);
-  if (!ok) {
+  if (!ok ||
+      !ProcessorRegistry::hasProcessor(static_cast<ProcessorID>(procID))) {
     errorMessage = "Invalid processor model specified '" +
                    parser.value("proc") + "' (--proc).";
     return false;
@@ -102,6 +999,23 @@ bool parseCLIOptions(QCommandLineParser &parser, QString &errorMessage,
   options.proc = static_cast<ProcessorID>(procID);
 
   options.jsonOutput = parser.isSet("json");
+  const QString reportFormat = parser.value("report-format");
+  if (reportFormat == "jsonl" || reportFormat == "cbor") {
+    options.streamReport = true;
+    options.streamFormat = reportFormat == "jsonl"
+                               ? ReportWriter::Format::JsonLines
+                               : ReportWriter::Format::Cbor;
+  } else if (reportFormat != "text" && reportFormat != "json") {
+    errorMessage =
+        "Invalid report format '" + reportFormat + "' (--report-format).";
+    return false;
+  }
+  if (options.jsonOutput && reportFormat != "text" && reportFormat != "json") {
+    errorMessage = "--json cannot be combined with --report-format " +
+                   reportFormat + ".";
+    return false;
+  }
+  options.jsonOutput |= reportFormat != "text";
 
   if (parser.isSet("isaexts")) {
     options.isaExtensions = parser.value("isaexts").split(",");
@@ -121,6 +1035,11 @@ bool parseCLIOptions(QCommandLineParser &parser, QString &errorMessage,
         return false;
       }
     }
+    if (options.isaExtensions.contains("D") &&
+        !options.isaExtensions.contains("F")) {
+      errorMessage = "The D extension requires the F extension (--isaexts).";
+      return false;
+    }
   }
 
   if (parser.isSet("timeout")) {
@@ -132,8 +1051,648 @@ bool parseCLIOptions(QCommandLineParser &parser, QString &errorMessage,
     }
   }
 
+  for (const auto &limit :
+       {std::make_pair("max-cycles", &options.maxCycles),
+        std::make_pair("max-instrs", &options.maxInstructions)}) {
+    bool ok;
+    *limit.second = parser.value(limit.first).toLongLong(&ok);
+    if (!ok || *limit.second < 0) {
+      errorMessage = "Invalid limit specified (--" + QString(limit.first) +
+                     ").";
+      return false;
+    }
+  }
+
   options.outputFile = parser.value("output");
 
+  if (parser.isSet("fast-forward")) {
+    bool ok;
+    options.fastForward = parser.value("fast-forward").toLongLong(&ok);
+    if (!ok || options.fastForward < 0) {
+      errorMessage =
+          "Invalid number of instructions specified (--fast-forward).";
+      return false;
+    }
+  }
+
+  if (parser.isSet("simpoint-interval")) {
+    bool ok;
+    options.simPointInterval =
+        parser.value("simpoint-interval").toLongLong(&ok);
+    if (!ok || options.simPointInterval < 0) {
+      errorMessage = "Invalid interval size specified (--simpoint-interval).";
+      return false;
+    }
+  }
+  if (parser.isSet("simpoints")) {
+    bool ok;
+    options.maxSimPoints = parser.value("simpoints").toUInt(&ok);
+    if (!ok || options.maxSimPoints == 0) {
+      errorMessage = "Invalid number of simulation points (--simpoints).";
+      return false;
+    }
+  }
+  if (options.simPointInterval != 0 && options.fastForward != 0) {
+    errorMessage = "Sampled simulation (--simpoint-interval) cannot be "
+                   "combined with fast-forwarding (--fast-forward).";
+    return false;
+  }
+
+  const bool limited = options.maxCycles != 0 || options.maxInstructions != 0;
+  if (limited && options.simPointInterval != 0) {
+    errorMessage = "Run limits (--max-cycles, --max-instrs) cannot be "
+                   "combined with sampled simulation (--simpoint-interval).";
+    return false;
+  }
+
+  if (parser.isSet("cosim")) {
+    bool ok;
+    int refID = QMetaEnum::fromType<ProcessorID>().keyToValue(
+        parser.value("cosim").toStdString().c_str(), &ok);
+    if (!ok ||
+        !ProcessorRegistry::hasProcessor(static_cast<ProcessorID>(refID))) {
+      errorMessage = "Invalid reference processor model '" +
+                     parser.value("cosim") + "' (--cosim).";
+      return false;
+    }
+    options.cosim = true;
+    options.cosimReference = static_cast<ProcessorID>(refID);
+    if (options.simPointInterval != 0) {
+      errorMessage = "Co-simulation (--cosim) cannot be combined with sampled "
+                     "simulation (--simpoint-interval).";
+      return false;
+    }
+    if (limited) {
+      errorMessage = "Co-simulation (--cosim) cannot be combined with run "
+                     "limits (--max-cycles, --max-instrs).";
+      return false;
+    }
+  }
+
+  if (parser.isSet("gdb")) {
+    bool ok;
+    const unsigned port = parser.value("gdb").toUInt(&ok);
+    if (!ok || port == 0 || port > 0xFFFF) {
+      errorMessage = "Invalid GDB server port '" + parser.value("gdb") +
+                     "' (--gdb).";
+      return false;
+    }
+    options.gdbPort = port;
+    if (options.sources.size() > 1) {
+      errorMessage = "A GDB server (--gdb) can only be run for a single "
+                     "source file.";
+      return false;
+    }
+    if (options.cosim || options.simPointInterval != 0 || limited) {
+      errorMessage = "A GDB server (--gdb) cannot be combined with "
+                     "co-simulation, sampled simulation or run limits.";
+      return false;
+    }
+  }
+
+  // Cache hierarchy; each level defaults to a 32-line, 4-word direct-mapped
+  // cache.
+  const std::vector<std::pair<QString, std::optional<CacheLevelConfig> *>>
+      cacheLevels = {{"l1i", &options.cacheConfig.l1i},
+                     {"l1d", &options.cacheConfig.l1d},
+                     {"l2", &options.cacheConfig.l2},
+                     {"l3", &options.cacheConfig.l3}};
+  for (const auto &[name, level] : cacheLevels) {
+    if (!parser.isSet(name))
+      continue;
+    CacheLevelConfig config;
+    QString err = parseCacheLevelConfig(parser.value(name), config);
+    if (!err.isEmpty()) {
+      errorMessage = err + " (--" + name + ").";
+      return false;
+    }
+    *level = config;
+  }
+  if (options.cacheConfig.l3 && !options.cacheConfig.l2) {
+    errorMessage = "An L3 cache (--l3) requires an L2 cache (--l2).";
+    return false;
+  }
+  const std::map<QString, InclusionPolicy> inclusionPolicies = {
+      {"nine", InclusionPolicy::NINE},
+      {"inclusive", InclusionPolicy::Inclusive},
+      {"exclusive", InclusionPolicy::Exclusive}};
+  const auto inclusion =
+      inclusionPolicies.find(parser.value("cache-inclusion"));
+  if (inclusion == inclusionPolicies.end()) {
+    errorMessage = "Invalid cache inclusion policy '" +
+                   parser.value("cache-inclusion") + "' (--cache-inclusion).";
+    return false;
+  }
+  options.cacheConfig.inclusion = inclusion->second;
+  if (inclusion->second != InclusionPolicy::NINE &&
+      !options.cacheConfig.l2) {
+    errorMessage = "A cache inclusion policy (--cache-inclusion) requires an "
+                   "L2 cache (--l2).";
+    return false;
+  }
+  if (inclusion->second == InclusionPolicy::Exclusive &&
+      (!options.cacheConfig.l1i || !options.cacheConfig.l1d)) {
+    // Exclusive caches do not allocate the lines which they serve.
+    errorMessage = "An exclusive cache hierarchy (--cache-inclusion) requires "
+                   "both L1 caches (--l1i, --l1d).";
+    return false;
+  }
+  CoherenceSim::Config coherenceConfig;
+  const QString coherenceErr = parseCoherenceConfig(
+      parser.value("coherence-protocol"), parser.value("coherence-l1"),
+      parser.value("coherence-l2"), coherenceConfig);
+  if (!coherenceErr.isEmpty()) {
+    errorMessage = coherenceErr + " (--coherence-protocol, --coherence-l1, "
+                                  "--coherence-l2).";
+    return false;
+  }
+  bool coherenceTopOk;
+  parser.value("coherence-top").toUInt(&coherenceTopOk);
+  if (!coherenceTopOk) {
+    errorMessage = "Invalid number of cache lines '" +
+                   parser.value("coherence-top") + "' (--coherence-top).";
+    return false;
+  }
+  if (parser.isSet("coherence") && options.hartQuantum != 1) {
+    errorMessage = "Coherence simulation (--coherence) requires a hart "
+                   "quantum of 1 (--hart-quantum).";
+    return false;
+  }
+  bool memLatencyOk;
+  options.cacheConfig.memLatency =
+      parser.value("mem-latency").toUInt(&memLatencyOk);
+  if (!memLatencyOk) {
+    errorMessage = "Invalid memory latency '" + parser.value("mem-latency") +
+                   "' (--mem-latency).";
+    return false;
+  }
+
+  options.blockTranslation = !parser.isSet("no-translation");
+  options.warmCaches = parser.isSet("warm-caches");
+  if (options.warmCaches &&
+      (options.fastForward == 0 || !options.cacheConfig.enabled())) {
+    errorMessage = "Cache warming (--warm-caches) requires fast-forwarding "
+                   "(--fast-forward) and a cache hierarchy (--l1i, --l1d, --l2 "
+                   "or --l3).";
+    return false;
+  }
+
+  options.cacheConfig.timing = parser.isSet("cache-timing");
+  if (options.cacheConfig.timing && !options.cacheConfig.enabled()) {
+    errorMessage = "Cache timing (--cache-timing) requires a cache hierarchy "
+                   "(--l1i, --l1d, --l2 or --l3).";
+    return false;
+  }
+
+  if (parser.isSet("fetch-buffer")) {
+    FetchBuffer::Config config;
+    QString err = parseFetchBufferConfig(parser.value("fetch-buffer"), config);
+    if (!err.isEmpty()) {
+      errorMessage = err + " (--fetch-buffer).";
+      return false;
+    }
+    const auto &caches = options.cacheConfig;
+    if (!caches.l1i && !caches.l2 && !caches.l3) {
+      errorMessage = "A fetch buffer (--fetch-buffer) requires an instruction "
+                     "cache (--l1i, --l2 or --l3).";
+      return false;
+    }
+    options.cacheConfig.fetchBuffer = config;
+  }
+
+  if (parser.isSet("tlb")) {
+    TLBSim::Config config;
+    const unsigned xlen =
+        ProcessorRegistry::getDescription(options.proc).isaInfo().isa->bits();
+    QString err = parseTLBConfig(parser.value("tlb"), config, xlen);
+    if (!err.isEmpty()) {
+      errorMessage = err + " (--tlb).";
+      return false;
+    }
+    if (!options.cacheConfig.enabled()) {
+      errorMessage = "A TLB (--tlb) requires a cache hierarchy "
+                     "(--l1i, --l1d, --l2 or --l3).";
+      return false;
+    }
+    options.cacheConfig.tlb = config;
+  }
+
+  if (parser.isSet("store-buffer")) {
+    StoreBuffer::Config config;
+    QString err = parseStoreBufferConfig(parser.value("store-buffer"), config);
+    if (!err.isEmpty()) {
+      errorMessage = err + " (--store-buffer).";
+      return false;
+    }
+    const auto &caches = options.cacheConfig;
+    if (!caches.l1d && !caches.l2 && !caches.l3) {
+      errorMessage = "A store buffer (--store-buffer) requires a data cache "
+                     "(--l1d, --l2 or --l3).";
+      return false;
+    }
+    options.cacheConfig.storeBuffer = config;
+  }
+
+  if (parser.isSet("dram")) {
+    DRAMSim::Config config;
+    QString err = parseDRAMConfig(parser.value("dram"), config);
+    if (!err.isEmpty()) {
+      errorMessage = err + " (--dram).";
+      return false;
+    }
+    if (!options.cacheConfig.enabled()) {
+      errorMessage = "A DRAM model (--dram) requires a cache hierarchy "
+                     "(--l1i, --l1d, --l2 or --l3).";
+      return false;
+    }
+    options.cacheConfig.dram = config;
+  }
+
+  if (parser.isSet("cache-sweep")) {
+    QString err = loadCacheSweepConfigs(parser.value("cache-sweep"),
+                                        options.cacheSweepConfigs);
+    if (!err.isEmpty()) {
+      errorMessage = err + " (--cache-sweep).";
+      return false;
+    }
+  }
+  bool blockOk;
+  const unsigned stackDistBlock =
+      parser.value("stackdist-block").toUInt(&blockOk);
+  if (!blockOk || stackDistBlock == 0 ||
+      (stackDistBlock & (stackDistBlock - 1)) != 0) {
+    errorMessage = "Invalid block size '" + parser.value("stackdist-block") +
+                   "', expected a power of two (--stackdist-block).";
+    return false;
+  }
+  bool profileTopOk;
+  parser.value("profile-top").toUInt(&profileTopOk);
+  if (!profileTopOk) {
+    errorMessage = "Invalid number of instructions '" +
+                   parser.value("profile-top") + "' (--profile-top).";
+    return false;
+  }
+  bool sourceLinesTopOk;
+  parser.value("source-lines-top").toUInt(&sourceLinesTopOk);
+  if (!sourceLinesTopOk) {
+    errorMessage = "Invalid number of source lines '" +
+                   parser.value("source-lines-top") +
+                   "' (--source-lines-top).";
+    return false;
+  }
+  bool sampleIntervalOk;
+  const unsigned sampleInterval =
+      parser.value("sample-interval").toUInt(&sampleIntervalOk);
+  if (!sampleIntervalOk || sampleInterval == 0) {
+    errorMessage = "Invalid sample interval '" +
+                   parser.value("sample-interval") + "' (--sample-interval).";
+    return false;
+  }
+  bool footprintPageOk;
+  const unsigned footprintPage =
+      parser.value("footprint-page").toUInt(&footprintPageOk);
+  if (!footprintPageOk || footprintPage == 0 ||
+      (footprintPage & (footprintPage - 1)) != 0) {
+    errorMessage = "Invalid page size '" + parser.value("footprint-page") +
+                   "', expected a power of two (--footprint-page).";
+    return false;
+  }
+  bool footprintIntervalOk;
+  const unsigned footprintInterval =
+      parser.value("footprint-interval").toUInt(&footprintIntervalOk);
+  if (!footprintIntervalOk || footprintInterval == 0) {
+    errorMessage = "Invalid sample interval '" +
+                   parser.value("footprint-interval") +
+                   "' (--footprint-interval).";
+    return false;
+  }
+  bool footprintTopOk;
+  parser.value("footprint-top").toUInt(&footprintTopOk);
+  if (!footprintTopOk) {
+    errorMessage = "Invalid number of pages '" +
+                   parser.value("footprint-top") + "' (--footprint-top).";
+    return false;
+  }
+  for (const QString option : {"reuse-block", "reuse-capacity"}) {
+    bool ok;
+    const unsigned bytes = parser.value(option).toUInt(&ok);
+    if (!ok || bytes == 0 || (bytes & (bytes - 1)) != 0) {
+      errorMessage = "Invalid size '" + parser.value(option) +
+                     "', expected a power of two (--" + option + ").";
+      return false;
+    }
+  }
+  bool reuseTopOk;
+  parser.value("reuse-top").toUInt(&reuseTopOk);
+  if (!reuseTopOk) {
+    errorMessage = "Invalid number of instructions '" +
+                   parser.value("reuse-top") + "' (--reuse-top).";
+    return false;
+  }
+  bool branchesTopOk;
+  parser.value("branches-top").toUInt(&branchesTopOk);
+  if (!branchesTopOk) {
+    errorMessage = "Invalid number of branches '" +
+                   parser.value("branches-top") + "' (--branches-top).";
+    return false;
+  }
+  bool hazardsTopOk;
+  parser.value("hazards-top").toUInt(&hazardsTopOk);
+  if (!hazardsTopOk) {
+    errorMessage = "Invalid number of basic blocks '" +
+                   parser.value("hazards-top") + "' (--hazards-top).";
+    return false;
+  }
+  std::vector<unsigned> ilpWindows;
+  const QString ilpWindowsErr =
+      IlpProfiler::parseWindowSizes(parser.value("ilp-windows"), ilpWindows);
+  if (!ilpWindowsErr.isEmpty()) {
+    errorMessage = ilpWindowsErr + " (--ilp-windows).";
+    return false;
+  }
+  options.cacheTraceOut = parser.value("cache-trace-out");
+  if (options.sources.size() > 1 && !options.cacheTraceOut.isEmpty()) {
+    errorMessage = "An access trace (--cache-trace-out) can only be written "
+                   "for a single source file.";
+    return false;
+  }
+
+  options.memTraceOut = parser.value("mem-trace");
+  options.memTraceCompress = parser.isSet("mem-trace-compress");
+  if (options.sources.size() > 1 && !options.memTraceOut.isEmpty()) {
+    errorMessage = "A memory trace (--mem-trace) can only be written for a "
+                   "single source file.";
+    return false;
+  }
+
+  options.shmTrace = parser.value("shm-trace");
+  if (!options.shmTrace.isEmpty()) {
+    if (options.sources.size() > 1) {
+      errorMessage = "A shared memory trace (--shm-trace) can only be "
+                     "published for a single source file.";
+      return false;
+    }
+    options.shmTraceEvents = 0;
+    for (const auto &event : parser.value("shm-trace-events").split(",")) {
+      if (event == "retire")
+        options.shmTraceEvents |= ProcessorObserver::Retire;
+      else if (event == "mem")
+        options.shmTraceEvents |= ProcessorObserver::MemAccess;
+      else if (event == "stage")
+        options.shmTraceEvents |= ProcessorObserver::StageUpdate;
+      else {
+        errorMessage = "Invalid shared memory trace event '" + event +
+                       "' (--shm-trace-events).";
+        return false;
+      }
+    }
+    bool ok;
+    options.shmTraceRecords =
+        parser.value("shm-trace-records").toULongLong(&ok);
+    if (!ok || options.shmTraceRecords == 0 ||
+        (options.shmTraceRecords & (options.shmTraceRecords - 1)) != 0) {
+      errorMessage = "The number of records of a shared memory trace must be "
+                     "a power of two (--shm-trace-records).";
+      return false;
+    }
+    options.shmTraceDrop = parser.isSet("shm-trace-drop");
+  }
+
+  options.commitLog = parser.value("commit-log");
+  options.commitLogAnnotate = parser.isSet("commit-log-annotate");
+  if (options.sources.size() > 1 && !options.commitLog.isEmpty()) {
+    errorMessage = "A commit log (--commit-log) can only be written for a "
+                   "single source file.";
+    return false;
+  }
+
+  options.replayTrace = parser.value("replay-trace");
+  options.replayFollow = parser.isSet("replay-follow");
+  if (options.replayFollow && options.replayTrace.isEmpty()) {
+    errorMessage = "Following a trace (--replay-follow) requires a trace to "
+                   "replay (--replay-trace).";
+    return false;
+  }
+  if (!options.replayTrace.isEmpty()) {
+    if (!replaysTraces(options.proc)) {
+      errorMessage = "The processor (--proc) cannot replay traces "
+                     "(--replay-trace); select a superscalar or out-of-order "
+                     "timing model.";
+      return false;
+    }
+    if (options.sources.size() > 1) {
+      errorMessage = "A trace (--replay-trace) can only be replayed for a "
+                     "single source file.";
+      return false;
+    }
+    if (options.cosim || options.simPointInterval != 0 ||
+        options.fastForward != 0) {
+      errorMessage = "Trace replay (--replay-trace) cannot be combined with "
+                     "co-simulation, sampled simulation or fast-forwarding.";
+      return false;
+    }
+  }
+
+  if (options.sources.size() > 1 && !options.ioLog.isEmpty()) {
+    errorMessage = "An IO log (--io-log) can only be written for a single "
+                   "source file.";
+    return false;
+  }
+
+  options.syscallLog = parser.value("syscall-log");
+  if (options.sources.size() > 1 && !options.syscallLog.isEmpty()) {
+    errorMessage = "A syscall log (--syscall-log) can only be written for a "
+                   "single source file.";
+    return false;
+  }
+
+  options.callGraphOut = parser.value("callgraph-out");
+  if (options.sources.size() > 1 && !options.callGraphOut.isEmpty()) {
+    errorMessage = "A call graph (--callgraph-out) can only be written for a "
+                   "single source file.";
+    return false;
+  }
+
+  options.plugins = parser.values("plugin");
+
+  for (const auto &spec : parser.values("watch")) {
+    QStringList parts = spec.split(":");
+    QString type = "w";
+    if (parts.size() > 1 &&
+        (parts.last() == "r" || parts.last() == "w" || parts.last() == "rw"))
+      type = parts.takeLast();
+    Watchpoint watchpoint;
+    bool ok = parts.size() <= 2;
+    if (ok)
+      watchpoint.start = parts[0].toULongLong(&ok, 0);
+    if (ok && parts.size() == 2)
+      watchpoint.size = parts[1].toULongLong(&ok, 0);
+    if (!ok || watchpoint.size == 0) {
+      errorMessage = "Invalid watchpoint '" + spec + "' specified (--watch).";
+      return false;
+    }
+    watchpoint.read = type.contains('r');
+    watchpoint.write = type.contains('w');
+    options.watchpoints.push_back(watchpoint);
+  }
+
+  if (parser.isSet("steady-state")) {
+    bool ok;
+    options.steadyStatePeriods = parser.value("steady-state").toUInt(&ok);
+    if (!ok || (options.steadyStatePeriods != 0 &&
+                options.steadyStatePeriods < 2)) {
+      errorMessage = "Invalid number of periods specified (--steady-state); "
+                     "at least 2 periods must be compared.";
+      return false;
+    }
+  }
+  if (parser.isSet("steady-state-period")) {
+    bool ok;
+    options.steadyStateMaxPeriod =
+        parser.value("steady-state-period").toUInt(&ok);
+    if (!ok || options.steadyStateMaxPeriod == 0) {
+      errorMessage = "Invalid period specified (--steady-state-period).";
+      return false;
+    }
+  }
+  if (options.steadyStatePeriods != 0) {
+    // The pipeline restarts after each extrapolation, which also resets the
+    // cache hierarchy.
+    if (options.simPointInterval != 0 || options.cosim ||
+        options.gdbPort != 0 || !options.replayTrace.isEmpty()) {
+      errorMessage = "Steady-state acceleration (--steady-state) cannot be "
+                     "combined with sampled simulation, co-simulation, a GDB "
+                     "server or trace replay.";
+      return false;
+    }
+    if (limited || !options.watchpoints.empty() ||
+        options.cacheConfig.enabled()) {
+      errorMessage = "Steady-state acceleration (--steady-state) cannot be "
+                     "combined with run limits, watchpoints or a simulated "
+                     "cache hierarchy.";
+      return false;
+    }
+  }
+
+  options.objdumpOut = parser.value("objdump");
+  if (options.sources.size() > 1 && !options.objdumpOut.isEmpty()) {
+    errorMessage = "A disassembly listing (--objdump) can only be written for "
+                   "a single source file.";
+    return false;
+  }
+
+  options.memoryDumpOut = parser.value("dump-memory-out");
+  const QString dumpFormat = parser.value("dump-memory-format");
+  static const std::map<QString, Radix> dumpRadices = {
+      {"hex", Radix::Hex},
+      {"binary", Radix::Binary},
+      {"unsigned", Radix::Unsigned},
+      {"signed", Radix::Signed}};
+  options.memoryDump.raw = dumpFormat == "raw";
+  if (!options.memoryDump.raw) {
+    auto radix = dumpRadices.find(dumpFormat);
+    if (radix == dumpRadices.end()) {
+      errorMessage = "Invalid memory dump format '" + dumpFormat +
+                     "' (--dump-memory-format).";
+      return false;
+    }
+    options.memoryDump.radix = radix->second;
+  }
+  bool dumpWidthOk;
+  options.memoryDump.width =
+      parser.value("dump-memory-width").toUInt(&dumpWidthOk);
+  const unsigned dumpWidth = options.memoryDump.width;
+  if (!dumpWidthOk ||
+      !(dumpWidth == 1 || dumpWidth == 2 || dumpWidth == 4 || dumpWidth == 8)) {
+    errorMessage = "Invalid memory dump width '" +
+                   parser.value("dump-memory-width") +
+                   "' (--dump-memory-width).";
+    return false;
+  }
+  for (const auto &spec : parser.values("dump-memory")) {
+    const QStringList parts = spec.split(":");
+    MemoryDumpConfig::Range range;
+    bool ok = parts.size() == 2;
+    if (ok)
+      range.start = parts[0].toULongLong(&ok, 0);
+    if (ok)
+      range.bytes = parts[1].toULongLong(&ok, 0);
+    if (!ok || range.bytes == 0) {
+      errorMessage =
+          "Invalid memory range '" + spec + "' specified (--dump-memory).";
+      return false;
+    }
+    if (!options.memoryDump.raw && range.bytes % dumpWidth != 0) {
+      errorMessage = "The size of memory range '" + spec +
+                     "' is not a multiple of the value width "
+                     "(--dump-memory-width).";
+      return false;
+    }
+    options.memoryDump.ranges.push_back(range);
+  }
+  if (options.memoryDump.ranges.empty() != options.memoryDumpOut.isEmpty()) {
+    errorMessage = "Memory dumps require both a range (--dump-memory) and a "
+                   "file (--dump-memory-out).";
+    return false;
+  }
+  if (options.sources.size() > 1 && !options.memoryDumpOut.isEmpty()) {
+    errorMessage = "A memory dump (--dump-memory) can only be written for a "
+                   "single source file.";
+    return false;
+  }
+
+  options.pipelineTraceOut = parser.value("pipeline-trace");
+  const QString pipelineTraceFormat = parser.value("pipeline-trace-format");
+  if (pipelineTraceFormat == "kanata") {
+    options.pipelineTraceFormat = PipelineTraceWriter::Format::Kanata;
+  } else if (pipelineTraceFormat == "binary") {
+    options.pipelineTraceFormat = PipelineTraceWriter::Format::Binary;
+  } else {
+    errorMessage = "Invalid pipeline trace format '" + pipelineTraceFormat +
+                   "' (--pipeline-trace-format).";
+    return false;
+  }
+  if (options.sources.size() > 1 && !options.pipelineTraceOut.isEmpty()) {
+    errorMessage = "A pipeline trace (--pipeline-trace) can only be written "
+                   "for a single source file.";
+    return false;
+  }
+
+  options.vcdOut = parser.value("vcd");
+  options.vcdSignals = parser.value("vcd-signals");
+  if (options.sources.size() > 1 && !options.vcdOut.isEmpty()) {
+    errorMessage = "A VCD file (--vcd) can only be written for a single "
+                   "source file.";
+    return false;
+  }
+
+  options.checkpointIn = parser.value("checkpoint-in");
+  options.checkpointOut = parser.value("checkpoint-out");
+  if (options.sources.size() > 1 &&
+      !(options.checkpointIn.isEmpty() && options.checkpointOut.isEmpty())) {
+    errorMessage = "Checkpoints (--checkpoint-in/--checkpoint-out) can only be "
+                   "used with a single source file.";
+    return false;
+  }
+
+  for (const auto &spec : parser.values("fork")) {
+    ForkVariant variant;
+    const QString err = parseForkVariant(spec, variant);
+    if (!err.isEmpty()) {
+      errorMessage = err + " (--fork).";
+      return false;
+    }
+    options.forkVariants.push_back(variant);
+  }
+  if (!options.forkVariants.empty() &&
+      (options.sources.size() > 1 || options.cosim ||
+       options.simPointInterval != 0 || options.gdbPort != 0)) {
+    errorMessage = "Simulations can only be forked (--fork) from a single "
+                   "source file, without co-simulation, sampled simulation or "
+                   "a GDB server.";
+    return false;
+  }
+
   // Validate register initializations
   if (parser.isSet("reginit")) {
     QStringList regInitList = parser.value("reginit").split(",");
@@ -179,9 +1738,25 @@ bool parseCLIOptions(QCommandLineParser &parser, QString &errorMessage,
 
   // Enable selected telemetry options.
   for (auto &telemetry : options.telemetry)
-    if (parser.isSet("all") || parser.isSet(telemetry->key()))
+    if (parser.isSet("all") || parser.isSet(telemetry->key()) ||
+        (telemetry->key() == "timeseries" && parser.isSet("sample-interval")) ||
+        (telemetry->key() == "callgraph" && parser.isSet("callgraph-out")) ||
+        (telemetry->key() == "syscalls" && parser.isSet("syscall-log")))
       telemetry->enable();
 
+  // Options are keyed on in order of their names, such that the order in
+  // which they were given does not matter.
+  QStringList resultOptions;
+  for (const auto &name : parser.optionNames()) {
+    if (c_resultNeutralOptions.contains(name))
+      continue;
+    const QString option = name + "=" + parser.values(name).join('\x1f');
+    if (!resultOptions.contains(option))
+      resultOptions << option;
+  }
+  resultOptions.sort();
+  options.resultOptions = resultOptions.join('\n');
+
   return true;
 }
 
@@ -1,23 +1,186 @@
 #pragma once
 
 #include "assembler/program.h"
+#include "cachehierarchy.h"
+#include "cachesweep.h"
+#include "consoleoutput.h"
+#include "headlessio.h"
+#include "memorydump.h"
+#include "pipelinetrace.h"
 #include "processorregistry.h"
+#include "reportwriter.h"
+#include "simfork.h"
+#include "simpoint.h"
+#include "steadystate.h"
 #include "telemetry.h"
+#include "vcdwriter.h"
+#include "watchpointset.h"
+#include "workernodes.h"
 #include <QCommandLineParser>
 #include <set>
 
 namespace Ripes {
 
 struct CLIModeOptions {
+  // The source file currently being processed.
   QString src;
+  // All source files specified on the command line. Each source is simulated
+  // separately, using the same set of options.
+  QStringList sources;
+  // Number of worker processes across which sources are distributed.
+  int jobs = 1;
   SourceType srcType;
   ProcessorID proc;
   QStringList isaExtensions;
   bool verbose = false;
   QString outputFile = "";
   bool jsonOutput = false;
+  // Whether the JSON report is streamed as it is collected, and its format
+  // (see ReportWriter).
+  bool streamReport = false;
+  ReportWriter::Format streamFormat = ReportWriter::Format::JsonLines;
   int timeout = 0;
+  // Deterministic bounds on the cycles executed and instructions retired by
+  // the processor model (0 = unbounded).
+  long long maxCycles = 0;
+  long long maxInstructions = 0;
   RegisterInitialization regInit;
+  // Checkpoint to restore before simulation starts, and to write after
+  // simulation ends.
+  QString checkpointIn;
+  QString checkpointOut;
+  // Simulations to fork from the state in which simulation ends, each resumed
+  // with the options of its variant.
+  std::vector<ForkVariant> forkVariants;
+  // Number of instructions to execute functionally before switching to the
+  // selected processor model.
+  long long fastForward = 0;
+  // Warm the cache hierarchy while fast-forwarding.
+  bool warmCaches = false;
+  // Clock the processor in batches of translated basic blocks.
+  bool blockTranslation = true;
+  // Sampled simulation; interval size in instructions (0 = disabled) and the
+  // maximum number of simulation points.
+  long long simPointInterval = 0;
+  unsigned maxSimPoints = 10;
+  std::shared_ptr<SimPointResult> simPointResult;
+  // Steady-state acceleration; the number of identical periods after which
+  // cycles are extrapolated (0 = disabled), and the longest period in cycles.
+  unsigned steadyStatePeriods = 0;
+  unsigned steadyStateMaxPeriod = 1024;
+  std::shared_ptr<SteadyStateResult> steadyStateResult;
+  // Lockstep co-simulation against a reference processor model.
+  bool cosim = false;
+  ProcessorID cosimReference;
+  // Local TCP port to serve a GDB session on (0 = disabled).
+  quint16 gdbPort = 0;
+  // Cache hierarchy simulated alongside the processor model.
+  CacheHierarchyConfig cacheConfig;
+  std::shared_ptr<CacheHierarchy> cacheHierarchy;
+  // Trace-driven cache design-space exploration; configurations to evaluate
+  // against the recorded access streams, and the file to write the recorded
+  // access trace to.
+  std::vector<CacheSweepConfig> cacheSweepConfigs;
+  QString cacheTraceOut;
+  std::shared_ptr<CacheSweepResult> cacheSweepResult;
+  // File to stream the per-cycle pipeline stage occupancy to, and its format.
+  QString pipelineTraceOut;
+  PipelineTraceWriter::Format pipelineTraceFormat =
+      PipelineTraceWriter::Format::Kanata;
+  // File to stream the values of the selected processor signals to, and the
+  // wildcard patterns selecting them (see VcdWriter).
+  QString vcdOut;
+  QString vcdSignals;
+  // File to stream all memory accesses to, and whether to compress it.
+  QString memTraceOut;
+  bool memTraceCompress = false;
+  // POSIX shared memory object to publish live trace events to, the traced
+  // events (of ProcessorObserver::Event), the number of records of its ring
+  // buffer, and whether records are dropped when the ring is full.
+  QString shmTrace;
+  unsigned shmTraceEvents = 0;
+  unsigned long long shmTraceRecords = 0;
+  bool shmTraceDrop = false;
+  // File to stream the log of committed instructions to, and whether to
+  // annotate it with cycles and disassembly.
+  QString commitLog;
+  bool commitLogAnnotate = false;
+  // Commit log to replay on the timing model, in place of the program, and
+  // whether to follow it while it is being recorded.
+  QString replayTrace;
+  bool replayFollow = false;
+  // File to write the gmon.out call graph profile to.
+  QString callGraphOut;
+  // File to stream the log of system calls to.
+  QString syscallLog;
+  // Shared libraries of the observer plugins to load.
+  QStringList plugins;
+  // Data watchpoints stopping the simulation.
+  std::vector<Watchpoint> watchpoints;
+  // File to write the disassembly listing of the program to.
+  QString objdumpOut;
+  // Ranges of memory to dump once simulation ends, and the file to write them
+  // to.
+  MemoryDumpConfig memoryDump;
+  QString memoryDumpOut;
+  // File to write the console output of programs to (stdout if empty), the
+  // policy by which it is flushed and the size of its buffer in bytes.
+  QString consoleOut;
+  ConsoleOutput::FlushPolicy consoleFlush = ConsoleOutput::FlushPolicy::Newline;
+  int consoleBuffer = 1 << 16;
+  // File to stream into the stdin of programs (the host stdin if empty).
+  QString stdinFile;
+  // Headless peripherals mapped into the address space, the script of input
+  // events replayed into them, the file to log LED writes to, and the file to
+  // write the C header of the peripheral symbols to.
+  std::vector<IODeviceSpec> ioDevices;
+  QString ioScript;
+  QString ioLog;
+  QString ioHeader;
+  // Assembly files linked into the program of each assembly source.
+  QStringList linkFiles;
+  // Directory in which assembled programs are cached across processes.
+  QString asmCacheDir;
+  // Directory in which the reports of runs are cached across processes, and
+  // the options of this run which may affect its result, canonicalized (see
+  // resultCacheKey).
+  QString resultCacheDir;
+  QString resultOptions;
+  // Simulated clock frequency in Hz deriving the time seen by programs, or 0
+  // for the wall clock of the host.
+  uint64_t virtualClockHz = 0;
+  SyscallABI syscallABI = SyscallABI::RARS;
+  BranchPredictor::Scheme branchPredictor = BranchPredictor::Scheme::NotTaken;
+  RipesProcessor::MExtTiming mextTiming;
+  // Cycles executed by the harts of multi-hart processors in between
+  // synchronizing.
+  unsigned hartQuantum = 1;
+  // Width in bits of the vector registers of the V extension.
+  unsigned vlen = 128;
+  // Handle output-only syscalls without draining the pipeline.
+  bool nonSerializingEcalls = false;
+  // Manifest of runs to execute within this process, in place of the options
+  // above.
+  QString batchManifest;
+  // Serve requests to simulate runs from stdin, in place of the options above.
+  bool server = false;
+  // Parameter sweep; the swept options (without leading dashes) and their
+  // values, whose cartesian product is run for each source, and whether rows
+  // are written as CSV rather than JSON.
+  bool sweep = false;
+  std::vector<std::pair<QString, QStringList>> sweepValues;
+  bool sweepCSV = false;
+  // Record the committed instructions of each source once, on the functional
+  // processor sharedFrontendProc, and replay them on the swept timing models
+  // while recording.
+  bool sharedFrontend = false;
+  ProcessorID sharedFrontendProc;
+  // Worker nodes to distribute the runs of a batch or sweep across, in place of
+  // worker processes, and the number of times lost runs are retried.
+  std::vector<WorkerNode> nodes;
+  unsigned nodeRetries = 2;
+  // TCP port to serve runs distributed by a coordinator on (0 = disabled).
+  quint16 workerPort = 0;
 
   // A list of enabled telemetry options.
   std::vector<std::shared_ptr<Telemetry>> telemetry;
@@ -1,11 +1,28 @@
 #include "clirunner.h"
+#include "assembler/assemblycache.h"
+#include "assembler/objdump.h"
+#include "checkpoint.h"
+#include "consoleoutput.h"
+#include "cosim.h"
+#include "gdbstub.h"
 #include "io/iomanager.h"
 #include "processorhandler.h"
 #include "programutilities.h"
+#include "resultcache.h"
+#include "session.h"
+#include "stdinreader.h"
 #include "syscall/systemio.h"
+#include "workernodes.h"
 
+#include <QCoreApplication>
+#include <QHash>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QProcess>
+#include <QTemporaryDir>
+
+#include <functional>
 
 namespace Ripes {
 
@@ -32,34 +49,749 @@ static QString qVariantToString(QVariant &v) {
   return def;
 }
 
-CLIRunner::CLIRunner(const CLIModeOptions &options)
+// Returns the arguments of this invocation, without the options (and their
+// values) for which @p removed is true. Removed options which do not take a
+// value must be listed in @p flags.
+static QStringList
+forwardedArguments(const std::function<bool(const QString &)> &removed,
+                   const QStringList &flags = {}) {
+  QStringList args = QCoreApplication::arguments();
+  args.removeFirst();
+
+  QStringList forwarded;
+  for (int i = 0; i < args.size(); ++i) {
+    QString name = args.at(i);
+    if (name.startsWith("-")) {
+      while (name.startsWith("-"))
+        name.remove(0, 1);
+      const bool hasInlineValue = name.contains('=');
+      name = name.section('=', 0, 0);
+      if (removed(name)) {
+        // Skip the option, and its value if provided as a separate argument.
+        if (!hasInlineValue && !flags.contains(name))
+          ++i;
+        continue;
+      }
+    }
+    forwarded << args.at(i);
+  }
+  return forwarded;
+}
+
+static QStringList workerArguments() {
+  static const QStringList perWorkerOptions = {"src", "jobs", "output"};
+  return forwardedArguments([](const QString &option) {
+    return perWorkerOptions.contains(option);
+  });
+}
+
+// Appends the values of @p object to @p row, keyed by their path from
+// @p prefix. Arrays are kept as JSON.
+static void flattenJson(const QJsonObject &object, const QString &prefix,
+                        QStringList &columns, QHash<QString, QString> &row) {
+  for (auto it = object.begin(); it != object.end(); ++it) {
+    const QString key = prefix.isEmpty() ? it.key() : prefix + "." + it.key();
+    const QJsonValue &value = it.value();
+    if (value.isObject()) {
+      flattenJson(value.toObject(), key, columns, row);
+      continue;
+    }
+    if (!columns.contains(key))
+      columns << key;
+    if (value.isArray())
+      row[key] = QJsonDocument(value.toArray()).toJson(QJsonDocument::Compact);
+    else
+      row[key] = value.toVariant().toString();
+  }
+}
+
+static QString csvField(QString field) {
+  if (!field.contains(',') && !field.contains('"') && !field.contains('\n'))
+    return field;
+  return "\"" + field.replace("\"", "\"\"") + "\"";
+}
+
+// Executes the sweep configurations @p runs across worker processes, each of
+// which runs a contiguous shard of the configurations as a batch, and
+// gathers the result of each configuration into @p results. @p whileRunning is
+// called once the workers have started.
+static void runSweepWorkers(const CLIModeOptions &options,
+                            const std::vector<BatchRun> &runs,
+                            std::vector<QJsonObject> &results,
+                            const std::function<void()> &whileRunning = {}) {
+  QTemporaryDir shardDir;
+  const int nRuns = static_cast<int>(runs.size());
+  const int nWorkers = std::min(options.jobs, nRuns);
+  std::vector<std::unique_ptr<QProcess>> workers;
+  std::vector<int> shardStart;
+  for (int i = 0; i < nWorkers; ++i) {
+    shardStart.push_back((i * nRuns) / nWorkers);
+    const int shardEnd = ((i + 1) * nRuns) / nWorkers;
+    QJsonArray manifest;
+    for (int run = shardStart.back(); run < shardEnd; ++run) {
+      QJsonObject entry;
+      entry["name"] = runs.at(run).name;
+      entry["args"] = QJsonArray::fromStringList(runs.at(run).arguments);
+      manifest.append(entry);
+    }
+    QFile manifestFile(shardDir.filePath(QString::number(i) + ".json"));
+    if (shardDir.isValid() && manifestFile.open(QIODevice::WriteOnly))
+      manifestFile.write(QJsonDocument(manifest).toJson());
+
+    QStringList args = {"--mode", "cli", "--batch", manifestFile.fileName(),
+                        "--output", shardDir.filePath(QString::number(i))};
+    if (!options.asmCacheDir.isEmpty())
+      args << "--asm-cache" << options.asmCacheDir;
+    if (options.verbose)
+      args << "-v";
+    auto &worker = workers.emplace_back(std::make_unique<QProcess>());
+    worker->setProcessChannelMode(QProcess::ForwardedChannels);
+    worker->start(QCoreApplication::applicationFilePath(), args);
+    worker->closeWriteChannel();
+  }
+  shardStart.push_back(nRuns);
+  if (whileRunning)
+    whileRunning();
+
+  for (int i = 0; i < nWorkers; ++i) {
+    workers.at(i)->waitForFinished(-1);
+    QFile output(shardDir.filePath(QString::number(i)));
+    if (output.open(QIODevice::ReadOnly | QIODevice::Text)) {
+      while (!output.atEnd()) {
+        QJsonObject result =
+            QJsonDocument::fromJson(output.readLine()).object();
+        const int run = shardStart.at(i) + result.take("run").toInt(-1);
+        if (run >= shardStart.at(i) && run < shardStart.at(i + 1))
+          results.at(run) = result;
+      }
+    }
+    // Configurations without a result were not run to completion.
+    for (int run = shardStart.at(i); run < shardStart.at(i + 1); ++run) {
+      if (!results.at(run).isEmpty())
+        continue;
+      results.at(run)["name"] = runs.at(run).name;
+      results.at(run)["status"] = "failed";
+      results.at(run)["error"] = "Worker " + QString::number(i) + " failed";
+    }
+  }
+}
+
+CLIRunner::CLIRunner(const CLIModeOptions &options, bool selectProcessor)
     : QObject(), m_options(options) {
   info("Ripes CLI mode", false, true);
-  ProcessorHandler::selectProcessor(m_options.proc, m_options.isaExtensions,
-                                    m_options.regInit);
+  // The processor is never reversed in CLI mode; avoid recording undo state.
+  ProcessorHandler::setReversible(false);
+  // Settings of the GUI do not carry over to the time seen by CLI runs.
+  ProcessorHandler::setVirtualClock(m_options.virtualClockHz);
+  ProcessorHandler::setSyscallABI(m_options.syscallABI);
+  ProcessorHandler::setBranchPredictor(m_options.branchPredictor);
+  ProcessorHandler::setMExtTiming(m_options.mextTiming);
+  ProcessorHandler::setHartQuantum(m_options.hartQuantum);
+  ProcessorHandler::setVLEN(m_options.vlen);
+  ProcessorHandler::setNonSerializingEcalls(m_options.nonSerializingEcalls);
+  ProcessorHandler::setBlockTranslation(m_options.blockTranslation);
+  if (!m_options.asmCacheDir.isEmpty())
+    Assembler::AssemblyCache::get().setDiskCacheDirectory(
+        m_options.asmCacheDir);
+  if (selectProcessor)
+    ProcessorHandler::selectProcessor(m_options.proc, m_options.isaExtensions,
+                                      m_options.regInit);
+  // Caches are reset alongside the processor, ie. when loading each program.
+  m_options.cacheHierarchy->build(m_options.cacheConfig);
+  if (!m_options.cacheSweepConfigs.empty() ||
+      !m_options.cacheTraceOut.isEmpty()) {
+    m_cacheSweep = std::make_unique<CacheSweep>();
+    m_cacheSweep->record();
+  }
 
-  // Connect systemIO output to stdout.
-  connect(&SystemIO::get(), &SystemIO::doPrint, this, [&](auto text) {
-    std::cout << text.toStdString();
-    std::flush(std::cout);
+  // Program output is buffered directly from the simulation thread, rather
+  // than delivered through a queued signal for each print.
+  SystemIO::setOutputSink([this](const QString &text) {
+    if (m_recordConsole)
+      m_recordedConsole += text;
+    if (m_captureConsole)
+      m_console += text;
+    else
+      ConsoleOutput::get().write(text);
   });
+}
+
+CLIRunner::~CLIRunner() {
+  SystemIO::setOutputSink(nullptr);
+  ConsoleOutput::get().flush();
+}
+
+int CLIRunner::openConsoleOutput(const CLIModeOptions &options) {
+  QString err = ConsoleOutput::get().open(
+      options.consoleOut, options.consoleFlush, options.consoleBuffer);
+  if (!err.isEmpty()) {
+    std::cerr << "ERROR: " << err.toStdString() << std::endl;
+    return 1;
+  }
+  return 0;
+}
 
-  // TODO: how to handle system input?
+int CLIRunner::openStdin(const CLIModeOptions &options) {
+  QString err = StdinReader::get().start(options.stdinFile);
+  if (!err.isEmpty()) {
+    std::cerr << "ERROR: " << err.toStdString() << std::endl;
+    return 1;
+  }
+  return 0;
 }
 
 int CLIRunner::run() {
-  if (processInput())
+  if (m_options.jobs > 1 && m_options.sources.size() > 1)
+    return runParallel();
+
+  if (openConsoleOutput(m_options) || openStdin(m_options) || openReport())
     return 1;
 
-  if (runModel())
+  if (openIO() || openReplayTrace() || openPipelineTrace() || openVcd() ||
+      openMemoryTrace() || openSharedTrace() || openCommitLog() ||
+      openSyscallLog() || openPlugins())
     return 1;
 
-  if (postRun())
+  // Sources are run in sequence, reusing the processor model. Loading a
+  // program resets the processor, so no state is carried between sources.
+  int result = 0;
+  for (const auto &source : qAsConst(m_options.sources)) {
+    m_options.src = source;
+    if (lookupResultCache())
+      continue;
+    if (runSource()) {
+      if (m_options.sources.size() == 1) {
+        closePipelineTrace();
+        closeVcd();
+        closeMemoryTrace();
+        closeSharedTrace();
+        closeCommitLog();
+        closeSyscallLog();
+        closePlugins();
+        closeReplayTrace();
+        closeIO();
+        return 1;
+      }
+      result = 1;
+      continue;
+    }
+    collectReport();
+    storeResultCache();
+  }
+
+  closePlugins();
+  const bool traceFailed = closePipelineTrace() | closeVcd() |
+                           closeMemoryTrace() | closeSharedTrace() |
+                           closeCommitLog() | closeSyscallLog() |
+                           closeReplayTrace() | closeIO();
+  if (traceFailed || postRun())
     return 1;
 
+  if (result == 0 && m_runLimitReached)
+    return c_runLimitExitCode;
+  return result;
+}
+
+int CLIRunner::runSource() {
+  bool finishedEarly = false;
+  bool failed = processInput() || writeObjdump() || restoreCheckpoint() ||
+                fastForward(finishedEarly);
+  if (!failed && m_options.simPointInterval != 0) {
+    failed = runSampled();
+  } else if (!failed && !finishedEarly && m_options.cosim) {
+    failed = runCosim();
+  } else if (!failed && !finishedEarly && m_options.gdbPort != 0) {
+    failed = runGDB();
+  } else if (!failed && !finishedEarly) {
+    failed = m_options.steadyStatePeriods != 0 ? runSteadyStateModel()
+                                               : runModel();
+    // Runs which timed out are also checkpointed, such that they may be
+    // resumed.
+    failed |= writeCheckpoint() != 0;
+    if (!failed)
+      failed = runForks();
+  }
+  if (!failed)
+    failed = runCacheSweep();
+  if (!failed)
+    failed = writeCallGraph();
+  if (!failed)
+    failed = writeMemoryDump();
+  ConsoleOutput::get().flush();
+  return failed;
+}
+
+int CLIRunner::runBatch(const CLIModeOptions &options) {
+  std::vector<BatchRun> runs;
+  QString err = loadBatchManifest(options.batchManifest, runs);
+  if (!err.isEmpty()) {
+    std::cerr << "ERROR: " << err.toStdString() << std::endl;
+    return 1;
+  }
+
+  QTextStream stream(stdout, QIODevice::WriteOnly);
+  QFile outputFile(options.outputFile);
+  if (!options.outputFile.isEmpty()) {
+    if (!outputFile.open(QIODevice::Truncate | QIODevice::Text |
+                         QIODevice::WriteOnly)) {
+      std::cerr << "ERROR: Failed to open output file" << std::endl;
+      return 1;
+    }
+    stream.setDevice(&outputFile);
+  }
+
+  if (openConsoleOutput(options) || openStdin(options))
+    return 1;
+  Assembler::AssemblyCache::get().setDiskCacheDirectory(options.asmCacheDir);
+  // Runs distributed across worker nodes are written once all have completed.
+  std::vector<QJsonObject> nodeResults;
+  if (!options.nodes.empty())
+    runOnWorkerNodes(options.nodes, runs, options.nodeRetries, options.verbose,
+                     nodeResults);
+
+  int result = 0;
+  SessionProcessor processor;
+  for (size_t i = 0; i < runs.size(); ++i) {
+    QJsonObject line;
+    line["run"] = static_cast<int>(i);
+    const QJsonObject runResult =
+        options.nodes.empty() ? executeRun(runs.at(i), options, processor,
+                                           /*captureConsole=*/false)
+                              : nodeResults.at(i);
+    for (auto it = runResult.begin(); it != runResult.end(); ++it)
+      line.insert(it.key(), it.value());
+    if (runResult.value("status") != "ok")
+      result = 1;
+    stream << QJsonDocument(line).toJson(QJsonDocument::Compact) << "\n";
+    stream.flush();
+  }
+  return result;
+}
+
+int CLIRunner::runSweep(const CLIModeOptions &options) {
+  // Each configuration is run with the arguments of this invocation, less the
+  // options of the sweep session and the sources.
+  const QStringList baseArgs = forwardedArguments(
+      [](const QString &option) {
+        return option == "src" || isSessionOption(option);
+      },
+      {"sweep", "server"});
+
+  // Configurations are ordered by source, and then by the values of each
+  // swept option, the last swept option varying fastest.
+  const auto &sweep = options.sweepValues;
+  std::vector<BatchRun> runs;
+  std::vector<QJsonObject> configs;
+  // With a shared front-end, the runs of each source replay the commit log
+  // recorded for the source, and are preceded by the recording run.
+  QTemporaryDir traceDir;
+  std::vector<BatchRun> recordings;
+  std::vector<size_t> sourceStart;
+  for (const auto &source : qAsConst(options.sources)) {
+    sourceStart.push_back(runs.size());
+    const QString trace =
+        traceDir.filePath(QString::number(sourceStart.size() - 1) + ".log");
+    if (options.sharedFrontend) {
+      BatchRun &recording = recordings.emplace_back();
+      recording.arguments = baseArgs;
+      recording.arguments
+          << "--src" << source << "--proc"
+          << enumToString<ProcessorID>(options.sharedFrontendProc)
+          << "--commit-log" << trace;
+      // Followers open the log before it is written.
+      QFile(trace).open(QIODevice::WriteOnly);
+    }
+    std::vector<int> index(sweep.size(), 0);
+    for (size_t axis = sweep.size(); axis > 0;) {
+      BatchRun run;
+      run.arguments = baseArgs;
+      run.arguments << "--src" << source;
+      if (options.sharedFrontend)
+        run.arguments << "--replay-trace" << trace << "--replay-follow";
+      QJsonObject config;
+      QStringList name;
+      for (size_t i = 0; i < sweep.size(); ++i) {
+        const QString &value = sweep.at(i).second.at(index.at(i));
+        run.arguments << "--" + sweep.at(i).first << value;
+        config[sweep.at(i).first] = value;
+        name << sweep.at(i).first + "=" + value;
+      }
+      run.name = name.join(" ");
+      runs.push_back(run);
+      configs.push_back(config);
+
+      for (axis = sweep.size(); axis > 0; --axis) {
+        if (++index.at(axis - 1) < sweep.at(axis - 1).second.size())
+          break;
+        index.at(axis - 1) = 0;
+      }
+    }
+  }
+
+  std::vector<QJsonObject> results(runs.size());
+  sourceStart.push_back(runs.size());
+  if (!options.nodes.empty()) {
+    runOnWorkerNodes(options.nodes, runs, options.nodeRetries, options.verbose,
+                     results);
+  } else if (options.sharedFrontend) {
+    if (!traceDir.isValid()) {
+      std::cerr << "ERROR: Failed to create temporary directory for traces"
+                << std::endl;
+      return 1;
+    }
+    if (openConsoleOutput(options) || openStdin(options))
+      return 1;
+    Assembler::AssemblyCache::get().setDiskCacheDirectory(options.asmCacheDir);
+    SessionProcessor processor;
+    // Each source is recorded in this process while its configurations
+    // replay the log, such that the functional execution of the program is
+    // shared by all of them.
+    for (size_t i = 0; i < recordings.size(); ++i) {
+      const std::vector<BatchRun> sourceRuns(
+          runs.begin() + sourceStart.at(i),
+          runs.begin() + sourceStart.at(i + 1));
+      std::vector<QJsonObject> sourceResults(sourceRuns.size());
+      const auto record = [&, i] {
+        const QJsonObject result = executeRun(recordings.at(i), options,
+                                              processor,
+                                              /*captureConsole=*/false);
+        // A run stopped at a run limit is replayed up to the limit.
+        const bool complete = result.value("status") != "failed";
+        const QString trace = traceDir.filePath(QString::number(i) + ".log");
+        QString err = CommitLogWriter::writeEndMarker(trace, complete);
+        if (err.isEmpty() && !complete)
+          err = "Recording the trace of '" + options.sources.at(i) +
+                "' failed: " + result.value("error").toString();
+        if (!err.isEmpty())
+          std::cerr << "ERROR: " << err.toStdString() << std::endl;
+      };
+      if (options.jobs > 1 && sourceRuns.size() > 1) {
+        runSweepWorkers(options, sourceRuns, sourceResults, record);
+      } else {
+        record();
+        for (size_t run = 0; run < sourceRuns.size(); ++run)
+          sourceResults.at(run) =
+              executeRun(sourceRuns.at(run), options, processor,
+                         /*captureConsole=*/false);
+      }
+      std::move(sourceResults.begin(), sourceResults.end(),
+                results.begin() + sourceStart.at(i));
+    }
+  } else if (options.jobs > 1 && runs.size() > 1) {
+    runSweepWorkers(options, runs, results);
+  } else {
+    if (openConsoleOutput(options) || openStdin(options))
+      return 1;
+    Assembler::AssemblyCache::get().setDiskCacheDirectory(options.asmCacheDir);
+    SessionProcessor processor;
+    for (size_t i = 0; i < runs.size(); ++i)
+      results.at(i) =
+          executeRun(runs.at(i), options, processor, /*captureConsole=*/false);
+  }
+
+  QTextStream stream(stdout, QIODevice::WriteOnly);
+  QFile outputFile(options.outputFile);
+  if (!options.outputFile.isEmpty()) {
+    if (!outputFile.open(QIODevice::Truncate | QIODevice::Text |
+                         QIODevice::WriteOnly)) {
+      std::cerr << "ERROR: Failed to open output file" << std::endl;
+      return 1;
+    }
+    stream.setDevice(&outputFile);
+  }
+
+  int result = 0;
+  QStringList columns = {"run", "src"};
+  for (const auto &option : sweep)
+    columns << option.first;
+  columns << "status";
+  std::vector<QHash<QString, QString>> rows;
+  for (size_t i = 0; i < results.size(); ++i) {
+    QJsonObject line = results.at(i);
+    if (line.value("status") != "ok")
+      result = 1;
+    line["run"] = static_cast<int>(i);
+    line["config"] = configs.at(i);
+    if (!options.sweepCSV) {
+      stream << QJsonDocument(line).toJson(QJsonDocument::Compact) << "\n";
+      continue;
+    }
+    QHash<QString, QString> &row = rows.emplace_back();
+    row["run"] = QString::number(i);
+    row["src"] = line.value("src").toString();
+    row["status"] = line.value("status").toString();
+    for (auto it = configs.at(i).begin(); it != configs.at(i).end(); ++it)
+      row[it.key()] = it.value().toString();
+    flattenJson(line.value("report").toObject(), QString(), columns, row);
+    if (line.contains("error")) {
+      row["error"] = line.value("error").toString();
+      if (!columns.contains("error"))
+        columns << "error";
+    }
+  }
+
+  if (options.sweepCSV) {
+    QStringList header;
+    for (const auto &column : qAsConst(columns))
+      header << csvField(column);
+    stream << header.join(",") << "\n";
+    for (const auto &row : rows) {
+      QStringList fields;
+      for (const auto &column : qAsConst(columns))
+        fields << csvField(row.value(column));
+      stream << fields.join(",") << "\n";
+    }
+  }
+  stream.flush();
+  return result;
+}
+
+int CLIRunner::runServer(const CLIModeOptions &options) {
+  Assembler::AssemblyCache::get().setDiskCacheDirectory(options.asmCacheDir);
+  // The host stdin carries requests, so programs only read from --stdin.
+  if (options.stdinFile.isEmpty())
+    SystemIO::closeStdIn();
+  else if (openStdin(options))
+    return 1;
+  QTextStream in(stdin, QIODevice::ReadOnly);
+  QTextStream out(stdout, QIODevice::WriteOnly);
+  SessionProcessor processor;
+  QString line;
+  while (in.readLineInto(&line)) {
+    if (line.trimmed().isEmpty())
+      continue;
+
+    QJsonParseError parseError;
+    const QJsonDocument doc =
+        QJsonDocument::fromJson(line.toUtf8(), &parseError);
+    QJsonObject request = doc.object();
+    const QJsonValue id = request.take("id");
+    QString err;
+    BatchRun run;
+    if (doc.isNull())
+      err = "Invalid request: " + parseError.errorString();
+    else if (!doc.isObject())
+      err = "Invalid request: expected an object";
+    else
+      err = parseBatchRun(request, run);
+
+    QJsonObject response;
+    if (err.isEmpty()) {
+      response = executeRun(run, options, processor, /*captureConsole=*/true);
+    } else {
+      response["status"] = "failed";
+      response["error"] = err;
+    }
+    if (!id.isUndefined())
+      response["id"] = id;
+    out << QJsonDocument(response).toJson(QJsonDocument::Compact) << "\n";
+    out.flush();
+  }
   return 0;
 }
 
+int CLIRunner::runWorker(const CLIModeOptions &options) {
+  // Runs are served by server mode processes configured with the remaining
+  // options of this invocation.
+  QStringList serverArgs = forwardedArguments([](const QString &option) {
+    return option == "worker" || option == "jobs";
+  });
+  serverArgs << "--server";
+  const QString err = runWorkerNode(options.workerPort, options.jobs,
+                                    serverArgs, options.verbose);
+  if (!err.isEmpty()) {
+    std::cerr << "ERROR: " << err.toStdString() << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+QJsonObject CLIRunner::executeRun(const BatchRun &run,
+                                  const CLIModeOptions &options,
+                                  SessionProcessor &processor,
+                                  bool captureConsole) {
+  QJsonObject result;
+  if (!run.name.isEmpty())
+    result["name"] = run.name;
+
+  // Each run is parsed as a separate invocation, such that it has its own
+  // telemetry and cache hierarchy.
+  QCommandLineParser parser;
+  CLIModeOptions runOptions;
+  addCLIOptions(parser, runOptions);
+  const QStringList args =
+      QStringList(QCoreApplication::applicationFilePath()) + run.arguments;
+  QString err;
+  bool ok = parser.parse(args);
+  if (!ok)
+    err = parser.errorText();
+  else
+    ok = parseCLIOptions(parser, err, runOptions);
+  if (ok && runOptions.sources.size() > 1) {
+    err = "A run can only simulate a single source file.";
+    ok = false;
+  }
+  // Forked simulations are run with the arguments of this process.
+  if (ok && !runOptions.forkVariants.empty()) {
+    err = "Simulations cannot be forked (--fork) from the runs of a batch, "
+          "sweep or server session.";
+    ok = false;
+  }
+
+  if (ok) {
+    result["src"] = runOptions.src;
+    result["proc"] = enumToString<ProcessorID>(runOptions.proc);
+    runOptions.jsonOutput = true;
+    runOptions.streamReport = false;
+    runOptions.verbose |= options.verbose;
+    if (runOptions.resultCacheDir.isEmpty())
+      runOptions.resultCacheDir = options.resultCacheDir;
+
+    const bool reuseProcessor =
+        processor.valid && processor.proc == runOptions.proc &&
+        processor.isaExtensions == runOptions.isaExtensions &&
+        processor.regInit == runOptions.regInit;
+    processor.valid = true;
+    processor.proc = runOptions.proc;
+    processor.isaExtensions = runOptions.isaExtensions;
+    processor.regInit = runOptions.regInit;
+
+    CLIRunner runner(runOptions, !reuseProcessor);
+    runner.m_captureConsole = captureConsole;
+    bool failed = runner.openReplayTrace() || runner.openPipelineTrace() ||
+                  runner.openVcd() || runner.openMemoryTrace() ||
+                  runner.openSharedTrace() || runner.openCommitLog() ||
+                  runner.openSyscallLog();
+    const bool cached = !failed && runner.lookupResultCache();
+    if (!failed && !cached)
+      failed = runner.runSource();
+    failed |= (runner.closePipelineTrace() | runner.closeVcd() |
+               runner.closeMemoryTrace() | runner.closeSharedTrace() |
+               runner.closeCommitLog() | runner.closeSyscallLog() |
+               runner.closeReplayTrace()) != 0;
+    if (!failed) {
+      if (!cached) {
+        runner.collectReport();
+        runner.storeResultCache();
+      }
+      result["report"] = runner.m_reports.front().json;
+      if (runner.m_runLimitReached)
+        err = "Simulation stopped at the run limit";
+    } else {
+      err = runner.m_lastError;
+      ok = false;
+    }
+    if (captureConsole)
+      result["console"] = runner.m_console;
+  }
+
+  result["status"] = !ok ? "failed" : err.isEmpty() ? "ok" : "limit";
+  if (!err.isEmpty())
+    result["error"] = err;
+  return result;
+}
+
+QJsonObject CLIRunner::runArguments(const QStringList &arguments) {
+  static SessionProcessor processor;
+  BatchRun run;
+  run.arguments = arguments;
+  return executeRun(run, CLIModeOptions(), processor, /*captureConsole=*/true);
+}
+
+int CLIRunner::runParallel() {
+  info("Distributing " + QString::number(m_options.sources.size()) +
+           " sources across " + QString::number(m_options.jobs) + " workers",
+       false, true);
+
+  QTemporaryDir reportDir;
+  if (!reportDir.isValid()) {
+    error("Failed to create temporary directory for worker reports");
+    return 1;
+  }
+  // Workers stream their reports in the requested format, which are appended
+  // to the report of this process as each worker finishes.
+  if (openReport())
+    return 1;
+
+  // Sources are split into contiguous shards, such that concatenating the
+  // reports of each worker retains the order in which sources were specified.
+  const int nSources = m_options.sources.size();
+  const int nWorkers = std::min(m_options.jobs, nSources);
+  std::vector<QStringList> shards(nWorkers);
+  for (int i = 0; i < nSources; ++i)
+    shards.at((i * nWorkers) / nSources) << m_options.sources.at(i);
+
+  const QStringList baseArgs = workerArguments();
+  std::vector<std::unique_ptr<QProcess>> workers;
+  for (int i = 0; i < nWorkers; ++i) {
+    QStringList args = baseArgs;
+    for (const auto &source : qAsConst(shards.at(i)))
+      args << "--src" << source;
+    args << "--output" << reportDir.filePath(QString::number(i));
+
+    auto &worker = workers.emplace_back(std::make_unique<QProcess>());
+    worker->setProcessChannelMode(QProcess::ForwardedChannels);
+    worker->start(QCoreApplication::applicationFilePath(), args);
+    // The host stdin cannot be shared between workers; programs of workers
+    // read end-of-file unless --stdin is specified.
+    worker->closeWriteChannel();
+  }
+
+  int result = 0;
+  for (int i = 0; i < nWorkers; ++i) {
+    auto &worker = workers.at(i);
+    worker->waitForFinished(-1);
+    if (worker->exitStatus() == QProcess::NormalExit &&
+        worker->exitCode() == c_runLimitExitCode) {
+      m_runLimitReached = true;
+    } else if (worker->exitStatus() != QProcess::NormalExit ||
+               worker->exitCode() != 0) {
+      error("Worker " + QString::number(i) + " failed (sources: " +
+            shards.at(i).join(", ") + ")");
+      result = 1;
+    }
+
+    QFile reportFile(reportDir.filePath(QString::number(i)));
+    // Streamed reports may be binary.
+    QIODevice::OpenMode mode = QIODevice::ReadOnly;
+    if (!m_reportWriter)
+      mode |= QIODevice::Text;
+    if (!reportFile.open(mode))
+      continue;
+    const QByteArray report = reportFile.readAll();
+
+    // A worker with a single source reports it as if it was the only source,
+    // whereas multi-source workers report each source individually.
+    const bool singleSource = shards.at(i).size() == 1;
+    if (m_reportWriter) {
+      // Streamed reports identify their source, and are concatenated.
+      m_reportWriter->append(report);
+    } else if (m_options.jsonOutput) {
+      const QJsonDocument doc = QJsonDocument::fromJson(report);
+      if (singleSource) {
+        m_reports.push_back({shards.at(i).front(), doc.object(), QString()});
+      } else {
+        for (const auto &value : doc.array()) {
+          QJsonObject obj = value.toObject();
+          const QString source = obj.take("source").toString();
+          m_reports.push_back({source, obj, QString()});
+        }
+      }
+    } else {
+      // Text reports are passed through verbatim.
+      m_reports.push_back(
+          {singleSource ? shards.at(i).front() : QString(), {}, report});
+    }
+  }
+
+  if (postRun())
+    return 1;
+
+  if (result == 0 && m_runLimitReached)
+    return c_runLimitExitCode;
+  return result;
+}
+
 int CLIRunner::processInput() {
   info("Processing input file", false, true);
 
@@ -71,8 +803,26 @@ int CLIRunner::processInput() {
       error("Failed to open input file");
       return 1;
     }
-    auto res = ProcessorHandler::getAssembler()->assembleRaw(
-        inputFile.readAll(), &IOManager::get().assemblerSymbols());
+    Assembler::AssembleResult res;
+    if (m_options.linkFiles.isEmpty()) {
+      res = Assembler::AssemblyCache::get().assemble(
+          *ProcessorHandler::getAssembler(), inputFile.readAll(),
+          &IOManager::get().assemblerSymbols());
+    } else {
+      std::vector<Assembler::SourceFile> files = {
+          {m_options.src, inputFile.readAll()}};
+      for (const auto &path : qAsConst(m_options.linkFiles)) {
+        QFile linkFile(path);
+        if (!linkFile.open(QIODevice::ReadOnly)) {
+          error("Failed to open linked file '" + path + "'");
+          return 1;
+        }
+        files.push_back({path, linkFile.readAll()});
+      }
+      info("Linking " + QString::number(files.size()) + " files");
+      res = ProcessorHandler::getAssembler()->assembleFiles(
+          files, &IOManager::get().assemblerSymbols());
+    }
     if (res.errors.size() == 0)
       ProcessorHandler::loadProgram(std::make_shared<Program>(res.program));
     else {
@@ -94,6 +844,32 @@ int CLIRunner::processInput() {
     ProcessorHandler::loadProgram(std::make_shared<Program>(p));
     break;
   }
+  case SourceType::ExternalELF: {
+    info("Loading ELF file '" + m_options.src + "'");
+    Program p;
+    QString err = loadElfFile(p, m_options.src);
+    if (!err.isEmpty()) {
+      error(err);
+      return 1;
+    }
+    ProcessorHandler::loadProgram(std::make_shared<Program>(p));
+    break;
+  }
+  case SourceType::Session: {
+    info("Loading session '" + m_options.src + "'");
+    Session session;
+    QString err = loadSession(m_options.src, session);
+    if (err.isEmpty()) {
+      ProcessorHandler::loadProgram(session.program);
+      if (!session.checkpoint.isEmpty())
+        err = applyCheckpointData(session.checkpoint, m_options.src);
+    }
+    if (!err.isEmpty()) {
+      error(err);
+      return 1;
+    }
+    break;
+  }
   default:
     assert(false &&
            "Command-line support for this source type is not yet implemented");
@@ -137,10 +913,16 @@ int CLIRunner::runModel() {
     infoTimer.start(1000);
 
   // Start simulation
+  ProcessorHandler::setRunLimits(m_options.maxCycles,
+                                 m_options.maxInstructions);
+  ProcessorHandler::clearWatchpoints();
+  for (const auto &watchpoint : m_options.watchpoints)
+    ProcessorHandler::addWatchpoint(watchpoint);
   ProcessorHandler::run();
   if (m_options.timeout != 0)
     timeoutTimer.start(m_options.timeout);
   loop.exec();
+  ProcessorHandler::setRunLimits(0, 0);
 
   // Event loop finished either by processor finishing or timeout. Determine the
   // cause and act.
@@ -153,13 +935,681 @@ int CLIRunner::runModel() {
           QString::number(m_options.timeout) + " ms)");
     return 1;
   }
+  if (!ProcessorHandler::unsupportedInstruction().isEmpty()) {
+    error(ProcessorHandler::unsupportedInstruction());
+    return 1;
+  }
+
+  if (ProcessorHandler::runLimitReached()) {
+    m_runLimitReached = true;
+    const auto *proc = ProcessorHandler::getProcessor();
+    info("Simulation stopped at the run limit (cycles: " +
+             QString::number(proc->getCycleCount()) + ", retired: " +
+             QString::number(proc->getInstructionsRetired()) + ")",
+         true);
+  }
+  if (const auto hit = ProcessorHandler::watchpointHit()) {
+    m_runLimitReached = true;
+    const auto *proc = ProcessorHandler::getProcessor();
+    info("Simulation stopped at watchpoint: " + WatchpointSet::describe(*hit) +
+             " (cycle: " + QString::number(proc->getCycleCount()) + ")",
+         true);
+  }
+
+  return 0;
+}
+
+int CLIRunner::runSampled() {
+  info("Running sampled simulation", false, true);
+  QString err = runSimPoints(m_options.simPointInterval, m_options.maxSimPoints,
+                             *m_options.simPointResult);
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
+  info("Simulated " +
+       QString::number(m_options.simPointResult->simPoints.size()) +
+       " simulation points out of " +
+       QString::number(m_options.simPointResult->totalInstructions) +
+       " instructions");
+  return 0;
+}
+
+int CLIRunner::runSteadyStateModel() {
+  info("Running model with steady-state acceleration", false, true);
+  auto &result = *m_options.steadyStateResult;
+  QString err = runSteadyState(m_options.steadyStatePeriods,
+                               m_options.steadyStateMaxPeriod, result);
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
+  info("Extrapolated " + QString::number(result.extrapolatedInstructions()) +
+       " of " + QString::number(result.instructions) + " instructions over " +
+       QString::number(result.loops.size()) + " steady states");
+  return 0;
+}
+
+int CLIRunner::runCosim() {
+  info("Co-simulating against " +
+           enumToString<ProcessorID>(m_options.cosimReference),
+       false, true);
+  CosimResult result;
+  QString err =
+      runCosimulation(m_options.cosimReference, m_options.timeout, result);
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
+  if (result.diverged) {
+    error(result.report);
+    return 1;
+  }
+  info("No divergence after " + QString::number(result.comparisons) +
+       " register state changes (signature: 0x" +
+       QString::number(result.signature, 16) + ")");
+  return 0;
+}
+
+int CLIRunner::runGDB() {
+  info("Waiting for a GDB connection on port " +
+           QString::number(m_options.gdbPort),
+       false, true);
+  QString err = runGDBServer(m_options.gdbPort);
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
+  info("GDB session ended");
+  return 0;
+}
+
+int CLIRunner::runCacheSweep() {
+  if (!m_cacheSweep)
+    return 0;
+
+  const auto &trace = m_cacheSweep->trace();
+  info("Recorded " + QString::number(trace.size()) + " memory accesses (" +
+       QString::number(trace.bytes()) + " bytes)");
+  if (!m_options.cacheTraceOut.isEmpty()) {
+    info("Writing access trace '" + m_options.cacheTraceOut + "'");
+    QString err = trace.save(m_options.cacheTraceOut);
+    if (!err.isEmpty()) {
+      error(err);
+      return 1;
+    }
+  }
 
+  if (m_options.cacheSweepConfigs.empty())
+    return 0;
+  info("Replaying access trace against " +
+           QString::number(m_options.cacheSweepConfigs.size()) +
+           " cache configurations",
+       false, true);
+  m_cacheSweep->run(m_options.cacheSweepConfigs, *m_options.cacheSweepResult);
+  return 0;
+}
+
+int CLIRunner::openPipelineTrace() {
+  if (m_options.pipelineTraceOut.isEmpty())
+    return 0;
+
+  info("Writing pipeline trace '" + m_options.pipelineTraceOut + "'");
+  m_pipelineTrace = std::make_unique<PipelineTraceWriter>();
+  QString err = m_pipelineTrace->open(m_options.pipelineTraceOut,
+                                      m_options.pipelineTraceFormat);
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
+  return 0;
+}
+
+int CLIRunner::closePipelineTrace() {
+  if (!m_pipelineTrace)
+    return 0;
+
+  QString err = m_pipelineTrace->close();
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
+  info("Traced " + QString::number(m_pipelineTrace->cycles()) +
+       " cycles to '" + m_options.pipelineTraceOut + "' (" +
+       QString::number(m_pipelineTrace->bytes()) + " bytes)");
+  m_pipelineTrace.reset();
+  return 0;
+}
+
+int CLIRunner::openVcd() {
+  if (m_options.vcdOut.isEmpty())
+    return 0;
+
+  info("Writing VCD file '" + m_options.vcdOut + "'");
+  m_vcd = std::make_unique<VcdWriter>();
+  QString err = m_vcd->open(m_options.vcdOut, m_options.vcdSignals);
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
+  info("Dumping " + QString::number(m_vcd->signalCount()) + " signals");
+  return 0;
+}
+
+int CLIRunner::closeVcd() {
+  if (!m_vcd)
+    return 0;
+
+  QString err = m_vcd->close();
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
+  info("Dumped " + QString::number(m_vcd->cycles()) + " cycles to '" +
+       m_options.vcdOut + "' (" + QString::number(m_vcd->bytes()) +
+       " bytes)");
+  m_vcd.reset();
+  return 0;
+}
+
+int CLIRunner::openMemoryTrace() {
+  if (m_options.memTraceOut.isEmpty())
+    return 0;
+
+  info("Writing memory trace '" + m_options.memTraceOut + "'");
+  m_memoryTrace = std::make_unique<MemoryTraceWriter>();
+  QString err =
+      m_memoryTrace->open(m_options.memTraceOut, m_options.memTraceCompress);
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
+  return 0;
+}
+
+int CLIRunner::closeMemoryTrace() {
+  if (!m_memoryTrace)
+    return 0;
+
+  QString err = m_memoryTrace->close();
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
+  info("Traced " + QString::number(m_memoryTrace->accesses()) +
+       " memory accesses to '" + m_options.memTraceOut + "' (" +
+       QString::number(m_memoryTrace->bytes()) + " bytes)");
+  m_memoryTrace.reset();
+  return 0;
+}
+
+int CLIRunner::openSharedTrace() {
+  if (m_options.shmTrace.isEmpty())
+    return 0;
+
+  info("Publishing shared memory trace '" + m_options.shmTrace + "'");
+  m_sharedTrace = std::make_unique<SharedTraceWriter>();
+  QString err = m_sharedTrace->open(m_options.shmTrace,
+                                    m_options.shmTraceRecords,
+                                    m_options.shmTraceEvents,
+                                    m_options.shmTraceDrop);
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
+  return 0;
+}
+
+int CLIRunner::closeSharedTrace() {
+  if (!m_sharedTrace)
+    return 0;
+
+  if (!m_options.shmTraceDrop)
+    info("Waiting for the shared memory trace to be consumed");
+  m_sharedTrace->close();
+  info("Published " + QString::number(m_sharedTrace->records()) +
+       " records to '" + m_options.shmTrace + "' (" +
+       QString::number(m_sharedTrace->dropped()) + " dropped)");
+  m_sharedTrace.reset();
+  return 0;
+}
+
+int CLIRunner::openCommitLog() {
+  if (m_options.commitLog.isEmpty())
+    return 0;
+
+  info("Writing commit log '" + m_options.commitLog + "'");
+  m_commitLog = std::make_unique<CommitLogWriter>();
+  QString err =
+      m_commitLog->open(m_options.commitLog, m_options.commitLogAnnotate);
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
+  return 0;
+}
+
+int CLIRunner::closeCommitLog() {
+  if (!m_commitLog)
+    return 0;
+
+  QString err = m_commitLog->close();
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
+  info("Logged " + QString::number(m_commitLog->commits()) +
+       " committed instructions to '" + m_options.commitLog + "' (" +
+       QString::number(m_commitLog->bytes()) + " bytes)");
+  m_commitLog.reset();
+  return 0;
+}
+
+int CLIRunner::openReplayTrace() {
+  if (m_options.replayTrace.isEmpty())
+    return 0;
+
+  const auto *proc = ProcessorHandler::getProcessor();
+  if (!(proc->features() & RipesProcessor::hasTraceReplay)) {
+    error("The processor (--proc) cannot replay traces; select a "
+          "superscalar or out-of-order timing model.");
+    return 1;
+  }
+  info("Replaying trace '" + m_options.replayTrace + "'");
+  m_replayTrace = std::make_shared<CommitLogReader>();
+  m_replayTrace->setFollow(m_options.replayFollow);
+  QString err = m_replayTrace->open(m_options.replayTrace,
+                                    proc->implementsISA()->bits());
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
+  // The trace is read from the start once the program is loaded.
+  ProcessorHandler::setInstructionTrace(m_replayTrace);
+  return 0;
+}
+
+int CLIRunner::closeReplayTrace() {
+  if (!m_replayTrace)
+    return 0;
+
+  ProcessorHandler::setInstructionTrace(nullptr);
+  const QString err = m_replayTrace->error();
+  const unsigned long long records = m_replayTrace->records();
+  m_replayTrace.reset();
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
+  info("Replayed " + QString::number(records) + " committed instructions");
+  return 0;
+}
+
+int CLIRunner::openSyscallLog() {
+  if (m_options.syscallLog.isEmpty())
+    return 0;
+
+  info("Writing syscall log '" + m_options.syscallLog + "'");
+  m_syscallLog = std::make_unique<SyscallLogWriter>();
+  QString err = m_syscallLog->open(m_options.syscallLog);
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
+  return 0;
+}
+
+int CLIRunner::closeSyscallLog() {
+  if (!m_syscallLog)
+    return 0;
+
+  // The simulation thread may still be handling a syscall.
+  ProcessorHandler::waitForIdle();
+  QString err = m_syscallLog->close();
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
+  info("Logged " + QString::number(m_syscallLog->records()) +
+       " system calls to '" + m_options.syscallLog + "'");
+  m_syscallLog.reset();
+  return 0;
+}
+
+int CLIRunner::openPlugins() {
+  for (const auto &path : qAsConst(m_options.plugins)) {
+    info("Loading plugin '" + path + "'");
+    auto plugin = std::make_unique<ObserverPlugin>();
+    QString err = plugin->load(path);
+    if (!err.isEmpty()) {
+      error(err);
+      closePlugins();
+      return 1;
+    }
+    ProcessorHandler::attachObserver(plugin->observer());
+    m_plugins.push_back(std::move(plugin));
+  }
+  return 0;
+}
+
+void CLIRunner::closePlugins() {
+  // The simulation thread may still be handling a syscall.
+  ProcessorHandler::waitForIdle();
+  for (auto &plugin : m_plugins)
+    ProcessorHandler::detachObserver(plugin->observer());
+  m_plugins.clear();
+}
+
+int CLIRunner::openIO() {
+  if (m_options.ioDevices.empty())
+    return 0;
+
+  info("Attaching " + QString::number(m_options.ioDevices.size()) +
+       " peripherals");
+  m_headlessIO = std::make_unique<HeadlessIO>();
+  QString err = m_headlessIO->open(m_options.ioDevices, m_options.ioScript,
+                                   m_options.ioLog);
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
+  if (!m_options.ioScript.isEmpty())
+    info("Replaying " + QString::number(m_headlessIO->events()) +
+         " input events from '" + m_options.ioScript + "'");
+
+  if (!m_options.ioHeader.isEmpty()) {
+    info("Writing peripheral header '" + m_options.ioHeader + "'");
+    QFile::remove(m_options.ioHeader);
+    if (!QFile::copy(IOManager::get().cSymbolsHeaderpath(),
+                     m_options.ioHeader)) {
+      error("Failed to write peripheral header '" + m_options.ioHeader + "'");
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int CLIRunner::closeIO() {
+  if (!m_headlessIO)
+    return 0;
+
+  // The simulation thread may still be writing to the peripherals.
+  ProcessorHandler::waitForIdle();
+  QString err = m_headlessIO->close();
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
+  if (!m_options.ioLog.isEmpty())
+    info("Logged " + QString::number(m_headlessIO->ledWrites()) +
+         " LED writes to '" + m_options.ioLog + "'");
+  m_headlessIO.reset();
+  return 0;
+}
+
+int CLIRunner::writeCallGraph() {
+  if (m_options.callGraphOut.isEmpty())
+    return 0;
+
+  for (const auto &telemetry : m_options.telemetry) {
+    const auto *callGraph =
+        dynamic_cast<const CallGraphTelemetry *>(telemetry.get());
+    if (!callGraph)
+      continue;
+    info("Writing call graph '" + m_options.callGraphOut + "'");
+    QString err = callGraph->profiler()->writeGmon(m_options.callGraphOut);
+    if (!err.isEmpty()) {
+      error(err);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int CLIRunner::writeObjdump() {
+  if (m_options.objdumpOut.isEmpty())
+    return 0;
+
+  info("Writing disassembly listing '" + m_options.objdumpOut + "'");
+  QString err = Assembler::writeObjdump(ProcessorHandler::getProgram(),
+                                        m_options.objdumpOut);
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
+  return 0;
+}
+
+int CLIRunner::fastForward(bool &finished) {
+  finished = false;
+  if (m_options.fastForward == 0)
+    return 0;
+
+  info("Fast-forwarding " + QString::number(m_options.fastForward) +
+       " instructions");
+  ProcessorHandler::setCacheWarming(m_options.warmCaches);
+  QString err = ProcessorHandler::fastForward(m_options.fastForward, finished);
+  ProcessorHandler::setCacheWarming(false);
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
+  if (finished)
+    info("Program finished during fast-forwarding");
+  return 0;
+}
+
+int CLIRunner::restoreCheckpoint() {
+  if (m_options.checkpointIn.isEmpty())
+    return 0;
+
+  info("Restoring checkpoint '" + m_options.checkpointIn + "'");
+  QString err = loadCheckpoint(m_options.checkpointIn);
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
+  if (!m_options.cacheHierarchy->levels().empty())
+    info("Caches are not checkpointed, and start out cold", true, false,
+         "WARNING");
+  return 0;
+}
+
+int CLIRunner::runForks() {
+  m_forkResults.clear();
+  if (m_options.forkVariants.empty())
+    return 0;
+
+  info("Forking " + QString::number(m_options.forkVariants.size()) +
+           " simulations",
+       false, true);
+  // The children resume from the state of this run, rather than running the
+  // program from its start, and report to the fork. Files written by this run
+  // are not written by the children.
+  static const QStringList removed = {
+      "src", "t", "fork", "output", "mode", "json", "v", "jobs", "max-cycles",
+      "max-instrs", "checkpoint-in", "checkpoint-out", "fast-forward",
+      "warm-caches", "result-cache", "replay-trace", "replay-follow",
+      "io-script", "io-log", "io-header", "console-out", "cache-trace-out",
+      "pipeline-trace", "mem-trace", "shm-trace", "commit-log", "syscall-log",
+      "callgraph-out", "objdump", "dump-memory-out", "host-trace"};
+  const QStringList args = forwardedArguments(
+      [](const QString &option) { return removed.contains(option); },
+      {"json", "v", "replay-follow"});
+  SimulationFork fork;
+  const QString err = fork.start(args, m_options.forkVariants);
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
+  fork.waitForFinished();
+  m_forkResults = fork.results();
+  return 0;
+}
+
+int CLIRunner::writeCheckpoint() {
+  if (m_options.checkpointOut.isEmpty())
+    return 0;
+
+  info("Writing checkpoint '" + m_options.checkpointOut + "'");
+  QString err = saveCheckpoint(m_options.checkpointOut);
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
+  return 0;
+}
+
+int CLIRunner::writeMemoryDump() {
+  if (m_options.memoryDumpOut.isEmpty())
+    return 0;
+
+  info("Writing memory dump '" + m_options.memoryDumpOut + "'");
+  QString err =
+      Ripes::writeMemoryDump(m_options.memoryDumpOut, m_options.memoryDump);
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
+  return 0;
+}
+
+void CLIRunner::collectReport() {
+  if (m_reportWriter) {
+    m_reportWriter->beginReport(m_options.src);
+    for (auto &telemetry : m_options.telemetry) {
+      if (telemetry->isEnabled())
+        telemetry->stream(*m_reportWriter);
+    }
+    if (!m_forkResults.empty()) {
+      QVariantList forks;
+      for (const auto &result : m_forkResults)
+        forks << result.toVariantMap();
+      m_reportWriter->value("forks", forks);
+    }
+    m_reportWriter->endReport();
+    return;
+  }
+
+  SourceReport report;
+  report.source = m_options.src;
+  for (auto &telemetry : m_options.telemetry) {
+    if (!telemetry->isEnabled())
+      continue;
+    if (m_options.jsonOutput) {
+      report.json.insert(
+          telemetry->prettyKey(),
+          QJsonValue::fromVariant(telemetry->report(/*json=*/true)));
+    } else {
+      report.text += "===== " + telemetry->description() + "\n";
+      QVariant reportedValue = telemetry->report(/*json=*/false);
+      report.text += qVariantToString(reportedValue) + "\n";
+    }
+  }
+  if (!m_forkResults.empty()) {
+    if (m_options.jsonOutput) {
+      QJsonArray forks;
+      for (const auto &result : m_forkResults)
+        forks.append(result);
+      report.json.insert("forks", forks);
+    } else {
+      report.text += "===== forked simulations\n";
+      for (const auto &result : m_forkResults) {
+        report.text += result.value("name").toString() + ": " +
+                       QJsonDocument(result).toJson(QJsonDocument::Compact) +
+                       "\n";
+      }
+    }
+  }
+  m_reports.push_back(report);
+}
+
+bool CLIRunner::lookupResultCache() {
+  m_resultKey.clear();
+  m_recordConsole = false;
+  if (m_options.resultCacheDir.isEmpty())
+    return false;
+
+  m_resultKey = resultCacheKey(m_options);
+  if (m_resultKey.isEmpty()) {
+    info("Run is not cacheable");
+    return false;
+  }
+  CachedResult cached;
+  if (!loadCachedResult(m_options.resultCacheDir, m_resultKey, cached)) {
+    // The run is simulated, recording what is needed to store its result.
+    m_recordConsole = true;
+    m_recordedConsole.clear();
+    m_stdinReads = SystemIO::stdinReads();
+    // Run limits are stored per source file.
+    m_runLimitBefore = m_runLimitReached;
+    m_runLimitReached = false;
+    return false;
+  }
+
+  info("Using cached result " + m_resultKey);
+  if (m_captureConsole)
+    m_console += cached.console;
+  else
+    ConsoleOutput::get().write(cached.console);
+  m_runLimitReached |= cached.runLimitReached;
+  SourceReport report;
+  report.source = m_options.src;
+  report.json = cached.json;
+  report.text = cached.text;
+  m_reports.push_back(report);
+  return true;
+}
+
+void CLIRunner::storeResultCache() {
+  if (!m_recordConsole)
+    return;
+  m_recordConsole = false;
+  const bool runLimitReached = m_runLimitReached;
+  m_runLimitReached |= m_runLimitBefore;
+  // The input of programs reading the host stdin is not part of the key.
+  if (m_options.stdinFile.isEmpty() &&
+      SystemIO::stdinReads() != m_stdinReads) {
+    info("Not caching result; the program read from stdin");
+    return;
+  }
+
+  CachedResult result;
+  result.json = m_reports.back().json;
+  result.text = m_reports.back().text;
+  result.console = m_recordedConsole;
+  result.runLimitReached = runLimitReached;
+  storeCachedResult(m_options.resultCacheDir, m_resultKey, result);
+  m_recordedConsole.clear();
+}
+
+int CLIRunner::openReport() {
+  if (!m_options.streamReport)
+    return 0;
+
+  m_reportWriter = std::make_unique<ReportWriter>();
+  QString err =
+      m_reportWriter->open(m_options.outputFile, m_options.streamFormat);
+  if (!err.isEmpty()) {
+    error(err);
+    return 1;
+  }
   return 0;
 }
 
 int CLIRunner::postRun() {
   info("Post-run", false, true);
 
+  if (m_reportWriter) {
+    QString err = m_reportWriter->close();
+    m_reportWriter.reset();
+    if (!err.isEmpty()) {
+      error(err);
+      return 1;
+    }
+    return 0;
+  }
+
   // Open output stream
   std::unique_ptr<QTextStream> stream;
   std::unique_ptr<QFile> outputFile;
@@ -175,23 +1625,32 @@ int CLIRunner::postRun() {
     stream = std::make_unique<QTextStream>(outputFile.get());
   }
 
+  // With a single source, telemetry is reported at the top level. Otherwise,
+  // telemetry is reported per source, as an array of the reports of each
+  // source, in the order in which sources were specified.
+  const bool multiSource = m_options.sources.size() > 1;
   if (m_options.jsonOutput) {
-    // Telemetry output
-    QJsonObject jsonOutput;
-    for (auto &telemetry : m_options.telemetry)
-      if (telemetry->isEnabled())
-        jsonOutput.insert(
-            telemetry->prettyKey(),
-            QJsonValue::fromVariant(telemetry->report(/*json=*/true)));
-    *stream << QJsonDocument(jsonOutput).toJson(QJsonDocument::Indented);
-  } else {
-    // Telemetry output
-    for (auto &telemetry : m_options.telemetry)
-      if (telemetry->isEnabled()) {
-        *stream << "===== " << telemetry->description() << "\n";
-        QVariant reportedValue = telemetry->report(/*json=*/false);
-        *stream << qVariantToString(reportedValue) << "\n";
+    QJsonDocument jsonOutput;
+    if (multiSource) {
+      QJsonArray reports;
+      for (const auto &report : m_reports) {
+        QJsonObject entry = report.json;
+        entry.insert("source", report.source);
+        reports.append(entry);
       }
+      jsonOutput.setArray(reports);
+    } else if (!m_reports.empty()) {
+      jsonOutput.setObject(m_reports.front().json);
+    } else {
+      jsonOutput.setObject(QJsonObject());
+    }
+    *stream << jsonOutput.toJson(QJsonDocument::Indented);
+  } else {
+    for (const auto &report : m_reports) {
+      if (multiSource && !report.source.isEmpty())
+        *stream << "##### Source: " << report.source << "\n";
+      *stream << report.text;
+    }
   }
 
   // Close output file if necessary
@@ -217,10 +1676,15 @@ void CLIRunner::info(QString msg, bool alwaysPrint, bool header,
       }
     } else
       msg.prepend(prefix + ": ");
-    std::cout << msg.toStdString() << std::endl;
+    // Captured runs reserve stdout for their results.
+    auto &out = m_captureConsole ? std::cerr : std::cout;
+    out << msg.toStdString() << std::endl;
   }
 }
 
-void CLIRunner::error(const QString &msg) { info(msg, true, false, "ERROR"); }
+void CLIRunner::error(const QString &msg) {
+  m_lastError = msg;
+  info(msg, true, false, "ERROR");
+}
 
 } // namespace Ripes
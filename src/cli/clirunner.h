@@ -1,6 +1,14 @@
 #pragma once
 
+#include "batchmanifest.h"
 #include "clioptions.h"
+#include "commitlog.h"
+#include "headlessio.h"
+#include "memorytrace.h"
+#include "processorobserver.h"
+#include "sharedtrace.h"
+#include "syscallprofiler.h"
+#include <QJsonObject>
 #include <QObject>
 
 namespace Ripes {
@@ -12,25 +20,222 @@ namespace Ripes {
 class CLIRunner : public QObject {
   Q_OBJECT
 public:
-  CLIRunner(const CLIModeOptions &options);
+  /// Creates a runner for @p options. If @p selectProcessor is not set, the
+  /// current processor model is reused, and must match the options.
+  CLIRunner(const CLIModeOptions &options, bool selectProcessor = true);
+  ~CLIRunner() override;
+
+  /// The exit status of runs in which a program was stopped upon reaching a
+  /// run limit (--max-cycles, --max-instrs) or a watchpoint (--watch).
+  /// Telemetry is still reported.
+  static constexpr int c_runLimitExitCode = 2;
 
   /// Runs the CLI mode.
   int run();
 
+  /// Executes each run of the batch manifest in @p options within this
+  /// process, writing the result of each run as a line of JSON. The processor
+  /// model is only reconstructed when it differs from that of the previous
+  /// run.
+  static int runBatch(const CLIModeOptions &options);
+
+  /// Runs each source of @p options on the cartesian product of the values of
+  /// the swept options, optionally across worker processes or worker nodes,
+  /// and writes the result of each configuration as a row of JSON or CSV.
+  static int runSweep(const CLIModeOptions &options);
+
+  /// Serves requests until stdin is closed. Each request is a line of JSON
+  /// holding the options of a run, as in a batch manifest, and an optional
+  /// "id". The result of each request, including the console output of the
+  /// simulated program, is written to stdout as a line of JSON.
+  static int runServer(const CLIModeOptions &options);
+
+  /// Serves runs distributed by coordinators (--nodes) on the worker port of
+  /// @p options, executing them across --jobs server mode processes, until
+  /// terminated.
+  static int runWorker(const CLIModeOptions &options);
+
+  /// Executes a single run with the command-line @p arguments within this
+  /// process, as a run of a batch session, and returns its result (see
+  /// runBatch). The console output of the program is captured in the result.
+  /// The processor model of the previous call is reused if it matches.
+  static QJsonObject runArguments(const QStringList &arguments);
+
 private:
+  /// Telemetry gathered after simulating a single source file.
+  struct SourceReport {
+    QString source;
+    QJsonObject json;
+    QString text;
+  };
+
+  /// The processor configuration of the previous run of a batch or server
+  /// session. The processor model is reused between runs which select the same
+  /// configuration.
+  struct SessionProcessor {
+    bool valid = false;
+    ProcessorID proc;
+    QStringList isaExtensions;
+    RegisterInitialization regInit;
+  };
+
+  /// Parses and executes a single run of a batch or server session, returning
+  /// its result. If @p captureConsole is set, the console output of the
+  /// program is included in the result rather than printed.
+  static QJsonObject executeRun(const BatchRun &run,
+                                const CLIModeOptions &options,
+                                SessionProcessor &processor,
+                                bool captureConsole);
+
+  /// Distributes the provided source files across m_options.jobs worker
+  /// processes, and merges the reports of each worker.
+  int runParallel();
+
+  /// Directs the console output of programs as specified by @p options.
+  static int openConsoleOutput(const CLIModeOptions &options);
+  /// Streams the stdin of programs from the source specified by @p options.
+  static int openStdin(const CLIModeOptions &options);
+
+  /// Processes, simulates and post-processes the source file m_options.src.
+  int runSource();
+
   /// Process the provided source file (assembling, compiling, loading, ...)
   int processInput();
 
-  /// Runs the processor model until the program is finished.
+  /// Runs the processor model until the program is finished, or a run limit
+  /// is reached.
   int runModel();
 
-  /// Prints requested telemetry to the console/output file.
+  /// Runs a sampled simulation of the program on the processor model.
+  int runSampled();
+
+  /// Runs the processor model until the program is finished, extrapolating
+  /// the cycles of loops which reach a steady state.
+  int runSteadyStateModel();
+
+  /// Runs the processor model in lockstep with the reference processor model
+  /// until the program is finished or the models diverge.
+  int runCosim();
+
+  /// Serves a GDB session on the program until GDB detaches.
+  int runGDB();
+
+  /// Fast-forwards the program, if requested. Sets @p finished if the program
+  /// finished while fast-forwarding.
+  int fastForward(bool &finished);
+
+  /// Replays the recorded access trace against the cache sweep
+  /// configurations, and writes the trace to file, if requested.
+  int runCacheSweep();
+
+  /// Starts/stops streaming the pipeline trace to file, if requested.
+  int openPipelineTrace();
+  int closePipelineTrace();
+
+  /// Starts/stops streaming the selected signals to a VCD file, if requested.
+  int openVcd();
+  int closeVcd();
+
+  /// Starts/stops streaming the memory access trace to file, if requested.
+  int openMemoryTrace();
+  int closeMemoryTrace();
+
+  /// Starts/stops publishing the shared memory trace, if requested.
+  int openSharedTrace();
+  int closeSharedTrace();
+
+  /// Starts/stops streaming the commit log to file, if requested.
+  int openCommitLog();
+  int closeCommitLog();
+
+  /// Starts/stops replaying the trace of committed instructions, if requested.
+  int openReplayTrace();
+  int closeReplayTrace();
+
+  /// Starts/stops streaming the syscall log to file, if requested.
+  int openSyscallLog();
+  int closeSyscallLog();
+
+  /// Loads and attaches/detaches the observer plugins, if requested.
+  int openPlugins();
+  void closePlugins();
+
+  /// Attaches/detaches the headless peripherals, if requested.
+  int openIO();
+  int closeIO();
+
+  /// Writes the call graph profile of the source file which was just run to
+  /// file, if requested.
+  int writeCallGraph();
+
+  /// Writes the disassembly listing of the loaded program to file, if
+  /// requested.
+  int writeObjdump();
+
+  /// Restores/writes the processor state from/to the checkpoint files
+  /// specified in the options, if any.
+  int restoreCheckpoint();
+  int writeCheckpoint();
+
+  /// Writes the requested ranges of memory to file, if any.
+  int writeMemoryDump();
+
+  /// Forks the simulation into the requested variants, if any, and waits for
+  /// them to finish (see SimulationFork).
+  int runForks();
+
+  /// Looks up the result of the current source file in the result cache, if
+  /// requested. On a hit, the stored report is gathered and the console output
+  /// of the program replayed, and true is returned.
+  bool lookupResultCache();
+  /// Stores the report of the source file which was just run in the result
+  /// cache, if it was looked up and is cacheable.
+  void storeResultCache();
+
+  /// Gathers requested telemetry for the source file which was just run.
+  /// Streamed reports are written directly to the report writer.
+  void collectReport();
+
+  /// Opens the report writer of a streamed report, if requested.
+  int openReport();
+
+  /// Prints gathered telemetry to the console/output file.
   int postRun();
   void info(QString msg, bool alwaysPrint = false, bool header = false,
             const QString &prefix = "INFO");
   void error(const QString &msg);
 
   CLIModeOptions m_options;
+  std::unique_ptr<CacheSweep> m_cacheSweep;
+  std::unique_ptr<PipelineTraceWriter> m_pipelineTrace;
+  std::unique_ptr<ReportWriter> m_reportWriter;
+  std::unique_ptr<VcdWriter> m_vcd;
+  std::unique_ptr<MemoryTraceWriter> m_memoryTrace;
+  std::unique_ptr<SharedTraceWriter> m_sharedTrace;
+  std::unique_ptr<CommitLogWriter> m_commitLog;
+  std::shared_ptr<CommitLogReader> m_replayTrace;
+  std::unique_ptr<SyscallLogWriter> m_syscallLog;
+  std::unique_ptr<HeadlessIO> m_headlessIO;
+  std::vector<std::unique_ptr<ObserverPlugin>> m_plugins;
+  std::vector<SourceReport> m_reports;
+  // The results of the simulations forked from the current source file.
+  std::vector<QJsonObject> m_forkResults;
+  // The most recently reported error.
+  QString m_lastError;
+  // Whether a program was stopped upon reaching a run limit or watchpoint.
+  bool m_runLimitReached = false;
+  // Whether console output of the program is captured into m_console, in
+  // which case status output is written to stderr.
+  bool m_captureConsole = false;
+  QString m_console;
+  // Result cache key of the current source file, if looked up, the console
+  // output of the program recorded for storing, and the number of reads of
+  // stdin and whether a run limit was reached before the run.
+  QString m_resultKey;
+  bool m_recordConsole = false;
+  QString m_recordedConsole;
+  unsigned long long m_stdinReads = 0;
+  bool m_runLimitBefore = false;
 };
 
 } // namespace Ripes
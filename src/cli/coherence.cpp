@@ -0,0 +1,229 @@
+#include "coherence.h"
+
+#include "processorhandler.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+// Lines track the words written by other harts in a 64-bit mask.
+static constexpr int s_maxBlockBits = 6;
+
+void CoherenceSim::Stats::add(const Stats &other) {
+  accesses += other.accesses;
+  misses += other.misses;
+  coherenceMisses += other.coherenceMisses;
+  falseSharingMisses += other.falseSharingMisses;
+  invalidations += other.invalidations;
+  upgrades += other.upgrades;
+  silentUpgrades += other.silentUpgrades;
+  interventions += other.interventions;
+  writebacks += other.writebacks;
+}
+
+QString parseCoherenceConfig(const QString &protocol, const QString &l1,
+                             const QString &l2, CoherenceSim::Config &config) {
+  if (protocol == "msi")
+    config.protocol = CoherenceSim::Protocol::MSI;
+  else if (protocol == "mesi")
+    config.protocol = CoherenceSim::Protocol::MESI;
+  else
+    return "Invalid coherence protocol '" + protocol +
+           "', expected msi or mesi";
+
+  if (!l1.isEmpty()) {
+    const QString err = parseCacheLevelConfig(l1, config.l1);
+    if (!err.isEmpty())
+      return err;
+  }
+  if (config.l1.victim != 0)
+    return "Coherent L1 caches do not support victim caches";
+  if (config.l1.preset.blocks > s_maxBlockBits)
+    return "Coherent L1 caches hold at most " +
+           QString::number(1 << s_maxBlockBits) + " words per line";
+  if (!l2.isEmpty())
+    return parseCacheLevelConfig(l2, config.l2);
+  return QString();
+}
+
+CoherenceSim::CoherenceSim(const Config &config) : m_config(config) {
+  // Coherence requires the L1 caches to hold the modified lines.
+  m_config.l1.preset.wrPolicy = WritePolicy::WriteBack;
+  m_config.l1.preset.wrAllocPolicy = WriteAllocPolicy::WriteAllocate;
+  reset();
+  ProcessorHandler::attachObserver(this);
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          [this] { reset(); });
+}
+
+CoherenceSim::~CoherenceSim() { ProcessorHandler::detachObserver(this); }
+
+void CoherenceSim::reset() {
+  const unsigned harts = std::min(ProcessorHandler::getProcessor()->hartCount(),
+                                  ReservationTable::s_maxHarts);
+  m_l1.clear();
+  for (unsigned hart = 0; hart < harts; ++hart) {
+    auto &cache = m_l1.emplace_back(std::make_unique<CacheSim>(nullptr));
+    cache->setPreset(m_config.l1.preset);
+    cache->setLatency(m_config.l1.latency);
+  }
+  m_l2 = std::make_unique<CacheSim>(nullptr);
+  m_l2->setPreset(m_config.l2.preset);
+  m_l2->setLatency(m_config.l2.latency);
+  m_stats.assign(harts, Stats());
+  m_lines.clear();
+  m_cycle = 0;
+}
+
+CoherenceSim::Stats CoherenceSim::total() const {
+  Stats total;
+  for (const auto &stats : m_stats)
+    total.add(stats);
+  return total;
+}
+
+std::vector<CoherenceSim::LineStats>
+CoherenceSim::worstLines(unsigned n) const {
+  std::vector<LineStats> lines;
+  for (const auto &line : m_lines) {
+    if (line.second.stats.coherenceMisses != 0 ||
+        line.second.stats.invalidations != 0)
+      lines.push_back(line.second.stats);
+  }
+  const auto cost = [](const LineStats &line) {
+    return line.coherenceMisses + line.invalidations;
+  };
+  std::stable_sort(lines.begin(), lines.end(),
+                   [&](const LineStats &a, const LineStats &b) {
+                     if (cost(a) != cost(b))
+                       return cost(a) > cost(b);
+                     return a.address < b.address;
+                   });
+  if (lines.size() > n)
+    lines.resize(n);
+  return lines;
+}
+
+AInt CoherenceSim::lineAddress(AInt address) const {
+  const CacheSim &cache = *m_l1.front();
+  return cache.buildAddress(cache.getTag(address), cache.getLineIdx(address),
+                            0);
+}
+
+void CoherenceSim::onCycle(const RipesProcessor &proc) {
+  m_cycle++;
+  for (unsigned hart = 0; hart < m_l1.size(); ++hart) {
+    const MemoryAccess dataAccess = proc.hartDataMemAccess(hart);
+    if (dataAccess.type != MemoryAccess::None)
+      access(hart, dataAccess.address, dataAccess.type);
+  }
+}
+
+CoherenceSim::State CoherenceSim::state(Line &line, unsigned hart,
+                                        AInt address) {
+  State &state = line.states[hart];
+  if (state != State::Invalid && !m_l1[hart]->contains(address)) {
+    // Lines are evicted silently once clean; modified lines are written back
+    // upon eviction.
+    state = State::Invalid;
+    line.invalidated &= ~(1u << hart);
+  }
+  return state;
+}
+
+void CoherenceSim::access(unsigned hart, AInt address,
+                          MemoryAccess::Type type) {
+  const AInt lineAddr = lineAddress(address);
+  Line &line = m_lines[lineAddr];
+  line.stats.address = lineAddr;
+  Stats &stats = m_stats[hart];
+  stats.accesses++;
+  const bool write = type == MemoryAccess::Write;
+  const uint32_t hartBit = 1u << hart;
+  const unsigned word = m_l1[hart]->getBlockIdx(address);
+  if (write)
+    line.stats.writers |= hartBit;
+  else
+    line.stats.readers |= hartBit;
+
+  const State current = state(line, hart, address);
+  const bool miss = current == State::Invalid;
+  if (miss) {
+    stats.misses++;
+    if (line.invalidated & hartBit) {
+      stats.coherenceMisses++;
+      line.stats.coherenceMisses++;
+      if (!(line.remoteWrites[hart] & (uint64_t(1) << word))) {
+        stats.falseSharingMisses++;
+        line.stats.falseSharingMisses++;
+      }
+    }
+    line.invalidated &= ~hartBit;
+    line.remoteWrites[hart] = 0;
+  }
+
+  // Snoop the copies of the other harts.
+  bool shared = false;
+  for (unsigned other = 0; other < m_l1.size(); ++other) {
+    if (other == hart)
+      continue;
+    const State otherState = state(line, other, address);
+    if (otherState == State::Invalid) {
+      if (write && (line.invalidated & (1u << other)))
+        line.remoteWrites[other] |= uint64_t(1) << word;
+      continue;
+    }
+    if (write && current != State::Modified &&
+        current != State::Exclusive) {
+      m_l1[other]->invalidate(address);
+      if (otherState == State::Modified) {
+        m_stats[other].interventions++;
+        m_l2->replayAccess(lineAddr, MemoryAccess::Write, m_cycle);
+      }
+      line.states[other] = State::Invalid;
+      line.invalidated |= 1u << other;
+      line.remoteWrites[other] = uint64_t(1) << word;
+      m_stats[other].invalidations++;
+      line.stats.invalidations++;
+    } else if (!write && miss) {
+      if (otherState == State::Modified) {
+        m_stats[other].interventions++;
+        m_l2->replayAccess(lineAddr, MemoryAccess::Write, m_cycle);
+      }
+      line.states[other] = State::Shared;
+      shared = true;
+    }
+  }
+
+  if (write) {
+    if (current == State::Shared)
+      stats.upgrades++;
+    else if (current == State::Exclusive)
+      stats.silentUpgrades++;
+    line.states[hart] = State::Modified;
+  } else if (miss) {
+    line.states[hart] = m_config.protocol == Protocol::MESI && !shared
+                            ? State::Exclusive
+                            : State::Shared;
+  }
+
+  CacheSim::CacheTransaction transaction;
+  m_l1[hart]->replayAccess(address, type, m_cycle, &transaction);
+  if (transaction.isWriteback) {
+    // The evicted line is written back only if modified; lines downgraded to
+    // shared remain dirty in the cache simulator.
+    const AInt evictedAddr = lineAddress(transaction.writebackAddress);
+    auto evicted = m_lines.find(evictedAddr);
+    if (evicted != m_lines.end() &&
+        evicted->second.states[hart] == State::Modified) {
+      stats.writebacks++;
+      m_l2->replayAccess(evictedAddr, MemoryAccess::Write, m_cycle);
+    }
+    if (evicted != m_lines.end())
+      evicted->second.states[hart] = State::Invalid;
+  }
+  if (miss)
+    m_l2->replayAccess(address, MemoryAccess::Read, m_cycle);
+}
+
+} // namespace Ripes
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "cachehierarchy.h"
+#include "processorobserver.h"
+#include "processors/interface/reservationtable.h"
+
+namespace Ripes {
+
+/**
+ * @brief The CoherenceSim class
+ * Simulates a private L1 data cache per hart of the current processor, kept
+ * coherent by a snooping MSI or MESI protocol over a shared L2 cache, and fed
+ * by the data accesses of each hart (see RipesProcessor::hartDataMemAccess).
+ * The harts must execute in lockstep (a hart quantum of 1), such that every
+ * access is observed.
+ *
+ * Writes to a line invalidate the copies of the other harts; reads of a line
+ * modified by another hart flush it to the L2 cache, and downgrade the copy to
+ * shared. With MESI, a read miss to a line which no other hart holds loads it
+ * exclusively, such that a subsequent write needs no invalidations.
+ *
+ * A miss is a coherence miss if the line was last lost to an invalidation
+ * rather than evicted. A coherence miss is a false sharing miss if none of the
+ * words written by the other harts since the invalidation is the accessed
+ * word, ie. the line was shared, but not the data. The L1 caches are
+ * write-back and write-allocate. The simulation is cleared when the processor
+ * is reset.
+ */
+class CoherenceSim : public QObject, public ProcessorObserver {
+public:
+  enum class Protocol { MSI, MESI };
+
+  struct Config {
+    Protocol protocol = Protocol::MESI;
+    CacheLevelConfig l1;
+    CacheLevelConfig l2 = {{"", 2, 8, 2, WritePolicy::WriteBack,
+                            WriteAllocPolicy::WriteAllocate, ReplPolicy::LRU},
+                           1,
+                           PrefetchPolicy::Disabled};
+  };
+
+  struct Stats {
+    unsigned long long accesses = 0;
+    unsigned long long misses = 0;
+    unsigned long long coherenceMisses = 0;
+    unsigned long long falseSharingMisses = 0;
+    // Copies of this hart invalidated by the writes of other harts.
+    unsigned long long invalidations = 0;
+    // Writes to shared lines, invalidating the other copies without a fill,
+    // and (MESI) writes to exclusive lines, which need no bus transaction.
+    unsigned long long upgrades = 0;
+    unsigned long long silentUpgrades = 0;
+    // Modified lines of this hart flushed to the L2 cache when snooped, and
+    // when evicted.
+    unsigned long long interventions = 0;
+    unsigned long long writebacks = 0;
+
+    void add(const Stats &other);
+  };
+
+  struct LineStats {
+    AInt address = 0;
+    unsigned long long invalidations = 0;
+    unsigned long long coherenceMisses = 0;
+    unsigned long long falseSharingMisses = 0;
+    // Masks of the harts which read and wrote the line.
+    uint32_t readers = 0;
+    uint32_t writers = 0;
+  };
+
+  /// Simulates the current processor until destroyed.
+  explicit CoherenceSim(const Config &config);
+  ~CoherenceSim() override;
+
+  const Config &config() const { return m_config; }
+  unsigned harts() const { return static_cast<unsigned>(m_l1.size()); }
+  const Stats &hartStats(unsigned hart) const { return m_stats.at(hart); }
+  Stats total() const;
+  const CacheSim &l2() const { return *m_l2; }
+  /// Returns the @p n lines with the most coherence misses and invalidations,
+  /// in descending order.
+  std::vector<LineStats> worstLines(unsigned n) const;
+
+  unsigned events() const override { return Cycle; }
+  void onCycle(const RipesProcessor &proc) override;
+
+private:
+  enum class State : uint8_t { Invalid, Shared, Exclusive, Modified };
+
+  struct Line {
+    std::array<State, ReservationTable::s_maxHarts> states{};
+    // Words written by other harts since the copy of each hart was
+    // invalidated, and the harts whose copy was last lost to an invalidation.
+    std::array<uint64_t, ReservationTable::s_maxHarts> remoteWrites{};
+    uint32_t invalidated = 0;
+    LineStats stats;
+  };
+
+  void reset();
+  void access(unsigned hart, AInt address, MemoryAccess::Type type);
+  /// Returns the state of the copy of @p hart, which is invalid if the line
+  /// was evicted from its cache.
+  State state(Line &line, unsigned hart, AInt address);
+  AInt lineAddress(AInt address) const;
+
+  Config m_config;
+  std::vector<std::unique_ptr<CacheSim>> m_l1;
+  std::unique_ptr<CacheSim> m_l2;
+  std::vector<Stats> m_stats;
+  std::unordered_map<AInt, Line> m_lines;
+  unsigned m_cycle = 0;
+};
+
+/**
+ * @brief parseCoherenceConfig
+ * Parses a coherence protocol (msi or mesi) and the specifications of the L1
+ * and L2 caches (see parseCacheLevelConfig) into @p config. Empty
+ * specifications retain the defaults. Returns an error message on failure, or
+ * an empty string on success.
+ */
+QString parseCoherenceConfig(const QString &protocol, const QString &l1,
+                             const QString &l2, CoherenceSim::Config &config);
+
+} // namespace Ripes
@@ -0,0 +1,384 @@
+#include "commitlog.h"
+
+#include "processorhandler.h"
+
+#include <QThread>
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+
+namespace Ripes {
+
+// Pending data accesses are dropped once this many are outstanding; their
+// instructions were flushed before committing.
+static constexpr size_t s_maxPendingAccesses = 32;
+
+// Interval at which a followed commit log is polled for lines, and the time
+// after which a log which has stopped growing is considered abandoned.
+static constexpr unsigned long s_followPollMs = 1;
+static constexpr qint64 s_followTimeoutMs = 60000;
+
+namespace {
+enum class Destination { None, GPR, FPR };
+
+/// Returns the register file written by the uncompressed instruction
+/// @p instr, if any.
+Destination destination(uint32_t instr) {
+  switch (instr & 0x7f) {
+  case 0b0110111: // LUI
+  case 0b0010111: // AUIPC
+  case 0b1101111: // JAL
+  case 0b1100111: // JALR
+  case 0b0000011: // LOAD
+  case 0b0010011: // OP-IMM
+  case 0b0110011: // OP
+  case 0b0011011: // OP-IMM-32
+  case 0b0111011: // OP-32
+  case 0b0101111: // AMO
+    return Destination::GPR;
+  case 0b1110011: // SYSTEM; only the CSR instructions write a register.
+    return ((instr >> 12) & 0b111) != 0 ? Destination::GPR : Destination::None;
+  case 0b0000111: // LOAD-FP
+  case 0b1000011: // MADD
+  case 0b1000111: // MSUB
+  case 0b1001011: // NMSUB
+  case 0b1001111: // NMADD
+    return Destination::FPR;
+  case 0b1010011: { // OP-FP
+    // Moves to, conversions to and comparisons into integer registers.
+    const unsigned funct5 = instr >> 27;
+    return funct5 == 0b11100 || funct5 == 0b11000 || funct5 == 0b10100
+               ? Destination::GPR
+               : Destination::FPR;
+  }
+  default:
+    return Destination::None;
+  }
+}
+
+/// Returns the width of the data loaded by @p instr, on a processor with
+/// @p xlen bit registers.
+unsigned loadBytes(uint32_t instr, unsigned xlen) {
+  if ((instr & 0b11) != 0b11) {
+    // Loads of quadrants 0 and 2 of the compressed instructions.
+    const unsigned quadrant = instr & 0b11;
+    const unsigned funct3 = (instr >> 13) & 0b111;
+    if (quadrant != 0b01 && funct3 == 0b001) // C.FLD(SP)
+      return 8;
+    if (quadrant != 0b01 && funct3 == 0b010) // C.LW(SP)
+      return 4;
+    if (quadrant != 0b01 && funct3 == 0b011) // C.FLW(SP) or C.LD(SP)
+      return xlen == 32 ? 4 : 8;
+    return xlen / CHAR_BIT;
+  }
+  switch (instr & 0x7f) {
+  case 0b0000011: // LOAD
+  case 0b0000111: // LOAD-FP
+  case 0b0101111: // AMO
+    return 1u << ((instr >> 12) & 0b11);
+  default:
+    return xlen / CHAR_BIT;
+  }
+}
+
+bool parseHex(const QByteArray &token, uint64_t &value) {
+  if (!token.startsWith("0x"))
+    return false;
+  bool ok = false;
+  value = token.mid(2).toULongLong(&ok, 16);
+  return ok;
+}
+} // namespace
+
+CommitLogWriter::~CommitLogWriter() { close(); }
+
+QString CommitLogWriter::open(const QString &path, bool annotate) {
+  close();
+  if (!m_writer.open(path).isEmpty())
+    return "Error: Could not open commit log file " + path;
+
+  m_annotate = annotate;
+  m_commits = 0;
+  processorReset();
+
+  ProcessorHandler::attachObserver(this);
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          [this] { processorReset(); });
+  return QString();
+}
+
+QString CommitLogWriter::close() {
+  if (!m_writer.isOpen())
+    return QString();
+
+  ProcessorHandler::detachObserver(this);
+  disconnect(ProcessorHandler::get(), nullptr, this, nullptr);
+  if (!m_writer.close().isEmpty())
+    return "Error: Could not write commit log file " + m_writer.fileName();
+  return QString();
+}
+
+void CommitLogWriter::processorReset() {
+  const auto *proc = ProcessorHandler::getProcessor();
+  const auto *isa = proc->implementsISA();
+  m_xlen = isa->bits();
+  m_flen = 0;
+  if (proc->registerFiles().count(RegisterFileType::FPR)) {
+    m_flen = isa->extensionEnabled('D')   ? 64
+             : isa->extensionEnabled('F') ? 32
+                                          : 0;
+  }
+
+  m_finalStages.clear();
+  for (const auto &lane : proc->structure())
+    m_finalStages.push_back({lane.first, lane.second - 1});
+  m_accesses.clear();
+  m_gprs.clear();
+  if (isa->extensionEnabled('C'))
+    proc->getRegisters(RegisterFileType::GPR, m_gprs);
+  m_lastRetired = proc->getInstructionsRetired();
+  m_lastCycle = proc->getCycleCount();
+  sample(*proc);
+}
+
+void CommitLogWriter::sample(const RipesProcessor &proc) {
+  m_committing.clear();
+  for (const auto &stage : m_finalStages) {
+    const StageInfo info = proc.stageInfo(stage);
+    if (info.stage_valid && info.state == StageInfo::State::None)
+      m_committing.push_back(info.pc);
+  }
+}
+
+void CommitLogWriter::onCycle(const RipesProcessor &proc) {
+  const long long cycle = proc.getCycleCount();
+  if (cycle < m_lastCycle)
+    processorReset();
+  m_lastCycle = cycle;
+
+  // Accesses of stall cycles were recorded in the cycle initiating the stall.
+  if (!proc.isStalled()) {
+    const MemoryAccess access = proc.dataMemAccess();
+    if (access.type != MemoryAccess::None) {
+      if (m_accesses.size() == s_maxPendingAccesses)
+        m_accesses.pop_front();
+      m_accesses.push_back({proc.dataMemAccessPC(), access});
+    }
+  }
+
+  const long long retired = proc.getInstructionsRetired();
+  long long newlyRetired = retired - m_lastRetired;
+  m_lastRetired = retired;
+  for (const AInt pc : m_committing) {
+    if (newlyRetired-- <= 0)
+      break;
+    commit(proc, pc);
+  }
+
+  sample(proc);
+  if (!m_gprs.empty())
+    proc.getRegisters(RegisterFileType::GPR, m_gprs);
+}
+
+void CommitLogWriter::commit(const RipesProcessor &proc, AInt pc) {
+  auto &memory = ProcessorHandler::getMemory();
+  uint32_t instr = static_cast<uint32_t>(memory.readMemConst(pc, 4));
+  const bool compressed = (instr & 0b11) != 0b11;
+  if (compressed)
+    instr &= 0xffff;
+
+  char line[256];
+  int size = std::snprintf(line, sizeof(line), "core   0: 3 0x%0*llx (0x%0*x)",
+                           m_xlen / 4, static_cast<unsigned long long>(pc),
+                           compressed ? 4 : 8, instr);
+  m_writer.write(line, size);
+
+  const RegisterView gprs = proc.registers(RegisterFileType::GPR);
+  if (compressed) {
+    // The destination is inferred from the registers changed by the cycle.
+    for (unsigned i = 1; i < m_gprs.size() && i < gprs.size(); ++i) {
+      if (gprs[i] != m_gprs[i]) {
+        writeRegister('x', i, gprs[i], m_xlen);
+        break;
+      }
+    }
+  } else {
+    const unsigned rd = (instr >> 7) & 0x1f;
+    switch (destination(instr)) {
+    case Destination::GPR:
+      if (rd != 0)
+        writeRegister('x', rd, gprs[rd], m_xlen);
+      break;
+    case Destination::FPR:
+      if (m_flen != 0)
+        writeRegister('f', rd, proc.getRegister(RegisterFileType::FPR, rd),
+                      m_flen);
+      break;
+    case Destination::None:
+      break;
+    }
+  }
+
+  auto it = std::find_if(m_accesses.begin(), m_accesses.end(),
+                         [pc](const PendingAccess &a) { return a.pc == pc; });
+  if (it != m_accesses.end()) {
+    const MemoryAccess &access = it->access;
+    size = std::snprintf(line, sizeof(line), " mem 0x%0*llx", m_xlen / 4,
+                         static_cast<unsigned long long>(access.address));
+    m_writer.write(line, size);
+    if (access.type == MemoryAccess::Write) {
+      const unsigned bytes = std::min<unsigned>(access.bytes, sizeof(VInt));
+      size = std::snprintf(
+          line, sizeof(line), " 0x%0*llx", bytes * 2,
+          static_cast<unsigned long long>(
+              memory.readMemConst(access.address, bytes)));
+      m_writer.write(line, size);
+    }
+    m_accesses.erase(it);
+  }
+
+  if (m_annotate) {
+    m_writer.write(QString("  ; cycle " + QString::number(m_lastCycle) + ": " +
+                           ProcessorHandler::disassembleInstr(pc))
+                       .toUtf8());
+  }
+  m_writer.write("\n", 1);
+  m_commits++;
+}
+
+void CommitLogWriter::writeRegister(char prefix, unsigned index, VInt value,
+                                    unsigned bits) {
+  if (bits < sizeof(VInt) * CHAR_BIT)
+    value &= (VInt(1) << bits) - 1;
+  char field[64];
+  const int size =
+      std::snprintf(field, sizeof(field), " %c%-2u 0x%0*llx", prefix, index,
+                    bits / 4, static_cast<unsigned long long>(value));
+  m_writer.write(field, size);
+}
+
+QString CommitLogWriter::writeEndMarker(const QString &path, bool complete) {
+  QFile file(path);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+    return "Error: Could not open commit log file " + path;
+  const QByteArray marker =
+      QByteArray(complete ? c_commitLogEndMarker : c_commitLogAbortMarker) +
+      "\n";
+  if (file.write(marker) != marker.size())
+    return "Error: Could not write commit log file " + path;
+  return QString();
+}
+
+QString CommitLogReader::open(const QString &path, unsigned xlen) {
+  close();
+  m_file.setFileName(path);
+  if (!m_file.open(QIODevice::ReadOnly))
+    return "Error: Could not open commit log file " + path;
+  m_xlen = xlen;
+  rewind();
+  return QString();
+}
+
+void CommitLogReader::rewind() {
+  m_file.seek(0);
+  m_line = 0;
+  m_records = 0;
+  m_ended = false;
+  m_error.clear();
+  m_lastSize = -1;
+}
+
+bool CommitLogReader::waitForLine() {
+  if (!m_follow || m_ended)
+    return false;
+  const qint64 size = m_file.size();
+  if (size != m_lastSize) {
+    m_lastSize = size;
+    m_idle.start();
+  } else if (m_idle.elapsed() > s_followTimeoutMs) {
+    m_error = "Timed out waiting for commit log " + m_file.fileName() +
+              " to be written";
+    return false;
+  }
+  QThread::msleep(s_followPollMs);
+  return true;
+}
+
+bool CommitLogReader::next(TraceRecord &record) {
+  while (m_error.isEmpty()) {
+    if (m_file.atEnd()) {
+      if (waitForLine())
+        continue;
+      return false;
+    }
+    const qint64 start = m_file.pos();
+    QByteArray line = m_file.readLine();
+    if (m_follow && !line.endsWith('\n')) {
+      // The line is still being written.
+      m_file.seek(start);
+      if (waitForLine())
+        continue;
+      return false;
+    }
+    m_line++;
+    if (line.startsWith(c_commitLogEndMarker)) {
+      m_ended = true;
+      return false;
+    }
+    if (line.startsWith(c_commitLogAbortMarker)) {
+      m_error = "The recording of commit log " + m_file.fileName() +
+                " was aborted";
+      return false;
+    }
+    if (const int comment = line.indexOf(';'); comment != -1)
+      line.truncate(comment);
+    const QList<QByteArray> tokens = line.simplified().split(' ');
+    if (tokens.size() < 4 || tokens[0] != "core")
+      continue;
+    // The privilege level is optional.
+    int i = tokens[2].startsWith("0x") ? 2 : 3;
+    if (i + 1 >= tokens.size() || !tokens[i + 1].startsWith("(0x"))
+      continue;
+
+    uint64_t pc = 0;
+    uint64_t instr = 0;
+    const QByteArray &instrToken = tokens[i + 1];
+    if (!parseHex(tokens[i], pc) ||
+        !parseHex(instrToken.mid(1, instrToken.size() - 2), instr)) {
+      m_error = "Malformed commit at line " + QString::number(m_line) +
+                " of " + m_file.fileName();
+      return false;
+    }
+    record = TraceRecord();
+    record.pc = pc;
+    record.instr = static_cast<uint32_t>(instr);
+
+    for (i += 2; i < tokens.size(); ++i) {
+      if (tokens[i] != "mem")
+        continue;
+      uint64_t address = 0;
+      if (i + 1 >= tokens.size() || !parseHex(tokens[i + 1], address)) {
+        m_error = "Malformed memory access at line " +
+                  QString::number(m_line) + " of " + m_file.fileName();
+        return false;
+      }
+      // AMOs record a load followed by a store; the store is kept.
+      record.data.address = address;
+      if (i + 2 < tokens.size() && tokens[i + 2].startsWith("0x")) {
+        record.data.type = MemoryAccess::Write;
+        record.data.bytes = (tokens[i + 2].size() - 2) / 2;
+        i += 2;
+      } else {
+        record.data.type = MemoryAccess::Read;
+        record.data.bytes = loadBytes(record.instr, m_xlen);
+        i += 1;
+      }
+    }
+    m_records++;
+    return true;
+  }
+  return false;
+}
+
+} // namespace Ripes
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QObject>
+#include <QString>
+
+#include <deque>
+#include <vector>
+
+#include "asyncfilewriter.h"
+#include "processorobserver.h"
+#include "processors/interface/instructiontrace.h"
+
+namespace Ripes {
+
+/// Comment lines terminating a commit log which was recorded for followers
+/// (see CommitLogReader::setFollow): the recording either completed, or was
+/// aborted.
+constexpr const char *c_commitLogEndMarker = "; end of trace";
+constexpr const char *c_commitLogAbortMarker = "; trace aborted";
+
+/**
+ * @brief The CommitLogWriter class
+ * Streams a log of the instructions committed by the current processor, in the
+ * format of Spike's --log-commits, such that the log of a program can be
+ * diffed against that of Spike:
+ *
+ *   core   0: 3 <pc> (<instruction>) [x<rd> <value>] [mem <address> [<value>]]
+ *
+ * Integer and floating-point register writes are recorded with their value
+ * after the commit; stores are recorded with the stored value as read from
+ * memory at commit time. If annotated, each line is suffixed by the cycle of
+ * the commit and the disassembled instruction, as a comment.
+ *
+ * An instruction is committed once it leaves the final stage of a lane (see
+ * RipesProcessor::getInstructionsRetired). Data accesses are attributed to
+ * instructions by their PC (see RipesProcessor::dataMemAccessPC). Lines are
+ * written on a background thread (see AsyncFileWriter).
+ */
+class CommitLogWriter : public QObject, public ProcessorObserver {
+public:
+  ~CommitLogWriter() override;
+
+  /// Opens the file at @p path and starts logging the current processor.
+  /// Returns an error message on failure, or an empty string on success.
+  QString open(const QString &path, bool annotate);
+  /// Stops logging and closes the file. Returns an error message if writing
+  /// the log failed, or an empty string on success.
+  QString close();
+  /// Appends the end marker to the closed commit log at @p path, or the abort
+  /// marker unless @p complete. Returns an error message on failure, or an
+  /// empty string on success.
+  static QString writeEndMarker(const QString &path, bool complete);
+
+  unsigned long long commits() const { return m_commits; }
+  unsigned long long bytes() const { return m_writer.bytes(); }
+
+  unsigned events() const override { return Cycle; }
+  void onCycle(const RipesProcessor &proc) override;
+
+private:
+  struct PendingAccess {
+    AInt pc;
+    MemoryAccess access;
+  };
+
+  void processorReset();
+  void sample(const RipesProcessor &proc);
+  void commit(const RipesProcessor &proc, AInt pc);
+  void writeRegister(char prefix, unsigned index, VInt value, unsigned bits);
+
+  AsyncFileWriter m_writer;
+  bool m_annotate = false;
+  unsigned long long m_commits = 0;
+
+  unsigned m_xlen = 32;
+  unsigned m_flen = 0;
+  std::vector<StageIndex> m_finalStages;
+  // The PCs of the instructions in the final stages after the previous cycle;
+  // these are the instructions committed by the following cycle.
+  std::vector<AInt> m_committing;
+  // Data accesses of instructions which have not yet committed.
+  std::deque<PendingAccess> m_accesses;
+  // The integer registers before the current cycle, from which the
+  // destination of compressed instructions is inferred.
+  std::vector<VInt> m_gprs;
+  long long m_lastRetired = 0;
+  long long m_lastCycle = 0;
+};
+
+/**
+ * @brief The CommitLogReader class
+ * Streams the committed instructions of a commit log in the format of Spike's
+ * --log-commits, as written by CommitLogWriter, as an instruction trace (see
+ * RipesProcessor::setInstructionTrace). Lines which are not commits, such as
+ * traps, are skipped, as are register writes and annotations. A memory access
+ * with a value is a store of the width of the value; other accesses are loads,
+ * of the width given by the instruction.
+ *
+ * A followed log is read while it is being written: at the end of the file,
+ * the reader waits for further lines until the end marker (see
+ * CommitLogWriter::writeEndMarker), such that a trace may be replayed while it
+ * is recorded.
+ */
+class CommitLogReader : public InstructionTrace {
+public:
+  /// Opens the commit log at @p path, of a processor with @p xlen bit
+  /// registers. Returns an error message on failure, or an empty string on
+  /// success.
+  QString open(const QString &path, unsigned xlen);
+  void close() { m_file.close(); }
+  /// Follows the log as it is written, until its end marker.
+  void setFollow(bool follow) { m_follow = follow; }
+
+  /// The number of records read since the trace was last rewound.
+  unsigned long long records() const { return m_records; }
+  /// An error message if a commit could not be parsed, or an empty string.
+  const QString &error() const { return m_error; }
+
+  void rewind() override;
+  bool next(TraceRecord &record) override;
+
+private:
+  /// Waits for the followed log to grow. Returns false if the log is not
+  /// followed, or has ended or stalled.
+  bool waitForLine();
+
+  QFile m_file;
+  unsigned m_xlen = 32;
+  bool m_follow = false;
+  bool m_ended = false;
+  // Size of the followed log when last polled, and the time since it last
+  // grew.
+  qint64 m_lastSize = -1;
+  QElapsedTimer m_idle;
+  unsigned long long m_line = 0;
+  unsigned long long m_records = 0;
+  QString m_error;
+};
+
+} // namespace Ripes
@@ -0,0 +1,51 @@
+#include "consoleoutput.h"
+
+#include <cstdio>
+
+namespace Ripes {
+
+ConsoleOutput::ConsoleOutput() {
+  m_file.open(stdout, QIODevice::WriteOnly, QFileDevice::DontCloseHandle);
+}
+
+QString ConsoleOutput::open(const QString &path, FlushPolicy policy,
+                            int bufferSize) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  flushLocked();
+  m_file.close();
+  m_policy = policy;
+  m_bufferSize = bufferSize;
+  m_buffer.reserve(bufferSize);
+  if (path.isEmpty()) {
+    m_file.open(stdout, QIODevice::WriteOnly, QFileDevice::DontCloseHandle);
+    return QString();
+  }
+  m_file.setFileName(path);
+  if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    return "Error: Could not open console output file " + path;
+  return QString();
+}
+
+void ConsoleOutput::write(const QString &text) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_buffer.append(text.toUtf8());
+  if ((m_policy == FlushPolicy::Newline && text.contains('\n')) ||
+      (m_policy != FlushPolicy::Exit && m_buffer.size() >= m_bufferSize))
+    flushLocked();
+}
+
+void ConsoleOutput::flush() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  flushLocked();
+}
+
+void ConsoleOutput::flushLocked() {
+  if (m_buffer.isEmpty())
+    return;
+  m_file.write(m_buffer);
+  m_file.flush();
+  // Retains the capacity of the buffer.
+  m_buffer.resize(0);
+}
+
+} // namespace Ripes
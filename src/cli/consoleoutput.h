@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+#include <mutex>
+
+namespace Ripes {
+
+/**
+ * @brief The ConsoleOutput class
+ * A buffered sink for the console output of simulated programs in CLI mode.
+ * Output is written directly by the simulation thread (see
+ * SystemIO::setOutputSink) into a buffer, which is written to stdout or to a
+ * file according to the flush policy:
+ * - Newline: whenever the output contains a newline, or the buffer is full.
+ * - Size: whenever the buffer is full.
+ * - Exit: only when the output is flushed explicitly, ie. once a run ends.
+ */
+class ConsoleOutput {
+public:
+  enum class FlushPolicy { Newline, Size, Exit };
+
+  static ConsoleOutput &get() {
+    static ConsoleOutput output;
+    return output;
+  }
+
+  /// Directs the output to the file at @p path, or to stdout if @p path is
+  /// empty. Returns an error message on failure, or an empty string on
+  /// success.
+  QString open(const QString &path, FlushPolicy policy, int bufferSize);
+
+  void write(const QString &text);
+  void flush();
+
+private:
+  ConsoleOutput();
+  void flushLocked();
+
+  std::mutex m_mutex;
+  QFile m_file;
+  QByteArray m_buffer;
+  FlushPolicy m_policy = FlushPolicy::Newline;
+  int m_bufferSize = 1 << 16;
+};
+
+} // namespace Ripes
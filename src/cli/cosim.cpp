@@ -0,0 +1,198 @@
+#include "cosim.h"
+
+#include "processorhandler.h"
+#include "processorobserver.h"
+#include "processors/pagedaddressspace.h"
+
+#include <QElapsedTimer>
+
+#include <deque>
+
+namespace Ripes {
+
+// Maximum number of reference cycles executed while matching a single register
+// state change of the target, before the reference is considered to have
+// diverged (ie. a pipelined reference which stalls indefinitely).
+static constexpr long long s_maxReferenceSteps = 1 << 20;
+
+/// FNV-1a hash of the general purpose registers of @p proc.
+static uint64_t hashRegisters(const RipesProcessor &proc, unsigned regCnt) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  const RegisterView values = proc.registers(RegisterFileType::GPR);
+  for (unsigned i = 0; i < regCnt; ++i) {
+    const VInt value = values[i];
+    for (unsigned byte = 0; byte < sizeof(VInt); ++byte) {
+      hash ^= (value >> (byte * 8)) & 0xFF;
+      hash *= 0x100000001b3ULL;
+    }
+  }
+  return hash;
+}
+
+namespace {
+
+// Records the memory written by each system call of the target, as the system
+// call left it, until the reference reaches the system call.
+class SyscallWrites : public ProcessorObserver {
+public:
+  using Writes = std::vector<std::pair<AInt, QByteArray>>;
+
+  unsigned events() const override { return Syscall; }
+  void onSyscall(const SyscallRecord &record) override {
+    Writes writes;
+    const auto &memory = ProcessorHandler::getMemory();
+    for (const auto &range : record.writes) {
+      QByteArray data(static_cast<int>(range.second), Qt::Uninitialized);
+      for (AInt i = 0; i < range.second; ++i)
+        data[static_cast<int>(i)] =
+            static_cast<char>(memory.readMemConst(range.first + i, 1));
+      writes.emplace_back(range.first, std::move(data));
+    }
+    m_pending.push_back(std::move(writes));
+  }
+
+  /// Returns the writes of the oldest system call not yet taken.
+  Writes take() {
+    if (m_pending.empty())
+      return {};
+    Writes writes = std::move(m_pending.front());
+    m_pending.pop_front();
+    return writes;
+  }
+
+private:
+  std::deque<Writes> m_pending;
+};
+
+} // namespace
+
+static QString divergenceReport(const RipesProcessor &target,
+                                const RipesProcessor &reference,
+                                unsigned regCnt, AInt referencePC) {
+  QString report = "Register state divergence detected";
+  report += "\nTarget processor state: \tCycle #: " +
+            QString::number(target.getCycleCount()) +
+            "\t Retired: " + QString::number(target.getInstructionsRetired());
+  report += "\nReference processor state: \tPC: 0x" +
+            QString::number(referencePC, 16) +
+            "\t Retired: " +
+            QString::number(reference.getInstructionsRetired());
+  const RegisterView expectedValues =
+      reference.registers(RegisterFileType::GPR);
+  const RegisterView actualValues = target.registers(RegisterFileType::GPR);
+  for (unsigned i = 0; i < regCnt; ++i) {
+    const VInt expected = expectedValues[i];
+    const VInt actual = actualValues[i];
+    if (expected != actual) {
+      report += "\nDifference in register x" + QString::number(i) + ":";
+      report += "\t expected: 0x" + QString::number(expected, 16) +
+                "\tactual: 0x" + QString::number(actual, 16);
+    }
+  }
+  return report;
+}
+
+QString runCosimulation(ProcessorID reference, int timeout,
+                        CosimResult &result) {
+  result = CosimResult();
+  auto program = ProcessorHandler::getProgram();
+  if (!program)
+    return "No program loaded";
+
+  auto *target = ProcessorHandler::getProcessorNonConst();
+  const ISAInfoBase *isa = target->implementsISA();
+  const QStringList &extensions = isa->enabledExtensions();
+  const auto &refDesc = ProcessorRegistry::getDescription(reference);
+  if (!isa->eq(refDesc.isaInfo().isa.get(), extensions)) {
+    return "Reference processor '" + enumToString<ProcessorID>(reference) +
+           "' does not implement the ISA of the current processor (" +
+           isa->name() + ")";
+  }
+
+  auto ref = ProcessorRegistry::constructProcessor(reference, extensions);
+  ref->isExecutableAddress = [](AInt address) {
+    return ProcessorHandler::isExecutableAddress(address);
+  };
+  // System calls are only executed by the target processor. Once the reference
+  // reaches a system call, the target has already executed it, and the
+  // results of the system call are forwarded to the reference: its return
+  // registers, and the memory it wrote (ie. the buffer of a read).
+  SyscallWrites syscallWrites;
+  ref->trapHandler = [&] {
+    for (unsigned arg = 0; arg < 2; ++arg) {
+      const int reg = isa->syscallArgReg(arg);
+      if (reg >= 0)
+        ref->setRegister(RegisterFileType::GPR, reg,
+                         target->registers(RegisterFileType::GPR)[reg]);
+    }
+    auto &refMemory = ref->getMemory();
+    for (const auto &write : syscallWrites.take()) {
+      for (int i = 0; i < write.second.size(); ++i)
+        refMemory.writeMem(write.first + i,
+                           static_cast<uint8_t>(write.second[i]), 1);
+      ref->memoryWritten(write.first, write.second.size());
+    }
+  };
+  ref->postConstruct();
+  auto &mem = ref->getMemory();
+  for (const auto &seg : program->sections) {
+    addInitializationMemory(mem, seg.second.address, seg.second.data.data(),
+                            seg.second.data.length());
+  }
+  ref->setPCInitialValue(program->entryPoint);
+  ref->resetProcessor();
+  ProcessorHandler::transferArchitecturalState(*target, *ref);
+
+  const unsigned regCnt = isa->regCnt();
+  uint64_t targetHash = hashRegisters(*target, regCnt);
+  uint64_t refHash = hashRegisters(*ref, regCnt);
+  if (targetHash != refHash)
+    return "Initial register state of the reference processor differs";
+
+  ProcessorHandler::attachObserver(&syscallWrites);
+  QElapsedTimer elapsed;
+  elapsed.start();
+  while (!target->finished()) {
+    if (timeout != 0 && (target->getCycleCount() % 1024) == 0 &&
+        elapsed.elapsed() > timeout) {
+      ProcessorHandler::detachObserver(&syscallWrites);
+      return "Co-simulation did not finish within the specified timeout (" +
+             QString::number(timeout) + " ms)";
+    }
+
+    target->clock();
+    const uint64_t newTargetHash = hashRegisters(*target, regCnt);
+    if (newTargetHash == targetHash)
+      continue;
+    targetHash = newTargetHash;
+
+    // Advance the reference until its register state matches the target. The
+    // reference may retire at most one instruction more than the target; a
+    // system call is executed by the target before the ecall instruction
+    // retires. Multiple-issue targets may change several registers in a single
+    // cycle, so the reference may pass through several intermediate states.
+    const long long maxRetired = target->getInstructionsRetired() + 1;
+    AInt refPC = 0;
+    for (long long steps = 0; refHash != targetHash && !ref->finished() &&
+                              ref->getInstructionsRetired() < maxRetired &&
+                              steps < s_maxReferenceSteps;
+         ++steps) {
+      refPC = ref->getPcForStage({0, 0});
+      ref->clock();
+      refHash = hashRegisters(*ref, regCnt);
+    }
+
+    result.comparisons++;
+    result.signature = (result.signature ^ targetHash) * 0x100000001b3ULL;
+    if (targetHash != refHash) {
+      result.diverged = true;
+      result.report = divergenceReport(*target, *ref, regCnt, refPC);
+      break;
+    }
+  }
+  ProcessorHandler::detachObserver(&syscallWrites);
+
+  return QString();
+}
+
+} // namespace Ripes
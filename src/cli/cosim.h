@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QString>
+
+#include "processorregistry.h"
+
+namespace Ripes {
+
+/**
+ * @brief The CosimResult struct
+ * Result of a lockstep co-simulation of the current processor against a
+ * reference processor model.
+ */
+struct CosimResult {
+  bool diverged = false;
+  // Number of register state changes which were compared.
+  long long comparisons = 0;
+  // Rolling hash over the register state of each compared change; identical
+  // traces yield identical signatures.
+  uint64_t signature = 0;
+  // Description of the first divergence, if any.
+  QString report;
+};
+
+/**
+ * @brief runCosimulation
+ * Runs the currently loaded program on the current processor, while a
+ * @p reference processor model follows along in lockstep. Each time the
+ * register file of the current processor changes, the reference model is
+ * executed until the hashes of both register files match, or until it has
+ * retired more instructions than the current processor, in which case the
+ * models have diverged. Simulation stops at the first divergence, when
+ * the program finishes, or after @p timeout ms (0 = no timeout). System calls
+ * are only executed by the current processor; their return values and the
+ * memory they wrote are mirrored into the reference. No traces are stored, so
+ * the memory cost is constant in the length of the program.
+ * Returns an error message on failure, or an empty string on success;
+ * a divergence is not considered a failure, but is recorded in @p result.
+ */
+QString runCosimulation(ProcessorID reference, int timeout,
+                        CosimResult &result);
+
+} // namespace Ripes
@@ -0,0 +1,106 @@
+#include "cpistack.h"
+
+#include "processorhandler.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+CPIStack::CPIStack() {
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorClocked, this,
+          [this] { processorClocked(); }, Qt::DirectConnection);
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          [this] { reset(); });
+  reset();
+}
+
+QString CPIStack::causeName(StallCause cause) {
+  switch (cause) {
+  case StallCause::None:
+    return "other";
+  case StallCause::DataHazard:
+    return "data hazard";
+  case StallCause::ControlHazard:
+    return "control hazard";
+  case StallCause::EcallDrain:
+    return "ecall drain";
+  case StallCause::WayHazard:
+    return "way hazard";
+  case StallCause::FunctionalUnit:
+    return "functional unit";
+  case StallCause::Memory:
+    return "memory";
+  }
+  Q_UNREACHABLE();
+}
+
+void CPIStack::reset() {
+  const auto *proc = ProcessorHandler::getProcessor();
+  m_width = std::max<unsigned>(proc->structure().size(), 1);
+  m_maxPendingSlots = proc->structure().numStages();
+  m_pending.clear();
+  m_pendingSlots = 0;
+  m_lostSlots.fill(0);
+  m_dataHazardSlots.clear();
+  m_cycles = 0;
+  m_retired = 0;
+  m_lastRetired = proc->getInstructionsRetired();
+}
+
+void CPIStack::charge(StallCause cause, int reg, unsigned long long slots) {
+  m_lostSlots[static_cast<unsigned>(cause)] += slots;
+  if (cause == StallCause::DataHazard)
+    m_dataHazardSlots[reg] += slots;
+}
+
+void CPIStack::processorClocked() {
+  const auto *proc = ProcessorHandler::getProcessor();
+  m_cycles++;
+
+  const unsigned long long retired = proc->getInstructionsRetired();
+  const unsigned long long newlyRetired = retired - m_lastRetired;
+  m_lastRetired = retired;
+  m_retired += newlyRetired;
+  unsigned lost =
+      m_width - std::min<unsigned long long>(newlyRetired, m_width);
+
+  const RipesProcessor::Stall stall = proc->stallCause();
+  if (stall.cause == StallCause::Memory ||
+      stall.cause == StallCause::FunctionalUnit) {
+    // The pipeline is frozen; queued bubbles do not advance.
+    charge(stall.cause, -1, lost);
+    return;
+  }
+
+  // Charge the lost slots of this cycle to the oldest signalled causes.
+  while (lost > 0 && !m_pending.empty()) {
+    auto &oldest = m_pending.front();
+    const unsigned slots = std::min(lost, oldest.lostSlots);
+    charge(oldest.cause, oldest.reg, slots);
+    oldest.lostSlots -= slots;
+    m_pendingSlots -= slots;
+    lost -= slots;
+    if (oldest.lostSlots == 0)
+      m_pending.pop_front();
+  }
+  if (lost > 0)
+    charge(StallCause::None, -1, lost);
+
+  if (stall.cause == StallCause::None || stall.lostSlots == 0)
+    return;
+  m_pending.push_back(stall);
+  m_pendingSlots += stall.lostSlots;
+  // A flush may discard bubbles of a preceding stall, such that fewer slots
+  // are lost than were signalled. Drop the oldest excess.
+  while (m_pendingSlots > m_maxPendingSlots) {
+    auto &oldest = m_pending.front();
+    const unsigned excess =
+        std::min(m_pendingSlots - m_maxPendingSlots, oldest.lostSlots);
+    oldest.lostSlots -= excess;
+    m_pendingSlots -= excess;
+    if (oldest.lostSlots == 0)
+      m_pending.pop_front();
+  }
+}
+
+} // namespace Ripes
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QObject>
+
+#include <array>
+#include <deque>
+#include <map>
+
+#include "processors/interface/ripesprocessor.h"
+
+namespace Ripes {
+
+/**
+ * @brief The CPIStack class
+ * Attributes the issue slots of each simulated cycle to either a retiring
+ * instruction or to the cause of the slot being lost, as reported by
+ * RipesProcessor::stallCause().
+ *
+ * Stalls and flushes are signalled by the hazard logic a number of cycles
+ * before the resulting bubbles reach the end of the pipeline. Signalled causes
+ * are therefore queued with the number of slots they lose, and lost slots are
+ * charged to the oldest queued cause. Lost slots with no queued cause, such as
+ * while the pipeline fills and drains, are charged to Other. Memory and
+ * functional unit stalls freeze the whole pipeline, and are charged in the
+ * cycle they occur.
+ */
+class CPIStack : public QObject {
+public:
+  using StallCause = RipesProcessor::StallCause;
+  static constexpr unsigned NCauses =
+      static_cast<unsigned>(StallCause::Memory) + 1;
+
+  CPIStack();
+
+  /// Returns the number of issue slots lost to @p cause. StallCause::None
+  /// holds the slots lost with no signalled cause.
+  unsigned long long lostSlots(StallCause cause) const {
+    return m_lostSlots.at(static_cast<unsigned>(cause));
+  }
+  /// Returns the number of issue slots lost to data hazards on each register.
+  const std::map<int, unsigned long long> &dataHazardSlots() const {
+    return m_dataHazardSlots;
+  }
+  unsigned long long cycles() const { return m_cycles; }
+  unsigned long long retired() const { return m_retired; }
+  unsigned issueWidth() const { return m_width; }
+
+  static QString causeName(StallCause cause);
+
+private:
+  void reset();
+  void processorClocked();
+  void charge(StallCause cause, int reg, unsigned long long slots);
+
+  unsigned m_width = 1;
+  // Upper bound on the number of queued slots; no more bubbles than the
+  // pipeline holds can be in flight.
+  unsigned m_maxPendingSlots = 0;
+  std::deque<RipesProcessor::Stall> m_pending;
+  unsigned m_pendingSlots = 0;
+
+  std::array<unsigned long long, NCauses> m_lostSlots{};
+  std::map<int, unsigned long long> m_dataHazardSlots;
+  unsigned long long m_cycles = 0;
+  unsigned long long m_retired = 0;
+  unsigned long long m_lastRetired = 0;
+};
+
+} // namespace Ripes
@@ -0,0 +1,539 @@
+#include "gdbstub.h"
+
+#include "processorhandler.h"
+#include "processors/pagedaddressspace.h"
+#include "processorstate.h"
+
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include <set>
+
+namespace Ripes {
+
+// Maximum size of a packet, as advertised to GDB.
+static constexpr int s_packetSize = 0x4000;
+// While continuing, the connection is polled for interrupts in between this
+// many cycles.
+static constexpr long long s_pollCycles = 1 << 14;
+// Maximum number of cycles clocked while single-stepping, before the step is
+// abandoned (ie. a processor which stalls indefinitely).
+static constexpr long long s_maxStepCycles = 1 << 20;
+// The byte sent by GDB to interrupt a running target.
+static constexpr char s_interrupt = '\x03';
+
+static int hexDigit(char c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+/// Parses @p text as a big endian hexadecimal number, ie. an address.
+static bool parseHex(const QByteArray &text, AInt &value) {
+  bool ok = false;
+  value = text.toULongLong(&ok, 16);
+  return ok;
+}
+
+/// Encodes the @p bytes low bytes of @p value as hex, in target (little
+/// endian) byte order.
+static void appendHexValue(QByteArray &out, VInt value, unsigned bytes) {
+  static constexpr char digits[] = "0123456789abcdef";
+  for (unsigned i = 0; i < bytes; ++i) {
+    const uint8_t byte = value >> (i * 8);
+    out.append(digits[byte >> 4]);
+    out.append(digits[byte & 0xF]);
+  }
+}
+
+/// Decodes @p bytes hex encoded bytes at @p text, in target (little endian)
+/// byte order.
+static bool parseHexValue(const char *text, unsigned bytes, VInt &value) {
+  value = 0;
+  for (unsigned i = 0; i < bytes; ++i) {
+    const int hi = hexDigit(text[2 * i]);
+    const int lo = hexDigit(text[2 * i + 1]);
+    if (hi < 0 || lo < 0)
+      return false;
+    value |= static_cast<VInt>(hi << 4 | lo) << (i * 8);
+  }
+  return true;
+}
+
+/// Parses the "<address>,<length>" arguments of a memory or breakpoint
+/// packet.
+static bool parseRange(const QByteArray &args, AInt &address, AInt &length) {
+  const int comma = args.indexOf(',');
+  return comma >= 0 && parseHex(args.left(comma), address) &&
+         parseHex(args.mid(comma + 1), length);
+}
+
+/// Escapes the characters of binary data which may not occur verbatim within
+/// a packet.
+static QByteArray escapeBinary(const QByteArray &data) {
+  QByteArray out;
+  out.reserve(data.size());
+  for (const char c : data) {
+    if (c == '#' || c == '$' || c == '}' || c == '*') {
+      out.append('}');
+      out.append(c ^ 0x20);
+    } else {
+      out.append(c);
+    }
+  }
+  return out;
+}
+
+static QByteArray unescapeBinary(const char *data, int size) {
+  QByteArray out;
+  out.reserve(size);
+  for (int i = 0; i < size; ++i) {
+    if (data[i] == '}' && i + 1 < size)
+      out.append(data[++i] ^ 0x20);
+    else
+      out.append(data[i]);
+  }
+  return out;
+}
+
+static void readMemory(AInt address, uint8_t *data, AInt bytes) {
+  auto &memory = ProcessorHandler::getMemory();
+  if (auto *paged = dynamic_cast<PagedAddressSpaceMM *>(&memory)) {
+    paged->readBlock(address, data, bytes);
+    return;
+  }
+  for (AInt i = 0; i < bytes; ++i)
+    data[i] = static_cast<uint8_t>(memory.readMemConst(address + i, 1));
+}
+
+static void writeMemory(AInt address, const uint8_t *data, AInt bytes) {
+  auto &memory = ProcessorHandler::getMemory();
+  if (auto *paged = dynamic_cast<PagedAddressSpaceMM *>(&memory)) {
+    paged->writeBlock(address, data, bytes);
+  } else {
+    for (AInt i = 0; i < bytes; ++i)
+      memory.writeMem(address + i, data[i], 1);
+  }
+  ProcessorHandler::memoryWritten(address, bytes);
+}
+
+/**
+ * @brief The GDBSession class
+ * A single session of the remote serial protocol over a connected socket. The
+ * socket is used in blocking mode, such that no event loop is required; the
+ * processor is clocked on the calling thread.
+ */
+class GDBSession {
+public:
+  GDBSession(QTcpSocket &socket)
+      : m_socket(socket), m_proc(ProcessorHandler::getProcessorNonConst()),
+        m_isa(m_proc->implementsISA()), m_regCnt(m_isa->regCnt()),
+        m_regBytes(m_isa->bytes()) {}
+
+  void serve() {
+    QByteArray packet;
+    while (!m_done && readPacket(packet)) {
+      const QByteArray reply = handle(packet);
+      if (!m_killed)
+        sendPacket(reply);
+      // Acknowledgements stop following the reply to QStartNoAckMode.
+      m_noAck |= m_startNoAck;
+    }
+  }
+
+private:
+  enum class Stop { Trap, Interrupt, Exited };
+
+  /// Reads any pending input without blocking longer than @p timeout ms.
+  /// Returns false if the connection is closed.
+  bool fill(int timeout) {
+    if (m_socket.bytesAvailable() == 0 && !m_socket.waitForReadyRead(timeout) &&
+        m_socket.state() != QAbstractSocket::ConnectedState)
+      return false;
+    m_in += m_socket.readAll();
+    return true;
+  }
+
+  /// Reads the next packet, acknowledging it. Returns false if the connection
+  /// is closed.
+  bool readPacket(QByteArray &packet) {
+    for (;;) {
+      // Anything preceding the start of a packet (acknowledgements and
+      // interrupts while stopped) is discarded.
+      const int start = m_in.indexOf('$');
+      if (start < 0) {
+        m_in.clear();
+        if (!fill(-1))
+          return false;
+        continue;
+      }
+      const int end = m_in.indexOf('#', start);
+      if (end < 0 || m_in.size() < end + 3) {
+        if (!fill(-1))
+          return false;
+        continue;
+      }
+
+      packet = m_in.mid(start + 1, end - start - 1);
+      bool ok = false;
+      const unsigned checksum = m_in.mid(end + 1, 2).toUInt(&ok, 16);
+      m_in.remove(0, end + 3);
+      if (m_noAck)
+        return true;
+      if (!ok || checksum != checksumOf(packet)) {
+        write("-");
+        continue;
+      }
+      write("+");
+      return true;
+    }
+  }
+
+  void sendPacket(const QByteArray &payload) {
+    QByteArray packet;
+    packet.reserve(payload.size() + 4);
+    packet.append('$');
+    packet.append(payload);
+    packet.append('#');
+    appendHexValue(packet, checksumOf(payload), 1);
+    write(packet);
+  }
+
+  void write(const QByteArray &data) {
+    m_socket.write(data);
+    while (m_socket.bytesToWrite() > 0 && m_socket.waitForBytesWritten(-1))
+      ;
+  }
+
+  static unsigned checksumOf(const QByteArray &data) {
+    unsigned sum = 0;
+    for (const char c : data)
+      sum += static_cast<uint8_t>(c);
+    return sum & 0xFF;
+  }
+
+  QByteArray handle(const QByteArray &packet) {
+    if (packet.isEmpty())
+      return QByteArray();
+    const QByteArray args = packet.mid(1);
+    switch (packet.at(0)) {
+    case '?':
+      return stopReply();
+    case 'q':
+    case 'Q':
+      return handleQuery(packet);
+    case 'H':
+      // A single thread.
+      return "OK";
+    case 'g':
+      return readRegisters();
+    case 'G':
+      return writeRegisters(args);
+    case 'p':
+      return readRegister(args);
+    case 'P':
+      return writeRegister(args);
+    case 'm':
+      return readMemoryPacket(args);
+    case 'M':
+    case 'X':
+      return writeMemoryPacket(packet);
+    case 'Z':
+    case 'z':
+      return breakpoint(packet);
+    case 's':
+    case 'c':
+      // Resuming at a given address requires writing the PC.
+      if (!args.isEmpty())
+        return "E01";
+      m_stop = resume(packet.at(0) == 's');
+      return stopReply();
+    case 'v':
+      return handleV(packet);
+    case 'D':
+      m_done = true;
+      return "OK";
+    case 'k':
+      // Kill requests are not replied to.
+      m_done = m_killed = true;
+      return QByteArray();
+    default:
+      // Unsupported packets are replied to with an empty packet.
+      return QByteArray();
+    }
+  }
+
+  QByteArray handleQuery(const QByteArray &packet) {
+    if (packet.startsWith("qSupported"))
+      return "PacketSize=" + QByteArray::number(s_packetSize, 16) +
+             ";qXfer:features:read+;QStartNoAckMode+";
+    if (packet == "QStartNoAckMode") {
+      m_startNoAck = true;
+      return "OK";
+    }
+    if (packet.startsWith("qXfer:features:read:"))
+      return readFeatures(packet.mid(sizeof("qXfer:features:read:") - 1));
+    if (packet == "qAttached")
+      return "1";
+    if (packet == "qC")
+      return "QC1";
+    if (packet == "qfThreadInfo")
+      return "m1";
+    if (packet == "qsThreadInfo")
+      return "l";
+    return QByteArray();
+  }
+
+  QByteArray handleV(const QByteArray &packet) {
+    if (packet == "vCont?")
+      return "vCont;c;s";
+    if (packet.startsWith("vCont;")) {
+      // A single thread; the first action applies to it.
+      const char action = packet.size() > 6 ? packet.at(6) : 0;
+      if (action != 'c' && action != 's')
+        return "E01";
+      m_stop = resume(action == 's');
+      return stopReply();
+    }
+    return QByteArray();
+  }
+
+  QByteArray stopReply() const {
+    switch (m_stop) {
+    case Stop::Trap:
+      return "S05";
+    case Stop::Interrupt:
+      return "S02";
+    case Stop::Exited:
+      return "W00";
+    }
+    Q_UNREACHABLE();
+  }
+
+  AInt pc() const { return oldestInFlightPC(*m_proc); }
+
+  QByteArray readRegisters() const {
+    QByteArray out;
+    out.reserve((m_regCnt + 1) * m_regBytes * 2);
+    const RegisterView regs = m_proc->registers(RegisterFileType::GPR);
+    for (unsigned i = 0; i < m_regCnt; ++i)
+      appendHexValue(out, regs[i], m_regBytes);
+    appendHexValue(out, pc(), m_regBytes);
+    return out;
+  }
+
+  QByteArray writeRegisters(const QByteArray &args) {
+    const int regChars = m_regBytes * 2;
+    if (args.size() < static_cast<int>(m_regCnt) * regChars)
+      return "E01";
+    std::vector<VInt> values(m_regCnt);
+    for (unsigned i = 0; i < m_regCnt; ++i) {
+      if (!parseHexValue(args.constData() + i * regChars, m_regBytes,
+                         values[i]))
+        return "E01";
+    }
+    if (args.size() >= static_cast<int>(m_regCnt + 1) * regChars) {
+      VInt newPC;
+      if (!parseHexValue(args.constData() + m_regCnt * regChars, m_regBytes,
+                         newPC) ||
+          newPC != pc())
+        return "E01";
+    }
+    // x0 is hardwired to zero.
+    for (unsigned i = 1; i < m_regCnt; ++i)
+      m_proc->setRegister(RegisterFileType::GPR, i, values[i]);
+    return "OK";
+  }
+
+  QByteArray readRegister(const QByteArray &args) const {
+    AInt reg;
+    if (!parseHex(args, reg) || reg > m_regCnt)
+      return "E01";
+    QByteArray out;
+    appendHexValue(out,
+                   reg == m_regCnt
+                       ? pc()
+                       : m_proc->registers(RegisterFileType::GPR)[reg],
+                   m_regBytes);
+    return out;
+  }
+
+  QByteArray writeRegister(const QByteArray &args) {
+    const int eq = args.indexOf('=');
+    AInt reg;
+    VInt value;
+    if (eq < 0 || !parseHex(args.left(eq), reg) || reg > m_regCnt ||
+        args.size() - eq - 1 < static_cast<int>(m_regBytes) * 2 ||
+        !parseHexValue(args.constData() + eq + 1, m_regBytes, value))
+      return "E01";
+    if (reg == m_regCnt)
+      return value == pc() ? "OK" : "E01";
+    if (reg != 0)
+      m_proc->setRegister(RegisterFileType::GPR, reg, value);
+    return "OK";
+  }
+
+  QByteArray readMemoryPacket(const QByteArray &args) const {
+    AInt address, length;
+    if (!parseRange(args, address, length))
+      return "E01";
+    // Replies are bounded by the packet size; GDB reads the remainder in
+    // subsequent packets.
+    length = std::min<AInt>(length, (s_packetSize - 4) / 2);
+    QByteArray data(length, '\0');
+    readMemory(address, reinterpret_cast<uint8_t *>(data.data()), length);
+    return data.toHex();
+  }
+
+  QByteArray writeMemoryPacket(const QByteArray &packet) {
+    const int colon = packet.indexOf(':');
+    AInt address, length;
+    if (colon < 0 || !parseRange(packet.mid(1, colon - 1), address, length))
+      return "E01";
+    const char *payload = packet.constData() + colon + 1;
+    const int payloadSize = packet.size() - colon - 1;
+    QByteArray data;
+    if (packet.at(0) == 'X')
+      data = unescapeBinary(payload, payloadSize);
+    else
+      data = QByteArray::fromHex(QByteArray::fromRawData(payload, payloadSize));
+    if (static_cast<AInt>(data.size()) != length)
+      return "E01";
+    if (length != 0)
+      writeMemory(address, reinterpret_cast<const uint8_t *>(data.constData()),
+                  length);
+    return "OK";
+  }
+
+  QByteArray breakpoint(const QByteArray &packet) {
+    // Software and hardware breakpoints are both implemented by the stub,
+    // rather than by writing to the program.
+    if (packet.size() < 3 || (packet.at(1) != '0' && packet.at(1) != '1') ||
+        packet.at(2) != ',')
+      return QByteArray();
+    AInt address, kind;
+    if (!parseRange(packet.mid(3), address, kind))
+      return "E01";
+    if (packet.at(0) == 'Z')
+      m_breakpoints.insert(address);
+    else
+      m_breakpoints.erase(address);
+    return "OK";
+  }
+
+  QByteArray readFeatures(const QByteArray &args) {
+    const int colon = args.indexOf(':');
+    AInt offset, length;
+    if (colon < 0 || !parseRange(args.mid(colon + 1), offset, length))
+      return "E01";
+    if (args.left(colon) != "target.xml")
+      return "E00";
+    const QByteArray &xml = targetDescription();
+    if (offset >= static_cast<AInt>(xml.size()))
+      return "l";
+    const QByteArray chunk = xml.mid(offset, length);
+    const bool last = offset + chunk.size() >= static_cast<AInt>(xml.size());
+    return (last ? "l" : "m") + escapeBinary(chunk);
+  }
+
+  const QByteArray &targetDescription() {
+    if (!m_targetXml.isEmpty())
+      return m_targetXml;
+    const QByteArray bits = QByteArray::number(m_isa->bits());
+    m_targetXml = "<?xml version=\"1.0\"?>\n"
+                  "<!DOCTYPE target SYSTEM \"gdb-target.dtd\">\n"
+                  "<target version=\"1.0\">\n"
+                  "<architecture>riscv:rv" +
+                  bits +
+                  "</architecture>\n"
+                  "<feature name=\"org.gnu.gdb.riscv.cpu\">\n";
+    for (unsigned i = 0; i < m_regCnt; ++i)
+      m_targetXml += "<reg name=\"x" + QByteArray::number(i) + "\" bitsize=\"" +
+                     bits + "\" type=\"int\"/>\n";
+    m_targetXml += "<reg name=\"pc\" bitsize=\"" + bits +
+                   "\" type=\"code_ptr\"/>\n"
+                   "</feature>\n"
+                   "</target>\n";
+    return m_targetXml;
+  }
+
+  /// Returns true if GDB has requested an interrupt, or closed the connection.
+  bool interrupted() {
+    if (!fill(0))
+      return true;
+    const int idx = m_in.indexOf(s_interrupt);
+    if (idx < 0)
+      return false;
+    m_in.remove(idx, 1);
+    return true;
+  }
+
+  /// Clocks the processor until an instruction retires if @p step is set, or
+  /// else until reaching a breakpoint, being interrupted or finishing.
+  Stop resume(bool step) {
+    if (m_proc->finished())
+      return Stop::Exited;
+    long long retired = m_proc->getInstructionsRetired();
+    for (long long cycles = 1;; ++cycles) {
+      m_proc->clock();
+      if (m_proc->finished())
+        return Stop::Exited;
+      // The PC seen by GDB only advances as instructions retire.
+      if (m_proc->getInstructionsRetired() != retired) {
+        retired = m_proc->getInstructionsRetired();
+        if (step || (!m_breakpoints.empty() && m_breakpoints.count(pc())))
+          return Stop::Trap;
+      }
+      if (step && cycles >= s_maxStepCycles)
+        return Stop::Trap;
+      if (!step && cycles % s_pollCycles == 0 && interrupted())
+        return Stop::Interrupt;
+    }
+  }
+
+  QTcpSocket &m_socket;
+  RipesProcessor *m_proc;
+  const ISAInfoBase *m_isa;
+  const unsigned m_regCnt;
+  const unsigned m_regBytes;
+
+  QByteArray m_in;
+  bool m_noAck = false;
+  bool m_startNoAck = false;
+  bool m_done = false;
+  bool m_killed = false;
+  Stop m_stop = Stop::Trap;
+  std::set<AInt> m_breakpoints;
+  QByteArray m_targetXml;
+};
+
+QString runGDBServer(quint16 port) {
+  if (!ProcessorHandler::getProgram())
+    return "No program loaded";
+  const ISAInfoBase *isa = ProcessorHandler::currentISA();
+  if (ISAFamilyNames.at(isa->isaID()) != "RISC-V")
+    return "The GDB server only supports RISC-V processors";
+
+  // Only local connections are accepted; the stub provides unrestricted
+  // access to the simulator.
+  QTcpServer server;
+  if (!server.listen(QHostAddress::LocalHost, port))
+    return "Could not listen on port " + QString::number(port) + ": " +
+           server.errorString();
+  if (!server.waitForNewConnection(-1))
+    return "Failed to accept a GDB connection: " + server.errorString();
+  QTcpSocket *socket = server.nextPendingConnection();
+  server.close();
+
+  ProcessorHandler::stopRun();
+  GDBSession session(*socket);
+  session.serve();
+  socket->disconnectFromHost();
+  return QString();
+}
+
+} // namespace Ripes
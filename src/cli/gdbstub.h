@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QString>
+
+namespace Ripes {
+
+/**
+ * @brief runGDBServer
+ * Listens on the local TCP @p port for a GDB remote serial protocol connection,
+ * and serves a single debugging session of the currently loaded program on the
+ * current processor. The session ends once GDB detaches, kills the program or
+ * disconnects.
+ *
+ * The stub supports:
+ * - Bulk register reads and writes (g/G) and single register access (p/P) of
+ *   the general purpose registers and the PC, as described by the target
+ *   description (qXfer:features:read).
+ * - Bulk memory reads and writes (m/M/X), transferred page by page within host
+ *   memory for paged memories.
+ * - Software and hardware breakpoints (Z0/Z1), single-stepping (s) and
+ *   continuing (c), including through vCont. Continuing may be interrupted.
+ *
+ * The PC seen by GDB is that of the oldest instruction in flight, ie. the next
+ * instruction to retire, such that the registers seen by GDB are those of all
+ * instructions preceding the PC. Single-stepping clocks the processor until an
+ * instruction retires, and breakpoints trigger once the instruction at their
+ * address is the next to retire. For pipelined models, younger instructions
+ * may have partially executed by then. The PC may not be written.
+ *
+ * Returns an error message on failure, or an empty string on success.
+ */
+QString runGDBServer(quint16 port);
+
+} // namespace Ripes
@@ -0,0 +1,180 @@
+#include "headlessio.h"
+
+#include "io/iomanager.h"
+#include "processorhandler.h"
+
+#include <map>
+
+namespace Ripes {
+
+QString parseIODeviceSpec(const QString &spec, IODeviceSpec &out) {
+  const QStringList parts = spec.split(':');
+  const QString &type = parts.at(0);
+  const QString arg = parts.size() > 1 ? parts.at(1) : QString();
+  if (parts.size() > 2)
+    return "Invalid peripheral '" + spec + "' (--io).";
+
+  if (type == "ledmatrix") {
+    out.type = IODeviceSpec::Type::LedMatrix;
+    if (arg.isEmpty())
+      return QString();
+    const QStringList dims = arg.split('x');
+    bool widthOk = false, heightOk = false;
+    if (dims.size() == 2) {
+      out.width = dims.at(0).toUInt(&widthOk);
+      out.height = dims.at(1).toUInt(&heightOk);
+    }
+    const unsigned maxSide = LedMatrixDevice::s_maxSideWidth;
+    if (!widthOk || !heightOk || out.width == 0 || out.height == 0 ||
+        out.width > maxSide || out.height > maxSide)
+      return "Invalid LED matrix dimensions '" + arg +
+             "' (--io); expected <width>x<height>, each within [1, " +
+             QString::number(maxSide) + "].";
+  } else if (type == "switches") {
+    out.type = IODeviceSpec::Type::Switches;
+    if (arg.isEmpty())
+      return QString();
+    bool ok;
+    out.count = arg.toUInt(&ok);
+    if (!ok || out.count == 0 || out.count > SwitchesDevice::s_maxSwitches)
+      return "Invalid number of switches '" + arg + "' (--io).";
+  } else if (type == "dpad") {
+    out.type = IODeviceSpec::Type::DPad;
+    if (!arg.isEmpty())
+      return "The D-pad takes no parameters (--io).";
+  } else if (type == "dma") {
+    out.type = IODeviceSpec::Type::DMA;
+    if (arg.isEmpty())
+      return QString();
+    bool ok;
+    out.burstBytes = arg.toUInt(&ok);
+    if (!ok || out.burstBytes == 0)
+      return "Invalid number of bytes per cycle '" + arg + "' (--io).";
+  } else if (type == "timer") {
+    out.type = IODeviceSpec::Type::Timer;
+    if (!arg.isEmpty())
+      return "The timer takes no parameters (--io).";
+  } else {
+    return "Invalid peripheral type '" + type +
+           "' (--io). Options: [ledmatrix, switches, dpad, dma, timer].";
+  }
+  return QString();
+}
+
+HeadlessIO::~HeadlessIO() { close(); }
+
+QString HeadlessIO::open(const std::vector<IODeviceSpec> &specs,
+                         const QString &scriptPath, const QString &logPath) {
+  close();
+  if (!logPath.isEmpty()) {
+    m_logFile.setFileName(logPath);
+    if (!m_logFile.open(QIODevice::WriteOnly | QIODevice::Truncate |
+                        QIODevice::Text))
+      return "Error: Could not open IO log file " + logPath;
+    m_log.setDevice(&m_logFile);
+  }
+  m_ledWrites = 0;
+
+  // Peripherals are numbered per type, as in the IO tab.
+  std::map<IODeviceSpec::Type, unsigned> ids;
+  for (const auto &spec : specs) {
+    const QString id = QString::number(ids[spec.type]++);
+    switch (spec.type) {
+    case IODeviceSpec::Type::LedMatrix: {
+      auto device = std::make_unique<LedMatrixDevice>("LED Matrix " + id);
+      device->resize(spec.width, spec.height);
+      if (m_logFile.isOpen()) {
+        auto *ledMatrix = device.get();
+        device->ledChanged = [=](unsigned idx, uint32_t color) {
+          logLED(*ledMatrix, idx, color);
+        };
+      }
+      m_peripherals.push_back(std::move(device));
+      break;
+    }
+    case IODeviceSpec::Type::Switches: {
+      auto device = std::make_unique<SwitchesDevice>("Switches " + id);
+      device->setCount(spec.count);
+      m_peripherals.push_back(std::move(device));
+      break;
+    }
+    case IODeviceSpec::Type::DPad:
+      m_peripherals.push_back(std::make_unique<DPadDevice>("D-Pad " + id));
+      break;
+    case IODeviceSpec::Type::DMA: {
+      auto device = std::make_unique<DMADevice>("DMA " + id);
+      device->setBurstBytes(spec.burstBytes);
+      m_dmaControllers.push_back(device.get());
+      m_peripherals.push_back(std::move(device));
+      break;
+    }
+    case IODeviceSpec::Type::Timer: {
+      auto device = std::make_unique<TimerDevice>("Timer " + id);
+      m_timers.push_back(device.get());
+      m_peripherals.push_back(std::move(device));
+      break;
+    }
+    }
+  }
+  for (const auto &peripheral : m_peripherals)
+    IOManager::get().attachPeripheral(peripheral.get());
+
+  if (!scriptPath.isEmpty()) {
+    std::vector<IOInputDevice> inputs;
+    for (const auto &peripheral : m_peripherals)
+      inputs.push_back({peripheral->name(), peripheral.get()});
+    const QString err = m_replay.replay(inputs, scriptPath);
+    if (!err.isEmpty())
+      return err;
+  }
+
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorClocked, this,
+          [this] { processorClocked(); }, Qt::DirectConnection);
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          [this] { processorReset(); });
+  processorReset();
+  return QString();
+}
+
+QString HeadlessIO::close() {
+  disconnect(ProcessorHandler::get(), nullptr, this, nullptr);
+  m_replay.stop();
+  for (const auto &peripheral : m_peripherals)
+    IOManager::get().detachPeripheral(peripheral.get());
+  m_peripherals.clear();
+  m_dmaControllers.clear();
+  m_timers.clear();
+
+  if (!m_logFile.isOpen())
+    return QString();
+  m_log.flush();
+  const bool failed = m_log.status() != QTextStream::Ok;
+  m_log.setDevice(nullptr);
+  m_logFile.close();
+  if (failed)
+    return "Error: Failed to write IO log file " + m_logFile.fileName();
+  return QString();
+}
+
+void HeadlessIO::processorReset() {
+  for (auto *dma : m_dmaControllers)
+    dma->reset();
+  for (auto *timer : m_timers)
+    timer->reset();
+}
+
+void HeadlessIO::processorClocked() {
+  for (auto *dma : m_dmaControllers)
+    dma->clock();
+}
+
+void HeadlessIO::logLED(const LedMatrixDevice &device, unsigned idx,
+                        uint32_t color) {
+  ++m_ledWrites;
+  m_log << ProcessorHandler::getProcessor()->getCycleCount() << ' '
+        << cName(device.name()) << ' ' << idx << " 0x"
+        << QString::number(color & 0xFFFFFF, 16).rightJustified(6, '0')
+        << '\n';
+}
+
+} // namespace Ripes
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <QFile>
+#include <QObject>
+#include <QString>
+#include <QTextStream>
+
+#include <memory>
+#include <vector>
+
+#include "io/iodevices.h"
+#include "io/ioeventrecorder.h"
+
+namespace Ripes {
+
+/// A headless peripheral to instantiate in CLI mode (--io).
+struct IODeviceSpec {
+  enum class Type { LedMatrix, Switches, DPad, DMA, Timer };
+  Type type;
+  // LED matrix dimensions.
+  unsigned width = 35;
+  unsigned height = 25;
+  // Number of switches.
+  unsigned count = 8;
+  // Bytes transferred per cycle by a DMA controller.
+  unsigned burstBytes = 4;
+};
+
+/// Parses @p spec, of the form "ledmatrix[:<width>x<height>]",
+/// "switches[:<count>]", "dpad", "dma[:<bytes per cycle>]" or "timer", into
+/// @p out.
+/// Returns an error message on failure, or an empty string on success.
+QString parseIODeviceSpec(const QString &spec, IODeviceSpec &out);
+
+/**
+ * @brief The HeadlessIO class
+ * Maps headless device models of the peripherals of the IO tab (iodevices.h)
+ * into the address space of the processor, such that programs interacting with
+ * peripherals may run in CLI mode. Peripherals are named, and export the same
+ * symbols, as when instantiated in the IO tab in the same order, ie. "LED
+ * Matrix 0" exports LED_MATRIX_0_BASE.
+ *
+ * Input to the peripherals is replayed from a script (see IOEventRecorder),
+ * such as recorded in the IO tab of the GUI.
+ *
+ * Writes which change the color of an LED are logged, as a line per write:
+ *   <cycle> <peripheral> <led index> <color, as 0xRRGGBB>
+ *
+ * DMA controllers are clocked after each cycle of the processor, and timers
+ * are disarmed whenever the processor is reset.
+ */
+class HeadlessIO : public QObject {
+public:
+  ~HeadlessIO() override;
+
+  /// Attaches the peripherals of @p specs, loads the input script at
+  /// @p scriptPath and opens the log at @p logPath, where either path may be
+  /// empty. Returns an error message on failure, or an empty string on
+  /// success.
+  QString open(const std::vector<IODeviceSpec> &specs,
+               const QString &scriptPath, const QString &logPath);
+  /// Detaches the peripherals and closes the log. Returns an error message if
+  /// writing the log failed, or an empty string on success.
+  QString close();
+
+  unsigned long long events() const { return m_replay.events(); }
+  unsigned long long ledWrites() const { return m_ledWrites; }
+
+private:
+  void processorReset();
+  void processorClocked();
+  void logLED(const LedMatrixDevice &device, unsigned idx, uint32_t color);
+
+  std::vector<std::unique_ptr<IOPeripheral>> m_peripherals;
+  std::vector<DMADevice *> m_dmaControllers;
+  std::vector<TimerDevice *> m_timers;
+  IOEventRecorder m_replay;
+
+  QFile m_logFile;
+  QTextStream m_log;
+  unsigned long long m_ledWrites = 0;
+};
+
+} // namespace Ripes
@@ -0,0 +1,113 @@
+#include "hotspotprofiler.h"
+
+#include "processorhandler.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+HotSpotProfiler::HotSpotProfiler() {
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorClocked, this,
+          [this] { processorClocked(); }, Qt::DirectConnection);
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          [this] { reset(); });
+  reset();
+}
+
+void HotSpotProfiler::reset() {
+  m_instrBytes = ProcessorHandler::currentISA()->instrBytes();
+  m_textStart = 0;
+  size_t instructions = 0;
+  if (auto program = ProcessorHandler::getProgram()) {
+    if (auto *text = program->getSection(TEXT_SECTION_NAME)) {
+      m_textStart = text->address;
+      instructions = text->data.size() / m_instrBytes;
+    }
+  }
+  m_cycles.assign(instructions, 0);
+  m_retired.assign(instructions, 0);
+  m_totalCycles = 0;
+  m_totalRetired = 0;
+
+  const auto *proc = ProcessorHandler::getProcessor();
+  m_finalStages.clear();
+  for (const auto &lane : proc->structure())
+    m_finalStages.push_back({lane.first, lane.second - 1});
+  m_lastRetired = proc->getInstructionsRetired();
+  m_pendingCycles = 0;
+}
+
+void HotSpotProfiler::processorClocked() {
+  const auto *proc = ProcessorHandler::getProcessor();
+  m_totalCycles++;
+  m_pendingCycles++;
+
+  const unsigned long long retired = proc->getInstructionsRetired();
+  unsigned long long newlyRetired = retired - m_lastRetired;
+  m_lastRetired = retired;
+  if (newlyRetired == 0)
+    return;
+  m_totalRetired += newlyRetired;
+
+  for (const auto &stage : m_finalStages) {
+    if (newlyRetired == 0)
+      break;
+    const StageInfo info = proc->stageInfo(stage);
+    if (!info.stage_valid || info.state != StageInfo::State::None)
+      continue;
+    newlyRetired--;
+    const AInt idx = (info.pc - m_textStart) / m_instrBytes;
+    if (info.pc < m_textStart || idx >= m_retired.size())
+      continue;
+    m_retired[idx]++;
+    m_cycles[idx] += m_pendingCycles;
+    m_pendingCycles = 0;
+  }
+  // Cycles of instructions retiring outside of the text section are not
+  // attributed.
+  m_pendingCycles = 0;
+}
+
+std::vector<HotSpotProfiler::Entry> HotSpotProfiler::hottest(unsigned n) const {
+  std::vector<Entry> entries;
+  for (size_t i = 0; i < m_cycles.size(); ++i) {
+    if (m_cycles[i] == 0 && m_retired[i] == 0)
+      continue;
+    entries.push_back({m_textStart + i * m_instrBytes, m_cycles[i],
+                       m_retired[i]});
+  }
+  const auto hotter = [](const Entry &lhs, const Entry &rhs) {
+    if (lhs.cycles != rhs.cycles)
+      return lhs.cycles > rhs.cycles;
+    return lhs.address < rhs.address;
+  };
+  if (entries.size() > n) {
+    std::partial_sort(entries.begin(), entries.begin() + n, entries.end(),
+                      hotter);
+    entries.resize(n);
+  } else {
+    std::sort(entries.begin(), entries.end(), hotter);
+  }
+  return entries;
+}
+
+QString HotSpotProfiler::symbolize(AInt address) {
+  auto program = ProcessorHandler::getProgram();
+  if (!program)
+    return QString();
+
+  // Find the nearest preceding symbol, skipping numerical labels.
+  const auto &symbols = program->symbols;
+  auto it = symbols.upper_bound(address);
+  while (it != symbols.begin()) {
+    --it;
+    if (!it->second.isLocal()) {
+      const AInt offset = address - it->first;
+      return offset == 0 ? it->second.v
+                         : it->second.v + "+" + QString::number(offset);
+    }
+  }
+  return QString();
+}
+
+} // namespace Ripes
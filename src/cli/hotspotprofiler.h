@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+
+#include <vector>
+
+#include "processors/interface/ripesprocessor.h"
+
+namespace Ripes {
+
+/**
+ * @brief The HotSpotProfiler class
+ * Counts the retired instructions and cycles of each instruction of the text
+ * section of the current program, during simulation. Counters are stored in
+ * flat arrays indexed by instruction, such that profiling a cycle is a few
+ * array increments.
+ *
+ * Cycles are attributed to instructions upon retirement: the cycles elapsed
+ * since the previous retirement are charged to the first instruction retiring
+ * in a cycle. Stall cycles are thus charged to the instruction which the
+ * pipeline was waiting on. The profile is cleared when the processor is reset.
+ */
+class HotSpotProfiler : public QObject {
+public:
+  struct Entry {
+    AInt address = 0;
+    unsigned long long cycles = 0;
+    unsigned long long retired = 0;
+  };
+
+  HotSpotProfiler();
+
+  /// Returns the @p n instructions with the most cycles, in descending order.
+  std::vector<Entry> hottest(unsigned n) const;
+
+  unsigned long long totalCycles() const { return m_totalCycles; }
+  unsigned long long totalRetired() const { return m_totalRetired; }
+
+  /// Returns the nearest symbol at or preceding @p address, followed by the
+  /// offset of @p address relative to the symbol, ie. "main+8". Returns an
+  /// empty string if no such symbol exists.
+  static QString symbolize(AInt address);
+
+private:
+  void reset();
+  void processorClocked();
+
+  AInt m_textStart = 0;
+  unsigned m_instrBytes = 4;
+  std::vector<unsigned long long> m_cycles;
+  std::vector<unsigned long long> m_retired;
+  unsigned long long m_totalCycles = 0;
+  unsigned long long m_totalRetired = 0;
+
+  // The final stage of each lane, which instructions retire from.
+  std::vector<StageIndex> m_finalStages;
+  unsigned long long m_lastRetired = 0;
+  unsigned long long m_pendingCycles = 0;
+};
+
+} // namespace Ripes
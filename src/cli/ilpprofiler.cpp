@@ -0,0 +1,344 @@
+#include "ilpprofiler.h"
+
+#include "instructionmix.h"
+#include "processorhandler.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+static constexpr size_t s_maxPendingAccesses = 32;
+// Offset of the floating-point registers in the register space.
+static constexpr int s_fpr = 32;
+
+namespace {
+
+// Register operands of an instruction, as indices into the register space, or
+// -1 if unused.
+struct Operands {
+  int rd = -1;
+  int rs1 = -1;
+  int rs2 = -1;
+  bool load = false;
+  bool store = false;
+  bool serializing = false;
+};
+
+} // namespace
+
+static Operands operands(const DecodedText::Instr &instr) {
+  Operands ops;
+  const int rd = instr.rd;
+  const int rs1 = instr.rs1;
+  const int rs2 = instr.rs2;
+  switch (instr.opcode) {
+  case RVInstr::NOP:
+    break;
+  case RVInstr::LUI:
+  case RVInstr::AUIPC:
+  case RVInstr::JAL:
+    ops.rd = rd;
+    break;
+  case RVInstr::BEQ:
+  case RVInstr::BNE:
+  case RVInstr::BLT:
+  case RVInstr::BGE:
+  case RVInstr::BLTU:
+  case RVInstr::BGEU:
+    ops.rs1 = rs1;
+    ops.rs2 = rs2;
+    break;
+  case RVInstr::LB:
+  case RVInstr::LH:
+  case RVInstr::LW:
+  case RVInstr::LBU:
+  case RVInstr::LHU:
+  case RVInstr::LWU:
+  case RVInstr::LD:
+  case RVInstr::LR_W:
+  case RVInstr::LR_D:
+    ops.rd = rd;
+    ops.rs1 = rs1;
+    ops.load = true;
+    break;
+  case RVInstr::SB:
+  case RVInstr::SH:
+  case RVInstr::SW:
+  case RVInstr::SD:
+    ops.rs1 = rs1;
+    ops.rs2 = rs2;
+    ops.store = true;
+    break;
+  case RVInstr::SC_W:
+  case RVInstr::SC_D:
+    ops.rd = rd;
+    ops.rs1 = rs1;
+    ops.rs2 = rs2;
+    ops.store = true;
+    break;
+  case RVInstr::FLW:
+  case RVInstr::FLD:
+    ops.rd = s_fpr + rd;
+    ops.rs1 = rs1;
+    ops.load = true;
+    break;
+  case RVInstr::FSW:
+  case RVInstr::FSD:
+    ops.rs1 = rs1;
+    ops.rs2 = s_fpr + rs2;
+    ops.store = true;
+    break;
+  case RVInstr::FEQ_S:
+  case RVInstr::FLT_S:
+  case RVInstr::FLE_S:
+  case RVInstr::FEQ_D:
+  case RVInstr::FLT_D:
+  case RVInstr::FLE_D:
+    ops.rd = rd;
+    ops.rs1 = s_fpr + rs1;
+    ops.rs2 = s_fpr + rs2;
+    break;
+  case RVInstr::FCLASS_S:
+  case RVInstr::FCVT_W_S:
+  case RVInstr::FCVT_WU_S:
+  case RVInstr::FCVT_L_S:
+  case RVInstr::FCVT_LU_S:
+  case RVInstr::FMV_X_W:
+  case RVInstr::FCLASS_D:
+  case RVInstr::FCVT_W_D:
+  case RVInstr::FCVT_WU_D:
+  case RVInstr::FCVT_L_D:
+  case RVInstr::FCVT_LU_D:
+  case RVInstr::FMV_X_D:
+    ops.rd = rd;
+    ops.rs1 = s_fpr + rs1;
+    break;
+  case RVInstr::FCVT_S_W:
+  case RVInstr::FCVT_S_WU:
+  case RVInstr::FCVT_S_L:
+  case RVInstr::FCVT_S_LU:
+  case RVInstr::FMV_W_X:
+  case RVInstr::FCVT_D_W:
+  case RVInstr::FCVT_D_WU:
+  case RVInstr::FCVT_D_L:
+  case RVInstr::FCVT_D_LU:
+  case RVInstr::FMV_D_X:
+    ops.rd = s_fpr + rd;
+    ops.rs1 = rs1;
+    break;
+  case RVInstr::FSQRT_S:
+  case RVInstr::FSQRT_D:
+  case RVInstr::FCVT_S_D:
+  case RVInstr::FCVT_D_S:
+    ops.rd = s_fpr + rd;
+    ops.rs1 = s_fpr + rs1;
+    break;
+  case RVInstr::ECALL:
+  case RVInstr::MRET:
+  case RVInstr::WFI:
+  case RVInstr::CSRRS:
+  case RVInstr::CSRRW:
+  case RVInstr::CSRRC:
+  case RVInstr::CSRRWI:
+  case RVInstr::CSRRSI:
+  case RVInstr::CSRRCI:
+    ops.serializing = true;
+    break;
+  default:
+    switch (InstructionMix::classify(instr.opcode)) {
+    case InstructionMix::Class::Atomic:
+      // Atomic memory operations read and write memory.
+      ops.rd = rd;
+      ops.rs1 = rs1;
+      ops.rs2 = rs2;
+      ops.load = true;
+      ops.store = true;
+      break;
+    case InstructionMix::Class::FP:
+      // The third source operand of fused multiply-adds is not tracked.
+      ops.rd = s_fpr + rd;
+      ops.rs1 = s_fpr + rs1;
+      ops.rs2 = s_fpr + rs2;
+      break;
+    case InstructionMix::Class::Vector:
+      ops.serializing = true;
+      break;
+    default: {
+      // Register-register operations read rs2; others take an immediate in
+      // its place.
+      ops.rd = rd;
+      ops.rs1 = rs1;
+      const bool rType = (instr.opcode >= RVInstr::ADD &&
+                          instr.opcode <= RVInstr::AND) ||
+                         (instr.opcode >= RVInstr::MUL &&
+                          instr.opcode <= RVInstr::REMU) ||
+                         (instr.opcode >= RVInstr::ADDW &&
+                          instr.opcode <= RVInstr::SRAW) ||
+                         (instr.opcode >= RVInstr::MULW &&
+                          instr.opcode <= RVInstr::REMUW);
+      if (rType)
+        ops.rs2 = rs2;
+      break;
+    }
+    }
+    break;
+  }
+  // x0 is a constant, and carries no dependencies.
+  if (ops.rd == 0)
+    ops.rd = -1;
+  if (ops.rs1 == 0)
+    ops.rs1 = -1;
+  if (ops.rs2 == 0)
+    ops.rs2 = -1;
+  return ops;
+}
+
+IlpProfiler::IlpProfiler(const std::vector<unsigned> &windowSizes)
+    : m_windowSizes(windowSizes) {
+  reset();
+  ProcessorHandler::attachObserver(this);
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          [this] { reset(); });
+}
+
+IlpProfiler::~IlpProfiler() { ProcessorHandler::detachObserver(this); }
+
+QString IlpProfiler::parseWindowSizes(const QString &spec,
+                                      std::vector<unsigned> &sizes) {
+  sizes.clear();
+  for (const auto &size : spec.split(',', Qt::SkipEmptyParts)) {
+    bool ok;
+    const unsigned value = size.trimmed().toUInt(&ok);
+    if (!ok || value == 0)
+      return "Invalid window size '" + size + "'";
+    sizes.push_back(value);
+  }
+  return QString();
+}
+
+std::vector<IlpProfiler::Window> IlpProfiler::windows() const {
+  std::vector<Window> windows;
+  for (const auto &schedule : m_schedules)
+    windows.push_back({schedule.size, schedule.criticalPath});
+  return windows;
+}
+
+void IlpProfiler::reset() {
+  m_text = DecodedText::decode();
+  m_schedules.clear();
+  for (const unsigned size : m_windowSizes) {
+    Schedule &schedule = m_schedules.emplace_back();
+    schedule.size = size;
+    schedule.retired.assign(size, 0);
+  }
+  m_schedules.emplace_back();
+  m_instructions = 0;
+  m_cycles = 0;
+  m_memoryDeps = 0;
+
+  const auto *proc = ProcessorHandler::getProcessor();
+  m_finalStages.clear();
+  for (const auto &lane : proc->structure())
+    m_finalStages.push_back({lane.first, lane.second - 1});
+  m_accesses.clear();
+  m_lastRetired = proc->getInstructionsRetired();
+  sample(*proc);
+}
+
+void IlpProfiler::sample(const RipesProcessor &proc) {
+  m_committing.clear();
+  for (const auto &stage : m_finalStages) {
+    const StageInfo info = proc.stageInfo(stage);
+    if (info.stage_valid && info.state == StageInfo::State::None)
+      m_committing.push_back(info.pc);
+  }
+}
+
+void IlpProfiler::onCycle(const RipesProcessor &proc) {
+  m_cycles++;
+  // Accesses of stall cycles were recorded in the cycle initiating the stall.
+  if (!proc.isStalled()) {
+    const MemoryAccess access = proc.dataMemAccess();
+    if (access.type != MemoryAccess::None) {
+      if (m_accesses.size() == s_maxPendingAccesses)
+        m_accesses.pop_front();
+      m_accesses.push_back({proc.dataMemAccessPC(), access});
+    }
+  }
+
+  const long long retired = proc.getInstructionsRetired();
+  long long newlyRetired = retired - m_lastRetired;
+  m_lastRetired = retired;
+  for (const AInt pc : m_committing) {
+    if (newlyRetired-- <= 0)
+      break;
+    retire(pc);
+  }
+  sample(proc);
+}
+
+void IlpProfiler::retire(AInt pc) {
+  m_instructions++;
+  const long idx = m_text.index(pc);
+  // Instructions outside of the text section are of unknown operands.
+  Operands ops;
+  if (idx >= 0)
+    ops = operands(m_text.instrs[idx]);
+  else
+    ops.serializing = true;
+
+  MemoryAccess access;
+  if (ops.load || ops.store) {
+    auto it = std::find_if(m_accesses.begin(), m_accesses.end(),
+                           [pc](const PendingAccess &a) { return a.pc == pc; });
+    if (it != m_accesses.end()) {
+      access = it->access;
+      m_accesses.erase(it);
+    }
+  }
+  const bool accessed = access.type != MemoryAccess::None;
+
+  bool memoryDep = false;
+  for (Schedule &schedule : m_schedules) {
+    long long ready = schedule.barrier;
+    for (const int rs : {ops.rs1, ops.rs2}) {
+      if (rs >= 0)
+        ready = std::max(ready, schedule.registers[rs]);
+    }
+    if (ops.load && accessed) {
+      for (unsigned b = 0; b < access.bytes; ++b) {
+        const auto it = schedule.memory.find(access.address + b);
+        if (it != schedule.memory.end()) {
+          ready = std::max(ready, it->second);
+          memoryDep = true;
+        }
+      }
+    }
+    // The instruction enters the window once the instruction preceding it by
+    // the size of the window has retired.
+    if (schedule.size != 0)
+      ready = std::max(ready, schedule.retired[schedule.head]);
+    if (ops.serializing)
+      ready = std::max(ready, schedule.criticalPath);
+
+    const long long completed = ready + 1;
+    if (ops.serializing)
+      schedule.barrier = completed;
+    if (ops.rd >= 0)
+      schedule.registers[ops.rd] = completed;
+    if (ops.store && accessed) {
+      for (unsigned b = 0; b < access.bytes; ++b)
+        schedule.memory[access.address + b] = completed;
+    }
+    schedule.criticalPath = std::max(schedule.criticalPath, completed);
+    schedule.lastRetired = std::max(schedule.lastRetired, completed);
+    if (schedule.size != 0) {
+      schedule.retired[schedule.head] = schedule.lastRetired;
+      schedule.head = (schedule.head + 1) % schedule.size;
+    }
+  }
+  if (memoryDep)
+    m_memoryDeps++;
+}
+
+} // namespace Ripes
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+
+#include <array>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+#include "processorobserver.h"
+#include "textdecoder.h"
+
+namespace Ripes {
+
+/**
+ * @brief The IlpProfiler class
+ * A limit study of the instruction-level parallelism of the program executed
+ * by the current processor. The instructions retired by the processor are
+ * scheduled on an idealized machine, which executes each instruction in a
+ * single cycle once its operands are available: registers are perfectly
+ * renamed and branches perfectly predicted, such that only the true (read
+ * after write) dependencies through registers and memory constrain the
+ * schedule. The ILP is the number of instructions over the length of the
+ * critical path of the schedule.
+ *
+ * The machine is limited to a window of the N oldest instructions which have
+ * not yet retired, retiring in order; the schedule is computed for each of a
+ * set of window sizes, and for an unbounded window. System, CSR and vector
+ * instructions are serializing. Memory dependencies are tracked per byte, with
+ * data accesses attributed to instructions by their PC (see
+ * RipesProcessor::dataMemAccessPC). The profile is cleared when the processor
+ * is reset.
+ */
+class IlpProfiler : public QObject, public ProcessorObserver {
+public:
+  struct Window {
+    // Size of the window, or 0 if unbounded.
+    unsigned size = 0;
+    // Cycles of the critical path of the schedule.
+    long long criticalPath = 0;
+  };
+
+  /// Profiles the current processor until destroyed, for each window size of
+  /// @p windowSizes and an unbounded window.
+  explicit IlpProfiler(const std::vector<unsigned> &windowSizes);
+  ~IlpProfiler() override;
+
+  /// Parses a comma-separated list of window sizes. Returns an error message
+  /// on failure, or an empty string on success.
+  static QString parseWindowSizes(const QString &spec,
+                                  std::vector<unsigned> &sizes);
+
+  unsigned long long instructions() const { return m_instructions; }
+  unsigned long long cycles() const { return m_cycles; }
+  /// Loads reading a value stored by an earlier instruction of the trace.
+  unsigned long long memoryDependencies() const { return m_memoryDeps; }
+  /// Schedules of each window size, in the order given upon construction,
+  /// followed by that of the unbounded window.
+  std::vector<Window> windows() const;
+
+  unsigned events() const override { return Cycle; }
+  void onCycle(const RipesProcessor &proc) override;
+
+private:
+  // Registers are indexed in a single space: the integer registers, followed
+  // by the floating-point registers.
+  static constexpr unsigned s_registers = 64;
+
+  struct PendingAccess {
+    AInt pc;
+    MemoryAccess access;
+  };
+
+  // The schedule of a window.
+  struct Schedule {
+    unsigned size = 0;
+    // Cycle in which the value of each register, and of each byte of memory,
+    // is available.
+    std::array<long long, s_registers> registers{};
+    std::unordered_map<AInt, long long> memory;
+    // Retirement cycles of the instructions in the window, as a ring buffer.
+    std::vector<long long> retired;
+    size_t head = 0;
+    long long lastRetired = 0;
+    // Cycle before which no instruction may execute, following a serializing
+    // instruction.
+    long long barrier = 0;
+    long long criticalPath = 0;
+  };
+
+  void reset();
+  void sample(const RipesProcessor &proc);
+  void retire(AInt pc);
+
+  DecodedText m_text;
+  std::vector<unsigned> m_windowSizes;
+  std::vector<Schedule> m_schedules;
+  unsigned long long m_instructions = 0;
+  unsigned long long m_cycles = 0;
+  unsigned long long m_memoryDeps = 0;
+
+  std::vector<StageIndex> m_finalStages;
+  // The PCs of the instructions in the final stages after the previous cycle;
+  // these are the instructions retired by the following cycle.
+  std::vector<AInt> m_committing;
+  // Data accesses of instructions which have not yet retired.
+  std::deque<PendingAccess> m_accesses;
+  long long m_lastRetired = 0;
+};
+
+} // namespace Ripes
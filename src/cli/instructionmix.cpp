@@ -0,0 +1,243 @@
+#include "instructionmix.h"
+
+#include "processorhandler.h"
+
+namespace Ripes {
+
+namespace {
+// Names of the RVInstr opcodes, in declaration order.
+constexpr std::array<const char *, InstructionMix::NOpcodes> c_opcodeNames = {
+    "nop",
+    /* RV32I Base Instruction Set */
+    "lui", "auipc", "jal", "jalr", "beq", "bne", "blt", "bge", "bltu", "bgeu",
+    "lb", "lh", "lw", "lbu", "lhu", "sb", "sh", "sw", "addi", "slti", "sltiu",
+    "xori", "ori", "andi", "slli", "srli", "srai", "add", "sub", "sll", "slt",
+    "sltu", "xor", "srl", "sra", "or", "and", "ecall",
+    /* RV32M Standard Extension */
+    "mul", "mulh", "mulhsu", "mulhu", "div", "divu", "rem", "remu",
+    /* RV64I Base Instruction Set */
+    "addiw", "slliw", "srliw", "sraiw", "addw", "subw", "sllw", "srlw", "sraw",
+    "lwu", "ld", "sd",
+    /* RV64M Standard Extension */
+    "mulw", "divw", "divuw", "remw", "remuw",
+    /* Zicsr Standard Extension */
+    "csrrs", "csrrw", "csrrc", "csrrwi", "csrrsi", "csrrci",
+    /* Machine-mode privileged instructions */
+    "mret", "wfi",
+    /* RV32A Standard Extension */
+    "lr.w", "sc.w", "amoswap.w", "amoadd.w", "amoxor.w", "amoand.w", "amoor.w",
+    "amomin.w", "amomax.w", "amominu.w", "amomaxu.w",
+    /* RV64A Standard Extension */
+    "lr.d", "sc.d", "amoswap.d", "amoadd.d", "amoxor.d", "amoand.d", "amoor.d",
+    "amomin.d", "amomax.d", "amominu.d", "amomaxu.d",
+    /* RV32F and RV64F Standard Extensions */
+    "flw", "fsw", "fmadd.s", "fmsub.s", "fnmsub.s", "fnmadd.s", "fadd.s",
+    "fsub.s", "fmul.s", "fdiv.s", "fsqrt.s", "fsgnj.s", "fsgnjn.s", "fsgnjx.s",
+    "fmin.s", "fmax.s", "feq.s", "flt.s", "fle.s", "fclass.s", "fcvt.w.s",
+    "fcvt.wu.s", "fcvt.l.s", "fcvt.lu.s", "fcvt.s.w", "fcvt.s.wu", "fcvt.s.l",
+    "fcvt.s.lu", "fmv.x.w", "fmv.w.x",
+    /* RV32D and RV64D Standard Extensions */
+    "fld", "fsd", "fmadd.d", "fmsub.d", "fnmsub.d", "fnmadd.d", "fadd.d",
+    "fsub.d", "fmul.d", "fdiv.d", "fsqrt.d", "fsgnj.d", "fsgnjn.d", "fsgnjx.d",
+    "fmin.d", "fmax.d", "feq.d", "flt.d", "fle.d", "fclass.d", "fcvt.w.d",
+    "fcvt.wu.d", "fcvt.l.d", "fcvt.lu.d", "fcvt.d.w", "fcvt.d.wu", "fcvt.d.l",
+    "fcvt.d.lu", "fmv.x.d", "fmv.d.x", "fcvt.s.d", "fcvt.d.s",
+    /* V Standard Extension (subset) */
+    "vsetvli", "vsetivli", "vsetvl", "vle8.v", "vle16.v", "vle32.v", "vle64.v",
+    "vse8.v", "vse16.v", "vse32.v", "vse64.v", "vadd.vv", "vadd.vx", "vadd.vi",
+    "vsub.vv", "vsub.vx", "vrsub.vx", "vrsub.vi", "vminu.vv", "vminu.vx",
+    "vmin.vv", "vmin.vx", "vmaxu.vv", "vmaxu.vx", "vmax.vv", "vmax.vx",
+    "vand.vv", "vand.vx", "vand.vi", "vor.vv", "vor.vx", "vor.vi", "vxor.vv",
+    "vxor.vx", "vxor.vi", "vsll.vv", "vsll.vx", "vsll.vi", "vsrl.vv",
+    "vsrl.vx", "vsrl.vi", "vsra.vv", "vsra.vx", "vsra.vi", "vmul.vv",
+    "vmul.vx", "vmv.v.v", "vmv.v.x", "vmv.v.i", "vredsum.vs", "vredand.vs",
+    "vredor.vs", "vredxor.vs", "vredminu.vs", "vredmin.vs", "vredmaxu.vs",
+    "vredmax.vs", "vmv.x.s", "vmv.s.x"};
+} // namespace
+
+InstructionMix::InstructionMix() {
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorClocked, this,
+          [this] { processorClocked(); }, Qt::DirectConnection);
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          [this] { reset(); });
+  reset();
+}
+
+void InstructionMix::reset() {
+  m_text = DecodedText::decode();
+  m_opcodes.fill(0);
+  m_classes.fill(0);
+  m_compressed = 0;
+  m_uncompressed = 0;
+  m_total = 0;
+
+  const auto *proc = ProcessorHandler::getProcessor();
+  m_finalStages.clear();
+  for (const auto &lane : proc->structure())
+    m_finalStages.push_back({lane.first, lane.second - 1});
+  m_lastRetired = proc->getInstructionsRetired();
+}
+
+void InstructionMix::processorClocked() {
+  const auto *proc = ProcessorHandler::getProcessor();
+  const unsigned long long retired = proc->getInstructionsRetired();
+  unsigned long long newlyRetired = retired - m_lastRetired;
+  m_lastRetired = retired;
+  if (newlyRetired == 0)
+    return;
+  m_total += newlyRetired;
+
+  for (const auto &stage : m_finalStages) {
+    if (newlyRetired == 0)
+      break;
+    const StageInfo info = proc->stageInfo(stage);
+    if (!info.stage_valid || info.state != StageInfo::State::None)
+      continue;
+    newlyRetired--;
+    const long idx = m_text.index(info.pc);
+    if (idx < 0) {
+      m_classes[static_cast<unsigned>(Class::Unknown)]++;
+      continue;
+    }
+    const DecodedText::Instr &decoded = m_text.instrs[idx];
+    m_opcodes[decoded.opcode]++;
+    m_classes[static_cast<unsigned>(classify(decoded.opcode))]++;
+    if (decoded.compressed)
+      m_compressed++;
+    else
+      m_uncompressed++;
+  }
+  // Retirements which could not be located in a final stage are unknown.
+  m_classes[static_cast<unsigned>(Class::Unknown)] += newlyRetired;
+}
+
+InstructionMix::Class InstructionMix::classify(unsigned opcode) {
+  switch (opcode) {
+  case RVInstr::LB:
+  case RVInstr::LH:
+  case RVInstr::LW:
+  case RVInstr::LBU:
+  case RVInstr::LHU:
+  case RVInstr::LWU:
+  case RVInstr::LD:
+  case RVInstr::FLW:
+  case RVInstr::FLD:
+  case RVInstr::VLE8_V:
+  case RVInstr::VLE16_V:
+  case RVInstr::VLE32_V:
+  case RVInstr::VLE64_V:
+    return Class::Load;
+  case RVInstr::SB:
+  case RVInstr::SH:
+  case RVInstr::SW:
+  case RVInstr::SD:
+  case RVInstr::FSW:
+  case RVInstr::FSD:
+  case RVInstr::VSE8_V:
+  case RVInstr::VSE16_V:
+  case RVInstr::VSE32_V:
+  case RVInstr::VSE64_V:
+    return Class::Store;
+  case RVInstr::BEQ:
+  case RVInstr::BNE:
+  case RVInstr::BLT:
+  case RVInstr::BGE:
+  case RVInstr::BLTU:
+  case RVInstr::BGEU:
+    return Class::Branch;
+  case RVInstr::JAL:
+  case RVInstr::JALR:
+    return Class::Jump;
+  case RVInstr::MUL:
+  case RVInstr::MULH:
+  case RVInstr::MULHSU:
+  case RVInstr::MULHU:
+  case RVInstr::DIV:
+  case RVInstr::DIVU:
+  case RVInstr::REM:
+  case RVInstr::REMU:
+  case RVInstr::MULW:
+  case RVInstr::DIVW:
+  case RVInstr::DIVUW:
+  case RVInstr::REMW:
+  case RVInstr::REMUW:
+    return Class::MExt;
+  case RVInstr::ECALL:
+  case RVInstr::CSRRS:
+  case RVInstr::CSRRW:
+  case RVInstr::CSRRC:
+  case RVInstr::CSRRWI:
+  case RVInstr::CSRRSI:
+  case RVInstr::CSRRCI:
+  case RVInstr::MRET:
+  case RVInstr::WFI:
+    return Class::System;
+  case RVInstr::NOP:
+    return Class::Unknown;
+  case RVInstr::LR_W:
+  case RVInstr::SC_W:
+  case RVInstr::AMOSWAP_W:
+  case RVInstr::AMOADD_W:
+  case RVInstr::AMOXOR_W:
+  case RVInstr::AMOAND_W:
+  case RVInstr::AMOOR_W:
+  case RVInstr::AMOMIN_W:
+  case RVInstr::AMOMAX_W:
+  case RVInstr::AMOMINU_W:
+  case RVInstr::AMOMAXU_W:
+  case RVInstr::LR_D:
+  case RVInstr::SC_D:
+  case RVInstr::AMOSWAP_D:
+  case RVInstr::AMOADD_D:
+  case RVInstr::AMOXOR_D:
+  case RVInstr::AMOAND_D:
+  case RVInstr::AMOOR_D:
+  case RVInstr::AMOMIN_D:
+  case RVInstr::AMOMAX_D:
+  case RVInstr::AMOMINU_D:
+  case RVInstr::AMOMAXU_D:
+    return Class::Atomic;
+  default:
+    // The F and D extensions, other than loads and stores.
+    if (opcode >= RVInstr::FLW && opcode <= RVInstr::FCVT_D_S)
+      return Class::FP;
+    // The V extension, other than loads and stores.
+    if (opcode >= RVInstr::VSETVLI && opcode <= RVInstr::VMV_S_X)
+      return Class::Vector;
+    return Class::ALU;
+  }
+}
+
+QString InstructionMix::className(Class cls) {
+  switch (cls) {
+  case Class::ALU:
+    return "ALU";
+  case Class::Load:
+    return "load";
+  case Class::Store:
+    return "store";
+  case Class::Branch:
+    return "branch";
+  case Class::Jump:
+    return "jump";
+  case Class::MExt:
+    return "M-extension";
+  case Class::Atomic:
+    return "atomic";
+  case Class::FP:
+    return "floating-point";
+  case Class::Vector:
+    return "vector";
+  case Class::System:
+    return "system";
+  case Class::Unknown:
+    return "unknown";
+  }
+  Q_UNREACHABLE();
+}
+
+QString InstructionMix::opcodeName(unsigned opcode) {
+  return c_opcodeNames.at(opcode);
+}
+
+} // namespace Ripes
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+
+#include <array>
+#include <vector>
+
+#include "textdecoder.h"
+
+namespace Ripes {
+
+/**
+ * @brief The InstructionMix class
+ * Histograms the instructions retired during simulation by RVInstr opcode, by
+ * instruction class and by encoding (compressed or uncompressed).
+ *
+ * The text section of the current program is decoded when the processor is
+ * reset (see DecodedText), into a flat array of instructions, such that
+ * profiling a retired instruction is an array lookup and an increment.
+ * Instructions retiring outside of the text section, and words which do not
+ * decode, are of the Unknown class; the former are not counted by opcode nor
+ * by encoding.
+ */
+class InstructionMix : public QObject {
+public:
+  enum class Class {
+    ALU,
+    Load,
+    Store,
+    Branch,
+    Jump,
+    MExt,
+    Atomic,
+    FP,
+    Vector,
+    System,
+    Unknown
+  };
+  static constexpr unsigned NClasses =
+      static_cast<unsigned>(Class::Unknown) + 1;
+  static constexpr unsigned NOpcodes = RVInstr::VMV_S_X + 1;
+
+  InstructionMix();
+
+  /// Returns the number of retired instructions decoding to @p opcode. Words
+  /// which do not decode count as RVInstr::NOP.
+  unsigned long long opcodeCount(unsigned opcode) const {
+    return m_opcodes.at(opcode);
+  }
+  unsigned long long classCount(Class cls) const {
+    return m_classes.at(static_cast<unsigned>(cls));
+  }
+  unsigned long long compressed() const { return m_compressed; }
+  unsigned long long uncompressed() const { return m_uncompressed; }
+  unsigned long long total() const { return m_total; }
+
+  static Class classify(unsigned opcode);
+  static QString className(Class cls);
+  static QString opcodeName(unsigned opcode);
+
+private:
+  void reset();
+  void processorClocked();
+
+  DecodedText m_text;
+
+  std::array<unsigned long long, NOpcodes> m_opcodes{};
+  std::array<unsigned long long, NClasses> m_classes{};
+  unsigned long long m_compressed = 0;
+  unsigned long long m_uncompressed = 0;
+  unsigned long long m_total = 0;
+
+  // The final stage of each lane, which instructions retire from.
+  std::vector<StageIndex> m_finalStages;
+  unsigned long long m_lastRetired = 0;
+};
+
+} // namespace Ripes
@@ -0,0 +1,71 @@
+#include "memorydump.h"
+
+#include "processorhandler.h"
+#include "processors/pagedaddressspace.h"
+
+#include <QFile>
+
+#include <algorithm>
+
+namespace Ripes {
+
+// Memory is read and formatted in chunks of this many bytes, bounding the
+// buffers of large dumps.
+static constexpr AInt s_chunkBytes = AInt(1) << 16;
+// Bytes of memory per line of formatted dumps.
+static constexpr AInt s_lineBytes = 16;
+
+/// Reads the @p bytes bytes at @p address into @p data, without accounting
+/// them to any system call.
+static void readMemory(AInt address, uint8_t *data, AInt bytes) {
+  auto &memory = ProcessorHandler::getMemory();
+  if (auto *paged = dynamic_cast<PagedAddressSpaceMM *>(&memory)) {
+    paged->readBlock(address, data, bytes);
+    return;
+  }
+  for (AInt i = 0; i < bytes; ++i)
+    data[i] = static_cast<uint8_t>(memory.readMemConst(address + i, 1));
+}
+
+QString writeMemoryDump(const QString &filepath,
+                        const MemoryDumpConfig &config) {
+  QFile file(filepath);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    return "Error: Could not open memory dump file " + filepath;
+
+  const unsigned addressBytes = ProcessorHandler::currentISA()->bytes();
+  std::vector<uint8_t> data(s_chunkBytes);
+  QByteArray text;
+  for (const auto &range : config.ranges) {
+    for (AInt offset = 0; offset < range.bytes; offset += s_chunkBytes) {
+      const AInt address = range.start + offset;
+      const AInt bytes = std::min(s_chunkBytes, range.bytes - offset);
+      readMemory(address, data.data(), bytes);
+      if (config.raw) {
+        if (file.write(reinterpret_cast<const char *>(data.data()), bytes) !=
+            static_cast<qint64>(bytes))
+          return "Error: Could not write memory dump file " + filepath;
+        continue;
+      }
+
+      text.clear();
+      for (AInt line = 0; line < bytes; line += s_lineBytes) {
+        char prefix[s_maxRadixChars + 2];
+        char *end =
+            formatRadixValue(prefix, address + line, Radix::Hex, addressBytes);
+        *end++ = ':';
+        *end++ = ' ';
+        text.append(prefix, end - prefix);
+        formatRadixValues(text, data.data() + line,
+                          std::min(s_lineBytes, bytes - line), config.radix,
+                          config.width);
+        text.append('\n');
+      }
+      if (file.write(text) != text.size())
+        return "Error: Could not write memory dump file " + filepath;
+    }
+  }
+  return QString();
+}
+
+} // namespace Ripes
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QString>
+
+#include <vector>
+
+#include "radix.h"
+
+namespace Ripes {
+
+/**
+ * Memory dumps write the contents of ranges of the memory of the processor
+ * model to a file once simulation ends, ie. for comparison against golden
+ * files. Dumps are either raw, holding the bytes of each range back to back,
+ * or formatted, holding a line per 16 bytes of memory:
+ *
+ *   <address>: <value> <value> ...
+ *
+ * where values are little endian values of the configured width, in the
+ * configured radix (see formatRadixValue).
+ */
+struct MemoryDumpConfig {
+  struct Range {
+    AInt start = 0;
+    AInt bytes = 0;
+  };
+
+  std::vector<Range> ranges;
+  bool raw = false;
+  Radix radix = Radix::Hex;
+  // Width in bytes of formatted values; 1, 2, 4 or 8.
+  unsigned width = 4;
+};
+
+/// Writes the dump of @p config of the memory of the current processor to
+/// @p filepath. Returns an error message on failure, or an empty string on
+/// success.
+QString writeMemoryDump(const QString &filepath,
+                        const MemoryDumpConfig &config);
+
+} // namespace Ripes
@@ -0,0 +1,141 @@
+#include "memorytrace.h"
+
+#include "processorhandler.h"
+
+#include <QDataStream>
+
+#include <algorithm>
+
+namespace Ripes {
+
+static constexpr quint32 s_traceMagic = 0x524d5452; // "RMTR"
+static constexpr quint32 s_traceVersion = 1;
+static constexpr quint32 s_compressedFlag = 1 << 0;
+
+// Record flags byte layout.
+static constexpr uint8_t s_dataBit = 1 << 0;
+static constexpr uint8_t s_writeBit = 1 << 1;
+static constexpr unsigned s_sizeShift = 2;
+static constexpr uint8_t s_sizeMask = 0xf;
+static constexpr uint8_t s_resetRecord = 0xff;
+
+// Buffered records are written to the file (or compressed as a block) in
+// chunks of this size.
+static constexpr size_t s_flushBytes = 1 << 16;
+
+static uint64_t zigzagEncode(int64_t v) {
+  return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+MemoryTraceWriter::~MemoryTraceWriter() { close(); }
+
+QString MemoryTraceWriter::open(const QString &path, bool compress) {
+  close();
+  m_file.setFileName(path);
+  if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    return "Error: Could not open memory trace file " + path;
+
+  m_compress = compress;
+  m_buffer.clear();
+  m_buffer.reserve(s_flushBytes + 64);
+  m_accesses = 0;
+  m_writeFailed = false;
+  m_lastCycle = 0;
+  m_lastAddress[0] = m_lastAddress[1] = 0;
+  m_lastDataPC = 0;
+
+  QDataStream stream(&m_file);
+  stream << s_traceMagic << s_traceVersion
+         << (compress ? s_compressedFlag : quint32(0));
+  m_bytes = m_file.pos();
+
+  ProcessorHandler::attachObserver(this);
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          [this] { processorReset(); });
+  return QString();
+}
+
+QString MemoryTraceWriter::close() {
+  if (!m_file.isOpen())
+    return QString();
+
+  ProcessorHandler::detachObserver(this);
+  disconnect(ProcessorHandler::get(), nullptr, this, nullptr);
+  flush(true);
+  m_file.close();
+  if (m_writeFailed)
+    return "Error: Could not write memory trace file " + m_file.fileName();
+  return QString();
+}
+
+void MemoryTraceWriter::processorReset() {
+  if (m_accesses > 0)
+    m_buffer.push_back(s_resetRecord);
+  m_lastCycle = 0;
+  m_lastAddress[0] = m_lastAddress[1] = 0;
+  m_lastDataPC = 0;
+}
+
+void MemoryTraceWriter::onMemAccess(const RipesProcessor &proc,
+                                    const MemoryAccess &access, bool data) {
+  writeAccess(data, access, data ? proc.dataMemAccessPC() : access.address);
+  flush();
+}
+
+void MemoryTraceWriter::writeAccess(bool data, const MemoryAccess &access,
+                                    AInt pc) {
+  const long long cycle = ProcessorHandler::getProcessor()->getCycleCount();
+  if (cycle < m_lastCycle) {
+    // Cycles are only ever deltas relative to a preceding access record.
+    processorReset();
+  }
+
+  uint8_t flags = data ? s_dataBit : 0;
+  if (access.type == MemoryAccess::Write)
+    flags |= s_writeBit;
+  flags |= (std::min<unsigned>(access.bytes, s_sizeMask) & s_sizeMask)
+           << s_sizeShift;
+  m_buffer.push_back(flags);
+  writeVarint(cycle - m_lastCycle);
+  m_lastCycle = cycle;
+
+  AInt &lastAddress = m_lastAddress[data ? 1 : 0];
+  writeVarint(zigzagEncode(static_cast<int64_t>(access.address - lastAddress)));
+  lastAddress = access.address;
+  if (data) {
+    writeVarint(zigzagEncode(static_cast<int64_t>(pc - m_lastDataPC)));
+    m_lastDataPC = pc;
+  }
+  m_accesses++;
+}
+
+void MemoryTraceWriter::writeVarint(uint64_t value) {
+  while (value >= 0x80) {
+    m_buffer.push_back(static_cast<uint8_t>(value) | 0x80);
+    value >>= 7;
+  }
+  m_buffer.push_back(static_cast<uint8_t>(value));
+}
+
+void MemoryTraceWriter::flush(bool force) {
+  if (m_buffer.empty() || (!force && m_buffer.size() < s_flushBytes))
+    return;
+
+  const qint64 before = m_file.pos();
+  if (m_compress) {
+    QDataStream stream(&m_file);
+    stream << qCompress(reinterpret_cast<const uchar *>(m_buffer.data()),
+                        static_cast<int>(m_buffer.size()));
+    if (stream.status() != QDataStream::Ok)
+      m_writeFailed = true;
+  } else {
+    const qint64 size = static_cast<qint64>(m_buffer.size());
+    if (m_file.write(reinterpret_cast<const char *>(m_buffer.data()), size) !=
+        size)
+      m_writeFailed = true;
+  }
+  m_bytes += m_file.pos() - before;
+  m_buffer.clear();
+}
+
+} // namespace Ripes
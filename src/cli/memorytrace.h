@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QFile>
+#include <QObject>
+#include <QString>
+
+#include <vector>
+
+#include "processorobserver.h"
+
+namespace Ripes {
+
+/**
+ * @brief The MemoryTraceWriter class
+ * Streams the instruction and data memory accesses of the current processor
+ * to a file during simulation, as reported by RipesProcessor::instrMemAccess()
+ * and RipesProcessor::dataMemAccess(). Records are buffered in fixed-size
+ * blocks, such that the trace is never held in memory.
+ *
+ * The file holds a magic number ("RMTR"), the format version and a flags word
+ * (bit 0: compressed), as serialized by QDataStream, followed by a sequence of
+ * records. An access record is a flags byte (bit 0: data access, bit 1: write,
+ * bits 2-5: access size in bytes), the LEB128 encoded cycle delta to the
+ * previous access record, and the zigzag encoded delta to the previous address
+ * of the same stream. Data access records are followed by the zigzag encoded
+ * delta to the PC of the previous data access; the PC of an instruction access
+ * is its address. A reset record is the byte 0xff, after which cycles,
+ * addresses and PCs are relative to zero again.
+ *
+ * If compressed, the records are instead split into blocks, each serialized as
+ * a QByteArray holding the qCompress()'ed (zlib) block.
+ *
+ * Accesses are observed through ProcessorHandler::attachObserver.
+ */
+class MemoryTraceWriter : public QObject, public ProcessorObserver {
+public:
+  ~MemoryTraceWriter() override;
+
+  /// Opens the file at @p path and starts tracing the current processor.
+  /// Returns an error message on failure, or an empty string on success.
+  QString open(const QString &path, bool compress);
+  /// Stops tracing and closes the file. Returns an error message if writing
+  /// the trace failed, or an empty string on success.
+  QString close();
+
+  unsigned long long accesses() const { return m_accesses; }
+  unsigned long long bytes() const { return m_bytes; }
+
+  unsigned events() const override { return MemAccess; }
+  void onMemAccess(const RipesProcessor &proc, const MemoryAccess &access,
+                   bool data) override;
+
+private:
+  void processorReset();
+  void writeAccess(bool data, const MemoryAccess &access, AInt pc);
+  void writeVarint(uint64_t value);
+  void flush(bool force = false);
+
+  QFile m_file;
+  bool m_compress = false;
+  std::vector<uint8_t> m_buffer;
+  unsigned long long m_accesses = 0;
+  unsigned long long m_bytes = 0;
+  bool m_writeFailed = false;
+
+  long long m_lastCycle = 0;
+  AInt m_lastAddress[2] = {0, 0};
+  AInt m_lastDataPC = 0;
+};
+
+} // namespace Ripes
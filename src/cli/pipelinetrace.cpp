@@ -0,0 +1,298 @@
+#include "pipelinetrace.h"
+
+#include "processorhandler.h"
+
+#include <QDataStream>
+
+#include <algorithm>
+#include <numeric>
+
+namespace Ripes {
+
+static constexpr quint32 s_traceMagic = 0x52505452; // "RPTR"
+static constexpr quint32 s_traceVersion = 1;
+
+// Binary record types.
+static constexpr uint8_t s_cycleRecord = 0;
+static constexpr uint8_t s_resetRecord = 1;
+
+// Stage entry flags byte layout.
+static constexpr uint8_t s_validBit = 1 << 0;
+static constexpr unsigned s_stateShift = 1;
+static constexpr uint8_t s_pcBit = 1 << 4;
+static constexpr uint8_t s_namedStateBit = 1 << 5;
+
+// Buffered output is written to the file in chunks of this size.
+static constexpr size_t s_flushBytes = 1 << 16;
+
+static uint64_t zigzagEncode(int64_t v) {
+  return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+PipelineTraceWriter::~PipelineTraceWriter() { close(); }
+
+QString PipelineTraceWriter::open(const QString &path, Format format) {
+  close();
+  m_file.setFileName(path);
+  if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    return "Error: Could not open pipeline trace file " + path;
+
+  m_format = format;
+  m_buffer.clear();
+  m_cycles = 0;
+  m_writeFailed = false;
+  m_lastCycle = 0;
+  m_namedStateIds.clear();
+  m_numNamedStates = 0;
+  m_nextId = 0;
+  m_nextRetireId = 0;
+  m_startedKanata = false;
+  m_disassembly.clear();
+
+  const auto *proc = ProcessorHandler::getProcessor();
+  const auto &structure = proc->structure();
+  m_stages.clear();
+  m_stageNames.clear();
+  for (auto idx : structure.stageIt()) {
+    m_stages.push_back(idx);
+    m_stageNames.push_back(proc->stageName(idx));
+  }
+
+  const unsigned n = m_stages.size();
+  m_infos.assign(n, StageInfo());
+  m_lastPcs.assign(n, 0);
+  m_occupants.assign(n, -1);
+  m_occupantPcs.assign(n, 0);
+  m_upstream.assign(n, {});
+  m_finalStage.assign(n, false);
+  for (unsigned pos = 0; pos < n; ++pos) {
+    const StageIndex &idx = m_stages[pos];
+    m_finalStage[pos] = idx.index() + 1 == structure.at(idx.lane());
+    if (idx.index() == 0)
+      continue;
+    // Stages are ordered by lane, such that the preceding stage of the same
+    // lane is found directly before this stage.
+    m_upstream[pos].push_back(pos - 1);
+    for (unsigned other = 0; other < n; ++other) {
+      if (m_stages[other].lane() != idx.lane() &&
+          m_stages[other].index() + 1 == idx.index())
+        m_upstream[pos].push_back(other);
+    }
+  }
+  m_matchOrder.resize(n);
+  std::iota(m_matchOrder.begin(), m_matchOrder.end(), 0);
+  std::stable_sort(m_matchOrder.begin(), m_matchOrder.end(),
+                   [&](unsigned lhs, unsigned rhs) {
+                     return m_stages[lhs].index() > m_stages[rhs].index();
+                   });
+
+  if (m_format == Format::Binary) {
+    QDataStream stream(&m_file);
+    stream << s_traceMagic << s_traceVersion << static_cast<quint32>(n);
+    for (unsigned pos = 0; pos < n; ++pos)
+      stream << static_cast<quint32>(m_stages[pos].lane())
+             << static_cast<quint32>(m_stages[pos].index())
+             << m_stageNames[pos];
+  } else {
+    writeText("Kanata\t0004\n");
+  }
+  m_bytes = m_file.pos();
+
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorClocked, this,
+          [this] { recordCycle(); }, Qt::DirectConnection);
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          [this] { processorReset(); });
+  return QString();
+}
+
+QString PipelineTraceWriter::close() {
+  if (!m_file.isOpen())
+    return QString();
+
+  disconnect(ProcessorHandler::get(), nullptr, this, nullptr);
+  if (m_format == Format::Kanata) {
+    // Instructions still in flight never complete.
+    for (unsigned pos = 0; pos < m_occupants.size(); ++pos) {
+      if (m_occupants[pos] >= 0)
+        retireKanata(pos, true);
+    }
+  }
+  flush(true);
+  m_file.close();
+  if (m_writeFailed)
+    return "Error: Could not write pipeline trace file " + m_file.fileName();
+  return QString();
+}
+
+void PipelineTraceWriter::processorReset() {
+  if (m_format == Format::Binary) {
+    if (m_cycles > 0)
+      m_buffer.push_back(s_resetRecord);
+    m_lastCycle = 0;
+    std::fill(m_lastPcs.begin(), m_lastPcs.end(), 0);
+  } else {
+    for (unsigned pos = 0; pos < m_occupants.size(); ++pos) {
+      if (m_occupants[pos] >= 0)
+        retireKanata(pos, true);
+    }
+    std::fill(m_occupants.begin(), m_occupants.end(), -1);
+  }
+  recordCycle();
+}
+
+void PipelineTraceWriter::recordCycle() {
+  const auto *proc = ProcessorHandler::getProcessor();
+  proc->stageInfos(m_infos.data());
+
+  if (m_format == Format::Binary)
+    writeBinaryCycle(proc->getCycleCount());
+  else
+    writeKanataCycle();
+  m_cycles++;
+  flush();
+}
+
+void PipelineTraceWriter::writeBinaryCycle(long long cycle) {
+  if (cycle < m_lastCycle) {
+    // Cycles are only ever deltas relative to a preceding cycle record.
+    m_buffer.push_back(s_resetRecord);
+    m_lastCycle = 0;
+    std::fill(m_lastPcs.begin(), m_lastPcs.end(), 0);
+  }
+  m_buffer.push_back(s_cycleRecord);
+  writeVarint(cycle - m_lastCycle);
+  m_lastCycle = cycle;
+
+  for (unsigned pos = 0; pos < m_stages.size(); ++pos) {
+    const StageInfo &info = m_infos[pos];
+    uint8_t flags = info.stage_valid ? s_validBit : 0;
+    flags |= static_cast<uint8_t>(info.state) << s_stateShift;
+    if (info.pc != m_lastPcs[pos])
+      flags |= s_pcBit;
+    if (info.namedState != NamedStates::None)
+      flags |= s_namedStateBit;
+    m_buffer.push_back(flags);
+
+    if (flags & s_pcBit) {
+      writeVarint(
+          zigzagEncode(static_cast<int64_t>(info.pc - m_lastPcs[pos])));
+      m_lastPcs[pos] = info.pc;
+    }
+    if (flags & s_namedStateBit) {
+      if (info.namedState >= m_namedStateIds.size())
+        m_namedStateIds.resize(info.namedState + 1, -1);
+      int &id = m_namedStateIds[info.namedState];
+      const bool defined = id >= 0;
+      if (!defined)
+        id = m_numNamedStates++;
+      writeVarint(id);
+      if (!defined) {
+        // First use of this named state; define it.
+        const QByteArray name = NamedStates::name(info.namedState).toUtf8();
+        writeVarint(name.size());
+        m_buffer.insert(m_buffer.end(), name.begin(), name.end());
+      }
+    }
+  }
+}
+
+void PipelineTraceWriter::writeKanataCycle() {
+  if (!m_startedKanata) {
+    writeText("C=\t0\n");
+    m_startedKanata = true;
+  } else {
+    writeText("C\t1\n");
+  }
+
+  const unsigned n = m_stages.size();
+  m_nextOccupants.assign(n, -1);
+  m_claimed.assign(n, false);
+  for (unsigned pos : m_matchOrder) {
+    const StageInfo &info = m_infos[pos];
+    if (!occupied(info))
+      continue;
+
+    // An instruction either advanced from a preceding stage, or remained in
+    // this stage.
+    int from = -1;
+    for (unsigned up : m_upstream[pos]) {
+      if (!m_claimed[up] && m_occupants[up] >= 0 &&
+          m_occupantPcs[up] == info.pc) {
+        from = up;
+        break;
+      }
+    }
+    if (from < 0 && !m_claimed[pos] && m_occupants[pos] >= 0 &&
+        m_occupantPcs[pos] == info.pc)
+      from = pos;
+
+    long long id;
+    if (from >= 0) {
+      m_claimed[from] = true;
+      id = m_occupants[from];
+      if (from != static_cast<int>(pos)) {
+        writeText("E\t" + QString::number(id) + "\t0\t" + m_stageNames[from] +
+                  "\n");
+        writeText("S\t" + QString::number(id) + "\t0\t" + m_stageNames[pos] +
+                  "\n");
+      }
+    } else {
+      id = m_nextId++;
+      auto it = m_disassembly.find(info.pc);
+      if (it == m_disassembly.end())
+        it = m_disassembly
+                 .emplace(info.pc, ProcessorHandler::disassembleInstr(info.pc))
+                 .first;
+      const QString idStr = QString::number(id);
+      writeText("I\t" + idStr + "\t" + idStr + "\t0\n");
+      writeText("L\t" + idStr + "\t0\t0x" + QString::number(info.pc, 16) +
+                ": " + it->second + "\n");
+      writeText("S\t" + idStr + "\t0\t" + m_stageNames[pos] + "\n");
+    }
+    m_nextOccupants[pos] = id;
+  }
+
+  // Instructions which did not advance have left the pipeline.
+  for (unsigned pos = 0; pos < n; ++pos) {
+    if (m_occupants[pos] >= 0 && !m_claimed[pos])
+      retireKanata(pos, !m_finalStage[pos]);
+  }
+  m_occupants.swap(m_nextOccupants);
+  for (unsigned pos = 0; pos < n; ++pos)
+    m_occupantPcs[pos] = m_infos[pos].pc;
+}
+
+void PipelineTraceWriter::retireKanata(unsigned pos, bool flushed) {
+  const QString idStr = QString::number(m_occupants[pos]);
+  writeText("E\t" + idStr + "\t0\t" + m_stageNames[pos] + "\n");
+  const long long retireId = flushed ? 0 : m_nextRetireId++;
+  writeText("R\t" + idStr + "\t" + QString::number(retireId) + "\t" +
+            (flushed ? "1" : "0") + "\n");
+  m_occupants[pos] = -1;
+}
+
+void PipelineTraceWriter::writeVarint(uint64_t value) {
+  while (value >= 0x80) {
+    m_buffer.push_back(static_cast<uint8_t>(value) | 0x80);
+    value >>= 7;
+  }
+  m_buffer.push_back(static_cast<uint8_t>(value));
+}
+
+void PipelineTraceWriter::writeText(const QString &text) {
+  const QByteArray bytes = text.toUtf8();
+  m_buffer.insert(m_buffer.end(), bytes.begin(), bytes.end());
+}
+
+void PipelineTraceWriter::flush(bool force) {
+  if (m_buffer.empty() || (!force && m_buffer.size() < s_flushBytes))
+    return;
+  const qint64 size = static_cast<qint64>(m_buffer.size());
+  if (m_file.write(reinterpret_cast<const char *>(m_buffer.data()), size) !=
+      size)
+    m_writeFailed = true;
+  m_bytes += size;
+  m_buffer.clear();
+}
+
+} // namespace Ripes
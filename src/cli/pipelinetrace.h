@@ -0,0 +1,107 @@
+#pragma once
+
+#include <QFile>
+#include <QObject>
+#include <QString>
+
+#include <unordered_map>
+#include <vector>
+
+#include "processors/interface/ripesprocessor.h"
+
+namespace Ripes {
+
+/**
+ * @brief The PipelineTraceWriter class
+ * Streams the stage occupancy of the current processor to a file during
+ * simulation, such that arbitrarily long runs may be inspected without holding
+ * the pipeline diagram in memory. Two formats are supported:
+ *
+ * - Binary: a magic number ("RPTR"), the format version and the number of
+ *   stages, followed by the lane, index and name of each stage, as serialized
+ *   by QDataStream. Then follows a sequence of records. A cycle record is the
+ *   byte 0, the LEB128 encoded cycle delta to the previous cycle record, and
+ *   an entry for each stage. A reset record is the byte 1, after which cycles
+ *   and stage PCs are relative to zero again. Each stage entry is a flags byte
+ *   (bit 0: valid, bits 1-3: StageInfo::State, bit 4: PC changed, bit 5: named
+ *   state), followed by the zigzag encoded delta to the previous PC of the
+ *   stage if it changed, and the id of the named state if present. Named
+ *   states are numbered in order of first appearance; the first use of an id
+ *   is followed by the LEB128 encoded length and UTF-8 bytes of the name.
+ *
+ * - Kanata: the text log format of the Konata pipeline viewer. Instructions
+ *   are identified by following each PC from a stage to its successor stage;
+ *   an instruction leaving the final stage of a lane is retired, and an
+ *   instruction leaving any other stage is recorded as flushed.
+ */
+class PipelineTraceWriter : public QObject {
+public:
+  enum class Format { Binary, Kanata };
+
+  ~PipelineTraceWriter() override;
+
+  /// Opens the file at @p path and starts tracing the current processor.
+  /// Returns an error message on failure, or an empty string on success.
+  QString open(const QString &path, Format format);
+  /// Stops tracing and closes the file. Returns an error message if writing
+  /// the trace failed, or an empty string on success.
+  QString close();
+
+  unsigned long long cycles() const { return m_cycles; }
+  unsigned long long bytes() const { return m_bytes; }
+
+private:
+  void processorReset();
+  void recordCycle();
+  void writeBinaryCycle(long long cycle);
+  void writeKanataCycle();
+  void retireKanata(unsigned pos, bool flushed);
+
+  void writeVarint(uint64_t value);
+  void writeText(const QString &text);
+  void flush(bool force = false);
+
+  bool occupied(const StageInfo &info) const {
+    return info.stage_valid && info.state == StageInfo::State::None;
+  }
+
+  QFile m_file;
+  Format m_format = Format::Kanata;
+  std::vector<uint8_t> m_buffer;
+  unsigned long long m_cycles = 0;
+  unsigned long long m_bytes = 0;
+  bool m_writeFailed = false;
+
+  // The stages of the processor, and the stage state of the current cycle.
+  std::vector<StageIndex> m_stages;
+  std::vector<QString> m_stageNames;
+  std::vector<StageInfo> m_infos;
+
+  // Binary format state.
+  long long m_lastCycle = 0;
+  std::vector<AInt> m_lastPcs;
+  // Trace-local ids of the named states defined so far, by NamedStates::ID;
+  // -1 if not yet defined in the trace.
+  std::vector<int> m_namedStateIds;
+  int m_numNamedStates = 0;
+
+  // Kanata format state. For each stage, the id and PC of the instruction
+  // occupying it, or -1 if unoccupied.
+  std::vector<long long> m_occupants;
+  std::vector<AInt> m_occupantPcs;
+  std::vector<long long> m_nextOccupants;
+  std::vector<bool> m_claimed;
+  // For each stage, the stages which instructions may advance from (the
+  // preceding stage of each lane, own lane first).
+  std::vector<std::vector<unsigned>> m_upstream;
+  std::vector<bool> m_finalStage;
+  // Stages in order of decreasing index, such that older instructions are
+  // matched first.
+  std::vector<unsigned> m_matchOrder;
+  long long m_nextId = 0;
+  long long m_nextRetireId = 0;
+  bool m_startedKanata = false;
+  std::unordered_map<AInt, QString> m_disassembly;
+};
+
+} // namespace Ripes
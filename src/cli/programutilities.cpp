@@ -1,21 +1,143 @@
 #include "programutilities.h"
 
+#include "elfio/elfio.hpp"
+
+#include "processorhandler.h"
+#include "sourcelines.h"
+
 namespace Ripes {
 
+const char *mapProgramFile(Program &program, const QString &filepath,
+                           qint64 &size, QString &error) {
+  auto file = std::make_shared<QFile>(filepath);
+  if (!file->open(QIODevice::ReadOnly)) {
+    error = "Error: Could not open file " + file->fileName();
+    return nullptr;
+  }
+  size = file->size();
+  if (size == 0) {
+    // Empty files cannot be mapped.
+    static const char empty = 0;
+    return &empty;
+  }
+  const uchar *mapped = file->map(0, size, QFileDevice::MapPrivateOption);
+  if (!mapped) {
+    error = "Error: Could not map file " + file->fileName();
+    return nullptr;
+  }
+  program.mappedFile = file;
+  return reinterpret_cast<const char *>(mapped);
+}
+
+QByteArray mappedData(const char *mapped, qint64 offset, qint64 size) {
+  return QByteArray::fromRawData(mapped + offset, static_cast<int>(size));
+}
+
 QString loadFlatBinaryFile(Program &program, const QString &filepath,
                            unsigned long entryPoint, unsigned long loadAt) {
-  QFile file(filepath);
-  if (!file.open(QIODevice::ReadOnly)) {
-    return "Error: Could not open file " + file.fileName();
-  }
+  QString err;
+  qint64 size = 0;
+  const char *mapped = mapProgramFile(program, filepath, size, err);
+  if (!mapped)
+    return err;
+
   ProgramSection section;
   section.name = TEXT_SECTION_NAME;
   section.address = loadAt;
-  section.data = file.readAll();
+  section.data = mappedData(mapped, 0, size);
 
   program.sections[TEXT_SECTION_NAME] = section;
   program.entryPoint = entryPoint;
   return QString();
 }
 
+QString loadElfFile(Program &program, const QString &filepath) {
+  ELFIO::elfio reader;
+  if (!reader.load(filepath.toStdString()))
+    return "Error: " + filepath + " is not an ELF file";
+
+  const ISAInfoBase *isa = ProcessorHandler::currentISA();
+  if (reader.get_machine() != isa->elfMachineId()) {
+    return "Error: Incompatible ELF machine type '" +
+           QString::number(reader.get_machine()) + "', expected '" +
+           QString::number(isa->elfMachineId()) + "'";
+  }
+  const unsigned elfBits = reader.get_class() == ELFCLASS32 ? 32 : 64;
+  if (elfBits != isa->bits()) {
+    return "Error: Expected " + QString::number(isa->bits()) +
+           " bit executable, but input program is " +
+           QString::number(elfBits) + " bit";
+  }
+  if (reader.get_type() != ET_EXEC)
+    return "Error: Only executable ELF files are supported";
+  QString err = isa->elfSupportsFlags(reader.get_flags());
+  if (!err.isEmpty())
+    return "Error: " + err;
+
+  qint64 fileSize = 0;
+  const char *mapped = mapProgramFile(program, filepath, fileSize, err);
+  if (!mapped)
+    return err;
+
+  unsigned segmentIdx = 0;
+  for (const auto &segment : reader.segments) {
+    if (segment->get_type() != PT_LOAD || segment->get_memory_size() == 0)
+      continue;
+    const QString segmentName = ".segment" + QString::number(segmentIdx++);
+    const auto offset = segment->get_offset();
+    const auto size = segment->get_file_size();
+    if (offset + size > static_cast<ELFIO::Elf64_Off>(fileSize))
+      return "Error: Segment " + segmentName + " extends beyond end of file";
+
+    ProgramSection section;
+    const bool isText = (segment->get_flags() & PF_X) &&
+                        program.sections.count(TEXT_SECTION_NAME) == 0;
+    section.name = isText ? TEXT_SECTION_NAME : segmentName;
+    section.address = segment->get_virtual_address();
+    section.data = mappedData(mapped, offset, size);
+    program.sections[section.name] = section;
+
+    // The part of the segment which is not backed by the file (ie. .bss) is
+    // zero-initialized.
+    const auto zeroSize = segment->get_memory_size() - size;
+    if (zeroSize > 0) {
+      ProgramSection zeroSection;
+      zeroSection.name = segmentName + ".zero";
+      zeroSection.address = section.address + size;
+      zeroSection.data = QByteArray(static_cast<int>(zeroSize), 0);
+      program.sections[zeroSection.name] = zeroSection;
+    }
+  }
+  if (program.sections.count(TEXT_SECTION_NAME) == 0)
+    return "Error: No executable segment found in " + filepath;
+
+  for (const auto &elfSection : reader.sections) {
+    if (elfSection->get_type() != SHT_SYMTAB)
+      continue;
+    const ELFIO::symbol_section_accessor symbols(reader, elfSection);
+    for (unsigned int j = 0; j < symbols.get_symbols_num(); ++j) {
+      std::string name;
+      ELFIO::Elf64_Addr value = 0;
+      ELFIO::Elf_Xword size;
+      unsigned char bind;
+      unsigned char type = STT_NOTYPE;
+      ELFIO::Elf_Half section_index;
+      unsigned char other;
+      symbols.get_symbol(j, name, value, size, bind, type, section_index,
+                         other);
+      if (type == STT_FUNC)
+        program.symbols[value] = QString::fromStdString(name);
+    }
+  }
+
+  // Malformed debug information does not prevent running the program; it is
+  // only needed for profiling by source line.
+  auto sourceLines = std::make_shared<SourceLineTable>();
+  if (loadSourceLines(reader, *sourceLines).isEmpty() && !sourceLines->empty())
+    program.sourceLines = sourceLines;
+
+  program.entryPoint = reader.get_entry();
+  return QString();
+}
+
 } // namespace Ripes
@@ -5,7 +5,25 @@
 
 namespace Ripes {
 
+/// Memory maps @p filepath and retains the mapping in @p program, such that
+/// sections may refer to the file contents without copying them. The mapping
+/// is private; any modification of the data is copy-on-write. Returns a pointer
+/// to the file contents of @p size bytes, or an error message in @p error.
+const char *mapProgramFile(Program &program, const QString &filepath,
+                           qint64 &size, QString &error);
+
+/// Returns a byte array referencing @p size bytes at @p offset of the file
+/// mapped by mapProgramFile, without copying.
+QByteArray mappedData(const char *mapped, qint64 offset, qint64 size);
+
 QString loadFlatBinaryFile(Program &program, const QString &filepath,
                            unsigned long entryPoint, unsigned long loadAt);
 
+/// Loads the executable ELF file at @p filepath into @p program. Loadable
+/// segments are referenced directly from a mapping of the file, the executable
+/// segment becoming the text section of the program. Function symbols are
+/// imported into the symbol map of the program. Returns an error message on
+/// failure, or an empty string on success.
+QString loadElfFile(Program &program, const QString &filepath);
+
 } // namespace Ripes
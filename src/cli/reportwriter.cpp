@@ -0,0 +1,120 @@
+#include "reportwriter.h"
+
+#include <QCborValue>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <cstdio>
+
+namespace Ripes {
+
+ReportWriter::~ReportWriter() { close(); }
+
+QString ReportWriter::open(const QString &path, Format format) {
+  close();
+  bool opened;
+  if (path.isEmpty()) {
+    opened = m_file.open(stdout, QIODevice::WriteOnly);
+  } else {
+    m_file.setFileName(path);
+    opened = m_file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+  }
+  if (!opened)
+    return "Error: Could not open report file " + path;
+
+  m_format = format;
+  m_inReport = false;
+  m_rowsKey.clear();
+  m_records = 0;
+  if (m_format == Format::Cbor)
+    m_cbor = std::make_unique<QCborStreamWriter>(&m_file);
+  return QString();
+}
+
+QString ReportWriter::close() {
+  if (!m_file.isOpen())
+    return QString();
+
+  endReport();
+  m_cbor.reset();
+  const bool failed = m_file.error() != QFileDevice::NoError;
+  m_file.close();
+  if (failed)
+    return "Error: Could not write report file " + m_file.fileName();
+  return QString();
+}
+
+void ReportWriter::beginReport(const QString &source) {
+  endReport();
+  m_source = source;
+  m_inReport = true;
+  if (m_format == Format::Cbor) {
+    m_cbor->startMap();
+    m_cbor->append(QLatin1String("source"));
+    m_cbor->append(source);
+    m_cbor->append(QLatin1String("report"));
+    m_cbor->startMap();
+  }
+}
+
+void ReportWriter::endReport() {
+  if (!m_inReport)
+    return;
+  endRows();
+  if (m_format == Format::Cbor) {
+    m_cbor->endMap();
+    m_cbor->endMap();
+  }
+  m_inReport = false;
+}
+
+void ReportWriter::value(const QString &key, const QVariant &value) {
+  endRows();
+  m_records++;
+  if (m_format == Format::JsonLines) {
+    writeLine(key, "value", value);
+    return;
+  }
+  m_cbor->append(key);
+  QCborValue::fromVariant(value).toCbor(*m_cbor);
+}
+
+void ReportWriter::row(const QString &key, const QVariant &row) {
+  m_records++;
+  if (m_format == Format::JsonLines) {
+    writeLine(key, "row", row);
+    return;
+  }
+  if (m_rowsKey != key) {
+    endRows();
+    m_cbor->append(key);
+    m_cbor->startArray();
+    m_rowsKey = key;
+  }
+  QCborValue::fromVariant(row).toCbor(*m_cbor);
+}
+
+void ReportWriter::append(const QByteArray &reports) {
+  endReport();
+  m_file.write(reports);
+}
+
+void ReportWriter::writeLine(const QString &key, const char *field,
+                             const QVariant &data) {
+  QJsonObject line;
+  line["source"] = m_source;
+  line["telemetry"] = key;
+  line[field] = QJsonValue::fromVariant(data);
+  m_file.write(QJsonDocument(line).toJson(QJsonDocument::Compact));
+  m_file.write("\n", 1);
+}
+
+void ReportWriter::endRows() {
+  if (m_rowsKey.isEmpty())
+    return;
+  if (m_format == Format::Cbor)
+    m_cbor->endArray();
+  m_rowsKey.clear();
+}
+
+} // namespace Ripes
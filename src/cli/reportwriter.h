@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QCborStreamWriter>
+#include <QFile>
+#include <QString>
+#include <QVariant>
+
+#include <memory>
+
+namespace Ripes {
+
+/**
+ * @brief The ReportWriter class
+ * Streams the telemetry reports of the simulated sources to a file as they are
+ * collected, such that large reports need not be assembled into a single
+ * document. Telemetry writes its report either as a single value, or as a
+ * sequence of rows (see Telemetry::stream). Two formats are supported:
+ *
+ * - JsonLines: a compact JSON object per line. A value is written as
+ *   {"source": <source>, "telemetry": <key>, "value": <value>}, and each row
+ *   as {"source": <source>, "telemetry": <key>, "row": <row>}.
+ *
+ * - Cbor: a CBOR sequence (RFC 8742) of a map per source, holding the source
+ *   ("source") and a map of the reports of its telemetry by key ("report").
+ *   Reports written as rows are arrays of the rows. Maps and arrays are of
+ *   indefinite length, such that they are written as they are collected.
+ *
+ * In both formats, the output of several writers may be concatenated.
+ */
+class ReportWriter {
+public:
+  enum class Format { JsonLines, Cbor };
+
+  ~ReportWriter();
+
+  /// Opens the file at @p path, or stdout if empty. Returns an error message
+  /// on failure, or an empty string on success.
+  QString open(const QString &path, Format format);
+  /// Ends the current report and closes the file. Returns an error message if
+  /// writing failed, or an empty string on success.
+  QString close();
+
+  /// Starts the report of @p source, ending the previous report.
+  void beginReport(const QString &source);
+  void endReport();
+  /// Writes @p value as the report of the telemetry @p key.
+  void value(const QString &key, const QVariant &value);
+  /// Appends @p row to the report of the telemetry @p key. The rows of a
+  /// report must be written consecutively.
+  void row(const QString &key, const QVariant &row);
+  /// Appends the complete reports written by another writer of the same
+  /// format.
+  void append(const QByteArray &reports);
+
+  unsigned long long records() const { return m_records; }
+
+private:
+  void writeLine(const QString &key, const char *field, const QVariant &data);
+  void endRows();
+
+  QFile m_file;
+  Format m_format = Format::JsonLines;
+  std::unique_ptr<QCborStreamWriter> m_cbor;
+  QString m_source;
+  bool m_inReport = false;
+  // The telemetry whose rows are being written, if any.
+  QString m_rowsKey;
+  unsigned long long m_records = 0;
+};
+
+} // namespace Ripes
@@ -0,0 +1,104 @@
+#include "resultcache.h"
+
+#include "version/version.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QSaveFile>
+
+namespace Ripes {
+
+namespace {
+// Identifies (the version of) the format of cached results.
+constexpr int c_resultCacheVersion = 1;
+
+bool isCacheable(const CLIModeOptions &options) {
+  return options.timeout == 0 && !options.streamReport &&
+         options.checkpointOut.isEmpty() && options.cacheTraceOut.isEmpty() &&
+         options.pipelineTraceOut.isEmpty() && options.vcdOut.isEmpty() &&
+         options.memTraceOut.isEmpty() && options.shmTrace.isEmpty() &&
+         options.commitLog.isEmpty() && options.replayTrace.isEmpty() &&
+         options.callGraphOut.isEmpty() && options.syscallLog.isEmpty() &&
+         options.plugins.isEmpty() && options.objdumpOut.isEmpty() &&
+         options.memoryDumpOut.isEmpty() && options.ioDevices.empty() &&
+         options.gdbPort == 0;
+}
+
+// Adds the content of the file at @p path to @p hash. Returns false if the
+// file could not be read.
+bool addFile(QCryptographicHash &hash, const QString &path) {
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly))
+    return false;
+  return hash.addData(&file);
+}
+} // namespace
+
+QString resultCacheKey(const CLIModeOptions &options) {
+  if (!isCacheable(options))
+    return QString();
+
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  const auto addField = [&](const QByteArray &field) {
+    hash.addData(field);
+    hash.addData("\0", 1);
+  };
+  addField(QByteArray::number(c_resultCacheVersion));
+  addField(getRipesVersion().toUtf8());
+  addField(options.resultOptions.toUtf8());
+  // Batch and server runs always report as JSON.
+  addField(options.jsonOutput ? "json" : "text");
+  if (!addFile(hash, options.src))
+    return QString();
+  addField("link");
+  for (const auto &path : options.linkFiles)
+    if (!addFile(hash, path))
+      return QString();
+  addField("stdin");
+  if (!options.stdinFile.isEmpty() && !addFile(hash, options.stdinFile))
+    return QString();
+  addField("checkpoint");
+  if (!options.checkpointIn.isEmpty() && !addFile(hash, options.checkpointIn))
+    return QString();
+  return hash.result().toHex();
+}
+
+bool loadCachedResult(const QString &dir, const QString &key,
+                      CachedResult &result) {
+  QFile file(QDir(dir).filePath(key + ".result"));
+  if (!file.open(QIODevice::ReadOnly))
+    return false;
+  const QJsonObject entry = QJsonDocument::fromJson(file.readAll()).object();
+  if (entry.value("version").toInt() != c_resultCacheVersion)
+    return false;
+  result.json = entry.value("report").toObject();
+  result.text = entry.value("text").toString();
+  result.console = entry.value("console").toString();
+  result.runLimitReached = entry.value("limit").toBool();
+  return true;
+}
+
+void storeCachedResult(const QString &dir, const QString &key,
+                       const CachedResult &result) {
+  if (!QDir().mkpath(dir))
+    return;
+
+  QJsonObject entry;
+  entry["version"] = c_resultCacheVersion;
+  entry["report"] = result.json;
+  entry["text"] = result.text;
+  entry["console"] = result.console;
+  entry["limit"] = result.runLimitReached;
+
+  // Written through a QSaveFile, such that concurrent runs never observe a
+  // partially written result.
+  QSaveFile file(QDir(dir).filePath(key + ".result"));
+  if (!file.open(QIODevice::WriteOnly))
+    return;
+  file.write(QJsonDocument(entry).toJson(QJsonDocument::Compact));
+  file.commit();
+}
+
+} // namespace Ripes
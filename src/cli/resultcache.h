@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QString>
+
+#include "clioptions.h"
+
+namespace Ripes {
+
+/**
+ * The result cache (--result-cache) stores the report of each run in a
+ * directory on disk, keyed on the content of its source file and the options
+ * of the run which may affect its result (see CLIModeOptions::resultOptions):
+ * the processor, ISA extensions, register initialization, cache
+ * configuration, requested telemetry and any other simulation options. Files
+ * read by the run, ie. stdin (--stdin) and checkpoints (--checkpoint-in), are
+ * keyed on their content. A later run with the same key returns the stored
+ * report, and replays the console output of the program, without simulating.
+ *
+ * Runs with side effects beyond their report and console output, ie. traces,
+ * checkpoints or memory dumps written to file, peripherals, plugins and GDB
+ * sessions, and runs bounded by wall time (--timeout), are not cached. Runs
+ * which read the standard input of the host are not stored, since their input
+ * is not known.
+ */
+struct CachedResult {
+  QJsonObject json;
+  QString text;
+  QString console;
+  // Whether the run was stopped at a run limit or watchpoint.
+  bool runLimitReached = false;
+};
+
+/// Returns the result cache key of running the source file of @p options with
+/// @p options, or an empty string if such runs are not cached.
+QString resultCacheKey(const CLIModeOptions &options);
+
+/// Loads the result stored as @p key in the cache directory @p dir into
+/// @p result. Returns false if no result is stored.
+bool loadCachedResult(const QString &dir, const QString &key,
+                      CachedResult &result);
+
+/// Stores @p result as @p key in the cache directory @p dir. Failing to store
+/// a result is not an error; the run is simply simulated again.
+void storeCachedResult(const QString &dir, const QString &key,
+                       const CachedResult &result);
+
+} // namespace Ripes
@@ -0,0 +1,85 @@
+#include "reuseprofiler.h"
+
+#include "processorhandler.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+unsigned long long ReuseProfiler::Entry::misses(unsigned capacityBits) const {
+  unsigned long long hits = 0;
+  for (unsigned b = 0; b <= capacityBits && b < distances.size(); ++b)
+    hits += distances[b];
+  return accesses() - hits;
+}
+
+unsigned ReuseProfiler::Entry::medianBucket() const {
+  const unsigned long long reuses = accesses() - cold;
+  unsigned long long seen = 0;
+  for (unsigned b = 0; b < distances.size(); ++b) {
+    seen += distances[b];
+    if (seen * 2 >= reuses && seen != 0)
+      return b;
+  }
+  return 0;
+}
+
+ReuseProfiler::ReuseProfiler(unsigned lineBits) : m_lineBits(lineBits) {
+  ProcessorHandler::attachObserver(this);
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          [this] { reset(); });
+}
+
+ReuseProfiler::~ReuseProfiler() { ProcessorHandler::detachObserver(this); }
+
+void ReuseProfiler::reset() {
+  m_accesses = 0;
+  m_tracker.reset();
+  m_instructions.clear();
+}
+
+void ReuseProfiler::onMemAccess(const RipesProcessor &proc,
+                                const MemoryAccess &access, bool data) {
+  if (!data)
+    return;
+  m_accesses++;
+  const AInt pc = proc.dataMemAccessPC();
+  Entry &entry = m_instructions[pc];
+  entry.pc = pc;
+  if (access.type == MemoryAccess::Write)
+    entry.stores++;
+  else
+    entry.loads++;
+
+  // Accesses spanning lines are attributed to their first line.
+  const long long distance = m_tracker.access(access.address >> m_lineBits);
+  if (distance == ReuseDistanceTracker::s_cold)
+    entry.cold++;
+  else
+    entry.distances[ReuseDistanceTracker::bucket(distance)]++;
+}
+
+std::vector<ReuseProfiler::Entry>
+ReuseProfiler::worst(unsigned n, unsigned capacityBits) const {
+  std::vector<Entry> entries;
+  entries.reserve(m_instructions.size());
+  for (const auto &it : m_instructions)
+    entries.push_back(it.second);
+  const auto worse = [capacityBits](const Entry &lhs, const Entry &rhs) {
+    const auto lhsMisses = lhs.misses(capacityBits);
+    const auto rhsMisses = rhs.misses(capacityBits);
+    if (lhsMisses != rhsMisses)
+      return lhsMisses > rhsMisses;
+    return lhs.pc < rhs.pc;
+  };
+  if (entries.size() > n) {
+    std::partial_sort(entries.begin(), entries.begin() + n, entries.end(),
+                      worse);
+    entries.resize(n);
+  } else {
+    std::sort(entries.begin(), entries.end(), worse);
+  }
+  return entries;
+}
+
+} // namespace Ripes
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QObject>
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+#include "cachesim/stackdistanceprofiler.h"
+#include "processorobserver.h"
+
+namespace Ripes {
+
+/**
+ * @brief The ReuseProfiler class
+ * Computes the reuse distance of each data access of the current processor at
+ * cache line granularity (see ReuseDistanceTracker), and keeps a histogram of
+ * the distances of each load and store instruction, by PC. An access hits in
+ * a fully associative LRU cache of N lines exactly if its reuse distance is
+ * less than N, such that the instructions with the worst locality for a cache
+ * of a given size are those with the most accesses of a larger distance. The
+ * profile is cleared when the processor is reset.
+ */
+class ReuseProfiler : public QObject, public ProcessorObserver {
+public:
+  struct Entry {
+    AInt pc = 0;
+    unsigned long long loads = 0;
+    unsigned long long stores = 0;
+    // Accesses to lines which were not accessed before.
+    unsigned long long cold = 0;
+    // Histogram of reuse distances (see ReuseDistanceTracker::bucket()).
+    std::array<unsigned long long, ReuseDistanceTracker::s_buckets>
+        distances{};
+
+    unsigned long long accesses() const { return loads + stores; }
+    /// Returns the accesses which miss in a fully associative LRU cache of
+    /// 2^@p capacityBits lines, including cold accesses.
+    unsigned long long misses(unsigned capacityBits) const;
+    /// Returns the histogram bucket of the median reuse distance of the
+    /// accesses which were not cold.
+    unsigned medianBucket() const;
+  };
+
+  /// Profiles the current processor until destroyed, with lines of
+  /// 2^@p lineBits bytes.
+  explicit ReuseProfiler(unsigned lineBits);
+  ~ReuseProfiler() override;
+
+  unsigned lineBits() const { return m_lineBits; }
+  unsigned long long accesses() const { return m_accesses; }
+  /// Returns the @p n instructions with the most misses in a fully associative
+  /// LRU cache of 2^@p capacityBits lines, in descending order.
+  std::vector<Entry> worst(unsigned n, unsigned capacityBits) const;
+
+  unsigned events() const override { return MemAccess; }
+  void onMemAccess(const RipesProcessor &proc, const MemoryAccess &access,
+                   bool data) override;
+
+private:
+  void reset();
+
+  unsigned m_lineBits;
+  unsigned long long m_accesses = 0;
+  ReuseDistanceTracker m_tracker;
+  std::unordered_map<AInt, Entry> m_instructions;
+};
+
+} // namespace Ripes
@@ -0,0 +1,169 @@
+#include "sharedtrace.h"
+
+#include "processorhandler.h"
+
+#include <thread>
+
+#ifndef Q_OS_WIN
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace Ripes {
+
+SharedTraceWriter::~SharedTraceWriter() { close(); }
+
+QString SharedTraceWriter::open(const QString &name, uint64_t capacity,
+                                unsigned traced, bool drop) {
+  close();
+#ifdef Q_OS_WIN
+  Q_UNUSED(name);
+  Q_UNUSED(capacity);
+  Q_UNUSED(traced);
+  Q_UNUSED(drop);
+  return "Error: Shared memory traces are not supported on this platform";
+#else
+  // POSIX shared memory object names start with a single slash.
+  m_name = name.startsWith('/') ? name : "/" + name;
+  const QByteArray path = m_name.toLocal8Bit();
+  // A segment left behind by an earlier run is replaced.
+  shm_unlink(path.constData());
+  m_fd = shm_open(path.constData(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (m_fd < 0)
+    return "Error: Could not create shared memory object " + m_name;
+
+  m_bytes = sizeof(SharedTraceHeader) + capacity * sizeof(SharedTraceRecord);
+  void *mapped = MAP_FAILED;
+  if (ftruncate(m_fd, static_cast<off_t>(m_bytes)) == 0)
+    mapped =
+        mmap(nullptr, m_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+  if (mapped == MAP_FAILED) {
+    ::close(m_fd);
+    m_fd = -1;
+    shm_unlink(path.constData());
+    return "Error: Could not map shared memory object " + m_name;
+  }
+
+  // The segment is zero-filled by ftruncate, such that the indices start at
+  // 0 and the consumer sees a valid magic once the header is complete.
+  m_header = static_cast<SharedTraceHeader *>(mapped);
+  m_records = reinterpret_cast<SharedTraceRecord *>(
+      static_cast<char *>(mapped) + sizeof(SharedTraceHeader));
+  m_header->version = SharedTraceHeader::c_version;
+  m_header->headerBytes = sizeof(SharedTraceHeader);
+  m_header->recordBytes = sizeof(SharedTraceRecord);
+  m_header->capacity = capacity;
+  m_header->events = traced;
+  std::atomic_thread_fence(std::memory_order_release);
+  m_header->magic = SharedTraceHeader::c_magic;
+
+  m_capacity = capacity;
+  m_traced = traced;
+  m_drop = drop;
+  m_write = m_read = 0;
+  m_dropped = 0;
+
+  ProcessorHandler::attachObserver(this);
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          [this] { processorReset(); });
+  return QString();
+#endif
+}
+
+void SharedTraceWriter::close() {
+#ifndef Q_OS_WIN
+  if (!m_header)
+    return;
+
+  ProcessorHandler::detachObserver(this);
+  disconnect(ProcessorHandler::get(), nullptr, this, nullptr);
+  publish();
+  m_header->finished.store(1, std::memory_order_release);
+  if (!m_drop) {
+    while (m_header->readIndex.load(std::memory_order_acquire) != m_write)
+      std::this_thread::yield();
+  }
+  munmap(m_header, m_bytes);
+  ::close(m_fd);
+  shm_unlink(m_name.toLocal8Bit().constData());
+  m_header = nullptr;
+  m_records = nullptr;
+  m_fd = -1;
+#endif
+}
+
+SharedTraceRecord *SharedTraceWriter::reserve() {
+  while (m_write - m_read >= m_capacity) {
+    m_read = m_header->readIndex.load(std::memory_order_acquire);
+    if (m_write - m_read < m_capacity)
+      break;
+    if (m_drop) {
+      m_header->dropped.store(++m_dropped, std::memory_order_relaxed);
+      return nullptr;
+    }
+    // Records of the current cycle are published, such that the consumer
+    // can make progress.
+    publish();
+    std::this_thread::yield();
+  }
+  return &m_records[m_write++ & (m_capacity - 1)];
+}
+
+void SharedTraceWriter::onRetire(const RipesProcessor &proc, unsigned count) {
+  SharedTraceRecord *record = reserve();
+  if (!record)
+    return;
+  *record = SharedTraceRecord();
+  record->type = SharedTraceRecord::Retire;
+  record->count = count;
+  record->cycle = proc.getCycleCount();
+  record->address = proc.getInstructionsRetired();
+}
+
+void SharedTraceWriter::onMemAccess(const RipesProcessor &proc,
+                                    const MemoryAccess &access, bool data) {
+  SharedTraceRecord *record = reserve();
+  if (!record)
+    return;
+  *record = SharedTraceRecord();
+  record->type = SharedTraceRecord::MemAccess;
+  record->flags = (data ? 0b01 : 0) |
+                  (access.type == MemoryAccess::Write ? 0b10 : 0);
+  record->count = access.bytes;
+  record->cycle = proc.getCycleCount();
+  record->pc = data ? proc.dataMemAccessPC() : access.address;
+  record->address = access.address;
+}
+
+void SharedTraceWriter::onStageUpdate(const RipesProcessor &proc,
+                                      StageIndex stage,
+                                      const StageInfo &info) {
+  SharedTraceRecord *record = reserve();
+  if (!record)
+    return;
+  *record = SharedTraceRecord();
+  record->type = SharedTraceRecord::StageUpdate;
+  record->flags =
+      static_cast<uint8_t>(info.state) | (info.stage_valid ? 0b1000 : 0);
+  record->stage = proc.structure().flatIndex(stage);
+  record->count = info.namedState;
+  record->cycle = proc.getCycleCount();
+  record->pc = info.pc;
+}
+
+void SharedTraceWriter::onCycle(const RipesProcessor &proc) {
+  Q_UNUSED(proc);
+  publish();
+}
+
+void SharedTraceWriter::processorReset() {
+  SharedTraceRecord *record = reserve();
+  if (!record)
+    return;
+  *record = SharedTraceRecord();
+  record->type = SharedTraceRecord::Reset;
+  publish();
+}
+
+} // namespace Ripes
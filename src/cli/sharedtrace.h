@@ -0,0 +1,144 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "processorobserver.h"
+
+namespace Ripes {
+
+/**
+ * Layout of a shared memory trace (--shm-trace), for consumers to map the
+ * segment directly. All fields are in host byte order.
+ *
+ * The segment starts with a SharedTraceHeader, followed by a ring of
+ * SharedTraceHeader::capacity records of SharedTraceRecord at offset
+ * SharedTraceHeader::headerBytes. Ripes is the single producer, and a single
+ * consumer is supported: record i (counting from 0) is held in slot
+ * i % capacity, and records [readIndex, writeIndex[ are ready to be consumed.
+ * The consumer loads writeIndex with acquire semantics, reads the records in
+ * place, and then stores the index of the first unread record to readIndex
+ * with release semantics to free their slots. Records are published once per
+ * cycle.
+ *
+ * Unless records are dropped (--shm-trace-drop), Ripes waits for slots to
+ * free up when the ring is full, and once tracing ends, until all records were
+ * consumed. Otherwise, records which do not fit are counted in dropped. Once
+ * tracing ends, finished is set to 1 (with release semantics), after which no
+ * more records are published.
+ */
+struct SharedTraceHeader {
+  static constexpr uint32_t c_magic = 0x54485352; // "RSHT"
+  static constexpr uint32_t c_version = 1;
+
+  uint32_t magic;
+  uint32_t version;
+  // Offset of the records from the start of the segment, and their size.
+  uint32_t headerBytes;
+  uint32_t recordBytes;
+  // Number of record slots of the ring; a power of two.
+  uint64_t capacity;
+  // Mask of the traced events, of ProcessorObserver::Event.
+  uint32_t events;
+  std::atomic<uint32_t> finished;
+  std::atomic<uint64_t> dropped;
+  // The indices of the producer and consumer, each in a cache line of its own.
+  alignas(64) std::atomic<uint64_t> writeIndex;
+  alignas(64) std::atomic<uint64_t> readIndex;
+};
+
+/**
+ * A single traced event.
+ * - Retire: @a count instructions retired in @a cycle, @a address holds the
+ *   total number of instructions retired.
+ * - MemAccess: an access of @a count bytes to @a address by the instruction at
+ *   @a pc. Flags: bit 0 is set for data accesses and bit 1 for writes.
+ * - StageUpdate: the state of the stage at @a stage of the flattened stage
+ *   table of the processor (see ProcessorStructure::flatIndex) in @a cycle,
+ *   holding the instruction at @a pc. The flags hold the StageInfo::State in
+ *   bits 0-2 and StageInfo::stage_valid in bit 3, and @a count holds the id of
+ *   the named state of the stage (see NamedStates).
+ * - Reset: the processor was reset; cycles and retirement counts restart.
+ */
+struct SharedTraceRecord {
+  enum Type : uint8_t { Retire = 1, MemAccess = 2, StageUpdate = 3, Reset = 4 };
+
+  uint8_t type;
+  uint8_t flags;
+  uint16_t stage;
+  uint32_t count;
+  uint64_t cycle;
+  uint64_t pc;
+  uint64_t address;
+};
+
+static_assert(sizeof(SharedTraceHeader) == 192 &&
+                  offsetof(SharedTraceHeader, writeIndex) == 64 &&
+                  offsetof(SharedTraceHeader, readIndex) == 128,
+              "Shared trace header layout changed");
+static_assert(sizeof(SharedTraceRecord) == 32,
+              "Shared trace record layout changed");
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "Shared trace indices must be lock-free");
+
+/**
+ * @brief The SharedTraceWriter class
+ * Publishes the retirement, memory access and stage events of the current
+ * processor into a ring buffer in POSIX shared memory, for external tools to
+ * consume live (see SharedTraceHeader). Events are observed through
+ * ProcessorHandler::attachObserver.
+ */
+class SharedTraceWriter : public QObject, public ProcessorObserver {
+public:
+  ~SharedTraceWriter() override;
+
+  /// Creates the shared memory object @p name with a ring of @p capacity
+  /// records (a power of two), and starts publishing the @p traced events
+  /// (of Retire, MemAccess and StageUpdate). If @p drop is set, records which
+  /// do not fit the ring are dropped rather than waited upon. Returns an error
+  /// message on failure, or an empty string on success.
+  QString open(const QString &name, uint64_t capacity, unsigned traced,
+               bool drop);
+  /// Stops publishing, waits for the consumer to drain the ring unless
+  /// records are dropped, and removes the shared memory object.
+  void close();
+
+  unsigned long long records() const { return m_write; }
+  unsigned long long dropped() const { return m_dropped; }
+
+  unsigned events() const override { return m_traced | Cycle; }
+  void onRetire(const RipesProcessor &proc, unsigned count) override;
+  void onMemAccess(const RipesProcessor &proc, const MemoryAccess &access,
+                   bool data) override;
+  void onStageUpdate(const RipesProcessor &proc, StageIndex stage,
+                     const StageInfo &info) override;
+  void onCycle(const RipesProcessor &proc) override;
+
+private:
+  /// Returns the slot of the next record, or nullptr if it is dropped.
+  SharedTraceRecord *reserve();
+  void publish() {
+    m_header->writeIndex.store(m_write, std::memory_order_release);
+  }
+  void processorReset();
+
+  QString m_name;
+  int m_fd = -1;
+  size_t m_bytes = 0;
+  SharedTraceHeader *m_header = nullptr;
+  SharedTraceRecord *m_records = nullptr;
+  uint64_t m_capacity = 0;
+  unsigned m_traced = 0;
+  bool m_drop = false;
+  // Producer-local copies of the indices, such that the consumer's cache line
+  // is only read once the ring appears full.
+  uint64_t m_write = 0;
+  uint64_t m_read = 0;
+  unsigned long long m_dropped = 0;
+};
+
+} // namespace Ripes
@@ -0,0 +1,159 @@
+#include "simfork.h"
+
+#include "checkpoint.h"
+#include "clirunner.h"
+#include "processorhandler.h"
+#include "session.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonDocument>
+
+namespace Ripes {
+
+QString parseForkVariant(const QString &spec, ForkVariant &variant) {
+  variant.name = spec.simplified();
+  variant.arguments = QProcess::splitCommand(spec);
+  for (const auto &argument : qAsConst(variant.arguments)) {
+    if (!argument.startsWith("-"))
+      continue;
+    QString option = argument.section('=', 0, 0);
+    while (option.startsWith("-"))
+      option.remove(0, 1);
+    if (option == "src" || option == "t" || option == "output" ||
+        option == "mode")
+      return "Option '" + option + "' cannot be set per forked simulation";
+  }
+  if (variant.arguments.empty())
+    return "Empty forked simulation '" + spec + "'";
+  return QString();
+}
+
+SimulationFork::~SimulationFork() {
+  for (auto &child : m_children) {
+    if (child->state() != QProcess::NotRunning) {
+      child->kill();
+      child->waitForFinished(-1);
+    }
+  }
+}
+
+QString SimulationFork::snapshot() {
+  if (isRunning())
+    return "A forked simulation is already running";
+  auto program = ProcessorHandler::getProgram();
+  if (!program)
+    return "No program is loaded";
+
+  m_sessionPath.clear();
+  m_dir = std::make_unique<QTemporaryDir>();
+  if (!m_dir->isValid())
+    return "Failed to create temporary directory for forked simulations";
+
+  // The children share a single copy of the program and the current state.
+  Session session;
+  session.processor = ProcessorHandler::getID();
+  session.extensions = ProcessorHandler::currentISA()->enabledExtensions();
+  session.sourceType = SourceType::Session;
+  session.program = std::make_shared<Program>(*program);
+  session.checkpoint = checkpointData();
+  const QString sessionPath = m_dir->filePath("fork.rses");
+  const QString err = saveSession(sessionPath, session);
+  if (!err.isEmpty())
+    return err;
+
+  m_sessionPath = sessionPath;
+  m_processor = session.processor;
+  m_extensions = session.extensions;
+  m_snapshotCycle = ProcessorHandler::getProcessor()->getCycleCount();
+  return QString();
+}
+
+QString SimulationFork::start(const QStringList &arguments,
+                              const std::vector<ForkVariant> &variants) {
+  if (isRunning())
+    return "A forked simulation is already running";
+  if (variants.empty())
+    return "No simulations to fork";
+  if (!hasSnapshot()) {
+    const QString err = snapshot();
+    if (!err.isEmpty())
+      return err;
+  }
+
+  QStringList baseArgs;
+  baseArgs << "--mode"
+           << "cli"
+           << "-t"
+           << "session"
+           << "--src" << m_sessionPath << "--json"
+           << "--proc" << enumToString<ProcessorID>(m_processor);
+  if (!m_extensions.empty())
+    baseArgs << "--isaexts" << m_extensions.join(",");
+  baseArgs << arguments;
+
+  m_children.clear();
+  m_results.assign(variants.size(), QJsonObject());
+  m_running = variants.size();
+  for (size_t i = 0; i < variants.size(); ++i) {
+    m_results.at(i)["name"] = variants.at(i).name;
+    auto &child = m_children.emplace_back(std::make_unique<QProcess>());
+    child->setProcessChannelMode(QProcess::MergedChannels);
+    connect(child.get(),
+            QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+            [this, i] { childFinished(i); });
+    connect(child.get(), &QProcess::errorOccurred, this,
+            [this, i](QProcess::ProcessError error) {
+              if (error == QProcess::FailedToStart)
+                childFinished(i);
+            });
+    // Reports of previous starts are not mistaken for those of this start.
+    const QString reportPath = m_dir->filePath(QString::number(i) + ".json");
+    QFile::remove(reportPath);
+    QStringList args = baseArgs;
+    args << variants.at(i).arguments << "--output" << reportPath;
+    child->start(QCoreApplication::applicationFilePath(), args);
+    // Programs of the children read end-of-file unless --stdin is specified.
+    child->closeWriteChannel();
+  }
+  return QString();
+}
+
+void SimulationFork::waitForFinished() {
+  for (auto &child : m_children) {
+    if (child->state() != QProcess::NotRunning)
+      child->waitForFinished(-1);
+  }
+}
+
+void SimulationFork::childFinished(size_t index) {
+  QJsonObject &result = m_results.at(index);
+  if (!result.value("status").isUndefined())
+    return;
+
+  auto &child = m_children.at(index);
+  const QStringList output =
+      QString::fromUtf8(child->readAll()).split('\n', Qt::SkipEmptyParts);
+  const bool normalExit = child->exitStatus() == QProcess::NormalExit &&
+                          child->error() != QProcess::FailedToStart;
+  const int exitCode = child->exitCode();
+  QFile report(m_dir->filePath(QString::number(index) + ".json"));
+  const bool completed =
+      exitCode == 0 || exitCode == CLIRunner::c_runLimitExitCode;
+  if (normalExit && completed && report.open(QIODevice::ReadOnly)) {
+    result["status"] = exitCode == 0 ? "ok" : "limit";
+    result["report"] = QJsonDocument::fromJson(report.readAll()).object();
+  } else {
+    result["status"] = "failed";
+    QString error = "Forked simulation failed";
+    for (const auto &line : output)
+      if (line.startsWith("ERROR: "))
+        error = line.mid(7).trimmed();
+    result["error"] = error;
+  }
+
+  if (--m_running == 0)
+    emit finished();
+}
+
+} // namespace Ripes
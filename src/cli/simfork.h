@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QObject>
+#include <QProcess>
+#include <QStringList>
+#include <QTemporaryDir>
+
+#include <memory>
+#include <vector>
+
+#include "processorregistry.h"
+
+namespace Ripes {
+
+/// A child of a forked simulation: its name, and the command-line options in
+/// which it differs from the other children (ie. `--proc RV32_OOO`,
+/// `--l1d lines=64,ways=2` or `--reginit 10=5`).
+struct ForkVariant {
+  QString name;
+  QStringList arguments;
+};
+
+/// Parses a variant from @p spec, a list of command-line options separated by
+/// spaces and quoted as in a shell. The variant is named by @p spec. Returns an
+/// error message on failure, or an empty string on success.
+QString parseForkVariant(const QString &spec, ForkVariant &variant);
+
+/**
+ * @brief The SimulationFork class
+ * Forks the current simulation into a child per variant, each of which resumes
+ * from the current state of the processor in a CLI mode process of its own,
+ * such that the children run in parallel.
+ *
+ * The program and a checkpoint of the current state (see checkpoint.h) are
+ * written once, to a session file (see session.h) loaded by every child. The
+ * sections of the program are memory mapped by the children, such that their
+ * pages are shared between the children by the host, and the prefix of the
+ * simulation is not re-executed. Children start with an empty pipeline and
+ * empty caches, and may select any processor model implementing the ISA of the
+ * current processor.
+ *
+ * The state is captured once, by the first start() or by snapshot(), such that
+ * children of later starts resume from the same state, ie. to rerun the
+ * variants with a larger cycle budget.
+ */
+class SimulationFork : public QObject {
+  Q_OBJECT
+public:
+  /// Children which are still running are killed.
+  ~SimulationFork() override;
+
+  /// Captures the program and the current state of the processor for the
+  /// children of subsequent starts. Returns an error message on failure, or an
+  /// empty string on success.
+  QString snapshot();
+  bool hasSnapshot() const { return !m_sessionPath.isEmpty(); }
+  /// The cycle count of the processor at the time of the snapshot.
+  long long snapshotCycle() const { return m_snapshotCycle; }
+
+  /// Starts a child per variant of @p variants. Each child is run with the
+  /// currently selected processor and ISA extensions, followed by the options
+  /// of @p arguments, and lastly those of its variant, which thus take
+  /// precedence. Returns an error message on failure, or an empty string on
+  /// success.
+  QString start(const QStringList &arguments,
+                const std::vector<ForkVariant> &variants);
+  bool isRunning() const { return m_running > 0; }
+  /// Blocks until all children have finished.
+  void waitForFinished();
+
+  /// The result of each child, in the order of the variants: its name (name),
+  /// status (ok, limit or failed), an error message (error), and its JSON
+  /// report (report), once the child has finished.
+  const std::vector<QJsonObject> &results() const { return m_results; }
+
+signals:
+  /// Emitted once all children have finished.
+  void finished();
+
+private:
+  void childFinished(size_t index);
+
+  std::unique_ptr<QTemporaryDir> m_dir;
+  QString m_sessionPath;
+  ProcessorID m_processor{};
+  QStringList m_extensions;
+  long long m_snapshotCycle = 0;
+  std::vector<std::unique_ptr<QProcess>> m_children;
+  std::vector<QJsonObject> m_results;
+  size_t m_running = 0;
+};
+
+} // namespace Ripes
@@ -0,0 +1,261 @@
+#include "simpoint.h"
+
+#include "processorhandler.h"
+#include "processorstate.h"
+#include "syscall/systemio.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <random>
+#include <unordered_map>
+
+namespace Ripes {
+
+// Basic block vectors are randomly projected down to this number of
+// dimensions before clustering, as done in SimPoint.
+static constexpr unsigned s_projectedDims = 15;
+static constexpr unsigned s_maxKMeansIterations = 100;
+
+using ProjectedBBV = std::array<double, s_projectedDims>;
+
+namespace {
+struct ProfiledInterval {
+  // Basic block vector; maps the start address of each basic block executed
+  // within the interval to the number of instructions executed in the block.
+  std::unordered_map<AInt, long long> bbv;
+  long long instructions = 0;
+};
+} // namespace
+
+double SimPointResult::cpi() const {
+  double cpi = 0;
+  for (const auto &sp : simPoints)
+    if (sp.instructions > 0)
+      cpi += sp.weight * static_cast<double>(sp.cycles) / sp.instructions;
+  return cpi;
+}
+
+static double distance2(const ProjectedBBV &a, const ProjectedBBV &b) {
+  double d = 0;
+  for (unsigned i = 0; i < s_projectedDims; ++i)
+    d += (a[i] - b[i]) * (a[i] - b[i]);
+  return d;
+}
+
+/// Projects the normalized basic block vector of @p interval onto a fixed,
+/// pseudo-random basis. The basis vector of each basic block is derived from
+/// its address, such that it is consistent across intervals.
+static ProjectedBBV project(const ProfiledInterval &interval) {
+  ProjectedBBV proj{};
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  for (const auto &block : interval.bbv) {
+    std::mt19937_64 rng(block.first);
+    const double w = static_cast<double>(block.second) / interval.instructions;
+    for (unsigned i = 0; i < s_projectedDims; ++i)
+      proj[i] += w * dist(rng);
+  }
+  return proj;
+}
+
+/// Clusters @p points into at most @p k clusters using k-means with k-means++
+/// initialization. Fewer clusters are formed if there are fewer than @p k
+/// distinct points. Returns the cluster index of each point.
+static std::vector<unsigned> kMeans(const std::vector<ProjectedBBV> &points,
+                                    unsigned k) {
+  std::mt19937 rng(0);
+  std::vector<ProjectedBBV> centroids;
+  centroids.push_back(points.at(rng() % points.size()));
+  while (centroids.size() < k) {
+    std::vector<double> d2(points.size());
+    for (unsigned p = 0; p < points.size(); ++p) {
+      d2[p] = std::numeric_limits<double>::max();
+      for (const auto &c : centroids)
+        d2[p] = std::min(d2[p], distance2(points[p], c));
+    }
+    // Every point coincides with a centroid; seeding further would pick from
+    // all-zero weights.
+    if (*std::max_element(d2.begin(), d2.end()) == 0)
+      break;
+    std::discrete_distribution<unsigned> pick(d2.begin(), d2.end());
+    centroids.push_back(points.at(pick(rng)));
+  }
+  k = centroids.size();
+
+  std::vector<unsigned> assignment(points.size(), 0);
+  for (unsigned it = 0; it < s_maxKMeansIterations; ++it) {
+    bool changed = false;
+    for (unsigned p = 0; p < points.size(); ++p) {
+      unsigned best = 0;
+      for (unsigned c = 1; c < k; ++c)
+        if (distance2(points[p], centroids[c]) <
+            distance2(points[p], centroids[best]))
+          best = c;
+      changed |= best != assignment[p];
+      assignment[p] = best;
+    }
+    if (!changed && it != 0)
+      break;
+
+    std::vector<ProjectedBBV> sums(k, ProjectedBBV{});
+    std::vector<unsigned> counts(k, 0);
+    for (unsigned p = 0; p < points.size(); ++p) {
+      for (unsigned i = 0; i < s_projectedDims; ++i)
+        sums[assignment[p]][i] += points[p][i];
+      counts[assignment[p]]++;
+    }
+    for (unsigned c = 0; c < k; ++c)
+      if (counts[c] != 0)
+        for (unsigned i = 0; i < s_projectedDims; ++i)
+          centroids[c][i] = sums[c][i] / counts[c];
+  }
+  return assignment;
+}
+
+// Executes the passes of runSimPoints, while the system calls of the
+// profiling pass are recorded.
+static QString runSimPointPasses(long long intervalSize, unsigned maxSimPoints,
+                                 SimPointResult &result) {
+  result = SimPointResult();
+  result.intervalSize = intervalSize;
+  if (intervalSize <= 0 || maxSimPoints == 0)
+    return "Invalid sampling parameters";
+
+  // Functional profiling pass. States are only captured for the simulation
+  // points, by a second pass once these are known. The later passes replay the
+  // system calls of the profiling pass, such that these neither read input
+  // again nor repeat output.
+  const ArchitecturalState startState =
+      ProcessorHandler::captureArchitecturalState();
+  std::vector<ProfiledInterval> intervals;
+  AInt blockStart = 0;
+  auto profile = [&](RipesProcessor &iss) {
+    if (result.totalInstructions % intervalSize == 0)
+      intervals.emplace_back();
+
+    // A new basic block starts at the target of any control flow transfer.
+    const AInt pc = iss.nextFetchedAddress();
+    const auto prev = iss.instrMemAccess();
+    if (result.totalInstructions == 0 || pc != prev.address + prev.bytes)
+      blockStart = pc;
+
+    auto &interval = intervals.back();
+    interval.bbv[blockStart]++;
+    interval.instructions++;
+    result.totalInstructions++;
+    return true;
+  };
+  bool finished;
+  QString err = ProcessorHandler::fastForward(
+      std::numeric_limits<long long>::max(), finished, profile);
+  if (!err.isEmpty())
+    return err;
+  if (intervals.empty())
+    return "Program did not execute any instructions";
+
+  // Cluster intervals and pick a representative interval for each cluster.
+  std::vector<ProjectedBBV> points;
+  for (const auto &interval : intervals)
+    points.push_back(project(interval));
+  const unsigned k =
+      std::min<unsigned>(maxSimPoints, static_cast<unsigned>(points.size()));
+  const auto assignment = kMeans(points, k);
+
+  for (unsigned c = 0; c < k; ++c) {
+    ProjectedBBV centroid{};
+    long long clusterInstructions = 0;
+    unsigned members = 0;
+    for (unsigned p = 0; p < points.size(); ++p) {
+      if (assignment[p] != c)
+        continue;
+      for (unsigned i = 0; i < s_projectedDims; ++i)
+        centroid[i] += points[p][i];
+      clusterInstructions += intervals[p].instructions;
+      members++;
+    }
+    if (members == 0)
+      continue;
+    for (auto &v : centroid)
+      v /= members;
+
+    long long closest = -1;
+    for (unsigned p = 0; p < points.size(); ++p) {
+      if (assignment[p] == c &&
+          (closest < 0 ||
+           distance2(points[p], centroid) <
+               distance2(points[closest], centroid)))
+        closest = p;
+    }
+    result.simPoints.push_back(
+        {closest,
+         static_cast<double>(clusterInstructions) / result.totalInstructions,
+         0, 0});
+  }
+  std::sort(result.simPoints.begin(), result.simPoints.end(),
+            [](const auto &a, const auto &b) {
+              return a.interval < b.interval;
+            });
+
+  // Second functional pass, capturing the state at the start of each
+  // simulation point, and the number of system calls executed before it. Its
+  // console output was already produced by the first pass.
+  auto *proc = ProcessorHandler::getProcessorNonConst();
+  proc->resetProcessor();
+  ProcessorHandler::applyArchitecturalState(startState);
+  ProcessorHandler::setSyscallReplay(ProcessorHandler::SyscallReplay::Replay);
+  std::vector<ArchitecturalState> states;
+  std::vector<size_t> syscalls;
+  long long executed = 0;
+  auto capture = [&](RipesProcessor &) {
+    if (executed ==
+        result.simPoints.at(states.size()).interval * intervalSize) {
+      states.push_back(ProcessorHandler::captureArchitecturalState());
+      syscalls.push_back(ProcessorHandler::syscallReplayPosition());
+    }
+    if (states.size() == result.simPoints.size())
+      return false;
+    executed++;
+    return true;
+  };
+  SystemIO::setOutputMuted(true);
+  err = ProcessorHandler::fastForward(std::numeric_limits<long long>::max(),
+                                      finished, capture);
+  SystemIO::setOutputMuted(false);
+  if (!err.isEmpty())
+    return err;
+  if (states.size() != result.simPoints.size())
+    return "Program did not reproduce its profiled execution";
+
+  // Detailed simulation of each simulation point. System calls which diverge
+  // from the recording are executed anew, with their output muted.
+  SystemIO::setOutputMuted(true);
+  for (unsigned i = 0; i < result.simPoints.size(); ++i) {
+    auto &sp = result.simPoints[i];
+    const auto &interval = intervals.at(sp.interval);
+    proc->resetProcessor();
+    ProcessorHandler::applyArchitecturalState(states[i]);
+    ProcessorHandler::setSyscallReplay(ProcessorHandler::SyscallReplay::Replay,
+                                       syscalls[i]);
+    const long long startCycles = proc->getCycleCount();
+    const long long startInstrs = proc->getInstructionsRetired();
+    while (!proc->finished() &&
+           proc->getInstructionsRetired() - startInstrs < interval.instructions)
+      proc->clock();
+    sp.cycles = proc->getCycleCount() - startCycles;
+    sp.instructions = proc->getInstructionsRetired() - startInstrs;
+  }
+  SystemIO::setOutputMuted(false);
+
+  result.valid = true;
+  return QString();
+}
+
+QString runSimPoints(long long intervalSize, unsigned maxSimPoints,
+                     SimPointResult &result) {
+  ProcessorHandler::setSyscallReplay(ProcessorHandler::SyscallReplay::Record);
+  const QString err = runSimPointPasses(intervalSize, maxSimPoints, result);
+  ProcessorHandler::setSyscallReplay(ProcessorHandler::SyscallReplay::Off);
+  return err;
+}
+
+} // namespace Ripes
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QString>
+#include <vector>
+
+namespace Ripes {
+
+/**
+ * @brief The SimPointResult struct
+ * Result of a sampled simulation. The program is divided into fixed-size
+ * intervals of instructions, of which a representative subset (the
+ * simulation points) is simulated in detail. The CPI of the full program is
+ * extrapolated from the weighted CPI of each simulation point.
+ */
+struct SimPointResult {
+  struct SimPoint {
+    // Index of the interval within the program.
+    long long interval;
+    // Fraction of the program's instructions represented by this interval.
+    double weight;
+    long long cycles;
+    long long instructions;
+  };
+
+  bool valid = false;
+  long long intervalSize = 0;
+  long long totalInstructions = 0;
+  std::vector<SimPoint> simPoints;
+
+  /// Weighted CPI across all simulation points.
+  double cpi() const;
+  /// Estimated cycle count of the full program.
+  long long estimatedCycles() const { return cpi() * totalInstructions; }
+};
+
+/**
+ * @brief runSimPoints
+ * Performs a sampled simulation of the currently loaded program. A functional
+ * pass profiles a basic block vector for every @p intervalSize instructions,
+ * after which intervals are clustered into at most @p maxSimPoints clusters.
+ * The interval closest to the centroid of each cluster is then simulated on
+ * the current processor, starting from the architectural state at the start of
+ * the interval, as captured by a second functional pass. Pipelines start out
+ * empty for each interval. System calls are only executed by the profiling
+ * pass; the later passes replay their recorded effects.
+ * Returns an error message on failure, or an empty string on success.
+ */
+QString runSimPoints(long long intervalSize, unsigned maxSimPoints,
+                     SimPointResult &result);
+
+} // namespace Ripes
@@ -0,0 +1,49 @@
+#include "stdinreader.h"
+
+#include "syscall/systemio.h"
+
+#include <QFile>
+
+#include <cstdio>
+#include <memory>
+
+namespace Ripes {
+
+QString StdinReader::start(const QString &path) {
+  if (m_started)
+    return QString();
+
+  auto file = std::make_unique<QFile>();
+  // Unbuffered, such that each line is forwarded as soon as the host has
+  // written it.
+  bool opened;
+  if (path.isEmpty()) {
+    opened = file->open(stdin, QIODevice::ReadOnly | QIODevice::Unbuffered,
+                        QFileDevice::DontCloseHandle);
+  } else {
+    file->setFileName(path);
+    opened = file->open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+  }
+  if (!opened)
+    return "Error: Could not open stdin file " + path;
+
+  m_started = true;
+  SystemIO::setStdInCapacity(c_capacity);
+  m_thread = std::thread([file = std::move(file)] {
+    for (;;) {
+      const QByteArray line = file->readLine(c_capacity);
+      if (line.isEmpty() || !SystemIO::writeStdIn(line))
+        break;
+    }
+    SystemIO::closeStdIn();
+  });
+  return QString();
+}
+
+StdinReader::~StdinReader() {
+  // The thread may be blocked reading the host stdin, and is not joined.
+  if (m_thread.joinable())
+    m_thread.detach();
+}
+
+} // namespace Ripes
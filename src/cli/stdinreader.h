@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QString>
+
+#include <thread>
+
+namespace Ripes {
+
+/**
+ * @brief The StdinReader class
+ * Streams the standard input of the host, or a file, into the stdin of
+ * simulated programs in CLI mode. Input is read line by line on a dedicated
+ * thread and pushed onto the (bounded) stdin buffer of SystemIO, such that a
+ * program blocking on stdin is woken as soon as a line is available, and
+ * reading never runs more than the buffer capacity ahead of the program.
+ * Once the input is exhausted, stdin is closed and reads return end-of-file.
+ */
+class StdinReader {
+public:
+  // The number of unread bytes which may be buffered ahead of the program.
+  static constexpr int c_capacity = 1 << 16;
+
+  static StdinReader &get() {
+    static StdinReader reader;
+    return reader;
+  }
+
+  /// Starts streaming the file at @p path, or the standard input of the host
+  /// if @p path is empty. Only the first call starts streaming. Returns an
+  /// error message on failure, or an empty string on success.
+  QString start(const QString &path);
+
+private:
+  StdinReader() = default;
+  ~StdinReader();
+
+  std::thread m_thread;
+  bool m_started = false;
+};
+
+} // namespace Ripes
@@ -0,0 +1,219 @@
+#include "steadystate.h"
+
+#include "processorhandler.h"
+#include "processorstate.h"
+
+#include <limits>
+#include <unordered_map>
+
+namespace Ripes {
+
+static constexpr uint64_t s_hashSeed = 0xcbf29ce484222325ULL;
+static constexpr uint64_t s_hashPrime = 0x100000001b3ULL;
+
+long long SteadyStateResult::extrapolatedCycles() const {
+  long long cycles = 0;
+  for (const auto &loop : loops)
+    cycles += loop.extrapolatedCycles;
+  return cycles;
+}
+
+long long SteadyStateResult::extrapolatedInstructions() const {
+  long long instructions = 0;
+  for (const auto &loop : loops)
+    instructions += loop.extrapolatedInstructions;
+  return instructions;
+}
+
+// Hashes the PC and state of each valid stage of a pipeline.
+static uint64_t hashPipeline(const std::vector<StageInfo> &infos) {
+  uint64_t hash = s_hashSeed;
+  for (const auto &info : infos) {
+    const uint64_t value =
+        info.stage_valid ? (static_cast<uint64_t>(info.pc) << 3) ^
+                               (static_cast<uint64_t>(info.state) + 1)
+                         : 0;
+    hash = (hash ^ value) * s_hashPrime;
+  }
+  return hash;
+}
+
+namespace {
+
+// A period of cycles which is expected to repeat.
+struct Candidate {
+  // Pipeline state at the boundaries of the period.
+  uint64_t pipeline = 0;
+  long long period = 0;
+  long long instructions = 0;
+  // Cycle and instructions retired at the start of the current period.
+  long long cycle = 0;
+  long long retired = 0;
+  // Hash over the pipeline states of each cycle of the last period.
+  uint64_t sequence = 0;
+  // Consecutive identical periods observed.
+  unsigned repeats = 0;
+};
+
+} // namespace
+
+QString runSteadyState(unsigned periods, unsigned maxPeriod,
+                       SteadyStateResult &result) {
+  result = SteadyStateResult();
+  if (periods < 2 || maxPeriod == 0)
+    return "Invalid steady-state parameters";
+  if (!ProcessorHandler::getProgram())
+    return "No program loaded";
+
+  auto *proc = ProcessorHandler::getProcessorNonConst();
+  std::vector<StageIndex> finalStages;
+  for (const auto &lane : proc->structure())
+    finalStages.push_back({lane.first, lane.second - 1});
+  std::vector<StageInfo> infos(proc->structure().numStages());
+
+  // Instructions in the final stages, which retire in the next cycle.
+  std::vector<AInt> committing;
+  auto sampleCommitting = [&] {
+    committing.clear();
+    for (const auto &stage : finalStages) {
+      const StageInfo info = proc->stageInfo(stage);
+      if (info.stage_valid && info.state == StageInfo::State::None)
+        committing.push_back(info.pc);
+    }
+  };
+
+  // Cycle and instructions retired when each pipeline state was last seen.
+  std::unordered_map<uint64_t, std::pair<long long, long long>> lastSeen;
+  Candidate candidate;
+  bool tracking = false;
+  uint64_t sequence = s_hashSeed;
+  // PCs of the instructions retired by the current and last period.
+  std::vector<AInt> periodPCs;
+  std::vector<AInt> steadyPCs;
+  // Cycles and instructions preceding the current detailed simulation.
+  long long baseCycles = 0;
+  long long baseInstructions = 0;
+  long long lastRetired = proc->getInstructionsRetired();
+  bool finishedFunctionally = false;
+  sampleCommitting();
+
+  while (!proc->finished()) {
+    proc->clock();
+    const long long cycle = proc->getCycleCount();
+    const long long retired = proc->getInstructionsRetired();
+    long long newlyRetired = retired - lastRetired;
+    lastRetired = retired;
+    if (tracking) {
+      for (const AInt pc : committing) {
+        if (newlyRetired-- <= 0)
+          break;
+        periodPCs.push_back(pc);
+      }
+    }
+    sampleCommitting();
+    proc->stageInfos(infos.data());
+    const uint64_t pipeline = hashPipeline(infos);
+
+    if (tracking) {
+      sequence = (sequence ^ pipeline) * s_hashPrime;
+      if (cycle - candidate.cycle == candidate.period) {
+        const bool repeated =
+            pipeline == candidate.pipeline &&
+            retired - candidate.retired == candidate.instructions &&
+            periodPCs.size() == static_cast<size_t>(candidate.instructions) &&
+            (candidate.repeats == 0 ||
+             (sequence == candidate.sequence && periodPCs == steadyPCs));
+        if (repeated) {
+          candidate.repeats++;
+          candidate.sequence = sequence;
+          candidate.cycle = cycle;
+          candidate.retired = retired;
+          steadyPCs.swap(periodPCs);
+        } else {
+          tracking = false;
+        }
+        periodPCs.clear();
+        sequence = s_hashSeed;
+      }
+    }
+
+    // Execution resumes from the oldest instruction in flight, which must be
+    // the first of the next period.
+    if (tracking && candidate.cycle == cycle && candidate.repeats >= periods &&
+        oldestInFlightPC(*proc) == steadyPCs.front()) {
+      tracking = false;
+      SteadyStateResult::Loop loop;
+      loop.pc = steadyPCs.front();
+      loop.period = candidate.period;
+      loop.instructions = candidate.instructions;
+
+      long long executed = 0;
+      ArchitecturalState resumeState;
+      auto follow = [&](RipesProcessor &iss) {
+        const AInt expected = steadyPCs[executed % steadyPCs.size()];
+        if (iss.nextFetchedAddress() != expected) {
+          // The ISS is the current processor while fast-forwarding.
+          resumeState = ProcessorHandler::captureArchitecturalState();
+          return false;
+        }
+        executed++;
+        return true;
+      };
+      bool finished = false;
+      const QString err = ProcessorHandler::fastForward(
+          std::numeric_limits<long long>::max(), finished, follow);
+      if (!err.isEmpty())
+        return err;
+
+      loop.extrapolatedInstructions = executed;
+      loop.extrapolatedCycles =
+          (executed * loop.period + loop.instructions / 2) / loop.instructions;
+      result.loops.push_back(loop);
+      baseCycles += cycle + loop.extrapolatedCycles;
+      baseInstructions += retired + loop.extrapolatedInstructions;
+      if (finished) {
+        finishedFunctionally = true;
+        break;
+      }
+
+      // Detailed simulation resumes with an empty pipeline.
+      proc->resetProcessor();
+      ProcessorHandler::applyArchitecturalState(resumeState);
+      lastSeen.clear();
+      lastRetired = proc->getInstructionsRetired();
+      sampleCommitting();
+      continue;
+    }
+
+    if (!tracking) {
+      const auto it = lastSeen.find(pipeline);
+      if (it != lastSeen.end() && cycle - it->second.first <= maxPeriod &&
+          retired > it->second.second) {
+        tracking = true;
+        candidate = Candidate();
+        candidate.pipeline = pipeline;
+        candidate.period = cycle - it->second.first;
+        candidate.instructions = retired - it->second.second;
+        candidate.cycle = cycle;
+        candidate.retired = retired;
+        periodPCs.clear();
+        sequence = s_hashSeed;
+      }
+    }
+    // States older than the longest period are of no use.
+    if (lastSeen.size() >= 4 * static_cast<size_t>(maxPeriod))
+      lastSeen.clear();
+    lastSeen[pipeline] = {cycle, retired};
+  }
+
+  result.cycles = baseCycles;
+  result.instructions = baseInstructions;
+  if (!finishedFunctionally) {
+    result.cycles += proc->getCycleCount();
+    result.instructions += proc->getInstructionsRetired();
+  }
+  result.valid = true;
+  return QString();
+}
+
+} // namespace Ripes
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "ripes_types.h"
+
+#include <QString>
+#include <vector>
+
+namespace Ripes {
+
+/**
+ * @brief The SteadyStateResult struct
+ * Result of a simulation accelerated by steady-state extrapolation. Loops
+ * which reach a repeating pipeline state are executed functionally, and their
+ * cycles are extrapolated from the period of the steady state.
+ */
+struct SteadyStateResult {
+  struct Loop {
+    // PC of the first instruction of a period of the steady state.
+    AInt pc;
+    // Cycles and instructions retired by a single period.
+    long long period;
+    long long instructions;
+    // Number of instructions executed functionally, and the cycles
+    // extrapolated for them.
+    long long extrapolatedInstructions;
+    long long extrapolatedCycles;
+  };
+
+  bool valid = false;
+  // Cycles and instructions of the full program, including those
+  // extrapolated.
+  long long cycles = 0;
+  long long instructions = 0;
+  std::vector<Loop> loops;
+
+  long long extrapolatedCycles() const;
+  long long extrapolatedInstructions() const;
+};
+
+/**
+ * @brief runSteadyState
+ * Simulates the currently loaded program on the current processor until it
+ * finishes, detecting when the pipeline reaches a steady state: a period of
+ * cycles which repeats @p periods times in a row, with the same sequence of
+ * pipeline states (the PC and state of each stage in each cycle), and the same
+ * sequence of retired instructions. The architectural state is then
+ * fast-forwarded functionally for as long as execution follows the sequence,
+ * each instruction taking the CPI of the steady state, after which detailed
+ * simulation resumes at the first diverging instruction with an empty
+ * pipeline. Periods span at most @p maxPeriod cycles.
+ * Returns an error message on failure, or an empty string on success.
+ */
+QString runSteadyState(unsigned periods, unsigned maxPeriod,
+                       SteadyStateResult &result);
+
+} // namespace Ripes
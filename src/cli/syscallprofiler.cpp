@@ -0,0 +1,132 @@
+#include "syscallprofiler.h"
+
+#include "processorhandler.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+SyscallProfiler::SyscallProfiler() {
+  connect(ProcessorHandler::get(), &ProcessorHandler::syscallExecuted, this,
+          [this](const SyscallRecord &r) { record(r); }, Qt::DirectConnection);
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorClocked, this,
+          [this] { processorClocked(); }, Qt::DirectConnection);
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          [this] { reset(); });
+}
+
+void SyscallProfiler::reset() {
+  m_entries.clear();
+  m_pendingDrainCycles = 0;
+}
+
+void SyscallProfiler::processorClocked() {
+  if (ProcessorHandler::getProcessor()->stallCause().cause ==
+      RipesProcessor::StallCause::EcallDrain)
+    m_pendingDrainCycles++;
+}
+
+void SyscallProfiler::record(const SyscallRecord &record) {
+  auto it = m_entries.find(record.id);
+  if (it == m_entries.end()) {
+    Entry entry;
+    entry.id = record.id;
+    if (record.syscall)
+      entry.name = record.syscall->name();
+    it = m_entries.emplace(record.id, entry).first;
+  }
+  Entry &entry = it->second;
+  entry.calls++;
+  entry.bytesRead += record.bytesRead;
+  entry.bytesWritten += record.bytesWritten;
+  entry.nanoseconds += record.nanoseconds;
+  entry.drainCycles += m_pendingDrainCycles;
+  m_pendingDrainCycles = 0;
+}
+
+std::vector<SyscallProfiler::Entry> SyscallProfiler::entries() const {
+  std::vector<Entry> entries;
+  for (const auto &it : m_entries)
+    entries.push_back(it.second);
+  std::stable_sort(entries.begin(), entries.end(),
+                   [](const Entry &lhs, const Entry &rhs) {
+                     return lhs.nanoseconds > rhs.nanoseconds;
+                   });
+  return entries;
+}
+
+SyscallProfiler::Entry SyscallProfiler::total() const {
+  Entry total;
+  for (const auto &it : m_entries) {
+    total.calls += it.second.calls;
+    total.bytesRead += it.second.bytesRead;
+    total.bytesWritten += it.second.bytesWritten;
+    total.nanoseconds += it.second.nanoseconds;
+    total.drainCycles += it.second.drainCycles;
+  }
+  return total;
+}
+
+SyscallLogWriter::~SyscallLogWriter() { close(); }
+
+QString SyscallLogWriter::open(const QString &path) {
+  close();
+  m_file.setFileName(path);
+  if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate |
+                   QIODevice::Text))
+    return "Error: Could not open syscall log file " + path;
+  m_records = 0;
+  m_writeFailed = false;
+
+  connect(
+      ProcessorHandler::get(), &ProcessorHandler::syscallExecuted, this,
+      [this](const SyscallRecord &record) {
+        const unsigned bits = ProcessorHandler::currentISA()->bits();
+        // Values are sign extended from the register width.
+        const auto value = [bits](VInt v) {
+          const unsigned shift = 64 - bits;
+          return static_cast<VIntS>(v << shift) >> shift;
+        };
+        QByteArray line = QByteArray::number(record.cycle) + ' ';
+        if (record.syscall) {
+          line += record.syscall->name().toUtf8() + '[' +
+                  QByteArray::number(record.id) + "](";
+          for (unsigned i = 0; i < record.args.size(); ++i) {
+            if (i > 0)
+              line += ", ";
+            line += "0x" + QByteArray::number(
+                               static_cast<qulonglong>(record.args[i]), 16);
+          }
+          line += ") = " + QByteArray::number(value(record.ret));
+        } else {
+          line += "?[" + QByteArray::number(record.id) + "]() = ?";
+        }
+        line += " read=" + QByteArray::number(record.bytesRead) +
+                " written=" + QByteArray::number(record.bytesWritten) + " <" +
+                QByteArray::number(record.nanoseconds / 1e9, 'f', 6) + ">\n";
+        write(line);
+        m_records++;
+      },
+      Qt::DirectConnection);
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          [this] { write("# reset\n"); });
+  return QString();
+}
+
+QString SyscallLogWriter::close() {
+  if (!m_file.isOpen())
+    return QString();
+
+  disconnect(ProcessorHandler::get(), nullptr, this, nullptr);
+  m_file.close();
+  if (m_writeFailed)
+    return "Error: Could not write syscall log file " + m_file.fileName();
+  return QString();
+}
+
+void SyscallLogWriter::write(const QByteArray &line) {
+  if (m_file.write(line) != line.size())
+    m_writeFailed = true;
+}
+
+} // namespace Ripes
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QFile>
+#include <QObject>
+#include <QString>
+
+#include <map>
+#include <vector>
+
+#include "syscall/ripes_syscall.h"
+
+namespace Ripes {
+
+/**
+ * @brief The SyscallProfiler class
+ * Accumulates, per syscall number, the number of calls, the bytes transferred
+ * between the memory of the processor and the host, and the host time spent
+ * handling the calls, as reported by ProcessorHandler::syscallExecuted(). The
+ * cycles which the pipeline spent draining its outstanding register writes
+ * before an ecall (see RipesProcessor::StallCause::EcallDrain) are charged to
+ * the syscall which the ecall called. The profile is cleared when the
+ * processor is reset.
+ */
+class SyscallProfiler : public QObject {
+public:
+  struct Entry {
+    SyscallManager::SyscallID id = 0;
+    // The name of the syscall, or an empty string if the syscall is unknown.
+    QString name;
+    unsigned long long calls = 0;
+    unsigned long long bytesRead = 0;
+    unsigned long long bytesWritten = 0;
+    long long nanoseconds = 0;
+    unsigned long long drainCycles = 0;
+  };
+
+  SyscallProfiler();
+
+  /// Returns the syscalls which were called, by descending host time.
+  std::vector<Entry> entries() const;
+
+  /// Returns the sum over all syscalls. The id and name of the returned entry
+  /// are unused.
+  Entry total() const;
+
+private:
+  void reset();
+  void record(const SyscallRecord &record);
+  void processorClocked();
+
+  std::map<SyscallManager::SyscallID, Entry> m_entries;
+  // Drain cycles of the ecall which has yet to be handled.
+  unsigned long long m_pendingDrainCycles = 0;
+};
+
+/**
+ * @brief The SyscallLogWriter class
+ * Streams a line per system call handled by the current processor to a text
+ * file, in the manner of strace:
+ *
+ *   <cycle> <name>[<id>](<a0>, <a1>, <a2>) = <ret> read=<bytes>
+ *   written=<bytes> <<host seconds>>
+ *
+ * Unknown syscalls are logged with the name "?" and no arguments. A line
+ * holding "# reset" is written whenever the processor is reset.
+ */
+class SyscallLogWriter : public QObject {
+public:
+  ~SyscallLogWriter() override;
+
+  /// Opens the file at @p path and starts logging the syscalls of the current
+  /// processor. Returns an error message on failure, or an empty string on
+  /// success.
+  QString open(const QString &path);
+  /// Stops logging and closes the file. Returns an error message if writing
+  /// the log failed, or an empty string on success.
+  QString close();
+
+  unsigned long long records() const { return m_records; }
+
+private:
+  void write(const QByteArray &line);
+
+  QFile m_file;
+  unsigned long long m_records = 0;
+  bool m_writeFailed = false;
+};
+
+} // namespace Ripes
@@ -1,12 +1,41 @@
 #pragma once
 
+#include <QElapsedTimer>
 #include <QTextStream>
 
+#include "branchprofiler.h"
+#include "callgraphprofiler.h"
+#include "coherence.h"
+#include "cachehierarchy.h"
+#include "cachesim/stackdistanceprofiler.h"
+#include "cachesweep.h"
+#include "cpistack.h"
+#include "hazardanalyzer.h"
+#include "hotspotprofiler.h"
+#include "ilpprofiler.h"
+#include "instructionmix.h"
+#include "pageprofiler.h"
 #include "pipelinediagrammodel.h"
 #include "processorhandler.h"
+#include "processors/componentprofiler.h"
+#include "processors/pagedaddressspace.h"
 #include "radix.h"
+#include "reportwriter.h"
+#include "reuseprofiler.h"
+#include "simpoint.h"
+#include "sourceprofiler.h"
+#include "stagestatisticsmodel.h"
+#include "steadystate.h"
+#include "syscallprofiler.h"
+#include "timeseries.h"
 
+#include <algorithm>
 #include <memory>
+#include <set>
+
+#ifndef Q_OS_WIN
+#include <sys/resource.h>
+#endif
 
 namespace Ripes {
 
@@ -20,6 +49,12 @@ public:
   // set, indicates that the output is intended for JSON export.
   virtual QVariant report(bool /*json*/) = 0;
 
+  // Writes the JSON report of this telemetry to 'writer'. Reports of many rows
+  // may write each row as it is built, rather than a single value.
+  virtual void stream(ReportWriter &writer) {
+    writer.value(prettyKey(), report(/*json=*/true));
+  }
+
   // Returns the name of this telemetry.
   virtual QString key() const = 0;
 
@@ -37,7 +72,27 @@ private:
   bool m_enabled = false;
 };
 
+// Cycles and instructions retired by the simulation, including those
+// extrapolated by steady-state acceleration.
+inline long long
+simulatedCycles(const std::shared_ptr<const SteadyStateResult> &steadyState) {
+  if (steadyState && steadyState->valid)
+    return steadyState->cycles;
+  return ProcessorHandler::getProcessor()->getCycleCount();
+}
+
+inline long long simulatedInstructions(
+    const std::shared_ptr<const SteadyStateResult> &steadyState) {
+  if (steadyState && steadyState->valid)
+    return steadyState->instructions;
+  return ProcessorHandler::getProcessor()->getInstructionsRetired();
+}
+
 class CPITelemetry : public Telemetry {
+public:
+  CPITelemetry(std::shared_ptr<const SimPointResult> simPoints,
+               std::shared_ptr<const SteadyStateResult> steadyState)
+      : m_simPoints(simPoints), m_steadyState(steadyState) {}
   QString key() const override { return "cpi"; }
   QString prettyKey() const override { return "CPI"; }
   QString description() const override {
@@ -45,47 +100,77 @@ class CPITelemetry : public Telemetry {
   }
 
   QVariant report(bool /*json*/) override {
-    const auto cycleCount = ProcessorHandler::getProcessor()->getCycleCount();
-    const auto instrsRetired =
-        ProcessorHandler::getProcessor()->getInstructionsRetired();
+    // For sampled simulations, the CPI is extrapolated from the simulation
+    // points.
+    if (m_simPoints && m_simPoints->valid)
+      return m_simPoints->cpi();
+
+    const auto cycleCount = simulatedCycles(m_steadyState);
+    const auto instrsRetired = simulatedInstructions(m_steadyState);
     const double cpi =
         static_cast<double>(cycleCount) / static_cast<double>(instrsRetired);
     return cpi;
   }
+
+private:
+  std::shared_ptr<const SimPointResult> m_simPoints;
+  std::shared_ptr<const SteadyStateResult> m_steadyState;
 };
 
 class IPCTelemetry : public Telemetry {
+public:
+  IPCTelemetry(std::shared_ptr<const SimPointResult> simPoints,
+               std::shared_ptr<const SteadyStateResult> steadyState)
+      : m_simPoints(simPoints), m_steadyState(steadyState) {}
   QString key() const override { return "ipc"; }
   QString prettyKey() const override { return "IPC"; }
   QString description() const override {
     return "instructions per cycle (IPC)";
   }
   QVariant report(bool /*json*/) override {
-    const auto cycleCount = ProcessorHandler::getProcessor()->getCycleCount();
-    const auto instrsRetired =
-        ProcessorHandler::getProcessor()->getInstructionsRetired();
+    if (m_simPoints && m_simPoints->valid)
+      return 1 / m_simPoints->cpi();
+
+    const auto cycleCount = simulatedCycles(m_steadyState);
+    const auto instrsRetired = simulatedInstructions(m_steadyState);
     const double cpi =
         static_cast<double>(cycleCount) / static_cast<double>(instrsRetired);
     const double ipc = 1 / cpi;
     return ipc;
   }
+
+private:
+  std::shared_ptr<const SimPointResult> m_simPoints;
+  std::shared_ptr<const SteadyStateResult> m_steadyState;
 };
 
 class CyclesTelemetry : public Telemetry {
+public:
+  CyclesTelemetry(std::shared_ptr<const SteadyStateResult> steadyState)
+      : m_steadyState(steadyState) {}
   QString key() const override { return "cycles"; }
   QString description() const override { return "cycles"; }
   QVariant report(bool /*json*/) override {
-    return ProcessorHandler::getProcessor()->getCycleCount();
+    return simulatedCycles(m_steadyState);
   }
+
+private:
+  std::shared_ptr<const SteadyStateResult> m_steadyState;
 };
 
 class InstrsRetiredTelemetry : public Telemetry {
+public:
+  InstrsRetiredTelemetry(std::shared_ptr<const SteadyStateResult> steadyState)
+      : m_steadyState(steadyState) {}
   QString key() const override { return "iret"; }
   QString prettyKey() const override { return "# instructions retired"; }
   QString description() const override { return "instructions retired"; }
   QVariant report(bool /*json*/) override {
-    return ProcessorHandler::getProcessor()->getInstructionsRetired();
+    return simulatedInstructions(m_steadyState);
   }
+
+private:
+  std::shared_ptr<const SteadyStateResult> m_steadyState;
 };
 
 class PipelineTelemetry : public Telemetry {
@@ -109,6 +194,109 @@ private:
   std::shared_ptr<PipelineDiagramModel> m_pipelineDiagramModel;
 };
 
+class StageTelemetry : public Telemetry {
+public:
+  void enable() override {
+    m_stageStatistics = std::make_shared<StageStatisticsModel>();
+    Telemetry::enable();
+  }
+
+  QString key() const override { return "stages"; }
+  QString prettyKey() const override { return "stage statistics"; }
+  QString description() const override {
+    return "per-stage active, stalled, flushed, way hazard and bubble cycles";
+  }
+  QVariant report(bool json) override {
+    QVariantMap m;
+    const auto *proc = ProcessorHandler::getProcessor();
+    const auto &stages = m_stageStatistics->stages();
+    for (size_t i = 0; i < stages.size(); ++i) {
+      const auto &counters = m_stageStatistics->counters().at(i);
+      QString name = proc->stageName(stages.at(i));
+      if (proc->structure().size() > 1)
+        name = QString::number(stages.at(i).lane()) + ":" + name;
+      // Prefix with the stage position to retain pipeline order.
+      name = QString::number(i) + " " + name;
+
+      QVariantMap c;
+      QStringList counterStrings;
+      for (int col = StageStatisticsModel::Active;
+           col < StageStatisticsModel::NColumns; ++col) {
+        const auto column = static_cast<StageStatisticsModel::Column>(col);
+        const QString columnName =
+            StageStatisticsModel::columnName(column).toLower();
+        if (json)
+          c[columnName] = counters[column];
+        else
+          counterStrings << columnName + " " +
+                                QString::number(counters[column]);
+      }
+      if (json)
+        m[name] = c;
+      else
+        m[name] = counterStrings.join(", ");
+    }
+    return m;
+  }
+
+private:
+  std::shared_ptr<StageStatisticsModel> m_stageStatistics;
+};
+
+class CPIStackTelemetry : public Telemetry {
+public:
+  void enable() override {
+    m_cpiStack = std::make_unique<CPIStack>();
+    Telemetry::enable();
+  }
+
+  QString key() const override { return "cpistack"; }
+  QString prettyKey() const override { return "CPI stack"; }
+  QString description() const override {
+    return "CPI stack: the cycles per instruction spent retiring instructions "
+           "and lost to each stall cause";
+  }
+  QVariant report(bool json) override {
+    using StallCause = CPIStack::StallCause;
+    const auto &stack = *m_cpiStack;
+    // Components are in cycles per retired instruction, such that they sum to
+    // the CPI.
+    const double scale =
+        stack.retired() == 0
+            ? 0.0
+            : 1.0 / (static_cast<double>(stack.retired()) * stack.issueWidth());
+
+    QVariantMap m;
+    m["cpi"] = stack.retired() == 0
+                   ? 0.0
+                   : static_cast<double>(stack.cycles()) / stack.retired();
+    m["base"] = stack.retired() == 0 ? 0.0 : 1.0 / stack.issueWidth();
+    for (unsigned i = 0; i < CPIStack::NCauses; ++i) {
+      const auto cause = static_cast<StallCause>(i);
+      m[CPIStack::causeName(cause)] = stack.lostSlots(cause) * scale;
+    }
+
+    const auto *isa = ProcessorHandler::currentISA();
+    QVariantMap regs;
+    QStringList regStrings;
+    for (const auto &it : stack.dataHazardSlots()) {
+      const QString name = it.first < 0 ? "unknown" : isa->regName(it.first);
+      if (json)
+        regs[name] = it.second * scale;
+      else
+        regStrings << name + " " + QString::number(it.second * scale);
+    }
+    if (json)
+      m["data hazard registers"] = regs;
+    else
+      m["data hazard registers"] = regStrings.join(", ");
+    return m;
+  }
+
+private:
+  std::unique_ptr<CPIStack> m_cpiStack;
+};
+
 class RegisterTelemetry : public Telemetry {
 public:
   QString key() const override { return "regs"; }
@@ -117,26 +305,1581 @@ public:
   QVariant report(bool json) override {
     QVariantMap registerMap;
     auto *isa = ProcessorHandler::currentISA();
+    const RegisterView values =
+        ProcessorHandler::getRegisterView(RegisterFileType::GPR);
+    // Floating-point registers are reported by their raw bits.
+    RegisterView fpValues;
+    const bool hasFP = ProcessorHandler::getProcessor()->registerFiles().count(
+        RegisterFileType::FPR);
+    if (hasFP)
+      fpValues = ProcessorHandler::getRegisterView(RegisterFileType::FPR);
+    const unsigned fpCnt = hasFP ? isa->fpRegCnt() : 0;
+    const unsigned fpBytes = isa->fpBits() / CHAR_BIT;
     if (json) {
-      for (unsigned i = 0; i < isa->regCnt(); i++) {
-        registerMap[isa->regName(i)] = QVariant::fromValue(
-            ProcessorHandler::getRegisterValue(RegisterFileType::GPR, i));
-      }
+      for (unsigned i = 0; i < isa->regCnt(); i++)
+        registerMap[isa->regName(i)] = QVariant::fromValue(values[i]);
+      for (unsigned i = 0; i < fpCnt; i++)
+        registerMap[isa->fpRegName(i)] = QVariant::fromValue(fpValues[i]);
       return registerMap;
     } else {
       QString outStr;
       QTextStream out(&outStr);
       for (unsigned i = 0; i < isa->regCnt(); i++) {
-        auto v = ProcessorHandler::getRegisterValue(RegisterFileType::GPR, i);
+        const VInt v = values[i];
         out << isa->regName(i) << ":\t"
             << encodeRadixValue(v, Radix::Signed, isa->bytes()) << "\t";
         out << "(" << encodeRadixValue(v, Radix::Hex, isa->bytes()) << ")\n";
       }
+      for (unsigned i = 0; i < fpCnt; i++) {
+        out << isa->fpRegName(i) << ":\t"
+            << encodeRadixValue(fpValues[i], Radix::Hex, fpBytes) << "\n";
+      }
       return outStr;
     }
   }
 };
 
+class SimPointTelemetry : public Telemetry {
+public:
+  SimPointTelemetry(std::shared_ptr<const SimPointResult> simPoints)
+      : m_simPoints(simPoints) {}
+  QString key() const override { return "simpoints"; }
+  QString prettyKey() const override { return "simulation points"; }
+  QString description() const override {
+    return "sampled simulation points (interval, weight, CPI)";
+  }
+  QVariant report(bool json) override {
+    QVariantMap m;
+    if (!m_simPoints->valid)
+      return m;
+
+    m["interval size"] = m_simPoints->intervalSize;
+    m["total instructions"] = m_simPoints->totalInstructions;
+    m["estimated cycles"] = m_simPoints->estimatedCycles();
+    QVariantList points;
+    QStringList pointStrings;
+    for (const auto &sp : m_simPoints->simPoints) {
+      const double cpi = static_cast<double>(sp.cycles) / sp.instructions;
+      if (json) {
+        QVariantMap p;
+        p["interval"] = sp.interval;
+        p["weight"] = sp.weight;
+        p["cpi"] = cpi;
+        points << p;
+      } else {
+        pointStrings << QString("#%1 (weight %2, CPI %3)")
+                            .arg(sp.interval)
+                            .arg(sp.weight)
+                            .arg(cpi);
+      }
+    }
+    if (json)
+      m["points"] = points;
+    else
+      m["points"] = pointStrings;
+    return m;
+  }
+
+private:
+  std::shared_ptr<const SimPointResult> m_simPoints;
+};
+
+class SteadyStateTelemetry : public Telemetry {
+public:
+  SteadyStateTelemetry(std::shared_ptr<const SteadyStateResult> steadyState)
+      : m_steadyState(steadyState) {}
+  QString key() const override { return "steadystates"; }
+  QString prettyKey() const override { return "steady states"; }
+  QString description() const override {
+    return "steady-state loops extrapolated by --steady-state (PC, period, "
+           "instructions)";
+  }
+  QVariant report(bool json) override {
+    QVariantMap m;
+    if (!m_steadyState->valid)
+      return m;
+
+    m["extrapolated cycles"] = m_steadyState->extrapolatedCycles();
+    m["extrapolated instructions"] = m_steadyState->extrapolatedInstructions();
+    QVariantList loops;
+    QStringList loopStrings;
+    for (const auto &loop : m_steadyState->loops) {
+      const QString pc = "0x" + QString::number(loop.pc, 16);
+      if (json) {
+        QVariantMap l;
+        l["pc"] = pc;
+        l["period"] = loop.period;
+        l["instructions"] = loop.instructions;
+        l["extrapolated instructions"] = loop.extrapolatedInstructions;
+        l["extrapolated cycles"] = loop.extrapolatedCycles;
+        loops << l;
+      } else {
+        loopStrings << QString("%1 (%2 cycles per %3 instructions, %4 "
+                               "instructions extrapolated)")
+                           .arg(pc)
+                           .arg(loop.period)
+                           .arg(loop.instructions)
+                           .arg(loop.extrapolatedInstructions);
+      }
+    }
+    if (json)
+      m["loops"] = loops;
+    else
+      m["loops"] = loopStrings;
+    return m;
+  }
+
+private:
+  std::shared_ptr<const SteadyStateResult> m_steadyState;
+};
+
+class CacheTelemetry : public Telemetry {
+public:
+  CacheTelemetry(std::shared_ptr<const CacheHierarchy> caches)
+      : m_caches(caches) {}
+  QString key() const override { return "cache"; }
+  QString prettyKey() const override { return "caches"; }
+  QString description() const override {
+    return "cache hierarchy statistics (per level, memory traffic, stall "
+           "cycle estimate)";
+  }
+  QVariant report(bool /*json*/) override {
+    QVariantMap m;
+    if (m_caches->levels().empty())
+      return m;
+    const long long cycles = ProcessorHandler::getProcessor()->getCycleCount();
+    m["levels"] = m_caches->report(cycles);
+    m["memory"] = m_caches->memoryReport(cycles);
+    m["estimated stall cycles"] = m_caches->estimatedStallCycles();
+    if (m_caches->hasFetchBuffer())
+      m["fetch buffer"] = m_caches->fetchBufferReport();
+    if (m_caches->hasTLB())
+      m["tlb"] = m_caches->tlbReport();
+    if (m_caches->hasStoreBuffer())
+      m["store buffer"] = m_caches->storeBufferReport();
+    if (m_caches->hasDRAM())
+      m["dram"] = m_caches->dramReport(cycles);
+    if (m_caches->timingEnabled())
+      m["stall cycles"] =
+          ProcessorHandler::getProcessor()->getMemoryStallCycles();
+    return m;
+  }
+
+private:
+  std::shared_ptr<const CacheHierarchy> m_caches;
+};
+
+class CoherenceTelemetry : public Telemetry {
+public:
+  CoherenceTelemetry(QCommandLineParser *parser) : m_parser(parser) {}
+  void enable() override {
+    // The configuration has been validated upon parsing.
+    CoherenceSim::Config config;
+    parseCoherenceConfig(m_parser->value("coherence-protocol"),
+                         m_parser->value("coherence-l1"),
+                         m_parser->value("coherence-l2"), config);
+    m_sim = std::make_unique<CoherenceSim>(config);
+    Telemetry::enable();
+  }
+
+  QString key() const override { return "coherence"; }
+  QString prettyKey() const override { return "cache coherence"; }
+  QString description() const override {
+    return "private L1 data caches per hart kept coherent over a shared L2 "
+           "cache (--coherence-protocol, --coherence-l1, --coherence-l2): "
+           "invalidations, coherence and false sharing misses per hart, and "
+           "the lines with the most coherence traffic (--coherence-top)";
+  }
+  QVariant report(bool json) override {
+    QVariantMap m;
+    if (ProcessorHandler::getProcessor()->hartQuantum() != 1) {
+      m["error"] = "Coherence simulation requires a hart quantum of 1 "
+                   "(--hart-quantum)";
+      return m;
+    }
+    const auto fields = [](const CoherenceSim::Stats &stats) {
+      QVariantMap e;
+      e["accesses"] = stats.accesses;
+      e["misses"] = stats.misses;
+      e["miss rate"] =
+          stats.accesses == 0
+              ? 0.0
+              : static_cast<double>(stats.misses) / stats.accesses;
+      e["coherence misses"] = stats.coherenceMisses;
+      e["false sharing misses"] = stats.falseSharingMisses;
+      e["invalidations"] = stats.invalidations;
+      e["upgrades"] = stats.upgrades;
+      e["silent upgrades"] = stats.silentUpgrades;
+      e["interventions"] = stats.interventions;
+      e["writebacks"] = stats.writebacks;
+      return e;
+    };
+    const auto toString = [](const QVariantMap &map) {
+      QStringList strings;
+      for (auto it = map.begin(); it != map.end(); ++it)
+        strings << it.key() + " " + it.value().toString();
+      return strings.join(", ");
+    };
+
+    m = fields(m_sim->total());
+    m["protocol"] = m_sim->config().protocol == CoherenceSim::Protocol::MESI
+                        ? "MESI"
+                        : "MSI";
+    m["l2 hits"] = m_sim->l2().getHits();
+    m["l2 misses"] = m_sim->l2().getMisses();
+
+    QVariantList harts;
+    QStringList hartStrings;
+    for (unsigned hart = 0; hart < m_sim->harts(); ++hart) {
+      QVariantMap e = fields(m_sim->hartStats(hart));
+      if (json) {
+        e["hart"] = hart;
+        harts << e;
+      } else {
+        hartStrings << "hart " + QString::number(hart) + ": " + toString(e);
+      }
+    }
+    if (json)
+      m["harts"] = harts;
+    else
+      m["harts"] = hartStrings;
+
+    // The count has been validated upon parsing.
+    const unsigned n = m_parser->value("coherence-top").toUInt();
+    const auto hartList = [](uint32_t mask) {
+      QStringList list;
+      for (unsigned hart = 0; mask != 0; ++hart, mask >>= 1) {
+        if (mask & 1)
+          list << QString::number(hart);
+      }
+      return list.join(",");
+    };
+    QVariantList lines;
+    QStringList lineStrings;
+    for (const auto &line : m_sim->worstLines(n)) {
+      const QString address =
+          "0x" + QString::number(line.address, 16).rightJustified(
+                     ProcessorHandler::currentISA()->bytes() * 2, '0');
+      const QString symbol = HotSpotProfiler::symbolize(line.address);
+      if (json) {
+        QVariantMap e;
+        e["address"] = address;
+        e["symbol"] = symbol;
+        e["invalidations"] = line.invalidations;
+        e["coherence misses"] = line.coherenceMisses;
+        e["false sharing misses"] = line.falseSharingMisses;
+        e["readers"] = hartList(line.readers);
+        e["writers"] = hartList(line.writers);
+        lines << e;
+      } else {
+        lineStrings << QString("%1 %2 (invalidations %3, coherence misses %4, "
+                               "false sharing misses %5, readers %6, "
+                               "writers %7)")
+                           .arg(address,
+                                symbol.isEmpty() ? "" : "<" + symbol + ">")
+                           .arg(line.invalidations)
+                           .arg(line.coherenceMisses)
+                           .arg(line.falseSharingMisses)
+                           .arg(hartList(line.readers))
+                           .arg(hartList(line.writers));
+      }
+    }
+    if (json)
+      m["lines"] = lines;
+    else
+      m["lines"] = lineStrings;
+    return m;
+  }
+
+private:
+  QCommandLineParser *m_parser = nullptr;
+  std::unique_ptr<CoherenceSim> m_sim;
+};
+
+class CacheSweepTelemetry : public Telemetry {
+public:
+  CacheSweepTelemetry(std::shared_ptr<const CacheSweepResult> sweep)
+      : m_sweep(sweep) {}
+  QString key() const override { return "cachesweep"; }
+  QString prettyKey() const override { return "cache sweep"; }
+  QString description() const override {
+    return "trace-driven cache sweep results (--cache-sweep)";
+  }
+  QVariant report(bool json) override {
+    QVariantMap m;
+    if (m_sweep->entries.empty())
+      return m;
+
+    m["trace accesses"] = QVariant::fromValue(m_sweep->traceEntries);
+    m["trace bytes"] = QVariant::fromValue(m_sweep->traceBytes);
+    QVariantList configs;
+    QStringList configStrings;
+    for (const auto &entry : m_sweep->entries) {
+      const QString stream =
+          entry.config.stream == MemoryAccessTrace::Stream::Instr ? "i" : "d";
+      const unsigned accesses = entry.hits + entry.misses;
+      const double hitRate =
+          accesses == 0 ? 0 : static_cast<double>(entry.hits) / accesses;
+      if (json) {
+        QVariantMap c;
+        c["stream"] = stream;
+        c["config"] = entry.config.spec;
+        c["hits"] = entry.hits;
+        c["misses"] = entry.misses;
+        c["writebacks"] = entry.writebacks;
+        c["victim hits"] = entry.victimHits;
+        c["hit rate"] = hitRate;
+        c["size (bits)"] = entry.sizeBits;
+        configs << c;
+      } else {
+        configStrings << QString("%1 %2 (hit rate %3, writebacks %4, %5 bits)")
+                             .arg(stream, entry.config.spec)
+                             .arg(hitRate)
+                             .arg(entry.writebacks)
+                             .arg(entry.sizeBits);
+      }
+    }
+    if (json)
+      m["configurations"] = configs;
+    else
+      m["configurations"] = configStrings;
+    return m;
+  }
+
+private:
+  std::shared_ptr<const CacheSweepResult> m_sweep;
+};
+
+class StackDistanceTelemetry : public Telemetry {
+public:
+  StackDistanceTelemetry(QCommandLineParser *parser) : m_parser(parser) {}
+  void enable() override {
+    // The block size has been validated as a power of two upon parsing.
+    const unsigned blockBytes = m_parser->value("stackdist-block").toUInt();
+    unsigned blockBits = 0;
+    while ((1u << blockBits) < blockBytes)
+      blockBits++;
+    const auto profile = [&](L1CacheShim::CacheType type) {
+      auto recorder =
+          std::make_shared<StackDistanceRecorder>(blockBits, nullptr);
+      auto shim = std::make_unique<L1CacheShim>(type, nullptr);
+      shim->setNextLevelCache(recorder);
+      m_recorders.push_back({std::move(shim), recorder});
+    };
+    profile(L1CacheShim::CacheType::InstrCache);
+    profile(L1CacheShim::CacheType::DataCache);
+    Telemetry::enable();
+  }
+
+  QString key() const override { return "stackdist"; }
+  QString prettyKey() const override { return "stack distance"; }
+  QString description() const override {
+    return "LRU miss rates of all L1 cache sizes and associativities, from "
+           "a single-pass stack distance profile (--stackdist-block)";
+  }
+  QVariant report(bool json) override {
+    QVariantMap m;
+    const QStringList streams = {"instr", "data"};
+    for (size_t i = 0; i < m_recorders.size(); ++i)
+      m[streams.at(i)] =
+          reportProfile(m_recorders.at(i).second->profiler(), json);
+    return m;
+  }
+
+private:
+  static QVariantMap reportProfile(const StackDistanceProfiler &profiler,
+                                   bool json) {
+    QVariantMap m;
+    const auto missRate = [&](unsigned long long misses) {
+      return profiler.accesses() == 0
+                 ? 0.0
+                 : static_cast<double>(misses) / profiler.accesses();
+    };
+    m["accesses"] = profiler.accesses();
+    m["block size"] = 1 << profiler.blockBits();
+
+    QVariantList fa;
+    QStringList faStrings;
+    for (unsigned bits = 0; bits <= profiler.maxCapacityBits(); ++bits) {
+      const double rate = missRate(profiler.fullyAssociativeMisses(bits));
+      if (json) {
+        QVariantMap c;
+        c["blocks"] = 1ull << bits;
+        c["miss rate"] = rate;
+        fa << c;
+      } else {
+        faStrings << QString("%1 blocks: %2").arg(1ull << bits).arg(rate);
+      }
+    }
+
+    QVariantList sa;
+    QStringList saStrings;
+    for (unsigned s = 0; s <= StackDistanceProfiler::s_maxSetBits; ++s) {
+      for (unsigned w = 0; w <= StackDistanceProfiler::s_maxWayBits; ++w) {
+        const double rate = missRate(profiler.misses(s, w));
+        if (json) {
+          QVariantMap c;
+          c["sets"] = 1 << s;
+          c["ways"] = 1 << w;
+          c["miss rate"] = rate;
+          sa << c;
+        } else {
+          saStrings << QString("%1 sets, %2 ways: %3")
+                           .arg(1 << s)
+                           .arg(1 << w)
+                           .arg(rate);
+        }
+      }
+    }
+    if (json) {
+      m["fully associative"] = fa;
+      m["set associative"] = sa;
+    } else {
+      m["fully associative"] = faStrings;
+      m["set associative"] = saStrings;
+    }
+    return m;
+  }
+
+  QCommandLineParser *m_parser = nullptr;
+  std::vector<std::pair<std::unique_ptr<L1CacheShim>,
+                        std::shared_ptr<StackDistanceRecorder>>>
+      m_recorders;
+};
+
+class FootprintTelemetry : public Telemetry {
+public:
+  FootprintTelemetry(QCommandLineParser *parser) : m_parser(parser) {}
+  void enable() override {
+    // The page size and interval have been validated upon parsing.
+    const unsigned pageBytes = m_parser->value("footprint-page").toUInt();
+    unsigned pageBits = 0;
+    while ((1u << pageBits) < pageBytes)
+      pageBits++;
+    m_profiler = std::make_unique<PageProfiler>(
+        pageBits, m_parser->value("footprint-interval").toUInt());
+    Telemetry::enable();
+  }
+
+  QString key() const override { return "footprint"; }
+  QString prettyKey() const override { return "memory footprint"; }
+  QString description() const override {
+    return "data memory footprint, working set size every "
+           "--footprint-interval cycles, and the reads and writes of the "
+           "most accessed pages (--footprint-page, --footprint-top)";
+  }
+  QVariant report(bool json) override {
+    m_profiler->finish();
+    const AInt pageBytes = m_profiler->pageBytes();
+    const unsigned addressDigits = ProcessorHandler::currentISA()->bytes() * 2;
+
+    QVariantMap m;
+    m["page size"] = static_cast<unsigned long long>(pageBytes);
+    m["footprint pages"] = m_profiler->footprint();
+    m["footprint bytes"] = m_profiler->footprint() * pageBytes;
+
+    unsigned long long peak = 0;
+    QVariantList samples;
+    QStringList sampleStrings;
+    for (const auto &sample : m_profiler->samples()) {
+      peak = std::max(peak, sample.pages);
+      if (json) {
+        QVariantMap s;
+        s["cycle"] = sample.cycle;
+        s["pages"] = sample.pages;
+        s["bytes"] = sample.pages * pageBytes;
+        samples << s;
+      } else {
+        sampleStrings << QString("cycle %1: %2 pages (%3 bytes)")
+                             .arg(sample.cycle)
+                             .arg(sample.pages)
+                             .arg(sample.pages * pageBytes);
+      }
+    }
+    m["peak working set pages"] = peak;
+
+    // The count has been validated upon parsing.
+    const unsigned n = m_parser->value("footprint-top").toUInt();
+    QVariantList pages;
+    QStringList pageStrings;
+    for (const auto &page : m_profiler->hottest(n)) {
+      const QString address =
+          "0x" + QString::number(page.page * pageBytes, 16)
+                     .rightJustified(addressDigits, '0');
+      if (json) {
+        QVariantMap p;
+        p["address"] = address;
+        p["reads"] = page.reads;
+        p["writes"] = page.writes;
+        pages << p;
+      } else {
+        pageStrings << QString("%1 (reads %2, writes %3)")
+                           .arg(address)
+                           .arg(page.reads)
+                           .arg(page.writes);
+      }
+    }
+    if (json) {
+      m["working set"] = samples;
+      m["hottest pages"] = pages;
+    } else {
+      m["working set"] = sampleStrings;
+      m["hottest pages"] = pageStrings;
+    }
+    return m;
+  }
+
+private:
+  QCommandLineParser *m_parser = nullptr;
+  std::unique_ptr<PageProfiler> m_profiler;
+};
+
+class MemoryTelemetry : public Telemetry {
+public:
+  QString key() const override { return "memory"; }
+  QString prettyKey() const override { return "simulated memory"; }
+  QString description() const override {
+    return "host memory backing the simulated memory: pages resident in host "
+           "memory, zero pages served without allocation, and pages mapped "
+           "by the program";
+  }
+  QVariant report(bool) override {
+    auto *paged =
+        dynamic_cast<PagedAddressSpaceMM *>(&ProcessorHandler::getMemory());
+    if (!paged)
+      return "unavailable for this processor";
+
+    constexpr AInt pageSize = PagedAddressSpaceMM::s_pageSize;
+    const auto resident = paged->materializedPages();
+    const auto zero = paged->zeroPages();
+    // Pages mapped by the program, and those touched during the run.
+    std::set<AInt> mapped(resident.begin(), resident.end());
+    mapped.insert(zero.begin(), zero.end());
+    if (auto program = ProcessorHandler::getProgram()) {
+      for (const auto &section : program->sections) {
+        const AInt size = section.second.data.size();
+        if (size == 0)
+          continue;
+        const AInt first = section.second.address / pageSize;
+        const AInt last = (section.second.address + size - 1) / pageSize;
+        for (AInt page = first; page <= last; ++page)
+          mapped.insert(page);
+      }
+    }
+
+    QVariantMap m;
+    const unsigned long long pageBytes = pageSize;
+    m["page size"] = pageBytes;
+    m["resident pages"] = static_cast<unsigned long long>(resident.size());
+    m["resident bytes"] = resident.size() * pageBytes;
+    m["zero pages"] = static_cast<unsigned long long>(zero.size());
+    m["mapped pages"] = static_cast<unsigned long long>(mapped.size());
+    m["mapped bytes"] = mapped.size() * pageBytes;
+    return m;
+  }
+};
+
+class ReuseTelemetry : public Telemetry {
+public:
+  ReuseTelemetry(QCommandLineParser *parser) : m_parser(parser) {}
+  void enable() override {
+    // The line size and capacity have been validated as powers of two upon
+    // parsing.
+    m_profiler = std::make_unique<ReuseProfiler>(
+        log2(m_parser->value("reuse-block").toUInt()));
+    Telemetry::enable();
+  }
+
+  QString key() const override { return "reuse"; }
+  QString prettyKey() const override { return "reuse distance"; }
+  QString description() const override {
+    return "reuse distance histograms of the loads and stores with the worst "
+           "locality for a cache of --reuse-capacity bytes (--reuse-block, "
+           "--reuse-top)";
+  }
+  QVariant report(bool json) override {
+    const unsigned lineBytes = 1u << m_profiler->lineBits();
+    const unsigned capacity = m_parser->value("reuse-capacity").toUInt();
+    const unsigned capacityLines = std::max(1u, capacity / lineBytes);
+    const unsigned capacityBits = log2(capacityLines);
+
+    QVariantMap m;
+    m["accesses"] = m_profiler->accesses();
+    m["line size"] = lineBytes;
+    m["capacity lines"] = capacityLines;
+
+    auto program = ProcessorHandler::getProgram();
+    const unsigned n = m_parser->value("reuse-top").toUInt();
+    QVariantList entries;
+    QStringList entryStrings;
+    for (const auto &entry : m_profiler->worst(n, capacityBits)) {
+      const QString address =
+          "0x" + QString::number(entry.pc, 16).rightJustified(
+                     ProcessorHandler::currentISA()->bytes() * 2, '0');
+      const QString symbol = HotSpotProfiler::symbolize(entry.pc);
+      const QString disassembly = ProcessorHandler::disassembleInstr(entry.pc);
+      QString line;
+      if (program && program->sourceLines) {
+        if (auto l = program->sourceLines->lookup(entry.pc))
+          line = program->sourceLines->file(l->file) + ":" +
+                 QString::number(l->line);
+      }
+      const unsigned long long misses = entry.misses(capacityBits);
+      const double missRate =
+          entry.accesses() == 0
+              ? 0.0
+              : static_cast<double>(misses) / entry.accesses();
+      const unsigned median = entry.medianBucket();
+      if (json) {
+        QVariantMap e;
+        e["address"] = address;
+        e["symbol"] = symbol;
+        e["instruction"] = disassembly;
+        e["line"] = line;
+        e["loads"] = entry.loads;
+        e["stores"] = entry.stores;
+        e["cold"] = entry.cold;
+        e["misses"] = misses;
+        e["miss rate"] = missRate;
+        // Bucket 0 counts distance 0, bucket b > 0 distances in
+        // [2^(b-1), 2^b); trailing empty buckets are omitted.
+        QVariantList histogram;
+        for (unsigned b = 0; b < entry.distances.size(); ++b)
+          histogram << entry.distances[b];
+        while (!histogram.isEmpty() && histogram.last().toULongLong() == 0)
+          histogram.removeLast();
+        e["histogram"] = histogram;
+        entries << e;
+      } else {
+        entryStrings
+            << QString("%1 %2 %3%4 (accesses %5, misses %6 (%7%), cold %8, "
+                       "median distance < %9 lines)")
+                   .arg(address, symbol.isEmpty() ? "" : "<" + symbol + ">",
+                        disassembly, line.isEmpty() ? "" : " at " + line)
+                   .arg(entry.accesses())
+                   .arg(misses)
+                   .arg(missRate * 100, 0, 'f', 1)
+                   .arg(entry.cold)
+                   .arg(1ull << median);
+      }
+    }
+    if (json)
+      m["worst"] = entries;
+    else
+      m["worst"] = entryStrings;
+    return m;
+  }
+
+private:
+  static unsigned log2(unsigned value) {
+    unsigned bits = 0;
+    while ((1u << bits) < value)
+      bits++;
+    return bits;
+  }
+
+  QCommandLineParser *m_parser = nullptr;
+  std::unique_ptr<ReuseProfiler> m_profiler;
+};
+
+class ProfileTelemetry : public Telemetry {
+public:
+  ProfileTelemetry(QCommandLineParser *parser) : m_parser(parser) {}
+  void enable() override {
+    m_profiler = std::make_unique<HotSpotProfiler>();
+    Telemetry::enable();
+  }
+
+  QString key() const override { return "profile"; }
+  QString prettyKey() const override { return "hot spots"; }
+  QString description() const override {
+    return "cycles and retired instructions of the hottest instructions "
+           "(--profile-top)";
+  }
+  QVariant report(bool json) override {
+    QVariantMap m;
+    const unsigned long long totalCycles = m_profiler->totalCycles();
+    m["cycles"] = totalCycles;
+    m["retired"] = m_profiler->totalRetired();
+
+    // The count has been validated upon parsing.
+    const unsigned n = m_parser->value("profile-top").toUInt();
+    QVariantList entries;
+    QStringList entryStrings;
+    for (const auto &entry : m_profiler->hottest(n)) {
+      const QString address =
+          "0x" + QString::number(entry.address, 16).rightJustified(
+                     ProcessorHandler::currentISA()->bytes() * 2, '0');
+      const QString symbol = HotSpotProfiler::symbolize(entry.address);
+      const QString disassembly =
+          ProcessorHandler::disassembleInstr(entry.address);
+      const double share =
+          totalCycles == 0 ? 0.0
+                           : static_cast<double>(entry.cycles) / totalCycles;
+      const double cpi =
+          entry.retired == 0
+              ? 0.0
+              : static_cast<double>(entry.cycles) / entry.retired;
+      if (json) {
+        QVariantMap e;
+        e["address"] = address;
+        e["symbol"] = symbol;
+        e["instruction"] = disassembly;
+        e["cycles"] = entry.cycles;
+        e["retired"] = entry.retired;
+        e["cycle share"] = share;
+        e["cpi"] = cpi;
+        entries << e;
+      } else {
+        entryStrings << QString("%1 %2 %3 (cycles %4 (%5%), retired %6, "
+                                "CPI %7)")
+                            .arg(address,
+                                 symbol.isEmpty() ? "" : "<" + symbol + ">",
+                                 disassembly)
+                            .arg(entry.cycles)
+                            .arg(share * 100, 0, 'f', 1)
+                            .arg(entry.retired)
+                            .arg(cpi);
+      }
+    }
+    if (json)
+      m["hottest"] = entries;
+    else
+      m["hottest"] = entryStrings;
+    return m;
+  }
+
+private:
+  QCommandLineParser *m_parser = nullptr;
+  std::unique_ptr<HotSpotProfiler> m_profiler;
+};
+
+class SourceLineTelemetry : public Telemetry {
+public:
+  SourceLineTelemetry(QCommandLineParser *parser,
+                      std::shared_ptr<const CacheHierarchy> caches)
+      : m_parser(parser), m_caches(caches) {}
+  void enable() override {
+    // The hierarchy is built after the telemetry is enabled; its L1 caches are
+    // looked up as misses are counted.
+    m_profiler = std::make_unique<SourceProfiler>(missCounter("L1I"),
+                                                  missCounter("L1D"));
+    Telemetry::enable();
+  }
+
+  QString key() const override { return "source-lines"; }
+  QString prettyKey() const override { return "source lines"; }
+  QString description() const override {
+    return "cycles, stall cycles and L1 cache misses of the hottest source "
+           "lines of the debug information of an ELF program "
+           "(--source-lines-top)";
+  }
+  QVariant report(bool json) override {
+    QVariantMap m;
+    const SourceProfiler::Counters &total = m_profiler->total();
+    m["cycles"] = total.cycles;
+    m["stalls"] = total.stalls;
+
+    auto program = ProcessorHandler::getProgram();
+    if (!program || !program->sourceLines) {
+      m["hottest"] = "No debug information";
+      return m;
+    }
+
+    // The count has been validated upon parsing.
+    const unsigned n = m_parser->value("source-lines-top").toUInt();
+    const auto lines = m_profiler->lines();
+    QVariantList entries;
+    QStringList entryStrings;
+    for (size_t i = 0; i < lines.size() && i < n; ++i) {
+      const SourceProfiler::Entry &entry = lines[i];
+      const SourceProfiler::Counters &c = entry.counters;
+      const QString location = program->sourceLines->file(entry.line.file) +
+                               ":" + QString::number(entry.line.line);
+      const double share =
+          total.cycles == 0 ? 0.0
+                            : static_cast<double>(c.cycles) / total.cycles;
+      if (json) {
+        QVariantMap e;
+        e["line"] = location;
+        e["cycles"] = c.cycles;
+        e["cycle share"] = share;
+        e["retired"] = c.retired;
+        e["stalls"] = c.stalls;
+        e["L1I misses"] = c.icacheMisses;
+        e["L1D misses"] = c.dcacheMisses;
+        entries << e;
+      } else {
+        entryStrings << QString("%1 (cycles %2 (%3%), retired %4, stalls %5, "
+                                "L1I misses %6, L1D misses %7)")
+                            .arg(location)
+                            .arg(c.cycles)
+                            .arg(share * 100, 0, 'f', 1)
+                            .arg(c.retired)
+                            .arg(c.stalls)
+                            .arg(c.icacheMisses)
+                            .arg(c.dcacheMisses);
+      }
+    }
+    if (json)
+      m["hottest"] = entries;
+    else
+      m["hottest"] = entryStrings;
+    return m;
+  }
+
+private:
+  SourceProfiler::MissCounter missCounter(const QString &level) const {
+    return [caches = m_caches, level]() -> unsigned long long {
+      for (const auto &l : caches->levels()) {
+        if (l.name == level)
+          return l.cache->getMisses();
+      }
+      return 0;
+    };
+  }
+
+  QCommandLineParser *m_parser = nullptr;
+  std::shared_ptr<const CacheHierarchy> m_caches;
+  std::unique_ptr<SourceProfiler> m_profiler;
+};
+
+class BranchTelemetry : public Telemetry {
+public:
+  BranchTelemetry(QCommandLineParser *parser) : m_parser(parser) {}
+  void enable() override {
+    m_profiler = std::make_unique<BranchProfiler>();
+    Telemetry::enable();
+  }
+
+  QString key() const override { return "branches"; }
+  QString prettyKey() const override { return "branch profile"; }
+  QString description() const override {
+    return "branch and jump counts, taken rates and flush cycles, and the "
+           "branches causing the most flush cycles (--branches-top)";
+  }
+  QVariant report(bool json) override {
+    QVariantMap m;
+    for (bool jumps : {false, true}) {
+      const auto total = m_profiler->total(jumps);
+      QVariantMap t;
+      t["executions"] = total.executions;
+      t["taken"] = total.taken;
+      t["taken rate"] = rate(total.taken, total.executions);
+      t["flush cycles"] = total.flushCycles;
+      // Taken branches are mispredicted by the not-taken fetch of the
+      // pipelined processors; this is the cost of each.
+      t["flush cycles per taken"] = rate(total.flushCycles, total.taken);
+      m[jumps ? "jumps" : "branches"] = json ? QVariant(t) : toString(t);
+    }
+
+    // The count has been validated upon parsing.
+    const unsigned n = m_parser->value("branches-top").toUInt();
+    QVariantList entries;
+    QStringList entryStrings;
+    for (const auto &entry : m_profiler->worst(n)) {
+      const QString address =
+          "0x" + QString::number(entry.address, 16).rightJustified(
+                     ProcessorHandler::currentISA()->bytes() * 2, '0');
+      const QString symbol = HotSpotProfiler::symbolize(entry.address);
+      const QString disassembly =
+          ProcessorHandler::disassembleInstr(entry.address);
+      if (json) {
+        QVariantMap e;
+        e["address"] = address;
+        e["symbol"] = symbol;
+        e["instruction"] = disassembly;
+        e["executions"] = entry.executions;
+        e["taken"] = entry.taken;
+        e["taken rate"] = rate(entry.taken, entry.executions);
+        e["flush cycles"] = entry.flushCycles;
+        entries << e;
+      } else {
+        entryStrings << QString("%1 %2 %3 (executions %4, taken %5 (%6%), "
+                                "flush cycles %7)")
+                            .arg(address,
+                                 symbol.isEmpty() ? "" : "<" + symbol + ">",
+                                 disassembly)
+                            .arg(entry.executions)
+                            .arg(entry.taken)
+                            .arg(rate(entry.taken, entry.executions) * 100, 0,
+                                 'f', 1)
+                            .arg(entry.flushCycles);
+      }
+    }
+    if (json)
+      m["worst"] = entries;
+    else
+      m["worst"] = entryStrings;
+
+    // Processors with a branch predictor report its accuracy.
+    if (const BranchPredictor *predictor =
+            ProcessorHandler::getProcessorNonConst()->branchPredictor()) {
+      const BranchPredictor::Stats &stats = predictor->stats();
+      QVariantMap p;
+      p["scheme"] = BranchPredictor::schemeName(predictor->config().scheme);
+      p["branch mispredictions"] = stats.branchMispredictions;
+      p["branch accuracy"] =
+          1.0 - rate(stats.branchMispredictions, stats.branches);
+      p["jump mispredictions"] = stats.jumpMispredictions;
+      p["jump accuracy"] = 1.0 - rate(stats.jumpMispredictions, stats.jumps);
+      m["predictor"] = json ? QVariant(p) : toString(p);
+    }
+    return m;
+  }
+
+private:
+  static double rate(unsigned long long n, unsigned long long d) {
+    return d == 0 ? 0.0 : static_cast<double>(n) / d;
+  }
+  static QString toString(const QVariantMap &map) {
+    QStringList strings;
+    for (auto it = map.begin(); it != map.end(); ++it)
+      strings << it.key() + " " + it.value().toString();
+    return strings.join(", ");
+  }
+
+  QCommandLineParser *m_parser = nullptr;
+  std::unique_ptr<BranchProfiler> m_profiler;
+};
+
+class HazardTelemetry : public Telemetry {
+public:
+  HazardTelemetry(QCommandLineParser *parser) : m_parser(parser) {}
+
+  QString key() const override { return "hazards"; }
+  QString prettyKey() const override { return "static hazard analysis"; }
+  QString description() const override {
+    return "pipeline hazard stalls and branch penalties of the program on the "
+           "processor, predicted per basic block without simulating, and the "
+           "blocks with the most stall cycles (--hazards-top)";
+  }
+  QVariant report(bool json) override {
+    QVariantMap m;
+    HazardAnalysis analysis;
+    const QString err = analyzeHazards(ProcessorHandler::getID(), analysis);
+    if (!err.isEmpty()) {
+      m["error"] = err;
+      return m;
+    }
+    m["processor"] = enumToString<ProcessorID>(analysis.processor);
+    m["blocks"] = static_cast<unsigned>(analysis.blocks.size());
+    m["hazards"] = static_cast<unsigned>(analysis.hazards.size());
+    m["stall cycles"] = analysis.stalls();
+    m["unresolved hazards"] = analysis.unresolved();
+
+    // The count has been validated upon parsing.
+    const unsigned n = m_parser->value("hazards-top").toUInt();
+    std::vector<const HazardBlock *> worst;
+    for (const auto &block : analysis.blocks) {
+      if (block.stalls != 0 || block.unresolved != 0)
+        worst.push_back(&block);
+    }
+    std::stable_sort(worst.begin(), worst.end(),
+                     [](const HazardBlock *a, const HazardBlock *b) {
+                       return a->stalls + a->unresolved >
+                              b->stalls + b->unresolved;
+                     });
+    if (worst.size() > n)
+      worst.resize(n);
+
+    QVariantList entries;
+    QStringList entryStrings;
+    for (const HazardBlock *block : worst) {
+      const QString address =
+          "0x" + QString::number(block->start, 16).rightJustified(
+                     ProcessorHandler::currentISA()->bytes() * 2, '0');
+      const QString symbol = HotSpotProfiler::symbolize(block->start);
+      QStringList hazards;
+      for (const auto &hazard : analysis.hazards) {
+        if (hazard.address >= block->start && hazard.address < block->end)
+          hazards << "0x" + QString::number(hazard.address, 16) + ": " +
+                         hazard.describe();
+      }
+      if (json) {
+        QVariantMap e;
+        e["address"] = address;
+        e["symbol"] = symbol;
+        e["instructions"] = block->instructions;
+        e["stall cycles"] = block->stalls;
+        e["unresolved hazards"] = block->unresolved;
+        e["taken penalty"] = block->takenPenalty;
+        e["estimated cycles"] = block->estimatedCycles;
+        e["hazards"] = hazards;
+        entries << e;
+      } else {
+        entryStrings << QString("%1 %2 (instructions %3, stall cycles %4, "
+                                "unresolved %5, taken penalty %6, estimated "
+                                "cycles %7): %8")
+                            .arg(address,
+                                 symbol.isEmpty() ? "" : "<" + symbol + ">")
+                            .arg(block->instructions)
+                            .arg(block->stalls)
+                            .arg(block->unresolved)
+                            .arg(block->takenPenalty)
+                            .arg(block->estimatedCycles)
+                            .arg(hazards.join("; "));
+      }
+    }
+    if (json)
+      m["worst"] = entries;
+    else
+      m["worst"] = entryStrings;
+    return m;
+  }
+
+private:
+  QCommandLineParser *m_parser = nullptr;
+};
+
+class CallGraphTelemetry : public Telemetry {
+public:
+  void enable() override {
+    m_profiler = std::make_unique<CallGraphProfiler>();
+    Telemetry::enable();
+  }
+  const CallGraphProfiler *profiler() const { return m_profiler.get(); }
+
+  QString key() const override { return "callgraph"; }
+  QString prettyKey() const override { return "call graph"; }
+  QString description() const override {
+    return "calls, exclusive and inclusive cycles of each function, and the "
+           "functions called by each function";
+  }
+  QVariant report(bool json) override {
+    const auto functions = m_profiler->functions();
+    const auto arcs = m_profiler->arcs();
+    const unsigned long long total = m_profiler->totalCycles();
+    const auto share = [&](unsigned long long cycles) {
+      return total == 0 ? 0.0 : static_cast<double>(cycles) / total;
+    };
+
+    // Functions are listed by decreasing inclusive cycles.
+    std::vector<unsigned> order;
+    for (unsigned i = 0; i < functions.size(); ++i) {
+      if (functions[i].inclusiveCycles != 0 || functions[i].selfCycles != 0)
+        order.push_back(i);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&](unsigned lhs, unsigned rhs) {
+                       return functions[lhs].inclusiveCycles >
+                              functions[rhs].inclusiveCycles;
+                     });
+
+    QVariantList entries;
+    QStringList entryStrings;
+    for (unsigned i : order) {
+      const auto &function = functions[i];
+      QVariantList callees;
+      QStringList calleeStrings;
+      for (auto it = arcs.lower_bound({i, 0});
+           it != arcs.end() && it->first.first == i; ++it) {
+        const QString &callee = functions[it->first.second].name;
+        if (json) {
+          QVariantMap c;
+          c["function"] = callee;
+          c["calls"] = it->second.calls;
+          c["cycles"] = it->second.cycles;
+          callees << c;
+        } else {
+          calleeStrings << QString("%1 (calls %2, cycles %3)")
+                               .arg(callee)
+                               .arg(it->second.calls)
+                               .arg(it->second.cycles);
+        }
+      }
+
+      if (json) {
+        QVariantMap e;
+        e["function"] = function.name;
+        e["calls"] = function.calls;
+        e["self cycles"] = function.selfCycles;
+        e["self share"] = share(function.selfCycles);
+        e["inclusive cycles"] = function.inclusiveCycles;
+        e["inclusive share"] = share(function.inclusiveCycles);
+        e["callees"] = callees;
+        entries << e;
+      } else {
+        QString entry =
+            QString("%1: calls %2, self %3 (%4%), inclusive %5 (%6%)")
+                .arg(function.name)
+                .arg(function.calls)
+                .arg(function.selfCycles)
+                .arg(share(function.selfCycles) * 100, 0, 'f', 1)
+                .arg(function.inclusiveCycles)
+                .arg(share(function.inclusiveCycles) * 100, 0, 'f', 1);
+        if (!calleeStrings.isEmpty())
+          entry += "; calls " + calleeStrings.join(", ");
+        entryStrings << entry;
+      }
+    }
+
+    QVariantMap m;
+    m["cycles"] = total;
+    if (json)
+      m["functions"] = entries;
+    else
+      m["functions"] = entryStrings;
+    return m;
+  }
+
+private:
+  std::unique_ptr<CallGraphProfiler> m_profiler;
+};
+
+class IlpTelemetry : public Telemetry {
+public:
+  IlpTelemetry(QCommandLineParser *parser) : m_parser(parser) {}
+  void enable() override {
+    // The window sizes have been validated upon parsing.
+    std::vector<unsigned> sizes;
+    IlpProfiler::parseWindowSizes(m_parser->value("ilp-windows"), sizes);
+    m_profiler = std::make_unique<IlpProfiler>(sizes);
+    Telemetry::enable();
+  }
+
+  QString key() const override { return "ilp"; }
+  QString prettyKey() const override { return "ILP limit study"; }
+  QString description() const override {
+    return "dataflow-limited instruction-level parallelism of the retired "
+           "instructions, for each window size of --ilp-windows and an "
+           "unbounded window, and its speedup bound over the simulated IPC";
+  }
+  QVariant report(bool json) override {
+    const unsigned long long instructions = m_profiler->instructions();
+    const double ipc =
+        m_profiler->cycles() == 0
+            ? 0.0
+            : static_cast<double>(instructions) / m_profiler->cycles();
+    QVariantMap m;
+    m["instructions"] = instructions;
+    m["memory dependencies"] = m_profiler->memoryDependencies();
+    m["simulated IPC"] = ipc;
+
+    QVariantList entries;
+    QStringList entryStrings;
+    for (const auto &window : m_profiler->windows()) {
+      const double ilp =
+          window.criticalPath == 0
+              ? 0.0
+              : static_cast<double>(instructions) / window.criticalPath;
+      const double speedup = ipc == 0.0 ? 0.0 : ilp / ipc;
+      const QString size =
+          window.size == 0 ? "unbounded" : QString::number(window.size);
+      if (json) {
+        QVariantMap e;
+        e["window"] = size;
+        e["critical path"] = window.criticalPath;
+        e["ilp"] = ilp;
+        e["speedup bound"] = speedup;
+        entries << e;
+      } else {
+        entryStrings << QString("window %1: critical path %2, ILP %3, "
+                                "speedup bound %4x")
+                            .arg(size)
+                            .arg(window.criticalPath)
+                            .arg(ilp, 0, 'f', 2)
+                            .arg(speedup, 0, 'f', 2);
+      }
+    }
+    if (json)
+      m["windows"] = entries;
+    else
+      m["windows"] = entryStrings;
+    return m;
+  }
+
+private:
+  QCommandLineParser *m_parser = nullptr;
+  std::unique_ptr<IlpProfiler> m_profiler;
+};
+
+class InstructionMixTelemetry : public Telemetry {
+public:
+  void enable() override {
+    m_mix = std::make_unique<InstructionMix>();
+    Telemetry::enable();
+  }
+
+  QString key() const override { return "imix"; }
+  QString prettyKey() const override { return "instruction mix"; }
+  QString description() const override {
+    return "retired instructions by opcode, by class and by encoding "
+           "(compressed or uncompressed)";
+  }
+  QVariant report(bool json) override {
+    const unsigned long long total = m_mix->total();
+    const auto entry = [&](unsigned long long count) -> QVariant {
+      const double share =
+          total == 0 ? 0.0 : static_cast<double>(count) / total;
+      if (json) {
+        QVariantMap e;
+        e["count"] = count;
+        e["share"] = share;
+        return e;
+      }
+      return QString("%1 (%2%)").arg(count).arg(share * 100, 0, 'f', 1);
+    };
+
+    QVariantMap m;
+    m["retired"] = total;
+
+    QVariantMap classes;
+    for (unsigned i = 0; i < InstructionMix::NClasses; ++i) {
+      const auto cls = static_cast<InstructionMix::Class>(i);
+      if (const auto count = m_mix->classCount(cls))
+        classes[InstructionMix::className(cls)] = entry(count);
+    }
+    m["classes"] = classes;
+
+    QVariantMap encodings;
+    encodings["compressed"] = entry(m_mix->compressed());
+    encodings["uncompressed"] = entry(m_mix->uncompressed());
+    m["encodings"] = encodings;
+
+    // Opcodes are listed by decreasing count.
+    std::vector<unsigned> opcodes;
+    for (unsigned op = 0; op < InstructionMix::NOpcodes; ++op) {
+      if (m_mix->opcodeCount(op) != 0)
+        opcodes.push_back(op);
+    }
+    std::stable_sort(opcodes.begin(), opcodes.end(),
+                     [&](unsigned lhs, unsigned rhs) {
+                       return m_mix->opcodeCount(lhs) >
+                              m_mix->opcodeCount(rhs);
+                     });
+    QVariantList opcodeEntries;
+    QStringList opcodeStrings;
+    for (unsigned op : opcodes) {
+      const QString name = InstructionMix::opcodeName(op);
+      if (json) {
+        QVariantMap e = entry(m_mix->opcodeCount(op)).toMap();
+        e["opcode"] = name;
+        opcodeEntries << e;
+      } else {
+        opcodeStrings << name + " " + entry(m_mix->opcodeCount(op)).toString();
+      }
+    }
+    if (json)
+      m["opcodes"] = opcodeEntries;
+    else
+      m["opcodes"] = opcodeStrings;
+    return m;
+  }
+
+private:
+  std::unique_ptr<InstructionMix> m_mix;
+};
+
+class TimeSeriesTelemetry : public Telemetry {
+public:
+  TimeSeriesTelemetry(QCommandLineParser *parser,
+                      std::shared_ptr<const CacheHierarchy> caches)
+      : m_parser(parser), m_caches(caches) {}
+  void enable() override {
+    // The interval has been validated upon parsing.
+    m_sampler = std::make_unique<TimeSeriesSampler>(
+        m_parser->value("sample-interval").toUInt(), m_caches);
+    Telemetry::enable();
+  }
+
+  QString key() const override { return "timeseries"; }
+  QString prettyKey() const override { return "time series"; }
+  QString description() const override {
+    return "CPI, IPC, memory stalls and cache hit rates sampled every "
+           "--sample-interval cycles";
+  }
+  QVariant report(bool json) override {
+    m_sampler->finish();
+    const auto &columns = m_sampler->columns();
+    if (json) {
+      QVariantList samples;
+      for (const auto &row : m_sampler->samples()) {
+        QVariantMap sample;
+        for (int i = 0; i < columns.size(); ++i)
+          sample[columns.at(i)] = row.at(i);
+        samples << sample;
+      }
+      return samples;
+    }
+
+    // CSV, one sample per line.
+    QStringList lines = {columns.join(",")};
+    for (const auto &row : m_sampler->samples()) {
+      QStringList values;
+      for (double value : row)
+        values << QString::number(value);
+      lines << values.join(",");
+    }
+    return lines.join("\n");
+  }
+  void stream(ReportWriter &writer) override {
+    m_sampler->finish();
+    const auto &columns = m_sampler->columns();
+    const auto &samples = m_sampler->samples();
+    if (samples.empty()) {
+      writer.value(prettyKey(), QVariantList());
+      return;
+    }
+    for (const auto &row : samples) {
+      QVariantMap sample;
+      for (int i = 0; i < columns.size(); ++i)
+        sample[columns.at(i)] = row.at(i);
+      writer.row(prettyKey(), sample);
+    }
+  }
+
+private:
+  QCommandLineParser *m_parser = nullptr;
+  std::shared_ptr<const CacheHierarchy> m_caches;
+  std::unique_ptr<TimeSeriesSampler> m_sampler;
+};
+
+class ComponentProfileTelemetry : public Telemetry {
+public:
+  void enable() override {
+    ComponentProfiler::setEnabled(true);
+    // Profile each program from its reset onwards.
+    m_context = std::make_unique<QObject>();
+    QObject::connect(ProcessorHandler::get(), &ProcessorHandler::processorReset,
+                     m_context.get(), [] { ComponentProfiler::clear(); });
+    Telemetry::enable();
+  }
+
+  QString key() const override { return "components"; }
+  QString prettyKey() const override { return "component profile"; }
+  QString description() const override {
+    return "evaluation counts and host time of each processor component, "
+           "ranked by time";
+  }
+  QVariant report(bool json) override {
+    const auto entries = ComponentProfiler::entries();
+    long long totalNs = 0;
+    for (const auto &entry : entries)
+      totalNs += entry.nanoseconds;
+
+    QVariantList list;
+    QStringList strings;
+    for (const auto &entry : entries) {
+      const QString name = QString::fromStdString(entry.name);
+      const double share =
+          totalNs == 0 ? 0.0 : static_cast<double>(entry.nanoseconds) / totalNs;
+      if (json) {
+        QVariantMap e;
+        e["component"] = name;
+        e["evaluations"] = entry.evaluations;
+        e["time (ns)"] = entry.nanoseconds;
+        e["time share"] = share;
+        list << e;
+      } else {
+        strings << QString("%1 (evaluations %2, %3 us (%4%))")
+                       .arg(name)
+                       .arg(entry.evaluations)
+                       .arg(entry.nanoseconds / 1000)
+                       .arg(share * 100, 0, 'f', 1);
+      }
+    }
+    if (json)
+      return list;
+    return strings;
+  }
+
+private:
+  std::unique_ptr<QObject> m_context;
+};
+
+class SimPerfTelemetry : public Telemetry {
+public:
+  void enable() override {
+    // Measure from the reset which precedes simulating each program.
+    m_context = std::make_unique<QObject>();
+    QObject::connect(ProcessorHandler::get(), &ProcessorHandler::processorReset,
+                     m_context.get(), [this] { start(); });
+    start();
+    Telemetry::enable();
+  }
+
+  QString key() const override { return "simperf"; }
+  QString prettyKey() const override { return "simulator performance"; }
+  QString description() const override {
+    return "simulator performance (wall time, simulated cycles and retired "
+           "instructions per second, peak RSS, system call time)";
+  }
+  QVariant report(bool /*json*/) override {
+    const auto *proc = ProcessorHandler::getProcessor();
+    const double wallSeconds = m_timer.nsecsElapsed() / 1e9;
+    const double syscallSeconds =
+        (ProcessorHandler::getSyscallNanoseconds() - m_startSyscallNs) / 1e9;
+    const auto perSecond = [&](double n) {
+      return wallSeconds == 0 ? 0.0 : n / wallSeconds;
+    };
+
+    QVariantMap m;
+    m["wall time (s)"] = wallSeconds;
+    m["cycles per second"] = perSecond(proc->getCycleCount());
+    m["instructions per second"] = perSecond(proc->getInstructionsRetired());
+    m["syscalls"] = ProcessorHandler::getSyscallCount() - m_startSyscallCount;
+    m["syscall time (s)"] = syscallSeconds;
+    m["clocking time (s)"] = wallSeconds - syscallSeconds;
+    const long long rss = peakRSSBytes();
+    if (rss >= 0)
+      m["peak RSS (bytes)"] = rss;
+    return m;
+  }
+
+private:
+  void start() {
+    m_timer.start();
+    m_startSyscallNs = ProcessorHandler::getSyscallNanoseconds();
+    m_startSyscallCount = ProcessorHandler::getSyscallCount();
+  }
+
+  // Returns the peak resident set size of this process, or -1 if unknown.
+  static long long peakRSSBytes() {
+#ifdef Q_OS_WIN
+    return -1;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+      return -1;
+#ifdef Q_OS_MAC
+    return usage.ru_maxrss;
+#else
+    // Reported in kilobytes on Linux.
+    return static_cast<long long>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+  }
+
+  std::unique_ptr<QObject> m_context;
+  QElapsedTimer m_timer;
+  long long m_startSyscallNs = 0;
+  unsigned long long m_startSyscallCount = 0;
+};
+
+class SyscallTelemetry : public Telemetry {
+public:
+  void enable() override {
+    m_profiler = std::make_unique<SyscallProfiler>();
+    Telemetry::enable();
+  }
+
+  QString key() const override { return "syscalls"; }
+  QString prettyKey() const override { return "system calls"; }
+  QString description() const override {
+    return "system calls by number (calls, bytes transferred to and from "
+           "memory, host time, ecall drain cycles)";
+  }
+  QVariant report(bool json) override {
+    const auto fields = [&](const SyscallProfiler::Entry &entry) {
+      QVariantMap e;
+      e["calls"] = entry.calls;
+      e["bytes read"] = entry.bytesRead;
+      e["bytes written"] = entry.bytesWritten;
+      e["host time (s)"] = entry.nanoseconds / 1e9;
+      e["ecall drain cycles"] = entry.drainCycles;
+      return e;
+    };
+
+    QVariantMap m = fields(m_profiler->total());
+    QVariantList entries;
+    QStringList entryStrings;
+    for (const auto &entry : m_profiler->entries()) {
+      const QString name = entry.name.isEmpty() ? "unknown" : entry.name;
+      if (json) {
+        QVariantMap e = fields(entry);
+        e["id"] = entry.id;
+        e["name"] = name;
+        entries << e;
+      } else {
+        entryStrings << QString("%1 (%2): calls %3, read %4 B, written %5 B, "
+                                "host time %6 s, ecall drain %7 cycles")
+                            .arg(name)
+                            .arg(entry.id)
+                            .arg(entry.calls)
+                            .arg(entry.bytesRead)
+                            .arg(entry.bytesWritten)
+                            .arg(entry.nanoseconds / 1e9)
+                            .arg(entry.drainCycles);
+      }
+    }
+    if (json)
+      m["syscalls"] = entries;
+    else
+      m["syscalls"] = entryStrings;
+    return m;
+  }
+
+private:
+  std::unique_ptr<SyscallProfiler> m_profiler;
+};
+
+class AtomicTelemetry : public Telemetry {
+public:
+  QString key() const override { return "atomics"; }
+  QString prettyKey() const override { return "atomic instructions"; }
+  QString description() const override {
+    return "LR/SC and AMO counts, SC failure rate and reservations lost to "
+           "other harts, in total and per hart (A extension)";
+  }
+  QVariant report(bool json) override {
+    const auto *proc = ProcessorHandler::getProcessor();
+    const ReservationTable *reservations = proc->reservations();
+    QVariantMap m;
+    if (!reservations)
+      return m;
+
+    const auto fields = [](const ReservationTable::Stats &stats) {
+      QVariantMap e;
+      e["lr"] = stats.loadReserved;
+      e["sc"] = stats.storeConditional;
+      e["sc failures"] = stats.storeConditionalFailures;
+      e["sc failure rate"] =
+          stats.storeConditional == 0
+              ? 0.0
+              : static_cast<double>(stats.storeConditionalFailures) /
+                    stats.storeConditional;
+      e["amo"] = stats.amos;
+      e["reservations lost"] = stats.invalidations;
+      return e;
+    };
+
+    ReservationTable::Stats total;
+    QVariantList harts;
+    QStringList hartStrings;
+    for (unsigned hart = 0; hart < proc->hartCount(); ++hart) {
+      const ReservationTable::Stats stats = reservations->stats(hart);
+      total.loadReserved += stats.loadReserved;
+      total.storeConditional += stats.storeConditional;
+      total.storeConditionalFailures += stats.storeConditionalFailures;
+      total.amos += stats.amos;
+      total.invalidations += stats.invalidations;
+      QVariantMap e = fields(stats);
+      if (json) {
+        e["hart"] = hart;
+        harts << e;
+      } else {
+        hartStrings << QString("hart %1: lr %2, sc %3, sc failures %4 (%5%), "
+                               "amo %6, reservations lost %7")
+                           .arg(hart)
+                           .arg(stats.loadReserved)
+                           .arg(stats.storeConditional)
+                           .arg(stats.storeConditionalFailures)
+                           .arg(e["sc failure rate"].toDouble() * 100, 0, 'f',
+                                1)
+                           .arg(stats.amos)
+                           .arg(stats.invalidations);
+      }
+    }
+    m = fields(total);
+    if (json)
+      m["harts"] = harts;
+    else
+      m["harts"] = hartStrings;
+    return m;
+  }
+};
+
 class RunInfoTelemetry : public Telemetry {
 public:
   RunInfoTelemetry(QCommandLineParser *parser) {
@@ -0,0 +1,70 @@
+#include "textdecoder.h"
+
+#include "processorhandler.h"
+#include "processors/RISC-V/rv_decode.h"
+#include "processors/RISC-V/rv_uncompress.h"
+
+namespace Ripes {
+
+namespace {
+template <unsigned XLEN>
+DecodedText::Instr decodeInstr(uint32_t word, bool compressed,
+                               const ISAInfoBase *isa) {
+  const VSRTL_VT_U instr =
+      compressed ? vsrtl::core::Uncompress<XLEN>::uncompress(word & 0xFFFF, isa)
+                 : word;
+  DecodedText::Instr decoded;
+  decoded.opcode = vsrtl::core::Decode<XLEN>::decodeOpcode(instr, isa);
+  decoded.rd = (instr >> 7) & 0b11111;
+  decoded.rs1 = (instr >> 15) & 0b11111;
+  decoded.rs2 = (instr >> 20) & 0b11111;
+  decoded.compressed = compressed;
+  const uint32_t bits = static_cast<uint32_t>(instr);
+  if (decoded.opcode == RVInstr::JAL) {
+    const uint32_t imm = ((bits >> 31) & 0x1) << 20 |
+                         ((bits >> 12) & 0xFF) << 12 |
+                         ((bits >> 20) & 0x1) << 11 |
+                         ((bits >> 21) & 0x3FF) << 1;
+    decoded.offset = static_cast<int32_t>(imm << 11) >> 11;
+  } else if (decoded.opcode >= RVInstr::BEQ &&
+             decoded.opcode <= RVInstr::BGEU) {
+    const uint32_t imm = ((bits >> 31) & 0x1) << 12 |
+                         ((bits >> 7) & 0x1) << 11 |
+                         ((bits >> 25) & 0x3F) << 5 |
+                         ((bits >> 8) & 0xF) << 1;
+    decoded.offset = static_cast<int32_t>(imm << 19) >> 19;
+  }
+  return decoded;
+}
+} // namespace
+
+DecodedText DecodedText::decode() {
+  DecodedText text;
+  const auto *isa = ProcessorHandler::currentISA();
+  const bool hasC = isa->extensionEnabled('C');
+  text.granule = hasC ? 2 : isa->instrBytes();
+  auto program = ProcessorHandler::getProgram();
+  if (!program)
+    return text;
+  const auto *section = program->getSection(TEXT_SECTION_NAME);
+  if (!section)
+    return text;
+
+  text.start = section->address;
+  const QByteArray &data = section->data;
+  text.instrs.resize(data.size() / text.granule);
+  for (size_t i = 0; i < text.instrs.size(); ++i) {
+    const int offset = i * text.granule;
+    // Read up to 4 bytes; a compressed instruction may end the section.
+    uint32_t word = 0;
+    for (int b = 0; b < 4 && offset + b < data.size(); ++b)
+      word |= static_cast<uint32_t>(static_cast<uint8_t>(data[offset + b]))
+              << (b * 8);
+    const bool compressed = hasC && (word & 0b11) != 0b11 && word != 0;
+    text.instrs[i] = isa->bits() == 64 ? decodeInstr<64>(word, compressed, isa)
+                                       : decodeInstr<32>(word, compressed, isa);
+  }
+  return text;
+}
+
+} // namespace Ripes
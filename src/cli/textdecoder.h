@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+
+#include "processors/RISC-V/riscv.h"
+#include "processors/interface/ripesprocessor.h"
+
+namespace Ripes {
+
+/**
+ * @brief The DecodedText struct
+ * The instructions of the text section of the current program, decoded ahead
+ * of simulation into a flat array holding an entry for each instruction
+ * granule: 2 bytes if the C extension is enabled, else the instruction width.
+ * Compressed instructions are decoded from their uncompressed equivalent.
+ * Entries at granules which do not begin an instruction hold whatever the
+ * bytes decode to.
+ */
+struct DecodedText {
+  struct Instr {
+    uint8_t opcode = RVInstr::NOP;
+    uint8_t rd = 0;
+    uint8_t rs1 = 0;
+    uint8_t rs2 = 0;
+    bool compressed = false;
+    // Offset of the target of branches and jal instructions, relative to the
+    // instruction.
+    int32_t offset = 0;
+  };
+
+  AInt start = 0;
+  unsigned granule = 4;
+  std::vector<Instr> instrs;
+
+  /// Returns the index of the instruction at @p pc, or -1 if @p pc is outside
+  /// of the text section.
+  long index(AInt pc) const {
+    if (pc < start)
+      return -1;
+    const AInt idx = (pc - start) / granule;
+    return idx < instrs.size() ? static_cast<long>(idx) : -1;
+  }
+  AInt address(size_t index) const { return start + index * granule; }
+
+  /// Decodes the text section of the current program, for the current ISA.
+  static DecodedText decode();
+};
+
+} // namespace Ripes
@@ -0,0 +1,97 @@
+#include "timeseries.h"
+
+#include "cachehierarchy.h"
+#include "processorhandler.h"
+
+namespace Ripes {
+
+TimeSeriesSampler::TimeSeriesSampler(
+    unsigned interval, std::shared_ptr<const CacheHierarchy> caches)
+    : m_interval(interval), m_caches(caches) {
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorClocked, this,
+          [this] { processorClocked(); }, Qt::DirectConnection);
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          [this] { reset(); });
+  reset();
+}
+
+void TimeSeriesSampler::addCounter(const QString &name, Counter counter) {
+  m_customCounters.push_back({name, counter});
+}
+
+void TimeSeriesSampler::reset() {
+  m_columns = QStringList{"cycle", "retired", "cpi", "ipc", "memory stalls"};
+  if (m_caches) {
+    for (const auto &level : m_caches->levels())
+      m_columns << level.name + " hit rate";
+  }
+  for (const auto &counter : m_customCounters)
+    m_columns << counter.first;
+  m_samples.clear();
+
+  const auto *proc = ProcessorHandler::getProcessor();
+  m_lastCycles = proc->getCycleCount();
+  m_lastRetired = proc->getInstructionsRetired();
+  m_lastStallCycles = proc->getMemoryStallCycles();
+  m_lastCacheStats.clear();
+  if (m_caches) {
+    for (const auto &level : m_caches->levels())
+      m_lastCacheStats.push_back(
+          {level.cache->getHits(), level.cache->getMisses()});
+  }
+  m_lastCustom.clear();
+  for (const auto &counter : m_customCounters)
+    m_lastCustom.push_back(counter.second());
+}
+
+void TimeSeriesSampler::processorClocked() {
+  const long long cycles = ProcessorHandler::getProcessor()->getCycleCount();
+  if (cycles - m_lastCycles >= static_cast<long long>(m_interval))
+    sample();
+}
+
+void TimeSeriesSampler::finish() {
+  if (ProcessorHandler::getProcessor()->getCycleCount() > m_lastCycles)
+    sample();
+}
+
+void TimeSeriesSampler::sample() {
+  const auto *proc = ProcessorHandler::getProcessor();
+  const long long cycles = proc->getCycleCount();
+  const long long retired = proc->getInstructionsRetired();
+  const long long stallCycles = proc->getMemoryStallCycles();
+  const double intervalCycles = cycles - m_lastCycles;
+  const double intervalRetired = retired - m_lastRetired;
+
+  std::vector<double> row;
+  row.reserve(m_columns.size());
+  row.push_back(cycles);
+  row.push_back(retired);
+  row.push_back(intervalRetired == 0 ? 0.0 : intervalCycles / intervalRetired);
+  row.push_back(intervalCycles == 0 ? 0.0 : intervalRetired / intervalCycles);
+  row.push_back(stallCycles - m_lastStallCycles);
+  if (m_caches) {
+    const auto &levels = m_caches->levels();
+    for (size_t i = 0; i < levels.size(); ++i) {
+      const unsigned hits = levels[i].cache->getHits();
+      const unsigned misses = levels[i].cache->getMisses();
+      const double intervalHits = hits - m_lastCacheStats[i].first;
+      const double accesses =
+          intervalHits + (misses - m_lastCacheStats[i].second);
+      row.push_back(accesses == 0 ? 0.0 : intervalHits / accesses);
+      m_lastCacheStats[i] = {hits, misses};
+    }
+  }
+  for (size_t i = 0; i < m_customCounters.size(); ++i) {
+    const double value = m_customCounters[i].second();
+    row.push_back(value - m_lastCustom[i]);
+    m_lastCustom[i] = value;
+  }
+  m_samples.push_back(std::move(row));
+
+  m_lastCycles = cycles;
+  m_lastRetired = retired;
+  m_lastStallCycles = stallCycles;
+}
+
+} // namespace Ripes
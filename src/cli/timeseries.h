@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QObject>
+#include <QStringList>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Ripes {
+
+class CacheHierarchy;
+
+/**
+ * @brief The TimeSeriesSampler class
+ * Snapshots a set of counters of the current processor every N cycles during
+ * simulation. Each sample holds the cycle count, the instructions retired, and
+ * the CPI, IPC, memory stall cycles and cache hit rates of the preceding
+ * interval, followed by the interval deltas of any counters registered through
+ * addCounter(). Samples are cleared when the processor is reset.
+ */
+class TimeSeriesSampler : public QObject {
+public:
+  /// A cumulative counter; samples hold its change over each interval.
+  using Counter = std::function<double()>;
+
+  TimeSeriesSampler(unsigned interval,
+                    std::shared_ptr<const CacheHierarchy> caches);
+
+  /// Registers a custom counter, sampled as column @p name. Takes effect upon
+  /// the next processor reset.
+  void addCounter(const QString &name, Counter counter);
+
+  /// Records the final, partial interval if any cycles elapsed since the last
+  /// sample.
+  void finish();
+
+  const QStringList &columns() const { return m_columns; }
+  const std::vector<std::vector<double>> &samples() const { return m_samples; }
+
+private:
+  void reset();
+  void processorClocked();
+  void sample();
+
+  unsigned m_interval = 0;
+  std::shared_ptr<const CacheHierarchy> m_caches;
+  std::vector<std::pair<QString, Counter>> m_customCounters;
+
+  QStringList m_columns;
+  std::vector<std::vector<double>> m_samples;
+
+  // Cumulative values as of the previous sample.
+  long long m_lastCycles = 0;
+  long long m_lastRetired = 0;
+  long long m_lastStallCycles = 0;
+  std::vector<std::pair<unsigned, unsigned>> m_lastCacheStats;
+  std::vector<double> m_lastCustom;
+};
+
+} // namespace Ripes
@@ -0,0 +1,195 @@
+#include "vcdwriter.h"
+
+#include "processorhandler.h"
+#include "processors/ripesvsrtlprocessor.h"
+
+namespace Ripes {
+
+// Identifier codes are written in base 94, over the printable ASCII range.
+static constexpr char s_firstIdChar = '!';
+static constexpr unsigned s_idChars = 94;
+
+static std::string identifier(size_t index) {
+  std::string id;
+  do {
+    id.push_back(static_cast<char>(s_firstIdChar + index % s_idChars));
+    index /= s_idChars;
+  } while (index != 0);
+  return id;
+}
+
+static uint64_t mask(unsigned width) {
+  return width >= 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+}
+
+VcdWriter::~VcdWriter() { close(); }
+
+QString VcdWriter::open(const QString &path, const QString &patterns) {
+  close();
+  const auto *design =
+      dynamic_cast<const vsrtl::SimDesign *>(ProcessorHandler::getProcessor());
+  if (!design)
+    return "Error: Signals can only be dumped for VSRTL processor models";
+
+  std::vector<QRegularExpression> regexes;
+  for (const auto &pattern : patterns.split(',', Qt::SkipEmptyParts)) {
+    regexes.emplace_back(QRegularExpression::anchoredPattern(
+        QRegularExpression::wildcardToRegularExpression(pattern.trimmed())));
+  }
+  m_signals.clear();
+  std::vector<std::string> scope;
+  collect(*design, scope, regexes);
+  if (m_signals.empty())
+    return "Error: No signals of the processor match '" + patterns + "'";
+
+  if (!m_writer.open(path).isEmpty())
+    return "Error: Could not open VCD file " + path;
+
+  m_cycles = 0;
+  m_timeBase = 0;
+  m_lastTime = 0;
+  m_wroteTime = false;
+  writeHeader(design->getName());
+  processorReset();
+
+  ProcessorHandler::attachObserver(this);
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          [this] { processorReset(); });
+  return QString();
+}
+
+QString VcdWriter::close() {
+  if (!m_writer.isOpen())
+    return QString();
+
+  ProcessorHandler::detachObserver(this);
+  disconnect(ProcessorHandler::get(), nullptr, this, nullptr);
+  // Mark the end of the final cycle, such that viewers show its values.
+  if (m_sampledTime > m_lastTime)
+    m_writer.write(QByteArray("#") + QByteArray::number(m_sampledTime) + "\n");
+  if (!m_writer.close().isEmpty())
+    return "Error: Could not write VCD file " + m_writer.fileName();
+  return QString();
+}
+
+void VcdWriter::collect(const vsrtl::SimComponent &component,
+                        std::vector<std::string> &scope,
+                        const std::vector<QRegularExpression> &patterns) {
+  QString prefix;
+  for (const auto &name : scope)
+    prefix += QString::fromStdString(name) + ".";
+  for (const auto &port :
+       component.getPorts<vsrtl::SimPort::PortType::out>()) {
+    const QString name = prefix + QString::fromStdString(port->getName());
+    for (const auto &pattern : patterns) {
+      if (!pattern.match(name).hasMatch())
+        continue;
+      const unsigned width = port->getWidth();
+      m_signals.push_back({&*port, scope, port->getName(), width,
+                           identifier(m_signals.size()), 0});
+      break;
+    }
+  }
+  for (const auto &sub : component.getSubComponents()) {
+    scope.push_back(sub->getName());
+    collect(*sub, scope, patterns);
+    scope.pop_back();
+  }
+}
+
+void VcdWriter::writeHeader(const std::string &design) {
+  QByteArray header = "$version Ripes $end\n"
+                      "$timescale 1 ns $end\n";
+  header += "$scope module " + QByteArray::fromStdString(design) + " $end\n";
+  // Signals are collected depth-first, such that the signals of each
+  // component are contiguous.
+  std::vector<std::string> open;
+  for (const auto &signal : m_signals) {
+    size_t common = 0;
+    while (common < open.size() && common < signal.scope.size() &&
+           open[common] == signal.scope[common])
+      common++;
+    for (size_t i = open.size(); i > common; --i)
+      header += "$upscope $end\n";
+    open.resize(common);
+    for (size_t i = common; i < signal.scope.size(); ++i) {
+      header += "$scope module " + QByteArray::fromStdString(signal.scope[i]) +
+                " $end\n";
+      open.push_back(signal.scope[i]);
+    }
+    header += "$var wire " + QByteArray::number(signal.width) + " " +
+              QByteArray::fromStdString(signal.id) + " " +
+              QByteArray::fromStdString(signal.name);
+    if (signal.width > 1)
+      header += " [" + QByteArray::number(signal.width - 1) + ":0]";
+    header += " $end\n";
+  }
+  for (size_t i = 0; i < open.size(); ++i)
+    header += "$upscope $end\n";
+  header += "$upscope $end\n"
+            "$enddefinitions $end\n";
+  m_writer.write(header);
+}
+
+void VcdWriter::processorReset() {
+  // The cycle count restarts; the run continues at the following time unit.
+  const long long cycle = ProcessorHandler::getProcessor()->getCycleCount();
+  if (m_wroteTime)
+    m_timeBase = m_sampledTime + 1 - cycle;
+  sample(m_timeBase + cycle, !m_wroteTime);
+}
+
+void VcdWriter::onCycle(const RipesProcessor &proc) {
+  m_cycles++;
+  unsigned long long time = m_timeBase + proc.getCycleCount();
+  if (time <= m_sampledTime && m_wroteTime) {
+    // The processor was rewound; time may only advance.
+    m_timeBase = m_sampledTime + 1 - proc.getCycleCount();
+    time = m_sampledTime + 1;
+  }
+  sample(time, false);
+}
+
+void VcdWriter::sample(unsigned long long time, bool all) {
+  m_sampledTime = time;
+  bool wroteTime = false;
+  for (auto &signal : m_signals) {
+    const uint64_t value = signal.port->uValue() & mask(signal.width);
+    if (!all && value == signal.value)
+      continue;
+    signal.value = value;
+    if (!wroteTime) {
+      m_writer.write(QByteArray("#") + QByteArray::number(time) + "\n");
+      if (all)
+        m_writer.write("$dumpvars\n", 10);
+      wroteTime = true;
+      m_wroteTime = true;
+      m_lastTime = time;
+    }
+    writeValue(signal);
+  }
+  if (all && wroteTime)
+    m_writer.write("$end\n", 5);
+}
+
+void VcdWriter::writeValue(const Signal &signal) {
+  char buffer[64 + 16];
+  int size = 0;
+  if (signal.width == 1) {
+    buffer[size++] = signal.value ? '1' : '0';
+  } else {
+    // Leading zeros are implied.
+    buffer[size++] = 'b';
+    int bit = 63;
+    while (bit > 0 && !(signal.value >> bit & 1))
+      bit--;
+    for (; bit >= 0; --bit)
+      buffer[size++] = (signal.value >> bit & 1) ? '1' : '0';
+    buffer[size++] = ' ';
+  }
+  m_writer.write(buffer, size);
+  m_writer.write(signal.id.data(), static_cast<int>(signal.id.size()));
+  m_writer.write("\n", 1);
+}
+
+} // namespace Ripes
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QObject>
+#include <QRegularExpression>
+#include <QString>
+
+#include <string>
+#include <vector>
+
+#include "asyncfilewriter.h"
+#include "processorobserver.h"
+
+namespace vsrtl {
+class SimComponent;
+class SimPort;
+} // namespace vsrtl
+
+namespace Ripes {
+
+/// The signals exported by default: the outputs of the pipeline registers and
+/// of the control unit of each model.
+constexpr const char *c_vcdDefaultSignals = "*_reg.*,control.*";
+
+/**
+ * @brief The VcdWriter class
+ * Streams the values of selected signals of the current VSRTL processor to a
+ * Value Change Dump file during simulation, such that the signals of long runs
+ * may be inspected in a waveform viewer (ie. GTKWave or Surfer). A signal is
+ * an output port of a component, named by its path through the design, ie.
+ * "idex_reg.alu_op1_out"; signals are selected by a comma-separated list of
+ * wildcard patterns matched against these names. Components are written as
+ * nested module scopes.
+ *
+ * Port values are read after each cycle, such that the design need not emit
+ * its change signals, and only changed values are written, one time unit per
+ * cycle. Time is monotonic across processor resets; a reset restarts at the
+ * time following the last written cycle. Output is written on a background
+ * thread (see AsyncFileWriter).
+ */
+class VcdWriter : public QObject, public ProcessorObserver {
+public:
+  ~VcdWriter() override;
+
+  /// Opens the file at @p path and starts dumping the signals matching
+  /// @p patterns of the current processor. Returns an error message on
+  /// failure, or an empty string on success.
+  QString open(const QString &path, const QString &patterns);
+  /// Stops dumping and closes the file. Returns an error message if writing
+  /// the dump failed, or an empty string on success.
+  QString close();
+
+  unsigned long long cycles() const { return m_cycles; }
+  unsigned long long bytes() const { return m_writer.bytes(); }
+  unsigned signalCount() const {
+    return static_cast<unsigned>(m_signals.size());
+  }
+
+  unsigned events() const override { return Cycle; }
+  void onCycle(const RipesProcessor &proc) override;
+
+private:
+  struct Signal {
+    const vsrtl::SimPort *port;
+    // Names of the enclosing components below the design, and of the port.
+    std::vector<std::string> scope;
+    std::string name;
+    unsigned width;
+    std::string id;
+    uint64_t value;
+  };
+
+  void collect(const vsrtl::SimComponent &component,
+               std::vector<std::string> &scope,
+               const std::vector<QRegularExpression> &patterns);
+  void writeHeader(const std::string &design);
+  void processorReset();
+  /// Writes the signals which changed since the previous sample, or all
+  /// signals if @p all, at @p time.
+  void sample(unsigned long long time, bool all);
+  void writeValue(const Signal &signal);
+
+  AsyncFileWriter m_writer;
+  std::vector<Signal> m_signals;
+  unsigned long long m_cycles = 0;
+  // Time of the cycle count zero of the current run, and the last time
+  // written to the dump.
+  unsigned long long m_timeBase = 0;
+  unsigned long long m_lastTime = 0;
+  bool m_wroteTime = false;
+  // Time of the most recently sampled cycle, whether or not it was written.
+  unsigned long long m_sampledTime = 0;
+};
+
+} // namespace Ripes
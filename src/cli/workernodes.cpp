@@ -0,0 +1,386 @@
+#include "workernodes.h"
+
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QProcess>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <set>
+
+namespace Ripes {
+
+QString parseWorkerNodes(const QString &spec, std::vector<WorkerNode> &nodes) {
+  nodes.clear();
+  for (const QString &item : spec.split(',', Qt::SkipEmptyParts)) {
+    const int colon = item.lastIndexOf(':');
+    WorkerNode node;
+    bool ok = false;
+    if (colon > 0) {
+      node.host = item.left(colon).trimmed();
+      const unsigned port = item.mid(colon + 1).toUInt(&ok);
+      ok &= port != 0 && port <= 0xFFFF;
+      node.port = port;
+    }
+    if (!ok)
+      return "Invalid worker node '" + item + "', expected <host>:<port>";
+    nodes.push_back(node);
+  }
+  if (nodes.empty())
+    return "No worker nodes specified";
+  return QString();
+}
+
+/// Splits the complete lines of @p buffer off its front.
+static std::vector<QByteArray> takeLines(QByteArray &buffer) {
+  std::vector<QByteArray> lines;
+  int start = 0;
+  for (int end; (end = buffer.indexOf('\n', start)) >= 0; start = end + 1) {
+    const QByteArray line = buffer.mid(start, end - start).trimmed();
+    if (!line.isEmpty())
+      lines.push_back(line);
+  }
+  buffer.remove(0, start);
+  return lines;
+}
+
+static QByteArray toLine(const QJsonObject &object) {
+  return QJsonDocument(object).toJson(QJsonDocument::Compact) + "\n";
+}
+
+namespace {
+
+/**
+ * @brief The Coordinator class
+ * Hands out the runs of a batch to the connected worker nodes, and gathers
+ * their results.
+ */
+class Coordinator {
+public:
+  Coordinator(const std::vector<BatchRun> &runs, unsigned retries,
+              bool verbose, std::vector<QJsonObject> &results)
+      : m_runs(runs), m_retries(retries), m_verbose(verbose),
+        m_results(results), m_attempts(runs.size(), 0),
+        m_remaining(runs.size()) {
+    for (int run = 0; run < static_cast<int>(runs.size()); ++run)
+      m_pending.push_back(run);
+  }
+
+  void run(const std::vector<WorkerNode> &nodes) {
+    if (m_remaining == 0)
+      return;
+    for (const auto &node : nodes) {
+      auto &conn = m_connections.emplace_back(std::make_unique<Connection>());
+      conn->node = node;
+      Connection *c = conn.get();
+      QObject::connect(&c->socket, &QTcpSocket::readyRead, &c->socket,
+                       [=] { onReadyRead(*c); });
+      QObject::connect(&c->socket, &QTcpSocket::disconnected, &c->socket,
+                       [=] { onLost(*c, "disconnected"); });
+      QObject::connect(&c->socket, &QTcpSocket::errorOccurred, &c->socket,
+                       [=] { onLost(*c, c->socket.errorString()); });
+      c->socket.connectToHost(node.host, node.port);
+    }
+    m_loop.exec();
+  }
+
+private:
+  struct Connection {
+    WorkerNode node;
+    QTcpSocket socket;
+    QByteArray in;
+    // Concurrent runs accepted by the worker; 0 until it has greeted.
+    int slots = 0;
+    std::set<int> inFlight;
+    bool alive = true;
+  };
+
+  void log(const QString &message) const {
+    if (m_verbose)
+      std::cerr << "INFO: " << message.toStdString() << std::endl;
+  }
+
+  void onReadyRead(Connection &c) {
+    c.in += c.socket.readAll();
+    for (const QByteArray &line : takeLines(c.in)) {
+      if (!c.alive)
+        return;
+      onLine(c, QJsonDocument::fromJson(line).object());
+    }
+  }
+
+  void onLine(Connection &c, QJsonObject message) {
+    if (c.slots == 0) {
+      // The greeting of the worker.
+      if (message.value("ripes") != "worker" ||
+          message.value("protocol").toInt() != c_workerProtocolVersion ||
+          message.value("slots").toInt() < 1) {
+        onLost(c, "not a compatible Ripes worker");
+        return;
+      }
+      c.slots = message.value("slots").toInt();
+      log("Connected to worker node " + c.node.toString() + " (" +
+          QString::number(c.slots) + " slots)");
+      dispatch();
+      return;
+    }
+
+    const int run = message.take("id").toInt(-1);
+    if (c.inFlight.erase(run) == 0)
+      return;
+    if (message.take("retry").toBool()) {
+      retry(run, "Worker process of " + c.node.toString() + " exited");
+    } else {
+      // Console output is not part of the results of a batch or sweep.
+      message.remove("console");
+      complete(run, message);
+    }
+    dispatch();
+  }
+
+  void onLost(Connection &c, const QString &reason) {
+    if (!c.alive)
+      return;
+    c.alive = false;
+    log("Lost worker node " + c.node.toString() + ": " + reason);
+    const std::set<int> lost = std::move(c.inFlight);
+    c.inFlight.clear();
+    for (const int run : lost)
+      retry(run, "Lost worker node " + c.node.toString() + ": " + reason);
+    c.socket.abort();
+    dispatch();
+  }
+
+  /// Requeues @p run, unless it has exhausted its retries.
+  void retry(int run, const QString &error) {
+    if (m_attempts.at(run)++ >= m_retries) {
+      complete(run, failure(run, error));
+      return;
+    }
+    log("Retrying run " + QString::number(run) + " (" + error + ")");
+    m_pending.push_front(run);
+  }
+
+  QJsonObject failure(int run, const QString &error) const {
+    QJsonObject result;
+    if (!m_runs.at(run).name.isEmpty())
+      result["name"] = m_runs.at(run).name;
+    result["status"] = "failed";
+    result["error"] = error;
+    return result;
+  }
+
+  void complete(int run, const QJsonObject &result) {
+    m_results.at(run) = result;
+    if (--m_remaining == 0)
+      m_loop.quit();
+  }
+
+  void dispatch() {
+    bool anyAlive = false;
+    for (auto &c : m_connections) {
+      if (!c->alive)
+        continue;
+      anyAlive = true;
+      while (c->slots != 0 && !m_pending.empty() &&
+             static_cast<int>(c->inFlight.size()) < c->slots) {
+        const int run = m_pending.front();
+        m_pending.pop_front();
+        QJsonObject request;
+        request["id"] = run;
+        if (!m_runs.at(run).name.isEmpty())
+          request["name"] = m_runs.at(run).name;
+        request["args"] = QJsonArray::fromStringList(m_runs.at(run).arguments);
+        c->inFlight.insert(run);
+        c->socket.write(toLine(request));
+      }
+    }
+    if (anyAlive || m_remaining == 0)
+      return;
+    // No node is left to execute the remaining runs.
+    while (!m_pending.empty()) {
+      const int run = m_pending.front();
+      m_pending.pop_front();
+      complete(run, failure(run, "No worker node available"));
+    }
+  }
+
+  const std::vector<BatchRun> &m_runs;
+  const unsigned m_retries;
+  const bool m_verbose;
+  std::vector<QJsonObject> &m_results;
+  std::vector<unsigned> m_attempts;
+  size_t m_remaining;
+  std::deque<int> m_pending;
+  std::vector<std::unique_ptr<Connection>> m_connections;
+  QEventLoop m_loop;
+};
+
+/**
+ * @brief The Worker class
+ * Serves a single coordinator at a time, forwarding its requests to a pool of
+ * server mode processes.
+ */
+class Worker {
+public:
+  Worker(int slots, const QStringList &serverArguments, bool verbose)
+      : m_serverArguments(serverArguments), m_verbose(verbose) {
+    for (int i = 0; i < slots; ++i) {
+      auto &slot = m_slots.emplace_back(std::make_unique<Slot>());
+      Slot *s = slot.get();
+      s->process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+      QObject::connect(&s->process, &QProcess::readyReadStandardOutput,
+                       &s->process, [=] { onOutput(*s); });
+      QObject::connect(
+          &s->process,
+          QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+          &s->process, [=] { onExited(*s); });
+      start(*s);
+    }
+  }
+
+  QString serve(quint16 port) {
+    if (!m_server.listen(QHostAddress::Any, port))
+      return "Could not listen on port " + QString::number(port) + ": " +
+             m_server.errorString();
+    QObject::connect(&m_server, &QTcpServer::newConnection, &m_server,
+                     [=] { accept(); });
+    log("Worker listening on port " + QString::number(port) + " (" +
+        QString::number(m_slots.size()) + " slots)");
+    m_loop.exec();
+    return QString();
+  }
+
+private:
+  struct Slot {
+    QProcess process;
+    QByteArray out;
+    // The id of the request being executed, if any.
+    bool busy = false;
+    QJsonValue id;
+  };
+
+  void log(const QString &message) const {
+    if (m_verbose)
+      std::cerr << "INFO: " << message.toStdString() << std::endl;
+  }
+
+  void start(Slot &s) {
+    s.out.clear();
+    s.busy = false;
+    s.process.start(QCoreApplication::applicationFilePath(),
+                    m_serverArguments);
+  }
+
+  void accept() {
+    if (m_socket || !m_server.hasPendingConnections())
+      return;
+    m_socket = m_server.nextPendingConnection();
+    log("Accepted coordinator " + m_socket->peerAddress().toString());
+    QObject::connect(m_socket, &QTcpSocket::readyRead, m_socket,
+                     [=] { onRequests(); });
+    QObject::connect(m_socket, &QTcpSocket::disconnected, m_socket,
+                     [=] { onDisconnected(); });
+    QJsonObject greeting;
+    greeting["ripes"] = "worker";
+    greeting["protocol"] = c_workerProtocolVersion;
+    greeting["slots"] = static_cast<int>(m_slots.size());
+    m_socket->write(toLine(greeting));
+  }
+
+  void onDisconnected() {
+    log("Coordinator disconnected");
+    m_socket->deleteLater();
+    m_socket = nullptr;
+    m_in.clear();
+    m_queue.clear();
+    // The results of runs in flight are of no use to the next coordinator.
+    for (auto &s : m_slots) {
+      if (!s->busy)
+        continue;
+      s->busy = false;
+      s->process.kill();
+      s->process.waitForFinished();
+    }
+    accept();
+  }
+
+  void onRequests() {
+    m_in += m_socket->readAll();
+    for (const QByteArray &line : takeLines(m_in))
+      m_queue.push_back(line);
+    dispatch();
+  }
+
+  void dispatch() {
+    for (auto &s : m_slots) {
+      if (m_queue.empty())
+        return;
+      if (s->busy || s->process.state() == QProcess::NotRunning)
+        continue;
+      const QByteArray request = m_queue.front();
+      m_queue.pop_front();
+      s->busy = true;
+      s->id = QJsonDocument::fromJson(request).object().value("id");
+      s->process.write(request + "\n");
+    }
+  }
+
+  void onOutput(Slot &s) {
+    s.out += s.process.readAllStandardOutput();
+    for (const QByteArray &line : takeLines(s.out)) {
+      if (!s.busy)
+        continue;
+      s.busy = false;
+      if (m_socket)
+        m_socket->write(line + "\n");
+    }
+    dispatch();
+  }
+
+  void onExited(Slot &s) {
+    if (s.busy && m_socket) {
+      QJsonObject response;
+      response["id"] = s.id;
+      response["status"] = "failed";
+      response["error"] = "Worker process exited unexpectedly";
+      response["retry"] = true;
+      m_socket->write(toLine(response));
+    }
+    log("Restarting worker process");
+    start(s);
+    dispatch();
+  }
+
+  const QStringList m_serverArguments;
+  const bool m_verbose;
+  QTcpServer m_server;
+  QTcpSocket *m_socket = nullptr;
+  QByteArray m_in;
+  std::deque<QByteArray> m_queue;
+  std::vector<std::unique_ptr<Slot>> m_slots;
+  QEventLoop m_loop;
+};
+
+} // namespace
+
+void runOnWorkerNodes(const std::vector<WorkerNode> &nodes,
+                      const std::vector<BatchRun> &runs, unsigned retries,
+                      bool verbose, std::vector<QJsonObject> &results) {
+  results.assign(runs.size(), QJsonObject());
+  Coordinator coordinator(runs, retries, verbose, results);
+  coordinator.run(nodes);
+}
+
+QString runWorkerNode(quint16 port, int slots,
+                      const QStringList &serverArguments, bool verbose) {
+  Worker worker(slots, serverArguments, verbose);
+  return worker.serve(port);
+}
+
+} // namespace Ripes
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+
+#include <vector>
+
+#include "batchmanifest.h"
+
+namespace Ripes {
+
+/**
+ * Distributed execution of the runs of a batch or sweep across worker nodes
+ * (--nodes), each a Ripes process in worker mode (--worker) on some machine.
+ *
+ * The protocol is line-delimited JSON over TCP. Upon accepting a connection, a
+ * worker sends a greeting, {"ripes": "worker", "protocol": 1, "slots": N},
+ * where N is the number of runs it executes concurrently. The coordinator then
+ * sends up to N requests at a time, each a request of server mode (--server)
+ * with the "name" and "args" of a run and the "id" of the run. Each response is
+ * the result of a run as in server mode, echoing its "id", and responses are
+ * sent in the order in which runs complete. Responses for runs which were lost
+ * to a worker process exiting carry "retry": true.
+ *
+ * Runs refer to files (ie. sources) by path, which must resolve to the same
+ * files on each node, ie. through a shared file system.
+ */
+struct WorkerNode {
+  QString host;
+  quint16 port = 0;
+
+  QString toString() const { return host + ":" + QString::number(port); }
+};
+
+/// Version of the worker protocol; coordinators only use workers of the same
+/// version.
+constexpr int c_workerProtocolVersion = 1;
+
+/// Parses the comma separated list of <host>:<port> of @p spec into @p nodes.
+/// Returns an error message on failure, or an empty string on success.
+QString parseWorkerNodes(const QString &spec, std::vector<WorkerNode> &nodes);
+
+/**
+ * @brief runOnWorkerNodes
+ * Executes @p runs across @p nodes, gathering the result of each run into
+ * @p results, in the order of @p runs. Runs are handed out to the nodes as
+ * their slots free up, such that faster nodes execute more runs. The runs in
+ * flight on a node which disconnects or fails, and runs lost to a worker
+ * process exiting, are retried on any node up to @p retries times; runs which
+ * could not be completed are reported as failed. Progress is reported to
+ * stderr if @p verbose is set.
+ */
+void runOnWorkerNodes(const std::vector<WorkerNode> &nodes,
+                      const std::vector<BatchRun> &runs, unsigned retries,
+                      bool verbose, std::vector<QJsonObject> &results);
+
+/**
+ * @brief runWorkerNode
+ * Serves coordinators connecting to TCP @p port, one at a time, until
+ * terminated. Runs are executed by @p slots server mode processes of this
+ * executable, started with @p serverArguments, which are restarted if they
+ * exit. Returns an error message on failure.
+ */
+QString runWorkerNode(quint16 port, int slots,
+                      const QStringList &serverArguments, bool verbose);
+
+} // namespace Ripes
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QObject>
+#include <QThread>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include "Signals/Signal.h"
+
+namespace Ripes {
+
+/**
+ * @brief The CoalescedSignal class
+ * Bridges a Gallant signal, ie. of a processor, to a handler run on the thread
+ * of a receiver. Emissions on the thread of the receiver run the handler
+ * directly. Emissions from other threads are counted, and only the first
+ * emission since the last delivery queues an event; the handler runs once for
+ * all emissions counted until the event is processed, and is given their
+ * number. Thus, at most one event per bridge is pending in the event queue of
+ * the receiver, however fast the signal is emitted.
+ *
+ * As with vsrtl::GallantSignalWrapper, the bridge does not disconnect from the
+ * signal upon destruction; the signal must be cleared or destroyed first.
+ * Events pending upon destruction are dropped.
+ */
+class CoalescedSignal {
+public:
+  using Handler = std::function<void(unsigned long long emissions)>;
+
+  CoalescedSignal(QObject *receiver, Handler handler,
+                  Gallant::Signal0<> &signal)
+      : m_receiver(receiver), m_state(std::make_shared<State>()) {
+    m_state->handler = std::move(handler);
+    signal.Connect(this, &CoalescedSignal::emitted);
+  }
+
+private:
+  struct State {
+    Handler handler;
+    std::atomic<unsigned long long> pending{0};
+
+    void deliver(unsigned long long emissions) {
+      emissions += pending.exchange(0);
+      if (emissions != 0)
+        handler(emissions);
+    }
+  };
+
+  void emitted() {
+    if (QThread::currentThread() == m_receiver->thread()) {
+      // Emissions still pending from other threads are delivered along with
+      // this one, such that they are not delivered after it.
+      m_state->deliver(1);
+      return;
+    }
+    if (m_state->pending.fetch_add(1) != 0)
+      return;
+    std::weak_ptr<State> state = m_state;
+    QMetaObject::invokeMethod(
+        m_receiver,
+        [state] {
+          if (auto s = state.lock())
+            s->deliver(0);
+        },
+        Qt::QueuedConnection);
+  }
+
+  QObject *m_receiver;
+  std::shared_ptr<State> m_state;
+};
+
+} // namespace Ripes
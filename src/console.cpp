@@ -1,6 +1,7 @@
 #include "console.h"
 
 #include "fonts.h"
+#include "processorhandler.h"
 #include "ripessettings.h"
 
 #include <QScrollBar>
@@ -15,7 +16,17 @@ Console::Console(QWidget *parent) : QPlainTextEdit(parent) {
   }
   setFont(m_font);
 
-  document()->setMaximumBlockCount(100);
+  // The console retains a bounded number of lines, discarding the oldest.
+  auto maxLinesFunctor = [=] {
+    m_maxLines = RipesSettings::value(RIPES_SETTING_CONSOLEMAXLINES).toInt();
+    document()->setMaximumBlockCount(m_maxLines);
+  };
+  connect(RipesSettings::getObserver(RIPES_SETTING_CONSOLEMAXLINES),
+          &SettingObserver::modified, this, maxLinesFunctor);
+  maxLinesFunctor();
+
+  m_refreshClient = ProcessorHandler::getRefreshScheduler().addClient(
+      this, [=] { flushOutput(); });
 
   auto paletteChangeFunctor = [=] {
     QPalette p = palette();
@@ -46,17 +57,48 @@ Console::Console(QWidget *parent) : QPlainTextEdit(parent) {
 }
 
 void Console::putData(const QByteArray &bytes) {
+  appendOutput(QString::fromUtf8(bytes));
+}
+
+void Console::appendOutput(const QString &text) {
+  {
+    QMutexLocker locker(&m_pendingOutputMutex);
+    m_pendingOutput += text;
+    // Output beyond what the console can retain is dropped ahead of time. A
+    // retained line is assumed to average no more than 256 characters.
+    const int maxChars = m_maxLines * 256;
+    if (m_pendingOutput.size() > maxChars)
+      m_pendingOutput.remove(0, m_pendingOutput.size() - maxChars);
+  }
+  if (!m_outputPending.exchange(true))
+    ProcessorHandler::getRefreshScheduler().markDirty(m_refreshClient);
+}
+
+void Console::flushOutput() {
+  QString output;
+  {
+    QMutexLocker locker(&m_pendingOutputMutex);
+    m_outputPending = false;
+    output.swap(m_pendingOutput);
+  }
+  if (output.isEmpty())
+    return;
+
   // Text can always only be inserted at the end of the console
   auto cursorAtEnd = QTextCursor(document());
   cursorAtEnd.movePosition(QTextCursor::End);
   setTextCursor(cursorAtEnd);
-  insertPlainText(bytes);
+  insertPlainText(output);
 
   QScrollBar *bar = verticalScrollBar();
   bar->setValue(bar->maximum());
 }
 
 void Console::clearConsole() {
+  {
+    QMutexLocker locker(&m_pendingOutputMutex);
+    m_pendingOutput.clear();
+  }
   clear();
   m_buffer.clear();
 }
@@ -3,8 +3,13 @@
 #include <QTextBlock>
 
 #include <QFont>
+#include <QMutex>
 #include <QPlainTextEdit>
 
+#include <atomic>
+
+#include "refreshscheduler.h"
+
 namespace Ripes {
 
 class Console : public QPlainTextEdit {
@@ -16,6 +21,9 @@ signals:
 public:
   Console(QWidget *parent = nullptr);
   void putData(const QByteArray &data);
+  /// Appends @p text to the console upon its next refresh. May be called from
+  /// any thread, such that output is batched at most once per UI frame.
+  void appendOutput(const QString &text);
   void clearConsole();
 
 protected:
@@ -23,10 +31,20 @@ protected:
 
 private:
   void backspace();
+  /// Inserts the pending output at the end of the console.
+  void flushOutput();
 
   bool m_localEchoEnabled = false;
   QFont m_font;
   QString m_buffer;
+
+  // Output which has yet to be inserted into the console. Bounded, since the
+  // console only retains its most recent lines regardless.
+  QString m_pendingOutput;
+  QMutex m_pendingOutputMutex;
+  std::atomic<bool> m_outputPending{false};
+  RefreshScheduler::ClientID m_refreshClient;
+  int m_maxLines = 0;
 };
 
 } // namespace Ripes
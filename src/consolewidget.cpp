@@ -24,9 +24,12 @@ ConsoleWidget::ConsoleWidget(QWidget *parent)
   connect(m_ui->console, &Console::sendData, &SystemIO::get(),
           &SystemIO::putStdInData);
 
-  // Print output data from SystemIO in the console.
-  connect(&SystemIO::get(), &SystemIO::doPrint, m_ui->console,
-          [&](auto text) { m_ui->console->putData(text.toUtf8()); });
+  // Print output data from SystemIO in the console. Output is buffered by the
+  // console directly from the simulation thread, and batched per UI frame.
+  connect(
+      &SystemIO::get(), &SystemIO::doPrint, m_ui->console,
+      [=](const QString &text) { m_ui->console->appendOutput(text); },
+      Qt::DirectConnection);
 }
 
 ConsoleWidget::~ConsoleWidget() { delete m_ui; }
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "ripes_types.h"
+
+namespace Ripes {
+
+/**
+ * @brief The DirtyPageTracker class
+ * Tracks which pages of simulated memory have been written. Each write stamps
+ * the written page(s) with the current generation. Observers record the
+ * generation returned by snapshot(), and later query the pages written since
+ * that generation. In this way, any number of observers may independently
+ * query and clear the dirty state of memory.
+ *
+ * Writes are expected to be marked by a single thread (the thread clocking the
+ * processor), whereas observers may query from any thread.
+ */
+class DirtyPageTracker {
+public:
+  static constexpr unsigned s_pageBits = 12;
+  static constexpr AInt s_pageSize = AInt(1) << s_pageBits;
+  using Generation = uint64_t;
+
+  /// Marks the @p bytes bytes at @p address as written.
+  void markDirty(AInt address, unsigned bytes) {
+    const Generation gen = m_generation.load(std::memory_order_relaxed);
+    const AInt first = address >> s_pageBits;
+    const AInt last = (address + (bytes ? bytes - 1 : 0)) >> s_pageBits;
+    // Fast path; repeated writes to the same page within a generation.
+    if (first == last && first == m_lastPage && m_lastStamp == gen)
+      return;
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    for (AInt page = first; page <= last; ++page)
+      m_pages[page] = gen;
+    m_lastPage = last;
+    m_lastStamp = gen;
+  }
+
+  /// Marks all of memory as written, ie. after a reset or reversal of the
+  /// processor.
+  void markAllDirty() {
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_allDirty = m_generation.load();
+    m_pages.clear();
+    m_lastStamp = 0;
+  }
+
+  /// Starts a new generation. Returns the generation which an observer should
+  /// provide upon its next query.
+  Generation snapshot() { return ++m_generation; }
+
+  /// Returns the page numbers written at, or after, generation @p since. If all
+  /// of memory must be considered written, @p all is set.
+  std::vector<AInt> dirtyPagesSince(Generation since, bool &all) const {
+    std::lock_guard<std::mutex> lock(m_lock);
+    all = since <= m_allDirty;
+    std::vector<AInt> pages;
+    if (all)
+      return pages;
+    for (const auto &page : m_pages)
+      if (page.second >= since)
+        pages.push_back(page.first);
+    return pages;
+  }
+
+private:
+  mutable std::mutex m_lock;
+  std::atomic<Generation> m_generation = 1;
+  // Generation at which all of memory was last marked as written.
+  Generation m_allDirty = 1;
+  // Page number => generation of the most recent write to the page.
+  std::unordered_map<AInt, Generation> m_pages;
+
+  // Most recently marked page; only accessed by the writing thread.
+  AInt m_lastPage = 0;
+  Generation m_lastStamp = 0;
+};
+
+} // namespace Ripes
@@ -7,20 +7,25 @@
 #include <QMenu>
 #include <QMessageBox>
 #include <QPainter>
+#include <QPainterPath>
 #include <QTextBlock>
+#include <QTextLayout>
 #include <QTimer>
 #include <QToolTip>
 #include <QWheelEvent>
 
+#include <algorithm>
 #include <iterator>
 
 #include "colors.h"
 #include "csyntaxhighlighter.h"
 #include "fonts.h"
 #include "formattermanager.h"
+#include "hazardanalyzer.h"
 #include "processorhandler.h"
 #include "ripessettings.h"
 #include "rvsyntaxhighlighter.h"
+#include "sourceprofiler.h"
 #include "statusmanager.h"
 #include "syntaxhighlighter.h"
 
@@ -35,8 +40,24 @@ CodeEditor::CodeEditor(QWidget *parent) : HighlightableTextEdit(parent) {
           &CodeEditor::updateSidebar);
   updateSidebarWidth(0);
 
-  connect(ProcessorHandler::get(), &ProcessorHandler::procStateChangedNonRun,
-          this, &CodeEditor::updateHighlighting);
+  ProcessorHandler::getRefreshScheduler().addClient(this, [=] {
+    updateHighlighting();
+    updateHeatMap();
+    updateHazards();
+  });
+  connect(RipesSettings::getObserver(RIPES_SETTING_EDITORHEATMAP),
+          &SettingObserver::modified, this, [=] { updateProfiler(); });
+  connect(RipesSettings::getObserver(RIPES_SETTING_EDITORHAZARDS),
+          &SettingObserver::modified, this, [=] { updateHazards(); });
+  // Annotations are invalidated by edits, until the source is reassembled.
+  connect(this, &QPlainTextEdit::textChanged, this, [=] {
+    if (m_hazardProgram) {
+      m_hazards.clear();
+      m_hazardProgram.reset();
+      viewport()->update();
+    }
+  });
+  updateProfiler();
 
   // Set font for the entire widget. calls to fontMetrics() will get the
   // dimensions of the currently set font
@@ -55,6 +76,8 @@ CodeEditor::CodeEditor(QWidget *parent) : HighlightableTextEdit(parent) {
   setupChangedTimer();
 }
 
+CodeEditor::~CodeEditor() = default;
+
 struct ClangFormatResult {
   // remapped cursor position. see clang-format --cursor for more info.
   unsigned cursor;
@@ -307,9 +330,80 @@ bool CodeEditor::eventFilter(QObject * /*observed*/, QEvent *event) {
   return false;
 }
 
-void CodeEditor::rehighlight() {
-  if (m_highlighter) {
-    m_highlighter->rehighlight();
+void CodeEditor::paintEvent(QPaintEvent *event) {
+  HighlightableTextEdit::paintEvent(event);
+  paintErrorOverlay(event);
+  paintHazardOverlay(event);
+}
+
+void CodeEditor::paintHazardOverlay(QPaintEvent *event) {
+  if (m_hazards.empty())
+    return;
+
+  QPainter painter(viewport());
+  const QPointF offset = contentOffset();
+  const int spacing = fontMetrics().horizontalAdvance(' ') * 4;
+  for (QTextBlock block = firstVisibleBlock(); block.isValid();
+       block = block.next()) {
+    const QRectF geometry = blockBoundingGeometry(block).translated(offset);
+    if (geometry.top() > event->rect().bottom())
+      break;
+    const auto it = m_hazards.find(block.blockNumber());
+    if (!block.isVisible() || it == m_hazards.end())
+      continue;
+
+    const HazardAnnotation &annotation = it->second;
+    QString text;
+    if (annotation.stalls != 0)
+      text = QString::number(annotation.stalls) +
+             (annotation.stalls == 1 ? " stall" : " stalls");
+    if (annotation.unresolved != 0) {
+      if (!text.isEmpty())
+        text += ", ";
+      text += QString::number(annotation.unresolved) + " unresolved";
+    }
+    const QTextLine line = block.layout()->lineAt(0);
+    painter.setPen(annotation.unresolved != 0 ? QColor(Qt::red)
+                                              : QColor(255, 140, 0));
+    painter.drawText(QPointF(geometry.left() + line.x() +
+                                 line.naturalTextWidth() + spacing,
+                             geometry.top() + line.y() + line.ascent()),
+                     text);
+  }
+}
+
+void CodeEditor::paintErrorOverlay(QPaintEvent *event) {
+  if (!m_errors || m_errors->empty())
+    return;
+  const auto &errors = m_errors->toMap();
+
+  QPainter painter(viewport());
+  painter.setPen(QPen(Qt::red, 1));
+  const int amplitude = 2;
+  const QPointF offset = contentOffset();
+  for (QTextBlock block = firstVisibleBlock(); block.isValid();
+       block = block.next()) {
+    const QRectF geometry = blockBoundingGeometry(block).translated(offset);
+    if (geometry.top() > event->rect().bottom())
+      break;
+    if (!block.isVisible() || !errors.count(block.firstLineNumber()))
+      continue;
+
+    // Wave underline the text of each line of the block.
+    const QTextLayout *layout = block.layout();
+    for (int i = 0; i < layout->lineCount(); ++i) {
+      const QTextLine line = layout->lineAt(i);
+      const qreal y = geometry.top() + line.y() + line.ascent() + amplitude;
+      const qreal left = geometry.left() + line.x();
+      const qreal right = left + std::max<qreal>(line.naturalTextWidth(), 8);
+      QPainterPath wave(QPointF(left, y));
+      bool up = true;
+      for (qreal x = left + amplitude; x <= right; x += amplitude) {
+        wave.lineTo(x, up ? y - amplitude : y);
+        up = !up;
+      }
+      painter.drawPath(wave);
+    }
   }
 }
 
@@ -321,8 +415,12 @@ bool CodeEditor::event(QEvent *event) {
     QTextCursor textAtCursor = cursorForPosition(helpEvent->pos());
     const int row = textAtCursor.block().firstLineNumber();
 
+    const auto hazards = m_hazards.find(textAtCursor.block().blockNumber());
     if (m_errors && m_errors->toMap().count(row) != 0) {
       QToolTip::showText(helpEvent->globalPos(), m_errors->toMap().at(row));
+    } else if (hazards != m_hazards.end()) {
+      QToolTip::showText(helpEvent->globalPos(),
+                         hazards->second.descriptions.join('\n'));
     } else {
       QToolTip::hideText();
       event->ignore();
@@ -361,21 +459,21 @@ void CodeEditor::setSourceType(SourceType type,
   case SourceType::Assembly: {
     auto *isa = ProcessorHandler::currentISA();
     if (isa->isaID() == ISA::RV32I || isa->isaID() == ISA::RV64I) {
-      m_highlighter = std::make_unique<RVSyntaxHighlighter>(
-          document(), m_errors, supportedOpcodes);
+      m_highlighter =
+          std::make_unique<RVSyntaxHighlighter>(document(), supportedOpcodes);
     } else {
       Q_ASSERT(false && "Unknown ISA selected");
     }
     break;
   }
   case SourceType::C:
-    m_highlighter = std::make_unique<CSyntaxHighlighter>(document(), m_errors);
+    m_highlighter = std::make_unique<CSyntaxHighlighter>(document());
     break;
   default:
     break;
   }
-
-  m_highlighter->rehighlight();
+  // Attaching the highlighter to the document schedules highlighting the
+  // document.
 }
 
 void CodeEditor::highlightCurrentLine() {
@@ -408,6 +506,11 @@ void CodeEditor::lineNumberAreaPaintEvent(QPaintEvent *event) {
 
   while (block.isValid() && top <= event->rect().bottom()) {
     if (block.isVisible() && bottom >= event->rect().top()) {
+      if (auto heat = m_heat.find(blockNumber); heat != m_heat.end()) {
+        const int alpha = 40 + static_cast<int>(heat->second * 160);
+        painter.fillRect(0, top, m_lineNumberArea->width(), bottom - top,
+                         QColor(255, 0, 0, alpha));
+      }
       QString number = QString::number(blockNumber + 1);
       painter.setPen(QColorConstants::Gray.darker(130));
       painter.drawText(0, top, m_lineNumberArea->width() - 3,
@@ -422,23 +525,16 @@ void CodeEditor::lineNumberAreaPaintEvent(QPaintEvent *event) {
 }
 
 void CodeEditor::updateHighlighting() {
-  clearBlockHighlights();
-
-  if (!RipesSettings::value(RIPES_SETTING_EDITORSTAGEHIGHLIGHTING).toBool())
+  std::vector<Highlight> highlights;
+  if (!RipesSettings::cached<SettingId::EditorStageHighlighting>() ||
+      !isSourceInSync()) {
+    setBlockHighlights(highlights);
     return;
+  }
 
   auto *proc = ProcessorHandler::getProcessor();
-  auto program = ProcessorHandler::getProgram().get();
-
-  // Is the current source in sync with the in-memory source?
-  if (!program || !program->isSameSource(document()->toPlainText().toUtf8()))
-    return;
-
-  auto sourceMapping = program->sourceMapping;
-
-  // Do nothing if no soruce mappings are available.
-  if (sourceMapping.empty())
-    return;
+  const auto program = ProcessorHandler::getProgram();
+  const auto &sourceMapping = program->sourceMapping;
 
   // Iterate over the processor stages and use the source mappings to determine
   // the source line which originated the instruction.
@@ -463,12 +559,104 @@ void CodeEditor::updateHighlighting() {
 
         // Record the stage name for the highlighted block for later painting
         QString stageString = ProcessorHandler::getProcessor()->stageName(sid);
-        if (!stageInfo.namedState.isEmpty())
-          stageString += " (" + stageInfo.namedState + ")";
-        highlightBlock(block, stageColor, stageString);
+        if (stageInfo.namedState != NamedStates::None)
+          stageString +=
+              " (" + NamedStates::name(stageInfo.namedState) + ")";
+        highlights.push_back({block, stageColor, stageString});
+      }
+    }
+  }
+  setBlockHighlights(highlights);
+}
+
+bool CodeEditor::isSourceInSync() {
+  auto program = ProcessorHandler::getProgram();
+  if (!program)
+    return false;
+  // Hashing the source is only repeated once it or the program changed.
+  const int revision = document()->revision();
+  if (program != m_syncedProgram.lock() || revision != m_syncedRevision) {
+    m_syncedProgram = program;
+    m_syncedRevision = revision;
+    m_sourceInSync = program->isSameSource(document()->toPlainText().toUtf8());
+  }
+  return m_sourceInSync;
+}
+
+void CodeEditor::updateProfiler() {
+  const bool enabled =
+      RipesSettings::value(RIPES_SETTING_EDITORHEATMAP).toBool();
+  if (enabled == static_cast<bool>(m_profiler))
+    return;
+
+  // Observers may only be attached and detached while the processor is not
+  // running.
+  ProcessorHandler::stopRun();
+  if (enabled)
+    m_profiler = std::make_unique<SourceProfiler>();
+  else
+    m_profiler.reset();
+  m_heat.clear();
+  updateHeatMap();
+}
+
+void CodeEditor::updateHeatMap() {
+  // The profile is written by the simulation thread while running.
+  if (ProcessorHandler::isRunning())
+    return;
+
+  m_heat.clear();
+  auto program = ProcessorHandler::getProgram();
+  if (m_profiler && program &&
+      program->isSameSource(document()->toPlainText().toUtf8())) {
+    const auto lines = m_profiler->sourceMappedLines();
+    unsigned long long hottest = 0;
+    for (const auto &line : lines)
+      hottest = std::max(hottest, line.second.cycles);
+    for (const auto &line : lines) {
+      if (line.second.cycles != 0)
+        m_heat[line.first] = static_cast<double>(line.second.cycles) / hottest;
+    }
+  }
+  m_lineNumberArea->update();
+}
+
+void CodeEditor::updateHazards() {
+  auto program = ProcessorHandler::getProgram();
+  const bool enabled =
+      RipesSettings::value(RIPES_SETTING_EDITORHAZARDS).toBool();
+  const int processor = ProcessorHandler::getID();
+  if (!enabled || !program) {
+    if (m_hazardProgram) {
+      m_hazards.clear();
+      m_hazardProgram.reset();
+      viewport()->update();
+    }
+    return;
+  }
+  if (program == m_hazardProgram && processor == m_hazardProcessor)
+    return;
+
+  m_hazards.clear();
+  m_hazardProgram = program;
+  m_hazardProcessor = processor;
+  HazardAnalysis analysis;
+  if (program->isSameSource(document()->toPlainText().toUtf8()) &&
+      analyzeHazards(ProcessorHandler::getID(), analysis).isEmpty()) {
+    for (const auto &hazard : analysis.hazards) {
+      const auto lines = program->sourceMapping.find(hazard.address);
+      if (lines == program->sourceMapping.end())
+        continue;
+      for (const auto line : lines->second) {
+        auto &annotation = m_hazards[line];
+        annotation.stalls += hazard.stalls;
+        annotation.unresolved += hazard.resolved ? 0 : 1;
+        annotation.descriptions << "0x" + QString::number(hazard.address, 16) +
+                                       ": " + hazard.describe();
       }
     }
   }
+  viewport()->update();
 }
 
 } // namespace Ripes
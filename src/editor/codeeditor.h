@@ -11,6 +11,7 @@
 #include "highlightabletextedit.h"
 #include "syntaxhighlighter.h"
 
+#include <map>
 #include <memory>
 #include <set>
 
@@ -20,23 +21,27 @@
 namespace Ripes {
 
 class LineNumberArea;
+class SourceProfiler;
 
 class CodeEditor : public HighlightableTextEdit {
   Q_OBJECT
 public:
   CodeEditor(QWidget *parent = nullptr);
+  ~CodeEditor() override;
 
   void setSourceType(SourceType type,
                      const std::set<QString> &supportedOpcodes);
   void lineNumberAreaPaintEvent(QPaintEvent *event);
   int lineNumberAreaWidth();
   void setupChangedTimer();
-  void rehighlight();
   void onSave();
 
   void setErrors(const std::shared_ptr<Assembler::Errors> &errors) {
     m_errors = errors;
   }
+  /// Repaints the error overlay, after the errors set through setErrors() have
+  /// changed. The document is not rehighlighted.
+  void updateErrors() { viewport()->update(); }
 
 signals:
   /**
@@ -49,6 +54,7 @@ signals:
   void timedTextChanged();
 
 protected:
+  void paintEvent(QPaintEvent *event) override;
   void resizeEvent(QResizeEvent *event) override;
   bool event(QEvent *e) override;
   void updateHighlighting();
@@ -59,6 +65,22 @@ private slots:
   void updateSidebar(const QRect &, int);
 
 private:
+  /// Returns true if the source of the editor is that of the current program.
+  bool isSourceInSync();
+  /// Underlines the visible lines with errors.
+  void paintErrorOverlay(QPaintEvent *event);
+  /// Starts or stops profiling the source lines of the program, as given by
+  /// the heat map setting.
+  void updateProfiler();
+  /// Recomputes the heat of each source line from the profile, if the
+  /// processor is not running.
+  void updateHeatMap();
+  /// Annotates the source lines of the program with the pipeline hazards
+  /// predicted for the current processor, as given by the hazards setting.
+  void updateHazards();
+  /// Draws the hazard annotations right of the text of the visible lines.
+  void paintHazardOverlay(QPaintEvent *event);
+
   std::unique_ptr<SyntaxHighlighter> m_highlighter;
 
   LineNumberArea *m_lineNumberArea;
@@ -68,6 +90,28 @@ private:
   SourceType m_sourceType = SourceType::Assembly;
   std::shared_ptr<Assembler::Errors> m_errors;
 
+  std::unique_ptr<SourceProfiler> m_profiler;
+  // The cycles of each (0-indexed) source line, relative to those of the
+  // hottest line.
+  std::map<unsigned, double> m_heat;
+
+  struct HazardAnnotation {
+    unsigned stalls = 0;
+    unsigned unresolved = 0;
+    QStringList descriptions;
+  };
+  // The predicted hazards of each (0-indexed) source line, and the program and
+  // processor which they were predicted for.
+  std::map<unsigned, HazardAnnotation> m_hazards;
+  std::shared_ptr<const Program> m_hazardProgram;
+  int m_hazardProcessor = -1;
+
+  // The program and document revision as of which the source was last compared
+  // to that of the program, and whether they matched.
+  std::weak_ptr<const Program> m_syncedProgram;
+  int m_syncedRevision = -1;
+  bool m_sourceInSync = false;
+
   QFont m_font;
 
   // A timer is needed for only catching one of the multiple wheel events that
@@ -4,107 +4,89 @@
 
 namespace Ripes {
 
-CSyntaxHighlighter::CSyntaxHighlighter(
-    QTextDocument *parent, std::shared_ptr<Assembler::Errors> errors)
-    : SyntaxHighlighter(parent, errors) {
-  HighlightingRule rule;
-
-  errorFormat.setUnderlineStyle(QTextCharFormat::WaveUnderline);
-  errorFormat.setUnderlineColor(Qt::red);
-
+static bool isWordChar(QChar c) { return c.isLetterOrNumber() || c == '_'; }
+
+CSyntaxHighlighter::CSyntaxHighlighter(QTextDocument *parent)
+    : SyntaxHighlighter(parent),
+      m_keywords({"const", "enum", "inline", "short", "static", "struct",
+                  "typedef", "typename", "union", "volatile", "break", "case",
+                  "if", "else", "do", "while", "continue", "for", "extern",
+                  "goto", "switch", "register", "return", "sizeof", "__asm__",
+                  "asm"}),
+      m_types({"char", "float", "double", "int", "long", "short", "signed",
+               "unsigned", "void", "bool"}) {
   keywordFormat.setForeground(Qt::darkBlue);
   keywordFormat.setFontWeight(QFont::Bold);
-  const QString keywordPatterns[] = {
-      QStringLiteral("\\bconst\\b"),    QStringLiteral("\\benum\\b"),
-      QStringLiteral("\\binline\\b"),   QStringLiteral("\\bshort\\b"),
-      QStringLiteral("\\bstatic\\b"),   QStringLiteral("\\bstruct\\b"),
-      QStringLiteral("\\btypedef\\b"),  QStringLiteral("\\btypename\\b"),
-      QStringLiteral("\\bunion\\b"),    QStringLiteral("\\bvolatile\\b"),
-      QStringLiteral("\\bbreak\\b"),    QStringLiteral("\\bcase\\b"),
-      QStringLiteral("\\bif\\b"),       QStringLiteral("\\belse\\b"),
-      QStringLiteral("\\bdo\\b"),       QStringLiteral("\\bwhile\\b"),
-      QStringLiteral("\\bcontinue\\b"), QStringLiteral("\\bfor\\b"),
-      QStringLiteral("\\bextern\\b"),   QStringLiteral("\\bgoto\\b"),
-      QStringLiteral("\\bswitch\\b"),   QStringLiteral("\\bregister\\b"),
-      QStringLiteral("\\breturn\\b"),   QStringLiteral("\\bsizeof\\b"),
-      QStringLiteral("\\b__asm__\\b"),  QStringLiteral("\\basm\\b")};
-
-  for (const QString &pattern : keywordPatterns) {
-    rule.pattern = QRegularExpression(pattern);
-    rule.format = keywordFormat;
-    highlightingRules.append(rule);
-  }
-
   typeFormat.setForeground(Qt::darkBlue);
   typeFormat.setFontWeight(QFont::Bold);
-  const QString typePatterns[] = {
-      QStringLiteral("\\bchar\\b"),   QStringLiteral("\\bfloat\\b"),
-      QStringLiteral("\\bdouble\\b"), QStringLiteral("\\bint\\b"),
-      QStringLiteral("\\blong\\b"),   QStringLiteral("\\bshort\\b"),
-      QStringLiteral("\\bsigned\\b"), QStringLiteral("\\bunsigned\\b"),
-      QStringLiteral("\\bvoid\\b"),   QStringLiteral("\\bbool\\b")};
-  for (const QString &pattern : typePatterns) {
-    rule.pattern = QRegularExpression(pattern);
-    rule.format = typeFormat;
-    highlightingRules.append(rule);
-  }
-
   singleLineCommentFormat.setForeground(Colors::Medalist);
-  rule.pattern = QRegularExpression(QStringLiteral("//[^\n]*"));
-  rule.format = singleLineCommentFormat;
-  highlightingRules.append(rule);
-
   multiLineCommentFormat.setForeground(Colors::Medalist);
-
   preprocessorFormat.setForeground(QColorConstants::DarkMagenta);
-  rule.pattern = QRegularExpression(QStringLiteral("^\\ *#[^ ]*"));
-  rule.format = preprocessorFormat;
-  highlightingRules.append(rule);
-
   quotationFormat.setForeground(QColor{0x80, 0x00, 0x00});
-  rule.pattern = QRegularExpression(QStringLiteral("\".*\""));
-  rule.format = quotationFormat;
-  highlightingRules.append(rule);
-
   functionFormat.setForeground(Colors::BerkeleyBlue);
-  rule.pattern = QRegularExpression(QStringLiteral("\\b[A-Za-z0-9_]+(?=\\()"));
-  rule.format = functionFormat;
-  highlightingRules.append(rule);
-
-  commentStartExpression = QRegularExpression(QStringLiteral("/\\*"));
-  commentEndExpression = QRegularExpression(QStringLiteral("\\*/"));
-} // namespace Ripes
+}
 
 void CSyntaxHighlighter::syntaxHighlightBlock(const QString &text) {
-  for (const HighlightingRule &rule : qAsConst(highlightingRules)) {
-    QRegularExpressionMatchIterator matchIterator =
-        rule.pattern.globalMatch(text);
-    while (matchIterator.hasNext()) {
-      QRegularExpressionMatch match = matchIterator.next();
-      setFormat(match.capturedStart(), match.capturedLength(), rule.format);
+  const int n = text.size();
+  int i = 0;
+  setCurrentBlockState(0);
+
+  // Formats the multi-line comment starting at i, possibly continuing past
+  // this block.
+  const auto comment = [&](int commentStart) {
+    const int end = text.indexOf(QStringLiteral("*/"), commentStart);
+    if (end == -1) {
+      setCurrentBlockState(s_inComment);
+      setFormat(i, n - i, multiLineCommentFormat);
+      i = n;
+    } else {
+      setFormat(i, end + 2 - i, multiLineCommentFormat);
+      i = end + 2;
     }
-  }
+  };
 
-  setCurrentBlockState(0);
+  if (previousBlockState() == s_inComment)
+    comment(0);
 
-  int startIndex = 0;
-  if (previousBlockState() != 1)
-    startIndex = text.indexOf(commentStartExpression);
+  // Preprocessor directives, which may be indented by spaces.
+  if (i == 0) {
+    const int hash = wordEnd(text, 0, [](QChar c) { return c == ' '; });
+    if (hash < n && text[hash] == '#') {
+      i = wordEnd(text, hash, [](QChar c) { return c != ' '; });
+      setFormat(hash, i - hash, preprocessorFormat);
+    }
+  }
 
-  while (startIndex >= 0) {
-    QRegularExpressionMatch match =
-        commentEndExpression.match(text, startIndex);
-    int endIndex = match.capturedStart();
-    int commentLength = 0;
-    if (endIndex == -1) {
-      setCurrentBlockState(1);
-      commentLength = text.length() - startIndex;
-    } else {
-      commentLength = endIndex - startIndex + match.capturedLength();
+  while (i < n) {
+    const QChar c = text[i];
+    if (c == '/' && i + 1 < n && text[i + 1] == '/') {
+      setFormat(i, n - i, singleLineCommentFormat);
+      return;
+    }
+    if (c == '/' && i + 1 < n && text[i + 1] == '*') {
+      comment(i + 2);
+      continue;
     }
-    setFormat(startIndex, commentLength, multiLineCommentFormat);
-    startIndex =
-        text.indexOf(commentStartExpression, startIndex + commentLength);
+    if (c == '"') {
+      const int end = stringEnd(text, i);
+      setFormat(i, end - i, quotationFormat);
+      i = end;
+      continue;
+    }
+    if (!isWordChar(c)) {
+      ++i;
+      continue;
+    }
+
+    const int end = wordEnd(text, i, isWordChar);
+    const QString word = text.mid(i, end - i);
+    if (m_keywords.count(word))
+      setFormat(i, end - i, keywordFormat);
+    else if (m_types.count(word))
+      setFormat(i, end - i, typeFormat);
+    else if (end < n && text[end] == '(')
+      setFormat(i, end - i, functionFormat);
+    i = end;
   }
 }
 
@@ -1,7 +1,8 @@
 #pragma once
 
-#include <QRegularExpression>
+#include <unordered_set>
 
+#include "assembler/program.h"
 #include "syntaxhighlighter.h"
 
 /** Heavily based on QT's rich text syntax highlighter example.
@@ -12,19 +13,15 @@ namespace Ripes {
 
 class CSyntaxHighlighter : public SyntaxHighlighter {
 public:
-  CSyntaxHighlighter(QTextDocument *parent = nullptr,
-                     std::shared_ptr<Assembler::Errors> errors = {});
+  CSyntaxHighlighter(QTextDocument *parent = nullptr);
   void syntaxHighlightBlock(const QString &text) override;
 
 private:
-  struct HighlightingRule {
-    QRegularExpression pattern;
-    QTextCharFormat format;
-  };
-  QVector<HighlightingRule> highlightingRules;
-
-  QRegularExpression commentStartExpression;
-  QRegularExpression commentEndExpression;
+  /// Block state of a block ending within a multi-line comment.
+  static constexpr int s_inComment = 1;
+
+  std::unordered_set<QString, QStringHash> m_keywords;
+  std::unordered_set<QString, QStringHash> m_types;
 
   QTextCharFormat keywordFormat;
   QTextCharFormat typeFormat;
@@ -69,10 +69,30 @@ void HighlightableTextEdit::clearBlockHighlights() {
   m_highlightedBlocksText.clear();
   m_highlightedBlocks.clear();
   m_blockHighlights.clear();
+  m_setHighlights.reset();
   viewport()->update();
   update();
 }
 
+void HighlightableTextEdit::setBlockHighlights(
+    const std::vector<Highlight> &highlights) {
+  std::vector<std::tuple<int, QRgb, QString>> keys;
+  keys.reserve(highlights.size());
+  for (const auto &highlight : highlights) {
+    if (highlight.block.isValid())
+      keys.emplace_back(highlight.block.blockNumber(), highlight.color.rgba(),
+                        highlight.text);
+  }
+  if (m_setHighlights == keys)
+    return;
+
+  clearBlockHighlights();
+  for (const auto &highlight : highlights)
+    addBlockHighlight(highlight.block, highlight.color, highlight.text);
+  applyHighlighting();
+  m_setHighlights = std::move(keys);
+}
+
 void HighlightableTextEdit::resizeEvent(QResizeEvent *e) {
   QPlainTextEdit::resizeEvent(e);
   applyHighlighting();
@@ -83,18 +103,27 @@ void HighlightableTextEdit::highlightBlock(const QTextBlock &block,
                                            const QString &text) {
   if (!block.isValid())
     return;
+  m_setHighlights.reset();
+  addBlockHighlight(block, color, text);
+  applyHighlighting();
+}
+
+void HighlightableTextEdit::addBlockHighlight(const QTextBlock &block,
+                                              const QColor &color,
+                                              const QString &text) {
+  if (!block.isValid())
+    return;
   if (!text.isEmpty())
     m_highlightedBlocksText[block].push_back(text);
 
   // Check if we're already highlighting the block. If this is the case, do not
   // set an additional highlight on it.
-  if (m_highlightedBlocks.count(block))
+  if (!m_highlightedBlocks.insert(block).second)
     return;
   m_blockHighlights.push_back({});
   auto &highlight = m_blockHighlights.back();
   highlight.blockNumber = block.blockNumber();
   highlight.color = color;
-  applyHighlighting();
 }
 
 std::optional<QTextEdit::ExtraSelection>
@@ -4,10 +4,13 @@
 #include <QObject>
 #include <QPlainTextEdit>
 #include <QScrollBar>
+#include <QTextBlock>
 #include <QTimer>
 
 #include <optional>
 #include <set>
+#include <tuple>
+#include <vector>
 
 namespace Ripes {
 
@@ -29,6 +32,12 @@ class HighlightableTextEdit : public QPlainTextEdit {
   };
 
 public:
+  struct Highlight {
+    QTextBlock block;
+    QColor color;
+    QString text;
+  };
+
   HighlightableTextEdit(QWidget *parent = nullptr);
   void paintEvent(QPaintEvent *e) override;
   /// Adds a highlight to the given block. An optional string may be provided,
@@ -37,6 +46,11 @@ public:
                       const QString &text = QString());
   /// Clears any currently active block highlightings.
   void clearBlockHighlights();
+  /// Replaces the active block highlightings by @p highlights, as if
+  /// highlighting each in order, and applies them at once. Does nothing if the
+  /// highlights are those already active, such that views refreshing their
+  /// highlights each frame only repaint once these change.
+  void setBlockHighlights(const std::vector<Highlight> &highlights);
 
 protected:
   void resizeEvent(QResizeEvent *event) override;
@@ -47,6 +61,9 @@ private:
   std::optional<QTextEdit::ExtraSelection>
   getExtraSelection(const HighlightableTextEdit::BlockHighlight &highlighting);
   void applyHighlighting();
+  /// Adds a highlight without applying it.
+  void addBlockHighlight(const QTextBlock &block, const QColor &color,
+                         const QString &text);
 
   /// A list of strings which will be printed at the right-hand side of each
   /// block
@@ -55,6 +72,9 @@ private:
   std::set<QTextBlock> m_highlightedBlocks;
   /// A list containing the current highlightings being applied
   QList<BlockHighlight> m_blockHighlights;
+  /// The block number, color and text of each highlight set through
+  /// setBlockHighlights(), unless the highlights were since modified.
+  std::optional<std::vector<std::tuple<int, QRgb, QString>>> m_setHighlights;
 };
 
 } // namespace Ripes
@@ -4,79 +4,75 @@
 
 namespace Ripes {
 
-RVSyntaxHighlighter::RVSyntaxHighlighter(
-    QTextDocument *parent, std::shared_ptr<Assembler::Errors> errors,
-    const std::set<QString> &supportedOpcodes)
-    : SyntaxHighlighter(parent, errors) {
-  HighlightingRule rule;
+static bool isWordChar(QChar c) {
+  return c.isLetterOrNumber() || c == '_' || c == '.' || c == '$';
+}
 
-  // General registers
+RVSyntaxHighlighter::RVSyntaxHighlighter(
+    QTextDocument *parent, const std::set<QString> &supportedOpcodes)
+    : SyntaxHighlighter(parent),
+      m_opcodes(supportedOpcodes.begin(), supportedOpcodes.end()),
+      m_namedRegisters({"zero", "ra", "sp", "gp", "tp", "fp"}) {
   registerFormat.setForeground(QColor{0x80, 0x00, 0x00});
-  rule.pattern = QRegularExpression("\\b[(a|s|t|x)][0-9]{1,2}");
-  rule.format = registerFormat;
-  m_highlightingRules.append(rule);
-
-  // Name-specific registers
-  QStringList registerPatterns;
-  registerPatterns << "\\bzero\\b"
-                   << "\\bra\\b"
-                   << "\\bsp\\b"
-                   << "\\bgp\\b"
-                   << "\\btp\\b"
-                   << "\\bfp\\b";
-  for (const auto &pattern : qAsConst(registerPatterns)) {
-    rule.pattern = QRegularExpression(pattern);
-    rule.format = registerFormat;
-    m_highlightingRules.append(rule);
-  }
-
-  // Instructions
   instructionFormat.setForeground(Colors::BerkeleyBlue);
-  for (const auto &pattern : supportedOpcodes) {
-    const QString regexPattern = "\\b" + pattern + "\\b";
-    rule.pattern = QRegularExpression(regexPattern);
-    rule.format = instructionFormat;
-    m_highlightingRules.append(rule);
-  }
-
-  // Labels
   labelFormat.setForeground(Colors::Medalist);
-  rule.pattern = QRegularExpression(R"([\S]+:)");
-  rule.format = labelFormat;
-  m_highlightingRules.append(rule);
-
-  // Immediates
   immediateFormat.setForeground(QColorConstants::DarkGreen);
-  rule.pattern = QRegularExpression("\\b(?<![A-Za-z])[-+]?\\d+");
-  rule.format = immediateFormat;
-  m_highlightingRules.append(rule);
+  stringFormat.setForeground(QColor{0x80, 0x00, 0x00});
+  commentFormat.setForeground(Colors::Medalist);
+}
 
-  // Prefixed immediates (0x, 0b)
-  rule.pattern =
-      QRegularExpression("([-+]?0[xX][0-9a-fA-F]+|[-+]?0[bB][0-1]+)");
-  m_highlightingRules.append(rule);
+const QTextCharFormat *
+RVSyntaxHighlighter::wordFormat(const QString &word) const {
+  const QChar first = word[0];
+  // Immediates, including prefixed (0x, 0b) immediates.
+  if (first.isDigit() || first == '-' || first == '+')
+    return &immediateFormat;
 
-  // Strings
-  stringFormat.setForeground(QColor{0x80, 0x00, 0x00});
-  rule.pattern = QRegularExpression(R"("(?:[^"]|\.)*")");
-  rule.format = stringFormat;
-  m_highlightingRules.append(rule);
+  // Registers; a, s, t or x followed by a register number, or named.
+  if (word.size() <= 3 && word.size() >= 2 &&
+      QStringLiteral("astx").contains(first) && word[1].isDigit() &&
+      (word.size() == 2 || word[2].isDigit()))
+    return &registerFormat;
+  if (m_namedRegisters.count(word))
+    return &registerFormat;
 
-  // Comments
-  commentFormat.setForeground(Colors::Medalist);
-  rule.pattern = QRegularExpression("[#]+.*");
-  rule.format = commentFormat;
-  m_highlightingRules.append(rule);
+  if (m_opcodes.count(word))
+    return &instructionFormat;
+  return nullptr;
 }
 
 void RVSyntaxHighlighter::syntaxHighlightBlock(const QString &text) {
-  for (const HighlightingRule &rule : qAsConst(m_highlightingRules)) {
-    QRegularExpressionMatchIterator matchIterator =
-        rule.pattern.globalMatch(text);
-    while (matchIterator.hasNext()) {
-      QRegularExpressionMatch match = matchIterator.next();
-      setFormat(match.capturedStart(), match.capturedLength(), rule.format);
+  const int n = text.size();
+  int i = 0;
+  while (i < n) {
+    const QChar c = text[i];
+    if (c == '#') {
+      setFormat(i, n - i, commentFormat);
+      return;
+    }
+    if (c == '"') {
+      const int end = stringEnd(text, i);
+      setFormat(i, end - i, stringFormat);
+      i = end;
+      continue;
+    }
+
+    // Words; a sign may only start an immediate.
+    const bool signedImm =
+        (c == '-' || c == '+') && i + 1 < n && text[i + 1].isDigit();
+    if (!isWordChar(c) && !signedImm) {
+      ++i;
+      continue;
+    }
+    const int end = wordEnd(text, i + 1, isWordChar);
+    if (!signedImm && end < n && text[end] == ':') {
+      setFormat(i, end + 1 - i, labelFormat);
+      i = end + 1;
+      continue;
     }
+    if (const auto *format = wordFormat(text.mid(i, end - i)))
+      setFormat(i, end - i, *format);
+    i = end;
   }
 }
 
@@ -1,8 +1,9 @@
 #pragma once
 
-#include <QRegularExpression>
 #include <set>
+#include <unordered_set>
 
+#include "assembler/program.h"
 #include "syntaxhighlighter.h"
 
 namespace Ripes {
@@ -10,20 +11,18 @@ namespace Ripes {
 class RVSyntaxHighlighter : public SyntaxHighlighter {
 public:
   RVSyntaxHighlighter(QTextDocument *parent,
-                      std::shared_ptr<Assembler::Errors> errors,
                       const std::set<QString> &supportedOpcodes);
   void syntaxHighlightBlock(const QString &text) override;
 
 private:
-  struct HighlightingRule {
-    QRegularExpression pattern;
-    QTextCharFormat format;
-  };
-  QVector<HighlightingRule> m_highlightingRules;
+  /// Returns the format of the word @p word, or nullptr if unformatted.
+  const QTextCharFormat *wordFormat(const QString &word) const;
+
+  std::unordered_set<QString, QStringHash> m_opcodes;
+  std::unordered_set<QString, QStringHash> m_namedRegisters;
 
   QTextCharFormat registerFormat;
   QTextCharFormat labelFormat;
-  QTextCharFormat directiveFormat;
   QTextCharFormat instructionFormat;
   QTextCharFormat stringFormat;
   QTextCharFormat commentFormat;
@@ -2,21 +2,22 @@
 
 #include <QTextDocument>
 
+#include <algorithm>
+
 namespace Ripes {
-SyntaxHighlighter::SyntaxHighlighter(QTextDocument *parent,
-                                     std::shared_ptr<Assembler::Errors> errors)
-    : QSyntaxHighlighter(parent), m_errors(errors) {
-  errorFormat.setUnderlineStyle(QTextCharFormat::WaveUnderline);
-  errorFormat.setUnderlineColor(Qt::red);
-}
+SyntaxHighlighter::SyntaxHighlighter(QTextDocument *parent)
+    : QSyntaxHighlighter(parent) {}
 
 void SyntaxHighlighter::highlightBlock(const QString &text) {
-  int row = currentBlock().firstLineNumber();
-  if (m_errors && m_errors->toMap().count(row) != 0) {
-    setFormat(0, text.length(), errorFormat);
-  } else {
-    syntaxHighlightBlock(text);
-  }
+  syntaxHighlightBlock(text);
+}
+
+int SyntaxHighlighter::stringEnd(const QString &text, int start) {
+  const QChar quote = text[start];
+  int end = start + 1;
+  while (end < text.size() && text[end] != quote)
+    end += text[end] == '\\' ? 2 : 1;
+  return std::min<int>(end + 1, text.size());
 }
 
 } // namespace Ripes
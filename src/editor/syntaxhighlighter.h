@@ -1,24 +1,25 @@
 #pragma once
 
 #include <QSyntaxHighlighter>
-#include <memory>
-
-#include "assembler/assemblererror.h"
 
 namespace Ripes {
 
+/**
+ * @brief The SyntaxHighlighter class
+ * Base class of the language-specific syntax highlighters of the code editor.
+ * Highlighters lex each block in a single pass, such that highlighting is
+ * linear in the length of the document. Note that QSyntaxHighlighter only
+ * rehighlights the blocks changed by an edit (and any following blocks whose
+ * state changes). Errors are not highlighted here, but painted as an overlay by
+ * the code editor, such that updating the errors does not rehighlight the
+ * document.
+ */
 class SyntaxHighlighter : public QSyntaxHighlighter {
   Q_OBJECT
 
 public:
-  SyntaxHighlighter(QTextDocument *parent = nullptr,
-                    std::shared_ptr<Assembler::Errors> errors = {});
+  SyntaxHighlighter(QTextDocument *parent = nullptr);
 
-  /**
-   * @brief highlightBlock
-   * Performs language-independent highlighting, such as line-underlining upon
-   * an error during assembly/compilation.
-   */
   void highlightBlock(const QString &text) override final;
   /**
    * @brief syntaxHighlightBlock
@@ -27,13 +28,18 @@ public:
   virtual void syntaxHighlightBlock(const QString &text) = 0;
 
 protected:
-  /**
-   * @brief m_errors
-   * The syntax highlighter may provide a tooltip error for each line in the
-   * current text document. These tooltips will be displayed by the codeeditor
-   * when a relevant tooltip event occurs.
-   */
-  std::shared_ptr<Assembler::Errors> m_errors;
-  QTextCharFormat errorFormat;
+  /// Returns the end of the word starting at @p start within @p text, of which
+  /// each character satisfies @p isWordChar.
+  template <typename F>
+  static int wordEnd(const QString &text, int start, F isWordChar) {
+    int end = start;
+    while (end < text.size() && isWordChar(text[end]))
+      ++end;
+    return end;
+  }
+
+  /// Returns the end of the string literal opening at @p start within @p text,
+  /// or the end of the text if the literal is not closed.
+  static int stringEnd(const QString &text, int start);
 };
 } // namespace Ripes
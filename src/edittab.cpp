@@ -8,8 +8,11 @@
 #include <QLabel>
 #include <QLineEdit>
 #include <QMessageBox>
+#include <QPointer>
 #include <QPushButton>
+#include <QtConcurrent/QtConcurrent>
 
+#include "assembler/assemblycache.h"
 #include "assembler/program.h"
 
 #include "ccmanager.h"
@@ -19,6 +22,8 @@
 #include "io/iomanager.h"
 #include "processorhandler.h"
 #include "ripessettings.h"
+#include "session.h"
+#include "sourcelines.h"
 #include "symbolnavigator.h"
 
 namespace Ripes {
@@ -75,6 +80,22 @@ EditTab::EditTab(QToolBar *toolbar, QWidget *parent)
           &EditTab::enableAssemblyInput);
   connect(m_ui->codeEditor, &CodeEditor::timedTextChanged, this,
           &EditTab::sourceCodeChanged);
+  connect(&m_assembleWatcher,
+          &QFutureWatcher<Assembler::AssembleResult>::finished, this,
+          &EditTab::assembleFinished);
+  connect(&m_elfWatcher, &QFutureWatcher<ElfLoadResult>::finished, this,
+          &EditTab::elfLoadFinished);
+  connect(&m_debugInfoWatcher, &QFutureWatcher<ElfDebugInfo>::finished, this,
+          &EditTab::debugInfoFinished);
+  connect(&m_debugInfoWatcher,
+          &QFutureWatcher<ElfDebugInfo>::progressValueChanged, this,
+          [=](int progress) {
+            const int total = m_debugInfoWatcher.progressMaximum();
+            if (total > 0)
+              m_ui->curInputSrcLabel->setText(
+                  "Executable (ELF), loading debug information (" +
+                  QString::number(100 * progress / total) + "%)");
+          });
 
   m_ui->programViewer->setReadOnly(true);
 
@@ -99,8 +120,8 @@ EditTab::EditTab(QToolBar *toolbar, QWidget *parent)
   connect(ProcessorHandler::get(), &ProcessorHandler::runFinished,
           m_buildAction,
           [=] { m_buildAction->setEnabled(m_ui->setCInput->isChecked()); });
-  connect(ProcessorHandler::get(), &ProcessorHandler::procStateChangedNonRun,
-          this, &EditTab::updateProgramViewerHighlighting);
+  ProcessorHandler::getRefreshScheduler().addClient(
+      this, [=] { updateProgramViewerHighlighting(); });
   connect(ProcessorHandler::get(), &ProcessorHandler::programChanged, this,
           &EditTab::updateProgramViewer);
   connect(ProcessorHandler::get(), &ProcessorHandler::processorChanged, this,
@@ -149,7 +170,7 @@ EditTab::EditTab(QToolBar *toolbar, QWidget *parent)
 
 void EditTab::showSymbolNavigator() {
   if (auto program = ProcessorHandler::getProgram()) {
-    SymbolNavigator nav(program->symbols, this);
+    SymbolNavigator nav(program->getSymbolIndex(), this);
     if (nav.exec()) {
       m_ui->programViewer->setCenterAddress(nav.getSelectedSymbolAddress());
     }
@@ -178,7 +199,35 @@ bool EditTab::loadExternalFile(const LoadFileParams &params) {
   return false;
 }
 
+bool EditTab::loadSession(const Session &session, const QString &filepath) {
+  // An assembly of the previous source must not replace the session program.
+  cancelAssembly();
+  cancelElfLoad();
+  if (session.sourceType == SourceType::Assembly ||
+      session.sourceType == SourceType::C) {
+    enableEditor();
+    if (session.sourceType == SourceType::C)
+      m_ui->setCInput->setChecked(true);
+    else
+      m_ui->setAssemblyInput->setChecked(true);
+    // Fails if no compiler is available for C input.
+    if (m_currentSourceType != session.sourceType)
+      return false;
+    m_sessionProgram = session.program;
+    setSourceText(session.source);
+  } else {
+    m_currentSourceType = session.sourceType;
+    m_ui->curInputSrcLabel->setText("Session");
+    m_ui->inputSrcPath->setText(filepath);
+    disableEditor();
+  }
+  ProcessorHandler::loadProgram(session.program);
+  return true;
+}
+
 bool EditTab::loadFile(const LoadFileParams &fileParams) {
+  // Any ELF file being loaded is superseded.
+  cancelElfLoad();
   QFile file(fileParams.filepath);
   if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
     QMessageBox::warning(this, "Error",
@@ -208,17 +257,19 @@ bool EditTab::loadFile(const LoadFileParams &fileParams) {
     }
     break;
   }
-  case SourceType::InternalELF: {
-    success &= loadElfFile(*loadedProgram, file);
-    break;
-  }
+  case SourceType::InternalELF:
   case SourceType::ExternalELF: {
     // Since there is no related source code for an externally compiled ELF, the
     // editor is disabled
-    disableEditor();
-    success &= loadElfFile(*loadedProgram, file);
-    break;
+    if (fileParams.type == SourceType::ExternalELF)
+      disableEditor();
+    // The program is loaded once read by a worker thread.
+    return loadElfFile(file);
   }
+  case SourceType::Session:
+    // Sessions also restore the simulator configuration (see loadSession).
+    success = false;
+    break;
   }
 
   if (success) {
@@ -282,20 +333,32 @@ void EditTab::sourceTypeChanged() {
 }
 
 void EditTab::onProcessorChanged() {
+  // The program of a session is assembled for the processor of the session.
+  m_sessionProgram.reset();
+
   // Notify a possible assembler change to the code editor - opcodes might have
   // been added or removed which must be reflected in the syntax highlighter
   m_ui->codeEditor->setSourceType(
       m_currentSourceType, ProcessorHandler::getAssembler()->getOpcodes());
 
+  // The program is reassembled upon each edit; only reassemble what changed.
+  ProcessorHandler::getAssembler()->setIncremental(true);
+
   // Try reassembling
   sourceCodeChanged();
 }
 
 void EditTab::sourceCodeChanged() {
   switch (m_currentSourceType) {
-  case SourceType::Assembly:
+  case SourceType::Assembly: {
+    // The source of a loaded session need not be reassembled.
+    const auto sessionProgram = m_sessionProgram.lock();
+    if (sessionProgram && sessionProgram == ProcessorHandler::getProgram() &&
+        sessionProgram->isSameSource(getAssemblyText().toUtf8()))
+      break;
     assemble();
     break;
+  }
   default:
     // Do nothing, either some external program is loaded or, if compiling from
     // C, the user shall manually select to build
@@ -304,45 +367,87 @@ void EditTab::sourceCodeChanged() {
 }
 
 void EditTab::assemble() {
-  auto res = ProcessorHandler::getAssembler()->assembleRaw(
-      m_ui->codeEditor->document()->toPlainText(),
-      &IOManager::get().assemblerSymbols());
+  m_assembleGeneration++;
+  if (m_assembleWatcher.isRunning()) {
+    m_assemblePending = true;
+    return;
+  }
+  m_assemblePending = false;
+  m_runningGeneration = m_assembleGeneration;
+
+  // The worker assembles a snapshot of the source and symbols, and keeps the
+  // assembler alive should the processor change meanwhile.
+  const auto assembler = ProcessorHandler::getAssembler();
+  const QString source = m_ui->codeEditor->document()->toPlainText();
+  const Assembler::SymbolMap symbols = IOManager::get().assemblerSymbols();
+  m_assembleWatcher.setFuture(QtConcurrent::run([=] {
+    return Assembler::AssemblyCache::get().assemble(*assembler, source,
+                                                    &symbols);
+  }));
+}
+
+void EditTab::cancelAssembly() {
+  m_assembleGeneration++;
+  m_assemblePending = false;
+}
+
+void EditTab::assembleFinished() {
+  if (m_runningGeneration != m_assembleGeneration) {
+    // Superseded by an edit, or cancelled.
+    if (m_assemblePending)
+      assemble();
+    return;
+  }
+
+  const auto res = m_assembleWatcher.result();
   *m_sourceErrors = res.errors;
   if (m_sourceErrors->size() == 0) {
     ProcessorHandler::loadProgram(std::make_shared<Program>(res.program));
   } else {
-    // Errors occured; rehighlight will reflect current m_sourceErrors in the
-    // editor.
+    // Errors occured; the error overlay of the editor will reflect the current
+    // m_sourceErrors.
 #ifndef NDEBUG
     // Ensure only valid error messages are present.
     for (auto &err : *m_sourceErrors)
       assert(err.isKnownSourceLine());
 #endif
   }
-  m_ui->codeEditor->rehighlight();
+  m_ui->codeEditor->updateErrors();
 }
 
 void EditTab::compile() {
   // We don't care about asking our editor for syntax accepted, since there is
   // no C-syntax checking in Ripes.
-  auto res = CCManager::get().compile(m_ui->codeEditor->document());
-  if (res.success) {
-    // Compilation successful; load file through standard file loading functions
-    LoadFileParams params;
-    params.filepath = res.outFile;
-    params.type = SourceType::InternalELF;
-    loadFile(params);
-    // Clean up temporary source and output files
-  } else if (!res.aborted) {
-    CompilerErrorDialog errDiag(this);
-    errDiag.setText("Compilation failed. Error output was:");
-    errDiag.setErrorText(CCManager::getError());
-    errDiag.exec();
-  }
-  res.clean();
+  // Compilation is asynchronous; the editor remains live meanwhile.
+  QPointer<EditTab> tab(this);
+  CCManager::get().compileAsync(
+      m_ui->codeEditor->document(), [tab](const CCManager::CCRes &res) {
+        if (tab && res.success) {
+          // Compilation successful; load file through standard file loading
+          // functions
+          LoadFileParams params;
+          params.filepath = res.outFile;
+          params.type = SourceType::InternalELF;
+          tab->loadFile(params);
+        } else if (tab && !res.aborted) {
+          CompilerErrorDialog errDiag(tab);
+          errDiag.setText("Compilation failed. Error output was:");
+          errDiag.setErrorText(res.errorOutput._stderr);
+          errDiag.exec();
+        }
+        // Clean up temporary output file
+        res.clean();
+      });
 }
 
-EditTab::~EditTab() { delete m_ui; }
+EditTab::~EditTab() {
+  cancelAssembly();
+  m_assembleWatcher.waitForFinished();
+  cancelElfLoad();
+  m_elfWatcher.waitForFinished();
+  m_debugInfoWatcher.waitForFinished();
+  delete m_ui;
+}
 
 void EditTab::newProgram() {
   m_ui->codeEditor->clear();
@@ -355,6 +460,7 @@ void EditTab::setSourceText(const QString &text) {
 }
 
 void EditTab::enableAssemblyInput() {
+  cancelElfLoad();
   // Clear currently loaded binary/ELF program
   updateProgramViewer();
   enableEditor();
@@ -373,6 +479,8 @@ void EditTab::enableEditor() {
 }
 
 void EditTab::disableEditor() {
+  // An externally loaded program replaces that of the editor.
+  cancelAssembly();
   m_ui->editorStackedWidget->setCurrentIndex(1);
   clearAssemblyEditor();
   m_editorEnabled = false;
@@ -392,25 +500,6 @@ bool EditTab::loadSourceFile(Program &, QFile &file) {
 }
 
 using namespace ELFIO;
-class ELFIODwarfLoader : public ::dwarf::loader {
-public:
-  ELFIODwarfLoader(elfio &reader) : reader(reader) {}
-
-  const void *load(::dwarf::section_type section, size_t *size_out) override {
-    auto sec = reader.sections[::dwarf::elf::section_type_to_name(section)];
-    if (sec == nullptr)
-      return nullptr;
-    *size_out = sec->get_size();
-    return sec->get_data();
-  }
-
-private:
-  elfio &reader;
-};
-
-std::shared_ptr<ELFIODwarfLoader> createDwarfLoader(elfio &reader) {
-  return std::make_shared<ELFIODwarfLoader>(reader);
-}
 
 static bool isInternalSourceFile(const QString &filename) {
   // Returns true if we have reason to believe that this file originated from
@@ -420,25 +509,30 @@ static bool isInternalSourceFile(const QString &filename) {
   return re.match(filename).hasMatch();
 }
 
-bool EditTab::loadElfFile(Program &program, QFile &file) {
-  ELFIO::elfio reader;
-
-  // No file validity checking is performed - it is expected that Loaddialog has
-  // done all validity checking.
-  if (!reader.load(file.fileName().toStdString())) {
-    assert(false);
-  }
-
+// Reads the sections and function symbols of the ELF file of @p reader into
+// @p program. Section data is referenced from @p mapped, the mapping of the
+// file, where possible.
+static void readElfSections(ELFIO::elfio &reader, Program &program,
+                            const char *mapped, qint64 mappedSize) {
   for (const auto &elfSection : reader.sections) {
     // Do not load .debug sections
     if (!QString::fromStdString(elfSection->get_name()).startsWith(".debug")) {
       ProgramSection section;
       section.name = QString::fromStdString(elfSection->get_name());
       section.address = elfSection->get_address();
-      // QByteArray performs a deep copy of the data when the data array is
-      // initialized at construction
-      section.data = QByteArray(elfSection->get_data(),
-                                static_cast<int>(elfSection->get_size()));
+      const bool inFile =
+          elfSection->get_type() != SHT_NOBITS &&
+          elfSection->get_offset() + elfSection->get_size() <=
+              static_cast<ELFIO::Elf64_Off>(mappedSize);
+      if (mapped && inFile) {
+        section.data = mappedData(mapped, elfSection->get_offset(),
+                                  elfSection->get_size());
+      } else {
+        // QByteArray performs a deep copy of the data when the data array is
+        // initialized at construction
+        section.data = QByteArray(elfSection->get_data(),
+                                  static_cast<int>(elfSection->get_size()));
+      }
       program.sections[section.name] = section;
     }
 
@@ -462,53 +556,162 @@ bool EditTab::loadElfFile(Program &program, QFile &file) {
       }
     }
   }
+  program.entryPoint = reader.get_entry();
+}
+
+// Loads the debug information of the ELF file of @p reader, reporting the
+// progress through (and stopping when cancelled by) @p future.
+static ElfDebugInfo readElfDebugInfo(ELFIO::elfio &reader,
+                                     QFutureInterface<ElfDebugInfo> &future) {
+  ElfDebugInfo info;
 
   // Load DWARF information into the source mapping of the program.
   // We'll only load information from compilation units which originated from a
-  // source file that plausibly arrived from within the Ripes editor.
-  QString editorSrcFile;
-  try {
-    ::dwarf::dwarf dw(createDwarfLoader(reader));
-    for (auto &cu : dw.compilation_units()) {
-      for (auto &line : cu.get_line_table()) {
-        if (!line.file)
+  // source file that plausibly arrived from within the Ripes editor. Units are
+  // identified by the name of their primary source file, such that the line
+  // tables of other units (ie. of a statically linked C library) need not be
+  // decoded.
+  if (reader.sections[".debug_info"] != nullptr &&
+      reader.sections[".debug_line"] != nullptr) {
+    QString editorSrcFile;
+    try {
+      ::dwarf::dwarf dw(createDwarfLoader(reader));
+      for (auto &cu : dw.compilation_units()) {
+        if (future.isCanceled())
+          return info;
+        const auto &root = cu.root();
+        if (!root.has(::dwarf::DW_AT::name) ||
+            !isInternalSourceFile(
+                QString::fromStdString(::dwarf::at_name(root))))
           continue;
-        QString filePath = QString::fromStdString(line.file->path);
-        if (editorSrcFile.isEmpty()) {
-          // Try to see if this compilation unit is from the Ripes editor:
-          if (isInternalSourceFile(filePath))
-            editorSrcFile = filePath;
+        for (auto &line : cu.get_line_table()) {
+          if (!line.file)
+            continue;
+          QString filePath = QString::fromStdString(line.file->path);
+          if (editorSrcFile.isEmpty()) {
+            // Try to see if this compilation unit is from the Ripes editor:
+            if (isInternalSourceFile(filePath))
+              editorSrcFile = filePath;
+          }
+          if (editorSrcFile != filePath)
+            continue;
+          info.sourceMapping[line.address].insert(line.line - 1);
         }
-        if (editorSrcFile != filePath)
-          continue;
-        program.sourceMapping[line.address].insert(line.line - 1);
       }
+      if (!editorSrcFile.isEmpty()) {
+        // Finally, we need to generate a hash of the source file that we've
+        // loaded source mappings from, so the editor knows what editor
+        // contents applies to this program.
+        QFile srcFile(editorSrcFile);
+        if (srcFile.open(QFile::ReadOnly))
+          info.sourceHash = Program::calculateHash(srcFile.readAll());
+        else
+          throw ::dwarf::format_error("Could not find source file " +
+                                      editorSrcFile.toStdString());
+      }
+    } catch (::dwarf::format_error &e) {
+      info.sourceMapping.clear();
+      info.error = "Could not load debug information: ";
+      info.error += e.what();
+    } catch (...) {
+      // Something else went wrong.
+      info.sourceMapping.clear();
     }
-    if (!editorSrcFile.isEmpty()) {
-      // Finally, we need to generate a hash of the source file that we've
-      // loaded source mappings from, so the editor knows what editor contents
-      // applies to this program.
-      QFile srcFile(editorSrcFile);
-      if (srcFile.open(QFile::ReadOnly))
-        program.sourceHash = Program::calculateHash(srcFile.readAll());
-      else
-        throw ::dwarf::format_error("Could not find source file " +
-                                    editorSrcFile.toStdString());
-    }
-  } catch (::dwarf::format_error &e) {
-    std::string msg = "Could not load debug information: ";
-    msg += e.what();
-    GeneralStatusManager::setStatusTimed(QString::fromStdString(msg), 2500);
-  } catch (...) {
-    // Something else went wrong.
   }
 
-  program.entryPoint = reader.get_entry();
+  // Line tables of all compilation units, for profiling by source line.
+  auto sourceLines = std::make_shared<SourceLineTable>();
+  const QString err =
+      loadSourceLines(reader, *sourceLines, [&](size_t loaded, size_t total) {
+        future.setProgressRange(0, static_cast<int>(total));
+        future.setProgressValue(static_cast<int>(loaded));
+        return !future.isCanceled();
+      });
+  if (err.isEmpty() && !sourceLines->empty())
+    info.sourceLines = sourceLines;
+  return info;
+}
 
-  m_ui->curInputSrcLabel->setText("Executable (ELF)");
-  m_ui->inputSrcPath->setText(file.fileName());
+bool EditTab::loadElfFile(QFile &file) {
+  // The file is read, and mapped, before returning, such that it may be
+  // removed once loaded (ie. temporary files of compiled programs).
+  auto reader = std::make_shared<ELFIO::elfio>();
+  // No file validity checking is performed - it is expected that Loaddialog has
+  // done all validity checking.
+  if (!reader->load(file.fileName().toStdString())) {
+    QMessageBox::warning(this, "Error",
+                         "Error: Could not load file " + file.fileName());
+    return false;
+  }
 
+  // Section data is referenced directly from a mapping of the file, rather than
+  // copied out of the reader.
+  auto program = std::make_shared<Program>();
+  QString mapErr;
+  qint64 mappedSize = 0;
+  const char *mapped =
+      mapProgramFile(*program, file.fileName(), mappedSize, mapErr);
+
+  m_elfGeneration++;
+  m_runningElfGeneration = m_elfGeneration;
+  m_elfWatcher.setFuture(QtConcurrent::run([=] {
+    readElfSections(*reader, *program, mapped, mappedSize);
+    return ElfLoadResult{program, reader};
+  }));
+
+  m_ui->curInputSrcLabel->setText("Executable (ELF), loading...");
+  m_ui->inputSrcPath->setText(file.fileName());
   return true;
 }
 
+void EditTab::elfLoadFinished() {
+  if (m_runningElfGeneration != m_elfGeneration)
+    return; // Superseded or cancelled.
+
+  const auto res = m_elfWatcher.result();
+  ProcessorHandler::loadProgram(res.program);
+  m_ui->curInputSrcLabel->setText("Executable (ELF), loading debug "
+                                  "information...");
+
+  m_debugInfoProgram = res.program;
+  QFutureInterface<ElfDebugInfo> future;
+  future.reportStarted();
+  m_debugInfoWatcher.setFuture(future.future());
+  const auto reader = res.reader;
+  QtConcurrent::run([reader, future]() mutable {
+    const ElfDebugInfo info = readElfDebugInfo(*reader, future);
+    if (!future.isCanceled())
+      future.reportResult(info);
+    future.reportFinished();
+  });
+}
+
+void EditTab::debugInfoFinished() {
+  const auto program = std::move(m_debugInfoProgram);
+  if (!program || m_debugInfoWatcher.isCanceled() ||
+      m_debugInfoWatcher.future().resultCount() == 0)
+    return;
+
+  m_ui->curInputSrcLabel->setText("Executable (ELF)");
+  // The debug information only applies while the program is loaded.
+  if (program != ProcessorHandler::getProgram())
+    return;
+  const auto info = m_debugInfoWatcher.result();
+  program->sourceMapping = info.sourceMapping;
+  program->sourceHash = info.sourceHash;
+  program->sourceLines = info.sourceLines;
+  if (!info.error.isEmpty())
+    GeneralStatusManager::setStatusTimed(info.error, 2500);
+  updateProgramViewerHighlighting();
+}
+
+void EditTab::cancelElfLoad() {
+  m_elfGeneration++;
+  m_debugInfoWatcher.cancel();
+  if (m_debugInfoProgram) {
+    m_debugInfoProgram.reset();
+    m_ui->curInputSrcLabel->setText("Executable (ELF)");
+  }
+}
+
 } // namespace Ripes
@@ -2,6 +2,7 @@
 
 #include <QByteArray>
 #include <QFile>
+#include <QFutureWatcher>
 #include <QWidget>
 #include <map>
 #include <memory>
@@ -10,6 +11,10 @@
 #include "assembler/program.h"
 #include "ripestab.h"
 
+namespace ELFIO {
+class elfio;
+}
+
 namespace Ripes {
 
 namespace Ui {
@@ -17,6 +22,23 @@ class EditTab;
 }
 
 struct LoadFileParams;
+struct Session;
+
+/// The program of an ELF file read on a worker thread, and the reader of the
+/// file, from which its debug information is subsequently loaded.
+struct ElfLoadResult {
+  std::shared_ptr<Program> program;
+  std::shared_ptr<ELFIO::elfio> reader;
+};
+
+/// The debug information of an ELF file, loaded on a worker thread.
+struct ElfDebugInfo {
+  Program::SourceMapping sourceMapping;
+  QString sourceHash;
+  std::shared_ptr<const SourceLineTable> sourceLines;
+  // Set if the debug information could not be loaded.
+  QString error;
+};
 
 class EditTab : public RipesTab {
   Q_OBJECT
@@ -44,6 +66,10 @@ public:
   /// calls loadFile(@p params). Returns true if the file loaded successfully.
   bool loadExternalFile(const LoadFileParams &params);
 
+  /// Loads the program and source of @p session. The source of the session is
+  /// not reassembled until edited. Returns true if the session was loaded.
+  bool loadSession(const Session &session, const QString &filepath);
+
 signals:
   void programChanged(const std::shared_ptr<Program> &program);
   void editorStateChanged(bool enabled);
@@ -72,12 +98,27 @@ public slots:
   void on_disassembledViewButton_toggled();
 
 private:
+  /// Assembles the source of the editor on a worker thread. If an assembly is
+  /// already running, the source is assembled once it finishes, and the result
+  /// of the running assembly, being superseded, is discarded.
   void assemble();
+  void assembleFinished();
+  /// Discards the result of any running or pending assembly.
+  void cancelAssembly();
   void compile();
 
   void updateProgramViewer();
   bool loadSourceFile(Program &program, QFile &file);
-  bool loadElfFile(Program &program, QFile &file);
+  /// Starts loading the ELF file @p file. Its sections and symbols are read on
+  /// a worker thread, after which the program is loaded, and its debug
+  /// information is loaded on a worker thread in turn. Returns false if the
+  /// file could not be read.
+  bool loadElfFile(QFile &file);
+  void elfLoadFinished();
+  void debugInfoFinished();
+  /// Discards any ELF file being loaded, and stops loading its debug
+  /// information.
+  void cancelElfLoad();
 
   void setupActions();
   void enableEditor();
@@ -90,8 +131,29 @@ private:
   Ui::EditTab *m_ui = nullptr;
   std::shared_ptr<Assembler::Errors> m_sourceErrors;
 
+  QFutureWatcher<Assembler::AssembleResult> m_assembleWatcher;
+  // Incremented upon each request to assemble and upon cancellation; the
+  // result of an assembly is only delivered if no such event occurred while it
+  // was running.
+  unsigned m_assembleGeneration = 0;
+  unsigned m_runningGeneration = 0;
+  bool m_assemblePending = false;
+
+  QFutureWatcher<ElfLoadResult> m_elfWatcher;
+  QFutureWatcher<ElfDebugInfo> m_debugInfoWatcher;
+  // Incremented upon each ELF load and upon cancellation; the results of a
+  // load are only delivered if neither occurred since it started.
+  unsigned m_elfGeneration = 0;
+  unsigned m_runningElfGeneration = 0;
+  // The program whose debug information is being loaded.
+  std::shared_ptr<Program> m_debugInfoProgram;
+
   SourceType m_currentSourceType = SourceType::Assembly;
 
   bool m_editorEnabled = true;
+
+  // The program of the session which was last loaded. It is the program of the
+  // source of the editor while loaded, unless the source or processor changes.
+  std::weak_ptr<const Program> m_sessionProgram;
 };
 } // namespace Ripes
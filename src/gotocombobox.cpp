@@ -8,6 +8,7 @@
 #include <QVariant>
 
 #include "processorhandler.h"
+#include "symbolnavigator.h"
 
 namespace Ripes {
 
@@ -43,6 +44,14 @@ void GoToComboBox::signalFilter(int index) {
     }
     break;
   }
+  case GoToFunction::Symbol: {
+    if (auto program = ProcessorHandler::getProgram()) {
+      SymbolNavigator navigator(program->getSymbolIndex(), this);
+      if (navigator.exec() == QDialog::Accepted)
+        emit jumpToAddress(navigator.getSelectedSymbolAddress());
+    }
+    break;
+  }
   case GoToFunction::Custom: {
     emit jumpToAddress(addrForIndex(index));
     break;
@@ -55,6 +64,9 @@ void GoToSectionComboBox::addTargets() {
   addItem("Address...",
           QVariant::fromValue<GoToUserData>({GoToFunction::Address, 0}));
   if (auto prog_spt = ProcessorHandler::getProgram()) {
+    if (!prog_spt->symbols.empty())
+      addItem("Symbol...",
+              QVariant::fromValue<GoToUserData>({GoToFunction::Symbol, 0}));
     for (const auto &section : prog_spt->sections) {
       addItem(section.first,
               QVariant::fromValue<GoToUserData>({GoToFunction::Custom, 0}));
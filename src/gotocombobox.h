@@ -7,7 +7,7 @@
 
 namespace Ripes {
 
-enum class GoToFunction { Select, Address, Custom };
+enum class GoToFunction { Select, Address, Symbol, Custom };
 struct GoToUserData {
   GoToFunction func;
   unsigned arg;
@@ -0,0 +1,347 @@
+#include "hazardanalyzer.h"
+
+#include "cli/textdecoder.h"
+#include "processorhandler.h"
+
+#include <algorithm>
+#include <set>
+
+namespace Ripes {
+
+// Cycles flushed by a taken branch or jump, which are resolved in the EX stage
+// of the 5-stage processors.
+static constexpr unsigned s_takenPenalty = 2;
+
+namespace {
+
+// Hazard handling of the pipeline of a processor model.
+struct PipelineModel {
+  bool pipelined = false;
+  bool forwarding = false;
+  bool detection = false;
+};
+
+// Register usage of an instruction.
+struct Operands {
+  bool writes = true;
+  // Whether rs2 is a register operand, rather than part of an immediate.
+  bool readsRs2 = false;
+  bool load = false;
+  bool branch = false;
+  bool jump = false;
+  bool ecall = false;
+};
+
+// An instruction in flight, which may produce an operand of the instructions
+// following it.
+struct InFlight {
+  AInt address;
+  // Cycle in which the instruction left the ID stage.
+  long long cycle;
+  unsigned rd;
+  Operands operands;
+};
+
+} // namespace
+
+static bool pipelineModel(ProcessorID id, PipelineModel &model) {
+  switch (id) {
+  case ProcessorID::RV32_SS:
+  case ProcessorID::RV64_SS:
+  case ProcessorID::RV32_ISS:
+  case ProcessorID::RV64_ISS:
+    model = {false, false, false};
+    return true;
+  case ProcessorID::RV32_5S:
+  case ProcessorID::RV64_5S:
+    model = {true, true, true};
+    return true;
+  case ProcessorID::RV32_5S_NO_FW:
+  case ProcessorID::RV64_5S_NO_FW:
+    model = {true, false, true};
+    return true;
+  case ProcessorID::RV32_5S_NO_HZ:
+  case ProcessorID::RV64_5S_NO_HZ:
+    model = {true, true, false};
+    return true;
+  case ProcessorID::RV32_5S_NO_FW_HZ:
+  case ProcessorID::RV64_5S_NO_FW_HZ:
+    model = {true, false, false};
+    return true;
+  default:
+    return false;
+  }
+}
+
+static Operands operands(unsigned opcode) {
+  Operands ops;
+  switch (opcode) {
+  case RVInstr::LB:
+  case RVInstr::LH:
+  case RVInstr::LW:
+  case RVInstr::LBU:
+  case RVInstr::LHU:
+  case RVInstr::LWU:
+  case RVInstr::LD:
+  case RVInstr::LR_W:
+  case RVInstr::LR_D:
+    ops.load = true;
+    break;
+  case RVInstr::SC_W:
+  case RVInstr::AMOSWAP_W:
+  case RVInstr::AMOADD_W:
+  case RVInstr::AMOXOR_W:
+  case RVInstr::AMOAND_W:
+  case RVInstr::AMOOR_W:
+  case RVInstr::AMOMIN_W:
+  case RVInstr::AMOMAX_W:
+  case RVInstr::AMOMINU_W:
+  case RVInstr::AMOMAXU_W:
+  case RVInstr::SC_D:
+  case RVInstr::AMOSWAP_D:
+  case RVInstr::AMOADD_D:
+  case RVInstr::AMOXOR_D:
+  case RVInstr::AMOAND_D:
+  case RVInstr::AMOOR_D:
+  case RVInstr::AMOMIN_D:
+  case RVInstr::AMOMAX_D:
+  case RVInstr::AMOMINU_D:
+  case RVInstr::AMOMAXU_D:
+    ops.load = true;
+    ops.readsRs2 = true;
+    break;
+  case RVInstr::SB:
+  case RVInstr::SH:
+  case RVInstr::SW:
+  case RVInstr::SD:
+    ops.writes = false;
+    ops.readsRs2 = true;
+    break;
+  case RVInstr::BEQ:
+  case RVInstr::BNE:
+  case RVInstr::BLT:
+  case RVInstr::BGE:
+  case RVInstr::BLTU:
+  case RVInstr::BGEU:
+    ops.writes = false;
+    ops.readsRs2 = true;
+    ops.branch = true;
+    break;
+  case RVInstr::JAL:
+  case RVInstr::JALR:
+    ops.jump = true;
+    break;
+  case RVInstr::ECALL:
+    ops.writes = false;
+    ops.ecall = true;
+    break;
+  case RVInstr::NOP:
+  case RVInstr::MRET:
+  case RVInstr::WFI:
+    ops.writes = false;
+    break;
+  case RVInstr::ADD:
+  case RVInstr::SUB:
+  case RVInstr::SLL:
+  case RVInstr::SLT:
+  case RVInstr::SLTU:
+  case RVInstr::XOR:
+  case RVInstr::SRL:
+  case RVInstr::SRA:
+  case RVInstr::OR:
+  case RVInstr::AND:
+  case RVInstr::ADDW:
+  case RVInstr::SUBW:
+  case RVInstr::SLLW:
+  case RVInstr::SRLW:
+  case RVInstr::SRAW:
+  case RVInstr::MUL:
+  case RVInstr::MULH:
+  case RVInstr::MULHSU:
+  case RVInstr::MULHU:
+  case RVInstr::DIV:
+  case RVInstr::DIVU:
+  case RVInstr::REM:
+  case RVInstr::REMU:
+  case RVInstr::MULW:
+  case RVInstr::DIVW:
+  case RVInstr::DIVUW:
+  case RVInstr::REMW:
+  case RVInstr::REMUW:
+    ops.readsRs2 = true;
+    break;
+  default:
+    break;
+  }
+  return ops;
+}
+
+QString PipelineHazard::describe() const {
+  const auto *isa = ProcessorHandler::currentISA();
+  QString desc;
+  switch (kind) {
+  case Kind::LoadUse:
+    desc = "load-use hazard on " + isa->regName(reg);
+    break;
+  case Kind::Data:
+    desc = "data hazard on " + isa->regName(reg);
+    break;
+  case Kind::Ecall:
+    desc = "ecall hazard";
+    break;
+  }
+  desc += " (0x" + QString::number(producer, 16) + "): ";
+  if (!resolved)
+    return desc + "not resolved by the processor";
+  return desc + QString::number(stalls) +
+         (stalls == 1 ? " stall cycle" : " stall cycles");
+}
+
+unsigned HazardAnalysis::stalls() const {
+  unsigned stalls = 0;
+  for (const auto &block : blocks)
+    stalls += block.stalls;
+  return stalls;
+}
+
+unsigned HazardAnalysis::unresolved() const {
+  unsigned unresolved = 0;
+  for (const auto &block : blocks)
+    unresolved += block.unresolved;
+  return unresolved;
+}
+
+QString analyzeHazards(ProcessorID id, HazardAnalysis &analysis) {
+  analysis = HazardAnalysis();
+  analysis.processor = id;
+  PipelineModel model;
+  if (!pipelineModel(id, model))
+    return "Static hazard analysis is not supported for processor " +
+           enumToString<ProcessorID>(id);
+  const auto &isaInfo = ProcessorRegistry::getDescription(id).isaInfo();
+  if (isaInfo.isa->isaID() != ProcessorHandler::currentISA()->isaID())
+    return "Processor " + enumToString<ProcessorID>(id) +
+           " does not implement the ISA of the current program";
+  auto program = ProcessorHandler::getProgram();
+  if (!program)
+    return "No program loaded";
+
+  const DecodedText text = DecodedText::decode();
+  auto next = [&](size_t index) {
+    return index + (text.instrs[index].compressed ? 2 : 4) / text.granule;
+  };
+
+  // Basic blocks start at the text section, at symbols, at the targets of
+  // branches and jal instructions, and following any branch or jump.
+  std::set<AInt> leaders;
+  if (!text.instrs.empty())
+    leaders.insert(text.start);
+  for (const auto &symbol : program->symbols)
+    leaders.insert(symbol.first);
+  for (size_t i = 0; i < text.instrs.size(); i = next(i)) {
+    const auto &instr = text.instrs[i];
+    const Operands ops = operands(instr.opcode);
+    if (ops.branch || instr.opcode == RVInstr::JAL)
+      leaders.insert(text.address(i) + instr.offset);
+    if (ops.branch || ops.jump)
+      leaders.insert(text.address(next(i)));
+  }
+
+  std::vector<InFlight> inFlight;
+  long long cycle = 0;
+  for (size_t i = 0; i < text.instrs.size(); i = next(i)) {
+    const auto &instr = text.instrs[i];
+    const AInt address = text.address(i);
+    const Operands ops = operands(instr.opcode);
+    if (leaders.count(address) || analysis.blocks.empty()) {
+      // Blocks following a jump are only entered through a taken control
+      // transfer, which flushes the instructions in flight.
+      const auto &prev = analysis.blocks;
+      if (!prev.empty() && prev.back().takenPenalty != 0 &&
+          !prev.back().conditional)
+        inFlight.clear();
+      analysis.blocks.push_back({address, address});
+    }
+    auto &block = analysis.blocks.back();
+
+    // The cycle in which the instruction leaves the ID stage, once all of the
+    // operands it waits on are available.
+    const long long earliest = cycle + 1;
+    long long ready = earliest;
+    const InFlight *producer = nullptr;
+    PipelineHazard::Kind kind = PipelineHazard::Kind::Data;
+    if (model.pipelined) {
+      // The nearest preceding instruction takes precedence.
+      for (auto it = inFlight.rbegin(); it != inFlight.rend(); ++it) {
+        if (!it->operands.writes)
+          continue;
+        long long operandReady = 0;
+        PipelineHazard::Kind operandKind = PipelineHazard::Kind::Data;
+        if (ops.ecall) {
+          // All outstanding writes must be written back before an ecall.
+          operandReady = it->cycle + 3;
+          operandKind = PipelineHazard::Kind::Ecall;
+        } else if (model.forwarding) {
+          // The hazard unit compares the register fields of the instruction
+          // whether or not they are register operands.
+          if (it->operands.load && (it->rd == instr.rs1 || it->rd == instr.rs2))
+            operandReady = it->cycle + 2;
+          operandKind = PipelineHazard::Kind::LoadUse;
+        } else if (it->rd != 0 &&
+                   (it->rd == instr.rs1 ||
+                    (ops.readsRs2 && it->rd == instr.rs2))) {
+          // Without forwarding, operands are read from the register file once
+          // written back.
+          operandReady = it->cycle + 3;
+          operandKind = it->operands.load ? PipelineHazard::Kind::LoadUse
+                                          : PipelineHazard::Kind::Data;
+        }
+        if (operandReady > ready) {
+          ready = operandReady;
+          producer = &*it;
+          kind = operandKind;
+        }
+      }
+    }
+
+    if (producer) {
+      PipelineHazard hazard;
+      hazard.kind = kind;
+      hazard.address = address;
+      hazard.producer = producer->address;
+      hazard.reg = kind == PipelineHazard::Kind::Ecall ? 0 : producer->rd;
+      hazard.resolved = model.detection;
+      if (model.detection) {
+        hazard.stalls = ready - earliest;
+        block.stalls += hazard.stalls;
+      } else {
+        block.unresolved++;
+        ready = earliest;
+      }
+      analysis.hazards.push_back(hazard);
+    }
+    cycle = ready;
+
+    block.instructions++;
+    block.end = text.address(next(i));
+    if (model.pipelined && (ops.branch || ops.jump)) {
+      block.takenPenalty = s_takenPenalty;
+      block.conditional = ops.branch;
+    }
+    const bool backward = ops.branch && instr.offset < 0;
+    block.estimatedCycles = block.instructions + block.stalls +
+                            (ops.jump || backward ? block.takenPenalty : 0);
+
+    // Instructions which left the ID stage three or more cycles ago have
+    // written back.
+    inFlight.push_back({address, cycle, instr.rd, ops});
+    inFlight.erase(std::remove_if(inFlight.begin(), inFlight.end(),
+                                  [&](const InFlight &f) {
+                                    return f.cycle + 3 <= cycle;
+                                  }),
+                   inFlight.end());
+  }
+  return QString();
+}
+
+} // namespace Ripes
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <QString>
+
+#include <vector>
+
+#include "processorregistry.h"
+
+namespace Ripes {
+
+/**
+ * @brief The PipelineHazard struct
+ * A data hazard between an instruction and a preceding instruction producing
+ * one of its operands, as predicted by static analysis (see analyzeHazards).
+ */
+struct PipelineHazard {
+  enum class Kind {
+    // The operand is loaded by the preceding instruction.
+    LoadUse,
+    // The operand is written by a preceding instruction, and not forwarded.
+    Data,
+    // An ecall waits for the preceding instructions to write back.
+    Ecall
+  };
+
+  Kind kind;
+  AInt address;
+  AInt producer;
+  // Register which the instruction waits on; unused for ecall hazards.
+  unsigned reg = 0;
+  // Stall cycles of the instruction. Hazards which are not detected by the
+  // processor do not stall, and are unresolved.
+  unsigned stalls = 0;
+  bool resolved = true;
+
+  /// Returns a description of the hazard, ie. "load-use hazard on a0 (0x8):
+  /// 1 stall cycle".
+  QString describe() const;
+};
+
+/**
+ * @brief The HazardBlock struct
+ * Predicted penalties of a basic block of the text section.
+ */
+struct HazardBlock {
+  AInt start;
+  // Address following the last instruction of the block.
+  AInt end;
+  unsigned instructions = 0;
+  // Stall cycles of data hazards within the block, and the number of hazards
+  // which are not resolved by the processor.
+  unsigned stalls = 0;
+  unsigned unresolved = 0;
+  // Cycles flushed if the control transfer ending the block is taken, and
+  // whether the transfer is a conditional branch. Blocks ending in a fall
+  // through have no penalty.
+  unsigned takenPenalty = 0;
+  bool conditional = false;
+  // Predicted cycles of an execution of the block, assuming that backward
+  // branches are taken and forward branches are not.
+  unsigned estimatedCycles = 0;
+};
+
+/**
+ * @brief The HazardAnalysis struct
+ * Result of a static hazard analysis of the text section of the current
+ * program, by basic blocks in address order.
+ */
+struct HazardAnalysis {
+  ProcessorID processor;
+  std::vector<HazardBlock> blocks;
+  // Hazards in address order.
+  std::vector<PipelineHazard> hazards;
+
+  unsigned stalls() const;
+  unsigned unresolved() const;
+};
+
+/**
+ * @brief analyzeHazards
+ * Predicts the load-use and data hazard stalls, and the branch penalties, of
+ * each basic block of the text section of the current program on processor
+ * @p id, without simulating. The hazard detection and forwarding of the
+ * processor are modelled on those of its pipeline: the register operands of
+ * each instruction are compared against the destinations of the preceding
+ * instructions in flight, and taken branches and jumps flush the instructions
+ * fetched behind them. Blocks are entered by falling through from the
+ * preceding block, if it may fall through.
+ * @p id must implement the ISA of the current processor, and be a single-cycle
+ * or classic 5-stage processor. Returns an error message on failure, or an
+ * empty string on success.
+ */
+QString analyzeHazards(ProcessorID id, HazardAnalysis &analysis);
+
+} // namespace Ripes
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+namespace Ripes {
+
+/**
+ * @brief The HostTrace class
+ * Records the host-side phases of the simulator (assembling, loading
+ * programs, constructing processors, running, system calls, view refreshes)
+ * as complete events of the Chrome trace event format, which may be viewed in
+ * Perfetto or chrome://tracing. Events are streamed to the trace file as they
+ * complete. When tracing is not started, a traced scope costs a single branch.
+ */
+class HostTrace {
+public:
+  /// Starts tracing to the file at @p path. Returns an error message on
+  /// failure, or an empty string on success.
+  static QString start(const QString &path) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_file.setFileName(path);
+    if (!s_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+      return "Error: Could not open host trace file " + path;
+    s_file.write("{\"traceEvents\":[\n");
+    s_events = 0;
+    s_start = Clock::now();
+    s_enabled = true;
+    return QString();
+  }
+
+  /// Stops tracing and closes the trace file.
+  static void stop() {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (!s_enabled)
+      return;
+    s_enabled = false;
+    s_file.write("\n]}\n");
+    s_file.close();
+  }
+
+  static bool isEnabled() { return s_enabled; }
+
+  /**
+   * @brief The Scope class
+   * Records the lifetime of the scope as an event named @p name in category
+   * @p category. Both must be string literals.
+   */
+  class Scope {
+  public:
+    Scope(const char *name, const char *category) {
+      if (!s_enabled)
+        return;
+      m_name = name;
+      m_category = category;
+      m_start = Clock::now();
+    }
+    ~Scope() {
+      if (m_name)
+        record(m_name, m_category, m_start, Clock::now());
+    }
+
+  private:
+    const char *m_name = nullptr;
+    const char *m_category = nullptr;
+    std::chrono::steady_clock::time_point m_start;
+  };
+
+  /// Invokes @p f within a scope named @p name, returning its result.
+  template <typename F>
+  static auto traced(const char *name, const char *category, F &&f) {
+    Scope scope(name, category);
+    return f();
+  }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  static void record(const char *name, const char *category,
+                     Clock::time_point begin, Clock::time_point end) {
+    static std::atomic<int> nextThreadId{1};
+    thread_local const int threadId = nextThreadId++;
+    using us = std::chrono::duration<double, std::micro>;
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (!s_enabled)
+      return;
+    const QString event =
+        QString("%1{\"name\":\"%2\",\"cat\":\"%3\",\"ph\":\"X\",\"ts\":%4,"
+                "\"dur\":%5,\"pid\":1,\"tid\":%6}")
+            .arg(s_events == 0 ? "" : ",\n")
+            .arg(name)
+            .arg(category)
+            .arg(us(begin - s_start).count(), 0, 'f', 3)
+            .arg(us(end - begin).count(), 0, 'f', 3)
+            .arg(threadId);
+    s_file.write(event.toUtf8());
+    s_events++;
+  }
+
+  static inline std::atomic<bool> s_enabled{false};
+  static inline std::mutex s_mutex;
+  static inline QFile s_file;
+  static inline unsigned long long s_events = 0;
+  static inline Clock::time_point s_start;
+};
+
+} // namespace Ripes
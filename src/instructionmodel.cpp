@@ -31,8 +31,8 @@ InstructionModel::InstructionModel(QObject *parent)
     m_stageNames[idx] = ProcessorHandler::getProcessor()->stageName(idx);
     m_stageInfos[idx] = ProcessorHandler::getProcessor()->stageInfo(idx);
   }
-  connect(ProcessorHandler::get(), &ProcessorHandler::procStateChangedNonRun,
-          this, &InstructionModel::updateStageInfo);
+  ProcessorHandler::getRefreshScheduler().addClient(
+      this, [=] { updateStageInfo(); });
   connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
           &InstructionModel::onProcessorReset);
   onProcessorReset();
@@ -44,10 +44,21 @@ void InstructionModel::onProcessorReset() {
 
   updateRowCount();
   beginResetModel();
+  // All rows are refetched by the reset; the stage rows are recomputed.
+  for (const auto &stageInfo : m_stageInfos)
+    m_stageRows[stageInfo.first] =
+        stageInfo.second.stage_valid ? stageRow(stageInfo.second.pc) : -1;
   endResetModel();
   updateStageInfo();
 }
 
+int InstructionModel::stageRow(AInt addr) const {
+  if (!m_program)
+    return -1;
+  const auto index = m_program->getDisassembled().addressToIndex(addr);
+  return index.has_value() ? static_cast<int>(index.value()) : -1;
+}
+
 int InstructionModel::columnCount(const QModelIndex &) const {
   return NColumns;
 }
@@ -63,34 +74,41 @@ void InstructionModel::updateRowCount() {
 int InstructionModel::rowCount(const QModelIndex &) const { return m_rowCount; }
 
 void InstructionModel::updateStageInfo() {
+  const auto *proc = ProcessorHandler::getProcessor();
+  // Rows whose stage occupancy changed; the rows of stages whose state changed
+  // in place display the same stage names, and are not updated.
+  std::set<int> changedRows;
   bool firstStageChanged = false;
-  for (auto idx : ProcessorHandler::getProcessor()->structure().stageIt()) {
-    auto stageInfoIt = m_stageInfos.find(idx);
-    if (stageInfoIt != m_stageInfos.end()) {
-      auto &oldStageInfo = m_stageInfos.at(idx);
-      if (idx == StageIndex(0, 0)) {
-        if (oldStageInfo.pc !=
-            ProcessorHandler::getProcessor()->stageInfo(idx).pc) {
-          firstStageChanged = true;
-        }
-      }
-      const auto stageInfo = ProcessorHandler::getProcessor()->stageInfo(idx);
-      const AInt oldAddress = oldStageInfo.pc;
-      if (oldStageInfo != stageInfo) {
-        oldStageInfo = stageInfo;
-        const int oldRow = addressToRow(oldAddress);
-        const int newRow = addressToRow(stageInfo.pc);
-        const QModelIndex oldIdx = index(oldRow, Stage);
-        const QModelIndex newIdx = index(newRow, Stage);
-        emit dataChanged(oldIdx, oldIdx, {Qt::DisplayRole});
-        emit dataChanged(newIdx, newIdx, {Qt::DisplayRole});
-      }
-      if (firstStageChanged) {
-        emit firstStageInstrChanged(addressToRow(m_stageInfos.at({0, 0}).pc));
-        firstStageChanged = false;
-      }
-    }
+  for (auto &[idx, oldStageInfo] : m_stageInfos) {
+    const auto stageInfo = proc->stageInfo(idx);
+    if (oldStageInfo == stageInfo)
+      continue;
+    if (idx == StageIndex(0, 0) && oldStageInfo.pc != stageInfo.pc)
+      firstStageChanged = true;
+    oldStageInfo = stageInfo;
+
+    int &row = m_stageRows[idx];
+    const int newRow = stageInfo.stage_valid ? stageRow(stageInfo.pc) : -1;
+    if (newRow == row)
+      continue;
+    if (row >= 0)
+      changedRows.insert(row);
+    if (newRow >= 0)
+      changedRows.insert(newRow);
+    row = newRow;
+  }
+
+  // Contiguous rows are updated as a single range.
+  for (auto it = changedRows.begin(); it != changedRows.end();) {
+    const int first = *it;
+    int last = first;
+    while (++it != changedRows.end() && *it == last + 1)
+      last = *it;
+    emit dataChanged(index(first, Stage), index(last, Stage),
+                     {Qt::DisplayRole});
   }
+  if (firstStageChanged)
+    emit firstStageInstrChanged(addressToRow(m_stageInfos.at({0, 0}).pc));
 }
 
 bool InstructionModel::setData(const QModelIndex &index, const QVariant &value,
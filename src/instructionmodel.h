@@ -42,7 +42,12 @@ signals:
   void firstStageInstrChanged(int row);
 
 private:
+  /// Updates the stage column of the rows whose stage occupancy changed since
+  /// the previous update. Called once per refresh frame.
   void updateStageInfo();
+  /// Returns the row of the instruction at @p addr, or -1 if not part of the
+  /// program.
+  int stageRow(AInt addr) const;
 
   QVariant BPData(AInt addr) const;
   QVariant PCData(AInt addr) const;
@@ -55,6 +60,8 @@ private:
   std::map<StageIndex, QString> m_stageNames;
   using StageID = unsigned;
   std::map<StageIndex, StageInfo> m_stageInfos;
+  // The row occupied by each valid stage as of the previous update, or -1.
+  std::map<StageIndex, int> m_stageRows;
   int m_rowCount = 0;
 };
 } // namespace Ripes
@@ -6,6 +6,7 @@
 
 #include "../assembler/program.h"
 #include "binutils.h"
+#include "ioperipheral.h"
 #include "serializers.h"
 
 #include "VSRTL/external/cereal/include/cereal/cereal.hpp"
@@ -40,26 +41,7 @@ struct IOParam {
   }
 };
 
-struct IOSymbol {
-  Symbol name;
-  VInt value;
-};
-
-struct RegDesc {
-  enum class RW { R, W, RW };
-  QString name;
-  RW rw;
-  unsigned bitWidth;
-  AInt address;
-  /**
-   * @brief exported
-   * if true, a constant symbol is generated that may be referenced in the
-   * assembler, which targets this register.
-   */
-  bool exported = false;
-};
-
-class IOBase : public QWidget {
+class IOBase : public QWidget, public IOPeripheral {
   Q_OBJECT
 
 public:
@@ -77,7 +59,7 @@ public:
    * @brief name
    * @returns unique name for this specific component
    */
-  virtual QString name() const;
+  QString name() const override;
 
   /**
    * @brief baseName
@@ -85,20 +67,6 @@ public:
    */
   virtual QString baseName() const = 0;
 
-  /**
-   * @brief registers
-   * @return a description of the programmable interface of this peripheral
-   */
-  virtual const std::vector<RegDesc> &registers() const = 0;
-
-  /**
-   * @brief extraSymbols
-   * @returns the set of extra symbols defined by this peripheral. Useful if
-   * some symbols aren't directly translated from the register descriptions of
-   * this peripheral.
-   */
-  virtual const std::vector<IOSymbol> *extraSymbols() const { return nullptr; };
-
   /**
    * @brief setParameter
    * Attempt to set the parameter @p ID to @p value. Returns true if the value
@@ -107,22 +75,16 @@ public:
   virtual bool setParameter(unsigned ID, const QVariant &value);
 
   /**
-   * @brief byteSize
-   * Size of this peripheral, in bytes
-   */
-  virtual unsigned byteSize() const = 0;
-
-  /**
-   * Read/write functions from processor
-   */
-  virtual VInt ioRead(AInt offset, unsigned bytes) = 0;
-  virtual void ioWrite(AInt offset, VInt value, unsigned bytes) = 0;
-
-  /**
-   * Read/write functions from peripheral to bus (memory/other periphs)
+   * Read/write functions from processor. These are called from the simulation
+   * thread, concurrently with the widget being used on the GUI thread. They
+   * shall therefore only access the device state of the peripheral (atomics,
+   * or state otherwise safe to share), and never its widgets. The widget
+   * exchanges state with the device through the same means: inputs are
+   * published to the device state as they change, and outputs are read as a
+   * snapshot of the device state when the widget is refreshed.
    */
-  std::function<void(AInt, AInt, VInt)> memWrite;
-  std::function<VInt(AInt, AInt)> memRead;
+  VInt ioRead(AInt offset, unsigned bytes) override = 0;
+  void ioWrite(AInt offset, VInt value, unsigned bytes) override = 0;
 
   unsigned iotype() const { return m_type; }
   unsigned id() const { return m_id; }
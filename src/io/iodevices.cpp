@@ -0,0 +1,231 @@
+#include "iodevices.h"
+
+#include "STLExtras.h"
+#include "binutils.h"
+
+namespace Ripes {
+
+LedMatrixDevice::LedMatrixDevice(const QString &name)
+    : m_name(name),
+      m_leds(std::make_unique<std::atomic<uint32_t>[]>(s_maxLEDs)) {}
+
+VInt LedMatrixDevice::ioRead(AInt offset, unsigned size) {
+  if (offset / 4 >= s_maxLEDs)
+    return 0;
+  return (led(offset / 4) >> ((offset % 4) * 8)) &
+         vsrtl::generateBitmask(size * 8);
+}
+
+void LedMatrixDevice::ioWrite(AInt offset, VInt value, unsigned) {
+  offset >>= 2; // word addressable
+  if (offset >= s_maxLEDs) {
+    Q_ASSERT(false);
+    return;
+  }
+  const uint32_t prev =
+      m_leds[offset].exchange(value, std::memory_order_relaxed);
+  if (ledChanged && prev != static_cast<uint32_t>(value))
+    ledChanged(offset, value);
+}
+
+void LedMatrixDevice::resize(unsigned width, unsigned height) {
+  m_width = width;
+  m_height = height;
+  const unsigned nLEDs = width * height;
+
+  m_extraSymbols.clear();
+  m_extraSymbols.push_back(IOSymbol{"WIDTH", width});
+  m_extraSymbols.push_back(IOSymbol{"HEIGHT", height});
+
+  m_regDescs.clear();
+  m_regDescs.resize(nLEDs);
+  for (auto mRegDesc : llvm::enumerate(m_regDescs)) {
+    RegDesc regdesc;
+    regdesc.name = "LED_" + QString::number(mRegDesc.index());
+    regdesc.rw = RegDesc::RW::RW;
+    regdesc.bitWidth = 24;
+    regdesc.address = mRegDesc.index() * 4;
+    regdesc.exported = false;
+    mRegDesc.value() = regdesc;
+  }
+}
+
+SwitchesDevice::SwitchesDevice(const QString &name) : m_name(name) {}
+
+VInt SwitchesDevice::ioRead(AInt, unsigned) { return state(); }
+
+void SwitchesDevice::ioWrite(AInt, VInt, unsigned) {
+  // Read-only
+}
+
+void SwitchesDevice::setCount(unsigned count) {
+  m_count = count;
+  m_extraSymbols.clear();
+  m_extraSymbols.push_back(IOSymbol{"N", count});
+  // No reason to export the register, since the base pointer already points to
+  // it, and it is the only register of this component.
+  m_regDescs = {RegDesc{"Switches", RegDesc::RW::R, count, 0, false}};
+}
+
+void SwitchesDevice::setState(uint32_t state) {
+  if (m_count < s_maxSwitches)
+    state &= (uint32_t(1) << m_count) - 1;
+  if (m_state.exchange(state, std::memory_order_relaxed) != state &&
+      inputChanged)
+    inputChanged();
+}
+
+void DPadDevice::setDown(Direction dir, bool down) {
+  if (m_down[dir].exchange(down) != down && inputChanged)
+    inputChanged();
+}
+
+DPadDevice::DPadDevice(const QString &name) : m_name(name) {
+  for (unsigned i = 0; i < DIRECTIONS; ++i)
+    m_regDescs.push_back(RegDesc{directionName(static_cast<Direction>(i)),
+                                 RegDesc::RW::R, 1, i * 4, true});
+}
+
+QString DPadDevice::directionName(Direction dir) {
+  switch (dir) {
+  case UP:
+    return "UP";
+  case DOWN:
+    return "DOWN";
+  case LEFT:
+    return "LEFT";
+  case RIGHT:
+    return "RIGHT";
+  case DIRECTIONS:
+    break;
+  }
+  Q_UNREACHABLE();
+}
+
+VInt DPadDevice::ioRead(AInt offset, unsigned) {
+  if (offset % 4 != 0 || offset / 4 >= DIRECTIONS)
+    return 0;
+  return m_down[offset / 4].load(std::memory_order_relaxed);
+}
+
+void DPadDevice::ioWrite(AInt, VInt, unsigned) {
+  // Read-only
+}
+
+DMADevice::DMADevice(const QString &name) : m_name(name) {
+  m_regDescs = {RegDesc{"SRC", RegDesc::RW::RW, 32, SRC * 4, true},
+                RegDesc{"DST", RegDesc::RW::RW, 32, DST * 4, true},
+                RegDesc{"LEN", RegDesc::RW::RW, 32, LEN * 4, true},
+                RegDesc{"CTRL", RegDesc::RW::W, 1, CTRL * 4, true},
+                RegDesc{"STATUS", RegDesc::RW::R, 2, STATUS * 4, true}};
+  m_extraSymbols = {IOSymbol{"CTRL_START", s_start},
+                    IOSymbol{"STATUS_BUSY", s_busy},
+                    IOSymbol{"STATUS_DONE", s_done}};
+}
+
+VInt DMADevice::ioRead(AInt offset, unsigned) {
+  const unsigned reg = offset / 4;
+  if (offset % 4 != 0 || reg >= NREGISTERS)
+    return 0;
+  if (reg < CTRL)
+    return m_regs[reg];
+  if (reg == STATUS)
+    return status();
+  return 0;
+}
+
+void DMADevice::ioWrite(AInt offset, VInt value, unsigned) {
+  const unsigned reg = offset / 4;
+  if (offset % 4 != 0 || reg >= NREGISTERS)
+    return;
+  if (reg < CTRL) {
+    m_regs[reg] = value;
+    return;
+  }
+  // Starting a transfer while another is ongoing has no effect.
+  if (reg != CTRL || !(value & s_start) || (status() & s_busy))
+    return;
+
+  m_src = m_regs[SRC];
+  m_dst = m_regs[DST];
+  m_burst = m_burstBytes;
+  m_delay = m_latency;
+  m_length = m_regs[LEN];
+  m_transferred = 0;
+  m_status = m_regs[LEN] == 0 ? s_done : s_busy;
+}
+
+void DMADevice::clock() {
+  if (!(status() & s_busy))
+    return;
+  if (m_delay > 0) {
+    --m_delay;
+    return;
+  }
+
+  const AInt transferred = m_transferred.load(std::memory_order_relaxed);
+  const AInt burst = std::min<AInt>(m_burst, length() - transferred);
+  if (memCopy)
+    memCopy(m_dst + transferred, m_src + transferred, burst);
+  m_transferred.store(transferred + burst, std::memory_order_relaxed);
+  if (transferred + burst == length())
+    m_status = s_done;
+}
+
+void DMADevice::reset() {
+  m_regs.fill(0);
+  m_status = 0;
+  m_length = 0;
+  m_transferred = 0;
+}
+
+TimerDevice::TimerDevice(const QString &name) : m_name(name) {
+  m_regDescs = {RegDesc{"MTIME", RegDesc::RW::R, 32, MTIME * 4, true},
+                RegDesc{"MTIMEH", RegDesc::RW::R, 32, MTIMEH * 4, true},
+                RegDesc{"MTIMECMP", RegDesc::RW::RW, 32, MTIMECMP * 4, true},
+                RegDesc{"MTIMECMPH", RegDesc::RW::RW, 32, MTIMECMPH * 4, true}};
+}
+
+VInt TimerDevice::ioRead(AInt offset, unsigned) {
+  if (offset % 4 != 0)
+    return 0;
+  switch (offset / 4) {
+  case MTIME:
+    return time() & 0xFFFFFFFF;
+  case MTIMEH:
+    return time() >> 32;
+  case MTIMECMP:
+    return timerCompare() & 0xFFFFFFFF;
+  case MTIMECMPH:
+    return timerCompare() >> 32;
+  default:
+    return 0;
+  }
+}
+
+void TimerDevice::ioWrite(AInt offset, VInt value, unsigned) {
+  if (offset % 4 != 0)
+    return;
+  // Only the simulation thread writes mtimecmp, so the halves are updated
+  // without a compare-and-swap.
+  const uint64_t cmp = timerCompare();
+  const uint64_t word = value & 0xFFFFFFFF;
+  switch (offset / 4) {
+  case MTIMECMP:
+    m_mtimecmp.store((cmp & ~0xFFFFFFFFull) | word, std::memory_order_relaxed);
+    break;
+  case MTIMECMPH:
+    m_mtimecmp.store((cmp & 0xFFFFFFFFull) | (word << 32),
+                     std::memory_order_relaxed);
+    break;
+  default:
+    break;
+  }
+}
+
+void TimerDevice::reset() {
+  m_mtimecmp.store(std::numeric_limits<uint64_t>::max(),
+                   std::memory_order_relaxed);
+}
+
+} // namespace Ripes
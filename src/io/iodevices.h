@@ -0,0 +1,218 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include "ioperipheral.h"
+
+namespace Ripes {
+
+/**
+ * Headless device models of the peripherals. A device model holds the register
+ * map and the device state of a peripheral, without any widget; the widgets of
+ * the IO tab (IOLedMatrix, IOSwitches, IODPad) each drive a device model, and
+ * the device models may be attached directly when running without a GUI.
+ *
+ * Device state is accessed by the simulation thread through ioRead/ioWrite,
+ * and by its owner through the remaining functions, and is therefore atomic.
+ */
+
+class LedMatrixDevice : public IOPeripheral {
+public:
+  static constexpr unsigned s_maxSideWidth = 256;
+  static constexpr unsigned s_maxLEDs = s_maxSideWidth * s_maxSideWidth;
+
+  LedMatrixDevice(const QString &name = QString());
+
+  QString name() const override { return m_name; }
+  unsigned byteSize() const override { return m_width * m_height * 4; }
+  const std::vector<RegDesc> &registers() const override { return m_regDescs; }
+  const std::vector<IOSymbol> *extraSymbols() const override {
+    return &m_extraSymbols;
+  }
+  VInt ioRead(AInt offset, unsigned size) override;
+  void ioWrite(AInt offset, VInt value, unsigned size) override;
+
+  /// Resizes the matrix, keeping the values of the LED registers.
+  void resize(unsigned width, unsigned height);
+  unsigned width() const { return m_width; }
+  unsigned height() const { return m_height; }
+  /// Returns the color register of LED @p idx, with B in the least significant
+  /// byte.
+  uint32_t led(unsigned idx) const {
+    return m_leds[idx].load(std::memory_order_relaxed);
+  }
+
+  /// Called from the simulation thread upon a write which changes the color
+  /// of an LED, with the index of the LED and its new color.
+  std::function<void(unsigned, uint32_t)> ledChanged;
+
+private:
+  QString m_name;
+  unsigned m_width = 0;
+  unsigned m_height = 0;
+  // Allocated for the largest matrix, such that resizing the matrix never
+  // reallocates the registers underneath a running simulation.
+  std::unique_ptr<std::atomic<uint32_t>[]> m_leds;
+  std::vector<RegDesc> m_regDescs;
+  std::vector<IOSymbol> m_extraSymbols;
+};
+
+class SwitchesDevice : public IOPeripheral {
+public:
+  static constexpr unsigned s_maxSwitches = 32;
+
+  SwitchesDevice(const QString &name = QString());
+
+  QString name() const override { return m_name; }
+  unsigned byteSize() const override { return 4; }
+  const std::vector<RegDesc> &registers() const override { return m_regDescs; }
+  const std::vector<IOSymbol> *extraSymbols() const override {
+    return &m_extraSymbols;
+  }
+  VInt ioRead(AInt offset, unsigned size) override;
+  void ioWrite(AInt offset, VInt value, unsigned size) override;
+
+  void setCount(unsigned count);
+  unsigned count() const { return m_count; }
+  /// Sets the state of all switches; switch n is set in bit n.
+  void setState(uint32_t state);
+  uint32_t state() const { return m_state.load(std::memory_order_relaxed); }
+
+  /// Called whenever the state of the switches changes, from the thread
+  /// setting the state.
+  std::function<void()> inputChanged;
+
+private:
+  QString m_name;
+  unsigned m_count = 0;
+  std::atomic<uint32_t> m_state{0};
+  std::vector<RegDesc> m_regDescs;
+  std::vector<IOSymbol> m_extraSymbols;
+};
+
+class DPadDevice : public IOPeripheral {
+public:
+  enum Direction { UP, DOWN, LEFT, RIGHT, DIRECTIONS };
+
+  DPadDevice(const QString &name = QString());
+
+  QString name() const override { return m_name; }
+  unsigned byteSize() const override { return DIRECTIONS * 4; }
+  const std::vector<RegDesc> &registers() const override { return m_regDescs; }
+  VInt ioRead(AInt offset, unsigned size) override;
+  void ioWrite(AInt offset, VInt value, unsigned size) override;
+
+  void setDown(Direction dir, bool down);
+  bool isDown(Direction dir) const { return m_down[dir]; }
+
+  /// Called whenever a button is pressed or released, from the thread
+  /// pressing or releasing it.
+  std::function<void()> inputChanged;
+
+  /// Returns the name of the register of @p dir.
+  static QString directionName(Direction dir);
+
+private:
+  QString m_name;
+  std::array<std::atomic<bool>, DIRECTIONS> m_down{};
+  std::vector<RegDesc> m_regDescs;
+};
+
+class DMADevice : public IOPeripheral {
+public:
+  enum Register { SRC, DST, LEN, CTRL, STATUS, NREGISTERS };
+  // CTRL bits.
+  static constexpr uint32_t s_start = 1 << 0;
+  // STATUS bits.
+  static constexpr uint32_t s_busy = 1 << 0;
+  static constexpr uint32_t s_done = 1 << 1;
+
+  DMADevice(const QString &name = QString());
+
+  QString name() const override { return m_name; }
+  unsigned byteSize() const override { return NREGISTERS * 4; }
+  const std::vector<RegDesc> &registers() const override { return m_regDescs; }
+  const std::vector<IOSymbol> *extraSymbols() const override {
+    return &m_extraSymbols;
+  }
+  VInt ioRead(AInt offset, unsigned size) override;
+  void ioWrite(AInt offset, VInt value, unsigned size) override;
+
+  /// Sets the number of bytes transferred per cycle, and the number of cycles
+  /// from starting a transfer until its first bytes are transferred. Applies
+  /// from the next transfer.
+  void setBurstBytes(unsigned bytes) { m_burstBytes = std::max(bytes, 1u); }
+  void setLatency(unsigned cycles) { m_latency = cycles; }
+
+  /// Advances the ongoing transfer, if any, by a cycle. Called from the
+  /// simulation thread after each cycle of the processor.
+  void clock();
+  /// Aborts the ongoing transfer and clears the registers.
+  void reset();
+
+  uint32_t status() const { return m_status.load(std::memory_order_relaxed); }
+  /// Returns the length of the ongoing (or latest) transfer, and the number of
+  /// bytes transferred so far.
+  AInt length() const { return m_length.load(std::memory_order_relaxed); }
+  AInt transferred() const {
+    return m_transferred.load(std::memory_order_relaxed);
+  }
+
+private:
+  QString m_name;
+  std::atomic<unsigned> m_burstBytes{4};
+  std::atomic<unsigned> m_latency{0};
+
+  // Programmed registers; SRC, DST and LEN.
+  std::array<AInt, CTRL> m_regs{};
+  std::atomic<uint32_t> m_status{0};
+  // The ongoing transfer, latched from the registers upon being started.
+  AInt m_src = 0;
+  AInt m_dst = 0;
+  unsigned m_burst = 0;
+  unsigned m_delay = 0;
+  std::atomic<AInt> m_length{0};
+  std::atomic<AInt> m_transferred{0};
+
+  std::vector<RegDesc> m_regDescs;
+  std::vector<IOSymbol> m_extraSymbols;
+};
+
+/**
+ * A CLINT-style machine timer. mtime counts the cycles executed by the
+ * processor, and a machine timer interrupt is pending while mtime >= mtimecmp.
+ * Both registers are 64 bits wide, and accessed as a pair of 32-bit words
+ * (low word first). mtime is read-only.
+ */
+class TimerDevice : public IOPeripheral {
+public:
+  enum Register { MTIME, MTIMEH, MTIMECMP, MTIMECMPH, NREGISTERS };
+
+  TimerDevice(const QString &name = QString());
+
+  QString name() const override { return m_name; }
+  unsigned byteSize() const override { return NREGISTERS * 4; }
+  const std::vector<RegDesc> &registers() const override { return m_regDescs; }
+  VInt ioRead(AInt offset, unsigned size) override;
+  void ioWrite(AInt offset, VInt value, unsigned size) override;
+
+  bool isTimer() const override { return true; }
+  uint64_t timerCompare() const override {
+    return m_mtimecmp.load(std::memory_order_relaxed);
+  }
+  uint64_t time() const { return cycleCount ? cycleCount() : 0; }
+
+  /// Disarms the timer; mtimecmp is reset to its maximum value.
+  void reset();
+
+private:
+  QString m_name;
+  std::atomic<uint64_t> m_mtimecmp{std::numeric_limits<uint64_t>::max()};
+  std::vector<RegDesc> m_regDescs;
+};
+
+} // namespace Ripes
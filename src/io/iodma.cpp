@@ -0,0 +1,100 @@
+#include "iodma.h"
+#include "ioregistry.h"
+
+#include <QVBoxLayout>
+
+#include "processorhandler.h"
+
+namespace Ripes {
+
+IODMA::IODMA(QWidget *parent) : IOBase(IOType::DMA, parent) {
+  // Parameters
+  m_parameters[BURST] = IOParam(BURST, "Bytes per cycle", 4, true, 1, 4096);
+  m_parameters[LATENCY] =
+      IOParam(LATENCY, "Latency (cycles)", 0, true, 0, 1000);
+
+  // The transfers of the device are issued on the bus that the peripheral is
+  // attached to by the IOManager.
+  m_device.memCopy = [this](AInt dst, AInt src, AInt bytes) {
+    if (memCopy)
+      memCopy(dst, src, bytes);
+  };
+
+  m_statusLabel = new QLabel(this);
+  auto *layout = new QVBoxLayout(this);
+  layout->addWidget(m_statusLabel);
+  setLayout(layout);
+
+  // The status is refreshed at most once per frame, however many cycles a
+  // transfer is advanced by in between.
+  m_refreshClient =
+      ProcessorHandler::getRefreshScheduler().addClient(this, [=] {
+        m_dirty = false;
+        updateStatus();
+      });
+
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorClocked, this,
+          [this] { processorClocked(); }, Qt::DirectConnection);
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          [this] {
+            m_device.reset();
+            updateStatus();
+          });
+
+  updateTiming();
+  updateStatus();
+}
+
+QString IODMA::description() const {
+  QStringList desc;
+  desc << "Copies LEN bytes from address SRC to address DST, independently "
+          "of the processor.";
+  desc << "Writing CTRL_START to CTRL starts a transfer. STATUS holds "
+          "STATUS_BUSY while the transfer is ongoing, and STATUS_DONE once it "
+          "has completed.";
+  desc << "Following the configured latency, the given number of bytes are "
+          "transferred each cycle. The source and destination must not "
+          "overlap.";
+
+  return desc.join('\n');
+}
+
+void IODMA::updateTiming() {
+  m_device.setBurstBytes(m_parameters.at(BURST).value.toUInt());
+  m_device.setLatency(m_parameters.at(LATENCY).value.toUInt());
+}
+
+VInt IODMA::ioRead(AInt offset, unsigned size) {
+  return m_device.ioRead(offset, size);
+}
+
+void IODMA::ioWrite(AInt offset, VInt value, unsigned size) {
+  m_device.ioWrite(offset, value, size);
+  markDirty();
+}
+
+void IODMA::processorClocked() {
+  if (!(m_device.status() & DMADevice::s_busy))
+    return;
+  m_device.clock();
+  markDirty();
+}
+
+void IODMA::markDirty() {
+  if (!m_dirty.exchange(true))
+    ProcessorHandler::getRefreshScheduler().markDirty(m_refreshClient);
+}
+
+void IODMA::updateStatus() {
+  const uint32_t status = m_device.status();
+  const QString progress = QString::number(m_device.transferred()) + " / " +
+                           QString::number(m_device.length()) + " bytes";
+  if (status & DMADevice::s_busy)
+    m_statusLabel->setText("Transferring: " + progress);
+  else if (status & DMADevice::s_done)
+    m_statusLabel->setText("Done: " + progress);
+  else
+    m_statusLabel->setText("Idle");
+}
+
+} // namespace Ripes
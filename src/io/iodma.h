@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QLabel>
+#include <QVariant>
+#include <QWidget>
+
+#include <atomic>
+
+#include "iobase.h"
+#include "iodevices.h"
+#include "refreshscheduler.h"
+
+namespace Ripes {
+
+class IODMA : public IOBase {
+  Q_OBJECT
+
+  enum Parameters { BURST, LATENCY };
+
+public:
+  IODMA(QWidget *parent);
+  ~IODMA() { unregister(); };
+
+  virtual unsigned byteSize() const override { return m_device.byteSize(); }
+  virtual QString description() const override;
+  virtual QString baseName() const override { return "DMA"; }
+
+  virtual const std::vector<RegDesc> &registers() const override {
+    return m_device.registers();
+  };
+  virtual const std::vector<IOSymbol> *extraSymbols() const override {
+    return m_device.extraSymbols();
+  }
+
+  /**
+   * Hardware read/write functions
+   */
+  virtual VInt ioRead(AInt offset, unsigned size) override;
+  virtual void ioWrite(AInt offset, VInt value, unsigned size) override;
+
+protected:
+  virtual void parameterChanged(unsigned) override { updateTiming(); };
+
+private:
+  void updateTiming();
+  void processorClocked();
+  /// Marks the status label for refresh upon the next frame.
+  void markDirty();
+  void updateStatus();
+
+  // Device state: the registers and the ongoing transfer, advanced by the
+  // simulation thread.
+  DMADevice m_device;
+  QLabel *m_statusLabel;
+  std::atomic<bool> m_dirty{false};
+  RefreshScheduler::ClientID m_refreshClient;
+};
+} // namespace Ripes
@@ -9,59 +9,75 @@
 
 namespace Ripes {
 
+using DPad = DPadDevice;
+
 IODPad::IODPad(QWidget *parent) : IOBase(IOType::DPAD, parent) {
-  for (unsigned i = 0; i < DIRECTIONS; ++i) {
-    QString name;
-    Qt::ArrowType arrow;
+  for (unsigned i = 0; i < DPad::DIRECTIONS; ++i) {
+    Qt::ArrowType arrow = Qt::NoArrow;
     switch (i) {
-    case UP:
-      name = "UP";
+    case DPad::UP:
       arrow = Qt::UpArrow;
       break;
-    case DOWN:
-      name = "DOWN";
+    case DPad::DOWN:
       arrow = Qt::DownArrow;
       break;
-    case LEFT:
-      name = "LEFT";
+    case DPad::LEFT:
       arrow = Qt::LeftArrow;
       break;
-    case RIGHT:
-      name = "RIGHT";
+    case DPad::RIGHT:
       arrow = Qt::RightArrow;
       break;
     }
     auto *button = new QToolButton();
-    m_buttons[static_cast<IdxToDir>(i)] = button;
+    const auto dir = static_cast<IdxToDir>(i);
+    m_buttons[dir] = button;
     button->setArrowType(arrow);
-
-    m_regDescs.push_back(RegDesc{name, RegDesc::RW::R, 1, i * 4, true});
+    connect(button, &QAbstractButton::pressed, this,
+            [=] { m_device.setDown(dir, true); });
+    connect(button, &QAbstractButton::released, this,
+            [=] { m_device.setDown(dir, false); });
   }
 
   auto *gridLayout = new QGridLayout();
-  gridLayout->addWidget(m_buttons[UP], 0, 1);
-  gridLayout->addWidget(m_buttons[DOWN], 2, 1);
-  gridLayout->addWidget(m_buttons[LEFT], 1, 0);
-  gridLayout->addWidget(m_buttons[RIGHT], 1, 2);
+  gridLayout->addWidget(m_buttons[DPad::UP], 0, 1);
+  gridLayout->addWidget(m_buttons[DPad::DOWN], 2, 1);
+  gridLayout->addWidget(m_buttons[DPad::LEFT], 1, 0);
+  gridLayout->addWidget(m_buttons[DPad::RIGHT], 1, 2);
 
   setLayout(gridLayout);
+
+  // Input may be replayed from the simulation thread.
+  m_device.inputChanged = [this] {
+    QMetaObject::invokeMethod(
+        this,
+        [this] {
+          for (const auto &button : m_buttons)
+            button.second->setDown(m_device.isDown(button.first));
+        },
+        Qt::QueuedConnection);
+  };
 }
 
-unsigned IODPad::byteSize() const { return 4 * 4; }
+unsigned IODPad::byteSize() const { return m_device.byteSize(); }
+
+void IODPad::setDown(IdxToDir dir, bool down) {
+  m_buttons.at(dir)->setDown(down);
+  m_device.setDown(dir, down);
+}
 
 void IODPad::keyPressEvent(QKeyEvent *e) {
   switch (e->key()) {
   case Qt::Key_A:
-    m_buttons.at(LEFT)->setDown(true);
+    setDown(DPad::LEFT, true);
     return;
   case Qt::Key_D:
-    m_buttons.at(RIGHT)->setDown(true);
+    setDown(DPad::RIGHT, true);
     return;
   case Qt::Key_W:
-    m_buttons.at(UP)->setDown(true);
+    setDown(DPad::UP, true);
     return;
   case Qt::Key_S:
-    m_buttons.at(DOWN)->setDown(true);
+    setDown(DPad::DOWN, true);
     return;
   }
   IOBase::keyPressEvent(e);
@@ -69,16 +85,16 @@ void IODPad::keyPressEvent(QKeyEvent *e) {
 void IODPad::keyReleaseEvent(QKeyEvent *e) {
   switch (e->key()) {
   case Qt::Key_A:
-    m_buttons.at(LEFT)->setDown(false);
+    setDown(DPad::LEFT, false);
     return;
   case Qt::Key_D:
-    m_buttons.at(RIGHT)->setDown(false);
+    setDown(DPad::RIGHT, false);
     return;
   case Qt::Key_W:
-    m_buttons.at(UP)->setDown(false);
+    setDown(DPad::UP, false);
     return;
   case Qt::Key_S:
-    m_buttons.at(DOWN)->setDown(false);
+    setDown(DPad::DOWN, false);
     return;
   }
   IOBase::keyReleaseEvent(e);
@@ -95,26 +111,12 @@ QString IODPad::description() const {
   return desc.join('\n');
 }
 
-VInt IODPad::ioRead(AInt offset, unsigned) {
-  switch (offset) {
-  case LEFT * 4: {
-    return m_buttons.at(LEFT)->isDown();
-  }
-  case RIGHT * 4: {
-    return m_buttons.at(RIGHT)->isDown();
-  }
-  case UP * 4: {
-    return m_buttons.at(UP)->isDown();
-  }
-  case DOWN * 4: {
-    return m_buttons.at(DOWN)->isDown();
-  }
-  }
-  return 0;
+VInt IODPad::ioRead(AInt offset, unsigned size) {
+  return m_device.ioRead(offset, size);
 }
 
-void IODPad::ioWrite(AInt, VInt, unsigned) {
-  // Write-only
+void IODPad::ioWrite(AInt offset, VInt value, unsigned size) {
+  m_device.ioWrite(offset, value, size);
 }
 
 } // namespace Ripes
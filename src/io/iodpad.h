@@ -7,13 +7,14 @@
 QT_FORWARD_DECLARE_CLASS(QAbstractButton);
 
 #include "iobase.h"
+#include "iodevices.h"
 
 namespace Ripes {
 
 class IODPad : public IOBase {
   Q_OBJECT
 
-  enum IdxToDir { UP, DOWN, LEFT, RIGHT, DIRECTIONS };
+  using IdxToDir = DPadDevice::Direction;
 
 public:
   IODPad(QWidget *parent);
@@ -24,7 +25,7 @@ public:
   virtual QString baseName() const override { return "D-Pad"; };
 
   virtual const std::vector<RegDesc> &registers() const override {
-    return m_regDescs;
+    return m_device.registers();
   };
 
   /**
@@ -33,14 +34,22 @@ public:
   virtual VInt ioRead(AInt offset, unsigned size) override;
   virtual void ioWrite(AInt offset, VInt value, unsigned size) override;
 
+  /// The device model, ie. for recording and replaying input.
+  DPadDevice &device() { return m_device; }
+
 protected:
   virtual void parameterChanged(unsigned) override{/* no parameters */};
   void keyPressEvent(QKeyEvent *e) override;
   void keyReleaseEvent(QKeyEvent *e) override;
 
 private:
-  constexpr static unsigned m_maxSideWidth = 256;
-  std::vector<RegDesc> m_regDescs;
+  /// Presses or releases the button of @p dir, from the GUI thread.
+  void setDown(IdxToDir dir, bool down);
+
   std::map<IdxToDir, QAbstractButton *> m_buttons;
+  // Device state: whether the button of each direction is held down. Written
+  // by the GUI thread, or by the simulation thread while replaying input, and
+  // read by the simulation thread.
+  DPadDevice m_device;
 };
 } // namespace Ripes
@@ -0,0 +1,230 @@
+#include "ioeventrecorder.h"
+
+#include "iobase.h"
+#include "processorhandler.h"
+#include "radix.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+static bool parseValue(const QString &str, uint32_t &value) {
+  bool ok;
+  if (str.startsWith("0x"))
+    value = decodeRadixValue(str, Radix::Hex, &ok);
+  else if (str.startsWith("0b"))
+    value = decodeRadixValue(str, Radix::Binary, &ok);
+  else
+    value = str.toUInt(&ok);
+  return ok;
+}
+
+static long long currentCycle() {
+  return ProcessorHandler::getProcessor()->getCycleCount();
+}
+
+IOEventRecorder::~IOEventRecorder() { stop(); }
+
+QString IOEventRecorder::record(const std::vector<IOInputDevice> &devices,
+                                const QString &path) {
+  stop();
+  m_eventCount = 0;
+  m_scriptFile.setFileName(path);
+  if (!m_scriptFile.open(QIODevice::WriteOnly | QIODevice::Truncate |
+                         QIODevice::Text))
+    return "Error: Could not open IO recording " + path;
+  m_script.setDevice(&m_scriptFile);
+  m_script << "# cycle peripheral value\n";
+
+  m_devices = devices;
+  for (const auto &input : m_devices) {
+    auto setCallback = [&](auto *device) {
+      m_chainedCallbacks[device] = device->inputChanged;
+      device->inputChanged = [this, input, chained = device->inputChanged] {
+        if (chained)
+          chained();
+        logInput(input);
+      };
+    };
+    if (auto *switches = dynamic_cast<SwitchesDevice *>(input.device))
+      setCallback(switches);
+    else if (auto *dpad = dynamic_cast<DPadDevice *>(input.device))
+      setCallback(dpad);
+    logInput(input);
+  }
+  return QString();
+}
+
+QString IOEventRecorder::replay(const std::vector<IOInputDevice> &devices,
+                                const QString &path) {
+  stop();
+  m_devices = devices;
+  const QString err = loadScript(path);
+  if (!err.isEmpty()) {
+    stop();
+    return err;
+  }
+  m_replaying = true;
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorClocked, this,
+          [this] { applyEvents(); }, Qt::DirectConnection);
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          [this] { processorReset(); });
+  processorReset();
+  return QString();
+}
+
+QString IOEventRecorder::stop() {
+  disconnect(ProcessorHandler::get(), nullptr, this, nullptr);
+  m_replaying = false;
+  m_events.clear();
+  m_nextEvent = 0;
+
+  for (const auto &input : m_devices) {
+    const auto chained = m_chainedCallbacks.find(input.device);
+    if (chained == m_chainedCallbacks.end())
+      continue;
+    if (auto *switches = dynamic_cast<SwitchesDevice *>(input.device))
+      switches->inputChanged = chained->second;
+    else if (auto *dpad = dynamic_cast<DPadDevice *>(input.device))
+      dpad->inputChanged = chained->second;
+  }
+  m_chainedCallbacks.clear();
+  m_logged.clear();
+  m_devices.clear();
+
+  if (!m_scriptFile.isOpen())
+    return QString();
+  m_script.flush();
+  const bool failed = m_script.status() != QTextStream::Ok;
+  m_script.setDevice(nullptr);
+  m_scriptFile.close();
+  if (failed)
+    return "Error: Failed to write IO recording " + m_scriptFile.fileName();
+  return QString();
+}
+
+const IOInputDevice *
+IOEventRecorder::findDevice(const QString &symbolName) const {
+  for (const auto &input : m_devices)
+    if (cName(input.name) == symbolName)
+      return &input;
+  return nullptr;
+}
+
+void IOEventRecorder::logInput(const IOInputDevice &input) {
+  const long long cycle = currentCycle();
+  const QString name = cName(input.name);
+  const auto logged = m_logged.find(input.device);
+  const bool first = logged == m_logged.end();
+  const uint32_t previous = first ? 0 : logged->second;
+
+  uint32_t state = 0;
+  if (auto *switches = dynamic_cast<SwitchesDevice *>(input.device)) {
+    state = switches->state();
+    if (first || state != previous) {
+      m_script << cycle << ' ' << name << " 0x" << QString::number(state, 16)
+               << '\n';
+      ++m_eventCount;
+    }
+  } else if (auto *dpad = dynamic_cast<DPadDevice *>(input.device)) {
+    for (unsigned i = 0; i < DPadDevice::DIRECTIONS; ++i) {
+      const auto dir = static_cast<DPadDevice::Direction>(i);
+      const bool down = dpad->isDown(dir);
+      state |= static_cast<uint32_t>(down) << i;
+      if (first || down != static_cast<bool>((previous >> i) & 1)) {
+        m_script << cycle << ' ' << name << ' '
+                 << DPadDevice::directionName(dir) << ' ' << (down ? 1 : 0)
+                 << '\n';
+        ++m_eventCount;
+      }
+    }
+  } else {
+    return;
+  }
+  m_logged[input.device] = state;
+}
+
+QString IOEventRecorder::loadScript(const QString &path) {
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    return "Error: Could not open IO script " + path;
+
+  QTextStream in(&file);
+  unsigned lineNumber = 0;
+  while (!in.atEnd()) {
+    const QString line = in.readLine().trimmed();
+    ++lineNumber;
+    if (line.isEmpty() || line.startsWith('#'))
+      continue;
+
+    const QString where = path + ":" + QString::number(lineNumber) + ": ";
+    const QStringList fields = line.split(' ', Qt::SkipEmptyParts);
+    Event event;
+    bool cycleOk;
+    event.cycle = fields.at(0).toLongLong(&cycleOk);
+    if (!cycleOk || event.cycle < 0)
+      return where + "Invalid cycle '" + fields.at(0) + "'.";
+    if (fields.size() < 2)
+      return where + "Expected a peripheral.";
+    const IOInputDevice *input = findDevice(fields.at(1));
+    if (!input)
+      return where + "Unknown peripheral '" + fields.at(1) + "'.";
+    event.device = input->device;
+
+    if (dynamic_cast<SwitchesDevice *>(event.device)) {
+      if (fields.size() != 3 || !parseValue(fields.at(2), event.value))
+        return where + "Expected the state of the switches.";
+    } else if (dynamic_cast<DPadDevice *>(event.device)) {
+      int direction = -1;
+      for (unsigned i = 0; i < DPadDevice::DIRECTIONS && fields.size() == 4;
+           ++i)
+        if (DPadDevice::directionName(static_cast<DPadDevice::Direction>(i)) ==
+            fields.at(2))
+          direction = i;
+      if (direction < 0 || !parseValue(fields.at(3), event.value))
+        return where + "Expected a direction (UP, DOWN, LEFT or RIGHT) and a "
+                       "button state.";
+      event.direction = static_cast<DPadDevice::Direction>(direction);
+    } else {
+      return where + "Peripheral '" + fields.at(1) + "' takes no input.";
+    }
+    m_events.push_back(event);
+  }
+  m_eventCount = m_events.size();
+
+  // Events of the same cycle are applied in the order of the script.
+  std::stable_sort(
+      m_events.begin(), m_events.end(),
+      [](const Event &a, const Event &b) { return a.cycle < b.cycle; });
+  return QString();
+}
+
+void IOEventRecorder::apply(const Event &event) {
+  if (auto *switches = dynamic_cast<SwitchesDevice *>(event.device))
+    switches->setState(event.value);
+  else if (auto *dpad = dynamic_cast<DPadDevice *>(event.device))
+    dpad->setDown(event.direction, event.value != 0);
+}
+
+void IOEventRecorder::processorReset() {
+  for (const auto &input : m_devices) {
+    if (auto *switches = dynamic_cast<SwitchesDevice *>(input.device))
+      switches->setState(0);
+    else if (auto *dpad = dynamic_cast<DPadDevice *>(input.device))
+      for (unsigned i = 0; i < DPadDevice::DIRECTIONS; ++i)
+        dpad->setDown(static_cast<DPadDevice::Direction>(i), false);
+  }
+  m_nextEvent = 0;
+  applyEvents();
+}
+
+void IOEventRecorder::applyEvents() {
+  if (m_nextEvent == m_events.size())
+    return;
+  const long long cycle = currentCycle();
+  while (m_nextEvent < m_events.size() &&
+         m_events[m_nextEvent].cycle <= cycle)
+    apply(m_events[m_nextEvent++]);
+}
+
+} // namespace Ripes
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <QFile>
+#include <QObject>
+#include <QString>
+#include <QTextStream>
+
+#include <map>
+#include <vector>
+
+#include "iodevices.h"
+
+namespace Ripes {
+
+/// An input peripheral to record or replay: the device model of a switches or
+/// D-pad peripheral, along with the name of the peripheral as mapped by the
+/// IOManager (ie. "Switches 0").
+struct IOInputDevice {
+  QString name;
+  IOPeripheral *device;
+};
+
+/**
+ * @brief The IOEventRecorder class
+ * Records and replays the input of the input peripherals (switches and D-pads),
+ * such that programs depending on user input may be rerun, and timed,
+ * deterministically.
+ *
+ * Input is stored as a script, of a line per event:
+ *   <cycle> <peripheral> <value...>
+ * where <peripheral> is the symbol name of a peripheral (ie. SWITCHES_0), and
+ * the event applies once the processor has executed <cycle> cycles. Switches
+ * take the state of all switches as a value (switch n = bit n), and D-pads the
+ * direction and state of a button, ie. "D_PAD_0 UP 1". Empty lines and lines
+ * starting with '#' are ignored.
+ *
+ * A recording starts with the state of all inputs at the current cycle,
+ * followed by an event for each change of an input, stamped with the cycle
+ * count of the processor at which it occurred. A replay applies the events as
+ * the processor is clocked, and restarts from the first event, with all inputs
+ * released, whenever the processor is reset.
+ */
+class IOEventRecorder : public QObject {
+public:
+  ~IOEventRecorder() override;
+
+  /// Starts recording the input of @p devices to the script at @p path.
+  /// Returns an error message on failure, or an empty string on success.
+  QString record(const std::vector<IOInputDevice> &devices,
+                 const QString &path);
+  /// Starts replaying the script at @p path onto @p devices. Returns an error
+  /// message on failure, or an empty string on success.
+  QString replay(const std::vector<IOInputDevice> &devices,
+                 const QString &path);
+  /// Stops recording or replaying. Returns an error message if writing the
+  /// recording failed, or an empty string on success.
+  QString stop();
+
+  bool recording() const { return m_scriptFile.isOpen(); }
+  bool replaying() const { return m_replaying; }
+  /// Returns the number of events recorded, or loaded for replay.
+  unsigned long long events() const { return m_eventCount; }
+
+private:
+  struct Event {
+    long long cycle = 0;
+    IOPeripheral *device = nullptr;
+    // The state of all switches, or the state of a D-pad button.
+    uint32_t value = 0;
+    DPadDevice::Direction direction = DPadDevice::UP;
+  };
+
+  QString loadScript(const QString &path);
+  const IOInputDevice *findDevice(const QString &symbolName) const;
+  /// Logs the inputs of @p input which changed since they were last logged.
+  void logInput(const IOInputDevice &input);
+  void processorReset();
+  /// Applies the events up to and including the current cycle.
+  void applyEvents();
+  static void apply(const Event &event);
+
+  std::vector<IOInputDevice> m_devices;
+  unsigned long long m_eventCount = 0;
+
+  // Recording state. inputChanged callbacks of the devices are chained, and
+  // restored once recording stops.
+  QFile m_scriptFile;
+  QTextStream m_script;
+  std::map<IOPeripheral *, std::function<void()>> m_chainedCallbacks;
+  // The last logged input of each device; the state of the switches, or the
+  // states of the D-pad buttons (direction n = bit n).
+  std::map<IOPeripheral *, uint32_t> m_logged;
+
+  // Replay state; events are sorted by cycle.
+  bool m_replaying = false;
+  std::vector<Event> m_events;
+  size_t m_nextEvent = 0;
+};
+
+} // namespace Ripes
@@ -0,0 +1,135 @@
+#include "ioframebuffer.h"
+
+#include <QPainter>
+
+#include "hosttrace.h"
+#include "ioregistry.h"
+#include "processorhandler.h"
+
+namespace Ripes {
+
+// The pixel memory is wrapped by a QImage, and must thus be laid out as plain
+// 32-bit words.
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) &&
+                  std::atomic<uint32_t>::is_always_lock_free,
+              "Pixels must be stored as plain 32-bit words");
+
+IOFramebuffer::IOFramebuffer(QWidget *parent)
+    : IOBase(IOType::FRAMEBUFFER, parent),
+      m_pixels(
+          std::make_unique<std::atomic<uint32_t>[]>(s_maxWidth * s_maxHeight)) {
+  // Parameters
+  m_parameters[WIDTH] = IOParam(WIDTH, "Width", 320, true, 1, s_maxWidth);
+  m_parameters[HEIGHT] = IOParam(HEIGHT, "Height", 240, true, 1, s_maxHeight);
+  m_parameters[SCALE] = IOParam(SCALE, "Pixel size", 2, true, 1, 8);
+  m_parameters[VSYNC] = IOParam(VSYNC, "VSync", 0, true, 0, 1);
+
+  // Writes may occur at any rate; the display is repainted at most once per
+  // frame.
+  m_refreshClient =
+      ProcessorHandler::getRefreshScheduler().addClient(this, [=] {
+        m_dirty = false;
+        update();
+      });
+
+  updateFramebuffer();
+}
+
+unsigned IOFramebuffer::byteSize() const {
+  const unsigned width = m_parameters.at(WIDTH).value.toUInt();
+  const unsigned height = m_parameters.at(HEIGHT).value.toUInt();
+  return s_pixelsOffset + width * height * 4;
+}
+
+QString IOFramebuffer::description() const {
+  QStringList desc;
+  desc << "Each pixel maps to a 32-bit word storing an RGB color value, with B "
+          "stored in the least significant byte.";
+  desc << "The byte offset of the pixel at coordinates (x, y) is:";
+  desc << "    offset = PIXELS_OFFSET + (y*WIDTH + x) * 4";
+  desc << "If VSync is set to 1, the display is only refreshed upon a write to "
+          "the VSYNC register; reading VSYNC returns the number of such "
+          "writes.";
+
+  return desc.join('\n');
+}
+
+VInt IOFramebuffer::ioRead(AInt offset, unsigned size) {
+  if (offset < s_pixelsOffset)
+    return offset == 0 ? m_frames.load(std::memory_order_relaxed) : 0;
+
+  offset -= s_pixelsOffset;
+  if (offset / 4 >= s_maxWidth * s_maxHeight)
+    return 0;
+  const uint32_t pixel = m_pixels[offset / 4].load(std::memory_order_relaxed);
+  return (pixel >> ((offset % 4) * 8)) & vsrtl::generateBitmask(size * 8);
+}
+
+void IOFramebuffer::ioWrite(AInt offset, VInt value, unsigned size) {
+  if (offset < s_pixelsOffset) {
+    if (offset == 0) {
+      m_frames.fetch_add(1, std::memory_order_relaxed);
+      markDirty();
+    }
+    return;
+  }
+
+  offset -= s_pixelsOffset;
+  if (offset / 4 >= s_maxWidth * s_maxHeight)
+    return;
+  auto &pixel = m_pixels[offset / 4];
+  if (size >= 4 && offset % 4 == 0) {
+    pixel.store(value, std::memory_order_relaxed);
+  } else {
+    // Sub-word write; pixels are only written by the simulation thread.
+    const unsigned shift = (offset % 4) * 8;
+    const uint32_t mask = vsrtl::generateBitmask(size * 8) << shift;
+    const uint32_t prev = pixel.load(std::memory_order_relaxed);
+    pixel.store((prev & ~mask) | ((value << shift) & mask),
+                std::memory_order_relaxed);
+  }
+  if (!m_vsync.load(std::memory_order_relaxed))
+    markDirty();
+}
+
+void IOFramebuffer::markDirty() {
+  if (!m_dirty.exchange(true))
+    ProcessorHandler::getRefreshScheduler().markDirty(m_refreshClient);
+}
+
+void IOFramebuffer::updateFramebuffer() {
+  const unsigned width = m_parameters.at(WIDTH).value.toUInt();
+  const unsigned height = m_parameters.at(HEIGHT).value.toUInt();
+  m_vsync = m_parameters.at(VSYNC).value.toUInt() != 0;
+
+  m_image = QImage(reinterpret_cast<const uchar *>(m_pixels.get()), width,
+                   height, width * 4, QImage::Format_RGB32);
+
+  m_extraSymbols.clear();
+  m_extraSymbols.push_back(IOSymbol{"WIDTH", width});
+  m_extraSymbols.push_back(IOSymbol{"HEIGHT", height});
+
+  m_regDescs = {
+      RegDesc{"VSYNC", RegDesc::RW::RW, 32, 0, true},
+      RegDesc{"PIXELS", RegDesc::RW::RW, 32, s_pixelsOffset, true}};
+
+  updateGeometry();
+  update();
+  emit regMapChanged();
+}
+
+QSize IOFramebuffer::minimumSizeHint() const {
+  const int scale = m_parameters.at(SCALE).value.toInt();
+  return m_image.size() * scale;
+}
+
+void IOFramebuffer::paintEvent(QPaintEvent *) {
+  HostTrace::Scope traceScope("framebufferPaint", "gui");
+  QPainter painter(this);
+  const int scale = m_parameters.at(SCALE).value.toInt();
+  // The pixel memory is drawn as is; each pixel is scaled without smoothing.
+  painter.drawImage(QRect(QPoint(0, 0), m_image.size() * scale), m_image);
+  painter.end();
+}
+
+} // namespace Ripes
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QImage>
+#include <QVariant>
+#include <QWidget>
+
+#include <atomic>
+#include <memory>
+
+#include "iobase.h"
+#include "refreshscheduler.h"
+
+namespace Ripes {
+
+/**
+ * @brief The IOFramebuffer class
+ * An RGB framebuffer display. The pixel memory of the display is mapped into
+ * the address space of the processor, and is rendered by the widget directly
+ * from its backing store, through a QImage wrapping the pixel memory without
+ * copying it. The display is refreshed at the rate of the UI whenever pixels
+ * are written, or, if vsync is enabled, only upon a write to the VSYNC
+ * register. As on hardware without double buffering, a frame may show pixels
+ * written while it was being drawn.
+ */
+class IOFramebuffer : public IOBase {
+  Q_OBJECT
+
+  enum Parameters { WIDTH, HEIGHT, SCALE, VSYNC };
+
+public:
+  IOFramebuffer(QWidget *parent);
+  ~IOFramebuffer() { unregister(); };
+
+  virtual unsigned byteSize() const override;
+  virtual QString description() const override;
+  virtual QString baseName() const override { return "Framebuffer"; }
+
+  virtual const std::vector<RegDesc> &registers() const override {
+    return m_regDescs;
+  };
+  virtual const std::vector<IOSymbol> *extraSymbols() const override {
+    return &m_extraSymbols;
+  }
+
+  /**
+   * Hardware read/write functions
+   */
+  virtual VInt ioRead(AInt offset, unsigned size) override;
+  virtual void ioWrite(AInt offset, VInt value, unsigned size) override;
+
+protected:
+  virtual void parameterChanged(unsigned) override { updateFramebuffer(); };
+
+  void paintEvent(QPaintEvent *event) override;
+  QSize minimumSizeHint() const override;
+
+private:
+  void updateFramebuffer();
+  /// Schedules a repaint upon the next frame.
+  void markDirty();
+
+  static constexpr unsigned s_maxWidth = 1024;
+  static constexpr unsigned s_maxHeight = 768;
+  // Byte offset of the pixel memory; preceded by the control registers.
+  static constexpr unsigned s_pixelsOffset = 16;
+
+  // Device state: the pixel memory, as 0x00RRGGBB words, written by the
+  // simulation thread. Allocated for the largest framebuffer, such that
+  // resizing the framebuffer never reallocates the pixel memory underneath a
+  // running simulation.
+  std::unique_ptr<std::atomic<uint32_t>[]> m_pixels;
+  // Number of writes to the VSYNC register.
+  std::atomic<uint32_t> m_frames{0};
+  // Wraps the pixel memory.
+  QImage m_image;
+  std::atomic<bool> m_vsync{false};
+  std::atomic<bool> m_dirty{false};
+  RefreshScheduler::ClientID m_refreshClient;
+  std::vector<RegDesc> m_regDescs;
+  std::vector<IOSymbol> m_extraSymbols;
+};
+} // namespace Ripes
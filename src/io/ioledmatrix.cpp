@@ -3,34 +3,40 @@
 #include <QPainter>
 #include <QPen>
 
-#include "STLExtras.h"
+#include "hosttrace.h"
 #include "ioregistry.h"
+#include "processorhandler.h"
 
 namespace Ripes {
 
-IOLedMatrix::IOLedMatrix(QWidget *parent) : IOBase(IOType::LED_MATRIX, parent) {
+IOLedMatrix::IOLedMatrix(QWidget *parent)
+    : IOBase(IOType::LED_MATRIX, parent) {
+  constexpr unsigned maxSideWidth = LedMatrixDevice::s_maxSideWidth;
   constexpr unsigned defaultWidth = 25;
 
   // Parameters
   m_parameters[HEIGHT] =
-      IOParam(WIDTH, "Height", defaultWidth, true, 1, m_maxSideWidth);
+      IOParam(WIDTH, "Height", defaultWidth, true, 1, maxSideWidth);
   m_parameters[WIDTH] =
-      IOParam(WIDTH, "Width", defaultWidth + 10, true, 1, m_maxSideWidth);
+      IOParam(WIDTH, "Width", defaultWidth + 10, true, 1, maxSideWidth);
   m_parameters[SIZE] = IOParam(SIZE, "LED size", 8, true, 1, 100);
 
   m_pen.setWidth(1);
   m_pen.setColor(Qt::black);
 
+  // Writes may occur at any rate; the framebuffer is refreshed, and the
+  // widget repainted, at most once per frame.
+  m_refreshClient =
+      ProcessorHandler::getRefreshScheduler().addClient(this, [=] {
+        m_dirty = false;
+        updateFramebuffer();
+        update();
+      });
+
   updateLEDRegs();
 }
 
-uint32_t IOLedMatrix::byteSize() const {
-  const int width = m_parameters.at(WIDTH).value.toInt();
-  const int height = m_parameters.at(HEIGHT).value.toInt();
-  const int nLEDs = width * height;
-
-  return nLEDs * 4;
-}
+uint32_t IOLedMatrix::byteSize() const { return m_device.byteSize(); }
 
 QString IOLedMatrix::description() const {
   QStringList desc;
@@ -44,44 +50,32 @@ QString IOLedMatrix::description() const {
 }
 
 VInt IOLedMatrix::ioRead(AInt offset, unsigned size) {
-  return (m_ledRegs.at(offset / 4) >> (offset % 4)) &
-         vsrtl::generateBitmask(size * 8);
+  return m_device.ioRead(offset, size);
 }
 
-void IOLedMatrix::ioWrite(AInt offset, VInt value, unsigned) {
-  offset >>= 2; // word addressable
-  if (offset >= m_ledRegs.size()) {
-    Q_ASSERT(false);
-  }
-  m_ledRegs.at(offset) = value;
-  emit scheduleUpdate();
+void IOLedMatrix::ioWrite(AInt offset, VInt value, unsigned size) {
+  m_device.ioWrite(offset, value, size);
+  if (!m_dirty.exchange(true))
+    ProcessorHandler::getRefreshScheduler().markDirty(m_refreshClient);
 }
 
-static QColor regToColor(uint32_t regVal) {
-  return QColor(regVal >> 16 & 0xFF, regVal >> 8 & 0xFF, regVal & 0xFF);
+void IOLedMatrix::updateFramebuffer() {
+  const int nLEDs = m_framebuffer.width() * m_framebuffer.height();
+  auto *pixels = reinterpret_cast<QRgb *>(m_framebuffer.bits());
+  for (int i = 0; i < nLEDs; ++i) {
+    const uint32_t regVal = m_device.led(i);
+    pixels[i] = qRgb(regVal >> 16 & 0xFF, regVal >> 8 & 0xFF, regVal & 0xFF);
+  }
 }
 
 void IOLedMatrix::updateLEDRegs() {
   const unsigned width = m_parameters[WIDTH].value.toInt();
   const unsigned height = m_parameters[HEIGHT].value.toInt();
-  const int nLEDs = width * height;
-  m_ledRegs.resize(nLEDs);
-
-  m_extraSymbols.clear();
-  m_extraSymbols.push_back(IOSymbol{"WIDTH", width});
-  m_extraSymbols.push_back(IOSymbol{"HEIGHT", height});
-
-  m_regDescs.clear();
-  m_regDescs.resize(nLEDs);
-  for (auto mRegDesc : llvm::enumerate(m_regDescs)) {
-    RegDesc regdesc;
-    regdesc.name = "LED_" + QString::number(mRegDesc.index());
-    regdesc.rw = RegDesc::RW::RW;
-    regdesc.bitWidth = 24;
-    regdesc.address = mRegDesc.index() * 4;
-    regdesc.exported = false;
-    mRegDesc.value() = regdesc;
-  }
+
+  m_device.resize(width, height);
+  m_framebuffer = QImage(width, height, QImage::Format_RGB32);
+  updateFramebuffer();
+  updateCellPixmap();
 
   updateGeometry();
   emit regMapChanged();
@@ -90,33 +84,42 @@ void IOLedMatrix::updateLEDRegs() {
 QSize IOLedMatrix::minimumSizeHint() const {
   const int width = m_parameters.at(WIDTH).value.toInt();
   const int height = m_parameters.at(HEIGHT).value.toInt();
-  const int size = m_parameters.at(SIZE).value.toInt();
-  const int pixelWidth = width * (size + m_pen.width());
-  const int pixelHeight = height * (size + m_pen.width());
-  return QSize(pixelWidth, pixelHeight);
+  return QSize(width * cellSize(), height * cellSize());
 }
 
-void IOLedMatrix::paintEvent(QPaintEvent *) {
-  QPainter painter(this);
-  painter.setRenderHint(QPainter::Antialiasing);
-
-  painter.setPen(m_pen);
+int IOLedMatrix::cellSize() const {
+  return m_parameters.at(SIZE).value.toInt() + m_pen.width();
+}
 
-  const int width = m_parameters[WIDTH].value.toInt();
-  const int height = m_parameters[HEIGHT].value.toInt();
-  const int size = m_parameters[SIZE].value.toInt();
-  for (int y = 0; y < height; y++) {
-    for (int x = 0; x < width; x++) {
-      QBrush brush(regToColor(m_ledRegs.at(y * width + x)));
-      painter.setBrush(brush);
+void IOLedMatrix::updateCellPixmap() {
+  const int size = m_parameters.at(SIZE).value.toInt();
+  QImage cell(cellSize(), cellSize(), QImage::Format_ARGB32_Premultiplied);
+  cell.fill(palette().window().color());
 
-      const unsigned xpos = x * (size + m_pen.width());
-      const unsigned ypos = y * (size + m_pen.width());
+  QPainter painter(&cell);
+  painter.setRenderHint(QPainter::Antialiasing);
+  // Clear the inside of the LED, such that the framebuffer shows through.
+  painter.setCompositionMode(QPainter::CompositionMode_Clear);
+  painter.setPen(Qt::NoPen);
+  painter.setBrush(Qt::black);
+  painter.drawEllipse(0, 0, size, size);
+  painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+  painter.setPen(m_pen);
+  painter.setBrush(Qt::NoBrush);
+  painter.drawEllipse(0, 0, size, size);
+  painter.end();
 
-      painter.drawEllipse(xpos, ypos, size, size);
-    }
-  }
+  m_cellPixmap = QPixmap::fromImage(cell);
+}
 
+void IOLedMatrix::paintEvent(QPaintEvent *) {
+  HostTrace::Scope traceScope("ledMatrixPaint", "gui");
+  QPainter painter(this);
+  const QRect area(0, 0, m_framebuffer.width() * cellSize(),
+                   m_framebuffer.height() * cellSize());
+  // Each framebuffer pixel is scaled to an LED cell, without smoothing.
+  painter.drawImage(area, m_framebuffer);
+  painter.drawTiledPixmap(area, m_cellPixmap);
   painter.end();
 }
 
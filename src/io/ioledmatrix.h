@@ -1,10 +1,16 @@
 #pragma once
 
+#include <QImage>
 #include <QPen>
+#include <QPixmap>
 #include <QVariant>
 #include <QWidget>
 
+#include <atomic>
+
 #include "iobase.h"
+#include "iodevices.h"
+#include "refreshscheduler.h"
 
 namespace Ripes {
 
@@ -22,10 +28,10 @@ public:
   virtual QString baseName() const override { return "LED Matrix"; }
 
   virtual const std::vector<RegDesc> &registers() const override {
-    return m_regDescs;
+    return m_device.registers();
   };
   virtual const std::vector<IOSymbol> *extraSymbols() const override {
-    return &m_extraSymbols;
+    return m_device.extraSymbols();
   }
 
   /**
@@ -44,13 +50,27 @@ protected:
   QSize minimumSizeHint() const override;
 
 private:
-  VInt regRead(AInt offset) const;
   void updateLEDRegs();
+  /// Copies a snapshot of the LED registers into the framebuffer.
+  void updateFramebuffer();
+  /// Returns the width and height of the area occupied by each LED.
+  int cellSize() const;
+  /// Draws the outline of a single LED, and masks the area outside of it.
+  void updateCellPixmap();
 
-  unsigned m_maxSideWidth = 256;
-  std::vector<uint32_t> m_ledRegs;
-  std::vector<RegDesc> m_regDescs;
-  std::vector<IOSymbol> m_extraSymbols;
+  // Device state: the color register of each LED, written by the simulation
+  // thread.
+  LedMatrixDevice m_device;
+  // The color of each LED, one pixel per LED, as of the latest refresh; a
+  // snapshot of the LED registers, scaled onto the widget when painted.
+  QImage m_framebuffer;
+  // Drawn over each LED cell of the scaled framebuffer, such that LEDs appear
+  // round.
+  QPixmap m_cellPixmap;
+  // Set upon a write, until the framebuffer is refreshed by the refresh
+  // scheduler.
+  std::atomic<bool> m_dirty{false};
+  RefreshScheduler::ClientID m_refreshClient;
 
   QPen m_pen;
 };
@@ -1,8 +1,10 @@
 #include "iomanager.h"
 
 #include "processorhandler.h"
+#include "processors/pagedaddressspace.h"
 #include "ripessettings.h"
 
+#include <algorithm>
 #include <memory>
 #include <ostream>
 
@@ -44,7 +46,7 @@ AInt IOManager::nextPeripheralAddress() const {
   return base;
 }
 
-AInt IOManager::assignBaseAddress(IOBase *peripheral) {
+AInt IOManager::assignBaseAddress(IOPeripheral *peripheral) {
   unregisterPeripheralWithProcessor(peripheral);
   const AInt base = nextPeripheralAddress();
   m_periphMMappings[peripheral] = {base, peripheral->byteSize(),
@@ -64,12 +66,24 @@ void IOManager::assignBaseAddresses() {
   refreshMemoryMap();
 }
 
-void IOManager::peripheralSizeChanged(IOBase *) {
+void IOManager::peripheralSizeChanged(IOPeripheral *) {
   assignBaseAddresses();
   refreshMemoryMap();
 }
 
-void IOManager::registerPeripheralWithProcessor(IOBase *peripheral) {
+static PagedAddressSpaceMM *pagedMemory() {
+  return dynamic_cast<PagedAddressSpaceMM *>(&ProcessorHandler::getMemory());
+}
+
+/// Paged memories cache the IO memory map in their page table; it must be
+/// synchronized with the underlying address space before the map changes.
+static void synchronizePagedMemory() {
+  if (auto *paged = pagedMemory())
+    paged->synchronize();
+}
+
+void IOManager::registerPeripheralWithProcessor(IOPeripheral *peripheral) {
+  synchronizePagedMemory();
   ProcessorHandler::getMemory().addIORegion(
       m_periphMMappings.at(peripheral).startAddr, peripheral->byteSize(),
       vsrtl::core::IOFunctors{
@@ -79,22 +93,77 @@ void IOManager::registerPeripheralWithProcessor(IOBase *peripheral) {
           [peripheral](AInt offset, unsigned size) {
             return peripheral->ioRead(offset, size);
           }});
+  // Paged memories dispatch to the peripheral directly through their page
+  // table, bypassing the IO functors.
+  if (auto *paged = pagedMemory())
+    paged->addIODevice(m_periphMMappings.at(peripheral).startAddr,
+                       peripheral->byteSize(), peripheral);
 
   peripheral->memWrite = [](AInt address, VInt value, unsigned size) {
-    ProcessorHandler::getMemory().writeMem(address, value, size);
+    ProcessorHandler::writeMem(address, value, size);
   };
   peripheral->memRead = [](AInt address, unsigned size) {
     return ProcessorHandler::getMemory().readMem(address, size);
   };
+  peripheral->memCopy = [](AInt dst, AInt src, AInt bytes) {
+    if (auto *paged = pagedMemory()) {
+      paged->copyMem(dst, src, bytes);
+    } else {
+      // Transferred in words where aligned, such that word-addressed
+      // peripherals may be targeted.
+      auto &memory = ProcessorHandler::getMemory();
+      for (AInt offset = 0; offset < bytes;) {
+        const unsigned width = ((src + offset) % 4 == 0 &&
+                                (dst + offset) % 4 == 0 && bytes - offset >= 4)
+                                   ? 4
+                                   : 1;
+        memory.writeMem(dst + offset, memory.readMem(src + offset, width),
+                        width);
+        offset += width;
+      }
+    }
+    ProcessorHandler::memoryWritten(dst, bytes);
+  };
+  peripheral->cycleCount = [] {
+    return static_cast<uint64_t>(
+        ProcessorHandler::getProcessor()->getCycleCount());
+  };
+  if (peripheral->isTimer())
+    updateTimerInterrupt();
 }
 
-void IOManager::unregisterPeripheralWithProcessor(IOBase *peripheral) {
+void IOManager::unregisterPeripheralWithProcessor(IOPeripheral *peripheral) {
   const auto &mmEntry = m_periphMMappings.find(peripheral);
   if (mmEntry != m_periphMMappings.end()) {
+    synchronizePagedMemory();
+    if (auto *paged = pagedMemory())
+      paged->removeIODevice(mmEntry->second.startAddr);
     ProcessorHandler::getMemory().removeIORegion(mmEntry->second.startAddr,
                                                  mmEntry->second.size);
     m_periphMMappings.erase(mmEntry);
+    if (peripheral->isTimer())
+      updateTimerInterrupt();
+  }
+}
+
+void IOManager::updateTimerInterrupt() {
+  std::vector<IOPeripheral *> timers;
+  for (const auto &periph : m_periphMMappings)
+    if (periph.first->isTimer())
+      timers.push_back(periph.first);
+
+  auto *proc = ProcessorHandler::getProcessorNonConst();
+  if (timers.empty()) {
+    proc->timerCompare = nullptr;
+    return;
   }
+  // With several timers, the earliest deadline interrupts first.
+  proc->timerCompare = [timers] {
+    uint64_t cmp = std::numeric_limits<uint64_t>::max();
+    for (const auto *timer : timers)
+      cmp = std::min(cmp, timer->timerCompare());
+    return cmp;
+  };
 }
 
 IOBase *IOManager::createPeripheral(IOType type, unsigned forcedId) {
@@ -128,6 +197,21 @@ void IOManager::removePeripheral(IOBase *peripheral, std::atomic<bool> &ok) {
   ok = true;
 }
 
+void IOManager::attachPeripheral(IOPeripheral *peripheral) {
+  Q_ASSERT(m_peripherals.count(peripheral) == 0);
+  m_peripherals.insert(peripheral);
+  assignBaseAddress(peripheral);
+  refreshMemoryMap();
+}
+
+void IOManager::detachPeripheral(IOPeripheral *peripheral) {
+  auto periphit = m_peripherals.find(peripheral);
+  Q_ASSERT(periphit != m_peripherals.end());
+  unregisterPeripheralWithProcessor(peripheral);
+  m_peripherals.erase(periphit);
+  refreshMemoryMap();
+}
+
 void IOManager::refreshAllPeriphsToProcessor() {
   for (const auto &periph : m_periphMMappings) {
     registerPeripheralWithProcessor(periph.first);
@@ -156,7 +240,7 @@ void IOManager::refreshMemoryMap() {
 }
 
 std::vector<std::pair<Symbol, AInt>>
-IOManager::assemblerSymbolsForPeriph(IOBase *peripheral) const {
+IOManager::assemblerSymbolsForPeriph(IOPeripheral *peripheral) const {
   const QString &periphName = cName(peripheral->name());
   std::vector<std::pair<Symbol, AInt>> symbols;
   const auto &periphInfo = m_periphMMappings.at(peripheral);
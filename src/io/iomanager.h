@@ -40,6 +40,15 @@ public:
 
   IOBase *createPeripheral(IOType type, unsigned forcedId = UINT_MAX);
   void removePeripheral(IOBase *peripheral, std::atomic<bool> &ok);
+
+  /**
+   * @brief attachPeripheral
+   * Maps the headless @p peripheral into the address space of the processor,
+   * alongside the peripherals of the IO tab. The peripheral is owned by the
+   * caller, and must be detached before it is destroyed.
+   */
+  void attachPeripheral(IOPeripheral *peripheral);
+  void detachPeripheral(IOPeripheral *peripheral);
   const MemoryMap &memoryMap() const { return m_memoryMap; }
 
   /**
@@ -58,7 +67,7 @@ public:
     return m_assemblerSymbols;
   }
   std::vector<std::pair<Symbol, AInt>>
-  assemblerSymbolsForPeriph(IOBase *peripheral) const;
+  assemblerSymbolsForPeriph(IOPeripheral *peripheral) const;
 
 signals:
   void memoryMapChanged();
@@ -75,7 +84,7 @@ private:
   void updateSymbols();
 
   void refreshMemoryMap();
-  void peripheralSizeChanged(IOBase *peripheral);
+  void peripheralSizeChanged(IOPeripheral *peripheral);
 
   /**
    * @brief registerPeripheralWithProcessor
@@ -84,8 +93,15 @@ private:
    * between the peripheral memory read/write functionality, and the processor
    * memory.
    */
-  void registerPeripheralWithProcessor(IOBase *peripheral);
-  void unregisterPeripheralWithProcessor(IOBase *peripheral);
+  void registerPeripheralWithProcessor(IOPeripheral *peripheral);
+  void unregisterPeripheralWithProcessor(IOPeripheral *peripheral);
+
+  /**
+   * @brief updateTimerInterrupt
+   * Connects the machine timer interrupt of the processor to the currently
+   * mapped timer peripherals, if any.
+   */
+  void updateTimerInterrupt();
 
   /**
    * @brief refreshAllPeriphsToProcessor
@@ -100,12 +116,12 @@ private:
    */
   AInt nextPeripheralAddress() const;
 
-  AInt assignBaseAddress(IOBase *peripheral);
+  AInt assignBaseAddress(IOPeripheral *peripheral);
   void assignBaseAddresses();
 
   MemoryMap m_memoryMap;
-  std::map<IOBase *, MemoryMapEntry> m_periphMMappings;
-  std::set<IOBase *> m_peripherals;
+  std::map<IOPeripheral *, MemoryMapEntry> m_periphMMappings;
+  std::set<IOPeripheral *> m_peripherals;
   Assembler::SymbolMap m_assemblerSymbols;
   std::unique_ptr<QFile> m_symbolsHeaderFile;
 };
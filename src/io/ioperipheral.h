@@ -0,0 +1,92 @@
+#pragma once
+
+#include <QString>
+
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "../assembler/program.h"
+#include "processors/mmiodevice.h"
+
+namespace Ripes {
+
+struct IOSymbol {
+  Symbol name;
+  VInt value;
+};
+
+struct RegDesc {
+  enum class RW { R, W, RW };
+  QString name;
+  RW rw;
+  unsigned bitWidth;
+  AInt address;
+  /**
+   * @brief exported
+   * if true, a constant symbol is generated that may be referenced in the
+   * assembler, which targets this register.
+   */
+  bool exported = false;
+};
+
+/**
+ * @brief The IOPeripheral class
+ * A memory mapped peripheral, as mapped into the address space of the processor
+ * by the IOManager. Peripherals are either widgets of the IO tab (see IOBase),
+ * or headless device models (see iodevices.h), which may be attached without a
+ * GUI.
+ */
+class IOPeripheral : public MMIODevice {
+public:
+  /**
+   * @brief name
+   * @returns unique name for this specific component
+   */
+  virtual QString name() const = 0;
+
+  /**
+   * @brief byteSize
+   * Size of this peripheral, in bytes
+   */
+  virtual unsigned byteSize() const = 0;
+
+  /**
+   * @brief registers
+   * @return a description of the programmable interface of this peripheral
+   */
+  virtual const std::vector<RegDesc> &registers() const = 0;
+
+  /**
+   * @brief extraSymbols
+   * @returns the set of extra symbols defined by this peripheral. Useful if
+   * some symbols aren't directly translated from the register descriptions of
+   * this peripheral.
+   */
+  virtual const std::vector<IOSymbol> *extraSymbols() const { return nullptr; }
+
+  /**
+   * @brief isTimer
+   * @returns whether this peripheral is a machine timer, driving the machine
+   * timer interrupt of the processor. A timer interrupt is pending while the
+   * cycle count of the processor is at least the value returned by
+   * timerCompare() (the mtimecmp register).
+   */
+  virtual bool isTimer() const { return false; }
+  virtual uint64_t timerCompare() const {
+    return std::numeric_limits<uint64_t>::max();
+  }
+
+  /**
+   * Read/write functions from peripheral to bus (memory/other periphs)
+   */
+  std::function<void(AInt, AInt, VInt)> memWrite;
+  std::function<VInt(AInt, AInt)> memRead;
+  /// Burst transfer from peripheral to bus; copies a number of bytes from a
+  /// source address to a (non-overlapping) destination address.
+  std::function<void(AInt dst, AInt src, AInt bytes)> memCopy;
+  /// Returns the number of cycles executed by the processor.
+  std::function<uint64_t()> cycleCount;
+};
+
+} // namespace Ripes
@@ -3,9 +3,12 @@
 #include "iobase.h"
 #include <QWidget>
 
+#include "iodma.h"
 #include "iodpad.h"
+#include "ioframebuffer.h"
 #include "ioledmatrix.h"
 #include "ioswitches.h"
+#include "iotimer.h"
 
 /** @brief IORegistry
  *
@@ -18,7 +21,15 @@
 
 namespace Ripes {
 
-enum IOType { LED_MATRIX, SWITCHES, DPAD, NPERIPHERALS };
+enum IOType {
+  LED_MATRIX,
+  SWITCHES,
+  DPAD,
+  DMA,
+  FRAMEBUFFER,
+  TIMER,
+  NPERIPHERALS
+};
 
 template <typename T>
 IOBase *createIO(QWidget *parent) {
@@ -31,11 +42,17 @@ using IOFactory = std::function<IOBase *(QWidget *parent)>;
 const static std::map<IOType, QString> IOTypeTitles = {
     {IOType::LED_MATRIX, "LED Matrix"},
     {IOType::SWITCHES, "Switches"},
-    {IOType::DPAD, "D-Pad"}};
+    {IOType::DPAD, "D-Pad"},
+    {IOType::DMA, "DMA"},
+    {IOType::FRAMEBUFFER, "Framebuffer"},
+    {IOType::TIMER, "Timer"}};
 const static std::map<IOType, IOFactory> IOFactories = {
     {IOType::LED_MATRIX, createIO<IOLedMatrix>},
     {IOType::SWITCHES, createIO<IOSwitches>},
-    {IOType::DPAD, createIO<IODPad>}};
+    {IOType::DPAD, createIO<IODPad>},
+    {IOType::DMA, createIO<IODMA>},
+    {IOType::FRAMEBUFFER, createIO<IOFramebuffer>},
+    {IOType::TIMER, createIO<IOTimer>}};
 
 } // namespace Ripes
 
@@ -12,6 +12,8 @@
 #include <QtGui/QMouseEvent>
 #include <QtGui/QPainter>
 
+#include <numeric>
+
 namespace Ripes {
 
 ToggleButton::ToggleButton(int trackRadius, int thumbRadius, bool rotated,
@@ -143,6 +145,12 @@ IOSwitches::IOSwitches(QWidget *parent) : IOBase(IOType::SWITCHES, parent) {
   m_switchLayout = new QGridLayout(this);
   setLayout(m_switchLayout);
 
+  // Input may be replayed from the simulation thread.
+  m_device.inputChanged = [this] {
+    QMetaObject::invokeMethod(
+        this, [this] { syncSwitches(); }, Qt::QueuedConnection);
+  };
+
   updateSwitches();
 }
 
@@ -162,13 +170,13 @@ void IOSwitches::updateSwitches() {
       auto *sw = new ToggleButton(10, 8, true, this);
       auto *label = new QLabel(QString::number(i), this);
       m_switches[i] = {label, sw};
+      connect(sw, &QAbstractButton::toggled, this, &IOSwitches::updateState);
       m_switchLayout->addWidget(label, 0, i, Qt::AlignCenter);
       m_switchLayout->addWidget(sw, 1, i, Qt::AlignCenter);
     }
   }
 
-  m_extraSymbols.clear();
-  m_extraSymbols.push_back(IOSymbol{"N", nSwitches});
+  m_device.setCount(nSwitches);
 
   // Remove extra switches if # of switches was reduced
   std::vector<unsigned> idxToDelete;
@@ -185,26 +193,32 @@ void IOSwitches::updateSwitches() {
     it->second.second->deleteLater();
     m_switches.erase(idx);
   }
-
-  // No reason to export the register, since the base pointer already points to
-  // it, and it is the only register of this component.
-  m_regDescs = {RegDesc{"Switches", RegDesc::RW::R, nSwitches, 0, false}};
+  updateState();
   updateGeometry();
 
   emit regMapChanged();
 }
 
-VInt IOSwitches::ioRead(AInt, unsigned) {
-  return std::accumulate(m_switches.begin(), m_switches.end(), 0,
-                         [=](uint32_t acc, const auto &sw) {
-                           return acc | (sw.second.second->isChecked())
-                                            << sw.first;
-                         });
+void IOSwitches::updateState() {
+  m_device.setState(std::accumulate(
+      m_switches.begin(), m_switches.end(), 0,
+      [=](uint32_t acc, const auto &sw) {
+        return acc | (sw.second.second->isChecked()) << sw.first;
+      }));
+}
+
+void IOSwitches::syncSwitches() {
+  const uint32_t state = m_device.state();
+  for (const auto &sw : m_switches)
+    sw.second.second->setChecked((state >> sw.first) & 1);
+}
+
+VInt IOSwitches::ioRead(AInt offset, unsigned size) {
+  return m_device.ioRead(offset, size);
 }
 
-void IOSwitches::ioWrite(AInt, VInt, unsigned) {
-  // Read-only
-  return;
+void IOSwitches::ioWrite(AInt offset, VInt value, unsigned size) {
+  m_device.ioWrite(offset, value, size);
 }
 
 } // namespace Ripes
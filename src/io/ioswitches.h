@@ -9,6 +9,7 @@
 #include <QtWidgets/QAbstractButton>
 
 #include "iobase.h"
+#include "iodevices.h"
 
 namespace Ripes {
 
@@ -72,10 +73,10 @@ public:
   virtual QString baseName() const override { return "Switches"; };
 
   virtual const std::vector<RegDesc> &registers() const override {
-    return m_regDescs;
+    return m_device.registers();
   };
   virtual const std::vector<IOSymbol> *extraSymbols() const override {
-    return &m_extraSymbols;
+    return m_device.extraSymbols();
   }
 
   /**
@@ -84,16 +85,24 @@ public:
   virtual VInt ioRead(AInt offset, unsigned size) override;
   virtual void ioWrite(AInt offset, VInt value, unsigned size) override;
 
+  /// The device model, ie. for recording and replaying input.
+  SwitchesDevice &device() { return m_device; }
+
 protected:
   virtual void parameterChanged(unsigned) override { updateSwitches(); };
 
 private:
   void updateSwitches();
+  /// Publishes the state of the switches to the device state.
+  void updateState();
+  /// Toggles the switches to the device state, ie. as replayed.
+  void syncSwitches();
 
-  uint32_t regRead(AInt offset) const;
   std::map<unsigned, std::pair<QLabel *, ToggleButton *>> m_switches;
+  // Device state: switch n is set in bit n. Written by the GUI thread, or by
+  // the simulation thread while replaying input, and read by the simulation
+  // thread.
+  SwitchesDevice m_device;
   QGridLayout *m_switchLayout;
-  std::vector<RegDesc> m_regDescs;
-  std::vector<IOSymbol> m_extraSymbols;
 };
 } // namespace Ripes
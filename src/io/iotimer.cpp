@@ -0,0 +1,76 @@
+#include "iotimer.h"
+#include "ioregistry.h"
+
+#include <QVBoxLayout>
+
+#include "processorhandler.h"
+
+namespace Ripes {
+
+IOTimer::IOTimer(QWidget *parent) : IOBase(IOType::TIMER, parent) {
+  // mtime is read from the bus that the peripheral is attached to by the
+  // IOManager.
+  m_device.cycleCount = [this] { return cycleCount ? cycleCount() : 0; };
+
+  m_statusLabel = new QLabel(this);
+  auto *layout = new QVBoxLayout(this);
+  layout->addWidget(m_statusLabel);
+  setLayout(layout);
+
+  m_refreshClient =
+      ProcessorHandler::getRefreshScheduler().addClient(this, [=] {
+        m_dirty = false;
+        updateStatus();
+      });
+
+  // mtime advances every cycle; the status is refreshed at most once per
+  // frame.
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorClocked, this,
+          [this] { markDirty(); }, Qt::DirectConnection);
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          [this] {
+            m_device.reset();
+            updateStatus();
+          });
+
+  updateStatus();
+}
+
+QString IOTimer::description() const {
+  QStringList desc;
+  desc << "A machine timer. MTIME/MTIMEH count the cycles executed by the "
+          "processor.";
+  desc << "A machine timer interrupt is pending while MTIME >= MTIMECMP, both "
+          "being 64-bit values accessed as a low and a high word. MTIMECMP is "
+          "reset to its maximum value.";
+  desc << "Interrupts and the wfi instruction are supported by the "
+          "single-cycle ISS processor model.";
+
+  return desc.join('\n');
+}
+
+VInt IOTimer::ioRead(AInt offset, unsigned size) {
+  return m_device.ioRead(offset, size);
+}
+
+void IOTimer::ioWrite(AInt offset, VInt value, unsigned size) {
+  m_device.ioWrite(offset, value, size);
+  markDirty();
+}
+
+void IOTimer::markDirty() {
+  if (!m_dirty.exchange(true))
+    ProcessorHandler::getRefreshScheduler().markDirty(m_refreshClient);
+}
+
+void IOTimer::updateStatus() {
+  const uint64_t cmp = m_device.timerCompare();
+  QString text = "mtime: " + QString::number(m_device.time());
+  if (cmp == std::numeric_limits<uint64_t>::max())
+    text += "\nmtimecmp: disarmed";
+  else
+    text += "\nmtimecmp: " + QString::number(cmp);
+  m_statusLabel->setText(text);
+}
+
+} // namespace Ripes
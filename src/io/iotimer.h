@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QLabel>
+#include <QVariant>
+#include <QWidget>
+
+#include <atomic>
+
+#include "iobase.h"
+#include "iodevices.h"
+#include "refreshscheduler.h"
+
+namespace Ripes {
+
+class IOTimer : public IOBase {
+  Q_OBJECT
+
+public:
+  IOTimer(QWidget *parent);
+  ~IOTimer() { unregister(); };
+
+  virtual unsigned byteSize() const override { return m_device.byteSize(); }
+  virtual QString description() const override;
+  virtual QString baseName() const override { return "Timer"; }
+
+  virtual const std::vector<RegDesc> &registers() const override {
+    return m_device.registers();
+  };
+
+  bool isTimer() const override { return true; }
+  uint64_t timerCompare() const override { return m_device.timerCompare(); }
+
+  /**
+   * Hardware read/write functions
+   */
+  virtual VInt ioRead(AInt offset, unsigned size) override;
+  virtual void ioWrite(AInt offset, VInt value, unsigned size) override;
+
+protected:
+  virtual void parameterChanged(unsigned) override{/* no parameters */};
+
+private:
+  /// Marks the status label for refresh upon the next frame.
+  void markDirty();
+  void updateStatus();
+
+  // Device state: mtimecmp, written by the simulation thread.
+  TimerDevice m_device;
+  QLabel *m_statusLabel;
+  std::atomic<bool> m_dirty{false};
+  RefreshScheduler::ClientID m_refreshClient;
+};
+} // namespace Ripes
@@ -2,8 +2,10 @@
 #include "ui_iotab.h"
 
 #include <QDockWidget>
+#include <QFileDialog>
 #include <QGraphicsItem>
 #include <QMdiSubWindow>
+#include <QMessageBox>
 #include <QScreen>
 #include <QToolBar>
 
@@ -79,6 +81,29 @@ IOTab::IOTab(QToolBar *toolbar, QWidget *parent)
   connect(ProcessorHandler::get(), &ProcessorHandler::runFinished, this,
           [=] { m_ui->peripheralsTable->setEnabled(true); });
 
+  // Input recording and replay
+  m_recordAction = new QAction(QIcon(":/icons/trace.svg"), "Record input",
+                               this);
+  m_recordAction->setCheckable(true);
+  m_recordAction->setToolTip(
+      "Record the input of the switches and D-pads to a file, stamped with the "
+      "cycle of each input change");
+  connect(m_recordAction, &QAction::triggered, this, &IOTab::recordInput);
+  m_toolbar->addAction(m_recordAction);
+
+  m_replayAction = new QAction(QIcon(":/icons/loadfile.svg"), "Replay input",
+                               this);
+  m_replayAction->setCheckable(true);
+  m_replayAction->setToolTip(
+      "Replay recorded input to the switches and D-pads. The recording is "
+      "replayed from the start whenever the processor is reset");
+  connect(m_replayAction, &QAction::triggered, this, &IOTab::replayInput);
+  m_toolbar->addAction(m_replayAction);
+
+  // The recorded peripherals must outlive the recording.
+  connect(&IOManager::get(), &IOManager::peripheralRemoved, this,
+          [this] { stopInput(); });
+
   // Store peripheral state before exiting the program
   connect(RipesSettings::getObserver(RIPES_GLOBALSIGNAL_QUIT),
           &SettingObserver::modified, this, &IOTab::storePeripheralState);
@@ -99,6 +124,57 @@ IOTab::IOTab(QToolBar *toolbar, QWidget *parent)
   m_ui->splitter->setSizes({largeWidth, static_cast<int>(largeWidth * 3), 0});
 }
 
+std::vector<IOInputDevice> IOTab::inputDevices() const {
+  std::vector<IOInputDevice> inputs;
+  for (const auto &it : m_periphToTab) {
+    if (auto *switches = dynamic_cast<IOSwitches *>(it.first))
+      inputs.push_back({switches->name(), &switches->device()});
+    else if (auto *dpad = dynamic_cast<IODPad *>(it.first))
+      inputs.push_back({dpad->name(), &dpad->device()});
+  }
+  return inputs;
+}
+
+void IOTab::stopInput() {
+  const QString err = m_inputRecorder.stop();
+  m_recordAction->setChecked(false);
+  m_replayAction->setChecked(false);
+  if (!err.isEmpty())
+    QMessageBox::warning(this, "Error", err);
+}
+
+void IOTab::recordInput(bool start) {
+  stopInput();
+  if (!start)
+    return;
+  const QString path = QFileDialog::getSaveFileName(
+      this, "Record input", "", "IO scripts (*.txt);;All files (*)");
+  if (path.isEmpty())
+    return;
+  const QString err = m_inputRecorder.record(inputDevices(), path);
+  if (!err.isEmpty()) {
+    QMessageBox::warning(this, "Error", err);
+    return;
+  }
+  m_recordAction->setChecked(true);
+}
+
+void IOTab::replayInput(bool start) {
+  stopInput();
+  if (!start)
+    return;
+  const QString path = QFileDialog::getOpenFileName(
+      this, "Replay input", "", "IO scripts (*.txt);;All files (*)");
+  if (path.isEmpty())
+    return;
+  const QString err = m_inputRecorder.replay(inputDevices(), path);
+  if (!err.isEmpty()) {
+    QMessageBox::warning(this, "Error", err);
+    return;
+  }
+  m_replayAction->setChecked(true);
+}
+
 void IOTab::updateIOSymbolFilePreview() {
   const auto &headerPath = IOManager::get().cSymbolsHeaderpath();
   auto headerFile = QFile(headerPath);
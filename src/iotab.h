@@ -9,6 +9,7 @@
 #include "memorymodel.h"
 #include "ripestab.h"
 
+#include "io/ioeventrecorder.h"
 #include "io/iomanager.h"
 #include "io/ioregistry.h"
 
@@ -48,6 +49,17 @@ private:
   void storePeripheralState();
   void updateIOSymbolFilePreview();
 
+  /**
+   * @brief Input recording and replay
+   * The input of the switches and D-pads may be recorded to, and replayed from,
+   * an IO event script (see IOEventRecorder), such that interactive programs
+   * may be rerun deterministically, ie. in CLI mode through --io-script.
+   */
+  void recordInput(bool start);
+  void replayInput(bool start);
+  void stopInput();
+  std::vector<IOInputDevice> inputDevices() const;
+
   void tile();
   Ui::IOTab *m_ui = nullptr;
 
@@ -66,5 +78,9 @@ private:
    * subwindow.
    */
   std::unordered_map<QWidget *, QMdiSubWindow *> m_subWindows;
+
+  IOEventRecorder m_inputRecorder;
+  QAction *m_recordAction = nullptr;
+  QAction *m_replayAction = nullptr;
 };
 } // namespace Ripes
@@ -3,6 +3,7 @@
 #include <QMap>
 #include <QSet>
 #include <QString>
+#include <cstdint>
 #include <memory>
 #include <set>
 
@@ -49,6 +50,19 @@ public:
   virtual QString regInfo(unsigned i) const = 0;
   /// Returns if the i'th register is read-only.
   virtual bool regIsReadOnly(unsigned i) const = 0;
+
+  /// The floating-point register counterparts of the above. ISAs without
+  /// floating-point registers (or with them disabled) report no registers.
+  virtual unsigned fpRegCnt() const { return 0; }
+  virtual QString fpRegName(unsigned /*i*/) const { return QString(); }
+  virtual unsigned fpRegNumber(const QString & /*regName*/,
+                               bool &success) const {
+    success = false;
+    return 0;
+  }
+  virtual QString fpRegAlias(unsigned i) const { return fpRegName(i); }
+  virtual QString fpRegInfo(unsigned /*i*/) const { return QString(); }
+  virtual unsigned fpBits() const { return 0; } // FP register width, in bits
   virtual unsigned bits() const = 0; // Register width, in bits
   unsigned bytes() const {
     return bits() / CHAR_BIT;
@@ -93,6 +107,21 @@ public:
   bool extensionEnabled(const QString &ext) const {
     return enabledExtensions().contains(ext);
   }
+
+  /**
+   * @brief extensionMask
+   * The enabled single-letter extensions, as a bitmask of the extensionBit()
+   * of each. The mask is computed once upon construction of the ISA, such that
+   * hot paths (ie. decoding and uncompressing instructions) may check for an
+   * extension without comparing strings.
+   */
+  static constexpr uint32_t extensionBit(char ext) {
+    return ext >= 'A' && ext <= 'Z' ? 1u << (ext - 'A') : 0;
+  }
+  uint32_t extensionMask() const { return m_extensionMask; }
+  bool extensionEnabled(char ext) const {
+    return m_extensionMask & extensionBit(ext);
+  }
   bool supportsExtension(const QString &ext) const {
     return supportedExtensions().contains(ext);
   }
@@ -113,6 +142,19 @@ public:
 
 protected:
   ISAInfoBase() {}
+
+  /// Computes extensionMask() from enabledExtensions(). To be called by ISAs
+  /// once their enabled extensions are set.
+  void updateExtensionMask() {
+    m_extensionMask = 0;
+    for (const auto &ext : enabledExtensions()) {
+      if (ext.size() == 1)
+        m_extensionMask |= extensionBit(ext.at(0).toLatin1());
+    }
+  }
+
+private:
+  uint32_t m_extensionMask = 0;
 };
 
 // Shallow ISA info used to drive ISA construction and UI representation.
@@ -17,6 +17,7 @@ public:
         assert(false && "Invalid extension specified for ISA");
       }
     }
+    updateExtensionMask();
   }
 
   ISA isaID() const override { return ISA::RV32I; }
@@ -28,7 +29,7 @@ public:
 
     // Proceed in canonical order. Canonical ordering is defined in the RISC-V
     // spec.
-    for (const auto &ext : {"M", "A", "F", "D", "C"}) {
+    for (const auto &ext : {"M", "A", "F", "D", "C", "V"}) {
       if (m_enabledExtensions.contains(ext)) {
         march += QString(ext).toLower();
       }
@@ -39,7 +40,7 @@ public:
   QString CCmabi() const override { return "ilp32"; }
 
   unsigned instrByteAlignment() const override {
-    return extensionEnabled("C") ? 2 : 4;
+    return extensionEnabled('C') ? 2 : 4;
   };
 };
 
@@ -17,6 +17,7 @@ public:
         assert(false && "Invalid extension specified for ISA");
       }
     }
+    updateExtensionMask();
   }
 
   ISA isaID() const override { return ISA::RV64I; }
@@ -26,7 +27,7 @@ public:
     QString march = "rv64i";
 
     // Proceed in canonical order
-    for (const auto &ext : {"M", "A", "F", "D", "C"}) {
+    for (const auto &ext : {"M", "A", "F", "D", "C", "V"}) {
       if (m_enabledExtensions.contains(ext)) {
         march += QString(ext).toLower();
       }
@@ -37,7 +38,7 @@ public:
   QString CCmabi() const override { return "lp64"; }
 
   unsigned instrByteAlignment() const override {
-    return extensionEnabled("C") ? 2 : 4;
+    return extensionEnabled('C') ? 2 : 4;
   };
 };
 
@@ -48,7 +48,80 @@ const QStringList RegDescs = QStringList() << "Hard-Wired zero"
                                          << "Temporary register\nSaver: Caller"
                                          << "Temporary register\nSaver: Caller"
                                          << "Temporary register\nSaver: Caller";
+
+const QStringList FPRegAliases = QStringList()
+    << "ft0" << "ft1" << "ft2" << "ft3" << "ft4" << "ft5" << "ft6" << "ft7"
+    << "fs0" << "fs1" << "fa0" << "fa1" << "fa2" << "fa3" << "fa4" << "fa5"
+    << "fa6" << "fa7" << "fs2" << "fs3" << "fs4" << "fs5" << "fs6" << "fs7"
+    << "fs8" << "fs9" << "fs10" << "fs11" << "ft8" << "ft9" << "ft10" << "ft11";
+
+const QStringList FPRegNames = QStringList()
+    << "f0" << "f1" << "f2" << "f3" << "f4" << "f5" << "f6" << "f7"
+    << "f8" << "f9" << "f10" << "f11" << "f12" << "f13" << "f14" << "f15"
+    << "f16" << "f17" << "f18" << "f19" << "f20" << "f21" << "f22" << "f23"
+    << "f24" << "f25" << "f26" << "f27" << "f28" << "f29" << "f30" << "f31";
+
+const QStringList FPRegDescs = QStringList() << "FP temporary\nSaver: Caller"
+                                           << "FP temporary\nSaver: Caller"
+                                           << "FP temporary\nSaver: Caller"
+                                           << "FP temporary\nSaver: Caller"
+                                           << "FP temporary\nSaver: Caller"
+                                           << "FP temporary\nSaver: Caller"
+                                           << "FP temporary\nSaver: Caller"
+                                           << "FP temporary\nSaver: Caller"
+                                           << "FP saved register\nSaver: Callee"
+                                           << "FP saved register\nSaver: Callee"
+                                           << "FP argument/return value\nSaver: Caller"
+                                           << "FP argument/return value\nSaver: Caller"
+                                           << "FP argument\nSaver: Caller"
+                                           << "FP argument\nSaver: Caller"
+                                           << "FP argument\nSaver: Caller"
+                                           << "FP argument\nSaver: Caller"
+                                           << "FP argument\nSaver: Caller"
+                                           << "FP argument\nSaver: Caller"
+                                           << "FP saved register\nSaver: Callee"
+                                           << "FP saved register\nSaver: Callee"
+                                           << "FP saved register\nSaver: Callee"
+                                           << "FP saved register\nSaver: Callee"
+                                           << "FP saved register\nSaver: Callee"
+                                           << "FP saved register\nSaver: Callee"
+                                           << "FP saved register\nSaver: Callee"
+                                           << "FP saved register\nSaver: Callee"
+                                           << "FP saved register\nSaver: Callee"
+                                           << "FP saved register\nSaver: Callee"
+                                           << "FP temporary\nSaver: Caller"
+                                           << "FP temporary\nSaver: Caller"
+                                           << "FP temporary\nSaver: Caller"
+                                           << "FP temporary\nSaver: Caller";
 // clang-format on
+
+static const std::map<QString, unsigned> &csrNumbers() {
+  static const std::map<QString, unsigned> numbers = {
+      {"fflags", FFLAGS},    {"frm", FRM},          {"fcsr", FCSR},
+      {"vstart", VSTART},    {"vl", VL},            {"vtype", VTYPE},
+      {"vlenb", VLENB},
+      {"cycle", 0xc00},      {"time", 0xc01},       {"instret", 0xc02},
+      {"cycleh", 0xc80},     {"timeh", 0xc81},      {"instreth", 0xc82},
+      {"mstatus", MSTATUS},  {"misa", MISA},        {"mie", MIE},
+      {"mtvec", MTVEC},      {"mscratch", MSCRATCH}, {"mepc", MEPC},
+      {"mcause", MCAUSE},    {"mtval", MTVAL},      {"mip", MIP},
+      {"mhartid", MHARTID}};
+  return numbers;
+}
+
+unsigned csrNumber(const QString &name, bool &ok) {
+  const auto it = csrNumbers().find(name);
+  ok = it != csrNumbers().end();
+  return ok ? it->second : 0;
+}
+
+QString csrName(unsigned csr) {
+  for (const auto &it : csrNumbers())
+    if (it.second == csr)
+      return it.first;
+  return QString();
+}
+
 } // namespace RVISA
 
 namespace RVABI {
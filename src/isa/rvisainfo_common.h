@@ -20,6 +20,9 @@ namespace RVISA {
 extern const QStringList RegAliases;
 extern const QStringList RegNames;
 extern const QStringList RegDescs;
+extern const QStringList FPRegAliases;
+extern const QStringList FPRegNames;
+extern const QStringList FPRegDescs;
 enum Opcode {
   LUI = 0b0110111,
   JAL = 0b1101111,
@@ -33,9 +36,52 @@ enum Opcode {
   OP32 = 0b0111011,
   ECALL = 0b1110011,
   AUIPC = 0b0010111,
+  AMO = 0b0101111,
+  LOAD_FP = 0b0000111,
+  STORE_FP = 0b0100111,
+  MADD = 0b1000011,
+  MSUB = 0b1000111,
+  NMSUB = 0b1001011,
+  NMADD = 0b1001111,
+  OP_FP = 0b1010011,
+  OP_V = 0b1010111,
   INVALID = 0b0
 };
 
+/// Floating-point, vector and machine-mode CSRs, and the bits of mstatus, mie,
+/// mip and mcause which are implemented.
+enum CSR {
+  FFLAGS = 0x001,
+  FRM = 0x002,
+  FCSR = 0x003,
+  VSTART = 0x008,
+  VL = 0xC20,
+  VTYPE = 0xC21,
+  VLENB = 0xC22,
+  MSTATUS = 0x300,
+  MISA = 0x301,
+  MIE = 0x304,
+  MTVEC = 0x305,
+  MSCRATCH = 0x340,
+  MEPC = 0x341,
+  MCAUSE = 0x342,
+  MTVAL = 0x343,
+  MIP = 0x344,
+  MHARTID = 0xF14
+};
+enum MStatus : unsigned { MSTATUS_MIE = 1 << 3, MSTATUS_MPIE = 1 << 7 };
+// Machine timer interrupt enable and pending bits of mie and mip.
+constexpr unsigned MTI = 1 << 7;
+// Exception code of a machine timer interrupt in mcause, excluding the
+// interrupt bit.
+constexpr unsigned MTIMER_CAUSE = 7;
+
+/// Returns the number of the CSR named @p name (ie. "mtvec"), and sets @p ok
+/// to whether the name is known.
+unsigned csrNumber(const QString &name, bool &ok);
+/// Returns the name of the CSR numbered @p csr, or an empty string if unknown.
+QString csrName(unsigned csr);
+
 } // namespace RVISA
 
 namespace RVABI {
@@ -57,13 +103,19 @@ enum SysCall {
   PrintIntHex = 34,
   PrintIntBinary = 35,
   PrintIntUnsigned = 36,
+  OpenAt = 56,
   Close = 57,
   LSeek = 62,
   Read = 63,
   Write = 64,
   FStat = 80,
   Exit2 = 93,
+  ExitGroup = 94,
+  ClockGetTime = 113,
+  Times = 153,
+  GetTimeOfDay = 169,
   brk = 214,
+  ClockGetTime64 = 403,
   Open = 1024
 };
 
@@ -87,6 +139,34 @@ public:
                ? RVISA::RegDescs.at(static_cast<int>(i))
                : QString();
   }
+  unsigned fpRegCnt() const override {
+    return extensionEnabled('F') ? 32 : 0;
+  }
+  QString fpRegName(unsigned i) const override {
+    return RVISA::FPRegNames.size() > static_cast<int>(i)
+               ? RVISA::FPRegNames.at(static_cast<int>(i))
+               : QString();
+  }
+  QString fpRegAlias(unsigned i) const override {
+    return RVISA::FPRegAliases.size() > static_cast<int>(i)
+               ? RVISA::FPRegAliases.at(static_cast<int>(i))
+               : QString();
+  }
+  QString fpRegInfo(unsigned i) const override {
+    return RVISA::FPRegDescs.size() > static_cast<int>(i)
+               ? RVISA::FPRegDescs.at(static_cast<int>(i))
+               : QString();
+  }
+  unsigned fpRegNumber(const QString &reg, bool &success) const override {
+    int idx = RVISA::FPRegNames.indexOf(reg);
+    if (idx < 0)
+      idx = RVISA::FPRegAliases.indexOf(reg);
+    success = idx >= 0;
+    return success ? idx : 0;
+  }
+  unsigned fpBits() const override {
+    return extensionEnabled('D') ? 64 : extensionEnabled('F') ? 32 : 0;
+  }
   QString name() const override { return CCmarch().toUpper(); }
   bool regIsReadOnly(unsigned i) const override { return i == 0; }
   int spReg() const override { return 2; }
@@ -136,14 +216,22 @@ public:
   QString extensionDescription(const QString &ext) const override {
     if (ext == "M")
       return "Integer multiplication and division";
+    if (ext == "A")
+      return "Atomic instructions";
+    if (ext == "F")
+      return "Single-precision floating-point";
+    if (ext == "D")
+      return "Double-precision floating-point (requires F)";
     if (ext == "C")
       return "Compressed instructions";
+    if (ext == "V")
+      return "Vector operations (integer subset)";
     Q_UNREACHABLE();
   }
 
 protected:
   QStringList m_enabledExtensions;
-  QStringList m_supportedExtensions = {"M", "C"};
+  QStringList m_supportedExtensions = {"M", "A", "F", "D", "C", "V"};
 };
 
 } // namespace Ripes
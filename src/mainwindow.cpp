@@ -2,15 +2,19 @@
 #include "ui_mainwindow.h"
 
 #include "cachetab.h"
+#include "cli/checkpoint.h"
+#include "cli/simfork.h"
 #include "edittab.h"
 #include "iotab.h"
 #include "loaddialog.h"
 #include "memorytab.h"
+#include "processorcomparisondialog.h"
 #include "processorhandler.h"
 #include "processortab.h"
 #include "registerwidget.h"
 #include "ripessettings.h"
 #include "savedialog.h"
+#include "session.h"
 #include "settingsdialog.h"
 #include "syscall/syscallviewer.h"
 #include "syscall/systemio.h"
@@ -23,6 +27,8 @@
 #include <QFileDialog>
 #include <QFontDatabase>
 #include <QIcon>
+#include <QInputDialog>
+#include <QJsonDocument>
 #include <QLabel>
 #include <QMessageBox>
 #include <QPushButton>
@@ -78,11 +84,14 @@ MainWindow::MainWindow(QWidget *parent)
   m_stackedTabs->insertWidget(CacheTabID, cacheTab);
   m_tabWidgets[CacheTabID] = {cacheTab, cacheToolbar};
 
+  // The memory tab is constructed upon first activation. A placeholder holds
+  // its index in the stacked widget until then.
   auto *memoryToolbar = addToolBar("Memory");
   memoryToolbar->setVisible(false);
-  auto *memoryTab = new MemoryTab(memoryToolbar, this);
-  m_stackedTabs->insertWidget(MemoryTabID, memoryTab);
-  m_tabWidgets[MemoryTabID] = {memoryTab, memoryToolbar};
+  m_stackedTabs->insertWidget(MemoryTabID, new QWidget(this));
+  m_tabWidgets[MemoryTabID] = {nullptr, memoryToolbar, [=] {
+                                 return new MemoryTab(memoryToolbar, this);
+                               }};
 
   auto *IOToolbar = addToolBar("I/O");
   IOToolbar->setVisible(false);
@@ -114,6 +123,17 @@ MainWindow::MainWindow(QWidget *parent)
   connect(ProcessorHandler::get(), &ProcessorHandler::processorReset,
           [=] { SystemIO::reset(); });
 
+  // Console output log
+  auto setConsoleLog = [=] {
+    const QString error = SystemIO::setOutputLog(
+        RipesSettings::value(RIPES_SETTING_CONSOLELOGFILE).toString());
+    if (!error.isEmpty())
+      SystemIOStatusManager::setStatusTimed(error);
+  };
+  connect(RipesSettings::getObserver(RIPES_SETTING_CONSOLELOGFILE),
+          &SettingObserver::modified, this, setConsoleLog);
+  setConsoleLog();
+
   connect(m_ui->actionSystem_calls, &QAction::triggered, this, [=] {
     SyscallViewer v;
     v.exec();
@@ -123,8 +143,9 @@ MainWindow::MainWindow(QWidget *parent)
   connect(m_ui->actionSettings, &QAction::triggered, this,
           &MainWindow::settingsTriggered);
 
-  connect(cacheTab, &CacheTab::focusAddressChanged, memoryTab,
-          &MemoryTab::setCentralAddress);
+  connect(cacheTab, &CacheTab::focusAddressChanged, this, [=](AInt address) {
+    static_cast<MemoryTab *>(getTab(MemoryTabID))->setCentralAddress(address);
+  });
 
   connect(this, &MainWindow::prepareSave, editTab, &EditTab::onSave);
 
@@ -176,10 +197,24 @@ void MainWindow::setupStatusBar() {
   setupStatusWidget(General);
 }
 
+RipesTab *MainWindow::getTab(TabIndex index) {
+  auto &widgets = m_tabWidgets.at(index);
+  if (widgets.tab == nullptr) {
+    widgets.tab = widgets.create();
+    auto *placeholder = m_stackedTabs->widget(index);
+    m_stackedTabs->removeWidget(placeholder);
+    placeholder->deleteLater();
+    m_stackedTabs->insertWidget(index, widgets.tab);
+  }
+  return widgets.tab;
+}
+
 void MainWindow::tabChanged(int index) {
   m_tabWidgets.at(m_currentTabID).toolbar->setVisible(false);
   m_tabWidgets.at(m_currentTabID).tab->tabVisibilityChanged(false);
   m_currentTabID = static_cast<TabIndex>(index);
+  // Tabs are constructed before the stacked widget is switched to them.
+  getTab(m_currentTabID);
   m_tabWidgets.at(m_currentTabID).toolbar->setVisible(true);
   m_tabWidgets.at(m_currentTabID).tab->tabVisibilityChanged(true);
 }
@@ -234,6 +269,41 @@ void MainWindow::setupMenus() {
 
   m_ui->menuFile->addSeparator();
 
+  auto *saveSessionAction =
+      new QAction(QIcon(":/icons/save.svg"), "Save Session...", this);
+  saveSessionAction->setToolTip(
+      "Save the program and simulator configuration to a session file, which "
+      "is reopened without reassembling or recompiling the program");
+  connect(saveSessionAction, &QAction::triggered, this,
+          &MainWindow::saveSessionTriggered);
+  m_ui->menuFile->addAction(saveSessionAction);
+
+  auto *loadSessionAction =
+      new QAction(QIcon(":/icons/loadfile.svg"), "Load Session...", this);
+  connect(loadSessionAction, &QAction::triggered, this,
+          &MainWindow::loadSessionTriggered);
+  m_ui->menuFile->addAction(loadSessionAction);
+
+  auto *forkAction = new QAction("Fork Simulation...", this);
+  forkAction->setToolTip(
+      "Fork the current simulation into simulations which resume from its "
+      "state with different options, ie. another processor model or cache "
+      "configuration, and run in parallel");
+  connect(forkAction, &QAction::triggered, this,
+          &MainWindow::forkSimulationTriggered);
+  m_ui->menuFile->addAction(forkAction);
+
+  auto *compareAction = new QAction("Compare Processors...", this);
+  compareAction->setToolTip(
+      "Simulate the current program on several processor models side by "
+      "side, stepping them in lockstep and comparing their cycles, CPI and "
+      "stalls");
+  connect(compareAction, &QAction::triggered, this,
+          &MainWindow::compareProcessorsTriggered);
+  m_ui->menuFile->addAction(compareAction);
+
+  m_ui->menuFile->addSeparator();
+
   const QIcon exitIcon = QIcon(":/icons/cancel.svg");
   auto *exitAction = new QAction(exitIcon, "Exit", this);
   exitAction->setShortcut(QKeySequence::Quit);
@@ -438,6 +508,196 @@ void MainWindow::saveFilesTriggered() {
                                        1000);
 }
 
+static const QString s_sessionFilter = "Ripes session (*.rses)";
+
+void MainWindow::saveSessionTriggered() {
+  static_cast<ProcessorTab *>(m_tabWidgets.at(ProcessorTabID).tab)->pause();
+  const auto program = ProcessorHandler::getProgram();
+  if (!program) {
+    QMessageBox::information(this, "Save session", "No program is loaded.");
+    return;
+  }
+  const QString path = QFileDialog::getSaveFileName(
+      this, "Save session",
+      RipesSettings::value(RIPES_SETTING_SAVEPATH).toString() + ".rses",
+      s_sessionFilter);
+  if (path.isEmpty())
+    return;
+
+  auto *editTab = static_cast<EditTab *>(m_tabWidgets.at(EditTabID).tab);
+  Session session;
+  session.processor = ProcessorHandler::getID();
+  session.extensions = ProcessorHandler::currentISA()->enabledExtensions();
+  session.sourceType = editTab->getSourceType();
+  if (editTab->isEditorEnabled())
+    session.source = editTab->getAssemblyText();
+  session.program = std::make_shared<Program>(*program);
+  session.caches =
+      static_cast<CacheTab *>(m_tabWidgets.at(CacheTabID).tab)
+          ->l1Configurations();
+  if (ProcessorHandler::getProcessor()->getCycleCount() > 0 &&
+      QMessageBox::question(
+          this, "Save session",
+          "Include the current state of the processor in the session?") ==
+          QMessageBox::Yes) {
+    session.checkpoint = checkpointData();
+  }
+
+  const QString err = saveSession(path, session);
+  if (!err.isEmpty()) {
+    QMessageBox::warning(this, "Save session", err);
+    return;
+  }
+  GeneralStatusManager::setStatusTimed("Saved session " + path, 1000);
+}
+
+void MainWindow::loadSessionTriggered() {
+  static_cast<ProcessorTab *>(m_tabWidgets.at(ProcessorTabID).tab)->pause();
+  const QString path = QFileDialog::getOpenFileName(
+      this, "Load session",
+      QFileInfo(RipesSettings::value(RIPES_SETTING_SAVEPATH).toString())
+          .absolutePath(),
+      s_sessionFilter);
+  if (path.isEmpty())
+    return;
+
+  Session session;
+  QString err = loadSession(path, session);
+  if (!err.isEmpty()) {
+    QMessageBox::warning(this, "Load session", err);
+    return;
+  }
+
+  if (session.processor != ProcessorHandler::getID() ||
+      session.extensions !=
+          ProcessorHandler::currentISA()->enabledExtensions()) {
+    ProcessorHandler::selectProcessor(session.processor, session.extensions);
+  }
+  // The caches are configured before the program is loaded, which resets the
+  // processor, such that a checkpoint is applied last.
+  static_cast<CacheTab *>(m_tabWidgets.at(CacheTabID).tab)
+      ->setL1Configurations(session.caches);
+  if (!static_cast<EditTab *>(m_tabWidgets.at(EditTabID).tab)
+           ->loadSession(session, path))
+    return;
+  if (!session.checkpoint.isEmpty()) {
+    err = applyCheckpointData(session.checkpoint, path);
+    if (!err.isEmpty())
+      QMessageBox::warning(this, "Load session", err);
+  }
+  GeneralStatusManager::setStatusTimed("Loaded session " + path, 1000);
+}
+
+// Returns the CLI options (see --l1i) of the cache configuration @p preset.
+static QString cacheOption(const CachePreset &preset) {
+  static const QStringList replPolicies = {"random", "lru", "plru", "fifo",
+                                           "srrip"};
+  return QString("lines=%1,ways=%2,blocks=%3,wp=%4,wa=%5,repl=%6")
+      .arg(1 << preset.lines)
+      .arg(1 << preset.ways)
+      .arg(1 << preset.blocks)
+      .arg(preset.wrPolicy == WritePolicy::WriteThrough ? "wt" : "wb")
+      .arg(preset.wrAllocPolicy == WriteAllocPolicy::NoWriteAllocate
+               ? "noalloc"
+               : "alloc")
+      .arg(replPolicies.value(preset.replPolicy));
+}
+
+QStringList MainWindow::forkedCacheArguments() {
+  // Forked simulations simulate the L1 caches of the cache tab, unless
+  // overridden.
+  const auto caches = static_cast<CacheTab *>(m_tabWidgets.at(CacheTabID).tab)
+                          ->l1Configurations();
+  QStringList args;
+  if (caches.size() == 2)
+    args << "--l1d" << cacheOption(caches.at(0)) << "--l1i"
+         << cacheOption(caches.at(1));
+  return args;
+}
+
+void MainWindow::forkSimulationTriggered() {
+  static_cast<ProcessorTab *>(m_tabWidgets.at(ProcessorTabID).tab)->pause();
+  if (!ProcessorHandler::getProgram()) {
+    QMessageBox::information(this, "Fork simulation", "No program is loaded.");
+    return;
+  }
+  if (m_simulationFork && m_simulationFork->isRunning()) {
+    QMessageBox::information(this, "Fork simulation",
+                             "The previously forked simulations are still "
+                             "running.");
+    return;
+  }
+
+  bool ok = false;
+  const QString specs = QInputDialog::getMultiLineText(
+      this, "Fork simulation",
+      "Options of each forked simulation, one simulation per line (ie. "
+      "\"--proc RV32_OOO\", \"--l1d lines=64,ways=2\" or \"--reginit "
+      "10=5\"):",
+      QString(), &ok);
+  if (!ok)
+    return;
+  std::vector<ForkVariant> variants;
+  for (const auto &spec : specs.split('\n', Qt::SkipEmptyParts)) {
+    if (spec.trimmed().isEmpty())
+      continue;
+    ForkVariant variant;
+    const QString err = parseForkVariant(spec, variant);
+    if (!err.isEmpty()) {
+      QMessageBox::warning(this, "Fork simulation", err);
+      return;
+    }
+    variants.push_back(variant);
+  }
+
+  QStringList args = {"--cycles", "--cpi", "--cache"};
+  args << forkedCacheArguments();
+
+  m_simulationFork = std::make_unique<SimulationFork>();
+  connect(m_simulationFork.get(), &SimulationFork::finished, this, [this] {
+    QStringList summary;
+    QStringList details;
+    for (const auto &result : m_simulationFork->results()) {
+      QString line = result.value("name").toString() + ": ";
+      if (result.value("status") == "failed") {
+        line += "failed (" + result.value("error").toString() + ")";
+      } else {
+        const QJsonObject report = result.value("report").toObject();
+        line += QString::number(report.value("cycles").toDouble(), 'f', 0) +
+                " cycles, CPI " +
+                QString::number(report.value("CPI").toDouble(), 'f', 3);
+      }
+      summary << line;
+      details << QJsonDocument(result).toJson(QJsonDocument::Indented);
+    }
+    QMessageBox box(QMessageBox::Information, "Forked simulations",
+                    summary.join("\n"), QMessageBox::Ok, this);
+    box.setDetailedText(details.join("\n"));
+    box.exec();
+  });
+  const QString err = m_simulationFork->start(args, variants);
+  if (!err.isEmpty()) {
+    QMessageBox::warning(this, "Fork simulation", err);
+    return;
+  }
+  GeneralStatusManager::setStatusTimed(
+      "Forked " + QString::number(variants.size()) + " simulations", 1000);
+}
+
+void MainWindow::compareProcessorsTriggered() {
+  static_cast<ProcessorTab *>(m_tabWidgets.at(ProcessorTabID).tab)->pause();
+  if (!ProcessorHandler::getProgram()) {
+    QMessageBox::information(this, "Compare processors",
+                             "No program is loaded.");
+    return;
+  }
+  // The dialog is modeless, such that the processor of the main window may be
+  // inspected alongside the comparison.
+  auto *dialog = new ProcessorComparisonDialog(forkedCacheArguments(), this);
+  dialog->setAttribute(Qt::WA_DeleteOnClose);
+  dialog->show();
+}
+
 void MainWindow::saveFilesAsTriggered() {
   SaveDialog diag(
       static_cast<EditTab *>(m_tabWidgets.at(EditTabID).tab)->getSourceType());
@@ -2,6 +2,9 @@
 
 #include <QMainWindow>
 
+#include <functional>
+#include <memory>
+
 #include "assembler/program.h"
 #include "statusmanager.h"
 
@@ -21,11 +24,15 @@ class CacheTab;
 class IOTab;
 class ProcessorHandler;
 class RipesTab;
+class SimulationFork;
 struct LoadFileParams;
 
 struct TabWidgets {
   RipesTab *tab;
   QToolBar *toolbar;
+  // Constructs the tab of tabs which are constructed upon first activation,
+  // in which case tab is nullptr until then.
+  std::function<RipesTab *()> create;
 };
 
 class MainWindow : public QMainWindow {
@@ -58,6 +65,10 @@ private slots:
 
   void saveFilesTriggered();
   void saveFilesAsTriggered();
+  void saveSessionTriggered();
+  void loadSessionTriggered();
+  void forkSimulationTriggered();
+  void compareProcessorsTriggered();
   void newProgramTriggered();
   void settingsTriggered();
   void tabChanged(int index);
@@ -68,6 +79,12 @@ private:
   void setupStatusBar();
   void setupMenus();
   void setupExamplesMenu(QMenu *parent);
+  /// Returns the options by which forked simulations simulate the L1 caches of
+  /// the cache tab.
+  QStringList forkedCacheArguments();
+
+  /// Returns the tab of @p index, constructing it if not yet constructed.
+  RipesTab *getTab(TabIndex index);
 
   Ui::MainWindow *m_ui = nullptr;
   QActionGroup *m_binaryStoreAction;
@@ -77,5 +94,8 @@ private:
   QStackedWidget *m_stackedTabs = nullptr;
   std::map<TabIndex, TabWidgets> m_tabWidgets;
   TabIndex m_currentTabID = ProcessorTabID;
+
+  // The simulations forked from the current simulation, if any.
+  std::unique_ptr<SimulationFork> m_simulationFork;
 };
 } // namespace Ripes
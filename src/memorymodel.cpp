@@ -3,11 +3,23 @@
 #include <QBrush>
 #include <QFont>
 
+#include <algorithm>
+
 #include "fonts.h"
+#include "pageprofiler.h"
 #include "processorhandler.h"
 
 namespace Ripes {
 
+AInt maxAddress();
+bool validAddressChange(AInt currentAddress, AInt newAddress);
+
+namespace {
+// Markers of the row byte states which are not byte values.
+constexpr uint16_t c_byteInvalid = 0x100;
+constexpr uint16_t c_byteUnused = 0x200;
+} // namespace
+
 MemoryModel::MemoryModel(QObject *parent) : QAbstractTableModel(parent) {}
 
 int MemoryModel::columnCount(const QModelIndex &) const {
@@ -17,10 +29,116 @@ int MemoryModel::columnCount(const QModelIndex &) const {
 
 int MemoryModel::rowCount(const QModelIndex &) const { return m_rowsVisible; }
 
+AInt MemoryModel::rowAddress(int row, bool &validAddress) const {
+  const AInt bytes = ProcessorHandler::currentISA()->bytes();
+  const AInt address = static_cast<AInt>(m_centralAddress) +
+                       ((((m_rowsVisible * bytes) / 2) / bytes) * bytes) -
+                       (row * bytes);
+  validAddress = validAddressChange(m_centralAddress, address);
+  return address;
+}
+
+void MemoryModel::readRow(int row, uint16_t *state) const {
+  const unsigned bytes = ProcessorHandler::currentISA()->bytes();
+  bool validAddress;
+  const AInt address = rowAddress(row, validAddress);
+  const auto &memory = ProcessorHandler::getMemory();
+  for (unsigned i = 0; i < bytes; ++i) {
+    if (!validAddress)
+      state[i] = c_byteInvalid;
+    else if (!memory.contains(address + i))
+      state[i] = c_byteUnused;
+    else
+      state[i] = memory.readMemConst(address + i, 1) & 0xFF;
+  }
+}
+
+void MemoryModel::reload() {
+  const unsigned bytes = ProcessorHandler::currentISA()->bytes();
+  m_rowBytes.resize(m_rowsVisible * bytes);
+  for (int row = 0; row < m_rowsVisible; ++row)
+    readRow(row, &m_rowBytes[row * bytes]);
+  if (m_rowsVisible > 0)
+    emit dataChanged(index(0, 0), index(m_rowsVisible - 1, columnCount() - 1));
+}
+
+void MemoryModel::refreshRows(int first, int last) {
+  const unsigned bytes = ProcessorHandler::currentISA()->bytes();
+  if (m_rowBytes.size() != m_rowsVisible * bytes) {
+    // The ISA changed since the last refresh.
+    reload();
+    return;
+  }
+  std::vector<uint16_t> state(bytes);
+  int runStart = -1;
+  for (int row = first; row <= last + 1; ++row) {
+    bool changed = false;
+    if (row <= last) {
+      readRow(row, state.data());
+      auto *cached = &m_rowBytes[row * bytes];
+      changed = !std::equal(state.begin(), state.end(), cached);
+      if (changed)
+        std::copy(state.begin(), state.end(), cached);
+    }
+    if (changed && runStart < 0) {
+      runStart = row;
+    } else if (!changed && runStart >= 0) {
+      emit dataChanged(index(runStart, 0), index(row - 1, columnCount() - 1));
+      runStart = -1;
+    }
+  }
+}
+
+void MemoryModel::setPageProfiler(const PageProfiler *profiler) {
+  m_pageProfiler = profiler;
+  if (m_rowsVisible > 0)
+    emit dataChanged(index(0, Column::Address),
+                     index(m_rowsVisible - 1, Column::Address),
+                     {Qt::BackgroundRole, Qt::ToolTipRole});
+}
+
 void MemoryModel::processorWasClocked() {
-  // Reload model
-  beginResetModel();
-  endResetModel();
+  if (m_rowsVisible == 0)
+    return;
+
+  // Page heat changes with any access, not only with writes.
+  if (m_pageProfiler && !ProcessorHandler::isRunning())
+    emit dataChanged(index(0, Column::Address),
+                     index(m_rowsVisible - 1, Column::Address),
+                     {Qt::BackgroundRole, Qt::ToolTipRole});
+
+  // Only rows within pages written since the last update are refreshed.
+  auto &tracker = ProcessorHandler::getDirtyPages();
+  const auto since = m_generation;
+  m_generation = tracker.snapshot();
+  bool all = false;
+  const auto pages = tracker.dirtyPagesSince(since, all);
+
+  const AInt bytes = ProcessorHandler::currentISA()->bytes();
+  const AInt topAddress = m_centralAddress + (m_rowsVisible / 2) * bytes;
+  const AInt span = (m_rowsVisible - 1) * bytes;
+  if (all || topAddress < m_centralAddress || topAddress < span) {
+    // Either all memory may have changed, or the visible rows wrap around the
+    // address space.
+    refreshRows(0, m_rowsVisible - 1);
+    return;
+  }
+  const AInt bottomAddress = topAddress - span;
+
+  int firstRow = m_rowsVisible;
+  int lastRow = -1;
+  for (const AInt page : pages) {
+    const AInt pageStart = page << DirtyPageTracker::s_pageBits;
+    const AInt pageEnd = pageStart + DirtyPageTracker::s_pageSize;
+    const AInt lo = std::max(pageStart, bottomAddress);
+    const AInt hi = std::min(pageEnd - bytes, topAddress);
+    if (lo > hi)
+      continue;
+    firstRow = std::min(firstRow, static_cast<int>((topAddress - hi) / bytes));
+    lastRow = std::max(lastRow, static_cast<int>((topAddress - lo) / bytes));
+  }
+  if (lastRow >= firstRow)
+    refreshRows(firstRow, lastRow);
 }
 
 AInt maxAddress() {
@@ -30,7 +148,7 @@ AInt maxAddress() {
 void MemoryModel::setCentralAddress(AInt address) {
   address = address - (address % ProcessorHandler::currentISA()->bytes());
   m_centralAddress = address;
-  processorWasClocked();
+  reload();
 }
 
 // Checks whether an overflow or underflow error occurred when calculating the
@@ -56,7 +174,7 @@ void MemoryModel::offsetCentralAddress(int rowOffset) {
   m_centralAddress = validAddressChange(m_centralAddress, newCenterAddress)
                          ? newCenterAddress
                          : m_centralAddress;
-  processorWasClocked();
+  reload();
 }
 
 QVariant MemoryModel::headerData(int section, Qt::Orientation orientation,
@@ -75,8 +193,20 @@ QVariant MemoryModel::headerData(int section, Qt::Orientation orientation,
 }
 
 void MemoryModel::setRowsVisible(int rows) {
-  m_rowsVisible = rows;
-  processorWasClocked();
+  // Rows are inserted or removed at the bottom of the view, rather than
+  // resetting the model, such that the view retains its state.
+  if (rows > m_rowsVisible) {
+    beginInsertRows(QModelIndex(), m_rowsVisible, rows - 1);
+    m_rowsVisible = rows;
+    endInsertRows();
+  } else if (rows < m_rowsVisible) {
+    beginRemoveRows(QModelIndex(), rows, m_rowsVisible - 1);
+    m_rowsVisible = rows;
+    endRemoveRows();
+  }
+  // The central row, and thereby the address of each row, moves with the
+  // number of rows.
+  reload();
 }
 
 QVariant MemoryModel::data(const QModelIndex &index, int role) const {
@@ -91,7 +221,6 @@ QVariant MemoryModel::data(const QModelIndex &index, int role) const {
     return QFont(Fonts::monospace, 11);
   }
 
-  const auto bytes = ProcessorHandler::currentISA()->bytes();
   // Calculate the word-aligned address corresponding to the row of the current
   // index. If the central address is at one of its two extrema, based on the
   // address space of the processor, the aligned address is invalid.
@@ -110,17 +239,16 @@ QVariant MemoryModel::data(const QModelIndex &index, int role) const {
   }
 */
 
-  const AInt alignedAddress =
-      static_cast<AInt>(m_centralAddress) +
-      ((((m_rowsVisible * bytes) / 2) / bytes) * bytes) - (index.row() * bytes);
-  const bool validAddress =
-      validAddressChange(m_centralAddress, alignedAddress);
+  bool validAddress;
+  const AInt alignedAddress = rowAddress(index.row(), validAddress);
 
   const unsigned byteOffset = index.column() - FIXED_COLUMNS_CNT;
 
   if (index.column() == Column::Address) {
     if (role == Qt::DisplayRole) {
       return addrData(alignedAddress, validAddress);
+    } else if (role == Qt::BackgroundRole || role == Qt::ToolTipRole) {
+      return pageHeatData(alignedAddress, validAddress, role);
     } else if (role == Qt::ForegroundRole) {
       // Assign a brush if one of the byte-indexed address covered by the
       // aligned address has been written to
@@ -157,7 +285,7 @@ QVariant MemoryModel::data(const QModelIndex &index, int role) const {
 
 void MemoryModel::setRadix(Radix r) {
   m_radix = r;
-  processorWasClocked();
+  reload();
 }
 
 QVariant MemoryModel::addrData(AInt address, bool validAddress) const {
@@ -178,6 +306,29 @@ QVariant MemoryModel::fgColorData(AInt address, AInt byteOffset,
   }
 }
 
+QVariant MemoryModel::pageHeatData(AInt address, bool validAddress,
+                                   int role) const {
+  // The profile is written by the simulation thread while running.
+  if (!m_pageProfiler || !validAddress || ProcessorHandler::isRunning())
+    return QVariant();
+  const auto *page = m_pageProfiler->find(address);
+  if (!page)
+    return QVariant();
+
+  const unsigned long long accesses = page->reads + page->writes;
+  if (role == Qt::ToolTipRole) {
+    return QString("Page %1: %2 reads, %3 writes")
+        .arg(encodeRadixValue(page->page * m_pageProfiler->pageBytes(),
+                              Radix::Hex,
+                              ProcessorHandler::currentISA()->bytes()))
+        .arg(page->reads)
+        .arg(page->writes);
+  }
+  const double heat = static_cast<double>(accesses) /
+                      std::max(1ull, m_pageProfiler->maxAccesses());
+  return QBrush(QColor(255, 0, 0, 40 + static_cast<int>(heat * 160)));
+}
+
 QVariant MemoryModel::byteData(AInt address, AInt byteOffset,
                                bool validAddress) const {
   if (!validAddress) {
@@ -2,10 +2,16 @@
 
 #include <QAbstractTableModel>
 
+#include <cstdint>
+#include <vector>
+
+#include "dirtypagetracker.h"
 #include "radix.h"
 
 namespace Ripes {
 
+class PageProfiler;
+
 class MemoryModel : public QAbstractTableModel {
   Q_OBJECT
 public:
@@ -24,6 +30,11 @@ public:
 
   void setRadix(Radix r);
   Radix getRadix() const { return m_radix; }
+  AInt getCentralAddress() const { return m_centralAddress; }
+  /// Shades the address of each row by the data accesses of its page, as
+  /// counted by @p profiler, or removes the shading if nullptr. The shading is
+  /// refreshed while the processor is not running.
+  void setPageProfiler(const PageProfiler *profiler);
 
 public slots:
   void processorWasClocked();
@@ -32,15 +43,37 @@ public slots:
   void setCentralAddress(Ripes::AInt address);
 
 private:
+  /// Refreshes all cells of the model, after the addresses or the radix of
+  /// the visible rows changed.
+  void reload();
+  /// Re-reads the memory of rows [@p first, @p last] and emits dataChanged
+  /// for the runs of rows whose contents differ from the last refresh.
+  void refreshRows(int first, int last);
+  /// Returns the aligned address shown in @p row, and whether it is valid.
+  AInt rowAddress(int row, bool &validAddress) const;
+  /// Reads the state of each byte of @p row into @p state.
+  void readRow(int row, uint16_t *state) const;
+
   QVariant addrData(AInt address, bool validAddress) const;
   QVariant byteData(AInt address, AInt byteOffset, bool validAddress) const;
   QVariant wordData(AInt address, bool validAddress) const;
   QVariant fgColorData(AInt address, AInt byteOffset, bool validAddress) const;
+  QVariant pageHeatData(AInt address, bool validAddress, int role) const;
 
   Radix m_radix = Radix::Hex;
 
   AInt m_centralAddress = 0; // Memory address at the center of the model
   int m_rowsVisible = 0;     // Number of rows currently visible in the view
                              // associated with the model
+
+  // The state of each byte of each visible row at the last refresh, as
+  // displayed: the byte value, or one of the c_byte* markers. Rows are
+  // ISA bytes wide.
+  std::vector<uint16_t> m_rowBytes;
+
+  // Generation of the memory dirty page tracker at the last update.
+  DirtyPageTracker::Generation m_generation = 0;
+
+  const PageProfiler *m_pageProfiler = nullptr;
 };
 } // namespace Ripes
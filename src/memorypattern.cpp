@@ -0,0 +1,84 @@
+#include "memorypattern.h"
+
+#include <QStringList>
+
+#include <climits>
+
+namespace Ripes {
+
+bool MemoryPattern::masked() const {
+  for (const char byte : mask) {
+    if (static_cast<uint8_t>(byte) != 0xFF)
+      return true;
+  }
+  return false;
+}
+
+/// Parses @p text as an integer; negative values are two's complement.
+static bool parseInteger(QString text, uint64_t &value) {
+  bool negative = text.startsWith('-');
+  if (negative)
+    text.remove(0, 1);
+  bool ok = false;
+  if (text.startsWith("0b", Qt::CaseInsensitive))
+    value = text.mid(2).toULongLong(&ok, 2);
+  else if (text.startsWith("0x", Qt::CaseInsensitive))
+    value = text.mid(2).toULongLong(&ok, 16);
+  else
+    value = text.toULongLong(&ok, 10);
+  if (negative)
+    value = -value;
+  return ok;
+}
+
+QString MemoryPattern::parse(Kind kind, const QString &text, unsigned width,
+                             MemoryPattern &pattern) {
+  pattern = MemoryPattern();
+  switch (kind) {
+  case Kind::Value: {
+    uint64_t value = 0;
+    if (!parseInteger(text.trimmed(), value))
+      return "Invalid value '" + text.trimmed() + "'";
+    if (width < sizeof(value)) {
+      // The value must be representable as a signed or unsigned value of
+      // the given width.
+      const uint64_t upper = value >> (width * CHAR_BIT - 1);
+      const uint64_t ones = ~uint64_t(0) >> (width * CHAR_BIT - 1);
+      if (upper > 1 && upper != ones)
+        return "Value does not fit in " + QString::number(width) + " bytes";
+    }
+    for (unsigned i = 0; i < width; ++i)
+      pattern.bytes.append(static_cast<char>(value >> (i * CHAR_BIT)));
+    pattern.alignment = width;
+    break;
+  }
+  case Kind::Bytes: {
+    const QStringList tokens = text.simplified().split(' ', Qt::SkipEmptyParts);
+    for (const QString &token : tokens) {
+      if (token == "??") {
+        pattern.bytes.append('\0');
+        pattern.mask.append('\0');
+        continue;
+      }
+      bool ok = false;
+      const unsigned byte = token.toUInt(&ok, 16);
+      if (!ok || token.size() > 2)
+        return "Invalid byte '" + token + "'";
+      pattern.bytes.append(static_cast<char>(byte));
+      pattern.mask.append(static_cast<char>(0xFF));
+    }
+    break;
+  }
+  case Kind::String:
+    pattern.bytes = text.toUtf8();
+    break;
+  }
+
+  if (pattern.bytes.isEmpty())
+    return "Empty pattern";
+  if (pattern.mask.isEmpty())
+    pattern.mask.fill(static_cast<char>(0xFF), pattern.bytes.size());
+  return QString();
+}
+
+} // namespace Ripes
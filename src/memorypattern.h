@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+#include "ripes_types.h"
+
+namespace Ripes {
+
+/**
+ * @brief The MemoryPattern struct
+ * A sequence of bytes to search memory for. Only the bits set in the
+ * corresponding byte of the mask are compared, such that bytes of a pattern
+ * may be wildcards.
+ */
+struct MemoryPattern {
+  enum class Kind { Value, Bytes, String };
+
+  QByteArray bytes;
+  QByteArray mask;
+  // Matches are only reported at multiples of the alignment.
+  unsigned alignment = 1;
+
+  /// Returns true if any bit of the pattern is not compared.
+  bool masked() const;
+
+  /**
+   * @brief parse
+   * Parses @p text as a pattern of @p kind into @p pattern:
+   * - Value: an integer (decimal, or 0x/0b prefixed, possibly negative),
+   *   encoded as a little endian, naturally aligned value of @p width bytes.
+   * - Bytes: whitespace separated hex bytes, where "??" matches any byte.
+   * - String: the characters of @p text, without a terminator.
+   * Returns an error message, or an empty string on success.
+   */
+  static QString parse(Kind kind, const QString &text, unsigned width,
+                       MemoryPattern &pattern);
+};
+
+} // namespace Ripes
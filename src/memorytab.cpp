@@ -1,17 +1,28 @@
 #include "memorytab.h"
 #include "ui_memorytab.h"
 
+#include <QDialog>
 #include <QGraphicsItem>
 #include <QPushButton>
 #include <QToolBar>
+#include <QVBoxLayout>
+#include <QtCharts/QChartView>
+#include <QtCharts/QLineSeries>
+#include <QtCharts/QValueAxis>
 
 #include "cachesim/cachesim.h"
 #include "io/iomanager.h"
 #include "io/memorymapmodel.h"
+#include "pageprofiler.h"
 #include "processorhandler.h"
 
+QT_CHARTS_USE_NAMESPACE
+
 namespace Ripes {
 
+// Interval in cycles at which the working set of the page profile is sampled.
+static constexpr unsigned s_workingSetInterval = 1000;
+
 MemoryTab::MemoryTab(QToolBar *toolbar, QWidget *parent)
     : RipesTab(toolbar, parent), m_ui(new Ui::MemoryTab) {
   m_ui->setupUi(this);
@@ -36,12 +47,80 @@ MemoryTab::MemoryTab(QToolBar *toolbar, QWidget *parent)
   m_ui->splitter->setStretchFactor(0, 2);
   m_ui->splitter->setStretchFactor(1, 1);
 
-  connect(ProcessorHandler::get(), &ProcessorHandler::procStateChangedNonRun,
-          m_ui->memoryViewerWidget,
-          [=] { m_ui->memoryViewerWidget->updateView(); });
+  ProcessorHandler::getRefreshScheduler().addClient(
+      m_ui->memoryViewerWidget,
+      [=] { m_ui->memoryViewerWidget->updateView(); });
+
+  m_pageHeatAction = new QAction(QIcon(":/icons/ram-memory.svg"),
+                                 "Show page heat map", this);
+  m_pageHeatAction->setCheckable(true);
+  connect(m_pageHeatAction, &QAction::toggled, this,
+          &MemoryTab::setPageHeatEnabled);
+  m_toolbar->addAction(m_pageHeatAction);
+
+  m_workingSetAction =
+      new QAction(QIcon(":/icons/graph.svg"), "Show working set", this);
+  m_workingSetAction->setEnabled(false);
+  connect(m_workingSetAction, &QAction::triggered, this,
+          &MemoryTab::showWorkingSet);
+  m_toolbar->addAction(m_workingSetAction);
+}
+
+MemoryTab::~MemoryTab() {
+  m_ui->memoryViewerWidget->setPageProfiler(nullptr);
+  delete m_ui;
 }
 
-MemoryTab::~MemoryTab() { delete m_ui; }
+void MemoryTab::setPageHeatEnabled(bool enabled) {
+  // Observers may only be attached and detached while the processor is not
+  // running.
+  ProcessorHandler::stopRun();
+  if (enabled) {
+    m_pageProfiler = std::make_unique<PageProfiler>(
+        DirtyPageTracker::s_pageBits, s_workingSetInterval);
+  } else {
+    m_pageProfiler.reset();
+  }
+  m_ui->memoryViewerWidget->setPageProfiler(m_pageProfiler.get());
+  m_workingSetAction->setEnabled(enabled);
+}
+
+void MemoryTab::showWorkingSet() {
+  // The profile is written by the simulation thread while running.
+  if (!m_pageProfiler || ProcessorHandler::isRunning())
+    return;
+
+  const AInt pageBytes = m_pageProfiler->pageBytes();
+  auto *chart = new QChart();
+  auto *series = new QLineSeries(chart);
+  series->setName("Pages accessed per " +
+                  QString::number(s_workingSetInterval) + " cycles");
+  for (const auto &sample : m_pageProfiler->samples())
+    series->append(sample.cycle, sample.pages);
+  chart->addSeries(series);
+  chart->createDefaultAxes();
+  auto *axisX = qobject_cast<QValueAxis *>(chart->axes(Qt::Horizontal).first());
+  auto *axisY = qobject_cast<QValueAxis *>(chart->axes(Qt::Vertical).first());
+  axisX->setTitleText("Cycle");
+  axisX->setLabelFormat("%d");
+  axisY->setTitleText("Working set (pages of " + QString::number(pageBytes) +
+                      " bytes)");
+  axisY->setLabelFormat("%d");
+  axisY->setMin(0);
+  chart->setTitle("Footprint: " +
+                  QString::number(m_pageProfiler->footprint()) + " pages (" +
+                  QString::number(m_pageProfiler->footprint() * pageBytes) +
+                  " bytes)");
+
+  QDialog dialog(this);
+  dialog.setWindowTitle("Working set");
+  auto *layout = new QVBoxLayout(&dialog);
+  auto *view = new QChartView(chart, &dialog);
+  view->setRenderHint(QPainter::Antialiasing);
+  view->setMinimumSize(640, 480);
+  layout->addWidget(view);
+  dialog.exec();
+}
 
 void MemoryTab::setCentralAddress(unsigned int address) {
   m_ui->memoryViewerWidget->setCentralAddress(address);
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <QAction>
 #include <QWidget>
 
+#include <memory>
 #include <unordered_map>
 
 #include "memorymodel.h"
@@ -13,6 +15,8 @@ namespace Ui {
 class MemoryTab;
 }
 
+class PageProfiler;
+
 class MemoryTab : public RipesTab {
   friend class CacheTabWidget;
   Q_OBJECT
@@ -24,6 +28,16 @@ public:
   void setCentralAddress(unsigned address);
 
 private:
+  /// Starts or stops profiling the data accesses of each page of memory, and
+  /// shading the memory viewer by them.
+  void setPageHeatEnabled(bool enabled);
+  /// Plots the working set size over time of the page profile.
+  void showWorkingSet();
+
   Ui::MemoryTab *m_ui = nullptr;
+
+  QAction *m_pageHeatAction = nullptr;
+  QAction *m_workingSetAction = nullptr;
+  std::unique_ptr<PageProfiler> m_pageProfiler;
 };
 } // namespace Ripes
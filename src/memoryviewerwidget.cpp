@@ -1,18 +1,58 @@
 #include "memoryviewerwidget.h"
 #include "ui_memoryviewerwidget.h"
 
+#include <QComboBox>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QFormLayout>
 #include <QHBoxLayout>
 #include <QLabel>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QPushButton>
 #include <QTableView>
 
+#include <algorithm>
+
 #include "flowlayout.h"
 #include "gotocombobox.h"
 #include "memorymodel.h"
+#include "memorypattern.h"
 #include "processorhandler.h"
 #include "radixselectorwidget.h"
 
 namespace Ripes {
 
+// Fills materialize the host pages of the filled memory, and are thus bounded.
+static constexpr AInt s_maxFillBytes = AInt(64) << 20;
+
+/// Adds the kinds of patterns which may be searched for or filled with to
+/// @p box. The data of each item is the pattern kind, and the width of
+/// values.
+static void addPatternKinds(QComboBox *box) {
+  using Kind = MemoryPattern::Kind;
+  const auto add = [box](const QString &name, Kind kind, unsigned width) {
+    box->addItem(name, QVariantList{static_cast<int>(kind), width});
+  };
+  add("Byte", Kind::Value, 1);
+  add("Half word", Kind::Value, 2);
+  add("Word", Kind::Value, 4);
+  if (ProcessorHandler::currentISA()->bits() == 64)
+    add("Double word", Kind::Value, 8);
+  add("Hex bytes", Kind::Bytes, 1);
+  add("String", Kind::String, 1);
+  box->setCurrentIndex(2);
+}
+
+/// Parses @p text as a pattern of the kind selected in @p box.
+static QString parsePattern(const QComboBox *box, const QString &text,
+                            MemoryPattern &pattern) {
+  const QVariantList data = box->currentData().toList();
+  return MemoryPattern::parse(
+      static_cast<MemoryPattern::Kind>(data.at(0).toInt()), text,
+      data.at(1).toUInt(), pattern);
+}
+
 MemoryViewerWidget::MemoryViewerWidget(QWidget *parent)
     : QWidget(parent), m_ui(new Ui::MemoryViewerWidget) {
   m_ui->setupUi(this);
@@ -46,6 +86,118 @@ void MemoryViewerWidget::setupNavigationWidgets() {
   layout->addWidget(new QLabel("Go to section: ", m_ui->flowParentLayout));
   layout->addWidget(m_goToSection);
   flowLayout->addItem(layout);
+
+  // Pattern kinds depend on the ISA, and are added as the model is updated.
+  m_findKind = new QComboBox(m_ui->flowParentLayout);
+  m_findText = new QLineEdit(m_ui->flowParentLayout);
+  m_findText->setPlaceholderText("Value or pattern");
+  m_findText->setToolTip(
+      "Values are given in decimal, or prefixed by 0x or 0b. Hex bytes are "
+      "separated by spaces, where ?? matches any byte.");
+  auto *findButton = new QPushButton("Find next", m_ui->flowParentLayout);
+  m_findStatus = new QLabel(m_ui->flowParentLayout);
+  // A changed pattern is searched for from the start of memory.
+  connect(m_findText, &QLineEdit::textChanged, this,
+          [this] { m_lastMatch.reset(); });
+  connect(m_findKind, QOverload<int>::of(&QComboBox::currentIndexChanged), this,
+          [this] { m_lastMatch.reset(); });
+  connect(m_findText, &QLineEdit::returnPressed, this,
+          &MemoryViewerWidget::findNext);
+  connect(findButton, &QPushButton::clicked, this,
+          &MemoryViewerWidget::findNext);
+
+  layout = new QHBoxLayout();
+  layout->addWidget(new QLabel("Find: ", m_ui->flowParentLayout));
+  layout->addWidget(m_findKind);
+  layout->addWidget(m_findText);
+  layout->addWidget(findButton);
+  layout->addWidget(m_findStatus);
+  flowLayout->addItem(layout);
+
+  auto *fillButton = new QPushButton("Fill...", m_ui->flowParentLayout);
+  connect(fillButton, &QPushButton::clicked, this,
+          &MemoryViewerWidget::showFillDialog);
+  flowLayout->addWidget(fillButton);
+}
+
+void MemoryViewerWidget::findNext() {
+  MemoryPattern pattern;
+  const QString error = parsePattern(m_findKind, m_findText->text(), pattern);
+  if (!error.isEmpty()) {
+    m_findStatus->setText(error);
+    return;
+  }
+
+  const AInt end = ProcessorHandler::currentISA()->bits() == 64
+                       ? ~AInt(0)
+                       : AInt(1) << 32;
+  const AInt from = m_lastMatch ? *m_lastMatch + 1 : 0;
+  auto match = ProcessorHandler::findMem(from, end, pattern);
+  if (!match && from != 0) {
+    // Wrap around, up to matches overlapping the start of the search.
+    match = ProcessorHandler::findMem(
+        0, std::min(end, from + pattern.bytes.size() - 1), pattern);
+  }
+  m_lastMatch = match;
+  if (!match) {
+    m_findStatus->setText("Not found");
+    return;
+  }
+  m_findStatus->setText("Found at 0x" + QString::number(*match, 16));
+  setCentralAddress(*match);
+}
+
+void MemoryViewerWidget::showFillDialog() {
+  QDialog dialog(this);
+  dialog.setWindowTitle("Fill memory");
+  auto *form = new QFormLayout(&dialog);
+  auto *start = new QLineEdit(
+      "0x" + QString::number(m_memoryModel->getCentralAddress(), 16), &dialog);
+  auto *size = new QLineEdit(&dialog);
+  size->setPlaceholderText("Bytes, ie. 4096 or 0x1000");
+  auto *kind = new QComboBox(&dialog);
+  addPatternKinds(kind);
+  auto *value = new QLineEdit(&dialog);
+  value->setToolTip(m_findText->toolTip());
+  form->addRow("Start address:", start);
+  form->addRow("Size:", size);
+  form->addRow("Pattern:", kind);
+  form->addRow("Value:", value);
+  auto *buttons = new QDialogButtonBox(
+      QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+  form->addRow(buttons);
+  connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+
+  AInt address = 0;
+  AInt bytes = 0;
+  MemoryPattern pattern;
+  connect(buttons, &QDialogButtonBox::accepted, &dialog, [&] {
+    bool ok = false;
+    QString error;
+    address = start->text().trimmed().toULongLong(&ok, 0);
+    if (!ok)
+      error = "Invalid start address";
+    if (error.isEmpty()) {
+      bytes = size->text().trimmed().toULongLong(&ok, 0);
+      if (!ok || bytes == 0 || bytes > s_maxFillBytes)
+        error = "The size must be between 1 and " +
+                QString::number(s_maxFillBytes) + " bytes";
+    }
+    if (error.isEmpty())
+      error = parsePattern(kind, value->text(), pattern);
+    if (error.isEmpty() && pattern.masked())
+      error = "Patterns with wildcards cannot be filled";
+    if (!error.isEmpty()) {
+      QMessageBox::warning(&dialog, "Fill memory", error);
+      return;
+    }
+    dialog.accept();
+  });
+  if (dialog.exec() != QDialog::Accepted)
+    return;
+
+  ProcessorHandler::fillMem(address, bytes, pattern.bytes);
+  updateView();
 }
 
 void MemoryViewerWidget::setCentralAddress(AInt address) {
@@ -54,11 +206,17 @@ void MemoryViewerWidget::setCentralAddress(AInt address) {
 
 void MemoryViewerWidget::updateView() { m_memoryModel->processorWasClocked(); }
 
+void MemoryViewerWidget::setPageProfiler(const PageProfiler *profiler) {
+  m_pageProfiler = profiler;
+  m_memoryModel->setPageProfiler(profiler);
+}
+
 void MemoryViewerWidget::updateModel() {
   auto *oldModel = m_memoryModel;
 
   auto *newModel = new MemoryModel(this);
   m_memoryModel = newModel;
+  m_memoryModel->setPageProfiler(m_pageProfiler);
   m_ui->memoryView->setModel(m_memoryModel);
   m_radixSelector->setRadix(m_memoryModel->getRadix());
   connect(m_radixSelector, &RadixSelectorWidget::radixChanged, m_memoryModel,
@@ -89,6 +247,9 @@ void MemoryViewerWidget::updateModel() {
   m_ui->memoryView->horizontalHeader()->setSectionResizeMode(
       MemoryModel::Address, QHeaderView::Stretch);
 
+  m_findKind->clear();
+  addPatternKinds(m_findKind);
+
   if (oldModel) {
     delete oldModel;
   }
@@ -2,13 +2,20 @@
 
 #include <QWidget>
 
+#include <optional>
+
 #include "ripes_types.h"
 
+class QComboBox;
+class QLabel;
+class QLineEdit;
+
 namespace Ripes {
 
 class RadixSelectorWidget;
 class GoToComboBox;
 class MemoryModel;
+class PageProfiler;
 
 namespace Ui {
 class MemoryViewerWidget;
@@ -22,6 +29,9 @@ public:
   ~MemoryViewerWidget();
 
   void updateModel();
+  /// Shades the rows of the memory viewer by the accesses of their page (see
+  /// MemoryModel::setPageProfiler).
+  void setPageProfiler(const PageProfiler *profiler);
 
   MemoryModel *m_memoryModel = nullptr;
 
@@ -31,11 +41,24 @@ public slots:
 
 private:
   void setupNavigationWidgets();
+  /// Jumps to the next occurrence in memory of the pattern of the find
+  /// widgets, wrapping around at the end of the address space.
+  void findNext();
+  /// Prompts for a range of memory and a pattern to fill it with.
+  void showFillDialog();
 
   Ui::MemoryViewerWidget *m_ui = nullptr;
 
   RadixSelectorWidget *m_radixSelector = nullptr;
   GoToComboBox *m_goToSection = nullptr;
   GoToComboBox *m_goToRegister = nullptr;
+  const PageProfiler *m_pageProfiler = nullptr;
+
+  QComboBox *m_findKind = nullptr;
+  QLineEdit *m_findText = nullptr;
+  QLabel *m_findStatus = nullptr;
+  // The address of the previous match of the find widgets, from which the
+  // next search continues.
+  std::optional<AInt> m_lastMatch;
 };
 } // namespace Ripes
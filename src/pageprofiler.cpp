@@ -0,0 +1,157 @@
+#include "pageprofiler.h"
+
+#include "processorhandler.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+// The number of slots of a table upon its first insertion. Tables double in
+// size once more than 3/4 of their slots are used.
+static constexpr size_t s_initialSlots = 64;
+
+size_t PageCounterTable::slot(AInt page) const {
+  // Fibonacci hashing; consecutive pages are spread across the table.
+  const uint64_t hash = static_cast<uint64_t>(page) * 0x9e3779b97f4a7c15ull;
+  return static_cast<size_t>(hash >> 32) & (m_slots.size() - 1);
+}
+
+PageCounterTable::Entry &PageCounterTable::get(AInt page) {
+  if ((m_size + 1) * 4 > m_slots.size() * 3)
+    grow();
+  size_t i = slot(page);
+  while (m_slots[i].page != page) {
+    if (m_slots[i].page == s_empty) {
+      m_slots[i].page = page;
+      m_size++;
+      return m_slots[i];
+    }
+    i = (i + 1) & (m_slots.size() - 1);
+  }
+  return m_slots[i];
+}
+
+const PageCounterTable::Entry *PageCounterTable::find(AInt page) const {
+  if (m_slots.empty())
+    return nullptr;
+  size_t i = slot(page);
+  while (m_slots[i].page != s_empty) {
+    if (m_slots[i].page == page)
+      return &m_slots[i];
+    i = (i + 1) & (m_slots.size() - 1);
+  }
+  return nullptr;
+}
+
+std::vector<PageCounterTable::Entry> PageCounterTable::entries() const {
+  std::vector<Entry> entries;
+  entries.reserve(m_size);
+  for (const Entry &entry : m_slots) {
+    if (entry.page != s_empty)
+      entries.push_back(entry);
+  }
+  return entries;
+}
+
+void PageCounterTable::clear() {
+  m_slots.clear();
+  m_size = 0;
+}
+
+void PageCounterTable::grow() {
+  std::vector<Entry> old;
+  old.swap(m_slots);
+  m_slots.resize(old.empty() ? s_initialSlots : old.size() * 2);
+  for (const Entry &entry : old) {
+    if (entry.page == s_empty)
+      continue;
+    size_t i = slot(entry.page);
+    while (m_slots[i].page != s_empty)
+      i = (i + 1) & (m_slots.size() - 1);
+    m_slots[i] = entry;
+  }
+}
+
+PageProfiler::PageProfiler(unsigned pageBits, unsigned interval)
+    : m_pageBits(pageBits), m_interval(interval) {
+  reset();
+  ProcessorHandler::attachObserver(this);
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          [this] { reset(); });
+}
+
+PageProfiler::~PageProfiler() { ProcessorHandler::detachObserver(this); }
+
+void PageProfiler::reset() {
+  m_pages.clear();
+  m_maxAccesses = 0;
+  m_samples.clear();
+  m_window = 0;
+  m_windowPages = 0;
+  m_lastCycle = ProcessorHandler::getProcessor()->getCycleCount();
+  m_windowStart = m_lastCycle;
+}
+
+void PageProfiler::onMemAccess(const RipesProcessor &,
+                               const MemoryAccess &access, bool data) {
+  if (!data)
+    return;
+  const AInt first = access.address >> m_pageBits;
+  const AInt last =
+      (access.address + (access.bytes ? access.bytes - 1 : 0)) >> m_pageBits;
+  for (AInt page = first; page <= last; ++page) {
+    auto &entry = m_pages.get(page);
+    if (access.type == MemoryAccess::Write)
+      entry.writes++;
+    else
+      entry.reads++;
+    m_maxAccesses = std::max(m_maxAccesses, entry.reads + entry.writes);
+    if (entry.window != m_window + 1) {
+      entry.window = m_window + 1;
+      m_windowPages++;
+    }
+  }
+}
+
+void PageProfiler::onCycle(const RipesProcessor &proc) {
+  const long long cycle = proc.getCycleCount();
+  if (cycle < m_lastCycle)
+    reset();
+  m_lastCycle = cycle;
+  if (cycle - m_windowStart >= static_cast<long long>(m_interval))
+    sample(cycle);
+}
+
+void PageProfiler::finish() {
+  if (m_lastCycle > m_windowStart)
+    sample(m_lastCycle);
+}
+
+void PageProfiler::sample(long long cycle) {
+  m_samples.push_back({cycle, m_windowPages});
+  m_window++;
+  m_windowPages = 0;
+  m_windowStart = cycle;
+}
+
+std::vector<PageCounterTable::Entry> PageProfiler::hottest(unsigned n) const {
+  std::vector<PageCounterTable::Entry> entries = m_pages.entries();
+  const auto hotter = [](const PageCounterTable::Entry &lhs,
+                         const PageCounterTable::Entry &rhs) {
+    const auto lhsAccesses = lhs.reads + lhs.writes;
+    const auto rhsAccesses = rhs.reads + rhs.writes;
+    if (lhsAccesses != rhsAccesses)
+      return lhsAccesses > rhsAccesses;
+    return lhs.page < rhs.page;
+  };
+  if (entries.size() > n) {
+    std::partial_sort(entries.begin(), entries.begin() + n, entries.end(),
+                      hotter);
+    entries.resize(n);
+  } else {
+    std::sort(entries.begin(), entries.end(), hotter);
+  }
+  return entries;
+}
+
+} // namespace Ripes
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <QObject>
+
+#include <vector>
+
+#include "processorobserver.h"
+
+namespace Ripes {
+
+/**
+ * @brief The PageCounterTable class
+ * A hash table of the read and write counts of the pages of memory, keyed by
+ * page number. Entries are stored inline in a single array with linear
+ * probing, such that counting an access is a multiplicative hash and, in the
+ * common case, a single probe.
+ */
+class PageCounterTable {
+public:
+  struct Entry {
+    AInt page = s_empty;
+    unsigned long long reads = 0;
+    unsigned long long writes = 0;
+    // The working set window in which the page was last accessed, plus one.
+    unsigned long long window = 0;
+  };
+
+  /// Returns the entry of @p page, inserting it if not present.
+  Entry &get(AInt page);
+  /// Returns the entry of @p page, or nullptr if the page was not accessed.
+  const Entry *find(AInt page) const;
+
+  /// Returns the entries of all accessed pages, in no particular order.
+  std::vector<Entry> entries() const;
+  size_t size() const { return m_size; }
+  void clear();
+
+private:
+  // Page numbers are addresses shifted by the page bits, and are thus never
+  // all ones.
+  static constexpr AInt s_empty = ~AInt(0);
+
+  size_t slot(AInt page) const;
+  void grow();
+
+  std::vector<Entry> m_slots;
+  size_t m_size = 0;
+};
+
+/**
+ * @brief The PageProfiler class
+ * Counts the data reads and writes of each page of memory, and samples the
+ * working set of the program: the number of distinct pages accessed within
+ * each interval of a fixed number of cycles. The footprint is the number of
+ * distinct pages accessed since the processor was last reset. The profile is
+ * cleared when the processor is reset or reversed.
+ */
+class PageProfiler : public QObject, public ProcessorObserver {
+public:
+  struct Sample {
+    // The cycle ending the interval.
+    long long cycle = 0;
+    // The distinct pages accessed within the interval.
+    unsigned long long pages = 0;
+  };
+
+  /// Profiles the current processor until destroyed, with pages of
+  /// 2^@p pageBits bytes, sampling the working set every @p interval cycles.
+  PageProfiler(unsigned pageBits, unsigned interval);
+  ~PageProfiler() override;
+
+  /// Samples the working set of the current, partial, interval.
+  void finish();
+
+  unsigned pageBits() const { return m_pageBits; }
+  AInt pageBytes() const { return AInt(1) << m_pageBits; }
+  unsigned interval() const { return m_interval; }
+
+  /// The distinct pages accessed since the processor was reset.
+  unsigned long long footprint() const { return m_pages.size(); }
+  const std::vector<Sample> &samples() const { return m_samples; }
+  /// Returns the @p n pages with the most accesses, in descending order.
+  std::vector<PageCounterTable::Entry> hottest(unsigned n) const;
+  /// Returns the counters of the page containing @p address, or nullptr if it
+  /// was not accessed.
+  const PageCounterTable::Entry *find(AInt address) const {
+    return m_pages.find(address >> m_pageBits);
+  }
+  /// The accesses of the most accessed page.
+  unsigned long long maxAccesses() const { return m_maxAccesses; }
+
+  unsigned events() const override { return MemAccess | Cycle; }
+  void onMemAccess(const RipesProcessor &proc, const MemoryAccess &access,
+                   bool data) override;
+  void onCycle(const RipesProcessor &proc) override;
+
+private:
+  void reset();
+  void sample(long long cycle);
+
+  unsigned m_pageBits;
+  unsigned m_interval;
+
+  PageCounterTable m_pages;
+  unsigned long long m_maxAccesses = 0;
+  std::vector<Sample> m_samples;
+  unsigned long long m_window = 0;
+  unsigned long long m_windowPages = 0;
+  long long m_windowStart = 0;
+  long long m_lastCycle = 0;
+};
+
+} // namespace Ripes
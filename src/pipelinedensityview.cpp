@@ -0,0 +1,109 @@
+#include "pipelinedensityview.h"
+
+#include <QMouseEvent>
+#include <QPainter>
+
+#include <algorithm>
+
+#include "colors.h"
+#include "pipelinediagrammodel.h"
+
+namespace Ripes {
+
+PipelineDensityView::PipelineDensityView(PipelineDiagramModel *model,
+                                         QWidget *parent)
+    : QWidget(parent), m_model(model) {
+  setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+  setCursor(Qt::PointingHandCursor);
+  setToolTip("Overview of all recorded cycles. Click or drag to scrub.");
+}
+
+QSize PipelineDensityView::sizeHint() const { return QSize(400, 48); }
+
+void PipelineDensityView::setWindow(long long first, long long count) {
+  m_windowStart = first;
+  m_windowCount = count;
+  update();
+}
+
+void PipelineDensityView::invalidate() {
+  m_image = QImage();
+  update();
+}
+
+void PipelineDensityView::render() {
+  m_cycles = m_model->cycles();
+  const int columns = std::max(1, width());
+  const int rows = std::max(1, height());
+  m_image = QImage(columns, rows, QImage::Format_RGB32);
+  const std::vector<unsigned> bins =
+      m_model->density(0, m_cycles, columns, rows);
+  const unsigned maxBin =
+      bins.empty() ? 0 : *std::max_element(bins.begin(), bins.end());
+
+  const QColor base = palette().color(QPalette::Base);
+  const QColor fill = Colors::FoundersRock;
+  for (int y = 0; y < rows; ++y) {
+    auto *line = reinterpret_cast<QRgb *>(m_image.scanLine(y));
+    for (int x = 0; x < columns; ++x) {
+      const unsigned bin = bins.empty() ? 0 : bins[y * columns + x];
+      if (bin == 0) {
+        line[x] = base.rgb();
+        continue;
+      }
+      // Any occupancy is visible; denser bins are shaded darker.
+      const double t = 0.25 + 0.75 * bin / maxBin;
+      auto mix = [t](int from, int to) {
+        return static_cast<int>(from + (to - from) * t);
+      };
+      line[x] = qRgb(mix(base.red(), fill.red()),
+                     mix(base.green(), fill.green()),
+                     mix(base.blue(), fill.blue()));
+    }
+  }
+}
+
+long long PipelineDensityView::cycleAt(int x) const {
+  if (m_cycles == 0 || width() == 0)
+    return 0;
+  x = std::clamp(x, 0, width() - 1);
+  return static_cast<long long>(x) * m_cycles / width();
+}
+
+int PipelineDensityView::xOf(long long cycle) const {
+  if (m_cycles == 0)
+    return 0;
+  return static_cast<int>(cycle * width() / m_cycles);
+}
+
+void PipelineDensityView::paintEvent(QPaintEvent *) {
+  if (m_image.isNull() || m_image.size() != size())
+    render();
+  QPainter painter(this);
+  painter.drawImage(0, 0, m_image);
+
+  if (m_cycles == 0)
+    return;
+  const int x0 = xOf(m_windowStart);
+  const int x1 = std::max(x0 + 1, xOf(m_windowStart + m_windowCount));
+  painter.setPen(QPen(Colors::Medalist, 2));
+  painter.setBrush(Qt::NoBrush);
+  painter.drawRect(QRect(x0, 1, x1 - x0, height() - 2));
+}
+
+void PipelineDensityView::resizeEvent(QResizeEvent *event) {
+  invalidate();
+  QWidget::resizeEvent(event);
+}
+
+void PipelineDensityView::mousePressEvent(QMouseEvent *event) {
+  if (event->button() == Qt::LeftButton)
+    emit cycleRequested(cycleAt(event->pos().x()));
+}
+
+void PipelineDensityView::mouseMoveEvent(QMouseEvent *event) {
+  if (event->buttons() & Qt::LeftButton)
+    emit cycleRequested(cycleAt(event->pos().x()));
+}
+
+} // namespace Ripes
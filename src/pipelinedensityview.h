@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QImage>
+#include <QWidget>
+
+namespace Ripes {
+class PipelineDiagramModel;
+
+/**
+ * @brief The PipelineDensityView class
+ * A zoomed-out overview of all cycles recorded by a PipelineDiagramModel. The
+ * overview is rendered as a density image, of which each pixel shades the
+ * number of stage occupancies within the cycles and instructions it spans. The
+ * cycle window displayed by the diagram is outlined, and clicking or dragging
+ * within the overview requests the diagram to display the cycle under the
+ * cursor.
+ */
+class PipelineDensityView : public QWidget {
+  Q_OBJECT
+public:
+  PipelineDensityView(PipelineDiagramModel *model, QWidget *parent = nullptr);
+
+  /// Outlines the cycles [first, first + count) as the displayed window.
+  void setWindow(long long first, long long count);
+  /// Re-renders the density image from the recorded cycles of the model.
+  void invalidate();
+
+  QSize sizeHint() const override;
+
+signals:
+  void cycleRequested(long long cycle);
+
+protected:
+  void paintEvent(QPaintEvent *event) override;
+  void resizeEvent(QResizeEvent *event) override;
+  void mousePressEvent(QMouseEvent *event) override;
+  void mouseMoveEvent(QMouseEvent *event) override;
+
+private:
+  void render();
+  long long cycleAt(int x) const;
+  int xOf(long long cycle) const;
+
+  PipelineDiagramModel *m_model = nullptr;
+  QImage m_image;
+  long long m_cycles = 0;
+  long long m_windowStart = 0;
+  long long m_windowCount = 0;
+};
+
+} // namespace Ripes
@@ -3,6 +3,8 @@
 #include "processorhandler.h"
 #include "ripessettings.h"
 
+#include <algorithm>
+#include <climits>
 #include <vector>
 
 namespace Ripes {
@@ -21,6 +23,7 @@ PipelineDiagramModel::PipelineDiagramModel(QObject *parent)
           &PipelineDiagramModel::processorWasClocked, Qt::DirectConnection);
   connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
           &PipelineDiagramModel::reset);
+  clearStageInfo();
 }
 
 QVariant PipelineDiagramModel::headerData(int section,
@@ -30,9 +33,13 @@ QVariant PipelineDiagramModel::headerData(int section,
     return QVariant();
   if (orientation == Qt::Horizontal) {
     // Cycle number
-    return QString::number(section);
+    return QString::number(windowCycle(section));
   } else {
+    // Disassembled instructions are cached by the program.
     const auto addr = indexToAddress(section);
+    if (auto program = ProcessorHandler::getProgram())
+      if (auto instr = program->getDisassembled().getFromAddr(addr))
+        return *instr;
     return ProcessorHandler::disassembleInstr(addr);
   }
 }
@@ -43,44 +50,82 @@ int PipelineDiagramModel::rowCount(const QModelIndex &) const {
 }
 
 int PipelineDiagramModel::columnCount(const QModelIndex &) const {
-  return m_cycleStageInfos.size();
+  long long columns = std::max(0LL, m_cycles - m_windowStart);
+  if (m_windowCount >= 0)
+    columns = std::min(columns, m_windowCount);
+  return static_cast<int>(std::min<long long>(columns, INT_MAX));
 }
 
-void PipelineDiagramModel::processorWasClocked() {
-  if (m_atMaxCycles) {
+void PipelineDiagramModel::setCycleWindow(long long first, long long count) {
+  first = std::max(0LL, first);
+  if (first == m_windowStart && count == m_windowCount)
     return;
+  const int prevColumns = columnCount();
+  m_windowStart = first;
+  m_windowCount = count;
+  const int columns = columnCount();
+  // Scrolling the window changes the contents of all columns, but not their
+  // number; only the columns entering or leaving the model are announced.
+  if (columns > prevColumns) {
+    beginInsertColumns(QModelIndex(), prevColumns, columns - 1);
+    endInsertColumns();
+  } else if (columns < prevColumns) {
+    beginRemoveColumns(QModelIndex(), columns, prevColumns - 1);
+    endRemoveColumns();
   }
-  gatherStageInfo();
-
-  const auto cycleCount = ProcessorHandler::getProcessor()->getCycleCount();
-  if (cycleCount >=
-      RipesSettings::value(RIPES_SETTING_PIPEDIAGRAM_MAXCYCLES).toInt()) {
-    m_atMaxCycles = true;
+  if (columns > 0) {
+    emit dataChanged(index(0, 0), index(rowCount() - 1, columns - 1));
+    emit headerDataChanged(Qt::Horizontal, 0, columns - 1);
   }
 }
 
+void PipelineDiagramModel::processorWasClocked() { gatherStageInfo(); }
+
 void PipelineDiagramModel::reset() {
-  m_atMaxCycles = false;
-  m_cycleStageInfos.clear();
+  clearStageInfo();
   gatherStageInfo();
 }
 
+void PipelineDiagramModel::clearStageInfo() {
+  m_stages = ProcessorHandler::getProcessor()->structure().stageIt();
+  m_stageInfos.resize(m_stages.size());
+  m_rows.clear();
+  m_rows.shrink_to_fit();
+  const long long maxCycles =
+      RipesSettings::cached<SettingId::PipelineDiagramMaxCycles>();
+  m_rows.reserve(std::min(maxCycles + 1, s_preallocatedCycles) *
+                 m_stages.size());
+  m_cycles = 0;
+}
+
 void PipelineDiagramModel::prepareForView() {
   beginResetModel();
   endResetModel();
 }
 
 void PipelineDiagramModel::gatherStageInfo() {
-  long long cycleCount = ProcessorHandler::getProcessor()->getCycleCount();
-  auto stageInfoForCycle = m_cycleStageInfos.find(cycleCount);
-  if (stageInfoForCycle != m_cycleStageInfos.end()) {
-    // Already gathered stage info for this cycle.
+  const long long cycleCount =
+      ProcessorHandler::getProcessor()->getCycleCount();
+  const long long maxCycles =
+      RipesSettings::cached<SettingId::PipelineDiagramMaxCycles>();
+  if (cycleCount < m_cycles || cycleCount > maxCycles) {
+    // Already gathered stage info for this cycle, or out of storage.
     return;
   }
-  m_cycleStageInfos[cycleCount];
-  for (auto idx : ProcessorHandler::getProcessor()->structure().stageIt())
-    m_cycleStageInfos[cycleCount][idx] =
-        ProcessorHandler::getProcessor()->stageInfo(idx);
+
+  // Any cycles which were not observed are recorded as invalid stages.
+  const size_t stages = m_stages.size();
+  m_rows.resize((cycleCount + 1) * stages);
+  StageRow *rows = &m_rows[cycleCount * stages];
+  ProcessorHandler::getProcessor()->stageInfos(m_stageInfos.data());
+  for (size_t i = 0; i < stages; ++i) {
+    const StageInfo &info = m_stageInfos[i];
+    rows[i].pc = info.pc;
+    rows[i].namedState = info.namedState;
+    rows[i].state = info.state;
+    rows[i].valid = info.stage_valid;
+  }
+  m_cycles = cycleCount + 1;
 }
 
 QVariant PipelineDiagramModel::data(const QModelIndex &index, int role) const {
@@ -94,52 +139,88 @@ QVariant PipelineDiagramModel::data(const QModelIndex &index, int role) const {
   if (role != Qt::DisplayRole)
     return QVariant();
 
-  if (!m_cycleStageInfos.count(index.column()))
+  const QString stages = stagesString(index.row(), windowCycle(index.column()));
+  if (stages.isEmpty())
     return QVariant();
+  return stages;
+}
 
-  const AInt addr = indexToAddress(index.row());
-  const auto &stageInfo = m_cycleStageInfos.at(index.column());
+QString PipelineDiagramModel::stagesString(int instrRow,
+                                           long long cycle) const {
+  if (!hasCycle(cycle))
+    return QString();
+
+  const AInt addr = indexToAddress(instrRow);
 
   QStringList stagesForAddr;
   QString stageStr;
-  for (const auto &si : stageInfo) {
-    if (si.second.pc == addr && si.second.stage_valid &&
-        si.second.state == StageInfo::State::None) {
-      if (m_cycleStageInfos.count(index.column() - 1)) {
-        const auto &prevCycleStageInfo =
-            m_cycleStageInfos.at(index.column() - 1);
-        if (prevCycleStageInfo.at(si.first).stage_valid &&
-            prevCycleStageInfo.at(si.first).pc == si.second.pc) {
+  for (unsigned i = 0; i < m_stages.size(); ++i) {
+    const StageRow &row = stageRow(cycle, i);
+    if (row.pc == addr && row.valid && row.state == StageInfo::State::None) {
+      const QString &namedState = NamedStates::name(row.namedState);
+      if (hasCycle(cycle - 1)) {
+        const StageRow &prevRow = stageRow(cycle - 1, i);
+        if (prevRow.valid && prevRow.pc == row.pc) {
           stageStr = "-";
-          if (!si.second.namedState.isEmpty()) {
-            stageStr += " (" + si.second.namedState + ")";
+          if (!namedState.isEmpty()) {
+            stageStr += " (" + namedState + ")";
           }
           stagesForAddr << stageStr;
           continue;
         }
       }
-      stageStr = ProcessorHandler::getProcessor()->stageName(si.first);
-      if (!si.second.namedState.isEmpty()) {
-        stageStr += " (" + si.second.namedState + ")";
+      stageStr = ProcessorHandler::getProcessor()->stageName(m_stages[i]);
+      if (!namedState.isEmpty()) {
+        stageStr += " (" + namedState + ")";
       }
       stagesForAddr << stageStr;
     }
   }
 
-  if (stagesForAddr.size() == 0) {
-    return QVariant();
-  }
-
   return stagesForAddr.join('/');
 }
 
+std::vector<unsigned> PipelineDiagramModel::density(long long firstCycle,
+                                                    long long lastCycle,
+                                                    int columns,
+                                                    int rows) const {
+  std::vector<unsigned> bins(std::max(0, columns) * std::max(0, rows), 0);
+  firstCycle = std::max(0LL, firstCycle);
+  lastCycle = std::min(lastCycle, m_cycles);
+  const int nInstrs = rowCount();
+  auto spt = ProcessorHandler::getProgram();
+  if (bins.empty() || firstCycle >= lastCycle || nInstrs == 0 || !spt)
+    return bins;
+
+  const AInt textStart = spt->getSection(TEXT_SECTION_NAME)->address;
+  const unsigned instrBytes = ProcessorHandler::currentISA()->instrBytes();
+  const long long nCycles = lastCycle - firstCycle;
+  const size_t stages = m_stages.size();
+  for (long long cycle = firstCycle; cycle < lastCycle; ++cycle) {
+    const unsigned column = (cycle - firstCycle) * columns / nCycles;
+    const StageRow *cycleRows = &m_rows[cycle * stages];
+    for (size_t i = 0; i < stages; ++i) {
+      const StageRow &row = cycleRows[i];
+      if (!row.valid || row.state != StageInfo::State::None ||
+          row.pc < textStart)
+        continue;
+      const AInt instr = (row.pc - textStart) / instrBytes;
+      if (instr >= static_cast<AInt>(nInstrs))
+        continue;
+      const unsigned bin = instr * rows / nInstrs;
+      bins[bin * columns + column]++;
+    }
+  }
+  return bins;
+}
+
 QString PipelineDiagramModel::toString() const {
   QString textualRepr;
 
-  // Copy headers
+  // Copy headers. All recorded cycles are copied, regardless of the window.
   textualRepr.append('\t');
-  for (int j = 0; j < columnCount(); j++) {
-    textualRepr.append(headerData(j, Qt::Horizontal).toString());
+  for (long long cycle = 0; cycle < m_cycles; cycle++) {
+    textualRepr.append(QString::number(cycle));
     textualRepr.append('\t');
   }
   textualRepr.append('\n');
@@ -147,8 +228,8 @@ QString PipelineDiagramModel::toString() const {
   for (int i = 0; i < rowCount(); ++i) {
     textualRepr.append(headerData(i, Qt::Vertical).toString());
     textualRepr.append('\t');
-    for (int j = 0; j < columnCount(); j++) {
-      textualRepr.append(data(index(i, j)).toString());
+    for (long long cycle = 0; cycle < m_cycles; cycle++) {
+      textualRepr.append(stagesString(i, cycle));
       textualRepr.append('\t');
     }
     textualRepr.append('\n');
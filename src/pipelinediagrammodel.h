@@ -3,6 +3,8 @@
 #include "processors/interface/ripesprocessor.h"
 #include <QAbstractTableModel>
 
+#include <vector>
+
 namespace Ripes {
 
 class PipelineDiagramModel : public QAbstractTableModel {
@@ -20,7 +22,23 @@ public:
                       int role = Qt::DisplayRole) const override;
   void prepareForView();
 
-  /// Returns a tab-separated stringified version of this pipeline diagram.
+  /// Restricts the columns of the model to the @p count cycles starting at
+  /// cycle @p first; column i then displays cycle first + i. Views thereby only
+  /// query the cycles which they display, no matter how many cycles were
+  /// recorded. A negative @p count spans all cycles from @p first.
+  void setCycleWindow(long long first, long long count);
+  long long windowStart() const { return m_windowStart; }
+  long long cycles() const { return m_cycles; }
+
+  /// Bins the executing stages of cycles [firstCycle, lastCycle) into a grid of
+  /// @p columns over the cycles times @p rows over the instructions of the
+  /// program. Each bin counts the stage occupancies which fall into it. Bins
+  /// are returned row-major.
+  std::vector<unsigned> density(long long firstCycle, long long lastCycle,
+                                int columns, int rows) const;
+
+  /// Returns a tab-separated stringified version of this pipeline diagram,
+  /// including all recorded cycles.
   QString toString() const;
 
 public slots:
@@ -28,21 +46,49 @@ public slots:
   void reset();
 
 private:
+  /// The recorded state of a single stage in a single cycle.
+  struct StageRow {
+    AInt pc = 0;
+    NamedStates::ID namedState = NamedStates::None;
+    StageInfo::State state = StageInfo::State::None;
+    bool valid = false;
+  };
+
+  /// Returns the stages executing the instruction at @p instrRow in @p cycle.
+  QString stagesString(int instrRow, long long cycle) const;
+  long long windowCycle(int column) const { return m_windowStart + column; }
+
   void gatherStageInfo();
+  /// Discards all recorded cycles, and preallocates storage for the stages of
+  /// the current processor.
+  void clearStageInfo();
 
-  /**
-   * @brief m_cycleStageInfos
-   * map<cycle, map<stageId, stageInfo>>
-   */
-  std::map<long long, std::map<StageIndex, StageInfo>> m_cycleStageInfos;
+  bool hasCycle(long long cycle) const {
+    return cycle >= 0 && cycle < m_cycles;
+  }
+  const StageRow &stageRow(long long cycle, unsigned stage) const {
+    return m_rows[cycle * m_stages.size() + stage];
+  }
+
+  /// The stages of the processor, in the order of the rows of each cycle.
+  std::vector<StageIndex> m_stages;
+  /// Scratch buffer for the stage infos of the cycle being recorded.
+  std::vector<StageInfo> m_stageInfos;
 
   /**
-   * @brief m_atMaxCycles
-   * Records the state that we've crossed the threshold set for
-   * RIPES_SETTING_PIPEDIAGRAM_MAXCYCLES. This is to speed up execution by not
-   * having to check the settings value during each cycle of simulation, after
-   * the value has been reached.
+   * @brief m_rows
+   * Columnar storage of the stage states of all recorded cycles; the row of
+   * stage i in cycle c is found at index c * m_stages.size() + i. Storage is
+   * preallocated for up to s_preallocatedCycles cycles upon reset, such that
+   * recording a cycle usually does not allocate; beyond that, storage grows
+   * geometrically up to RIPES_SETTING_PIPEDIAGRAM_MAXCYCLES cycles.
    */
-  bool m_atMaxCycles = false;
+  std::vector<StageRow> m_rows;
+  long long m_cycles = 0;
+  static constexpr long long s_preallocatedCycles = 1 << 16;
+
+  // The window of cycles displayed by the columns of the model.
+  long long m_windowStart = 0;
+  long long m_windowCount = -1;
 };
 } // namespace Ripes
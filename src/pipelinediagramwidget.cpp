@@ -3,7 +3,14 @@
 
 #include <QClipboard>
 #include <QHeaderView>
+#include <QLabel>
+#include <QScrollBar>
+#include <QWheelEvent>
 
+#include <algorithm>
+#include <climits>
+
+#include "pipelinedensityview.h"
 #include "pipelinediagrammodel.h"
 #include "ripessettings.h"
 
@@ -15,39 +22,102 @@ PipelineDiagramWidget::PipelineDiagramWidget(PipelineDiagramModel *model,
   m_ui->setupUi(this);
 
   m_stageModel = model;
-  m_ui->pipelineDiagramView->setModel(m_stageModel);
-
-  m_ui->pipelineDiagramView->resizeColumnsToContents();
   m_ui->copy->setIcon(QIcon(":/icons/documents.svg"));
 
+  // Cycles are scrolled through the window of the model, rather than by the
+  // table, so the table never holds more columns than fit in its viewport.
+  auto *view = m_ui->pipelineDiagramView;
+  view->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+  view->viewport()->installEventFilter(this);
+
+  m_overview = new PipelineDensityView(m_stageModel, this);
+  m_scrubber = new QScrollBar(Qt::Horizontal, this);
+  m_scrubber->setToolTip("Cycle scrubber");
+  m_windowLabel = new QLabel(this);
+  m_ui->verticalLayout->insertWidget(1, m_overview);
+  m_ui->verticalLayout->addWidget(m_scrubber);
+  m_ui->horizontalLayout->insertWidget(1, m_windowLabel);
+
+  connect(m_scrubber, &QScrollBar::valueChanged, this,
+          &PipelineDiagramWidget::updateWindow);
+  connect(m_overview, &PipelineDensityView::cycleRequested, this,
+          [this](long long cycle) {
+            // Center the window on the requested cycle.
+            m_scrubber->setValue(cycle - m_scrubber->pageStep() / 2);
+          });
+
   m_stageModel->prepareForView();
+  view->setModel(m_stageModel);
+
+  // All columns are sized alike, such that the number of cycles fitting in
+  // the viewport is known without querying them. The width is sampled from
+  // contents of an initial window of cycles.
+  m_stageModel->setCycleWindow(0, 64);
+  view->resizeColumnsToContents();
+  for (int i = 0; i < m_stageModel->columnCount(); ++i)
+    m_columnWidth = std::max(m_columnWidth, view->columnWidth(i));
+  m_columnWidth = std::max(m_columnWidth, view->fontMetrics().height() * 2);
+  view->horizontalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+  view->horizontalHeader()->setDefaultSectionSize(m_columnWidth);
+  for (int i = 0; i < m_stageModel->columnCount(); ++i)
+    view->setColumnWidth(i, m_columnWidth);
+
+  updateWindow();
 }
 
-PipelineDiagramWidget::~PipelineDiagramWidget() { delete m_ui; }
+PipelineDiagramWidget::~PipelineDiagramWidget() {
+  // Restore the model to span all cycles for any other users of it.
+  m_stageModel->setCycleWindow(0, -1);
+  delete m_ui;
+}
 
-void PipelineDiagramWidget::on_copy_clicked() {
-  // Copy entire table to clipboard, including headers
-  Q_ASSERT(m_stageModel != nullptr);
-  QString textualRepr;
+void PipelineDiagramWidget::updateWindow() {
+  const long long cycles = m_stageModel->cycles();
+  const int viewWidth = m_ui->pipelineDiagramView->viewport()->width();
+  const int windowCycles =
+      std::max(1, viewWidth / std::max(1, m_columnWidth) + 1);
 
-  // Copy headers
-  textualRepr.append('\t');
-  for (int j = 0; j < m_stageModel->columnCount(); j++) {
-    textualRepr.append(m_stageModel->headerData(j, Qt::Horizontal).toString());
-    textualRepr.append('\t');
+  const long long maxStart = std::max(0LL, cycles - windowCycles);
+  {
+    QSignalBlocker blocker(m_scrubber);
+    m_scrubber->setRange(0, static_cast<int>(std::min<long long>(maxStart,
+                                                                 INT_MAX)));
+    m_scrubber->setPageStep(windowCycles);
   }
-  textualRepr.append('\n');
-  // Copy data
-  for (int i = 0; i < m_stageModel->rowCount(); ++i) {
-    textualRepr.append(m_stageModel->headerData(i, Qt::Vertical).toString());
-    textualRepr.append('\t');
-    for (int j = 0; j < m_stageModel->columnCount(); j++) {
-      textualRepr.append(
-          m_stageModel->data(m_stageModel->index(i, j)).toString());
-      textualRepr.append('\t');
+  const long long first = m_scrubber->value();
+  m_stageModel->setCycleWindow(first, windowCycles);
+  m_overview->setWindow(first, windowCycles);
+
+  const long long last = std::min(cycles, first + windowCycles) - 1;
+  m_windowLabel->setText(
+      cycles == 0 ? QString()
+                  : QString("Cycles %1-%2 of %3")
+                        .arg(first)
+                        .arg(std::max(first, last))
+                        .arg(cycles));
+}
+
+bool PipelineDiagramWidget::eventFilter(QObject *watched, QEvent *event) {
+  if (watched == m_ui->pipelineDiagramView->viewport()) {
+    if (event->type() == QEvent::Resize) {
+      updateWindow();
+    } else if (event->type() == QEvent::Wheel) {
+      // Horizontal scrolling (or shift+wheel) scrubs through the cycles.
+      auto *wheelEvent = static_cast<QWheelEvent *>(event);
+      if (wheelEvent->angleDelta().x() != 0 ||
+          wheelEvent->modifiers() & Qt::ShiftModifier) {
+        QCoreApplication::sendEvent(m_scrubber, event);
+        return true;
+      }
     }
-    textualRepr.append('\n');
   }
-  QApplication::clipboard()->setText(textualRepr);
+  return QDialog::eventFilter(watched, event);
+}
+
+void PipelineDiagramWidget::on_copy_clicked() {
+  // Copy entire table to clipboard, including headers. All recorded cycles are
+  // copied, not only those within the displayed window.
+  Q_ASSERT(m_stageModel != nullptr);
+  QApplication::clipboard()->setText(m_stageModel->toString());
 }
 } // namespace Ripes
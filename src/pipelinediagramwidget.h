@@ -3,13 +3,23 @@
 #include <QDialog>
 
 QT_FORWARD_DECLARE_CLASS(QAbstractItemModel)
+QT_FORWARD_DECLARE_CLASS(QLabel)
+QT_FORWARD_DECLARE_CLASS(QScrollBar)
 
 namespace Ripes {
 class PipelineDiagramModel;
+class PipelineDensityView;
 namespace Ui {
 class PipelineDiagramWidget;
 }
 
+/**
+ * @brief The PipelineDiagramWidget class
+ * Displays a window of the cycles recorded by a PipelineDiagramModel. The
+ * table only holds the cycles which fit within its viewport; the window is
+ * moved through the recorded cycles by the cycle scrubber, or by clicking
+ * within the density overview of all cycles.
+ */
 class PipelineDiagramWidget : public QDialog {
   Q_OBJECT
 
@@ -17,11 +27,22 @@ public:
   PipelineDiagramWidget(PipelineDiagramModel *model, QWidget *parent = nullptr);
   ~PipelineDiagramWidget() override;
 
+protected:
+  bool eventFilter(QObject *watched, QEvent *event) override;
+
 private slots:
   void on_copy_clicked();
 
 private:
+  /// Fits the cycle window to the width of the table, starting at the cycle of
+  /// the scrubber.
+  void updateWindow();
+
   Ui::PipelineDiagramWidget *m_ui = nullptr;
   PipelineDiagramModel *m_stageModel = nullptr;
+  PipelineDensityView *m_overview = nullptr;
+  QScrollBar *m_scrubber = nullptr;
+  QLabel *m_windowLabel = nullptr;
+  int m_columnWidth = 0;
 };
 } // namespace Ripes
@@ -0,0 +1,204 @@
+#include "processorcomparisondialog.h"
+
+#include <QDialogButtonBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QJsonObject>
+#include <QLabel>
+#include <QListWidget>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+#include <climits>
+#include <vector>
+
+#include "processorhandler.h"
+
+namespace Ripes {
+
+ProcessorComparisonDialog::ProcessorComparisonDialog(
+    const QStringList &arguments, QWidget *parent)
+    : QDialog(parent), m_arguments(arguments) {
+  setWindowTitle("Compare processors");
+  auto *layout = new QVBoxLayout(this);
+
+  // Any processor implementing the ISA of the current processor may resume
+  // from its state.
+  const auto *isa = ProcessorHandler::currentISA();
+  m_processorList = new QListWidget(this);
+  m_processorList->setToolTip("Processor models to compare. Each runs in a "
+                              "process of its own.");
+  for (const auto &desc : ProcessorRegistry::getAvailableProcessors()) {
+    const auto procISA = desc.second->isaInfo().isa;
+    if (procISA->isaID() != isa->isaID() || procISA->bits() != isa->bits())
+      continue;
+    auto *item = new QListWidgetItem(desc.second->name, m_processorList);
+    item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+    const bool current = desc.first == ProcessorHandler::getID();
+    item->setCheckState(current ? Qt::Checked : Qt::Unchecked);
+    item->setData(Qt::UserRole, static_cast<int>(desc.first));
+  }
+  layout->addWidget(new QLabel("Processors:", this));
+  layout->addWidget(m_processorList);
+
+  auto *controls = new QHBoxLayout();
+  m_stepCycles = new QSpinBox(this);
+  m_stepCycles->setRange(1, INT_MAX);
+  m_stepCycles->setValue(100);
+  m_stepCycles->setSuffix(" cycles");
+  m_stepButton = new QPushButton("Step", this);
+  m_stepButton->setToolTip(
+      "Advance every processor by the same number of cycles");
+  m_runButton = new QPushButton("Run", this);
+  m_runButton->setToolTip("Run every processor until the program finishes");
+  m_resetButton = new QPushButton("Reset", this);
+  m_resetButton->setToolTip("Restart the comparison from the current state of "
+                            "the processor of the main window");
+  controls->addWidget(new QLabel("Step:", this));
+  controls->addWidget(m_stepCycles);
+  controls->addWidget(m_stepButton);
+  controls->addWidget(m_runButton);
+  controls->addStretch();
+  controls->addWidget(m_resetButton);
+  layout->addLayout(controls);
+
+  m_table = new QTableWidget(0, NColumns, this);
+  m_table->setHorizontalHeaderLabels({"Processor", "Status", "Cycles",
+                                      "Instructions", "CPI",
+                                      "Stalled stage cycles"});
+  m_table->horizontalHeader()->setSectionResizeMode(
+      QHeaderView::ResizeToContents);
+  m_table->horizontalHeader()->setStretchLastSection(true);
+  m_table->verticalHeader()->hide();
+  m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  layout->addWidget(m_table);
+
+  m_status = new QLabel(this);
+  layout->addWidget(m_status);
+
+  auto *buttons = new QDialogButtonBox(QDialogButtonBox::Close, this);
+  connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+  layout->addWidget(buttons);
+
+  connect(m_stepButton, &QPushButton::clicked, this,
+          [this] { runModels(m_steppedCycles + m_stepCycles->value()); });
+  connect(m_runButton, &QPushButton::clicked, this, [this] { runModels(0); });
+  connect(m_resetButton, &QPushButton::clicked, this, [this] {
+    if (ProcessorHandler::isRunning()) {
+      m_status->setText("Pause the processor to capture its state.");
+      return;
+    }
+    capture();
+  });
+  connect(&m_fork, &SimulationFork::finished, this,
+          &ProcessorComparisonDialog::modelsFinished);
+
+  capture();
+  resize(640, 480);
+}
+
+void ProcessorComparisonDialog::capture() {
+  const QString err = m_fork.snapshot();
+  m_steppedCycles = 0;
+  m_table->setRowCount(0);
+  if (!err.isEmpty())
+    m_status->setText(err);
+  else
+    m_status->setText("Captured the state at cycle " +
+                      QString::number(m_fork.snapshotCycle()));
+}
+
+std::vector<ProcessorID> ProcessorComparisonDialog::checkedProcessors() const {
+  std::vector<ProcessorID> processors;
+  for (int i = 0; i < m_processorList->count(); ++i) {
+    const auto *item = m_processorList->item(i);
+    if (item->checkState() == Qt::Checked)
+      processors.push_back(
+          static_cast<ProcessorID>(item->data(Qt::UserRole).toInt()));
+  }
+  return processors;
+}
+
+void ProcessorComparisonDialog::setRunning(bool running) {
+  m_processorList->setEnabled(!running);
+  m_stepButton->setEnabled(!running);
+  m_runButton->setEnabled(!running);
+  m_resetButton->setEnabled(!running);
+}
+
+void ProcessorComparisonDialog::runModels(long long cycles) {
+  m_processors = checkedProcessors();
+  if (m_processors.empty()) {
+    m_status->setText("No processors are selected.");
+    return;
+  }
+
+  std::vector<ForkVariant> variants;
+  for (const auto id : m_processors)
+    variants.push_back({ProcessorRegistry::getDescription(id).name,
+                        {"--proc", enumToString<ProcessorID>(id)}});
+  QStringList args = {"--cycles", "--iret", "--cpi", "--stages"};
+  // Run limits are absolute cycle counts.
+  if (cycles != 0)
+    args << "--max-cycles" << QString::number(m_fork.snapshotCycle() + cycles);
+  args << m_arguments;
+
+  const QString err = m_fork.start(args, variants);
+  if (!err.isEmpty()) {
+    m_status->setText(err);
+    return;
+  }
+  m_requestedCycles = cycles;
+  setRunning(true);
+  m_status->setText(cycles == 0 ? "Running to completion..."
+                                : "Running " + QString::number(cycles) +
+                                      " cycles past the captured state...");
+}
+
+void ProcessorComparisonDialog::modelsFinished() {
+  setRunning(false);
+  m_steppedCycles = m_requestedCycles;
+  const auto &results = m_fork.results();
+  m_table->setRowCount(static_cast<int>(results.size()));
+  for (size_t i = 0; i < results.size(); ++i) {
+    const QJsonObject &result = results.at(i);
+    const QJsonObject report = result.value("report").toObject();
+    const QString status = result.value("status").toString();
+
+    std::vector<QString> cells(NColumns);
+    cells[Processor] = result.value("name").toString();
+    if (status == "failed") {
+      cells[Status] = "Failed: " + result.value("error").toString();
+    } else {
+      cells[Status] = status == "ok" ? "Finished" : "Running";
+      cells[Cycles] =
+          QString::number(report.value("cycles").toDouble(), 'f', 0);
+      const double instructions =
+          report.value("# instructions retired").toDouble();
+      cells[Instructions] = QString::number(instructions, 'f', 0);
+      const double cpi = report.value("CPI").toDouble();
+      cells[CPI] = instructions == 0 ? "-" : QString::number(cpi, 'f', 3);
+      double stalls = 0;
+      const QJsonObject stages = report.value("stage statistics").toObject();
+      for (const auto &stage : stages)
+        stalls += stage.toObject().value("stalled").toDouble();
+      cells[Stalls] = QString::number(stalls, 'f', 0);
+    }
+    for (int column = 0; column < NColumns; ++column) {
+      auto *item = new QTableWidgetItem(cells.at(column));
+      if (column >= Cycles)
+        item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+      m_table->setItem(static_cast<int>(i), column, item);
+    }
+  }
+  m_status->setText(
+      m_steppedCycles == 0
+          ? "Ran to completion"
+          : "Stepped " + QString::number(m_steppedCycles) +
+                " cycles past the captured state at cycle " +
+                QString::number(m_fork.snapshotCycle()));
+}
+
+} // namespace Ripes
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <QDialog>
+
+#include "cli/simfork.h"
+#include "processorregistry.h"
+
+QT_FORWARD_DECLARE_CLASS(QLabel)
+QT_FORWARD_DECLARE_CLASS(QListWidget)
+QT_FORWARD_DECLARE_CLASS(QPushButton)
+QT_FORWARD_DECLARE_CLASS(QSpinBox)
+QT_FORWARD_DECLARE_CLASS(QTableWidget)
+
+namespace Ripes {
+
+/**
+ * @brief The ProcessorComparisonDialog class
+ * Simulates the current program on several processor models side by side,
+ * comparing their cycles, instructions retired, CPI and stalled stage cycles.
+ * Each model resumes from the state of the processor when the dialog was
+ * opened (see SimulationFork), in a CLI mode process of its own, such that the
+ * models run in parallel without slowing down the simulation of the main
+ * window.
+ *
+ * The models are stepped in lockstep: each step runs every model up to the
+ * same cycle count. A forked simulation cannot be resumed, so each step reruns
+ * the models from the captured state with a larger cycle budget.
+ */
+class ProcessorComparisonDialog : public QDialog {
+  Q_OBJECT
+
+public:
+  /// The models are run with the options of @p arguments, ie. the L1 cache
+  /// configuration of the cache tab.
+  ProcessorComparisonDialog(const QStringList &arguments,
+                            QWidget *parent = nullptr);
+
+private:
+  enum Column {
+    Processor,
+    Status,
+    Cycles,
+    Instructions,
+    CPI,
+    Stalls,
+    NColumns
+  };
+
+  /// Runs the checked models up to @p cycles cycles past the captured state,
+  /// or to completion if @p cycles is 0.
+  void runModels(long long cycles);
+  /// Captures the current state of the processor, which the models resume
+  /// from.
+  void capture();
+  void modelsFinished();
+  std::vector<ProcessorID> checkedProcessors() const;
+  void setRunning(bool running);
+
+  QStringList m_arguments;
+  SimulationFork m_fork;
+  std::vector<ProcessorID> m_processors;
+  // Cycles past the captured state which the models were last run to, and are
+  // being run to; 0 if run to completion.
+  long long m_steppedCycles = 0;
+  long long m_requestedCycles = 0;
+
+  QListWidget *m_processorList = nullptr;
+  QSpinBox *m_stepCycles = nullptr;
+  QPushButton *m_stepButton = nullptr;
+  QPushButton *m_runButton = nullptr;
+  QPushButton *m_resetButton = nullptr;
+  QTableWidget *m_table = nullptr;
+  QLabel *m_status = nullptr;
+};
+
+} // namespace Ripes
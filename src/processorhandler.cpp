@@ -1,6 +1,8 @@
 #include "processorhandler.h"
 
+#include "hosttrace.h"
 #include "processorregistry.h"
+#include "processors/pagedaddressspace.h"
 #include "processors/ripesvsrtlprocessor.h"
 #include "ripessettings.h"
 #include "statusmanager.h"
@@ -11,11 +13,31 @@
 
 #include "syscall/riscv_syscall.h"
 
+#include <QApplication>
+#include <QElapsedTimer>
 #include <QMessageBox>
 #include <QtConcurrent/QtConcurrent>
 
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <thread>
+
 namespace Ripes {
 
+// Batches of cycles executed per second of simulated time by paced runs, and
+// the longest sleep in between checks for the run being stopped.
+static constexpr uint64_t c_pacedBatchesPerSecond = 100;
+static constexpr qint64 c_pacedSleepSliceNs = 10000000;
+
+static QString frequencyString(double hz) {
+  if (hz >= 1e6)
+    return QString::number(hz / 1e6, 'g', 3) + " MHz";
+  if (hz >= 1e3)
+    return QString::number(hz / 1e3, 'g', 3) + " kHz";
+  return QString::number(hz, 'g', 3) + " Hz";
+}
+
 ProcessorHandler::ProcessorHandler() {
   m_constructing = true;
 
@@ -28,9 +50,9 @@ ProcessorHandler::ProcessorHandler() {
         RipesSettings::value(RIPES_SETTING_PROCESSOR_ID).value<ProcessorID>();
 
     // Some sanity checking
-    m_currentID = m_currentID >= ProcessorID::NUM_PROCESSORS
-                      ? ProcessorID::RV32_5S
-                      : m_currentID;
+    m_currentID = ProcessorRegistry::hasProcessor(m_currentID)
+                      ? m_currentID
+                      : ProcessorID::RV32_5S;
   }
 
   // Processor extensions
@@ -38,60 +60,107 @@ ProcessorHandler::ProcessorHandler() {
   if (RipesSettings::value(RIPES_SETTING_PROCESSOR_EXTENSIONS).isNull())
     extensions = ProcessorRegistry::getDescription(m_currentID)
                      .isaInfo()
-                     .isa->supportedExtensions();
+                     .supportedExtensions;
   else
     extensions = RipesSettings::value(RIPES_SETTING_PROCESSOR_EXTENSIONS)
                      .value<QStringList>();
 
+  // Applied to the processor when it is constructed.
+  m_vlen = RipesSettings::value(RIPES_SETTING_VLEN).toUInt();
+
   _selectProcessor(
       m_currentID, extensions,
       ProcessorRegistry::getDescription(m_currentID).defaultRegisterVals);
 
-  // The m_procStateChangeTimer limits maximum frequency of which the
+  // The refresh scheduler limits the maximum frequency of which the
   // procStateChangedNonRun is emitted.
-  m_procStateChangeTimer.setSingleShot(true);
-  m_procStateChangeTimer.setInterval(
-      1000.0 / RipesSettings::value(RIPES_SETTING_UIUPDATEPS).toInt());
+  m_refreshScheduler.setFrameRate(
+      RipesSettings::value(RIPES_SETTING_UIUPDATEPS).toInt());
   connect(RipesSettings::getObserver(RIPES_SETTING_UIUPDATEPS),
           &SettingObserver::modified, this, [=] {
-            m_procStateChangeTimer.setInterval(
-                1000.0 /
+            m_refreshScheduler.setFrameRate(
                 RipesSettings::value(RIPES_SETTING_UIUPDATEPS).toInt());
           });
+  m_refreshScheduler.addClient(this, [=] { emit procStateChangedNonRun(); });
 
-  connect(&m_procStateChangeTimer, &QTimer::timeout, this, [=] {
-    emit procStateChangedNonRun();
-    m_enqueueStateChangeLock.lock();
-    if (m_enqueueStateChangeSignal) {
-      m_enqueueStateChangeSignal = false;
-      m_procStateChangeTimer.start();
-    }
-    m_enqueueStateChangeLock.unlock();
-  });
+  m_virtualClockHz = RipesSettings::value(RIPES_SETTING_VIRTUAL_CLOCK).toUInt();
+  connect(RipesSettings::getObserver(RIPES_SETTING_VIRTUAL_CLOCK),
+          &SettingObserver::modified, this, [=] {
+            m_virtualClockHz =
+                RipesSettings::value(RIPES_SETTING_VIRTUAL_CLOCK).toUInt();
+          });
+  m_runPaceHz = RipesSettings::value(RIPES_SETTING_RUN_PACE).toUInt();
+  connect(RipesSettings::getObserver(RIPES_SETTING_RUN_PACE),
+          &SettingObserver::modified, this, [=] {
+            m_runPaceHz = RipesSettings::value(RIPES_SETTING_RUN_PACE).toUInt();
+          });
 
-  // Connect the runwatcher finished signals
-  connect(&m_runWatcher, &QFutureWatcher<void>::finished, this, [=] {
-    emit runFinished();
-    _triggerProcStateChangeTimer();
-  });
-  connect(&m_runWatcher, &QFutureWatcher<void>::finished, this,
-          [=] { ProcessorStatusManager::clearStatus(); });
+  m_branchPredictor = static_cast<BranchPredictor::Scheme>(
+      RipesSettings::value(RIPES_SETTING_BRANCH_PREDICTOR).toInt());
+  _applyBranchPredictor();
+  connect(RipesSettings::getObserver(RIPES_SETTING_BRANCH_PREDICTOR),
+          &SettingObserver::modified, this, [=](const QVariant &scheme) {
+            _setBranchPredictor(
+                static_cast<BranchPredictor::Scheme>(scheme.toInt()));
+          });
 
-  // Connect relevant settings changes to VSRTL
-  connect(RipesSettings::getObserver(RIPES_SETTING_REWINDSTACKSIZE),
-          &SettingObserver::modified, this, [=](const auto &size) {
-            m_currentProcessor->setMaxReverseCycles(size.toUInt());
+  m_mextTiming.mulLatency =
+      RipesSettings::value(RIPES_SETTING_MUL_LATENCY).toUInt();
+  m_mextTiming.divLatency =
+      RipesSettings::value(RIPES_SETTING_DIV_LATENCY).toUInt();
+  _applyMExtTiming();
+  for (const char *setting :
+       {RIPES_SETTING_MUL_LATENCY, RIPES_SETTING_DIV_LATENCY}) {
+    connect(RipesSettings::getObserver(setting), &SettingObserver::modified,
+            this, [=] {
+              RipesProcessor::MExtTiming timing;
+              timing.mulLatency =
+                  RipesSettings::value(RIPES_SETTING_MUL_LATENCY).toUInt();
+              timing.divLatency =
+                  RipesSettings::value(RIPES_SETTING_DIV_LATENCY).toUInt();
+              _setMExtTiming(timing);
+            });
+  }
+
+  m_hartQuantum =
+      std::max(RipesSettings::value(RIPES_SETTING_HART_QUANTUM).toUInt(), 1u);
+  m_currentProcessor->setHartQuantum(m_hartQuantum);
+  connect(RipesSettings::getObserver(RIPES_SETTING_HART_QUANTUM),
+          &SettingObserver::modified, this, [=](const QVariant &cycles) {
+            _setHartQuantum(cycles.toUInt());
+          });
+
+  connect(RipesSettings::getObserver(RIPES_SETTING_VLEN),
+          &SettingObserver::modified, this,
+          [=](const QVariant &bits) { _setVLEN(bits.toUInt()); });
+
+  m_nonSerializingEcalls =
+      RipesSettings::value(RIPES_SETTING_NONSERIALIZING_ECALLS).toBool();
+  _applyNonSerializingEcalls();
+  connect(RipesSettings::getObserver(RIPES_SETTING_NONSERIALIZING_ECALLS),
+          &SettingObserver::modified, this, [=](const QVariant &enabled) {
+            _setNonSerializingEcalls(enabled.toBool());
           });
 
-  // Update VSRTL reverse stack size to reflect current settings
-  m_currentProcessor->setMaxReverseCycles(
-      RipesSettings::value(RIPES_SETTING_REWINDSTACKSIZE).toInt());
+  // Connect relevant settings changes to VSRTL
+  connect(RipesSettings::getObserver(RIPES_SETTING_REWINDSTACKSIZE),
+          &SettingObserver::modified, this,
+          [=](const auto &) { _applyReverseStackSize(); });
 
   // Reset request handling
   connect(RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET),
           &SettingObserver::modified, this, &ProcessorHandler::_reset);
 
-  m_syscallManager = std::make_unique<RISCVSyscallManager>();
+  m_syscallABI = RipesSettings::value(RIPES_SETTING_SYSCALL_NEWLIB).toBool()
+                     ? SyscallABI::Newlib
+                     : SyscallABI::RARS;
+  m_syscallManager = std::make_unique<RISCVSyscallManager>(m_syscallABI);
+  connect(RipesSettings::getObserver(RIPES_SETTING_SYSCALL_NEWLIB),
+          &SettingObserver::modified, this, [=](const QVariant &newlib) {
+            _setSyscallABI(newlib.toBool() ? SyscallABI::Newlib
+                                           : SyscallABI::RARS);
+          });
+  m_resetTimer.start();
   m_constructing = false;
 }
 
@@ -101,6 +170,7 @@ bool ProcessorHandler::isVSRTLProcessor() {
 }
 
 void ProcessorHandler::_loadProgram(const std::shared_ptr<Program> &p) {
+  HostTrace::Scope traceScope("loadProgram", "processor");
   // Stop any currently executing simulation
   stopRun();
 
@@ -111,11 +181,13 @@ void ProcessorHandler::_loadProgram(const std::shared_ptr<Program> &p) {
   auto &mem = m_currentProcessor->getMemory();
 
   m_program = p;
+  // Symbol lookups are served from an index, built while the program loads.
+  p->buildSymbolIndex();
   // Memory initializations
   mem.clearInitializationMemories();
   for (const auto &seg : p->sections) {
-    mem.addInitializationMemory(seg.second.address, seg.second.data.data(),
-                                seg.second.data.length());
+    addInitializationMemory(mem, seg.second.address, seg.second.data.data(),
+                            seg.second.data.length());
   }
 
   m_currentProcessor->setPCInitialValue(p->entryPoint);
@@ -125,13 +197,25 @@ void ProcessorHandler::_loadProgram(const std::shared_ptr<Program> &p) {
 
   // Update breakpoints to stay within the loaded program range
   std::vector<AInt> bpsToRemove;
-  for (const auto &bp : m_breakpoints) {
+  for (const auto &bp : m_breakpoints.addresses()) {
     if ((bp < textStart) || (bp >= textEnd)) {
       bpsToRemove.push_back(bp);
     }
   }
   for (const auto &bp : bpsToRemove) {
     m_breakpoints.erase(bp);
+    m_breakpointConditions.erase(bp);
+  }
+  m_breakpoints.setRange(textStart, textEnd);
+  // Conditions may refer to the symbols of the program; conditions which no
+  // longer compile are removed, leaving their breakpoints unconditional.
+  for (auto it = m_breakpointConditions.begin();
+       it != m_breakpointConditions.end();) {
+    auto &condition = it->second;
+    if (condition.compile(condition.text(), *_currentISA(), p.get()).isEmpty())
+      ++it;
+    else
+      it = m_breakpointConditions.erase(it);
   }
 
   RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
@@ -140,52 +224,238 @@ void ProcessorHandler::_loadProgram(const std::shared_ptr<Program> &p) {
 
 void ProcessorHandler::_writeMem(AInt address, VInt value, int size) {
   m_currentProcessor->getMemory().writeMem(address, value, size);
+  _memoryWritten(address, size);
 }
 
-vsrtl::core::AddressSpaceMM &ProcessorHandler::_getMemory() {
-  return m_currentProcessor->getMemory();
+void ProcessorHandler::_memoryWritten(AInt address, AInt bytes) {
+  m_dirtyPages.markDirty(address, bytes);
+  m_currentProcessor->memoryWritten(address, bytes);
+  if (m_executingSyscall)
+    m_executingSyscall->writes.emplace_back(address, bytes);
+  if (m_recordedSyscall) {
+    // The written memory is recorded as the system call left it.
+    QByteArray data(static_cast<int>(bytes), Qt::Uninitialized);
+    const unsigned long long bytesRead = m_syscallBytesRead;
+    _readMemBlock(address, data.data(), bytes);
+    m_syscallBytesRead = bytesRead;
+    m_recordedSyscall->memory.emplace_back(address, std::move(data));
+  }
+}
+
+void ProcessorHandler::_readMemBlock(AInt address, char *data, AInt bytes) {
+  m_syscallBytesRead += bytes;
+  auto &memory = m_currentProcessor->getMemory();
+  if (auto *paged = dynamic_cast<PagedAddressSpaceMM *>(&memory)) {
+    paged->readBlock(address, reinterpret_cast<uint8_t *>(data), bytes);
+    return;
+  }
+  for (AInt i = 0; i < bytes; ++i)
+    data[i] = static_cast<char>(memory.readMemConst(address + i, 1) & 0xFF);
 }
 
-void ProcessorHandler::_triggerProcStateChangeTimer() {
-  m_enqueueStateChangeLock.lock();
-  if (!m_procStateChangeTimer.isActive()) {
-    m_enqueueStateChangeSignal = false;
-    m_procStateChangeTimer.start();
+void ProcessorHandler::_writeMemBlock(AInt address, const char *data,
+                                      AInt bytes) {
+  m_syscallBytesWritten += bytes;
+  auto &memory = m_currentProcessor->getMemory();
+  if (auto *paged = dynamic_cast<PagedAddressSpaceMM *>(&memory)) {
+    paged->writeBlock(address, reinterpret_cast<const uint8_t *>(data), bytes);
   } else {
-    m_enqueueStateChangeSignal = true;
+    for (AInt i = 0; i < bytes; ++i)
+      memory.writeMem(address + i, static_cast<uint8_t>(data[i]), 1);
   }
-  m_enqueueStateChangeLock.unlock();
+  _memoryWritten(address, bytes);
 }
 
-class ProcessorClocker : public QRunnable {
-public:
-  explicit ProcessorClocker(bool &finished) : m_finished(finished) {}
-  void run() override {
-    ProcessorHandler::getProcessorNonConst()->clock();
-    ProcessorHandler::checkProcessorFinished();
-    if (ProcessorHandler::checkBreakpoint()) {
-      ProcessorHandler::stopRun();
+QByteArray ProcessorHandler::_readString(AInt address) {
+  auto &memory = m_currentProcessor->getMemory();
+  QByteArray string;
+  if (auto *paged = dynamic_cast<PagedAddressSpaceMM *>(&memory)) {
+    string.resize(paged->stringLength(address));
+    paged->readBlock(address, reinterpret_cast<uint8_t *>(string.data()),
+                     string.size());
+  } else {
+    char byte;
+    while ((byte = static_cast<char>(memory.readMemConst(address++, 1) & 0xFF)))
+      string.append(byte);
+  }
+  // Including the terminator.
+  m_syscallBytesRead += string.size() + 1;
+  return string;
+}
+
+std::optional<AInt> ProcessorHandler::_findMem(AInt start, AInt end,
+                                               const MemoryPattern &pattern) {
+  auto &memory = m_currentProcessor->getMemory();
+  auto *paged = dynamic_cast<PagedAddressSpaceMM *>(&memory);
+
+  // The searched ranges of memory, as [first, last) pairs, merged such that
+  // matches may span adjacent ranges.
+  std::vector<std::pair<AInt, AInt>> ranges;
+  if (m_program) {
+    for (const auto &section : m_program->sections) {
+      const AInt address = section.second.address;
+      ranges.push_back({address, address + section.second.data.size()});
     }
-    m_finished = true;
+  }
+  if (paged) {
+    for (const AInt page : paged->materializedPages())
+      ranges.push_back({page << PagedAddressSpaceMM::s_pageBits,
+                        (page + 1) << PagedAddressSpaceMM::s_pageBits});
+  }
+  std::sort(ranges.begin(), ranges.end());
+  std::vector<std::pair<AInt, AInt>> merged;
+  for (const auto &range : ranges) {
+    if (!merged.empty() && range.first <= merged.back().second)
+      merged.back().second = std::max(merged.back().second, range.second);
+    else
+      merged.push_back(range);
   }
 
-private:
-  bool &m_finished;
-};
+  const auto *bytes = reinterpret_cast<const uint8_t *>(pattern.bytes.data());
+  const auto *mask = reinterpret_cast<const uint8_t *>(pattern.mask.data());
+  const AInt size = pattern.bytes.size();
+  for (const auto &range : merged) {
+    const AInt first = std::max(start, range.first);
+    const AInt last = std::min(end, range.second);
+    if (first >= last)
+      continue;
+    if (paged) {
+      if (auto match = paged->find(first, last, bytes,
+                                   pattern.masked() ? mask : nullptr, size,
+                                   pattern.alignment))
+        return match;
+      continue;
+    }
+    for (AInt address = first; last - address >= size; ++address) {
+      if (address % pattern.alignment != 0)
+        continue;
+      AInt i = 0;
+      while (i < size &&
+             ((memory.readMemConst(address + i, 1) ^ bytes[i]) & mask[i]) == 0)
+        ++i;
+      if (i == size)
+        return address;
+    }
+  }
+  return {};
+}
 
-void ProcessorHandler::_clock() {
-  if (m_clockFinished) {
-    m_clockFinished = false;
-    QThreadPool::globalInstance()->start(new ProcessorClocker(m_clockFinished));
+void ProcessorHandler::_fillMem(AInt address, AInt bytes,
+                                const QByteArray &pattern) {
+  if (pattern.isEmpty())
+    return;
+  auto &memory = m_currentProcessor->getMemory();
+  if (auto *paged = dynamic_cast<PagedAddressSpaceMM *>(&memory)) {
+    paged->fill(address, bytes,
+                reinterpret_cast<const uint8_t *>(pattern.data()),
+                pattern.size());
+  } else {
+    for (AInt i = 0; i < bytes; ++i)
+      memory.writeMem(address + i,
+                      static_cast<uint8_t>(pattern[i % pattern.size()]), 1);
   }
+  _memoryWritten(address, bytes);
+}
+
+void ProcessorHandler::_trackMemoryWrites() {
+  const auto access = m_currentProcessor->dataMemAccess();
+  if (access.type == MemoryAccess::Write)
+    m_dirtyPages.markDirty(access.address, access.bytes);
+}
+
+void ProcessorHandler::_attachObserver(ProcessorObserver *observer) {
+  const bool observedCycles = m_observers.observesCycles();
+  m_observers.attach(observer);
+  if (!observedCycles && m_observers.observesCycles() && m_currentProcessor) {
+    m_observers.sync(*m_currentProcessor);
+    _connectObservers(true);
+  }
+}
+
+void ProcessorHandler::_detachObserver(ProcessorObserver *observer) {
+  const bool observedCycles = m_observers.observesCycles();
+  m_observers.detach(observer);
+  if (observedCycles && !m_observers.observesCycles() && m_currentProcessor)
+    _connectObservers(false);
+}
+
+void ProcessorHandler::_connectObservers(bool connect) {
+  // Per-cycle dispatch is only connected while observed, such that unobserved
+  // processors do not pay for it.
+  if (connect)
+    m_currentProcessor->processorWasClocked.Connect(
+        this, &ProcessorHandler::_notifyObservers);
+  else
+    m_currentProcessor->processorWasClocked.Disconnect(
+        this, &ProcessorHandler::_notifyObservers);
+}
+
+void ProcessorHandler::_notifyObservers() {
+  m_observers.cycle(*m_currentProcessor);
+}
+
+vsrtl::core::AddressSpaceMM &ProcessorHandler::_getMemory() {
+  return m_currentProcessor->getMemory();
+}
+
+void ProcessorHandler::_markProcStateChanged() {
+  m_refreshScheduler.markAllDirty();
+}
+
+void ProcessorHandler::_clock(unsigned cycles) {
+  m_clockWorker.post([=] { _clockCycles(cycles); }, true);
+}
+
+void ProcessorHandler::_clockCycles(unsigned cycles) {
+  HostTrace::Scope traceScope("clock", "simulation");
+  m_watchpointHit.reset();
+  bool watched = false;
+  if (cycles == 1) {
+    m_currentProcessor->clock();
+    _checkpointForSeek();
+    watched = _checkWatchpoint();
+  } else {
+    // The clock signals of the cycles of a request are suppressed, and views
+    // are refreshed once after the final cycle.
+    auto *vsrtl_proc =
+        dynamic_cast<vsrtl::SimDesign *>(m_currentProcessor.get());
+    if (vsrtl_proc)
+      vsrtl_proc->setEnableSignals(false);
+    for (unsigned i = 0; i < cycles; ++i) {
+      if (i > 0 && (watched || _checkBreakpoint() ||
+                    m_currentProcessor->finished()))
+        break;
+      m_suppressedClockSignals++;
+      m_currentProcessor->clock();
+      _checkpointForSeek();
+      watched = _checkWatchpoint();
+    }
+    if (vsrtl_proc)
+      vsrtl_proc->setEnableSignals(true);
+    QMetaObject::invokeMethod(
+        this,
+        [=] {
+          if (m_vsrtlWidget)
+            m_vsrtlWidget->sync();
+          emit processorClockedNonRun();
+          _markProcStateChanged();
+        },
+        Qt::QueuedConnection);
+  }
+  _checkProcessorFinished();
+  if (watched || _checkBreakpoint())
+    setStopRunFlag();
 }
 
 void ProcessorHandler::_run() {
   ProcessorStatusManager::setStatusTimed("Running...");
   emit runStarted();
 
-  // Start running through the VSRTL Widget interface
-  m_runWatcher.setFuture(QtConcurrent::run([=] {
+  // Runs are executed by the simulation worker, in order with any preceding
+  // clock requests.
+  m_running = true;
+  m_clockWorker.post([=] {
+    HostTrace::Scope traceScope("run", "simulation");
     auto *vsrtl_proc =
         dynamic_cast<vsrtl::SimDesign *>(m_currentProcessor.get());
 
@@ -193,16 +463,157 @@ void ProcessorHandler::_run() {
       vsrtl_proc->setEnableSignals(false);
     }
 
-    while (!(_checkBreakpoint() || m_currentProcessor->finished() ||
-             m_stopRunningFlag)) {
-      m_currentProcessor->clock();
+    m_runLimitReached = false;
+    m_watchpointHit.reset();
+    m_runFrameRequested = false;
+    // Paced runs execute the cycles of a fraction of a second of simulated
+    // time per batch, sleeping in between.
+    const uint64_t paceHz = m_runPaceHz;
+    const long long paceBatch =
+        std::max<long long>(1, paceHz / c_pacedBatchesPerSecond);
+    const long long startCycles = m_currentProcessor->getCycleCount();
+    QElapsedTimer runTimer;
+    runTimer.start();
+    for (bool stopped = false; !stopped;) {
+      if (m_runFrameRequested)
+        _runFrame();
+      long long cycles = _cyclesUntilRunLimit();
+      if (cycles == 0) {
+        // A program finishing at the limit is not cut short by it.
+        m_runLimitReached = !m_currentProcessor->finished();
+        break;
+      }
+      if (paceHz != 0)
+        cycles = std::min(cycles, paceBatch);
+      // Without breakpoints and watchpoints, nothing is checked in between
+      // the cycles of a batch.
+      const bool batched = m_blockTranslation && m_breakpoints.empty() &&
+                           m_watchpoints.empty();
+      if (batched && (m_currentProcessor->finished() || m_stopRunningFlag)) {
+        stopped = true;
+      } else if (batched) {
+        m_currentProcessor->clockBatch(
+            std::min(cycles, _cyclesUntilSeekCheckpoint()));
+        _checkpointForSeek();
+      } else {
+        for (long long i = 0; i < cycles; ++i) {
+          if (_checkBreakpoint() || m_currentProcessor->finished() ||
+              m_stopRunningFlag) {
+            stopped = true;
+            break;
+          }
+          m_currentProcessor->clock();
+          _checkpointForSeek();
+          if (_checkWatchpoint()) {
+            stopped = true;
+            break;
+          }
+        }
+      }
+      if (paceHz != 0 && !stopped)
+        _pace(runTimer, m_currentProcessor->getCycleCount() - startCycles,
+              paceHz);
+    }
+    if (paceHz != 0) {
+      const qint64 ns = std::max<qint64>(1, runTimer.nsecsElapsed());
+      m_achievedRunPace =
+          (m_currentProcessor->getCycleCount() - startCycles) * 1e9 / ns;
     }
 
     if (vsrtl_proc) {
       vsrtl_proc->setEnableSignals(true);
     }
-    emit runFinished();
-  }));
+    m_running = false;
+    QMetaObject::invokeMethod(
+        this,
+        [=] {
+          emit runFinished();
+          _markProcStateChanged();
+          ProcessorStatusManager::clearStatus();
+          if (paceHz != 0)
+            ProcessorStatusManager::setStatusTimed(
+                "Ran at " + frequencyString(m_achievedRunPace) + " (target " +
+                    frequencyString(paceHz) + ")",
+                5000);
+          if (m_watchpointHit)
+            ProcessorStatusManager::setStatusTimed(
+                "Stopped at watchpoint: " +
+                    WatchpointSet::describe(*m_watchpointHit),
+                5000);
+        },
+        Qt::QueuedConnection);
+  });
+}
+
+void ProcessorHandler::_pace(const QElapsedTimer &timer, long long cycles,
+                             uint64_t hz) {
+  const qint64 targetNs = static_cast<qint64>(cycles * 1e9 / hz);
+  const qint64 elapsedNs = timer.nsecsElapsed();
+  if (elapsedNs > 0)
+    m_achievedRunPace = cycles * 1e9 / elapsedNs;
+  // The run is stopped within a frame of sleeping.
+  for (qint64 aheadNs = targetNs - timer.nsecsElapsed(); aheadNs > 0;
+       aheadNs = targetNs - timer.nsecsElapsed()) {
+    if (m_stopRunningFlag)
+      return;
+    std::this_thread::sleep_for(std::chrono::nanoseconds(
+        std::min<qint64>(aheadNs, c_pacedSleepSliceNs)));
+  }
+}
+
+void ProcessorHandler::_runFrame() {
+  m_runFrameRequested = false;
+  std::unique_lock<std::mutex> lock(m_runFrameLock);
+  m_runFramePending = true;
+  QMetaObject::invokeMethod(
+      this,
+      [=] {
+        std::lock_guard<std::mutex> frameLock(m_runFrameLock);
+        // The run may have been stopped before the frame was presented.
+        if (!m_runFramePending)
+          return;
+        auto *vsrtl_proc =
+            dynamic_cast<vsrtl::SimDesign *>(m_currentProcessor.get());
+        if (vsrtl_proc)
+          vsrtl_proc->setEnableSignals(true);
+        emit runFrame();
+        if (vsrtl_proc)
+          vsrtl_proc->setEnableSignals(false);
+        m_runFramePending = false;
+        m_runFramePresented.notify_one();
+      },
+      Qt::QueuedConnection);
+  // The GUI thread may itself be waiting for the run to stop, in which case
+  // the frame is abandoned.
+  while (m_runFramePending && !m_stopRunningFlag)
+    m_runFramePresented.wait_for(lock, std::chrono::milliseconds(10));
+  m_runFramePending = false;
+}
+
+long long ProcessorHandler::_cyclesUntilRunLimit() const {
+  // Run limits are checked in between batches of this many cycles.
+  constexpr long long c_batchCycles = 1 << 12;
+  long long cycles = c_batchCycles;
+  if (m_maxCycles != 0) {
+    const long long remaining =
+        m_maxCycles - m_currentProcessor->getCycleCount();
+    if (remaining <= 0)
+      return 0;
+    // Each clock of a multi-hart processor executes a quantum of cycles.
+    cycles = std::min(
+        cycles, std::max(1LL, remaining / m_currentProcessor->hartQuantum()));
+  }
+  if (m_maxInstructions != 0) {
+    const long long remaining =
+        m_maxInstructions - m_currentProcessor->getInstructionsRetired();
+    if (remaining <= 0)
+      return 0;
+    // Each lane retires at most one instruction per cycle.
+    const long long lanes = m_currentProcessor->structure().size() *
+                            m_currentProcessor->hartQuantum();
+    cycles = std::min(cycles, std::max(1LL, remaining / lanes));
+  }
+  return cycles;
 }
 
 void ProcessorHandler::_setBreakpoint(const AInt address, bool enabled) {
@@ -210,7 +621,33 @@ void ProcessorHandler::_setBreakpoint(const AInt address, bool enabled) {
     m_breakpoints.insert(address);
   } else {
     m_breakpoints.erase(address);
+    m_breakpointConditions.erase(address);
+  }
+}
+
+QString ProcessorHandler::_setBreakpointCondition(AInt address,
+                                                  const QString &condition,
+                                                  unsigned hitCount) {
+  if (!_isExecutableAddress(address))
+    return "Address 0x" + QString::number(address, 16) + " is not executable";
+  if (condition.trimmed().isEmpty() && hitCount <= 1) {
+    m_breakpointConditions.erase(address);
+  } else {
+    BreakpointCondition compiled;
+    QString err = compiled.compile(condition, *_currentISA(), m_program.get());
+    if (!err.isEmpty())
+      return err;
+    compiled.setHitCount(hitCount);
+    m_breakpointConditions[address] = std::move(compiled);
   }
+  m_breakpoints.insert(address);
+  return QString();
+}
+
+const BreakpointCondition *
+ProcessorHandler::_getBreakpointCondition(AInt address) const {
+  auto it = m_breakpointConditions.find(address);
+  return it != m_breakpointConditions.end() ? &it->second : nullptr;
 }
 
 void ProcessorHandler::_loadProcessorToWidget(vsrtl::VSRTLWidget *widget,
@@ -221,20 +658,27 @@ void ProcessorHandler::_loadProcessorToWidget(vsrtl::VSRTLWidget *widget,
   if (auto *vsrtlProcessor =
           dynamic_cast<RipesVSRTLProcessor *>(m_currentProcessor.get())) {
     widget->setDesign(vsrtlProcessor, doPlaceAndRoute);
+    m_processorInWidget = true;
   }
 }
 
 bool ProcessorHandler::_hasBreakpoint(const AInt address) const {
-  return m_breakpoints.count(address);
+  return m_breakpoints.contains(address);
 }
 
 bool ProcessorHandler::_checkBreakpoint() {
-  for (const auto &stage : m_currentProcessor->breakpointTriggeringStages()) {
-    const auto it =
-        m_breakpoints.find(m_currentProcessor->getPcForStage(stage));
-    if (it != m_breakpoints.end()) {
+  if (m_breakpoints.empty())
+    return false;
+  for (const auto &stage : m_breakpointStages) {
+    const AInt pc = m_currentProcessor->getPcForStage(stage);
+    if (!m_breakpoints.contains(pc))
+      continue;
+    if (m_breakpointConditions.empty())
+      return true;
+    auto it = m_breakpointConditions.find(pc);
+    if (it == m_breakpointConditions.end() ||
+        it->second.triggers(*m_currentProcessor, stage))
       return true;
-    }
   }
   return false;
 }
@@ -243,7 +687,47 @@ void ProcessorHandler::_toggleBreakpoint(const AInt address) {
   _setBreakpoint(address, !hasBreakpoint(address));
 }
 
-void ProcessorHandler::_clearBreakpoints() { m_breakpoints.clear(); }
+void ProcessorHandler::_clearBreakpoints() {
+  m_breakpoints.clear();
+  m_breakpointConditions.clear();
+}
+
+bool ProcessorHandler::_checkWatchpoint() {
+  if (m_watchpoints.empty())
+    return false;
+  if (m_watchedMemory && !m_watchedMemory->takeWatchedAccess())
+    return false;
+  // The access of a stall cycle was performed, and checked, in the cycle which
+  // initiated the stall.
+  if (m_currentProcessor->isStalled())
+    return false;
+  // Watched pages may also be accessed outside of the data accesses of the
+  // processor (ie. combinationally by a memory component, or by system
+  // calls); hits are confirmed against the data access of the cycle.
+  const MemoryAccess access = m_currentProcessor->dataMemAccess();
+  if (!m_watchpoints.match(access))
+    return false;
+  m_watchpointHit = access;
+  return true;
+}
+
+void ProcessorHandler::_addWatchpoint(const Watchpoint &watchpoint) {
+  m_watchpoints.insert(watchpoint);
+  _applyWatchpoints();
+}
+
+void ProcessorHandler::_clearWatchpoints() {
+  m_watchpoints.clear();
+  _applyWatchpoints();
+}
+
+void ProcessorHandler::_applyWatchpoints() {
+  m_watchedMemory =
+      dynamic_cast<PagedAddressSpaceMM *>(&m_currentProcessor->getMemory());
+  if (m_watchedMemory)
+    m_watchedMemory->setWatchedPages(
+        m_watchpoints.pages(PagedAddressSpaceMM::s_pageBits));
+}
 
 void ProcessorHandler::createAssemblerForCurrentISA() {
   const auto &ISA = _currentISA();
@@ -263,22 +747,36 @@ void ProcessorHandler::_reset() {
   }
 
   SystemIO::abortSyscall();
+  // Clock requests and runs in flight would otherwise race with the reset.
+  if (m_running)
+    m_stopRunningFlag = true;
+  m_clockWorker.waitForIdle();
+  m_stopRunningFlag = false;
+  // Resets of a seek re-execute the recorded execution.
+  if (!m_seeking) {
+    m_syscallLog.clear();
+    m_seekCheckpoints.clear();
+  }
+  m_syscallLogPosition = 0;
+  m_seekCheckpointable = true;
+  m_unsupportedInstruction.clear();
   getProcessorNonConst()->resetProcessor();
+  for (auto &condition : m_breakpointConditions)
+    condition.second.resetHits();
 
   // Rewrite register initializations
-  for (const auto &kv : m_currentRegInits) {
-    _setRegisterValue(RegisterFileType::GPR, kv.first, kv.second);
-  }
+  getProcessorNonConst()->setRegisters(RegisterFileType::GPR,
+                                       m_currentRegInits);
   // Forcing memory values doesn't necessarily mean that the processor will
-  // notify that its state changed. Manually trigger a state change signal, to
-  // ensure this.
-  emit procStateChangedNonRun();
+  // notify that its state changed. Manually trigger a state change, to ensure
+  // this.
+  _markProcStateChanged();
 }
 
 void ProcessorHandler::_selectProcessor(const ProcessorID &id,
                                         const QStringList &extensions,
                                         const RegisterInitialization &setup) {
-  m_currentID = id;
+  HostTrace::Scope traceScope("selectProcessor", "processor");
   m_currentRegInits = setup;
   RipesSettings::setValue(RIPES_SETTING_PROCESSOR_ID, id);
   RipesSettings::setValue(RIPES_SETTING_PROCESSOR_EXTENSIONS, extensions);
@@ -290,62 +788,113 @@ void ProcessorHandler::_selectProcessor(const ProcessorID &id,
           ProcessorRegistry::getDescription(id).isaInfo().isa.get(),
           extensions));
 
-  // Processor initializations
-  m_currentProcessor =
-      ProcessorRegistry::constructProcessor(m_currentID, extensions);
+  // Processor initializations. Previously selected processors are reused
+  // from the processor pool, having been initialized already.
+  _poolCurrentProcessor();
+  m_currentID = id;
+  m_currentExtensions = extensions;
+  m_currentProcessor = _takePooledProcessor(m_currentID, extensions);
+  const bool pooled = m_currentProcessor != nullptr;
+  if (!pooled) {
+    m_currentProcessor =
+        ProcessorRegistry::constructProcessor(m_currentID, extensions);
+  }
   m_currentProcessor->isExecutableAddress = [=](AInt address) {
     return _isExecutableAddress(address);
   };
+  m_breakpointStages = m_currentProcessor->breakpointTriggeringStages();
+  _applyWatchpoints();
 
   // Syscall handling initialization
   m_currentProcessor->trapHandler = [=] { syscallTrap(); };
+  m_currentProcessor->unsupportedInstrHandler = [=](AInt address) {
+    _unsupportedInstr(address);
+  };
 
-  m_currentProcessor->postConstruct();
+  if (!pooled)
+    m_currentProcessor->postConstruct();
+  _applyReverseStackSize();
+  _applyBranchPredictor();
+  _applyMExtTiming();
+  _applyInstructionTrace();
+  m_currentProcessor->setHartQuantum(m_hartQuantum);
+  m_currentProcessor->setVLEN(m_vlen);
+  _applyNonSerializingEcalls();
   createAssemblerForCurrentISA();
 
   if (keepProgram && m_program) {
     loadProgram(m_program);
   } else {
     m_program = nullptr;
+    if (pooled) {
+      // Unload the program which the pooled processor last executed.
+      m_currentProcessor->getMemory().clearInitializationMemories();
+      m_currentProcessor->setPCInitialValue(0);
+    }
     emit programChanged();
   }
 
-  // Connect wrappers for making processor signal emissions thread safe.
+  // Connect bridges for making processor signal emissions thread safe.
+  // Emissions from the simulation thread are coalesced, such that stepping or
+  // reversing many cycles queues a single event per signal.
   m_signalWrappers.clear();
-  m_signalWrappers.push_back(std::unique_ptr<vsrtl::GallantSignalWrapperBase>(
-      new vsrtl::GallantSignalWrapper(
-          this,
-          [=] {
-            if (!_isRunning()) {
-              emit processorClockedNonRun();
-              _triggerProcStateChangeTimer();
-            }
-          },
-          m_currentProcessor->processorWasClocked)));
+  m_signalWrappers.push_back(std::make_unique<CoalescedSignal>(
+      this,
+      [=](unsigned long long emissions) {
+        // Only the simulation thread adds suppressed signals; none are
+        // consumed in between reading and subtracting them.
+        const long long suppressed = std::min<long long>(
+            emissions, m_suppressedClockSignals.load());
+        m_suppressedClockSignals -= suppressed;
+        if (static_cast<long long>(emissions) == suppressed)
+          return;
+        if (!_isRunning()) {
+          emit processorClockedNonRun();
+          _markProcStateChanged();
+        }
+      },
+      m_currentProcessor->processorWasClocked));
   // Connect ProcessorHandler::processorClocked since things connected to this
   // signal _must_ be updated _for each_ processor cycle, in order. Which would
   // not be possible through processorClockedNonRun, which might be cross-thread
   // and out of order.
   m_currentProcessor->processorWasClocked.Connect(
       this, &ProcessorHandler::processorClocked);
-
-  m_signalWrappers.push_back(std::unique_ptr<vsrtl::GallantSignalWrapperBase>(
-      new vsrtl::GallantSignalWrapper(
-          this,
-          [=] {
-            emit processorReset();
-            _triggerProcStateChangeTimer();
-          },
-          m_currentProcessor->processorWasReset)));
-
-  m_signalWrappers.push_back(std::unique_ptr<vsrtl::GallantSignalWrapperBase>(
-      new vsrtl::GallantSignalWrapper(
-          this,
-          [=] {
-            emit processorReversed();
-            _triggerProcStateChangeTimer();
-          },
-          m_currentProcessor->processorWasReversed)));
+  m_currentProcessor->processorWasClocked.Connect(
+      this, &ProcessorHandler::_trackMemoryWrites);
+  if (m_observers.observesCycles()) {
+    m_observers.sync(*m_currentProcessor);
+    _connectObservers(true);
+  }
+  // Resetting or reversing the processor may modify any part of memory.
+  m_dirtyPages.markAllDirty();
+  m_currentProcessor->processorWasReset.Connect(
+      &m_dirtyPages, &DirtyPageTracker::markAllDirty);
+  m_currentProcessor->processorWasReversed.Connect(
+      &m_dirtyPages, &DirtyPageTracker::markAllDirty);
+
+  // Repeated resets or reversals are handled as one.
+  m_signalWrappers.push_back(std::make_unique<CoalescedSignal>(
+      this,
+      [=](unsigned long long) {
+        m_resetTimer.start();
+        // System calls re-executed by a seek are replaced by their recorded
+        // effects, which act on the state of the system calls as it is.
+        if (!m_seeking)
+          m_syscallManager->reset();
+        m_programBreak = 0;
+        emit processorReset();
+        _markProcStateChanged();
+      },
+      m_currentProcessor->processorWasReset));
+
+  m_signalWrappers.push_back(std::make_unique<CoalescedSignal>(
+      this,
+      [=](unsigned long long) {
+        emit processorReversed();
+        _markProcStateChanged();
+      },
+      m_currentProcessor->processorWasReversed));
 
   emit processorChanged();
 
@@ -353,6 +902,42 @@ void ProcessorHandler::_selectProcessor(const ProcessorID &id,
   RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
 }
 
+void ProcessorHandler::_poolCurrentProcessor() {
+  if (!m_currentProcessor)
+    return;
+  if (m_processorInWidget) {
+    m_processorInWidget = false;
+    m_currentProcessor.reset();
+    return;
+  }
+  // Detach the processor from the handler and the components hooked into it,
+  // such that it is pooled as if newly constructed. The signal wrappers
+  // connected to it are destroyed once the next processor is selected.
+  m_currentProcessor->timerCompare = nullptr;
+  for (auto &counter : m_currentProcessor->hpmCounters)
+    counter = nullptr;
+  m_currentProcessor->processorWasClocked.Clear();
+  m_currentProcessor->processorWasReset.Clear();
+  m_currentProcessor->processorWasReversed.Clear();
+  m_processorPool.push_front(
+      {m_currentID, m_currentExtensions, std::move(m_currentProcessor)});
+  if (m_processorPool.size() > s_processorPoolSize)
+    m_processorPool.pop_back();
+}
+
+std::unique_ptr<RipesProcessor>
+ProcessorHandler::_takePooledProcessor(const ProcessorID &id,
+                                       const QStringList &extensions) {
+  for (auto it = m_processorPool.begin(); it != m_processorPool.end(); ++it) {
+    if (it->id == id && it->extensions == extensions) {
+      auto processor = std::move(it->processor);
+      m_processorPool.erase(it);
+      return processor;
+    }
+  }
+  return nullptr;
+}
+
 int ProcessorHandler::_getCurrentProgramSize() const {
   if (m_program) {
     const auto *textSection = m_program->getSection(TEXT_SECTION_NAME);
@@ -385,22 +970,478 @@ QString ProcessorHandler::_disassembleInstr(const AInt addr) const {
   }
 }
 
+// Returns the time in nanoseconds of @p cycles at the virtual clock @p hz.
+static long long cyclesToNs(uint64_t cycles, uint64_t hz) {
+  // Split to avoid overflowing cycles * 10^9.
+  return (cycles / hz) * 1000000000 + (cycles % hz) * 1000000000 / hz;
+}
+
+long long ProcessorHandler::currentTimeNs() {
+  const uint64_t hz = getVirtualClock();
+  if (hz == 0)
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+  return cyclesToNs(getProcessor()->getCycleCount(), hz);
+}
+
+long long ProcessorHandler::elapsedTimeNs() {
+  const uint64_t hz = getVirtualClock();
+  if (hz == 0)
+    return get()->m_resetTimer.nsecsElapsed();
+  return cyclesToNs(getProcessor()->getCycleCount(), hz);
+}
+
+void ProcessorHandler::_setSyscallABI(SyscallABI abi) {
+  if (abi == m_syscallABI)
+    return;
+  // Syscalls may be executing on the simulation thread, and the program is
+  // restarted under the new ABI.
+  SystemIO::abortSyscall();
+  _stopRun();
+  m_syscallABI = abi;
+  m_syscallManager = std::make_unique<RISCVSyscallManager>(abi);
+  _reset();
+}
+
 void ProcessorHandler::syscallTrap() {
-  auto futureWatcher = QFutureWatcher<bool>();
-  futureWatcher.setFuture(QtConcurrent::run([=] {
-    const unsigned int function = m_currentProcessor->getRegister(
-        RegisterFileType::GPR, _currentISA()->syscallReg());
-    return m_syscallManager->execute(function);
-  }));
-
-  futureWatcher.waitForFinished();
-  if (!futureWatcher.result()) {
+  HostTrace::Scope traceScope("syscall", "simulation");
+  const unsigned int function = m_currentProcessor->registers(
+      RegisterFileType::GPR)[_currentISA()->syscallReg()];
+  SyscallRecord record;
+  record.id = function;
+  const auto &syscalls = m_syscallManager->getSyscalls();
+  if (const auto it = syscalls.find(function); it != syscalls.end())
+    record.syscall = it->second.get();
+  record.cycle = m_currentProcessor->getCycleCount();
+
+  // System calls which were executed before are replaced by their recorded
+  // effects, as long as the execution follows the recording.
+  if (m_syscallLogPosition < m_syscallLog.size()) {
+    const SyscallEffects &effects = m_syscallLog[m_syscallLogPosition];
+    if (effects.cycle == record.cycle && effects.id == function) {
+      m_syscallLogPosition++;
+      _replaySyscall(effects);
+      return;
+    }
+    m_syscallLog.resize(m_syscallLogPosition);
+  }
+  if (m_syscallReplay == SyscallReplay::Replay) {
+    if (m_replayedSyscallPosition < m_replayedSyscalls.size() &&
+        m_replayedSyscalls[m_replayedSyscallPosition].id == function) {
+      _replaySyscall(m_replayedSyscalls[m_replayedSyscallPosition++]);
+      return;
+    }
+    m_syscallReplay = SyscallReplay::Off;
+  }
+
+  if (record.syscall) {
+    for (unsigned i = 0; i < record.args.size(); ++i)
+      record.args[i] = record.syscall->getArg(RegisterFileType::GPR, i);
+  }
+  m_syscallBytesRead = 0;
+  m_syscallBytesWritten = 0;
+
+  SyscallEffects effects;
+  std::map<RegisterFileType, std::vector<VInt>> registers;
+  const bool recordForSeek =
+      m_reversible && m_syscallLog.size() < s_syscallLogSize;
+  if (recordForSeek || m_syscallReplay == SyscallReplay::Record) {
+    effects.cycle = record.cycle;
+    effects.id = function;
+    for (const auto rfid : m_currentProcessor->registerFiles())
+      m_currentProcessor->getRegisters(rfid, registers[rfid]);
+    m_recordedSyscall = &effects;
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+  bool handled;
+  m_executingSyscall = &record;
+  if (!m_syscallManager->mayBlock(function)) {
+    // Fast path: non-blocking syscalls execute directly on the simulation
+    // thread, without a thread pool handoff.
+    handled = m_syscallManager->execute(function);
+  } else {
+    auto futureWatcher = QFutureWatcher<bool>();
+    futureWatcher.setFuture(QtConcurrent::run(
+        [=] { return m_syscallManager->execute(function); }));
+    futureWatcher.waitForFinished();
+    handled = futureWatcher.result();
+  }
+  m_executingSyscall = nullptr;
+  record.nanoseconds = timer.nsecsElapsed();
+  m_syscallNanoseconds += record.nanoseconds;
+  m_syscallCount++;
+
+  // Return values are passed in the first argument register.
+  if (record.syscall)
+    record.ret = record.syscall->getArg(RegisterFileType::GPR, 0);
+  record.bytesRead = m_syscallBytesRead;
+  record.bytesWritten = m_syscallBytesWritten;
+  record.handled = handled;
+
+  if (m_recordedSyscall) {
+    m_recordedSyscall = nullptr;
+    std::vector<VInt> values;
+    for (const auto &rf : registers) {
+      m_currentProcessor->getRegisters(rf.first, values);
+      for (unsigned i = 0; i < values.size(); ++i) {
+        if (values[i] != rf.second[i])
+          effects.registers.emplace_back(rf.first, i, values[i]);
+      }
+    }
+    effects.programBreak = m_programBreak;
+    effects.handled = handled;
+    if (m_syscallReplay == SyscallReplay::Record) {
+      m_replayedSyscalls.push_back(effects);
+      m_replayedSyscallPosition = m_replayedSyscalls.size();
+    }
+    if (recordForSeek) {
+      m_syscallLog.push_back(std::move(effects));
+      m_syscallLogPosition = m_syscallLog.size();
+    }
+  }
+  m_observers.syscall(record);
+  emit syscallExecuted(record);
+  if (!handled) {
     // Syscall handling failed, stop running processor
     setStopRunFlag();
   }
 }
 
-bool ProcessorHandler::_isRunning() { return !m_runWatcher.isFinished(); }
+void ProcessorHandler::_replaySyscall(const SyscallEffects &effects) {
+  for (const auto &reg : effects.registers)
+    m_currentProcessor->setRegister(std::get<0>(reg), std::get<1>(reg),
+                                    std::get<2>(reg));
+  for (const auto &write : effects.memory)
+    _writeMemBlock(write.first, write.second.constData(), write.second.size());
+  m_programBreak = effects.programBreak;
+  if (effects.exited)
+    m_currentProcessor->finalize(RipesProcessor::FinalizeReason::exitSyscall);
+  if (!effects.handled)
+    setStopRunFlag();
+}
+
+void ProcessorHandler::_setSyscallReplay(SyscallReplay mode,
+                                         size_t position) {
+  m_syscallReplay = mode;
+  if (mode == SyscallReplay::Replay) {
+    m_replayedSyscallPosition = std::min(position, m_replayedSyscalls.size());
+    return;
+  }
+  m_replayedSyscalls.clear();
+  m_replayedSyscallPosition = 0;
+}
+
+void ProcessorHandler::_unsupportedInstr(AInt address) {
+  // Instructions held in a stalled stage are reported once.
+  if (!m_unsupportedInstruction.isEmpty())
+    return;
+  m_unsupportedInstruction =
+      "Unsupported instruction '" + _disassembleInstr(address) +
+      "' at address 0x" + QString::number(address, 16) + ": the " +
+      ProcessorRegistry::getDescription(m_currentID).name +
+      " processor does not implement machine-mode CSRs and traps (mret, wfi "
+      "and CSR accesses other than counter reads). Select an ISS processor "
+      "to execute this program.";
+  // Without a GUI (ie. in CLI mode), the error is reported by the caller of
+  // the stopped run.
+  if (qobject_cast<QApplication *>(QCoreApplication::instance())) {
+    const QString message = m_unsupportedInstruction;
+    postToGUIThread([=] {
+      QMessageBox::warning(nullptr, "Unsupported instruction", message);
+    });
+  }
+  setStopRunFlag();
+}
+
+void ProcessorHandler::_exitProgram() {
+  m_currentProcessor->finalize(RipesProcessor::FinalizeReason::exitSyscall);
+  if (m_recordedSyscall)
+    m_recordedSyscall->exited = true;
+}
+
+bool ProcessorHandler::_isRunning() { return m_running; }
+
+void ProcessorHandler::_seekToCycle(long long cycle) {
+  _stopRun();
+  const long long currentCycle = m_currentProcessor->getCycleCount();
+  if (cycle == currentCycle)
+    return;
+
+  // Seeking is treated as a run, such that views refresh once it finishes.
+  emit runStarted();
+
+  if (cycle < currentCycle) {
+    // Everything up until the current cycle has already been observed, so
+    // its output is suppressed. Checkpoints succeeding the target are taken
+    // anew while re-executing.
+    SystemIO::setOutputMuted(true);
+    while (!m_seekCheckpoints.empty() && m_seekCheckpoints.back().cycle > cycle)
+      m_seekCheckpoints.pop_back();
+    if (m_seekCheckpoints.empty()) {
+      m_seeking = true;
+      RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+      m_seeking = false;
+    } else {
+      const SeekCheckpoint &checkpoint = m_seekCheckpoints.back();
+      m_currentProcessor->restoreSnapshot(*checkpoint.snapshot);
+      m_programBreak = checkpoint.programBreak;
+      m_syscallLogPosition = checkpoint.syscalls;
+      m_dirtyPages.markAllDirty();
+      // Views are reset as by a reset, and follow the re-execution.
+      emit processorReset();
+    }
+  }
+
+  m_running = true;
+  m_clockWorker.post([=] {
+    HostTrace::Scope traceScope("seek", "simulation");
+    auto *vsrtl_proc =
+        dynamic_cast<vsrtl::SimDesign *>(m_currentProcessor.get());
+    if (vsrtl_proc)
+      vsrtl_proc->setEnableSignals(false);
+
+    while (m_currentProcessor->getCycleCount() < cycle &&
+           !m_currentProcessor->finished() && !m_stopRunningFlag) {
+      if (m_currentProcessor->getCycleCount() >= currentCycle)
+        SystemIO::setOutputMuted(false);
+      m_currentProcessor->clock();
+      _checkpointForSeek();
+    }
+    SystemIO::setOutputMuted(false);
+
+    if (vsrtl_proc)
+      vsrtl_proc->setEnableSignals(true);
+    m_running = false;
+    QMetaObject::invokeMethod(
+        this,
+        [=] {
+          emit runFinished();
+          _markProcStateChanged();
+        },
+        Qt::QueuedConnection);
+  });
+}
+
+void ProcessorHandler::_checkpointForSeek() {
+  if (_cyclesUntilSeekCheckpoint() > 0)
+    return;
+  SeekCheckpoint checkpoint;
+  checkpoint.snapshot = m_currentProcessor->saveSnapshot();
+  if (!checkpoint.snapshot) {
+    m_seekCheckpointable = false;
+    return;
+  }
+  checkpoint.cycle = m_currentProcessor->getCycleCount();
+  checkpoint.programBreak = m_programBreak;
+  checkpoint.syscalls = m_syscallLogPosition;
+  if (m_seekCheckpoints.size() == s_seekCheckpoints)
+    m_seekCheckpoints.pop_front();
+  m_seekCheckpoints.push_back(std::move(checkpoint));
+}
+
+long long ProcessorHandler::_cyclesUntilSeekCheckpoint() const {
+  if (!m_reversible || !m_seekCheckpointable)
+    return std::numeric_limits<long long>::max();
+  const long long last =
+      m_seekCheckpoints.empty() ? 0 : m_seekCheckpoints.back().cycle;
+  return std::max(0LL, last + s_seekCheckpointInterval -
+                           m_currentProcessor->getCycleCount());
+}
+
+void ProcessorHandler::_setReversible(bool reversible) {
+  m_reversible = reversible;
+  _applyReverseStackSize();
+}
+
+void ProcessorHandler::_applyReverseStackSize() {
+  const unsigned cycles =
+      RipesSettings::value(RIPES_SETTING_REWINDSTACKSIZE).toUInt();
+  m_currentProcessor->setMaxReverseCycles(m_reversible ? cycles : 0);
+}
+
+void ProcessorHandler::_setBranchPredictor(BranchPredictor::Scheme scheme) {
+  if (scheme == m_branchPredictor)
+    return;
+  _stopRun();
+  m_branchPredictor = scheme;
+  _applyBranchPredictor();
+  _reset();
+}
+
+void ProcessorHandler::_applyBranchPredictor() {
+  BranchPredictor *predictor = m_currentProcessor->branchPredictor();
+  if (!predictor)
+    return;
+  BranchPredictor::Config config = predictor->config();
+  config.scheme = m_branchPredictor;
+  predictor->configure(config);
+}
+
+void ProcessorHandler::_setMExtTiming(
+    const RipesProcessor::MExtTiming &timing) {
+  if (timing.mulLatency == m_mextTiming.mulLatency &&
+      timing.divLatency == m_mextTiming.divLatency)
+    return;
+  _stopRun();
+  m_mextTiming = timing;
+  _applyMExtTiming();
+  _reset();
+}
+
+void ProcessorHandler::_applyMExtTiming() {
+  m_currentProcessor->setMExtTiming(m_mextTiming);
+}
+
+void ProcessorHandler::_setHartQuantum(unsigned cycles) {
+  // The quantum only affects the interleaving of subsequent cycles; the
+  // processor need not be reset.
+  _stopRun();
+  m_hartQuantum = std::max(cycles, 1u);
+  m_currentProcessor->setHartQuantum(m_hartQuantum);
+}
+
+void ProcessorHandler::_setVLEN(unsigned bits) {
+  if (bits == m_vlen)
+    return;
+  _stopRun();
+  m_vlen = bits;
+  m_currentProcessor->setVLEN(m_vlen);
+  _reset();
+}
+
+void ProcessorHandler::_setNonSerializingEcalls(bool enabled) {
+  // Only the handling of subsequent ecalls is affected; the processor need not
+  // be reset.
+  _stopRun();
+  m_nonSerializingEcalls = enabled;
+  _applyNonSerializingEcalls();
+}
+
+void ProcessorHandler::_applyNonSerializingEcalls() {
+  if (m_nonSerializingEcalls)
+    m_currentProcessor->isOutputOnlyEcall = [=](VInt id) {
+      return m_syscallManager->outputOnly(static_cast<int>(id));
+    };
+  else
+    m_currentProcessor->isOutputOnlyEcall = nullptr;
+}
+
+void ProcessorHandler::_setInstructionTrace(
+    std::shared_ptr<InstructionTrace> trace) {
+  if (trace == m_instructionTrace)
+    return;
+  _stopRun();
+  m_instructionTrace = std::move(trace);
+  _applyInstructionTrace();
+  _reset();
+}
+
+void ProcessorHandler::_applyInstructionTrace() {
+  // Pooled processors may still hold a trace which was since replaced.
+  const bool replays =
+      m_currentProcessor->features() & RipesProcessor::hasTraceReplay;
+  m_currentProcessor->setInstructionTrace(replays ? m_instructionTrace
+                                                  : nullptr);
+}
+
+ArchitecturalState
+ProcessorHandler::_captureArchitecturalState(RipesProcessor &proc) const {
+  if (!m_program) {
+    auto state = Ripes::captureArchitecturalState(proc, {});
+    state.programBreak = m_programBreak;
+    return state;
+  }
+
+  // The initial stack pointer is given by the register initializations of the
+  // processor, falling back to the defaults of the processor model.
+  RegisterInitialization regInit =
+      ProcessorRegistry::getDescription(m_currentID).defaultRegisterVals;
+  for (const auto &kv : m_currentRegInits)
+    regInit[kv.first] = kv.second;
+
+  auto state = Ripes::captureArchitecturalState(
+      proc, programMemoryRegions(proc, *m_program, regInit, m_programBreak));
+  state.programBreak = m_programBreak;
+  return state;
+}
+
+void ProcessorHandler::_applyArchitecturalState(
+    const ArchitecturalState &state) {
+  // The state does not follow from the recorded execution.
+  m_syscallLog.clear();
+  m_syscallLogPosition = 0;
+  m_seekCheckpoints.clear();
+  Ripes::applyArchitecturalState(*m_currentProcessor, state);
+  m_programBreak = state.programBreak;
+  m_dirtyPages.markAllDirty();
+  _markProcStateChanged();
+}
+
+QString ProcessorHandler::_fastForward(
+    long long instructions, bool &finished,
+    const std::function<bool(RipesProcessor &)> &onInstruction) {
+  finished = false;
+  if (!m_program)
+    return "No program loaded";
+  _stopRun();
+
+  // Construct a functional ISS implementing the same ISA as the current
+  // processor.
+  const auto *isa = _currentISA();
+  const ProcessorID issID =
+      isa->bits() == 32 ? ProcessorID::RV32_ISS : ProcessorID::RV64_ISS;
+  const QStringList &extensions = isa->enabledExtensions();
+  const auto supportedExtensions =
+      ProcessorRegistry::getDescription(issID).isaInfo().supportedExtensions;
+  for (const auto &ext : extensions) {
+    if (!supportedExtensions.contains(ext))
+      return "Fast-forwarding does not support the '" + ext + "' extension";
+  }
+
+  auto iss = ProcessorRegistry::constructProcessor(issID, extensions);
+  iss->isExecutableAddress = [=](AInt address) {
+    return _isExecutableAddress(address);
+  };
+  iss->trapHandler = [=] { syscallTrap(); };
+  iss->postConstruct();
+  auto &mem = iss->getMemory();
+  for (const auto &seg : m_program->sections) {
+    addInitializationMemory(mem, seg.second.address, seg.second.data.data(),
+                            seg.second.data.length());
+  }
+  iss->setPCInitialValue(m_program->entryPoint);
+  iss->resetProcessor();
+  // Start from the current state, which may differ from the initial program
+  // state if ie. restored from a checkpoint.
+  Ripes::applyArchitecturalState(
+      *iss, _captureArchitecturalState(*m_currentProcessor));
+
+  // System calls executed while fast-forwarding act on the current processor,
+  // so the ISS temporarily takes its place.
+  std::swap(m_currentProcessor, iss);
+  const bool batched = m_blockTranslation && !onInstruction && !m_cacheWarming;
+  while (m_currentProcessor->getInstructionsRetired() < instructions &&
+         !m_currentProcessor->finished()) {
+    if (batched) {
+      m_currentProcessor->clockBatch(
+          instructions - m_currentProcessor->getInstructionsRetired());
+      continue;
+    }
+    if (onInstruction && !onInstruction(*m_currentProcessor))
+      break;
+    m_currentProcessor->clock();
+    if (m_cacheWarming)
+      emit fastForwardClocked();
+  }
+  finished = m_currentProcessor->finished();
+  std::swap(m_currentProcessor, iss);
+
+  _applyArchitecturalState(_captureArchitecturalState(*iss));
+  return QString();
+}
 
 void ProcessorHandler::_checkProcessorFinished() {
   if (m_currentProcessor->finished())
@@ -409,7 +1450,7 @@ void ProcessorHandler::_checkProcessorFinished() {
 
 void ProcessorHandler::setStopRunFlag() {
   emit stopping();
-  if (m_runWatcher.isRunning()) {
+  if (m_running) {
     m_stopRunningFlag = true;
     // We might be currently trapping for user I/O. Signal to abort the trap, in
     // this avoiding a deadlock.
@@ -419,7 +1460,7 @@ void ProcessorHandler::setStopRunFlag() {
 
 void ProcessorHandler::_stopRun() {
   setStopRunFlag();
-  m_runWatcher.waitForFinished();
+  m_clockWorker.waitForIdle();
   m_stopRunningFlag = false;
 }
 
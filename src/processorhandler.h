@@ -3,19 +3,38 @@
 #include <QFuture>
 #include <QFutureWatcher>
 #include <QObject>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <list>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
 
-#include "VSRTL/graphics/gallantsignalwrapper.h"
 #include "assembler/assembler.h"
 #include "assembler/program.h"
+#include "breakpointcondition.h"
+#include "breakpointset.h"
+#include "coalescedsignal.h"
+#include "dirtypagetracker.h"
+#include "memorypattern.h"
+#include "processorobserver.h"
 #include "processorregistry.h"
 #include "processors/interface/ripesprocessor.h"
+#include "processorstate.h"
+#include "refreshscheduler.h"
+#include "simulationworker.h"
 #include "syscall/ripes_syscall.h"
+#include "watchpointset.h"
 
 #include "VSRTL/graphics/vsrtl_widget.h"
 
 namespace Ripes {
 
+class PagedAddressSpaceMM;
+
 /**
  * @brief The ProcessorHandler class
  * Manages construction and destruction of a VSRTL processor design, when
@@ -56,11 +75,50 @@ public:
   /// Returns a pointer to the currently instantiated ISA.
   static const ISAInfoBase *currentISA() { return get()->_currentISA(); }
 
+  /**
+   * @brief setSyscallABI
+   * Selects the system call ABI which programs are executed with (see
+   * SyscallABI), replacing the system call manager. The processor is reset.
+   */
+  static void setSyscallABI(SyscallABI abi) { get()->_setSyscallABI(abi); }
+  static SyscallABI getSyscallABI() { return get()->m_syscallABI; }
+
   /// Returns a reference to the system call manager.
   static const SyscallManager &getSyscallManager() {
     return get()->_getSyscallManager();
   }
 
+  /**
+   * @brief getProgramBreak/setProgramBreak
+   * The program break (the end of the heap) as set through the brk system
+   * call, or 0 if the program has not set it since the processor was reset.
+   * Kept by the handler rather than by the system call, such that it is part
+   * of the architectural state (see captureArchitecturalState).
+   */
+  static AInt getProgramBreak() { return get()->m_programBreak; }
+  static void setProgramBreak(AInt programBreak) {
+    get()->m_programBreak = programBreak;
+  }
+
+  /**
+   * @brief exitProgram
+   * Called by exit system calls; finalizes the current processor (see
+   * RipesProcessor::finalize), such that it finishes once the system call
+   * returns. Replays of the system call (see seekToCycle) exit as well.
+   */
+  static void exitProgram() { get()->_exitProgram(); }
+
+  /**
+   * @brief getSyscallNanoseconds
+   * Returns the accumulated host time in nanoseconds spent handling system
+   * calls, and the number of system calls handled, since the ProcessorHandler
+   * was constructed.
+   */
+  static long long getSyscallNanoseconds() {
+    return get()->m_syscallNanoseconds;
+  }
+  static unsigned long long getSyscallCount() { return get()->m_syscallCount; }
+
   /// Sets the program p as the currently instantiated program.
   static void loadProgram(const std::shared_ptr<Program> &p) {
     get()->_loadProgram(p);
@@ -83,7 +141,10 @@ public:
   /**
    * @brief selectProcessor
    * Constructs the processor identified by @param id, and performs all
-   * necessary initialization through the RipesProcessor interface.
+   * necessary initialization through the RipesProcessor interface. Processors
+   * which were previously selected with the same extensions are reused from a
+   * pool of constructed processors, rather than constructed anew (see
+   * m_processorPool).
    */
   static void selectProcessor(
       const ProcessorID &id, const QStringList &extensions = {},
@@ -129,6 +190,37 @@ public:
     return get()->_getMemory();
   }
 
+  /**
+   * @brief getDirtyPages
+   * Returns the tracker of memory pages written by the current processor, or
+   * through the ProcessorHandler. Observers may use this to only refresh
+   * modified memory.
+   */
+  static DirtyPageTracker &getDirtyPages() { return get()->m_dirtyPages; }
+
+  /**
+   * @brief memoryWritten
+   * Records that the @p bytes bytes at @p address were written other than by
+   * the current processor executing the program, ie. by a debugger or a
+   * peripheral. The pages are marked dirty, and the processor drops any
+   * instructions which it decoded from the range (see
+   * RipesProcessor::memoryWritten). Called by the memory accessors of the
+   * ProcessorHandler.
+   */
+  static void memoryWritten(AInt address, AInt bytes) {
+    get()->_memoryWritten(address, bytes);
+  }
+
+  /**
+   * @brief getRefreshScheduler
+   * Returns the scheduler pacing the refreshes of the views of the processor
+   * state. All of its clients are marked dirty whenever the processor state
+   * changes while not running; this is when procStateChangedNonRun is emitted.
+   */
+  static RefreshScheduler &getRefreshScheduler() {
+    return get()->m_refreshScheduler;
+  }
+
   /**
    * @brief setRegisterValue
    * Set the value of register @param idx to @param value.
@@ -146,6 +238,43 @@ public:
     get()->_writeMem(address, value, size);
   }
 
+  /**
+   * @brief readMemBlock/writeMemBlock
+   * Bulk transfers of @p bytes bytes between @p address of the memory of the
+   * simulator and the host buffer @p data, ie. for system calls moving
+   * buffers. The transferred bytes are accounted to the current syscall (see
+   * syscallExecuted). RAM of paged memories is copied page by page within host memory,
+   * rather than byte by byte.
+   */
+  static void readMemBlock(AInt address, char *data, AInt bytes) {
+    get()->_readMemBlock(address, data, bytes);
+  }
+  static void writeMemBlock(AInt address, const char *data, AInt bytes) {
+    get()->_writeMemBlock(address, data, bytes);
+  }
+  /// Returns the null-terminated string at @p address, excluding the
+  /// terminator.
+  static QByteArray readString(AInt address) {
+    return get()->_readString(address);
+  }
+
+  /**
+   * @brief findMem
+   * Returns the lowest address within [@p start, @p end) at which @p pattern
+   * occurs in the memory of the simulator, if any. The sections of the program
+   * and the memory accessed since the processor was reset are searched; any
+   * other memory is not. RAM of paged memories is searched page by page within
+   * host memory.
+   */
+  static std::optional<AInt> findMem(AInt start, AInt end,
+                                     const MemoryPattern &pattern) {
+    return get()->_findMem(start, end, pattern);
+  }
+  /// Writes repetitions of @p pattern to the @p bytes bytes at @p address.
+  static void fillMem(AInt address, AInt bytes, const QByteArray &pattern) {
+    get()->_fillMem(address, bytes, pattern);
+  }
+
   /**
    * @brief getRegisterValue
    * @returns value of register @param idx
@@ -154,6 +283,24 @@ public:
     return get()->_getRegisterValue(rfid, idx);
   }
 
+  /**
+   * @brief getRegisterValues
+   * Sets @param values to the value of each register of @param rfid.
+   */
+  static void getRegisterValues(RegisterFileType rfid,
+                                std::vector<VInt> &values) {
+    get()->m_currentProcessor->getRegisters(rfid, values);
+  }
+
+  /**
+   * @brief getRegisterView
+   * @returns a view of the value of each register of @param rfid, valid until
+   * the processor is next clocked, reset or written (see RegisterView).
+   */
+  static RegisterView getRegisterView(RegisterFileType rfid) {
+    return get()->m_currentProcessor->registers(rfid);
+  }
+
   /// Returns true if the processor is currently at a breakpoint. This is done
   /// through comparing the breakpoint-triggering stages of the current
   /// processor, fetching the PC of those stages, and comparing them against the
@@ -178,6 +325,44 @@ public:
   /// Removes all currently set breakpoints.
   static void clearBreakpoints() { get()->_clearBreakpoints(); }
 
+  /**
+   * @brief setBreakpointCondition
+   * Sets a breakpoint at @p address which triggers only if @p condition holds,
+   * from the @p hitCount'th time that it is hit (see BreakpointCondition). An
+   * empty condition and a hit count of at most 1 make the breakpoint
+   * unconditional. Returns an error message if the address is not executable
+   * or the condition does not compile. Hit counts restart upon reset.
+   */
+  static QString setBreakpointCondition(AInt address, const QString &condition,
+                                        unsigned hitCount = 0) {
+    return get()->_setBreakpointCondition(address, condition, hitCount);
+  }
+  /// Returns the condition of the breakpoint at @p address, if conditional.
+  static const BreakpointCondition *getBreakpointCondition(AInt address) {
+    return get()->_getBreakpointCondition(address);
+  }
+
+  /**
+   * @brief addWatchpoint/clearWatchpoints
+   * Adds or removes data watchpoints. Runs and multi-cycle clock requests stop
+   * after the cycle in which a data access of the processor triggers a
+   * watchpoint; see watchpointHit(). Given a paged address space, only cycles
+   * accessing a watched page are checked. Must not be called while the
+   * processor is running.
+   */
+  static void addWatchpoint(const Watchpoint &watchpoint) {
+    get()->_addWatchpoint(watchpoint);
+  }
+  static void clearWatchpoints() { get()->_clearWatchpoints(); }
+  static const std::vector<Watchpoint> &getWatchpoints() {
+    return get()->m_watchpoints.watchpoints();
+  }
+  /// Returns the access which triggered a watchpoint in the most recent run or
+  /// clock request, if any.
+  static std::optional<MemoryAccess> watchpointHit() {
+    return get()->m_watchpointHit;
+  }
+
   /// Trigger a processor finished check. This inspect the current processor run
   /// state, and if finished, emit a finish signal.
   static void checkProcessorFinished() { get()->_checkProcessorFinished(); }
@@ -185,6 +370,132 @@ public:
   /// Returns true if the simulator is currently in "run" mode.
   static bool isRunning() { return get()->_isRunning(); }
 
+  /**
+   * @brief setReversible
+   * Selects whether the simulator records the state required for reversing
+   * clock cycles. When disabled (i.e., for CLI and batch runs), the processor
+   * reverse stacks are sized to 0 and the cache simulators skip recording
+   * their undo traces, removing all undo bookkeeping from the clock path.
+   */
+  static void setReversible(bool reversible) {
+    get()->_setReversible(reversible);
+  }
+  /// Returns true if the simulator records state for reversing clock cycles.
+  static bool isReversible() { return get()->m_reversible; }
+
+  /**
+   * @brief setVirtualClock
+   * Sets the simulated clock frequency of the processor, in Hz. If non-zero,
+   * time as seen by the program (ie. the Time_msec syscall) is virtual: it is
+   * derived from the cycle count at this frequency, counting from the epoch at
+   * cycle 0, such that it does not depend on the speed or load of the host.
+   * This is the rate at which the mtime register of timer peripherals, which
+   * counts cycles, advances. If zero, the wall clock of the host is used.
+   */
+  static void setVirtualClock(uint64_t hz) { get()->m_virtualClockHz = hz; }
+  static uint64_t getVirtualClock() { return get()->m_virtualClockHz; }
+
+  /**
+   * @brief setRunPace
+   * Sets the simulated clock frequency, in Hz, which runs (see run()) are
+   * paced to. If non-zero, cycles are executed in batches, in between which
+   * the simulation thread sleeps such that the processor advances at this
+   * rate of wall clock time, ie. for peripherals to animate at a predictable
+   * speed. If zero, runs execute as fast as possible.
+   */
+  static void setRunPace(uint64_t hz) { get()->m_runPaceHz = hz; }
+  static uint64_t getRunPace() { return get()->m_runPaceHz; }
+  /// Returns the clock frequency, in Hz, achieved by the current or most
+  /// recent paced run.
+  static double achievedRunPace() { return get()->m_achievedRunPace; }
+
+  /**
+   * @brief requestRunFrame
+   * Requests a frame of the processor state during a run. Upon the next batch
+   * of cycles, the run pauses and runFrame is emitted in the GUI thread. The
+   * simulation proceeds once the frame is presented, such that views may
+   * update at a rate of their own while the processor is running.
+   */
+  static void requestRunFrame() { get()->m_runFrameRequested = true; }
+
+  /**
+   * @brief setBranchPredictor
+   * Selects the branch prediction scheme of processors implementing branch
+   * prediction (see RipesProcessor::branchPredictor). The selection is kept
+   * across processor changes. The processor is reset.
+   */
+  static void setBranchPredictor(BranchPredictor::Scheme scheme) {
+    get()->_setBranchPredictor(scheme);
+  }
+  static BranchPredictor::Scheme getBranchPredictor() {
+    return get()->m_branchPredictor;
+  }
+
+  /**
+   * @brief setMExtTiming
+   * Sets the latencies of the M-extension units of processors modelling them
+   * (see RipesProcessor::setMExtTiming). The latencies are kept across
+   * processor changes. The processor is reset.
+   */
+  static void setMExtTiming(const RipesProcessor::MExtTiming &timing) {
+    get()->_setMExtTiming(timing);
+  }
+  static const RipesProcessor::MExtTiming &getMExtTiming() {
+    return get()->m_mextTiming;
+  }
+
+  /**
+   * @brief setHartQuantum
+   * Sets the synchronization quantum of processors with multiple harts (see
+   * RipesProcessor::setHartQuantum). The quantum is kept across processor
+   * changes.
+   */
+  static void setHartQuantum(unsigned cycles) {
+    get()->_setHartQuantum(cycles);
+  }
+  static unsigned getHartQuantum() { return get()->m_hartQuantum; }
+
+  /**
+   * @brief setVLEN
+   * Sets the width in bits of the vector registers of processors implementing
+   * the V extension (see RipesProcessor::setVLEN). The width is kept across
+   * processor changes. The processor is reset.
+   */
+  static void setVLEN(unsigned bits) { get()->_setVLEN(bits); }
+  static unsigned getVLEN() { return get()->m_vlen; }
+
+  /**
+   * @brief setNonSerializingEcalls
+   * If set, the pipelined processors do not drain their outstanding register
+   * writes before handling ecalls of output-only syscalls (see
+   * RipesProcessor::isOutputOnlyEcall). The setting is kept across processor
+   * changes.
+   */
+  static void setNonSerializingEcalls(bool enabled) {
+    get()->_setNonSerializingEcalls(enabled);
+  }
+  static bool getNonSerializingEcalls() {
+    return get()->m_nonSerializingEcalls;
+  }
+
+  /**
+   * @brief setInstructionTrace
+   * Replays @p trace on processors implementing trace replay (see
+   * RipesProcessor::setInstructionTrace), in place of executing the loaded
+   * program. The trace is kept across processor changes; a null trace returns
+   * to executing the program. The processor is reset.
+   */
+  static void setInstructionTrace(std::shared_ptr<InstructionTrace> trace) {
+    get()->_setInstructionTrace(std::move(trace));
+  }
+  /// Returns the time in nanoseconds (or milliseconds) since epoch as seen by
+  /// the program; see setVirtualClock.
+  static long long currentTimeNs();
+  static long long currentTimeMs() { return currentTimeNs() / 1000000; }
+  /// Returns the time in nanoseconds elapsed since the processor was reset, as
+  /// seen by the program; see setVirtualClock.
+  static long long elapsedTimeNs();
+
   /**
    * @brief run
    * Asynchronously runs the current processor. During this, the processor will
@@ -194,7 +505,61 @@ public:
    */
   static void run() { get()->_run(); }
 
-  static void clock() { get()->_clock(); }
+  /**
+   * @brief setRunLimits
+   * Bounds subsequent runs to @p maxCycles clock cycles and @p maxInstructions
+   * retired instructions of the current processor, counted from its reset. A
+   * limit of 0 is unbounded. The limits are checked per batch of cycles, with
+   * batches shrinking as a limit nears, such that the cycle limit is met
+   * exactly and the instruction limit is overshot by at most the number of
+   * instructions retiring in a single cycle. A run which reaches a limit
+   * stops as if stopped through stopRun(); see runLimitReached().
+   */
+  static void setRunLimits(long long maxCycles, long long maxInstructions) {
+    get()->m_maxCycles = maxCycles;
+    get()->m_maxInstructions = maxInstructions;
+  }
+  /// Returns true if the most recent run stopped upon reaching a run limit.
+  static bool runLimitReached() { return get()->m_runLimitReached; }
+
+  /**
+   * @brief unsupportedInstruction
+   * Returns a description of the instruction which the current processor
+   * decoded, but does not implement, since the processor was last reset; or
+   * an empty string. Executing such an instruction stops the simulation.
+   */
+  static QString unsupportedInstruction() {
+    return get()->m_unsupportedInstruction;
+  }
+
+  /**
+   * @brief clock
+   * Clocks the processor @param cycles times on the simulation thread, or
+   * until reaching a breakpoint or finishing. Views are refreshed once all
+   * cycles have been clocked. The request is dropped if a previous request
+   * has not yet started.
+   */
+  static void clock(unsigned cycles = 1) { get()->_clock(cycles); }
+
+  /**
+   * @brief waitForIdle
+   * Blocks until all clock requests and runs have been executed by the
+   * simulation thread.
+   */
+  static void waitForIdle() { get()->m_clockWorker.waitForIdle(); }
+
+  /**
+   * @brief attachObserver/detachObserver
+   * Attaches @p observer to, or detaches it from, the execution of the current
+   * and any subsequently selected processor (see ProcessorObserver). Must not
+   * be called while the processor is running.
+   */
+  static void attachObserver(ProcessorObserver *observer) {
+    get()->_attachObserver(observer);
+  }
+  static void detachObserver(ProcessorObserver *observer) {
+    get()->_detachObserver(observer);
+  }
 
   /**
    * @brief stopRun
@@ -203,6 +568,128 @@ public:
    */
   static void stopRun() { get()->_stopRun(); }
 
+  /**
+   * @brief seekToCycle
+   * Moves the current processor to the state it had (or will have) at
+   * @p cycle. Seeking backwards is performed by returning the processor to the
+   * latest checkpoint preceding @p cycle, and deterministically re-executing
+   * the program up to @p cycle with signals disabled. This provides reverse
+   * execution beyond the depth of the reverse stack.
+   *
+   * While reversible (see setReversible), the processor is checkpointed every
+   * s_seekCheckpointInterval cycles, keeping the latest s_seekCheckpoints
+   * checkpoints. Processors which cannot be checkpointed (see
+   * RipesProcessor::saveSnapshot), and seeks preceding the oldest checkpoint,
+   * re-execute from reset. The effects of system calls on the registers, the
+   * memory and the program break are recorded as well, and re-executed system
+   * calls are replaced by their recorded effects, such that replays neither
+   * block on input nor repeat output. A replay which diverges from the
+   * recording (ie. after the state was modified) executes system calls anew,
+   * with console output suppressed up until the cycle the seek started from.
+   * State outside of the processor, such as files opened by the program, is
+   * not restored.
+   *
+   * Like a run, the seek is executed by the simulation worker, and is
+   * bracketed by runStarted and runFinished.
+   */
+  static void seekToCycle(long long cycle) { get()->_seekToCycle(cycle); }
+
+  /**
+   * @brief The SyscallReplay enum
+   * Modes of setSyscallReplay.
+   */
+  enum class SyscallReplay { Off, Record, Replay };
+
+  /**
+   * @brief setSyscallReplay
+   * Records or replays system calls by their order, for re-executing parts of
+   * an execution on processors whose cycles differ from those of the recorded
+   * execution, ie. the passes of a sampled simulation (see runSimPoints). While
+   * recording, the effects of each executed system call are recorded as for
+   * seekToCycle, whether or not the simulator is reversible. While replaying,
+   * system calls are replaced by the recorded effects in order, starting from
+   * the @p position'th recorded system call, such that replays neither read
+   * input again nor repeat output. A system call which differs from the
+   * recording ends the replay, and is executed anew. Off discards the
+   * recording.
+   */
+  static void setSyscallReplay(SyscallReplay mode, size_t position = 0) {
+    get()->_setSyscallReplay(mode, position);
+  }
+  /// Returns the number of system calls recorded, or replayed, so far.
+  static size_t syscallReplayPosition() {
+    return get()->m_replayedSyscallPosition;
+  }
+
+  /**
+   * @brief captureArchitecturalState
+   * @returns the architectural state of the current processor, including the
+   * memory regions of the currently loaded program, the heap and the stack,
+   * and the program break.
+   */
+  static ArchitecturalState captureArchitecturalState() {
+    return get()->_captureArchitecturalState(*get()->m_currentProcessor);
+  }
+
+  /**
+   * @brief applyArchitecturalState
+   * Applies @p state to the current processor.
+   */
+  static void applyArchitecturalState(const ArchitecturalState &state) {
+    get()->_applyArchitecturalState(state);
+  }
+
+  /**
+   * @brief transferArchitecturalState
+   * Copies the registers, PC and program memory of @p from into @p to. Both
+   * processors must implement the same ISA.
+   */
+  static void transferArchitecturalState(RipesProcessor &from,
+                                         RipesProcessor &to) {
+    Q_ASSERT(from.implementsISA()->isaID() == to.implementsISA()->isaID());
+    Ripes::applyArchitecturalState(to,
+                                   get()->_captureArchitecturalState(from));
+  }
+
+  /**
+   * @brief fastForward
+   * Executes up to @p instructions instructions of the currently loaded
+   * program on a functional instruction set simulator, after which the
+   * architectural state is transferred to the current processor, from where
+   * execution may continue in detail. Sets @p finished if the program finished
+   * during fast-forwarding. If provided, @p onInstruction is called with the
+   * functional ISS before each instruction is executed, and fast-forwarding
+   * stops before the instruction if it returns false; while fast-forwarding
+   * the ISS acts as the current processor. Returns an error message on
+   * failure, or an empty string on success.
+   */
+  static QString
+  fastForward(long long instructions, bool &finished,
+              const std::function<bool(RipesProcessor &)> &onInstruction = {}) {
+    return get()->_fastForward(instructions, finished, onInstruction);
+  }
+  /**
+   * @brief setCacheWarming
+   * Selects whether the memory accesses of fast-forwarded instructions warm
+   * the cache hierarchy (see CacheInterface::warm), such that its state
+   * reflects the fast-forwarded execution once detailed simulation starts.
+   */
+  static void setCacheWarming(bool enabled) { get()->m_cacheWarming = enabled; }
+  static bool getCacheWarming() { return get()->m_cacheWarming; }
+
+  /**
+   * @brief setBlockTranslation
+   * Selects whether runs and fast-forwarding clock the processor in batches
+   * (see RipesProcessor::clockBatch), which the functional ISS executes as
+   * translated basic blocks. Batches are only clocked while no breakpoints or
+   * watchpoints are set, and while fast-forwarding without a callback per
+   * instruction or cache warming.
+   */
+  static void setBlockTranslation(bool enabled) {
+    get()->m_blockTranslation = enabled;
+  }
+  static bool getBlockTranslation() { return get()->m_blockTranslation; }
+
 signals:
 
   /**
@@ -232,6 +719,14 @@ signals:
   void runStarted();
   void runFinished();
 
+  /**
+   * @brief runFrame
+   * Emitted in the GUI thread while a run is paused for a frame requested
+   * through requestRunFrame(). The processor state may be read, but not
+   * modified, until the slots return.
+   */
+  void runFrame();
+
   /**
    * @brief Various signals wrapping around the direct VSRTL model emission
    * signals. This is done to avoid relying component to having to reconnect to
@@ -244,6 +739,21 @@ signals:
   // cycle. Remember to use Qt::DirectConnection for the slot to be executed
   // directly, instead of concurrently in the event loop.
   void processorClocked();
+
+  /**
+   * @brief syscallExecuted
+   * Emitted from the simulation thread once a system call was handled. As
+   * with processorClocked, connect using Qt::DirectConnection.
+   */
+  void syscallExecuted(const Ripes::SyscallRecord &record);
+  /**
+   * @brief fastForwardClocked
+   * Emitted from the simulation thread for each instruction executed while
+   * fast-forwarding with cache warming enabled (see setCacheWarming), with the
+   * functional ISS as the current processor. Connect using
+   * Qt::DirectConnection.
+   */
+  void fastForwardClocked();
   void processorClockedNonRun(); // Only emitted when _not_ running; i.e., for
                                  // GUI updating
   void procStateChangedNonRun(); // processorReset | processorReversed |
@@ -252,9 +762,11 @@ signals:
 private slots:
   /**
    * @brief syscallTrap
-   * Connects to the processors system call request interface. Will concurrently
-   * run the systemcall manager to handle the requested functionality, and
-   * return once the system call was handled.
+   * Connects to the processors system call request interface. Runs the
+   * systemcall manager to handle the requested functionality, and returns once
+   * the system call was handled. Non-blocking system calls run on the calling
+   * (simulation) thread; system calls which may block on console input run
+   * concurrently.
    */
   void syscallTrap();
 
@@ -276,11 +788,18 @@ private:
     return m_currentProcessor->implementsISA();
   }
   const SyscallManager &_getSyscallManager() const { return *m_syscallManager; }
+  void _setSyscallABI(SyscallABI abi);
   void _loadProcessorToWidget(vsrtl::VSRTLWidget *widget,
                               bool doPlaceAndRoute = false);
   void _selectProcessor(
       const ProcessorID &id, const QStringList &extensions = {},
       const RegisterInitialization &setup = RegisterInitialization());
+  /// Moves the current processor into the processor pool.
+  void _poolCurrentProcessor();
+  /// Takes the processor of @p id and @p extensions from the processor pool,
+  /// or returns nullptr if it is not pooled.
+  std::unique_ptr<RipesProcessor>
+  _takePooledProcessor(const ProcessorID &id, const QStringList &extensions);
   bool _isExecutableAddress(AInt address) const;
   int _getCurrentProgramSize() const;
   AInt _getTextStart() const;
@@ -289,19 +808,77 @@ private:
   const vsrtl::core::AddressSpace &_getRegisters() const;
   void _setRegisterValue(RegisterFileType rfid, const unsigned idx, VInt value);
   void _writeMem(AInt address, VInt value, int size = sizeof(VInt));
+  void _memoryWritten(AInt address, AInt bytes);
+  void _readMemBlock(AInt address, char *data, AInt bytes);
+  void _writeMemBlock(AInt address, const char *data, AInt bytes);
+  QByteArray _readString(AInt address);
+  std::optional<AInt> _findMem(AInt start, AInt end,
+                               const MemoryPattern &pattern);
+  void _fillMem(AInt address, AInt bytes, const QByteArray &pattern);
   VInt _getRegisterValue(RegisterFileType rfid, const unsigned idx) const;
   bool _checkBreakpoint();
+  bool _checkWatchpoint();
+  void _addWatchpoint(const Watchpoint &watchpoint);
+  void _clearWatchpoints();
+  void _applyWatchpoints();
   void _setBreakpoint(const AInt address, bool enabled);
   void _toggleBreakpoint(const AInt address);
   bool _hasBreakpoint(const AInt address) const;
   void _clearBreakpoints();
+  QString _setBreakpointCondition(AInt address, const QString &condition,
+                                  unsigned hitCount);
+  const BreakpointCondition *_getBreakpointCondition(AInt address) const;
+  void _seekToCycle(long long cycle);
+  /// Checkpoints the current processor for seekToCycle, if due.
+  void _checkpointForSeek();
+  /// Returns the number of cycles until the next checkpoint for seekToCycle is
+  /// due.
+  long long _cyclesUntilSeekCheckpoint() const;
+  void _exitProgram();
+  /// Reports the unsupported instruction at @p address, and stops running.
+  void _unsupportedInstr(AInt address);
+  struct SyscallEffects;
+  /// Applies the recorded @p effects of a system call, in place of executing
+  /// it.
+  void _replaySyscall(const SyscallEffects &effects);
+  void _setSyscallReplay(SyscallReplay mode, size_t position);
+  void _setReversible(bool reversible);
+  void _applyReverseStackSize();
+  void _setBranchPredictor(BranchPredictor::Scheme scheme);
+  void _applyBranchPredictor();
+  void _setMExtTiming(const RipesProcessor::MExtTiming &timing);
+  void _applyMExtTiming();
+  void _setHartQuantum(unsigned cycles);
+  void _setVLEN(unsigned bits);
+  void _setNonSerializingEcalls(bool enabled);
+  void _applyNonSerializingEcalls();
+  void _setInstructionTrace(std::shared_ptr<InstructionTrace> trace);
+  void _applyInstructionTrace();
+  void _trackMemoryWrites();
+  void _attachObserver(ProcessorObserver *observer);
+  void _detachObserver(ProcessorObserver *observer);
+  void _connectObservers(bool connect);
+  void _notifyObservers();
+  ArchitecturalState _captureArchitecturalState(RipesProcessor &proc) const;
+  void _applyArchitecturalState(const ArchitecturalState &state);
+  QString
+  _fastForward(long long instructions, bool &finished,
+               const std::function<bool(RipesProcessor &)> &onInstruction);
   void _checkProcessorFinished();
   bool _isRunning();
   void _run();
-  void _clock();
+  long long _cyclesUntilRunLimit() const;
+  /// Sleeps until the wall clock time of @p cycles at @p hz has elapsed since
+  /// @p timer was started, or the run is stopped.
+  void _pace(const QElapsedTimer &timer, long long cycles, uint64_t hz);
+  /// Pauses the run until runFrame has been emitted in the GUI thread, or the
+  /// run is stopped.
+  void _runFrame();
+  void _clock(unsigned cycles);
+  void _clockCycles(unsigned cycles);
   void _reset();
   void _stopRun();
-  void _triggerProcStateChangeTimer();
+  void _markProcStateChanged();
 
   void createAssemblerForCurrentISA();
   void setStopRunFlag();
@@ -310,10 +887,110 @@ private:
   // Flag used during construction to avoid calling ProcessorHandler::get() to
   // retrieve the singleton while it is being constructed.
   bool m_constructing = false;
+
+  // Whether undo state is recorded while clocking the processor.
+  bool m_reversible = true;
+  DirtyPageTracker m_dirtyPages;
+  ProcessorObservers m_observers;
   ProcessorID m_currentID;
   RegisterInitialization m_currentRegInits;
+  QStringList m_currentExtensions;
   std::unique_ptr<RipesProcessor> m_currentProcessor;
+  // Whether the current processor is the design of m_vsrtlWidget.
+  bool m_processorInWidget = false;
+
+  /**
+   * @brief m_processorPool
+   * Previously selected processors, most recently selected first, which have
+   * been constructed and initialized (postConstruct) already. Selecting a
+   * pooled processor resets and reuses it. Processors which have been loaded
+   * into the VSRTL widget are not pooled, since their graphics are owned by
+   * the widget.
+   */
+  struct PooledProcessor {
+    ProcessorID id;
+    QStringList extensions;
+    std::unique_ptr<RipesProcessor> processor;
+  };
+  std::list<PooledProcessor> m_processorPool;
+  static constexpr unsigned s_processorPoolSize = 8;
   std::unique_ptr<SyscallManager> m_syscallManager;
+  SyscallABI m_syscallABI = SyscallABI::RARS;
+  AInt m_programBreak = 0;
+  // Updated from the simulation thread while running.
+  std::atomic<long long> m_syscallNanoseconds{0};
+  std::atomic<unsigned long long> m_syscallCount{0};
+  // Bytes transferred by the block memory accessors during the current
+  // syscall; see syscallTrap.
+  unsigned long long m_syscallBytesRead = 0;
+  unsigned long long m_syscallBytesWritten = 0;
+
+  /**
+   * @brief The SyscallEffects struct
+   * The effects of a system call executed at @p cycle, recorded for replays of
+   * the cycle (see seekToCycle).
+   */
+  struct SyscallEffects {
+    long long cycle = 0;
+    unsigned id = 0;
+    // The registers modified by the system call, and their new values.
+    std::vector<std::tuple<RegisterFileType, unsigned, VInt>> registers;
+    // The memory written by the system call, by address.
+    std::vector<std::pair<AInt, QByteArray>> memory;
+    AInt programBreak = 0;
+    bool handled = true;
+    bool exited = false;
+  };
+  // The system calls executed since the processor was reset, in order, and the
+  // number of them executed by the current execution. System calls beyond the
+  // first s_syscallLogSize are not recorded.
+  static constexpr size_t s_syscallLogSize = 1 << 16;
+  std::vector<SyscallEffects> m_syscallLog;
+  size_t m_syscallLogPosition = 0;
+  // The system calls recorded for in-order replays (see setSyscallReplay),
+  // and the number of them recorded or replayed so far.
+  SyscallReplay m_syscallReplay = SyscallReplay::Off;
+  std::vector<SyscallEffects> m_replayedSyscalls;
+  size_t m_replayedSyscallPosition = 0;
+  // The effects of the executing system call, while recorded.
+  SyscallEffects *m_recordedSyscall = nullptr;
+  // The record of the executing system call, while executing.
+  SyscallRecord *m_executingSyscall = nullptr;
+
+  // A checkpoint of the current processor at some cycle, for seekToCycle.
+  struct SeekCheckpoint {
+    long long cycle;
+    std::shared_ptr<const RipesProcessor::Snapshot> snapshot;
+    AInt programBreak;
+    // The position in m_syscallLog.
+    size_t syscalls;
+  };
+  static constexpr long long s_seekCheckpointInterval = 100000;
+  static constexpr unsigned s_seekCheckpoints = 32;
+  std::deque<SeekCheckpoint> m_seekCheckpoints;
+  // Whether the current processor can be checkpointed.
+  bool m_seekCheckpointable = true;
+  // Set while the processor is reset for a seek, such that the recordings of
+  // the execution are kept.
+  bool m_seeking = false;
+  std::atomic<uint64_t> m_virtualClockHz{0};
+  std::atomic<uint64_t> m_runPaceHz{0};
+  std::atomic<double> m_achievedRunPace{0};
+  std::atomic<bool> m_runFrameRequested{false};
+  // Set by the simulation worker while it waits for a frame to be presented.
+  bool m_runFramePending = false;
+  std::mutex m_runFrameLock;
+  std::condition_variable m_runFramePresented;
+  BranchPredictor::Scheme m_branchPredictor = BranchPredictor::Scheme::NotTaken;
+  RipesProcessor::MExtTiming m_mextTiming;
+  std::shared_ptr<InstructionTrace> m_instructionTrace;
+  unsigned m_hartQuantum = 1;
+  unsigned m_vlen = 128;
+  bool m_nonSerializingEcalls = false;
+  bool m_cacheWarming = false;
+  bool m_blockTranslation = true;
+  // Restarted whenever the processor is reset; see elapsedTimeNs.
+  QElapsedTimer m_resetTimer;
   std::shared_ptr<Assembler::AssemblerBase> m_currentAssembler;
 
   /**
@@ -322,22 +999,43 @@ private:
    */
   vsrtl::VSRTLWidget *m_vsrtlWidget = nullptr;
 
-  std::set<AInt> m_breakpoints;
+  BreakpointSet m_breakpoints;
+  // Breakpoint-triggering stages of the current processor.
+  std::vector<StageIndex> m_breakpointStages;
+  // Conditions of the conditional breakpoints, by address; only consulted
+  // once the PC of a stage matches a breakpoint.
+  std::unordered_map<AInt, BreakpointCondition> m_breakpointConditions;
+  WatchpointSet m_watchpoints;
+  // The memory of the current processor, if paged, which filters the cycles
+  // checked against the watchpoints.
+  PagedAddressSpaceMM *m_watchedMemory = nullptr;
+  std::optional<MemoryAccess> m_watchpointHit;
   std::shared_ptr<Program> m_program;
 
-  QFutureWatcher<void> m_runWatcher;
-  bool m_stopRunningFlag = false;
-  bool m_clockFinished = true;
+  // Set from the GUI thread and read by the simulation worker.
+  std::atomic<bool> m_running{false};
+  std::atomic<bool> m_stopRunningFlag{false};
+  long long m_maxCycles = 0;
+  long long m_maxInstructions = 0;
+  std::atomic<bool> m_runLimitReached{false};
+  QString m_unsupportedInstruction;
+
+  /**
+   * @brief m_clockWorker
+   * The simulation thread, executing clock requests and runs. Declared after
+   * the processor, such that it is stopped before the processor is destroyed.
+   */
+  SimulationWorker m_clockWorker;
+  // Number of pending processor clock signals which are not to refresh views,
+  // being emitted by the cycles of a multi-cycle clock request.
+  std::atomic<long long> m_suppressedClockSignals{0};
 
   /**
    * @brief To avoid excessive UI updates due to things relying on
-   * procStateChangedNonRun, the m_procStateChangeTimer ensures that the signal
-   * is only emitted with some max. frequency. New state change signals can be
-   * enqueued by atomically setting the m_enqueueStateChangeSignal.
+   * procStateChangedNonRun, the signal is emitted by a client of
+   * m_refreshScheduler, such that it is emitted at most once per frame.
    */
-  QTimer m_procStateChangeTimer;
-  bool m_enqueueStateChangeSignal;
-  std::mutex m_enqueueStateChangeLock;
+  RefreshScheduler m_refreshScheduler;
 
   /**
    * @brief m_sem
@@ -345,7 +1043,6 @@ private:
    * the execution environment.
    */
   QSemaphore m_sem;
-  std::vector<std::unique_ptr<vsrtl::GallantSignalWrapperBase>>
-      m_signalWrappers;
+  std::vector<std::unique_ptr<CoalescedSignal>> m_signalWrappers;
 };
 } // namespace Ripes
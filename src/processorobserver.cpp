@@ -0,0 +1,80 @@
+#include "processorobserver.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+void ProcessorObservers::attach(ProcessorObserver *observer) {
+  const unsigned events = observer->events();
+  if (events & ProcessorObserver::Retire)
+    m_retire.push_back(observer);
+  if (events & ProcessorObserver::MemAccess)
+    m_memAccess.push_back(observer);
+  if (events & ProcessorObserver::StageUpdate)
+    m_stageUpdate.push_back(observer);
+  if (events & ProcessorObserver::Cycle)
+    m_cycle.push_back(observer);
+  if (events & ProcessorObserver::Syscall)
+    m_syscall.push_back(observer);
+}
+
+void ProcessorObservers::detach(ProcessorObserver *observer) {
+  for (auto *list :
+       {&m_retire, &m_memAccess, &m_stageUpdate, &m_cycle, &m_syscall})
+    list->erase(std::remove(list->begin(), list->end(), observer),
+                list->end());
+}
+
+void ProcessorObservers::cycle(const RipesProcessor &proc) {
+  if (!m_retire.empty()) {
+    // Reversal and reset decrease the retirement count; only increases
+    // are dispatched.
+    const long long retired = proc.getInstructionsRetired();
+    if (retired > m_retired) {
+      for (auto *observer : m_retire)
+        observer->onRetire(proc, static_cast<unsigned>(retired - m_retired));
+    }
+    m_retired = retired;
+  }
+
+  if (!m_memAccess.empty() && !proc.isStalled()) {
+    const MemoryAccess instrAccess = proc.instrMemAccess();
+    const MemoryAccess dataAccess = proc.dataMemAccess();
+    for (auto *observer : m_memAccess) {
+      if (instrAccess.type != MemoryAccess::None)
+        observer->onMemAccess(proc, instrAccess, false);
+      if (dataAccess.type != MemoryAccess::None)
+        observer->onMemAccess(proc, dataAccess, true);
+    }
+  }
+
+  if (!m_stageUpdate.empty()) {
+    m_stageInfos.resize(proc.structure().numStages());
+    proc.stageInfos(m_stageInfos.data());
+    const StageInfo *info = m_stageInfos.data();
+    for (auto stage : proc.structure().stageIt()) {
+      for (auto *observer : m_stageUpdate)
+        observer->onStageUpdate(proc, stage, *info);
+      ++info;
+    }
+  }
+
+  for (auto *observer : m_cycle)
+    observer->onCycle(proc);
+}
+
+QString ObserverPlugin::load(const QString &path) {
+  m_library.setFileName(path);
+  if (!m_library.load())
+    return "Error: Could not load plugin " + path + ": " +
+           m_library.errorString();
+  using CreateObserver = ProcessorObserver *(*)();
+  auto create = reinterpret_cast<CreateObserver>(
+      m_library.resolve("ripesCreateObserver"));
+  if (!create)
+    return "Error: Plugin " + path + " does not define an observer";
+  m_observer.reset(create());
+  return QString();
+}
+
+} // namespace Ripes
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <QLibrary>
+#include <memory>
+#include <vector>
+
+#include "processors/interface/ripesprocessor.h"
+#include "syscall/ripes_syscall.h"
+
+#if defined(_WIN32)
+#define RIPES_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define RIPES_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+/// Defines the entry point of an observer plugin (see ObserverPlugin), which
+/// constructs an observer of type @p Type.
+#define RIPES_OBSERVER_PLUGIN(Type)                                            \
+  extern "C" RIPES_PLUGIN_EXPORT Ripes::ProcessorObserver *                    \
+  ripesCreateObserver() {                                                      \
+    return new Type();                                                         \
+  }
+
+namespace Ripes {
+
+/**
+ * @brief The ProcessorObserver class
+ * A typed observer of the execution of the current processor, for analyses
+ * which must see every cycle (see ProcessorHandler::attachObserver). Events are
+ * dispatched on the simulation thread, after each clock cycle and system call,
+ * to the observers subscribing to them (see events()). Events without
+ * subscribers are not computed; with no observers attached, the processor is
+ * not observed at all.
+ */
+class ProcessorObserver {
+public:
+  enum Event : unsigned {
+    Retire = 0b0001,
+    MemAccess = 0b0010,
+    StageUpdate = 0b0100,
+    Syscall = 0b1000,
+    Cycle = 0b10000
+  };
+
+  virtual ~ProcessorObserver() = default;
+
+  /// The events to which this observer subscribes, as a mask of Event; read
+  /// once, when the observer is attached.
+  virtual unsigned events() const = 0;
+
+  /// Called after a cycle in which @p count instructions retired.
+  virtual void onRetire(const RipesProcessor &proc, unsigned count) {
+    Q_UNUSED(proc);
+    Q_UNUSED(count);
+  }
+  /// Called for the instruction and the data access of each cycle, if any.
+  /// The accesses of memory stall cycles were performed, and dispatched, in
+  /// the cycle which initiated the stall.
+  virtual void onMemAccess(const RipesProcessor &proc,
+                           const MemoryAccess &access, bool data) {
+    Q_UNUSED(proc);
+    Q_UNUSED(access);
+    Q_UNUSED(data);
+  }
+  /// Called for each stage of the processor after each cycle.
+  virtual void onStageUpdate(const RipesProcessor &proc, StageIndex stage,
+                             const StageInfo &info) {
+    Q_UNUSED(proc);
+    Q_UNUSED(stage);
+    Q_UNUSED(info);
+  }
+  /// Called once per cycle, after the other events of the cycle.
+  virtual void onCycle(const RipesProcessor &proc) { Q_UNUSED(proc); }
+  /// Called once a system call was handled.
+  virtual void onSyscall(const SyscallRecord &record) { Q_UNUSED(record); }
+};
+
+/**
+ * @brief The ProcessorObservers class
+ * The attached observers, in a dispatch list per event.
+ */
+class ProcessorObservers {
+public:
+  void attach(ProcessorObserver *observer);
+  void detach(ProcessorObserver *observer);
+
+  /// Returns true if any observer subscribes to a per-cycle event.
+  bool observesCycles() const {
+    return !m_retire.empty() || !m_memAccess.empty() ||
+           !m_stageUpdate.empty() || !m_cycle.empty();
+  }
+
+  /// Synchronizes the retirement count against that of @p proc, such that
+  /// instructions retired while not observed are not dispatched.
+  void sync(const RipesProcessor &proc) {
+    m_retired = proc.getInstructionsRetired();
+  }
+
+  void cycle(const RipesProcessor &proc);
+  void syscall(const SyscallRecord &record) {
+    for (auto *observer : m_syscall)
+      observer->onSyscall(record);
+  }
+
+private:
+  std::vector<ProcessorObserver *> m_retire;
+  std::vector<ProcessorObserver *> m_memAccess;
+  std::vector<ProcessorObserver *> m_stageUpdate;
+  std::vector<ProcessorObserver *> m_cycle;
+  std::vector<ProcessorObserver *> m_syscall;
+  long long m_retired = 0;
+  // Stage infos of the current cycle, for dispatching stage updates.
+  std::vector<StageInfo> m_stageInfos;
+};
+
+/**
+ * @brief The ObserverPlugin class
+ * An observer loaded from a shared library. The library must define its entry
+ * point through RIPES_OBSERVER_PLUGIN; the observer is destroyed before the
+ * library is released.
+ */
+class ObserverPlugin {
+public:
+  /// Loads the plugin at @p path. Returns an error message on failure.
+  QString load(const QString &path);
+
+  ProcessorObserver *observer() const { return m_observer.get(); }
+  QString fileName() const { return m_library.fileName(); }
+
+private:
+  QLibrary m_library;
+  std::unique_ptr<ProcessorObserver> m_observer;
+};
+
+} // namespace Ripes
@@ -7,7 +7,14 @@
 #include "processors/RISC-V/rv5s_no_fw_hz/rv5s_no_fw_hz.h"
 #include "processors/RISC-V/rv5s_no_hz/rv5s_no_hz.h"
 #include "processors/RISC-V/rv6s_dual/rv6s_dual.h"
+#include "processors/RISC-V/rviss/rviss.h"
+#include "processors/RISC-V/rvmultihart/rvmultihart.h"
+#include "processors/RISC-V/rvooo/rvooo.h"
+#include "processors/RISC-V/rvsuperscalar/rvsuperscalar.h"
 #include "processors/RISC-V/rvss/rvss.h"
+#ifdef RIPES_WITH_VERILATOR_PROCESSORS
+#include "processors/RVVerilog/rvverilog.h"
+#endif
 
 namespace Ripes {
 
@@ -172,5 +179,118 @@ ProcessorRegistry::ProcessorRegistry() {
       "is reserved for controlflow and ecall instructions, and way 2 for "
       "memory accessing instructions.",
       layouts, defRegVals));
+
+  // RISC-V functional instruction set simulator
+  layouts = {};
+  defRegVals = {{2, 0x7ffffff0}, {3, 0x10000000}};
+  addProcessor(ProcInfo<vsrtl::core::RVISS<uint32_t>>(
+      ProcessorID::RV32_ISS, "Functional ISS",
+      "A functional instruction set simulator. Instructions are executed "
+      "directly on the architectural state without simulating a processor "
+      "netlist, making it suitable for fast, non-visual execution.",
+      layouts, defRegVals));
+  addProcessor(ProcInfo<vsrtl::core::RVISS<uint64_t>>(
+      ProcessorID::RV64_ISS, "Functional ISS",
+      "A functional instruction set simulator. Instructions are executed "
+      "directly on the architectural state without simulating a processor "
+      "netlist, making it suitable for fast, non-visual execution.",
+      layouts, defRegVals));
+
+  // RISC-V N-way in-order superscalar timing models
+  layouts = {};
+  defRegVals = {{2, 0x7ffffff0}, {3, 0x10000000}};
+  const auto superscalarDesc = [](unsigned width) {
+    return QString("A %1-way in-order superscalar timing model with a 5-stage "
+                   "pipeline. Issues up to %1 instructions per cycle, subject "
+                   "to data hazards and a mix of %1 arithmetic, 1 "
+                   "M-extension, 1 control-flow and 1 memory unit. "
+                   "Instructions are executed functionally as they are "
+                   "issued, and have no VSRTL view.")
+        .arg(width);
+  };
+  const auto superscalarName = [](unsigned width) {
+    return QString("%1-way in-order superscalar model").arg(width);
+  };
+  addProcessor(ProcInfo<vsrtl::core::RVSuperscalar<uint32_t, 1>>(
+      ProcessorID::RV32_SUPERSCALAR_1W, superscalarName(1),
+      superscalarDesc(1), layouts, defRegVals));
+  addProcessor(ProcInfo<vsrtl::core::RVSuperscalar<uint32_t, 2>>(
+      ProcessorID::RV32_SUPERSCALAR_2W, superscalarName(2),
+      superscalarDesc(2), layouts, defRegVals));
+  addProcessor(ProcInfo<vsrtl::core::RVSuperscalar<uint32_t, 3>>(
+      ProcessorID::RV32_SUPERSCALAR_3W, superscalarName(3),
+      superscalarDesc(3), layouts, defRegVals));
+  addProcessor(ProcInfo<vsrtl::core::RVSuperscalar<uint32_t, 4>>(
+      ProcessorID::RV32_SUPERSCALAR_4W, superscalarName(4),
+      superscalarDesc(4), layouts, defRegVals));
+  addProcessor(ProcInfo<vsrtl::core::RVSuperscalar<uint64_t, 1>>(
+      ProcessorID::RV64_SUPERSCALAR_1W, superscalarName(1),
+      superscalarDesc(1), layouts, defRegVals));
+  addProcessor(ProcInfo<vsrtl::core::RVSuperscalar<uint64_t, 2>>(
+      ProcessorID::RV64_SUPERSCALAR_2W, superscalarName(2),
+      superscalarDesc(2), layouts, defRegVals));
+  addProcessor(ProcInfo<vsrtl::core::RVSuperscalar<uint64_t, 3>>(
+      ProcessorID::RV64_SUPERSCALAR_3W, superscalarName(3),
+      superscalarDesc(3), layouts, defRegVals));
+  addProcessor(ProcInfo<vsrtl::core::RVSuperscalar<uint64_t, 4>>(
+      ProcessorID::RV64_SUPERSCALAR_4W, superscalarName(4),
+      superscalarDesc(4), layouts, defRegVals));
+
+  // RISC-V out-of-order timing models
+  layouts = {};
+  defRegVals = {{2, 0x7ffffff0}, {3, 0x10000000}};
+  const QString oooDesc =
+      "A 2-way out-of-order timing model with register renaming, a 32-entry "
+      "reorder buffer, a 16-entry issue queue and an 8-entry load/store "
+      "queue. Instructions issue as their operands become available, onto 2 "
+      "arithmetic, 1 M-extension, 1 control-flow and 1 memory unit, and "
+      "commit in order. Instructions are executed functionally as they are "
+      "fetched, and have no VSRTL view.";
+  addProcessor(ProcInfo<vsrtl::core::RVOutOfOrder<uint32_t>>(
+      ProcessorID::RV32_OOO, "Out-of-order model", oooDesc, layouts,
+      defRegVals));
+  addProcessor(ProcInfo<vsrtl::core::RVOutOfOrder<uint64_t>>(
+      ProcessorID::RV64_OOO, "Out-of-order model", oooDesc, layouts,
+      defRegVals));
+
+  // RISC-V multi-hart processors
+  layouts = {};
+  defRegVals = {{2, 0x7ffffff0}, {3, 0x10000000}};
+  const auto multiHartDesc = [](unsigned harts) {
+    return QString("A multi-core processor of %1 functional harts sharing a "
+                   "single memory, for parallel programs. All harts execute "
+                   "the program from its entry point, and tell themselves "
+                   "apart through the mhartid CSR. Each hart has its own "
+                   "stack, 64 KiB below that of the preceding hart. Harts "
+                   "execute in lockstep, or concurrently on host threads "
+                   "when synchronizing in quanta of multiple cycles.")
+        .arg(harts);
+  };
+  const auto multiHartName = [](unsigned harts) {
+    return QString("%1-hart functional multi-core").arg(harts);
+  };
+  addProcessor(ProcInfo<vsrtl::core::RVMultiHart<uint32_t, 2>>(
+      ProcessorID::RV32_MULTIHART_2, multiHartName(2), multiHartDesc(2),
+      layouts, defRegVals));
+  addProcessor(ProcInfo<vsrtl::core::RVMultiHart<uint32_t, 4>>(
+      ProcessorID::RV32_MULTIHART_4, multiHartName(4), multiHartDesc(4),
+      layouts, defRegVals));
+  addProcessor(ProcInfo<vsrtl::core::RVMultiHart<uint64_t, 2>>(
+      ProcessorID::RV64_MULTIHART_2, multiHartName(2), multiHartDesc(2),
+      layouts, defRegVals));
+  addProcessor(ProcInfo<vsrtl::core::RVMultiHart<uint64_t, 4>>(
+      ProcessorID::RV64_MULTIHART_4, multiHartName(4), multiHartDesc(4),
+      layouts, defRegVals));
+
+#ifdef RIPES_WITH_VERILATOR_PROCESSORS
+  // RISC-V single-cycle, Verilated
+  layouts = {};
+  defRegVals = {{2, 0x7ffffff0}, {3, 0x10000000}};
+  addProcessor(ProcInfo<RVVerilog>(
+      ProcessorID::RV32_VERILOG, "Verilated single-cycle processor",
+      "A single-cycle RV32IM processor, simulated from its Verilog "
+      "description through Verilator. Has no VSRTL view.",
+      layouts, defRegVals));
+#endif
 }
 } // namespace Ripes
@@ -33,6 +33,23 @@ enum ProcessorID {
   RV64_5S_NO_FW,
   RV64_5S,
   RV64_6S_DUAL,
+  RV32_ISS,
+  RV64_ISS,
+  RV32_SUPERSCALAR_1W,
+  RV32_SUPERSCALAR_2W,
+  RV32_SUPERSCALAR_3W,
+  RV32_SUPERSCALAR_4W,
+  RV64_SUPERSCALAR_1W,
+  RV64_SUPERSCALAR_2W,
+  RV64_SUPERSCALAR_3W,
+  RV64_SUPERSCALAR_4W,
+  RV32_OOO,
+  RV64_OOO,
+  RV32_MULTIHART_2,
+  RV32_MULTIHART_4,
+  RV64_MULTIHART_2,
+  RV64_MULTIHART_4,
+  RV32_VERILOG,
   NUM_PROCESSORS
 };
 Q_ENUM_NS(ProcessorID); // Register with the metaobject system
@@ -93,6 +110,11 @@ public:
   static const ProcessorMap &getAvailableProcessors() {
     return instance().m_descriptions;
   }
+  /// @returns true if processor @p id is available in this build (ie.
+  /// Verilator processors are only available when built).
+  static bool hasProcessor(ProcessorID id) {
+    return instance().m_descriptions.count(id) != 0;
+  }
   static const ProcInfoBase &getDescription(ProcessorID id) {
     auto desc = instance().m_descriptions.find(id);
     if (desc == instance().m_descriptions.end()) {
@@ -35,12 +35,49 @@ Enum(RVInstr, NOP,
      ADDIW, SLLIW, SRLIW, SRAIW, ADDW, SUBW, SLLW, SRLW, SRAW, LWU, LD, SD,
 
      /* RV64M Standard Extension */
-     MULW, DIVW, DIVUW, REMW, REMUW);
+     MULW, DIVW, DIVUW, REMW, REMUW,
+
+     /* Zicsr Standard Extension */
+     CSRRS, CSRRW, CSRRC, CSRRWI, CSRRSI, CSRRCI,
+
+     /* Machine-mode privileged instructions */
+     MRET, WFI,
+
+     /* RV32A Standard Extension */
+     LR_W, SC_W, AMOSWAP_W, AMOADD_W, AMOXOR_W, AMOAND_W, AMOOR_W, AMOMIN_W,
+     AMOMAX_W, AMOMINU_W, AMOMAXU_W,
+
+     /* RV64A Standard Extension */
+     LR_D, SC_D, AMOSWAP_D, AMOADD_D, AMOXOR_D, AMOAND_D, AMOOR_D, AMOMIN_D,
+     AMOMAX_D, AMOMINU_D, AMOMAXU_D,
+
+     /* RV32F and RV64F Standard Extensions */
+     FLW, FSW, FMADD_S, FMSUB_S, FNMSUB_S, FNMADD_S, FADD_S, FSUB_S, FMUL_S,
+     FDIV_S, FSQRT_S, FSGNJ_S, FSGNJN_S, FSGNJX_S, FMIN_S, FMAX_S, FEQ_S, FLT_S,
+     FLE_S, FCLASS_S, FCVT_W_S, FCVT_WU_S, FCVT_L_S, FCVT_LU_S, FCVT_S_W,
+     FCVT_S_WU, FCVT_S_L, FCVT_S_LU, FMV_X_W, FMV_W_X,
+
+     /* RV32D and RV64D Standard Extensions, in the order of the F extension */
+     FLD, FSD, FMADD_D, FMSUB_D, FNMSUB_D, FNMADD_D, FADD_D, FSUB_D, FMUL_D,
+     FDIV_D, FSQRT_D, FSGNJ_D, FSGNJN_D, FSGNJX_D, FMIN_D, FMAX_D, FEQ_D, FLT_D,
+     FLE_D, FCLASS_D, FCVT_W_D, FCVT_WU_D, FCVT_L_D, FCVT_LU_D, FCVT_D_W,
+     FCVT_D_WU, FCVT_D_L, FCVT_D_LU, FMV_X_D, FMV_D_X, FCVT_S_D, FCVT_D_S,
+
+     /* V Standard Extension (subset): configuration, unit-stride loads and
+        stores, and unmasked integer operations */
+     VSETVLI, VSETIVLI, VSETVL, VLE8_V, VLE16_V, VLE32_V, VLE64_V, VSE8_V,
+     VSE16_V, VSE32_V, VSE64_V, VADD_VV, VADD_VX, VADD_VI, VSUB_VV, VSUB_VX,
+     VRSUB_VX, VRSUB_VI, VMINU_VV, VMINU_VX, VMIN_VV, VMIN_VX, VMAXU_VV,
+     VMAXU_VX, VMAX_VV, VMAX_VX, VAND_VV, VAND_VX, VAND_VI, VOR_VV, VOR_VX,
+     VOR_VI, VXOR_VV, VXOR_VX, VXOR_VI, VSLL_VV, VSLL_VX, VSLL_VI, VSRL_VV,
+     VSRL_VX, VSRL_VI, VSRA_VV, VSRA_VX, VSRA_VI, VMUL_VV, VMUL_VX, VMV_V_V,
+     VMV_V_X, VMV_V_I, VREDSUM_VS, VREDAND_VS, VREDOR_VS, VREDXOR_VS,
+     VREDMINU_VS, VREDMIN_VS, VREDMAXU_VS, VREDMAX_VS, VMV_X_S, VMV_S_X);
 
 /** Datapath enumerations */
 Enum(ALUOp, NOP, ADD, SUB, MUL, DIV, AND, OR, XOR, SL, SRA, SRL, LUI, LT, LTU,
      EQ, MULH, MULHU, MULHSU, DIVU, REM, REMU, SLW, SRLW, SRAW, ADDW, SUBW,
-     MULW, DIVW, DIVUW, REMW, REMUW);
+     MULW, DIVW, DIVUW, REMW, REMUW, CSR);
 Enum(RegWrSrc, MEMREAD, ALURES, PC4);
 Enum(AluSrc1, REG1, PC);
 Enum(AluSrc2, REG2, IMM);
@@ -50,108 +87,71 @@ Enum(ECALL, none, print_int = 1, print_char = 2, print_string = 4, exit = 10);
 Enum(PcSrc, PC4 = 0, ALU = 1);
 Enum(PcInc, INC2 = 0, INC4 = 1);
 
-/** Instruction field parser */
+/** Instruction field parser. Field widths are listed from LSB to MSB. */
 class RVInstrParser {
 public:
-  static RVInstrParser *getParser() {
-    static RVInstrParser parser;
-    return &parser;
+  static constexpr InstrFields<uint32_t, 7, 5, 20>
+  decodeU32Instr(const uint32_t instr) {
+    return parseInstrFields<uint32_t, 7, 5, 20>(instr);
   }
-
-  std::vector<uint32_t> decodeU32Instr(const uint32_t &instr) const {
-    return m_decodeU32Instr(instr);
+  static constexpr InstrFields<uint32_t, 7, 5, 8, 1, 10, 1>
+  decodeJ32Instr(const uint32_t instr) {
+    return parseInstrFields<uint32_t, 7, 5, 8, 1, 10, 1>(instr);
   }
-  std::vector<uint32_t> decodeJ32Instr(const uint32_t &instr) const {
-    return m_decodeJ32Instr(instr);
+  static constexpr InstrFields<uint32_t, 7, 5, 3, 5, 12>
+  decodeI32Instr(const uint32_t instr) {
+    return parseInstrFields<uint32_t, 7, 5, 3, 5, 12>(instr);
   }
-  std::vector<uint32_t> decodeI32Instr(const uint32_t &instr) const {
-    return m_decodeI32Instr(instr);
+  static constexpr InstrFields<uint32_t, 7, 5, 3, 5, 5, 7>
+  decodeS32Instr(const uint32_t instr) {
+    return parseInstrFields<uint32_t, 7, 5, 3, 5, 5, 7>(instr);
   }
-  std::vector<uint32_t> decodeS32Instr(const uint32_t &instr) const {
-    return m_decodeS32Instr(instr);
+  static constexpr InstrFields<uint32_t, 7, 5, 3, 5, 5, 7>
+  decodeR32Instr(const uint32_t instr) {
+    return parseInstrFields<uint32_t, 7, 5, 3, 5, 5, 7>(instr);
   }
-  std::vector<uint32_t> decodeR32Instr(const uint32_t &instr) const {
-    return m_decodeR32Instr(instr);
+  static constexpr InstrFields<uint32_t, 7, 5, 3, 5, 5, 2, 5>
+  decodeR4Instr(const uint32_t instr) {
+    return parseInstrFields<uint32_t, 7, 5, 3, 5, 5, 2, 5>(instr);
   }
-  std::vector<uint32_t> decodeB32Instr(const uint32_t &instr) const {
-    return m_decodeB32Instr(instr);
+  static constexpr InstrFields<uint32_t, 7, 1, 4, 3, 5, 5, 6, 1>
+  decodeB32Instr(const uint32_t instr) {
+    return parseInstrFields<uint32_t, 7, 1, 4, 3, 5, 5, 6, 1>(instr);
   }
 
   // RVC
-  std::vector<uint32_t> decodeCA16Instr(const uint32_t &instr) const {
-    return m_decodeCA16Instr(instr);
-  }
-  std::vector<uint32_t> decodeCI16Instr(const uint32_t &instr) const {
-    return m_decodeCI16Instr(instr);
+  static constexpr InstrFields<uint32_t, 2, 3, 2, 3, 2, 1, 3, 16>
+  decodeCA16Instr(const uint32_t instr) {
+    return parseInstrFields<uint32_t, 2, 3, 2, 3, 2, 1, 3, 16>(instr);
   }
-  std::vector<uint32_t> decodeCS16Instr(const uint32_t &instr) const {
-    return m_decodeCS16Instr(instr);
+  static constexpr InstrFields<uint32_t, 2, 5, 5, 1, 3, 16>
+  decodeCI16Instr(const uint32_t instr) {
+    return parseInstrFields<uint32_t, 2, 5, 5, 1, 3, 16>(instr);
   }
-  std::vector<uint32_t> decodeCIW16Instr(const uint32_t &instr) const {
-    return m_decodeCIW16Instr(instr);
+  static constexpr InstrFields<uint32_t, 2, 3, 2, 3, 3, 3, 16>
+  decodeCS16Instr(const uint32_t instr) {
+    return parseInstrFields<uint32_t, 2, 3, 2, 3, 3, 3, 16>(instr);
   }
-  std::vector<uint32_t> decodeCSS16Instr(const uint32_t &instr) const {
-    return m_decodeCSS16Instr(instr);
+  static constexpr InstrFields<uint32_t, 2, 3, 8, 3, 16>
+  decodeCIW16Instr(const uint32_t instr) {
+    return parseInstrFields<uint32_t, 2, 3, 8, 3, 16>(instr);
   }
-  std::vector<uint32_t> decodeCJ16Instr(const uint32_t &instr) const {
-    return m_decodeCJ16Instr(instr);
+  static constexpr InstrFields<uint32_t, 2, 5, 6, 3, 16>
+  decodeCSS16Instr(const uint32_t instr) {
+    return parseInstrFields<uint32_t, 2, 5, 6, 3, 16>(instr);
   }
-  std::vector<uint32_t> decodeCB16Instr(const uint32_t &instr) const {
-    return m_decodeCB16Instr(instr);
+  static constexpr InstrFields<uint32_t, 2, 11, 3, 16>
+  decodeCJ16Instr(const uint32_t instr) {
+    return parseInstrFields<uint32_t, 2, 11, 3, 16>(instr);
   }
-  std::vector<uint32_t> decodeCB216Instr(const uint32_t &instr) const {
-    return m_decodeCB216Instr(instr);
+  static constexpr InstrFields<uint32_t, 2, 5, 3, 3, 3, 16>
+  decodeCB16Instr(const uint32_t instr) {
+    return parseInstrFields<uint32_t, 2, 5, 3, 3, 3, 16>(instr);
   }
-
-private:
-  RVInstrParser() {
-    m_decodeR32Instr = generateInstrParser<uint32_t>(
-        std::vector<int>{7, 5, 3, 5, 5, 7}); // from LSB to MSB
-    m_decodeI32Instr =
-        generateInstrParser<uint32_t>(std::vector<int>{7, 5, 3, 5, 12});
-    m_decodeS32Instr =
-        generateInstrParser<uint32_t>(std::vector<int>{7, 5, 3, 5, 5, 7});
-    m_decodeB32Instr =
-        generateInstrParser<uint32_t>(std::vector<int>{7, 1, 4, 3, 5, 5, 6, 1});
-    m_decodeU32Instr =
-        generateInstrParser<uint32_t>(std::vector<int>{7, 5, 20});
-    m_decodeJ32Instr =
-        generateInstrParser<uint32_t>(std::vector<int>{7, 5, 8, 1, 10, 1});
-
-    // RVC
-    m_decodeCA16Instr = generateInstrParser<uint32_t>(
-        std::vector<int>{2, 3, 2, 3, 2, 1, 3, 16});
-    m_decodeCI16Instr =
-        generateInstrParser<uint32_t>(std::vector<int>{2, 5, 5, 1, 3, 16});
-    m_decodeCS16Instr =
-        generateInstrParser<uint32_t>(std::vector<int>{2, 3, 2, 3, 3, 3, 16});
-    m_decodeCIW16Instr =
-        generateInstrParser<uint32_t>(std::vector<int>{2, 3, 8, 3, 16});
-    m_decodeCSS16Instr =
-        generateInstrParser<uint32_t>(std::vector<int>{2, 5, 6, 3, 16});
-    m_decodeCJ16Instr =
-        generateInstrParser<uint32_t>(std::vector<int>{2, 11, 3, 16});
-    m_decodeCB16Instr =
-        generateInstrParser<uint32_t>(std::vector<int>{2, 5, 3, 3, 3, 16});
-    m_decodeCB216Instr =
-        generateInstrParser<uint32_t>(std::vector<int>{2, 5, 3, 2, 1, 3, 16});
+  static constexpr InstrFields<uint32_t, 2, 5, 3, 2, 1, 3, 16>
+  decodeCB216Instr(const uint32_t instr) {
+    return parseInstrFields<uint32_t, 2, 5, 3, 2, 1, 3, 16>(instr);
   }
-  decode_functor<uint32_t> m_decodeU32Instr;
-  decode_functor<uint32_t> m_decodeJ32Instr;
-  decode_functor<uint32_t> m_decodeI32Instr;
-  decode_functor<uint32_t> m_decodeS32Instr;
-  decode_functor<uint32_t> m_decodeR32Instr;
-  decode_functor<uint32_t> m_decodeB32Instr;
-
-  // RVC
-  decode_functor<uint32_t> m_decodeCA16Instr;
-  decode_functor<uint32_t> m_decodeCI16Instr;
-  decode_functor<uint32_t> m_decodeCS16Instr;
-  decode_functor<uint32_t> m_decodeCIW16Instr;
-  decode_functor<uint32_t> m_decodeCSS16Instr;
-  decode_functor<uint32_t> m_decodeCJ16Instr;
-  decode_functor<uint32_t> m_decodeCB16Instr;
-  decode_functor<uint32_t> m_decodeCB216Instr;
 };
 
 } // namespace Ripes
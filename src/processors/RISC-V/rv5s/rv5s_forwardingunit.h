@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../../componentprofiler.h"
 #include "../riscv.h"
 
 #include "VSRTL/core/vsrtl_component.h"
@@ -17,6 +18,7 @@ public:
   ForwardingUnit(const std::string &name, SimComponent *parent)
       : Component(name, parent) {
     alu_reg1_forwarding_ctrl << [=] {
+      RIPES_PROFILE_COMPONENT(name);
       const auto idx = id_reg1_idx.uValue();
       if (idx == 0) {
         return ForwardingSrc::IdStage;
@@ -30,6 +32,7 @@ public:
     };
 
     alu_reg2_forwarding_ctrl << [=] {
+      RIPES_PROFILE_COMPONENT(name);
       const auto idx = id_reg2_idx.uValue();
       if (idx == 0) {
         return ForwardingSrc::IdStage;
@@ -1,9 +1,12 @@
 #pragma once
 
+#include "../../componentprofiler.h"
 #include "../riscv.h"
 
 #include "VSRTL/core/vsrtl_component.h"
 
+#include <functional>
+
 namespace vsrtl {
 namespace core {
 using namespace Ripes;
@@ -12,11 +15,26 @@ class HazardUnit_NO_FW : public Component {
 public:
   HazardUnit_NO_FW(const std::string &name, SimComponent *parent)
       : Component(name, parent) {
-    hazardFEEnable << [=] { return !hasHazard(); };
-    hazardIDEXEnable << [=] { return !hasEcallHazard(); };
-    hazardEXMEMClear << [=] { return hasEcallHazard(); };
-    hazardIDEXClear << [=] { return hasDataOrLoadUseHazard(); };
-    stallEcallHandling << [=] { return hasEcallHazard(); };
+    hazardFEEnable << [=] {
+      RIPES_PROFILE_COMPONENT(name);
+      return !hasHazard();
+    };
+    hazardIDEXEnable << [=] {
+      RIPES_PROFILE_COMPONENT(name);
+      return !hasEcallHazard();
+    };
+    hazardEXMEMClear << [=] {
+      RIPES_PROFILE_COMPONENT(name);
+      return hasEcallHazard();
+    };
+    hazardIDEXClear << [=] {
+      RIPES_PROFILE_COMPONENT(name);
+      return hasDataOrLoadUseHazard();
+    };
+    stallEcallHandling << [=] {
+      RIPES_PROFILE_COMPONENT(name);
+      return hasEcallHazard();
+    };
   }
 
   INPUTPORT(id_reg1_idx, c_RVRegsBits);
@@ -54,7 +72,26 @@ public:
   // register file before handling the ecall.
   OUTPUTPORT(stallEcallHandling, 1);
 
+  /// Sets the predicate of whether the ecall in EX must wait for the
+  /// outstanding register writes before being handled. If unset, all ecalls
+  /// wait.
+  void setEcallSerializing(std::function<bool()> serializing) {
+    m_ecallSerializing = std::move(serializing);
+  }
+
+  // Returns the register which a data or load-use hazard is waiting on. The
+  // nearest preceding instruction takes precedence.
+  unsigned hazardRegister() const {
+    if (hasDataHazardEx() || hasLoadUseHazard())
+      return ex_reg_wr_idx.uValue();
+    return mem_reg_wr_idx.uValue();
+  }
+
 private:
+  bool ecallSerializing() const {
+    return !m_ecallSerializing || m_ecallSerializing();
+  }
+
   bool hasHazard() { return hasDataOrLoadUseHazard() || hasEcallHazard(); }
 
   bool hasDataOrLoadUseHazard() {
@@ -79,7 +116,8 @@ private:
     // front-end of the pipeline shall be stalled until the remainder of the
     // pipeline has been cleared and there are no more outstanding writes.
     const bool isEcall = ex_opcode.uValue() == RVInstr::ECALL;
-    return isEcall && (mem_do_reg_write.uValue() || wb_do_reg_write.uValue());
+    return isEcall && (mem_do_reg_write.uValue() || wb_do_reg_write.uValue()) &&
+           ecallSerializing();
   }
 
   // Check if data Hazard between instruction i+1 and i
@@ -125,6 +163,8 @@ private:
             ((writeIdx == idx2) && (idx2isReg || isBranch || isMemWrite))) &&
            regWrite && !exBranchTaken;
   }
+
+  std::function<bool()> m_ecallSerializing;
 };
 } // namespace core
 } // namespace vsrtl
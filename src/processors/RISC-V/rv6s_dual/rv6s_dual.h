@@ -266,6 +266,7 @@ public:
     alu_op2_exec_src->out >> alu->op2;
 
     iiex_reg->alu_ctrl_out >> alu->ctrl;
+    alu->setCSRReader([=](unsigned csr) { return readCounterCSR(csr); });
 
     // -----------------------------------------------------------------------
     // Data way ALU
@@ -313,7 +314,15 @@ public:
     // Ecall checker
 
     iiex_reg->opcode_out >> ecallChecker->opcode;
-    ecallChecker->setSyscallCallback(&trapHandler);
+    // Ecalls of output-only syscalls are handled without waiting for the
+    // outstanding register writes, reading their arguments through them.
+    m_ecallHandler = [=] {
+      m_forwardEcallArguments = true;
+      trapHandler();
+      m_forwardEcallArguments = false;
+    };
+    ecallChecker->setSyscallCallback(&m_ecallHandler);
+    hzunit->setEcallSerializing([=] { return ecallSerializing(); });
     hzunit->stallEcallHandling >> ecallChecker->stallEcallHandling;
 
     // -----------------------------------------------------------------------
@@ -668,6 +677,33 @@ public:
       return "WB";
     Q_UNREACHABLE();
   }
+  Stall stallCause() const override {
+    if (isStalled())
+      return RipesProcessor::stallCause();
+    // Slot counts below cover both ways of each affected stage.
+    if (hzunit->stallEcallHandling.uValue())
+      return {StallCause::EcallDrain, -1, 2};
+    // A taken branch or jump in EX flushes the IF, ID and II stages.
+    if (branch->did_controlflow.uValue())
+      return {StallCause::ControlHazard, -1, 6};
+    if (hzunit->hazardIDEXClear.uValue())
+      return {StallCause::DataHazard,
+              static_cast<int>(hzunit->hazardRegister()), 2};
+    // The second instruction of a pair is issued in the following cycle.
+    if (waycontrol->stall_out.uValue())
+      return {StallCause::WayHazard, -1, 1};
+    return {};
+  }
+  BranchOutcome branchOutcome() const override {
+    // Branches and jumps are resolved in the EX stage of the execution way.
+    if (isStalled() || !iiex_reg->valid_out.uValue())
+      return {};
+    const bool isJump = iiex_reg->do_jmp_out.uValue();
+    if (!isJump && !iiex_reg->do_br_out.uValue())
+      return {};
+    return {true, iiex_reg->pc_out.uValue(), isJump,
+            static_cast<bool>(branch->did_controlflow.uValue())};
+  }
   StageInfo stageInfo(StageIndex stage) const override {
     bool stageValid = true;
     // Has the pipeline stage been filled?
@@ -793,6 +829,8 @@ public:
   }
   AddressSpaceMM &getMemory() override { return *m_memory; }
   VInt getRegister(RegisterFileType, unsigned i) const override {
+    if (m_forwardEcallArguments)
+      return forwardedRegister(i);
     return registerFile->getRegister(i);
   }
   void finalize(FinalizeReason fr) override {
@@ -812,6 +850,9 @@ public:
   MemoryAccess dataMemAccess() const override {
     return memToAccessInfo(data_mem);
   }
+  AInt dataMemAccessPC() const override {
+    return exmem_reg->pc_data_out.uValue();
+  }
   MemoryAccess instrMemAccess() const override {
     auto instrAccess = memToAccessInfo(instr_mem);
     instrAccess.type = MemoryAccess::Read;
@@ -860,6 +901,32 @@ public:
     m_instructionsRetired += instructionsRetired();
 
     Design::clock();
+    // System instructions are only issued to the execute way.
+    const bool exValid = iiex_reg->valid_out.uValue() != 0;
+    if (exValid && iiex_reg->exec_valid_out.uValue()) {
+      checkImplemented(iiex_reg->pc_out.uValue(), iiex_reg->opcode_out.uValue(),
+                       iiex_reg->imm_out.uValue() & 0xfff,
+                       iiex_reg->rd_reg1_idx_out.uValue());
+    }
+    // Multiplications are pipelined, and their results forwarded; the hazard
+    // logic stalls instructions reading them before they are available. Only
+    // the execute way holds M-extension instructions.
+    scheduleMExtStall(
+        {{exValid && iiex_reg->exec_valid_out.uValue(),
+          static_cast<unsigned>(iiex_reg->alu_ctrl_out.uValue()),
+          iiex_reg->reg_do_write_out.uValue()
+              ? static_cast<unsigned>(iiex_reg->wr_reg_idx_out.uValue())
+              : 0u,
+          static_cast<unsigned>(iiex_reg->rd_reg1_idx_out.uValue()),
+          static_cast<unsigned>(iiex_reg->rd_reg2_idx_out.uValue())},
+         {exValid && iiex_reg->data_valid_out.uValue(),
+          static_cast<unsigned>(iiex_reg->alu_ctrl_data_out.uValue()),
+          iiex_reg->reg_do_write_data_out.uValue()
+              ? static_cast<unsigned>(iiex_reg->wr_reg_idx_data_out.uValue())
+              : 0u,
+          static_cast<unsigned>(iiex_reg->rd_reg1_idx_data_out.uValue()),
+          static_cast<unsigned>(iiex_reg->rd_reg2_idx_data_out.uValue())}},
+        true);
   }
 
   void reverse() override {
@@ -893,13 +960,78 @@ public:
     std::set<RegisterFileType> rfs;
     rfs.insert(RegisterFileType::GPR);
 
-    if (implementsISA()->extensionEnabled("F")) {
+    if (implementsISA()->extensionEnabled('F')) {
       rfs.insert(RegisterFileType::FPR);
     }
     return rfs;
   }
 
 private:
+  /// Returns the value of register @p i as seen by the instructions in EX, ie.
+  /// including the outstanding writes of both ways of the MEM and WB stages.
+  /// Loads in MEM have yet to read their value (see ecallSerializing).
+  VInt forwardedRegister(unsigned i) const {
+    if (i == 0)
+      return 0;
+    if (exmem_reg->reg_do_write_out.uValue() &&
+        exmem_reg->wr_reg_idx_out.uValue() == i) {
+      return exmem_reg->reg_wr_src_ctrl_dual_out.uValue() == RegWrSrcDual::PC4
+                 ? exmem_reg->pc4_out.uValue()
+                 : exmem_reg->alures_out.uValue();
+    }
+    if (exmem_reg->reg_do_write_data_out.uValue() &&
+        exmem_reg->wr_reg_idx_data_out.uValue() == i)
+      return exmem_reg->alures_data_out.uValue();
+    if (memwb_reg->reg_do_write_out.uValue() &&
+        memwb_reg->wr_reg_idx_out.uValue() == i) {
+      return memwb_reg->reg_wr_src_ctrl_dual_out.uValue() == RegWrSrcDual::PC4
+                 ? memwb_reg->pc4_out.uValue()
+                 : memwb_reg->alures_out.uValue();
+    }
+    if (memwb_reg->reg_do_write_data_out.uValue() &&
+        memwb_reg->wr_reg_idx_data_out.uValue() == i) {
+      return memwb_reg->reg_wr_src_ctrl_data_out.uValue() ==
+                     RegWrSrcDataDual::MEM
+                 ? memwb_reg->mem_read_out.uValue()
+                 : memwb_reg->alures_data_out.uValue();
+    }
+    return registerFile->getRegister(i);
+  }
+
+  /// Whether the ecall in EX must wait for the outstanding register writes
+  /// before being handled. Output-only syscalls need not, unless a memory
+  /// access is outstanding in MEM (a load has yet to read the value it
+  /// writes, and a store has yet to write the memory which the syscall may
+  /// read), or the order of the writes is ambiguous: the instruction issued
+  /// alongside the ecall writes a register or accesses memory, or both ways of
+  /// a stage write the same register.
+  bool ecallSerializing() const {
+    if (!isOutputOnlyEcall)
+      return true;
+    if (exmem_reg->mem_do_read_out.uValue() ||
+        exmem_reg->mem_do_write_out.uValue())
+      return true;
+    if (iiex_reg->data_valid_out.uValue() &&
+        (iiex_reg->reg_do_write_data_out.uValue() ||
+         iiex_reg->mem_do_read_out.uValue() ||
+         iiex_reg->mem_do_write_out.uValue()))
+      return true;
+    const auto sameWrite = [](const auto *reg) {
+      return reg->reg_do_write_out.uValue() &&
+             reg->reg_do_write_data_out.uValue() &&
+             reg->wr_reg_idx_out.uValue() == reg->wr_reg_idx_data_out.uValue();
+    };
+    if (sameWrite(exmem_reg) || sameWrite(memwb_reg))
+      return true;
+    return !isOutputOnlyEcall(
+        forwardedRegister(static_cast<unsigned>(m_enabledISA->syscallReg())));
+  }
+
+  // Handles the ecalls of the ecall checker, with register reads forwarded
+  // while set.
+  std::function<void(void)> m_ecallHandler;
+  bool m_forwardEcallArguments = false;
+
   /**
    * @brief m_syscallExitCycle
    * The variable will contain the cycle of which an exit system call was
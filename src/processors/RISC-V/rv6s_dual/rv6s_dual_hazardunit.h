@@ -4,6 +4,8 @@
 
 #include "VSRTL/core/vsrtl_component.h"
 
+#include <functional>
+
 namespace vsrtl {
 namespace core {
 using namespace Ripes;
@@ -52,7 +54,21 @@ public:
   // register file before handling the ecall.
   OUTPUTPORT(stallEcallHandling, 1);
 
+  /// Sets the predicate of whether the ecall in EX must wait for the
+  /// outstanding register writes before being handled. If unset, all ecalls
+  /// wait.
+  void setEcallSerializing(std::function<bool()> serializing) {
+    m_ecallSerializing = std::move(serializing);
+  }
+
+  // Returns the register which a load-use hazard is waiting on.
+  unsigned hazardRegister() const { return ex_reg_wr_idx_data.uValue(); }
+
 private:
+  bool ecallSerializing() const {
+    return !m_ecallSerializing || m_ecallSerializing();
+  }
+
   bool hasHazard() { return hasLoadUseHazard() || hasEcallHazard(); }
 
   bool hasLoadUseHazard() const {
@@ -79,8 +95,11 @@ private:
     const bool isEcall = opcode.uValue() == RVInstr::ECALL;
     return isEcall &&
            (mem_do_reg_write_exec.uValue() || mem_do_reg_write_data.uValue() ||
-            wb_do_reg_write_data.uValue() || wb_do_reg_write_exec.uValue());
+            wb_do_reg_write_data.uValue() || wb_do_reg_write_exec.uValue()) &&
+           ecallSerializing();
   }
+
+  std::function<bool()> m_ecallSerializing;
 };
 } // namespace core
 } // namespace vsrtl
@@ -20,6 +20,23 @@ private:
     return Control::do_mem_ctrl(opcode) != +MemOp::NOP;
   }
 
+  static bool isSystem(const VSRTL_VT_U &opcode) {
+    switch (opcode) {
+    case RVInstr::ECALL:
+    case RVInstr::CSRRS:
+    case RVInstr::CSRRW:
+    case RVInstr::CSRRC:
+    case RVInstr::CSRRWI:
+    case RVInstr::CSRRSI:
+    case RVInstr::CSRRCI:
+    case RVInstr::MRET:
+    case RVInstr::WFI:
+      return true;
+    default:
+      return false;
+    }
+  }
+
   // clang-format off
     static bool isWriteRegInstr(const VSRTL_VT_U& opcode) {
         switch(opcode) {
@@ -48,6 +65,9 @@ private:
             // Jump instructions
             case RVInstr::JALR:
             case RVInstr::JAL:
+
+            // CSR instructions
+            case RVInstr::CSRRS:
                 return true;
             default: return false;
         }
@@ -92,7 +112,10 @@ private:
       return WayClass ::Data;
     } else if (isControlflow(opcode)) {
       return WayClass::Controlflow;
-    } else if (opcode == RVInstr::ECALL) {
+    } else if (isSystem(opcode)) {
+      // Counter CSR reads are issued alone, like ecalls, such that they are
+      // ordered with respect to the instructions they count. Other system
+      // instructions are issued alike, to the execute way.
       return WayClass::Ecall;
     } else {
       return WayClass::Arithmetic;
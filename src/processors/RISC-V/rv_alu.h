@@ -1,8 +1,10 @@
 #pragma once
 
 #include "limits.h"
+#include <functional>
 #include <math.h>
 
+#include "../componentprofiler.h"
 #include "riscv.h"
 
 #include "VSRTL/core/vsrtl_component.h"
@@ -20,6 +22,7 @@ public:
   SetGraphicsType(ALU);
   ALU(const std::string &name, SimComponent *parent) : Component(name, parent) {
     res << [=] {
+      RIPES_PROFILE_COMPONENT(name);
       switch (ctrl.uValue()) {
       case ALUOp::ADD:
         return op1.uValue() + op2.uValue();
@@ -160,17 +163,32 @@ public:
         return VT_U(signextend<32>(static_cast<uint32_t>(op1.uValue()) >>
                                    (op2.uValue() & generateBitmask(5))));
 
+      case ALUOp::CSR:
+        return m_csrReader ? VT_U(m_csrReader(op2.uValue())) : VT_U(0);
+
       default:
         throw std::runtime_error("Invalid ALU opcode");
       }
     };
   }
 
+  /**
+   * @brief setCSRReader
+   * Sets the callback through which ALUOp::CSR reads the CSR numbered by
+   * op2. CSRs read as zero if no callback is set.
+   */
+  void setCSRReader(std::function<VSRTL_VT_U(unsigned)> reader) {
+    m_csrReader = reader;
+  }
+
   INPUTPORT_ENUM(ctrl, ALUOp);
   INPUTPORT(op1, XLEN);
   INPUTPORT(op2, XLEN);
 
   OUTPUTPORT(res, XLEN);
+
+private:
+  std::function<VSRTL_VT_U(unsigned)> m_csrReader;
 };
 
 } // namespace core
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../componentprofiler.h"
 #include "VSRTL/core/vsrtl_component.h"
 #include "riscv.h"
 
@@ -14,6 +15,7 @@ public:
       : Component(name, parent) {
     // clang-format off
         res << [=] {
+            RIPES_PROFILE_COMPONENT(name);
             switch(comp_op.uValue()){
                 case CompOp::NOP: return false;
                 case CompOp::EQ: return op1.uValue() == op2.uValue();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../componentprofiler.h"
 #include "VSRTL/core/vsrtl_component.h"
 #include "riscv.h"
 
@@ -86,6 +87,9 @@ public:
             // Jump instructions
             case RVInstr::JALR:
             case RVInstr::JAL:
+
+            // CSR instructions
+            case RVInstr::CSRRS:
                 return 1;
             default: return 0;
         }
@@ -158,6 +162,10 @@ public:
         case RVInstr::JAL:
             return AluSrc2::IMM;
 
+        // CSR instructions; the immediate holds the CSR number
+        case RVInstr::CSRRS:
+            return AluSrc2::IMM;
+
         default:
             return AluSrc2::REG2;
         }
@@ -215,6 +223,7 @@ public:
             case RVInstr::DIVUW : return ALUOp::DIVUW;
             case RVInstr::REMW  : return ALUOp::REMW ;
             case RVInstr::REMUW : return ALUOp::REMUW;
+            case RVInstr::CSRRS : return ALUOp::CSR;
 
             default: return ALUOp::NOP;
         }
@@ -241,17 +250,50 @@ public:
 public:
   Control(const std::string &name, SimComponent *parent)
       : Component(name, parent) {
-    comp_ctrl << [=] { return do_comp_ctrl(opcode.uValue()); };
-    do_branch << [=] { return do_branch_ctrl(opcode.uValue()); };
-    do_jump << [=] { return do_jump_ctrl(opcode.uValue()); };
-    mem_ctrl << [=] { return do_mem_ctrl(opcode.uValue()); };
-    reg_do_write_ctrl << [=] { return do_reg_do_write_ctrl(opcode.uValue()); };
-    reg_wr_src_ctrl << [=] { return do_reg_wr_src_ctrl(opcode.uValue()); };
-    alu_op1_ctrl << [=] { return do_alu_op1_ctrl(opcode.uValue()); };
-    alu_op2_ctrl << [=] { return do_alu_op2_ctrl(opcode.uValue()); };
-    alu_ctrl << [=] { return do_alu_ctrl(opcode.uValue()); };
-    mem_do_write_ctrl << [=] { return do_do_mem_write_ctrl(opcode.uValue()); };
-    mem_do_read_ctrl << [=] { return do_do_read_ctrl(opcode.uValue()); };
+    comp_ctrl << [=] {
+      RIPES_PROFILE_COMPONENT(name);
+      return do_comp_ctrl(opcode.uValue());
+    };
+    do_branch << [=] {
+      RIPES_PROFILE_COMPONENT(name);
+      return do_branch_ctrl(opcode.uValue());
+    };
+    do_jump << [=] {
+      RIPES_PROFILE_COMPONENT(name);
+      return do_jump_ctrl(opcode.uValue());
+    };
+    mem_ctrl << [=] {
+      RIPES_PROFILE_COMPONENT(name);
+      return do_mem_ctrl(opcode.uValue());
+    };
+    reg_do_write_ctrl << [=] {
+      RIPES_PROFILE_COMPONENT(name);
+      return do_reg_do_write_ctrl(opcode.uValue());
+    };
+    reg_wr_src_ctrl << [=] {
+      RIPES_PROFILE_COMPONENT(name);
+      return do_reg_wr_src_ctrl(opcode.uValue());
+    };
+    alu_op1_ctrl << [=] {
+      RIPES_PROFILE_COMPONENT(name);
+      return do_alu_op1_ctrl(opcode.uValue());
+    };
+    alu_op2_ctrl << [=] {
+      RIPES_PROFILE_COMPONENT(name);
+      return do_alu_op2_ctrl(opcode.uValue());
+    };
+    alu_ctrl << [=] {
+      RIPES_PROFILE_COMPONENT(name);
+      return do_alu_ctrl(opcode.uValue());
+    };
+    mem_do_write_ctrl << [=] {
+      RIPES_PROFILE_COMPONENT(name);
+      return do_do_mem_write_ctrl(opcode.uValue());
+    };
+    mem_do_read_ctrl << [=] {
+      RIPES_PROFILE_COMPONENT(name);
+      return do_do_read_ctrl(opcode.uValue());
+    };
   }
 
   INPUTPORT_ENUM(opcode, RVInstr);
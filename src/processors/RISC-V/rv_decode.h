@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include "../componentprofiler.h"
 #include "VSRTL/core/vsrtl_component.h"
 #include "riscv.h"
 
@@ -15,8 +16,32 @@ public:
   Decode(const std::string &name, SimComponent *parent)
       : Component(name, parent) {
     opcode << [=] {
-      const auto instrValue = instr.uValue();
+      RIPES_PROFILE_COMPONENT(name);
+      return decodeOpcode(instr.uValue(), m_isa.get());
+    };
+    wr_reg_idx << [=] {
+      RIPES_PROFILE_COMPONENT(name);
+      return (instr.uValue() >> 7) & 0b11111;
+    };
+    r1_reg_idx << [=] {
+      RIPES_PROFILE_COMPONENT(name);
+      return (instr.uValue() >> 15) & 0b11111;
+    };
+    r2_reg_idx << [=] {
+      RIPES_PROFILE_COMPONENT(name);
+      return (instr.uValue() >> 20) & 0b11111;
+    };
+  }
 
+  /**
+   * @brief decodeOpcode
+   * Decodes the (uncompressed) instruction word @p instrValue into its RVInstr
+   * opcode, given the extensions enabled in @p isa. Unknown instructions decode
+   * to RVInstr::NOP. This is independent of any component state, and may thus
+   * be used outside of a VSRTL design.
+   */
+  static VSRTL_VT_U decodeOpcode(const VSRTL_VT_U instrValue,
+                                 const ISAInfoBase *isa) {
       const unsigned l7 = instrValue & 0b1111111;
 
       // clang-format off
@@ -25,11 +50,31 @@ public:
             case RVISA::Opcode::AUIPC: return RVInstr::AUIPC;
             case RVISA::Opcode::JAL: return RVInstr::JAL;
             case RVISA::Opcode::JALR: return RVInstr::JALR;
-            case RVISA::Opcode::ECALL: return RVInstr::ECALL;
+            case RVISA::Opcode::ECALL: {
+                // System instructions
+                const auto fields = RVInstrParser::decodeI32Instr(instrValue);
+                switch (fields[2]) {
+                    case 0b000: {
+                        switch (fields[4]) {
+                            case 0x302: return RVInstr::MRET;
+                            case 0x105: return RVInstr::WFI;
+                            default: return RVInstr::ECALL;
+                        }
+                    }
+                    case 0b001: return RVInstr::CSRRW;
+                    case 0b010: return RVInstr::CSRRS;
+                    case 0b011: return RVInstr::CSRRC;
+                    case 0b101: return RVInstr::CSRRWI;
+                    case 0b110: return RVInstr::CSRRSI;
+                    case 0b111: return RVInstr::CSRRCI;
+                    default: break;
+                }
+                break;
+            }
 
             case RVISA::Opcode::OPIMM: {
                 // I-Type
-                const auto fields = RVInstrParser::getParser()->decodeI32Instr(instrValue);
+                const auto fields = RVInstrParser::decodeI32Instr(instrValue);
                 switch(fields[2]) {
                 case 0b000: return RVInstr::ADDI;
                 case 0b010: return RVInstr::SLTI;
@@ -51,7 +96,7 @@ public:
 
             case RVISA::Opcode::OPIMM32: {
                 // I-Type (32-bit, in 64-bit ISA)
-                const auto fields = RVInstrParser::getParser()->decodeI32Instr(instrValue);
+                const auto fields = RVInstrParser::decodeI32Instr(instrValue);
                 switch(fields[2]) {
                 case 0b000: return RVInstr::ADDIW;
                 case 0b001: return RVInstr::SLLIW;
@@ -68,9 +113,9 @@ public:
 
             case RVISA::Opcode::OP: {
                 // R-Type
-                const auto fields = RVInstrParser::getParser()->decodeR32Instr(instrValue);
+                const auto fields = RVInstrParser::decodeR32Instr(instrValue);
                 if (fields[0] == 0b0000001) {
-                    if(m_isa && m_isa->extensionEnabled("M")) {
+                    if(isa && isa->extensionEnabled('M')) {
                         // RV32M Standard extension
                         switch (fields[3]) {
                             case 0b000: return RVInstr::MUL;
@@ -115,9 +160,9 @@ public:
 
             case RVISA::Opcode::OP32: {
                 // R-Type (32-bit, in 64-bit ISA)
-                const auto fields = RVInstrParser::getParser()->decodeR32Instr(instrValue);
+                const auto fields = RVInstrParser::decodeR32Instr(instrValue);
                 if (fields[0] == 0b0000001) {
-                    if(m_isa && m_isa->extensionEnabled("M")) {
+                    if(isa && isa->extensionEnabled('M')) {
                         // RV64M Standard extension
                         switch (fields[3]) {
                             case 0b000: return RVInstr::MULW;
@@ -154,7 +199,7 @@ public:
 
             case RVISA::Opcode::LOAD: {
                 // Load instruction
-                const auto fields = RVInstrParser::getParser()->decodeI32Instr(instrValue);
+                const auto fields = RVInstrParser::decodeI32Instr(instrValue);
                 switch (fields[2]) {
                     case 0b000: return RVInstr::LB;
                     case 0b001: return RVInstr::LH;
@@ -170,7 +215,7 @@ public:
 
             case RVISA::Opcode::STORE: {
                 // Store instructions
-                const auto fields = RVInstrParser::getParser()->decodeS32Instr(instrValue);
+                const auto fields = RVInstrParser::decodeS32Instr(instrValue);
                 switch (fields[3]) {
                     case 0b000: return RVInstr::SB;
                     case 0b001: return RVInstr::SH;
@@ -181,9 +226,182 @@ public:
                 break;
             }
 
+            case RVISA::Opcode::AMO: {
+                // Atomic instructions. Bits 25 and 26 (rl and aq) only order
+                // memory accesses, and do not affect the opcode.
+                if (!isa || !isa->extensionEnabled('A'))
+                    break;
+                const auto fields = RVInstrParser::decodeR32Instr(instrValue);
+                const bool isDouble = fields[3] == 0b011;
+                if (fields[3] != 0b010 && !(isDouble && isa->bits() == 64))
+                    break;
+                // The RV64A opcodes follow the RV32A opcodes in RVInstr.
+                const unsigned d = isDouble ? RVInstr::LR_D - RVInstr::LR_W : 0;
+                switch (fields[0] >> 2) {
+                    case 0b00010:
+                        if (fields[1] != 0)
+                            break;
+                        return RVInstr::LR_W + d;
+                    case 0b00011: return RVInstr::SC_W + d;
+                    case 0b00001: return RVInstr::AMOSWAP_W + d;
+                    case 0b00000: return RVInstr::AMOADD_W + d;
+                    case 0b00100: return RVInstr::AMOXOR_W + d;
+                    case 0b01100: return RVInstr::AMOAND_W + d;
+                    case 0b01000: return RVInstr::AMOOR_W + d;
+                    case 0b10000: return RVInstr::AMOMIN_W + d;
+                    case 0b10100: return RVInstr::AMOMAX_W + d;
+                    case 0b11000: return RVInstr::AMOMINU_W + d;
+                    case 0b11100: return RVInstr::AMOMAXU_W + d;
+                    default: break;
+                }
+                break;
+            }
+
+            case RVISA::Opcode::LOAD_FP:
+            case RVISA::Opcode::STORE_FP: {
+                // Floating-point loads and stores, of the width in funct3
+                const auto fields = RVInstrParser::decodeI32Instr(instrValue);
+                const bool isLoad = l7 == RVISA::Opcode::LOAD_FP;
+                if (fields[2] == 0b010 && fpFormatOffset(0b00, isa) >= 0)
+                    return isLoad ? RVInstr::FLW : RVInstr::FSW;
+                if (fields[2] == 0b011 && fpFormatOffset(0b01, isa) >= 0)
+                    return isLoad ? RVInstr::FLD : RVInstr::FSD;
+                return decodeVectorMemory(instrValue, isLoad, isa);
+            }
+
+            case RVISA::Opcode::MADD:
+            case RVISA::Opcode::MSUB:
+            case RVISA::Opcode::NMSUB:
+            case RVISA::Opcode::NMADD: {
+                // Fused multiply-add; R4-Type, with the format in bits 25-26
+                const auto fields = RVInstrParser::decodeR4Instr(instrValue);
+                const int d = fpFormatOffset(fields[1], isa);
+                if (d < 0)
+                    break;
+                switch (l7) {
+                    case RVISA::Opcode::MADD: return RVInstr::FMADD_S + d;
+                    case RVISA::Opcode::MSUB: return RVInstr::FMSUB_S + d;
+                    case RVISA::Opcode::NMSUB: return RVInstr::FNMSUB_S + d;
+                    default: return RVInstr::FNMADD_S + d;
+                }
+            }
+
+            case RVISA::Opcode::OP_FP: {
+                // Floating-point operations, with funct7 holding funct5 and
+                // the format, and funct3 the rounding mode of rounding
+                // operations
+                const auto fields = RVInstrParser::decodeR32Instr(instrValue);
+                const int d = fpFormatOffset(fields[0] & 0b11, isa);
+                if (d < 0)
+                    break;
+                const bool isDouble = d != 0;
+                const bool isRV64 = isa->bits() == 64;
+                const unsigned rs2 = fields[1];
+                const unsigned funct3 = fields[3];
+                switch (fields[0] >> 2) {
+                    case 0b00000: return RVInstr::FADD_S + d;
+                    case 0b00001: return RVInstr::FSUB_S + d;
+                    case 0b00010: return RVInstr::FMUL_S + d;
+                    case 0b00011: return RVInstr::FDIV_S + d;
+                    case 0b01011:
+                        if (rs2 != 0)
+                            break;
+                        return RVInstr::FSQRT_S + d;
+                    case 0b00100: {
+                        switch (funct3) {
+                            case 0b000: return RVInstr::FSGNJ_S + d;
+                            case 0b001: return RVInstr::FSGNJN_S + d;
+                            case 0b010: return RVInstr::FSGNJX_S + d;
+                            default: break;
+                        }
+                        break;
+                    }
+                    case 0b00101: {
+                        switch (funct3) {
+                            case 0b000: return RVInstr::FMIN_S + d;
+                            case 0b001: return RVInstr::FMAX_S + d;
+                            default: break;
+                        }
+                        break;
+                    }
+                    case 0b10100: {
+                        switch (funct3) {
+                            case 0b010: return RVInstr::FEQ_S + d;
+                            case 0b001: return RVInstr::FLT_S + d;
+                            case 0b000: return RVInstr::FLE_S + d;
+                            default: break;
+                        }
+                        break;
+                    }
+                    case 0b01000: {
+                        // Conversions between formats; rs2 holds the source
+                        // format
+                        if (isDouble && rs2 == 0b00000)
+                            return RVInstr::FCVT_D_S;
+                        if (!isDouble && rs2 == 0b00001 &&
+                            fpFormatOffset(0b01, isa) >= 0)
+                            return RVInstr::FCVT_S_D;
+                        break;
+                    }
+                    case 0b11000:
+                    case 0b11010: {
+                        // Conversions to (11000) and from (11010) integers, in
+                        // the order W, WU, L and LU of rs2 and of RVInstr. L
+                        // and LU are RV64 only.
+                        if (rs2 > 0b00011 || (rs2 > 0b00001 && !isRV64))
+                            break;
+                        const unsigned base = (fields[0] >> 2) == 0b11000
+                                                  ? RVInstr::FCVT_W_S
+                                                  : RVInstr::FCVT_S_W;
+                        return base + rs2 + d;
+                    }
+                    case 0b11100: {
+                        if (rs2 != 0)
+                            break;
+                        switch (funct3) {
+                            case 0b000:
+                                if (isDouble && !isRV64)
+                                    break;
+                                return RVInstr::FMV_X_W + d;
+                            case 0b001: return RVInstr::FCLASS_S + d;
+                            default: break;
+                        }
+                        break;
+                    }
+                    case 0b11110: {
+                        if (rs2 != 0 || funct3 != 0 || (isDouble && !isRV64))
+                            break;
+                        return RVInstr::FMV_W_X + d;
+                    }
+                    default: break;
+                }
+                break;
+            }
+
+            case RVISA::Opcode::OP_V: {
+                if (!isa || !isa->extensionEnabled('V'))
+                    break;
+                const auto fields = RVInstrParser::decodeR32Instr(instrValue);
+                if (fields[3] == 0b111) {
+                    // Configuration instructions, told apart by bits 30-31
+                    if (!(instrValue >> 31))
+                        return RVInstr::VSETVLI;
+                    if ((instrValue >> 30) == 0b11)
+                        return RVInstr::VSETIVLI;
+                    if (fields[0] == 0b1000000)
+                        return RVInstr::VSETVL;
+                    break;
+                }
+                // Only unmasked operations (vm = 1) are implemented.
+                if (!(fields[0] & 0b1))
+                    break;
+                return decodeVectorOp(fields[3], fields[0] >> 1, fields[2],
+                                      fields[1]);
+            }
+
             case RVISA::Opcode::BRANCH: {
                 // Branch instruction
-                const auto fields = RVInstrParser::getParser()->decodeB32Instr(instrValue);
+                const auto fields = RVInstrParser::decodeB32Instr(instrValue);
                 switch (fields[4]) {
                     case 0b000: return RVInstr::BEQ;
                     case 0b001: return RVInstr::BNE;
@@ -203,20 +421,6 @@ public:
 
             // Fallthrough - unknown instruction.
             return RVInstr::NOP;
-        };
-
-        wr_reg_idx << [=] {
-          return (instr.uValue() >> 7) & 0b11111;
-        };
-
-        r1_reg_idx << [=] {
-          return (instr.uValue() >> 15) & 0b11111;
-        };
-
-        r2_reg_idx << [=] {
-          return (instr.uValue() >> 20) & 0b11111;
-        };
-
     // clang-format on
   }
 
@@ -227,6 +431,138 @@ public:
   OUTPUTPORT(r2_reg_idx, c_RVRegsBits);
 
 private:
+  /// Returns the offset of the RVInstr opcodes of the floating-point format
+  /// @p fmt (S = 00, D = 01) from those of the F extension, or -1 if the
+  /// extension of the format is not enabled. The D opcodes follow the F opcodes
+  /// in RVInstr.
+  static int fpFormatOffset(unsigned fmt, const ISAInfoBase *isa) {
+    if (!isa || !isa->extensionEnabled('F'))
+      return -1;
+    if (fmt == 0b00)
+      return 0;
+    if (fmt == 0b01 && isa->extensionEnabled('D'))
+      return RVInstr::FLD - RVInstr::FLW;
+    return -1;
+  }
+
+  /// Decodes the unit-stride vector loads and stores, which share the
+  /// LOAD-FP and STORE-FP opcodes with the scalar floating-point loads and
+  /// stores. Only unmasked accesses of a single field are implemented.
+  static VSRTL_VT_U decodeVectorMemory(const VSRTL_VT_U instrValue, bool isLoad,
+                                       const ISAInfoBase *isa) {
+    if (!isa || !isa->extensionEnabled('V'))
+      return RVInstr::NOP;
+    // nf, mew and mop (bits 26-31) are zero, vm (bit 25) is set, and lumop or
+    // sumop (bits 20-24) is zero.
+    if (((instrValue >> 20) & 0xfff) != 0b000000100000)
+      return RVInstr::NOP;
+    // The element widths 8, 16, 32 and 64 of the width field, in the order of
+    // RVInstr.
+    unsigned index;
+    switch ((instrValue >> 12) & 0b111) {
+    case 0b000:
+      index = 0;
+      break;
+    case 0b101:
+      index = 1;
+      break;
+    case 0b110:
+      index = 2;
+      break;
+    case 0b111:
+      index = 3;
+      break;
+    default:
+      return RVInstr::NOP;
+    }
+    return (isLoad ? RVInstr::VLE8_V : RVInstr::VSE8_V) + index;
+  }
+
+  /// Decodes an unmasked vector operation of the category @p funct3 (OPIVV,
+  /// OPIVX, OPIVI, OPMVV or OPMVX) and @p funct6.
+  static VSRTL_VT_U decodeVectorOp(unsigned funct3, unsigned funct6,
+                                   unsigned vs1, unsigned vs2) {
+    // Selects the form of an integer operation by the category; RVInstr::NOP
+    // for forms which do not exist.
+    const auto form = [funct3](unsigned vv, unsigned vx,
+                               unsigned vi) -> VSRTL_VT_U {
+      switch (funct3) {
+      case 0b000:
+        return vv;
+      case 0b100:
+        return vx;
+      case 0b011:
+        return vi;
+      default:
+        return RVInstr::NOP;
+      }
+    };
+    constexpr unsigned none = RVInstr::NOP;
+    switch (funct3) {
+    case 0b000:
+    case 0b100:
+    case 0b011: {
+      switch (funct6) {
+      case 0b000000:
+        return form(RVInstr::VADD_VV, RVInstr::VADD_VX, RVInstr::VADD_VI);
+      case 0b000010:
+        return form(RVInstr::VSUB_VV, RVInstr::VSUB_VX, none);
+      case 0b000011:
+        return form(none, RVInstr::VRSUB_VX, RVInstr::VRSUB_VI);
+      case 0b000100:
+        return form(RVInstr::VMINU_VV, RVInstr::VMINU_VX, none);
+      case 0b000101:
+        return form(RVInstr::VMIN_VV, RVInstr::VMIN_VX, none);
+      case 0b000110:
+        return form(RVInstr::VMAXU_VV, RVInstr::VMAXU_VX, none);
+      case 0b000111:
+        return form(RVInstr::VMAX_VV, RVInstr::VMAX_VX, none);
+      case 0b001001:
+        return form(RVInstr::VAND_VV, RVInstr::VAND_VX, RVInstr::VAND_VI);
+      case 0b001010:
+        return form(RVInstr::VOR_VV, RVInstr::VOR_VX, RVInstr::VOR_VI);
+      case 0b001011:
+        return form(RVInstr::VXOR_VV, RVInstr::VXOR_VX, RVInstr::VXOR_VI);
+      case 0b100101:
+        return form(RVInstr::VSLL_VV, RVInstr::VSLL_VX, RVInstr::VSLL_VI);
+      case 0b101000:
+        return form(RVInstr::VSRL_VV, RVInstr::VSRL_VX, RVInstr::VSRL_VI);
+      case 0b101001:
+        return form(RVInstr::VSRA_VV, RVInstr::VSRA_VX, RVInstr::VSRA_VI);
+      case 0b010111:
+        // vmv.v.*; unmasked vmerge with vs2 = v0
+        if (vs2 != 0)
+          break;
+        return form(RVInstr::VMV_V_V, RVInstr::VMV_V_X, RVInstr::VMV_V_I);
+      default:
+        break;
+      }
+      break;
+    }
+    case 0b010: {
+      // OPMVV. The reductions follow the order of their funct6 in RVInstr.
+      if (funct6 <= 0b000111)
+        return RVInstr::VREDSUM_VS + funct6;
+      if (funct6 == 0b100101)
+        return RVInstr::VMUL_VV;
+      if (funct6 == 0b010000 && vs1 == 0)
+        return RVInstr::VMV_X_S;
+      break;
+    }
+    case 0b110: {
+      // OPMVX
+      if (funct6 == 0b100101)
+        return RVInstr::VMUL_VX;
+      if (funct6 == 0b010000 && vs2 == 0)
+        return RVInstr::VMV_S_X;
+      break;
+    }
+    default:
+      break;
+    }
+    return RVInstr::NOP;
+  }
+
   void unknownInstruction() {}
   std::shared_ptr<ISAInfoBase> m_isa;
 };
@@ -3,6 +3,7 @@
 #include "Signals/Signal.h"
 #include "VSRTL/core/vsrtl_component.h"
 
+#include "../componentprofiler.h"
 #include "riscv.h"
 
 namespace vsrtl {
@@ -14,6 +15,7 @@ public:
   EcallChecker(const std::string &name, SimComponent *parent)
       : Component(name, parent) {
     dummy << [=] {
+      RIPES_PROFILE_COMPONENT(name);
       if (opcode.uValue() == RVInstr::ECALL && !stallEcallHandling.uValue() &&
           !handlingEcall) {
         assert(m_callback != nullptr && "No syscall callback was set!");
@@ -30,7 +32,10 @@ public:
     // in the pipeline. This signal may then be used as a method of clearing
     // early pipeline stages while the remainder of the pipeline is emptying the
     // to-be executed instructions after the syscall.
-    syscallExit << [=] { return m_syscallExit; };
+    syscallExit << [=] {
+      RIPES_PROFILE_COMPONENT(name);
+      return m_syscallExit;
+    };
   }
 
   void setSyscallCallback(std::function<void(void)> const *cb) {
@@ -0,0 +1,356 @@
+#pragma once
+
+#include <cfenv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The RVFPU struct
+ * The floating-point operations of the F and D extensions, executed on the
+ * host FPU. The arithmetic operations, square roots and conversions execute
+ * as the corresponding host operations, with the host rounding mode set to the
+ * RISC-V rounding mode (see Scope), and report the host floating-point
+ * exceptions of the operation as fflags. The host rounding to nearest (ties to
+ * even) stands in for RMM (ties to max magnitude) in these operations, which
+ * hosts do not implement. Conversions to integers, comparisons, min/max and
+ * classification are implemented explicitly, since their RISC-V semantics
+ * (saturation, NaN handling and the signaling of sNaNs) differ from those of
+ * the host.
+ *
+ * Results which are NaN are the canonical NaN, as required by the RISC-V
+ * specification. Floating-point registers are 64 bits wide, with single-
+ * precision values NaN-boxed (see box/unbox).
+ */
+struct RVFPU {
+  /// The exception flags of fflags.
+  enum Flags : unsigned { NX = 1, UF = 2, OF = 4, DZ = 8, NV = 16 };
+  /// The rounding modes of frm and of the rm field of instructions.
+  enum RoundingMode : unsigned {
+    RNE = 0b000,
+    RTZ = 0b001,
+    RDN = 0b010,
+    RUP = 0b011,
+    RMM = 0b100,
+    DYN = 0b111
+  };
+
+  static bool validRoundingMode(unsigned rm) { return rm <= RMM; }
+
+  /**
+   * @brief The Scope class
+   * Sets the host rounding mode to the RISC-V rounding mode @p rm and clears
+   * the host exceptions for the lifetime of the scope, within which host
+   * floating-point operations execute as RISC-V operations. Operands and
+   * results of operations within the scope are accessed through volatiles,
+   * such that the operations are not reordered across the scope, nor evaluated
+   * at compile time.
+   */
+  class Scope {
+  public:
+    explicit Scope(unsigned rm) {
+      std::fesetround(hostRoundingMode(rm));
+      std::feclearexcept(FE_ALL_EXCEPT);
+    }
+    ~Scope() { std::fesetround(FE_TONEAREST); }
+
+    /// The fflags of the exceptions raised within the scope.
+    unsigned flags() const {
+      const int raised = std::fetestexcept(FE_ALL_EXCEPT);
+      unsigned flags = 0;
+      if (raised & FE_INEXACT)
+        flags |= NX;
+      if (raised & FE_UNDERFLOW)
+        flags |= UF;
+      if (raised & FE_OVERFLOW)
+        flags |= OF;
+      if (raised & FE_DIVBYZERO)
+        flags |= DZ;
+      if (raised & FE_INVALID)
+        flags |= NV;
+      return flags;
+    }
+
+  private:
+    static int hostRoundingMode(unsigned rm) {
+      switch (rm) {
+      case RTZ:
+        return FE_TOWARDZERO;
+      case RDN:
+        return FE_DOWNWARD;
+      case RUP:
+        return FE_UPWARD;
+      default:
+        return FE_TONEAREST;
+      }
+    }
+  };
+
+  template <typename F>
+  using Bits = std::conditional_t<std::is_same_v<F, float>, uint32_t, uint64_t>;
+
+  template <typename F>
+  static Bits<F> toBits(F v) {
+    Bits<F> bits;
+    std::memcpy(&bits, &v, sizeof(v));
+    return bits;
+  }
+  template <typename F>
+  static F fromBits(Bits<F> bits) {
+    F v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+  }
+
+  template <typename F>
+  static constexpr Bits<F> canonicalNaN() {
+    return std::is_same_v<F, float> ? 0x7fc00000 : 0x7ff8000000000000;
+  }
+  template <typename F>
+  static constexpr Bits<F> signBit() {
+    return Bits<F>(1) << (sizeof(F) * 8 - 1);
+  }
+
+  /// NaN-boxes the single-precision @p bits in a 64-bit register.
+  static uint64_t box(uint32_t bits) { return 0xffffffff00000000 | bits; }
+  /// Returns the single-precision value of the 64-bit register @p reg, which
+  /// is the canonical NaN if the register is not a NaN-boxed single.
+  static uint32_t unbox(uint64_t reg) {
+    return (reg >> 32) == 0xffffffff ? static_cast<uint32_t>(reg)
+                                     : canonicalNaN<float>();
+  }
+
+  template <typename F>
+  static bool isSignalingNaN(F v) {
+    // The most significant bit of the significand.
+    constexpr Bits<F> quiet = Bits<F>(1)
+                              << (std::numeric_limits<F>::digits - 2);
+    return std::isnan(v) && !(toBits(v) & quiet);
+  }
+
+  /// Returns @p v, or the canonical NaN if @p v is a NaN.
+  template <typename F>
+  static F canonicalize(F v) {
+    return std::isnan(v) ? fromBits<F>(canonicalNaN<F>()) : v;
+  }
+
+  /// Executes @p op on the host with the rounding mode @p rm, accruing its
+  /// exceptions in @p flags.
+  template <typename F, typename Op>
+  static F execute(unsigned rm, unsigned &flags, Op &&op) {
+    Scope scope(rm);
+    const F res = op();
+    flags |= scope.flags();
+    return canonicalize(res);
+  }
+
+  template <typename F>
+  static F add(F a, F b, unsigned rm, unsigned &flags) {
+    return execute<F>(rm, flags, [=] {
+      volatile F x = a, y = b;
+      volatile F res = x + y;
+      return res;
+    });
+  }
+  template <typename F>
+  static F sub(F a, F b, unsigned rm, unsigned &flags) {
+    return execute<F>(rm, flags, [=] {
+      volatile F x = a, y = b;
+      volatile F res = x - y;
+      return res;
+    });
+  }
+  template <typename F>
+  static F mul(F a, F b, unsigned rm, unsigned &flags) {
+    return execute<F>(rm, flags, [=] {
+      volatile F x = a, y = b;
+      volatile F res = x * y;
+      return res;
+    });
+  }
+  template <typename F>
+  static F div(F a, F b, unsigned rm, unsigned &flags) {
+    return execute<F>(rm, flags, [=] {
+      volatile F x = a, y = b;
+      volatile F res = x / y;
+      return res;
+    });
+  }
+  template <typename F>
+  static F sqrt(F a, unsigned rm, unsigned &flags) {
+    return execute<F>(rm, flags, [=] {
+      volatile F x = a;
+      volatile F res = std::sqrt(x);
+      return res;
+    });
+  }
+
+  /// Computes (+/-)(a * b) (+/-) c with a single rounding, for the four fused
+  /// multiply-add instructions.
+  template <typename F>
+  static F fma(F a, F b, F c, bool negateProduct, bool negateAddend,
+               unsigned rm, unsigned &flags) {
+    // The product of infinity and zero is invalid, even if c is a quiet NaN.
+    if ((std::isinf(a) && b == 0) || (a == 0 && std::isinf(b)))
+      flags |= NV;
+    return execute<F>(rm, flags, [=] {
+      volatile F x = negateProduct ? -a : a, y = b;
+      volatile F z = negateAddend ? -c : c;
+      volatile F res = std::fma(x, y, z);
+      return res;
+    });
+  }
+
+  /// Sign injection of fsgnj, fsgnjn and fsgnjx, on the bits of the operands.
+  template <typename F>
+  static Bits<F> signInject(Bits<F> a, Bits<F> b, bool negate, bool xorSign) {
+    constexpr Bits<F> sign = signBit<F>();
+    Bits<F> s = b & sign;
+    if (negate)
+      s ^= sign;
+    if (xorSign)
+      s = (a ^ b) & sign;
+    return (a & ~sign) | s;
+  }
+
+  /// fmin and fmax: -0 orders before +0, and a NaN operand yields the other
+  /// operand. sNaN operands are invalid.
+  template <typename F>
+  static F minMax(F a, F b, bool max, unsigned &flags) {
+    if (isSignalingNaN(a) || isSignalingNaN(b))
+      flags |= NV;
+    if (std::isnan(a) && std::isnan(b))
+      return fromBits<F>(canonicalNaN<F>());
+    if (std::isnan(a))
+      return b;
+    if (std::isnan(b))
+      return a;
+    if (a == b) {
+      // Orders -0 and +0 by their sign bits.
+      const bool aNegative = std::signbit(a);
+      return aNegative == max ? b : a;
+    }
+    return (a < b) != max ? a : b;
+  }
+
+  /// feq is a quiet comparison, invalid only for sNaN operands; flt and fle
+  /// are signaling comparisons, invalid for any NaN operand.
+  template <typename F>
+  static bool eq(F a, F b, unsigned &flags) {
+    if (isSignalingNaN(a) || isSignalingNaN(b))
+      flags |= NV;
+    return !std::isnan(a) && !std::isnan(b) && a == b;
+  }
+  template <typename F>
+  static bool lt(F a, F b, unsigned &flags) {
+    if (std::isnan(a) || std::isnan(b)) {
+      flags |= NV;
+      return false;
+    }
+    return a < b;
+  }
+  template <typename F>
+  static bool le(F a, F b, unsigned &flags) {
+    if (std::isnan(a) || std::isnan(b)) {
+      flags |= NV;
+      return false;
+    }
+    return a <= b;
+  }
+
+  /// The fclass mask of @p v.
+  template <typename F>
+  static unsigned classify(F v) {
+    const bool negative = std::signbit(v);
+    switch (std::fpclassify(v)) {
+    case FP_INFINITE:
+      return negative ? 1 << 0 : 1 << 7;
+    case FP_NORMAL:
+      return negative ? 1 << 1 : 1 << 6;
+    case FP_SUBNORMAL:
+      return negative ? 1 << 2 : 1 << 5;
+    case FP_ZERO:
+      return negative ? 1 << 3 : 1 << 4;
+    default:
+      return isSignalingNaN(v) ? 1 << 8 : 1 << 9;
+    }
+  }
+
+  /// Converts @p v to the integer type I, rounding with @p rm. Values out of
+  /// the range of I saturate, and NaNs convert to the largest value of I; both
+  /// are invalid.
+  template <typename I, typename F>
+  static I toInt(F v, unsigned rm, unsigned &flags) {
+    if (std::isnan(v)) {
+      flags |= NV;
+      return std::numeric_limits<I>::max();
+    }
+    const F rounded = roundToIntegral(v, rm);
+    // The bounds of I are powers of two, and thereby exact in F.
+    const F upper = std::ldexp(F(1), std::numeric_limits<I>::digits);
+    const F lower = std::is_signed_v<I> ? -upper : F(0);
+    if (!(rounded >= lower && rounded < upper)) {
+      flags |= NV;
+      return rounded < 0 ? std::numeric_limits<I>::min()
+                         : std::numeric_limits<I>::max();
+    }
+    if (rounded != v)
+      flags |= NX;
+    return static_cast<I>(rounded);
+  }
+
+  /// Converts the integer @p v to F, rounding with @p rm.
+  template <typename F, typename I>
+  static F fromInt(I v, unsigned rm, unsigned &flags) {
+    return execute<F>(rm, flags, [=] {
+      volatile I x = v;
+      volatile F res = static_cast<F>(x);
+      return res;
+    });
+  }
+
+  /// Converts between the single- and double-precision formats.
+  template <typename To, typename From>
+  static To convert(From v, unsigned rm, unsigned &flags) {
+    return execute<To>(rm, flags, [=] {
+      volatile From x = v;
+      volatile To res = static_cast<To>(x);
+      return res;
+    });
+  }
+
+private:
+  /// Rounds @p v to an integral value with the rounding mode @p rm, without
+  /// depending on the host rounding mode.
+  template <typename F>
+  static F roundToIntegral(F v, unsigned rm) {
+    switch (rm) {
+    case RTZ:
+      return std::trunc(v);
+    case RDN:
+      return std::floor(v);
+    case RUP:
+      return std::ceil(v);
+    case RMM:
+      return std::round(v);
+    default: {
+      // Ties to even. The fraction of v is exact in F.
+      const F down = std::floor(v);
+      const F fraction = v - down;
+      if (fraction > F(0.5))
+        return down + 1;
+      if (fraction < F(0.5))
+        return down;
+      return std::fmod(down, F(2)) == 0 ? down : down + 1;
+    }
+    }
+  }
+};
+
+} // namespace core
+} // namespace vsrtl
@@ -2,6 +2,7 @@
 
 #include "VSRTL/core/vsrtl_component.h"
 
+#include "../componentprofiler.h"
 #include "riscv.h"
 
 namespace vsrtl {
@@ -17,71 +18,110 @@ public:
       : Component(name, parent) {
     setDescription("Immediate value decoder");
     imm << [=] {
-      Switch(opcode, RVInstr) {
-      case RVInstr::LUI:
-      case RVInstr::AUIPC:
-        return VT_U(signextend<32>(instr.uValue() & 0xfffff000));
-      case RVInstr::JAL: {
-        const auto fields =
-            RVInstrParser::getParser()->decodeJ32Instr(instr.uValue());
-        return VT_U(signextend<21>(fields[0] << 20 | fields[1] << 1 |
-                                   fields[2] << 11 | fields[3] << 12));
-      }
-      case RVInstr::JALR: {
-        return VT_U(signextend<12>((instr.uValue() >> 20)));
-      }
-      case RVInstr::BEQ:
-      case RVInstr::BNE:
-      case RVInstr::BLT:
-      case RVInstr::BGE:
-      case RVInstr::BLTU:
-      case RVInstr::BGEU: {
-        const auto fields =
-            RVInstrParser::getParser()->decodeB32Instr(instr.uValue());
-        return VT_U(signextend<13>((fields[0] << 12) | (fields[1] << 5) |
-                                   (fields[5] << 1) | (fields[6] << 11)));
-      }
-      case RVInstr::LB:
-      case RVInstr::LH:
-      case RVInstr::LW:
-      case RVInstr::LBU:
-      case RVInstr::LHU:
-      case RVInstr::LWU:
-      case RVInstr::LD:
-      case RVInstr::ADDI:
-      case RVInstr::SLTI:
-      case RVInstr::SLTIU:
-      case RVInstr::XORI:
-      case RVInstr::ORI:
-      case RVInstr::ANDI:
-      case RVInstr::ADDIW:
-        return VT_U(signextend<12>((instr.uValue() >> 20)));
-      case RVInstr::SLLI:
-      case RVInstr::SRLI:
-      case RVInstr::SRAI: {
-        if constexpr (XLEN == 32) {
-          return VT_U((instr.uValue() >> 20) & 0b11111);
-        } else {
-          return VT_U((instr.uValue() >> 20) & 0b111111);
-        }
-      }
-      case RVInstr::SLLIW:
-      case RVInstr::SRLIW:
-      case RVInstr::SRAIW:
-        return VT_U((instr.uValue() >> 20) & 0b11111);
-      case RVInstr::SB:
-      case RVInstr::SH:
-      case RVInstr::SW:
-      case RVInstr::SD: {
-        return VT_U(signextend<12>(((instr.uValue() & 0xfe000000)) >> 20) |
-                    ((instr.uValue() & 0xf80) >> 7));
-      }
-      default:
-        return VT_U(0xDEADBEEF);
-      }
+      RIPES_PROFILE_COMPONENT(name);
+      return decodeImmediate(opcode.uValue(), instr.uValue());
     };
   }
 
+  /**
+   * @brief decodeImmediate
+   * Returns the sign-extended immediate value of the (uncompressed) instruction
+   * word @p instr, given its decoded RVInstr @p opcode.
+   */
+  static VSRTL_VT_U decodeImmediate(const VSRTL_VT_U opcode,
+                                    const VSRTL_VT_U instr) {
+    switch (opcode) {
+    case RVInstr::LUI:
+    case RVInstr::AUIPC:
+      return VT_U(signextend<32>(instr & 0xfffff000));
+    case RVInstr::JAL: {
+      const auto fields = RVInstrParser::decodeJ32Instr(instr);
+      return VT_U(signextend<21>(fields[0] << 20 | fields[1] << 1 |
+                                 fields[2] << 11 | fields[3] << 12));
+    }
+    case RVInstr::JALR: {
+      return VT_U(signextend<12>((instr >> 20)));
+    }
+    case RVInstr::BEQ:
+    case RVInstr::BNE:
+    case RVInstr::BLT:
+    case RVInstr::BGE:
+    case RVInstr::BLTU:
+    case RVInstr::BGEU: {
+      const auto fields = RVInstrParser::decodeB32Instr(instr);
+      return VT_U(signextend<13>((fields[0] << 12) | (fields[1] << 5) |
+                                 (fields[5] << 1) | (fields[6] << 11)));
+    }
+    case RVInstr::LB:
+    case RVInstr::LH:
+    case RVInstr::LW:
+    case RVInstr::LBU:
+    case RVInstr::LHU:
+    case RVInstr::LWU:
+    case RVInstr::LD:
+    case RVInstr::FLW:
+    case RVInstr::FLD:
+    case RVInstr::ADDI:
+    case RVInstr::SLTI:
+    case RVInstr::SLTIU:
+    case RVInstr::XORI:
+    case RVInstr::ORI:
+    case RVInstr::ANDI:
+    case RVInstr::ADDIW:
+      return VT_U(signextend<12>((instr >> 20)));
+    case RVInstr::SLLI:
+    case RVInstr::SRLI:
+    case RVInstr::SRAI: {
+      if constexpr (XLEN == 32) {
+        return VT_U((instr >> 20) & 0b11111);
+      } else {
+        return VT_U((instr >> 20) & 0b111111);
+      }
+    }
+    case RVInstr::SLLIW:
+    case RVInstr::SRLIW:
+    case RVInstr::SRAIW:
+      return VT_U((instr >> 20) & 0b11111);
+    case RVInstr::CSRRS:
+    case RVInstr::CSRRW:
+    case RVInstr::CSRRC:
+    case RVInstr::CSRRWI:
+    case RVInstr::CSRRSI:
+    case RVInstr::CSRRCI:
+      // The CSR number, zero-extended.
+      return VT_U((instr >> 20) & 0xfff);
+    case RVInstr::SB:
+    case RVInstr::SH:
+    case RVInstr::SW:
+    case RVInstr::SD:
+    case RVInstr::FSW:
+    case RVInstr::FSD: {
+      return VT_U(signextend<12>(((instr & 0xfe000000)) >> 20) |
+                  ((instr & 0xf80) >> 7));
+    }
+    case RVInstr::VSETVLI:
+      // The new vtype (zimm), zero-extended.
+      return VT_U((instr >> 20) & 0x7ff);
+    case RVInstr::VSETIVLI:
+      return VT_U((instr >> 20) & 0x3ff);
+    case RVInstr::VADD_VI:
+    case RVInstr::VRSUB_VI:
+    case RVInstr::VAND_VI:
+    case RVInstr::VOR_VI:
+    case RVInstr::VXOR_VI:
+    case RVInstr::VMV_V_I:
+      // simm5, in place of vs1.
+      return VT_U(signextend<5>((instr >> 15) & 0b11111));
+    case RVInstr::VSLL_VI:
+    case RVInstr::VSRL_VI:
+    case RVInstr::VSRA_VI:
+      // The shift amount (uimm5), in place of vs1.
+      return VT_U((instr >> 15) & 0b11111);
+    default:
+      return VT_U(0xDEADBEEF);
+    }
+  }
+
   INPUTPORT_ENUM(opcode, RVInstr);
   INPUTPORT(instr, c_RVInstrWidth);
   OUTPUTPORT(imm, XLEN);
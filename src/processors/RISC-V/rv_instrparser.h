@@ -1,44 +1,41 @@
 #pragma once
 
+#include <array>
+#include <climits>
+#include <type_traits>
+
 #include "../../binutils.h"
-#include <assert.h>
-#include <functional>
-#include <numeric>
 
 namespace Ripes {
 
-template <typename T>
-using decode_functor = std::function<std::vector<T>(T)>;
-
-template <typename T>
-decode_functor<T> generateInstrParser(const std::vector<int> &bitFields) {
-  constexpr int size_bits = sizeof(T) * CHAR_BIT;
-  static_assert(isPowerOf2(size_bits) && size_bits >= 32,
+template <typename T, unsigned... BitFields>
+using InstrFields = std::array<T, sizeof...(BitFields)>;
+
+/**
+ * @brief parseInstrFields
+ * Splits @p word into bit fields of the widths given by @p BitFields, listed
+ * from LSB to MSB. The returned fields are ordered from MSB to LSB. Field
+ * widths are known at compile time, so decoding is allocation free and fully
+ * inlineable.
+ */
+template <typename T, unsigned... BitFields>
+constexpr InstrFields<T, BitFields...> parseInstrFields(T word) {
+  constexpr unsigned size_bits = sizeof(T) * CHAR_BIT;
+  static_assert(std::is_unsigned<T>::value && size_bits >= 32,
                 "Invalid word size parameter");
-  // Generates functors that can decode a binary number based on the input
-  // vector which is supplied upon generation
-  assert(std::accumulate(bitFields.begin(), bitFields.end(), 0) == size_bits &&
-         "Requested word parsing format is not T-bits in length");
-
-  // Generate vector of <fieldsize,bitmask>
-  std::vector<std::pair<uint32_t, uint32_t>> parseVector;
-
-  // Generate bit masks and fill parse vector
-  for (const auto &field : bitFields) {
-    parseVector.emplace_back(field, vsrtl::generateBitmask(field));
+  static_assert((BitFields + ...) == size_bits,
+                "Requested word parsing format is not T-bits in length");
+
+  constexpr unsigned widths[] = {BitFields...};
+  constexpr unsigned nFields = sizeof...(BitFields);
+  InstrFields<T, BitFields...> fields{};
+  for (unsigned i = 0; i < nFields; ++i) {
+    const unsigned width = widths[i];
+    const T mask = width >= size_bits ? ~T(0) : (T(1) << width) - 1;
+    fields[nFields - 1 - i] = word & mask;
+    word = width >= size_bits ? 0 : word >> width;
   }
-
-  // Create parse functor
-  decode_functor<T> instrParser = [=](T word) {
-    std::vector<T> parsedWord;
-    for (const auto &field : parseVector) {
-      parsedWord.insert(parsedWord.begin(), word & field.second);
-      word = word >> field.first;
-    }
-    return parsedWord;
-  };
-
-  return instrParser;
+  return fields;
 }
 
 } // namespace Ripes
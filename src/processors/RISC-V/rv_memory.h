@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../componentprofiler.h"
 #include "VSRTL/core/vsrtl_memory.h"
 #include "VSRTL/core/vsrtl_wire.h"
 #include "riscv.h"
@@ -20,6 +21,7 @@ public:
 
     wr_width->setSensitiveTo(&op);
     wr_width->out << [=] {
+      RIPES_PROFILE_COMPONENT(name);
       switch (op.uValue()) {
       case MemOp::SB:
         return 1;
@@ -36,6 +38,7 @@ public:
     wr_width->out >> mem->wr_width;
 
     data_out << [=] {
+      RIPES_PROFILE_COMPONENT(name);
       const auto &value = mem->data_out.uValue();
       switch (op.uValue()) {
       case MemOp::LB:
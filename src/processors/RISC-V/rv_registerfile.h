@@ -4,6 +4,7 @@
 #include "VSRTL/core/vsrtl_memory.h"
 #include "VSRTL/core/vsrtl_wire.h"
 
+#include "../componentprofiler.h"
 #include "riscv.h"
 
 namespace vsrtl {
@@ -20,7 +21,10 @@ public:
 
     // Disable writes to register 0
     wr_en_0->setSensitiveTo(wr_en);
-    wr_en_0->out << [=] { return wr_en.uValue() && wr_addr.uValue() != 0; };
+    wr_en_0->out << [=] {
+      RIPES_PROFILE_COMPONENT(name);
+      return wr_en.uValue() && wr_addr.uValue() != 0;
+    };
 
     wr_addr >> _wr_mem->addr;
     wr_en_0->out >> _wr_mem->wr_en;
@@ -40,6 +44,7 @@ public:
      */
     if constexpr (readBypass) {
       r1_out << [=] {
+        RIPES_PROFILE_COMPONENT(name);
         const int rd_idx = r1_addr.uValue();
         if (rd_idx == 0) {
           return VT_U(0);
@@ -54,6 +59,7 @@ public:
       };
 
       r2_out << [=] {
+        RIPES_PROFILE_COMPONENT(name);
         const unsigned rd_idx = r2_addr.uValue();
         if (rd_idx == 0) {
           return VT_U(0);
@@ -91,11 +97,10 @@ public:
                                   XLEN / CHAR_BIT);
   }
 
-  std::vector<VSRTL_VT_U> getRegisters() {
-    std::vector<VSRTL_VT_U> regs;
+  void getRegisters(std::vector<VInt> &regs) const {
+    regs.resize(c_RVRegs);
     for (int i = 0; i < c_RVRegs; ++i)
-      regs.push_back(getRegister(i));
-    return regs;
+      regs[i] = getRegister(i);
   }
 
   void setMemory(AddressSpace *mem) {
@@ -0,0 +1,272 @@
+#pragma once
+
+#include "../interface/branchpredictor.h"
+#include "riscv.h"
+
+namespace vsrtl {
+namespace core {
+using namespace Ripes;
+
+/**
+ * @brief The RVTiming struct
+ * Classification of RISC-V instructions shared by the timing models (see
+ * RVSuperscalar and RVOutOfOrder): the functional unit executing an
+ * instruction, the registers it reads and writes, and the kind of control
+ * transfer it predicts as.
+ *
+ * Instructions of the F and D extensions execute on the ALUs, or the memory
+ * unit for loads and stores. Their floating-point register operands are
+ * reported by the indices of the registers, as are integer registers, such
+ * that floating-point dependencies are tracked alongside (and conservatively
+ * alias) the integer dependencies. The rs3 operand of fused multiply-adds is
+ * not tracked.
+ *
+ * Likewise, instructions of the V extension execute on the ALUs, or the memory
+ * unit for loads and stores, with vector registers reported by their indices.
+ * Register groups, vl and vtype, and the vs3 operand of stores are not
+ * tracked.
+ */
+struct RVTiming {
+  enum class Unit { ALU, MulDiv, Branch, Memory, System };
+  static constexpr unsigned NUnits = static_cast<unsigned>(Unit::System) + 1;
+
+  static Unit unitOf(RVInstr opc) {
+    if (isAtomic(opc))
+      return Unit::Memory;
+    switch (opc) {
+    case RVInstr::LB:
+    case RVInstr::LH:
+    case RVInstr::LW:
+    case RVInstr::LBU:
+    case RVInstr::LHU:
+    case RVInstr::LWU:
+    case RVInstr::LD:
+    case RVInstr::SB:
+    case RVInstr::SH:
+    case RVInstr::SW:
+    case RVInstr::SD:
+    case RVInstr::FLW:
+    case RVInstr::FSW:
+    case RVInstr::FLD:
+    case RVInstr::FSD:
+    case RVInstr::VLE8_V:
+    case RVInstr::VLE16_V:
+    case RVInstr::VLE32_V:
+    case RVInstr::VLE64_V:
+    case RVInstr::VSE8_V:
+    case RVInstr::VSE16_V:
+    case RVInstr::VSE32_V:
+    case RVInstr::VSE64_V:
+      return Unit::Memory;
+    case RVInstr::BEQ:
+    case RVInstr::BNE:
+    case RVInstr::BLT:
+    case RVInstr::BGE:
+    case RVInstr::BLTU:
+    case RVInstr::BGEU:
+    case RVInstr::JAL:
+    case RVInstr::JALR:
+      return Unit::Branch;
+    case RVInstr::MUL:
+    case RVInstr::MULH:
+    case RVInstr::MULHSU:
+    case RVInstr::MULHU:
+    case RVInstr::DIV:
+    case RVInstr::DIVU:
+    case RVInstr::REM:
+    case RVInstr::REMU:
+    case RVInstr::MULW:
+    case RVInstr::DIVW:
+    case RVInstr::DIVUW:
+    case RVInstr::REMW:
+    case RVInstr::REMUW:
+      return Unit::MulDiv;
+    case RVInstr::ECALL:
+    case RVInstr::CSRRW:
+    case RVInstr::CSRRS:
+    case RVInstr::CSRRC:
+    case RVInstr::CSRRWI:
+    case RVInstr::CSRRSI:
+    case RVInstr::CSRRCI:
+    case RVInstr::MRET:
+    case RVInstr::WFI:
+      return Unit::System;
+    default:
+      return Unit::ALU;
+    }
+  }
+
+  static BranchPredictor::Kind controlKind(RVInstr opc, unsigned rd,
+                                           unsigned rs1) {
+    // Calls and returns follow the register conventions of the RISC-V
+    // specification, with x1 or x5 as the link register.
+    const auto isLink = [](unsigned reg) { return reg == 1 || reg == 5; };
+    switch (opc) {
+    case RVInstr::JAL:
+      return isLink(rd) ? BranchPredictor::Kind::Call
+                        : BranchPredictor::Kind::Jump;
+    case RVInstr::JALR:
+      if (isLink(rd))
+        return BranchPredictor::Kind::Call;
+      return rd == 0 && isLink(rs1) ? BranchPredictor::Kind::Return
+                                    : BranchPredictor::Kind::Jump;
+    default:
+      return BranchPredictor::Kind::Branch;
+    }
+  }
+
+  static bool isLoad(RVInstr opc) {
+    switch (opc) {
+    case RVInstr::LB:
+    case RVInstr::LH:
+    case RVInstr::LW:
+    case RVInstr::LBU:
+    case RVInstr::LHU:
+    case RVInstr::LWU:
+    case RVInstr::LD:
+    case RVInstr::LR_W:
+    case RVInstr::LR_D:
+    case RVInstr::FLW:
+    case RVInstr::FLD:
+    case RVInstr::VLE8_V:
+    case RVInstr::VLE16_V:
+    case RVInstr::VLE32_V:
+    case RVInstr::VLE64_V:
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  /// Whether @p opc is an LR, SC or AMO of the A extension.
+  static bool isAtomic(RVInstr opc) {
+    return opc >= RVInstr::LR_W && opc <= RVInstr::AMOMAXU_D;
+  }
+
+  /// Whether @p opc is an instruction of the F or D extension.
+  static bool isFP(RVInstr opc) {
+    return opc >= RVInstr::FLW && opc <= RVInstr::FCVT_D_S;
+  }
+
+  /// Whether @p opc is an instruction of the V extension.
+  static bool isVector(RVInstr opc) {
+    return opc >= RVInstr::VSETVLI && opc <= RVInstr::VMV_S_X;
+  }
+
+  static bool isDivision(RVInstr opc) {
+    switch (opc) {
+    case RVInstr::DIV:
+    case RVInstr::DIVU:
+    case RVInstr::REM:
+    case RVInstr::REMU:
+    case RVInstr::DIVW:
+    case RVInstr::DIVUW:
+    case RVInstr::REMW:
+    case RVInstr::REMUW:
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  static bool isMultiplication(RVInstr opc) {
+    return unitOf(opc) == Unit::MulDiv && !isDivision(opc);
+  }
+
+  static bool readsRs1(RVInstr opc) {
+    switch (opc) {
+    case RVInstr::NOP:
+    case RVInstr::LUI:
+    case RVInstr::AUIPC:
+    case RVInstr::JAL:
+    case RVInstr::CSRRWI:
+    case RVInstr::CSRRSI:
+    case RVInstr::CSRRCI:
+    case RVInstr::ECALL:
+    case RVInstr::MRET:
+    case RVInstr::WFI:
+    case RVInstr::VSETIVLI:
+      return false;
+    default:
+      return true;
+    }
+  }
+
+  static bool readsRs2(RVInstr opc) {
+    switch (opc) {
+    case RVInstr::BEQ:
+    case RVInstr::BNE:
+    case RVInstr::BLT:
+    case RVInstr::BGE:
+    case RVInstr::BLTU:
+    case RVInstr::BGEU:
+    case RVInstr::SB:
+    case RVInstr::SH:
+    case RVInstr::SW:
+    case RVInstr::SD:
+    case RVInstr::ADD:
+    case RVInstr::SUB:
+    case RVInstr::SLL:
+    case RVInstr::SLT:
+    case RVInstr::SLTU:
+    case RVInstr::XOR:
+    case RVInstr::SRL:
+    case RVInstr::SRA:
+    case RVInstr::OR:
+    case RVInstr::AND:
+    case RVInstr::ADDW:
+    case RVInstr::SUBW:
+    case RVInstr::SLLW:
+    case RVInstr::SRLW:
+    case RVInstr::SRAW:
+    case RVInstr::FSW:
+    case RVInstr::FSD:
+    case RVInstr::VSETVL:
+      return true;
+    case RVInstr::LR_W:
+    case RVInstr::LR_D:
+      return false;
+    default:
+      if (isFP(opc)) {
+        // The D instructions follow their F counterparts in RVInstr.
+        unsigned f = opc;
+        if (opc >= RVInstr::FLD)
+          f -= RVInstr::FLD - RVInstr::FLW;
+        return (f >= RVInstr::FMADD_S && f <= RVInstr::FDIV_S) ||
+               (f >= RVInstr::FSGNJ_S && f <= RVInstr::FLE_S);
+      }
+      if (isVector(opc)) {
+        // The arithmetic operations, reductions and vmv.x.s read vs2.
+        return opc >= RVInstr::VADD_VV && opc <= RVInstr::VMV_X_S &&
+               !(opc >= RVInstr::VMV_V_V && opc <= RVInstr::VMV_V_I);
+      }
+      return unitOf(opc) == Unit::MulDiv || isAtomic(opc);
+    }
+  }
+
+  static bool writesRd(RVInstr opc) {
+    switch (opc) {
+    case RVInstr::NOP:
+    case RVInstr::SB:
+    case RVInstr::SH:
+    case RVInstr::SW:
+    case RVInstr::SD:
+    case RVInstr::FSW:
+    case RVInstr::FSD:
+    case RVInstr::VSE8_V:
+    case RVInstr::VSE16_V:
+    case RVInstr::VSE32_V:
+    case RVInstr::VSE64_V:
+    case RVInstr::ECALL:
+    case RVInstr::MRET:
+    case RVInstr::WFI:
+      return false;
+    default:
+      return unitOf(opc) != Unit::Branch || opc == RVInstr::JAL ||
+             opc == RVInstr::JALR;
+    }
+  }
+};
+
+} // namespace core
+} // namespace vsrtl
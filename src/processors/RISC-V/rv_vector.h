@@ -0,0 +1,310 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The RVVectorUnit class
+ * The architectural state and operations of the implemented subset of the V
+ * extension: the 32 vector registers of VLEN bits, vl and vtype, unit-stride
+ * loads and stores, and unmasked integer operations and reductions.
+ *
+ * The registers of a register group (LMUL > 1) are consecutive registers,
+ * which are contiguous in the register file, such that an operation is a
+ * single loop over contiguous arrays of elements of SEW bits. The loops are
+ * free of dependencies between elements, and are thereby vectorized by the
+ * compiler to host SIMD instructions. Elements are stored in host byte order,
+ * which is the little-endian order of memory on the hosts Ripes supports.
+ *
+ * ELEN is 64. Elements past vl (the tail) are left undisturbed, which
+ * satisfies both the tail-undisturbed and tail-agnostic policies, and vstart
+ * is always 0. Operations with an invalid vtype (vill), or with register
+ * groups which are misaligned or exceed the register file, are reserved and
+ * return false.
+ */
+class RVVectorUnit {
+public:
+  static constexpr unsigned ELEN = 64;
+  static constexpr unsigned s_regs = 32;
+
+  /// Integer operations; the reductions are those of Add to Max.
+  enum class Op {
+    Add,
+    Sub,
+    RSub,
+    MinU,
+    Min,
+    MaxU,
+    Max,
+    And,
+    Or,
+    Xor,
+    Sll,
+    Srl,
+    Sra,
+    Mul,
+    Mv
+  };
+  /// The second operand of an operation; the elements of vs1 (VV), or a
+  /// scalar of an integer register (VX) or immediate (VI).
+  enum class Form { VV, VX, VI };
+
+  /// Clears the registers, resizing them to @p vlen bits, and sets vill.
+  void reset(unsigned vlen) {
+    m_vlenb = vlen / 8;
+    m_regs.assign(s_regs * m_vlenb, 0);
+    m_vl = 0;
+    m_vtype = 0;
+    m_vill = true;
+  }
+
+  unsigned vlenb() const { return m_vlenb; }
+  uint64_t vl() const { return m_vl; }
+  /// The vtype CSR, excluding vill (see vill()).
+  uint64_t vtype() const { return m_vill ? 0 : m_vtype; }
+  bool vill() const { return m_vill; }
+
+  /**
+   * @brief setVL
+   * Executes vsetvl, vsetvli and vsetivli: sets vtype to @p vtype, and vl to
+   * the application vector length @p avl, limited to VLMAX. If @p keepVL is
+   * set (rd = rs1 = x0), vl is kept, limited to the new VLMAX. An unsupported
+   * vtype sets vill, and a vl of 0. Returns the new vl.
+   */
+  uint64_t setVL(uint64_t avl, uint64_t vtype, bool keepVL) {
+    const unsigned vlmul = vtype & 0b111;
+    const unsigned vsew = (vtype >> 3) & 0b111;
+    // LMUL in eighths; vlmul 5 to 7 are the fractional LMULs 1/8 to 1/2.
+    const unsigned lmul8 = vlmul < 4 ? 8u << vlmul : 8u >> (8 - vlmul);
+    const unsigned sew = 8u << vsew;
+    m_vill = (vtype >> 8) != 0 || vlmul == 4 || vsew > 3 ||
+             sew * 8 > ELEN * lmul8;
+    const uint64_t vlmax = m_vill ? 0 : m_vlenb * lmul8 / sew;
+    if (m_vill || vlmax == 0) {
+      m_vill = true;
+      m_vtype = 0;
+      m_vl = 0;
+      return 0;
+    }
+    m_vtype = vtype;
+    m_sewBytes = sew / 8;
+    m_lmul8 = lmul8;
+    m_vl = std::min(keepVL ? m_vl : avl, vlmax);
+    return m_vl;
+  }
+
+  /// Executes the unit-stride load of the elements below vl, of @p eewBytes
+  /// each, into the register group of @p vd. @p read(offset, bytes) returns
+  /// the element at the byte offset of the access.
+  template <typename Read>
+  bool load(unsigned vd, unsigned eewBytes, Read &&read) {
+    if (m_vill || !validGroup(vd, eewBytes))
+      return false;
+    withWidth(eewBytes, [&](auto t) {
+      using T = decltype(t);
+      for (uint64_t i = 0; i < m_vl; ++i)
+        set<T>(vd, i, static_cast<T>(read(i * eewBytes, eewBytes)));
+    });
+    return true;
+  }
+
+  /// Executes the unit-stride store of the elements below vl of the register
+  /// group of @p vs3, through @p write(offset, bytes, value).
+  template <typename Write>
+  bool store(unsigned vs3, unsigned eewBytes, Write &&write) const {
+    if (m_vill || !validGroup(vs3, eewBytes))
+      return false;
+    withWidth(eewBytes, [&](auto t) {
+      using T = decltype(t);
+      for (uint64_t i = 0; i < m_vl; ++i)
+        write(i * eewBytes, eewBytes, get<T>(vs3, i));
+    });
+    return true;
+  }
+
+  /// Executes vd[i] = op(vs2[i], b) for the elements below vl, where b is
+  /// vs1[i] in the VV form, and the low SEW bits of @p scalar otherwise.
+  /// Shift amounts are the low log2(SEW) bits of b.
+  bool arith(Op op, Form form, unsigned vd, unsigned vs2, unsigned vs1,
+             uint64_t scalar) {
+    if (m_vill || !validGroup(vd, m_sewBytes) ||
+        !validGroup(vs2, m_sewBytes) ||
+        (form == Form::VV && !validGroup(vs1, m_sewBytes)))
+      return false;
+    withWidth(m_sewBytes, [&](auto t) {
+      using T = decltype(t);
+      withOperation<T>(op, [&](auto fn) {
+        uint8_t *d = group(vd);
+        const uint8_t *a = group(vs2);
+        if (form == Form::VV) {
+          const uint8_t *b = group(vs1);
+          for (uint64_t i = 0; i < m_vl; ++i) {
+            storeElement<T>(d, i,
+                            fn(loadElement<T>(a, i), loadElement<T>(b, i)));
+          }
+        } else {
+          const T b = static_cast<T>(scalar);
+          for (uint64_t i = 0; i < m_vl; ++i)
+            storeElement<T>(d, i, fn(loadElement<T>(a, i), b));
+        }
+      });
+    });
+    return true;
+  }
+
+  /// Executes the reduction vd[0] = op(vs1[0], vs2[0], ..., vs2[vl - 1]). The
+  /// destination is unchanged if vl is 0.
+  bool reduce(Op op, unsigned vd, unsigned vs2, unsigned vs1) {
+    if (m_vill || !validGroup(vs2, m_sewBytes))
+      return false;
+    if (m_vl == 0)
+      return true;
+    withWidth(m_sewBytes, [&](auto t) {
+      using T = decltype(t);
+      withOperation<T>(op, [&](auto fn) {
+        const uint8_t *a = group(vs2);
+        T acc = get<T>(vs1, 0);
+        for (uint64_t i = 0; i < m_vl; ++i)
+          acc = fn(acc, loadElement<T>(a, i));
+        set<T>(vd, 0, acc);
+      });
+    });
+    return true;
+  }
+
+  /// Element 0 of @p vs2, sign-extended from SEW bits (vmv.x.s).
+  bool moveToScalar(unsigned vs2, int64_t &value) const {
+    if (m_vill)
+      return false;
+    withWidth(m_sewBytes, [&](auto t) {
+      using T = decltype(t);
+      value = static_cast<std::make_signed_t<T>>(get<T>(vs2, 0));
+    });
+    return true;
+  }
+
+  /// Sets element 0 of @p vd to the low SEW bits of @p value, if vl > 0
+  /// (vmv.s.x).
+  bool moveFromScalar(unsigned vd, uint64_t value) {
+    if (m_vill)
+      return false;
+    if (m_vl == 0)
+      return true;
+    withWidth(m_sewBytes, [&](auto t) {
+      using T = decltype(t);
+      set<T>(vd, 0, static_cast<T>(value));
+    });
+    return true;
+  }
+
+private:
+  /// Whether the register group of @p reg, holding vl elements of @p eewBytes
+  /// each, is aligned to its size (EMUL = EEW / SEW * LMUL) and within the
+  /// register file.
+  bool validGroup(unsigned reg, unsigned eewBytes) const {
+    const unsigned emul8 = m_lmul8 * eewBytes / m_sewBytes;
+    if (emul8 == 0 || emul8 > 64)
+      return false;
+    const unsigned regs = std::max(emul8 / 8, 1u);
+    return reg % regs == 0 && reg + regs <= s_regs;
+  }
+
+  template <typename Fn>
+  static void withWidth(unsigned bytes, Fn &&fn) {
+    switch (bytes) {
+    case 1:
+      fn(uint8_t());
+      break;
+    case 2:
+      fn(uint16_t());
+      break;
+    case 4:
+      fn(uint32_t());
+      break;
+    default:
+      fn(uint64_t());
+      break;
+    }
+  }
+
+  /// Calls @p use with the element operation of @p op on elements of type T.
+  template <typename T, typename Use>
+  static void withOperation(Op op, Use &&use) {
+    using S = std::make_signed_t<T>;
+    // Products of narrow elements are computed without signed overflow.
+    using W = std::conditional_t<(sizeof(T) < sizeof(unsigned)), unsigned, T>;
+    constexpr T shiftMask = sizeof(T) * 8 - 1;
+    switch (op) {
+    case Op::Add:
+      return use([](T x, T y) { return T(x + y); });
+    case Op::Sub:
+      return use([](T x, T y) { return T(x - y); });
+    case Op::RSub:
+      return use([](T x, T y) { return T(y - x); });
+    case Op::MinU:
+      return use([](T x, T y) { return std::min(x, y); });
+    case Op::Min:
+      return use([](T x, T y) { return T(std::min(S(x), S(y))); });
+    case Op::MaxU:
+      return use([](T x, T y) { return std::max(x, y); });
+    case Op::Max:
+      return use([](T x, T y) { return T(std::max(S(x), S(y))); });
+    case Op::And:
+      return use([](T x, T y) { return T(x & y); });
+    case Op::Or:
+      return use([](T x, T y) { return T(x | y); });
+    case Op::Xor:
+      return use([](T x, T y) { return T(x ^ y); });
+    case Op::Sll:
+      return use([](T x, T y) { return T(W(x) << (y & shiftMask)); });
+    case Op::Srl:
+      return use([](T x, T y) { return T(x >> (y & shiftMask)); });
+    case Op::Sra:
+      return use([](T x, T y) { return T(S(x) >> (y & shiftMask)); });
+    case Op::Mul:
+      return use([](T x, T y) { return T(W(x) * W(y)); });
+    case Op::Mv:
+      return use([](T, T y) { return y; });
+    }
+  }
+
+  uint8_t *group(unsigned reg) { return &m_regs[reg * m_vlenb]; }
+  const uint8_t *group(unsigned reg) const { return &m_regs[reg * m_vlenb]; }
+
+  template <typename T>
+  static T loadElement(const uint8_t *group, uint64_t i) {
+    T v;
+    std::memcpy(&v, group + i * sizeof(T), sizeof(T));
+    return v;
+  }
+  template <typename T>
+  static void storeElement(uint8_t *group, uint64_t i, T v) {
+    std::memcpy(group + i * sizeof(T), &v, sizeof(T));
+  }
+  template <typename T>
+  T get(unsigned reg, uint64_t i) const {
+    return loadElement<T>(group(reg), i);
+  }
+  template <typename T>
+  void set(unsigned reg, uint64_t i, T v) {
+    storeElement<T>(group(reg), i, v);
+  }
+
+  std::vector<uint8_t> m_regs;
+  unsigned m_vlenb = 0;
+  uint64_t m_vl = 0;
+  uint64_t m_vtype = 0;
+  bool m_vill = true;
+  // SEW in bytes and LMUL in eighths, of the current vtype.
+  unsigned m_sewBytes = 1;
+  unsigned m_lmul8 = 8;
+};
+
+} // namespace core
+} // namespace vsrtl
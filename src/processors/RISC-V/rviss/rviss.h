@@ -0,0 +1,1581 @@
+#pragma once
+
+#include <array>
+#include <limits>
+#include <map>
+#include <memory>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+#include "VSRTL/core/vsrtl_addressspace.h"
+
+#include "../../interface/instructiontrace.h"
+#include "../../interface/ripesprocessor.h"
+#include "../../pagedaddressspace.h"
+
+#include "../riscv.h"
+#include "../rv_decode.h"
+#include "../rv_fpu.h"
+#include "../rv_immediate.h"
+#include "../rv_uncompress.h"
+#include "../rv_vector.h"
+
+namespace vsrtl {
+namespace core {
+using namespace Ripes;
+
+/**
+ * @brief The RVISS class
+ * A functional (instruction set simulator) RISC-V processor. Each clock cycle
+ * fetches, decodes and executes a single instruction directly on the
+ * architectural state, without instantiating or propagating a VSRTL netlist.
+ * Decoding reuses the same routines as the VSRTL Decode, Uncompress and
+ * Immediate components, such that instruction semantics are shared between the
+ * functional and structural models. Intended for fast, non-visual (ie. CLI)
+ * execution where only the final architectural state and retirement counts are
+ * of interest.
+ *
+ * Implements the A extension, with the reservations of LR/SC held in a
+ * ReservationTable, which the harts of a multi-hart processor share. AMOs and
+ * SCs update memory through host atomic operations, such that they are atomic
+ * also while harts execute concurrently; the aq and rl orderings are implied,
+ * since each hart accesses memory in program order.
+ *
+ * Implements the F and D extensions on the host FPU (see RVFPU), with the
+ * floating-point registers, fflags, frm and fcsr. Floating-point registers are
+ * FLEN (32 or 64) bits wide, as seen through the FPR register file; singles are
+ * NaN-boxed within the 64-bit registers of the D extension. Instructions with a
+ * reserved rounding mode execute as NOPs, as do unknown instructions.
+ *
+ * Implements a subset of the V extension (see RVVectorUnit), with vector
+ * registers of RipesProcessor::vlen() bits: vsetvl[i], unit-stride loads and
+ * stores, and unmasked integer arithmetic, moves and reductions. Reserved
+ * vector instructions (ie. with vill set) execute as NOPs. Vector loads and
+ * stores are reported as a single data access, of the first element.
+ *
+ * Implements machine-mode traps for the machine timer interrupt (see
+ * RipesProcessor::timerCompare): mstatus.MIE, mie.MTIE, mtvec (direct mode),
+ * mepc, mcause, mscratch and mret. A wfi, while the timer interrupt is
+ * enabled, skips the idle cycles until the timer fires at once, rather than
+ * simulating them.
+ *
+ * Batches of clocks (see clockBatch) execute translated basic blocks of
+ * predecoded instructions, which are chained to their successors such that
+ * hot code bypasses both decoding and the lookup of each instruction. Stores
+ * invalidate the translated blocks which they overlap.
+ *
+ * Having no microarchitectural state, the hart is saved in full by snapshots
+ * of its registers, CSRs, counters and materialized pages of memory (see
+ * RipesProcessor::saveSnapshot).
+ *
+ * The execution state is accessible to subclasses, such that timing models may
+ * be built on top of the functional execution (see RVSuperscalar), and such
+ * that multiple harts may share a memory (see RVMultiHart).
+ */
+template <typename XLEN_T>
+class RVISS : public RipesProcessor {
+  static_assert(std::is_same<uint32_t, XLEN_T>::value ||
+                    std::is_same<uint64_t, XLEN_T>::value,
+                "Only supports 32- and 64-bit variants");
+  static constexpr unsigned XLEN = sizeof(XLEN_T) * CHAR_BIT;
+  using XLEN_ST = typename std::make_signed<XLEN_T>::type;
+
+public:
+  RVISS(const QStringList &extensions) {
+    m_enabledISA = std::make_shared<ISAInfo<XLenToRVISA<XLEN>()>>(extensions);
+    m_compressed = m_enabledISA->extensionEnabled('C');
+    m_fpDouble = m_enabledISA->extensionEnabled('D');
+    m_features = Features::hasDCacheInterface | Features::hasICacheInterface;
+    if (m_enabledISA->extensionEnabled('A'))
+      m_features |= Features::hasAtomics;
+    m_memory = std::make_shared<PagedAddressSpaceMM>();
+    m_reservations = std::make_shared<ReservationTable>();
+  }
+
+  // Ripes interface compliance
+  const ProcessorStructure &structure() const override { return m_structure; }
+  unsigned int getPcForStage(StageIndex) const override { return m_pc; }
+  AInt nextFetchedAddress() const override { return m_pc; }
+  QString stageName(StageIndex) const override { return "•"; }
+  StageInfo stageInfo(StageIndex) const override {
+    return StageInfo({m_pc, isFetchable(m_pc), StageInfo::State::None});
+  }
+  void setProgramCounter(AInt address) override { m_pc = address; }
+  void setPCInitialValue(AInt address) override { m_pcInitialValue = address; }
+  AddressSpaceMM &getMemory() override { return *m_memory; }
+  VInt getRegister(RegisterFileType rfid, unsigned i) const override {
+    if (rfid == RegisterFileType::FPR)
+      return fpRegister(i);
+    return m_regs.at(i);
+  }
+  void getRegisters(RegisterFileType rfid,
+                    std::vector<VInt> &values) const override {
+    if (rfid == RegisterFileType::FPR) {
+      values.resize(m_fregs.size());
+      for (unsigned i = 0; i < m_fregs.size(); ++i)
+        values[i] = fpRegister(i);
+      return;
+    }
+    values.assign(m_regs.begin(), m_regs.end());
+  }
+  RegisterView registers(RegisterFileType rfid) const override {
+    if (rfid == RegisterFileType::FPR)
+      return RegisterView(m_fregs.data(), m_fregs.size(),
+                          m_fpDouble ? ~0ULL : 0xFFFFFFFFULL);
+    return RegisterView(m_regs.data(), m_regs.size());
+  }
+  void setRegister(RegisterFileType rfid, unsigned i, VInt v) override {
+    if (rfid == RegisterFileType::FPR)
+      m_fregs.at(i) = m_fpDouble ? v : RVFPU::box(static_cast<uint32_t>(v));
+    else if (i != 0)
+      m_regs.at(i) = static_cast<XLEN_T>(v);
+  }
+  std::map<unsigned, VInt> getCSRState() const override {
+    std::map<unsigned, VInt> csrs;
+    for (const unsigned csr : s_stateCSRs)
+      csrs[csr] = static_cast<VInt>(readCSR(csr));
+    return csrs;
+  }
+  void setCSRState(const std::map<unsigned, VInt> &csrs) override {
+    for (const auto &csr : csrs)
+      writeCSR(csr.first, static_cast<XLEN_T>(csr.second));
+  }
+  void finalize(FinalizeReason fr) override {
+    // Instructions are fully retired when executed; there is no pipeline to
+    // drain, so an exit system call finishes execution immediately.
+    if (fr == FinalizeReason::exitSyscall)
+      m_finished = true;
+  }
+  bool finished() const override { return m_finished || !isFetchable(m_pc); }
+  void memoryWritten(AInt address, AInt bytes) override {
+    if (bytes == 0)
+      return;
+    // Ranges written externally may be large (ie. filled from the memory
+    // view). Translations are only looked up within the translated range, and
+    // the predecode cache is scanned rather than probed per byte.
+    const AInt end = address + bytes;
+    const AInt first = std::max(address, m_translatedStart);
+    const AInt last = std::min(end, m_translatedEnd);
+    if (first < last)
+      invalidateTranslated(first, last - first);
+    const AInt start = address >= 3 ? address - 3 : 0;
+    if (end - start < m_predecoded.size()) {
+      for (AInt a = start; a < end; ++a)
+        m_predecoded.erase(a);
+      return;
+    }
+    for (auto it = m_predecoded.begin(); it != m_predecoded.end();) {
+      if (it->first >= start && it->first < end)
+        it = m_predecoded.erase(it);
+      else
+        ++it;
+    }
+  }
+  const std::vector<StageIndex> breakpointTriggeringStages() const override {
+    return {{0, 0}};
+  }
+  MemoryAccess dataMemAccess() const override { return m_dataAccess; }
+  MemoryAccess instrMemAccess() const override { return m_instrAccess; }
+  long long getInstructionsRetired() const override {
+    return m_instructionsRetired;
+  }
+  // Every instruction executes in a single cycle; cycles skipped by wfi are
+  // counted as well.
+  long long getCycleCount() const override { return m_cycleCount; }
+
+  void resetProcessor() override {
+    m_memory->reset();
+    m_reservations->reset();
+    resetHart();
+    if (m_emitsSignals)
+      processorWasReset.Emit();
+  }
+
+  std::shared_ptr<const Snapshot> saveSnapshot() const override {
+    // The timing state of subclasses, and the position within a replayed
+    // trace, are not saved.
+    if (typeid(*this) != typeid(RVISS) || m_trace)
+      return nullptr;
+    auto snapshot = std::make_shared<HartSnapshot>();
+    snapshot->regs = m_regs;
+    snapshot->fregs = m_fregs;
+    snapshot->pc = m_pc;
+    snapshot->instructionsRetired = m_instructionsRetired;
+    snapshot->cycleCount = m_cycleCount;
+    snapshot->finished = m_finished;
+    snapshot->dataAccess = m_dataAccess;
+    snapshot->instrAccess = m_instrAccess;
+    snapshot->csrs = {m_mstatus, m_mie, m_mtvec, m_mscratch, m_mepc, m_mcause};
+    snapshot->fflags = m_fflags;
+    snapshot->frm = m_frm;
+    snapshot->vector = m_vector;
+    for (const AInt page : m_memory->materializedPages()) {
+      auto &data = snapshot->pages[page];
+      data.resize(PagedAddressSpaceMM::s_pageSize);
+      m_memory->readBlock(page << PagedAddressSpaceMM::s_pageBits, data.data(),
+                          data.size());
+    }
+    return snapshot;
+  }
+
+  void restoreSnapshot(const Snapshot &snapshot) override {
+    const auto &s = static_cast<const HartSnapshot &>(snapshot);
+    // Pages materialized since the snapshot revert to their initial contents.
+    // LR/SC reservations are not saved, and are cleared.
+    m_memory->reset();
+    for (const auto &page : s.pages)
+      m_memory->writeBlock(page.first << PagedAddressSpaceMM::s_pageBits,
+                           page.second.data(), page.second.size());
+    m_reservations->reset();
+    m_regs = s.regs;
+    m_fregs = s.fregs;
+    m_pc = s.pc;
+    m_instructionsRetired = s.instructionsRetired;
+    m_cycleCount = s.cycleCount;
+    m_finished = s.finished;
+    m_dataAccess = s.dataAccess;
+    m_instrAccess = s.instrAccess;
+    m_mstatus = s.csrs[0];
+    m_mie = s.csrs[1];
+    m_mtvec = s.csrs[2];
+    m_mscratch = s.csrs[3];
+    m_mepc = s.csrs[4];
+    m_mcause = s.csrs[5];
+    m_fflags = s.fflags;
+    m_frm = s.frm;
+    m_vector = s.vector;
+    m_predecoded.clear();
+    clearTranslations();
+  }
+
+  static ProcessorISAInfo supportsISA() {
+    return ProcessorISAInfo{
+        std::make_shared<ISAInfo<XLenToRVISA<XLEN>()>>(QStringList()),
+        {"M", "A", "F", "D", "C", "V"},
+        {"M"}};
+  }
+  const ISAInfoBase *implementsISA() const override {
+    return m_enabledISA.get();
+  }
+  const std::set<RegisterFileType> registerFiles() const override {
+    std::set<RegisterFileType> rfs = {RegisterFileType::GPR};
+    if (m_enabledISA->extensionEnabled('F'))
+      rfs.insert(RegisterFileType::FPR);
+    return rfs;
+  }
+  const ReservationTable *reservations() const override {
+    return m_reservations.get();
+  }
+  void setInstructionTrace(std::shared_ptr<InstructionTrace> trace) override {
+    m_trace = trace;
+  }
+
+  long long clockBatch(long long cycles) override {
+    // Replayed instructions are decoded from the trace, and subclasses clock
+    // the functional execution through their timing models.
+    if (typeid(*this) != typeid(RVISS) || m_trace)
+      return RipesProcessor::clockBatch(cycles);
+
+    long long clocked = 0;
+    TranslatedBlock *prev = nullptr;
+    while (clocked < cycles && !m_finished) {
+      // Pending interrupts are only checked in between instructions by
+      // clockProcessor.
+      if ((m_mie & RVISA::MTI) && (m_mstatus & RVISA::MSTATUS_MIE) &&
+          timerCompare) {
+        if (finished())
+          break;
+        clockProcessor();
+        clocked++;
+        prev = nullptr;
+        continue;
+      }
+      TranslatedBlock *block = prev ? prev->successor(m_pc, m_epoch) : nullptr;
+      if (!block) {
+        block = translatedBlock(m_pc);
+        if (!block)
+          break;
+        if (prev)
+          prev->link(m_pc, block, m_epoch);
+      }
+      const uint64_t epoch = m_epoch;
+      clocked += executeBlock(*block, cycles - clocked);
+      // Blocks invalidated while executing are not chained from.
+      prev = epoch == m_epoch ? block : nullptr;
+    }
+    m_retiredBlocks.clear();
+    return clocked;
+  }
+
+protected:
+  // The state of the hart and its memory, as saved by saveSnapshot. Pages of
+  // memory are held by page number.
+  struct HartSnapshot : Snapshot {
+    std::array<XLEN_T, c_RVRegs> regs;
+    std::array<uint64_t, c_RVRegs> fregs;
+    AInt pc;
+    long long instructionsRetired;
+    long long cycleCount;
+    bool finished;
+    MemoryAccess dataAccess;
+    MemoryAccess instrAccess;
+    // mstatus, mie, mtvec, mscratch, mepc and mcause.
+    std::array<XLEN_T, 6> csrs;
+    unsigned fflags;
+    unsigned frm;
+    RVVectorUnit vector;
+    std::map<AInt, std::vector<uint8_t>> pages;
+  };
+
+  /// Resets the architectural state of the hart, leaving memory untouched.
+  void resetHart() {
+    m_regs.fill(0);
+    m_fregs.fill(m_fpDouble ? 0 : RVFPU::box(0));
+    m_fflags = 0;
+    m_frm = 0;
+    m_vector.reset(vlen());
+    m_pc = m_pcInitialValue;
+    m_instructionsRetired = 0;
+    m_cycleCount = 0;
+    m_mstatus = 0;
+    m_mie = 0;
+    m_mtvec = 0;
+    m_mscratch = 0;
+    m_mepc = 0;
+    m_mcause = 0;
+    m_finished = false;
+    m_dataAccess = MemoryAccess();
+    m_instrAccess = MemoryAccess();
+    m_predecoded.clear();
+    clearTranslations();
+    if (m_trace) {
+      m_trace->rewind();
+      m_finished = !nextTraceRecord();
+      if (!m_finished)
+        m_pc = m_traceRecord.pc;
+    }
+  }
+
+  void clockProcessor() override {
+    // A pending interrupt is taken before the instruction at the PC executes;
+    // the first instruction of the handler executes in the same cycle.
+    if ((m_mie & RVISA::MTI) && (m_mstatus & RVISA::MSTATUS_MIE) &&
+        timerPending())
+      trap(RVISA::MTIMER_CAUSE, true);
+    step();
+    m_instructionsRetired++;
+    m_cycleCount++;
+    if (m_emitsSignals)
+      processorWasClocked.Emit();
+  }
+
+  /**
+   * @brief The PredecodedInstr struct
+   * Result of fetching and decoding the instruction at a given PC. Entries are
+   * cached in m_predecoded such that tight loops only decode each instruction
+   * once.
+   */
+  struct PredecodedInstr {
+    RVInstr opcode;
+    XLEN_T imm;
+    uint8_t rd;
+    uint8_t rs1;
+    uint8_t rs2;
+    uint8_t rs3;
+    // The rounding mode of floating-point instructions (funct3).
+    uint8_t rm;
+    uint8_t bytes;
+  };
+
+  const PredecodedInstr &predecode(AInt pc) {
+    // Replayed instructions are decoded from the trace rather than fetched,
+    // and need not be in memory.
+    if (m_trace)
+      return m_traceDecoded;
+    auto it = m_predecoded.find(pc);
+    if (it != m_predecoded.end())
+      return it->second;
+    return m_predecoded
+        .emplace(pc, decode(m_memory->readMem(pc, c_RVInstrWidth / CHAR_BIT)))
+        .first->second;
+  }
+
+  /// Decodes the instruction word @p fetched, which may be compressed.
+  PredecodedInstr decode(VInt fetched) const {
+    const bool isCompressed =
+        m_compressed && ((fetched & 0b11) != 0b11) && fetched != 0;
+    const VInt instr =
+        isCompressed
+            ? Uncompress<XLEN>::uncompress(fetched & 0xFFFF, m_enabledISA.get())
+            : fetched & 0xFFFFFFFF;
+
+    PredecodedInstr decoded;
+    decoded.opcode = static_cast<RVInstr>(
+        Decode<XLEN>::decodeOpcode(instr, m_enabledISA.get()));
+    decoded.imm = static_cast<XLEN_T>(
+        Immediate<XLEN>::decodeImmediate(decoded.opcode, instr));
+    decoded.rd = (instr >> 7) & 0b11111;
+    decoded.rs1 = (instr >> 15) & 0b11111;
+    decoded.rs2 = (instr >> 20) & 0b11111;
+    decoded.rs3 = (instr >> 27) & 0b11111;
+    decoded.rm = (instr >> 12) & 0b111;
+    decoded.bytes = isCompressed ? 2 : 4;
+    return decoded;
+  }
+
+  /// Returns true if the instruction at @p pc may be fetched. During trace
+  /// replay, all PCs of the trace may be fetched.
+  bool isFetchable(AInt pc) const { return m_trace || isExecutableAddress(pc); }
+
+  /// Drops any predecoded or translated instruction which overlaps the byte
+  /// range [address : address + bytes[. Only stores into executable regions
+  /// may invalidate predecoded instructions.
+  void invalidatePredecoded(AInt address, unsigned bytes) {
+    if (address < m_translatedEnd && address + bytes > m_translatedStart)
+      invalidateTranslated(address, bytes);
+    if (m_predecoded.empty() ||
+        !(isExecutableAddress(address) ||
+          isExecutableAddress(address + bytes - 1)))
+      return;
+    // An instruction starting up to 3 bytes before the store may overlap it.
+    const AInt start = address >= 3 ? address - 3 : 0;
+    for (AInt a = start; a < address + bytes; ++a)
+      m_predecoded.erase(a);
+  }
+
+  /**
+   * @brief The TranslatedBlock struct
+   * A basic block of up to s_maxBlockInstrs predecoded instructions starting
+   * at @p start, which ends before @p end. Blocks end at control transfers and
+   * at instructions which may change the interrupt state (see endsBlock), or
+   * before the first instruction which is not executable. The most recent
+   * successors of a block are linked to it, and links are valid within the
+   * translation epoch in which they were made.
+   */
+  struct TranslatedBlock {
+    struct Link {
+      AInt pc = 0;
+      TranslatedBlock *block = nullptr;
+      uint64_t epoch = 0;
+    };
+
+    TranslatedBlock *successor(AInt pc, uint64_t epoch) const {
+      for (const auto &l : links) {
+        if (l.block && l.pc == pc && l.epoch == epoch)
+          return l.block;
+      }
+      return nullptr;
+    }
+    void link(AInt pc, TranslatedBlock *block, uint64_t epoch) {
+      links[nextLink] = {pc, block, epoch};
+      nextLink = (nextLink + 1) % links.size();
+    }
+
+    AInt start;
+    AInt end;
+    std::vector<PredecodedInstr> instrs;
+    // The taken and not-taken successors of a branch.
+    std::array<Link, 2> links;
+    unsigned nextLink = 0;
+  };
+  static constexpr unsigned s_maxBlockInstrs = 64;
+  static constexpr unsigned s_translationPageBits =
+      PagedAddressSpaceMM::s_pageBits;
+
+  static bool endsBlock(RVInstr opc) {
+    switch (opc) {
+    case RVInstr::JAL:
+    case RVInstr::JALR:
+    case RVInstr::BEQ:
+    case RVInstr::BNE:
+    case RVInstr::BLT:
+    case RVInstr::BGE:
+    case RVInstr::BLTU:
+    case RVInstr::BGEU:
+    case RVInstr::ECALL:
+    case RVInstr::MRET:
+    case RVInstr::WFI:
+    case RVInstr::CSRRW:
+    case RVInstr::CSRRS:
+    case RVInstr::CSRRC:
+    case RVInstr::CSRRWI:
+    case RVInstr::CSRRSI:
+    case RVInstr::CSRRCI:
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  /// Returns the translated block starting at @p pc, translating it if
+  /// required, or nullptr if @p pc is not executable.
+  TranslatedBlock *translatedBlock(AInt pc) {
+    auto it = m_blocks.find(pc);
+    if (it != m_blocks.end())
+      return it->second.get();
+    if (!isExecutableAddress(pc))
+      return nullptr;
+
+    auto block = std::make_unique<TranslatedBlock>();
+    block->start = pc;
+    AInt next = pc;
+    do {
+      block->instrs.push_back(
+          decode(m_memory->readMem(next, c_RVInstrWidth / CHAR_BIT)));
+      next += block->instrs.back().bytes;
+    } while (block->instrs.size() < s_maxBlockInstrs &&
+             !endsBlock(block->instrs.back().opcode) &&
+             isExecutableAddress(next));
+    block->end = next;
+
+    for (AInt page = pc >> s_translationPageBits;
+         page <= (next - 1) >> s_translationPageBits; ++page)
+      m_translatedPages[page].push_back(pc);
+    m_translatedStart = std::min(m_translatedStart, pc);
+    m_translatedEnd = std::max(m_translatedEnd, next);
+    return m_blocks.emplace(pc, std::move(block)).first->second.get();
+  }
+
+  /// Executes up to @p maxInstrs instructions of @p block, starting at its
+  /// first instruction, which is at the PC. Returns the number of instructions
+  /// executed. Execution leaves the block once it is invalidated.
+  long long executeBlock(const TranslatedBlock &block, long long maxInstrs) {
+    const uint64_t epoch = m_epoch;
+    long long executed = 0;
+    for (const auto &instr : block.instrs) {
+      if (executed == maxInstrs)
+        break;
+      execute(instr);
+      m_instructionsRetired++;
+      m_cycleCount++;
+      executed++;
+      if (m_emitsSignals)
+        processorWasClocked.Emit();
+      if (m_finished || epoch != m_epoch)
+        break;
+    }
+    return executed;
+  }
+
+  /// Invalidates the translated blocks overlapping the byte range
+  /// [address : address + bytes[. Invalidated blocks are retired rather than
+  /// freed, since they may be executing.
+  void invalidateTranslated(AInt address, AInt bytes) {
+    const AInt last = address + bytes - 1;
+    for (AInt page = address >> s_translationPageBits;
+         page <= last >> s_translationPageBits; ++page) {
+      auto pageIt = m_translatedPages.find(page);
+      if (pageIt == m_translatedPages.end())
+        continue;
+      auto &starts = pageIt->second;
+      for (size_t i = 0; i < starts.size();) {
+        auto it = m_blocks.find(starts[i]);
+        // Blocks spanning several pages are listed in each; the entries of
+        // blocks retired through another page are dropped here.
+        if (it == m_blocks.end()) {
+          starts[i] = starts.back();
+          starts.pop_back();
+          continue;
+        }
+        if (it->second->start <= last && address < it->second->end) {
+          m_retiredBlocks.push_back(std::move(it->second));
+          m_blocks.erase(it);
+          m_epoch++;
+          starts[i] = starts.back();
+          starts.pop_back();
+          continue;
+        }
+        ++i;
+      }
+      if (starts.empty())
+        m_translatedPages.erase(pageIt);
+    }
+  }
+
+  void clearTranslations() {
+    m_blocks.clear();
+    m_translatedPages.clear();
+    m_translatedStart = std::numeric_limits<AInt>::max();
+    m_translatedEnd = 0;
+    m_epoch++;
+  }
+
+  bool timerPending() const {
+    // The interrupts of a replayed trace are part of the trace.
+    return !m_trace && timerCompare &&
+           static_cast<uint64_t>(m_cycleCount) >= timerCompare();
+  }
+
+  /// Enters the trap handler at mtvec, for the exception or interrupt
+  /// @p cause, with the PC of the interrupted instruction saved in mepc.
+  void trap(unsigned cause, bool interrupt) {
+    m_mepc = static_cast<XLEN_T>(m_pc);
+    m_mcause = cause;
+    if (interrupt)
+      m_mcause |= static_cast<XLEN_T>(1) << (XLEN - 1);
+    m_mstatus = (m_mstatus & RVISA::MSTATUS_MIE) ? RVISA::MSTATUS_MPIE : 0;
+    m_pc = m_mtvec;
+  }
+
+  /// The value of the floating-point register @p i, of FLEN bits.
+  VInt fpRegister(unsigned i) const {
+    return m_fpDouble ? m_fregs.at(i) : static_cast<uint32_t>(m_fregs.at(i));
+  }
+
+  XLEN_T readCSR(unsigned csr) const {
+    switch (csr) {
+    case RVISA::FFLAGS:
+      return m_fflags;
+    case RVISA::FRM:
+      return m_frm;
+    case RVISA::FCSR:
+      return m_frm << 5 | m_fflags;
+    case RVISA::VSTART:
+      return 0;
+    case RVISA::VL:
+      return static_cast<XLEN_T>(m_vector.vl());
+    case RVISA::VTYPE:
+      return m_vector.vill() ? static_cast<XLEN_T>(1) << (XLEN - 1)
+                             : static_cast<XLEN_T>(m_vector.vtype());
+    case RVISA::VLENB:
+      return m_vector.vlenb();
+    case RVISA::MSTATUS:
+      return m_mstatus;
+    case RVISA::MISA: {
+      XLEN_T misa = static_cast<XLEN_T>(XLEN == 32 ? 1 : 2) << (XLEN - 2);
+      misa |= 1 << ('I' - 'A');
+      for (const auto &ext : m_enabledISA->enabledExtensions())
+        misa |= 1 << (ext.at(0).toLatin1() - 'A');
+      return misa;
+    }
+    case RVISA::MIE:
+      return m_mie;
+    case RVISA::MTVEC:
+      return m_mtvec;
+    case RVISA::MSCRATCH:
+      return m_mscratch;
+    case RVISA::MEPC:
+      return m_mepc;
+    case RVISA::MCAUSE:
+      return m_mcause;
+    case RVISA::MTVAL:
+      return 0;
+    case RVISA::MIP:
+      return timerPending() ? RVISA::MTI : 0;
+    case RVISA::MHARTID:
+      return m_hartId;
+    default:
+      return static_cast<XLEN_T>(readCounterCSR(csr));
+    }
+  }
+
+  /// Writes the writable bits of @p csr; other bits, and read-only CSRs, are
+  /// left unchanged.
+  void writeCSR(unsigned csr, XLEN_T value) {
+    switch (csr) {
+    case RVISA::FFLAGS:
+      m_fflags = value & 0b11111;
+      break;
+    case RVISA::FRM:
+      m_frm = value & 0b111;
+      break;
+    case RVISA::FCSR:
+      m_fflags = value & 0b11111;
+      m_frm = (value >> 5) & 0b111;
+      break;
+    case RVISA::MSTATUS:
+      m_mstatus = value & (RVISA::MSTATUS_MIE | RVISA::MSTATUS_MPIE);
+      break;
+    case RVISA::MIE:
+      m_mie = value & RVISA::MTI;
+      break;
+    case RVISA::MTVEC:
+      // Only direct mode is supported.
+      m_mtvec = value & ~static_cast<XLEN_T>(0b11);
+      break;
+    case RVISA::MSCRATCH:
+      m_mscratch = value;
+      break;
+    case RVISA::MEPC:
+      m_mepc = value & ~static_cast<XLEN_T>(1);
+      break;
+    case RVISA::MCAUSE:
+      m_mcause = value;
+      break;
+    default:
+      break;
+    }
+  }
+
+  /// Fetches, decodes and executes the instruction at the current PC.
+  void step() {
+    if (m_trace) {
+      replay();
+      return;
+    }
+    // Copied, since a store may invalidate the cached entry.
+    const PredecodedInstr decoded = predecode(m_pc);
+    execute(decoded);
+  }
+
+  /// Executes @p decoded, the instruction at the current PC, which must remain
+  /// valid while executing even if a store invalidates it.
+  void execute(const PredecodedInstr &decoded) {
+    const RVInstr opc = decoded.opcode;
+    const XLEN_T imm = decoded.imm;
+    const unsigned rd = decoded.rd;
+    const unsigned instrBytes = decoded.bytes;
+    const XLEN_T rs1 = m_regs[decoded.rs1];
+    const XLEN_T rs2 = m_regs[decoded.rs2];
+    const XLEN_ST rs1s = static_cast<XLEN_ST>(rs1);
+    const XLEN_ST rs2s = static_cast<XLEN_ST>(rs2);
+
+    m_instrAccess = MemoryAccess{MemoryAccess::Read, m_pc, instrBytes};
+    m_dataAccess = MemoryAccess();
+
+    const XLEN_T pc = static_cast<XLEN_T>(m_pc);
+    XLEN_T nextPc = pc + instrBytes;
+
+    auto wr = [&](XLEN_T v) {
+      if (rd != 0)
+        m_regs[rd] = v;
+    };
+    auto wr32 = [&](uint32_t v) {
+      wr(static_cast<XLEN_T>(
+          static_cast<XLEN_ST>(static_cast<int32_t>(v))));
+    };
+    auto load = [&](unsigned bytes, bool signExtend) {
+      const XLEN_T addr = rs1 + imm;
+      m_dataAccess = MemoryAccess{MemoryAccess::Read, addr, bytes};
+      VInt v = m_memory->readMem(addr, bytes);
+      if (signExtend && bytes < sizeof(VInt))
+        v = vsrtl::signextend<VInt, VIntS>(v, bytes * CHAR_BIT);
+      wr(static_cast<XLEN_T>(v));
+    };
+    auto store = [&](unsigned bytes, VInt value) {
+      const XLEN_T addr = rs1 + imm;
+      m_dataAccess = MemoryAccess{MemoryAccess::Write, addr, bytes};
+      m_memory->writeMem(addr, value, bytes);
+      m_reservations->invalidate(m_hartId, addr, bytes);
+      invalidatePredecoded(addr, bytes);
+    };
+
+    // A extension. The RV64A instructions follow the RV32A instructions in
+    // RVInstr. Words are sign-extended to XLEN, such that the signed and
+    // unsigned comparisons of AMOMIN/AMOMAX[U].W order them as 32-bit values.
+    const unsigned atomicBytes = opc >= RVInstr::LR_D ? 8 : 4;
+    const VInt atomicMask = atomicBytes == sizeof(VInt)
+                                ? ~VInt(0)
+                                : (VInt(1) << (atomicBytes * CHAR_BIT)) - 1;
+    auto atomicValue = [&](VInt v) {
+      if (atomicBytes < sizeof(VInt))
+        v = vsrtl::signextend<VInt, VIntS>(v & atomicMask,
+                                           atomicBytes * CHAR_BIT);
+      return static_cast<XLEN_T>(v);
+    };
+    auto loadReserved = [&] {
+      const XLEN_T addr = rs1;
+      m_dataAccess = MemoryAccess{MemoryAccess::Read, addr, atomicBytes};
+      const VInt v = m_memory->readMem(addr, atomicBytes);
+      m_reservations->reserve(m_hartId, addr, atomicBytes, v);
+      wr(atomicValue(v));
+    };
+    auto storeConditional = [&] {
+      const XLEN_T addr = rs1;
+      const VInt value = rs2 & atomicMask;
+      const bool success = m_reservations->storeConditional(
+          m_hartId, addr, atomicBytes, [&](VInt reserved) {
+            return m_memory->atomicUpdate(addr, atomicBytes, [&](VInt old) {
+                     return old == reserved ? value : old;
+                   }) == reserved;
+          });
+      if (success) {
+        m_dataAccess = MemoryAccess{MemoryAccess::Write, addr, atomicBytes};
+        invalidatePredecoded(addr, atomicBytes);
+      }
+      wr(success ? 0 : 1);
+    };
+    auto amo = [&](auto op) {
+      const XLEN_T addr = rs1;
+      const XLEN_T src = atomicValue(rs2);
+      m_dataAccess = MemoryAccess{MemoryAccess::Write, addr, atomicBytes};
+      const VInt old = m_memory->atomicUpdate(addr, atomicBytes, [&](VInt v) {
+        return static_cast<VInt>(op(atomicValue(v), src)) & atomicMask;
+      });
+      m_reservations->countAMO(m_hartId);
+      m_reservations->invalidate(m_hartId, addr, atomicBytes);
+      invalidatePredecoded(addr, atomicBytes);
+      wr(atomicValue(old));
+    };
+
+    // F and D extensions. The D instructions follow the F instructions in
+    // RVInstr, such that both are executed by executeFP, on floats or doubles.
+    const unsigned rm = decoded.rm == RVFPU::DYN ? m_frm : decoded.rm;
+    auto loadFP = [&](unsigned bytes) {
+      const XLEN_T addr = rs1 + imm;
+      m_dataAccess = MemoryAccess{MemoryAccess::Read, addr, bytes};
+      const VInt v = m_memory->readMem(addr, bytes);
+      m_fregs[rd] = bytes == 4 ? RVFPU::box(static_cast<uint32_t>(v)) : v;
+    };
+    auto readFP = [&](auto format, unsigned reg) {
+      using F = decltype(format);
+      if constexpr (std::is_same_v<F, float>)
+        return RVFPU::fromBits<float>(RVFPU::unbox(m_fregs[reg]));
+      else
+        return RVFPU::fromBits<double>(m_fregs[reg]);
+    };
+    auto writeFP = [&](auto v) {
+      if constexpr (std::is_same_v<decltype(v), float>)
+        m_fregs[rd] = RVFPU::box(RVFPU::toBits(v));
+      else
+        m_fregs[rd] = RVFPU::toBits(v);
+    };
+    // Executes the F instruction @p sOpc, as the D instruction following it in
+    // RVInstr if @p format is a double.
+    auto executeFP = [&](auto format, unsigned sOpc) {
+      using F = decltype(format);
+      const bool rounds =
+          (sOpc >= RVInstr::FMADD_S && sOpc <= RVInstr::FSQRT_S) ||
+          (sOpc >= RVInstr::FCVT_W_S && sOpc <= RVInstr::FCVT_S_LU);
+      if (rounds && !RVFPU::validRoundingMode(rm))
+        return;
+      const F a = readFP(format, decoded.rs1);
+      const F b = readFP(format, decoded.rs2);
+      const F c = readFP(format, decoded.rs3);
+      const auto sgnj = [&](bool negate, bool xorSign) {
+        writeFP(RVFPU::fromBits<F>(RVFPU::signInject<F>(
+            RVFPU::toBits(a), RVFPU::toBits(b), negate, xorSign)));
+      };
+      unsigned flags = 0;
+      switch (sOpc) {
+      case RVInstr::FMADD_S:
+        writeFP(RVFPU::fma(a, b, c, false, false, rm, flags));
+        break;
+      case RVInstr::FMSUB_S:
+        writeFP(RVFPU::fma(a, b, c, false, true, rm, flags));
+        break;
+      case RVInstr::FNMSUB_S:
+        writeFP(RVFPU::fma(a, b, c, true, false, rm, flags));
+        break;
+      case RVInstr::FNMADD_S:
+        writeFP(RVFPU::fma(a, b, c, true, true, rm, flags));
+        break;
+      case RVInstr::FADD_S:
+        writeFP(RVFPU::add(a, b, rm, flags));
+        break;
+      case RVInstr::FSUB_S:
+        writeFP(RVFPU::sub(a, b, rm, flags));
+        break;
+      case RVInstr::FMUL_S:
+        writeFP(RVFPU::mul(a, b, rm, flags));
+        break;
+      case RVInstr::FDIV_S:
+        writeFP(RVFPU::div(a, b, rm, flags));
+        break;
+      case RVInstr::FSQRT_S:
+        writeFP(RVFPU::sqrt(a, rm, flags));
+        break;
+      case RVInstr::FSGNJ_S:
+        sgnj(false, false);
+        break;
+      case RVInstr::FSGNJN_S:
+        sgnj(true, false);
+        break;
+      case RVInstr::FSGNJX_S:
+        sgnj(false, true);
+        break;
+      case RVInstr::FMIN_S:
+        writeFP(RVFPU::minMax(a, b, false, flags));
+        break;
+      case RVInstr::FMAX_S:
+        writeFP(RVFPU::minMax(a, b, true, flags));
+        break;
+      case RVInstr::FEQ_S:
+        wr(RVFPU::eq(a, b, flags) ? 1 : 0);
+        break;
+      case RVInstr::FLT_S:
+        wr(RVFPU::lt(a, b, flags) ? 1 : 0);
+        break;
+      case RVInstr::FLE_S:
+        wr(RVFPU::le(a, b, flags) ? 1 : 0);
+        break;
+      case RVInstr::FCLASS_S:
+        wr(RVFPU::classify(a));
+        break;
+      // 32-bit results are sign-extended to XLEN, also for fcvt.wu.
+      case RVInstr::FCVT_W_S:
+        wr32(static_cast<uint32_t>(RVFPU::toInt<int32_t>(a, rm, flags)));
+        break;
+      case RVInstr::FCVT_WU_S:
+        wr32(RVFPU::toInt<uint32_t>(a, rm, flags));
+        break;
+      case RVInstr::FCVT_L_S:
+        wr(static_cast<XLEN_T>(RVFPU::toInt<int64_t>(a, rm, flags)));
+        break;
+      case RVInstr::FCVT_LU_S:
+        wr(static_cast<XLEN_T>(RVFPU::toInt<uint64_t>(a, rm, flags)));
+        break;
+      case RVInstr::FCVT_S_W:
+        writeFP(RVFPU::fromInt<F>(static_cast<int32_t>(rs1), rm, flags));
+        break;
+      case RVInstr::FCVT_S_WU:
+        writeFP(RVFPU::fromInt<F>(static_cast<uint32_t>(rs1), rm, flags));
+        break;
+      case RVInstr::FCVT_S_L:
+        writeFP(RVFPU::fromInt<F>(static_cast<int64_t>(rs1s), rm, flags));
+        break;
+      case RVInstr::FCVT_S_LU:
+        writeFP(RVFPU::fromInt<F>(static_cast<uint64_t>(rs1), rm, flags));
+        break;
+      // Moves transfer the raw register bits, without NaN-unboxing.
+      case RVInstr::FMV_X_W:
+        if constexpr (std::is_same_v<F, float>)
+          wr32(static_cast<uint32_t>(m_fregs[decoded.rs1]));
+        else
+          wr(static_cast<XLEN_T>(m_fregs[decoded.rs1]));
+        break;
+      case RVInstr::FMV_W_X:
+        if constexpr (std::is_same_v<F, float>)
+          m_fregs[rd] = RVFPU::box(static_cast<uint32_t>(rs1));
+        else
+          m_fregs[rd] = rs1;
+        break;
+      default:
+        break;
+      }
+      m_fflags |= flags;
+    };
+
+    // V extension. The scalar operand of the VX forms is rs1, sign-extended
+    // to ELEN, and that of the VI forms is simm5 (imm).
+    const uint64_t vx = static_cast<uint64_t>(static_cast<int64_t>(rs1s));
+    const uint64_t vi = static_cast<uint64_t>(
+        static_cast<int64_t>(static_cast<XLEN_ST>(imm)));
+    auto vectorMemory = [&](bool isLoad, unsigned eewBytes) {
+      const XLEN_T addr = rs1;
+      bool executed;
+      if (isLoad) {
+        executed = m_vector.load(rd, eewBytes, [&](uint64_t offset,
+                                                   unsigned bytes) {
+          return m_memory->readMem(addr + offset, bytes);
+        });
+      } else {
+        executed = m_vector.store(
+            rd, eewBytes, [&](uint64_t offset, unsigned bytes, uint64_t v) {
+              const XLEN_T elementAddr = addr + offset;
+              m_memory->writeMem(elementAddr, v, bytes);
+              m_reservations->invalidate(m_hartId, elementAddr, bytes);
+              invalidatePredecoded(elementAddr, bytes);
+            });
+      }
+      if (executed && m_vector.vl() > 0)
+        m_dataAccess = MemoryAccess{
+            isLoad ? MemoryAccess::Read : MemoryAccess::Write, addr, eewBytes};
+    };
+    // Executes the arithmetic, move or reduction @p vOpc.
+    auto executeVector = [&](unsigned vOpc) {
+      using V = RVVectorUnit;
+      const unsigned vs1 = decoded.rs1;
+      const unsigned vs2 = decoded.rs2;
+      auto arith = [&](V::Op op, V::Form form) {
+        m_vector.arith(op, form, rd, vs2, vs1, form == V::Form::VX ? vx : vi);
+      };
+      switch (vOpc) {
+      case RVInstr::VADD_VV:
+        return arith(V::Op::Add, V::Form::VV);
+      case RVInstr::VADD_VX:
+        return arith(V::Op::Add, V::Form::VX);
+      case RVInstr::VADD_VI:
+        return arith(V::Op::Add, V::Form::VI);
+      case RVInstr::VSUB_VV:
+        return arith(V::Op::Sub, V::Form::VV);
+      case RVInstr::VSUB_VX:
+        return arith(V::Op::Sub, V::Form::VX);
+      case RVInstr::VRSUB_VX:
+        return arith(V::Op::RSub, V::Form::VX);
+      case RVInstr::VRSUB_VI:
+        return arith(V::Op::RSub, V::Form::VI);
+      case RVInstr::VMINU_VV:
+        return arith(V::Op::MinU, V::Form::VV);
+      case RVInstr::VMINU_VX:
+        return arith(V::Op::MinU, V::Form::VX);
+      case RVInstr::VMIN_VV:
+        return arith(V::Op::Min, V::Form::VV);
+      case RVInstr::VMIN_VX:
+        return arith(V::Op::Min, V::Form::VX);
+      case RVInstr::VMAXU_VV:
+        return arith(V::Op::MaxU, V::Form::VV);
+      case RVInstr::VMAXU_VX:
+        return arith(V::Op::MaxU, V::Form::VX);
+      case RVInstr::VMAX_VV:
+        return arith(V::Op::Max, V::Form::VV);
+      case RVInstr::VMAX_VX:
+        return arith(V::Op::Max, V::Form::VX);
+      case RVInstr::VAND_VV:
+        return arith(V::Op::And, V::Form::VV);
+      case RVInstr::VAND_VX:
+        return arith(V::Op::And, V::Form::VX);
+      case RVInstr::VAND_VI:
+        return arith(V::Op::And, V::Form::VI);
+      case RVInstr::VOR_VV:
+        return arith(V::Op::Or, V::Form::VV);
+      case RVInstr::VOR_VX:
+        return arith(V::Op::Or, V::Form::VX);
+      case RVInstr::VOR_VI:
+        return arith(V::Op::Or, V::Form::VI);
+      case RVInstr::VXOR_VV:
+        return arith(V::Op::Xor, V::Form::VV);
+      case RVInstr::VXOR_VX:
+        return arith(V::Op::Xor, V::Form::VX);
+      case RVInstr::VXOR_VI:
+        return arith(V::Op::Xor, V::Form::VI);
+      case RVInstr::VSLL_VV:
+        return arith(V::Op::Sll, V::Form::VV);
+      case RVInstr::VSLL_VX:
+        return arith(V::Op::Sll, V::Form::VX);
+      case RVInstr::VSLL_VI:
+        return arith(V::Op::Sll, V::Form::VI);
+      case RVInstr::VSRL_VV:
+        return arith(V::Op::Srl, V::Form::VV);
+      case RVInstr::VSRL_VX:
+        return arith(V::Op::Srl, V::Form::VX);
+      case RVInstr::VSRL_VI:
+        return arith(V::Op::Srl, V::Form::VI);
+      case RVInstr::VSRA_VV:
+        return arith(V::Op::Sra, V::Form::VV);
+      case RVInstr::VSRA_VX:
+        return arith(V::Op::Sra, V::Form::VX);
+      case RVInstr::VSRA_VI:
+        return arith(V::Op::Sra, V::Form::VI);
+      case RVInstr::VMUL_VV:
+        return arith(V::Op::Mul, V::Form::VV);
+      case RVInstr::VMUL_VX:
+        return arith(V::Op::Mul, V::Form::VX);
+      case RVInstr::VMV_V_V:
+        return arith(V::Op::Mv, V::Form::VV);
+      case RVInstr::VMV_V_X:
+        return arith(V::Op::Mv, V::Form::VX);
+      case RVInstr::VMV_V_I:
+        return arith(V::Op::Mv, V::Form::VI);
+      case RVInstr::VMV_X_S: {
+        int64_t v;
+        if (m_vector.moveToScalar(vs2, v))
+          wr(static_cast<XLEN_T>(v));
+        return;
+      }
+      case RVInstr::VMV_S_X:
+        m_vector.moveFromScalar(rd, vx);
+        return;
+      default: {
+        // The reductions, in the order of their funct6.
+        static constexpr V::Op reductions[] = {
+            V::Op::Add, V::Op::And, V::Op::Or,   V::Op::Xor,
+            V::Op::MinU, V::Op::Min, V::Op::MaxU, V::Op::Max};
+        if (vOpc >= RVInstr::VREDSUM_VS && vOpc <= RVInstr::VREDMAX_VS)
+          m_vector.reduce(reductions[vOpc - RVInstr::VREDSUM_VS], rd, vs2,
+                          vs1);
+        return;
+      }
+      }
+    };
+
+    auto branch = [&](bool taken) {
+      if (taken)
+        nextPc = pc + imm;
+    };
+
+    // Division semantics follow the RISC-V specification (see rv_alu.h).
+    auto div = [](auto a, auto b, auto minValue) -> decltype(a) {
+      if (b == 0)
+        return -1;
+      if (a == minValue && b == -1)
+        return a;
+      return a / b;
+    };
+    auto rem = [](auto a, auto b, auto minValue) -> decltype(a) {
+      if (b == 0)
+        return a;
+      if (a == minValue && b == -1)
+        return 0;
+      return a % b;
+    };
+    constexpr XLEN_ST minS = std::numeric_limits<XLEN_ST>::min();
+    constexpr int32_t min32 = std::numeric_limits<int32_t>::min();
+    constexpr unsigned shMask = XLEN - 1;
+
+    switch (opc) {
+    case RVInstr::LUI:
+      wr(imm);
+      break;
+    case RVInstr::AUIPC:
+      wr(pc + imm);
+      break;
+    case RVInstr::JAL:
+      wr(pc + instrBytes);
+      nextPc = pc + imm;
+      break;
+    case RVInstr::JALR:
+      wr(pc + instrBytes);
+      nextPc = (rs1 + imm) & ~static_cast<XLEN_T>(1);
+      break;
+
+    // Branches
+    case RVInstr::BEQ:
+      branch(rs1 == rs2);
+      break;
+    case RVInstr::BNE:
+      branch(rs1 != rs2);
+      break;
+    case RVInstr::BLT:
+      branch(rs1s < rs2s);
+      break;
+    case RVInstr::BGE:
+      branch(rs1s >= rs2s);
+      break;
+    case RVInstr::BLTU:
+      branch(rs1 < rs2);
+      break;
+    case RVInstr::BGEU:
+      branch(rs1 >= rs2);
+      break;
+
+    // Loads and stores
+    case RVInstr::LB:
+      load(1, true);
+      break;
+    case RVInstr::LH:
+      load(2, true);
+      break;
+    case RVInstr::LW:
+      load(4, true);
+      break;
+    case RVInstr::LD:
+      load(8, false);
+      break;
+    case RVInstr::LBU:
+      load(1, false);
+      break;
+    case RVInstr::LHU:
+      load(2, false);
+      break;
+    case RVInstr::LWU:
+      load(4, false);
+      break;
+    case RVInstr::SB:
+      store(1, rs2);
+      break;
+    case RVInstr::SH:
+      store(2, rs2);
+      break;
+    case RVInstr::SW:
+      store(4, rs2);
+      break;
+    case RVInstr::SD:
+      store(8, rs2);
+      break;
+
+    // Arithmetic-immediate instructions
+    case RVInstr::ADDI:
+      wr(rs1 + imm);
+      break;
+    case RVInstr::SLTI:
+      wr(rs1s < static_cast<XLEN_ST>(imm) ? 1 : 0);
+      break;
+    case RVInstr::SLTIU:
+      wr(rs1 < imm ? 1 : 0);
+      break;
+    case RVInstr::XORI:
+      wr(rs1 ^ imm);
+      break;
+    case RVInstr::ORI:
+      wr(rs1 | imm);
+      break;
+    case RVInstr::ANDI:
+      wr(rs1 & imm);
+      break;
+    case RVInstr::SLLI:
+      wr(rs1 << (imm & shMask));
+      break;
+    case RVInstr::SRLI:
+      wr(rs1 >> (imm & shMask));
+      break;
+    case RVInstr::SRAI:
+      wr(static_cast<XLEN_T>(rs1s >> (imm & shMask)));
+      break;
+
+    // Arithmetic instructions
+    case RVInstr::ADD:
+      wr(rs1 + rs2);
+      break;
+    case RVInstr::SUB:
+      wr(rs1 - rs2);
+      break;
+    case RVInstr::SLL:
+      wr(rs1 << (rs2 & shMask));
+      break;
+    case RVInstr::SLT:
+      wr(rs1s < rs2s ? 1 : 0);
+      break;
+    case RVInstr::SLTU:
+      wr(rs1 < rs2 ? 1 : 0);
+      break;
+    case RVInstr::XOR:
+      wr(rs1 ^ rs2);
+      break;
+    case RVInstr::SRL:
+      wr(rs1 >> (rs2 & shMask));
+      break;
+    case RVInstr::SRA:
+      wr(static_cast<XLEN_T>(rs1s >> (rs2 & shMask)));
+      break;
+    case RVInstr::OR:
+      wr(rs1 | rs2);
+      break;
+    case RVInstr::AND:
+      wr(rs1 & rs2);
+      break;
+
+    // M extension
+    case RVInstr::MUL:
+      wr(rs1 * rs2);
+      break;
+    case RVInstr::MULH:
+    case RVInstr::MULHSU:
+    case RVInstr::MULHU: {
+      if constexpr (XLEN == 32) {
+        int64_t res;
+        if (opc == RVInstr::MULH)
+          res = static_cast<int64_t>(rs1s) * static_cast<int64_t>(rs2s);
+        else if (opc == RVInstr::MULHSU)
+          res = static_cast<int64_t>(rs1s) * static_cast<int64_t>(rs2);
+        else
+          res = static_cast<int64_t>(static_cast<uint64_t>(rs1) *
+                                     static_cast<uint64_t>(rs2));
+        wr(static_cast<XLEN_T>(static_cast<uint64_t>(res) >> 32));
+      } else {
+        __int128 res;
+        if (opc == RVInstr::MULH)
+          res = static_cast<__int128>(rs1s) * static_cast<__int128>(rs2s);
+        else if (opc == RVInstr::MULHSU)
+          res = static_cast<__int128>(rs1s) *
+                static_cast<__int128>(static_cast<unsigned __int128>(rs2));
+        else
+          res = static_cast<__int128>(static_cast<unsigned __int128>(rs1) *
+                                      static_cast<unsigned __int128>(rs2));
+        wr(static_cast<XLEN_T>(static_cast<unsigned __int128>(res) >> 64));
+      }
+      break;
+    }
+    case RVInstr::DIV:
+      wr(static_cast<XLEN_T>(div(rs1s, rs2s, minS)));
+      break;
+    case RVInstr::DIVU:
+      wr(rs2 == 0 ? static_cast<XLEN_T>(-1) : rs1 / rs2);
+      break;
+    case RVInstr::REM:
+      wr(static_cast<XLEN_T>(rem(rs1s, rs2s, minS)));
+      break;
+    case RVInstr::REMU:
+      wr(rs2 == 0 ? rs1 : rs1 % rs2);
+      break;
+
+    // RV64I
+    case RVInstr::ADDIW:
+      wr32(static_cast<uint32_t>(rs1 + imm));
+      break;
+    case RVInstr::SLLIW:
+      wr32(static_cast<uint32_t>(rs1) << (imm & 0b11111));
+      break;
+    case RVInstr::SRLIW:
+      wr32(static_cast<uint32_t>(rs1) >> (imm & 0b11111));
+      break;
+    case RVInstr::SRAIW:
+      wr32(static_cast<uint32_t>(static_cast<int32_t>(rs1) >> (imm & 0b11111)));
+      break;
+    case RVInstr::ADDW:
+      wr32(static_cast<uint32_t>(rs1 + rs2));
+      break;
+    case RVInstr::SUBW:
+      wr32(static_cast<uint32_t>(rs1 - rs2));
+      break;
+    case RVInstr::SLLW:
+      wr32(static_cast<uint32_t>(rs1) << (rs2 & 0b11111));
+      break;
+    case RVInstr::SRLW:
+      wr32(static_cast<uint32_t>(rs1) >> (rs2 & 0b11111));
+      break;
+    case RVInstr::SRAW:
+      wr32(static_cast<uint32_t>(static_cast<int32_t>(rs1) >> (rs2 & 0b11111)));
+      break;
+
+    // RV64M
+    case RVInstr::MULW:
+      wr32(static_cast<uint32_t>(rs1) * static_cast<uint32_t>(rs2));
+      break;
+    case RVInstr::DIVW:
+      wr32(static_cast<uint32_t>(
+          div(static_cast<int32_t>(rs1), static_cast<int32_t>(rs2), min32)));
+      break;
+    case RVInstr::DIVUW: {
+      const uint32_t a = rs1, b = rs2;
+      wr32(b == 0 ? static_cast<uint32_t>(-1) : a / b);
+      break;
+    }
+    case RVInstr::REMW:
+      wr32(static_cast<uint32_t>(
+          rem(static_cast<int32_t>(rs1), static_cast<int32_t>(rs2), min32)));
+      break;
+    case RVInstr::REMUW: {
+      const uint32_t a = rs1, b = rs2;
+      wr32(b == 0 ? a : a % b);
+      break;
+    }
+
+    // A extension
+    case RVInstr::LR_W:
+    case RVInstr::LR_D:
+      loadReserved();
+      break;
+    case RVInstr::SC_W:
+    case RVInstr::SC_D:
+      storeConditional();
+      break;
+    case RVInstr::AMOSWAP_W:
+    case RVInstr::AMOSWAP_D:
+      amo([](XLEN_T, XLEN_T b) { return b; });
+      break;
+    case RVInstr::AMOADD_W:
+    case RVInstr::AMOADD_D:
+      amo([](XLEN_T a, XLEN_T b) { return a + b; });
+      break;
+    case RVInstr::AMOXOR_W:
+    case RVInstr::AMOXOR_D:
+      amo([](XLEN_T a, XLEN_T b) { return a ^ b; });
+      break;
+    case RVInstr::AMOAND_W:
+    case RVInstr::AMOAND_D:
+      amo([](XLEN_T a, XLEN_T b) { return a & b; });
+      break;
+    case RVInstr::AMOOR_W:
+    case RVInstr::AMOOR_D:
+      amo([](XLEN_T a, XLEN_T b) { return a | b; });
+      break;
+    case RVInstr::AMOMIN_W:
+    case RVInstr::AMOMIN_D:
+      amo([](XLEN_T a, XLEN_T b) {
+        return static_cast<XLEN_ST>(a) < static_cast<XLEN_ST>(b) ? a : b;
+      });
+      break;
+    case RVInstr::AMOMAX_W:
+    case RVInstr::AMOMAX_D:
+      amo([](XLEN_T a, XLEN_T b) {
+        return static_cast<XLEN_ST>(a) > static_cast<XLEN_ST>(b) ? a : b;
+      });
+      break;
+    case RVInstr::AMOMINU_W:
+    case RVInstr::AMOMINU_D:
+      amo([](XLEN_T a, XLEN_T b) { return a < b ? a : b; });
+      break;
+    case RVInstr::AMOMAXU_W:
+    case RVInstr::AMOMAXU_D:
+      amo([](XLEN_T a, XLEN_T b) { return a > b ? a : b; });
+      break;
+
+    // F and D extensions
+    case RVInstr::FLW:
+      loadFP(4);
+      break;
+    case RVInstr::FLD:
+      loadFP(8);
+      break;
+    case RVInstr::FSW:
+      store(4, m_fregs[decoded.rs2]);
+      break;
+    case RVInstr::FSD:
+      store(8, m_fregs[decoded.rs2]);
+      break;
+    case RVInstr::FCVT_S_D:
+    case RVInstr::FCVT_D_S: {
+      if (!RVFPU::validRoundingMode(rm))
+        break;
+      unsigned flags = 0;
+      if (opc == RVInstr::FCVT_S_D)
+        writeFP(RVFPU::convert<float>(readFP(0.0, decoded.rs1), rm, flags));
+      else
+        writeFP(RVFPU::convert<double>(readFP(0.0f, decoded.rs1), rm, flags));
+      m_fflags |= flags;
+      break;
+    }
+
+    // V extension
+    case RVInstr::VSETVLI:
+    case RVInstr::VSETIVLI:
+    case RVInstr::VSETVL: {
+      // The AVL is uimm (vsetivli) or rs1. An rs1 of x0 requests VLMAX, or
+      // keeps vl if rd is x0 as well.
+      const bool isImm = opc == RVInstr::VSETIVLI;
+      const bool avlX0 = !isImm && decoded.rs1 == 0;
+      const uint64_t avl =
+          isImm ? decoded.rs1 : (avlX0 ? ~uint64_t(0) : uint64_t(rs1));
+      const XLEN_T vtype = opc == RVInstr::VSETVL ? rs2 : imm;
+      wr(static_cast<XLEN_T>(m_vector.setVL(avl, vtype, avlX0 && rd == 0)));
+      break;
+    }
+    case RVInstr::VLE8_V:
+    case RVInstr::VLE16_V:
+    case RVInstr::VLE32_V:
+    case RVInstr::VLE64_V:
+      vectorMemory(true, 1u << (opc - RVInstr::VLE8_V));
+      break;
+    case RVInstr::VSE8_V:
+    case RVInstr::VSE16_V:
+    case RVInstr::VSE32_V:
+    case RVInstr::VSE64_V:
+      vectorMemory(false, 1u << (opc - RVInstr::VSE8_V));
+      break;
+
+    // Zicsr. Set and clear operations with a zero source (rs1 = x0 or
+    // uimm = 0) do not write the CSR.
+    case RVInstr::CSRRW:
+    case RVInstr::CSRRS:
+    case RVInstr::CSRRC:
+    case RVInstr::CSRRWI:
+    case RVInstr::CSRRSI:
+    case RVInstr::CSRRCI: {
+      const bool isImm = opc == RVInstr::CSRRWI || opc == RVInstr::CSRRSI ||
+                         opc == RVInstr::CSRRCI;
+      const XLEN_T src = isImm ? decoded.rs1 : rs1;
+      const XLEN_T old = readCSR(imm);
+      if (opc == RVInstr::CSRRW || opc == RVInstr::CSRRWI)
+        writeCSR(imm, src);
+      else if (decoded.rs1 != 0)
+        writeCSR(imm, (opc == RVInstr::CSRRS || opc == RVInstr::CSRRSI)
+                          ? old | src
+                          : old & ~src);
+      wr(old);
+      break;
+    }
+
+    case RVInstr::MRET:
+      m_mstatus = RVISA::MSTATUS_MPIE |
+                  ((m_mstatus & RVISA::MSTATUS_MPIE) ? RVISA::MSTATUS_MIE : 0);
+      nextPc = m_mepc;
+      break;
+
+    case RVInstr::WFI:
+      // Idles until the timer interrupt is pending. Without an enabled timer
+      // interrupt, or with the timer disarmed, wfi executes as a NOP.
+      if ((m_mie & RVISA::MTI) && timerCompare) {
+        const uint64_t cmp = timerCompare();
+        constexpr auto maxCycles = std::numeric_limits<long long>::max();
+        if (cmp <= static_cast<uint64_t>(maxCycles) &&
+            static_cast<long long>(cmp) > m_cycleCount + 1)
+          m_cycleCount = static_cast<long long>(cmp) - 1;
+      }
+      break;
+
+    case RVInstr::ECALL:
+      // The PC still points to the ecall while the trap handler executes.
+      if (trapHandler)
+        trapHandler();
+      break;
+
+    default:
+      if (opc >= RVInstr::FMADD_S && opc < RVInstr::FLD)
+        executeFP(0.0f, opc);
+      else if (opc > RVInstr::FSD && opc < RVInstr::FCVT_S_D)
+        executeFP(0.0, opc - (RVInstr::FLD - RVInstr::FLW));
+      else if (opc >= RVInstr::VADD_VV && opc <= RVInstr::VMV_S_X)
+        executeVector(opc);
+      // Unknown instructions are executed as NOPs, mirroring the VSRTL models.
+      break;
+    }
+
+    m_pc = nextPc;
+  }
+
+  /// Replays the current record of the trace, and advances to the next. The PC
+  /// follows the trace, such that control transfers resolve as recorded.
+  void replay() {
+    const unsigned instrBytes = predecode(m_pc).bytes;
+    m_instrAccess = MemoryAccess{MemoryAccess::Read, m_pc, instrBytes};
+    m_dataAccess = m_traceRecord.data;
+    if (nextTraceRecord()) {
+      m_pc = m_traceRecord.pc;
+    } else {
+      m_pc += instrBytes;
+      m_finished = true;
+    }
+  }
+
+  bool nextTraceRecord() {
+    if (!m_trace->next(m_traceRecord))
+      return false;
+    m_traceDecoded = decode(m_traceRecord.instr);
+    return true;
+  }
+
+  // RAM is backed by host pages, such that fetches, loads and stores within
+  // RAM resolve to a direct host memory access.
+  std::shared_ptr<PagedAddressSpaceMM> m_memory;
+  std::shared_ptr<ReservationTable> m_reservations;
+  std::array<XLEN_T, c_RVRegs> m_regs{};
+  std::array<uint64_t, c_RVRegs> m_fregs{};
+  std::unordered_map<AInt, PredecodedInstr> m_predecoded;
+  // Translated blocks by start address, and the start addresses of the blocks
+  // overlapping each page. All translated instructions lie within
+  // [m_translatedStart : m_translatedEnd[.
+  std::unordered_map<AInt, std::unique_ptr<TranslatedBlock>> m_blocks;
+  std::unordered_map<AInt, std::vector<AInt>> m_translatedPages;
+  AInt m_translatedStart = std::numeric_limits<AInt>::max();
+  AInt m_translatedEnd = 0;
+  // Invalidated blocks, freed once the current batch has finished.
+  std::vector<std::unique_ptr<TranslatedBlock>> m_retiredBlocks;
+  // Incremented whenever blocks are invalidated, invalidating all links.
+  uint64_t m_epoch = 0;
+  AInt m_pc = 0;
+  AInt m_pcInitialValue = 0;
+  long long m_instructionsRetired = 0;
+  long long m_cycleCount = 0;
+  bool m_finished = false;
+  bool m_compressed = false;
+  // FLEN is 64 with the D extension, and 32 otherwise.
+  bool m_fpDouble = false;
+  XLEN_T m_hartId = 0;
+
+  MemoryAccess m_dataAccess;
+  MemoryAccess m_instrAccess;
+
+  // The replayed trace, if any (see RipesProcessor::setInstructionTrace), and
+  // the record of the instruction at the PC.
+  std::shared_ptr<InstructionTrace> m_trace;
+  TraceRecord m_traceRecord;
+  PredecodedInstr m_traceDecoded;
+
+  // The CSRs of getCSRState; the writable CSRs other than the vector CSRs.
+  static constexpr std::array<unsigned, 7> s_stateCSRs = {
+      RVISA::FCSR,     RVISA::MSTATUS, RVISA::MIE,   RVISA::MTVEC,
+      RVISA::MSCRATCH, RVISA::MEPC,    RVISA::MCAUSE};
+
+  // Machine-mode trap CSRs.
+  XLEN_T m_mstatus = 0;
+  XLEN_T m_mie = 0;
+  XLEN_T m_mtvec = 0;
+  XLEN_T m_mscratch = 0;
+  XLEN_T m_mepc = 0;
+  XLEN_T m_mcause = 0;
+
+  // Floating-point CSRs; fcsr is composed of frm and fflags.
+  unsigned m_fflags = 0;
+  unsigned m_frm = 0;
+
+  // Vector registers, vl and vtype.
+  RVVectorUnit m_vector;
+
+  std::shared_ptr<ISAInfoBase> m_enabledISA;
+  ProcessorStructure m_structure = {{0, 1}};
+};
+
+} // namespace core
+} // namespace vsrtl
@@ -0,0 +1,346 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../rviss/rviss.h"
+
+namespace vsrtl {
+namespace core {
+using namespace Ripes;
+
+/**
+ * @brief The RVHart class
+ * A hart of a multi-hart processor (see RVMultiHart): a functional RVISS core
+ * executing on a memory shared with the other harts, and identified to
+ * programs through the mhartid CSR.
+ */
+template <typename XLEN_T>
+class RVHart : public RVISS<XLEN_T> {
+  using Base = RVISS<XLEN_T>;
+
+public:
+  RVHart(const QStringList &extensions, unsigned hartId,
+         const std::shared_ptr<PagedAddressSpaceMM> &memory,
+         const std::shared_ptr<ReservationTable> &reservations)
+      : Base(extensions) {
+    this->m_hartId = hartId;
+    this->m_memory = memory;
+    this->m_reservations = reservations;
+    this->m_emitsSignals = false;
+  }
+
+  // The shared memory and reservations are reset by the processor owning the
+  // harts.
+  void resetProcessor() override { this->resetHart(); }
+
+  AInt pc() const { return this->m_pc; }
+};
+
+/**
+ * @brief The RVMultiHart class
+ * A multi-core processor of Harts functional harts (see RVHart), sharing a
+ * single memory. All harts start executing the program at its entry point, and
+ * tell themselves apart through the mhartid CSR. Each hart is shown as a lane
+ * of a single stage.
+ *
+ * The harts synchronize every quantum cycles (see
+ * RipesProcessor::setHartQuantum). With a quantum of 1, each clock executes one
+ * instruction of every hart, in order of their hart IDs, such that execution is
+ * deterministic. With larger quanta, each clock executes a quantum of cycles
+ * with every hart on its own host thread, such that the interleaving of the
+ * memory accesses of the harts within a quantum is not deterministic. Stores
+ * of a hart are visible to the other harts as soon as they execute, and LR/SC
+ * reservations are shared between the harts (see ReservationTable). A hart
+ * which modifies the code of another hart must do so before the code is first
+ * executed.
+ *
+ * The registers of the processor are those of hart 0, except while a hart
+ * executes a system call, during which they are those of the calling hart.
+ * System calls are serialized across harts. An exit system call finishes the
+ * calling hart, and the processor finishes once all harts have finished.
+ * Register writes outside of system calls (ie. register initializations) apply
+ * to all harts, except that the stack pointer of each hart is s_stackSize
+ * bytes below that of the preceding hart, such that harts have disjoint
+ * stacks.
+ *
+ * Cycle counts are those of the processor, in whole quanta, whereas the cycle
+ * and instret CSRs read by a program count the cycles and instructions of the
+ * reading hart. Cache and memory access reporting follows hart 0; the accesses
+ * of each hart are available through hartDataMemAccess().
+ */
+template <typename XLEN_T, unsigned Harts>
+class RVMultiHart : public RipesProcessor {
+  static_assert(Harts >= 1 && Harts <= ReservationTable::s_maxHarts,
+                "Harts must be within [1;16]");
+  using Hart = RVHart<XLEN_T>;
+
+public:
+  static constexpr AInt s_stackSize = 0x10000;
+  static constexpr unsigned s_spReg = 2;
+
+  RVMultiHart(const QStringList &extensions) {
+    m_features = Features::hasDCacheInterface | Features::hasICacheInterface |
+                 Features::hasMultipleHarts;
+    m_memory = std::make_shared<PagedAddressSpaceMM>();
+    m_reservations = std::make_shared<ReservationTable>();
+    for (unsigned id = 0; id < Harts; ++id) {
+      auto hart =
+          std::make_unique<Hart>(extensions, id, m_memory, m_reservations);
+      hart->isExecutableAddress = [this](AInt address) {
+        return isExecutableAddress(address);
+      };
+      hart->timerCompare = [this] {
+        return timerCompare ? timerCompare()
+                            : std::numeric_limits<uint64_t>::max();
+      };
+      for (unsigned i = 0; i < hpmCounters.size(); ++i) {
+        hart->hpmCounters[i] = [this, i] {
+          return hpmCounters[i] ? hpmCounters[i]() : 0;
+        };
+      }
+      hart->trapHandler = [this, id] {
+        std::lock_guard<std::mutex> lock(m_trapLock);
+        m_trapHart = id;
+        if (trapHandler)
+          trapHandler();
+        m_trapHart = -1;
+      };
+      m_harts[id] = std::move(hart);
+    }
+    if (m_harts[0]->features() & Features::hasAtomics)
+      m_features |= Features::hasAtomics;
+    std::map<unsigned, unsigned> lanes;
+    for (unsigned lane = 0; lane < Harts; ++lane)
+      lanes[lane] = 1;
+    m_structure = ProcessorStructure(lanes);
+  }
+
+  ~RVMultiHart() override {
+    {
+      std::lock_guard<std::mutex> lock(m_syncLock);
+      m_quit = true;
+    }
+    m_quantumStarted.notify_all();
+    for (auto &worker : m_workers)
+      worker.join();
+  }
+
+  // Ripes interface compliance
+  const ProcessorStructure &structure() const override { return m_structure; }
+  unsigned int getPcForStage(StageIndex stage) const override {
+    return m_harts.at(stage.lane())->pc();
+  }
+  AInt nextFetchedAddress() const override { return activeHart().pc(); }
+  QString stageName(StageIndex stage) const override {
+    return "hart " + QString::number(stage.lane());
+  }
+  StageInfo stageInfo(StageIndex stage) const override {
+    const Hart &hart = *m_harts.at(stage.lane());
+    const bool running = !hart.finished();
+    return StageInfo({hart.pc(), running,
+                      running ? StageInfo::State::None
+                              : StageInfo::State::Unused});
+  }
+  void setProgramCounter(AInt address) override {
+    for (auto &hart : m_harts)
+      hart->setProgramCounter(address);
+  }
+  void setPCInitialValue(AInt address) override {
+    for (auto &hart : m_harts)
+      hart->setPCInitialValue(address);
+  }
+  AddressSpaceMM &getMemory() override { return *m_memory; }
+  void memoryWritten(AInt address, AInt bytes) override {
+    for (auto &hart : m_harts)
+      hart->memoryWritten(address, bytes);
+  }
+  VInt getRegister(RegisterFileType rfid, unsigned i) const override {
+    return activeHart().getRegister(rfid, i);
+  }
+  void getRegisters(RegisterFileType rfid,
+                    std::vector<VInt> &values) const override {
+    activeHart().getRegisters(rfid, values);
+  }
+  RegisterView registers(RegisterFileType rfid) const override {
+    return activeHart().registers(rfid);
+  }
+  void setRegister(RegisterFileType rfid, unsigned i, VInt v) override {
+    if (m_trapHart >= 0) {
+      m_harts.at(m_trapHart)->setRegister(rfid, i, v);
+      return;
+    }
+    const bool isSp = rfid == RegisterFileType::GPR && i == s_spReg;
+    for (unsigned id = 0; id < Harts; ++id)
+      m_harts[id]->setRegister(rfid, i, isSp ? v - id * s_stackSize : v);
+  }
+  std::map<unsigned, VInt> getCSRState() const override {
+    return activeHart().getCSRState();
+  }
+  void setCSRState(const std::map<unsigned, VInt> &csrs) override {
+    if (m_trapHart >= 0) {
+      m_harts.at(m_trapHart)->setCSRState(csrs);
+      return;
+    }
+    for (auto &hart : m_harts)
+      hart->setCSRState(csrs);
+  }
+  void finalize(FinalizeReason fr) override { activeHart().finalize(fr); }
+  bool finished() const override {
+    for (const auto &hart : m_harts) {
+      if (!hart->finished())
+        return false;
+    }
+    return true;
+  }
+  const std::vector<StageIndex> breakpointTriggeringStages() const override {
+    std::vector<StageIndex> stages;
+    for (unsigned lane = 0; lane < Harts; ++lane)
+      stages.push_back({lane, 0});
+    return stages;
+  }
+  MemoryAccess dataMemAccess() const override {
+    return m_harts[0]->dataMemAccess();
+  }
+  MemoryAccess instrMemAccess() const override {
+    return m_harts[0]->instrMemAccess();
+  }
+  long long getInstructionsRetired() const override {
+    long long retired = 0;
+    for (const auto &hart : m_harts)
+      retired += hart->getInstructionsRetired();
+    return retired;
+  }
+  long long getCycleCount() const override { return m_cycleCount; }
+
+  void resetProcessor() override {
+    m_memory->reset();
+    m_reservations->reset();
+    for (auto &hart : m_harts) {
+      hart->setVLEN(vlen());
+      hart->resetProcessor();
+    }
+    m_cycleCount = 0;
+    if (m_emitsSignals)
+      processorWasReset.Emit();
+  }
+
+  static ProcessorISAInfo supportsISA() { return Hart::supportsISA(); }
+  const ISAInfoBase *implementsISA() const override {
+    return m_harts[0]->implementsISA();
+  }
+  const std::set<RegisterFileType> registerFiles() const override {
+    return m_harts[0]->registerFiles();
+  }
+
+  unsigned hartCount() const override { return Harts; }
+  MemoryAccess hartDataMemAccess(unsigned hart) const override {
+    return m_harts.at(hart)->dataMemAccess();
+  }
+  const ReservationTable *reservations() const override {
+    return m_reservations.get();
+  }
+
+protected:
+  void clockProcessor() override {
+    const unsigned quantum = hartQuantum();
+    if (quantum == 1 || Harts == 1) {
+      for (unsigned cycle = 0; cycle < quantum; ++cycle) {
+        for (auto &hart : m_harts)
+          hart->clock();
+      }
+    } else {
+      runConcurrently(quantum);
+    }
+    m_cycleCount += quantum;
+    if (m_emitsSignals)
+      processorWasClocked.Emit();
+  }
+
+private:
+  const Hart &activeHart() const {
+    const int trapHart = m_trapHart;
+    return *m_harts.at(trapHart >= 0 ? trapHart : 0);
+  }
+  Hart &activeHart() {
+    const int trapHart = m_trapHart;
+    return *m_harts.at(trapHart >= 0 ? trapHart : 0);
+  }
+
+  void runHart(unsigned id, unsigned cycles) {
+    Hart &hart = *m_harts[id];
+    for (unsigned cycle = 0; cycle < cycles && !hart.finished(); ++cycle)
+      hart.clock();
+  }
+
+  /// Executes @p cycles cycles of every hart, each on its own thread. Hart 0
+  /// executes on the calling thread.
+  void runConcurrently(unsigned cycles) {
+    if (m_workers.empty()) {
+      for (unsigned id = 1; id < Harts; ++id)
+        m_workers.emplace_back([this, id] { work(id); });
+    }
+    m_memory->setConcurrent(true);
+    {
+      std::lock_guard<std::mutex> lock(m_syncLock);
+      m_quantumCycles = cycles;
+      m_pendingHarts = Harts - 1;
+      m_quantum++;
+    }
+    m_quantumStarted.notify_all();
+    runHart(0, cycles);
+    {
+      std::unique_lock<std::mutex> lock(m_syncLock);
+      m_quantumFinished.wait(lock, [this] { return m_pendingHarts == 0; });
+    }
+    m_memory->setConcurrent(false);
+  }
+
+  void work(unsigned id) {
+    uint64_t quantum = 0;
+    std::unique_lock<std::mutex> lock(m_syncLock);
+    while (true) {
+      m_quantumStarted.wait(lock,
+                            [&] { return m_quit || m_quantum != quantum; });
+      if (m_quit)
+        return;
+      quantum = m_quantum;
+      const unsigned cycles = m_quantumCycles;
+      lock.unlock();
+      runHart(id, cycles);
+      lock.lock();
+      if (--m_pendingHarts == 0)
+        m_quantumFinished.notify_one();
+    }
+  }
+
+  ProcessorStructure m_structure;
+  std::shared_ptr<PagedAddressSpaceMM> m_memory;
+  std::shared_ptr<ReservationTable> m_reservations;
+  std::array<std::unique_ptr<Hart>, Harts> m_harts;
+  long long m_cycleCount = 0;
+
+  // The hart executing a system call, or -1.
+  std::mutex m_trapLock;
+  std::atomic<int> m_trapHart{-1};
+
+  // Threads executing harts 1..Harts-1, started by the first concurrent
+  // quantum. Each quantum is identified by a sequence number.
+  std::vector<std::thread> m_workers;
+  std::mutex m_syncLock;
+  std::condition_variable m_quantumStarted;
+  std::condition_variable m_quantumFinished;
+  uint64_t m_quantum = 0;
+  unsigned m_quantumCycles = 0;
+  unsigned m_pendingHarts = 0;
+  bool m_quit = false;
+};
+
+} // namespace core
+} // namespace vsrtl
@@ -0,0 +1,448 @@
+#pragma once
+
+#include <array>
+#include <deque>
+
+#include "../rv_timing.h"
+#include "../rviss/rviss.h"
+
+namespace vsrtl {
+namespace core {
+using namespace Ripes;
+
+/**
+ * @brief The RVOutOfOrder class
+ * A timing model of an out-of-order processor, fetching, renaming and
+ * committing up to Width instructions per cycle. Instructions are executed by
+ * the functional model of RVISS as they are fetched, in program order; the
+ * rename table, reorder buffer (ROB), issue queue (IQ) and load/store queue
+ * (LSQ) only model timing. Alternatively, the instructions of a recorded trace
+ * are replayed (see RipesProcessor::setInstructionTrace). The stages are:
+ * - IF: fetches up to Width instructions into the fetch buffer. Branches and
+ *   jumps are predicted by the branch predictor (see BranchPredictor); a
+ *   correctly predicted taken transfer ends the fetch group. Since execution
+ *   is functional, wrong-path instructions are not fetched: fetching stops on
+ *   a misprediction until the transfer has executed.
+ * - RN: renames the source registers of up to Width instructions to their
+ *   in-flight producers, and dispatches them into the ROB, the IQ and (for
+ *   memory instructions) the LSQ. Dispatching stalls while any is full.
+ * - IS: issues up to Width instructions per cycle, oldest first, whose
+ *   operands are available, onto ALUs arithmetic, one M-extension, one
+ *   control-flow and one memory unit. A load waits for any older store to an
+ *   overlapping address to execute, and is then forwarded its data.
+ * - EX: executes issued instructions, for the latency of their unit (see
+ *   RipesProcessor::setMExtTiming for the M-extension units). The multiplier
+ *   is pipelined, whereas the divider accepts a division once the preceding
+ *   division has executed. Results are forwarded to dependent instructions
+ *   issuing in the last execution cycle, such that dependent single-cycle
+ *   instructions issue back-to-back.
+ * - CM: commits up to Width executed instructions per cycle, in order, from the
+ *   head of the ROB.
+ * System instructions (ecall, CSR accesses, mret and wfi) and traps stop
+ * fetching until they commit, and only issue from the head of the ROB.
+ *
+ * Each stage shows the (up to Width) instructions which it processes in the
+ * current cycle, oldest in lane 0.
+ */
+template <typename XLEN_T, unsigned Width = 2, unsigned ROBSize = 32,
+          unsigned IQSize = 16, unsigned LSQSize = 8, unsigned ALUs = Width>
+class RVOutOfOrder : public RVISS<XLEN_T> {
+  static_assert(Width >= 1 && Width <= 4, "Width must be within [1;4]");
+  static_assert(ROBSize >= Width && IQSize >= 1 && IQSize <= ROBSize &&
+                    LSQSize >= 1 && LSQSize <= ROBSize,
+                "Queue sizes must be within [1;ROBSize]");
+  static_assert(ALUs >= 1 && ALUs <= Width, "ALUs must be within [1;Width]");
+  using Base = RVISS<XLEN_T>;
+  using Unit = RVTiming::Unit;
+
+public:
+  enum Stage { IF = 0, RN = 1, IS = 2, EX = 3, CM = 4, STAGECOUNT };
+  static constexpr unsigned s_loadLatency = 2;
+
+  RVOutOfOrder(const QStringList &extensions) : Base(extensions) {
+    this->m_features |= RipesProcessor::hasBranchPredictor |
+                        RipesProcessor::hasMExtLatency |
+                        RipesProcessor::hasTraceReplay;
+    std::map<unsigned, unsigned> lanes;
+    for (unsigned lane = 0; lane < Width; ++lane)
+      lanes[lane] = STAGECOUNT;
+    this->m_structure = ProcessorStructure(lanes);
+    resetPipeline();
+  }
+
+  // Ripes interface compliance
+  unsigned int getPcForStage(StageIndex stage) const override {
+    return slot(stage).pc;
+  }
+  QString stageName(StageIndex stage) const override {
+    switch (stage.index()) {
+    case IF:
+      return "IF";
+    case RN:
+      return "RN";
+    case IS:
+      return "IS";
+    case EX:
+      return "EX";
+    case CM:
+      return "CM";
+    default:
+      return "?";
+    }
+  }
+  StageInfo stageInfo(StageIndex stage) const override {
+    const Slot &s = slot(stage);
+    return StageInfo({s.pc, s.state == StageInfo::State::None, s.state});
+  }
+  void finalize(FinalizeReason fr) override {
+    // Fetching stops upon an exit system call; the instructions in flight
+    // drain from the pipeline.
+    if (fr == FinalizeReason::exitSyscall)
+      this->m_finished = true;
+  }
+  bool finished() const override {
+    return fetchStopped() && m_fetchBuffer.empty() && m_rob.empty();
+  }
+  const std::vector<StageIndex> breakpointTriggeringStages() const override {
+    return {{0, IF}};
+  }
+
+  BranchPredictor *branchPredictor() override { return &m_predictor; }
+
+  void resetProcessor() override {
+    resetPipeline();
+    m_predictor.reset();
+    Base::resetProcessor();
+  }
+
+protected:
+  void clockProcessor() override {
+    const long long now = this->m_cycleCount;
+    for (auto &stage : m_stages)
+      stage.fill(Slot());
+
+    // Stages are evaluated in reverse order, such that each instruction
+    // advances by at most one stage per cycle.
+    const unsigned committed = commit(now);
+    const MemoryAccess dataAccess = issue(now);
+    execute(now);
+    dispatch();
+    const MemoryAccess instrAccess = fetch(now);
+    this->m_instrAccess = instrAccess;
+    this->m_dataAccess = dataAccess;
+
+    this->m_instructionsRetired += committed;
+    this->m_cycleCount++;
+    if (this->m_emitsSignals)
+      this->processorWasClocked.Emit();
+  }
+
+private:
+  struct Slot {
+    AInt pc = 0;
+    StageInfo::State state = StageInfo::State::Unused;
+  };
+
+  struct Entry {
+    // Sequence number in program order, starting from 1.
+    uint64_t seq = 0;
+    AInt pc = 0;
+    RVInstr opc = RVInstr::NOP;
+    Unit unit = Unit::ALU;
+    // Architectural source registers (x0 if not read) and destination register
+    // (x0 if not written).
+    unsigned rs1 = 0;
+    unsigned rs2 = 0;
+    unsigned rd = 0;
+    // Sequence numbers of the producers of the source operands, assigned when
+    // renamed, or 0 for operands read from the architectural register file.
+    std::array<uint64_t, 2> producers{};
+    // Whether the prediction of a control transfer was wrong.
+    bool mispredicted = false;
+    bool issued = false;
+    long long issueCycle = 0;
+    unsigned latency = 1;
+    MemoryAccess dataAccess;
+
+    // Whether the result is available to instructions issuing in @p cycle.
+    bool resultReady(long long cycle) const {
+      return issued && issueCycle + latency <= cycle;
+    }
+    bool executing(long long cycle) const {
+      return issued && issueCycle < cycle && cycle <= issueCycle + latency;
+    }
+    bool executed(long long cycle) const {
+      return issued && issueCycle + latency < cycle;
+    }
+    bool isStore() const {
+      return unit == Unit::Memory && !RVTiming::isLoad(opc);
+    }
+  };
+
+  const Slot &slot(StageIndex stage) const {
+    return m_stages.at(stage.index()).at(stage.lane());
+  }
+  void setSlot(Stage stage, unsigned lane, AInt pc) {
+    m_stages.at(stage).at(lane) = {pc, StageInfo::State::None};
+  }
+  /// Marks the remaining slots of @p stage, from @p lane, as @p state.
+  void fillSlots(Stage stage, unsigned lane, StageInfo::State state) {
+    for (; lane < Width; ++lane)
+      m_stages.at(stage).at(lane) = {this->m_pc, state};
+  }
+
+  bool fetchStopped() const {
+    return this->m_finished || !this->isFetchable(this->m_pc);
+  }
+
+  void resetPipeline() {
+    for (auto &stage : m_stages)
+      stage.fill(Slot());
+    m_fetchBuffer.clear();
+    m_rob.clear();
+    m_renameTable.fill(0);
+    m_iqCount = 0;
+    m_lsqCount = 0;
+    m_nextSeq = 1;
+    m_fetchBlocker = 0;
+    m_fetchResume = 0;
+    m_divBusyUntil = 0;
+  }
+
+  /// Returns the in-flight instruction of sequence number @p seq, or nullptr
+  /// if it has committed.
+  const Entry *inFlight(uint64_t seq) const {
+    if (seq == 0 || m_rob.empty() || seq < m_rob.front().seq)
+      return nullptr;
+    return &m_rob.at(seq - m_rob.front().seq);
+  }
+  bool operandReady(uint64_t producer, long long cycle) const {
+    const Entry *entry = inFlight(producer);
+    return !entry || entry->resultReady(cycle);
+  }
+
+  /// Returns whether the load @p load must wait for an older store to an
+  /// overlapping address, which has not yet executed.
+  bool storeConflict(const Entry &load, long long cycle) const {
+    const AInt start = load.dataAccess.address;
+    const AInt end = start + load.dataAccess.bytes;
+    for (const Entry &entry : m_rob) {
+      if (entry.seq == load.seq)
+        break;
+      if (!entry.isStore() || entry.resultReady(cycle))
+        continue;
+      const AInt storeStart = entry.dataAccess.address;
+      const AInt storeEnd = storeStart + entry.dataAccess.bytes;
+      if (storeStart < end && start < storeEnd)
+        return true;
+    }
+    return false;
+  }
+
+  unsigned commit(long long cycle) {
+    unsigned lane = 0;
+    while (lane < Width && !m_rob.empty() && m_rob.front().executed(cycle)) {
+      const Entry &entry = m_rob.front();
+      if (entry.rd != 0 && m_renameTable.at(entry.rd) == entry.seq)
+        m_renameTable.at(entry.rd) = 0;
+      if (entry.unit == Unit::Memory)
+        m_lsqCount--;
+      if (entry.seq == m_fetchBlocker) {
+        // A serializing instruction; fetching resumes in the next cycle.
+        m_fetchBlocker = 0;
+        m_fetchResume = cycle + 1;
+      }
+      setSlot(CM, lane++, entry.pc);
+      m_rob.pop_front();
+    }
+    fillSlots(CM, lane,
+              m_rob.empty() ? StageInfo::State::Unused
+                            : StageInfo::State::Stalled);
+    return lane;
+  }
+
+  /// Issues the instructions of the current cycle, and returns the data memory
+  /// access of the memory unit, if any.
+  MemoryAccess issue(long long cycle) {
+    std::array<unsigned, RVTiming::NUnits> unitsUsed{};
+    MemoryAccess dataAccess;
+    unsigned lane = 0;
+    for (Entry &entry : m_rob) {
+      if (lane == Width)
+        break;
+      auto &used = unitsUsed[static_cast<unsigned>(entry.unit)];
+      if (entry.issued || used == unitCount(entry.unit) ||
+          !operandReady(entry.producers[0], cycle) ||
+          !operandReady(entry.producers[1], cycle))
+        continue;
+      if (entry.unit == Unit::System && entry.seq != m_rob.front().seq)
+        continue;
+      if ((RVTiming::isLoad(entry.opc) || RVTiming::isAtomic(entry.opc)) &&
+          storeConflict(entry, cycle))
+        continue;
+      const bool division = RVTiming::isDivision(entry.opc);
+      if (division && cycle < m_divBusyUntil)
+        continue;
+
+      entry.issued = true;
+      entry.issueCycle = cycle;
+      used++;
+      m_iqCount--;
+      if (division)
+        m_divBusyUntil = cycle + entry.latency;
+      if (entry.unit == Unit::Memory)
+        dataAccess = entry.dataAccess;
+      if (entry.mispredicted && entry.seq == m_fetchBlocker) {
+        // The correct path is fetched once the transfer has executed.
+        m_fetchBlocker = 0;
+        m_fetchResume = entry.issueCycle + entry.latency + 1;
+      }
+      setSlot(IS, lane++, entry.pc);
+    }
+    fillSlots(IS, lane,
+              m_iqCount == 0 ? StageInfo::State::Unused
+                             : StageInfo::State::Stalled);
+    return dataAccess;
+  }
+
+  void execute(long long cycle) {
+    unsigned lane = 0;
+    bool anyIssued = false;
+    for (const Entry &entry : m_rob) {
+      if (lane == Width)
+        break;
+      if (entry.executing(cycle))
+        setSlot(EX, lane++, entry.pc);
+      anyIssued |= entry.issued;
+    }
+    fillSlots(EX, lane,
+              anyIssued ? StageInfo::State::Stalled : StageInfo::State::Unused);
+  }
+
+  void dispatch() {
+    unsigned lane = 0;
+    while (lane < Width && !m_fetchBuffer.empty()) {
+      Entry &entry = m_fetchBuffer.front();
+      if (m_rob.size() == ROBSize || m_iqCount == IQSize ||
+          (entry.unit == Unit::Memory && m_lsqCount == LSQSize))
+        break;
+      if (entry.rs1 != 0)
+        entry.producers[0] = m_renameTable.at(entry.rs1);
+      if (entry.rs2 != 0)
+        entry.producers[1] = m_renameTable.at(entry.rs2);
+      if (entry.rd != 0)
+        m_renameTable.at(entry.rd) = entry.seq;
+      m_iqCount++;
+      if (entry.unit == Unit::Memory)
+        m_lsqCount++;
+      setSlot(RN, lane++, entry.pc);
+      m_rob.push_back(entry);
+      m_fetchBuffer.pop_front();
+    }
+    fillSlots(RN, lane,
+              m_fetchBuffer.empty() ? StageInfo::State::Unused
+                                    : StageInfo::State::Stalled);
+  }
+
+  /// Fetches (and executes) the instructions of the current cycle, and returns
+  /// the instruction memory access of the first.
+  MemoryAccess fetch(long long cycle) {
+    MemoryAccess instrAccess;
+    unsigned lane = 0;
+    const bool blocked = m_fetchBlocker != 0 || cycle < m_fetchResume;
+    if (!blocked && !fetchStopped() && (this->m_mie & RVISA::MTI) &&
+        (this->m_mstatus & RVISA::MSTATUS_MIE) && this->timerPending())
+      this->trap(RVISA::MTIMER_CAUSE, true);
+
+    while (!blocked && lane < Width && m_fetchBuffer.size() < Width &&
+           !fetchStopped()) {
+      const AInt pc = this->m_pc;
+      const auto decoded = this->predecode(pc);
+      this->step();
+
+      Entry entry;
+      entry.seq = m_nextSeq++;
+      entry.pc = pc;
+      entry.opc = decoded.opcode;
+      entry.unit = RVTiming::unitOf(entry.opc);
+      entry.rs1 = RVTiming::readsRs1(entry.opc) ? decoded.rs1 : 0;
+      entry.rs2 = RVTiming::readsRs2(entry.opc) ? decoded.rs2 : 0;
+      entry.rd = RVTiming::writesRd(entry.opc) ? decoded.rd : 0;
+      entry.latency = latency(entry.opc);
+      entry.dataAccess = this->m_dataAccess;
+      if (lane == 0)
+        instrAccess = this->m_instrAccess;
+      setSlot(IF, lane++, pc);
+
+      const AInt next = pc + decoded.bytes;
+      bool endGroup = this->m_pc != next;
+      if (entry.unit == Unit::Branch) {
+        const auto kind =
+            RVTiming::controlKind(entry.opc, decoded.rd, decoded.rs1);
+        const AInt target = entry.opc == RVInstr::JALR
+                                ? next
+                                : static_cast<XLEN_T>(pc + decoded.imm);
+        const AInt predicted = m_predictor.predict(pc, kind, next, target);
+        entry.mispredicted =
+            !m_predictor.resolve(pc, kind, next, predicted, this->m_pc);
+        if (entry.mispredicted)
+          m_fetchBlocker = entry.seq;
+      } else if (entry.unit == Unit::System || endGroup) {
+        m_fetchBlocker = entry.seq;
+        endGroup = true;
+      }
+      m_fetchBuffer.push_back(entry);
+      if (endGroup || entry.mispredicted)
+        break;
+    }
+
+    StageInfo::State emptyState = StageInfo::State::Stalled;
+    if (fetchStopped())
+      emptyState = StageInfo::State::Unused;
+    else if (lane == 0 && blocked)
+      emptyState = StageInfo::State::Flushed;
+    fillSlots(IF, lane, emptyState);
+    return instrAccess;
+  }
+
+  static unsigned unitCount(Unit unit) {
+    return unit == Unit::ALU ? ALUs : 1;
+  }
+
+  unsigned latency(RVInstr opc) const {
+    if (RVTiming::isDivision(opc))
+      return this->m_mextTiming.divLatency;
+    if (RVTiming::isMultiplication(opc))
+      return this->m_mextTiming.mulLatency;
+    if (RVTiming::isLoad(opc) || RVTiming::isAtomic(opc))
+      return s_loadLatency;
+    return 1;
+  }
+
+  // Instructions shown by each stage in the current cycle, indexed by stage
+  // and lane.
+  std::array<std::array<Slot, Width>, STAGECOUNT> m_stages;
+  // Fetched instructions awaiting dispatch, in program order.
+  std::deque<Entry> m_fetchBuffer;
+  // The reorder buffer, in program order; dispatched instructions remain until
+  // committed.
+  std::deque<Entry> m_rob;
+  // Sequence number of the in-flight producer of each architectural register,
+  // or 0 if the register file holds its value.
+  std::array<uint64_t, c_RVRegs> m_renameTable{};
+  // Dispatched instructions which have not issued, and dispatched memory
+  // instructions which have not committed.
+  unsigned m_iqCount = 0;
+  unsigned m_lsqCount = 0;
+  uint64_t m_nextSeq = 1;
+  // The instruction which fetching is stopped on (see fetch()), or 0.
+  uint64_t m_fetchBlocker = 0;
+  // The cycle from which fetching resumes, following m_fetchBlocker.
+  long long m_fetchResume = 0;
+  // The cycle from which the divider accepts a division.
+  long long m_divBusyUntil = 0;
+  BranchPredictor m_predictor;
+};
+
+} // namespace core
+} // namespace vsrtl
@@ -110,6 +110,7 @@ public:
     alu_op2_src->out >> alu->op2;
 
     control->alu_ctrl >> alu->ctrl;
+    alu->setCSRReader([=](unsigned csr) { return readCounterCSR(csr); });
 
     // -----------------------------------------------------------------------
     // Data memory
@@ -182,6 +183,10 @@ public:
   VInt getRegister(RegisterFileType, unsigned i) const override {
     return registerFile->getRegister(i);
   }
+  void getRegisters(RegisterFileType,
+                    std::vector<VInt> &values) const override {
+    registerFile->getRegisters(values);
+  }
   void finalize(FinalizeReason fr) override {
     if (fr == FinalizeReason::exitSyscall) {
       // Allow one additional clock cycle to clear the current instruction
@@ -216,6 +221,13 @@ public:
     // before clocking the processor, and emit finished if this was the final
     // clock cycle.
     const bool finishInThisCycle = m_finishInNextCycle;
+    checkImplemented(pc_reg->out.uValue(), decode->opcode.uValue(),
+                     immediate->imm.uValue() & 0xfff,
+                     decode->r1_reg_idx.uValue());
+    // The M-extension units hold the processor for their full latency, once
+    // the instruction of this cycle has executed.
+    scheduleMExtStall({{true, static_cast<unsigned>(alu->ctrl.uValue())}},
+                      false);
     Design::clock();
     if (finishInThisCycle) {
       m_finished = true;
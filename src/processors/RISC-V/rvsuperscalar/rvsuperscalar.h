@@ -0,0 +1,288 @@
+#pragma once
+
+#include <array>
+#include <deque>
+
+#include "../rv_timing.h"
+#include "../rviss/rviss.h"
+
+namespace vsrtl {
+namespace core {
+using namespace Ripes;
+
+/**
+ * @brief The RVSuperscalar class
+ * A timing model of an in-order superscalar processor, issuing up to Width
+ * instructions per cycle into a 5-stage pipeline. Instructions are executed by
+ * the functional model of RVISS as they are issued, and then flow through the
+ * pipeline lanes to retire from WB; the lanes only model timing.
+ * Alternatively, the instructions of a recorded trace are replayed (see
+ * RipesProcessor::setInstructionTrace).
+ *
+ * A contiguous group of instructions is issued each cycle, in program order,
+ * until an instruction cannot issue:
+ * - Data hazards: an instruction reading a register written by an earlier
+ *   instruction of its group (no same-cycle forwarding), or by a load of the
+ *   previous group (load-use hazard), or by a multiplication still executing
+ *   in the pipelined multiplier. Other results are forwarded.
+ * - Structural hazards: each cycle issues at most ALUs arithmetic, MulDivUnits
+ *   M-extension, BranchUnits control-flow and a single memory instruction.
+ *   Memory instructions are limited to one per cycle, given that the data
+ *   cache interface reports a single access per cycle.
+ * - System instructions (ecall, CSR accesses, mret and wfi) issue alone.
+ * - Divisions occupy the iterative divider for their full latency (see
+ *   RipesProcessor::setMExtTiming), during which no instructions issue. A
+ *   division ends its group.
+ * Branches and jumps are predicted in IF by the branch predictor (see
+ * BranchPredictor), which predicts all branches not taken unless configured
+ * otherwise. A taken branch or jump ends its group. Branches and jumps are
+ * resolved in EX; upon a misprediction, and upon traps, no instructions issue
+ * for s_branchPenalty cycles.
+ *
+ * With Width = 1, the model approximates the timing of a 5-stage pipeline with
+ * forwarding and hazard detection; the IPC of a program may be compared across
+ * issue widths, all else being equal.
+ */
+template <typename XLEN_T, unsigned Width, unsigned ALUs = Width,
+          unsigned MulDivUnits = 1, unsigned BranchUnits = 1>
+class RVSuperscalar : public RVISS<XLEN_T> {
+  static_assert(Width >= 1 && Width <= 4, "Issue width must be within [1;4]");
+  static_assert(ALUs >= 1 && ALUs <= Width && MulDivUnits >= 1 &&
+                    MulDivUnits <= Width && BranchUnits >= 1 &&
+                    BranchUnits <= Width,
+                "Functional unit counts must be within [1;Width]");
+  using Base = RVISS<XLEN_T>;
+
+public:
+  enum Stage { IF = 0, ID = 1, EX = 2, MEM = 3, WB = 4, STAGECOUNT };
+  static constexpr unsigned s_branchPenalty = EX - IF;
+
+  RVSuperscalar(const QStringList &extensions) : Base(extensions) {
+    this->m_features |= RipesProcessor::hasBranchPredictor |
+                        RipesProcessor::hasMExtLatency |
+                        RipesProcessor::hasTraceReplay;
+    std::map<unsigned, unsigned> lanes;
+    for (unsigned lane = 0; lane < Width; ++lane)
+      lanes[lane] = STAGECOUNT;
+    this->m_structure = ProcessorStructure(lanes);
+    resetPipeline();
+  }
+
+  // Ripes interface compliance
+  unsigned int getPcForStage(StageIndex stage) const override {
+    return slot(stage).pc;
+  }
+  QString stageName(StageIndex stage) const override {
+    switch (stage.index()) {
+    case IF:
+      return "IF";
+    case ID:
+      return "ID";
+    case EX:
+      return "EX";
+    case MEM:
+      return "MEM";
+    case WB:
+      return "WB";
+    default:
+      return "?";
+    }
+  }
+  StageInfo stageInfo(StageIndex stage) const override {
+    const Slot &s = slot(stage);
+    return StageInfo({s.pc, s.state == StageInfo::State::None, s.state});
+  }
+  void finalize(FinalizeReason fr) override {
+    // Fetching stops upon an exit system call; the instructions in flight
+    // drain from the pipeline.
+    if (fr == FinalizeReason::exitSyscall)
+      this->m_finished = true;
+  }
+  bool finished() const override {
+    if (!fetchStopped())
+      return false;
+    for (const auto &group : m_pipeline) {
+      if (group.issued != 0)
+        return false;
+    }
+    return true;
+  }
+  const std::vector<StageIndex> breakpointTriggeringStages() const override {
+    return {{0, IF}};
+  }
+
+  BranchPredictor *branchPredictor() override { return &m_predictor; }
+
+  void resetProcessor() override {
+    resetPipeline();
+    m_predictor.reset();
+    Base::resetProcessor();
+  }
+
+protected:
+  void clockProcessor() override {
+    if (!fetchStopped() && (this->m_mie & RVISA::MTI) &&
+        (this->m_mstatus & RVISA::MSTATUS_MIE) && this->timerPending())
+      this->trap(RVISA::MTIMER_CAUSE, true);
+
+    m_pipeline.pop_back();
+    m_pipeline.push_front(issue());
+    this->m_instructionsRetired += m_pipeline.at(WB).issued;
+    this->m_cycleCount++;
+    if (this->m_emitsSignals)
+      this->processorWasClocked.Emit();
+  }
+
+private:
+  using Unit = RVTiming::Unit;
+
+  struct Slot {
+    AInt pc = 0;
+    StageInfo::State state = StageInfo::State::Unused;
+  };
+  struct Group {
+    std::array<Slot, Width> slots;
+    unsigned issued = 0;
+  };
+
+  const Slot &slot(StageIndex stage) const {
+    return m_pipeline.at(stage.index()).slots.at(stage.lane());
+  }
+
+  bool fetchStopped() const {
+    return this->m_finished || !this->isFetchable(this->m_pc);
+  }
+
+  void resetPipeline() {
+    m_pipeline.assign(STAGECOUNT, Group());
+    m_flushCycles = 0;
+    m_divCycles = 0;
+    m_readyCycle.fill(0);
+  }
+
+  /// Issues (and executes) the group of instructions of the current cycle.
+  Group issue() {
+    Group group;
+    std::array<bool, c_RVRegs> written{};
+    std::array<unsigned, RVTiming::NUnits> unitsUsed{};
+    MemoryAccess instrAccess;
+    MemoryAccess dataAccess;
+    StageInfo::State emptyState = StageInfo::State::Stalled;
+
+    const long long cycle = this->m_cycleCount;
+    if (m_flushCycles > 0) {
+      m_flushCycles--;
+      emptyState = StageInfo::State::Flushed;
+    } else if (m_divCycles > 0) {
+      m_divCycles--;
+    } else {
+      for (unsigned lane = 0; lane < Width; ++lane) {
+        if (fetchStopped())
+          break;
+        const AInt pc = this->m_pc;
+        const auto decoded = this->predecode(pc);
+        const RVInstr opc = decoded.opcode;
+        const Unit unit = RVTiming::unitOf(opc);
+        auto &used = unitsUsed[static_cast<unsigned>(unit)];
+        if (used == unitCount(unit) || (unit == Unit::System && lane != 0))
+          break;
+        const auto hazard = [&](unsigned reg) {
+          return reg != 0 && (written[reg] || m_readyCycle[reg] > cycle);
+        };
+        if ((RVTiming::readsRs1(opc) && hazard(decoded.rs1)) ||
+            (RVTiming::readsRs2(opc) && hazard(decoded.rs2)))
+          break;
+
+        this->step();
+        used++;
+        group.slots[lane] = {pc, StageInfo::State::None};
+        group.issued++;
+        if (lane == 0)
+          instrAccess = this->m_instrAccess;
+        if (this->m_dataAccess.type != MemoryAccess::None)
+          dataAccess = this->m_dataAccess;
+        if (RVTiming::writesRd(opc)) {
+          written[decoded.rd] = true;
+          m_readyCycle[decoded.rd] = cycle + resultLatency(opc);
+        }
+
+        const AInt next = pc + decoded.bytes;
+        if (unit == Unit::Branch) {
+          const auto kind =
+              RVTiming::controlKind(opc, decoded.rd, decoded.rs1);
+          const AInt target = opc == RVInstr::JALR
+                                  ? next
+                                  : static_cast<XLEN_T>(pc + decoded.imm);
+          const AInt predicted = m_predictor.predict(pc, kind, next, target);
+          if (!m_predictor.resolve(pc, kind, next, predicted, this->m_pc)) {
+            m_flushCycles = s_branchPenalty;
+            break;
+          }
+          // A correctly predicted taken transfer redirects fetch without a
+          // penalty, but ends the group.
+          if (this->m_pc != next)
+            break;
+        } else if (this->m_pc != next) {
+          // Trap or return from trap
+          m_flushCycles = s_branchPenalty;
+          break;
+        }
+        if (unit == Unit::System)
+          break;
+        if (RVTiming::isDivision(opc)) {
+          m_divCycles = this->m_mextTiming.divLatency - 1;
+          break;
+        }
+      }
+      if (group.issued != 0)
+        emptyState = StageInfo::State::WayHazard;
+    }
+
+    if (fetchStopped() && group.issued == 0)
+      emptyState = StageInfo::State::Unused;
+    for (unsigned lane = group.issued; lane < Width; ++lane)
+      group.slots[lane] = {this->m_pc, emptyState};
+    this->m_instrAccess = instrAccess;
+    this->m_dataAccess = dataAccess;
+    return group;
+  }
+
+  /// Cycles after issue until the result of @p opc may be forwarded.
+  unsigned resultLatency(RVInstr opc) const {
+    if (RVTiming::isLoad(opc) || RVTiming::isAtomic(opc))
+      return 2;
+    if (RVTiming::isMultiplication(opc))
+      return this->m_mextTiming.mulLatency;
+    if (RVTiming::isDivision(opc))
+      return this->m_mextTiming.divLatency;
+    return 1;
+  }
+
+  static unsigned unitCount(Unit unit) {
+    switch (unit) {
+    case Unit::ALU:
+      return ALUs;
+    case Unit::MulDiv:
+      return MulDivUnits;
+    case Unit::Branch:
+      return BranchUnits;
+    case Unit::Memory:
+    case Unit::System:
+      return 1;
+    }
+    return 1;
+  }
+
+  // Issue groups, indexed by the stage they occupy.
+  std::deque<Group> m_pipeline;
+  // Cycles until instructions issue again, following a taken control transfer.
+  unsigned m_flushCycles = 0;
+  // Cycles until instructions issue again, following a division.
+  unsigned m_divCycles = 0;
+  // Cycle from which the result of each register may be forwarded.
+  std::array<long long, c_RVRegs> m_readyCycle{};
+  BranchPredictor m_predictor;
+};
+
+} // namespace core
+} // namespace vsrtl
@@ -0,0 +1,209 @@
+// A single-cycle RV32IM core, with the top-level ports expected by the Ripes
+// Verilator processor adapter (see ../verilatedcore.h). Instructions execute
+// in a single cycle, with memories read combinationally by the environment.
+// ecall is executed by the environment; ebreak, fence and CSR instructions
+// execute as NOPs.
+module rv32_core (
+    input  wire        clk,
+    input  wire        rst,
+    input  wire        halt,
+    // Instruction memory
+    output wire [31:0] imem_addr,
+    input  wire [31:0] imem_rdata,
+    // Data memory
+    output wire [31:0] dmem_addr,
+    output wire        dmem_re,
+    output wire        dmem_we,
+    output wire [1:0]  dmem_size,
+    output wire [31:0] dmem_wdata,
+    input  wire [31:0] dmem_rdata,
+    // Execution state
+    output wire [31:0] pc,
+    output wire        retire,
+    output wire        ecall,
+    // Debug port, written while halted
+    input  wire [4:0]  dbg_reg_addr,
+    output wire [31:0] dbg_reg_rdata,
+    input  wire        dbg_reg_we,
+    input  wire [31:0] dbg_reg_wdata,
+    input  wire        dbg_pc_we,
+    input  wire [31:0] dbg_pc_wdata
+);
+  localparam OP_LUI    = 7'b0110111;
+  localparam OP_AUIPC  = 7'b0010111;
+  localparam OP_JAL    = 7'b1101111;
+  localparam OP_JALR   = 7'b1100111;
+  localparam OP_BRANCH = 7'b1100011;
+  localparam OP_LOAD   = 7'b0000011;
+  localparam OP_STORE  = 7'b0100011;
+  localparam OP_IMM    = 7'b0010011;
+  localparam OP_REG    = 7'b0110011;
+  localparam OP_SYSTEM = 7'b1110011;
+
+  reg [31:0] pc_q;
+  reg [31:0] regs [0:31];
+
+  // Decode
+  wire [31:0] instr  = imem_rdata;
+  wire [6:0]  opcode = instr[6:0];
+  wire [4:0]  rd     = instr[11:7];
+  wire [2:0]  funct3 = instr[14:12];
+  wire [4:0]  rs1    = instr[19:15];
+  wire [4:0]  rs2    = instr[24:20];
+  wire [6:0]  funct7 = instr[31:25];
+
+  wire [31:0] imm_i = {{20{instr[31]}}, instr[31:20]};
+  wire [31:0] imm_s = {{20{instr[31]}}, instr[31:25], instr[11:7]};
+  wire [31:0] imm_b = {{20{instr[31]}}, instr[7], instr[30:25], instr[11:8],
+                       1'b0};
+  wire [31:0] imm_u = {instr[31:12], 12'd0};
+  wire [31:0] imm_j = {{12{instr[31]}}, instr[19:12], instr[20], instr[30:21],
+                       1'b0};
+
+  wire [31:0] rs1_val = rs1 == 5'd0 ? 32'd0 : regs[rs1];
+  wire [31:0] rs2_val = rs2 == 5'd0 ? 32'd0 : regs[rs2];
+
+  wire is_reg  = opcode == OP_REG;
+  wire is_mext = is_reg && funct7 == 7'b0000001;
+
+  // ALU. Signed operations are computed on their own wires, such that their
+  // operands are not made unsigned by the surrounding expressions.
+  wire [31:0] alu_b   = is_reg ? rs2_val : imm_i;
+  wire [4:0]  shamt   = alu_b[4:0];
+  wire [31:0] sra_res = $signed(rs1_val) >>> shamt;
+  wire        lt      = $signed(rs1_val) < $signed(alu_b);
+  wire        ltu     = rs1_val < alu_b;
+  reg  [31:0] alu_res;
+  always @(*) begin
+    case (funct3)
+      3'b000:  alu_res = (is_reg && funct7[5]) ? rs1_val - alu_b
+                                               : rs1_val + alu_b;
+      3'b001:  alu_res = rs1_val << shamt;
+      3'b010:  alu_res = {31'd0, lt};
+      3'b011:  alu_res = {31'd0, ltu};
+      3'b100:  alu_res = rs1_val ^ alu_b;
+      3'b101:  alu_res = funct7[5] ? sra_res : rs1_val >> shamt;
+      3'b110:  alu_res = rs1_val | alu_b;
+      default: alu_res = rs1_val & alu_b;
+    endcase
+  end
+
+  // M extension. Division by zero and signed overflow are resolved without
+  // dividing, as the host would trap on the overflowing division.
+  wire [63:0] mul_ss = $signed({{32{rs1_val[31]}}, rs1_val}) *
+                       $signed({{32{rs2_val[31]}}, rs2_val});
+  wire [63:0] mul_su = $signed({{32{rs1_val[31]}}, rs1_val}) *
+                       $signed({32'd0, rs2_val});
+  wire [63:0] mul_uu = {32'd0, rs1_val} * {32'd0, rs2_val};
+  wire        div_zero = rs2_val == 32'd0;
+  wire        div_ovf  = rs1_val == 32'h80000000 && rs2_val == 32'hffffffff;
+  wire [31:0] divisor  = (div_zero || div_ovf) ? 32'd1 : rs2_val;
+  wire [31:0] divisoru = div_zero ? 32'd1 : rs2_val;
+  wire [31:0] div_s    = $signed(rs1_val) / $signed(divisor);
+  wire [31:0] rem_s    = $signed(rs1_val) % $signed(divisor);
+  reg  [31:0] mext_res;
+  always @(*) begin
+    case (funct3)
+      3'b000:  mext_res = mul_ss[31:0];
+      3'b001:  mext_res = mul_ss[63:32];
+      3'b010:  mext_res = mul_su[63:32];
+      3'b011:  mext_res = mul_uu[63:32];
+      3'b100:  mext_res = div_zero ? 32'hffffffff
+                                   : div_ovf ? rs1_val : div_s;
+      3'b101:  mext_res = div_zero ? 32'hffffffff : rs1_val / divisoru;
+      3'b110:  mext_res = div_zero ? rs1_val : div_ovf ? 32'd0 : rem_s;
+      default: mext_res = div_zero ? rs1_val : rs1_val % divisoru;
+    endcase
+  end
+
+  // Memory. The environment returns the accessed bytes zero-extended.
+  wire is_load  = opcode == OP_LOAD;
+  wire is_store = opcode == OP_STORE;
+  assign dmem_addr  = rs1_val + (is_store ? imm_s : imm_i);
+  assign dmem_re    = is_load;
+  assign dmem_we    = is_store && !halt && !rst;
+  assign dmem_size  = funct3[1:0];
+  assign dmem_wdata = rs2_val;
+  reg [31:0] load_val;
+  always @(*) begin
+    case (funct3)
+      3'b000:  load_val = {{24{dmem_rdata[7]}}, dmem_rdata[7:0]};
+      3'b001:  load_val = {{16{dmem_rdata[15]}}, dmem_rdata[15:0]};
+      3'b100:  load_val = {24'd0, dmem_rdata[7:0]};
+      3'b101:  load_val = {16'd0, dmem_rdata[15:0]};
+      default: load_val = dmem_rdata;
+    endcase
+  end
+
+  // Control flow
+  wire blt  = $signed(rs1_val) < $signed(rs2_val);
+  wire bltu = rs1_val < rs2_val;
+  reg  taken;
+  always @(*) begin
+    case (funct3)
+      3'b000:  taken = rs1_val == rs2_val;
+      3'b001:  taken = rs1_val != rs2_val;
+      3'b100:  taken = blt;
+      3'b101:  taken = !blt;
+      3'b110:  taken = bltu;
+      3'b111:  taken = !bltu;
+      default: taken = 1'b0;
+    endcase
+  end
+
+  wire [31:0] pc_plus4 = pc_q + 32'd4;
+  reg  [31:0] next_pc;
+  always @(*) begin
+    case (opcode)
+      OP_JAL:    next_pc = pc_q + imm_j;
+      OP_JALR:   next_pc = (rs1_val + imm_i) & ~32'd1;
+      OP_BRANCH: next_pc = taken ? pc_q + imm_b : pc_plus4;
+      default:   next_pc = pc_plus4;
+    endcase
+  end
+
+  // Write-back
+  reg [31:0] wb_val;
+  reg        wb_en;
+  always @(*) begin
+    wb_en = rd != 5'd0;
+    case (opcode)
+      OP_LUI:   wb_val = imm_u;
+      OP_AUIPC: wb_val = pc_q + imm_u;
+      OP_JAL,
+      OP_JALR:  wb_val = pc_plus4;
+      OP_LOAD:  wb_val = load_val;
+      OP_IMM:   wb_val = alu_res;
+      OP_REG:   wb_val = is_mext ? mext_res : alu_res;
+      default: begin
+        wb_val = 32'd0;
+        wb_en  = 1'b0;
+      end
+    endcase
+  end
+
+  integer i;
+  always @(posedge clk) begin
+    if (rst) begin
+      pc_q <= 32'd0;
+      for (i = 0; i < 32; i = i + 1)
+        regs[i] <= 32'd0;
+    end else if (halt) begin
+      if (dbg_reg_we && dbg_reg_addr != 5'd0)
+        regs[dbg_reg_addr] <= dbg_reg_wdata;
+      if (dbg_pc_we)
+        pc_q <= dbg_pc_wdata;
+    end else begin
+      if (wb_en)
+        regs[rd] <= wb_val;
+      pc_q <= next_pc;
+    end
+  end
+
+  assign imem_addr     = pc_q;
+  assign pc            = pc_q;
+  assign retire        = !halt && !rst;
+  assign ecall         = opcode == OP_SYSTEM && funct3 == 3'd0 &&
+                         instr[31:20] == 12'd0;
+  assign dbg_reg_rdata = dbg_reg_addr == 5'd0 ? 32'd0 : regs[dbg_reg_addr];
+endmodule
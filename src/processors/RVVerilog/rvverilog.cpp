@@ -0,0 +1,13 @@
+#include "rvverilog.h"
+
+#include "../verilatedcore.h"
+#include "Vrv32_core.h"
+
+namespace Ripes {
+
+RVVerilog::RVVerilog(const QStringList &extensions)
+    : RipesVerilatorProcessor(
+          std::make_unique<VerilatedCore<Vrv32_core>>(RIPES_VERILATOR_THREADS),
+          std::make_shared<ISAInfo<ISA::RV32I>>(extensions)) {}
+
+} // namespace Ripes
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "../../isa/rv32isainfo.h"
+#include "../ripesverilatorprocessor.h"
+
+namespace Ripes {
+
+/**
+ * @brief The RVVerilog class
+ * A single-cycle RV32IM processor, simulated from its Verilog description
+ * (rv32_core.v) through Verilator. The core always implements the M
+ * extension.
+ */
+class RVVerilog : public RipesVerilatorProcessor {
+public:
+  RVVerilog(const QStringList &extensions);
+
+  static ProcessorISAInfo supportsISA() {
+    return ProcessorISAInfo{
+        std::make_shared<ISAInfo<ISA::RV32I>>(QStringList()), {"M"}, {"M"}};
+  }
+};
+
+} // namespace Ripes
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Ripes {
+
+/**
+ * @brief The ComponentProfiler class
+ * Opt-in instrumentation of the combinational logic of processor components.
+ * When enabled, each evaluation of an instrumented output port (see
+ * RIPES_PROFILE_COMPONENT) is counted and timed, and accumulated per
+ * component. When disabled, an instrumented evaluation costs a single branch.
+ *
+ * Only the components of the Ripes processor models are instrumented; the
+ * registers, multiplexers and gates provided by VSRTL are not. The profiler is
+ * not thread safe: it must be enabled, cleared and read while the processor is
+ * not running.
+ */
+class ComponentProfiler {
+public:
+  struct Entry {
+    std::string name;
+    unsigned long long evaluations = 0;
+    long long nanoseconds = 0;
+  };
+
+  static void setEnabled(bool enabled) { s_enabled = enabled; }
+  static bool isEnabled() { return s_enabled; }
+  static void clear() { s_entries.clear(); }
+
+  /// Returns the accumulated statistics of all evaluated components, ordered
+  /// by decreasing time.
+  static std::vector<Entry> entries() {
+    std::vector<Entry> entries;
+    entries.reserve(s_entries.size());
+    for (const auto &it : s_entries)
+      entries.push_back(it.second);
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry &lhs, const Entry &rhs) {
+                if (lhs.nanoseconds != rhs.nanoseconds)
+                  return lhs.nanoseconds > rhs.nanoseconds;
+                return lhs.name < rhs.name;
+              });
+    return entries;
+  }
+
+  /**
+   * @brief The Scope class
+   * Times the evaluation which it is constructed within, and charges it to
+   * @p component upon destruction.
+   */
+  class Scope {
+  public:
+    Scope(const void *component, const std::string &name) {
+      if (!s_enabled)
+        return;
+      m_component = component;
+      m_name = &name;
+      m_start = Clock::now();
+    }
+    ~Scope() {
+      if (m_component)
+        record(m_component, *m_name, Clock::now() - m_start);
+    }
+
+  private:
+    const void *m_component = nullptr;
+    const std::string *m_name = nullptr;
+    std::chrono::steady_clock::time_point m_start;
+  };
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  static void record(const void *component, const std::string &name,
+                     Clock::duration elapsed) {
+    Entry &entry = s_entries[component];
+    if (entry.evaluations == 0)
+      entry.name = name;
+    entry.evaluations++;
+    entry.nanoseconds +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  }
+
+  static inline bool s_enabled = false;
+  static inline std::unordered_map<const void *, Entry> s_entries;
+};
+
+} // namespace Ripes
+
+/// Profiles the enclosing output port evaluation of a component, if component
+/// profiling is enabled. @p name is the name of the component.
+#define RIPES_PROFILE_COMPONENT(name)                                          \
+  const Ripes::ComponentProfiler::Scope ripesProfileScope_(this, name)
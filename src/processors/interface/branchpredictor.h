@@ -0,0 +1,177 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+
+#include <algorithm>
+#include <vector>
+
+#include "../../ripes_types.h"
+
+namespace Ripes {
+
+/**
+ * @brief The BranchPredictor class
+ * A branch predictor of the fetch stage of a pipelined processor, predicting
+ * the address fetched after each control-flow instruction. The direction of
+ * conditional branches is predicted by one of the schemes below; targets are
+ * read from a direct-mapped branch target buffer (BTB), and return addresses
+ * from a return address stack (RAS):
+ * - NotTaken: all control-flow instructions fall through (no prediction).
+ * - BTFN: backward branches are taken and forward branches not taken, and
+ *   direct jumps are taken, given the target decoded in the fetch stage. No
+ *   BTB or RAS is used.
+ * - Bimodal: a table of 2-bit saturating counters indexed by the PC.
+ * - GShare: a table of 2-bit saturating counters indexed by the PC xor the
+ *   global history of branch directions.
+ * With the dynamic schemes, a branch or jump is only predicted taken if the
+ * BTB (or, for returns, the RAS) holds its target.
+ *
+ * Predictions are resolved in program order through resolve(), which trains
+ * the predictor and counts the mispredictions.
+ */
+class BranchPredictor {
+public:
+  enum class Scheme { NotTaken, BTFN, Bimodal, GShare };
+  enum class Kind { Branch, Jump, Call, Return };
+
+  struct Config {
+    Scheme scheme = Scheme::NotTaken;
+    // log2 of the number of 2-bit counters, which is also the length of the
+    // global history of gshare.
+    unsigned counterBits = 10;
+    // log2 of the number of BTB entries.
+    unsigned btbBits = 6;
+    unsigned rasDepth = 8;
+  };
+
+  struct Stats {
+    unsigned long long branches = 0;
+    unsigned long long branchMispredictions = 0;
+    unsigned long long jumps = 0;
+    unsigned long long jumpMispredictions = 0;
+  };
+
+  BranchPredictor() { configure(Config()); }
+
+  static QStringList schemeNames() {
+    return {"nottaken", "btfn", "bimodal", "gshare"};
+  }
+  static QString schemeName(Scheme scheme) {
+    return schemeNames().at(static_cast<int>(scheme));
+  }
+
+  /// Sets the configuration of the predictor, clearing its state.
+  void configure(const Config &config) {
+    m_config = config;
+    m_counters.assign(size_t(1) << config.counterBits, s_weaklyNotTaken);
+    m_btb.assign(size_t(1) << config.btbBits, BTBEntry());
+    m_ras.assign(config.rasDepth, 0);
+    reset();
+  }
+  const Config &config() const { return m_config; }
+
+  /// Clears the tables and statistics of the predictor.
+  void reset() {
+    std::fill(m_counters.begin(), m_counters.end(), s_weaklyNotTaken);
+    std::fill(m_btb.begin(), m_btb.end(), BTBEntry());
+    m_rasTop = 0;
+    m_rasSize = 0;
+    m_history = 0;
+    m_stats = Stats();
+  }
+
+  const Stats &stats() const { return m_stats; }
+
+  /**
+   * @brief predict
+   * Returns the predicted address fetched after the control-flow instruction
+   * at @p pc, of kind @p kind, whose fall-through address is @p next. For
+   * direct branches and jumps, @p target is the target encoded by the
+   * instruction; it is only used by the static schemes.
+   */
+  AInt predict(AInt pc, Kind kind, AInt next, AInt target) {
+    switch (m_config.scheme) {
+    case Scheme::NotTaken:
+      return next;
+    case Scheme::BTFN:
+      if (kind == Kind::Branch)
+        return target < pc ? target : next;
+      return target != next ? target : next;
+    case Scheme::Bimodal:
+    case Scheme::GShare:
+      break;
+    }
+
+    if (kind == Kind::Return && m_rasSize > 0) {
+      m_rasTop = (m_rasTop + m_ras.size() - 1) % m_ras.size();
+      m_rasSize--;
+      return m_ras.at(m_rasTop);
+    }
+    if (kind == Kind::Call && !m_ras.empty()) {
+      m_ras.at(m_rasTop) = next;
+      m_rasTop = (m_rasTop + 1) % m_ras.size();
+      m_rasSize = std::min<size_t>(m_rasSize + 1, m_ras.size());
+    }
+    if (kind == Kind::Branch && m_counters.at(counterIndex(pc)) < 2)
+      return next;
+    const BTBEntry &entry = m_btb.at(btbIndex(pc));
+    return entry.valid && entry.pc == pc ? entry.target : next;
+  }
+
+  /**
+   * @brief resolve
+   * Resolves the latest prediction of the instruction at @p pc. @p predicted
+   * is the address returned by predict(), and @p actual the address executed
+   * after the instruction. Returns whether the prediction was correct.
+   */
+  bool resolve(AInt pc, Kind kind, AInt next, AInt predicted, AInt actual) {
+    const bool correct = predicted == actual;
+    const bool taken = actual != next;
+    if (kind == Kind::Branch) {
+      m_stats.branches++;
+      m_stats.branchMispredictions += !correct;
+      uint8_t &counter = m_counters.at(counterIndex(pc));
+      if (taken && counter < 3)
+        counter++;
+      else if (!taken && counter > 0)
+        counter--;
+      m_history = (m_history << 1) | (taken ? 1 : 0);
+    } else {
+      m_stats.jumps++;
+      m_stats.jumpMispredictions += !correct;
+    }
+    if (taken && kind != Kind::Return)
+      m_btb.at(btbIndex(pc)) = BTBEntry{true, pc, actual};
+    return correct;
+  }
+
+private:
+  static constexpr uint8_t s_weaklyNotTaken = 1;
+
+  struct BTBEntry {
+    bool valid = false;
+    AInt pc = 0;
+    AInt target = 0;
+  };
+
+  // Instructions are (at least) 2-byte aligned.
+  size_t counterIndex(AInt pc) const {
+    AInt index = pc >> 1;
+    if (m_config.scheme == Scheme::GShare)
+      index ^= m_history;
+    return index & (m_counters.size() - 1);
+  }
+  size_t btbIndex(AInt pc) const { return (pc >> 1) & (m_btb.size() - 1); }
+
+  Config m_config;
+  std::vector<uint8_t> m_counters;
+  std::vector<BTBEntry> m_btb;
+  std::vector<AInt> m_ras;
+  size_t m_rasTop = 0;
+  size_t m_rasSize = 0;
+  AInt m_history = 0;
+  Stats m_stats;
+};
+
+} // namespace Ripes
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "ripesprocessor.h"
+
+namespace Ripes {
+
+/// A committed instruction of a functional trace: its PC, its (possibly
+/// compressed) instruction word and its data memory access, if any.
+struct TraceRecord {
+  AInt pc = 0;
+  uint32_t instr = 0;
+  MemoryAccess data;
+};
+
+/**
+ * @brief The InstructionTrace class
+ * A source of the committed instructions of a previously recorded execution,
+ * in program order, which a timing model may replay in place of executing a
+ * program (see RipesProcessor::setInstructionTrace). Traces are streamed; a
+ * trace is read again from its start whenever the processor is reset.
+ */
+class InstructionTrace {
+public:
+  virtual ~InstructionTrace() = default;
+
+  /// Restarts the trace from its first record.
+  virtual void rewind() = 0;
+  /// Reads the next record of the trace into @p record. Returns false at the
+  /// end of the trace, or if the trace could not be read.
+  virtual bool next(TraceRecord &record) = 0;
+};
+
+} // namespace Ripes
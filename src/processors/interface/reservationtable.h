@@ -0,0 +1,156 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <mutex>
+
+#include "../../ripes_types.h"
+
+namespace Ripes {
+
+/**
+ * @brief The ReservationTable class
+ * The reservation sets of the harts of a processor, for the load-reserved and
+ * store-conditional instructions of the A extension. Each hart holds at most
+ * one reservation, of the bytes read by its most recent LR. A reservation is
+ * lost when the hart executes an SC, or when another hart stores to a byte of
+ * the reservation.
+ *
+ * Harts may execute concurrently on host threads (see RVMultiHart), and plain
+ * stores invalidate reservations without synchronizing with the memory access
+ * itself. An SC therefore also compares the reserved bytes against the value
+ * read by the LR, and fails if they differ, such that a store racing an SC is
+ * never lost.
+ *
+ * Counts the LR, SC and AMO instructions of each hart, the SC failures, and
+ * the reservations lost to stores of other harts, as a measure of contention.
+ */
+class ReservationTable {
+public:
+  static constexpr unsigned s_maxHarts = 16;
+
+  struct Stats {
+    unsigned long long loadReserved = 0;
+    unsigned long long storeConditional = 0;
+    unsigned long long storeConditionalFailures = 0;
+    unsigned long long amos = 0;
+    // Reservations of the hart lost to stores of other harts.
+    unsigned long long invalidations = 0;
+  };
+
+  /// Clears all reservations and statistics.
+  void reset() {
+    std::lock_guard<std::mutex> lock(m_lock);
+    for (auto &hart : m_harts) {
+      hart.reservation = Reservation();
+      hart.loadReserved = 0;
+      hart.storeConditional = 0;
+      hart.storeConditionalFailures = 0;
+      hart.amos = 0;
+      hart.invalidations = 0;
+    }
+    m_active = 0;
+  }
+
+  /// Registers the reservation of @p hart on the @p bytes bytes at @p address,
+  /// which an LR has read as @p value. Replaces any preceding reservation.
+  void reserve(unsigned hart, AInt address, unsigned bytes, VInt value) {
+    std::lock_guard<std::mutex> lock(m_lock);
+    Hart &h = m_harts.at(hart);
+    h.loadReserved++;
+    if (!h.reservation.valid)
+      m_active++;
+    h.reservation = Reservation{true, address, bytes, value};
+  }
+
+  /**
+   * @brief storeConditional
+   * Executes an SC of @p hart to the @p bytes bytes at @p address, clearing
+   * the reservation of the hart. If the reservation covers the access,
+   * @p compareExchange is called with the value read by the LR, and must store
+   * the SC value if memory still holds it, returning whether it did. A
+   * successful SC invalidates the overlapping reservations of other harts.
+   * @returns whether the SC succeeded.
+   */
+  template <typename CompareExchange>
+  bool storeConditional(unsigned hart, AInt address, unsigned bytes,
+                        CompareExchange &&compareExchange) {
+    std::lock_guard<std::mutex> lock(m_lock);
+    Hart &h = m_harts.at(hart);
+    h.storeConditional++;
+    const Reservation reservation = h.reservation;
+    if (reservation.valid) {
+      h.reservation.valid = false;
+      m_active--;
+    }
+    const bool success = reservation.valid && reservation.address == address &&
+                         reservation.bytes == bytes &&
+                         compareExchange(reservation.value);
+    if (success)
+      invalidateOthers(hart, address, bytes);
+    else
+      h.storeConditionalFailures++;
+    return success;
+  }
+
+  /// Invalidates the reservations of harts other than @p hart which overlap
+  /// the @p bytes bytes at @p address, which @p hart has stored to.
+  void invalidate(unsigned hart, AInt address, unsigned bytes) {
+    if (m_active.load(std::memory_order_relaxed) == 0)
+      return;
+    std::lock_guard<std::mutex> lock(m_lock);
+    invalidateOthers(hart, address, bytes);
+  }
+
+  void countAMO(unsigned hart) {
+    m_harts.at(hart).amos.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  Stats stats(unsigned hart) const {
+    const Hart &h = m_harts.at(hart);
+    Stats stats;
+    stats.loadReserved = h.loadReserved;
+    stats.storeConditional = h.storeConditional;
+    stats.storeConditionalFailures = h.storeConditionalFailures;
+    stats.amos = h.amos;
+    stats.invalidations = h.invalidations;
+    return stats;
+  }
+
+private:
+  struct Reservation {
+    bool valid = false;
+    AInt address = 0;
+    unsigned bytes = 0;
+    VInt value = 0;
+  };
+
+  struct Hart {
+    Reservation reservation;
+    std::atomic<unsigned long long> loadReserved{0};
+    std::atomic<unsigned long long> storeConditional{0};
+    std::atomic<unsigned long long> storeConditionalFailures{0};
+    std::atomic<unsigned long long> amos{0};
+    std::atomic<unsigned long long> invalidations{0};
+  };
+
+  void invalidateOthers(unsigned hart, AInt address, unsigned bytes) {
+    for (unsigned i = 0; i < s_maxHarts; ++i) {
+      Reservation &r = m_harts[i].reservation;
+      if (i == hart || !r.valid || r.address >= address + bytes ||
+          address >= r.address + r.bytes)
+        continue;
+      r.valid = false;
+      m_active--;
+      m_harts[i].invalidations++;
+    }
+  }
+
+  std::array<Hart, s_maxHarts> m_harts;
+  // The number of valid reservations, such that stores need not lock the
+  // table while no reservations are held.
+  std::atomic<unsigned> m_active{0};
+  std::mutex m_lock;
+};
+
+} // namespace Ripes
@@ -4,13 +4,72 @@
 
 #include "Signals/Signal.h"
 #include "VSRTL/core/vsrtl_design.h"
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include "../../isa/isainfo.h"
 #include "../../ripes_types.h"
+#include "branchpredictor.h"
+#include "reservationtable.h"
 
 namespace Ripes {
 
+class InstructionTrace;
+
+/**
+ * @brief The NamedStates class
+ * Interns the names of the states which processors report for their stages
+ * (see StageInfo::namedState) into small integer ids, such that a StageInfo
+ * carries no string. Ids are unique across all processor models and remain
+ * valid for the lifetime of the program. Id 0 is the empty name.
+ */
+class NamedStates {
+public:
+  using ID = uint16_t;
+  static constexpr ID None = 0;
+
+  /// Returns the id of @p name, interning it if not seen before.
+  static ID intern(const QString &name) {
+    if (name.isEmpty())
+      return None;
+    auto &self = get();
+    std::lock_guard<std::mutex> lock(self.m_mutex);
+    auto it = self.m_ids.find(name);
+    if (it != self.m_ids.end())
+      return it->second;
+    const ID id = static_cast<ID>(self.m_names.size());
+    self.m_names.push_back(name);
+    self.m_ids[name] = id;
+    return id;
+  }
+
+  /// Returns the name interned as @p id, or an empty string if unknown.
+  static const QString &name(ID id) {
+    auto &self = get();
+    std::lock_guard<std::mutex> lock(self.m_mutex);
+    // Elements of a deque are not moved as it grows, such that the returned
+    // reference remains valid after the lock is released.
+    return id < self.m_names.size() ? self.m_names[id] : self.m_names[None];
+  }
+
+private:
+  NamedStates() { m_names.emplace_back(); }
+  static NamedStates &get() {
+    static NamedStates instance;
+    return instance;
+  }
+
+  std::mutex m_mutex;
+  std::deque<QString> m_names;
+  std::map<QString, ID> m_ids;
+};
+
 /**
  * @brief The StageInfo struct
  * Contains information regarding the state of the instruction currently present
@@ -22,7 +81,8 @@ struct StageInfo {
   AInt pc = 0;
   bool stage_valid = false;
   State state;
-  QString namedState = "";
+  // Id of the named state of the stage, interned through NamedStates.
+  NamedStates::ID namedState = NamedStates::None;
   bool operator==(const StageInfo &other) const {
     return this->pc == other.pc && this->stage_valid == other.stage_valid &&
            this->state == other.state;
@@ -46,67 +106,85 @@ struct StageIndex : public std::pair<unsigned, unsigned> {
   unsigned index() const { return this->second; }
 };
 
-/// Structural description of the processor model. Currently this is a map of
-///   {# of lanes : # of stages}
-struct ProcessorStructure : public std::map<unsigned, unsigned> {
-  using std::map<unsigned, unsigned>::map;
-
-  struct StageIterator {
-    StageIterator(const ProcessorStructure &structure)
-        : m_structure(structure) {}
-
-    struct Iterator {
-      using iterator_category = std::forward_iterator_tag;
-      using difference_type = std::ptrdiff_t;
-      using value_type = StageIndex;
-      using pointer = value_type *;
-      using reference = value_type &;
-
-      Iterator(unsigned lane, unsigned index,
-               const ProcessorStructure &structure)
-          : m_lane(lane), m_index(index), m_structure(structure) {}
-      StageIndex operator*() const { return {m_lane, m_index}; }
-      StageIndex operator->() const { return {m_lane, m_index}; }
-      Iterator &operator++() {
-        ++m_index;
-        if (m_index == m_structure.at(m_lane)) {
-          m_index = 0;
-          ++m_lane;
-        }
-        return *this;
-      }
-      Iterator operator++(int) {
-        Iterator tmp = *this;
-        ++(*this);
-        return tmp;
-      }
-      bool operator==(const Iterator &other) const {
-        return m_lane == other.m_lane && m_index == other.m_index;
-      }
-      bool operator!=(const Iterator &other) const { return !(*this == other); }
-
-      unsigned m_lane = 0;
-      unsigned m_index = 0;
-      const ProcessorStructure &m_structure;
-    };
-
-    Iterator begin() const { return Iterator(0, 0, m_structure); }
-    Iterator end() const {
-      return Iterator(m_structure.size(), 0, m_structure);
+/**
+ * @brief The ProcessorStructure class
+ * Structural description of the processor model: the number of stages of each
+ * lane, for lanes 0 to size() - 1. A structure is immutable once constructed,
+ * and precomputes a flat table of all of its stages, such that iterating over
+ * the stages, counting them and mapping between a stage and its position in
+ * the table are constant time per stage.
+ */
+class ProcessorStructure {
+public:
+  using Lane = std::pair<unsigned, unsigned>; // {lane : # of stages}
+  using const_iterator = std::vector<Lane>::const_iterator;
+
+  ProcessorStructure() = default;
+  ProcessorStructure(std::initializer_list<Lane> lanes)
+      : ProcessorStructure(std::map<unsigned, unsigned>(lanes.begin(),
+                                                        lanes.end())) {}
+  explicit ProcessorStructure(const std::map<unsigned, unsigned> &lanes) {
+    for (const auto &lane : lanes) {
+      Q_ASSERT(lane.first == m_lanes.size() && "Lanes must be contiguous");
+      m_lanes.push_back(lane);
+      m_laneOffsets.push_back(m_stages.size());
+      for (unsigned idx = 0; idx < lane.second; ++idx)
+        m_stages.push_back({lane.first, idx});
     }
-    const ProcessorStructure &m_structure;
-  };
+  }
+
+  // Iteration over the lanes, as {lane : # of stages} pairs.
+  const_iterator begin() const { return m_lanes.begin(); }
+  const_iterator end() const { return m_lanes.end(); }
 
-  // Returns an iterator over all stages.
-  StageIterator stageIt() const { return {*this}; }
+  // Returns the number of lanes.
+  size_t size() const { return m_lanes.size(); }
+  // Returns the number of stages of @p lane.
+  unsigned at(unsigned lane) const { return m_lanes.at(lane).second; }
+
+  // Returns all stages, lane by lane.
+  const std::vector<StageIndex> &stageIt() const { return m_stages; }
 
   // Returns the total number of stages of this processor.
-  unsigned numStages() const {
-    unsigned count = 0;
-    for (auto it : *this)
-      count += it.second;
-    return count;
+  unsigned numStages() const { return m_stages.size(); }
+
+  // Returns the position of @p stage in stageIt().
+  unsigned flatIndex(StageIndex stage) const {
+    return m_laneOffsets[stage.lane()] + stage.index();
   }
+
+private:
+  std::vector<Lane> m_lanes;
+  std::vector<unsigned> m_laneOffsets;
+  std::vector<StageIndex> m_stages;
+};
+
+/**
+ * @brief The RegisterView class
+ * A read-only view of the values of each register of a register file, by
+ * register index (see RipesProcessor::registers). A view refers to the
+ * registers in place; it is invalidated once the processor is clocked, reset,
+ * written or destroyed. Views of 64-bit registers may mask each value to the
+ * register width of the register file.
+ */
+class RegisterView {
+public:
+  RegisterView() = default;
+  RegisterView(const uint32_t *regs, unsigned size)
+      : m_regs32(regs), m_size(size) {}
+  RegisterView(const uint64_t *regs, unsigned size, uint64_t mask = ~0ULL)
+      : m_regs64(regs), m_size(size), m_mask(mask) {}
+
+  unsigned size() const { return m_size; }
+  VInt operator[](unsigned i) const {
+    return m_regs64 ? m_regs64[i] & m_mask : m_regs32[i];
+  }
+
+private:
+  const uint32_t *m_regs32 = nullptr;
+  const uint64_t *m_regs64 = nullptr;
+  unsigned m_size = 0;
+  uint64_t m_mask = ~0ULL;
 };
 
 /**
@@ -144,7 +222,13 @@ public:
   enum Features {
     isReversible = 0b1,
     hasICacheInterface = 0b10,
-    hasDCacheInterface = 0b100
+    hasDCacheInterface = 0b100,
+    hasMemoryStalls = 0b1000,
+    hasBranchPredictor = 0b10000,
+    hasMExtLatency = 0b100000,
+    hasMultipleHarts = 0b1000000,
+    hasAtomics = 0b10000000,
+    hasTraceReplay = 0b100000000
   };
 
   unsigned features() const { return m_features; }
@@ -205,6 +289,19 @@ public:
    */
   virtual StageInfo stageInfo(StageIndex stageIndex) const = 0;
 
+  /**
+   * @brief stageInfos
+   * Fills @p infos with the stage info of each stage in the current cycle, in
+   * the order of structure().stageIt(). @p infos must hold at least
+   * structure().numStages() elements. Consumers which query every stage each
+   * cycle should prefer this over stageInfo(), which models may override to
+   * share work across stages.
+   */
+  virtual void stageInfos(StageInfo *infos) const {
+    for (auto stage : structure().stageIt())
+      *infos++ = stageInfo(stage);
+  }
+
   /**
    * @brief breakpointTriggeringStages
    * @returns the stage indices for which a breakpoint is triggered when the
@@ -219,6 +316,18 @@ public:
    */
   virtual vsrtl::core::AddressSpaceMM &getMemory() = 0;
 
+  /**
+   * @brief memoryWritten
+   * Notifies the processor that the @p bytes bytes at @p address were written
+   * by other than the processor itself; ie. by system calls, a debugger,
+   * peripherals or the user. Processors which cache decoded or translated
+   * instructions drop those overlapping the range.
+   */
+  virtual void memoryWritten(AInt address, AInt bytes) {
+    Q_UNUSED(address);
+    Q_UNUSED(bytes);
+  }
+
   /**
    * @brief dataMemAccess/instrMemAccess
    * @returns the state of a current access to the instruction or data memory.
@@ -228,6 +337,14 @@ public:
   virtual MemoryAccess dataMemAccess() const = 0;
   virtual MemoryAccess instrMemAccess() const = 0;
 
+  /**
+   * @brief dataMemAccessPC
+   * @returns the address of the instruction performing dataMemAccess(). For
+   * single-cycle processors, this is the instruction fetched in the same
+   * cycle.
+   */
+  virtual AInt dataMemAccessPC() const { return instrMemAccess().address; }
+
   /**
    * @brief getRegister
    * @param rfid: register file identifier
@@ -236,6 +353,35 @@ public:
    */
   virtual VInt getRegister(RegisterFileType rfid, unsigned i) const = 0;
 
+  /**
+   * @brief getRegisters
+   * @param rfid: register file identifier
+   * @param values: set to the values currently present in each register of
+   * @p rfid, by register index.
+   * Processors may override this to read a register file in a single call.
+   */
+  virtual void getRegisters(RegisterFileType rfid,
+                            std::vector<VInt> &values) const {
+    values.resize(implementsISA()->regCnt());
+    for (unsigned i = 0; i < values.size(); ++i)
+      values[i] = getRegister(rfid, i);
+  }
+
+  /**
+   * @brief registers
+   * @param rfid: register file identifier
+   * @returns a view of the values currently present in each register of
+   * @p rfid, by register index (see RegisterView).
+   * Processors which hold a register file in an array should override this to
+   * return a view of the array. By default, the registers are read through
+   * getRegisters into a buffer of the processor, which the view refers to.
+   */
+  virtual RegisterView registers(RegisterFileType rfid) const {
+    auto &buffer = m_registerBuffers[rfid];
+    getRegisters(rfid, buffer);
+    return RegisterView(buffer.data(), buffer.size());
+  }
+
   /**
    * @brief setRegister
    * @param rfid: register file identifier
@@ -244,6 +390,37 @@ public:
    */
   virtual void setRegister(RegisterFileType rfid, unsigned i, VInt v) = 0;
 
+  /**
+   * @brief setRegisters
+   * @param rfid: register file identifier
+   * Sets the value of each register of @p rfid which is a key of @p values to
+   * its value. Processors may override this to write a register file in a
+   * single call.
+   */
+  virtual void setRegisters(RegisterFileType rfid,
+                            const std::map<unsigned, VInt> &values) {
+    for (const auto &value : values)
+      setRegister(rfid, value.first, value.second);
+  }
+
+  /**
+   * @brief getCSRState
+   * @returns the values of the CSRs holding architectural state outside of the
+   * register files (ie. fcsr and the machine-mode trap CSRs), by CSR number.
+   * Counter CSRs follow from the cycle and instruction counts, and are not
+   * included. Processors which implement no such CSRs return an empty map.
+   */
+  virtual std::map<unsigned, VInt> getCSRState() const { return {}; }
+
+  /**
+   * @brief setCSRState
+   * Writes each CSR of @p csrs, as returned by getCSRState, which the processor
+   * implements.
+   */
+  virtual void setCSRState(const std::map<unsigned, VInt> &csrs) {
+    Q_UNUSED(csrs);
+  }
+
   /**
    * @brief setProgramCounter
    * Sets the program counter of the processor to @param address
@@ -267,10 +444,25 @@ public:
    * Clocks the processor.
    */
   void clock() {
-    if (!finished())
+    if (!finished() && !stallProcessor())
       clockProcessor();
   }
 
+  /**
+   * @brief clockBatch
+   * Clocks the processor up to @p cycles times, stopping once it has finished,
+   * and returns the number of clocks. Equivalent to clocking the processor
+   * repeatedly, but processors may execute a batch faster (see RVISS). The
+   * processor is only observable through its clocked signal in between the
+   * clocks of a batch.
+   */
+  virtual long long clockBatch(long long cycles) {
+    long long clocked = 0;
+    for (; clocked < cycles && !finished(); ++clocked)
+      clock();
+    return clocked;
+  }
+
   /**
    * @brief finalize
    * Called from Ripes to indicate that the processor should start or stop its
@@ -304,6 +496,80 @@ public:
    */
   virtual long long getCycleCount() const = 0;
 
+  /** ======================= Performance counters ======================= */
+
+  /**
+   * @brief hpmCounters
+   * Callbacks providing the values of the hpmcounter4..31 CSRs, indexed by
+   * counter number. Set by the Ripes environment, ie. for the cache simulator
+   * to expose its miss counts to programs. Unset counters read as zero.
+   */
+  std::array<std::function<uint64_t()>, 32> hpmCounters;
+
+  /**
+   * @brief readCounterCSR
+   * @returns the value of the unprivileged counter CSR numbered @p csr, as
+   * read by programs through the CSRRS instruction (ie. rdcycle): cycle,
+   * time, instret and hpmcounter3..31, and their upper halves for 32-bit ISAs.
+   * time counts cycles, and hpmcounter3 counts memory stall cycles. Other CSRs
+   * read as zero.
+   */
+  uint64_t readCounterCSR(unsigned csr) const {
+    if (!isCounterCSR(csr))
+      return 0;
+    const bool is32 = implementsISA()->bits() == 32;
+    const bool upper = csr >= 0xc80 && csr <= 0xc9f;
+
+    uint64_t value = 0;
+    const unsigned counter = csr & 0x1f;
+    switch (counter) {
+    case 0: // cycle
+    case 1: // time
+      value = getCycleCount();
+      break;
+    case 2: // instret
+      value = getInstructionsRetired();
+      break;
+    case 3: // hpmcounter3
+      value = getMemoryStallCycles();
+      break;
+    default:
+      if (hpmCounters[counter])
+        value = hpmCounters[counter]();
+      break;
+    }
+    if (upper)
+      return value >> 32;
+    return is32 ? value & 0xffffffff : value;
+  }
+
+  /**
+   * @brief isCounterCSR
+   * @returns true if @p csr is one of the counter CSRs read by readCounterCSR.
+   */
+  bool isCounterCSR(unsigned csr) const {
+    return (csr >= 0xc00 && csr <= 0xc1f) ||
+           (csr >= 0xc80 && csr <= 0xc9f && implementsISA()->bits() == 32);
+  }
+
+  /**
+   * @brief timerCompare
+   * Callback providing the value of the mtimecmp register of the machine timer,
+   * set by the Ripes environment while a timer peripheral is mapped. mtime
+   * counts cycles (as the time CSR), and a machine timer interrupt is pending
+   * while mtime >= mtimecmp. Unset, no timer interrupt is ever pending.
+   * Processors without machine-mode trap support ignore the timer.
+   */
+  std::function<uint64_t()> timerCompare;
+
+  /**
+   * @brief unsupportedInstrHandler
+   * Callback for processors executing an instruction which they decode, but do
+   * not implement, given the address of the instruction. Set by the Ripes
+   * environment, which reports the instruction and stops the simulation.
+   */
+  std::function<void(AInt)> unsupportedInstrHandler;
+
   /** ======================= Signals and callbacks ======================= */
   /**
    * @brief clocked, reversed & reset signals
@@ -330,6 +596,16 @@ public:
    */
   std::function<void(void)> trapHandler;
 
+  /**
+   * @brief isOutputOnlyEcall
+   * Callback for the processor to query whether the syscall of number @p id
+   * only produces output (see Syscall::outputOnly). Pipelined processors which
+   * drain their outstanding register writes before handling an ecall may
+   * instead handle such ecalls right away, reading their arguments through the
+   * writes in flight. If unset, all ecalls drain the pipeline.
+   */
+  std::function<bool(VInt)> isOutputOnlyEcall;
+
   /** ======================== FEATURE: Reversible ======================== */
   // Enabled by setting m_features.isReversible = true
 
@@ -345,6 +621,229 @@ public:
    */
   virtual void setMaxReverseCycles(unsigned cycles) { Q_UNUSED(cycles); }
 
+  /**
+   * @brief The Snapshot struct
+   * The complete state of a processor at some cycle; its registers, memory,
+   * counters and microarchitectural state. Opaque to all but the processor
+   * which saved it.
+   */
+  struct Snapshot {
+    virtual ~Snapshot() = default;
+  };
+  /**
+   * @brief saveSnapshot
+   * Returns a snapshot of the processor, which restoreSnapshot returns the
+   * processor to, such that execution continues exactly as it did from the
+   * cycle of the snapshot. Processors whose state cannot be saved return
+   * nullptr; these only return to an earlier cycle by being reset and
+   * re-executed (see ProcessorHandler::seekToCycle).
+   */
+  virtual std::shared_ptr<const Snapshot> saveSnapshot() const {
+    return nullptr;
+  }
+  /// Restores @p snapshot, as saved by this processor. No signals are emitted.
+  virtual void restoreSnapshot(const Snapshot &snapshot) { Q_UNUSED(snapshot); }
+
+  /** ====================== FEATURE: Memory stalls ====================== */
+  // Enabled by setting m_features.hasMemoryStalls = true
+
+  /**
+   * @brief stallForMemory
+   * Stalls the processor for @p cycles clock cycles, starting from the next
+   * clock, ie. when a memory access of the current cycle misses in a cache.
+   * The processor state is frozen during a memory stall; the cycles are
+   * counted, but no instructions progress. Overlapping stalls (ie. of the
+   * instruction and data memories) are served in parallel.
+   */
+  virtual void stallForMemory(unsigned cycles) { Q_UNUSED(cycles); }
+  /**
+   * @brief isMemoryStalled
+   * @returns true if the current cycle is a memory stall cycle. The memory
+   * accesses of a stall cycle are those of the cycle which initiated the stall,
+   * and shall not be performed again.
+   */
+  virtual bool isMemoryStalled() const { return false; }
+  /// @returns the number of memory stall cycles included in getCycleCount().
+  virtual long long getMemoryStallCycles() const { return 0; }
+  /**
+   * @brief isUnitStalled
+   * @returns true if the current cycle is a stall cycle of a multi-cycle
+   * functional unit (see MExtTiming). The processor state is frozen as during
+   * a memory stall.
+   */
+  virtual bool isUnitStalled() const { return false; }
+  /// @returns true if the processor state is frozen in the current cycle.
+  bool isStalled() const { return isMemoryStalled() || isUnitStalled(); }
+
+  /** ========================= Stall accounting ========================= */
+
+  enum class StallCause {
+    None,
+    DataHazard,     // Stalled on the result of an in-flight instruction
+    ControlHazard,  // Flushed due to a taken branch or jump
+    EcallDrain,     // Stalled on outstanding writes preceding an ecall
+    WayHazard,      // Instruction pair split across issue cycles
+    FunctionalUnit, // Stalled on a multi-cycle M-extension unit
+    Memory          // Stalled on an outstanding memory access
+  };
+
+  struct Stall {
+    StallCause cause = StallCause::None;
+    // The register which a data hazard is waiting on, or -1.
+    int reg = -1;
+    // The number of issue slots which are lost due to the stall.
+    unsigned lostSlots = 0;
+  };
+
+  /**
+   * @brief stallCause
+   * @returns the stall or flush which the hazard logic of the processor
+   * signals in the current cycle, ie. which takes effect upon the next clock.
+   * If multiple conditions coincide, the one which takes precedence in the
+   * processor is reported. Memory and functional unit stalls are reported for
+   * each stall cycle, with all issue slots of the cycle lost.
+   */
+  virtual Stall stallCause() const {
+    if (isMemoryStalled())
+      return {StallCause::Memory, -1,
+              static_cast<unsigned>(structure().size())};
+    if (isUnitStalled())
+      return {StallCause::FunctionalUnit, -1,
+              static_cast<unsigned>(structure().size())};
+    return {};
+  }
+
+  /** ========================= Branch outcomes ========================== */
+
+  struct BranchOutcome {
+    // Whether a branch or jump is resolved in the current cycle.
+    bool valid = false;
+    AInt pc = 0;
+    bool isJump = false;
+    bool taken = false;
+  };
+
+  /**
+   * @brief branchOutcome
+   * @returns the conditional branch or jump which is resolved in the current
+   * cycle, if any. An instruction held in place by a stall is reported once,
+   * in the cycle it leaves its stage. Processors which do not model control
+   * hazards report no outcomes.
+   */
+  virtual BranchOutcome branchOutcome() const { return {}; }
+
+  /** ===================== FEATURE: Branch prediction ===================== */
+  // Enabled by setting m_features.hasBranchPredictor = true
+
+  /**
+   * @brief branchPredictor
+   * @returns the branch predictor of the fetch stage. The predictor may be
+   * reconfigured between simulations, ie. before the processor is reset.
+   */
+  virtual BranchPredictor *branchPredictor() { return nullptr; }
+
+  /** =================== FEATURE: M-extension latency =================== */
+  // Enabled by setting m_features.hasMExtLatency = true
+
+  struct MExtTiming {
+    static constexpr unsigned s_maxLatency = 64;
+    // Cycles spent executing multiplications, and divisions (and remainders).
+    unsigned mulLatency = 1;
+    unsigned divLatency = 1;
+  };
+
+  /**
+   * @brief setMExtTiming
+   * Sets the latencies of the M-extension units, within [1;s_maxLatency].
+   * Multiplications are pipelined where the processor detects hazards on their
+   * results, whereas divisions are iterative, occupying the divider for their
+   * full latency. Takes effect once the processor is reset.
+   */
+  void setMExtTiming(const MExtTiming &timing) {
+    m_mextTiming.mulLatency =
+        std::clamp(timing.mulLatency, 1u, MExtTiming::s_maxLatency);
+    m_mextTiming.divLatency =
+        std::clamp(timing.divLatency, 1u, MExtTiming::s_maxLatency);
+  }
+  const MExtTiming &mextTiming() const { return m_mextTiming; }
+
+  /** ==================== FEATURE: Multiple harts ==================== */
+  // Enabled by setting m_features.hasMultipleHarts = true
+
+  /**
+   * @brief hartCount
+   * @returns the number of harts of the processor. Each hart is shown as a
+   * lane of the processor structure.
+   */
+  virtual unsigned hartCount() const { return 1; }
+
+  /**
+   * @brief hartDataMemAccess
+   * @returns the data memory access of hart @p hart in the current cycle. With
+   * a hart quantum larger than 1, this is the access of the last cycle of the
+   * quantum.
+   */
+  virtual MemoryAccess hartDataMemAccess(unsigned hart) const {
+    Q_UNUSED(hart);
+    return dataMemAccess();
+  }
+
+  /**
+   * @brief setHartQuantum
+   * Sets the number of cycles which the harts execute independently of each
+   * other, in between synchronizing. With a quantum of 1, the harts execute in
+   * lockstep, interleaving one instruction each per cycle. With larger quanta,
+   * each clock of the processor executes a quantum, and harts may execute
+   * concurrently on host threads.
+   */
+  void setHartQuantum(unsigned cycles) { m_hartQuantum = std::max(cycles, 1u); }
+  unsigned hartQuantum() const { return m_hartQuantum; }
+
+  /** ======================== FEATURE: Atomics ======================== */
+  // Enabled by setting m_features.hasAtomics = true
+
+  /**
+   * @brief reservations
+   * @returns the LR/SC reservation sets of the harts of the processor, which
+   * also count the A-extension instructions executed by each hart.
+   */
+  virtual const ReservationTable *reservations() const { return nullptr; }
+
+  /** ====================== FEATURE: Trace replay ====================== */
+  // Enabled by setting m_features.hasTraceReplay = true
+
+  /**
+   * @brief setInstructionTrace
+   * Replays the committed instructions of @p trace in place of executing the
+   * program, such that the timing of an execution recorded elsewhere may be
+   * evaluated. Instructions are fetched from the PCs of the trace, and perform
+   * the data accesses of the trace; no architectural state is computed. The
+   * processor finishes at the end of the trace. A null trace returns to
+   * executing the program. Takes effect once the processor is reset.
+   */
+  virtual void setInstructionTrace(std::shared_ptr<InstructionTrace> trace) {
+    Q_UNUSED(trace);
+  }
+
+  /** ===================== FEATURE: Vector extension ===================== */
+
+  static constexpr unsigned s_minVLEN = 64;
+  static constexpr unsigned s_maxVLEN = 4096;
+
+  /**
+   * @brief setVLEN
+   * Sets the width in bits of the vector registers of processors implementing
+   * the V extension. VLEN is a power of two within [s_minVLEN; s_maxVLEN];
+   * other widths are rounded down to one. Takes effect once the processor is
+   * reset.
+   */
+  void setVLEN(unsigned bits) {
+    m_vlen = s_minVLEN;
+    while (m_vlen < s_maxVLEN && m_vlen * 2 <= bits)
+      m_vlen *= 2;
+  }
+  unsigned vlen() const { return m_vlen; }
+
   /** ======================================================================*/
 
 protected:
@@ -353,10 +852,23 @@ protected:
    * Implementation of processor clocking.
    */
   virtual void clockProcessor() = 0;
+  /**
+   * @brief stallProcessor
+   * Called in place of clockProcessor. Performs a memory stall cycle if any are
+   * pending, in which case true is returned.
+   */
+  virtual bool stallProcessor() { return false; }
 
   // m_features should be adjusted accordingly during processor construction
   unsigned m_features;
+  MExtTiming m_mextTiming;
+  unsigned m_hartQuantum = 1;
+  unsigned m_vlen = 128;
   bool m_emitsSignals = true;
+
+private:
+  // Register values read by the default implementation of registers().
+  mutable std::map<RegisterFileType, std::vector<VInt>> m_registerBuffers;
 };
 
 } // namespace Ripes
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "ripes_types.h"
+
+namespace Ripes {
+
+/**
+ * @brief The MMIODevice class
+ * Interface of a memory mapped IO device. Accesses to the IO region of a device
+ * are dispatched directly to it by memories which support such (see
+ * PagedAddressSpaceMM::addIODevice), with the offset of the access relative to
+ * the start of the region.
+ */
+class MMIODevice {
+public:
+  virtual ~MMIODevice() = default;
+  virtual VInt ioRead(AInt offset, unsigned bytes) = 0;
+  virtual void ioWrite(AInt offset, VInt value, unsigned bytes) = 0;
+};
+
+} // namespace Ripes
@@ -0,0 +1,731 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "VSRTL/core/vsrtl_addressspace.h"
+
+#include "mmiodevice.h"
+#include "ripes_types.h"
+
+namespace Ripes {
+
+/**
+ * @brief The PagedAddressSpaceMM class
+ * An AddressSpaceMM which organizes RAM as a two-level table of 4 KiB host
+ * pages. A page is materialized from the underlying address space on its first
+ * access, after which loads and stores within the page are served directly
+ * from host memory. Accesses crossing a page boundary are split into bytes,
+ * each served by its own page. Pages which overlap a memory mapped IO region
+ * are never materialized. Instead, IO pages hold the IO devices registered
+ * through addIODevice which overlap them, such that an access to a device
+ * resolves through the page table to a single virtual call of the device.
+ * Accesses to IO pages outside any registered device fall back to the region
+ * dispatch of AddressSpaceMM.
+ *
+ * Pages of RAM which are only read, and hold only zeros (ie. .bss sections and
+ * zero-initialized arrays), are not materialized. Instead, reads are served by
+ * a shared zero page, and host memory is only allocated upon the first write
+ * to the page.
+ *
+ * Materialized pages are the authoritative copy of their memory. Before the IO
+ * memory map is changed, synchronize() must be called to write the pages back
+ * to the underlying address space.
+ *
+ * Pages may be watched (see setWatchedPages), such that accesses to them are
+ * recorded. Accesses to unwatched pages are not affected.
+ *
+ * While concurrent (see setConcurrent), the address space may be accessed from
+ * multiple threads, ie. by the harts of a multi-hart processor. Accesses to
+ * materialized RAM pages remain lock-free; the page table and IO accesses are
+ * serialized.
+ */
+class PagedAddressSpaceMM final : public vsrtl::core::AddressSpaceMM {
+public:
+  static constexpr unsigned s_pageBits = 12;
+  static constexpr AInt s_pageSize = AInt(1) << s_pageBits;
+  static constexpr unsigned s_directoryBits = 10;
+  static constexpr AInt s_directorySize = AInt(1) << s_directoryBits;
+
+  VInt readMem(AInt address, unsigned width = sizeof(VInt)) override {
+    if (!fitsInPage(address, width)) {
+      // Accesses crossing a page boundary are split into bytes, such that each
+      // byte is served by its own page.
+      VInt value = 0;
+      for (unsigned i = 0; i < width; ++i)
+        value |= readMem(address + i, 1) << (i * CHAR_BIT);
+      return value;
+    }
+    const Page *p = readPage(address >> s_pageBits);
+    if (!p->io) {
+      if (p->watched)
+        m_watchedAccess.store(true, std::memory_order_relaxed);
+      return load(&p->data[address & (s_pageSize - 1)], width);
+    }
+    const auto lock = concurrentLock();
+    if (const IODevice *device = p->device(address, width))
+      return device->device->ioRead(address - device->start, width);
+    noteUnpagedAccess();
+    return AddressSpaceMM::readMem(address, width);
+  }
+
+  VInt readMemConst(AInt address,
+                    unsigned width = sizeof(VInt)) const override {
+    if (!fitsInPage(address, width)) {
+      VInt value = 0;
+      for (unsigned i = 0; i < width; ++i)
+        value |= readMemConst(address + i, 1) << (i * CHAR_BIT);
+      return value;
+    }
+    // Const accesses must not materialize pages.
+    const auto lock = concurrentLock();
+    const Page *p = findPage(address >> s_pageBits);
+    if (p && !p->io)
+      return load(&p->data[address & (s_pageSize - 1)], width);
+    return AddressSpaceMM::readMemConst(address, width);
+  }
+
+  void writeMem(AInt address, VInt value, int size = sizeof(VInt)) override {
+    if (!fitsInPage(address, size)) {
+      for (int i = 0; i < size; ++i)
+        writeMem(address + i, (value >> (i * CHAR_BIT)) & 0xFF, 1);
+      return;
+    }
+    Page *p = page(address >> s_pageBits);
+    if (!p->io) {
+      uint8_t *ptr = &p->data[address & (s_pageSize - 1)];
+      for (int i = 0; i < size; ++i)
+        ptr[i] = static_cast<uint8_t>(value >> (i * CHAR_BIT));
+      p->dirty = true;
+      if (p->watched)
+        m_watchedAccess.store(true, std::memory_order_relaxed);
+      return;
+    }
+    const auto lock = concurrentLock();
+    if (const IODevice *device = p->device(address, size)) {
+      device->device->ioWrite(address - device->start, value, size);
+      return;
+    }
+    noteUnpagedAccess();
+    AddressSpaceMM::writeMem(address, value, size);
+  }
+
+  void reset() override {
+    clearPages();
+    AddressSpaceMM::reset();
+  }
+
+  /**
+   * @brief setConcurrent
+   * Sets whether the address space may be accessed from multiple threads. The
+   * page table must not be cleared (ie. through reset() or synchronize())
+   * while concurrent.
+   */
+  void setConcurrent(bool concurrent) { m_concurrent = concurrent; }
+
+  /**
+   * @brief hostPointer
+   * Returns a pointer to the host memory backing the @p width bytes at
+   * @p address. Returns nullptr if the access is to an IO or watched page, or
+   * crosses a page boundary.
+   */
+  uint8_t *hostPointer(AInt address, unsigned width) {
+    if (!fitsInPage(address, width))
+      return nullptr;
+    Page *p = page(address >> s_pageBits);
+    if (p->io || p->watched)
+      return nullptr;
+    return &p->data[address & (s_pageSize - 1)];
+  }
+
+  /**
+   * @brief atomicUpdate
+   * Replaces the @p width (4 or 8) bytes at @p address by @p update applied to
+   * them, atomically with respect to other atomic updates, and returns their
+   * previous value. Aligned words of RAM are updated through host atomic
+   * operations; other accesses are serialized, and are only written if
+   * @p update changes their value.
+   */
+  template <typename Update>
+  VInt atomicUpdate(AInt address, unsigned width, Update &&update) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (address % width == 0) {
+      if (uint8_t *ptr = hostPointer(address, width)) {
+        page(address >> s_pageBits)->dirty = true;
+        if (width == 4)
+          return atomicUpdate(reinterpret_cast<uint32_t *>(ptr), update);
+        return atomicUpdate(reinterpret_cast<uint64_t *>(ptr), update);
+      }
+    }
+#endif
+    std::lock_guard<std::recursive_mutex> lock(m_lock);
+    const VInt old = readMem(address, width);
+    const VInt value = update(old);
+    if (value != old)
+      writeMem(address, value, width);
+    return old;
+  }
+
+  /**
+   * @brief copyMem
+   * Copies the @p bytes bytes at @p src to @p dst, which must not overlap. Runs
+   * of RAM are copied page by page within host memory; bytes within an IO
+   * page are transferred through readMem/writeMem, in words where aligned.
+   */
+  void copyMem(AInt dst, AInt src, AInt bytes) {
+    while (bytes > 0) {
+      const AInt chunk =
+          std::min({bytes, s_pageSize - (src & (s_pageSize - 1)),
+                    s_pageSize - (dst & (s_pageSize - 1))});
+      const Page *srcPage = readPage(src >> s_pageBits);
+      Page *dstPage = page(dst >> s_pageBits);
+      if (!srcPage->io && !dstPage->io) {
+        std::memcpy(&dstPage->data[dst & (s_pageSize - 1)],
+                    &srcPage->data[src & (s_pageSize - 1)], chunk);
+        dstPage->dirty = true;
+      } else {
+        for (AInt offset = 0; offset < chunk;) {
+          const unsigned width =
+              ((src + offset) % 4 == 0 && (dst + offset) % 4 == 0 &&
+               chunk - offset >= 4)
+                  ? 4
+                  : 1;
+          writeMem(dst + offset, readMem(src + offset, width), width);
+          offset += width;
+        }
+      }
+      src += chunk;
+      dst += chunk;
+      bytes -= chunk;
+    }
+  }
+
+  /**
+   * @brief readBlock/writeBlock
+   * Transfers the @p bytes bytes at @p address to or from the host buffer
+   * @p data. Runs of RAM are copied page by page within host memory; bytes
+   * within an IO page are transferred through readMem/writeMem.
+   */
+  void readBlock(AInt address, uint8_t *data, AInt bytes) {
+    while (bytes > 0) {
+      const AInt offset = address & (s_pageSize - 1);
+      const AInt chunk = std::min(bytes, s_pageSize - offset);
+      const Page *p = readPage(address >> s_pageBits);
+      if (!p->io) {
+        std::memcpy(data, &p->data[offset], chunk);
+      } else {
+        for (AInt i = 0; i < chunk; ++i)
+          data[i] = static_cast<uint8_t>(readMem(address + i, 1));
+      }
+      address += chunk;
+      data += chunk;
+      bytes -= chunk;
+    }
+  }
+
+  void writeBlock(AInt address, const uint8_t *data, AInt bytes) {
+    while (bytes > 0) {
+      const AInt offset = address & (s_pageSize - 1);
+      const AInt chunk = std::min(bytes, s_pageSize - offset);
+      Page *p = page(address >> s_pageBits);
+      if (!p->io) {
+        std::memcpy(&p->data[offset], data, chunk);
+        p->dirty = true;
+      } else {
+        for (AInt i = 0; i < chunk; ++i)
+          writeMem(address + i, data[i], 1);
+      }
+      address += chunk;
+      data += chunk;
+      bytes -= chunk;
+    }
+  }
+
+  /**
+   * @brief stringLength
+   * Returns the length of the null-terminated string at @p address, excluding
+   * the terminator. Pages of RAM are searched within host memory.
+   */
+  AInt stringLength(AInt address) {
+    AInt length = 0;
+    while (true) {
+      const AInt offset = address & (s_pageSize - 1);
+      const AInt chunk = s_pageSize - offset;
+      const Page *p = readPage(address >> s_pageBits);
+      if (!p->io) {
+        const uint8_t *start = &p->data[offset];
+        if (const void *end = std::memchr(start, 0, chunk))
+          return length + (static_cast<const uint8_t *>(end) - start);
+      } else {
+        for (AInt i = 0; i < chunk; ++i)
+          if (readMem(address + i, 1) == 0)
+            return length + i;
+      }
+      length += chunk;
+      address += chunk;
+    }
+  }
+
+  /**
+   * @brief find
+   * Returns the lowest address within [@p start, @p end) at which the @p size
+   * bytes of @p pattern occur, if any, such that the match lies within the
+   * range. If @p mask is given, only the bits set in the corresponding byte of
+   * @p mask are compared. Matches are only reported at multiples of
+   * @p alignment. Pages of RAM are searched within host memory, locating
+   * candidates through memchr (which libc vectorizes) on the first fully
+   * compared byte of the pattern. IO pages are skipped, given that reading a
+   * device may have side effects.
+   */
+  std::optional<AInt> find(AInt start, AInt end, const uint8_t *pattern,
+                           const uint8_t *mask, AInt size,
+                           AInt alignment = 1) {
+    if (size == 0 || end < start || end - start < size)
+      return {};
+    // Offset within the pattern of the byte located by memchr. If every byte
+    // is masked, each candidate is compared.
+    AInt anchor = 0;
+    while (mask && anchor < size && mask[anchor] != 0xFF)
+      ++anchor;
+    const bool scan = anchor < size;
+    if (!scan)
+      anchor = 0;
+
+    const AInt last = end - size;
+    AInt address = start;
+    while (address <= last) {
+      const AInt anchorAddress = address + anchor;
+      const AInt offset = anchorAddress & (s_pageSize - 1);
+      const AInt chunk = std::min(s_pageSize - offset, last - address + 1);
+      const Page *p = readPage(anchorAddress >> s_pageBits);
+      if (!p->io) {
+        const uint8_t *data = &p->data[0];
+        const uint8_t *it = data + offset;
+        const uint8_t *stop = it + chunk;
+        while (it < stop) {
+          if (scan) {
+            it = static_cast<const uint8_t *>(
+                std::memchr(it, pattern[anchor], stop - it));
+            if (!it)
+              break;
+          }
+          const AInt candidate =
+              (anchorAddress - offset) + (it - data) - anchor;
+          if (candidate % alignment == 0 &&
+              matches(candidate, pattern, mask, size))
+            return candidate;
+          ++it;
+        }
+      }
+      address += chunk;
+    }
+    return {};
+  }
+
+  /**
+   * @brief fill
+   * Writes repetitions of the @p size bytes of @p pattern to the @p bytes
+   * bytes at @p address. Runs of RAM are filled page by page within host
+   * memory; bytes within an IO page are written through writeMem.
+   */
+  void fill(AInt address, AInt bytes, const uint8_t *pattern, AInt size) {
+    if (size == 0)
+      return;
+    // A page worth of repetitions, such that a page is filled by a single copy
+    // starting at the offset of the next byte within the pattern.
+    std::vector<uint8_t> run(s_pageSize + size);
+    for (AInt i = 0; i < run.size(); ++i)
+      run[i] = pattern[i % size];
+    AInt phase = 0;
+    while (bytes > 0) {
+      const AInt offset = address & (s_pageSize - 1);
+      const AInt chunk = std::min(bytes, s_pageSize - offset);
+      Page *p = page(address >> s_pageBits);
+      if (!p->io) {
+        std::memcpy(&p->data[offset], &run[phase], chunk);
+        p->dirty = true;
+      } else {
+        for (AInt i = 0; i < chunk; ++i)
+          writeMem(address + i, run[phase + i], 1);
+      }
+      phase = (phase + chunk) % size;
+      address += chunk;
+      bytes -= chunk;
+    }
+  }
+
+  /// Returns the page numbers of the materialized pages of RAM, in ascending
+  /// order. These hold all memory written, and all nonzero memory read, since
+  /// the address space was last reset or synchronized.
+  std::vector<AInt> materializedPages() const {
+    const auto lock = concurrentLock();
+    std::vector<AInt> pages;
+    for (const auto &dir : m_directories) {
+      for (AInt i = 0; i < s_directorySize; ++i) {
+        const Page *p = dir.second->at(i).get();
+        if (p && !p->io)
+          pages.push_back((dir.first << s_directoryBits) | i);
+      }
+    }
+    std::sort(pages.begin(), pages.end());
+    return pages;
+  }
+
+  /// Returns the page numbers of the pages of RAM read, but not materialized,
+  /// since the address space was last reset or synchronized, in ascending
+  /// order. These hold only zeros.
+  std::vector<AInt> zeroPages() const {
+    const auto lock = concurrentLock();
+    std::vector<AInt> pages(m_zeroPages.begin(), m_zeroPages.end());
+    std::sort(pages.begin(), pages.end());
+    return pages;
+  }
+
+  /**
+   * @brief addIODevice
+   * Dispatches accesses to the @p size bytes at @p start directly to
+   * @p device. The region must also be added as an IO region of the address
+   * space (see AddressSpaceMM::addIORegion), which serves any accesses not
+   * dispatched through the page table.
+   */
+  void addIODevice(AInt start, AInt size, MMIODevice *device) {
+    synchronize();
+    m_ioDevices[start] = IODevice{start, size, device};
+  }
+
+  void removeIODevice(AInt start) {
+    synchronize();
+    m_ioDevices.erase(start);
+  }
+
+  /**
+   * @brief setWatchedPages
+   * Watches the pages with @p pageNumbers, in place of any previously watched
+   * pages. An access to a watched page of RAM through readMem, writeMem or
+   * atomicUpdate is recorded (see takeWatchedAccess), as is any access not
+   * served by the page table while pages are watched. Block transfers are not
+   * recorded.
+   */
+  void setWatchedPages(std::set<AInt> pageNumbers) {
+    const auto lock = concurrentLock();
+    m_watchedPages = std::move(pageNumbers);
+    for (const auto &dir : m_directories) {
+      for (AInt i = 0; i < s_directorySize; ++i) {
+        if (Page *p = dir.second->at(i).get())
+          p->watched = m_watchedPages.count((dir.first << s_directoryBits) | i);
+      }
+    }
+    // Watched pages are materialized upon being read.
+    for (const AInt pageNumber : m_watchedPages)
+      m_zeroPages.erase(pageNumber);
+    m_lastZeroPage = false;
+    m_watchedAccess = false;
+  }
+
+  /// Returns true if a watched page was accessed since the previous call.
+  bool takeWatchedAccess() {
+    return m_watchedAccess.exchange(false, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief synchronize
+   * Writes all modified pages back to the underlying address space, and clears
+   * the page table.
+   */
+  void synchronize() {
+    for (const auto &dir : m_directories) {
+      for (AInt i = 0; i < s_directorySize; ++i) {
+        const Page *p = dir.second->at(i).get();
+        if (!p || p->io || !p->dirty)
+          continue;
+        const AInt base = ((dir.first << s_directoryBits) | i) << s_pageBits;
+        for (AInt offset = 0; offset < s_pageSize; ++offset) {
+          const uint8_t byte = p->data[offset];
+          if (AddressSpaceMM::readMemConst(base + offset, 1) != byte)
+            AddressSpaceMM::writeMem(base + offset, byte, 1);
+        }
+      }
+    }
+    clearPages();
+  }
+
+private:
+  struct IODevice {
+    AInt start;
+    AInt size;
+    MMIODevice *device;
+  };
+
+  struct Page {
+    // Set if the page overlaps an IO region; such pages hold no data.
+    bool io = false;
+    bool dirty = false;
+    // Set if accesses to the page are recorded; see setWatchedPages.
+    bool watched = false;
+    // The IO devices overlapping an IO page; a page may hold a handful of
+    // peripherals, given that these are laid out contiguously.
+    std::vector<IODevice> devices;
+    // Aligned, such that aligned words may be accessed atomically.
+    alignas(8) std::array<uint8_t, s_pageSize> data;
+
+    /// Returns the device holding the @p width bytes at @p address, if any.
+    const IODevice *device(AInt address, unsigned width) const {
+      for (const auto &d : devices) {
+        if (address >= d.start && address + width <= d.start + d.size)
+          return &d;
+      }
+      return nullptr;
+    }
+  };
+  using Directory = std::array<std::unique_ptr<Page>, s_directorySize>;
+
+  static bool fitsInPage(AInt address, unsigned width) {
+    return (address & (s_pageSize - 1)) + width <= s_pageSize;
+  }
+
+  static VInt load(const uint8_t *ptr, unsigned width) {
+    VInt value = 0;
+    for (unsigned i = 0; i < width; ++i)
+      value |= static_cast<VInt>(ptr[i]) << (i * CHAR_BIT);
+    return value;
+  }
+
+  template <typename T, typename Update>
+  static VInt atomicUpdate(T *ptr, Update &update) {
+    T old = __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+    T value;
+    do {
+      value = static_cast<T>(update(static_cast<VInt>(old)));
+    } while (!__atomic_compare_exchange_n(ptr, &old, value, false,
+                                          __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST));
+    return old;
+  }
+
+  /// Returns true if the @p size bytes at @p address match @p pattern under
+  /// @p mask (see find). Bytes within IO pages never match.
+  bool matches(AInt address, const uint8_t *pattern, const uint8_t *mask,
+               AInt size) {
+    for (AInt i = 0; i < size;) {
+      const AInt offset = (address + i) & (s_pageSize - 1);
+      const AInt chunk = std::min(size - i, s_pageSize - offset);
+      const Page *p = readPage((address + i) >> s_pageBits);
+      if (p->io)
+        return false;
+      const uint8_t *data = &p->data[offset];
+      if (!mask) {
+        if (std::memcmp(data, pattern + i, chunk) != 0)
+          return false;
+      } else {
+        for (AInt j = 0; j < chunk; ++j) {
+          if ((data[j] ^ pattern[i + j]) & mask[i + j])
+            return false;
+        }
+      }
+      i += chunk;
+    }
+    return true;
+  }
+
+  /// Accesses which bypass the page table are conservatively recorded as
+  /// accesses to a watched page, if any.
+  void noteUnpagedAccess() {
+    if (!m_watchedPages.empty())
+      m_watchedAccess.store(true, std::memory_order_relaxed);
+  }
+
+  const Page *findPage(AInt pageNumber) const {
+    auto dir = m_directories.find(pageNumber >> s_directoryBits);
+    if (dir == m_directories.end())
+      return nullptr;
+    return dir->second->at(pageNumber & (s_directorySize - 1)).get();
+  }
+
+  /// Returns a lock serializing accesses to the page table and IO, which is
+  /// only held while concurrent.
+  std::unique_lock<std::recursive_mutex> concurrentLock() const {
+    if (!m_concurrent)
+      return {};
+    return std::unique_lock<std::recursive_mutex>(m_lock);
+  }
+
+  /// Returns the page with @p pageNumber, materializing it if needed.
+  Page *page(AInt pageNumber) {
+    if (m_concurrent) {
+      // Each thread caches its most recently accessed page. Pages are not
+      // freed while concurrent, and the cache is invalidated when the page
+      // table is cleared.
+      struct Cache {
+        uint64_t generation = 0;
+        AInt pageNumber = 0;
+        Page *page = nullptr;
+      };
+      thread_local Cache cache;
+      if (cache.generation == m_generation && cache.pageNumber == pageNumber)
+        return cache.page;
+      const auto lock = concurrentLock();
+      Page *p = materialize(pageNumber);
+      cache = {m_generation, pageNumber, p};
+      return p;
+    }
+
+    if (m_lastPage && pageNumber == m_lastPageNumber)
+      return m_lastPage;
+    m_lastPageNumber = pageNumber;
+    m_lastPage = materialize(pageNumber);
+    return m_lastPage;
+  }
+
+  /// Returns the page with @p pageNumber for reading. Pages of RAM holding only
+  /// zeros are served by the zero page, rather than materialized, unless
+  /// watched or while concurrent.
+  const Page *readPage(AInt pageNumber) {
+    if (m_concurrent)
+      return page(pageNumber);
+    if (m_lastPage && pageNumber == m_lastPageNumber)
+      return m_lastPage;
+    if (m_lastZeroPage && pageNumber == m_lastZeroPageNumber)
+      return &s_zeroPage;
+    if (findPage(pageNumber))
+      return page(pageNumber);
+
+    if (!m_zeroPages.count(pageNumber)) {
+      if (m_watchedPages.count(pageNumber) || !isZeroRAM(pageNumber))
+        return page(pageNumber);
+      m_zeroPages.insert(pageNumber);
+    }
+    m_lastZeroPage = true;
+    m_lastZeroPageNumber = pageNumber;
+    return &s_zeroPage;
+  }
+
+  /// Returns true if the page with @p pageNumber is RAM, and its underlying
+  /// memory holds only zeros.
+  bool isZeroRAM(AInt pageNumber) {
+    const AInt base = pageNumber << s_pageBits;
+    for (AInt offset = 0; offset < s_pageSize; ++offset) {
+      if (regionType(base + offset) == RegionType::IO ||
+          AddressSpaceMM::readMemConst(base + offset, 1) != 0)
+        return false;
+    }
+    return true;
+  }
+
+  Page *materialize(AInt pageNumber) {
+    auto &dir = m_directories[pageNumber >> s_directoryBits];
+    if (!dir)
+      dir = std::make_unique<Directory>();
+    auto &p = dir->at(pageNumber & (s_directorySize - 1));
+    if (!p) {
+      p = std::make_unique<Page>();
+      p->watched = m_watchedPages.count(pageNumber);
+      if (m_zeroPages.erase(pageNumber)) {
+        // Known to be zero RAM; the page is zero-initialized upon
+        // construction.
+        if (m_lastZeroPage && m_lastZeroPageNumber == pageNumber)
+          m_lastZeroPage = false;
+        return p.get();
+      }
+      const AInt base = pageNumber << s_pageBits;
+      for (AInt offset = 0; offset < s_pageSize && !p->io; ++offset)
+        p->io = regionType(base + offset) == RegionType::IO;
+      if (!p->io) {
+        for (AInt offset = 0; offset < s_pageSize; ++offset)
+          p->data[offset] = AddressSpaceMM::readMemConst(base + offset, 1);
+      } else {
+        for (const auto &device : m_ioDevices) {
+          const IODevice &d = device.second;
+          if (d.start < base + s_pageSize && d.start + d.size > base)
+            p->devices.push_back(d);
+        }
+      }
+    }
+    return p.get();
+  }
+
+  void clearPages() {
+    m_directories.clear();
+    m_zeroPages.clear();
+    m_lastPage = nullptr;
+    m_lastZeroPage = false;
+    m_generation = s_generations++;
+  }
+
+  // First level of the page table, indexed by the upper bits of the page
+  // number. Kept sparse, given that the 64-bit address space is mostly empty.
+  std::unordered_map<AInt, std::unique_ptr<Directory>> m_directories;
+
+  // IO devices dispatched to through the page table, by start address.
+  std::map<AInt, IODevice> m_ioDevices;
+
+  // Watched pages, applied to pages as they are materialized, and whether any
+  // was accessed since last queried.
+  std::set<AInt> m_watchedPages;
+  std::atomic<bool> m_watchedAccess{false};
+
+  // Most recently accessed page.
+  AInt m_lastPageNumber = 0;
+  Page *m_lastPage = nullptr;
+
+  // Pages of RAM known to hold only zeros, which are read through the zero
+  // page, and the most recently read such page.
+  std::unordered_set<AInt> m_zeroPages;
+  bool m_lastZeroPage = false;
+  AInt m_lastZeroPageNumber = 0;
+  static inline const Page s_zeroPage{};
+
+  bool m_concurrent = false;
+  mutable std::recursive_mutex m_lock;
+  // Identifies the contents of the page table across all address spaces, for
+  // invalidating the page caches of threads.
+  static inline std::atomic<uint64_t> s_generations{1};
+  uint64_t m_generation = s_generations++;
+};
+
+/**
+ * @brief addInitializationMemory
+ * Adds the @p size bytes at @p data as initialization memory of @p memory at
+ * @p address, omitting the pages (of PagedAddressSpaceMM::s_pageSize bytes)
+ * which only hold zeros, given that uninitialized memory reads as zero. Large
+ * zero-initialized regions, ie. .bss sections, thus cost neither memory nor
+ * time to load.
+ */
+inline void addInitializationMemory(vsrtl::core::AddressSpaceMM &memory,
+                                    AInt address, const char *data,
+                                    AInt size) {
+  constexpr AInt pageSize = PagedAddressSpaceMM::s_pageSize;
+  // Start of the pending run of pages holding a nonzero byte.
+  AInt runStart = 0;
+  bool inRun = false;
+  AInt offset = 0;
+  while (offset < size) {
+    const AInt chunk =
+        std::min(size - offset, pageSize - ((address + offset) % pageSize));
+    const bool zero =
+        std::all_of(data + offset, data + offset + chunk,
+                    [](char byte) { return byte == 0; });
+    if (!zero && !inRun) {
+      runStart = offset;
+      inRun = true;
+    } else if (zero && inRun) {
+      memory.addInitializationMemory(address + runStart, data + runStart,
+                                     offset - runStart);
+      inRun = false;
+    }
+    offset += chunk;
+  }
+  if (inRun)
+    memory.addInitializationMemory(address + runStart, data + runStart,
+                                   size - runStart);
+}
+
+} // namespace Ripes
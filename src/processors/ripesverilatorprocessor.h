@@ -0,0 +1,216 @@
+#pragma once
+
+#include <memory>
+
+#include "interface/ripesprocessor.h"
+#include "pagedaddressspace.h"
+
+namespace Ripes {
+
+/**
+ * @brief The VerilatorCore class
+ * The top-level ports of a Verilated processor core, as driven by
+ * RipesVerilatorProcessor. The ports of a core are sampled and driven as a
+ * whole, such that the adapter does not depend on the Verilator runtime (see
+ * VerilatedCore for the Verilog port names).
+ *
+ * While halt is asserted, a clock edge must leave the architectural state of
+ * the core unchanged, apart from the writes of the debug port.
+ */
+class VerilatorCore {
+public:
+  struct Inputs {
+    bool rst = false;
+    bool halt = false;
+    VInt imemRData = 0;
+    VInt dmemRData = 0;
+    // Debug port
+    unsigned dbgRegAddr = 0;
+    bool dbgRegWe = false;
+    VInt dbgRegWData = 0;
+    bool dbgPcWe = false;
+    AInt dbgPcWData = 0;
+  };
+
+  struct Outputs {
+    AInt imemAddr = 0;
+    AInt dmemAddr = 0;
+    bool dmemRe = false;
+    bool dmemWe = false;
+    // log2 of the number of bytes of the data access.
+    unsigned dmemSize = 0;
+    VInt dmemWData = 0;
+    // The PC of the instruction being executed.
+    AInt pc = 0;
+    // The instruction at pc retires on the next rising edge.
+    bool retire = false;
+    // The instruction at pc is an ecall.
+    bool ecall = false;
+    VInt dbgRegRData = 0;
+  };
+
+  virtual ~VerilatorCore() = default;
+  /// Drives @p in, evaluates the combinational logic and samples @p out.
+  virtual void eval(const Inputs &in, Outputs &out) = 0;
+  /// Drives @p in, evaluates a rising and a falling clock edge and samples
+  /// @p out.
+  virtual void tick(const Inputs &in, Outputs &out) = 0;
+};
+
+/**
+ * @brief The RipesVerilatorProcessor class
+ * Adapts a Verilated processor core (see VerilatorCore) to the RipesProcessor
+ * interface. The core is shown as a single stage, executing the instruction at
+ * its pc output.
+ *
+ * Each clock cycle settles the core against the simulator memory: the
+ * instruction at the fetch address is driven onto imem_rdata, after which the
+ * data read, if any, is driven onto dmem_rdata. An ecall is handed to the
+ * trap handler before the clock edge which retires it, with registers accessed
+ * through the debug port of the core. Stores are performed on the memory of
+ * the processor before the clock edge.
+ *
+ * Cores are reset to a PC of 0, with cleared registers; the initial PC is then
+ * set through the debug port. Reversal is not supported.
+ */
+class RipesVerilatorProcessor : public RipesProcessor {
+public:
+  RipesVerilatorProcessor(std::unique_ptr<VerilatorCore> core,
+                          std::shared_ptr<ISAInfoBase> isa)
+      : m_core(std::move(core)), m_isa(std::move(isa)) {
+    m_features = Features::hasDCacheInterface | Features::hasICacheInterface;
+    m_memory = std::make_shared<PagedAddressSpaceMM>();
+  }
+
+  // Ripes interface compliance
+  const ProcessorStructure &structure() const override { return m_structure; }
+  unsigned int getPcForStage(StageIndex) const override { return m_out.pc; }
+  AInt nextFetchedAddress() const override { return m_out.imemAddr; }
+  QString stageName(StageIndex) const override { return "•"; }
+  StageInfo stageInfo(StageIndex) const override {
+    return StageInfo({m_out.pc, isExecutableAddress(m_out.pc),
+                      StageInfo::State::None});
+  }
+  void setProgramCounter(AInt address) override {
+    VerilatorCore::Inputs in = m_in;
+    in.halt = true;
+    in.dbgPcWe = true;
+    in.dbgPcWData = address;
+    m_core->tick(in, m_out);
+    m_core->eval(m_in, m_out);
+  }
+  void setPCInitialValue(AInt address) override { m_pcInitialValue = address; }
+  AddressSpaceMM &getMemory() override { return *m_memory; }
+  VInt getRegister(RegisterFileType, unsigned i) const override {
+    VerilatorCore::Inputs in = m_in;
+    in.dbgRegAddr = i;
+    VerilatorCore::Outputs out;
+    m_core->eval(in, out);
+    return out.dbgRegRData;
+  }
+  void setRegister(RegisterFileType, unsigned i, VInt v) override {
+    VerilatorCore::Inputs in = m_in;
+    in.halt = true;
+    in.dbgRegAddr = i;
+    in.dbgRegWe = true;
+    in.dbgRegWData = v;
+    m_core->tick(in, m_out);
+    m_core->eval(m_in, m_out);
+  }
+  void finalize(FinalizeReason fr) override {
+    // The core is shown as a single stage; an exit system call finishes
+    // execution immediately.
+    if (fr == FinalizeReason::exitSyscall)
+      m_finished = true;
+  }
+  bool finished() const override {
+    return m_finished || !isExecutableAddress(m_out.imemAddr);
+  }
+  const std::vector<StageIndex> breakpointTriggeringStages() const override {
+    return {{0, 0}};
+  }
+  MemoryAccess dataMemAccess() const override { return m_dataAccess; }
+  MemoryAccess instrMemAccess() const override { return m_instrAccess; }
+  long long getInstructionsRetired() const override {
+    return m_instructionsRetired;
+  }
+  long long getCycleCount() const override { return m_cycleCount; }
+
+  void resetProcessor() override {
+    m_memory->reset();
+    m_in = VerilatorCore::Inputs();
+    m_in.rst = true;
+    m_core->tick(m_in, m_out);
+    m_in.rst = false;
+    m_core->eval(m_in, m_out);
+    setProgramCounter(m_pcInitialValue);
+    m_finished = false;
+    m_instructionsRetired = 0;
+    m_cycleCount = 0;
+    m_dataAccess = MemoryAccess();
+    m_instrAccess = MemoryAccess();
+    if (m_emitsSignals)
+      processorWasReset.Emit();
+  }
+
+  const ISAInfoBase *implementsISA() const override { return m_isa.get(); }
+  const std::set<RegisterFileType> registerFiles() const override {
+    return {RegisterFileType::GPR};
+  }
+
+protected:
+  void clockProcessor() override {
+    settle();
+    if (m_out.ecall && trapHandler) {
+      trapHandler();
+      // The trap handler may have written registers read by the core.
+      settle();
+    }
+    if (m_out.dmemWe) {
+      const unsigned bytes = 1u << m_out.dmemSize;
+      m_dataAccess = MemoryAccess{MemoryAccess::Write, m_out.dmemAddr, bytes};
+      m_memory->writeMem(m_out.dmemAddr, m_out.dmemWData, bytes);
+    }
+    if (m_out.retire)
+      m_instructionsRetired++;
+    m_core->tick(m_in, m_out);
+    m_cycleCount++;
+    if (m_emitsSignals)
+      processorWasClocked.Emit();
+  }
+
+private:
+  /// Drives the instruction and data reads of the core from memory, in the
+  /// order in which they depend on one another.
+  void settle() {
+    // Instructions are fetched as 32-bit words; the fetch address of a core
+    // with compressed instructions need not be word-aligned.
+    m_core->eval(m_in, m_out);
+    m_instrAccess = MemoryAccess{MemoryAccess::Read, m_out.imemAddr, 4};
+    m_in.imemRData = m_memory->readMem(m_out.imemAddr, 4);
+    m_core->eval(m_in, m_out);
+    m_dataAccess = MemoryAccess();
+    if (m_out.dmemRe) {
+      const unsigned bytes = 1u << m_out.dmemSize;
+      m_dataAccess = MemoryAccess{MemoryAccess::Read, m_out.dmemAddr, bytes};
+      m_in.dmemRData = m_memory->readMem(m_out.dmemAddr, bytes);
+      m_core->eval(m_in, m_out);
+    }
+  }
+
+  std::unique_ptr<VerilatorCore> m_core;
+  std::shared_ptr<ISAInfoBase> m_isa;
+  std::shared_ptr<PagedAddressSpaceMM> m_memory;
+  VerilatorCore::Inputs m_in;
+  VerilatorCore::Outputs m_out;
+  ProcessorStructure m_structure = {{0, 1}};
+
+  AInt m_pcInitialValue = 0;
+  bool m_finished = false;
+  long long m_instructionsRetired = 0;
+  long long m_cycleCount = 0;
+  MemoryAccess m_dataAccess;
+  MemoryAccess m_instrAccess;
+};
+
+} // namespace Ripes
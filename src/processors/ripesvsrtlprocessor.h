@@ -4,6 +4,8 @@
  * Interface for all VSRTL-based Ripes processors
  */
 
+#include <deque>
+
 #include "RISC-V/riscv.h"
 #include "VSRTL/core/vsrtl_design.h"
 #include "interface/ripesprocessor.h"
@@ -15,7 +17,8 @@ public:
   RipesVSRTLProcessor(const std::string &name) : Design(name) {
     // VSRTL provides reversible simulation
     m_features = {Features::isReversible | Features::hasDCacheInterface |
-                  Features::hasICacheInterface};
+                  Features::hasICacheInterface | Features::hasMemoryStalls |
+                  Features::hasMExtLatency};
 
     // Shim signal emissions from VSRTL to RipesProcessor
     designWasClocked.Connect(&processorWasClocked, &Gallant::Signal0<>::Emit);
@@ -25,15 +28,58 @@ public:
 
   virtual void resetProcessor() override {
     m_instructionsRetired = 0;
+    m_pendingStallCycles = 0;
+    m_pendingUnitStallCycles = 0;
+    m_stallCycles = 0;
+    m_unitStallCycles = 0;
+    m_stallHistory.clear();
+    m_mextResults.clear();
     reset();
   }
 
-  virtual void reverseProcessor() override { reverse(); }
+  virtual void reverseProcessor() override {
+    if (isStalled()) {
+      // Undo a stall cycle; the design itself was not clocked.
+      const StallCycle &stall = m_stallHistory.back();
+      if (stall.memory)
+        m_pendingStallCycles++;
+      if (stall.unit)
+        m_pendingUnitStallCycles++;
+      if (stall.memory)
+        m_stallCycles--;
+      else
+        m_unitStallCycles--;
+      m_stallHistory.pop_back();
+      processorWasReversed.Emit();
+      return;
+    }
+    // Any stall pending in the undone cycle is requested anew once the cycle
+    // is re-executed.
+    m_pendingStallCycles = 0;
+    m_pendingUnitStallCycles = 0;
+    reverse();
+    while (!m_mextResults.empty() &&
+           m_mextResults.back().designCycle > m_cycleCount)
+      m_mextResults.pop_back();
+  }
+
+  void stallForMemory(unsigned cycles) override {
+    m_pendingStallCycles = std::max(m_pendingStallCycles, cycles);
+  }
+  bool isMemoryStalled() const override {
+    return isStallCycle() && m_stallHistory.back().memory;
+  }
+  bool isUnitStalled() const override {
+    return isStallCycle() && !m_stallHistory.back().memory;
+  }
+  long long getMemoryStallCycles() const override { return m_stallCycles; }
 
   long long getInstructionsRetired() const override {
     return m_instructionsRetired;
   }
-  long long getCycleCount() const override { return m_cycleCount; }
+  long long getCycleCount() const override {
+    return m_cycleCount + m_stallCycles + m_unitStallCycles;
+  }
   void setMaxReverseCycles(unsigned cycles) override {
     setReverseStackSize(cycles);
   }
@@ -46,6 +92,36 @@ public:
   }
 
 protected:
+  /**
+   * @brief checkImplemented
+   * Reports the instruction at @p pc, of opcode @p opcode, to
+   * unsupportedInstrHandler if it is a system instruction which the VSRTL
+   * models decode but execute as a NOP: CSR accesses other than reads of the
+   * counter CSRs, mret and wfi. @p csr and @p rs1 are the CSR number and source
+   * register index of CSR accesses. Machine-mode CSRs and traps are only
+   * implemented by the ISS models.
+   */
+  void checkImplemented(AInt pc, unsigned opcode, unsigned csr, unsigned rs1) {
+    switch (opcode) {
+    case RVInstr::CSRRS:
+      if (rs1 == 0 && isCounterCSR(csr))
+        return;
+      break;
+    case RVInstr::CSRRW:
+    case RVInstr::CSRRC:
+    case RVInstr::CSRRWI:
+    case RVInstr::CSRRSI:
+    case RVInstr::CSRRCI:
+    case RVInstr::MRET:
+    case RVInstr::WFI:
+      break;
+    default:
+      return;
+    }
+    if (unsupportedInstrHandler)
+      unsupportedInstrHandler(pc);
+  }
+
   MemoryAccess
   memToAccessInfo(const vsrtl::core::BaseMemory<true> *memory) const {
     MemoryAccess access;
@@ -104,9 +180,169 @@ protected:
     return access;
   }
 
+  bool stallProcessor() override {
+    if (m_pendingStallCycles == 0 && m_pendingUnitStallCycles == 0)
+      return false;
+    // Stall cycles are not visible to the design, which remains frozen in its
+    // current state. Overlapping memory and functional unit stalls are served
+    // in parallel, and counted as memory stalls.
+    StallCycle stall;
+    stall.memory = m_pendingStallCycles > 0;
+    stall.unit = m_pendingUnitStallCycles > 0;
+    if (stall.memory) {
+      m_pendingStallCycles--;
+      m_stallCycles++;
+    } else {
+      m_unitStallCycles++;
+    }
+    if (stall.unit)
+      m_pendingUnitStallCycles--;
+    stall.cycle = getCycleCount();
+    m_stallHistory.push_back(stall);
+    if (m_stallHistory.size() >
+        vsrtl::core::ClockedComponent::reverseStackSize())
+      m_stallHistory.pop_front();
+    processorWasClocked.Emit();
+    return true;
+  }
+
+  /// An instruction which has entered the stage executing M-extension
+  /// instructions; see scheduleMExtStall.
+  struct ExecutingInstr {
+    bool valid = false;
+    unsigned aluOp = ALUOp::NOP;
+    // The register written by the instruction, or 0.
+    unsigned rd = 0;
+    // The registers read by the instruction, or 0.
+    unsigned rs1 = 0;
+    unsigned rs2 = 0;
+  };
+
+  /**
+   * @brief scheduleMExtStall
+   * Stalls the processor for the latencies of the M-extension units (see
+   * MExtTiming), given the instructions @p instrs which have entered the
+   * execute stage in the current cycle. To be called by the processor after
+   * each clock of the design.
+   * Divisions occupy the divider, and stall the processor, for divLatency - 1
+   * cycles. If @p pipelinedMul, multiplications are pipelined: the processor
+   * is only stalled once an instruction reads the result of a multiplication
+   * before it is available, ie. before mulLatency cycles have elapsed since
+   * the multiplication entered the execute stage. Otherwise, multiplications
+   * stall the processor like divisions. Processors without forwarding or
+   * hazard detection shall not pipeline multiplications.
+   */
+  void scheduleMExtStall(std::initializer_list<ExecutingInstr> instrs,
+                         bool pipelinedMul) {
+    const MExtTiming &timing = mextTiming();
+    if (timing.mulLatency <= 1 && timing.divLatency <= 1)
+      return;
+
+    const long long cycle = getCycleCount();
+    long long operandStall = 0;
+    unsigned unitStall = 0;
+    for (const ExecutingInstr &instr : instrs) {
+      if (!instr.valid)
+        continue;
+      for (unsigned rs : {instr.rs1, instr.rs2}) {
+        if (rs == 0)
+          continue;
+        // The most recent write of the register is the one which is read.
+        for (auto it = m_mextResults.rbegin(); it != m_mextResults.rend();
+             ++it) {
+          if (it->rd != rs)
+            continue;
+          operandStall = std::max(operandStall, it->readyCycle - cycle);
+          break;
+        }
+      }
+      if (isDivision(instr.aluOp) ||
+          (!pipelinedMul && isMultiplication(instr.aluOp)))
+        unitStall = std::max(unitStall, isDivision(instr.aluOp)
+                                            ? timing.divLatency - 1
+                                            : timing.mulLatency - 1);
+    }
+
+    if (pipelinedMul) {
+      for (const ExecutingInstr &instr : instrs) {
+        if (!instr.valid || instr.rd == 0)
+          continue;
+        const long long ready = isMultiplication(instr.aluOp)
+                                    ? cycle + operandStall + timing.mulLatency
+                                    : 0;
+        m_mextResults.push_back({m_cycleCount, instr.rd, ready});
+      }
+      // Results older than the maximum latency are available.
+      while (m_mextResults.size() > 2 * MExtTiming::s_maxLatency)
+        m_mextResults.pop_front();
+    }
+
+    const unsigned stall = static_cast<unsigned>(operandStall) + unitStall;
+    m_pendingUnitStallCycles = std::max(m_pendingUnitStallCycles, stall);
+  }
+
   // m_instructionsRetired should be modified by the processor when it retires
   // (or "un-retires", while reversing) an instruction
   long long m_instructionsRetired = 0;
+
+private:
+  struct StallCycle {
+    long long cycle = 0;
+    // Whether a pending memory and a pending functional unit stall were
+    // served.
+    bool memory = false;
+    bool unit = false;
+  };
+  struct MExtResult {
+    // The cycle of the design in which the producing instruction entered the
+    // execute stage.
+    long long designCycle;
+    unsigned rd;
+    // The cycle from which the result may be forwarded.
+    long long readyCycle;
+  };
+
+  bool isStallCycle() const {
+    return !m_stallHistory.empty() &&
+           m_stallHistory.back().cycle == getCycleCount();
+  }
+  static bool isMultiplication(unsigned aluOp) {
+    switch (aluOp) {
+    case ALUOp::MUL:
+    case ALUOp::MULH:
+    case ALUOp::MULHU:
+    case ALUOp::MULHSU:
+    case ALUOp::MULW:
+      return true;
+    default:
+      return false;
+    }
+  }
+  static bool isDivision(unsigned aluOp) {
+    switch (aluOp) {
+    case ALUOp::DIV:
+    case ALUOp::DIVU:
+    case ALUOp::REM:
+    case ALUOp::REMU:
+    case ALUOp::DIVW:
+    case ALUOp::DIVUW:
+    case ALUOp::REMW:
+    case ALUOp::REMUW:
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  unsigned m_pendingStallCycles = 0;
+  unsigned m_pendingUnitStallCycles = 0;
+  long long m_stallCycles = 0;
+  long long m_unitStallCycles = 0;
+  // The most recent stall cycles, for reversing.
+  std::deque<StallCycle> m_stallHistory;
+  // Registers written by the most recent instructions to enter the execute
+  // stage, and when their results are available.
+  std::deque<MExtResult> m_mextResults;
 };
 
 } // namespace Ripes
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <memory>
+
+#include "verilated.h"
+
+#include "ripesverilatorprocessor.h"
+
+namespace Ripes {
+
+/**
+ * @brief The VerilatedCore class
+ * Drives the Verilated model VTop of a processor core with the following
+ * top-level ports:
+ *
+ *   inputs:  clk, rst, halt, imem_rdata, dmem_rdata, dbg_reg_addr, dbg_reg_we,
+ *            dbg_reg_wdata, dbg_pc_we, dbg_pc_wdata
+ *   outputs: imem_addr, dmem_addr, dmem_re, dmem_we, dmem_size, dmem_wdata,
+ *            pc, retire, ecall, dbg_reg_rdata
+ *
+ * See VerilatorCore for their semantics. Each model has its own simulation
+ * context, such that multiple processors may be instantiated at once. A model
+ * verilated with --threads evaluates on @p threads threads of its context;
+ * the number of threads must be that which the model was verilated with.
+ */
+template <typename VTop>
+class VerilatedCore : public VerilatorCore {
+public:
+  VerilatedCore(unsigned threads = 1)
+      : m_context(std::make_unique<VerilatedContext>()) {
+    m_context->threads(threads);
+    m_top = std::make_unique<VTop>(m_context.get());
+    m_top->clk = 0;
+  }
+  ~VerilatedCore() override { m_top->final(); }
+
+  void eval(const Inputs &in, Outputs &out) override {
+    drive(in);
+    m_top->eval();
+    sample(out);
+  }
+  void tick(const Inputs &in, Outputs &out) override {
+    drive(in);
+    m_top->clk = 1;
+    m_top->eval();
+    m_top->clk = 0;
+    m_top->eval();
+    sample(out);
+  }
+
+private:
+  void drive(const Inputs &in) {
+    m_top->rst = in.rst;
+    m_top->halt = in.halt;
+    m_top->imem_rdata = in.imemRData;
+    m_top->dmem_rdata = in.dmemRData;
+    m_top->dbg_reg_addr = in.dbgRegAddr;
+    m_top->dbg_reg_we = in.dbgRegWe;
+    m_top->dbg_reg_wdata = in.dbgRegWData;
+    m_top->dbg_pc_we = in.dbgPcWe;
+    m_top->dbg_pc_wdata = in.dbgPcWData;
+  }
+  void sample(Outputs &out) const {
+    out.imemAddr = m_top->imem_addr;
+    out.dmemAddr = m_top->dmem_addr;
+    out.dmemRe = m_top->dmem_re;
+    out.dmemWe = m_top->dmem_we;
+    out.dmemSize = m_top->dmem_size;
+    out.dmemWData = m_top->dmem_wdata;
+    out.pc = m_top->pc;
+    out.retire = m_top->retire;
+    out.ecall = m_top->ecall;
+    out.dbgRegRData = m_top->dbg_reg_rdata;
+  }
+
+  std::unique_ptr<VerilatedContext> m_context;
+  std::unique_ptr<VTop> m_top;
+};
+
+} // namespace Ripes
@@ -0,0 +1,125 @@
+#include "processorstate.h"
+
+namespace Ripes {
+
+// Upper bound on the size of the stack region included in an architectural
+// state. Guards against capturing gigabytes of memory if the stack pointer has
+// been repurposed by the program.
+static constexpr AInt s_maxStackRegionBytes = 16 * 1024 * 1024;
+
+// Memory is read and written in word-sized chunks.
+static constexpr unsigned s_memChunkBytes = 4;
+
+AInt oldestInFlightPC(const RipesProcessor &proc) {
+  // Stages are traversed from the back of the pipeline towards the front; for
+  // multi-issue processors, the lowest PC at a given stage depth is used.
+  const auto &structure = proc.structure();
+  unsigned maxStages = 0;
+  for (const auto &lane : structure)
+    maxStages = std::max(maxStages, lane.second);
+
+  for (unsigned idx = maxStages; idx-- > 0;) {
+    bool found = false;
+    AInt pc = 0;
+    for (const auto &lane : structure) {
+      if (idx >= lane.second)
+        continue;
+      const auto info = proc.stageInfo({lane.first, idx});
+      if (!info.stage_valid || info.state == StageInfo::State::Flushed)
+        continue;
+      if (!found || info.pc < pc)
+        pc = info.pc;
+      found = true;
+    }
+    if (found)
+      return pc;
+  }
+  return proc.nextFetchedAddress();
+}
+
+AInt initialProgramBreak(const Program &program) {
+  AInt end = 0;
+  for (const auto &it : program.sections)
+    end = std::max<AInt>(end, it.second.address + it.second.data.size());
+  return (end + 15) & ~AInt(15);
+}
+
+std::vector<MemoryRegion>
+programMemoryRegions(const RipesProcessor &proc, const Program &program,
+                     const RegisterInitialization &regInit,
+                     AInt programBreak) {
+  std::vector<MemoryRegion> regions;
+  for (const auto &section : program.sections)
+    regions.push_back({section.second.address,
+                       static_cast<AInt>(section.second.data.size())});
+
+  const AInt heapStart = initialProgramBreak(program);
+  if (programBreak > heapStart)
+    regions.push_back({heapStart, programBreak - heapStart});
+
+  const auto *isa = proc.implementsISA();
+  const int spReg = isa->spReg();
+  if (spReg >= 0) {
+    auto stackTop = regInit.find(spReg);
+    const AInt sp = proc.getRegister(RegisterFileType::GPR, spReg);
+    if (stackTop != regInit.end() && sp <= stackTop->second) {
+      // Include the word at the initial stack pointer itself.
+      const AInt top = stackTop->second + isa->bytes();
+      const AInt size = std::min(top - sp, s_maxStackRegionBytes);
+      regions.push_back({top - size, size});
+    }
+  }
+  return regions;
+}
+
+ArchitecturalState
+captureArchitecturalState(RipesProcessor &proc,
+                          const std::vector<MemoryRegion> &regions) {
+  ArchitecturalState state;
+  state.pc = oldestInFlightPC(proc);
+
+  for (const auto &rfid : proc.registerFiles())
+    proc.getRegisters(rfid, state.registers[rfid]);
+  state.csrs = proc.getCSRState();
+
+  auto &mem = proc.getMemory();
+  for (const auto &region : regions) {
+    QByteArray data(region.size, 0);
+    for (AInt offset = 0; offset < region.size; offset += s_memChunkBytes) {
+      const unsigned bytes =
+          std::min<AInt>(s_memChunkBytes, region.size - offset);
+      const VInt value = mem.readMemConst(region.address + offset, bytes);
+      for (unsigned b = 0; b < bytes; ++b)
+        data[offset + b] = static_cast<char>((value >> (b * CHAR_BIT)) & 0xFF);
+    }
+    state.memory[region.address] = data;
+  }
+  return state;
+}
+
+void applyArchitecturalState(RipesProcessor &proc,
+                             const ArchitecturalState &state) {
+  auto &mem = proc.getMemory();
+  for (const auto &region : state.memory) {
+    const QByteArray &data = region.second;
+    for (int offset = 0; offset < data.size(); offset += s_memChunkBytes) {
+      const unsigned bytes =
+          std::min<int>(s_memChunkBytes, data.size() - offset);
+      VInt value = 0;
+      for (unsigned b = 0; b < bytes; ++b)
+        value |= static_cast<VInt>(static_cast<uint8_t>(data[offset + b]))
+                 << (b * CHAR_BIT);
+      mem.writeMem(region.first + offset, value, bytes);
+    }
+    proc.memoryWritten(region.first, data.size());
+  }
+
+  for (const auto &rf : state.registers)
+    for (unsigned i = 0; i < rf.second.size(); ++i)
+      proc.setRegister(rf.first, i, rf.second.at(i));
+  proc.setCSRState(state.csrs);
+
+  proc.setProgramCounter(state.pc);
+}
+
+} // namespace Ripes
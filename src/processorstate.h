@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QByteArray>
+#include <map>
+#include <vector>
+
+#include "assembler/program.h"
+#include "processorregistry.h"
+#include "processors/interface/ripesprocessor.h"
+
+namespace Ripes {
+
+/// A contiguous range of memory, [address : address + size[.
+struct MemoryRegion {
+  AInt address;
+  AInt size;
+};
+
+/**
+ * @brief The ArchitecturalState struct
+ * Snapshot of the architecturally visible state of a processor; its program
+ * counter, register files, CSRs (see RipesProcessor::getCSRState), a set of
+ * memory regions and the program break.
+ * Microarchitectural state (pipeline registers, caches, ...) is not included,
+ * such that a state captured from one processor model may be applied to any
+ * other processor model implementing the same ISA.
+ *
+ * Neither is state outside of the processor: the registers of memory mapped
+ * peripherals and the files opened by the program (see SystemIO). Programs
+ * using either are not resumed faithfully from a state. Of the vector
+ * extension, neither the vector registers nor vl and vtype are included.
+ */
+struct ArchitecturalState {
+  AInt pc = 0;
+  std::map<RegisterFileType, std::vector<VInt>> registers;
+  std::map<unsigned, VInt> csrs;
+  std::map<AInt, QByteArray> memory;
+  // See ProcessorHandler::getProgramBreak.
+  AInt programBreak = 0;
+};
+
+/// Returns the PC of the oldest valid instruction in the pipeline of @p proc.
+/// When resuming from this PC, any younger in-flight instructions are
+/// re-executed.
+AInt oldestInFlightPC(const RipesProcessor &proc);
+
+/// Returns the initial program break of @p program; the end of its sections.
+AInt initialProgramBreak(const Program &program);
+
+/// Returns the memory regions which make up the architectural state of
+/// @p program: each of its sections, the heap, ranging from the initial program
+/// break up to @p programBreak, as well as the stack, ranging from the current
+/// stack pointer of @p proc up to its initial value as given by @p regInit.
+std::vector<MemoryRegion>
+programMemoryRegions(const RipesProcessor &proc, const Program &program,
+                     const RegisterInitialization &regInit,
+                     AInt programBreak);
+
+/// Captures the architectural state of @p proc, including the contents of
+/// @p regions.
+ArchitecturalState
+captureArchitecturalState(RipesProcessor &proc,
+                          const std::vector<MemoryRegion> &regions);
+
+/// Applies @p state to @p proc.
+void applyArchitecturalState(RipesProcessor &proc,
+                             const ArchitecturalState &state);
+
+} // namespace Ripes
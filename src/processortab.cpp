@@ -1,15 +1,27 @@
 #include "processortab.h"
 #include "ui_processortab.h"
 
+#include <QDialog>
 #include <QDir>
+#include <QFileInfo>
 #include <QFontMetrics>
+#include <QHeaderView>
+#include <QInputDialog>
+#include <QLabel>
 #include <QMessageBox>
+#include <QPainter>
 #include <QPushButton>
+#include <QResource>
+#include <QSaveFile>
 #include <QScrollBar>
 #include <QSpinBox>
-#include <QTemporaryFile>
+#include <QStandardPaths>
+#include <QTableView>
+#include <QVBoxLayout>
+#include <climits>
 
 #include "consolewidget.h"
+#include "hosttrace.h"
 #include "instructionmodel.h"
 #include "pipelinediagrammodel.h"
 #include "pipelinediagramwidget.h"
@@ -19,6 +31,7 @@
 #include "registercontainerwidget.h"
 #include "registermodel.h"
 #include "ripessettings.h"
+#include "stagestatisticsmodel.h"
 #include "syscall/systemio.h"
 
 #include "VSRTL/graphics/vsrtl_widget.h"
@@ -72,7 +85,7 @@ ProcessorTab::ProcessorTab(QToolBar *controlToolbar,
   m_vsrtlWidget = m_ui->vsrtlWidget;
 
   if (ProcessorHandler::isVSRTLProcessor()) {
-    // Load the default constructed processor to the VSRTL widget. Do a bit of
+    // Select the layout of the default constructed processor. Do a bit of
     // sanity checking to ensure that the layout stored in the settings is valid
     // for the given processor
     unsigned layoutID =
@@ -87,35 +100,38 @@ ProcessorTab::ProcessorTab(QToolBar *controlToolbar,
     if (layouts.size() > layoutID) {
       layout = &layouts.at(layoutID);
     }
-    loadProcessorToWidget(layout);
-
-    // By default, lock the VSRTL widget
-    m_vsrtlWidget->setLocked(true);
+    m_loadPending = true;
+    m_pendingLayout = layout;
   }
 
   m_stageModel = new PipelineDiagramModel(this);
+  m_stageStatisticsModel = new StageStatisticsModel(this);
 
   updateInstructionModel();
-  connect(ProcessorHandler::get(), &ProcessorHandler::procStateChangedNonRun,
-          this, &ProcessorTab::updateStatistics);
-  connect(ProcessorHandler::get(), &ProcessorHandler::procStateChangedNonRun,
-          this, &ProcessorTab::updateInstructionLabels);
-  connect(ProcessorHandler::get(), &ProcessorHandler::procStateChangedNonRun,
-          this, [=] {
-            m_reverseAction->setEnabled(m_vsrtlWidget->isReversible() &&
-                                        !m_autoClockAction->isChecked());
-          });
+  ProcessorHandler::getRefreshScheduler().addClient(this, [=] {
+    updateStatistics();
+    updateInstructionLabels();
+    m_reverseAction->setEnabled(canReverse() &&
+                                !m_autoClockAction->isChecked());
+  });
 
   setupSimulatorActions(controlToolbar);
 
   // Setup statistics update timer - this timer is distinct from the
-  // ProcessorHandler's update timer, given that it needs to run during
+  // ProcessorHandler's refresh scheduler, given that it needs to run during
   // 'running' the processor.
   m_statUpdateTimer = new QTimer(this);
   m_statUpdateTimer->setInterval(
       1000.0 / RipesSettings::value(RIPES_SETTING_UIUPDATEPS).toInt());
   connect(m_statUpdateTimer, &QTimer::timeout, this,
           &ProcessorTab::updateStatistics);
+  // The processor view is refreshed at the same rate while running.
+  connect(m_statUpdateTimer, &QTimer::timeout, this, [=] {
+    if (m_vsrtlView && isVisible())
+      ProcessorHandler::requestRunFrame();
+  });
+  connect(ProcessorHandler::get(), &ProcessorHandler::runFrame, this,
+          &ProcessorTab::presentRunFrame);
   connect(RipesSettings::getObserver(RIPES_SETTING_UIUPDATEPS),
           &SettingObserver::modified, m_statUpdateTimer, [=] {
             m_statUpdateTimer->setInterval(
@@ -127,7 +143,7 @@ ProcessorTab::ProcessorTab(QToolBar *controlToolbar,
   // simulator is reversible
   connect(RipesSettings::getObserver(RIPES_SETTING_REWINDSTACKSIZE),
           &SettingObserver::modified, m_reverseAction, [=](const auto &) {
-            m_reverseAction->setEnabled(m_vsrtlWidget->isReversible());
+            m_reverseAction->setEnabled(canReverse());
           });
 
   // Connect the global reset request signal to reset()
@@ -156,6 +172,39 @@ ProcessorTab::ProcessorTab(QToolBar *controlToolbar,
   enableSimulatorControls();
 }
 
+// cereal expects the archive file to be present standalone on disk, and
+// available through an ifstream. Resource layout files (bundled within the
+// binary as Qt resources) are extracted once to the cache directory, keyed by
+// the processor, the layout and the version of the layout resource, such that
+// switching processors does not extract the layout anew. Returns an empty
+// string on failure.
+static QString cachedLayoutFile(const Layout &layout) {
+  const QResource resource(layout.file);
+  const QString version =
+      QString::number(resource.size()) + "-" +
+      QString::number(resource.lastModified().toSecsSinceEpoch());
+  const QDir cacheDir(
+      QStandardPaths::writableLocation(QStandardPaths::CacheLocation) +
+      "/layouts");
+  const QString fileName = cacheDir.filePath(
+      enumToString<ProcessorID>(ProcessorHandler::getID()) + "-" +
+      QFileInfo(layout.file).completeBaseName() + "-" + version + ".json");
+  if (QFileInfo::exists(fileName))
+    return fileName;
+
+  if (!cacheDir.mkpath("."))
+    return QString();
+  QFile resourceFile(layout.file);
+  QSaveFile cacheFile(fileName);
+  if (!resourceFile.open(QIODevice::ReadOnly) ||
+      !cacheFile.open(QIODevice::WriteOnly))
+    return QString();
+  cacheFile.write(resourceFile.readAll());
+  if (!cacheFile.commit())
+    return QString();
+  return fileName;
+}
+
 void ProcessorTab::loadLayout(const Layout &layout) {
   if (layout.name.isEmpty() || layout.file.isEmpty())
     return; // Not a valid layout
@@ -166,28 +215,18 @@ void ProcessorTab::loadLayout(const Layout &layout) {
              "A stage label position must be specified for each stage");
   }
 
-  // cereal expects the archive file to be present standalone on disk, and
-  // available through an ifstream. Copy the resource layout file (bundled
-  // within the binary as a Qt resource) to a temporary file, for loading the
-  // layout.
-  const auto &layoutResourceFilename = layout.file;
-  QFile layoutResourceFile(layoutResourceFilename);
-  QTemporaryFile *tmpLayoutFile =
-      QTemporaryFile::createNativeFile(layoutResourceFile);
-  if (!tmpLayoutFile->open()) {
-    QMessageBox::warning(this, "Error",
-                         "Could not create temporary layout file");
+  const QString layoutFile = cachedLayoutFile(layout);
+  if (layoutFile.isEmpty()) {
+    QMessageBox::warning(this, "Error", "Could not create layout file");
     return;
   }
-
-  m_vsrtlWidget->getTopLevelComponent()->loadLayoutFile(
-      tmpLayoutFile->fileName());
-  tmpLayoutFile->remove();
+  m_vsrtlWidget->getTopLevelComponent()->loadLayoutFile(layoutFile);
 
   // Adjust stage label positions
-  const auto &parent = m_stageInstructionLabels.at({0, 0})->parentItem();
-  for (auto sid : ProcessorHandler::getProcessor()->structure().stageIt()) {
-    auto &label = m_stageInstructionLabels.at(sid);
+  const auto &structure = ProcessorHandler::getProcessor()->structure();
+  const auto &parent = m_stageInstructionLabels.at(0)->parentItem();
+  for (auto sid : structure.stageIt()) {
+    auto &label = m_stageInstructionLabels.at(structure.flatIndex(sid));
     QFontMetrics metrics(label->font());
     label->setPos(parent->boundingRect().width() *
                       layout.stageLabelPositions.at(sid).x(),
@@ -220,6 +259,13 @@ void ProcessorTab::setupSimulatorActions(QToolBar *controlToolbar) {
   m_reverseAction->setToolTip("Undo a clock cycle (F4)");
   controlToolbar->addAction(m_reverseAction);
 
+  m_seekAction = new QAction("Go to cycle", this);
+  connect(m_seekAction, &QAction::triggered, this, &ProcessorTab::seekToCycle);
+  m_seekAction->setToolTip(
+      "Move the simulator to an arbitrary cycle, replaying from reset if the "
+      "cycle lies beyond the rewind history");
+  controlToolbar->addAction(m_seekAction);
+
   const QIcon clockIcon = QIcon(":/icons/step.svg");
   m_clockAction = new QAction(clockIcon, "Clock (F5)", this);
   connect(m_clockAction, &QAction::triggered, this,
@@ -230,7 +276,7 @@ void ProcessorTab::setupSimulatorActions(QToolBar *controlToolbar) {
 
   m_autoClockTimer = new QTimer(this);
   connect(m_autoClockTimer, &QTimer::timeout, this,
-          [=] { ProcessorHandler::clock(); });
+          [=] { ProcessorHandler::clock(m_autoClockCycles->value()); });
 
   const QIcon startAutoClockIcon = QIcon(":/icons/step-clock.svg");
   m_autoClockAction = new QAction(startAutoClockIcon, "Auto clock (F6)", this);
@@ -256,6 +302,18 @@ void ProcessorTab::setupSimulatorActions(QToolBar *controlToolbar) {
       RipesSettings::value(RIPES_SETTING_AUTOCLOCK_INTERVAL).toInt());
   controlToolbar->addWidget(m_autoClockInterval);
 
+  m_autoClockCycles = new QSpinBox(this);
+  m_autoClockCycles->setRange(1, 1000000);
+  m_autoClockCycles->setSuffix(" cycles");
+  m_autoClockCycles->setToolTip("Cycles clocked per auto clock interval");
+  connect(m_autoClockCycles, qOverload<int>(&QSpinBox::valueChanged), this,
+          [](int cycles) {
+            RipesSettings::setValue(RIPES_SETTING_AUTOCLOCK_CYCLES, cycles);
+          });
+  m_autoClockCycles->setValue(
+      RipesSettings::value(RIPES_SETTING_AUTOCLOCK_CYCLES).toInt());
+  controlToolbar->addWidget(m_autoClockCycles);
+
   const QIcon runIcon = QIcon(":/icons/run.svg");
   m_runAction = new QAction(runIcon, "Run (F8)", this);
   m_runAction->setShortcut(QKeySequence("F8"));
@@ -275,7 +333,7 @@ void ProcessorTab::setupSimulatorActions(QToolBar *controlToolbar) {
           [=](bool checked) {
             RipesSettings::setValue(RIPES_SETTING_SHOWSIGNALS,
                                     QVariant::fromValue(checked));
-            m_vsrtlWidget->setOutputPortValuesVisible(checked);
+            updateSignalValueVisibility();
           });
   m_displayValuesAction->setChecked(
       RipesSettings::value(RIPES_SETTING_SHOWSIGNALS).toBool());
@@ -287,6 +345,13 @@ void ProcessorTab::setupSimulatorActions(QToolBar *controlToolbar) {
           &ProcessorTab::showPipelineDiagram);
   m_toolbar->addAction(m_pipelineDiagramAction);
 
+  const QIcon statisticsIcon = QIcon(":/icons/analytics.svg");
+  m_stageStatisticsAction =
+      new QAction(statisticsIcon, "Show stage statistics", this);
+  connect(m_stageStatisticsAction, &QAction::triggered, this,
+          &ProcessorTab::showStageStatistics);
+  m_toolbar->addAction(m_stageStatisticsAction);
+
   m_darkmodeAction = new QAction("Processor darkmode", this);
   m_darkmodeAction->setCheckable(true);
   connect(m_darkmodeAction, &QAction::toggled, m_vsrtlWidget,
@@ -300,6 +365,7 @@ void ProcessorTab::setupSimulatorActions(QToolBar *controlToolbar) {
 }
 
 void ProcessorTab::updateStatistics() {
+  HostTrace::Scope traceScope("updateStatistics", "gui");
   static auto lastUpdateTime = std::chrono::system_clock::now();
   static long long lastCycleCount =
       ProcessorHandler::getProcessor()->getCycleCount();
@@ -342,10 +408,37 @@ void ProcessorTab::updateStatistics() {
 void ProcessorTab::pause() {
   m_autoClockAction->setChecked(false);
   m_runAction->setChecked(false);
-  m_reverseAction->setEnabled(m_vsrtlWidget->isReversible());
+  m_reverseAction->setEnabled(canReverse());
 }
 
-void ProcessorTab::fitToScreen() { m_vsrtlWidget->zoomToFit(); }
+void ProcessorTab::fitToScreen() {
+  m_vsrtlWidget->zoomToFit();
+  updateSignalValueVisibility();
+}
+
+void ProcessorTab::updateSignalValueVisibility() {
+  if (!m_vsrtlView) {
+    m_vsrtlView = m_vsrtlWidget->findChild<QGraphicsView *>();
+    if (m_vsrtlView)
+      m_vsrtlView->viewport()->installEventFilter(this);
+  }
+  const qreal scale = m_vsrtlView ? m_vsrtlView->transform().m11() : 1;
+  const bool visible =
+      m_displayValuesAction->isChecked() && scale >= s_signalValuesMinScale;
+  if (visible == m_signalValuesVisible)
+    return;
+  m_signalValuesVisible = visible;
+  m_vsrtlWidget->setOutputPortValuesVisible(visible);
+}
+
+bool ProcessorTab::eventFilter(QObject *watched, QEvent *event) {
+  if (m_vsrtlView && watched == m_vsrtlView->viewport() &&
+      event->type() == QEvent::Wheel) {
+    // The view zooms upon handling the event.
+    QTimer::singleShot(0, this, [=] { updateSignalValueVisibility(); });
+  }
+  return RipesTab::eventFilter(watched, event);
+}
 
 void ProcessorTab::loadProcessorToWidget(const Layout *layout) {
   const bool doPlaceAndRoute = layout != nullptr;
@@ -355,21 +448,33 @@ void ProcessorTab::loadProcessorToWidget(const Layout *layout) {
   auto *topLevelComponent = m_vsrtlWidget->getTopLevelComponent();
 
   m_stageInstructionLabels.clear();
-  for (auto laneIt : ProcessorHandler::getProcessor()->structure()) {
-    for (unsigned stageIdx = 0; stageIdx < laneIt.second; stageIdx++) {
-      StageIndex sid = {laneIt.first, stageIdx};
-      auto *stagelabel = new vsrtl::Label(topLevelComponent, "-");
-      stagelabel->setPointSize(14);
-      m_stageInstructionLabels[sid] = stagelabel;
-    }
+  for (unsigned i = 0;
+       i < ProcessorHandler::getProcessor()->structure().numStages(); ++i) {
+    auto *stagelabel = new vsrtl::Label(topLevelComponent, "-");
+    stagelabel->setPointSize(14);
+    m_stageInstructionLabels.push_back(stagelabel);
   }
   if (layout != nullptr) {
     loadLayout(*layout);
   }
   updateInstructionLabels();
+  // The signal values of the new design are shown according to its zoom
+  // level.
+  m_signalValuesVisible = false;
   fitToScreen();
 }
 
+void ProcessorTab::showEvent(QShowEvent *event) {
+  RipesTab::showEvent(event);
+  if (!m_loadPending)
+    return;
+
+  m_loadPending = false;
+  loadProcessorToWidget(m_pendingLayout);
+  // By default, lock the VSRTL widget
+  m_vsrtlWidget->setLocked(true);
+}
+
 void ProcessorTab::processorSelection() {
   m_autoClockAction->setChecked(false);
   ProcessorSelectionDialog diag;
@@ -377,6 +482,7 @@ void ProcessorTab::processorSelection() {
     // New processor model was selected
     m_vsrtlWidget->clearDesign();
     m_stageInstructionLabels.clear();
+    m_loadPending = false;
     ProcessorHandler::selectProcessor(diag.getSelectedId(),
                                       diag.getEnabledExtensions(),
                                       diag.getRegisterInitialization());
@@ -397,10 +503,8 @@ void ProcessorTab::processorSelection() {
     }
     updateInstructionModel();
 
-    // Retrigger value display action if enabled
-    if (m_displayValuesAction->isChecked()) {
-      m_vsrtlWidget->setOutputPortValuesVisible(true);
-    }
+    // Retrigger value display for the new design
+    updateSignalValueVisibility();
   }
 }
 
@@ -463,18 +567,22 @@ void ProcessorTab::enableSimulatorControls() {
   m_clockAction->setEnabled(true);
   m_autoClockAction->setEnabled(true);
   m_runAction->setEnabled(true);
-  m_reverseAction->setEnabled(m_vsrtlWidget->isReversible());
+  m_reverseAction->setEnabled(canReverse());
+  m_seekAction->setEnabled(true);
   m_resetAction->setEnabled(true);
   m_pipelineDiagramAction->setEnabled(true);
 }
 
 void ProcessorTab::updateInstructionLabels() {
+  HostTrace::Scope traceScope("updateInstructionLabels", "gui");
   const auto &proc = ProcessorHandler::getProcessor();
-  for (auto sid : ProcessorHandler::getProcessor()->structure().stageIt()) {
-    if (!m_stageInstructionLabels.count(sid))
-      continue;
-    const auto stageInfo = proc->stageInfo(sid);
-    auto &instrLabel = m_stageInstructionLabels.at(sid);
+  const auto &stages = proc->structure().stageIt();
+  // Labels are only present once the processor is loaded to the widget.
+  if (m_stageInstructionLabels.size() != stages.size())
+    return;
+  for (unsigned i = 0; i < stages.size(); ++i) {
+    const auto stageInfo = proc->stageInfo(stages[i]);
+    auto &instrLabel = m_stageInstructionLabels[i];
     QString instrString;
     if (stageInfo.state != StageInfo::State::None) {
       /* clang-format off */
@@ -519,9 +627,43 @@ void ProcessorTab::setInstructionViewCenterRow(int row) {
 
 void ProcessorTab::runFinished() {
   pause();
+  if (m_seeking) {
+    m_seeking = false;
+    setRunningControls(false);
+    enableSimulatorControls();
+  }
   ProcessorHandler::checkProcessorFinished();
   m_vsrtlWidget->sync();
   m_statUpdateTimer->stop();
+  if (m_runFrameLabel)
+    m_runFrameLabel->hide();
+}
+
+void ProcessorTab::presentRunFrame() {
+  if (!m_vsrtlView || !isVisible())
+    return;
+  HostTrace::Scope traceScope("runFrame", "gui");
+  QWidget *viewport = m_vsrtlView->viewport();
+  if (!m_runFrameLabel) {
+    m_runFrameLabel = new QLabel(viewport);
+    // Opaque, such that the view is not drawn beneath it.
+    m_runFrameLabel->setAutoFillBackground(true);
+    m_runFrameLabel->setAlignment(Qt::AlignLeft | Qt::AlignTop);
+  }
+
+  m_vsrtlWidget->sync();
+  const qreal ratio = viewport->devicePixelRatioF();
+  QImage frame(viewport->size() * ratio, QImage::Format_ARGB32_Premultiplied);
+  frame.setDevicePixelRatio(ratio);
+  frame.fill(viewport->palette().color(viewport->backgroundRole()));
+  QPainter painter(&frame);
+  painter.setRenderHints(m_vsrtlView->renderHints());
+  m_vsrtlView->render(&painter, QRectF(), viewport->rect());
+  painter.end();
+
+  m_runFrameLabel->setGeometry(viewport->rect());
+  m_runFrameLabel->setPixmap(QPixmap::fromImage(frame));
+  m_runFrameLabel->show();
 }
 
 void ProcessorTab::autoClock(bool state) {
@@ -539,6 +681,7 @@ void ProcessorTab::autoClock(bool state) {
   m_selectProcessorAction->setEnabled(!state);
   m_clockAction->setEnabled(!state);
   m_reverseAction->setEnabled(!state);
+  m_seekAction->setEnabled(!state);
   m_resetAction->setEnabled(!state);
   m_displayValuesAction->setEnabled(!state);
   m_pipelineDiagramAction->setEnabled(!state);
@@ -557,29 +700,86 @@ void ProcessorTab::run(bool state) {
     ProcessorHandler::stopRun();
     m_statUpdateTimer->stop();
   }
+  setRunningControls(state);
+}
 
+void ProcessorTab::setRunningControls(bool running) {
   // Enable/Disable all actions based on whether the processor is running.
-  m_selectProcessorAction->setEnabled(!state);
-  m_clockAction->setEnabled(!state);
-  m_autoClockAction->setEnabled(!state);
-  m_reverseAction->setEnabled(!state);
-  m_resetAction->setEnabled(!state);
-  m_displayValuesAction->setEnabled(!state);
-  m_pipelineDiagramAction->setEnabled(!state);
+  m_selectProcessorAction->setEnabled(!running);
+  m_clockAction->setEnabled(!running);
+  m_autoClockAction->setEnabled(!running);
+  m_reverseAction->setEnabled(!running);
+  m_seekAction->setEnabled(!running);
+  m_resetAction->setEnabled(!running);
+  m_displayValuesAction->setEnabled(!running);
+  m_pipelineDiagramAction->setEnabled(!running);
 
   // Disable widgets which are not updated when running the processor
-  m_vsrtlWidget->setEnabled(!state);
-  m_ui->registerContainerWidget->setEnabled(!state);
-  m_ui->instructionView->setEnabled(!state);
+  m_vsrtlWidget->setEnabled(!running);
+  m_ui->registerContainerWidget->setEnabled(!running);
+  m_ui->instructionView->setEnabled(!running);
+}
+
+void ProcessorTab::seek(long long cycle) {
+  if (cycle == ProcessorHandler::getProcessor()->getCycleCount())
+    return;
+  // The seek executes asynchronously, and re-enables the controls once it
+  // finishes (see runFinished). Seeking may reset the processor, enabling the
+  // controls.
+  m_seeking = true;
+  ProcessorHandler::seekToCycle(cycle);
+  setRunningControls(true);
+}
+
+bool ProcessorTab::canReverse() const {
+  return m_vsrtlWidget->isReversible() ||
+         ProcessorHandler::getProcessor()->getCycleCount() > 0;
 }
 
 void ProcessorTab::reverse() {
-  m_vsrtlWidget->reverse();
-  enableSimulatorControls();
+  // Reverse the state resulting from any clock requests still in flight.
+  ProcessorHandler::waitForIdle();
+  if (m_vsrtlWidget->isReversible()) {
+    m_vsrtlWidget->reverse();
+    enableSimulatorControls();
+  } else {
+    // The rewind history is exhausted; replay up until the preceding cycle
+    // instead.
+    seek(ProcessorHandler::getProcessor()->getCycleCount() - 1);
+  }
+}
+
+void ProcessorTab::seekToCycle() {
+  bool ok = false;
+  const int cycle = QInputDialog::getInt(
+      this, "Go to cycle", "Cycle:",
+      ProcessorHandler::getProcessor()->getCycleCount(), 0, INT_MAX, 1, &ok);
+  if (!ok)
+    return;
+  seek(cycle);
 }
 
 void ProcessorTab::showPipelineDiagram() {
   auto w = PipelineDiagramWidget(m_stageModel);
   w.exec();
 }
+
+void ProcessorTab::showStageStatistics() {
+  QDialog dialog(this);
+  dialog.setWindowTitle("Stage statistics");
+  auto *layout = new QVBoxLayout(&dialog);
+  auto *view = new QTableView(&dialog);
+  m_stageStatisticsModel->prepareForView();
+  view->setModel(m_stageStatisticsModel);
+  view->verticalHeader()->hide();
+  view->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+  layout->addWidget(view);
+  layout->addWidget(new QLabel(
+      "Cycles in which each stage held an executing instruction, was stalled, "
+      "was flushed, held a way hazard or held a bubble, out of " +
+          QString::number(m_stageStatisticsModel->cycles()) + " cycles.",
+      &dialog));
+  dialog.resize(600, 300);
+  dialog.exec();
+}
 } // namespace Ripes
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <QAction>
+#include <QGraphicsView>
+#include <QLabel>
+#include <QPointer>
 #include <QSpinBox>
 #include <QTimer>
 #include <QToolBar>
@@ -24,6 +27,7 @@ class ProcessorTab;
 class InstructionModel;
 class RegisterModel;
 class PipelineDiagramModel;
+class StageStatisticsModel;
 struct Layout;
 
 class ProcessorTab : public RipesTab {
@@ -43,6 +47,7 @@ public slots:
   void restart();
   void reset();
   void reverse();
+  void seekToCycle();
   void processorFinished();
   void runFinished();
   void updateStatistics();
@@ -51,29 +56,67 @@ public slots:
 
   void processorSelection();
 
+protected:
+  void showEvent(QShowEvent *event) override;
+  bool eventFilter(QObject *watched, QEvent *event) override;
+
 private slots:
   void run(bool state);
   void autoClock(bool state);
   void setInstructionViewCenterRow(int row);
   void showPipelineDiagram();
+  void showStageStatistics();
 
 private:
   void setupSimulatorActions(QToolBar *controlToolbar);
   void enableSimulatorControls();
+  /// Disables the controls which may not be used while the processor is
+  /// running, or enables them.
+  void setRunningControls(bool running);
+  /// Seeks the processor to @p cycle (see ProcessorHandler::seekToCycle).
+  void seek(long long cycle);
+  bool canReverse() const;
   void updateInstructionModel();
   void updateRegisterModel();
   void loadLayout(const Layout &);
   void loadProcessorToWidget(const Layout *);
+  /// Shows the signal values of the processor view if enabled, and if the view
+  /// is zoomed in beyond s_signalValuesMinScale.
+  void updateSignalValueVisibility();
+  /// Renders the processor view into m_runFrameLabel, while the processor is
+  /// paused for a frame of the run.
+  void presentRunFrame();
 
   Ui::ProcessorTab *m_ui = nullptr;
   InstructionModel *m_instrModel = nullptr;
   PipelineDiagramModel *m_stageModel = nullptr;
+  StageStatisticsModel *m_stageStatisticsModel = nullptr;
 
   vsrtl::VSRTLWidget *m_vsrtlWidget = nullptr;
-
-  std::map<StageIndex, vsrtl::Label *> m_stageInstructionLabels;
+  // The graphics view of m_vsrtlWidget, whose zoom level is observed.
+  QPointer<QGraphicsView> m_vsrtlView;
+  bool m_signalValuesVisible = false;
+  // Below this scale, signal values are too small to be legible, and are
+  // hidden such that they need not be drawn.
+  static constexpr qreal s_signalValuesMinScale = 0.5;
+  // Covers the processor view while running, presenting the most recent frame
+  // of the run (see ProcessorHandler::requestRunFrame). The scene is not drawn
+  // while covered, given that the processor state changes concurrently.
+  QLabel *m_runFrameLabel = nullptr;
+
+  // The instruction label of each stage, in the order of
+  // ProcessorStructure::stageIt().
+  std::vector<vsrtl::Label *> m_stageInstructionLabels;
+
+  // The initial processor is loaded to the VSRTL widget once the tab is first
+  // shown, such that its layout is only parsed once it is drawn. Set while the
+  // processor has yet to be loaded, along with the layout to load it with.
+  bool m_loadPending = false;
+  const Layout *m_pendingLayout = nullptr;
 
   QTimer *m_statUpdateTimer;
+  // Set while a seek executes, which is not started through m_runAction.
+  bool m_seeking = false;
 
   // Actions
   QAction *m_selectProcessorAction = nullptr;
@@ -82,11 +125,14 @@ private:
   QAction *m_runAction = nullptr;
   QAction *m_displayValuesAction = nullptr;
   QAction *m_pipelineDiagramAction = nullptr;
+  QAction *m_stageStatisticsAction = nullptr;
   QAction *m_reverseAction = nullptr;
+  QAction *m_seekAction = nullptr;
   QAction *m_resetAction = nullptr;
   QAction *m_darkmodeAction = nullptr;
   QTimer *m_autoClockTimer = nullptr;
 
   QSpinBox *m_autoClockInterval = nullptr;
+  QSpinBox *m_autoClockCycles = nullptr;
 };
 } // namespace Ripes
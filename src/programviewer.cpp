@@ -4,7 +4,9 @@
 #include <QApplication>
 #include <QEvent>
 #include <QFontMetricsF>
+#include <QInputDialog>
 #include <QMenu>
+#include <QMessageBox>
 #include <QTextBlock>
 
 #include "colors.h"
@@ -100,11 +102,11 @@ void ProgramViewer::setFollowEnabled(bool enabled) {
 }
 
 void ProgramViewer::updateHighlightedAddresses() {
-  clearBlockHighlights();
   const unsigned stages =
       ProcessorHandler::getProcessor()->structure().numStages();
   auto colorGenerator = Colors::incrementalRedGenerator(stages);
 
+  std::vector<Highlight> highlights;
   for (auto sid : ProcessorHandler::getProcessor()->structure().stageIt()) {
     const auto stageInfo = ProcessorHandler::getProcessor()->stageInfo(sid);
     if (stageInfo.stage_valid) {
@@ -114,11 +116,14 @@ void ProgramViewer::updateHighlightedAddresses() {
 
       // Record the stage name for the highlighted block for later painting
       QString stageString = ProcessorHandler::getProcessor()->stageName(sid);
-      if (!stageInfo.namedState.isEmpty())
-        stageString += " (" + stageInfo.namedState + ")";
-      highlightBlock(block, colorGenerator(), stageString);
+      if (stageInfo.namedState != NamedStates::None)
+        stageString += " (" + NamedStates::name(stageInfo.namedState) + ")";
+      highlights.push_back({block, colorGenerator(), stageString});
     }
   }
+  // Only the blocks whose stages changed since the previous refresh cause a
+  // repaint.
+  setBlockHighlights(highlights);
 
   if (m_following) {
     updateCenterAddressFromProcessor();
@@ -314,6 +319,30 @@ void ProgramViewer::breakpointClick(const QPoint &pos) {
   }
 }
 
+void ProgramViewer::editBreakpointCondition(const QPoint &pos) {
+  bool ok;
+  const auto address = addressForPos(pos, ok);
+  if (!ok)
+    return;
+  const auto *current = ProcessorHandler::getBreakpointCondition(address);
+  const QString condition = QInputDialog::getText(
+      this, "Breakpoint condition",
+      "Break when (ie. a0 == 42 && mem[sp+8] > 0; empty for always):",
+      QLineEdit::Normal, current ? current->text() : QString(), &ok);
+  if (!ok)
+    return;
+  const int hitCount = QInputDialog::getInt(
+      this, "Breakpoint hit count", "Break from hit number:",
+      current ? std::max(1u, current->hitCount()) : 1, 1, INT_MAX, 1, &ok);
+  if (!ok)
+    return;
+  const QString err =
+      ProcessorHandler::setBreakpointCondition(address, condition, hitCount);
+  if (!err.isEmpty())
+    QMessageBox::warning(this, "Breakpoint condition", err);
+  repaint();
+}
+
 // -------------- breakpoint area ----------------------------------
 
 BreakpointArea::BreakpointArea(ProgramViewer *viewer) : QWidget(viewer) {
@@ -327,10 +356,13 @@ void BreakpointArea::contextMenuEvent(QContextMenuEvent *event) {
 
   // Create and connect actions for removing and setting breakpoints
   auto *toggleAction = contextMenu.addAction("Toggle breakpoint");
+  auto *conditionAction = contextMenu.addAction("Edit breakpoint condition...");
   auto *removeAllAction = contextMenu.addAction("Remove all breakpoints");
 
   connect(toggleAction, &QAction::triggered, m_programViewer,
           [=] { m_programViewer->breakpointClick(event->pos()); });
+  connect(conditionAction, &QAction::triggered, m_programViewer,
+          [=] { m_programViewer->editBreakpointCondition(event->pos()); });
   connect(removeAllAction, &QAction::triggered, m_programViewer, [=] {
     m_programViewer->clearBreakpoints();
     repaint();
@@ -22,6 +22,8 @@ public:
 
   void breakpointAreaPaintEvent(QPaintEvent *event);
   void breakpointClick(const QPoint &pos);
+  /// Prompts for the condition and hit count of the breakpoint at @p pos.
+  void editBreakpointCondition(const QPoint &pos);
   bool hasBreakpoint(const QPoint &pos) const;
   void clearBreakpoints();
   void setFollowEnabled(bool enabled);
@@ -2,6 +2,9 @@
 
 #include "processorhandler.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace Ripes {
 
 void setISADepRegex(QRegExpValidator *validator) {
@@ -17,49 +20,148 @@ void setISADepRegex(QRegExpValidator *validator) {
   }
 }
 
-QString encodeRadixValue(VInt value, const Radix type, unsigned byteWidth) {
+namespace {
+/// Two-digit encodings of each byte in hex, of each byte in binary (eight
+/// digits), and of each number below 100 in decimal.
+struct DigitTables {
+  char hex[256][2];
+  char bin[256][8];
+  char dec[100][2];
+
+  DigitTables() {
+    static const char digits[] = "0123456789abcdef";
+    for (unsigned i = 0; i < 256; ++i) {
+      hex[i][0] = digits[i >> 4];
+      hex[i][1] = digits[i & 0xF];
+      for (unsigned bit = 0; bit < 8; ++bit)
+        bin[i][bit] = '0' + ((i >> (7 - bit)) & 1);
+    }
+    for (unsigned i = 0; i < 100; ++i) {
+      dec[i][0] = '0' + i / 10;
+      dec[i][1] = '0' + i % 10;
+    }
+  }
+};
+const DigitTables s_digits;
+
+/// Returns the number of significant bits of @p value, and at least one.
+unsigned bitLength(VInt value) {
+  unsigned bits = 1;
+  while (bits < sizeof(VInt) * CHAR_BIT && value >> bits)
+    ++bits;
+  return bits;
+}
+
+char *formatDecimal(char *out, uint64_t value) {
+  // Digits are produced from the least significant pair, into the end of a
+  // buffer of the longest decimal.
+  char buffer[20];
+  char *it = buffer + sizeof(buffer);
+  while (value >= 100) {
+    it -= 2;
+    std::memcpy(it, s_digits.dec[value % 100], 2);
+    value /= 100;
+  }
+  if (value >= 10) {
+    it -= 2;
+    std::memcpy(it, s_digits.dec[value], 2);
+  } else {
+    *--it = '0' + value;
+  }
+  const size_t length = buffer + sizeof(buffer) - it;
+  std::memcpy(out, it, length);
+  return out + length;
+}
+} // namespace
+
+char *formatRadixValue(char *out, VInt value, const Radix type,
+                       unsigned byteWidth) {
   switch (type) {
   case Radix::Hex: {
-    return "0x" + QString::number(value, 16).rightJustified(byteWidth * 2, '0');
+    // Values wider than the byte width are not truncated.
+    const unsigned digits =
+        std::max(byteWidth * 2, (bitLength(value) + 3) / 4);
+    *out++ = '0';
+    *out++ = 'x';
+    unsigned i = digits;
+    if (i % 2 != 0)
+      *out++ = s_digits.hex[(value >> (--i * 4)) & 0xF][1];
+    for (; i > 0; i -= 2, out += 2)
+      std::memcpy(out, s_digits.hex[(value >> ((i - 2) * 4)) & 0xFF], 2);
+    return out;
   }
   case Radix::Float: {
     float _fvalue; // Copy raw data instead of reinterpret_cast to avoid
                    // type-punned pointer error
     double _dvalue;
+    QByteArray str;
     if (byteWidth <= 4) {
       memcpy(&_fvalue, &value, sizeof(_fvalue));
-      return QString::number(_fvalue);
+      str = QByteArray::number(_fvalue);
     } else {
       memcpy(&_dvalue, &value, sizeof(_dvalue));
-      return QString::number(_dvalue);
+      str = QByteArray::number(_dvalue);
     }
+    std::memcpy(out, str.constData(), str.size());
+    return out + str.size();
   }
   case Radix::Binary: {
-    return "0b" +
-           QString::number(value, 2).rightJustified(byteWidth * CHAR_BIT, '0');
+    const unsigned digits = std::max(byteWidth * CHAR_BIT, bitLength(value));
+    *out++ = '0';
+    *out++ = 'b';
+    unsigned i = digits;
+    for (; i % 8 != 0; --i)
+      *out++ = '0' + ((value >> (i - 1)) & 1);
+    for (; i > 0; i -= 8, out += 8)
+      std::memcpy(out, s_digits.bin[(value >> (i - 8)) & 0xFF], 8);
+    return out;
   }
   case Radix::Unsigned: {
-    return QString::number(value, 10);
+    return formatDecimal(out, value);
   }
   case Radix::Signed: {
-    if (byteWidth == 4) {
-      return QString::number(static_cast<int32_t>(value), 10);
-    } else {
-      return QString::number(static_cast<int64_t>(value), 10);
-    }
+    const int64_t signedValue = byteWidth == 4
+                                    ? static_cast<int32_t>(value)
+                                    : static_cast<int64_t>(value);
+    if (signedValue >= 0)
+      return formatDecimal(out, signedValue);
+    *out++ = '-';
+    return formatDecimal(out, -static_cast<uint64_t>(signedValue));
   }
   case Radix::ASCII: {
-    QString str;
-    for (unsigned i = 0; i < byteWidth; ++i) {
-      str.prepend(QChar::fromLatin1(value & 0xFF));
-      value >>= 8;
-    }
-    return str;
+    for (unsigned i = byteWidth; i > 0; --i)
+      *out++ = static_cast<char>((value >> ((i - 1) * CHAR_BIT)) & 0xFF);
+    return out;
   }
   }
   Q_UNREACHABLE();
 }
 
+QString encodeRadixValue(VInt value, const Radix type, unsigned byteWidth) {
+  char buffer[s_maxRadixChars];
+  const char *end = formatRadixValue(buffer, value, type, byteWidth);
+  return QString::fromLatin1(buffer, end - buffer);
+}
+
+void formatRadixValues(QByteArray &out, const uint8_t *data, size_t bytes,
+                       const Radix type, unsigned byteWidth, char separator) {
+  const size_t count = bytes / byteWidth;
+  if (count == 0)
+    return;
+  const int start = out.size();
+  out.resize(start + count * (s_maxRadixChars + 1));
+  char *it = out.data() + start;
+  for (size_t i = 0; i < count; ++i, data += byteWidth) {
+    VInt value = 0;
+    for (unsigned b = 0; b < byteWidth; ++b)
+      value |= static_cast<VInt>(data[b]) << (b * CHAR_BIT);
+    if (i != 0)
+      *it++ = separator;
+    it = formatRadixValue(it, value, type, byteWidth);
+  }
+  out.resize(it - out.data());
+}
+
 VInt decodeRadixValue(QString value, const Radix type, bool *ok) {
   switch (type) {
   case Radix::Hex: {
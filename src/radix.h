@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QByteArray>
 #include <QMetaType>
 #include <QRegExp>
 #include <QRegExpValidator>
@@ -30,6 +31,29 @@ void setISADepRegex(QRegExpValidator *validator);
 QString encodeRadixValue(VInt value, const Radix type, unsigned byteWidth);
 VInt decodeRadixValue(QString value, const Radix type, bool *ok = nullptr);
 
+/// The maximum number of characters written by formatRadixValue.
+constexpr unsigned s_maxRadixChars = 66;
+
+/**
+ * @brief formatRadixValue
+ * Writes @p value to @p out as encodeRadixValue would, without allocating.
+ * @p out must hold s_maxRadixChars characters. Returns a pointer one past the
+ * last character written.
+ */
+char *formatRadixValue(char *out, VInt value, const Radix type,
+                       unsigned byteWidth);
+
+/**
+ * @brief formatRadixValues
+ * Appends the little endian values of @p byteWidth bytes held in the @p bytes
+ * bytes at @p data to @p out, formatted as by formatRadixValue and separated
+ * by @p separator. Trailing bytes not forming a whole value are ignored. The
+ * buffer is grown once for all values.
+ */
+void formatRadixValues(QByteArray &out, const uint8_t *data, size_t bytes,
+                       const Radix type, unsigned byteWidth,
+                       char separator = ' ');
+
 } // namespace Ripes
 
 Q_DECLARE_METATYPE(Ripes::Radix);
@@ -0,0 +1,124 @@
+#include "refreshscheduler.h"
+
+#include <QEvent>
+#include <QThread>
+#include <QWidget>
+
+#include <algorithm>
+
+#include "hosttrace.h"
+
+namespace Ripes {
+
+RefreshScheduler::RefreshScheduler(QObject *parent) : QObject(parent) {
+  m_frameTimer.setSingleShot(true);
+  connect(&m_frameTimer, &QTimer::timeout, this, &RefreshScheduler::frame);
+}
+
+RefreshScheduler::ClientID
+RefreshScheduler::addClient(QObject *context, std::function<void()> refresh) {
+  std::lock_guard<std::mutex> lock(m_lock);
+  Client client;
+  client.context = context;
+  client.refresh = std::move(refresh);
+  // Refreshes of hidden widgets are deferred until they are shown.
+  if (context->isWidgetType())
+    context->installEventFilter(this);
+  m_clients.push_back(std::move(client));
+  return m_clients.size() - 1;
+}
+
+void RefreshScheduler::markDirty(ClientID id) {
+  std::lock_guard<std::mutex> lock(m_lock);
+  m_clients.at(id).dirty = true;
+  scheduleFrame();
+}
+
+void RefreshScheduler::markAllDirty() {
+  std::lock_guard<std::mutex> lock(m_lock);
+  for (auto &client : m_clients)
+    client.dirty = true;
+  scheduleFrame();
+}
+
+bool RefreshScheduler::Client::refreshable() const {
+  if (context.isNull())
+    return false;
+  if (context->isWidgetType())
+    return static_cast<QWidget *>(context.data())->isVisible();
+  return true;
+}
+
+bool RefreshScheduler::eventFilter(QObject *watched, QEvent *event) {
+  if (event->type() == QEvent::Show) {
+    std::lock_guard<std::mutex> lock(m_lock);
+    const bool dirty = std::any_of(
+        m_clients.begin(), m_clients.end(), [watched](const Client &client) {
+          return client.dirty && client.context == watched;
+        });
+    if (dirty)
+      scheduleFrame();
+  }
+  return QObject::eventFilter(watched, event);
+}
+
+void RefreshScheduler::setFrameRate(int fps) {
+  std::lock_guard<std::mutex> lock(m_lock);
+  m_frameIntervalMs = fps > 0 ? 1000 / fps : 0;
+}
+
+void RefreshScheduler::scheduleFrame() {
+  if (m_framePending)
+    return;
+  m_framePending = true;
+
+  // Frames are spaced by at least the frame interval; a state change after an
+  // idle period is refreshed immediately.
+  int delay = 0;
+  if (m_sinceLastFrame.isValid())
+    delay = std::max<qint64>(0, m_frameIntervalMs - m_sinceLastFrame.elapsed());
+  if (QThread::currentThread() == thread())
+    m_frameTimer.start(delay);
+  else
+    QMetaObject::invokeMethod(
+        this, [=] { m_frameTimer.start(delay); }, Qt::QueuedConnection);
+}
+
+void RefreshScheduler::frame() {
+  HostTrace::Scope traceScope("refreshFrame", "gui");
+  QElapsedTimer elapsed;
+  elapsed.start();
+  std::unique_lock<std::mutex> lock(m_lock);
+  m_framePending = false;
+  m_sinceLastFrame.start();
+  const qint64 budgetMs = m_frameIntervalMs * s_frameBudget;
+
+  const unsigned nClients = m_clients.size();
+  for (unsigned i = 0; i < nClients; ++i) {
+    const unsigned idx = (m_next + i) % nClients;
+    auto &client = m_clients[idx];
+    if (!client.dirty || !client.refreshable())
+      continue;
+    client.dirty = false;
+    // Refreshing may add or mark clients, so the lock is released meanwhile.
+    const auto refresh = client.refresh;
+    lock.unlock();
+    refresh();
+    lock.lock();
+    if (elapsed.elapsed() >= budgetMs) {
+      // Out of budget; the remaining clients are refreshed first next frame.
+      m_next = (idx + 1) % nClients;
+      break;
+    }
+  }
+
+  // Dirty clients which are hidden are scheduled once they are shown.
+  const bool dirty =
+      std::any_of(m_clients.begin(), m_clients.end(), [](const Client &client) {
+        return client.dirty && client.refreshable();
+      });
+  if (dirty)
+    scheduleFrame();
+}
+
+} // namespace Ripes
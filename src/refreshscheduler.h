@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace Ripes {
+
+/**
+ * @brief The RefreshScheduler class
+ * Paces the refreshes of the views of the processor state (registers, memory,
+ * pipeline stages, ...) to the display frame rate. Views register a refresh
+ * function as a client, and clients are marked dirty whenever the state they
+ * display changes. Dirty clients are refreshed together upon the next frame,
+ * such that a view is refreshed at most once per frame, no matter how many
+ * state changes occurred in between.
+ *
+ * A frame only spends a budget of its interval refreshing clients; clients
+ * which did not fit within the budget are refreshed first upon the following
+ * frame. This bounds the time spent redrawing when the processor is clocked at
+ * high rates, leaving the remainder of each frame to simulation.
+ *
+ * Clients whose context is a hidden widget, ie. a view in an inactive tab, are
+ * not refreshed while hidden; they remain dirty and are refreshed upon the
+ * first frame after the widget is shown.
+ *
+ * Clients may be marked dirty from any thread; refreshes are executed in the
+ * thread of the scheduler.
+ */
+class RefreshScheduler : public QObject {
+  Q_OBJECT
+public:
+  using ClientID = unsigned;
+
+  RefreshScheduler(QObject *parent = nullptr);
+
+  /// Registers @p refresh as a client, which is executed within the lifetime
+  /// of @p context. Clients are initially clean.
+  ClientID addClient(QObject *context, std::function<void()> refresh);
+
+  void markDirty(ClientID id);
+  void markAllDirty();
+
+  /// Sets the frame rate, in frames per second.
+  void setFrameRate(int fps);
+
+  /// Fraction of each frame interval which may be spent refreshing clients.
+  static constexpr double s_frameBudget = 0.5;
+
+protected:
+  bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+  struct Client {
+    QPointer<QObject> context;
+    std::function<void()> refresh;
+    bool dirty = false;
+
+    /// Returns true if the client may be refreshed; ie. its context is alive
+    /// and not a hidden widget.
+    bool refreshable() const;
+  };
+
+  /// Schedules a frame at the next frame boundary, if none is pending. Must be
+  /// called with m_lock held.
+  void scheduleFrame();
+  void frame();
+
+  std::vector<Client> m_clients;
+  // Index of the client which is refreshed first upon the next frame.
+  unsigned m_next = 0;
+  bool m_framePending = false;
+  std::mutex m_lock;
+
+  int m_frameIntervalMs = 0;
+  QTimer m_frameTimer;
+  QElapsedTimer m_sinceLastFrame;
+};
+
+} // namespace Ripes
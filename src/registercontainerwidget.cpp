@@ -9,8 +9,8 @@ namespace Ripes {
 RegisterContainerWidget::RegisterContainerWidget(QWidget *parent)
     : QWidget(parent), m_ui(new Ui::RegisterContainerWidget) {
   m_ui->setupUi(this);
-  connect(ProcessorHandler::get(), &ProcessorHandler::procStateChangedNonRun,
-          this, &RegisterContainerWidget::updateView);
+  ProcessorHandler::getRefreshScheduler().addClient(this,
+                                                    [=] { updateView(); });
   connect(ProcessorHandler::get(), &ProcessorHandler::processorChanged, this,
           &RegisterContainerWidget::initialize);
   initialize();
@@ -2,7 +2,6 @@
 
 #include <QHeaderView>
 
-#include "STLExtras.h"
 #include "fonts.h"
 #include "processorhandler.h"
 
@@ -12,37 +11,57 @@ using namespace vsrtl;
 
 RegisterModel::RegisterModel(RegisterFileType rft, QObject *parent)
     : QAbstractTableModel(parent), m_rft(rft) {
-  m_regBytes = ProcessorHandler::getProcessor()->implementsISA()->bytes();
-}
-
-std::vector<VInt> RegisterModel::gatherRegisterValues() {
-  std::vector<VInt> vals;
-  for (int i = 0; i < rowCount(); ++i)
-    vals.push_back(ProcessorHandler::getRegisterValue(m_rft, i));
-  return vals;
+  const auto *isa = ProcessorHandler::getProcessor()->implementsISA();
+  m_regBytes = m_rft == RegisterFileType::FPR ? isa->fpBits() / CHAR_BIT
+                                              : isa->bytes();
 }
 
 int RegisterModel::columnCount(const QModelIndex &) const { return NColumns; }
 
 int RegisterModel::rowCount(const QModelIndex &) const {
-  return ProcessorHandler::currentISA()->regCnt();
+  const auto *isa = ProcessorHandler::currentISA();
+  return m_rft == RegisterFileType::FPR ? isa->fpRegCnt() : isa->regCnt();
 }
 
 void RegisterModel::processorWasClocked() {
-  // Reload model
-  beginResetModel();
-  endResetModel();
-  const auto newRegValues = gatherRegisterValues();
-  if (m_regValues.size() != 0) {
-    for (auto newRegVal : llvm::enumerate(newRegValues)) {
-      if (m_regValues[newRegVal.index()] != newRegVal.value()) {
-        m_mostRecentlyModifiedReg = newRegVal.index();
-        emit registerChanged(newRegVal.index());
-        break;
-      }
+  const RegisterView regs = ProcessorHandler::getRegisterView(m_rft);
+  if (regs.size() != m_regValues.size()) {
+    // No previous snapshot to compare against.
+    m_regValues.resize(regs.size());
+    for (unsigned i = 0; i < regs.size(); ++i)
+      m_regValues[i] = regs[i];
+    beginResetModel();
+    endResetModel();
+    return;
+  }
+
+  // Only the runs of rows whose registers changed are refreshed. The most
+  // recently modified register is the first register which changed.
+  const int previouslyModifiedReg = m_mostRecentlyModifiedReg;
+  bool modified = false;
+  int runStart = -1;
+  for (unsigned i = 0; i <= m_regValues.size(); ++i) {
+    const bool changed = i < m_regValues.size() && m_regValues[i] != regs[i];
+    if (changed)
+      m_regValues[i] = regs[i];
+    if (changed && !modified) {
+      modified = true;
+      m_mostRecentlyModifiedReg = i;
+      emit registerChanged(i);
+    }
+    if (changed && runStart < 0) {
+      runStart = i;
+    } else if (!changed && runStart >= 0) {
+      emit dataChanged(index(runStart, 0), index(i - 1, NColumns - 1));
+      runStart = -1;
     }
   }
-  m_regValues = newRegValues;
+  if (previouslyModifiedReg >= 0 &&
+      previouslyModifiedReg != m_mostRecentlyModifiedReg) {
+    // Clear the highlight of the previously modified register.
+    emit dataChanged(index(previouslyModifiedReg, 0),
+                     index(previouslyModifiedReg, NColumns - 1));
+  }
 }
 
 bool RegisterModel::setData(const QModelIndex &index, const QVariant &value,
@@ -53,6 +72,8 @@ bool RegisterModel::setData(const QModelIndex &index, const QVariant &value,
     VInt v = decodeRadixValue(value.toString(), m_radix, &ok);
     if (ok) {
       ProcessorHandler::setRegisterValue(m_rft, i, v);
+      if (i < static_cast<int>(m_regValues.size()))
+        m_regValues[i] = ProcessorHandler::getRegisterValue(m_rft, i);
       emit dataChanged(index, index);
       return true;
     }
@@ -123,30 +144,42 @@ QVariant RegisterModel::data(const QModelIndex &index, int role) const {
 
 void RegisterModel::setRadix(Ripes::Radix r) {
   m_radix = r;
-  processorWasClocked();
+  if (rowCount() > 0)
+    emit dataChanged(index(0, Column::Value),
+                     index(rowCount() - 1, Column::Value));
 }
 
 QVariant RegisterModel::nameData(unsigned idx) const {
-  return ProcessorHandler::currentISA()->regName(idx);
+  const auto *isa = ProcessorHandler::currentISA();
+  return m_rft == RegisterFileType::FPR ? isa->fpRegName(idx)
+                                        : isa->regName(idx);
 }
 
 QVariant RegisterModel::aliasData(unsigned idx) const {
-  return ProcessorHandler::currentISA()->regAlias(idx);
+  const auto *isa = ProcessorHandler::currentISA();
+  return m_rft == RegisterFileType::FPR ? isa->fpRegAlias(idx)
+                                        : isa->regAlias(idx);
 }
 
 QVariant RegisterModel::tooltipData(unsigned idx) const {
-  return ProcessorHandler::currentISA()->regInfo(idx);
+  const auto *isa = ProcessorHandler::currentISA();
+  return m_rft == RegisterFileType::FPR ? isa->fpRegInfo(idx)
+                                        : isa->regInfo(idx);
 }
 
 QVariant RegisterModel::valueData(unsigned idx) const {
-  return encodeRadixValue(ProcessorHandler::getRegisterValue(m_rft, idx),
-                          m_radix, m_regBytes);
+  const VInt value = idx < m_regValues.size()
+                         ? m_regValues[idx]
+                         : ProcessorHandler::getRegisterValue(m_rft, idx);
+  return encodeRadixValue(value, m_radix, m_regBytes);
 }
 
 Qt::ItemFlags RegisterModel::flags(const QModelIndex &index) const {
-  const auto def = ProcessorHandler::currentISA()->regIsReadOnly(index.row())
-                       ? Qt::NoItemFlags
-                       : Qt::ItemIsEnabled;
+  // All floating-point registers are writable.
+  const bool readOnly =
+      m_rft != RegisterFileType::FPR &&
+      ProcessorHandler::currentISA()->regIsReadOnly(index.row());
+  const auto def = readOnly ? Qt::NoItemFlags : Qt::ItemIsEnabled;
   if (index.column() == Column::Value)
     return Qt::ItemIsEditable | def;
   return def;
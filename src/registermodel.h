@@ -42,8 +42,6 @@ signals:
   void registerChanged(unsigned i);
 
 private:
-  std::vector<VInt> gatherRegisterValues();
-
   QVariant nameData(unsigned idx) const;
   QVariant aliasData(unsigned idx) const;
   QVariant valueData(unsigned idx) const;
@@ -54,6 +52,7 @@ private:
   RegisterFileType m_rft;
 
   int m_mostRecentlyModifiedReg = -1;
+  // Snapshot of the register file at the last refresh, which is displayed.
   std::vector<VInt> m_regValues;
 };
 } // namespace Ripes
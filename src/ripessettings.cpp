@@ -22,6 +22,8 @@ const std::map<QString, QVariant> s_defaultSettings = {
     {RIPES_SETTING_CONSOLEECHO, "true"},
     {RIPES_SETTING_CONSOLEBG, QColorConstants::White},
     {RIPES_SETTING_CONSOLEFONTCOLOR, QColorConstants::Black},
+    {RIPES_SETTING_CONSOLEMAXLINES, 1000},
+    {RIPES_SETTING_CONSOLELOGFILE, ""},
     {RIPES_SETTING_CONSOLEFONT,
      QVariant() /* Let Console define its own default font */},
     {RIPES_SETTING_CONSOLEFONT, QColorConstants::Black},
@@ -35,10 +37,22 @@ const std::map<QString, QVariant> s_defaultSettings = {
     {RIPES_SETTING_EDITORREGS, true},
     {RIPES_SETTING_EDITORCONSOLE, true},
     {RIPES_SETTING_EDITORSTAGEHIGHLIGHTING, true},
+    {RIPES_SETTING_EDITORHEATMAP, false},
+    {RIPES_SETTING_EDITORHAZARDS, false},
 
     {RIPES_SETTING_PIPEDIAGRAM_MAXCYCLES, 100},
     {RIPES_SETTING_CACHE_MAXCYCLES, 10000},
     {RIPES_SETTING_CACHE_MAXPOINTS, 1000},
+    {RIPES_SETTING_CACHE_TIMING, false},
+    {RIPES_SETTING_VIRTUAL_CLOCK, 0},
+    {RIPES_SETTING_RUN_PACE, 0},
+    {RIPES_SETTING_SYSCALL_NEWLIB, false},
+    {RIPES_SETTING_BRANCH_PREDICTOR, 0},
+    {RIPES_SETTING_MUL_LATENCY, 1},
+    {RIPES_SETTING_DIV_LATENCY, 1},
+    {RIPES_SETTING_HART_QUANTUM, 1},
+    {RIPES_SETTING_VLEN, 128},
+    {RIPES_SETTING_NONSERIALIZING_ECALLS, false},
     {RIPES_SETTING_CACHE_PRESETS,
      QVariant::fromValue<QList<CachePreset>>(
          {CachePreset{"32-entry 4-word direct-mapped", 2, 5, 0,
@@ -69,6 +83,7 @@ const std::map<QString, QVariant> s_defaultSettings = {
     {RIPES_SETTING_SHOWSIGNALS, false},
     {RIPES_SETTING_INPUT_TYPE, static_cast<unsigned>(SourceType::Assembly)},
     {RIPES_SETTING_AUTOCLOCK_INTERVAL, 100},
+    {RIPES_SETTING_AUTOCLOCK_CYCLES, 1},
 
     {RIPES_SETTING_HAS_SAVEFILE, false},
     {RIPES_SETTING_SAVEPATH, ""},
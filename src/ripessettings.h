@@ -4,6 +4,8 @@
 #include <QFont>
 #include <QSettings>
 
+#include <atomic>
+
 namespace Ripes {
 
 // =========== Definitions of the name of all settings within Ripes ============
@@ -19,6 +21,8 @@ namespace Ripes {
 #define RIPES_SETTING_CONSOLEBG ("console_bg_color")
 #define RIPES_SETTING_CONSOLEFONTCOLOR ("console_font_color")
 #define RIPES_SETTING_CONSOLEFONT ("console_font")
+#define RIPES_SETTING_CONSOLEMAXLINES ("console_max_lines")
+#define RIPES_SETTING_CONSOLELOGFILE ("console_log_file")
 #define RIPES_SETTING_INDENTAMT ("editor_indent")
 #define RIPES_SETTING_UIUPDATEPS ("ui_update_ps")
 
@@ -31,7 +35,17 @@ namespace Ripes {
 #define RIPES_SETTING_CACHE_MAXCYCLES ("cacheplot_maxcycles")
 #define RIPES_SETTING_CACHE_MAXPOINTS ("cacheplot_maxpoints")
 #define RIPES_SETTING_CACHE_PRESETS ("cache_presets")
+#define RIPES_SETTING_CACHE_TIMING ("cache_timing")
 #define RIPES_SETTING_PERIPHERAL_SETTINGS ("peripheral_settings")
+#define RIPES_SETTING_VIRTUAL_CLOCK ("virtual_clock_hz")
+#define RIPES_SETTING_RUN_PACE ("run_pace_hz")
+#define RIPES_SETTING_SYSCALL_NEWLIB ("syscall_newlib")
+#define RIPES_SETTING_BRANCH_PREDICTOR ("branch_predictor")
+#define RIPES_SETTING_MUL_LATENCY ("mul_latency")
+#define RIPES_SETTING_DIV_LATENCY ("div_latency")
+#define RIPES_SETTING_HART_QUANTUM ("hart_quantum")
+#define RIPES_SETTING_VLEN ("vlen")
+#define RIPES_SETTING_NONSERIALIZING_ECALLS ("nonserializing_ecalls")
 
 // This is not really a setting, but instead a method to leverage the static
 // observer objects that are generated for a setting. Used for other objects to
@@ -51,9 +65,12 @@ namespace Ripes {
 #define RIPES_SETTING_DARKMODE ("darkmode")
 #define RIPES_SETTING_SHOWSIGNALS ("show_signals")
 #define RIPES_SETTING_AUTOCLOCK_INTERVAL ("autoclock_interval")
+#define RIPES_SETTING_AUTOCLOCK_CYCLES ("autoclock_cycles")
 #define RIPES_SETTING_EDITORREGS ("editor_regs")
 #define RIPES_SETTING_EDITORCONSOLE ("editor_console")
 #define RIPES_SETTING_EDITORSTAGEHIGHLIGHTING ("editor_stage_highlighting")
+#define RIPES_SETTING_EDITORHEATMAP ("editor_heat_map")
+#define RIPES_SETTING_EDITORHAZARDS ("editor_hazards")
 
 #define RIPES_SETTING_HAS_SAVEFILE ("has_savefile")
 #define RIPES_SETTING_SAVEPATH ("savepath")
@@ -95,6 +112,32 @@ private:
   QString m_key;
 };
 
+// ================ Typed settings read on hot paths in Ripes ==================
+enum class SettingId {
+  UIUpdatePS,
+  PipelineDiagramMaxCycles,
+  CacheMaxPoints,
+  EditorStageHighlighting
+};
+
+/// The key and value type of each setting which may be read through
+/// RipesSettings::cached.
+template <SettingId Id>
+struct SettingTraits;
+#define RIPES_CACHED_SETTING(ID, TYPE, KEY)                                    \
+  template <>                                                                  \
+  struct SettingTraits<SettingId::ID> {                                        \
+    using Type = TYPE;                                                         \
+    static constexpr const char *key = KEY;                                    \
+  };
+RIPES_CACHED_SETTING(UIUpdatePS, int, RIPES_SETTING_UIUPDATEPS)
+RIPES_CACHED_SETTING(PipelineDiagramMaxCycles, int,
+                     RIPES_SETTING_PIPEDIAGRAM_MAXCYCLES)
+RIPES_CACHED_SETTING(CacheMaxPoints, int, RIPES_SETTING_CACHE_MAXPOINTS)
+RIPES_CACHED_SETTING(EditorStageHighlighting, bool,
+                     RIPES_SETTING_EDITORSTAGEHIGHLIGHTING)
+#undef RIPES_CACHED_SETTING
+
 class RipesSettings : public QSettings {
 public:
   static void setValue(const QString &key, const QVariant &value);
@@ -103,6 +146,17 @@ public:
     return get().m_observers.at(key).value<T>();
   }
 
+  /**
+   * @brief cached
+   * Returns the value of the setting @p Id. The value is kept in a plain
+   * field, which the observer of the setting updates upon each modification,
+   * such that reading it involves neither a lookup of the key nor a QSettings
+   * or QVariant conversion. Intended for settings read on every cycle or
+   * frame; values may be read from any thread.
+   */
+  template <SettingId Id>
+  static typename SettingTraits<Id>::Type cached();
+
   static bool hasSetting(const QString &key) {
     return get().m_observers.count(key) != 0;
   }
@@ -124,4 +178,23 @@ private:
   std::map<QString, SettingObserver> m_observers;
 };
 
+template <SettingId Id>
+typename SettingTraits<Id>::Type RipesSettings::cached() {
+  using Type = typename SettingTraits<Id>::Type;
+  struct Cache {
+    Cache() {
+      SettingObserver *observer = getObserver(SettingTraits<Id>::key);
+      value = observer->value<Type>();
+      QObject::connect(observer, &SettingObserver::modified,
+                       [this](const QVariant &v) {
+                         value.store(v.value<Type>(),
+                                     std::memory_order_relaxed);
+                       });
+    }
+    std::atomic<Type> value;
+  };
+  static Cache s_cache;
+  return s_cache.value.load(std::memory_order_relaxed);
+}
+
 } // namespace Ripes
@@ -0,0 +1,203 @@
+#include "session.h"
+
+#include "cli/programutilities.h"
+
+#include <QDataStream>
+#include <QSaveFile>
+
+#include <cstdint>
+
+namespace Ripes {
+
+static constexpr quint32 s_sessionMagic = 0x52534553; // "RSES"
+static constexpr quint32 s_sessionVersion = 1;
+
+// Size of the fixed part of the header: magic, version and header size.
+static constexpr qint64 s_fixedHeaderBytes = 16;
+// Section contents are aligned to this many bytes within the file.
+static constexpr qint64 s_sectionAlignment = 8;
+
+static qint64 alignSection(qint64 offset) {
+  return (offset + s_sectionAlignment - 1) & ~(s_sectionAlignment - 1);
+}
+
+QString saveSession(const QString &filepath, const Session &session) {
+  if (!session.program)
+    return "Error: No program to save";
+  const Program &program = *session.program;
+
+  QByteArray header;
+  QDataStream out(&header, QIODevice::WriteOnly);
+  out << static_cast<qint32>(session.processor) << session.extensions;
+  out << static_cast<qint32>(session.sourceType) << session.source;
+  out << static_cast<quint64>(program.entryPoint) << program.sourceHash;
+
+  // Sections, by their offset from the start of the section contents
+  out << static_cast<quint32>(program.sections.size());
+  qint64 offset = 0;
+  for (const auto &it : program.sections) {
+    const ProgramSection &section = it.second;
+    out << section.name << static_cast<quint64>(section.address)
+        << static_cast<quint64>(offset)
+        << static_cast<quint64>(section.data.size());
+    offset = alignSection(offset + section.data.size());
+  }
+
+  out << static_cast<quint32>(program.symbols.size());
+  for (const auto &it : program.symbols)
+    out << static_cast<quint64>(it.first) << it.second.v
+        << static_cast<quint32>(it.second.type);
+
+  out << static_cast<quint32>(program.sourceMapping.size());
+  for (const auto &it : program.sourceMapping) {
+    QList<quint32> lines;
+    for (const auto line : it.second)
+      lines << line;
+    out << static_cast<quint64>(it.first) << lines;
+  }
+
+  // The instruction layout is stored as the address of the first instruction
+  // and the size of each instruction. Layouts with gaps which do not fit a
+  // byte are not stored, but laid out anew upon loading.
+  const auto &addresses = program.getDisassembled().addresses();
+  QByteArray sizes;
+  quint32 nInstructions = addresses.size();
+  for (unsigned i = 1; i < addresses.size(); ++i) {
+    const VInt size = addresses[i] - addresses[i - 1];
+    if (size > UINT8_MAX) {
+      nInstructions = 0;
+      sizes.clear();
+      break;
+    }
+    sizes.append(static_cast<char>(size));
+  }
+  out << nInstructions
+      << static_cast<quint64>(nInstructions != 0 ? addresses.front() : 0)
+      << sizes;
+
+  out << static_cast<quint32>(session.caches.size());
+  for (const auto &preset : session.caches)
+    out << preset;
+
+  out << session.checkpoint;
+
+  // Written through a QSaveFile, such that a session is never left partially
+  // written.
+  QSaveFile file(filepath);
+  if (!file.open(QIODevice::WriteOnly))
+    return "Error: Could not open session file " + filepath;
+  {
+    QDataStream fileStream(&file);
+    fileStream << s_sessionMagic << s_sessionVersion
+               << static_cast<quint64>(header.size());
+  }
+  file.write(header);
+  for (const auto &it : program.sections) {
+    const QByteArray &data = it.second.data;
+    file.write(QByteArray(alignSection(file.pos()) - file.pos(), '\0'));
+    file.write(data);
+  }
+  if (!file.commit())
+    return "Error: Could not write session file " + filepath;
+  return QString();
+}
+
+QString loadSession(const QString &filepath, Session &session) {
+  session = Session();
+  auto program = std::make_shared<Program>();
+
+  QString err;
+  qint64 fileSize = 0;
+  const char *mapped = mapProgramFile(*program, filepath, fileSize, err);
+  if (!mapped)
+    return err;
+  if (fileSize < s_fixedHeaderBytes)
+    return "Error: " + filepath + " is not a Ripes session";
+
+  QDataStream fixedHeader(mappedData(mapped, 0, s_fixedHeaderBytes));
+  quint32 magic, version;
+  quint64 headerSize;
+  fixedHeader >> magic >> version >> headerSize;
+  if (magic != s_sessionMagic)
+    return "Error: " + filepath + " is not a Ripes session";
+  if (version != s_sessionVersion)
+    return "Error: Unsupported session version " + QString::number(version);
+  if (headerSize > quint64(fileSize - s_fixedHeaderBytes))
+    return "Error: Session file " + filepath + " is corrupt";
+
+  QDataStream in(mappedData(mapped, s_fixedHeaderBytes, headerSize));
+  qint32 processor, sourceType;
+  in >> processor >> session.extensions >> sourceType >> session.source;
+  session.processor = static_cast<ProcessorID>(processor);
+  session.sourceType = static_cast<SourceType>(sourceType);
+
+  quint64 entryPoint;
+  in >> entryPoint >> program->sourceHash;
+  program->entryPoint = entryPoint;
+
+  const qint64 contentStart = alignSection(s_fixedHeaderBytes + headerSize);
+  quint32 nSections;
+  in >> nSections;
+  for (quint32 i = 0; i < nSections && in.status() == QDataStream::Ok; ++i) {
+    ProgramSection section;
+    quint64 address, offset, size;
+    in >> section.name >> address >> offset >> size;
+    if (contentStart > fileSize || offset > quint64(fileSize - contentStart) ||
+        size > quint64(fileSize - contentStart) - offset)
+      return "Error: Session file " + filepath + " is corrupt";
+    section.address = address;
+    section.data = mappedData(mapped, contentStart + offset, size);
+    program->sections[section.name] = section;
+  }
+
+  quint32 nSymbols;
+  in >> nSymbols;
+  for (quint32 i = 0; i < nSymbols && in.status() == QDataStream::Ok; ++i) {
+    quint64 address;
+    Symbol symbol;
+    quint32 type;
+    in >> address >> symbol.v >> type;
+    symbol.type = type;
+    program->symbols[address] = symbol;
+  }
+
+  quint32 nMappings;
+  in >> nMappings;
+  for (quint32 i = 0; i < nMappings && in.status() == QDataStream::Ok; ++i) {
+    quint64 address;
+    QList<quint32> lines;
+    in >> address >> lines;
+    program->sourceMapping[address] =
+        std::set<unsigned>(lines.begin(), lines.end());
+  }
+
+  quint32 nInstructions;
+  quint64 layoutStart;
+  QByteArray sizes;
+  in >> nInstructions >> layoutStart >> sizes;
+  if (nInstructions != 0 && quint32(sizes.size()) == nInstructions - 1) {
+    std::vector<VInt> addresses;
+    addresses.reserve(nInstructions);
+    addresses.push_back(layoutStart);
+    for (const char size : sizes)
+      addresses.push_back(addresses.back() + static_cast<uint8_t>(size));
+    program->setInstructionLayout(std::move(addresses));
+  }
+
+  quint32 nCaches;
+  in >> nCaches;
+  for (quint32 i = 0; i < nCaches && in.status() == QDataStream::Ok; ++i) {
+    CachePreset preset;
+    in >> preset;
+    session.caches.push_back(preset);
+  }
+
+  in >> session.checkpoint;
+  if (in.status() != QDataStream::Ok)
+    return "Error: Session file " + filepath + " is corrupt";
+
+  session.program = program;
+  return QString();
+}
+
+} // namespace Ripes
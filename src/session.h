@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+#include <vector>
+
+#include "assembler/program.h"
+#include "cachesim/cachesim.h"
+#include "processorregistry.h"
+
+namespace Ripes {
+
+/**
+ * Sessions store a program along with the configuration of the simulator in a
+ * binary file, such that reopening the session requires neither reassembly nor
+ * recompilation of the program.
+ *
+ * A session contains:
+ * - The processor model and its enabled ISA extensions.
+ * - The source type of the program, and its source text if it was assembled or
+ *   compiled from within Ripes.
+ * - The program: its entry point, sections, symbols, source mapping and the
+ *   layout of the instructions of its text section (the disassembly index).
+ * - The configuration of the L1 caches.
+ * - Optionally, a checkpoint of the processor state (see checkpoint.h).
+ *
+ * The contents of the sections are stored uncompressed following the header,
+ * such that loading a session memory maps the file and reads the header; the
+ * sections of the program reference the mapped file in place. The source lines
+ * of the debug information of an ELF file are not stored.
+ */
+struct Session {
+  ProcessorID processor;
+  QStringList extensions;
+
+  SourceType sourceType = SourceType::Assembly;
+  QString source;
+  std::shared_ptr<Program> program;
+
+  // The configurations of the L1 data and instruction caches, in that order.
+  std::vector<CachePreset> caches;
+
+  // A checkpoint, as returned by checkpointData(), or empty.
+  QByteArray checkpoint;
+};
+
+/// Writes @p session to @p filepath. Returns an error message on failure, or
+/// an empty string on success.
+QString saveSession(const QString &filepath, const Session &session);
+
+/// Loads the session at @p filepath into @p session. Returns an error message
+/// on failure, or an empty string on success.
+QString loadSession(const QString &filepath, Session &session);
+
+} // namespace Ripes
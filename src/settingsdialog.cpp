@@ -3,10 +3,12 @@
 
 #include "ccmanager.h"
 #include "formattermanager.h"
+#include "processors/interface/ripesprocessor.h"
 #include "ripessettings.h"
 
 #include <QCheckBox>
 #include <QColorDialog>
+#include <QComboBox>
 #include <QFileDialog>
 #include <QFontDialog>
 #include <QGroupBox>
@@ -38,7 +40,8 @@ std::pair<QWidget *, QGridLayout *> constructPage() {
 
 template <typename T_TriggerWidget, typename T_EditWidget = T_TriggerWidget>
 std::pair<QLabel *, T_TriggerWidget *>
-createSettingsWidgets(const QString &settingName, const QString &labelText) {
+createSettingsWidgets(const QString &settingName, const QString &labelText,
+                      const QStringList &items = {}) {
   auto *label = new QLabel(labelText);
   auto f = label->font();
   f.setBold(true);
@@ -73,6 +76,13 @@ createSettingsWidgets(const QString &settingName, const QString &labelText) {
     widget->connect(widget, &QCheckBox::toggled, settingObserver,
                     &SettingObserver::setValue);
     widget->setChecked(settingObserver->value().toBool());
+  } else if constexpr (std::is_same<T_EditWidget, QComboBox>()) {
+    // The setting holds the index of the selected item of @p items.
+    widget->addItems(items);
+    widget->setCurrentIndex(settingObserver->value().toInt());
+    widget->connect(widget, QOverload<int>::of(&QComboBox::currentIndexChanged),
+                    settingObserver, &SettingObserver::setValue);
+    widget->installEventFilter(new ScrollEventFilter());
   } else if constexpr (std::is_same<T_EditWidget, QColorDialog>()) {
     // Create a QPushButton which will trigger a QColorWidget when clicked.
     // Changes in the color settings will trigger a change in the pushbutton
@@ -307,6 +317,100 @@ QWidget *SettingsDialog::createSimulatorPage() {
   appendToLayout({rewindLabel, rewindSpinbox}, pageLayout,
                  "Maximum cycles that the simulator is able to undo.");
 
+  auto [clockLabel, clockSpinbox] = createSettingsWidgets<QSpinBox>(
+      RIPES_SETTING_VIRTUAL_CLOCK, "Virtual clock (Hz):");
+  clockSpinbox->setRange(0, INT_MAX);
+  clockSpinbox->setSpecialValueText("Host wall clock");
+  appendToLayout({clockLabel, clockSpinbox}, pageLayout,
+                 "If set, the time seen by programs (ie. the Time_msec system "
+                 "call) is derived from the cycle count at this simulated "
+                 "clock frequency, counting from the epoch at cycle 0, rather "
+                 "than read from the wall clock of the host. Timing "
+                 "measurements of programs then do not depend on the speed of "
+                 "the simulator.");
+
+  auto [paceLabel, paceSpinbox] = createSettingsWidgets<QSpinBox>(
+      RIPES_SETTING_RUN_PACE, "Paced run (Hz):");
+  paceSpinbox->setRange(0, INT_MAX);
+  paceSpinbox->setSpecialValueText("Unpaced");
+  appendToLayout({paceLabel, paceSpinbox}, pageLayout,
+                 "If set, running the processor executes cycles at this "
+                 "simulated clock frequency rather than as fast as possible, "
+                 "ie. to watch peripherals react in real time. The achieved "
+                 "frequency is shown once the run stops.");
+
+  auto [newlibLabel, newlibCheckbox] = createSettingsWidgets<QCheckBox>(
+      RIPES_SETTING_SYSCALL_NEWLIB, "Newlib system calls");
+  appendToLayout({newlibLabel, newlibCheckbox}, pageLayout,
+                 "Execute programs with the Linux system calls issued by "
+                 "newlib (openat, fstat, brk, gettimeofday, clock_gettime, "
+                 "times...) rather than with the RARS system calls (print, "
+                 "exit...), such that programs built with a RISC-V newlib "
+                 "toolchain run unmodified. The processor is reset when this "
+                 "setting is changed.");
+
+  appendToLayout(
+      createSettingsWidgets<QComboBox>(
+          RIPES_SETTING_BRANCH_PREDICTOR, "Branch predictor:",
+          {"Not taken", "BTFN", "Bimodal", "Gshare"}),
+      pageLayout,
+      "Branch predictor of the fetch stage of the processor models which "
+      "implement branch prediction (ie. the superscalar and out-of-order "
+      "models). BTFN statically predicts backward branches taken and forward "
+      "branches not taken. The bimodal and gshare predictors predict branch "
+      "directions with 2-bit saturating counters, indexed by the PC or by the "
+      "PC xor the global branch history, and read their targets from a branch "
+      "target buffer and a return address stack. The processor is reset when "
+      "this setting is changed.");
+
+  auto [mulLabel, mulSpinbox] = createSettingsWidgets<QSpinBox>(
+      RIPES_SETTING_MUL_LATENCY, "Multiplication latency:");
+  mulSpinbox->setRange(1, RipesProcessor::MExtTiming::s_maxLatency);
+  appendToLayout({mulLabel, mulSpinbox}, pageLayout,
+                 "Cycles spent executing M-extension multiplications. "
+                 "Multiplications are pipelined, stalling only instructions "
+                 "which depend on their results, in the processors with "
+                 "forwarding and hazard detection; the other processors stall "
+                 "for the full latency. The processor is reset when this "
+                 "setting is changed.");
+
+  auto [divLabel, divSpinbox] = createSettingsWidgets<QSpinBox>(
+      RIPES_SETTING_DIV_LATENCY, "Division latency:");
+  divSpinbox->setRange(1, RipesProcessor::MExtTiming::s_maxLatency);
+  appendToLayout({divLabel, divSpinbox}, pageLayout,
+                 "Cycles spent executing M-extension divisions and "
+                 "remainders. The divider is iterative, stalling the "
+                 "processor for the full latency (the out-of-order processors "
+                 "only stall subsequent divisions). The processor is reset "
+                 "when this setting is changed.");
+
+  auto [quantumLabel, quantumSpinbox] = createSettingsWidgets<QSpinBox>(
+      RIPES_SETTING_HART_QUANTUM, "Hart quantum (cycles):");
+  quantumSpinbox->setRange(1, INT_MAX);
+  appendToLayout({quantumLabel, quantumSpinbox}, pageLayout,
+                 "Cycles which the harts of the multi-hart processors execute "
+                 "in between synchronizing. With a quantum of 1, the harts "
+                 "execute in lockstep, one instruction each per cycle. With "
+                 "larger quanta, the harts execute concurrently on host "
+                 "threads, and each clock executes a full quantum.");
+
+  auto [vlenLabel, vlenSpinbox] =
+      createSettingsWidgets<QSpinBox>(RIPES_SETTING_VLEN, "VLEN (bits):");
+  vlenSpinbox->setRange(RipesProcessor::s_minVLEN, RipesProcessor::s_maxVLEN);
+  appendToLayout({vlenLabel, vlenSpinbox}, pageLayout,
+                 "Width of the vector registers of processors implementing "
+                 "the V extension. Widths are rounded down to a power of two. "
+                 "The processor is reset when this setting is changed.");
+
+  appendToLayout(
+      createSettingsWidgets<QCheckBox>(RIPES_SETTING_NONSERIALIZING_ECALLS,
+                                       "Non-serializing print ecalls"),
+      pageLayout,
+      "Handle the ecalls of the print syscalls without first draining the "
+      "outstanding register writes of the pipelined processors. The arguments "
+      "of the syscall are read through the writes in flight instead. Ecalls "
+      "still drain if a load or store is outstanding.");
+
   appendToLayout(createSettingsWidgets<HexSpinBox>(
                      RIPES_SETTING_PERIPHERALS_START, "I/O start address:"),
                  pageLayout,
@@ -345,6 +449,24 @@ QWidget *SettingsDialog::createEditorPage() {
       "Show (or hide) highlighting of processor stages in the program source "
       "code.");
 
+  auto [editorHeatMapLabel, editorHeatMapCheckbox] =
+      createSettingsWidgets<QCheckBox>(RIPES_SETTING_EDITORHEATMAP,
+                                       "Show cycle heat map in source");
+  appendToLayout({editorHeatMapLabel, editorHeatMapCheckbox}, pageLayout,
+                 "Profile the cycles spent on each line of the program source "
+                 "code, and shade the line numbers by their share of the "
+                 "cycles of the hottest line. The heat map is updated while "
+                 "the processor is not running.");
+
+  auto [editorHazardsLabel, editorHazardsCheckbox] =
+      createSettingsWidgets<QCheckBox>(RIPES_SETTING_EDITORHAZARDS,
+                                       "Annotate predicted hazards in source");
+  appendToLayout({editorHazardsLabel, editorHazardsCheckbox}, pageLayout,
+                 "Annotate each line of the program source code with the "
+                 "pipeline hazard stalls predicted for the current processor, "
+                 "without simulating. Only single-cycle and 5-stage processors "
+                 "are analyzed.");
+
   // ===== Source formatter
   auto *formatterGroupBox = new QGroupBox("Formatter");
   appendToLayout(formatterGroupBox, pageLayout);
@@ -398,14 +520,15 @@ QWidget *SettingsDialog::createEnvironmentPage() {
                  "may reduce performance.");
 
   auto [maxcyclesLabel, maxcyclesSb] = createSettingsWidgets<QSpinBox>(
-      RIPES_SETTING_CACHE_MAXCYCLES, "Max. cache plot cycles");
-  maxcyclesSb->setMinimum(0);
+      RIPES_SETTING_CACHE_MAXCYCLES, "Max. cache plot samples");
+  maxcyclesSb->setMinimum(2);
   maxcyclesSb->setMaximum(INT_MAX);
   appendToLayout(
       {maxcyclesLabel, maxcyclesSb}, pageLayout,
-      "Maximum number of cache cycles to plot. Increasing this may incur "
-      "substantial slowdown for long "
-      "time executing programs, given the number of points to be plotted.");
+      "Maximum number of cache statistics samples to retain for plotting. "
+      "Once exceeded, the resolution of the plot is halved. Increasing this "
+      "increases memory usage and may slow down plotting for long "
+      "time executing programs.");
 
   auto [maxPointsLabel, maxPointsSb] = createSettingsWidgets<QSpinBox>(
       RIPES_SETTING_CACHE_MAXPOINTS, "Min. cache plot points:");
@@ -420,6 +543,15 @@ QWidget *SettingsDialog::createEnvironmentPage() {
                  "real-time plotting regardless of the number of "
                  "simulation cycles.");
 
+  auto [cacheTimingLabel, cacheTimingCheckbox] =
+      createSettingsWidgets<QCheckBox>(RIPES_SETTING_CACHE_TIMING,
+                                       "Stall processor on cache misses");
+  appendToLayout({cacheTimingLabel, cacheTimingCheckbox}, pageLayout,
+                 "Stall the processor for the latency of each access to the "
+                 "L1 caches and the levels below them, as configured in the "
+                 "cache tab. The processor is reset when this setting is "
+                 "changed.");
+
   auto [maxPipeDiagCycLabel, maxPipeDiagCycSb] =
       createSettingsWidgets<QSpinBox>(RIPES_SETTING_PIPEDIAGRAM_MAXCYCLES,
                                       "Max. pipeline diagram cycles:");
@@ -446,6 +578,18 @@ QWidget *SettingsDialog::createEnvironmentPage() {
   appendToLayout(createSettingsWidgets<QPushButton, QColorDialog>(
                      RIPES_SETTING_CONSOLEBG, "Console background color:"),
                  consoleLayout);
+  auto [maxLinesLabel, maxLinesSb] = createSettingsWidgets<QSpinBox>(
+      RIPES_SETTING_CONSOLEMAXLINES, "Console history lines:");
+  maxLinesSb->setMinimum(1);
+  maxLinesSb->setMaximum(1000000);
+  appendToLayout({maxLinesLabel, maxLinesSb}, consoleLayout,
+                 "Number of lines retained by the console. Older lines are "
+                 "discarded.");
+  appendToLayout(createSettingsWidgets<QLineEdit>(RIPES_SETTING_CONSOLELOGFILE,
+                                                  "Console log file:"),
+                 consoleLayout,
+                 "If set, all console output is additionally written to this "
+                 "file, regardless of the console history limit.");
   appendToLayout(consoleGroupBox, pageLayout);
 
   return pageWidget;
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Ripes {
+
+/**
+ * @brief The SimulationWorker class
+ * A persistent thread executing simulation commands (ie. clocking the
+ * processor) in the order they are posted. Commands are executed outside of
+ * the GUI thread, without constructing a new task for each command.
+ */
+class SimulationWorker {
+public:
+  using Command = std::function<void()>;
+
+  SimulationWorker() : m_thread([this] { work(); }) {}
+  ~SimulationWorker() {
+    {
+      std::lock_guard<std::mutex> lock(m_lock);
+      m_quit = true;
+    }
+    m_commandPosted.notify_all();
+    m_thread.join();
+  }
+
+  /// Posts @p command for execution. If @p coalesce is set, the command is
+  /// dropped if a previously posted command has not yet started, such that
+  /// commands posted faster than they execute do not accumulate. Returns
+  /// whether the command was posted.
+  bool post(Command command, bool coalesce = false) {
+    {
+      std::lock_guard<std::mutex> lock(m_lock);
+      if (coalesce && !m_commands.empty())
+        return false;
+      m_commands.push_back(std::move(command));
+    }
+    m_commandPosted.notify_one();
+    return true;
+  }
+
+  /// Blocks until all posted commands have executed. Returns immediately when
+  /// called from a command.
+  void waitForIdle() {
+    if (std::this_thread::get_id() == m_thread.get_id())
+      return;
+    std::unique_lock<std::mutex> lock(m_lock);
+    m_idle.wait(lock, [this] { return m_commands.empty() && !m_executing; });
+  }
+
+private:
+  void work() {
+    std::unique_lock<std::mutex> lock(m_lock);
+    while (true) {
+      m_commandPosted.wait(lock,
+                           [this] { return m_quit || !m_commands.empty(); });
+      if (m_quit)
+        return;
+      Command command = std::move(m_commands.front());
+      m_commands.pop_front();
+      m_executing = true;
+      lock.unlock();
+      command();
+      lock.lock();
+      m_executing = false;
+      if (m_commands.empty())
+        m_idle.notify_all();
+    }
+  }
+
+  std::mutex m_lock;
+  std::condition_variable m_commandPosted;
+  std::condition_variable m_idle;
+  std::deque<Command> m_commands;
+  bool m_executing = false;
+  bool m_quit = false;
+  // Constructed last, once the state of the worker is initialized.
+  std::thread m_thread;
+};
+
+} // namespace Ripes
@@ -0,0 +1,82 @@
+#include "sourcelines.h"
+
+#include "elfio/elfio.hpp"
+#include "libelfin/dwarf/dwarf++.hh"
+
+namespace Ripes {
+
+namespace {
+class ELFIODwarfLoader : public ::dwarf::loader {
+public:
+  ELFIODwarfLoader(ELFIO::elfio &reader) : reader(reader) {}
+
+  const void *load(::dwarf::section_type section, size_t *size_out) override {
+    auto sec = reader.sections[::dwarf::elf::section_type_to_name(section)];
+    if (sec == nullptr)
+      return nullptr;
+    *size_out = sec->get_size();
+    return sec->get_data();
+  }
+
+private:
+  ELFIO::elfio &reader;
+};
+} // namespace
+
+std::shared_ptr<::dwarf::loader> createDwarfLoader(ELFIO::elfio &reader) {
+  return std::make_shared<ELFIODwarfLoader>(reader);
+}
+
+void SourceLineTable::addRow(AInt address, const QString &path,
+                             std::optional<unsigned> line) {
+  if (!line) {
+    // Rows of a sequence may start at the end of the preceding sequence.
+    m_rows.emplace(address, std::nullopt);
+    return;
+  }
+  auto it = m_fileIndices.find(path);
+  if (it == m_fileIndices.end()) {
+    it = m_fileIndices.emplace(path, m_files.size()).first;
+    m_files.push_back(path);
+  }
+  m_rows[address] = Line{it->second, *line};
+}
+
+std::optional<SourceLineTable::Line>
+SourceLineTable::lookup(AInt address) const {
+  auto it = m_rows.upper_bound(address);
+  if (it == m_rows.begin())
+    return std::nullopt;
+  return std::prev(it)->second;
+}
+
+QString loadSourceLines(ELFIO::elfio &reader, SourceLineTable &table,
+                        const SourceLinesProgress &progress) {
+  if (reader.sections[".debug_info"] == nullptr ||
+      reader.sections[".debug_line"] == nullptr)
+    return QString();
+
+  try {
+    ::dwarf::dwarf dw(createDwarfLoader(reader));
+    const auto &units = dw.compilation_units();
+    for (size_t i = 0; i < units.size(); ++i) {
+      if (progress && !progress(i, units.size()))
+        break;
+      for (auto &line : units[i].get_line_table()) {
+        if (line.end_sequence || !line.file) {
+          table.addRow(line.address, QString(), std::nullopt);
+          continue;
+        }
+        table.addRow(line.address, QString::fromStdString(line.file->path),
+                     line.line);
+      }
+    }
+  } catch (::dwarf::format_error &e) {
+    return QString("Could not load debug information: ") + e.what();
+  } catch (...) {
+    return "Could not load debug information";
+  }
+  return QString();
+}
+
+} // namespace Ripes
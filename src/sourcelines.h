@@ -0,0 +1,81 @@
+#pragma once
+
+#include <QString>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "ripes_types.h"
+
+namespace ELFIO {
+class elfio;
+}
+
+namespace dwarf {
+class loader;
+}
+
+namespace Ripes {
+
+/**
+ * @brief The SourceLineTable class
+ * The mapping from instruction addresses to the source lines which they were
+ * compiled from, as given by the DWARF line tables of an executable. A row
+ * covers the addresses up until the following row; rows ending a sequence
+ * cover addresses of no source line.
+ */
+class SourceLineTable {
+public:
+  struct Line {
+    unsigned file = 0;
+    unsigned line = 0;
+
+    bool operator==(const Line &other) const {
+      return file == other.file && line == other.line;
+    }
+    bool operator<(const Line &other) const {
+      return file != other.file ? file < other.file : line < other.line;
+    }
+  };
+
+  /// Adds a row starting at @p address, of source line @p line of the file
+  /// @p path, or of no source line if @p line is not set.
+  void addRow(AInt address, const QString &path, std::optional<unsigned> line);
+
+  /// Returns the source line of the instruction at @p address, if known.
+  std::optional<Line> lookup(AInt address) const;
+  /// Returns the path of the source file of index @p file.
+  const QString &file(unsigned file) const { return m_files.at(file); }
+
+  bool empty() const { return m_rows.empty(); }
+
+private:
+  std::vector<QString> m_files;
+  std::map<QString, unsigned> m_fileIndices;
+  std::map<AInt, std::optional<Line>> m_rows;
+};
+
+/// Returns a loader of the DWARF sections of the ELF file of @p reader, which
+/// must outlive the loader.
+std::shared_ptr<::dwarf::loader> createDwarfLoader(ELFIO::elfio &reader);
+
+/// Called with the number of compilation units loaded, and the total number of
+/// compilation units. Returns false to stop loading.
+using SourceLinesProgress = std::function<bool(size_t loaded, size_t total)>;
+
+/**
+ * @brief loadSourceLines
+ * Loads the line tables of the DWARF information of the ELF file of @p reader
+ * into @p table. Executables without debug information yield an empty table.
+ * If set, @p progress is called before each compilation unit is loaded; if it
+ * stops loading, @p table holds the units loaded so far.
+ * Returns an error message if the debug information is malformed, or an empty
+ * string on success.
+ */
+QString loadSourceLines(ELFIO::elfio &reader, SourceLineTable &table,
+                        const SourceLinesProgress &progress = {});
+
+} // namespace Ripes
@@ -0,0 +1,175 @@
+#include "sourceprofiler.h"
+
+#include "processorhandler.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace Ripes {
+
+namespace {
+/// Returns the misses counted by @p counter since @p last, and updates @p last.
+/// Counters reset after the profiler yield the misses since the reset.
+unsigned long long newMisses(const SourceProfiler::MissCounter &counter,
+                             unsigned long long &last) {
+  if (!counter)
+    return 0;
+  const unsigned long long misses = counter();
+  const unsigned long long delta = misses >= last ? misses - last : misses;
+  last = misses;
+  return delta;
+}
+} // namespace
+
+SourceProfiler::Counters &
+SourceProfiler::Counters::operator+=(const Counters &other) {
+  cycles += other.cycles;
+  retired += other.retired;
+  stalls += other.stalls;
+  icacheMisses += other.icacheMisses;
+  dcacheMisses += other.dcacheMisses;
+  return *this;
+}
+
+SourceProfiler::SourceProfiler(MissCounter icacheMisses,
+                               MissCounter dcacheMisses)
+    : m_icacheMisses(icacheMisses), m_dcacheMisses(dcacheMisses) {
+  reset();
+  ProcessorHandler::attachObserver(this);
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          [this] { reset(); });
+}
+
+SourceProfiler::~SourceProfiler() { ProcessorHandler::detachObserver(this); }
+
+void SourceProfiler::reset() {
+  const auto *isa = ProcessorHandler::currentISA();
+  // Compressed instructions are counted at their own granularity.
+  m_instrBytes = std::max(1u, isa->instrByteAlignment());
+  m_textStart = 0;
+  size_t instructions = 0;
+  if (auto program = ProcessorHandler::getProgram()) {
+    if (auto *text = program->getSection(TEXT_SECTION_NAME)) {
+      m_textStart = text->address;
+      instructions = text->data.size() / m_instrBytes;
+    }
+  }
+  m_counters.assign(instructions, Counters());
+  m_total = Counters();
+
+  const auto *proc = ProcessorHandler::getProcessor();
+  m_finalStages.clear();
+  for (const auto &lane : proc->structure())
+    m_finalStages.push_back({lane.first, lane.second - 1});
+  m_lastCycle = proc->getCycleCount();
+  m_lastRetired = proc->getInstructionsRetired();
+  m_pendingCycles = 0;
+  m_lastICacheMisses = m_icacheMisses ? m_icacheMisses() : 0;
+  m_lastDCacheMisses = m_dcacheMisses ? m_dcacheMisses() : 0;
+}
+
+const SourceProfiler::Counters *SourceProfiler::counters(AInt pc) const {
+  const AInt idx = (pc - m_textStart) / m_instrBytes;
+  if (pc < m_textStart || idx >= m_counters.size())
+    return nullptr;
+  return &m_counters[idx];
+}
+
+SourceProfiler::Counters *SourceProfiler::counters(AInt pc) {
+  return const_cast<Counters *>(std::as_const(*this).counters(pc));
+}
+
+void SourceProfiler::onCycle(const RipesProcessor &proc) {
+  const long long cycle = proc.getCycleCount();
+  if (cycle < m_lastCycle)
+    reset();
+  m_lastCycle = cycle;
+  m_total.cycles++;
+  m_pendingCycles++;
+
+  if (const unsigned long long misses =
+          newMisses(m_icacheMisses, m_lastICacheMisses)) {
+    m_total.icacheMisses += misses;
+    const MemoryAccess fetch = proc.instrMemAccess();
+    if (fetch.type != MemoryAccess::None) {
+      if (auto *c = counters(fetch.address))
+        c->icacheMisses += misses;
+    }
+  }
+  if (const unsigned long long misses =
+          newMisses(m_dcacheMisses, m_lastDCacheMisses)) {
+    m_total.dcacheMisses += misses;
+    if (proc.dataMemAccess().type != MemoryAccess::None) {
+      if (auto *c = counters(proc.dataMemAccessPC()))
+        c->dcacheMisses += misses;
+    }
+  }
+
+  const long long retired = proc.getInstructionsRetired();
+  long long newlyRetired = retired - m_lastRetired;
+  m_lastRetired = retired;
+  if (newlyRetired <= 0)
+    return;
+  m_total.retired += newlyRetired;
+  m_total.stalls += m_pendingCycles - 1;
+
+  for (const auto &stage : m_finalStages) {
+    if (newlyRetired == 0)
+      break;
+    const StageInfo info = proc.stageInfo(stage);
+    if (!info.stage_valid || info.state != StageInfo::State::None)
+      continue;
+    newlyRetired--;
+    if (auto *c = counters(info.pc)) {
+      c->retired++;
+      c->cycles += m_pendingCycles;
+      if (m_pendingCycles > 0)
+        c->stalls += m_pendingCycles - 1;
+    }
+    m_pendingCycles = 0;
+  }
+  m_pendingCycles = 0;
+}
+
+std::vector<SourceProfiler::Entry> SourceProfiler::lines() const {
+  std::vector<Entry> entries;
+  auto program = ProcessorHandler::getProgram();
+  if (!program || !program->sourceLines)
+    return entries;
+
+  std::map<SourceLineTable::Line, Counters> lines;
+  for (size_t i = 0; i < m_counters.size(); ++i) {
+    const Counters &c = m_counters[i];
+    if (c.cycles == 0 && c.icacheMisses == 0 && c.dcacheMisses == 0)
+      continue;
+    if (auto line = program->sourceLines->lookup(m_textStart +
+                                                 i * m_instrBytes))
+      lines[*line] += c;
+  }
+  for (const auto &line : lines)
+    entries.push_back({line.first, line.second});
+  std::stable_sort(entries.begin(), entries.end(),
+                   [](const Entry &lhs, const Entry &rhs) {
+                     return lhs.counters.cycles > rhs.counters.cycles;
+                   });
+  return entries;
+}
+
+std::map<unsigned, SourceProfiler::Counters>
+SourceProfiler::sourceMappedLines() const {
+  std::map<unsigned, Counters> lines;
+  auto program = ProcessorHandler::getProgram();
+  if (!program)
+    return lines;
+
+  for (const auto &mapping : program->sourceMapping) {
+    const Counters *c = counters(mapping.first);
+    if (!c)
+      continue;
+    for (const unsigned line : mapping.second)
+      lines[line] += *c;
+  }
+  return lines;
+}
+
+} // namespace Ripes
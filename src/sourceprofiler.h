@@ -0,0 +1,90 @@
+#pragma once
+
+#include <QObject>
+
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "processorobserver.h"
+#include "sourcelines.h"
+
+namespace Ripes {
+
+/**
+ * @brief The SourceProfiler class
+ * Counts the cycles, stall cycles and cache misses of each instruction of the
+ * text section of the current program, for aggregating them by the source
+ * lines which the instructions were compiled or assembled from.
+ *
+ * As in HotSpotProfiler, the cycles elapsed since the previous retirement are
+ * charged to the first instruction retiring in a cycle; all but one of these
+ * are stall cycles of the instruction. Cache misses are read from the provided
+ * miss counters after each cycle, and charged to the instruction which was
+ * fetched, respectively which accessed data, in the cycle. The profile is
+ * cleared when the processor is reset or reversed.
+ */
+class SourceProfiler : public QObject, public ProcessorObserver {
+public:
+  /// Returns the number of misses of a cache since it was last reset.
+  using MissCounter = std::function<unsigned long long()>;
+
+  struct Counters {
+    unsigned long long cycles = 0;
+    unsigned long long retired = 0;
+    unsigned long long stalls = 0;
+    unsigned long long icacheMisses = 0;
+    unsigned long long dcacheMisses = 0;
+
+    Counters &operator+=(const Counters &other);
+  };
+
+  struct Entry {
+    SourceLineTable::Line line;
+    Counters counters;
+  };
+
+  /// Profiles the current processor until destroyed. Cache misses are not
+  /// counted for caches without a miss counter.
+  SourceProfiler(MissCounter icacheMisses = {}, MissCounter dcacheMisses = {});
+  ~SourceProfiler() override;
+
+  /// Returns the counters of the source lines of the debug information of the
+  /// current program (see Program::sourceLines), by descending cycles.
+  std::vector<Entry> lines() const;
+  /// Returns the counters of the (0-indexed) lines of the source of the
+  /// current program, as given by its source mapping (see
+  /// Program::sourceMapping).
+  std::map<unsigned, Counters> sourceMappedLines() const;
+
+  /// The counters of all instructions, including those outside of the text
+  /// section or of no source line.
+  const Counters &total() const { return m_total; }
+
+  unsigned events() const override { return Cycle; }
+  void onCycle(const RipesProcessor &proc) override;
+
+private:
+  void reset();
+  /// Returns the counters of the instruction at @p pc, or nullptr if outside
+  /// of the text section.
+  const Counters *counters(AInt pc) const;
+  Counters *counters(AInt pc);
+
+  MissCounter m_icacheMisses;
+  MissCounter m_dcacheMisses;
+
+  AInt m_textStart = 0;
+  unsigned m_instrBytes = 4;
+  std::vector<Counters> m_counters;
+  Counters m_total;
+
+  std::vector<StageIndex> m_finalStages;
+  long long m_lastCycle = 0;
+  long long m_lastRetired = 0;
+  unsigned long long m_pendingCycles = 0;
+  unsigned long long m_lastICacheMisses = 0;
+  unsigned long long m_lastDCacheMisses = 0;
+};
+
+} // namespace Ripes
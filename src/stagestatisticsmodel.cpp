@@ -0,0 +1,153 @@
+#include "stagestatisticsmodel.h"
+
+#include "processorhandler.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+StageStatisticsModel::StageStatisticsModel(QObject *parent)
+    : QAbstractTableModel(parent) {
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorClocked, this,
+          &StageStatisticsModel::processorWasClocked, Qt::DirectConnection);
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReversed, this,
+          &StageStatisticsModel::processorWasReversed);
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          &StageStatisticsModel::reset);
+  reset();
+}
+
+QString StageStatisticsModel::columnName(Column column) {
+  switch (column) {
+  case Stage:
+    return "Stage";
+  case Active:
+    return "Active";
+  case Stalled:
+    return "Stalled";
+  case Flushed:
+    return "Flushed";
+  case WayHazard:
+    return "Way hazard";
+  case Bubble:
+    return "Bubble";
+  case NColumns:
+    break;
+  }
+  Q_UNREACHABLE();
+}
+
+QVariant StageStatisticsModel::headerData(int section,
+                                          Qt::Orientation orientation,
+                                          int role) const {
+  if (role != Qt::DisplayRole || orientation != Qt::Horizontal)
+    return QVariant();
+  return columnName(static_cast<Column>(section));
+}
+
+int StageStatisticsModel::rowCount(const QModelIndex &) const {
+  return m_stages.size();
+}
+
+int StageStatisticsModel::columnCount(const QModelIndex &) const {
+  return NColumns;
+}
+
+QVariant StageStatisticsModel::data(const QModelIndex &index, int role) const {
+  if (!index.isValid() || index.row() >= rowCount())
+    return QVariant();
+
+  if (role == Qt::TextAlignmentRole)
+    return Qt::AlignCenter;
+
+  const auto &stage = m_stages.at(index.row());
+  if (index.column() == Stage) {
+    if (role != Qt::DisplayRole)
+      return QVariant();
+    QString name = ProcessorHandler::getProcessor()->stageName(stage);
+    if (ProcessorHandler::getProcessor()->structure().size() > 1)
+      name += " (lane " + QString::number(stage.lane()) + ")";
+    return name;
+  }
+
+  const unsigned long long count = m_counters.at(index.row())[index.column()];
+  if (role == Qt::DisplayRole)
+    return count;
+  if (role == Qt::ToolTipRole && m_cycles > 0)
+    return QString::number(100.0 * count / m_cycles, 'f', 1) +
+           "% of cycles";
+  return QVariant();
+}
+
+void StageStatisticsModel::prepareForView() {
+  beginResetModel();
+  endResetModel();
+}
+
+StageStatisticsModel::Column
+StageStatisticsModel::classify(const StageInfo &info) {
+  switch (info.state) {
+  case StageInfo::State::Stalled:
+    return Stalled;
+  case StageInfo::State::Flushed:
+    return Flushed;
+  case StageInfo::State::WayHazard:
+    return WayHazard;
+  case StageInfo::State::Unused:
+    return Bubble;
+  case StageInfo::State::None:
+    return info.stage_valid ? Active : Bubble;
+  }
+  Q_UNREACHABLE();
+}
+
+void StageStatisticsModel::processorWasClocked() {
+  const auto *proc = ProcessorHandler::getProcessor();
+  const size_t stages = m_stages.size();
+  uint8_t *history = nullptr;
+  if (m_historyCapacity > 0) {
+    history = &m_history[m_historyHead * stages];
+    m_historyHead = (m_historyHead + 1) % m_historyCapacity;
+    m_historyCount = std::min(m_historyCount + 1, m_historyCapacity);
+  }
+
+  proc->stageInfos(m_stageInfos.data());
+  for (size_t i = 0; i < stages; ++i) {
+    const Column column = classify(m_stageInfos[i]);
+    m_counters[i][column]++;
+    if (history)
+      history[i] = column;
+  }
+  m_cycles++;
+}
+
+void StageStatisticsModel::processorWasReversed() {
+  if (m_historyCount == 0) {
+    // The reversed cycle is older than the recorded history.
+    return;
+  }
+
+  const size_t stages = m_stages.size();
+  m_historyHead = (m_historyHead + m_historyCapacity - 1) % m_historyCapacity;
+  m_historyCount--;
+  const uint8_t *history = &m_history[m_historyHead * stages];
+  for (size_t i = 0; i < stages; ++i)
+    m_counters[i][history[i]]--;
+  m_cycles--;
+}
+
+void StageStatisticsModel::reset() {
+  m_stages = ProcessorHandler::getProcessor()->structure().stageIt();
+  m_stageInfos.resize(m_stages.size());
+  m_counters.assign(m_stages.size(), Counters{});
+  m_cycles = 0;
+
+  m_historyCapacity = ProcessorHandler::isReversible()
+                          ? vsrtl::core::ClockedComponent::reverseStackSize()
+                          : 0;
+  m_history.assign(m_historyCapacity * m_stages.size(), 0);
+  m_historyHead = 0;
+  m_historyCount = 0;
+}
+
+} // namespace Ripes
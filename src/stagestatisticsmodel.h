@@ -0,0 +1,76 @@
+#pragma once
+
+#include "processors/interface/ripesprocessor.h"
+#include <QAbstractTableModel>
+
+#include <array>
+#include <vector>
+
+namespace Ripes {
+
+/**
+ * @brief The StageStatisticsModel class
+ * Accumulates, for each stage of the current processor, the number of cycles
+ * in which the stage held an executing instruction, was stalled, was flushed,
+ * held a way hazard or held a bubble, as reported by
+ * RipesProcessor::stageInfo(). Invalid and unused stages are counted as
+ * bubbles. Reversed cycles are subtracted from the counters.
+ */
+class StageStatisticsModel : public QAbstractTableModel {
+  Q_OBJECT
+public:
+  enum Column {
+    Stage = 0,
+    Active = 1,
+    Stalled = 2,
+    Flushed = 3,
+    WayHazard = 4,
+    Bubble = 5,
+    NColumns
+  };
+  /// Per-stage counters, indexed by Column. The Stage entry is unused.
+  using Counters = std::array<unsigned long long, NColumns>;
+
+  StageStatisticsModel(QObject *parent = nullptr);
+
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+
+  QVariant data(const QModelIndex &index,
+                int role = Qt::DisplayRole) const override;
+  QVariant headerData(int section, Qt::Orientation orientation,
+                      int role = Qt::DisplayRole) const override;
+  void prepareForView();
+
+  const std::vector<StageIndex> &stages() const { return m_stages; }
+  const std::vector<Counters> &counters() const { return m_counters; }
+  unsigned long long cycles() const { return m_cycles; }
+  static QString columnName(Column column);
+
+public slots:
+  void processorWasClocked();
+  void processorWasReversed();
+  void reset();
+
+private:
+  static Column classify(const StageInfo &info);
+
+  std::vector<StageIndex> m_stages;
+  std::vector<StageInfo> m_stageInfos;
+  std::vector<Counters> m_counters;
+  unsigned long long m_cycles = 0;
+
+  /**
+   * @brief m_history
+   * The classification of each stage in the most recently recorded cycles,
+   * for subtracting reversed cycles. A ring of m_historyCapacity cycles, each
+   * holding one entry per stage. The capacity follows the reverse stack size of
+   * the processor, and is zero if the processor is not reversible.
+   */
+  std::vector<uint8_t> m_history;
+  size_t m_historyCapacity = 0;
+  size_t m_historyHead = 0;
+  size_t m_historyCount = 0;
+};
+
+} // namespace Ripes
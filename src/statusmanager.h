@@ -18,7 +18,8 @@ namespace Ripes {
 template <typename F>
 static void postToGUIThread(F &&fun,
                             Qt::ConnectionType type = Qt::QueuedConnection) {
-  auto *obj = QAbstractEventDispatcher::instance(qApp->thread());
+  auto *obj = QAbstractEventDispatcher::instance(
+      QCoreApplication::instance()->thread());
   Q_ASSERT(obj);
   QMetaObject::invokeMethod(obj, std::forward<F>(fun), type);
 }
@@ -1,64 +1,121 @@
 #include "symbolnavigator.h"
 #include "ui_symbolnavigator.h"
 
+#include "assembler/symbolindex.h"
 #include "processorhandler.h"
 #include "radix.h"
 
+#include <QAbstractTableModel>
+#include <QKeyEvent>
 #include <QPushButton>
 
 namespace Ripes {
 
-SymbolNavigator::SymbolNavigator(const ReverseSymbolMap &symbolmap,
-                                 QWidget *parent)
+/// The symbols of a SymbolIndex matching the filter of the navigator.
+class SymbolNavigatorModel : public QAbstractTableModel {
+public:
+  enum Column { AddressColumn, NameColumn, NColumns };
+
+  SymbolNavigatorModel(const SymbolIndex &symbols, QObject *parent)
+      : QAbstractTableModel(parent), m_symbols(symbols) {}
+
+  void setFilter(const QString &filter) {
+    beginResetModel();
+    m_matches = m_symbols.find(filter);
+    endResetModel();
+  }
+
+  const SymbolIndex::Entry &entry(int row) const {
+    return m_symbols.entry(m_matches.at(row));
+  }
+
+  int rowCount(const QModelIndex & = QModelIndex()) const override {
+    return m_matches.size();
+  }
+  int columnCount(const QModelIndex & = QModelIndex()) const override {
+    return NColumns;
+  }
+
+  QVariant headerData(int section, Qt::Orientation orientation,
+                      int role) const override {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+      return QVariant();
+    return section == AddressColumn ? "Address" : "Symbol";
+  }
+
+  QVariant data(const QModelIndex &index, int role) const override {
+    if (!index.isValid() || role != Qt::DisplayRole)
+      return QVariant();
+    const auto &symbol = entry(index.row());
+    if (index.column() == AddressColumn)
+      return encodeRadixValue(symbol.address, Radix::Hex,
+                              ProcessorHandler::currentISA()->bytes());
+    return symbol.name;
+  }
+
+private:
+  const SymbolIndex &m_symbols;
+  std::vector<unsigned> m_matches;
+};
+
+SymbolNavigator::SymbolNavigator(const SymbolIndex &symbols, QWidget *parent)
     : QDialog(parent), m_ui(new Ui::SymbolNavigator) {
   m_ui->setupUi(this);
 
   setWindowTitle("Symbol navigator");
 
-  m_ui->symbolTable->setColumnCount(2);
+  m_model = new SymbolNavigatorModel(symbols, this);
+  m_ui->symbolTable->setModel(m_model);
   m_ui->symbolTable->setSelectionBehavior(QAbstractItemView::SelectRows);
   m_ui->symbolTable->setSelectionMode(QAbstractItemView::SingleSelection);
   m_ui->symbolTable->verticalHeader()->hide();
-  m_ui->symbolTable->setHorizontalHeaderLabels({"Address", "Symbol"});
   m_ui->symbolTable->horizontalHeader()->setStretchLastSection(true);
-  m_ui->symbolTable->horizontalHeader()->setSectionResizeMode(
-      QHeaderView::ResizeToContents);
+  // Addresses are of a fixed width; sizing the column to its contents would
+  // query each of the (possibly thousands of) symbols.
+  m_ui->symbolTable->setColumnWidth(
+      SymbolNavigatorModel::AddressColumn,
+      m_ui->symbolTable->fontMetrics().horizontalAdvance(encodeRadixValue(
+          0, Radix::Hex, ProcessorHandler::currentISA()->bytes())) +
+          m_ui->symbolTable->fontMetrics().height());
   m_ui->buttonBox->button(QDialogButtonBox::Ok)->setText("Go to symbol");
 
-  for (const auto &iter : symbolmap) {
-    addSymbol(iter.first, iter.second);
-  }
+  // Up/down in the filter moves the selection, such that a symbol may be
+  // filtered and selected without leaving the keyboard.
+  m_ui->filter->installEventFilter(this);
+  connect(m_ui->filter, &QLineEdit::textChanged, this,
+          &SymbolNavigator::setFilter);
+  connect(m_ui->symbolTable, &QTableView::doubleClicked, this,
+          &SymbolNavigator::accept);
+  setFilter(QString());
+  m_ui->filter->setFocus();
+}
+
+void SymbolNavigator::setFilter(const QString &filter) {
+  m_model->setFilter(filter);
   m_ui->symbolTable->selectRow(0);
+  m_ui->buttonBox->button(QDialogButtonBox::Ok)
+      ->setEnabled(m_model->rowCount() > 0);
+}
+
+bool SymbolNavigator::eventFilter(QObject *watched, QEvent *event) {
+  if (watched == m_ui->filter && event->type() == QEvent::KeyPress) {
+    const int key = static_cast<QKeyEvent *>(event)->key();
+    if (key == Qt::Key_Up || key == Qt::Key_Down || key == Qt::Key_PageUp ||
+        key == Qt::Key_PageDown) {
+      QCoreApplication::sendEvent(m_ui->symbolTable, event);
+      return true;
+    }
+  }
+  return QDialog::eventFilter(watched, event);
 }
 
 AInt SymbolNavigator::getSelectedSymbolAddress() const {
-  const auto selected = m_ui->symbolTable->selectedItems();
+  const auto selected = m_ui->symbolTable->selectionModel()->selectedRows();
   if (selected.size() > 0) {
-    return selected[0]->data(Qt::UserRole).toUInt();
+    return m_model->entry(selected[0].row()).address;
   }
   return 0;
 }
 
-void SymbolNavigator::addSymbol(const AInt address, const QString &label) {
-  m_ui->symbolTable->setRowCount(m_ui->symbolTable->rowCount() + 1);
-  QTableWidgetItem *addrItem = new QTableWidgetItem();
-  QTableWidgetItem *labelItem = new QTableWidgetItem();
-
-  addrItem->setData(Qt::DisplayRole,
-                    encodeRadixValue(address, Radix::Hex,
-                                     ProcessorHandler::currentISA()->bytes()));
-  labelItem->setData(Qt::DisplayRole, label);
-
-  addrItem->setFlags(addrItem->flags() ^ Qt::ItemIsEditable);
-  labelItem->setFlags(labelItem->flags() ^ Qt::ItemIsEditable);
-
-  addrItem->setData(Qt::UserRole, QVariant::fromValue(address));
-  labelItem->setData(Qt::UserRole, QVariant::fromValue(address));
-
-  const int row = m_ui->symbolTable->rowCount() - 1;
-  m_ui->symbolTable->setItem(row, 0, addrItem);
-  m_ui->symbolTable->setItem(row, 1, labelItem);
-}
-
 SymbolNavigator::~SymbolNavigator() { delete m_ui; }
 } // namespace Ripes
@@ -6,6 +6,9 @@
 
 namespace Ripes {
 
+class SymbolIndex;
+class SymbolNavigatorModel;
+
 namespace Ui {
 class SymbolNavigator;
 }
@@ -14,14 +17,18 @@ class SymbolNavigator : public QDialog {
   Q_OBJECT
 
 public:
-  SymbolNavigator(const ReverseSymbolMap &symbolmap, QWidget *parent = nullptr);
+  SymbolNavigator(const SymbolIndex &symbols, QWidget *parent = nullptr);
   ~SymbolNavigator();
 
   AInt getSelectedSymbolAddress() const;
 
+protected:
+  bool eventFilter(QObject *watched, QEvent *event) override;
+
 private:
-  void addSymbol(const AInt address, const QString &label);
+  void setFilter(const QString &filter);
 
   Ui::SymbolNavigator *m_ui;
+  SymbolNavigatorModel *m_model = nullptr;
 };
 } // namespace Ripes
@@ -16,8 +16,7 @@ public:
   ExitSyscall() : BaseSyscall("Exit", "Exits the program with code 0") {}
   void execute() {
     SystemIO::printString("\nProgram exited with code: 0\n");
-    ProcessorHandler::getProcessorNonConst()->finalize(
-        RipesProcessor::FinalizeReason::exitSyscall);
+    ProcessorHandler::exitProgram();
   }
 };
 
@@ -33,8 +32,7 @@ public:
     SystemIO::printString(
         "\nProgram exited with code: " +
         QString::number(BaseSyscall::getArg(RegisterFileType::GPR, 0)) + "\n");
-    ProcessorHandler::getProcessorNonConst()->finalize(
-        RipesProcessor::FinalizeReason::exitSyscall);
+    ProcessorHandler::exitProgram();
   }
 };
 
@@ -21,14 +21,7 @@ public:
   void execute() {
     const AInt arg0 = BaseSyscall::getArg(RegisterFileType::GPR, 0);
     const AInt arg1 = BaseSyscall::getArg(RegisterFileType::GPR, 1);
-    QByteArray string;
-    char byte;
-    unsigned int address = arg0;
-    do {
-      byte = static_cast<char>(
-          ProcessorHandler::getMemory().readMemConst(address++, 1) & 0xFF);
-      string.append(byte);
-    } while (byte != '\0');
+    const QByteArray string = ProcessorHandler::readString(arg0);
 
     int ret = SystemIO::openFile(QString::fromUtf8(string), arg1);
 
@@ -82,9 +75,14 @@ public:
                      {1, "address of the buffer"},
                      {2, "maximum number of bytes to read"}},
                     {{0, "number of read bytes or -1 if an error occurred"}}) {}
+  // Reads from stdin wait for console input; reads from files do not block.
+  bool mayBlock() const override {
+    return static_cast<int>(BaseSyscall::getArg(RegisterFileType::GPR, 0)) ==
+           SystemIO::STDIN;
+  }
   void execute() {
     const int fd = BaseSyscall::getArg(RegisterFileType::GPR, 0);
-    int byteAddress = BaseSyscall::getArg(
+    const AInt byteAddress = BaseSyscall::getArg(
         RegisterFileType::GPR, 1); // destination of characters read from file
     const int length = BaseSyscall::getArg(RegisterFileType::GPR, 2);
     QByteArray buffer;
@@ -92,15 +90,12 @@ public:
     int retLength = SystemIO::readFromFile(fd, buffer, length);
     BaseSyscall::setRet(RegisterFileType::GPR, 0, retLength);
 
-    if (retLength != -1) {
-      // copy bytes from returned buffer into memory
-      const char *dataptr =
-          buffer.constData(); // QString::data contains a possible null
-                              // termination '\0' character (present if reading
-                              // from stdin and not from a file)
-      while (retLength-- > 0) {
-        ProcessorHandler::writeMem(byteAddress++, *dataptr++, sizeof(char));
-      }
+    if (retLength > 0) {
+      // copy bytes from returned buffer into memory. The buffer may contain a
+      // null termination '\0' character (present if reading from stdin and
+      // not from a file), which is not copied.
+      ProcessorHandler::writeMemBlock(byteAddress, buffer.constData(),
+                                      retLength);
     }
   }
 };
@@ -117,7 +112,7 @@ public:
                      {2, "number of bytes to write"}},
                     {{0, "the number of bytes written"}}) {}
   void execute() {
-    const int byteAddress = BaseSyscall::getArg(
+    const AInt byteAddress = BaseSyscall::getArg(
         RegisterFileType::GPR, 1); // source of characters to write to file
     const int reqLength =
         BaseSyscall::getArg(RegisterFileType::GPR, 2); // user-requested length
@@ -125,17 +120,12 @@ public:
       BaseSyscall::setRet(RegisterFileType::GPR, 0, -1);
       return;
     }
-    int index = 0;
-    QString myBuffer;
-
-    do {
-      myBuffer.append(static_cast<char>(
-          ProcessorHandler::getMemory().readMemConst(byteAddress + index++, 1) &
-          0xFF));
-    } while (index < reqLength);
+    QByteArray buffer(reqLength, '\0');
+    ProcessorHandler::readMemBlock(byteAddress, buffer.data(), reqLength);
 
     const int retValue = SystemIO::writeToFile(
-        BaseSyscall::getArg(RegisterFileType::GPR, 0), myBuffer, reqLength);
+        BaseSyscall::getArg(RegisterFileType::GPR, 0),
+        QString::fromLatin1(buffer), reqLength);
     BaseSyscall::setRet(RegisterFileType::GPR, 0, retValue);
   }
 };
@@ -153,9 +143,8 @@ public:
              {1, "the length of the buffer"}},
             {{0, "-1 if the path is longer than the buffer"}}) {}
   void execute() {
-    const int byteAddress = BaseSyscall::getArg(
+    const AInt byteAddress = BaseSyscall::getArg(
         RegisterFileType::GPR, 0); // destination of characters read from file
-    int index = 0;
     const int bufferSize = BaseSyscall::getArg(RegisterFileType::GPR, 1);
 
     const QString pwd = QDir::currentPath();
@@ -168,10 +157,9 @@ public:
     }
 
     // copy bytes from returned buffer into memory
-    while (index < pwd.length()) {
-      ProcessorHandler::writeMem(byteAddress, pwd.at(index++).toLatin1(),
-                                 sizeof(char));
-    }
+    const QByteArray path = pwd.toLatin1();
+    ProcessorHandler::writeMemBlock(byteAddress, path.constData(),
+                                    path.size());
   }
 };
 
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#include <QtEndian>
+
+#include "processorhandler.h"
+#include "ripes_syscall.h"
+#include "systemio.h"
+
+namespace Ripes {
+
+// Syscalls of the newlib ABI (see SyscallABI::Newlib), as issued by libgloss.
+// Errors are returned as negated errno values, which libgloss stores to errno.
+namespace NewlibErrno {
+static constexpr int EBADF = 9;
+static constexpr int EINVAL = 22;
+} // namespace NewlibErrno
+
+// Writes the @p bytes low bytes of @p value, little-endian, at @p offset of
+// @p buffer.
+inline void newlibPut(QByteArray &buffer, int offset, uint64_t value,
+                      unsigned bytes) {
+  const uint64_t le = qToLittleEndian(value);
+  std::memcpy(buffer.data() + offset, &le, bytes);
+}
+
+template <typename BaseSyscall>
+class NewlibBrkSyscall : public BaseSyscall {
+  static_assert(std::is_base_of<Syscall, BaseSyscall>::value);
+
+public:
+  NewlibBrkSyscall()
+      : BaseSyscall(
+            "brk",
+            "Sets the program break, the end of the heap. The initial break "
+            "is the end of the sections of the program.",
+            {{0, "the new program break, or 0 to query the break"}},
+            {{0, "the program break"}}) {}
+
+  void execute() {
+    AInt programBreak = ProcessorHandler::getProgramBreak();
+    if (programBreak == 0) {
+      if (const auto program = ProcessorHandler::getProgram())
+        programBreak = initialProgramBreak(*program);
+    }
+    // The heap may grow without bounds.
+    if (const AInt request = BaseSyscall::getArg(RegisterFileType::GPR, 0))
+      programBreak = request;
+    ProcessorHandler::setProgramBreak(programBreak);
+    BaseSyscall::setRet(RegisterFileType::GPR, 0, programBreak);
+  }
+};
+
+template <typename BaseSyscall>
+class NewlibOpenAtSyscall : public BaseSyscall {
+  static_assert(std::is_base_of<Syscall, BaseSyscall>::value);
+
+public:
+  NewlibOpenAtSyscall()
+      : BaseSyscall("openat",
+                    "Opens a file from a path, relative to the current working "
+                    "directory",
+                    {{0, "the directory file descriptor (ignored)"},
+                     {1, "Pointer to null terminated string for the path"},
+                     {2, "flags"}},
+                    {{0, "the file decriptor or -1 if an error occurred"}}) {}
+  void execute() {
+    const QByteArray path = ProcessorHandler::readString(
+        BaseSyscall::getArg(RegisterFileType::GPR, 1));
+    // newlib flags are those of SystemIO.
+    const int ret = SystemIO::openFile(
+        QString::fromUtf8(path), BaseSyscall::getArg(RegisterFileType::GPR, 2));
+    BaseSyscall::setRet(RegisterFileType::GPR, 0, ret);
+  }
+};
+
+template <typename BaseSyscall>
+class NewlibFStatSyscall : public BaseSyscall {
+  static_assert(std::is_base_of<Syscall, BaseSyscall>::value);
+
+public:
+  NewlibFStatSyscall()
+      : BaseSyscall("fstat",
+                    "Writes information about a file to a struct "
+                    "kernel_stat. Standard streams are character devices, such "
+                    "that newlib line-buffers the console.",
+                    {{0, "the file descriptor"},
+                     {1, "pointer to a struct kernel_stat"}},
+                    {{0, "0, or -EBADF if the file is not open"}}) {}
+  void execute() {
+    const int fd = BaseSyscall::getArg(RegisterFileType::GPR, 0);
+    const AInt statAddress = BaseSyscall::getArg(RegisterFileType::GPR, 1);
+    uint64_t mode;
+    long long size = 0;
+    if (fd >= 0 && fd < SystemIO::STDIO_END) {
+      mode = s_ifchr | 0620;
+    } else {
+      size = SystemIO::fileSize(fd);
+      if (size < 0) {
+        BaseSyscall::setRet(RegisterFileType::GPR, 0, -NewlibErrno::EBADF);
+        return;
+      }
+      mode = s_ifreg | 0644;
+    }
+
+    // struct kernel_stat of libgloss, which is of the same layout for RV32
+    // and RV64 (time_t is 64-bit). Timestamps are left zero.
+    QByteArray stat(s_statBytes, '\0');
+    newlibPut(stat, 16, mode, 4); // st_mode
+    newlibPut(stat, 20, 1, 4);    // st_nlink
+    newlibPut(stat, 48, size, 8); // st_size
+    ProcessorHandler::writeMemBlock(statAddress, stat.constData(),
+                                    stat.size());
+    BaseSyscall::setRet(RegisterFileType::GPR, 0, 0);
+  }
+
+private:
+  static constexpr int s_statBytes = 128;
+  static constexpr uint64_t s_ifchr = 0020000;
+  static constexpr uint64_t s_ifreg = 0100000;
+};
+
+template <typename BaseSyscall>
+class NewlibGetTimeOfDaySyscall : public BaseSyscall {
+  static_assert(std::is_base_of<Syscall, BaseSyscall>::value);
+
+public:
+  NewlibGetTimeOfDaySyscall()
+      : BaseSyscall("gettimeofday",
+                    "Writes the current time since epoch to a struct timeval. "
+                    "With a virtual clock, the time is derived from the cycle "
+                    "count",
+                    {{0, "pointer to a struct timeval, or 0"},
+                     {1, "pointer to a struct timezone (ignored)"}},
+                    {{0, "0"}}) {}
+  void execute() {
+    if (const AInt tv = BaseSyscall::getArg(RegisterFileType::GPR, 0)) {
+      const long long ns = ProcessorHandler::currentTimeNs();
+      const unsigned xlen = ProcessorHandler::currentISA()->bytes();
+      // time_t tv_sec is 64-bit; suseconds_t tv_usec is a long.
+      QByteArray timeval(8 + xlen, '\0');
+      newlibPut(timeval, 0, ns / 1000000000, 8);
+      newlibPut(timeval, 8, ns % 1000000000 / 1000, xlen);
+      ProcessorHandler::writeMemBlock(tv, timeval.constData(), timeval.size());
+    }
+    BaseSyscall::setRet(RegisterFileType::GPR, 0, 0);
+  }
+};
+
+/**
+ * clock_gettime. If @p Time64, the seconds and nanoseconds of the timespec are
+ * 64-bit (clock_gettime64 of RV32); else, they are of the register width.
+ */
+template <typename BaseSyscall, bool Time64>
+class NewlibClockGetTimeSyscall : public BaseSyscall {
+  static_assert(std::is_base_of<Syscall, BaseSyscall>::value);
+
+public:
+  NewlibClockGetTimeSyscall()
+      : BaseSyscall(Time64 ? "clock_gettime64" : "clock_gettime",
+                    "Writes the time of a clock to a struct timespec. "
+                    "CLOCK_REALTIME is the time since epoch; the monotonic and "
+                    "CPU time clocks count from the processor reset. With a "
+                    "virtual clock, times are derived from the cycle count",
+                    {{0, "the clock ID"}, {1, "pointer to a struct timespec"}},
+                    {{0, "0, or -EINVAL for unknown clocks"}}) {}
+  void execute() {
+    long long ns;
+    switch (BaseSyscall::getArg(RegisterFileType::GPR, 0)) {
+    case s_clockRealtime:
+      ns = ProcessorHandler::currentTimeNs();
+      break;
+    case s_clockMonotonic:
+    case s_clockProcessCPUTime:
+    case s_clockThreadCPUTime:
+      ns = ProcessorHandler::elapsedTimeNs();
+      break;
+    default:
+      BaseSyscall::setRet(RegisterFileType::GPR, 0, -NewlibErrno::EINVAL);
+      return;
+    }
+    const unsigned bytes =
+        Time64 ? 8 : ProcessorHandler::currentISA()->bytes();
+    QByteArray timespec(2 * bytes, '\0');
+    newlibPut(timespec, 0, ns / 1000000000, bytes);
+    newlibPut(timespec, bytes, ns % 1000000000, bytes);
+    ProcessorHandler::writeMemBlock(
+        BaseSyscall::getArg(RegisterFileType::GPR, 1), timespec.constData(),
+        timespec.size());
+    BaseSyscall::setRet(RegisterFileType::GPR, 0, 0);
+  }
+
+private:
+  static constexpr VInt s_clockRealtime = 0;
+  static constexpr VInt s_clockMonotonic = 1;
+  static constexpr VInt s_clockProcessCPUTime = 2;
+  static constexpr VInt s_clockThreadCPUTime = 3;
+};
+
+template <typename BaseSyscall>
+class NewlibTimesSyscall : public BaseSyscall {
+  static_assert(std::is_base_of<Syscall, BaseSyscall>::value);
+
+public:
+  NewlibTimesSyscall()
+      : BaseSyscall("times",
+                    "Writes the process times, in microsecond ticks since the "
+                    "processor reset, to a struct tms. All time is user time",
+                    {{0, "pointer to a struct tms, or 0"}},
+                    {{0, "the ticks since the processor reset"}}) {}
+  void execute() {
+    const uint64_t ticks = ProcessorHandler::elapsedTimeNs() / 1000;
+    if (const AInt buf = BaseSyscall::getArg(RegisterFileType::GPR, 0)) {
+      // tms_utime, tms_stime, tms_cutime and tms_cstime are clock_t (long).
+      const unsigned xlen = ProcessorHandler::currentISA()->bytes();
+      QByteArray tms(4 * xlen, '\0');
+      newlibPut(tms, 0, ticks, xlen);
+      ProcessorHandler::writeMemBlock(buf, tms.constData(), tms.size());
+    }
+    BaseSyscall::setRet(RegisterFileType::GPR, 0, ticks);
+  }
+};
+
+} // namespace Ripes
@@ -16,6 +16,7 @@ public:
   PrintIntSyscall()
       : BaseSyscall("PrintInt", "Prints an integer",
                     {{0, "integer to print"}}) {}
+  bool outputOnly() const override { return true; }
   void execute() {
     const VIntS arg0 = vsrtl::signextend<VInt, VIntS>(
         BaseSyscall::getArg(RegisterFileType::GPR, 0),
@@ -32,6 +33,7 @@ public:
   PrintFloatSyscall()
       : BaseSyscall("PrintFloat", "Prints a floating point number",
                     {{0, "float to print"}}) {}
+  bool outputOnly() const override { return true; }
   void execute() {
     const VInt arg0 = BaseSyscall::getArg(RegisterFileType::GPR, 0);
     auto *v_f = reinterpret_cast<const float *>(&arg0);
@@ -47,16 +49,10 @@ public:
   PrintStrSyscall()
       : BaseSyscall("PrintString", "Prints a null-terminated string",
                     {{0, "address of the string"}}) {}
+  bool outputOnly() const override { return true; }
   void execute() {
     const VInt arg0 = BaseSyscall::getArg(RegisterFileType::GPR, 0);
-    QByteArray string;
-    char byte;
-    AInt address = arg0;
-    do {
-      byte = static_cast<char>(
-          ProcessorHandler::getMemory().readMemConst(address++, 1) & 0xFF);
-      string.append(byte);
-    } while (byte != '\0');
+    const QByteArray string = ProcessorHandler::readString(arg0);
     SystemIO::printString(QString::fromUtf8(string));
   }
 };
@@ -70,6 +66,7 @@ public:
       : BaseSyscall(
             "PrintChar", "Prints an ascii character",
             {{0, "character to print (only lowest byte is considered)"}}) {}
+  bool outputOnly() const override { return true; }
   void execute() {
     const VInt arg0 = BaseSyscall::getArg(RegisterFileType::GPR, 0);
     SystemIO::printString(QChar(static_cast<char>(arg0)));
@@ -86,6 +83,7 @@ public:
             "PrintIntHex",
             "Prints an integer (in hexdecimal format left-padded with zeroes)",
             {{0, "integer to print"}}) {}
+  bool outputOnly() const override { return true; }
   void execute() {
     const VInt arg0 = BaseSyscall::getArg(RegisterFileType::GPR, 0);
     SystemIO::printString("0x" +
@@ -104,6 +102,7 @@ public:
             "PrintIntBinary",
             "Prints an integer (in binary format left-padded with zeroes)",
             {{0, "integer to print"}}) {}
+  bool outputOnly() const override { return true; }
   void execute() {
     const VInt arg0 = BaseSyscall::getArg(RegisterFileType::GPR, 0);
     SystemIO::printString("0b" +
@@ -120,6 +119,7 @@ public:
   PrintUnsignedSyscall()
       : BaseSyscall("PrintIntUnsigned", "Prints an integer (unsigned)",
                     {{0, "integer to print"}}) {}
+  bool outputOnly() const override { return true; }
   void execute() {
     const VInt arg0 = BaseSyscall::getArg(RegisterFileType::GPR, 0);
     SystemIO::printString(QString::number(arg0));
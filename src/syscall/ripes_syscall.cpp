@@ -2,23 +2,37 @@
 
 #include "processorhandler.h"
 
+#include <iostream>
+
 namespace Ripes {
 
 bool SyscallManager::execute(SyscallID id) {
   if (m_syscalls.count(id) == 0) {
+    const QString message =
+        "Unknown system call in register '" +
+        ProcessorHandler::currentISA()->regAlias(
+            ProcessorHandler::currentISA()->syscallReg()) +
+        "': " + QString::number(id);
+    // Without a GUI (ie. in CLI mode), there is no message box to show.
+    if (!qobject_cast<QApplication *>(QCoreApplication::instance())) {
+      std::cerr << "ERROR: " << message.toStdString() << std::endl;
+      return false;
+    }
     postToGUIThread([=] {
       QMessageBox::warning(
           nullptr, "Error",
-          "Unknown system call in register '" +
-              ProcessorHandler::currentISA()->regAlias(
-                  ProcessorHandler::currentISA()->syscallReg()) +
-              "': " + QString::number(id) +
-              "\nRefer to \"Help->System calls\" for a list of support system "
-              "calls.");
+          message + "\nRefer to \"Help->System calls\" for a list of support "
+                    "system calls.");
     });
     return false;
   } else {
     const auto &syscall = m_syscalls.at(id);
+    // Non-blocking syscalls complete before a status message could be shown,
+    // and are executed without posting to the GUI thread.
+    if (!syscall->mayBlock()) {
+      syscall->execute();
+      return true;
+    }
     const QString &syscallName = syscall->name();
     postToGUIThread([=] {
       // We don't have a good way of making non-permanent status timers
@@ -6,9 +6,12 @@
 #include <QString>
 #include <QThread>
 
+#include <array>
 #include <functional>
 #include <map>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "../isa/isainfo.h"
 #include "ripes_types.h"
@@ -16,6 +19,18 @@
 
 namespace Ripes {
 
+/**
+ * @brief The SyscallABI enum
+ * The system call ABIs which programs may be executed with.
+ */
+enum class SyscallABI {
+  // The syscalls of the RARS simulator (printing, exiting, files...).
+  RARS,
+  // The Linux syscalls issued by newlib (through libgloss), such that programs
+  // built with a newlib toolchain run unmodified.
+  Newlib
+};
+
 /**
  * @brief The Syscall class
  * Base class for all system calls. Must be specialized by an ISA/ABI specific
@@ -44,6 +59,32 @@ public:
 
   virtual void execute() = 0;
 
+  /**
+   * @brief mayBlock
+   * @returns whether executing the syscall, with its current arguments, may
+   * block the calling thread for an unbounded time (ie. waiting for console
+   * input). Non-blocking syscalls are executed directly on the simulation
+   * thread.
+   */
+  virtual bool mayBlock() const { return false; }
+
+  /**
+   * @brief outputOnly
+   * @returns whether the syscall only produces output from its argument
+   * registers and the memory of the processor, ie. writes neither registers,
+   * memory nor other state which the program may observe. Processors may
+   * handle such syscalls without draining their pipelines first (see
+   * RipesProcessor::isOutputOnlyEcall).
+   */
+  virtual bool outputOnly() const { return false; }
+
+  /**
+   * @brief reset
+   * Resets any state which the syscall keeps between calls. Called whenever
+   * the processor is reset.
+   */
+  virtual void reset() {}
+
   /**
    * @brief getArg
    * ABI specific specialization of returning an argument register value.
@@ -83,6 +124,32 @@ public:
    */
   bool execute(SyscallID id);
 
+  /**
+   * @brief mayBlock
+   * @returns whether the syscall identified by @p id may block (see
+   * Syscall::mayBlock). Unknown syscalls do not block.
+   */
+  bool mayBlock(SyscallID id) const {
+    const auto it = m_syscalls.find(id);
+    return it != m_syscalls.end() && it->second->mayBlock();
+  }
+
+  /**
+   * @brief outputOnly
+   * @returns whether the syscall identified by @p id only produces output (see
+   * Syscall::outputOnly). Unknown syscalls are not output-only.
+   */
+  bool outputOnly(SyscallID id) const {
+    const auto it = m_syscalls.find(id);
+    return it != m_syscalls.end() && it->second->outputOnly();
+  }
+
+  /// Resets the state of all syscalls; see Syscall::reset.
+  void reset() {
+    for (auto &it : m_syscalls)
+      it.second->reset();
+  }
+
   const std::map<SyscallID, std::unique_ptr<Syscall>> &getSyscalls() const {
     return m_syscalls;
   }
@@ -92,6 +159,32 @@ protected:
   std::map<SyscallID, std::unique_ptr<Syscall>> m_syscalls;
 };
 
+/**
+ * @brief The SyscallRecord struct
+ * A system call handled by the processor handler, as reported by
+ * ProcessorHandler::syscallExecuted().
+ */
+struct SyscallRecord {
+  SyscallManager::SyscallID id = 0;
+  // The syscall identified by id, or nullptr if the syscall is unknown.
+  const Syscall *syscall = nullptr;
+  // Cycle count of the processor upon the call.
+  long long cycle = 0;
+  // The first argument registers upon the call, and the return register once
+  // the syscall was handled. Zero for unknown syscalls.
+  std::array<VInt, 3> args{};
+  VInt ret = 0;
+  // Bytes read from and written to the memory of the processor by the syscall.
+  unsigned long long bytesRead = 0;
+  unsigned long long bytesWritten = 0;
+  // The ranges of memory written by the syscall, as (address, bytes) pairs in
+  // the order written.
+  std::vector<std::pair<AInt, AInt>> writes;
+  // Host time spent handling the syscall.
+  long long nanoseconds = 0;
+  bool handled = false;
+};
+
 template <class T>
 class SyscallManagerT : public SyscallManager {
   static_assert(std::is_base_of<Syscall, T>::value);
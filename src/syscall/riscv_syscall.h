@@ -6,6 +6,7 @@
 // Syscall headers
 #include "control.h"
 #include "file.h"
+#include "newlib.h"
 #include "print.h"
 #include "syscall_time.h"
 
@@ -25,7 +26,7 @@ public:
     // RISC-V arguments range from a0-a6
     assert(i < 7);
     const int regIdx = 10 + i; // a0 = x10
-    return ProcessorHandler::getRegisterValue(rfid, regIdx);
+    return ProcessorHandler::getRegisterView(rfid)[regIdx];
   }
 
   void setRet(RegisterFileType rfid, ArgIdx i, VInt value) const override {
@@ -38,7 +39,31 @@ public:
 
 class RISCVSyscallManager : public SyscallManagerT<RISCVSyscall> {
 public:
-  RISCVSyscallManager() {
+  RISCVSyscallManager(SyscallABI abi = SyscallABI::RARS) {
+    // File and control syscalls shared by both ABIs, which use the Linux
+    // syscall numbers.
+    emplace<CloseSyscall<RISCVSyscall>>(RVABI::Close);
+    emplace<LSeekSyscall<RISCVSyscall>>(RVABI::LSeek);
+    emplace<ReadSyscall<RISCVSyscall>>(RVABI::Read);
+    emplace<OpenSyscall<RISCVSyscall>>(RVABI::Open);
+    emplace<WriteSyscall<RISCVSyscall>>(RVABI::Write);
+    emplace<GetCWDSyscall<RISCVSyscall>>(RVABI::GetCWD);
+    emplace<Exit2Syscall<RISCVSyscall>>(RVABI::Exit2);
+
+    if (abi == SyscallABI::Newlib) {
+      emplace<NewlibOpenAtSyscall<RISCVSyscall>>(RVABI::OpenAt);
+      emplace<NewlibFStatSyscall<RISCVSyscall>>(RVABI::FStat);
+      emplace<Exit2Syscall<RISCVSyscall>>(RVABI::ExitGroup);
+      emplace<NewlibBrkSyscall<RISCVSyscall>>(RVABI::brk);
+      emplace<NewlibClockGetTimeSyscall<RISCVSyscall, false>>(
+          RVABI::ClockGetTime);
+      emplace<NewlibClockGetTimeSyscall<RISCVSyscall, true>>(
+          RVABI::ClockGetTime64);
+      emplace<NewlibTimesSyscall<RISCVSyscall>>(RVABI::Times);
+      emplace<NewlibGetTimeOfDaySyscall<RISCVSyscall>>(RVABI::GetTimeOfDay);
+      return;
+    }
+
     // Print syscalls
     emplace<PrintIntSyscall<RISCVSyscall>>(RVABI::PrintInt);
     emplace<PrintFloatSyscall<RISCVSyscall>>(RVABI::PrintFloat);
@@ -50,16 +75,9 @@ public:
 
     // Control syscalls
     emplace<ExitSyscall<RISCVSyscall>>(RVABI::Exit);
-    emplace<Exit2Syscall<RISCVSyscall>>(RVABI::Exit2);
     emplace<BrkSyscall<RISCVSyscall>>(RVABI::brk);
 
     // File syscalls
-    emplace<CloseSyscall<RISCVSyscall>>(RVABI::Close);
-    emplace<LSeekSyscall<RISCVSyscall>>(RVABI::LSeek);
-    emplace<ReadSyscall<RISCVSyscall>>(RVABI::Read);
-    emplace<OpenSyscall<RISCVSyscall>>(RVABI::Open);
-    emplace<WriteSyscall<RISCVSyscall>>(RVABI::Write);
-    emplace<GetCWDSyscall<RISCVSyscall>>(RVABI::GetCWD);
     emplace<FStatSyscall<RISCVSyscall>>(RVABI::FStat);
 
     // Time syscalls
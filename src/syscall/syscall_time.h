@@ -6,8 +6,6 @@
 #include "ripes_syscall.h"
 #include "systemio.h"
 
-#include <QDateTime>
-
 namespace Ripes {
 template <typename BaseSyscall>
 class CyclesSyscall : public BaseSyscall {
@@ -35,12 +33,13 @@ public:
   TimeMsSyscall()
       : BaseSyscall("Time_msec",
                     "Get the current time since epoch (milliseconds since 1 "
-                    "January 1970)",
+                    "January 1970). With a virtual clock, the time is derived "
+                    "from the cycle count, starting at the epoch",
                     {},
                     {{0, "low 32 bits of milliseconds since epoch"},
                      {1, "high 32 bits of milliseconds since epoch"}}) {}
   void execute() {
-    long long ms = QDateTime::currentMSecsSinceEpoch();
+    const long long ms = ProcessorHandler::currentTimeMs();
     BaseSyscall::setRet(RegisterFileType::GPR, 0, ms & 0xFFFFFFFF);
     BaseSyscall::setRet(RegisterFileType::GPR, 1, (ms >> 32) & 0xFFFFFFFF);
   }
@@ -10,5 +10,13 @@ std::map<int, QFile> SystemIO::FileIOData::files;
 QByteArray SystemIO::FileIOData::s_stdinBuffer;
 QMutex SystemIO::FileIOData::s_stdioMutex;
 QWaitCondition SystemIO::FileIOData::s_stdinBufferEmpty;
+QWaitCondition SystemIO::FileIOData::s_stdinBufferFull;
+int SystemIO::FileIOData::s_stdinCapacity = 0;
+bool SystemIO::FileIOData::s_stdinClosed = false;
+unsigned long long SystemIO::FileIOData::s_stdinReads = 0;
 bool SystemIO::s_abortSyscall = false;
+bool SystemIO::s_outputMuted = false;
+std::function<void(const QString &)> SystemIO::s_outputSink;
+QFile SystemIO::s_outputLog;
+QMutex SystemIO::s_outputLogMutex;
 } // namespace Ripes
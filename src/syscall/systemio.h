@@ -10,6 +10,7 @@
 #include <QTextStream>
 #include <QWaitCondition>
 
+#include <functional>
 #include <stdexcept>
 #include <sys/stat.h>
 
@@ -68,6 +69,18 @@ private:
   // Flag used for aborting waiting for I/O
   static bool s_abortSyscall;
 
+  // Flag used for suppressing console output, ie. while replaying cycles
+  // which have already been executed.
+  static bool s_outputMuted;
+
+  // If set, receives console output directly in place of the doPrint signal,
+  // ie. on the simulation thread rather than through queued signal delivery.
+  static std::function<void(const QString &)> s_outputSink;
+
+  // If open, receives a copy of all console output.
+  static QFile s_outputLog;
+  static QMutex s_outputLogMutex;
+
   // Standard I/O Channels
   enum STDIO { STDIN = 0, STDOUT = 1, STDERR = 2, STDIO_END };
 
@@ -109,6 +122,28 @@ private:
      */
     static QMutex s_stdioMutex;
     static QWaitCondition s_stdinBufferEmpty;
+    // Signalled when the stdin buffer has been drained, for producers waiting
+    // on a full buffer (see s_stdinCapacity).
+    static QWaitCondition s_stdinBufferFull;
+    // The number of unread bytes at which producers block, or 0 if the stdin
+    // buffer is unbounded.
+    static int s_stdinCapacity;
+    // Set once the producer of stdin has reached the end of its input. Reads
+    // drain the buffer, and then return end-of-file.
+    static bool s_stdinClosed;
+    // The number of reads of stdin by programs.
+    static unsigned long long s_stdinReads;
+
+    // Releases the storage of the stdin buffer once all of it has been read.
+    // Must be called with s_stdioMutex held.
+    static void drainStdin() {
+      auto &stream = streams[STDIN];
+      if (!stream.atEnd())
+        return;
+      s_stdinBuffer.clear();
+      stream.seek(0);
+      s_stdinBufferFull.wakeAll();
+    }
 
     // Reset all file information. Closes any open files and resets the arrays
     static void resetFiles() {
@@ -347,27 +382,26 @@ public:
         SystemIOStatusManager::setStatusTimed("Waiting for user input...",
                                               99999999);
       });
+      // Producers wake us when pushing data, closing stdin, or aborting the
+      // syscall, so waiting needs no timeout.
+      QMutexLocker locker(&FileIOData::s_stdioMutex);
+      FileIOData::s_stdinReads++;
       while (myBuffer.size() < lengthRequested) {
-        // Lock the stdio objects and try to read from stdio. If no data is
-        // present, wait until so.
-        FileIOData::s_stdioMutex.lock();
         if (s_abortSyscall) {
-          FileIOData::s_stdioMutex.unlock();
           s_abortSyscall = false;
+          locker.unlock();
           postToGUIThread([=] { SystemIOStatusManager::clearStatus(); });
           return -1;
         }
         auto readData = InputStream.read(lengthRequested).toUtf8();
+        FileIOData::drainStdin();
         myBuffer.append(readData);
         lengthRequested -= readData.length();
-
-        /** We spin on a wait condition with a timeout. The timeout is required
-         * to ensure that we may observe any abort flags (ie. if execution is
-         * stopped while waiting for IO */
-        FileIOData::s_stdinBufferEmpty.wait(&FileIOData::s_stdioMutex, 100);
-        FileIOData::s_stdioMutex.unlock();
-        if (myBuffer.endsWith('\n'))
+        if (myBuffer.endsWith('\n') ||
+            (FileIOData::s_stdinClosed && InputStream.atEnd()))
           break;
+        if (readData.isEmpty())
+          FileIOData::s_stdinBufferEmpty.wait(&FileIOData::s_stdioMutex);
       }
     } else {
       // Reads up to lengthRequested bytes of data from this Input stream into
@@ -375,13 +409,10 @@ public:
       myBuffer = InputStream.read(lengthRequested).toUtf8();
     }
 
-    if (myBuffer.size() == 0) {
-      if (fd == STDIN) {
-        Q_ASSERT(false); // EOF should never be possible for STDIN
-      } else {
-        // End of file - write EOF file character into buffer
-        myBuffer.append(sizeof(int), EOF);
-      }
+    // An empty read from STDIN signals that stdin has been closed.
+    if (myBuffer.size() == 0 && fd != STDIN) {
+      // End of file - write EOF file character into buffer
+      myBuffer.append(sizeof(int), EOF);
     }
 
     postToGUIThread([=] { SystemIOStatusManager::clearStatus(); });
@@ -401,7 +432,7 @@ public:
   static int writeToFile(int fd, const QString &myBuffer, int lengthRequested) {
     SystemIO::get(); // Ensure that SystemIO is constructed
     if (fd == STDOUT || fd == STDERR) {
-      emit get().doPrint(myBuffer);
+      printString(myBuffer);
       return myBuffer.size();
     }
 
@@ -428,9 +459,115 @@ public:
    */
   static void closeFile(int fd) { FileIOData::close(fd); }
 
-  static void printString(const QString &string) { emit get().doPrint(string); }
+  /**
+   * Returns the size in bytes of the file with the specified file descriptor
+   *
+   * @param fd the file descriptor
+   * @return the size of the file, or -1 if fd is not an open file
+   */
+  static long long fileSize(int fd) {
+    const auto it = FileIOData::files.find(fd);
+    if (it == FileIOData::files.end() || !it->second.isOpen())
+      return -1;
+    return it->second.size();
+  }
+
+  /**
+   * Returns the names of the files currently opened by the program, by file
+   * descriptor. The standard streams are not included.
+   */
+  static std::map<int, QString> openFiles() {
+    std::map<int, QString> files;
+    for (const auto &file : FileIOData::fileNames) {
+      if (file.first >= STDIO_END && !file.second.isEmpty())
+        files.insert(file);
+    }
+    return files;
+  }
+
+  static void printString(const QString &string) {
+    if (s_outputMuted)
+      return;
+    {
+      QMutexLocker locker(&s_outputLogMutex);
+      if (s_outputLog.isOpen())
+        s_outputLog.write(string.toUtf8());
+    }
+    if (s_outputSink)
+      s_outputSink(string);
+    else
+      emit get().doPrint(string);
+  }
+  static void setOutputMuted(bool muted) { s_outputMuted = muted; }
+  static void setOutputSink(std::function<void(const QString &)> sink) {
+    s_outputSink = sink;
+  }
+  /// Additionally writes all console output to the file at @p path, or stops
+  /// doing so if @p path is empty. Returns an error message on failure, or an
+  /// empty string on success.
+  static QString setOutputLog(const QString &path) {
+    QMutexLocker locker(&s_outputLogMutex);
+    s_outputLog.close();
+    if (path.isEmpty())
+      return QString();
+    s_outputLog.setFileName(path);
+    if (!s_outputLog.open(QIODevice::WriteOnly | QIODevice::Truncate))
+      return "Error: Could not open console log file " + path;
+    return QString();
+  }
   static void reset() { FileIOData::resetFiles(); }
-  static void abortSyscall() { s_abortSyscall = true; }
+  static void abortSyscall() {
+    QMutexLocker locker(&FileIOData::s_stdioMutex);
+    s_abortSyscall = true;
+    FileIOData::s_stdinBufferEmpty.wakeAll();
+  }
+
+  /**
+   * @brief setStdInCapacity
+   * Bounds the stdin buffer to @p bytes of unread data, beyond which
+   * writeStdIn blocks. 0 leaves the buffer unbounded.
+   */
+  static void setStdInCapacity(int bytes) {
+    QMutexLocker locker(&FileIOData::s_stdioMutex);
+    FileIOData::s_stdinCapacity = bytes;
+    FileIOData::s_stdinBufferFull.wakeAll();
+  }
+
+  /**
+   * @brief writeStdIn
+   * Pushes @p data onto the stdin buffer, blocking while the buffer is full.
+   * Returns false, dropping @p data, if stdin has been closed.
+   */
+  static bool writeStdIn(const QByteArray &data) {
+    QMutexLocker locker(&FileIOData::s_stdioMutex);
+    while (FileIOData::s_stdinCapacity > 0 && !FileIOData::s_stdinClosed &&
+           FileIOData::s_stdinBuffer.size() >= FileIOData::s_stdinCapacity)
+      FileIOData::s_stdinBufferFull.wait(&FileIOData::s_stdioMutex);
+    if (FileIOData::s_stdinClosed)
+      return false;
+    FileIOData::s_stdinBuffer.append(data);
+    FileIOData::s_stdinBufferEmpty.wakeAll();
+    return true;
+  }
+
+  /**
+   * @brief closeStdIn
+   * Signals the end of stdin. Reads return the remaining buffered data, and
+   * then end-of-file.
+   */
+  static void closeStdIn() {
+    QMutexLocker locker(&FileIOData::s_stdioMutex);
+    FileIOData::s_stdinClosed = true;
+    FileIOData::s_stdinBufferEmpty.wakeAll();
+    FileIOData::s_stdinBufferFull.wakeAll();
+  }
+
+  /// Returns the number of reads of stdin by programs since startup, ie. to
+  /// tell whether a program depended on its input.
+  static unsigned long long stdinReads() {
+    QMutexLocker locker(&FileIOData::s_stdioMutex);
+    return FileIOData::s_stdinReads;
+  }
 
 signals:
   void doPrint(const QString &);
@@ -440,12 +577,7 @@ public slots:
    * @brief putStdInData
    * Pushes @p data onto the stdin buffer object
    */
-  void putStdInData(const QByteArray &data) {
-    FileIOData::s_stdioMutex.lock();
-    FileIOData::s_stdinBuffer.append(data);
-    FileIOData::s_stdinBufferEmpty.wakeAll();
-    FileIOData::s_stdioMutex.unlock();
-  }
+  void putStdInData(const QByteArray &data) { writeStdIn(data); }
 
 private:
   SystemIO() { reset(); }
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <QString>
+#include <set>
+#include <vector>
+
+#include "processors/interface/ripesprocessor.h"
+
+namespace Ripes {
+
+/// A data watchpoint on the @p size bytes at @p start, triggering on reads
+/// and/or writes.
+struct Watchpoint {
+  AInt start = 0;
+  AInt size = 1;
+  bool read = false;
+  bool write = true;
+
+  /// Returns true if @p access triggers this watchpoint.
+  bool matches(const MemoryAccess &access) const {
+    const bool triggers = access.type == MemoryAccess::Read    ? read
+                          : access.type == MemoryAccess::Write ? write
+                                                               : false;
+    return triggers && access.address < start + size &&
+           access.address + access.bytes > start;
+  }
+};
+
+/**
+ * @brief The WatchpointSet class
+ * The set of data watchpoints. Given that watchpoints are few, accesses are
+ * matched linearly; the pages overlapped by the watchpoints are used to filter
+ * the accesses which are matched at all (see PagedAddressSpaceMM).
+ */
+class WatchpointSet {
+public:
+  void insert(const Watchpoint &watchpoint) {
+    m_watchpoints.push_back(watchpoint);
+  }
+  void clear() { m_watchpoints.clear(); }
+
+  bool empty() const { return m_watchpoints.empty(); }
+  const std::vector<Watchpoint> &watchpoints() const { return m_watchpoints; }
+
+  /// Returns the first watchpoint triggered by @p access, or nullptr.
+  const Watchpoint *match(const MemoryAccess &access) const {
+    if (access.type == MemoryAccess::None)
+      return nullptr;
+    for (const auto &watchpoint : m_watchpoints) {
+      if (watchpoint.matches(access))
+        return &watchpoint;
+    }
+    return nullptr;
+  }
+
+  /// Returns the numbers of the pages of 2^@p pageBits bytes overlapped by the
+  /// watchpoints.
+  std::set<AInt> pages(unsigned pageBits) const {
+    std::set<AInt> pages;
+    for (const auto &watchpoint : m_watchpoints) {
+      if (watchpoint.size == 0)
+        continue;
+      const AInt last = (watchpoint.start + watchpoint.size - 1) >> pageBits;
+      for (AInt page = watchpoint.start >> pageBits; page <= last; ++page)
+        pages.insert(page);
+    }
+    return pages;
+  }
+
+  /// Returns a description of @p access, as triggering a watchpoint.
+  static QString describe(const MemoryAccess &access) {
+    return QString(access.type == MemoryAccess::Read ? "read" : "write") +
+           " of " + QString::number(access.bytes) + " byte(s) at 0x" +
+           QString::number(access.address, 16);
+  }
+
+private:
+  std::vector<Watchpoint> m_watchpoints;
+};
+
+} // namespace Ripes
@@ -6,6 +6,7 @@
 #include "edittab.h"
 #include "processorhandler.h"
 #include "processorregistry.h"
+#include "ripessettings.h"
 
 #include <optional>
 
@@ -58,4 +59,24 @@ private:
   EditTab *m_editTab = nullptr;
 };
 
+/// Selects and resets processor \p id, and loads \p program into it. If
+/// \p toFinish is set, the processor is clocked until the program finishes.
+inline void runProgram(ProcessorID id, const QStringList &program,
+                       bool toFinish) {
+  ProcessorHandler::get()->selectProcessor(id, {});
+  RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+  ProcessorHandler::get()->getProcessorNonConst()->trapHandler = [=] {};
+
+  auto loader = new ProgramLoader();
+  loader->loadTest(program.join("\n"));
+  if (!toFinish)
+    return;
+
+  auto proc = ProcessorHandler::get()->getProcessorNonConst();
+  while (!proc->finished() && proc->getCycleCount() < 1000)
+    proc->clock();
+  if (!proc->finished())
+    QFAIL("Execution never finished");
+}
+
 } // namespace Ripes
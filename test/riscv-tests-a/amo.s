@@ -0,0 +1,140 @@
+.text
+main:
+  #-------------------------------------------------------------
+  # Atomic memory operation tests, on a word of the stack
+  #-------------------------------------------------------------
+ addi sp, sp, -16
+ mv x1, sp
+
+test_2:
+ li x2, 0x12345678
+ sw x2, 0(x1)
+ li x4, 0x87654321
+ amoswap.w x30, x4, (x1)
+ li x29, 0x12345678
+ li gp, 2
+ bne x30, x29, fail
+ lw x30, 0(x1)
+ li x29, 0x87654321
+ bne x30, x29, fail
+
+test_3:
+ li x4, 0x11111111
+ amoadd.w x30, x4, (x1)
+ li x29, 0x87654321
+ li gp, 3
+ bne x30, x29, fail
+ lw x30, 0(x1)
+ li x29, 0x98765432
+ bne x30, x29, fail
+
+test_4:
+ li x4, 0x0f0f0f0f
+ amoand.w x30, x4, (x1)
+ li x29, 0x98765432
+ li gp, 4
+ bne x30, x29, fail
+ lw x30, 0(x1)
+ li x29, 0x08060402
+ bne x30, x29, fail
+
+test_5:
+ li x4, 0x10000000
+ amoor.w.aq x30, x4, (x1)
+ li x29, 0x08060402
+ li gp, 5
+ bne x30, x29, fail
+ lw x30, 0(x1)
+ li x29, 0x18060402
+ bne x30, x29, fail
+
+test_6:
+ li x4, 0x18060402
+ amoxor.w.rl x30, x4, (x1)
+ li x29, 0x18060402
+ li gp, 6
+ bne x30, x29, fail
+ lw x30, 0(x1)
+ bne x30, x0, fail
+
+test_7:
+ li x2, -5
+ sw x2, 0(x1)
+ li x4, 3
+ amomin.w x30, x4, (x1)
+ li gp, 7
+ bne x30, x2, fail
+ li x4, -7
+ amomin.w x30, x4, (x1)
+ bne x30, x2, fail
+ lw x30, 0(x1)
+ bne x30, x4, fail
+
+test_8:
+ li x2, 3
+ amomax.w.aqrl x30, x2, (x1)
+ li x29, -7
+ li gp, 8
+ bne x30, x29, fail
+ lw x30, 0(x1)
+ bne x30, x2, fail
+
+test_9:
+ li x4, -1
+ amominu.w x30, x4, (x1)
+ li x29, 3
+ li gp, 9
+ bne x30, x29, fail
+ lw x30, 0(x1)
+ bne x30, x29, fail
+
+test_10:
+ amomaxu.w x30, x4, (x1)
+ li x29, 3
+ li gp, 10
+ bne x30, x29, fail
+ lw x30, 0(x1)
+ bne x30, x4, fail
+
+  #-------------------------------------------------------------
+  # Load-reserved/store-conditional tests
+  #-------------------------------------------------------------
+
+test_11:
+ lr.w x30, (x1)
+ li x2, 0xabc
+ sc.w x5, x2, (x1)
+ li gp, 11
+ bne x30, x4, fail
+ bne x5, x0, fail
+ lw x30, 0(x1)
+ bne x30, x2, fail
+
+test_12:
+ # The preceding sc cleared the reservation.
+ sc.w x5, x4, (x1)
+ li x29, 1
+ li gp, 12
+ bne x5, x29, fail
+ lw x30, 0(x1)
+ bne x30, x2, fail
+
+test_13:
+ # An sc to an address other than the reserved one fails.
+ lr.w.aq x30, (x1)
+ addi x6, x1, 4
+ sc.w.rl x5, x4, (x6)
+ li x29, 1
+ li gp, 13
+ bne x5, x29, fail
+ lw x30, 4(x1)
+ beq x30, x4, fail
+
+pass:
+	li a0, 42
+	li a7, 93
+	ecall
+fail:
+	li a0, 0
+	li a7, 93
+	ecall
@@ -0,0 +1,97 @@
+.text
+main:
+  #-------------------------------------------------------------
+  # Double-precision arithmetic, on values converted from integers
+  #-------------------------------------------------------------
+ li x1, 3
+ fcvt.d.w f1, x1
+ li x1, -8
+ fcvt.d.w f2, x1
+
+test_2:
+ fadd.d f3, f1, f2
+ fcvt.w.d x30, f3
+ li x29, -5
+ li gp, 2
+ bne x30, x29, fail
+
+test_3:
+ fdiv.d f3, f2, f1
+ fmul.d f3, f3, f1
+ fcvt.w.d x30, f3
+ li x29, -8
+ li gp, 3
+ bne x30, x29, fail
+
+test_4:
+ fnmsub.d f3, f1, f1, f2 # -(3 * 3) + -8
+ fcvt.w.d x30, f3
+ li x29, -17
+ li gp, 4
+ bne x30, x29, fail
+
+test_5:
+ fsflags x0, x0
+ fsqrt.d f4, f3
+ fclass.d x30, f4
+ li x29, 0x200 # Canonical (quiet) NaN
+ li gp, 5
+ bne x30, x29, fail
+ frflags x30
+ li x29, 0x10 # Invalid operation
+ bne x30, x29, fail
+
+  #-------------------------------------------------------------
+  # Loads, stores and conversions between the formats
+  #-------------------------------------------------------------
+
+test_6:
+ addi sp, sp, -16
+ fsd f2, 8(sp)
+ lw x30, 12(sp)
+ li x29, 0xc0200000 # The upper word of -8.0
+ li gp, 6
+ bne x30, x29, fail
+ lw x30, 8(sp)
+ bne x30, x0, fail
+ fld f4, 8(sp)
+ feq.d x30, f4, f2
+ li x29, 1
+ bne x30, x29, fail
+ addi sp, sp, 16
+
+test_7:
+ fcvt.s.d f5, f2
+ fmv.x.w x30, f5
+ li x29, 0xc1000000 # -8.0f
+ li gp, 7
+ bne x30, x29, fail
+ fcvt.d.s f6, f5
+ feq.d x30, f6, f2
+ li x29, 1
+ bne x30, x29, fail
+
+test_8:
+ # A single-precision operation on a double is on the canonical NaN, since
+ # the double is not NaN-boxed.
+ fclass.s x30, f2
+ li x29, 0x200
+ li gp, 8
+ bne x30, x29, fail
+
+test_9:
+ fsgnjn.d f3, f1, f1
+ fsgnjx.d f4, f3, f2
+ fcvt.w.d x30, f4
+ li x29, 3
+ li gp, 9
+ bne x30, x29, fail
+
+pass:
+	li a0, 42
+	li a7, 93
+	ecall
+fail:
+	li a0, 0
+	li a7, 93
+	ecall
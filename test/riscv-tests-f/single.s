@@ -0,0 +1,149 @@
+.text
+main:
+  #-------------------------------------------------------------
+  # Single-precision arithmetic, on values moved from the integer
+  # registers
+  #-------------------------------------------------------------
+ li x1, 0x3fc00000 # 1.5
+ fmv.w.x f1, x1
+ li x1, 0x40200000 # 2.5
+ fmv.w.x f2, x1
+
+test_2:
+ fadd.s f3, f1, f2
+ fmv.x.w x30, f3
+ li x29, 0x40800000 # 4.0
+ li gp, 2
+ bne x30, x29, fail
+
+test_3:
+ fsub.s f3, f1, f2
+ fmv.x.w x30, f3
+ li x29, 0xbf800000 # -1.0
+ li gp, 3
+ bne x30, x29, fail
+
+test_4:
+ fmul.s f3, f1, f2
+ fmv.x.w x30, f3
+ li x29, 0x40700000 # 3.75
+ li gp, 4
+ bne x30, x29, fail
+
+test_5:
+ fmadd.s f3, f1, f2, f1
+ fmv.x.w x30, f3
+ li x29, 0x40a80000 # 5.25
+ li gp, 5
+ bne x30, x29, fail
+
+test_6:
+ fdiv.s f3, f2, f1
+ fmv.x.w x30, f3
+ li x29, 0x3fd55555 # 5/3, rounded to nearest
+ li gp, 6
+ bne x30, x29, fail
+
+test_7:
+ # Rounding towards zero, by the rounding mode of the instruction
+ fdiv.s f3, f2, f1, rtz
+ fmv.x.w x30, f3
+ li x29, 0x3fd55555
+ li gp, 7
+ bne x30, x29, fail
+ fdiv.s f3, f1, f2, rup
+ fmv.x.w x30, f3
+ li x29, 0x3f19999a # 0.6, rounded up
+ li gp, 7
+ bne x30, x29, fail
+
+  #-------------------------------------------------------------
+  # Comparisons, conversions and sign injection
+  #-------------------------------------------------------------
+
+test_8:
+ flt.s x30, f1, f2
+ li x29, 1
+ li gp, 8
+ bne x30, x29, fail
+ feq.s x30, f1, f2
+ bne x30, x0, fail
+ fle.s x30, f2, f1
+ bne x30, x0, fail
+
+test_9:
+ fcvt.w.s x30, f2, rne
+ li x29, 2
+ li gp, 9
+ bne x30, x29, fail
+ fcvt.w.s x30, f2, rup
+ li x29, 3
+ bne x30, x29, fail
+ fneg.s f3, f2
+ fcvt.w.s x30, f3, rdn
+ li x29, -3
+ bne x30, x29, fail
+
+test_10:
+ li x2, -7
+ fcvt.s.w f3, x2
+ fabs.s f3, f3
+ fmv.x.w x30, f3
+ li x29, 0x40e00000 # 7.0
+ li gp, 10
+ bne x30, x29, fail
+
+test_11:
+ fmin.s f3, f1, f2
+ feq.s x30, f3, f1
+ li x29, 1
+ li gp, 11
+ bne x30, x29, fail
+ fmax.s f3, f1, f2
+ feq.s x30, f3, f2
+ bne x30, x29, fail
+
+test_12:
+ fclass.s x30, f1
+ li x29, 0x40 # Positive normal
+ li gp, 12
+ bne x30, x29, fail
+
+  #-------------------------------------------------------------
+  # Loads and stores, and the accrued exception flags
+  #-------------------------------------------------------------
+
+test_13:
+ addi sp, sp, -16
+ fsw f2, 4(sp)
+ lw x30, 4(sp)
+ li x29, 0x40200000
+ li gp, 13
+ bne x30, x29, fail
+ flw f4, 4(sp)
+ feq.s x30, f4, f2
+ li x29, 1
+ bne x30, x29, fail
+ addi sp, sp, 16
+
+test_14:
+ fsflags x0, x0
+ fdiv.s f3, f2, f1
+ frflags x30
+ li x29, 1 # Inexact
+ li gp, 14
+ bne x30, x29, fail
+ fmv.w.x f3, x0
+ fdiv.s f3, f1, f3
+ frflags x30
+ li x29, 9 # Division by zero, and the preceding inexact
+ bne x30, x29, fail
+
+pass:
+	li a0, 42
+	li a7, 93
+	ecall
+fail:
+	li a0, 0
+	li a7, 93
+	ecall
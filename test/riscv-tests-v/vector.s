@@ -0,0 +1,142 @@
+.text
+main:
+  #-------------------------------------------------------------
+  # Configuration, with the default VLEN of 128 bits
+  #-------------------------------------------------------------
+test_2:
+ csrr x30, vlenb
+ li x29, 16
+ li gp, 2
+ bne x30, x29, fail
+
+test_3:
+ # An AVL of x0 requests VLMAX
+ vsetvli x30, x0, e32, m1, ta, ma
+ li x29, 4
+ li gp, 3
+ bne x30, x29, fail
+ vsetvli x30, x0, e8, m2
+ li x29, 32
+ bne x30, x29, fail
+ csrr x30, vl
+ bne x30, x29, fail
+
+test_4:
+ # The AVL is limited to VLMAX
+ li x1, 3
+ vsetvli x30, x1, e32, m1, ta, ma
+ li x29, 3
+ li gp, 4
+ bne x30, x29, fail
+ vsetivli x30, 31, e64, m1, ta, ma
+ li x29, 2
+ bne x30, x29, fail
+
+test_5:
+ # SEW = 64 with LMUL = 1/2 is unsupported, setting vill
+ vsetvli x30, x0, e64, mf2, ta, ma
+ li gp, 5
+ bne x30, x0, fail
+ csrr x30, vtype
+ bgez x30, fail
+
+  #-------------------------------------------------------------
+  # Loads, arithmetic and stores of four words on the stack
+  #-------------------------------------------------------------
+ addi sp, sp, -16
+ li x1, 1
+ sw x1, 0(sp)
+ li x1, 2
+ sw x1, 4(sp)
+ li x1, 3
+ sw x1, 8(sp)
+ li x1, 4
+ sw x1, 12(sp)
+ vsetivli x0, 4, e32, m1, ta, ma
+ vle32.v v1, (sp)
+
+test_6:
+ vadd.vi v2, v1, 5
+ vse32.v v2, (sp)
+ lw x30, 0(sp)
+ li x29, 6
+ li gp, 6
+ bne x30, x29, fail
+ lw x30, 12(sp)
+ li x29, 9
+ bne x30, x29, fail
+
+test_7:
+ # Reductions, with the initial value of element 0 of vs1
+ vmv.v.i v3, 0
+ vredsum.vs v4, v2, v3
+ vmv.x.s x30, v4
+ li x29, 30
+ li gp, 7
+ bne x30, x29, fail
+
+test_8:
+ li x1, 3
+ vmul.vx v5, v1, x1
+ vredmax.vs v4, v5, v3
+ vmv.x.s x30, v4
+ li x29, 12
+ li gp, 8
+ bne x30, x29, fail
+
+test_9:
+ vsub.vv v6, v2, v1
+ vmv.v.i v7, -1
+ vredand.vs v4, v6, v7
+ vmv.x.s x30, v4
+ li x29, 5
+ li gp, 9
+ bne x30, x29, fail
+
+test_10:
+ # Arithmetic shifts, and the sign extension of vmv.x.s
+ li x1, -16
+ vmv.v.x v7, x1
+ vsra.vi v8, v7, 2
+ vmv.x.s x30, v8
+ li x29, -4
+ li gp, 10
+ bne x30, x29, fail
+ vsrl.vi v8, v7, 28
+ vmv.x.s x30, v8
+ li x29, 15
+ bne x30, x29, fail
+
+test_11:
+ # Elements past vl are undisturbed
+ vsetivli x0, 2, e32, m1, tu, mu
+ vmv.v.i v2, -1
+ vsetivli x0, 4, e32, m1, ta, ma
+ vse32.v v2, (sp)
+ lw x30, 4(sp)
+ li x29, -1
+ li gp, 11
+ bne x30, x29, fail
+ lw x30, 8(sp)
+ li x29, 8
+ bne x30, x29, fail
+
+test_12:
+ # Byte elements of the same memory
+ vsetivli x0, 16, e8, m1, ta, ma
+ vle8.v v9, (sp)
+ vminu.vx v9, v9, x29
+ vredmaxu.vs v4, v9, v3
+ vmv.x.s x30, v4
+ li gp, 12
+ bne x30, x29, fail
+ addi sp, sp, 16
+
+pass:
+	li a0, 42
+	li a7, 93
+	ecall
+fail:
+	li a0, 0
+	li a7, 93
+	ecall
@@ -0,0 +1,86 @@
+.text
+main:
+  #-------------------------------------------------------------
+  # Zicsr instructions and mret, on the machine-mode CSRs
+  #-------------------------------------------------------------
+
+test_2:
+ # csrrw swaps rs1 into the CSR.
+ li x1, 0x1234
+ csrrw x30, mscratch, x1
+ li gp, 2
+ bne x30, x0, fail
+ csrr x30, mscratch
+ bne x30, x1, fail
+
+test_3:
+ # csrrs sets, and csrrc clears, the bits of rs1.
+ li x2, 0x00f0
+ csrrs x30, mscratch, x2
+ li gp, 3
+ bne x30, x1, fail
+ csrr x30, mscratch
+ li x29, 0x12f4
+ bne x30, x29, fail
+ li x2, 0x0204
+ csrrc x30, mscratch, x2
+ bne x30, x29, fail
+ csrr x30, mscratch
+ li x29, 0x10f0
+ bne x30, x29, fail
+
+test_4:
+ # The immediate variants.
+ csrrwi x30, mscratch, 5
+ li gp, 4
+ li x29, 0x10f0
+ bne x30, x29, fail
+ csrrsi x30, mscratch, 0x18
+ li x29, 5
+ bne x30, x29, fail
+ csrrci x30, mscratch, 1
+ li x29, 0x1d
+ bne x30, x29, fail
+ csrr x30, mscratch
+ li x29, 0x1c
+ bne x30, x29, fail
+
+test_5:
+ # Only the writable bits are written: mtvec is aligned (direct mode), and
+ # mstatus holds MIE and MPIE.
+ li x1, 0x1003
+ csrw mtvec, x1
+ csrr x30, mtvec
+ li gp, 5
+ li x29, 0x1000
+ bne x30, x29, fail
+ li x1, -1
+ csrw mstatus, x1
+ csrr x30, mstatus
+ li x29, 0x88
+ bne x30, x29, fail
+ csrw mstatus, x0
+
+test_6:
+ # mret returns to mepc, setting mstatus.MIE from MPIE, and MPIE.
+ la x1, test_6_ret
+ csrw mepc, x1
+ li x2, 0x80
+ csrw mstatus, x2
+ li gp, 6
+ mret
+ j fail
+test_6_ret:
+ csrr x30, mstatus
+ li x29, 0x88
+ bne x30, x29, fail
+ csrw mstatus, x0
+
+pass:
+	li a0, 42
+	li a7, 93
+	ecall
+fail:
+	li a0, 0
+	li a7, 93
+	ecall
@@ -0,0 +1,60 @@
+.text
+main:
+  #-------------------------------------------------------------
+  # Machine timer interrupts, with the timer firing at cycle 1000
+  #-------------------------------------------------------------
+ la x1, handler
+ csrw mtvec, x1
+ mv s1, x0
+ li x2, 0x80
+ csrs mie, x2
+
+test_2:
+ # wfi idles until the timer interrupt is pending, skipping the idle cycles.
+ # The interrupt is not taken while mstatus.MIE is clear.
+ li gp, 2
+ wfi
+ csrr x30, mip
+ li x29, 0x80
+ bne x30, x29, fail
+ rdcycle x30
+ li x29, 1000
+ bltu x30, x29, fail
+ bne s1, x0, fail
+
+test_3:
+ # Setting mstatus.MIE takes the pending interrupt before the next
+ # instruction, which is saved in mepc, with the interrupt cause in mcause.
+ li gp, 3
+ csrsi mstatus, 8
+interrupted:
+ nop
+ li x29, 0x80000007
+ bne s1, x29, fail
+ la x29, interrupted
+ bne s2, x29, fail
+ # The handler runs with MIE clear and MPIE set, and mret sets MIE again.
+ li x29, 0x80
+ bne s3, x29, fail
+ csrr x30, mstatus
+ li x29, 0x88
+ bne x30, x29, fail
+ j pass
+
+handler:
+ csrr s1, mcause
+ csrr s2, mepc
+ csrr s3, mstatus
+ # The timer interrupt remains pending, and is disabled before returning.
+ li t0, 0x80
+ csrc mie, t0
+ mret
+
+pass:
+	li a0, 42
+	li a7, 93
+	ecall
+fail:
+	li a0, 0
+	li a7, 93
+	ecall
@@ -0,0 +1,55 @@
+.text
+main:
+  #-------------------------------------------------------------
+  # Counter CSR tests
+  #-------------------------------------------------------------
+
+test_2:
+ rdcycle x1
+ nop
+ nop
+ rdcycle x2
+ li gp, 2
+ bgeu x1, x2, fail
+
+
+test_3:
+ rdinstret x1
+ nop
+ nop
+ rdinstret x2
+ li gp, 3
+ bgeu x1, x2, fail
+
+
+test_4:
+ rdtime x1
+ nop
+ rdtime x2
+ li gp, 4
+ bgeu x1, x2, fail
+
+
+test_5:
+ csrr x1, 0xc02
+ csrr x2, 0xc00
+ li gp, 5
+ bltu x2, x1, fail
+
+
+test_6:
+ li x1, 1
+ csrr x1, 0xc1f
+ li x29, 0
+ li gp, 6
+ bne x1, x29, fail
+
+
+pass:
+	li a0, 42
+	li a7, 93
+	ecall
+fail:
+	li a0, 0
+	li a7, 93
+	ecall
@@ -8,8 +8,11 @@
 #include "assembler/rv32i_assembler.h"
 #include "assembler/rv64i_assembler.h"
 
+#include "assembler/assemblycache.h"
 #include "processorhandler.h"
 
+#include <QTemporaryDir>
+
 using namespace Ripes;
 using namespace Assembler;
 
@@ -34,6 +37,10 @@ private slots:
   void tst_simpleWithBranch();
   void tst_segment();
   void tst_matcher();
+  void tst_decodeTable();
+  void tst_atomics();
+  void tst_floatingPoint();
+  void tst_vector();
   void tst_label();
   void tst_labelWithPseudo();
   void tst_weirdImmediates();
@@ -47,6 +54,10 @@ private slots:
   void tst_stringDirectives();
   void tst_riscv();
   void tst_relativeLabels();
+  void tst_assemblyCache();
+  void tst_incremental();
+  void tst_parallelPasses();
+  void tst_multiFile();
 
 private:
   QString createProgram(int entries) {
@@ -411,5 +422,310 @@ void tst_Assembler::tst_matcher() {
   }
 }
 
+void tst_Assembler::tst_decodeTable() {
+  // The decode table must yield the instruction which the match tree yields,
+  // for every word.
+  const auto verify = [](const auto &matcher) {
+    uint32_t word = 0x12345678;
+    for (unsigned i = 0; i < 200000; ++i) {
+      word = word * 1664525 + 1013904223;
+      // Exercise compressed encodings as well.
+      const Instr_T instr = (i % 2) ? word : (word & 0xFFFF);
+      const auto tableMatch = matcher.matchInstruction(instr);
+      const auto treeMatch = matcher.matchInstructionByTree(instr);
+      QCOMPARE(tableMatch.index(), treeMatch.index());
+      if (tableMatch.index() == 1)
+        QCOMPARE(std::get<1>(tableMatch), std::get<1>(treeMatch));
+    }
+  };
+
+  auto isa32 = std::make_unique<ISAInfo<ISA::RV32I>>(
+      QStringList{"M", "A", "F", "D", "C", "V"});
+  auto assembler32 = RV32I_Assembler(isa32.get());
+  verify(assembler32.getMatcher());
+
+  auto isa64 = std::make_unique<ISAInfo<ISA::RV64I>>(
+      QStringList{"M", "A", "F", "D", "C", "V"});
+  auto assembler64 = RV64I_Assembler(isa64.get());
+  verify(assembler64.getMatcher());
+}
+
+void tst_Assembler::tst_atomics() {
+  // Each instruction must assemble to its encoding, and the encoding must
+  // match back to the instruction.
+  const auto verify = [](auto &assembler, const QString &instr,
+                         uint32_t expected) {
+    auto res = assembler.assemble(QStringList{instr});
+    if (res.errors.size() != 0) {
+      res.errors.print();
+      QFAIL(("Failed to assemble: " + instr).toStdString().c_str());
+    }
+    const QByteArray &text = res.program.getSection(".text")->data;
+    QCOMPARE(text.size(), 4);
+    uint32_t word = 0;
+    for (int i = 0; i < 4; ++i)
+      word |= static_cast<uint32_t>(static_cast<uint8_t>(text.at(i)))
+              << (8 * i);
+    QCOMPARE(word, expected);
+
+    const auto match = assembler.getMatcher().matchInstruction(word);
+    QVERIFY(std::get_if<Error>(&match) == nullptr);
+    QCOMPARE(std::get<1>(match)->name(), instr.split(' ').at(0));
+  };
+
+  auto isa32 = std::make_unique<ISAInfo<ISA::RV32I>>(QStringList{"A"});
+  auto assembler32 = RV32I_Assembler(isa32.get());
+  verify(assembler32, "amoadd.w a0, a1, (a2)", 0x00b6252f);
+  verify(assembler32, "lr.w.aq a0, (a1)", 0x1405a52f);
+  verify(assembler32, "sc.w.rl a0, a1, (a2)", 0x1ab6252f);
+  verify(assembler32, "amoswap.w.aqrl a0, a1, (a2)", 0x0eb6252f);
+
+  auto isa64 = std::make_unique<ISAInfo<ISA::RV64I>>(QStringList{"A"});
+  auto assembler64 = RV64I_Assembler(isa64.get());
+  verify(assembler64, "amomaxu.d a0, a1, (a2)", 0xe0b6352f);
+
+  // Doubleword atomics are only available in RV64.
+  QVERIFY(assembler32.assemble(QStringList{"amomaxu.d a0, a1, (a2)"})
+              .errors.size() != 0);
+}
+
+void tst_Assembler::tst_floatingPoint() {
+  const auto verify = [](auto &assembler, const QString &instr,
+                         uint32_t expected) {
+    auto res = assembler.assemble(QStringList{instr});
+    if (res.errors.size() != 0) {
+      res.errors.print();
+      QFAIL(("Failed to assemble: " + instr).toStdString().c_str());
+    }
+    const QByteArray &text = res.program.getSection(".text")->data;
+    QCOMPARE(text.size(), 4);
+    uint32_t word = 0;
+    for (int i = 0; i < 4; ++i)
+      word |= static_cast<uint32_t>(static_cast<uint8_t>(text.at(i)))
+              << (8 * i);
+    QCOMPARE(word, expected);
+
+    const auto match = assembler.getMatcher().matchInstruction(word);
+    QVERIFY(std::get_if<Error>(&match) == nullptr);
+    QCOMPARE(std::get<1>(match)->name(), instr.split(' ').at(0));
+  };
+
+  auto isa32 = std::make_unique<ISAInfo<ISA::RV32I>>(QStringList{"F", "D"});
+  auto assembler32 = RV32I_Assembler(isa32.get());
+  // Without a rounding mode, instructions round with the dynamic rounding mode.
+  verify(assembler32, "fadd.s fa0, fa1, fa2", 0x00c5f553);
+  verify(assembler32, "fmadd.d fa0, fa1, fa2, fa3, rtz", 0x6ac59543);
+  verify(assembler32, "flw fa0, 8(a1)", 0x0085a507);
+  verify(assembler32, "fsd fa0, 8(a1)", 0x00a5b427);
+  verify(assembler32, "fcvt.w.s a0, fa1, rtz", 0xc0059553);
+  verify(assembler32, "fmv.x.w a0, fa1", 0xe0058553);
+  verify(assembler32, "fcvt.s.d fa0, fa1", 0x4015f553);
+
+  // Floating-point operands must be floating-point registers, and the moves
+  // of doubles to and from the integer registers are only available in RV64.
+  QVERIFY(assembler32.assemble(QStringList{"fadd.s a0, fa1, fa2"})
+              .errors.size() != 0);
+  QVERIFY(assembler32.assemble(QStringList{"fmv.x.d a0, fa1"}).errors.size() !=
+          0);
+  QVERIFY(assembler32.assemble(QStringList{"fadd.s fa0, fa1, fa2, rmx"})
+              .errors.size() != 0);
+
+  testAssemble({".data", ".float 1.5", ".double -2"}, Expect::Success,
+               QByteArray::fromHex("0000c03f00000000000000c0"));
+}
+
+void tst_Assembler::tst_vector() {
+  auto isa = std::make_unique<ISAInfo<ISA::RV32I>>(QStringList{"V"});
+  auto assembler = RV32I_Assembler(isa.get());
+  const auto assemble = [&](const QString &instr) {
+    auto res = assembler.assemble(QStringList{instr});
+    if (res.errors.size() != 0) {
+      res.errors.print();
+      return QByteArray();
+    }
+    return res.program.getSection(".text")->data;
+  };
+  QCOMPARE(assemble("vsetvli t0, a0, e32, m1, ta, ma"),
+           QByteArray::fromHex("d772050d"));
+  // Without the policies, vsetvli is tail and mask undisturbed.
+  QCOMPARE(assemble("vsetvli t0, a0, e32, m1"),
+           QByteArray::fromHex("d7720501"));
+  QCOMPARE(assemble("vle32.v v1, (a0)"), QByteArray::fromHex("87600502"));
+  QCOMPARE(assemble("vadd.vv v1, v2, v3"), QByteArray::fromHex("d7802102"));
+  QCOMPARE(assemble("vmv.x.s a0, v1"), QByteArray::fromHex("57251042"));
+
+  QVERIFY(assembler.assemble(QStringList{"vadd.vv v1, v2, x3"}).errors.size() !=
+          0);
+  QVERIFY(assembler.assemble(QStringList{"vsetvli t0, a0, e128, m1"})
+              .errors.size() != 0);
+}
+
+void tst_Assembler::tst_incremental() {
+  auto isa = std::make_unique<ISAInfo<ISA::RV32I>>(QStringList());
+  auto reference = RV32I_Assembler(isa.get());
+  auto incremental = RV32I_Assembler(isa.get());
+  incremental.setIncremental(true);
+
+  // Each edit must assemble as if assembled from scratch.
+  QStringList program = createProgram(10).split('\n');
+  const auto verify = [&] {
+    const auto expected = reference.assemble(program);
+    const auto res = incremental.assemble(program);
+    QCOMPARE(res.errors.size(), expected.errors.size());
+    if (!expected.errors.empty())
+      return;
+    QCOMPARE(res.program.entryPoint, expected.program.entryPoint);
+    QCOMPARE(res.program.getSection(".text")->data,
+             expected.program.getSection(".text")->data);
+    QCOMPARE(res.program.getSection(".data")->data,
+             expected.program.getSection(".data")->data);
+    QCOMPARE(res.program.symbols, expected.program.symbols);
+    QCOMPARE(res.program.sourceMapping, expected.program.sourceMapping);
+  };
+  verify();
+  // A comment
+  program.last() += " # comment";
+  verify();
+  // An instruction
+  program.last() = "addi a0 a0 2";
+  verify();
+  // A line, shifting the lines which follow it
+  program.insert(program.indexOf(".text") + 1, "nop");
+  verify();
+  // An invalid line, and its removal
+  program.insert(1, "a: b c: d");
+  verify();
+  program.removeAt(1);
+  verify();
+}
+
+void tst_Assembler::tst_assemblyCache() {
+  auto isa = std::make_unique<ISAInfo<ISA::RV32I>>(QStringList());
+  auto isaM = std::make_unique<ISAInfo<ISA::RV32I>>(QStringList{"M"});
+  auto assembler = RV32I_Assembler(isa.get());
+  auto assemblerM = RV32I_Assembler(isaM.get());
+  const QString program = createProgram(10);
+  auto &cache = AssemblyCache::get();
+  QTemporaryDir diskCache;
+  cache.setDiskCacheDirectory(diskCache.path());
+  cache.clear();
+
+  const auto reference = assembler.assembleRaw(program).program;
+  const auto verify = [&](const AssembleResult &res) {
+    QVERIFY(res.errors.empty());
+    QCOMPARE(res.program.entryPoint, reference.entryPoint);
+    QCOMPARE(res.program.getSection(".text")->data,
+             reference.getSection(".text")->data);
+    QCOMPARE(res.program.getSection(".data")->data,
+             reference.getSection(".data")->data);
+    QCOMPARE(res.program.symbols.size(), reference.symbols.size());
+    QCOMPARE(res.program.sourceMapping, reference.sourceMapping);
+  };
+
+  const auto misses = cache.misses();
+  const auto hits = cache.hits();
+  verify(cache.assemble(assembler, program));
+  QCOMPARE(cache.misses(), misses + 1);
+  verify(cache.assemble(assembler, program));
+  QCOMPARE(cache.hits(), hits + 1);
+
+  // Programs are keyed on the ISA extensions of the assembler.
+  verify(cache.assemble(assemblerM, program));
+  QCOMPARE(cache.misses(), misses + 2);
+
+  // Programs are restored from disk once evicted from memory.
+  cache.clear();
+  verify(cache.assemble(assembler, program));
+  QCOMPARE(cache.hits(), hits + 2);
+  cache.setDiskCacheDirectory(QString());
+}
+
+void tst_Assembler::tst_parallelPasses() {
+  // Large enough for the lexing and expansion passes to run in parallel.
+  auto isa = std::make_unique<ISAInfo<ISA::RV32I>>(QStringList());
+  auto assembler = RV32I_Assembler(isa.get());
+  const int entries = 10000;
+  const auto res = assembler.assembleRaw(createProgram(entries));
+  QVERIFY(res.errors.empty());
+  QCOMPARE(res.program.getSection(".text")->data.size(), entries * 3 * 4);
+  QCOMPARE(res.program.getSection(".data")->data.size(), entries * 4 * 4);
+
+  // Errors are reported in source order, whichever thread lexed their line.
+  QStringList program = createProgram(entries).split('\n');
+  std::vector<int> errorLines;
+  for (int line = 1; line < program.size(); line += 997) {
+    program[line] = "a: b c: d";
+    errorLines.push_back(line);
+  }
+  const auto failed = assembler.assemble(program);
+  QCOMPARE(failed.errors.size(), errorLines.size());
+  for (size_t i = 0; i < errorLines.size(); ++i)
+    QCOMPARE(static_cast<int>(failed.errors.at(i).sourceLine()),
+             errorLines.at(i));
+}
+
+void tst_Assembler::tst_multiFile() {
+  auto isa = std::make_unique<ISAInfo<ISA::RV32I>>(QStringList());
+  auto reference = RV32I_Assembler(isa.get());
+  auto assembler = RV32I_Assembler(isa.get());
+
+  // The sections of the first file span whole object alignments, such that
+  // the linked program equals the concatenation of the files.
+  std::vector<SourceFile> files = {
+      {"main.s", ".text\njal ra helper\nla a0 value\nlw a1 0(a0)\n"},
+      {"lib.s", ".data\nvalue: .word 42\n.text\nhelper: addi a0 a0 1\nret"}};
+  const auto verify = [&] {
+    QString concatenated;
+    for (const auto &file : files)
+      concatenated += file.text + "\n";
+    const auto expected = reference.assembleRaw(concatenated);
+    const auto res = assembler.assembleFiles(files);
+    if (!res.errors.empty())
+      res.errors.print();
+    QVERIFY(expected.errors.empty());
+    QVERIFY(res.errors.empty());
+    QCOMPARE(res.program.entryPoint, expected.program.entryPoint);
+    QCOMPARE(res.program.getSection(".text")->data,
+             expected.program.getSection(".text")->data);
+    QCOMPARE(res.program.getSection(".data")->data,
+             expected.program.getSection(".data")->data);
+    QCOMPARE(res.program.symbols, expected.program.symbols);
+    QCOMPARE(res.program.sourceMapping, expected.program.sourceMapping);
+  };
+  verify();
+  QCOMPARE(assembler.objectsAssembled(), 2ULL);
+
+  // Editing a file reassembles only that file; the library is moved.
+  files[0].text += "nop\nnop\nnop\nnop\n";
+  verify();
+  QCOMPARE(assembler.objectsAssembled(), 3ULL);
+  QCOMPARE(assembler.objectsReused(), 1ULL);
+
+  // Unless the library depends on its placement.
+  files[1].text += "\n.data\npointer: .word helper";
+  verify();
+  QCOMPARE(assembler.objectsAssembled(), 4ULL);
+  files[0].text += "nop\nnop\nnop\nnop\n";
+  verify();
+  QCOMPARE(assembler.objectsAssembled(), 6ULL);
+
+  // Errors are reported at their line in the concatenated files.
+  const int mainLines = files[0].text.split('\n').size();
+  files[1].text += "\na: b c: d";
+  const auto failed = assembler.assembleFiles(files);
+  QCOMPARE(failed.errors.size(), 1UL);
+  QCOMPARE(static_cast<int>(failed.errors.front().sourceLine()),
+           mainLines + files[1].text.split('\n').size() - 1);
+  QVERIFY(failed.errors.front().errorMessage().startsWith("lib.s: "));
+
+  // Symbols are shared between files, and defined once.
+  files[1].text = ".data\nvalue: .word 42\n.text\nhelper: nop";
+  files.push_back({"other.s", "helper: nop"});
+  const auto duplicate = assembler.assembleFiles(files);
+  QCOMPARE(duplicate.errors.size(), 1UL);
+  QVERIFY(duplicate.errors.front().errorMessage().contains(
+      "Multiple definitions of symbol 'helper'"));
+}
+
 QTEST_APPLESS_MAIN(tst_Assembler)
 #include "tst_assembler.moc"
@@ -0,0 +1,104 @@
+#include <QStringList>
+#include <QtEndian>
+#include <QtTest/QTest>
+
+#include <functional>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "programloader.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+Q_DECLARE_METATYPE(std::function<void(Ripes::AInt)>)
+
+class tst_BlockTranslation : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_self_modifying_code();
+  void tst_external_writes_data();
+  void tst_external_writes();
+};
+
+// Encoding of "li a2 2", ie. "addi a2 zero 2".
+static constexpr uint32_t s_liA2_2 = 0x00200613;
+
+static VInt a2() {
+  return ProcessorHandler::get()->getRegisterValue(RegisterFileType::GPR, 12);
+}
+
+// Clocks the current processor in batches until it finishes.
+static void clockToFinish() {
+  auto *proc = ProcessorHandler::get()->getProcessorNonConst();
+  while (!proc->finished() && proc->getCycleCount() < 100000)
+    proc->clockBatch(1000);
+  QVERIFY(proc->finished());
+}
+
+// Ensures that a store patching an instruction of the executing block takes
+// effect on the next execution of the instruction.
+void tst_BlockTranslation::tst_self_modifying_code() {
+  QStringList program = QStringList() << ".text"
+                                      << "la a0 target"
+                                      << "la a1 patch"
+                                      << "lw t0 0 a1"
+                                      << "li t1 2"
+                                      << "target:"
+                                      << "li a2 1"
+                                      << "addi a3 a3 1"
+                                      << "sw t0 0 a0"
+                                      << "blt a3 t1 target"
+                                      << "j end"
+                                      << "patch:"
+                                      << "li a2 2"
+                                      << "end:";
+  runProgram(ProcessorID::RV32_ISS, program, false);
+  clockToFinish();
+  QCOMPARE(a2(), VInt(2));
+}
+
+void tst_BlockTranslation::tst_external_writes_data() {
+  using Write = std::function<void(AInt)>;
+  QTest::addColumn<Write>("write");
+  QTest::newRow("writeMem") << Write([](AInt address) {
+    ProcessorHandler::writeMem(address, s_liA2_2, 4);
+  });
+  QTest::newRow("writeMemBlock") << Write([](AInt address) {
+    const uint32_t instr = qToLittleEndian(s_liA2_2);
+    ProcessorHandler::writeMemBlock(
+        address, reinterpret_cast<const char *>(&instr), sizeof(instr));
+  });
+  QTest::newRow("fillMem") << Write([](AInt address) {
+    const uint32_t instr = qToLittleEndian(s_liA2_2);
+    ProcessorHandler::fillMem(
+        address, sizeof(instr),
+        QByteArray(reinterpret_cast<const char *>(&instr), sizeof(instr)));
+  });
+}
+
+// Ensures that instructions written through the memory accessors of the
+// ProcessorHandler, as by system calls, debuggers and the memory view, replace
+// the translated instructions of a loop.
+void tst_BlockTranslation::tst_external_writes() {
+  QFETCH(std::function<void(AInt)>, write);
+  QStringList program = QStringList() << ".text"
+                                      << "li t1 1000"
+                                      << "loop:"
+                                      << "li a2 1"
+                                      << "addi a3 a3 1"
+                                      << "blt a3 t1 loop";
+  runProgram(ProcessorID::RV32_ISS, program, false);
+  auto *proc = ProcessorHandler::get()->getProcessorNonConst();
+  proc->clockBatch(100);
+  QCOMPARE(a2(), VInt(1));
+
+  write(ProcessorHandler::getTextStart() + 4);
+  clockToFinish();
+  QCOMPARE(a2(), VInt(2));
+}
+
+QTEST_MAIN(tst_BlockTranslation)
+#include "tst_blocktranslation.moc"
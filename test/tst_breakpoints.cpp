@@ -0,0 +1,91 @@
+#include <QStringList>
+#include <QtTest/QTest>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "breakpointset.h"
+#include "programloader.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+class tst_Breakpoints : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_breakpoint_set();
+  void tst_breakpoint_condition();
+};
+
+// Ensures that breakpoints within and outside of the bitmap range are found,
+// also as the range changes.
+void tst_Breakpoints::tst_breakpoint_set() {
+  BreakpointSet bps;
+  QVERIFY(bps.empty());
+  bps.insert(0x104);
+  bps.setRange(0x100, 0x200);
+  bps.insert(0x1fe);
+  bps.insert(0x300);
+  QVERIFY(bps.contains(0x104));
+  QVERIFY(bps.contains(0x1fe));
+  QVERIFY(bps.contains(0x300));
+  QVERIFY(!bps.contains(0x100));
+  QVERIFY(!bps.contains(0x105));
+  QVERIFY(!bps.contains(0x2fe));
+
+  bps.setRange(0x200, 0x400);
+  QVERIFY(bps.contains(0x104));
+  QVERIFY(bps.contains(0x300));
+  bps.erase(0x104);
+  bps.erase(0x300);
+  QVERIFY(!bps.contains(0x104));
+  QVERIFY(!bps.contains(0x300));
+  QCOMPARE(bps.addresses(), std::set<AInt>({0x1fe}));
+  bps.clear();
+  QVERIFY(bps.empty());
+  QVERIFY(!bps.contains(0x1fe));
+}
+
+// Ensures that conditional breakpoints and hit counts trigger at the expected
+// iteration of a loop, and that invalid conditions are rejected.
+void tst_Breakpoints::tst_breakpoint_condition() {
+  QStringList program = QStringList() << ".data"
+                                      << "x: .word 7"
+                                      << ".text"
+                                      << "li a0 0"
+                                      << "loop:"
+                                      << "addi a0 a0 1"
+                                      << "li t0 10"
+                                      << "blt a0 t0 loop";
+  runProgram(ProcessorID::RV32_ISS, program, false);
+  const AInt bp = ProcessorHandler::getTextStart() + 8;
+  auto a0 = [] {
+    return ProcessorHandler::get()->getRegisterValue(RegisterFileType::GPR, 10);
+  };
+
+  QVERIFY(!ProcessorHandler::setBreakpointCondition(bp, "a0 ==").isEmpty());
+  QVERIFY(!ProcessorHandler::setBreakpointCondition(bp, "y > 1").isEmpty());
+  QCOMPARE(ProcessorHandler::setBreakpointCondition(bp, "a0 == 3"), QString());
+  ProcessorHandler::clock(1000);
+  ProcessorHandler::waitForIdle();
+  QCOMPARE(a0(), VInt(3));
+
+  RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+  QCOMPARE(ProcessorHandler::setBreakpointCondition(bp, "", 5), QString());
+  ProcessorHandler::clock(1000);
+  ProcessorHandler::waitForIdle();
+  QCOMPARE(a0(), VInt(5));
+
+  RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+  QCOMPARE(ProcessorHandler::setBreakpointCondition(
+               bp, "(mem[x] == 7 && a0 >= 2) || a0 < 0"),
+           QString());
+  ProcessorHandler::clock(1000);
+  ProcessorHandler::waitForIdle();
+  QCOMPARE(a0(), VInt(2));
+  ProcessorHandler::clearBreakpoints();
+}
+
+QTEST_MAIN(tst_Breakpoints)
+#include "tst_breakpoints.moc"
@@ -0,0 +1,224 @@
+#include <QStringList>
+#include <QtTest/QTest>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "cli/cachehierarchy.h"
+#include "programloader.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+class tst_CacheHierarchy : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_parse_level();
+  void tst_shared_levels();
+  void tst_warm_caches_data();
+  void tst_warm_caches();
+  void tst_traffic_data();
+  void tst_traffic();
+  void cleanup();
+};
+
+void tst_CacheHierarchy::cleanup() { ProcessorHandler::setCacheWarming(false); }
+
+// Loads 16 consecutive words, twice.
+static const QStringList s_program = QStringList() << ".data"
+                                                   << "a: .zero 64"
+                                                   << ".text"
+                                                   << "li t2 2"
+                                                   << "outer:"
+                                                   << "la a0 a"
+                                                   << "li t0 16"
+                                                   << "inner:"
+                                                   << "lw a1 0 a0"
+                                                   << "addi a0 a0 4"
+                                                   << "addi t0 t0 -1"
+                                                   << "bnez t0 inner"
+                                                   << "addi t2 t2 -1"
+                                                   << "bnez t2 outer";
+
+// Clocks the current processor until it finishes.
+static void clockToFinish() {
+  auto *proc = ProcessorHandler::get()->getProcessorNonConst();
+  while (!proc->finished() && proc->getCycleCount() < 10000)
+    proc->clock();
+  QVERIFY(proc->finished());
+}
+
+void tst_CacheHierarchy::tst_parse_level() {
+  CacheLevelConfig config;
+  QVERIFY(parseCacheLevelConfig("lines=64,ways=2,blocks=4,latency=10,wp=wt",
+                                config)
+              .isEmpty());
+  QCOMPARE(config.preset.lines, 6);
+  QCOMPARE(config.preset.ways, 1);
+  QCOMPARE(config.preset.blocks, 2);
+  QCOMPARE(config.latency, 10u);
+  QCOMPARE(config.preset.wrPolicy, WritePolicy::WriteThrough);
+  // Unspecified keys retain their value.
+  QVERIFY(parseCacheLevelConfig("ways=4", config).isEmpty());
+  QCOMPARE(config.preset.lines, 6);
+  QCOMPARE(config.preset.ways, 2);
+
+  QVERIFY(!parseCacheLevelConfig("lines=48", config).isEmpty());
+  QVERIFY(!parseCacheLevelConfig("size=64", config).isEmpty());
+  QVERIFY(!parseCacheLevelConfig("repl=mru", config).isEmpty());
+}
+
+// Ensures that the misses of the L1 caches are served by the shared L2 cache,
+// and that the stall estimate accounts for the latency of each level.
+void tst_CacheHierarchy::tst_shared_levels() {
+  runProgram(ProcessorID::RV32_5S, s_program, false);
+  CacheHierarchyConfig config;
+  QVERIFY(parseCacheLevelConfig("lines=64,blocks=4", config.l1i.emplace())
+              .isEmpty());
+  // Each line of the direct mapped L1D cache holds 2 of the words, such that
+  // every load misses.
+  QVERIFY(parseCacheLevelConfig("lines=8,ways=1,blocks=1,latency=1",
+                                config.l1d.emplace())
+              .isEmpty());
+  QVERIFY(parseCacheLevelConfig("lines=64,ways=2,blocks=1,latency=10",
+                                config.l2.emplace())
+              .isEmpty());
+  config.memLatency = 100;
+  CacheHierarchy hierarchy;
+  hierarchy.build(config);
+  QCOMPARE(hierarchy.levels().size(), size_t(3));
+  clockToFinish();
+
+  const auto &levels = hierarchy.levels();
+  const auto &l1i = levels.at(0).cache;
+  const auto &l1d = levels.at(1).cache;
+  const auto &l2 = levels.at(2).cache;
+  QCOMPARE(levels.at(2).name, QString("L2"));
+  QCOMPARE(l1d->getMisses(), 32u);
+  QCOMPARE(l1d->getHits(), 0u);
+  QCOMPARE(l2->getHits() + l2->getMisses(),
+           l1i->getMisses() + l1d->getMisses());
+  // The second pass over the words hits in the L2 cache.
+  QVERIFY(l2->getHits() >= 16);
+
+  long long expected = 0;
+  for (const auto &cache : {l1i, l1d, l2})
+    expected += static_cast<long long>(cache->getHits() + cache->getMisses()) *
+                cache->getLatency();
+  expected += static_cast<long long>(l2->getMisses()) * 100;
+  QCOMPARE(hierarchy.estimatedStallCycles(), expected);
+
+  const QVariantMap report = hierarchy.report(1);
+  QCOMPARE(report.value("L1D").toMap().value("misses").toUInt(), 32u);
+  QCOMPARE(report.value("L2").toMap().value("hits").toUInt(), l2->getHits());
+}
+
+void tst_CacheHierarchy::tst_warm_caches_data() {
+  QTest::addColumn<bool>("warm");
+  QTest::addColumn<unsigned>("misses");
+  QTest::newRow("cold") << false << 4u;
+  QTest::newRow("warm") << true << 0u;
+}
+
+// Ensures that fast-forwarding with cache warming leaves the lines accessed by
+// the fast-forwarded instructions in the caches, without recording statistics
+// for the fast-forwarded accesses.
+void tst_CacheHierarchy::tst_warm_caches() {
+  QFETCH(bool, warm);
+  QFETCH(unsigned, misses);
+  runProgram(ProcessorID::RV32_5S, s_program, false);
+  CacheHierarchyConfig config;
+  QVERIFY(parseCacheLevelConfig("lines=64,blocks=4", config.l1i.emplace())
+              .isEmpty());
+  // The 16 words occupy 4 of the lines of the L1D cache.
+  QVERIFY(parseCacheLevelConfig("lines=8,ways=1,blocks=4",
+                                config.l1d.emplace())
+              .isEmpty());
+  QVERIFY(parseCacheLevelConfig("lines=64,ways=2,blocks=4",
+                                config.l2.emplace())
+              .isEmpty());
+  CacheHierarchy hierarchy;
+  hierarchy.build(config);
+  const auto &l1d = hierarchy.levels().at(1).cache;
+  const auto &l2 = hierarchy.levels().at(2).cache;
+
+  // Fast-forward through the first pass over the words.
+  ProcessorHandler::setCacheWarming(warm);
+  bool finished = false;
+  const QString err = ProcessorHandler::fastForward(70, finished);
+  ProcessorHandler::setCacheWarming(false);
+  QVERIFY2(err.isEmpty(), qPrintable(err));
+  QVERIFY(!finished);
+  QCOMPARE(l1d->getHits() + l1d->getMisses(), 0u);
+  QCOMPARE(l2->getHits() + l2->getMisses(), 0u);
+
+  clockToFinish();
+  QCOMPARE(l1d->getMisses(), misses);
+  QCOMPARE(l1d->getHits(), 16u - misses);
+  QCOMPARE(l2->getHits() + l2->getMisses(),
+           hierarchy.levels().at(0).cache->getMisses() + misses);
+}
+
+void tst_CacheHierarchy::tst_traffic_data() {
+  QTest::addColumn<QString>("l1d");
+  QTest::addColumn<double>("bytesRead");
+  QTest::addColumn<double>("bytesWritten");
+  // The loaded and stored words occupy 4 lines each. Every store is written
+  // through as a word.
+  QTest::newRow("write-through")
+      << QString("lines=8,ways=1,blocks=4,wp=wt") << 8 * 16.0 << 16 * 4.0;
+  // The stored lines conflict with the loaded lines, such that every access
+  // misses, and the loads of all but the first word of each line evict a
+  // modified line.
+  QTest::newRow("write-back")
+      << QString("lines=4,ways=1,blocks=4") << 32 * 16.0 << 12 * 16.0;
+}
+
+// Ensures that the bytes read from, and written to, the level below a cache
+// are the lines filled and written back, or the words written through, and
+// that the traffic to memory is that of the last level cache.
+void tst_CacheHierarchy::tst_traffic() {
+  QFETCH(QString, l1d);
+  QFETCH(double, bytesRead);
+  QFETCH(double, bytesWritten);
+  QStringList program = QStringList() << ".data"
+                                      << "a: .zero 128"
+                                      << ".text"
+                                      << "la a0 a"
+                                      << "li t0 16"
+                                      << "loop:"
+                                      << "lw a1 0 a0"
+                                      << "sw a1 64 a0"
+                                      << "addi a0 a0 4"
+                                      << "addi t0 t0 -1"
+                                      << "bnez t0 loop";
+  runProgram(ProcessorID::RV32_5S, program, false);
+  CacheHierarchyConfig config;
+  QVERIFY(parseCacheLevelConfig(l1d, config.l1d.emplace()).isEmpty());
+  CacheHierarchy hierarchy;
+  hierarchy.build(config);
+  clockToFinish();
+
+  const long long cycles = ProcessorHandler::getProcessor()->getCycleCount();
+  const QVariantMap level = hierarchy.report(cycles).value("L1D").toMap();
+  QCOMPARE(level.value("bytes read").toDouble(), bytesRead);
+  QCOMPARE(level.value("bytes written").toDouble(), bytesWritten);
+  QCOMPARE(level.value("bandwidth (bytes/cycle)").toDouble(),
+           (bytesRead + bytesWritten) / cycles);
+
+  const QVariantMap memory = hierarchy.memoryReport(cycles);
+  QCOMPARE(memory.value("bytes read").toDouble(), bytesRead);
+  QCOMPARE(memory.value("bytes written").toDouble(), bytesWritten);
+  // No interval of the access history transfers more than all of the bytes.
+  const double peak = memory.value("peak bandwidth (bytes/cycle)").toDouble();
+  const unsigned interval =
+      memory.value("bandwidth interval (cycles)").toUInt();
+  QVERIFY(interval >= 1);
+  QVERIFY(peak > 0);
+  QVERIFY(peak * interval <= bytesRead + bytesWritten);
+  QCOMPARE(level.value("peak bandwidth (bytes/cycle)").toDouble(), peak);
+}
+
+QTEST_MAIN(tst_CacheHierarchy)
+#include "tst_cachehierarchy.moc"
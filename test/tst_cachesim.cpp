@@ -0,0 +1,392 @@
+#include <QStringList>
+#include <QtTest/QTest>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "cachesim/cachesim.h"
+#include "cachesim/l1cacheshim.h"
+#include "programloader.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+class tst_CacheSim : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_cache_history();
+  void tst_cache_replacement_data();
+  void tst_cache_replacement();
+  void tst_cache_srrip_invalidation();
+  void tst_cache_timing();
+  void tst_cache_prefetch();
+  void tst_cache_victim();
+  void tst_cache_inclusion();
+  void tst_cache_rv64();
+  void tst_cache_line_view();
+};
+
+// Ensures that the cache access history stays within the configured bounds,
+// while the access statistics remain exact.
+void tst_CacheSim::tst_cache_history() {
+  constexpr int capacity = 16;
+  const QVariant oldCapacity =
+      RipesSettings::value(RIPES_SETTING_CACHE_MAXCYCLES);
+  RipesSettings::setValue(RIPES_SETTING_CACHE_MAXCYCLES, capacity);
+  ProcessorHandler::get()->selectProcessor(ProcessorID::RV32_5S, {});
+  ProcessorHandler::get()->getProcessorNonConst()->trapHandler = [=] {};
+
+  auto shim =
+      std::make_shared<L1CacheShim>(L1CacheShim::CacheType::DataCache, nullptr);
+  auto cache = std::make_shared<CacheSim>(nullptr);
+  shim->setNextLevelCache(cache);
+
+  auto loader = new ProgramLoader();
+  loader->loadTest(QStringList({".data", "a: .word 0", ".text", "la a0 a",
+                                "loop:", "lw a1 0 a0", "addi a1 a1 1",
+                                "sw a1 0 a0", "j loop"})
+                       .join("\n"));
+  RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+  auto proc = ProcessorHandler::get()->getProcessorNonConst();
+  for (unsigned i = 0; i < 2000; ++i)
+    proc->clock();
+
+  const auto &history = cache->getAccessHistory();
+  QVERIFY(history.size() <= static_cast<size_t>(capacity));
+  QVERIFY(cache->getAccessHistoryResolution() > 1);
+  for (size_t i = 1; i < history.size(); ++i)
+    QVERIFY(history[i - 1].cycle < history[i].cycle);
+  QCOMPARE(static_cast<unsigned>(history.back().stats.accesses()),
+           cache->getHits() + cache->getMisses());
+  QVERIFY(cache->getHits() + cache->getMisses() > 0);
+
+  RipesSettings::setValue(RIPES_SETTING_CACHE_MAXCYCLES, oldCapacity);
+}
+
+void tst_CacheSim::tst_cache_replacement_data() {
+  QTest::addColumn<int>("policy");
+  QTest::addColumn<VInt>("victim");
+  // Accessing blocks 1, 2, 3, 4, 1, 5 of a 4-way cache line evicts the
+  // following blocks.
+  QTest::newRow("LRU") << static_cast<int>(ReplPolicy::LRU) << VInt(2);
+  QTest::newRow("Tree-PLRU") << static_cast<int>(ReplPolicy::PLRU) << VInt(3);
+  QTest::newRow("FIFO") << static_cast<int>(ReplPolicy::FIFO) << VInt(1);
+  QTest::newRow("SRRIP") << static_cast<int>(ReplPolicy::SRRIP) << VInt(2);
+}
+
+// Ensures that each replacement policy selects the expected victim, and that
+// undoing an access restores the replacement state of the line.
+void tst_CacheSim::tst_cache_replacement() {
+  QFETCH(int, policy);
+  QFETCH(VInt, victim);
+  ProcessorHandler::get()->selectProcessor(ProcessorID::RV32_5S, {});
+
+  auto cache = std::make_shared<CacheSim>(nullptr);
+  CachePreset preset{"", 0, 0, 2, WritePolicy::WriteBack,
+                     WriteAllocPolicy::WriteAllocate,
+                     static_cast<ReplPolicy>(policy)};
+  cache->setPreset(preset);
+
+  // A single line of 4 ways with single-word blocks; the tag of an address is
+  // its word index.
+  const auto accessBlock = [&](VInt tag) {
+    cache->access(tag << 2, MemoryAccess::Read);
+  };
+  const auto isCached = [&](VInt tag) {
+    for (int i = 0; i < cache->getWays(); ++i) {
+      const auto way = cache->getWay(0, i);
+      if (way.valid && way.tag == tag)
+        return true;
+    }
+    return false;
+  };
+
+  for (VInt tag : {1, 2, 3, 4, 1, 5})
+    accessBlock(tag);
+  QVERIFY(isCached(5));
+  QVERIFY(!isCached(victim));
+  QCOMPARE(cache->getMisses(), 5u);
+
+  cache->undo();
+  QVERIFY(isCached(victim));
+  QVERIFY(!isCached(5));
+  accessBlock(6);
+  QVERIFY(!isCached(victim));
+}
+
+// Ensures that SRRIP predicts invalidated ways as distant re-references, such
+// that filling an invalidated way which was recently hit does not age the other
+// ways of the line past the largest RRPV.
+void tst_CacheSim::tst_cache_srrip_invalidation() {
+  ProcessorHandler::get()->selectProcessor(ProcessorID::RV32_5S, {});
+
+  auto cache = std::make_shared<CacheSim>(nullptr);
+  // A single line of 4 ways with single-word blocks, as above.
+  CachePreset preset{"", 0, 0, 2, WritePolicy::WriteBack,
+                     WriteAllocPolicy::WriteAllocate, ReplPolicy::SRRIP};
+  cache->setPreset(preset);
+  const auto isCached = [&](VInt tag) {
+    for (int i = 0; i < cache->getWays(); ++i) {
+      const auto way = cache->getWay(0, i);
+      if (way.valid && way.tag == tag)
+        return true;
+    }
+    return false;
+  };
+
+  // Fill the line, hit block 2, and invalidate it.
+  for (VInt tag : {1, 2, 3, 4, 2})
+    cache->access(tag << 2, MemoryAccess::Read);
+  cache->invalidate(2 << 2);
+  QVERIFY(!isCached(2));
+
+  // Block 5 fills the invalidated way, and the next miss evicts the first way
+  // rather than the way just filled.
+  cache->access(5 << 2, MemoryAccess::Read);
+  cache->access(6 << 2, MemoryAccess::Read);
+  QVERIFY(isCached(5));
+  QVERIFY(isCached(6));
+  QVERIFY(!isCached(1));
+  QVERIFY(isCached(3));
+  QVERIFY(isCached(4));
+}
+
+// Ensures that cache misses stall the processor when timing is enabled, and
+// that stall cycles are reversible.
+void tst_CacheSim::tst_cache_timing() {
+  constexpr unsigned missLatency = 10;
+  ProcessorHandler::get()->selectProcessor(ProcessorID::RV32_5S, {});
+  ProcessorHandler::get()->getProcessorNonConst()->trapHandler = [=] {};
+
+  auto shim =
+      std::make_shared<L1CacheShim>(L1CacheShim::CacheType::DataCache, nullptr);
+  auto cache = std::make_shared<CacheSim>(nullptr);
+  cache->setMissLatency(missLatency);
+  shim->setNextLevelCache(cache);
+  shim->setTimingEnabled(true);
+
+  // Strided stores, such that each access misses.
+  auto loader = new ProgramLoader();
+  loader->loadTest(QStringList({".data", "a: .word 0", ".text", "la a0 a",
+                                "loop:", "sw a1 0 a0", "addi a0 a0 1024",
+                                "j loop"})
+                       .join("\n"));
+  RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+  auto proc = ProcessorHandler::get()->getProcessorNonConst();
+  for (unsigned i = 0; i < 200; ++i)
+    proc->clock();
+
+  const long long stalls = proc->getMemoryStallCycles();
+  QVERIFY(stalls > 0);
+  QVERIFY(stalls <= static_cast<long long>(cache->getMisses()) * missLatency);
+  QCOMPARE(proc->getCycleCount(), 200);
+
+  // Reversing and re-executing must reproduce the same timing.
+  const auto retired = proc->getInstructionsRetired();
+  const auto misses = cache->getMisses();
+  for (unsigned i = 0; i < 50; ++i)
+    proc->reverseProcessor();
+  QCOMPARE(proc->getCycleCount(), 150);
+  for (unsigned i = 0; i < 50; ++i)
+    proc->clock();
+  QCOMPARE(proc->getMemoryStallCycles(), stalls);
+  QCOMPARE(proc->getInstructionsRetired(), retired);
+  QCOMPARE(cache->getMisses(), misses);
+}
+
+// Ensures that prefetch statistics are tracked, and that prefetch fills are
+// undone alongside the accesses which triggered them.
+void tst_CacheSim::tst_cache_prefetch() {
+  ProcessorHandler::get()->selectProcessor(ProcessorID::RV32_5S, {});
+
+  // A direct mapped cache of 8 lines with single-word blocks.
+  auto cache = std::make_shared<CacheSim>(nullptr);
+  CachePreset preset{"", 0, 3, 0, WritePolicy::WriteBack,
+                     WriteAllocPolicy::WriteAllocate, ReplPolicy::LRU};
+  cache->setPreset(preset);
+  cache->setPrefetchPolicy(PrefetchPolicy::NextLine);
+
+  // Sequential accesses, spaced further apart than the latency of a prefetch.
+  for (unsigned i = 0; i < 8; ++i)
+    cache->replayAccess(i << 2, MemoryAccess::Read, i * 20);
+  QCOMPARE(cache->getMisses(), 1u);
+  QCOMPARE(cache->getHits(), 7u);
+  QCOMPARE(cache->getPrefetches(), 8u);
+  QCOMPARE(cache->getPrefetchAccuracy(), 7.0 / 8);
+  QCOMPARE(cache->getPrefetchCoverage(), 7.0 / 8);
+  QCOMPARE(cache->getPrefetchTimeliness(), 1.0);
+
+  cache->reset();
+  cache->access(0 << 2, MemoryAccess::Read);
+  cache->access(1 << 2, MemoryAccess::Read);
+  QVERIFY(!cache->getWay(1, 0).prefetched);
+  QVERIFY(cache->getWay(2, 0).prefetched);
+
+  // Undo the prefetch of block 2, followed by the access to block 1.
+  cache->undo();
+  QVERIFY(!cache->getWay(2, 0).valid);
+  cache->undo();
+  QVERIFY(cache->getWay(1, 0).prefetched);
+  QCOMPARE(cache->getHits(), 0u);
+  QCOMPARE(cache->getPrefetches(), 1u);
+}
+
+// Ensures that conflict misses are served by the victim cache, which writes
+// back the dirty lines it evicts, and that undoing restores its contents.
+void tst_CacheSim::tst_cache_victim() {
+  ProcessorHandler::get()->selectProcessor(ProcessorID::RV32_5S, {});
+
+  // A direct mapped cache of 8 lines with single-word blocks, and a victim
+  // cache of 2 lines.
+  auto cache = std::make_shared<CacheSim>(nullptr);
+  CachePreset preset{"", 0, 3, 0, WritePolicy::WriteBack,
+                     WriteAllocPolicy::WriteAllocate, ReplPolicy::LRU};
+  cache->setPreset(preset);
+  cache->setVictimCacheEntries(2);
+
+  // Alternating accesses to two blocks of the same line.
+  for (unsigned i = 0; i < 4; ++i)
+    cache->replayAccess((i % 2) * 32, MemoryAccess::Read, i);
+  QCOMPARE(cache->getMisses(), 4u);
+  QCOMPARE(cache->getVictimHits(), 2u);
+
+  cache->reset();
+  cache->access(0, MemoryAccess::Write);
+  cache->access(32, MemoryAccess::Read);
+  cache->access(64, MemoryAccess::Read);
+  QCOMPARE(cache->getWritebacks(), 0u);
+  // Evicts the dirty block 0 from the victim cache.
+  cache->access(96, MemoryAccess::Read);
+  QCOMPARE(cache->getWritebacks(), 1u);
+
+  cache->undo();
+  QCOMPARE(cache->getWritebacks(), 0u);
+  cache->access(0, MemoryAccess::Read);
+  QCOMPARE(cache->getVictimHits(), 1u);
+  QVERIFY(cache->getWay(0, 0).dirty);
+}
+
+// Ensures that inclusive caches invalidate the lines they evict in the caches
+// above, and that exclusive caches hand out the lines which they serve.
+void tst_CacheSim::tst_cache_inclusion() {
+  ProcessorHandler::get()->selectProcessor(ProcessorID::RV32_5S, {});
+
+  // A direct mapped L1 cache of 8 lines in front of a direct mapped L2 cache
+  // of 4 lines, with single-word blocks.
+  auto l1 = std::make_shared<CacheSim>(nullptr);
+  auto l2 = std::make_shared<CacheSim>(nullptr);
+  CachePreset preset{"", 0, 3, 0, WritePolicy::WriteBack,
+                     WriteAllocPolicy::WriteAllocate, ReplPolicy::LRU};
+  l1->setPreset(preset);
+  preset.lines = 2;
+  l2->setPreset(preset);
+  l1->setNextLevelCache(l2);
+  l2->setInclusionPolicy(InclusionPolicy::Inclusive);
+  l2->addPreviousLevelCache(l1.get());
+
+  // Blocks 0 and 16 conflict in the L2 cache, but not in the L1 cache.
+  l1->access(0, MemoryAccess::Write);
+  l1->access(16, MemoryAccess::Read);
+  QVERIFY(!l1->getWay(0, 0).valid);
+  QCOMPARE(l1->getInvalidations(), 1u);
+  // The block modified in the L1 cache is written back.
+  QCOMPARE(l2->getWritebacks(), 1u);
+
+  l1->undo();
+  QVERIFY(l1->getWay(0, 0).valid);
+  QVERIFY(l1->getWay(0, 0).dirty);
+  QCOMPARE(l1->getInvalidations(), 0u);
+
+  // An exclusive L2 cache of 16 lines.
+  l1->reset();
+  l2->setInclusionPolicy(InclusionPolicy::Exclusive);
+  preset.lines = 4;
+  l2->setPreset(preset);
+  l1->access(0, MemoryAccess::Read);
+  QCOMPARE(l2->getMisses(), 1u);
+  QVERIFY(!l2->contains(0));
+  // Block 0 is evicted from the L1 cache into the L2 cache.
+  l1->access(32, MemoryAccess::Read);
+  QCOMPARE(l2->getInsertions(), 1u);
+  QVERIFY(l2->contains(0));
+  // Block 0 is handed out to the L1 cache, and block 32 inserted.
+  l1->access(0, MemoryAccess::Read);
+  QCOMPARE(l2->getHits(), 1u);
+  QCOMPARE(l2->getInvalidations(), 1u);
+  QVERIFY(!l2->contains(0));
+  QVERIFY(l2->contains(32));
+}
+
+// Ensures that addresses differing only above bit 31 do not alias within the
+// cache of a 64-bit processor.
+void tst_CacheSim::tst_cache_rv64() {
+  ProcessorHandler::get()->selectProcessor(ProcessorID::RV64_5S, {});
+
+  // A direct mapped cache of 8 lines with single-word blocks.
+  auto cache = std::make_shared<CacheSim>(nullptr);
+  CachePreset preset{"", 0, 3, 0, WritePolicy::WriteBack,
+                     WriteAllocPolicy::WriteAllocate, ReplPolicy::LRU};
+  cache->setPreset(preset);
+  QCOMPARE(cache->getTagBits(), 64 - 3 - 0 - 3);
+
+  const AInt low = 0x8;
+  const AInt high = (AInt(1) << 40) | low;
+  QCOMPARE(cache->getLineIdx(high), cache->getLineIdx(low));
+  QVERIFY(cache->getTag(high) != cache->getTag(low));
+  QCOMPARE(cache->buildAddress(cache->getTag(high), cache->getLineIdx(high),
+                               cache->getBlockIdx(high)),
+           high);
+
+  cache->access(low, MemoryAccess::Read);
+  cache->access(high, MemoryAccess::Read);
+  cache->access(low, MemoryAccess::Read);
+  QCOMPARE(cache->getMisses(), 3u);
+  QCOMPARE(cache->getHits(), 0u);
+}
+
+// Ensures that the views of the packed cache state reflect the tag, validity,
+// replacement and per-block dirty state of each way, including dirty blocks
+// beyond the first word of the dirty block mask, and that undoing an eviction
+// restores them.
+void tst_CacheSim::tst_cache_line_view() {
+  ProcessorHandler::get()->selectProcessor(ProcessorID::RV32_5S, {});
+
+  // 2 lines of 2 ways with 128-word blocks.
+  auto cache = std::make_shared<CacheSim>(nullptr);
+  CachePreset preset{"", 7, 1, 1, WritePolicy::WriteBack,
+                     WriteAllocPolicy::WriteAllocate, ReplPolicy::LRU};
+  cache->setPreset(preset);
+  QCOMPARE(cache->getBlocks(), 128);
+
+  cache->access(cache->buildAddress(5, 1, 3), MemoryAccess::Write);
+  cache->access(cache->buildAddress(5, 1, 100), MemoryAccess::Write);
+  cache->access(cache->buildAddress(9, 1, 0), MemoryAccess::Read);
+
+  const auto findWay = [&](VInt tag) {
+    for (const auto &way : cache->getLine(1))
+      if (way.second.valid && way.second.tag == tag)
+        return way.second;
+    return CacheSim::CacheWay();
+  };
+  const auto written = findWay(5);
+  QVERIFY(written.valid && written.dirty);
+  QCOMPARE(written.dirtyBlocks, std::set<unsigned>({3, 100}));
+  const auto read = findWay(9);
+  QVERIFY(read.valid && !read.dirty && read.dirtyBlocks.empty());
+  QVERIFY(read.lru < written.lru);
+  for (const auto &way : cache->getLine(0))
+    QVERIFY(!way.second.valid);
+
+  // Evicts the least recently used, dirty, way.
+  cache->access(cache->buildAddress(11, 1, 0), MemoryAccess::Read);
+  QVERIFY(!findWay(5).valid);
+  QCOMPARE(cache->getWritebacks(), 1u);
+  cache->undo();
+  QCOMPARE(findWay(5).dirtyBlocks, std::set<unsigned>({3, 100}));
+  QVERIFY(!findWay(11).valid);
+  QCOMPARE(cache->getWritebacks(), 0u);
+}
+
+QTEST_MAIN(tst_CacheSim)
+#include "tst_cachesim.moc"
@@ -0,0 +1,134 @@
+#include <QStringList>
+#include <QTemporaryFile>
+#include <QTextStream>
+#include <QtTest/QTest>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "cli/cachehierarchy.h"
+#include "cli/cachesweep.h"
+#include "programloader.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+class tst_CacheSweep : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_trace_encoding();
+  void tst_load_configs();
+  void tst_sweep();
+};
+
+// Ensures that entries decode as they were appended, including decreasing and
+// 64-bit addresses.
+void tst_CacheSweep::tst_trace_encoding() {
+  using Stream = MemoryAccessTrace::Stream;
+  const std::vector<MemoryAccessTrace::Entry> entries = {
+      {0, 0x1000, Stream::Instr, MemoryAccess::Read},
+      {0, 0x10000000, Stream::Data, MemoryAccess::Write},
+      {1, 0x1004, Stream::Instr, MemoryAccess::Read},
+      {5, 0xffc, Stream::Instr, MemoryAccess::Read},
+      {300, 0x8000000000000000, Stream::Data, MemoryAccess::Read},
+      {300, 0x8, Stream::Data, MemoryAccess::Write}};
+  MemoryAccessTrace trace;
+  for (const auto &entry : entries)
+    trace.append(entry);
+  QCOMPARE(trace.size(), entries.size());
+
+  MemoryAccessTrace::Reader reader(trace);
+  MemoryAccessTrace::Entry entry;
+  for (const auto &expected : entries) {
+    QVERIFY(reader.next(entry));
+    QCOMPARE(entry.cycle, expected.cycle);
+    QCOMPARE(entry.address, expected.address);
+    QVERIFY(entry.stream == expected.stream);
+    QCOMPARE(entry.type, expected.type);
+  }
+  QVERIFY(!reader.next(entry));
+}
+
+void tst_CacheSweep::tst_load_configs() {
+  QTemporaryFile file;
+  QVERIFY(file.open());
+  QTextStream(&file) << "# Data caches\n"
+                     << "d lines=64,ways=2\n"
+                     << "\n"
+                     << "i lines=16,blocks=8\n";
+  file.close();
+  std::vector<CacheSweepConfig> configs;
+  QVERIFY(loadCacheSweepConfigs(file.fileName(), configs).isEmpty());
+  QCOMPARE(configs.size(), size_t(2));
+  QVERIFY(configs.at(0).stream == MemoryAccessTrace::Stream::Data);
+  QCOMPARE(configs.at(0).config.preset.lines, 6);
+  QVERIFY(configs.at(1).stream == MemoryAccessTrace::Stream::Instr);
+  QCOMPARE(configs.at(1).config.preset.blocks, 3);
+
+  QVERIFY(file.open());
+  QTextStream(&file) << "x lines=64\n";
+  file.close();
+  configs.clear();
+  const QString err = loadCacheSweepConfigs(file.fileName(), configs);
+  QVERIFY2(err.contains(":1:"), qPrintable(err));
+}
+
+// Ensures that replaying the recorded access streams against a cache
+// configuration yields the statistics of simulating it alongside the processor.
+void tst_CacheSweep::tst_sweep() {
+  QStringList program = QStringList() << ".data"
+                                      << "a: .zero 256"
+                                      << ".text"
+                                      << "li t2 3"
+                                      << "outer:"
+                                      << "la a0 a"
+                                      << "li t0 32"
+                                      << "inner:"
+                                      << "lw a1 0 a0"
+                                      << "addi a1 a1 1"
+                                      << "sw a1 4 a0"
+                                      << "addi a0 a0 8"
+                                      << "addi t0 t0 -1"
+                                      << "bnez t0 inner"
+                                      << "addi t2 t2 -1"
+                                      << "bnez t2 outer";
+  runProgram(ProcessorID::RV32_5S, program, false);
+
+  std::vector<CacheSweepConfig> configs(2);
+  configs.at(0).stream = MemoryAccessTrace::Stream::Data;
+  configs.at(0).spec = "lines=4,ways=2,blocks=2";
+  configs.at(1).stream = MemoryAccessTrace::Stream::Instr;
+  configs.at(1).spec = "lines=2,blocks=2";
+  CacheHierarchyConfig config;
+  for (auto &sweepConfig : configs)
+    QVERIFY(parseCacheLevelConfig(sweepConfig.spec, sweepConfig.config)
+                .isEmpty());
+  config.l1d = configs.at(0).config;
+  config.l1i = configs.at(1).config;
+  CacheHierarchy hierarchy;
+  hierarchy.build(config);
+  CacheSweep sweep;
+  sweep.record();
+
+  auto *proc = ProcessorHandler::get()->getProcessorNonConst();
+  while (!proc->finished() && proc->getCycleCount() < 10000)
+    proc->clock();
+  QVERIFY(proc->finished());
+
+  CacheSweepResult result;
+  sweep.run(configs, result);
+  QCOMPARE(result.traceEntries, sweep.trace().size());
+  QCOMPARE(result.entries.size(), configs.size());
+  const auto &l1d = hierarchy.levels().at(1).cache;
+  const auto &l1i = hierarchy.levels().at(0).cache;
+  QVERIFY(l1d->getMisses() > 0 && l1d->getWritebacks() > 0);
+  QCOMPARE(result.entries.at(0).hits, l1d->getHits());
+  QCOMPARE(result.entries.at(0).misses, l1d->getMisses());
+  QCOMPARE(result.entries.at(0).writebacks, l1d->getWritebacks());
+  QCOMPARE(result.entries.at(1).hits, l1i->getHits());
+  QCOMPARE(result.entries.at(1).misses, l1i->getMisses());
+}
+
+QTEST_MAIN(tst_CacheSweep)
+#include "tst_cachesweep.moc"
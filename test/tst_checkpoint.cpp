@@ -0,0 +1,69 @@
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QtTest/QTest>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "cli/checkpoint.h"
+#include "isa/rvisainfo_common.h"
+#include "programloader.h"
+#include "syscall/systemio.h"
+
+using namespace Ripes;
+
+class tst_Checkpoint : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_csrs();
+  void tst_open_files();
+  void cleanup();
+};
+
+void tst_Checkpoint::cleanup() { SystemIO::reset(); }
+
+static const QStringList s_program = QStringList() << ".text"
+                                                   << "li t0 0x1234"
+                                                   << "csrw mscratch t0"
+                                                   << "li t0 0x400"
+                                                   << "csrw mtvec t0"
+                                                   << "li t0 0x80"
+                                                   << "csrw mie t0";
+
+// Ensures that the CSRs holding architectural state are restored from a
+// checkpoint, rather than left at their reset values.
+void tst_Checkpoint::tst_csrs() {
+  runProgram(ProcessorID::RV32_ISS, s_program, true);
+  const auto csrs = ProcessorHandler::getProcessor()->getCSRState();
+  QCOMPARE(csrs.at(RVISA::MSCRATCH), VInt(0x1234));
+  QCOMPARE(csrs.at(RVISA::MTVEC), VInt(0x400));
+  QCOMPARE(csrs.at(RVISA::MIE), VInt(0x80));
+  const QByteArray data = checkpointData();
+
+  runProgram(ProcessorID::RV32_ISS, s_program, false);
+  QCOMPARE(ProcessorHandler::getProcessor()->getCSRState().at(RVISA::MSCRATCH),
+           VInt(0));
+  const QString err = applyCheckpointData(data, "checkpoint");
+  QVERIFY2(err.isEmpty(), qPrintable(err));
+  QVERIFY(ProcessorHandler::getProcessor()->getCSRState() == csrs);
+}
+
+// Ensures that checkpoints taken while the program has files open are
+// rejected when restored, since the files are not.
+void tst_Checkpoint::tst_open_files() {
+  runProgram(ProcessorID::RV32_ISS, s_program, true);
+  QTemporaryDir dir;
+  const int fd = SystemIO::openFile(dir.filePath("out.txt"), 0x201);
+  QVERIFY(fd >= 0);
+  const QByteArray data = checkpointData();
+  SystemIO::closeFile(fd);
+  QVERIFY(applyCheckpointData(checkpointData(), "checkpoint").isEmpty());
+
+  const QString err = applyCheckpointData(data, "checkpoint");
+  QVERIFY(err.contains("files open"));
+  QVERIFY(err.contains("out.txt"));
+}
+
+QTEST_MAIN(tst_Checkpoint)
+#include "tst_checkpoint.moc"
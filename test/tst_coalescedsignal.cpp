@@ -0,0 +1,49 @@
+#include <QStringList>
+#include <QtTest/QTest>
+
+#include <thread>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "coalescedsignal.h"
+#include "programloader.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+class tst_CoalescedSignal : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_coalesced_signal();
+};
+
+// Ensures that emissions from other threads are delivered as one, and that
+// emissions on the thread of the receiver are delivered directly.
+void tst_CoalescedSignal::tst_coalesced_signal() {
+  Gallant::Signal0<> signal;
+  QObject receiver;
+  std::vector<unsigned long long> deliveries;
+  CoalescedSignal bridge(
+      &receiver,
+      [&](unsigned long long emissions) { deliveries.push_back(emissions); },
+      signal);
+
+  std::thread emitter([&] {
+    for (unsigned i = 0; i < 1000; ++i)
+      signal.Emit();
+  });
+  emitter.join();
+  QVERIFY(deliveries.empty());
+  QCoreApplication::processEvents();
+  QCOMPARE(deliveries, std::vector<unsigned long long>{1000});
+
+  signal.Emit();
+  QCOMPARE(deliveries, (std::vector<unsigned long long>{1000, 1}));
+  QCoreApplication::processEvents();
+  QCOMPARE(deliveries.size(), size_t(2));
+}
+
+QTEST_MAIN(tst_CoalescedSignal)
+#include "tst_coalescedsignal.moc"
@@ -0,0 +1,170 @@
+#include <QStringList>
+#include <QtAlgorithms>
+#include <QtTest/QTest>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "cli/coherence.h"
+#include "programloader.h"
+
+using namespace Ripes;
+
+class tst_Coherence : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_parse_config();
+  void tst_sharing_data();
+  void tst_sharing();
+  void tst_private_data();
+  void tst_private();
+};
+
+// Number of iterations in which each hart increments its counter.
+static constexpr unsigned s_iterations = 20;
+
+// Returns a program in which each hart increments a counter @p iterations
+// times. The counter of a hart is the word at @p stride times its hart ID
+// bytes from the start of the data section; @p stride is 0 or a power of 2.
+static QStringList counterProgram(unsigned stride, unsigned iterations) {
+  const QString offset =
+      stride == 0
+          ? QString("li t0 0")
+          : "slli t0 t0 " + QString::number(qCountTrailingZeroBits(stride));
+  return QStringList() << ".data"
+                       << "words: .word 0, 0, 0, 0, 0, 0, 0, 0"
+                       << ".text"
+                       << "la s0 words"
+                       << "csrr t0 mhartid"
+                       << offset
+                       << "add s0 s0 t0"
+                       << "li t1 " + QString::number(iterations)
+                       << "loop:"
+                       << "lw a0 0 s0"
+                       << "addi a0 a0 1"
+                       << "sw a0 0 s0"
+                       << "addi t1 t1 -1"
+                       << "bnez t1 loop";
+}
+
+// Runs @p program on two harts in lockstep, simulated by @p sim.
+static void runHarts(const QStringList &program,
+                     std::unique_ptr<CoherenceSim> &sim,
+                     const CoherenceSim::Config &config) {
+  ProcessorHandler::setHartQuantum(1);
+  runProgram(ProcessorID::RV32_MULTIHART_2, program, false);
+  sim = std::make_unique<CoherenceSim>(config);
+  QCOMPARE(sim->harts(), 2u);
+  auto *proc = ProcessorHandler::get()->getProcessorNonConst();
+  while (!proc->finished() && proc->getCycleCount() < 1000)
+    proc->clock();
+  QVERIFY(proc->finished());
+}
+
+// Ensures that the protocol and the specifications of the caches are parsed,
+// and that L1 caches which cannot be kept coherent are rejected.
+void tst_Coherence::tst_parse_config() {
+  CoherenceSim::Config config;
+  QVERIFY(parseCoherenceConfig("msi", "lines=8,blocks=4", "ways=4", config)
+              .isEmpty());
+  QVERIFY(config.protocol == CoherenceSim::Protocol::MSI);
+  QCOMPARE(config.l1.preset.lines, 3);
+  QCOMPARE(config.l1.preset.blocks, 2);
+  QCOMPARE(config.l2.preset.ways, 2);
+
+  QVERIFY(parseCoherenceConfig("moesi", "", "", config).contains("msi"));
+  QVERIFY(parseCoherenceConfig("mesi", "victim=4", "", config)
+              .contains("victim"));
+  QVERIFY(parseCoherenceConfig("mesi", "blocks=128", "", config)
+              .contains("64 words"));
+}
+
+void tst_Coherence::tst_sharing_data() {
+  QTest::addColumn<unsigned>("stride");
+  QTest::addColumn<bool>("falseSharing");
+  QTest::newRow("true sharing") << 0u << false;
+  QTest::newRow("false sharing") << 4u << true;
+}
+
+// Ensures that harts writing to the same line in turn invalidate each other's
+// copies, and that the resulting coherence misses are false sharing misses
+// only if the harts write to different words of the line.
+void tst_Coherence::tst_sharing() {
+  QFETCH(unsigned, stride);
+  QFETCH(bool, falseSharing);
+  std::unique_ptr<CoherenceSim> sim;
+  runHarts(counterProgram(stride, s_iterations), sim, {});
+  constexpr unsigned n = s_iterations;
+
+  // In each iteration, both harts load their counter, then both store it.
+  // Hart 0 misses on its loads, which follow the store of hart 1, and upgrades
+  // its shared copy by its store. Hart 1 hits on its loads, and misses on its
+  // stores, which follow the store of hart 0. The first load of either hart is
+  // a compulsory miss.
+  const CoherenceSim::Stats &hart0 = sim->hartStats(0);
+  QCOMPARE(hart0.accesses, 2ull * n);
+  QCOMPARE(hart0.misses, 1ull * n);
+  QCOMPARE(hart0.coherenceMisses, n - 1ull);
+  QCOMPARE(hart0.invalidations, 1ull * n);
+  QCOMPARE(hart0.upgrades, 1ull * n);
+  QCOMPARE(hart0.interventions, 1ull * n);
+  const CoherenceSim::Stats &hart1 = sim->hartStats(1);
+  QCOMPARE(hart1.accesses, 2ull * n);
+  QCOMPARE(hart1.misses, n + 1ull);
+  QCOMPARE(hart1.coherenceMisses, 1ull * n);
+  QCOMPARE(hart1.invalidations, 1ull * n);
+  QCOMPARE(hart1.upgrades, 0ull);
+  QCOMPARE(hart1.interventions, n - 1ull);
+
+  const CoherenceSim::Stats total = sim->total();
+  QCOMPARE(total.coherenceMisses, 2ull * n - 1);
+  QCOMPARE(total.falseSharingMisses, falseSharing ? 2ull * n - 1 : 0ull);
+  QCOMPARE(total.writebacks, 0ull);
+
+  const auto lines = sim->worstLines(4);
+  QCOMPARE(lines.size(), size_t(1));
+  QCOMPARE(lines.front().address,
+           ProcessorHandler::getProgram()->getSection(".data")->address);
+  QCOMPARE(lines.front().invalidations, 2ull * n);
+  QCOMPARE(lines.front().falseSharingMisses, total.falseSharingMisses);
+  QCOMPARE(lines.front().readers, 3u);
+  QCOMPARE(lines.front().writers, 3u);
+}
+
+void tst_Coherence::tst_private_data() {
+  QTest::addColumn<int>("protocol");
+  QTest::addColumn<unsigned long long>("upgrades");
+  QTest::addColumn<unsigned long long>("silentUpgrades");
+  QTest::newRow("msi") << static_cast<int>(CoherenceSim::Protocol::MSI)
+                       << 1ull << 0ull;
+  QTest::newRow("mesi") << static_cast<int>(CoherenceSim::Protocol::MESI)
+                        << 0ull << 1ull;
+}
+
+// Ensures that harts accessing lines of their own are not invalidated, and
+// that, with MESI, the first write to a line read by a single hart needs no
+// bus transaction.
+void tst_Coherence::tst_private() {
+  QFETCH(int, protocol);
+  QFETCH(unsigned long long, upgrades);
+  QFETCH(unsigned long long, silentUpgrades);
+  CoherenceSim::Config config;
+  config.protocol = static_cast<CoherenceSim::Protocol>(protocol);
+  std::unique_ptr<CoherenceSim> sim;
+  runHarts(counterProgram(16, s_iterations), sim, config);
+
+  for (unsigned hart = 0; hart < 2; ++hart) {
+    const CoherenceSim::Stats &stats = sim->hartStats(hart);
+    QCOMPARE(stats.accesses, 2ull * s_iterations);
+    QCOMPARE(stats.misses, 1ull);
+    QCOMPARE(stats.coherenceMisses, 0ull);
+    QCOMPARE(stats.invalidations, 0ull);
+    QCOMPARE(stats.upgrades, upgrades);
+    QCOMPARE(stats.silentUpgrades, silentUpgrades);
+  }
+  QVERIFY(sim->worstLines(4).empty());
+}
+
+QTEST_MAIN(tst_Coherence)
+#include "tst_coherence.moc"
@@ -32,14 +32,37 @@ struct RegisterChange {
 
 // Maximum cycle count
 static constexpr unsigned s_maxCycles = 1000000;
-using Registers = std::map<int, VInt>;
+using Registers = std::vector<VInt>;
+
+// A register change, along with the processor state in which it occurred.
 struct TraceEntry {
-  Registers regs;
+  RegisterChange change;
   unsigned long cycle;
   AInt pc;
 };
 
-using Trace = std::vector<TraceEntry>;
+/**
+ * A register trace is recorded as the register state upon reset, followed by
+ * each change of a register. The register state at any point of the trace is
+ * reconstructed by replaying the changes up to that point, which is only
+ * required when reporting a divergence.
+ */
+struct Trace {
+  Registers initial;
+  std::vector<TraceEntry> changes;
+
+  /// Returns the register state once the changes up to and including
+  /// @p entry have been applied.
+  Registers stateAt(std::vector<TraceEntry>::const_iterator entry) const {
+    Registers regs = initial;
+    for (auto it = changes.begin(); it != changes.end(); ++it) {
+      regs.at(it->change.index) = it->change.newValue;
+      if (it == entry)
+        break;
+    }
+    return regs;
+  }
+};
 
 // Reference model
 // All tests will be compared against the trace generated by this processor
@@ -72,10 +95,12 @@ private:
   const Trace &generateReferenceTrace(const QStringList &extensions);
   void trapHandler();
   void executeSimulator(Trace &outTrace, const Trace *refTrace = nullptr);
-  Registers dumpRegs();
+  void dumpRegs(Registers &regs);
   QString generateErrorReport(const RegisterChange &change,
-                              const TraceEntry &lhs,
-                              const TraceEntry &rhs) const;
+                              const Registers &regs, unsigned long cycle,
+                              const Trace &refTrace,
+                              std::vector<TraceEntry>::const_iterator
+                                  refEntry) const;
   void loadCurrentTest();
 
   bool m_stop = false;
@@ -107,63 +132,54 @@ void tst_Cosimulate::trapHandler() {
   }
 }
 
-Registers tst_Cosimulate::dumpRegs() {
-  Registers regs;
-  for (unsigned i = 0; i < ProcessorHandler::get()->currentISA()->regCnt();
-       i++) {
-    regs[i] = ProcessorHandler::get()->getProcessor()->getRegister(
-        RegisterFileType::GPR, i);
-  }
-  return regs;
+void tst_Cosimulate::dumpRegs(Registers &regs) {
+  const auto *proc = ProcessorHandler::get()->getProcessor();
+  regs.resize(ProcessorHandler::get()->currentISA()->regCnt());
+  for (unsigned i = 0; i < regs.size(); i++)
+    regs[i] = proc->getRegister(RegisterFileType::GPR, i);
 }
 
-std::optional<std::vector<int>> regNeq(const Registers &lhs,
-                                       const Registers &rhs) {
-  std::vector<int> uneqIdxes;
-  for (const auto &it : lhs) {
-    if (it.second != rhs.at(it.first)) {
-      uneqIdxes.push_back(it.first);
-    }
-  }
-
-  if (uneqIdxes.size() > 0) {
-    return {uneqIdxes};
-  } else {
-    return std::nullopt;
-  }
-}
-
-std::vector<RegisterChange> registerChange(const Registers &before,
-                                           const Registers &after) {
-  std::vector<RegisterChange> change;
-  for (unsigned i = 0; i < ProcessorHandler::get()->currentISA()->regCnt();
-       i++) {
+/// Appends the registers which differ between @p before and @p after to
+/// @p change.
+void registerChange(const Registers &before, const Registers &after,
+                    std::vector<RegisterChange> &change) {
+  for (unsigned i = 0; i < after.size(); i++) {
     if (before.at(i) != after.at(i)) {
       change.push_back({i, after.at(i)});
     }
   }
-  return change;
 }
 
-QString tst_Cosimulate::generateErrorReport(const RegisterChange &change,
-                                            const TraceEntry &lhs,
-                                            const TraceEntry &rhs) const {
+QString tst_Cosimulate::generateErrorReport(
+    const RegisterChange &change, const Registers &regs, unsigned long cycle,
+    const Trace &refTrace,
+    std::vector<TraceEntry>::const_iterator refEntry) const {
   QString err;
   err += "\nRegister change discrepancy detected while executing test: " +
          m_currentTest.filepath;
   err += "\nUnexpected change was: x" + QString::number(change.index) +
          " -> 0x" + QString::number(change.newValue, 16) + "\n";
-  err += "\nTest processor state: \t\tPC: 0x" + QString::number(lhs.pc, 16) +
-         "\t Cycle #: " + QString::number(lhs.cycle);
-  err += "\nReference processor state: \tPC: 0x" + QString::number(rhs.pc, 16) +
-         "\t Cycle #: " + QString::number(rhs.cycle);
+  err += "\nTest processor state: \t\tPC: 0x" +
+         QString::number(
+             ProcessorHandler::get()->getProcessor()->getPcForStage({0, 0}),
+             16) +
+         "\t Cycle #: " + QString::number(cycle);
+  if (refEntry == refTrace.changes.end()) {
+    err += "\nReference processor state: \tend of trace\n";
+    return err;
+  }
+  err += "\nReference processor state: \tPC: 0x" +
+         QString::number(refEntry->pc, 16) +
+         "\t Cycle #: " + QString::number(refEntry->cycle);
   err += "\n";
 
-  std::vector<int> idxes = regNeq(lhs.regs, rhs.regs).value();
-  for (const auto idx : idxes) {
+  const Registers refRegs = refTrace.stateAt(refEntry);
+  for (unsigned idx = 0; idx < regs.size(); idx++) {
+    if (regs.at(idx) == refRegs.at(idx))
+      continue;
     err += "Difference in register x" + QString::number(idx) + ":";
-    err += "\t expected: 0x" + QString::number(rhs.regs.at(idx), 16) +
-           "\tactual: 0x" + QString::number(lhs.regs.at(idx), 16) + "\n";
+    err += "\t expected: 0x" + QString::number(refRegs.at(idx), 16) +
+           "\tactual: 0x" + QString::number(regs.at(idx), 16) + "\n";
   }
 
   return err;
@@ -190,58 +206,60 @@ void tst_Cosimulate::executeSimulator(Trace &trace, const Trace *refTrace) {
   m_err = QString();
   bool maxCyclesReached = false;
   unsigned cycles = 0;
-  trace.push_back(TraceEntry{
-      dumpRegs(), cycles,
-      ProcessorHandler::get()->getProcessor()->getPcForStage({0, 0})});
-
-  decltype(refTrace->begin()) cmpRegState;
-  if (refTrace) {
-    cmpRegState = refTrace->begin();
-    cmpRegState++; // skip initial state
-  }
+  dumpRegs(trace.initial);
+  trace.changes.clear();
 
-  Registers preRegs = dumpRegs();
+  std::vector<TraceEntry>::const_iterator cmpRegState;
+  if (refTrace)
+    cmpRegState = refTrace->changes.begin();
+
+  Registers preRegs = trace.initial;
+  Registers regs;
+  std::vector<RegisterChange> regChange;
 
   do {
     ProcessorHandler::get()->getProcessorNonConst()->clock();
     cycles++;
 
-    Registers regs = dumpRegs();
-    auto regChange = registerChange(preRegs, regs);
-    // Detect change in current register state
-    if (regNeq(regs, trace.rbegin()->regs)) {
-      trace.push_back(TraceEntry{
-          dumpRegs(), cycles,
-          ProcessorHandler::get()->getProcessor()->getPcForStage({0, 0})});
-
-      // Check whether change corresponds to expected change in comparison
-      // trace. regChange might contain multiple register changes (for
-      // processors that can commit >1 instruction per cycle). So we try to
-      // locate each of the changes in the next expected register set
-      // (cmpRegStatePtr), until we have accounted for all register changes. If
-      // we incremented the expected register set, but did not find an
-      // accompanying register change, then we've reached a point of divergence.
+    dumpRegs(regs);
+    regChange.clear();
+    registerChange(preRegs, regs, regChange);
+    if (!regChange.empty()) {
+      const AInt pc =
+          ProcessorHandler::get()->getProcessor()->getPcForStage({0, 0});
+      for (const auto &change : regChange)
+        trace.changes.push_back(TraceEntry{change, cycles, pc});
+
+      // Check whether the changes correspond to the expected changes of the
+      // reference trace. regChange might contain multiple register changes
+      // (for processors that can commit >1 instruction per cycle). So we try
+      // to locate the next expected change (cmpRegState) among the changes,
+      // until we have accounted for all register changes. If the expected
+      // change is not among them, then we've reached a point of divergence.
       if (refTrace != nullptr) {
         while (regChange.size() > 0) {
           bool foundChange = false;
-          for (auto changeIt = regChange.begin(); changeIt != regChange.end();
-               changeIt++) {
-            if (cmpRegState->regs.at(changeIt->index) == changeIt->newValue) {
-              regChange.erase(changeIt);
-              cmpRegState++;
-              foundChange = true;
-              break;
+          if (cmpRegState != refTrace->changes.end()) {
+            for (auto changeIt = regChange.begin();
+                 changeIt != regChange.end(); changeIt++) {
+              if (cmpRegState->change.index == changeIt->index &&
+                  cmpRegState->change.newValue == changeIt->newValue) {
+                regChange.erase(changeIt);
+                cmpRegState++;
+                foundChange = true;
+                break;
+              }
             }
           }
           if (!foundChange) {
             const QString err = generateErrorReport(
-                *regChange.begin(), *trace.rbegin(), *cmpRegState);
+                *regChange.begin(), regs, cycles, *refTrace, cmpRegState);
             QFAIL(err.toStdString().c_str());
           }
         }
       }
     }
-    preRegs = regs;
+    std::swap(preRegs, regs);
 
     maxCyclesReached = cycles >= s_maxCycles;
     m_stop |=
@@ -267,7 +285,7 @@ tst_Cosimulate::generateReferenceTrace(const QStringList &extensions) {
     ProcessorHandler::get()->selectProcessor(s_referenceModel, extensions);
     Trace trace;
     executeSimulator(trace);
-    m_referenceTraces[m_currentTest.filepath] = trace;
+    m_referenceTraces[m_currentTest.filepath] = std::move(trace);
     refTrace = m_referenceTraces.find(m_currentTest.filepath);
   }
   return refTrace->second;
@@ -289,7 +307,7 @@ void tst_Cosimulate::cosimulate(const ProcessorID &id,
   for (const auto &test : s_testFiles) {
     m_currentTest = test;
     std::cout << test.filepath.toStdString() << std::endl;
-    auto referenceTrace = generateReferenceTrace(extensions);
+    const auto &referenceTrace = generateReferenceTrace(extensions);
     ProcessorHandler::get()->selectProcessor(id, extensions);
     RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
 
@@ -0,0 +1,95 @@
+#include <QStringList>
+#include <QtTest/QTest>
+
+#include <algorithm>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "dirtypagetracker.h"
+#include "programloader.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+class tst_DirtyPages : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_dirty_pages();
+  void tst_processor_writes();
+};
+
+static bool contains(const std::vector<AInt> &pages, AInt page) {
+  return std::find(pages.begin(), pages.end(), page) != pages.end();
+}
+
+// Ensures that each observer sees the pages written since its own snapshot,
+// and that marking all of memory dirty reaches every observer once.
+void tst_DirtyPages::tst_dirty_pages() {
+  DirtyPageTracker tracker;
+  bool all;
+  const auto first = tracker.snapshot();
+  // A write crossing a page boundary dirties both pages.
+  tracker.markDirty(0x1ffe, 4);
+  auto pages = tracker.dirtyPagesSince(first, all);
+  QVERIFY(!all);
+  QCOMPARE(pages.size(), size_t(2));
+  QVERIFY(contains(pages, 1) && contains(pages, 2));
+
+  const auto second = tracker.snapshot();
+  QVERIFY(tracker.dirtyPagesSince(second, all).empty());
+  tracker.markDirty(0x5000, 1);
+  pages = tracker.dirtyPagesSince(second, all);
+  QCOMPARE(pages.size(), size_t(1));
+  QVERIFY(contains(pages, 5));
+  // The first observer has not yet queried; it sees all three pages.
+  QCOMPARE(tracker.dirtyPagesSince(first, all).size(), size_t(3));
+
+  tracker.markAllDirty();
+  tracker.dirtyPagesSince(second, all);
+  QVERIFY(all);
+  const auto third = tracker.snapshot();
+  QVERIFY(tracker.dirtyPagesSince(third, all).empty());
+  QVERIFY(!all);
+  // Repeated writes to a page after marking all of memory dirty.
+  tracker.markDirty(0x5000, 1);
+  QCOMPARE(tracker.dirtyPagesSince(third, all).size(), size_t(1));
+}
+
+// Ensures that the stores of a processor, and the writes made through the
+// ProcessorHandler, are tracked.
+void tst_DirtyPages::tst_processor_writes() {
+  QStringList program = QStringList() << ".data"
+                                      << "a: .word 0"
+                                      << ".text"
+                                      << "la a0 a"
+                                      << "li a1 5"
+                                      << "sw a1 0 a0";
+  runProgram(ProcessorID::RV32_5S, program, false);
+  auto &tracker = ProcessorHandler::getDirtyPages();
+  const auto since = tracker.snapshot();
+  auto *proc = ProcessorHandler::get()->getProcessorNonConst();
+  while (!proc->finished() && proc->getCycleCount() < 100)
+    proc->clock();
+  QVERIFY(proc->finished());
+
+  const AInt address =
+      ProcessorHandler::get()->getRegisterValue(RegisterFileType::GPR, 10);
+  QCOMPARE(ProcessorHandler::getMemory().readMemConst(address, 4), VInt(5));
+  bool all;
+  auto pages = tracker.dirtyPagesSince(since, all);
+  QVERIFY(!all);
+  QCOMPARE(pages.size(), size_t(1));
+  QVERIFY(contains(pages, address >> DirtyPageTracker::s_pageBits));
+
+  const auto written = tracker.snapshot();
+  const AInt other = address + 8 * DirtyPageTracker::s_pageSize;
+  ProcessorHandler::writeMem(other, 1, 4);
+  pages = tracker.dirtyPagesSince(written, all);
+  QCOMPARE(pages.size(), size_t(1));
+  QVERIFY(contains(pages, other >> DirtyPageTracker::s_pageBits));
+}
+
+QTEST_MAIN(tst_DirtyPages)
+#include "tst_dirtypages.moc"
@@ -9,6 +9,7 @@ class tst_ExprEval : public QObject {
 
 private slots:
   void tst_binops();
+  void tst_rebind();
 };
 
 void expect(const ExprEvalRes &res, const ExprEvalVT &expected) {
@@ -27,5 +28,18 @@ void tst_ExprEval::tst_binops() {
   expect(evaluate(Location::unknown(), "(B *(3+ 4))+4", &symbols.abs), 18);
 }
 
+void tst_ExprEval::tst_rebind() {
+  // Cached expressions must bind the current values of symbols.
+  SymbolMap symbols;
+  symbols.abs["B"] = 2;
+  expect(evaluate(Location::unknown(), "B+4*3", &symbols.abs), 14);
+  symbols.abs["B"] = 10;
+  expect(evaluate(Location::unknown(), "B+4*3", &symbols.abs), 22);
+  symbols.abs.clear();
+  QVERIFY(std::holds_alternative<Error>(
+      evaluate(Location::unknown(), "B+4*3", &symbols.abs)));
+  expect(evaluate(Location::unknown(), "-5@4"), -5);
+}
+
 QTEST_APPLESS_MAIN(tst_ExprEval)
 #include "tst_expreval.moc"
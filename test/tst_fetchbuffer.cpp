@@ -0,0 +1,57 @@
+#include <QStringList>
+#include <QtTest/QTest>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "cachesim/cachesim.h"
+#include "cachesim/fetchbuffer.h"
+#include "programloader.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+class tst_FetchBuffer : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_fetch_buffer();
+};
+
+// Ensures that a loop which fits the loop buffer is captured, such that its
+// subsequent iterations do not access the cache.
+void tst_FetchBuffer::tst_fetch_buffer() {
+  ProcessorHandler::get()->selectProcessor(ProcessorID::RV32_5S, {});
+
+  auto cache = std::make_shared<CacheSim>(nullptr);
+  cache->setMissLatency(10);
+  FetchBuffer::Config config;
+  config.blockBytes = 16;
+  config.loopBytes = 32;
+  auto buffer = std::make_shared<FetchBuffer>(config, nullptr);
+  buffer->setNextLevelCache(cache);
+
+  // 10 iterations of a loop of 6 instructions.
+  constexpr unsigned iterations = 10;
+  for (unsigned it = 0; it < iterations; ++it) {
+    for (AInt addr = 0x100; addr < 0x118; addr += 4)
+      buffer->access(addr, MemoryAccess::Read);
+  }
+  // Leave the loop.
+  buffer->access(0x118, MemoryAccess::Read);
+
+  const auto &stats = buffer->stats();
+  QCOMPARE(stats.fetches, iterations * 6ull + 1);
+  QCOMPARE(stats.loops, 1ull);
+  // The first iteration fetches two blocks; the remaining iterations are served
+  // by the loop buffer, and the fetch past the loop by the fetch buffer.
+  QCOMPARE(stats.loopBufferHits, (iterations - 1) * 6ull);
+  QCOMPARE(stats.cacheAccesses, 2ull);
+  QCOMPARE(stats.fetchBufferHits, 5ull);
+
+  buffer->reset();
+  QCOMPARE(buffer->stats().fetches, 0ull);
+}
+
+QTEST_MAIN(tst_FetchBuffer)
+#include "tst_fetchbuffer.moc"
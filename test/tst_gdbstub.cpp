@@ -0,0 +1,166 @@
+#include <QStringList>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QtTest/QTest>
+
+#include <thread>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "cli/gdbstub.h"
+#include "programloader.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+class tst_GDBStub : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_session();
+};
+
+namespace {
+/// A minimal remote serial protocol client, exchanging a packet and its reply
+/// at a time over a blocking socket.
+class GDBClient {
+public:
+  bool connect(quint16 port) {
+    // The server may not be listening yet.
+    for (unsigned attempt = 0; attempt < 100; ++attempt) {
+      m_socket.connectToHost(QHostAddress::LocalHost, port);
+      if (m_socket.waitForConnected(100))
+        return true;
+      m_socket.abort();
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    return false;
+  }
+
+  /// Sends @p payload, and returns the payload of the reply.
+  QByteArray exchange(const QByteArray &payload) {
+    unsigned sum = 0;
+    for (const char c : payload)
+      sum += static_cast<uint8_t>(c);
+    m_socket.write("$" + payload + "#" +
+                   QByteArray::number(sum & 0xFF, 16).rightJustified(2, '0'));
+    m_socket.waitForBytesWritten(-1);
+
+    // Acknowledgements preceding the reply are discarded.
+    for (;;) {
+      const int start = m_in.indexOf('$');
+      const int end = start < 0 ? -1 : m_in.indexOf('#', start);
+      if (end >= 0 && m_in.size() >= end + 3) {
+        const QByteArray reply = m_in.mid(start + 1, end - start - 1);
+        m_in.remove(0, end + 3);
+        m_socket.write("+");
+        m_socket.waitForBytesWritten(-1);
+        return reply;
+      }
+      if (!m_socket.waitForReadyRead(5000))
+        return "<timeout>";
+      m_in += m_socket.readAll();
+    }
+  }
+
+private:
+  QTcpSocket m_socket;
+  QByteArray m_in;
+};
+} // namespace
+
+static QByteArray hex(AInt value) {
+  return QByteArray::number(static_cast<qulonglong>(value), 16);
+}
+
+// Ensures that a debugging session stops at breakpoints and after single
+// steps, and that registers and memory are transferred in bulk, including
+// escaped binary writes.
+void tst_GDBStub::tst_session() {
+  QStringList program = QStringList() << ".data"
+                                      << "d: .word 0 0"
+                                      << ".text"
+                                      << "li a0 1"
+                                      << "li a1 2"
+                                      << "add a2 a0 a1"
+                                      << "la t0 d"
+                                      << "lw a3 0 t0";
+  runProgram(ProcessorID::RV32_5S, program, false);
+  const AInt text = ProcessorHandler::getTextStart();
+  const AInt data =
+      ProcessorHandler::getProgram()->getSection(".data")->address;
+  const QByteArray breakpoint = hex(text + 8);
+
+  // Find a free port.
+  QTcpServer probe;
+  QVERIFY(probe.listen(QHostAddress::LocalHost));
+  const quint16 port = probe.serverPort();
+  probe.close();
+
+  // Packets sent by the client, and the replies received.
+  const QList<QByteArray> packets = {
+      "qSupported:swbreak+",
+      "Z0," + breakpoint + ",4",
+      "c",
+      "p20",
+      "g",
+      "M" + hex(data) + ",4:78563412",
+      "m" + hex(data) + ",4",
+      "X" + hex(data + 4) + ",4:}\x03}\x04}]}\x0a",
+      "m" + hex(data + 4) + ",4",
+      "s",
+      "p20",
+      "z0," + breakpoint + ",4",
+      "c",
+      "D"};
+  QList<QByteArray> replies;
+  bool connected = false;
+  std::thread client([&] {
+    GDBClient gdb;
+    connected = gdb.connect(port);
+    if (!connected)
+      return;
+    for (const auto &packet : packets)
+      replies << gdb.exchange(packet);
+  });
+  const QString err = runGDBServer(port);
+  client.join();
+  QVERIFY2(err.isEmpty(), qPrintable(err));
+  QVERIFY(connected);
+  QCOMPARE(replies.size(), packets.size());
+
+  QVERIFY(replies.at(0).contains("PacketSize="));
+  QCOMPARE(replies.at(1), QByteArray("OK"));
+  QCOMPARE(replies.at(2), QByteArray("S05"));
+  // The PC is that of the next instruction to retire, in target byte order.
+  const auto le = [](AInt value) {
+    QByteArray out;
+    for (unsigned i = 0; i < 4; ++i)
+      out += QByteArray::number(static_cast<uint>((value >> (8 * i)) & 0xFF),
+                                16)
+                 .rightJustified(2, '0');
+    return out;
+  };
+  QCOMPARE(replies.at(3), le(text + 8));
+  // x0..x31 and the PC; a0 and a1 have retired.
+  QCOMPARE(replies.at(4).size(), 33 * 8);
+  QCOMPARE(replies.at(4).mid(10 * 8, 8), le(1));
+  QCOMPARE(replies.at(4).mid(11 * 8, 8), le(2));
+  QCOMPARE(replies.at(4).right(8), le(text + 8));
+  QCOMPARE(replies.at(5), QByteArray("OK"));
+  QCOMPARE(replies.at(6), QByteArray("78563412"));
+  QCOMPARE(replies.at(7), QByteArray("OK"));
+  QCOMPARE(replies.at(8), QByteArray("23247d2a"));
+  QCOMPARE(replies.at(9), QByteArray("S05"));
+  QCOMPARE(replies.at(10), le(text + 12));
+  QCOMPARE(replies.at(12), QByteArray("W00"));
+  QCOMPARE(replies.at(13), QByteArray("OK"));
+
+  // The program loaded the word written by the debugger.
+  QCOMPARE(ProcessorHandler::get()->getRegisterValue(RegisterFileType::GPR, 13),
+           VInt(0x12345678));
+}
+
+QTEST_MAIN(tst_GDBStub)
+#include "tst_gdbstub.moc"
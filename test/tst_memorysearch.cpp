@@ -0,0 +1,64 @@
+#include <QStringList>
+#include <QtTest/QTest>
+
+#include <optional>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "memorypattern.h"
+#include "programloader.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+class tst_MemorySearch : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_memory_search();
+};
+
+// Ensures that memory searches find values in the program image and in memory
+// written by the program, and that patterns match across pages.
+void tst_MemorySearch::tst_memory_search() {
+  using Kind = MemoryPattern::Kind;
+  MemoryPattern pattern;
+  QVERIFY(!MemoryPattern::parse(Kind::Value, "0x100", 1, pattern).isEmpty());
+  QVERIFY(!MemoryPattern::parse(Kind::Bytes, "de zz", 1, pattern).isEmpty());
+  QVERIFY(MemoryPattern::parse(Kind::Value, "-1", 2, pattern).isEmpty());
+  QCOMPARE(pattern.bytes, QByteArray("\xff\xff"));
+  QCOMPARE(pattern.alignment, 2u);
+
+  QStringList program = QStringList() << ".data"
+                                      << "a: .word 1"
+                                      << "b: .word 0xdeadbeef"
+                                      << ".text"
+                                      << "la a0 a"
+                                      << "li t0 4096"
+                                      << "add a0 a0 t0"
+                                      << "li t1 0xdeadbeef"
+                                      << "sw t1 0 a0";
+  runProgram(ProcessorID::RV32_ISS, program, true);
+  const AInt a = ProcessorHandler::getProgram()->getSection(".data")->address;
+  const AInt end = AInt(1) << 32;
+
+  QVERIFY(
+      MemoryPattern::parse(Kind::Value, "0xdeadbeef", 4, pattern).isEmpty());
+  QCOMPARE(ProcessorHandler::findMem(0, end, pattern), std::optional(a + 4));
+  QCOMPARE(ProcessorHandler::findMem(a + 5, end, pattern),
+           std::optional(a + 4096));
+  QVERIFY(!ProcessorHandler::findMem(a + 4097, end, pattern));
+
+  const AInt boundary = a + 8192;
+  ProcessorHandler::fillMem(boundary - 3, 6, QByteArray("\x12\x34"));
+  QCOMPARE(ProcessorHandler::getMemory().readMemConst(boundary + 2, 1),
+           VInt(0x34));
+  QVERIFY(MemoryPattern::parse(Kind::Bytes, "34 12 ?? 12", 1, pattern)
+              .isEmpty());
+  QCOMPARE(ProcessorHandler::findMem(a, end, pattern),
+           std::optional(boundary - 2));
+}
+
+QTEST_MAIN(tst_MemorySearch)
+#include "tst_memorysearch.moc"
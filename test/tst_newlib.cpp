@@ -0,0 +1,104 @@
+#include <QStringList>
+#include <QtTest/QTest>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "processorstate.h"
+#include "programloader.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+class tst_Newlib : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_brk_data();
+  void tst_brk();
+  void cleanup();
+};
+
+void tst_Newlib::cleanup() {
+  ProcessorHandler::setSyscallABI(SyscallABI::RARS);
+}
+
+static VInt reg(unsigned idx) {
+  return ProcessorHandler::get()->getRegisterValue(RegisterFileType::GPR, idx);
+}
+
+// Clocks the current processor until it finishes.
+static void clockToFinish() {
+  auto *proc = ProcessorHandler::get()->getProcessorNonConst();
+  while (!proc->finished() && proc->getCycleCount() < 1000)
+    proc->clock();
+  QVERIFY(proc->finished());
+}
+
+void tst_Newlib::tst_brk_data() {
+  QTest::addColumn<int>("id");
+  QTest::newRow("RV32_ISS") << static_cast<int>(ProcessorID::RV32_ISS);
+  QTest::newRow("RV32_5S") << static_cast<int>(ProcessorID::RV32_5S);
+  QTest::newRow("RV64_ISS") << static_cast<int>(ProcessorID::RV64_ISS);
+}
+
+// Ensures that brk grows and shrinks the heap as the sbrk of libgloss does,
+// that the heap is usable memory, that the program break is reset alongside
+// the processor, and that the standard streams are character devices.
+void tst_Newlib::tst_brk() {
+  QFETCH(int, id);
+  QStringList program = QStringList() << ".data"
+                                      << "st: .zero 128"
+                                      << ".text"
+                                      << "li a7 214"
+                                      << "li a0 0"
+                                      << "ecall"
+                                      << "mv s0 a0"
+                                      // sbrk(64)
+                                      << "addi a0 s0 64"
+                                      << "ecall"
+                                      << "mv s1 a0"
+                                      << "li t0 1234"
+                                      << "sw t0 60 s0"
+                                      // sbrk(-32)
+                                      << "addi a0 s1 -32"
+                                      << "ecall"
+                                      << "mv s2 a0"
+                                      << "li a0 0"
+                                      << "ecall"
+                                      << "mv s3 a0"
+                                      << "lw s4 60 s0"
+                                      // fstat(1, &st)
+                                      << "li a7 80"
+                                      << "li a0 1"
+                                      << "la a1 st"
+                                      << "ecall"
+                                      << "mv s5 a0"
+                                      << "lw s6 16 a1";
+  ProcessorHandler::setSyscallABI(SyscallABI::Newlib);
+  ProcessorHandler::get()->selectProcessor(static_cast<ProcessorID>(id),
+                                           {});
+  RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+  auto loader = new ProgramLoader();
+  loader->loadTest(program.join("\n"));
+
+  const AInt initial = initialProgramBreak(*ProcessorHandler::getProgram());
+  for (unsigned run = 0; run < 2; ++run) {
+    clockToFinish();
+    QCOMPARE(reg(8), VInt(initial));
+    QCOMPARE(reg(9), VInt(initial + 64));
+    QCOMPARE(reg(18), VInt(initial + 32));
+    QCOMPARE(reg(19), VInt(initial + 32));
+    QCOMPARE(reg(20), VInt(1234));
+    QCOMPARE(ProcessorHandler::getProgramBreak(), initial + 32);
+    QCOMPARE(reg(21), VInt(0));
+    QCOMPARE(reg(22), VInt(0020620));
+
+    // The program break starts over once the processor is reset.
+    RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+    QCOMPARE(ProcessorHandler::getProgramBreak(), AInt(0));
+  }
+}
+
+QTEST_MAIN(tst_Newlib)
+#include "tst_newlib.moc"
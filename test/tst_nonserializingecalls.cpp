@@ -0,0 +1,107 @@
+#include <QStringList>
+#include <QtTest/QTest>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "programloader.h"
+#include "ripessettings.h"
+#include "syscall/systemio.h"
+
+using namespace Ripes;
+
+class tst_NonSerializingEcalls : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_output_order_data();
+  void tst_output_order();
+  void cleanup();
+};
+
+void tst_NonSerializingEcalls::cleanup() {
+  ProcessorHandler::setNonSerializingEcalls(false);
+  SystemIO::setOutputSink({});
+}
+
+// Runs @p program on processor @p id, with syscalls serviced, and returns its
+// console output and cycle count.
+static void runOutput(ProcessorID id, const QStringList &program,
+                      QString &output, long long &cycles) {
+  output.clear();
+  SystemIO::setOutputSink([&output](const QString &text) { output += text; });
+  ProcessorHandler::get()->selectProcessor(id, {});
+  RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+  auto loader = new ProgramLoader();
+  loader->loadTest(program.join("\n"));
+  auto *proc = ProcessorHandler::get()->getProcessorNonConst();
+  while (!proc->finished() && proc->getCycleCount() < 10000)
+    proc->clock();
+  QVERIFY(proc->finished());
+  cycles = proc->getCycleCount();
+}
+
+void tst_NonSerializingEcalls::tst_output_order_data() {
+  QTest::addColumn<int>("id");
+  QTest::addColumn<bool>("dualIssue");
+  QTest::newRow("RV32_5S") << static_cast<int>(ProcessorID::RV32_5S) << false;
+  QTest::newRow("RV64_5S") << static_cast<int>(ProcessorID::RV64_5S) << false;
+  QTest::newRow("RV32_5S_NO_FW")
+      << static_cast<int>(ProcessorID::RV32_5S_NO_FW) << false;
+  QTest::newRow("RV32_6S_DUAL")
+      << static_cast<int>(ProcessorID::RV32_6S_DUAL) << true;
+}
+
+// Ensures that output-only ecalls which do not drain the pipeline print the
+// same output, in the same order, as ecalls which do, given arguments written
+// by the instructions immediately preceding the ecalls, and that they take
+// fewer cycles. The dual-issue processor may pair the ecalls with register
+// writes, which still serialize.
+void tst_NonSerializingEcalls::tst_output_order() {
+  QFETCH(int, id);
+  QFETCH(bool, dualIssue);
+  QStringList program = QStringList() << ".data"
+                                      << "sep: .string \"-\""
+                                      << ".text"
+                                      << "la s2 sep"
+                                      << "li s0 0"
+                                      << "li s1 10"
+                                      << "loop:"
+                                      << "addi s0 s0 1"
+                                      // PrintInt
+                                      << "slli a0 s0 3"
+                                      << "li a7 1"
+                                      << "ecall"
+                                      // PrintChar, of a loaded argument
+                                      << "lb a0 0 s2"
+                                      << "li a7 11"
+                                      << "ecall"
+                                      // PrintString
+                                      << "mv a0 s2"
+                                      << "li a7 4"
+                                      << "ecall"
+                                      << "blt s0 s1 loop";
+  QString expected;
+  for (unsigned i = 1; i <= 10; ++i)
+    expected += QString::number(i * 8) + "--";
+
+  QString drained;
+  long long drainedCycles = 0;
+  runOutput(static_cast<ProcessorID>(id), program, drained, drainedCycles);
+  QCOMPARE(drained, expected);
+
+  ProcessorHandler::setNonSerializingEcalls(true);
+  QString forwarded;
+  long long forwardedCycles = 0;
+  runOutput(static_cast<ProcessorID>(id), program, forwarded, forwardedCycles);
+  QCOMPARE(forwarded, drained);
+  if (dualIssue)
+    QVERIFY(forwardedCycles <= drainedCycles);
+  else
+    QVERIFY2(forwardedCycles < drainedCycles,
+             qPrintable(QString::number(forwardedCycles) + " >= " +
+                        QString::number(drainedCycles)));
+}
+
+QTEST_MAIN(tst_NonSerializingEcalls)
+#include "tst_nonserializingecalls.moc"
@@ -0,0 +1,63 @@
+#include <QStringList>
+#include <QtTest/QTest>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "programloader.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+class tst_Observer : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_processor_observer();
+};
+
+class CountingObserver : public ProcessorObserver {
+public:
+  unsigned events() const override { return Retire | MemAccess | StageUpdate; }
+  void onRetire(const RipesProcessor &, unsigned count) override {
+    retired += count;
+  }
+  void onMemAccess(const RipesProcessor &, const MemoryAccess &,
+                   bool data) override {
+    (data ? dataAccesses : instrAccesses)++;
+  }
+  void onStageUpdate(const RipesProcessor &, StageIndex,
+                     const StageInfo &) override {
+    stageUpdates++;
+  }
+
+  long long retired = 0;
+  long long instrAccesses = 0;
+  long long dataAccesses = 0;
+  long long stageUpdates = 0;
+};
+
+// Ensures that observers see every retirement, memory access and stage of a
+// run.
+void tst_Observer::tst_processor_observer() {
+  CountingObserver observer;
+  ProcessorHandler::attachObserver(&observer);
+  QStringList program = QStringList() << ".data"
+                                      << "a: .word 42"
+                                      << ".text"
+                                      << "la a0 a"
+                                      << "lw a1 0 a0"
+                                      << "addi a1 a1 1"
+                                      << "sw a1 0 a0";
+  runProgram(ProcessorID::RV32_ISS, program, true);
+  ProcessorHandler::detachObserver(&observer);
+
+  const auto *proc = ProcessorHandler::getProcessor();
+  QCOMPARE(observer.retired, proc->getInstructionsRetired());
+  QCOMPARE(observer.instrAccesses, proc->getInstructionsRetired());
+  QCOMPARE(observer.dataAccesses, 2LL);
+  QCOMPARE(observer.stageUpdates, proc->getCycleCount());
+}
+
+QTEST_MAIN(tst_Observer)
+#include "tst_observer.moc"
@@ -0,0 +1,104 @@
+#include <QtTest/QTest>
+
+#include "processors/pagedaddressspace.h"
+
+using namespace Ripes;
+
+class tst_PagedAddressSpace : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_cross_page();
+  void tst_aliasing();
+  void tst_zero_pages();
+};
+
+// Ensures that accesses crossing a page boundary see, and update, the
+// materialized pages on either side of the boundary.
+void tst_PagedAddressSpace::tst_cross_page() {
+  PagedAddressSpaceMM mem;
+  const char data[] = {1, 2, 3, 4, 5, 6, 7, 8};
+  mem.addInitializationMemory(0xffc, data, sizeof(data));
+  mem.reset();
+
+  // Materialize both pages through stores within them.
+  mem.writeMem(0xffc, 0x11, 1);
+  mem.writeMem(0x1000, 0x55, 1);
+  QCOMPARE(mem.readMem(0xffe, 4), VInt(0x06550403));
+
+  mem.writeMem(0xfff, 0xaabbccdd, 4);
+  const VInt expected = 0x08aabbccdd030211;
+  QCOMPARE(mem.readMem(0xffc, 8), expected);
+  QCOMPARE(mem.readMemConst(0xffc, 8), expected);
+  QCOMPARE(mem.readMem(0x1000, 2), VInt(0xbbcc));
+  QCOMPARE(mem.readMem(0xffc, 4), VInt(0xdd030211));
+
+  // The underlying memory agrees once the pages are written back.
+  mem.synchronize();
+  QCOMPARE(mem.readMemConst(0xffc, 8), expected);
+  QCOMPARE(mem.readMem(0xffc, 8), expected);
+}
+
+// Ensures that pages sharing their index within a directory, and zero pages
+// served by the shared zero page, do not alias.
+void tst_PagedAddressSpace::tst_aliasing() {
+  PagedAddressSpaceMM mem;
+  mem.reset();
+  constexpr AInt directoryBytes = PagedAddressSpaceMM::s_pageSize
+                                  << PagedAddressSpaceMM::s_directoryBits;
+  const std::vector<AInt> addresses = {0x100, 0x100 + directoryBytes,
+                                       0x100 + (AInt(1) << 40)};
+  for (const AInt address : addresses)
+    QCOMPARE(mem.readMem(address, 4), VInt(0));
+  for (unsigned i = 0; i < addresses.size(); ++i)
+    mem.writeMem(addresses[i], i + 1, 4);
+  for (unsigned i = 0; i < addresses.size(); ++i)
+    QCOMPARE(mem.readMem(addresses[i], 4), VInt(i + 1));
+
+  // A zero page read before and after a store to another zero page.
+  const AInt zero = 0x100 + 2 * PagedAddressSpaceMM::s_pageSize;
+  QCOMPARE(mem.readMem(zero, 4), VInt(0));
+  mem.writeMem(zero + PagedAddressSpaceMM::s_pageSize, 0x1234, 4);
+  QCOMPARE(mem.readMem(zero, 4), VInt(0));
+  QCOMPARE(mem.readMem(zero + PagedAddressSpaceMM::s_pageSize, 4),
+           VInt(0x1234));
+}
+
+// Ensures that pages of zero initialization memory are read without being
+// materialized, and are materialized upon their first write.
+void tst_PagedAddressSpace::tst_zero_pages() {
+  constexpr AInt pageSize = PagedAddressSpaceMM::s_pageSize;
+  constexpr AInt base = 0x10000;
+  constexpr AInt basePage = base / pageSize;
+  QByteArray data(16 * pageSize, '\0');
+  data[3 * pageSize + 5] = 7;
+  data[11 * pageSize - 1] = 9;
+  PagedAddressSpaceMM mem;
+  addInitializationMemory(mem, base, data.constData(), data.size());
+  mem.reset();
+
+  for (AInt page = 0; page < 16; ++page)
+    QCOMPARE(mem.readMem(base + page * pageSize + 4, 4),
+             VInt(page == 3 ? 0x700 : 0));
+  QCOMPARE(mem.readMem(base + 11 * pageSize - 4, 4), VInt(0x09000000));
+  QCOMPARE(mem.materializedPages(),
+           std::vector<AInt>({basePage + 3, basePage + 10}));
+  QCOMPARE(mem.zeroPages().size(), size_t(14));
+
+  // The first write to a zero page materializes it.
+  mem.writeMem(base + 8, 0x1234, 4);
+  QCOMPARE(mem.readMem(base + 8, 4), VInt(0x1234));
+  QCOMPARE(mem.readMem(base + pageSize + 8, 4), VInt(0));
+  QCOMPARE(mem.materializedPages(),
+           std::vector<AInt>({basePage, basePage + 3, basePage + 10}));
+  QCOMPARE(mem.zeroPages().size(), size_t(13));
+
+  // Resetting restores the zeros of the initialization memory.
+  mem.reset();
+  QVERIFY(mem.materializedPages().empty());
+  QCOMPARE(mem.readMem(base + 8, 4), VInt(0));
+  QCOMPARE(mem.readMem(base + 3 * pageSize + 4, 4), VInt(0x700));
+}
+
+QTEST_MAIN(tst_PagedAddressSpace)
+#include "tst_pagedaddressspace.moc"
@@ -0,0 +1,59 @@
+#include <QStringList>
+#include <QtTest/QTest>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "pageprofiler.h"
+#include "programloader.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+class tst_PageProfiler : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_page_profiler();
+};
+
+// Ensures that data accesses are counted by page, and that the page table
+// retains all pages as it grows.
+void tst_PageProfiler::tst_page_profiler() {
+  PageCounterTable table;
+  for (AInt page = 0; page < 1000; ++page)
+    table.get(page * 7).reads += page;
+  QCOMPARE(table.size(), size_t(1000));
+  for (AInt page = 0; page < 1000; ++page) {
+    QVERIFY(table.find(page * 7) != nullptr);
+    QCOMPARE(table.find(page * 7)->reads,
+             static_cast<unsigned long long>(page));
+  }
+  QVERIFY(table.find(1) == nullptr);
+
+  PageProfiler profiler(12, 1000);
+  QStringList program = QStringList() << ".data"
+                                      << "a: .word 42"
+                                      << ".text"
+                                      << "la a0 a"
+                                      << "lw a1 0 a0"
+                                      << "sw a1 0 a0"
+                                      << "li t0 4096"
+                                      << "add a0 a0 t0"
+                                      << "sw a1 0 a0";
+  runProgram(ProcessorID::RV32_ISS, program, true);
+  profiler.finish();
+
+  QCOMPARE(profiler.footprint(), 2ull);
+  const auto pages = profiler.hottest(2);
+  QCOMPARE(pages.size(), size_t(2));
+  QCOMPARE(pages[0].reads, 1ull);
+  QCOMPARE(pages[0].writes, 1ull);
+  QCOMPARE(pages[1].reads, 0ull);
+  QCOMPARE(pages[1].writes, 1ull);
+  QCOMPARE(profiler.samples().size(), size_t(1));
+  QCOMPARE(profiler.samples().front().pages, 2ull);
+}
+
+QTEST_MAIN(tst_PageProfiler)
+#include "tst_pageprofiler.moc"
@@ -0,0 +1,54 @@
+#include <QStringList>
+#include <QtTest/QTest>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "programloader.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+class tst_ProcessorPool : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_processor_pool();
+};
+
+// Ensures that reselecting a processor reuses the previously constructed
+// instance, reset to its initial state.
+void tst_ProcessorPool::tst_processor_pool() {
+  ProcessorHandler::get()->selectProcessor(ProcessorID::RV32_5S, {"M"});
+  auto loader = new ProgramLoader();
+  loader->loadTest(QStringList({".text", "loop:", "addi a0 a0 1", "j loop"})
+                       .join("\n"));
+  auto *proc = ProcessorHandler::get()->getProcessorNonConst();
+  for (unsigned i = 0; i < 20; ++i)
+    proc->clock();
+  QVERIFY(proc->getInstructionsRetired() > 0);
+
+  // The program is kept across processors of the same ISA.
+  ProcessorHandler::get()->selectProcessor(ProcessorID::RV32_SS, {"M"});
+  ProcessorHandler::get()->selectProcessor(ProcessorID::RV32_5S, {"M"});
+  QCOMPARE(ProcessorHandler::get()->getProcessorNonConst(), proc);
+  QCOMPARE(proc->getCycleCount(), 0);
+  QCOMPARE(proc->getInstructionsRetired(), 0);
+  QVERIFY(ProcessorHandler::getProgram() != nullptr);
+  const VInt instr = proc->getMemory().readMemConst(0, 4);
+  QVERIFY(instr != 0);
+
+  // Processors are pooled by their extensions.
+  ProcessorHandler::get()->selectProcessor(ProcessorID::RV32_5S, {});
+  QVERIFY(ProcessorHandler::get()->getProcessorNonConst() != proc);
+
+  // A program dropped while the processor was pooled is unloaded.
+  ProcessorHandler::get()->selectProcessor(ProcessorID::RV64_5S, {"M"});
+  ProcessorHandler::get()->selectProcessor(ProcessorID::RV32_5S, {"M"});
+  QCOMPARE(ProcessorHandler::get()->getProcessorNonConst(), proc);
+  QVERIFY(ProcessorHandler::getProgram() == nullptr);
+  QCOMPARE(proc->getMemory().readMemConst(0, 4), VInt(0));
+}
+
+QTEST_MAIN(tst_ProcessorPool)
+#include "tst_processorpool.moc"
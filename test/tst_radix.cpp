@@ -0,0 +1,53 @@
+#include <QStringList>
+#include <QtTest/QTest>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "programloader.h"
+#include "radix.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+class tst_Radix : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_radix_format();
+};
+
+// Ensures that values are formatted as by the QString based encodings which
+// formatRadixValue replaces, including values wider than their byte width.
+void tst_Radix::tst_radix_format() {
+  const std::vector<VInt> values = {
+      0, 1, 9, 10, 99, 100, 0x123, 0x7fffffff, 0xdeadbeef, ~VInt(0),
+      VInt(1) << 63, 12345678901};
+  for (const VInt value : values) {
+    for (const unsigned width : {1u, 4u, 8u}) {
+      QCOMPARE(encodeRadixValue(value, Radix::Hex, width),
+               "0x" +
+                   QString::number(value, 16).rightJustified(width * 2, '0'));
+      QCOMPARE(encodeRadixValue(value, Radix::Binary, width),
+               "0b" +
+                   QString::number(value, 2).rightJustified(width * 8, '0'));
+      QCOMPARE(encodeRadixValue(value, Radix::Unsigned, width),
+               QString::number(value));
+      QCOMPARE(encodeRadixValue(value, Radix::Signed, width),
+               width == 4 ? QString::number(static_cast<int32_t>(value))
+                          : QString::number(static_cast<int64_t>(value)));
+    }
+  }
+
+  const uint8_t data[] = {0xef, 0xbe, 0xad, 0xde, 0x01, 0x00, 0x00, 0x00};
+  QByteArray out = "0:";
+  formatRadixValues(out, data, sizeof(data), Radix::Hex, 4);
+  QCOMPARE(out, QByteArray("0:0xdeadbeef 0x00000001"));
+  out.clear();
+  formatRadixValues(out, data, 3, Radix::Signed, 2, ',');
+  // As encodeRadixValue, only 4-byte values are sign extended.
+  QCOMPARE(out, QByteArray("48879"));
+}
+
+QTEST_MAIN(tst_Radix)
+#include "tst_radix.moc"
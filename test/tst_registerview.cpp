@@ -0,0 +1,43 @@
+#include <QStringList>
+#include <QtTest/QTest>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "programloader.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+class tst_RegisterView : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_register_view();
+};
+
+// Ensures that register views and bulk register writes agree with the
+// per-register accessors, for processors with and without their own views.
+void tst_RegisterView::tst_register_view() {
+  for (auto processor :
+       {ProcessorID::RV32_SS, ProcessorID::RV32_ISS, ProcessorID::RV64_ISS}) {
+    QStringList program = QStringList() << ".text"
+                                        << "li x10 -1"
+                                        << "li x11 5";
+    runProgram(processor, program, true);
+    auto *proc = ProcessorHandler::get()->getProcessorNonConst();
+    proc->setRegisters(RegisterFileType::GPR, {{12, 7}, {13, 9}});
+    const RegisterView regs = proc->registers(RegisterFileType::GPR);
+    QCOMPARE(regs.size(), ProcessorHandler::get()->currentISA()->regCnt());
+    for (unsigned i = 0; i < regs.size(); ++i)
+      QCOMPARE(regs[i], proc->getRegister(RegisterFileType::GPR, i));
+    QCOMPARE(regs[10], proc->implementsISA()->bits() == 32 ? VInt(0xFFFFFFFF)
+                                                           : ~VInt(0));
+    QCOMPARE(regs[11], VInt(5));
+    QCOMPARE(regs[12], VInt(7));
+    QCOMPARE(regs[13], VInt(9));
+  }
+}
+
+QTEST_MAIN(tst_RegisterView)
+#include "tst_registerview.moc"
@@ -0,0 +1,87 @@
+#include <QStringList>
+#include <QtTest/QTest>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "cachesim/cachesim.h"
+#include "cachesim/stackdistanceprofiler.h"
+#include "programloader.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+class tst_ReuseDistance : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_reuse_distance();
+  void tst_stack_distance();
+};
+
+// Ensures that reuse distances count the distinct blocks accessed between
+// consecutive accesses to a block, also across renumbering of the timestamps.
+void tst_ReuseDistance::tst_reuse_distance() {
+  ReuseDistanceTracker tracker;
+  QCOMPARE(tracker.access(1), ReuseDistanceTracker::s_cold);
+  QCOMPARE(tracker.access(2), ReuseDistanceTracker::s_cold);
+  QCOMPARE(tracker.access(3), ReuseDistanceTracker::s_cold);
+  QCOMPARE(tracker.access(1), 2LL);
+  QCOMPARE(tracker.access(2), 2LL);
+  QCOMPARE(tracker.access(2), 0LL);
+  QCOMPARE(tracker.access(3), 2LL);
+
+  // Cycling through more blocks than the initial timestamp capacity.
+  tracker.reset();
+  for (unsigned round = 0; round < 3; ++round) {
+    for (AInt block = 0; block < 1500; ++block) {
+      QCOMPARE(tracker.access(block),
+               round == 0 ? ReuseDistanceTracker::s_cold : 1499LL);
+    }
+  }
+  QCOMPARE(ReuseDistanceTracker::bucket(0), 0u);
+  QCOMPARE(ReuseDistanceTracker::bucket(1), 1u);
+  QCOMPARE(ReuseDistanceTracker::bucket(1499), 11u);
+}
+
+// Ensures that the misses derived from the stack distance profile match those
+// of simulating each LRU cache configuration.
+void tst_ReuseDistance::tst_stack_distance() {
+  ProcessorHandler::get()->selectProcessor(ProcessorID::RV32_5S, {});
+  // Blocks of 4 words.
+  constexpr unsigned blockBits = 4;
+  StackDistanceProfiler profiler(blockBits);
+  std::vector<AInt> addresses;
+  uint32_t state = 1;
+  for (unsigned i = 0; i < 4000; ++i) {
+    state = state * 1103515245 + 12345;
+    // Mostly accesses within a small working set, and occasional far ones.
+    const AInt range = (state >> 28) == 0 ? 0x10000 : 0x800;
+    addresses.push_back(((state >> 8) % range) & ~AInt(3));
+  }
+  for (const AInt address : addresses)
+    profiler.access(address);
+  QCOMPARE(profiler.accesses(), 4000ull);
+
+  const auto simulate = [&](int lines, int ways) {
+    auto cache = std::make_shared<CacheSim>(nullptr);
+    cache->setPreset({"", blockBits - 2, lines, ways, WritePolicy::WriteBack,
+                      WriteAllocPolicy::WriteAllocate, ReplPolicy::LRU});
+    for (unsigned i = 0; i < addresses.size(); ++i)
+      cache->replayAccess(addresses[i], MemoryAccess::Read, i);
+    return static_cast<unsigned long long>(cache->getMisses());
+  };
+  for (int setBits : {0, 2, 5})
+    for (int wayBits : {0, 1, 3})
+      QCOMPARE(profiler.misses(setBits, wayBits), simulate(setBits, wayBits));
+  for (unsigned capacityBits : {0u, 2u, 4u})
+    QCOMPARE(profiler.fullyAssociativeMisses(capacityBits),
+             simulate(0, capacityBits));
+  // Beyond the working set, only compulsory misses remain.
+  const unsigned maxBits = profiler.maxCapacityBits();
+  QCOMPARE(profiler.fullyAssociativeMisses(maxBits + 1),
+           profiler.fullyAssociativeMisses(maxBits));
+}
+
+QTEST_MAIN(tst_ReuseDistance)
+#include "tst_reusedistance.moc"
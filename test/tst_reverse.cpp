@@ -9,6 +9,8 @@
 #include "processorhandler.h"
 #include "processorregistry.h"
 
+#include "cachesim/cachesim.h"
+#include "cachesim/l1cacheshim.h"
 #include "edittab.h"
 #include "isa/rvisainfo_common.h"
 #include "programloader.h"
@@ -29,6 +31,10 @@ private slots:
                 bool toFinish);
   void tst_reverse_regs();
   void tst_reverse_mem();
+  void tst_seek_checkpoint();
+  void tst_seek_syscall();
+  void bench_clock_data();
+  void bench_clock();
 };
 
 using Registers = std::map<int, VInt>;
@@ -109,5 +115,101 @@ void tst_reverse::tst_reverse_mem() {
   }
 }
 
+// Ensures that seeking back from beyond a checkpoint of the ISS restores the
+// registers and memory of the target cycle.
+void tst_reverse::tst_seek_checkpoint() {
+  QStringList program = QStringList() << ".data"
+                                      << "a: .word 0"
+                                      << ".text"
+                                      << "la a1 a"
+                                      << "loop:"
+                                      << "addi a0 a0 1"
+                                      << "sw a0 0 a1"
+                                      << "j loop";
+  runProgram(ProcessorID::RV32_ISS, program, false);
+  const AInt a = ProcessorHandler::getProgram()->getSection(".data")->address;
+  ProcessorHandler::clock(150001);
+  ProcessorHandler::waitForIdle();
+  const Registers regs = dumpRegs();
+  const VInt value = ProcessorHandler::getMemory().readMemConst(a, 4);
+
+  ProcessorHandler::clock(100000);
+  ProcessorHandler::waitForIdle();
+  QVERIFY(ProcessorHandler::getMemory().readMemConst(a, 4) != value);
+  ProcessorHandler::seekToCycle(150001);
+  ProcessorHandler::waitForIdle();
+  QCOMPARE(ProcessorHandler::getProcessor()->getCycleCount(), 150001LL);
+  QCOMPARE(dumpRegs(), regs);
+  QCOMPARE(ProcessorHandler::getMemory().readMemConst(a, 4), value);
+}
+
+// Ensures that seeking back replaces system calls by their recorded results,
+// rather than executing them anew.
+void tst_reverse::tst_seek_syscall() {
+  QStringList program = QStringList() << ".text"
+                                      << "li a7 30"
+                                      << "ecall"
+                                      << "mv s0 a0"
+                                      << "li t0 0"
+                                      << "li t1 100"
+                                      << "loop:"
+                                      << "addi t0 t0 1"
+                                      << "blt t0 t1 loop";
+  // The system call is executed, so the program is not loaded through
+  // runProgram.
+  ProcessorHandler::get()->selectProcessor(ProcessorID::RV32_5S, {});
+  RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+  auto loader = new ProgramLoader();
+  loader->loadTest(program.join("\n"));
+  ProcessorHandler::clock(300);
+  ProcessorHandler::waitForIdle();
+  const Registers regs = dumpRegs();
+
+  // The time returned by the system call differs, were it executed anew.
+  QTest::qSleep(10);
+  ProcessorHandler::seekToCycle(299);
+  ProcessorHandler::waitForIdle();
+  ProcessorHandler::clock();
+  ProcessorHandler::waitForIdle();
+  QCOMPARE(ProcessorHandler::getProcessor()->getCycleCount(), 300LL);
+  QCOMPARE(dumpRegs(), regs);
+}
+
+void tst_reverse::bench_clock_data() {
+  QTest::addColumn<bool>("reversible");
+  QTest::newRow("rewind") << true;
+  QTest::newRow("no rewind") << false;
+}
+
+// Benchmarks clocking a pipelined processor with an attached data cache with
+// and without undo recording, to quantify the cost of reverse stacks and
+// cache undo traces.
+void tst_reverse::bench_clock() {
+  QFETCH(bool, reversible);
+  constexpr unsigned cycles = 5000;
+  ProcessorHandler::setReversible(reversible);
+  ProcessorHandler::get()->selectProcessor(ProcessorID::RV32_5S, {});
+  RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+  ProcessorHandler::get()->getProcessorNonConst()->trapHandler = [=] {};
+
+  auto shim =
+      std::make_shared<L1CacheShim>(L1CacheShim::CacheType::DataCache, nullptr);
+  auto cache = std::make_shared<CacheSim>(nullptr);
+  shim->setNextLevelCache(cache);
+
+  auto loader = new ProgramLoader();
+  loader->loadTest(QStringList({".data", "a: .word 0", ".text", "la a0 a",
+                                "loop:", "lw a1 0 a0", "addi a1 a1 1",
+                                "sw a1 0 a0", "j loop"})
+                       .join("\n"));
+  auto proc = ProcessorHandler::get()->getProcessorNonConst();
+  QBENCHMARK {
+    RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+    for (unsigned i = 0; i < cycles; ++i)
+      proc->clock();
+  }
+  ProcessorHandler::setReversible(true);
+}
+
 QTEST_MAIN(tst_reverse)
 #include "tst_reverse.moc"
@@ -38,16 +38,26 @@ static constexpr unsigned s_ecallreg = 10; // a0
 // Maximum cycle count
 static constexpr unsigned s_maxCycles = 10000;
 
+// Cycle at which the machine timer of the trap tests fires
+static constexpr uint64_t s_timerCompare = 1000;
+
 // Tests which contains instructions or assembler directives not yet supported
 const auto s_excludedTests = {"f", "ldst", "move", "recoding",
                               /* fails on CI, unknown as of know */ "memory"};
 
+// Environment variable selecting the shard of the tests to run, as
+// "<index>/<count>". Each test function runs every count'th test file,
+// starting from index, such that the suite may be split across concurrently
+// running processes (see test/CMakeLists.txt).
+static constexpr const char *s_shardEnv = "RIPES_TEST_SHARD";
+
 class tst_RISCV : public QObject {
   Q_OBJECT
 
 private:
   void loadBinaryToSimulator(const QString &binFile);
   bool skipTest(const QString &test);
+  QString runTest(const QString &testPath);
   QString executeSimulator();
   QString dumpRegs();
 
@@ -55,14 +65,50 @@ private:
 
   void runTests(const ProcessorID &id, const QStringList &extensions,
                 const QStringList &testdirs);
+  void runBatchedTests(const ProcessorID &id, const QStringList &extensions,
+                       const QStringList &testdirs);
 
   void trapHandler();
 
   bool m_stop = false;
+  // Whether tests are executed through clockBatch rather than clock.
+  bool m_batched = false;
+  // Whether a machine timer, firing at s_timerCompare, is attached.
+  bool m_timer = false;
   std::shared_ptr<Program> m_program;
   QString m_err;
 
+  unsigned m_shardIndex = 0;
+  unsigned m_shardCount = 1;
+
 private slots:
+  void initTestCase() {
+    const QString shard = qEnvironmentVariable(s_shardEnv);
+    if (shard.isEmpty())
+      return;
+    const QStringList parts = shard.split('/');
+    bool indexOk = false, countOk = false;
+    if (parts.size() == 2) {
+      m_shardIndex = parts.at(0).toUInt(&indexOk);
+      m_shardCount = parts.at(1).toUInt(&countOk);
+    }
+    if (!indexOk || !countOk || m_shardCount == 0 ||
+        m_shardIndex >= m_shardCount) {
+      const QString err = QString("Invalid test shard '%1' in %2")
+                              .arg(shard)
+                              .arg(s_shardEnv);
+      QFAIL(err.toStdString().c_str());
+    }
+    qInfo() << "Running shard" << m_shardIndex << "of" << m_shardCount;
+  }
+  // Tests changing the configuration of the simulator may fail before
+  // restoring it; the configuration is restored here rather than by the tests.
+  void cleanup() {
+    m_timer = false;
+    m_batched = false;
+    ProcessorHandler::setBranchPredictor(BranchPredictor::Scheme::NotTaken);
+    ProcessorHandler::setMExtTiming({});
+  }
 
   void testRV64_SingleCycle() {
     runTests(ProcessorID::RV64_SS, {"M", "C"},
@@ -80,6 +126,14 @@ private slots:
     runTests(ProcessorID::RV64_6S_DUAL, {"M", "C"},
              {RISCV64_TEST_DIR, RISCV64_C_TEST_DIR});
   }
+  void testRV64_ISS() {
+    runTests(ProcessorID::RV64_ISS, {"M", "C"},
+             {RISCV64_TEST_DIR, RISCV64_C_TEST_DIR});
+  }
+  void testRV64_Superscalar2W() {
+    runTests(ProcessorID::RV64_SUPERSCALAR_2W, {"M", "C"},
+             {RISCV64_TEST_DIR, RISCV64_C_TEST_DIR});
+  }
 
   void testRV32_SingleCycle() {
     runTests(ProcessorID::RV32_SS, {"M", "C"},
@@ -97,6 +151,75 @@ private slots:
     runTests(ProcessorID::RV32_6S_DUAL, {"M", "C"},
              {RISCV32_TEST_DIR, RISCV32_C_TEST_DIR});
   }
+  void testRV32_ISS() {
+    runTests(ProcessorID::RV32_ISS, {"M", "C"},
+             {RISCV32_TEST_DIR, RISCV32_C_TEST_DIR});
+  }
+  void testRV32_Superscalar4W() {
+    runTests(ProcessorID::RV32_SUPERSCALAR_4W, {"M", "C"},
+             {RISCV32_TEST_DIR, RISCV32_C_TEST_DIR});
+  }
+  void testRV32_OutOfOrder() {
+    runTests(ProcessorID::RV32_OOO, {"M", "C"},
+             {RISCV32_TEST_DIR, RISCV32_C_TEST_DIR});
+  }
+  void testRV64_OutOfOrder() {
+    runTests(ProcessorID::RV64_OOO, {"M", "C"},
+             {RISCV64_TEST_DIR, RISCV64_C_TEST_DIR});
+  }
+  void testRV32_MultiHart2() {
+    // Both harts execute each test in lockstep; the first ecall, of hart 0,
+    // reports the result.
+    runTests(ProcessorID::RV32_MULTIHART_2, {"M", "C"},
+             {RISCV32_TEST_DIR, RISCV32_C_TEST_DIR});
+  }
+  void testRV32_ISS_Batched() {
+    runBatchedTests(ProcessorID::RV32_ISS, {"M", "C"},
+                    {RISCV32_TEST_DIR, RISCV32_C_TEST_DIR});
+  }
+  void testRV64_ISS_Batched() {
+    runBatchedTests(ProcessorID::RV64_ISS, {"M", "C"},
+                    {RISCV64_TEST_DIR, RISCV64_C_TEST_DIR});
+  }
+  void testRV32_ISS_Atomics() {
+    runTests(ProcessorID::RV32_ISS, {"M", "A"}, {RISCV32_A_TEST_DIR});
+  }
+  void testRV32_MultiHart2_Atomics() {
+    // Each hart operates on its own stack, such that the harts do not contend.
+    runTests(ProcessorID::RV32_MULTIHART_2, {"M", "A"}, {RISCV32_A_TEST_DIR});
+  }
+  void testRV32_ISS_FloatingPoint() {
+    runTests(ProcessorID::RV32_ISS, {"M", "F", "D"}, {RISCV32_F_TEST_DIR});
+  }
+  void testRV32_ISS_FloatingPoint_Batched() {
+    runBatchedTests(ProcessorID::RV32_ISS, {"M", "F", "D"},
+                    {RISCV32_F_TEST_DIR});
+  }
+  void testRV32_OutOfOrder_FloatingPoint() {
+    runTests(ProcessorID::RV32_OOO, {"M", "F", "D"}, {RISCV32_F_TEST_DIR});
+  }
+  void testRV32_ISS_Vector() {
+    runTests(ProcessorID::RV32_ISS, {"M", "V"}, {RISCV32_V_TEST_DIR});
+  }
+  void testRV32_ISS_Traps() {
+    m_timer = true;
+    runTests(ProcessorID::RV32_ISS, {"M"}, {RISCV32_ZICSR_TEST_DIR});
+    runBatchedTests(ProcessorID::RV32_ISS, {"M"}, {RISCV32_ZICSR_TEST_DIR});
+  }
+  void testUnsupportedInstructions();
+  void testRV32_Superscalar2W_GShare() {
+    // Branch prediction only affects timing; results must be unchanged.
+    ProcessorHandler::setBranchPredictor(BranchPredictor::Scheme::GShare);
+    runTests(ProcessorID::RV32_SUPERSCALAR_2W, {"M", "C"},
+             {RISCV32_TEST_DIR, RISCV32_C_TEST_DIR});
+  }
+  void testRV32_5StagePipeline_MExtLatency() {
+    // Multi-cycle M-extension units only affect timing; results must be
+    // unchanged.
+    ProcessorHandler::setMExtTiming({4, 12});
+    runTests(ProcessorID::RV32_5S, {"M", "C"},
+             {RISCV32_TEST_DIR, RISCV32_C_TEST_DIR});
+  }
 };
 
 bool tst_RISCV::skipTest(const QString &test) {
@@ -151,6 +274,10 @@ void tst_RISCV::trapHandler() {
     m_err += dumpRegs();
   }
   m_stop |= true;
+  // A batch only stops once the processor has finished.
+  if (m_batched)
+    ProcessorHandler::getProcessorNonConst()->finalize(
+        RipesProcessor::FinalizeReason::exitSyscall);
 }
 
 QString tst_RISCV::executeSimulator() {
@@ -159,9 +286,15 @@ QString tst_RISCV::executeSimulator() {
   bool maxCyclesReached = false;
   unsigned cycles = 0;
   do {
-    ProcessorHandler::getProcessorNonConst()->clock();
-
-    cycles++;
+    auto *proc = ProcessorHandler::getProcessorNonConst();
+    if (m_batched) {
+      cycles += proc->clockBatch(s_maxCycles - cycles);
+      // The program ran off the end of the text section.
+      m_stop |= proc->finished();
+    } else {
+      proc->clock();
+      cycles++;
+    }
 
     maxCyclesReached |= cycles >= s_maxCycles;
     m_stop |= maxCyclesReached;
@@ -179,52 +312,122 @@ QString tst_RISCV::executeSimulator() {
   return m_err;
 }
 
+QString tst_RISCV::runTest(const QString &testPath) {
+  m_currentTest = testPath;
+  qInfo() << "Running test: " << m_currentTest;
+
+  // Assemble test file
+  auto f = QFile(testPath);
+  if (!f.open(QIODevice::ReadOnly))
+    return "Test: '" + m_currentTest + "' failed: Could not open test file";
+  const auto program =
+      ProcessorHandler::getAssembler()->assembleRaw(QString(f.readAll()));
+  if (program.errors.size() != 0) {
+    QString err = "Test: '" + m_currentTest + "' failed: Could not assemble";
+    err += "\n errors were:";
+    err += program.errors.toString();
+    return err;
+  }
+  auto spProgram = std::make_shared<Program>(program.program);
+
+  // Override the ProcessorHandler's ECALL handling. In doing so, we verify
+  // whether the correct test value was reached.
+  ProcessorHandler::getProcessorNonConst()->trapHandler = [=] {
+    trapHandler();
+  };
+  ProcessorHandler::getProcessorNonConst()->timerCompare =
+      m_timer ? std::function<uint64_t()>([] { return s_timerCompare; })
+              : nullptr;
+  ProcessorHandler::get()->loadProgram(spProgram);
+  RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+
+  const QString err = executeSimulator();
+  if (err.isNull())
+    qInfo() << "Test '" << m_currentTest << "' succeeded.";
+  return err;
+}
+
+// Ensures that the VSRTL models stop at the CSR instructions which they do not
+// implement, rather than executing them as NOPs.
+void tst_RISCV::testUnsupportedInstructions() {
+  if (m_shardIndex != 0)
+    QSKIP("Runs in the first shard only");
+  // Returns false if @p instr could not be assembled.
+  const auto run = [](const QString &instr) {
+    const QString src = ".text\nnop\n" + instr + "\nnop\nnop\nnop\nnop\n";
+    const auto program = ProcessorHandler::getAssembler()->assembleRaw(src);
+    if (program.errors.size() != 0)
+      return false;
+    ProcessorHandler::get()->loadProgram(
+        std::make_shared<Program>(program.program));
+    RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+    auto *proc = ProcessorHandler::getProcessorNonConst();
+    for (unsigned i = 0; i < 20 && !proc->finished(); ++i)
+      proc->clock();
+    return true;
+  };
+  for (const auto id :
+       {ProcessorID::RV32_SS, ProcessorID::RV32_5S, ProcessorID::RV32_5S_NO_FW,
+        ProcessorID::RV32_6S_DUAL}) {
+    ProcessorHandler::selectProcessor(id, {"M"});
+    for (const auto &instr : {"csrw mscratch t0", "csrr t0 mstatus", "mret",
+                              "wfi", "csrsi mie 8"}) {
+      QVERIFY2(run(instr), instr);
+      QVERIFY2(!ProcessorHandler::unsupportedInstruction().isEmpty(),
+               qPrintable(enumToString<ProcessorID>(id) + ": " + instr));
+    }
+    QVERIFY(run("rdcycle t0"));
+    QVERIFY2(ProcessorHandler::unsupportedInstruction().isEmpty(),
+             qPrintable(ProcessorHandler::unsupportedInstruction()));
+  }
+}
+
 void tst_RISCV::runTests(const ProcessorID &id, const QStringList &extensions,
                          const QStringList &testDirs) {
+  // All tests of the shard are run, and failures are reported together, such
+  // that a single failing test does not hide the state of the remaining ones.
+  QStringList failures;
+  unsigned passed = 0;
+  unsigned testIdx = 0;
   for (auto testDir : testDirs) {
     const auto dir = QDir(testDir);
-    const auto testFiles = dir.entryList({"*.s"});
+    const auto testFiles = dir.entryList({"*.s"}, QDir::Files, QDir::Name);
     ProcessorHandler::selectProcessor(id, extensions);
 
     for (const auto &test : testFiles) {
-      auto testPath = testDir + QString(QDir::separator()) + test;
-      m_currentTest = testPath;
       if (skipTest(test))
         continue;
+      if (testIdx++ % m_shardCount != m_shardIndex)
+        continue;
 
-      qInfo() << "Running test: " << m_currentTest;
-
-      // Assemble test file
-      auto f = QFile(testPath);
-      if (!f.open(QIODevice::ReadOnly)) {
-        QFAIL("Could not open test file");
-      }
-      const auto program =
-          ProcessorHandler::getAssembler()->assembleRaw(QString(f.readAll()));
-      if (program.errors.size() != 0) {
-        QString err = "Could not assemble program";
-        err += "\n errors were:";
-        err += program.errors.toString();
-        QFAIL(err.toStdString().c_str());
-      }
-      auto spProgram = std::make_shared<Program>(program.program);
-
-      // Override the ProcessorHandler's ECALL handling. In doing so, we verify
-      // whether the correct test value was reached.
-      ProcessorHandler::getProcessorNonConst()->trapHandler = [=] {
-        trapHandler();
-      };
-      ProcessorHandler::get()->loadProgram(spProgram);
-      RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
-
-      const QString err = executeSimulator();
-      if (!err.isNull()) {
-        QFAIL(err.toStdString().c_str());
-      }
-
-      qInfo() << "Test '" << m_currentTest << "' succeeded.";
+      const QString err =
+          runTest(testDir + QString(QDir::separator()) + test);
+      if (err.isNull())
+        passed++;
+      else
+        failures << err;
     }
   }
+
+  qInfo().noquote() << QString("%1: %2 passed, %3 failed (shard %4 of %5)")
+                           .arg(enumToString<ProcessorID>(id))
+                           .arg(passed)
+                           .arg(failures.size())
+                           .arg(m_shardIndex)
+                           .arg(m_shardCount);
+  if (!failures.isEmpty()) {
+    const QString err = QString::number(failures.size()) +
+                        " test(s) failed:\n" + failures.join("\n");
+    QFAIL(err.toStdString().c_str());
+  }
+}
+
+void tst_RISCV::runBatchedTests(const ProcessorID &id,
+                                const QStringList &extensions,
+                                const QStringList &testDirs) {
+  m_batched = true;
+  runTests(id, extensions, testDirs);
+  m_batched = false;
 }
 
 QTEST_APPLESS_MAIN(tst_RISCV)
@@ -0,0 +1,84 @@
+#include <QStringList>
+#include <QtTest/QTest>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "programloader.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+class tst_RV5S : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_hazards_data();
+  void tst_hazards();
+};
+
+static VInt reg(unsigned idx) {
+  return ProcessorHandler::get()->getRegisterValue(RegisterFileType::GPR, idx);
+}
+
+// Runs @p program on processor @p id, and returns the cycles taken.
+static long long run(ProcessorID id, const QStringList &program) {
+  runProgram(id, program, true);
+  return ProcessorHandler::getProcessor()->getCycleCount();
+}
+
+void tst_RV5S::tst_hazards_data() {
+  QTest::addColumn<int>("id");
+  QTest::addColumn<bool>("forwarding");
+  QTest::addColumn<bool>("hazardDetection");
+  for (const bool rv64 : {false, true}) {
+    const char *xlen = rv64 ? "RV64" : "RV32";
+    QTest::addRow("%s_5S", xlen)
+        << static_cast<int>(rv64 ? ProcessorID::RV64_5S : ProcessorID::RV32_5S)
+        << true << true;
+    QTest::addRow("%s_5S_NO_FW", xlen)
+        << static_cast<int>(rv64 ? ProcessorID::RV64_5S_NO_FW
+                                 : ProcessorID::RV32_5S_NO_FW)
+        << false << true;
+    QTest::addRow("%s_5S_NO_HZ", xlen)
+        << static_cast<int>(rv64 ? ProcessorID::RV64_5S_NO_HZ
+                                 : ProcessorID::RV32_5S_NO_HZ)
+        << true << false;
+    QTest::addRow("%s_5S_NO_FW_HZ", xlen)
+        << static_cast<int>(rv64 ? ProcessorID::RV64_5S_NO_FW_HZ
+                                 : ProcessorID::RV32_5S_NO_FW_HZ)
+        << false << false;
+  }
+}
+
+// Ensures that each specialization of the 5-stage pipeline resolves exactly
+// the data hazards of its forwarding and hazard detection configuration.
+void tst_RV5S::tst_hazards() {
+  QFETCH(int, id);
+  QFETCH(bool, forwarding);
+  QFETCH(bool, hazardDetection);
+  const auto proc = static_cast<ProcessorID>(id);
+
+  // Dependent ALU instructions are resolved by forwarding, or by stalling.
+  const QStringList alu = {".text", "li a0 5", "addi a1 a0 1"};
+  const long long aluCycles = run(proc, alu);
+  QCOMPARE(reg(11), VInt(forwarding || hazardDetection ? 6 : 1));
+  const long long baseCycles = run(ProcessorID::RV32_5S, alu);
+  QCOMPARE(aluCycles > baseCycles, !forwarding && hazardDetection);
+
+  // A load-use hazard requires hazard detection.
+  run(proc, {".text", "li t0 7", "nop", "nop", "nop", "sw t0 -4 sp",
+             "lw a1 -4 sp", "addi a2 a1 1"});
+  if (hazardDetection)
+    QCOMPARE(reg(12), VInt(8));
+  else
+    QVERIFY(reg(12) != VInt(8));
+
+  // Independent instructions execute alike on all specializations.
+  run(proc, {".text", "li a0 5", "nop", "nop", "nop", "addi a1 a0 1", "nop",
+             "nop", "nop", "add a2 a1 a0"});
+  QCOMPARE(reg(12), VInt(11));
+}
+
+QTEST_MAIN(tst_RV5S)
+#include "tst_rv5s.moc"
@@ -0,0 +1,89 @@
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QtTest/QTest>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "programloader.h"
+#include "ripessettings.h"
+#include "session.h"
+
+using namespace Ripes;
+
+class tst_Session : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_session();
+};
+
+void tst_Session::tst_session() {
+  QStringList program = QStringList() << ".data"
+                                      << "a: .word 1 2 3"
+                                      << ".text"
+                                      << "main:"
+                                      << "la a0 a"
+                                      << "lw a1 0 a0"
+                                      << "loop: addi a1 a1 -1"
+                                      << "bnez a1 loop";
+  runProgram(ProcessorID::RV32_ISS, program, false);
+  const auto loaded = ProcessorHandler::getProgram();
+
+  Session session;
+  session.processor = ProcessorID::RV32_ISS;
+  session.extensions = QStringList() << "M";
+  session.source = program.join("\n");
+  session.program = std::make_shared<Program>(*loaded);
+  CachePreset preset;
+  preset.blocks = 2;
+  preset.lines = 5;
+  preset.ways = 1;
+  preset.wrPolicy = WritePolicy::WriteThrough;
+  preset.wrAllocPolicy = WriteAllocPolicy::NoWriteAllocate;
+  preset.replPolicy = ReplPolicy::LRU;
+  session.caches = {preset};
+  session.checkpoint = QByteArray("checkpoint");
+
+  QTemporaryDir dir;
+  const QString path = dir.filePath("test.rses");
+  QCOMPARE(saveSession(path, session), QString());
+  Session restored;
+  QCOMPARE(loadSession(path, restored), QString());
+
+  QCOMPARE(restored.processor, session.processor);
+  QCOMPARE(restored.extensions, session.extensions);
+  QCOMPARE(restored.sourceType, SourceType::Assembly);
+  QCOMPARE(restored.source, session.source);
+  QCOMPARE(restored.checkpoint, session.checkpoint);
+  QCOMPARE(restored.caches.size(), size_t(1));
+  QCOMPARE(restored.caches.at(0).lines, preset.lines);
+  QCOMPARE(restored.caches.at(0).replPolicy, preset.replPolicy);
+
+  const Program &p = *restored.program;
+  QCOMPARE(p.entryPoint, loaded->entryPoint);
+  QCOMPARE(p.sourceHash, loaded->sourceHash);
+  QCOMPARE(p.sections.size(), loaded->sections.size());
+  for (const auto &it : loaded->sections) {
+    QCOMPARE(p.sections.at(it.first).address, it.second.address);
+    QCOMPARE(p.sections.at(it.first).data, it.second.data);
+  }
+  QCOMPARE(p.symbols.size(), loaded->symbols.size());
+  for (const auto &it : loaded->symbols)
+    QCOMPARE(p.symbols.at(it.first).v, it.second.v);
+  QCOMPARE(p.sourceMapping, loaded->sourceMapping);
+  QCOMPARE(p.getDisassembled().addresses(),
+           loaded->getDisassembled().addresses());
+  QCOMPARE(*p.getDisassembled().getFromIdx(2),
+           *loaded->getDisassembled().getFromIdx(2));
+
+  // Truncated sessions are rejected.
+  QFile file(path);
+  QVERIFY(file.open(QIODevice::ReadWrite));
+  QVERIFY(file.resize(file.size() - 1));
+  file.close();
+  QVERIFY(!loadSession(path, restored).isEmpty());
+}
+
+QTEST_MAIN(tst_Session)
+#include "tst_session.moc"
@@ -0,0 +1,117 @@
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QJsonObject>
+#include <QStringList>
+#include <QtTest/QTest>
+
+#include <cstdio>
+#include <cstring>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "cli/clioptions.h"
+#include "cli/clirunner.h"
+#include "cli/simfork.h"
+#include "programloader.h"
+
+using namespace Ripes;
+
+class tst_SimFork : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_parse_variant();
+  void tst_fork();
+};
+
+// Ensures that variants are split as in a shell, and that options identifying
+// the program or the output of the children are rejected.
+void tst_SimFork::tst_parse_variant() {
+  ForkVariant variant;
+  QVERIFY(parseForkVariant("--proc RV32_5S  --l1d \"lines=64,ways=2\"", variant)
+              .isEmpty());
+  QCOMPARE(variant.name, QString("--proc RV32_5S --l1d \"lines=64,ways=2\""));
+  QCOMPARE(variant.arguments, QStringList({"--proc", "RV32_5S", "--l1d",
+                                           "lines=64,ways=2"}));
+
+  for (const QString &spec : {"--src other.s", "-t=elf", "--output r.json"})
+    QVERIFY(parseForkVariant(spec, variant).contains("cannot be set"));
+  QVERIFY(!parseForkVariant("  ", variant).isEmpty());
+}
+
+// Ensures that the children of a fork resume from the state of the processor
+// at the time of the fork, on processor models of their own, rather than
+// re-executing the program from its start.
+void tst_SimFork::tst_fork() {
+  QStringList program = QStringList() << ".text"
+                                      << "li a1 1"
+                                      << "li t1 1000"
+                                      << "loop:"
+                                      << "add a0 a0 a1"
+                                      << "addi a3 a3 1"
+                                      << "blt a3 t1 loop";
+  runProgram(ProcessorID::RV32_ISS, program, false);
+  auto *proc = ProcessorHandler::get()->getProcessorNonConst();
+  proc->clockBatch(301);
+  const long long retiredAtFork = proc->getInstructionsRetired();
+  QVERIFY(retiredAtFork > 2);
+  QVERIFY(!proc->finished());
+
+  std::vector<ForkVariant> variants(2);
+  QVERIFY(parseForkVariant("--proc RV32_5S", variants.at(0)).isEmpty());
+  QVERIFY(parseForkVariant("--proc RV32_ISS", variants.at(1)).isEmpty());
+  SimulationFork fork;
+  const QString err = fork.start({"--regs", "--iret"}, variants);
+  QVERIFY2(err.isEmpty(), qPrintable(err));
+  QCOMPARE(fork.snapshotCycle(), proc->getCycleCount());
+  fork.waitForFinished();
+  QVERIFY(!fork.isRunning());
+
+  // The program retires 2 + 3 * 1000 instructions in all.
+  const long long remaining = 3002 - retiredAtFork;
+  QCOMPARE(fork.results().size(), size_t(2));
+  for (size_t i = 0; i < variants.size(); ++i) {
+    const QJsonObject result = fork.results().at(i);
+    QCOMPARE(result.value("name").toString(), variants.at(i).name);
+    QVERIFY2(result.value("status").toString() == "ok",
+             qPrintable(result.value("error").toString()));
+    const QJsonObject report = result.value("report").toObject();
+    QCOMPARE(report.value("# instructions retired").toVariant().toLongLong(),
+             remaining);
+    const QJsonObject regs = report.value("registers").toObject();
+    QCOMPARE(regs.value("a0").toVariant().toLongLong(), 1000);
+    QCOMPARE(regs.value("a3").toVariant().toLongLong(), 1000);
+  }
+
+  // The parent is unaffected by its children.
+  QCOMPARE(proc->getInstructionsRetired(), retiredAtFork);
+}
+
+// The children of a fork are run by the executable of the forking process,
+// which thus acts as the Ripes CLI when run in CLI mode.
+int main(int argc, char **argv) {
+  if (argc > 2 && std::strcmp(argv[1], "--mode") == 0 &&
+      std::strcmp(argv[2], "cli") == 0) {
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    CLIModeOptions options;
+    parser.addOption(QCommandLineOption("mode", "Ripes mode", "mode", "gui"));
+    addCLIOptions(parser, options);
+    QString err;
+    if (!parser.parse(QCoreApplication::arguments()) ||
+        !parseCLIOptions(parser, err, options)) {
+      fprintf(stderr, "ERROR: %s\n",
+              qPrintable(err.isEmpty() ? parser.errorText() : err));
+      return 1;
+    }
+    return CLIRunner(options).run();
+  }
+
+  QApplication app(argc, argv);
+  tst_SimFork tc;
+  QTEST_SET_MAIN_SOURCE_PATH
+  return QTest::qExec(&tc, argc, argv);
+}
+
+#include "tst_simfork.moc"
@@ -0,0 +1,92 @@
+#include <QStringList>
+#include <QtTest/QTest>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "programloader.h"
+#include "ripessettings.h"
+#include "stagestatisticsmodel.h"
+
+using namespace Ripes;
+
+class tst_StageStatistics : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_stage_statistics();
+  void tst_stall_cause();
+};
+
+// Ensures that stage statistics account for every cycle of every stage, and
+// that reversed cycles are subtracted.
+void tst_StageStatistics::tst_stage_statistics() {
+  ProcessorHandler::get()->selectProcessor(ProcessorID::RV32_5S_NO_FW, {});
+  ProcessorHandler::get()->getProcessorNonConst()->trapHandler = [=] {};
+  StageStatisticsModel stats;
+
+  // Back-to-back dependencies stall the pipeline without forwarding.
+  auto loader = new ProgramLoader();
+  loader->loadTest(QStringList({".text", "loop:", "addi a0 a0 1",
+                                "add a1 a0 a0", "j loop"})
+                       .join("\n"));
+  RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+  auto proc = ProcessorHandler::get()->getProcessorNonConst();
+  for (unsigned i = 0; i < 40; ++i)
+    proc->clock();
+
+  QCOMPARE(stats.cycles(), 40ull);
+  unsigned long long stalls = 0;
+  for (const auto &counters : stats.counters()) {
+    unsigned long long cycles = 0;
+    for (int col = StageStatisticsModel::Active;
+         col < StageStatisticsModel::NColumns; ++col)
+      cycles += counters[col];
+    QCOMPARE(cycles, 40ull);
+    stalls += counters[StageStatisticsModel::Stalled];
+  }
+  QVERIFY(stalls > 0);
+
+  const auto counters = stats.counters();
+  for (unsigned i = 0; i < 10; ++i)
+    proc->reverseProcessor();
+  QCOMPARE(stats.cycles(), 30ull);
+  for (unsigned i = 0; i < 10; ++i)
+    proc->clock();
+  QCOMPARE(stats.cycles(), 40ull);
+  QVERIFY(stats.counters() == counters);
+}
+
+// Ensures that the stalls of a pipeline without forwarding are attributed
+// to the data and control hazards which cause them.
+void tst_StageStatistics::tst_stall_cause() {
+  ProcessorHandler::get()->selectProcessor(ProcessorID::RV32_5S_NO_FW, {});
+  ProcessorHandler::get()->getProcessorNonConst()->trapHandler = [=] {};
+
+  auto loader = new ProgramLoader();
+  loader->loadTest(QStringList({".text", "loop:", "addi a0 a0 1",
+                                "add a1 a0 a0", "j loop"})
+                       .join("\n"));
+  RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+  auto proc = ProcessorHandler::get()->getProcessorNonConst();
+
+  using StallCause = RipesProcessor::StallCause;
+  bool dataHazard = false, controlHazard = false;
+  for (unsigned i = 0; i < 40; ++i) {
+    proc->clock();
+    const auto stall = proc->stallCause();
+    if (stall.cause == StallCause::DataHazard) {
+      // add a1 a0 a0 waits on a0.
+      QCOMPARE(stall.reg, 10);
+      dataHazard = true;
+    } else if (stall.cause == StallCause::ControlHazard) {
+      QCOMPARE(stall.lostSlots, 2u);
+      controlHazard = true;
+    }
+  }
+  QVERIFY(dataHazard);
+  QVERIFY(controlHazard);
+}
+
+QTEST_MAIN(tst_StageStatistics)
+#include "tst_stagestatistics.moc"
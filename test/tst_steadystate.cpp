@@ -0,0 +1,68 @@
+#include <QStringList>
+#include <QtTest/QTest>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "cli/steadystate.h"
+#include "programloader.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+class tst_SteadyState : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_heap();
+  void cleanup();
+};
+
+void tst_SteadyState::cleanup() {
+  ProcessorHandler::setSyscallABI(SyscallABI::RARS);
+}
+
+// Ensures that detailed simulation resumes after an extrapolated loop with the
+// heap memory written while fast-forwarding through the loop.
+void tst_SteadyState::tst_heap() {
+  QStringList program = QStringList() << ".text"
+                                      << "li a7 214"
+                                      << "li a0 0"
+                                      << "ecall"
+                                      << "mv s0 a0"
+                                      << "addi a0 s0 64"
+                                      << "ecall"
+                                      << "li t0 0"
+                                      << "li t1 2000"
+                                      << "loop:"
+                                      << "andi t2 t0 15"
+                                      << "slli t2 t2 2"
+                                      << "add t2 t2 s0"
+                                      << "sw t0 0 t2"
+                                      << "addi t0 t0 1"
+                                      << "blt t0 t1 loop"
+                                      << "lw a1 60 s0";
+  // The system calls of the program are serviced, so the program is not loaded
+  // through runProgram.
+  ProcessorHandler::setSyscallABI(SyscallABI::Newlib);
+  ProcessorHandler::get()->selectProcessor(ProcessorID::RV32_5S, {});
+  RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+  auto loader = new ProgramLoader();
+  loader->loadTest(program.join("\n"));
+
+  SteadyStateResult result;
+  const QString err = runSteadyState(4, 64, result);
+  QVERIFY2(err.isEmpty(), qPrintable(err));
+  QVERIFY(result.valid);
+  QVERIFY(!result.loops.empty());
+  QVERIFY(result.extrapolatedInstructions() > 0);
+
+  const AInt heap =
+      ProcessorHandler::get()->getRegisterValue(RegisterFileType::GPR, 8);
+  QCOMPARE(ProcessorHandler::get()->getRegisterValue(RegisterFileType::GPR, 11),
+           VInt(1999));
+  QCOMPARE(ProcessorHandler::getMemory().readMemConst(heap, 4), VInt(1984));
+}
+
+QTEST_MAIN(tst_SteadyState)
+#include "tst_steadystate.moc"
@@ -0,0 +1,107 @@
+#include <QCommandLineParser>
+#include <QStringList>
+#include <QtTest/QTest>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "cli/clioptions.h"
+#include "processors/interface/instructiontrace.h"
+#include "programloader.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+class tst_TraceReplay : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_trace_replay();
+  void tst_rejected_processors_data();
+  void tst_rejected_processors();
+};
+
+namespace {
+/// An instruction trace held in memory.
+class VectorTrace : public InstructionTrace {
+public:
+  std::vector<TraceRecord> records;
+
+  void rewind() override { m_next = 0; }
+  bool next(TraceRecord &record) override {
+    if (m_next == records.size())
+      return false;
+    record = records[m_next++];
+    return true;
+  }
+
+private:
+  size_t m_next = 0;
+};
+} // namespace
+
+// Ensures that a timing model replaying the trace of a program retires the
+// instructions of the trace in the cycles taken to execute the program, without
+// executing them.
+void tst_TraceReplay::tst_trace_replay() {
+  QStringList program = QStringList() << ".text"
+                                      << "li a0 1"
+                                      << "addi a1 a0 1"
+                                      << "add a2 a1 a0"
+                                      << "addi a3 a2 4"
+                                      << "add a4 a3 a3";
+  runProgram(ProcessorID::RV32_SUPERSCALAR_2W, program, true);
+  auto *proc = ProcessorHandler::get()->getProcessorNonConst();
+  const long long cycles = proc->getCycleCount();
+  const long long retired = proc->getInstructionsRetired();
+  QCOMPARE(retired, 5);
+
+  auto trace = std::make_shared<VectorTrace>();
+  const AInt text = ProcessorHandler::getTextStart();
+  for (long long i = 0; i < retired; ++i) {
+    const AInt pc = text + 4 * i;
+    trace->records.push_back(
+        {pc, static_cast<uint32_t>(proc->getMemory().readMemConst(pc, 4)), {}});
+  }
+  ProcessorHandler::setInstructionTrace(trace);
+  proc = ProcessorHandler::get()->getProcessorNonConst();
+  while (!proc->finished() && proc->getCycleCount() < 1000)
+    proc->clock();
+
+  QVERIFY(proc->finished());
+  QCOMPARE(proc->getInstructionsRetired(), retired);
+  QCOMPARE(proc->getCycleCount(), cycles);
+  QCOMPARE(proc->getRegister(RegisterFileType::GPR, 14), VInt(0));
+  ProcessorHandler::setInstructionTrace(nullptr);
+}
+
+void tst_TraceReplay::tst_rejected_processors_data() {
+  QTest::addColumn<QStringList>("arguments");
+  for (const char *proc : {"RV32_SS", "RV32_5S", "RV32_5S_NO_FW",
+                           "RV32_6S_DUAL"}) {
+    QTest::addRow("replay %s", proc)
+        << (QStringList() << "--src" << "prog.s" << "-t" << "asm" << "--proc"
+                          << proc << "--replay-trace" << "prog.log");
+    QTest::addRow("shared-frontend %s", proc)
+        << (QStringList() << "--src" << "prog.s" << "-t" << "asm" << "--proc"
+                          << proc << "--sweep" << "--sweep-proc"
+                          << QString("RV32_SUPERSCALAR_2W,") + proc
+                          << "--shared-frontend");
+  }
+}
+
+// Ensures that trace replay is rejected on processors which cannot replay
+// traces, rather than silently executing the program.
+void tst_TraceReplay::tst_rejected_processors() {
+  QFETCH(QStringList, arguments);
+  QCommandLineParser parser;
+  CLIModeOptions options;
+  addCLIOptions(parser, options);
+  QVERIFY(parser.parse(QStringList("ripes") + arguments));
+  QString err;
+  QVERIFY(!parseCLIOptions(parser, err, options));
+  QVERIFY2(err.contains("cannot replay traces"), qPrintable(err));
+}
+
+QTEST_MAIN(tst_TraceReplay)
+#include "tst_tracereplay.moc"
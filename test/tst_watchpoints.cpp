@@ -0,0 +1,49 @@
+#include <QStringList>
+#include <QtTest/QTest>
+
+#include <optional>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "programloader.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+class tst_Watchpoints : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_watchpoints();
+};
+
+// Ensures that a run stops at the store to a watched word, but not at the load
+// preceding it, nor at accesses to the unwatched words of the same page.
+void tst_Watchpoints::tst_watchpoints() {
+  QStringList program = QStringList() << ".data"
+                                      << "a: .word 1"
+                                      << "b: .word 2"
+                                      << ".text"
+                                      << "la a0 a"
+                                      << "lw a1 0 a0"
+                                      << "sw a1 4 a0"
+                                      << "sw a1 0 a0"
+                                      << "lw a2 4 a0";
+  runProgram(ProcessorID::RV32_ISS, program, false);
+  const AInt a = ProcessorHandler::getProgram()->getSection(".data")->address;
+  ProcessorHandler::addWatchpoint(Watchpoint{a, 4, false, true});
+  ProcessorHandler::clock(100);
+  ProcessorHandler::waitForIdle();
+  ProcessorHandler::clearWatchpoints();
+
+  const auto hit = ProcessorHandler::watchpointHit();
+  QVERIFY(hit.has_value());
+  QCOMPARE(hit->type, MemoryAccess::Write);
+  QCOMPARE(hit->address, a);
+  QCOMPARE(ProcessorHandler::get()->getRegisterValue(RegisterFileType::GPR, 12),
+           VInt(0));
+}
+
+QTEST_MAIN(tst_Watchpoints)
+#include "tst_watchpoints.moc"
@@ -0,0 +1,182 @@
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QtTest/QTest>
+
+#include <functional>
+#include <memory>
+
+#include "cli/workernodes.h"
+
+using namespace Ripes;
+
+class tst_WorkerNodes : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_parse_nodes();
+  void tst_distribute();
+  void tst_retries();
+};
+
+namespace {
+/**
+ * A worker node speaking the worker protocol on the event loop of the test.
+ * Each request is passed to the handler, which returns the response, or an
+ * empty object to drop the connection. Responses are sent @p delay ms after
+ * their request.
+ */
+class FakeWorker {
+public:
+  using Handler = std::function<QJsonObject(const QJsonObject &)>;
+
+  FakeWorker(int slots, Handler handler, int delay = 0, int protocol = 1)
+      : m_slots(slots), m_delay(delay), m_protocol(protocol),
+        m_handler(std::move(handler)) {
+    m_server.listen(QHostAddress::LocalHost);
+    QObject::connect(&m_server, &QTcpServer::newConnection, &m_server,
+                     [=] { accept(); });
+  }
+
+  WorkerNode node() const { return {"127.0.0.1", m_server.serverPort()}; }
+  /// Names of the runs received, in order.
+  const QStringList &received() const { return m_received; }
+
+private:
+  void accept() {
+    QTcpSocket *socket = m_server.nextPendingConnection();
+    QObject::connect(socket, &QTcpSocket::readyRead, socket, [=] {
+      m_in += socket->readAll();
+      for (int end; (end = m_in.indexOf('\n')) >= 0;) {
+        const QJsonObject request =
+            QJsonDocument::fromJson(m_in.left(end)).object();
+        m_in.remove(0, end + 1);
+        m_received << request.value("name").toString();
+        QJsonObject response = m_handler(request);
+        if (response.isEmpty()) {
+          socket->abort();
+          return;
+        }
+        response["id"] = request.value("id");
+        QTimer::singleShot(m_delay, socket, [=] {
+          socket->write(
+              QJsonDocument(response).toJson(QJsonDocument::Compact) + "\n");
+        });
+      }
+    });
+    QJsonObject greeting;
+    greeting["ripes"] = "worker";
+    greeting["protocol"] = m_protocol;
+    greeting["slots"] = m_slots;
+    socket->write(QJsonDocument(greeting).toJson(QJsonDocument::Compact) +
+                  "\n");
+  }
+
+  QTcpServer m_server;
+  const int m_slots;
+  const int m_delay;
+  const int m_protocol;
+  Handler m_handler;
+  QByteArray m_in;
+  QStringList m_received;
+};
+
+// Responds with the name and arguments of the request.
+QJsonObject echo(const QJsonObject &request) {
+  QJsonObject response;
+  response["name"] = request.value("name");
+  response["status"] = "ok";
+  response["args"] = request.value("args");
+  return response;
+}
+} // namespace
+
+static std::vector<BatchRun> makeRuns(unsigned n) {
+  std::vector<BatchRun> runs;
+  for (unsigned i = 0; i < n; ++i)
+    runs.push_back({"run" + QString::number(i),
+                    {"--src", "prog" + QString::number(i) + ".s"}});
+  return runs;
+}
+
+void tst_WorkerNodes::tst_parse_nodes() {
+  std::vector<WorkerNode> nodes;
+  QVERIFY(parseWorkerNodes("a:1234, 10.0.0.2:80,[::1]:9", nodes).isEmpty());
+  QCOMPARE(nodes.size(), size_t(3));
+  QCOMPARE(nodes.at(0).host, QString("a"));
+  QCOMPARE(nodes.at(1).toString(), QString("10.0.0.2:80"));
+  QCOMPARE(nodes.at(2).host, QString("[::1]"));
+  QCOMPARE(nodes.at(2).port, quint16(9));
+  QVERIFY(!parseWorkerNodes("a", nodes).isEmpty());
+  QVERIFY(!parseWorkerNodes("a:0", nodes).isEmpty());
+  QVERIFY(!parseWorkerNodes("a:65536", nodes).isEmpty());
+  QVERIFY(!parseWorkerNodes("", nodes).isEmpty());
+}
+
+// Ensures that each run is executed once across the nodes, that results are
+// gathered in the order of the runs, and that the runs of a failing node, and
+// of an incompatible node, are executed by the remaining nodes.
+void tst_WorkerNodes::tst_distribute() {
+  // The failing node receives its second request while the runs of the
+  // slower node are in flight.
+  FakeWorker slow(2, echo, 50);
+  // Drops the connection upon its second request.
+  int requests = 0;
+  FakeWorker failing(1, [&](const QJsonObject &request) {
+    return ++requests == 2 ? QJsonObject() : echo(request);
+  });
+  FakeWorker incompatible(4, echo, 0, 2);
+
+  const auto runs = makeRuns(10);
+  std::vector<QJsonObject> results;
+  runOnWorkerNodes({slow.node(), failing.node(), incompatible.node()}, runs,
+                   1, false, results);
+  QCOMPARE(results.size(), runs.size());
+  for (unsigned i = 0; i < runs.size(); ++i) {
+    QCOMPARE(results.at(i).value("status").toString(), QString("ok"));
+    QCOMPARE(results.at(i).value("name").toString(), runs.at(i).name);
+    QCOMPARE(results.at(i).value("args").toArray().at(1).toString(),
+             runs.at(i).arguments.at(1));
+  }
+  QVERIFY(incompatible.received().isEmpty());
+  QCOMPARE(failing.received().size(), 2);
+  // The run lost to the failing node was retried on the remaining node.
+  QCOMPARE(slow.received().size(), 9);
+  QVERIFY(slow.received().contains(failing.received().at(1)));
+}
+
+// Ensures that runs lost to an exiting worker process are retried up to the
+// given number of times, and are then reported as failed.
+void tst_WorkerNodes::tst_retries() {
+  FakeWorker worker(1, [](const QJsonObject &request) {
+    if (request.value("name") != "run1")
+      return echo(request);
+    QJsonObject response;
+    response["status"] = "failed";
+    response["retry"] = true;
+    return response;
+  });
+  const auto runs = makeRuns(3);
+  std::vector<QJsonObject> results;
+  runOnWorkerNodes({worker.node()}, runs, 2, false, results);
+  QCOMPARE(results.at(0).value("status").toString(), QString("ok"));
+  QCOMPARE(results.at(1).value("status").toString(), QString("failed"));
+  QCOMPARE(results.at(1).value("name").toString(), QString("run1"));
+  QCOMPARE(results.at(2).value("status").toString(), QString("ok"));
+  // The initial attempt and two retries.
+  QCOMPARE(worker.received().count("run1"), 3);
+
+  // Without any reachable node, all runs fail.
+  QTcpServer closed;
+  QVERIFY(closed.listen(QHostAddress::LocalHost));
+  const WorkerNode node{"127.0.0.1", closed.serverPort()};
+  closed.close();
+  runOnWorkerNodes({node}, runs, 2, false, results);
+  for (const auto &result : results)
+    QCOMPARE(result.value("status").toString(), QString("failed"));
+}
+
+QTEST_MAIN(tst_WorkerNodes)
+#include "tst_workernodes.moc"